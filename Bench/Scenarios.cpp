@@ -0,0 +1,401 @@
+#include "Scenarios.h"
+#include <cmath>
+
+using namespace std;
+
+namespace
+{
+	// Static quad of Size x Size centered on the origin, at height Y
+	void CreateGround(PhysicsEngine& Engine, SceneID Scene, float Size, float Y = 0.0f)
+	{
+		vector<PxVec3> vertices =
+		{
+			PxVec3(-1, 0, -1),
+			PxVec3(-1, 0,  1),
+			PxVec3( 1, 0, -1),
+			PxVec3( 1, 0,  1)
+		};
+
+		vector<uint32_t> indices =
+		{
+			3, 2, 0,
+			3, 0, 1
+		};
+
+		auto mesh_id = Engine.CreatePhysicsTriangleMesh(vertices, indices);
+		Engine.CreateStaticActor(mesh_id, PxVec3(0, Y, 0), PxQuat(PxIdentity), PxVec3(Size * 0.5f, 1, Size * 0.5f), MaterialID(), Scene);
+
+		// The actor keeps the mesh alive
+		Engine.ReleaseMesh(mesh_id);
+	}
+
+	// Smooth hills with some noise, normalized to [0,1]
+	vector<float> CreateHeightmap(uint32_t Size, Random& Rng)
+	{
+		vector<float> heights(Size * Size);
+		for (uint32_t y = 0; y < Size; y++)
+		{
+			for (uint32_t x = 0; x < Size; x++)
+			{
+				const float u = float(x) / Size;
+				const float v = float(y) / Size;
+				const float hills = 0.5f + 0.25f * sinf(u * 12.0f) * cosf(v * 9.0f) + 0.15f * sinf((u + v) * 23.0f);
+				heights[y * Size + x] = PxClamp(hills + Rng.Range(-0.02f, 0.02f), 0.0f, 1.0f);
+			}
+		}
+		return heights;
+	}
+
+	PxVec3 GetPosition(PhysicsEngine& Engine, ActorID ID)
+	{
+		return Engine.GetActor(ID)->getGlobalPose().p;
+	}
+
+	// Connects two parts of a ragdoll at a world position
+	void CreateSphericalJoint(PxPhysics& Physics, PxRigidActor * Actor0, PxRigidActor * Actor1, PxVec3 Anchor, float ConeAngle)
+	{
+		const PxTransform frame0 = Actor0->getGlobalPose().transformInv(PxTransform(Anchor));
+		const PxTransform frame1 = Actor1->getGlobalPose().transformInv(PxTransform(Anchor));
+
+		auto joint = PxSphericalJointCreate(Physics, Actor0, frame0, Actor1, frame1);
+		if (!joint)
+			return;
+
+		joint->setLimitCone(PxJointLimitCone(ConeAngle, ConeAngle));
+		joint->setSphericalJointFlag(PxSphericalJointFlag::eLIMIT_ENABLED, true);
+	}
+
+	// Pyramids of boxes, the classic solver stress test
+	class BoxStacks : public Scenario
+	{
+	public:
+		virtual const char * GetName() const { return "box_stacks"; }
+
+		virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng)
+		{
+			CreateGround(Engine, Scene, 400.0f);
+
+			const uint32_t stack_count = 16;
+			const uint32_t base_size = 12;
+			vector<DynamicActorDesc> descs;
+			for (uint32_t s = 0; s < stack_count; s++)
+			{
+				const PxVec3 origin((float(s % 4) - 1.5f) * 20.0f, 0.0f, (float(s / 4) - 1.5f) * 20.0f);
+				for (uint32_t level = 0; level < base_size; level++)
+				{
+					for (uint32_t i = 0; i < base_size - level; i++)
+					{
+						DynamicActorDesc desc;
+						desc.Type = DynamicShapeType::Box;
+						desc.HalfExtents = PxVec3(0.5f);
+						// Small jitter so the stacks are not perfectly symmetric, still the same on every run
+						desc.Pose = PxTransform(origin + PxVec3(float(i) + 0.5f * level - 0.5f * base_size + Rng.Range(-0.01f, 0.01f), 0.5f + float(level), 0.0f));
+						descs.push_back(desc);
+					}
+				}
+			}
+			Engine.CreateDynamicActors(descs, false, Scene);
+		}
+	};
+
+	// A heap of mixed small shapes falling on each other
+	class DebrisPile : public Scenario
+	{
+		vector<ConvexID> Convexes;
+	public:
+		virtual const char * GetName() const { return "debris_pile"; }
+
+		virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng)
+		{
+			CreateGround(Engine, Scene, 400.0f);
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				vector<PxVec3> points(24);
+				for (auto& point : points)
+					point = Rng.Vector(-0.4f, 0.4f);
+				Convexes.push_back(Engine.CreateConvexMesh(points));
+			}
+
+			vector<DynamicActorDesc> descs(3000);
+			for (auto& desc : descs)
+			{
+				desc.Type = DynamicShapeType(Rng.Index(4));
+				desc.Pose = PxTransform(PxVec3(Rng.Range(-10, 10), Rng.Range(1, 40), Rng.Range(-10, 10)), Rng.Rotation());
+				desc.HalfExtents = PxVec3(Rng.Range(0.1f, 0.4f), Rng.Range(0.1f, 0.4f), Rng.Range(0.1f, 0.4f));
+				desc.Radius = Rng.Range(0.1f, 0.3f);
+				desc.HalfHeight = Rng.Range(0.1f, 0.3f);
+				desc.Convex = Convexes[Rng.Index(uint32_t(Convexes.size()))];
+				desc.LinearVelocity = Rng.Vector(-2.0f, 2.0f);
+			}
+			Engine.CreateDynamicActors(descs, false, Scene);
+		}
+
+		virtual void Teardown(PhysicsEngine& Engine)
+		{
+			for (auto id : Convexes)
+				Engine.ReleaseConvex(id);
+			Convexes.clear();
+		}
+	};
+
+	// Ragdolls made of capsules and spherical joints, collapsing on each other
+	class RagdollCrowd : public Scenario
+	{
+	public:
+		virtual const char * GetName() const { return "ragdoll_crowd"; }
+
+		virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng)
+		{
+			CreateGround(Engine, Scene, 400.0f);
+
+			auto& physics = Engine.GetScene(Scene)->getPhysics();
+			const PxQuat vertical(PxHalfPi, PxVec3(0, 0, 1));
+
+			for (uint32_t r = 0; r < 128; r++)
+			{
+				const PxVec3 base((float(r % 16) - 7.5f) * 2.0f, 1.0f + Rng.Range(0.0f, 2.0f), (float(r / 16) - 3.5f) * 2.0f);
+
+				// Pelvis, spine, head, legs and arms. Capsules are along X, the vertical ones are rotated
+				vector<DynamicActorDesc> parts(7);
+				parts[0].Type = DynamicShapeType::Capsule; parts[0].Radius = 0.15f; parts[0].HalfHeight = 0.15f;
+				parts[0].Pose = PxTransform(base + PxVec3(0, 1.0f, 0));
+				parts[1].Type = DynamicShapeType::Capsule; parts[1].Radius = 0.15f; parts[1].HalfHeight = 0.2f;
+				parts[1].Pose = PxTransform(base + PxVec3(0, 1.5f, 0), vertical);
+				parts[2].Type = DynamicShapeType::Sphere; parts[2].Radius = 0.15f;
+				parts[2].Pose = PxTransform(base + PxVec3(0, 2.05f, 0));
+				for (uint32_t side = 0; side < 2; side++)
+				{
+					const float sign = side ? 1.0f : -1.0f;
+					auto& leg = parts[3 + side];
+					leg.Type = DynamicShapeType::Capsule; leg.Radius = 0.1f; leg.HalfHeight = 0.3f;
+					leg.Pose = PxTransform(base + PxVec3(sign * 0.2f, 0.45f, 0), vertical);
+					auto& arm = parts[5 + side];
+					arm.Type = DynamicShapeType::Capsule; arm.Radius = 0.08f; arm.HalfHeight = 0.25f;
+					arm.Pose = PxTransform(base + PxVec3(sign * 0.5f, 1.75f, 0));
+				}
+				for (auto& part : parts)
+					part.LinearVelocity = PxVec3(Rng.Range(-1, 1), 0, Rng.Range(-1, 1));
+
+				auto ids = Engine.CreateDynamicActors(parts, false, Scene);
+				if (ids.size() != parts.size())
+					continue;
+
+				PxRigidActor * actors[7];
+				for (size_t i = 0; i < ids.size(); i++)
+					actors[i] = Engine.GetActor(ids[i]);
+
+				CreateSphericalJoint(physics, actors[0], actors[1], base + PxVec3(0, 1.15f, 0), PxPi / 6);
+				CreateSphericalJoint(physics, actors[1], actors[2], base + PxVec3(0, 1.9f, 0), PxPi / 4);
+				for (uint32_t side = 0; side < 2; side++)
+				{
+					const float sign = side ? 1.0f : -1.0f;
+					CreateSphericalJoint(physics, actors[0], actors[3 + side], base + PxVec3(sign * 0.2f, 0.9f, 0), PxPi / 3);
+					CreateSphericalJoint(physics, actors[1], actors[5 + side], base + PxVec3(sign * 0.2f, 1.75f, 0), PxPi / 2);
+				}
+			}
+		}
+	};
+
+	// Boxes on four driven wheels crossing hills. The vehicle SDK is not linked by the wrapper, so the wheels are spheres on revolute joints
+	class VehiclesOnHeightfield : public Scenario
+	{
+	public:
+		virtual const char * GetName() const { return "vehicles_on_heightfield"; }
+
+		virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng)
+		{
+			const uint32_t size = 257;
+			const float extent = 400.0f;
+			const float max_height = 12.0f;
+			auto heights = CreateHeightmap(size, Rng);
+
+			HeightmapView view;
+			view.Data = heights.data();
+			view.Format = HeightmapFormat::Float;
+			view.SizeX = size;
+			view.SizeY = size;
+			view.RowStride = size * sizeof(float);
+			Engine.CreateTerrain(PxVec3(-extent * 0.5f, 0, -extent * 0.5f), PxVec3(extent, 1, extent), view, 0.0f, max_height, MaterialID(), Scene);
+
+			auto& physics = Engine.GetScene(Scene)->getPhysics();
+			for (uint32_t v = 0; v < 64; v++)
+			{
+				const PxVec3 base((float(v % 8) - 3.5f) * 12.0f, max_height + 2.0f, (float(v / 8) - 3.5f) * 12.0f);
+
+				vector<DynamicActorDesc> parts(5);
+				parts[0].Type = DynamicShapeType::Box;
+				parts[0].HalfExtents = PxVec3(1.0f, 0.3f, 2.0f);
+				parts[0].Pose = PxTransform(base);
+				for (uint32_t w = 0; w < 4; w++)
+				{
+					auto& wheel = parts[1 + w];
+					wheel.Type = DynamicShapeType::Sphere;
+					wheel.Radius = 0.45f;
+					wheel.Density = 2.0f;
+					wheel.Pose = PxTransform(base + PxVec3((w & 1) ? 1.3f : -1.3f, -0.3f, (w & 2) ? 1.5f : -1.5f));
+				}
+
+				auto ids = Engine.CreateDynamicActors(parts, false, Scene);
+				if (ids.size() != parts.size())
+					continue;
+
+				auto chassis = Engine.GetActor(ids[0]);
+				const float drive_velocity = Rng.Range(4.0f, 10.0f);
+				for (uint32_t w = 0; w < 4; w++)
+				{
+					auto wheel = Engine.GetActor(ids[1 + w]);
+
+					// The axle is the X axis of the joint frames
+					const PxTransform anchor(GetPosition(Engine, ids[1 + w]));
+					auto joint = PxRevoluteJointCreate(physics, chassis, chassis->getGlobalPose().transformInv(anchor), wheel, PxTransform(PxIdentity));
+					if (!joint)
+						continue;
+
+					joint->setDriveVelocity(drive_velocity);
+					joint->setRevoluteJointFlag(PxRevoluteJointFlag::eDRIVE_ENABLED, true);
+				}
+			}
+		}
+	};
+
+	// Character controllers wandering between random targets around dynamic obstacles
+	class CharacterCrowd : public Scenario
+	{
+		vector<CharacterID> Characters;
+		vector<PxVec3> Targets;
+		vector<PxVec3> Displacements;
+	public:
+		virtual const char * GetName() const { return "cct_crowd"; }
+
+		virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng)
+		{
+			CreateGround(Engine, Scene, 400.0f);
+
+			vector<DynamicActorDesc> obstacles(200);
+			for (auto& desc : obstacles)
+			{
+				desc.HalfExtents = PxVec3(Rng.Range(0.5f, 2.0f), Rng.Range(0.5f, 1.5f), Rng.Range(0.5f, 2.0f));
+				desc.Pose = PxTransform(PxVec3(Rng.Range(-40, 40), desc.HalfExtents.y, Rng.Range(-40, 40)));
+				desc.Density = 5.0f;
+			}
+			Engine.CreateDynamicActors(obstacles, false, Scene);
+
+			for (uint32_t c = 0; c < 256; c++)
+			{
+				const PxVec3 position((float(c % 16) - 7.5f) * 5.0f, 2.0f, (float(c / 16) - 7.5f) * 5.0f);
+				auto id = Engine.CreateCharacterController(position, 1.8f, 0.4f, Scene);
+				if (!id.IsValid())
+					continue;
+				Characters.push_back(id);
+				Targets.push_back(PxVec3(Rng.Range(-40, 40), 0, Rng.Range(-40, 40)));
+			}
+			Displacements.resize(Characters.size());
+		}
+
+		virtual void Update(PhysicsEngine& Engine, SceneID /*Scene*/, Random& Rng, uint32_t Frame, float ElapsedTime)
+		{
+			for (size_t i = 0; i < Characters.size(); i++)
+			{
+				const auto position = Engine.GetCharacter(Characters[i])->getPosition();
+				PxVec3 to_target = Targets[i] - PxVec3(float(position.x), 0.0f, float(position.z));
+				if (to_target.magnitudeSquared() < 1.0f || (Frame + i) % 240 == 0)
+					Targets[i] = PxVec3(Rng.Range(-40, 40), 0, Rng.Range(-40, 40));
+
+				Displacements[i] = to_target.getNormalized() * (3.0f * ElapsedTime);
+			}
+			Engine.MoveCharacters(Characters, Displacements, ElapsedTime);
+		}
+
+		virtual void Teardown(PhysicsEngine& /*Engine*/)
+		{
+			// Released with the scene
+			Characters.clear();
+		}
+	};
+
+	// Batched raycasts on a scene full of resting boxes
+	class RaycastStorm : public Scenario
+	{
+		QueryBatch Batch;
+	public:
+		virtual const char * GetName() const { return "raycast_storm"; }
+		virtual uint32_t GetFrames() const { return 300; }
+		virtual uint32_t GetWarmupFrames() const { return 120; }
+
+		virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng)
+		{
+			CreateGround(Engine, Scene, 400.0f);
+
+			vector<DynamicActorDesc> descs(2000);
+			for (auto& desc : descs)
+			{
+				desc.HalfExtents = Rng.Vector(0.3f, 1.0f);
+				desc.Pose = PxTransform(PxVec3(Rng.Range(-50, 50), Rng.Range(1, 10), Rng.Range(-50, 50)), Rng.Rotation());
+			}
+			Engine.CreateDynamicActors(descs, false, Scene);
+		}
+
+		virtual void Update(PhysicsEngine& Engine, SceneID Scene, Random& Rng, uint32_t /*Frame*/, float /*ElapsedTime*/)
+		{
+			Batch.Clear();
+			for (uint32_t i = 0; i < 16384; i++)
+			{
+				const PxVec3 origin(Rng.Range(-60, 60), 30.0f, Rng.Range(-60, 60));
+				const PxVec3 direction = PxVec3(Rng.Range(-0.3f, 0.3f), -1.0f, Rng.Range(-0.3f, 0.3f)).getNormalized();
+				Batch.AddRaycast(origin, direction, 100.0f, (i & 3) == 0);
+			}
+			Engine.ExecuteQueries(Batch, Scene);
+		}
+	};
+
+	// Cooking of terrain like triangle meshes, without simulating
+	class MeshCooking : public Scenario
+	{
+	public:
+		virtual const char * GetName() const { return "mesh_cooking"; }
+		virtual uint32_t GetFrames() const { return 32; }
+		virtual uint32_t GetWarmupFrames() const { return 2; }
+		virtual bool Simulates() const { return false; }
+
+		virtual void Setup(PhysicsEngine& /*Engine*/, SceneID /*Scene*/, Random& /*Rng*/) {}
+
+		virtual void Update(PhysicsEngine& Engine, SceneID /*Scene*/, Random& Rng, uint32_t Frame, float /*ElapsedTime*/)
+		{
+			// 64x64 quads, 8192 triangles
+			const uint32_t size = 65;
+			vector<PxVec3> vertices(size * size);
+			for (uint32_t z = 0; z < size; z++)
+				for (uint32_t x = 0; x < size; x++)
+					vertices[z * size + x] = PxVec3(float(x), Rng.Range(0.0f, 2.0f), float(z));
+
+			vector<uint32_t> indices;
+			indices.reserve((size - 1) * (size - 1) * 6);
+			for (uint32_t z = 0; z + 1 < size; z++)
+			{
+				for (uint32_t x = 0; x + 1 < size; x++)
+				{
+					const uint32_t i = z * size + x;
+					indices.insert(indices.end(), { i, i + size, i + 1, i + 1, i + size, i + size + 1 });
+				}
+			}
+
+			// Alternate both modes, the stream one also serializes the cooked data
+			auto mesh_id = Engine.CreatePhysicsTriangleMesh(vertices, indices, (Frame & 1) ? MeshCookingMode::Stream : MeshCookingMode::Direct);
+			Engine.ReleaseMesh(mesh_id);
+		}
+	};
+}
+
+std::vector<std::unique_ptr<Scenario>> CreateScenarios()
+{
+	vector<unique_ptr<Scenario>> scenarios;
+	scenarios.emplace_back(new BoxStacks());
+	scenarios.emplace_back(new DebrisPile());
+	scenarios.emplace_back(new RagdollCrowd());
+	scenarios.emplace_back(new VehiclesOnHeightfield());
+	scenarios.emplace_back(new CharacterCrowd());
+	scenarios.emplace_back(new RaycastStorm());
+	scenarios.emplace_back(new MeshCooking());
+	return scenarios;
+}
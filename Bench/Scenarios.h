@@ -0,0 +1,56 @@
+#pragma once
+#include "PhysicsEngine.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Small deterministic generator, the standard distributions are not guaranteed to give the same numbers on every library
+class Random
+{
+	uint64_t State;
+public:
+	explicit Random(uint64_t Seed) : State(Seed ? Seed : 0x9e3779b97f4a7c15ull) {}
+
+	uint32_t Next()
+	{
+		// xorshift64*
+		State ^= State >> 12;
+		State ^= State << 25;
+		State ^= State >> 27;
+		return uint32_t((State * 0x2545f4914f6cdd1dull) >> 32);
+	}
+
+	// Uniform in [Min, Max)
+	float Range(float Min, float Max) { return Min + (Max - Min) * float(Next() >> 8) * (1.0f / 16777216.0f); }
+	uint32_t Index(uint32_t Count) { return Next() % Count; }
+	PxVec3 Vector(float Min, float Max) { return PxVec3(Range(Min, Max), Range(Min, Max), Range(Min, Max)); }
+	PxQuat Rotation()
+	{
+		PxQuat q(Range(-1, 1), Range(-1, 1), Range(-1, 1), Range(-1, 1));
+		return q.magnitudeSquared() > 1e-6f ? q.getNormalized() : PxQuat(PxIdentity);
+	}
+};
+
+// A reproducible workload. The runner creates a scene for it, calls Setup once, then Update before each step
+class Scenario
+{
+public:
+	virtual ~Scenario() = default;
+
+	virtual const char * GetName() const = 0;
+	// Frames measured, before scaling by the command line
+	virtual uint32_t GetFrames() const { return 600; }
+	// Frames run before measuring, so the measures don't include the initial fall of the bodies
+	virtual uint32_t GetWarmupFrames() const { return 30; }
+	// False for the scenarios that only measure Update (e.g. cooking)
+	virtual bool Simulates() const { return true; }
+
+	virtual void Setup(PhysicsEngine& Engine, SceneID Scene, Random& Rng) = 0;
+	// Work done by the game before each step (moving characters, queries...), timed separately from the step
+	virtual void Update(PhysicsEngine& /*Engine*/, SceneID /*Scene*/, Random& /*Rng*/, uint32_t /*Frame*/, float /*ElapsedTime*/) {}
+	// Released before the scene, for what the scene doesn't own
+	virtual void Teardown(PhysicsEngine& /*Engine*/) {}
+};
+
+// Every scenario, in the order they are run
+std::vector<std::unique_ptr<Scenario>> CreateScenarios();
@@ -0,0 +1,327 @@
+#include "PhysicsEngine.h"
+#include "Scenarios.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace
+{
+	// Forwards to the pool allocator of the wrapper, counting the allocations and the live memory
+	// Each block gets a 16 byte header with its size, which keeps the SDK alignment
+	class CountingAllocator : public PxAllocatorCallback
+	{
+		static const size_t HeaderSize = 16;
+
+		PoolAllocator Allocator;
+	public:
+		atomic<uint64_t> Allocations{ 0 };
+		atomic<uint64_t> AllocatedBytes{ 0 };
+		atomic<uint64_t> LiveBytes{ 0 };
+		atomic<uint64_t> PeakBytes{ 0 };
+
+		virtual void* allocate(size_t size, const char* typeName, const char* filename, int line)
+		{
+			auto block = static_cast<uint8_t*>(Allocator.allocate(size + HeaderSize, typeName, filename, line));
+			if (!block)
+				return nullptr;
+			*reinterpret_cast<size_t*>(block) = size;
+
+			Allocations.fetch_add(1, memory_order_relaxed);
+			AllocatedBytes.fetch_add(size, memory_order_relaxed);
+			const uint64_t live = LiveBytes.fetch_add(size, memory_order_relaxed) + size;
+			uint64_t peak = PeakBytes.load(memory_order_relaxed);
+			while (live > peak && !PeakBytes.compare_exchange_weak(peak, live, memory_order_relaxed));
+
+			return block + HeaderSize;
+		}
+
+		virtual void deallocate(void* ptr)
+		{
+			if (!ptr)
+				return;
+
+			auto block = static_cast<uint8_t*>(ptr) - HeaderSize;
+			LiveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), memory_order_relaxed);
+			Allocator.deallocate(block);
+		}
+
+		void ResetPeak() { PeakBytes.store(LiveBytes.load(memory_order_relaxed), memory_order_relaxed); }
+	};
+
+	struct Options
+	{
+		uint32_t Threads = 4;
+		uint64_t Seed = 1234;
+		float FrameScale = 1.0f;
+		string OutputPath;
+		vector<string> Scenarios;
+		bool List = false;
+	};
+
+	struct Distribution
+	{
+		double Mean = 0, P50 = 0, P95 = 0, Max = 0;
+	};
+
+	Distribution Summarize(vector<double> Samples)
+	{
+		Distribution d;
+		if (Samples.empty())
+			return d;
+
+		sort(Samples.begin(), Samples.end());
+		for (double sample : Samples)
+			d.Mean += sample;
+		d.Mean /= Samples.size();
+		d.P50 = Samples[Samples.size() / 2];
+		d.P95 = Samples[min(Samples.size() - 1, Samples.size() * 95 / 100)];
+		d.Max = Samples.back();
+		return d;
+	}
+
+	struct ScenarioResult
+	{
+		string Name;
+		uint32_t Frames = 0;
+		double SetupMs = 0;
+		Distribution FrameMs, UpdateMs, SimulateMs;
+		double StageWallUs[PxSimulationStatistics::eSTAGE_COUNT] = {};
+		double StageCpuUs[PxSimulationStatistics::eSTAGE_COUNT] = {};
+		uint64_t Allocations = 0;
+		uint64_t AllocatedBytes = 0;
+		uint64_t PeakBytes = 0;
+		uint64_t LiveBytesEnd = 0;
+		// Memory not given back once the scene and the scenario objects are released
+		int64_t RetainedBytes = 0;
+		uint32_t DynamicBodies = 0;
+		uint32_t ActiveBodies = 0;
+		// Sum of the final positions of the actors, changes if the simulation gives different results
+		double PoseChecksum = 0;
+	};
+
+	const char * const StageNames[PxSimulationStatistics::eSTAGE_COUNT] =
+	{
+		"broad_phase", "narrow_phase", "island_gen", "solver", "integration", "ccd", "scene_query_update", "callbacks"
+	};
+
+	double Milliseconds(chrono::steady_clock::duration Duration)
+	{
+		return chrono::duration<double, milli>(Duration).count();
+	}
+
+	ScenarioResult RunScenario(PhysicsEngine& Engine, CountingAllocator& Allocator, Scenario& Bench, const Options& Settings)
+	{
+		const float elapsed_time = 1.0f / 60.0f;
+
+		ScenarioResult result;
+		result.Name = Bench.GetName();
+		result.Frames = max(1u, uint32_t(Bench.GetFrames() * Settings.FrameScale));
+
+		// Each scenario gets its own generator, so running a subset gives the same numbers
+		Random rng(Settings.Seed ^ hash<string>()(result.Name));
+		const uint64_t live_before = Allocator.LiveBytes.load();
+
+		auto start = chrono::steady_clock::now();
+		SceneID scene = Engine.CreateScene();
+		Bench.Setup(Engine, scene, rng);
+		result.SetupMs = Milliseconds(chrono::steady_clock::now() - start);
+
+		uint32_t frame = 0;
+		for (uint32_t i = 0; i < Bench.GetWarmupFrames(); i++, frame++)
+		{
+			Bench.Update(Engine, scene, rng, frame, elapsed_time);
+			if (Bench.Simulates())
+				Engine.Simulate(elapsed_time, scene);
+		}
+
+		const uint64_t allocations_before = Allocator.Allocations.load();
+		const uint64_t bytes_before = Allocator.AllocatedBytes.load();
+		Allocator.ResetPeak();
+
+		vector<double> frame_ms, update_ms, simulate_ms;
+		PxSimulationStatistics stats;
+		for (uint32_t i = 0; i < result.Frames; i++, frame++)
+		{
+			auto frame_start = chrono::steady_clock::now();
+			Bench.Update(Engine, scene, rng, frame, elapsed_time);
+			auto update_end = chrono::steady_clock::now();
+			if (Bench.Simulates())
+				Engine.Simulate(elapsed_time, scene);
+			auto frame_end = chrono::steady_clock::now();
+
+			update_ms.push_back(Milliseconds(update_end - frame_start));
+			simulate_ms.push_back(Milliseconds(frame_end - update_end));
+			frame_ms.push_back(Milliseconds(frame_end - frame_start));
+
+			if (Bench.Simulates() && Engine.GetSimulationStatistics(stats, scene))
+			{
+				for (uint32_t s = 0; s < PxSimulationStatistics::eSTAGE_COUNT; s++)
+				{
+					result.StageWallUs[s] += stats.stageWallTime[s];
+					result.StageCpuUs[s] += stats.stageCpuTime[s];
+				}
+			}
+		}
+
+		for (uint32_t s = 0; s < PxSimulationStatistics::eSTAGE_COUNT; s++)
+		{
+			result.StageWallUs[s] /= result.Frames;
+			result.StageCpuUs[s] /= result.Frames;
+		}
+		result.FrameMs = Summarize(frame_ms);
+		result.UpdateMs = Summarize(update_ms);
+		result.SimulateMs = Summarize(simulate_ms);
+		result.Allocations = Allocator.Allocations.load() - allocations_before;
+		result.AllocatedBytes = Allocator.AllocatedBytes.load() - bytes_before;
+		result.PeakBytes = Allocator.PeakBytes.load();
+		result.LiveBytesEnd = Allocator.LiveBytes.load();
+
+		if (Bench.Simulates() && Engine.GetSimulationStatistics(stats, scene))
+		{
+			result.DynamicBodies = stats.nbDynamicBodies;
+			result.ActiveBodies = stats.nbActiveDynamicBodies;
+		}
+
+		// Only the actors of this scene are registered at this point
+		const ActorID * ids;
+		const PxVec3 * positions;
+		const PxQuat * rotations;
+		const size_t actor_count = Engine.GetActorPoses(ids, positions, rotations);
+		for (size_t i = 0; i < actor_count; i++)
+			result.PoseChecksum += double(positions[i].x) + double(positions[i].y) + double(positions[i].z);
+
+		Bench.Teardown(Engine);
+		Engine.ReleaseScene(scene);
+		result.RetainedBytes = int64_t(Allocator.LiveBytes.load()) - int64_t(live_before);
+
+		return result;
+	}
+
+	void WriteDistribution(ostream& Out, const char * Name, const Distribution& D)
+	{
+		Out << "\"" << Name << "\": { \"mean\": " << D.Mean << ", \"p50\": " << D.P50 << ", \"p95\": " << D.P95 << ", \"max\": " << D.Max << " }";
+	}
+
+	void WriteStages(ostream& Out, const char * Name, const double * Values)
+	{
+		Out << "\"" << Name << "\": { ";
+		for (uint32_t s = 0; s < PxSimulationStatistics::eSTAGE_COUNT; s++)
+			Out << (s ? ", " : "") << "\"" << StageNames[s] << "\": " << Values[s];
+		Out << " }";
+	}
+
+	void WriteReport(ostream& Out, const Options& Settings, const vector<ScenarioResult>& Results)
+	{
+		Out.precision(6);
+		Out << "{\n";
+		Out << "  \"seed\": " << Settings.Seed << ",\n";
+		Out << "  \"threads\": " << Settings.Threads << ",\n";
+		Out << "  \"frame_scale\": " << Settings.FrameScale << ",\n";
+		Out << "  \"scenarios\": [\n";
+		for (size_t i = 0; i < Results.size(); i++)
+		{
+			const auto& r = Results[i];
+			Out << "    {\n";
+			Out << "      \"name\": \"" << r.Name << "\",\n";
+			Out << "      \"frames\": " << r.Frames << ",\n";
+			Out << "      \"setup_ms\": " << r.SetupMs << ",\n";
+			Out << "      "; WriteDistribution(Out, "frame_ms", r.FrameMs); Out << ",\n";
+			Out << "      "; WriteDistribution(Out, "update_ms", r.UpdateMs); Out << ",\n";
+			Out << "      "; WriteDistribution(Out, "simulate_ms", r.SimulateMs); Out << ",\n";
+			Out << "      "; WriteStages(Out, "stage_wall_us", r.StageWallUs); Out << ",\n";
+			Out << "      "; WriteStages(Out, "stage_cpu_us", r.StageCpuUs); Out << ",\n";
+			Out << "      \"allocations\": { \"count\": " << r.Allocations << ", \"bytes\": " << r.AllocatedBytes
+				<< ", \"per_frame\": " << double(r.Allocations) / r.Frames << " },\n";
+			Out << "      \"memory\": { \"peak_bytes\": " << r.PeakBytes << ", \"live_bytes_end\": " << r.LiveBytesEnd
+				<< ", \"retained_bytes\": " << r.RetainedBytes << " },\n";
+			Out << "      \"bodies\": { \"dynamic\": " << r.DynamicBodies << ", \"active\": " << r.ActiveBodies << " },\n";
+			Out << "      \"pose_checksum\": " << r.PoseChecksum << "\n";
+			Out << "    }" << (i + 1 < Results.size() ? "," : "") << "\n";
+		}
+		Out << "  ]\n";
+		Out << "}\n";
+	}
+
+	bool ParseOptions(int argc, char ** argv, Options& Settings)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const bool has_value = i + 1 < argc;
+			if (!strcmp(argv[i], "--threads") && has_value)
+				Settings.Threads = uint32_t(strtoul(argv[++i], nullptr, 10));
+			else if (!strcmp(argv[i], "--seed") && has_value)
+				Settings.Seed = strtoull(argv[++i], nullptr, 10);
+			else if (!strcmp(argv[i], "--frame-scale") && has_value)
+				Settings.FrameScale = float(atof(argv[++i]));
+			else if (!strcmp(argv[i], "--out") && has_value)
+				Settings.OutputPath = argv[++i];
+			else if (!strcmp(argv[i], "--scenario") && has_value)
+				Settings.Scenarios.push_back(argv[++i]);
+			else if (!strcmp(argv[i], "--list"))
+				Settings.List = true;
+			else
+			{
+				cout << "Usage: SimplePhysXBench [--threads N] [--seed N] [--frame-scale F] [--scenario NAME]... [--out FILE] [--list]" << endl;
+				return false;
+			}
+		}
+		return Settings.FrameScale > 0.0f;
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	Options settings;
+	if (!ParseOptions(argc, argv, settings))
+		return 1;
+
+	auto scenarios = CreateScenarios();
+	if (settings.List)
+	{
+		for (auto& scenario : scenarios)
+			cout << scenario->GetName() << endl;
+		return 0;
+	}
+
+	CountingAllocator allocator;
+	vector<ScenarioResult> results;
+	{
+		// No mesh cache, the cooking has to be measured
+		PhysicsEngine physics;
+		if (!physics.Initialize(settings.Threads, PxVec3(0.0f, -9.81f, 0.0f), string(), &allocator))
+			return 1;
+
+		for (auto& scenario : scenarios)
+		{
+			if (!settings.Scenarios.empty() && find(settings.Scenarios.begin(), settings.Scenarios.end(), scenario->GetName()) == settings.Scenarios.end())
+				continue;
+
+			cerr << "Running " << scenario->GetName() << "..." << endl;
+			results.push_back(RunScenario(physics, allocator, *scenario, settings));
+		}
+	}
+
+	if (settings.OutputPath.empty())
+		WriteReport(cout, settings, results);
+	else
+	{
+		ofstream file(settings.OutputPath);
+		if (!file)
+		{
+			cout << "Could not open " << settings.OutputPath << endl;
+			return 1;
+		}
+		WriteReport(file, settings, results);
+	}
+
+	// Errors reported by the SDK make the run suspicious
+	return PhysicsEngine::GetLogCounters().Errors ? 2 : 0;
+}
@@ -0,0 +1,234 @@
+#include "Allocators.h"
+#include <mutex>
+#include <algorithm>
+
+namespace
+{
+	// Every block starts with a header holding its size class, which keeps the user pointer 16 byte aligned
+	const size_t HeaderSize = 16;
+	const uint32_t LargeClass = UINT32_MAX;
+
+	// Classes are every 16 bytes up to 256, then 1.5x steps up to MaxPooledSize
+	constexpr size_t ClassSizes[] =
+	{
+		16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256,
+		384, 512, 768, 1024, 1536, 2048
+	};
+	constexpr uint32_t NumClasses = uint32_t(sizeof(ClassSizes) / sizeof(ClassSizes[0]));
+	static_assert(ClassSizes[NumClasses - 1] == PoolAllocator::MaxPooledSize, "The last size class must match MaxPooledSize");
+
+	// Size of the chunks requested to the system to carve blocks from
+	const size_t ChunkSize = 64 * 1024;
+
+	uint32_t GetSizeClass(size_t Size)
+	{
+		if (Size <= 256)
+			return Size == 0 ? 0 : uint32_t((Size - 1) / 16);
+
+		uint32_t size_class = 16;
+		while (ClassSizes[size_class] < Size)
+			size_class++;
+		return size_class;
+	}
+
+	// Number of blocks moved at once between a thread cache and the shared pool
+	uint32_t GetBatchSize(uint32_t SizeClass)
+	{
+		return uint32_t(std::min<size_t>(std::max<size_t>(16 * 1024 / (ClassSizes[SizeClass] + HeaderSize), 8), 64));
+	}
+
+	struct FreeBlock
+	{
+		FreeBlock * Next;
+	};
+
+	struct SharedPool
+	{
+		std::mutex Mutex;
+		FreeBlock * Free = nullptr;
+	};
+
+	// Intentionally never destroyed, threads that exit after main still flush their caches here
+	// The chunks are given back to the system when the process ends
+	SharedPool * GetSharedPools()
+	{
+		static SharedPool * pools = new SharedPool[NumClasses];
+		return pools;
+	}
+
+	// Pops up to Count blocks from the shared pool, carving a new chunk if it doesn't have enough
+	// Returns the number of blocks added to List
+	uint32_t TakeFromShared(uint32_t SizeClass, uint32_t Count, FreeBlock *& List)
+	{
+		SharedPool& pool = GetSharedPools()[SizeClass];
+		std::lock_guard<std::mutex> lock(pool.Mutex);
+
+		uint32_t taken = 0;
+		while (taken < Count)
+		{
+			if (!pool.Free)
+			{
+				const size_t stride = ClassSizes[SizeClass] + HeaderSize;
+				uint8_t * chunk = static_cast<uint8_t*>(platformAlignedAlloc(ChunkSize));
+				if (!chunk)
+					break;
+
+				for (size_t offset = 0; offset + stride <= ChunkSize; offset += stride)
+				{
+					*reinterpret_cast<uint32_t*>(chunk + offset) = SizeClass;
+					FreeBlock * block = reinterpret_cast<FreeBlock*>(chunk + offset + HeaderSize);
+					block->Next = pool.Free;
+					pool.Free = block;
+				}
+			}
+
+			FreeBlock * block = pool.Free;
+			pool.Free = block->Next;
+			block->Next = List;
+			List = block;
+			taken++;
+		}
+
+		return taken;
+	}
+
+	// Moves Count blocks from the front of List back to the shared pool
+	void GiveToShared(uint32_t SizeClass, uint32_t Count, FreeBlock *& List)
+	{
+		SharedPool& pool = GetSharedPools()[SizeClass];
+		std::lock_guard<std::mutex> lock(pool.Mutex);
+
+		for (uint32_t i = 0; i < Count && List; i++)
+		{
+			FreeBlock * block = List;
+			List = block->Next;
+			block->Next = pool.Free;
+			pool.Free = block;
+		}
+	}
+
+	struct ThreadCache
+	{
+		FreeBlock * Lists[NumClasses] = {};
+		uint32_t Counts[NumClasses] = {};
+
+		~ThreadCache()
+		{
+			Flush();
+		}
+
+		void Flush()
+		{
+			for (uint32_t size_class = 0; size_class < NumClasses; size_class++)
+			{
+				GiveToShared(size_class, Counts[size_class], Lists[size_class]);
+				Counts[size_class] = 0;
+			}
+		}
+	};
+
+	thread_local ThreadCache Cache;
+}
+
+void* PoolAllocator::allocate(size_t size, const char*, const char*, int)
+{
+	if (size > MaxPooledSize)
+	{
+		uint8_t * memory = static_cast<uint8_t*>(platformAlignedAlloc(size + HeaderSize));
+		if (!memory)
+			return nullptr;
+
+		*reinterpret_cast<uint32_t*>(memory) = LargeClass;
+		return memory + HeaderSize;
+	}
+
+	const uint32_t size_class = GetSizeClass(size);
+	if (!Cache.Lists[size_class])
+	{
+		Cache.Counts[size_class] += TakeFromShared(size_class, GetBatchSize(size_class), Cache.Lists[size_class]);
+		if (!Cache.Lists[size_class])
+			return nullptr;
+	}
+
+	FreeBlock * block = Cache.Lists[size_class];
+	Cache.Lists[size_class] = block->Next;
+	Cache.Counts[size_class]--;
+
+	PX_ASSERT((reinterpret_cast<size_t>(block) & 15) == 0);
+	return block;
+}
+
+void PoolAllocator::deallocate(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	uint8_t * header = static_cast<uint8_t*>(ptr) - HeaderSize;
+	const uint32_t size_class = *reinterpret_cast<uint32_t*>(header);
+	if (size_class == LargeClass)
+	{
+		platformAlignedFree(header);
+		return;
+	}
+
+	FreeBlock * block = static_cast<FreeBlock*>(ptr);
+	block->Next = Cache.Lists[size_class];
+	Cache.Lists[size_class] = block;
+	Cache.Counts[size_class]++;
+
+	// Don't let a thread that frees more than it allocates hoard the memory
+	const uint32_t batch = GetBatchSize(size_class);
+	if (Cache.Counts[size_class] > 2 * batch)
+	{
+		GiveToShared(size_class, batch, Cache.Lists[size_class]);
+		Cache.Counts[size_class] -= batch;
+	}
+}
+
+void PoolAllocator::FlushThreadCache()
+{
+	Cache.Flush();
+}
+
+FrameArena::~FrameArena()
+{
+	if (Memory)
+		Allocator->deallocate(Memory);
+}
+
+void FrameArena::Initialize(PxAllocatorCallback& Allocator, size_t Capacity)
+{
+	if (Memory)
+		this->Allocator->deallocate(Memory);
+
+	this->Allocator = &Allocator;
+	this->Capacity = Capacity;
+	Memory = static_cast<uint8_t*>(Allocator.allocate(Capacity, "FrameArena", __FILE__, __LINE__));
+	if (!Memory)
+		this->Capacity = 0;
+	Offset = 0;
+	Peak = 0;
+}
+
+void * FrameArena::Allocate(size_t Size, size_t Alignment)
+{
+	// Align the address and not the offset, the backing memory is only guaranteed to be 16 byte aligned
+	const size_t base = reinterpret_cast<size_t>(Memory);
+	const size_t start = ((base + Offset + Alignment - 1) & ~(Alignment - 1)) - base;
+	Peak = std::max(Peak, start + Size);
+	if (!Memory || start + Size > Capacity)
+		return nullptr;
+
+	Offset = start + Size;
+	return Memory + start;
+}
+
+void FrameArena::Reset()
+{
+	// Grow to fit the last frame, so the overflow only happens once
+	if (Allocator && Peak > Capacity)
+		Initialize(*Allocator, std::max(Peak, Capacity * 2));
+
+	Offset = 0;
+	Peak = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <cstddef>
+#include <cstdint>
+
+using namespace physx;
+
+// Allocator for the SDK that serves small blocks from size class pools
+// Each thread keeps a cache of free blocks per size class, so most allocations and frees don't take any lock
+// Blocks are only moved (in batches) between the thread caches and the shared pools when a cache runs empty or grows too much
+// Big requests go straight to the system allocator
+// The pools are shared by every instance, so a block can be freed through any of them
+class PoolAllocator : public PxAllocatorCallback
+{
+public:
+	// Biggest request served by the pools, in bytes
+	static const size_t MaxPooledSize = 2048;
+
+	virtual void* allocate(size_t size, const char* typeName, const char* filename, int line);
+	virtual void deallocate(void* ptr);
+
+	// Returns the blocks cached by the calling thread to the shared pools
+	// Done automatically when a thread exits, but worker threads that are parked for a long time can call it to give memory back
+	static void FlushThreadCache();
+};
+
+// Linear allocator for data that lives for a single frame
+// Allocation is a pointer bump, and everything is freed at once with Reset
+// Not thread safe
+class FrameArena
+{
+	PxAllocatorCallback * Allocator = nullptr;
+	uint8_t * Memory = nullptr;
+	size_t Capacity = 0;
+	size_t Offset = 0;
+	// Biggest amount requested since the last Reset, including the requests that didn't fit
+	size_t Peak = 0;
+public:
+	FrameArena() = default;
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+	~FrameArena();
+
+	// Allocates the backing memory from the provided allocator
+	void Initialize(PxAllocatorCallback& Allocator, size_t Capacity);
+
+	// Returns nullptr if the arena is full. The arena grows on the next Reset to fit the peak usage
+	// Alignment must be a power of two
+	void * Allocate(size_t Size, size_t Alignment = 16);
+
+	// Frees every allocation made since the last Reset
+	void Reset();
+
+	size_t GetCapacity() const { return Capacity; }
+	size_t GetUsed() const { return Offset; }
+};
@@ -0,0 +1,212 @@
+#include "LogSink.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstring>
+
+LogSink::LogSink()
+	: EnqueuePos(0), MaxPerSecond(10), Info(0), Warnings(0), PerfWarnings(0), Errors(0), Dropped(0), Suppressed(0)
+{
+	for (uint32_t i = 0; i < QueueSize; i++)
+		Queue[i].Sequence.store(i, std::memory_order_relaxed);
+
+	for (auto& slot : RateSlots)
+	{
+		slot.Key.store(0, std::memory_order_relaxed);
+		slot.WindowStart.store(0, std::memory_order_relaxed);
+		slot.Count.store(0, std::memory_order_relaxed);
+	}
+}
+
+LogSink::~LogSink()
+{
+	Stop();
+}
+
+bool LogSink::CheckRate(const char * File, int Line)
+{
+	const uint32_t max_per_second = MaxPerSecond.load(std::memory_order_relaxed);
+	if (!max_per_second)
+		return true;
+
+	// File names come from __FILE__, so the pointer identifies the file
+	const uint64_t key = ((uint64_t(reinterpret_cast<size_t>(File)) << 16) ^ uint64_t(uint32_t(Line))) | 1;
+	const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	// Two call sites can share a slot and two threads can reset it at the same time, which only makes the limit approximate
+	RateSlot& slot = RateSlots[(key ^ (key >> 17)) % RateSlotCount];
+	if (slot.Key.load(std::memory_order_relaxed) != key || slot.WindowStart.load(std::memory_order_relaxed) != now)
+	{
+		slot.Key.store(key, std::memory_order_relaxed);
+		slot.WindowStart.store(now, std::memory_order_relaxed);
+		slot.Count.store(0, std::memory_order_relaxed);
+	}
+
+	return slot.Count.fetch_add(1, std::memory_order_relaxed) < max_per_second;
+}
+
+void LogSink::reportError(PxErrorCode::Enum code, const char* message, const char* file, int line)
+{
+	switch (code)
+	{
+	case PxErrorCode::eDEBUG_INFO:
+	case PxErrorCode::eNO_ERROR:
+		Info.fetch_add(1, std::memory_order_relaxed);
+		break;
+	case PxErrorCode::eDEBUG_WARNING:
+		Warnings.fetch_add(1, std::memory_order_relaxed);
+		break;
+	case PxErrorCode::ePERF_WARNING:
+		PerfWarnings.fetch_add(1, std::memory_order_relaxed);
+		break;
+	default:
+		Errors.fetch_add(1, std::memory_order_relaxed);
+		break;
+	}
+
+	if (!CheckRate(file, line))
+	{
+		Suppressed.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// Claim a cell, giving up if the queue is full instead of waiting for the drain thread
+	uint32_t pos = EnqueuePos.load(std::memory_order_relaxed);
+	Entry * entry;
+	while (true)
+	{
+		entry = &Queue[pos % QueueSize];
+		const int32_t diff = int32_t(entry->Sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0)
+		{
+			if (EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			Dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+			pos = EnqueuePos.load(std::memory_order_relaxed);
+	}
+
+	entry->Code = code;
+	entry->File = file;
+	entry->Line = line;
+	strncpy(entry->Message, message ? message : "", MaxMessageLength - 1);
+	entry->Message[MaxMessageLength - 1] = '\0';
+	entry->Sequence.store(pos + 1, std::memory_order_release);
+
+	// Errors are rare and usually come before a crash, so don't wait for the next drain
+	if (code != PxErrorCode::eDEBUG_INFO && code != PxErrorCode::eNO_ERROR && code != PxErrorCode::eDEBUG_WARNING && code != PxErrorCode::ePERF_WARNING)
+		Wake.notify_one();
+}
+
+uint32_t LogSink::Drain()
+{
+	using namespace std;
+
+	string text;
+	uint32_t count = 0;
+	while (true)
+	{
+		Entry& entry = Queue[DequeuePos % QueueSize];
+		if (int32_t(entry.Sequence.load(memory_order_acquire) - (DequeuePos + 1)) < 0)
+			break;
+
+		switch (entry.Code)
+		{
+		case PxErrorCode::eDEBUG_INFO:
+		case PxErrorCode::eNO_ERROR:
+			text += "[Info]";
+			break;
+		case PxErrorCode::eDEBUG_WARNING:
+		case PxErrorCode::ePERF_WARNING:
+			text += "[Warning]";
+			break;
+		default:
+			text += "[Error]";
+			break;
+		}
+		text += " : ";
+		text += entry.Message;
+		text += "\n    ";
+		text += entry.File ? entry.File : "";
+		text += " @ ";
+		text += to_string(entry.Line);
+		text += "\n";
+
+		// Hand the cell back to the producers of the next lap
+		entry.Sequence.store(DequeuePos + QueueSize, memory_order_release);
+		DequeuePos++;
+		count++;
+	}
+
+	const uint64_t suppressed = Suppressed.load(memory_order_relaxed);
+	if (suppressed != ReportedSuppressed)
+	{
+		text += "[Warning] : " + to_string(suppressed - ReportedSuppressed) + " repeated messages were suppressed\n";
+		ReportedSuppressed = suppressed;
+	}
+
+	// A single flush per batch
+	if (!text.empty())
+		cout << text << flush;
+
+	return count;
+}
+
+void LogSink::Start()
+{
+	if (DrainThread.joinable())
+		return;
+
+	Quit = false;
+	DrainThread = std::thread([this]
+	{
+		using namespace std;
+
+		while (true)
+		{
+			bool quit;
+			{
+				unique_lock<mutex> lock(WakeMutex);
+				Wake.wait_for(lock, chrono::milliseconds(20), [this] { return Quit; });
+				quit = Quit;
+			}
+
+			Drain();
+			if (quit)
+				return;
+		}
+	});
+}
+
+void LogSink::Stop()
+{
+	if (DrainThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(WakeMutex);
+			Quit = true;
+		}
+		Wake.notify_one();
+		DrainThread.join();
+	}
+
+	// Whatever was reported without the thread running
+	Drain();
+}
+
+LogCounters LogSink::GetCounters() const
+{
+	LogCounters counters;
+	counters.Info = Info.load(std::memory_order_relaxed);
+	counters.Warnings = Warnings.load(std::memory_order_relaxed);
+	counters.PerfWarnings = PerfWarnings.load(std::memory_order_relaxed);
+	counters.Errors = Errors.load(std::memory_order_relaxed);
+	counters.Dropped = Dropped.load(std::memory_order_relaxed);
+	counters.Suppressed = Suppressed.load(std::memory_order_relaxed);
+	return counters;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace physx;
+
+// Totals of the messages reported to a LogSink, for metrics
+struct LogCounters
+{
+	uint64_t Info = 0;
+	uint64_t Warnings = 0;
+	uint64_t PerfWarnings = 0;
+	uint64_t Errors = 0;
+	// Lost because the queue was full
+	uint64_t Dropped = 0;
+	// Skipped by the per call site rate limit
+	uint64_t Suppressed = 0;
+};
+
+// Error callback that never blocks the reporting thread
+// Messages are copied to a lock free queue and printed by a background thread, so worker threads don't serialize on the console
+// Each call site (file and line) can report at most the configured number of messages per second, the rest are only counted
+class LogSink : public PxErrorCallback
+{
+	static const uint32_t QueueSize = 1024;
+	static const uint32_t MaxMessageLength = 256;
+	static const uint32_t RateSlotCount = 512;
+	static_assert((QueueSize & (QueueSize - 1)) == 0, "The queue size must be a power of two so the positions can wrap around");
+
+	struct Entry
+	{
+		// Vyukov bounded queue sequence, tells producers and the consumer whose turn it is
+		std::atomic<uint32_t> Sequence;
+		PxErrorCode::Enum Code;
+		const char * File;
+		int Line;
+		char Message[MaxMessageLength];
+	};
+
+	// Messages reported by a call site on the current one second window
+	struct RateSlot
+	{
+		std::atomic<uint64_t> Key;
+		std::atomic<int64_t> WindowStart;
+		std::atomic<uint32_t> Count;
+	};
+
+	Entry Queue[QueueSize];
+	std::atomic<uint32_t> EnqueuePos;
+	uint32_t DequeuePos = 0;
+
+	RateSlot RateSlots[RateSlotCount];
+	std::atomic<uint32_t> MaxPerSecond;
+
+	std::atomic<uint64_t> Info, Warnings, PerfWarnings, Errors, Dropped, Suppressed;
+	// Suppressed count already reported by the drain thread
+	uint64_t ReportedSuppressed = 0;
+
+	std::mutex WakeMutex;
+	std::condition_variable Wake;
+	bool Quit = false;
+	std::thread DrainThread;
+
+	// Returns false if the message must be skipped because of the rate limit
+	bool CheckRate(const char * File, int Line);
+
+	// Prints every queued message, returns the number printed
+	uint32_t Drain();
+public:
+	LogSink();
+	LogSink(const LogSink&) = delete;
+	LogSink& operator=(const LogSink&) = delete;
+	~LogSink();
+
+	virtual void reportError(PxErrorCode::Enum code, const char* message, const char* file, int line);
+
+	// Starts the background thread. Messages reported before are kept on the queue
+	void Start();
+
+	// Prints whatever is left on the queue and stops the background thread
+	void Stop();
+
+	// Messages per second allowed for each call site, 0 disables the limit
+	void SetRateLimit(uint32_t MessagesPerSecond) { MaxPerSecond = MessagesPerSecond; }
+
+	LogCounters GetCounters() const;
+};
@@ -0,0 +1,311 @@
+#include "PartitionedWorld.h"
+#include <algorithm>
+#include <cmath>
+
+bool PartitionedWorld::Initialize(PhysicsEngine& Engine, const PartitionedWorldSettings& Settings)
+{
+	using namespace std;
+
+	Release();
+
+	if (!Settings.TilesX || !Settings.TilesZ || Settings.TileSize <= 0.0f || Settings.GhostMargin < 0.0f || Settings.GhostMargin * 2.0f >= Settings.TileSize)
+	{
+		cout << "PartitionedWorld needs at least one tile, and a ghost margin below half the tile size" << endl;
+		return false;
+	}
+
+	this->Engine = &Engine;
+	this->Settings = Settings;
+
+	Tiles.reserve(Settings.TilesX * Settings.TilesZ);
+	for (uint32_t i = 0; i < Settings.TilesX * Settings.TilesZ; i++)
+	{
+		SceneID scene = Engine.CreateScene(Settings.Scene, Settings.Gravity);
+		if (!scene.IsValid())
+		{
+			Release();
+			return false;
+		}
+		Tiles.push_back(scene);
+	}
+
+	return true;
+}
+
+void PartitionedWorld::Release()
+{
+	if (!Engine)
+		return;
+
+	for (auto& body : Bodies)
+		ReleaseGhosts(body);
+	Bodies.clear();
+	BodyIndices.clear();
+
+	for (SceneID scene : Tiles)
+		Engine->ReleaseScene(scene);
+	Tiles.clear();
+
+	Engine = nullptr;
+}
+
+uint32_t PartitionedWorld::GetTileIndex(PxVec3 Position) const
+{
+	const float x = floorf((Position.x - Settings.Origin.x) / Settings.TileSize);
+	const float z = floorf((Position.z - Settings.Origin.z) / Settings.TileSize);
+
+	const uint32_t tile_x = uint32_t(PxClamp(x, 0.0f, float(Settings.TilesX - 1)));
+	const uint32_t tile_z = uint32_t(PxClamp(z, 0.0f, float(Settings.TilesZ - 1)));
+	return tile_x + tile_z * Settings.TilesX;
+}
+
+bool PartitionedWorld::TouchesTile(const PxBounds3& Bounds, uint32_t Tile) const
+{
+	const uint32_t tile_x = Tile % Settings.TilesX;
+	const uint32_t tile_z = Tile / Settings.TilesX;
+
+	// The outer borders of the grid are open, anything past them belongs to the edge tiles
+	const float min_x = tile_x ? Settings.Origin.x + tile_x * Settings.TileSize - Settings.GhostMargin : -PX_MAX_F32;
+	const float max_x = tile_x + 1 < Settings.TilesX ? Settings.Origin.x + (tile_x + 1) * Settings.TileSize + Settings.GhostMargin : PX_MAX_F32;
+	const float min_z = tile_z ? Settings.Origin.z + tile_z * Settings.TileSize - Settings.GhostMargin : -PX_MAX_F32;
+	const float max_z = tile_z + 1 < Settings.TilesZ ? Settings.Origin.z + (tile_z + 1) * Settings.TileSize + Settings.GhostMargin : PX_MAX_F32;
+
+	return Bounds.maximum.x >= min_x && Bounds.minimum.x <= max_x && Bounds.maximum.z >= min_z && Bounds.minimum.z <= max_z;
+}
+
+void PartitionedWorld::ForEachTile(const PxBounds3& Bounds, const std::function<void(SceneID Scene)>& Function) const
+{
+	for (uint32_t i = 0; i < Tiles.size(); i++)
+	{
+		if (TouchesTile(Bounds, i))
+			Function(Tiles[i]);
+	}
+}
+
+PxRigidDynamic * PartitionedWorld::CreateGhost(PxRigidDynamic& Actor, uint32_t Tile)
+{
+	PxScene * scene = Engine->GetScene(Tiles[Tile]);
+	PxPhysics& physics = scene->getPhysics();
+
+	PxRigidDynamic * ghost = physics.createRigidDynamic(Actor.getGlobalPose());
+	if (!ghost)
+		return nullptr;
+	ghost->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
+	// Not on the registry, like the character proxies
+	ghost->userData = nullptr;
+
+	PxShape * shapes[16];
+	PxShape * copies[16];
+	PxMaterial * materials[16];
+	const PxU32 shape_count = Actor.getNbShapes();
+	for (PxU32 start = 0; start < shape_count; start += 16)
+	{
+		const PxU32 count = Actor.getShapes(shapes, 16, start);
+		PxU32 copy_count = 0;
+		for (PxU32 i = 0; i < count; i++)
+		{
+			// Only what the simulation collides with, the queries and triggers keep seeing the actor in its own tile
+			if (!(shapes[i]->getFlags() & PxShapeFlag::eSIMULATION_SHAPE))
+				continue;
+
+			const PxU16 material_count = PxU16(shapes[i]->getMaterials(materials, 16));
+			PxShape * copy = physics.createShape(shapes[i]->getGeometry().any(), materials, material_count, true, PxShapeFlag::eSIMULATION_SHAPE);
+			if (!copy)
+				continue;
+
+			copy->setLocalPose(shapes[i]->getLocalPose());
+			copy->setSimulationFilterData(shapes[i]->getSimulationFilterData());
+			copy->setContactOffset(shapes[i]->getContactOffset());
+			copy->setRestOffset(shapes[i]->getRestOffset());
+			copies[copy_count++] = copy;
+		}
+
+		ghost->attachShapes(copies, copy_count);
+		for (PxU32 i = 0; i < copy_count; i++)
+			copies[i]->release();
+	}
+
+	scene->addActor(*ghost);
+	return ghost;
+}
+
+void PartitionedWorld::ReleaseGhosts(Body& Tracked)
+{
+	for (uint32_t i = 0; i < Tracked.GhostCount; i++)
+		Tracked.Ghosts[i].Actor->release();
+	Tracked.GhostCount = 0;
+}
+
+void PartitionedWorld::Untrack(uint32_t Index)
+{
+	BodyIndices.erase(Bodies[Index].ID.Index);
+	if (Index + 1 != Bodies.size())
+	{
+		Bodies[Index] = Bodies.back();
+		BodyIndices[Bodies[Index].ID.Index] = Index;
+	}
+	Bodies.pop_back();
+}
+
+std::vector<ActorID> PartitionedWorld::CreateDynamicActors(const std::vector<DynamicActorDesc>& Descs)
+{
+	using namespace std;
+
+	vector<ActorID> ids(Descs.size());
+	if (!Engine)
+		return ids;
+
+	// Grouped by tile, so each tile gets a single insertion
+	vector<vector<uint32_t>> per_tile(Tiles.size());
+	for (uint32_t i = 0; i < Descs.size(); i++)
+		per_tile[GetTileIndex(Descs[i].Pose.p)].push_back(i);
+
+	vector<DynamicActorDesc> tile_descs;
+	for (uint32_t tile = 0; tile < Tiles.size(); tile++)
+	{
+		if (per_tile[tile].empty())
+			continue;
+
+		tile_descs.clear();
+		for (uint32_t i : per_tile[tile])
+			tile_descs.push_back(Descs[i]);
+
+		const auto tile_ids = Engine->CreateDynamicActors(tile_descs, false, Tiles[tile]);
+		for (size_t i = 0; i < tile_ids.size(); i++)
+		{
+			ids[per_tile[tile][i]] = tile_ids[i];
+			if (!tile_ids[i].IsValid())
+				continue;
+
+			Body body;
+			body.ID = tile_ids[i];
+			body.Tile = tile;
+			body.GhostCount = 0;
+			BodyIndices[body.ID.Index] = uint32_t(Bodies.size());
+			Bodies.push_back(body);
+		}
+	}
+
+	// Actors created right next to a border get their ghosts before the first step
+	UpdateBorders();
+	return ids;
+}
+
+bool PartitionedWorld::RemoveActor(ActorID ID)
+{
+	auto entry = BodyIndices.find(ID.Index);
+	if (!Engine || entry == BodyIndices.end() || Bodies[entry->second].ID != ID)
+	{
+		std::cout << "Invalid actor ID [" << ID.Index << "] provided to PartitionedWorld::RemoveActor" << std::endl;
+		return false;
+	}
+
+	const uint32_t index = entry->second;
+	ReleaseGhosts(Bodies[index]);
+	Untrack(index);
+	return Engine->RemoveActor(ID);
+}
+
+void PartitionedWorld::Simulate(float ElapsedTimeSeconds)
+{
+	if (!Engine)
+		return;
+
+	// The tiles share the worker threads, so one finishing early lets the others use all of them
+	for (SceneID scene : Tiles)
+		Engine->BeginSimulate(ElapsedTimeSeconds, scene);
+	for (SceneID scene : Tiles)
+		Engine->EndSimulate(true, scene);
+
+	UpdateBorders();
+}
+
+void PartitionedWorld::UpdateBorders()
+{
+	LastMigrations = 0;
+
+	for (uint32_t i = 0; i < Bodies.size();)
+	{
+		Body& body = Bodies[i];
+		auto actor = static_cast<PxRigidDynamic*>(Engine->GetActor(body.ID));
+		if (!actor)
+		{
+			// Removed straight through the engine
+			ReleaseGhosts(body);
+			Untrack(i);
+			continue;
+		}
+
+		const PxTransform pose = actor->getGlobalPose();
+		const uint32_t owner = GetTileIndex(pose.p);
+		if (owner != body.Tile)
+		{
+			// The ghost on the new side is replaced by the actor itself
+			for (uint32_t g = 0; g < body.GhostCount; g++)
+			{
+				if (body.Ghosts[g].Tile != owner)
+					continue;
+				body.Ghosts[g].Actor->release();
+				body.Ghosts[g] = body.Ghosts[--body.GhostCount];
+				break;
+			}
+
+			if (Engine->MoveActorToScene(body.ID, Tiles[owner]))
+			{
+				body.Tile = owner;
+				LastMigrations++;
+			}
+		}
+
+		const PxBounds3 bounds = actor->getWorldBounds();
+		const bool sleeping = actor->isSleeping();
+
+		// Release the ghosts that are out of range, and drive the others to the pose of the actor
+		for (uint32_t g = 0; g < body.GhostCount;)
+		{
+			if (!TouchesTile(bounds, body.Ghosts[g].Tile))
+			{
+				body.Ghosts[g].Actor->release();
+				body.Ghosts[g] = body.Ghosts[--body.GhostCount];
+				continue;
+			}
+
+			// A sleeping actor doesn't move, and without a target the ghost can go to sleep as well
+			if (!sleeping)
+				body.Ghosts[g].Actor->setKinematicTarget(pose);
+			g++;
+		}
+
+		// Only the neighbours of the owner can be within the margin
+		const int32_t owner_x = int32_t(body.Tile % Settings.TilesX);
+		const int32_t owner_z = int32_t(body.Tile / Settings.TilesX);
+		for (int32_t z = PxMax(owner_z - 1, 0); z <= PxMin(owner_z + 1, int32_t(Settings.TilesZ) - 1); z++)
+		{
+			for (int32_t x = PxMax(owner_x - 1, 0); x <= PxMin(owner_x + 1, int32_t(Settings.TilesX) - 1); x++)
+			{
+				const uint32_t tile = uint32_t(x) + uint32_t(z) * Settings.TilesX;
+				if (tile == body.Tile || body.GhostCount == MaxGhosts || !TouchesTile(bounds, tile))
+					continue;
+
+				bool found = false;
+				for (uint32_t g = 0; g < body.GhostCount && !found; g++)
+					found = body.Ghosts[g].Tile == tile;
+				if (found)
+					continue;
+
+				if (auto ghost = CreateGhost(*actor, tile))
+					body.Ghosts[body.GhostCount++] = Ghost{ tile, ghost };
+			}
+		}
+
+		i++;
+	}
+}
+
+uint32_t PartitionedWorld::GetGhostCount() const
+{
+	uint32_t count = 0;
+	for (const auto& body : Bodies)
+		count += body.GhostCount;
+	return count;
+}
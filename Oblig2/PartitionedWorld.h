@@ -0,0 +1,112 @@
+#pragma once
+#include "PhysicsEngine.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// Settings of a PartitionedWorld
+struct PartitionedWorldSettings
+{
+	// Corner of the grid with the lowest X and Z. Tiles are TileSize x TileSize squares on the XZ plane, and cover every height
+	PxVec3 Origin = PxVec3(0.0f);
+	float TileSize = 512.0f;
+	uint32_t TilesX = 2;
+	uint32_t TilesZ = 2;
+	// Actors closer than this to a border get a ghost in the tile on the other side
+	// Should be above the distance a body can travel in a step plus its contact offset
+	float GhostMargin = 4.0f;
+
+	// Used for every tile scene
+	SceneSettings Scene;
+	PxVec3 Gravity = PxVec3(0.0f, -9.81f, 0.0f);
+};
+
+// Splits a world too big for a single scene into a grid of tiles, each one simulated by its own scene of the engine
+// The tiles are stepped at the same time on the worker threads, so the broadphase and the solver of each one only see a part of the world
+// A dynamic actor belongs to the tile its center is in, and is moved to the neighbour tile when it crosses a border (keeping its ID)
+// Near a border the actor gets a kinematic ghost in the tiles whose margin it touches, driven to its pose after every step
+// Bodies on both sides of a border then push each other, like against a kinematic body one step late
+// Static geometry has to be added to every tile it touches (see ForEachTile). Joints, aggregates and characters don't cross borders
+class PartitionedWorld
+{
+	// A kinematic copy of an actor in a neighbour tile. Not on the actor registry, and not seen by the scene queries
+	struct Ghost
+	{
+		uint32_t Tile;
+		PxRigidDynamic * Actor;
+	};
+
+	// A tile touches at most 3 neighbours within the margin (2 borders and the corner between them)
+	static const uint32_t MaxGhosts = 3;
+
+	struct Body
+	{
+		ActorID ID;
+		uint32_t Tile;
+		uint32_t GhostCount;
+		Ghost Ghosts[MaxGhosts];
+	};
+
+	PhysicsEngine * Engine = nullptr;
+	PartitionedWorldSettings Settings;
+	// Row major, index X + Z * TilesX
+	std::vector<SceneID> Tiles;
+
+	std::vector<Body> Bodies;
+	// ActorID::Index to position on Bodies
+	std::unordered_map<uint32_t, uint32_t> BodyIndices;
+
+	uint32_t LastMigrations = 0;
+
+	// Returns the tile containing the position, clamped to the grid
+	uint32_t GetTileIndex(PxVec3 Position) const;
+	// Returns true if the bounds overlap the tile enlarged by the ghost margin
+	bool TouchesTile(const PxBounds3& Bounds, uint32_t Tile) const;
+
+	PxRigidDynamic * CreateGhost(PxRigidDynamic& Actor, uint32_t Tile);
+	void ReleaseGhosts(Body& Tracked);
+
+	// Moves the actors that left their tile, and creates, drives and releases the ghosts
+	void UpdateBorders();
+
+	// Stops tracking the body at that position, swapping the last one into it
+	void Untrack(uint32_t Index);
+public:
+	PartitionedWorld() = default;
+	PartitionedWorld(const PartitionedWorld&) = delete;
+	PartitionedWorld& operator=(const PartitionedWorld&) = delete;
+	~PartitionedWorld() { Release(); }
+
+	// Creates one scene per tile on the engine, which must outlive the world
+	// Returns true if successful
+	bool Initialize(PhysicsEngine& Engine, const PartitionedWorldSettings& Settings = PartitionedWorldSettings());
+
+	// Releases the ghosts and the tile scenes, along with every actor in them
+	void Release();
+
+	uint32_t GetTileCount() const { return uint32_t(Tiles.size()); }
+	SceneID GetTileScene(uint32_t X, uint32_t Z) const { return Tiles[X + Z * Settings.TilesX]; }
+
+	// Returns the scene of the tile containing the position (clamped to the grid)
+	SceneID GetSceneAt(PxVec3 Position) const { return Tiles[GetTileIndex(Position)]; }
+
+	// Calls the function with the scene of every tile that the bounds touch, including the ghost margin
+	// Meant for adding static geometry, which has to be in each of those tiles
+	void ForEachTile(const PxBounds3& Bounds, const std::function<void(SceneID Scene)>& Function) const;
+
+	// Creates the actors in the tile of their pose, see PhysicsEngine::CreateDynamicActors (without aggregates)
+	// The IDs stay valid when the actors move between tiles
+	std::vector<ActorID> CreateDynamicActors(const std::vector<DynamicActorDesc>& Descs);
+
+	// Removes the actor and its ghosts. Returns false if the ID is not valid or not on the world
+	bool RemoveActor(ActorID ID);
+
+	// Steps every tile at once, then hands off the actors that crossed a border and updates the ghosts
+	void Simulate(float ElapsedTimeSeconds);
+
+	// Number of actors that changed tile on the last step
+	uint32_t GetMigrationCount() const { return LastMigrations; }
+	// Number of ghosts alive
+	uint32_t GetGhostCount() const;
+};
@@ -1,83 +1,429 @@
 #include "PhysicsEngine.h"
 #include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <csignal>
+#include <atomic>
 
-PhysicsEngine::ErrorLogger PhysicsEngine::ErrorCallback;
-PxDefaultAllocator PhysicsEngine::Allocator;
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HEIGHTMAP_SSE2 1
+#else
+#define HEIGHTMAP_SSE2 0
+#endif
+
+LogSink PhysicsEngine::ErrorCallback;
+PoolAllocator PhysicsEngine::DefaultAllocator;
+
+namespace
+{
+	// Packs the grid coordinates of a chunk in a single key
+	int64_t ChunkKey(int32_t X, int32_t Z)
+	{
+		return (int64_t(X) << 32) | int64_t(uint32_t(Z));
+	}
+
+	int32_t ChunkKeyX(int64_t Key) { return int32_t(Key >> 32); }
+	int32_t ChunkKeyZ(int64_t Key) { return int32_t(uint32_t(Key)); }
+
+	// 64 bit FNV-1a, chaining the previous hash as the seed
+	uint64_t HashBytes(const void * Data, size_t Size, uint64_t Hash = 14695981039346656037ull)
+	{
+		auto bytes = static_cast<const uint8_t*>(Data);
+		for (size_t i = 0; i < Size; i++)
+		{
+			Hash ^= bytes[i];
+			Hash *= 1099511628211ull;
+		}
+		return Hash;
+	}
+
+	template<typename T>
+	uint64_t HashValue(const T& Value, uint64_t Hash)
+	{
+		return HashBytes(&Value, sizeof(T), Hash);
+	}
+
+	// Hashes field by field, as the struct has padding
+	uint64_t HashCookingParams(const PxCookingParams& Params)
+	{
+		uint64_t hash = HashValue(Params.targetPlatform, 14695981039346656037ull);
+		hash = HashValue(Params.areaTestEpsilon, hash);
+		hash = HashValue(Params.planeTolerance, hash);
+		hash = HashValue(Params.convexMeshCookingType, hash);
+		hash = HashValue(Params.suppressTriangleMeshRemapTable, hash);
+		hash = HashValue(Params.buildTriangleAdjacencies, hash);
+		hash = HashValue(Params.buildGPUData, hash);
+		hash = HashValue(Params.scale.length, hash);
+		hash = HashValue(Params.scale.speed, hash);
+		hash = HashValue(uint32_t(Params.meshPreprocessParams), hash);
+		hash = HashValue(Params.meshWeldTolerance, hash);
+		hash = HashValue(Params.midphaseDesc.getType(), hash);
+		hash = HashValue(Params.gaussMapLimit, hash);
+		return hash;
+	}
+
+	// Maps normalized heights ([0,1]) to [-32767, 32767]
+	void QuantizeHeights(const float * Heights, uint32_t Count, PxI16 * Out)
+	{
+		uint32_t i = 0;
+#if HEIGHTMAP_SSE2
+		const __m128 scale = _mm_set1_ps(65534.0f);
+		const __m128 bias = _mm_set1_ps(-32767.0f);
+		for (; i + 8 <= Count; i += 8)
+		{
+			__m128 a = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Heights + i), scale), bias);
+			__m128 b = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Heights + i + 4), scale), bias);
+			// Round to nearest, and the pack saturates out of range values
+			__m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + i), packed);
+		}
+#endif
+		for (; i < Count; i++)
+		{
+			const float q = PxClamp(Heights[i] * 65534.0f - 32767.0f, -32767.0f, 32767.0f);
+			Out[i] = PxI16(q < 0.0f ? q - 0.5f : q + 0.5f);
+		}
+	}
+
+	// Maps [0, 65535] to [-32768, 32767]
+	void QuantizeHeights(const uint16_t * Heights, uint32_t Count, PxI16 * Out)
+	{
+		uint32_t i = 0;
+#if HEIGHTMAP_SSE2
+		const __m128i sign_flip = _mm_set1_epi16(short(0x8000));
+		for (; i + 8 <= Count; i += 8)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Heights + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + i), _mm_xor_si128(v, sign_flip));
+		}
+#endif
+		for (; i < Count; i++)
+			Out[i] = PxI16(int32_t(Heights[i]) - 32768);
+	}
+
+	// Counts pending tasks, so the submitting thread can wait for all of them
+	class TaskGroup
+	{
+		std::mutex Mutex;
+		std::condition_variable Done;
+		size_t Pending = 0;
+	public:
+		explicit TaskGroup(size_t Count) : Pending(Count) {}
+
+		void Finish()
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			if (--Pending == 0)
+				Done.notify_all();
+		}
+
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			Done.wait(lock, [this] { return Pending == 0; });
+		}
+	};
+
+	// Dispatcher task that runs a function and reports to its group when released
+	class FunctionTask : public PxBaseTask
+	{
+		std::function<void()> Function;
+		TaskGroup * Group = nullptr;
+	public:
+		void Set(std::function<void()> Function, TaskGroup& Group, PxTaskPriority::Enum Priority = PxTaskPriority::eNORMAL)
+		{
+			this->Function = std::move(Function);
+			this->Group = &Group;
+			setPriority(Priority);
+		}
+
+		virtual void run() { Function(); }
+		virtual void release() { Group->Finish(); }
+		virtual const char* getName() const { return "PhysicsEngine.FunctionTask"; }
+
+		// Not used, the task is submitted straight to the dispatcher and has no dependencies
+		virtual void addReference() {}
+		virtual void removeReference() {}
+		virtual int32_t getReference() const { return 1; }
+	};
+
+	// Continuation of PxScene::processCallbacks, signals its group once all the callbacks were processed
+	class CallbackFinishTask : public PxLightCpuTask
+	{
+		TaskGroup& Group;
+	public:
+		explicit CallbackFinishTask(TaskGroup& Group) : Group(Group) {}
+
+		virtual void release()
+		{
+			PxLightCpuTask::release();
+			Group.Finish();
+		}
+
+		// Nothing to do, the group is signaled on release for thread safety
+		virtual void run() {}
+		virtual const char* getName() const { return "PhysicsEngine.CallbackFinishTask"; }
+	};
+
+	// Default filtering, plus swept contacts for the bodies that have CCD enabled
+	PxFilterFlags CCDFilterShader(PxFilterObjectAttributes attributes0, PxFilterData filterData0,
+		PxFilterObjectAttributes attributes1, PxFilterData filterData1,
+		PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize)
+	{
+		PxFilterFlags flags = PxDefaultSimulationFilterShader(attributes0, filterData0, attributes1, filterData1, pairFlags, constantBlock, constantBlockSize);
+		pairFlags |= PxPairFlag::eDETECT_CCD_CONTACT;
+		return flags;
+	}
+}
 
 PhysicsEngine::~PhysicsEngine()
 {
-	if (GlobalScene)
-		GlobalScene->release();
+	if (StreamingThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(StreamingMutex);
+			StreamingQuit = true;
+		}
+		StreamingWake.notify_all();
+		StreamingThread.join();
+
+		for (auto& chunk : ReadyChunks)
+		{
+			if (chunk.Pruning)
+				chunk.Pruning->release();
+			ReleaseChunkActors(chunk.Actors, false);
+		}
+	}
+
+	while (!Scenes.Empty())
+	{
+		DestroyScene(*Scenes.Data()[0]);
+		Scenes.Remove(Scenes.Handles()[0]);
+	}
 	if (Dispatcher)
 		Dispatcher->release();
 	if (Physics)
 		Physics->release();
 
 	if (PVD)
-	{
-		PxPvdTransport* transport = PVD->getTransport();
 		PVD->release();
-		transport->release();
+	if (PvdTransport)
+		PvdTransport->release();
+
+	if (TraceProfiler)
+	{
+		PxSetProfilerCallback(nullptr);
+		TraceProfiler->release();
 	}
 	
 	if (Foundation)
 		Foundation->release();
+
+	// Print what's left, shutdown errors included
+	ErrorCallback.Stop();
 }
 
-bool PhysicsEngine::Initialize(uint32_t NumThreads, PxVec3 Gravity)
+bool PhysicsEngine::Initialize(uint32_t NumThreads, PxVec3 Gravity, const std::string& CacheDirectory, PxAllocatorCallback * Allocator, const SceneSettings& Settings, bool EnableTracing, uint32_t Features)
 {
-	this->Gravity = Gravity;
+	this->CacheDirectory = CacheDirectory;
+	this->Allocator = Allocator ? Allocator : &DefaultAllocator;
 
 	using namespace std;
 
-	Foundation = PxCreateFoundation(PX_FOUNDATION_VERSION, Allocator, ErrorCallback);
+	ErrorCallback.Start();
+	Foundation = PxCreateFoundation(PX_FOUNDATION_VERSION, *this->Allocator, ErrorCallback);
 	if (!Foundation)
 	{
 		cout << "Failed to create the PhysX foundation instance" << endl;
 		return false;
 	}
 
+	// Support for the PhysX Visual Debugger [https://developer.nvidia.com/physx-visual-debugger]
+	// Created on every build so profile captures can be started later on, it does nothing while disconnected
+	// Left out without FeatureVisualDebugger, the SDK then skips its error and allocation hooks
+	if (Features & FeatureVisualDebugger)
+		PVD = PxCreatePvd(*Foundation);
+
 #ifdef _DEBUG
-	bool record_memory_allocations = true;
+	bool record_memory_allocations = PVD != nullptr;
 
-	// Support for the PhysX Visual Debugger [https://developer.nvidia.com/physx-visual-debugger]
-	PVD = PxCreatePvd(*Foundation);
-	PxPvdTransport* transport = PxDefaultPvdSocketTransportCreate("127.0.0.1", 5425, 10);
-	if (!PVD->connect(*transport, PxPvdInstrumentationFlag::eALL))
-		cout << "[Warning] Could not connect to the visual debugger. Maybe it's not open?" << endl;
+	if (PVD)
+	{
+		PvdTransport = PxDefaultPvdSocketTransportCreate("127.0.0.1", 5425, 10);
+		if (!PVD->connect(*PvdTransport, PxPvdInstrumentationFlag::eALL))
+			cout << "[Warning] Could not connect to the visual debugger. Maybe it's not open?" << endl;
+	}
 #else
 	bool record_memory_allocations = false;
 #endif
 
+	// Installed after the debugger connection, which sets its own profiler callback
+	if (EnableTracing)
+		SetTracingEnabled(true);
+
 	PxTolerancesScale scaling;
 	scaling.length = 100;
 
-	Physics = PxCreatePhysics(PX_PHYSICS_VERSION, *Foundation, scaling, record_memory_allocations, PVD);
+	// Only the chosen modules are registered, see EnableFeatures
+	Physics = PxCreateBasePhysics(PX_PHYSICS_VERSION, *Foundation, scaling, record_memory_allocations, PVD);
 	if (!Physics)
 	{
 		cout << "Failed to create the PhysX physics instance" << endl;
 		return false;
 	}
+	EnableFeatures(Features);
+
+	Dispatcher = PxDefaultCpuDispatcherCreate(NumThreads);
+
+	// The dispatcher doesn't change the cooked data, so it's not part of the hash
+	PxCookingParams cooking_params(scaling);
+	CookingParamsHash = HashCookingParams(cooking_params);
+	cooking_params.dispatcher = Dispatcher;
 
-	Cooker = PxCreateCooking(PX_PHYSICS_VERSION, *Foundation, PxCookingParams(scaling));
+	Cooker = PxCreateCooking(PX_PHYSICS_VERSION, *Foundation, cooking_params);
 	if (!Cooker)
 	{
 		cout << "Failed to create the PhysX cooker instance" << endl;
 		return false;
 	}
-	
+
+	// Create default material
+	DefaultMaterial = Physics->createMaterial(0.5f, 0.5f, 0.6f);
+
+	DefaultScene = CreateScene(Settings, Gravity);
+	if (!DefaultScene.IsValid())
+		return false;
+
+	return true;
+}
+
+void PhysicsEngine::EnableFeatures(uint32_t Features)
+{
+	using namespace std;
+
+	lock_guard<mutex> lock(FeatureMutex);
+
+	uint32_t missing = Features & ~EnabledFeatures & ~FeatureVisualDebugger;
+	if (!missing || !Physics)
+		return;
+
+	if (missing & FeatureHeightFields)
+	{
+		if (Physics->getNbHeightFields() > 0 && Physics->getNbScenes() > 0)
+		{
+			cout << "[Warning] Heightfields can't be registered once a heightfield exists" << endl;
+			missing &= ~FeatureHeightFields;
+		}
+		else
+			PxRegisterHeightFields(*Physics);
+	}
+	if (missing & FeatureArticulations)
+		PxRegisterArticulations(*Physics);
+	if (missing & FeatureCloth)
+		PxRegisterCloth(*Physics);
+	if (missing & FeatureParticles)
+		PxRegisterParticles(*Physics);
+
+	EnabledFeatures |= missing;
+}
+
+SceneID PhysicsEngine::CreateScene(const SceneSettings& Settings, PxVec3 Gravity)
+{
+	using namespace std;
+
 	PxSceneDesc scene_desc(Physics->getTolerancesScale());
 	scene_desc.gravity = Gravity;
-	Dispatcher = PxDefaultCpuDispatcherCreate(NumThreads);
 	scene_desc.cpuDispatcher = Dispatcher;
-	scene_desc.filterShader = PxDefaultSimulationFilterShader;
+	scene_desc.filterShader = Settings.EnableCCD ? CCDFilterShader : PxDefaultSimulationFilterShader;
+	scene_desc.filterBatchShader = Settings.EnableCCD ? nullptr : PxDefaultSimulationFilterBatchShader;
+
+	scene_desc.broadPhaseType = Settings.BroadPhase;
+	scene_desc.limits = Settings.Limits;
+	scene_desc.frictionType = Settings.FrictionType;
+	scene_desc.solverBatchSize = Settings.SolverBatchSize;
+	scene_desc.solverConvergenceThreshold = Settings.SolverConvergenceThreshold;
+	scene_desc.ccdMaxPasses = Settings.CCDMaxPasses;
+	if (Settings.IncrementalQueryTree)
+		scene_desc.dynamicStructure = PxPruningStructureType::eINCREMENTAL_AABB_TREE;
+	if (Settings.HashGridQueryStructure)
+		scene_desc.dynamicStructure = PxPruningStructureType::eHASH_GRID;
+	scene_desc.flags.clear(PxSceneFlag::eENABLE_PCM);
+	if (Settings.EnablePCM)
+		scene_desc.flags |= PxSceneFlag::eENABLE_PCM;
+	if (Settings.AdaptivePCMThresholds)
+		scene_desc.flags |= PxSceneFlag::eENABLE_ADAPTIVE_PCM_THRESHOLDS;
+	if (Settings.CompactContacts)
+		scene_desc.flags |= PxSceneFlag::eENABLE_COMPACT_CONTACTS;
+	if (Settings.BalancedPartitions)
+		scene_desc.flags |= PxSceneFlag::eENABLE_BALANCED_PARTITIONS;
+	if (Settings.WarmSleeping)
+		scene_desc.flags |= PxSceneFlag::eENABLE_WARM_SLEEPING;
+	if (Settings.EnableStabilization)
+		scene_desc.flags |= PxSceneFlag::eENABLE_STABILIZATION;
+	if (Settings.Deterministic)
+		scene_desc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+	if (Settings.EnableCCD)
+		scene_desc.flags |= PxSceneFlag::eENABLE_CCD;
+	if (Settings.StaticBroadPhaseTree)
+		scene_desc.flags |= PxSceneFlag::eENABLE_STATIC_BROADPHASE_TREE;
+	if (Settings.QueryCache)
+		scene_desc.flags |= PxSceneFlag::eENABLE_QUERY_CACHE;
+	if (Settings.QuerySnapshots)
+		scene_desc.flags |= PxSceneFlag::eENABLE_QUERY_SNAPSHOTS;
+
+	const PxU32 subdivisions = PxClamp(Settings.BroadPhaseSubdivisions, 1u, 16u);
+	if (Settings.BroadPhase == PxBroadPhaseType::eMBP)
+		scene_desc.limits.maxNbRegions = PxMax(scene_desc.limits.maxNbRegions, subdivisions * subdivisions);
 
-	GlobalScene = Physics->createScene(scene_desc);
+	unique_ptr<SimulationScene> state(new SimulationScene());
+	state->Gravity = Gravity;
+	state->Scene = Physics->createScene(scene_desc);
+	if (!state->Scene)
+	{
+		cout << "Failed to create the PhysX scene. Check the scene settings" << endl;
+		return SceneID();
+	}
+	state->Scene->userData = state.get();
+
+	// MBP only tracks the objects inside its regions, so cover the whole world with them
+	if (Settings.BroadPhase == PxBroadPhaseType::eMBP && Settings.AdaptiveBroadPhaseRegions)
+	{
+		PxBroadPhaseAdaptiveRegionsDesc adaptive_desc;
+		if (!state->Scene->setBroadPhaseAdaptiveRegions(&adaptive_desc))
+			cout << "Failed to enable the adaptive broad phase regions" << endl;
+	}
+	else if (Settings.BroadPhase == PxBroadPhaseType::eMBP)
+	{
+		vector<PxBounds3> regions(subdivisions * subdivisions);
+		const PxU32 region_count = PxBroadPhaseExt::createRegionsFromWorldBounds(regions.data(), Settings.WorldBounds, subdivisions);
+		for (PxU32 i = 0; i < region_count; i++)
+		{
+			PxBroadPhaseRegion region;
+			region.bounds = regions[i];
+			region.userData = nullptr;
+			state->Scene->addBroadPhaseRegion(region);
+		}
+	}
 	
-	CharacterManager = PxCreateControllerManager(*GlobalScene);
+	// MoveCharacters goes through the batches of the manager, which don't need the locking of concurrent user moves
+	state->CharacterManager = PxCreateControllerManager(*state->Scene);
 
 #ifdef _DEBUG
-	PxPvdSceneClient* pvd_client = GlobalScene->getScenePvdClient();
+	PxPvdSceneClient* pvd_client = state->Scene->getScenePvdClient();
 	if (pvd_client)
 	{
 		pvd_client->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONSTRAINTS, true);
@@ -86,144 +432,2128 @@ bool PhysicsEngine::Initialize(uint32_t NumThreads, PxVec3 Gravity)
 	}
 #endif
 
-	// Create default material
-	DefaultMaterial = Physics->createMaterial(0.5f, 0.5f, 0.6f);
+	// The scratch block size must be a multiple of 16 KB
+	state->ScratchBlockSize = (Settings.ScratchBlockSize + 16 * 1024 - 1) & ~PxU32(16 * 1024 - 1);
+	if (state->ScratchBlockSize)
+		state->StepArena.Initialize(*Allocator, state->ScratchBlockSize);
 
-	return true;
+	return Scenes.Insert(move(state));
 }
 
-void PhysicsEngine::Simulate(float ElapsedTimeSeconds)
+void PhysicsEngine::FinishStep(SimulationScene& Scene)
 {
-	GlobalScene->simulate(ElapsedTimeSeconds);
-	GlobalScene->fetchResults(true);
+	if (!Scene.Simulating)
+		return;
+
+	if (Scene.Colliding)
+	{
+		Scene.Scene->fetchCollision(true);
+		Scene.Scene->advance();
+		Scene.Colliding = false;
+	}
+	Scene.Scene->fetchResults(true);
+	Scene.Simulating = false;
 }
 
-bool PhysicsEngine::CreateStaticActor(size_t MeshID,PxVec3 Position, PxQuat Rotation, PxVec3 Scale)
+std::vector<PxRigidActor*> PhysicsEngine::DropSceneEntries(SimulationScene& Scene)
 {
-	using namespace std;
+	for (size_t i = Characters.Size(); i-- > 0;)
+	{
+		if (Characters.Data()[i]->getScene() == Scene.Scene)
+			Characters.Remove(Characters.Handles()[i]);
+	}
 
-	if (MeshID < 0 && MeshID >= TriangleMeshes.size())
+	std::vector<PxRigidActor*> actors;
+	for (size_t i = Actors.Size(); i-- > 0;)
 	{
-		cout << "Invalid mesh id [" << MeshID << "] provided to CreateStaticActor" << endl;
+		if (Actors.Data()[i]->getScene() != Scene.Scene)
+			continue;
+
+		// Mirror the swap with the last element done by the slot map
+		actors.push_back(Actors.Data()[i]);
+		Actors.Remove(Actors.Handles()[i]);
+		PosePositions[i] = PosePositions.back();
+		PoseRotations[i] = PoseRotations.back();
+		PosePositions.pop_back();
+		PoseRotations.pop_back();
+	}
+	return actors;
+}
+
+void PhysicsEngine::DestroyScene(SimulationScene& Scene)
+{
+	// The scene can't be released in the middle of a step
+	FinishStep(Scene);
+
+	// Drop the registry entries of whatever lives on the scene, the SDK releases the objects themselves
+	DropSceneEntries(Scene);
+
+	Scene.CharacterManager->release();
+	Scene.Scene->release();
+}
+
+bool PhysicsEngine::ResetScene(SceneID ID)
+{
+	using namespace std;
+
+	auto state = ResolveScene(ID);
+	if (!state)
 		return false;
+
+	SimulationScene& scene = *state;
+	FinishStep(scene);
+
+	// The controllers release their own kinematic actors, the manager itself is kept
+	const vector<PxRigidActor*> actors = DropSceneEntries(scene);
+	scene.CharacterManager->purgeControllers();
+	scene.CharacterCosts.clear();
+
+	vector<PxActor*> chunk_actors;
+	if (scene.Scene == GetScene(DefaultScene))
+	{
+		for (auto& chunk : LoadedChunks)
+			chunk_actors.insert(chunk_actors.end(), chunk.second.begin(), chunk.second.end());
+		LoadedChunks.clear();
+		HasFocusChunk = false;
 	}
 
-	PxTriangleMeshGeometry instance;
-	instance.triangleMesh = TriangleMeshes[MeshID];
-	instance.scale = Scale;
-	
-	PxTransform tworld(Position, Rotation);
+	// The aggregates come from CreateDynamicActors, nothing else holds them
+	vector<PxAggregate*> aggregates(scene.Scene->getNbAggregates());
+	scene.Scene->getAggregates(aggregates.data(), PxU32(aggregates.size()));
 
-	// No need to keep the rigid body pointer and clean it by hand, they are removed by the SDK
-	auto actor = PxCreateStatic(*Physics, tworld, instance, *DefaultMaterial);
-	if (!actor)
+	// Everything leaves the scene at once, so the objects are released outside of it
+	scene.Scene->reset();
+
+	for (auto aggregate : aggregates)
+		aggregate->release();
+	for (auto actor : actors)
+		actor->release();
+	ReleaseChunkActors(chunk_actors, false);
+
+	scene.MovedActors.clear();
+	return true;
+}
+
+bool PhysicsEngine::ReleaseScene(SceneID ID)
+{
+	auto state = Scenes.Get(ID);
+	if (!state)
 	{
-		cout << "Failed to create the static actor" << endl;
+		std::cout << "Invalid scene ID [" << ID.Index << "] provided to ReleaseScene" << std::endl;
+		return false;
+	}
+
+	if (ID == DefaultScene)
+	{
+		std::cout << "[Warning] The default scene can't be released" << std::endl;
 		return false;
 	}
-	GlobalScene->addActor(*actor);
 
+	DestroyScene(**state);
+	Scenes.Remove(ID);
+
+	return true;
+}
+
+PhysicsEngine::SimulationScene * PhysicsEngine::ResolveScene(SceneID ID) const
+{
+	if (!ID.IsValid())
+		ID = DefaultScene;
+
+	auto state = Scenes.Get(ID);
+	if (!state)
+	{
+		std::cout << "Invalid scene ID [" << ID.Index << "]" << std::endl;
+		return nullptr;
+	}
+
+	return state->get();
+}
+
+PxScene * PhysicsEngine::GetScene(SceneID ID) const
+{
+	auto state = ResolveScene(ID);
+	return state ? state->Scene : nullptr;
+}
+
+bool PhysicsEngine::IsSimulating(SceneID Scene) const
+{
+	auto state = ResolveScene(Scene);
+	return state && state->Simulating;
+}
+
+bool PhysicsEngine::SetCostReportCallback(CostReportFn Callback, uint32_t MaxEntries, SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state || state->Simulating)
+		return false;
+
+	state->CostCallback = Callback;
+	state->CostEntries = Callback ? MaxEntries : 0;
+	state->CharacterCosts.clear();
+	state->Scene->setCostProfiling(state->CostEntries);
 	return true;
 }
 
-bool PhysicsEngine::CreateTerrain(PxVec3 Position, PxVec3 Scale, uint32_t SizeX, uint32_t SizeY, float MinZ, float MaxZ, const std::vector<float>& Heightmap)
+void PhysicsEngine::AddCharacterCost(SimulationScene& Scene, CharacterID ID, float Time)
 {
-	using namespace std;
+	if (!Scene.CostEntries)
+		return;
 
-	PxHeightFieldDesc hf_desc;
-	hf_desc.format = PxHeightFieldFormat::eS16_TM;
-	hf_desc.nbColumns = SizeX;
-	hf_desc.nbRows = SizeY;
+	auto& cost = Scene.CharacterCosts[ID.Index];
+	// A released character whose slot got reused starts over
+	if (cost.ID != ID)
+		cost = CostReport::Character{ ID, 0, 0.0f };
+	cost.MoveCount++;
+	cost.Time += Time;
+}
 
-	vector<PxHeightFieldSample> px_data(Heightmap.size());
+void PhysicsEngine::UpdateCostReport(SimulationScene& Scene, SceneID ID)
+{
+	using namespace std;
 
-	for (uint32_t y = 0; y < SizeY; y++)
+	PxCostProfile profile;
+	if (!Scene.CostCallback || !Scene.Scene->getCostProfile(profile))
+		return;
+
+	auto to_actor_id = [this](const PxActor * Actor)
 	{
-		for (uint32_t x = 0; x < SizeX; x++)
-		{
-			uint32_t out_idx = y + x * hf_desc.nbRows;
-			uint32_t in_idx = x * sizeof(float) + y * SizeX;
+		const size_t slot = Actor ? reinterpret_cast<size_t>(Actor->userData) : 0;
+		return slot ? Actors.GetHandle(uint32_t(slot - 1)) : ActorID();
+	};
 
-			px_data[out_idx].height = (MaxZ - MinZ) * Heightmap[in_idx] + MinZ;
-			px_data[out_idx].materialIndex0 = 0;
-			px_data[out_idx].materialIndex1 = 0;
-		}
+	CostReport report;
+	report.Scene = ID.IsValid() ? ID : DefaultScene;
+	report.NarrowPhaseTime = profile.narrowPhaseTime;
+	report.SolverTime = profile.solverTime;
+	memcpy(report.GeometryPairTime, profile.geometryPairTime, sizeof(report.GeometryPairTime));
+	memcpy(report.GeometryPairCount, profile.nbGeometryPairs, sizeof(report.GeometryPairCount));
+
+	report.Pairs.reserve(profile.nbPairs);
+	for (PxU32 i = 0; i < profile.nbPairs; i++)
+	{
+		const PxPairCost& pair = profile.pairs[i];
+		report.Pairs.push_back(CostReport::Pair{ to_actor_id(pair.actor0), to_actor_id(pair.actor1), pair.actor0, pair.actor1,
+			pair.shape0->getGeometryType(), pair.shape1->getGeometryType(), pair.time });
 	}
 
-	hf_desc.samples.data = px_data.data();
-	hf_desc.samples.stride = sizeof(PxHeightFieldSample);
+	report.Actors.reserve(profile.nbActors);
+	for (PxU32 i = 0; i < profile.nbActors; i++)
+	{
+		const PxActorCost& actor = profile.actors[i];
+		report.Actors.push_back(CostReport::Actor{ to_actor_id(actor.actor), actor.actor, actor.nbPairs, actor.time });
+	}
 
-	auto hf_ptr = Cooker->createHeightField(hf_desc, Physics->getPhysicsInsertionCallback());
-	PxHeightFieldGeometry geo(hf_ptr, PxMeshGeometryFlags(), 1, Scale.x / hf_desc.nbColumns, Scale.z / hf_desc.nbRows);
+	report.Islands.reserve(profile.nbIslands);
+	for (PxU32 i = 0; i < profile.nbIslands; i++)
+	{
+		const PxIslandCost& island = profile.islands[i];
+		report.Islands.push_back(CostReport::Island{ to_actor_id(island.actor), island.nbIslands, island.nbBodies, island.nbContactManagers, island.nbConstraints, island.time });
+	}
 
-	PxTransform tworld(PxVec3(Position.x, Position.y, Position.z));
+	// The characters moved since the last report, which is usually the frame before the step
+	for (const auto& entry : Scene.CharacterCosts)
+	{
+		report.Characters.push_back(entry.second);
+		report.CharacterTime += entry.second.Time;
+	}
+	Scene.CharacterCosts.clear();
 
-	// No need to keep the rigid body pointer and clean it by hand, they are removed by the SDK
-	auto actor = PxCreateStatic(*Physics, tworld, geo, *DefaultMaterial);
-	if (!actor)
+	auto costlier = [](const CostReport::Character& A, const CostReport::Character& B) { return A.Time > B.Time; };
+	if (report.Characters.size() > Scene.CostEntries)
 	{
-		cout << "Failed to create the terrain actor" << endl;
-		return false;
+		partial_sort(report.Characters.begin(), report.Characters.begin() + Scene.CostEntries, report.Characters.end(), costlier);
+		report.Characters.resize(Scene.CostEntries);
 	}
-	GlobalScene->addActor(*actor);
+	else
+		sort(report.Characters.begin(), report.Characters.end(), costlier);
+
+	// Copied, the callback may replace itself
+	CostReportFn callback = Scene.CostCallback;
+	callback(report);
+}
+
+bool PhysicsEngine::GetSimulationStatistics(PxSimulationStatistics& Stats, SceneID Scene) const
+{
+	auto state = ResolveScene(Scene);
+	if (!state || state->Simulating)
+		return false;
 
+	state->Scene->getSimulationStatistics(Stats);
 	return true;
 }
 
-size_t PhysicsEngine::CreateCharacterController(PxVec3 StartPosition, float Height, float Radius)
+void PhysicsEngine::Simulate(float ElapsedTimeSeconds, SceneID Scene)
 {
-	PxCapsuleControllerDesc desc;
+	BeginSimulate(ElapsedTimeSeconds, Scene);
+	EndSimulate(true, Scene);
+}
 
-	desc.height = Height;
-	desc.radius = Radius;
-	desc.position = PxExtendedVec3(StartPosition.x, StartPosition.y, StartPosition.z);
-	desc.contactOffset = Radius + Radius * 0.1;
-	desc.stepOffset = Height * 0.25;
-	desc.material = DefaultMaterial;
+void PhysicsEngine::SimulateScenes(float ElapsedTimeSeconds)
+{
+	// The scenes share the worker threads, so one scene finishing early lets the others use all of them
+	for (size_t i = 0; i < Scenes.Size(); i++)
+		BeginSimulate(ElapsedTimeSeconds, Scenes.Handles()[i]);
+	for (size_t i = 0; i < Scenes.Size(); i++)
+		EndSimulate(true, Scenes.Handles()[i]);
+}
 
-	PxController * controller = CharacterManager->createController(desc);
-	if (!controller)
+void * PhysicsEngine::SimulationScene::GetScratchBlock()
+{
+	if (!ScratchBlockSize)
+		return nullptr;
+
+	// The previous step is done with it once its results were fetched
+	StepArena.Reset();
+	return StepArena.Allocate(ScratchBlockSize, 16);
+}
+
+void PhysicsEngine::BeginSimulate(float ElapsedTimeSeconds, SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return;
+
+	if (state->Simulating)
 	{
-		std::cout << "Failed to create the character controller" << std::endl;
-		return -1;
+		std::cout << "[Warning] BeginSimulate called while the previous step is still running" << std::endl;
+		return;
 	}
-	Characters.push_back(controller);
 
-	return Characters.size() - 1;
+	void * scratch = state->GetScratchBlock();
+	state->Scene->simulate(ElapsedTimeSeconds, nullptr, scratch, scratch ? state->ScratchBlockSize : 0);
+	state->Simulating = true;
 }
 
-PxController * PhysicsEngine::GetCharacter(size_t ID)
+void PhysicsEngine::BeginCollide(float ElapsedTimeSeconds, SceneID Scene)
 {
-	if (ID < 0 && ID >= Characters.size())
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return;
+
+	if (state->Simulating)
 	{
-		std::cout << "Invalid character ID [" << ID << "] provided to GetCharacter" << std::endl;
-		return nullptr;
+		std::cout << "[Warning] BeginCollide called while the previous step is still running" << std::endl;
+		return;
 	}
 
-	return Characters[ID];
+	void * scratch = state->GetScratchBlock();
+	state->Scene->collide(ElapsedTimeSeconds, nullptr, scratch, scratch ? state->ScratchBlockSize : 0);
+	state->Simulating = true;
+	state->Colliding = true;
+}
+
+void PhysicsEngine::Advance(SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state || !state->Colliding)
+		return;
+
+	state->Scene->fetchCollision(true);
+	state->Scene->advance();
+	state->Colliding = false;
+}
+
+bool PhysicsEngine::EndSimulate(bool Block, SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state || !state->Simulating)
+		return true;
+
+	// A split step must be advanced before its results can be fetched
+	Advance(Scene);
+
+	if (!state->Scene->fetchResults(Block))
+		return false;
+
+	state->Simulating = false;
+	UpdatePoseCache(*state);
+	UpdateProfileCapture(*state);
+	UpdateAllocationDump();
+	UpdateCostReport(*state, Scene);
+	return true;
+}
+
+void PhysicsEngine::EndSimulateParallelCallbacks(SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state || !state->Simulating)
+		return;
+
+	Advance(Scene);
+
+	const PxContactPairHeader * pair_headers;
+	PxU32 pair_count;
+	state->Scene->fetchResultsStart(pair_headers, pair_count, true);
+
+	TaskGroup group(1);
+	CallbackFinishTask finish_task(group);
+	finish_task.setContinuation(*state->Scene->getTaskManager(), nullptr);
+
+	state->Scene->processCallbacks(&finish_task);
+	finish_task.removeReference();
+	group.Wait();
+
+	state->Scene->fetchResultsFinish();
+	state->Simulating = false;
+	UpdatePoseCache(*state);
+	UpdateProfileCapture(*state);
+	UpdateAllocationDump();
+	UpdateCostReport(*state, Scene);
 }
 
-void PhysicsEngine::SimulateFixedFrequency(float Frequency, std::function<void(float ElapsedTime)> Callback)
+bool PhysicsEngine::StartProfileCapture(const std::string& FilePath, uint32_t Frames)
 {
 	using namespace std;
 
-	static auto start_time = chrono::high_resolution_clock::now();
-	float step_size = 1.0f / Frequency;
+	if (!PVD)
+		return false;
 
-	ElapsedTime = chrono::duration<float, std::deca>(chrono::high_resolution_clock::now() - start_time).count();
-	if (ElapsedTime >= step_size)
+	if (PVD->isConnected(false))
 	{
-		if (Callback) Callback(ElapsedTime);
+		cout << "[Warning] A profile capture can't be started while the visual debugger is connected" << endl;
+		return false;
+	}
 
-		Simulate(ElapsedTime);
-		start_time = chrono::high_resolution_clock::now();
+	// Leftover of a previous connection (e.g. the debugger socket that failed to connect)
+	if (PvdTransport)
+		PvdTransport->release();
+
+	// Written from a background thread so the capture doesn't stall the simulation. Not compressed, PVD opens the file as is
+	PxPvdAsyncFileTransportDesc transport_desc;
+	transport_desc.name = FilePath.c_str();
+	transport_desc.compress = false;
+	PvdTransport = PxDefaultPvdAsyncFileTransportCreate(transport_desc);
+	if (!PvdTransport || !PVD->connect(*PvdTransport, PxPvdInstrumentationFlag::ePROFILE))
+	{
+		cout << "Failed to start the profile capture to " << FilePath << endl;
+		if (PvdTransport)
+			PvdTransport->release();
+		PvdTransport = nullptr;
+		return false;
 	}
+
+	ProfileCapturing = true;
+	ProfileFramesLeft = Frames;
+	return true;
 }
 
-PxControllerCollisionFlags PhysicsEngine::MoveCharacter(size_t ID, PxVec3 Disp, float ElapsedTime, bool ApplyGravity)
+void PhysicsEngine::StopProfileCapture()
 {
-	auto char_ptr = GetCharacter(ID);
-	if (ApplyGravity) Disp += Gravity;
+	if (!ProfileCapturing)
+		return;
 
-	return char_ptr->move(Disp, 1e-6, ElapsedTime, PxControllerFilters());
+	PVD->disconnect();
+	PvdTransport->release();
+	PvdTransport = nullptr;
+	ProfileCapturing = false;
+	ProfileFramesLeft = 0;
+
+	// Disconnecting removed the profiler callback
+	if (TraceProfiler)
+		PxSetProfilerCallback(TraceProfiler);
+}
+
+void PhysicsEngine::SetTracingEnabled(bool Enabled)
+{
+	if (!TraceProfiler)
+	{
+		if (!Enabled)
+			return;
+
+		TraceProfiler = PxTraceProfilerCreate();
+		if (!TraceProfiler)
+			return;
+
+		// A running capture keeps the callback, StopProfileCapture installs the profiler
+		if (!ProfileCapturing)
+			PxSetProfilerCallback(TraceProfiler);
+	}
+
+	TraceProfiler->setEnabled(Enabled);
+}
+
+bool PhysicsEngine::ExportTrace(const std::string& FilePath) const
+{
+	using namespace std;
+
+	if (!TraceProfiler)
+		return false;
+
+	PxDefaultFileOutputStream stream(FilePath.c_str());
+	if (!stream.isValid() || !TraceProfiler->exportChromeTrace(stream))
+	{
+		cout << "Failed to write the trace to " << FilePath << endl;
+		return false;
+	}
+
+	const PxU64 dropped = TraceProfiler->getNbDroppedEvents();
+	if (dropped)
+		cout << "[Warning] " << dropped << " trace events were dropped, too many threads" << endl;
+	return true;
+}
+
+void PhysicsEngine::SetAllocationProfilingEnabled(bool Enabled)
+{
+	using namespace std;
+
+	for (auto& scene : Scenes)
+	{
+		if (scene->Simulating)
+		{
+			cout << "[Warning] The allocation profiler can't be toggled while simulating" << endl;
+			return;
+		}
+	}
+
+	PxSetAllocationProfilingEnabled(Enabled);
+}
+
+bool PhysicsEngine::DumpAllocationProfile(const std::string& FilePath, uint32_t MaxSites) const
+{
+	using namespace std;
+
+	PxDefaultFileOutputStream stream(FilePath.c_str());
+	if (!stream.isValid())
+	{
+		cout << "Failed to write the allocation profile to " << FilePath << endl;
+		return false;
+	}
+
+	PxDumpAllocationProfile(stream, MaxSites);
+	return true;
+}
+
+namespace
+{
+	// Only set by the signal handler, the dump itself allocates so it waits for the end of a step
+	volatile std::sig_atomic_t AllocationDumpRequested = 0;
+
+	void RequestAllocationDump(int)
+	{
+		AllocationDumpRequested = 1;
+	}
+
+#ifdef SIGUSR1
+	const int AllocationDumpSignal = SIGUSR1;
+#else
+	const int AllocationDumpSignal = SIGBREAK;
+#endif
+}
+
+void PhysicsEngine::DumpAllocationProfileOnSignal(const std::string& FilePath)
+{
+	AllocationDumpPath = FilePath;
+	std::signal(AllocationDumpSignal, FilePath.empty() ? SIG_DFL : RequestAllocationDump);
+}
+
+void PhysicsEngine::UpdateAllocationDump()
+{
+	if (!AllocationDumpRequested || AllocationDumpPath.empty())
+		return;
+
+	AllocationDumpRequested = 0;
+	DumpAllocationProfile(AllocationDumpPath);
+}
+
+void PhysicsEngine::UpdateProfileCapture(const SimulationScene& Scene)
+{
+	if (!ProfileCapturing || !ProfileFramesLeft)
+		return;
+
+	if (ProfileFramesLeft > 1)
+	{
+		if (&Scene == Scenes.Get(DefaultScene)->get())
+			ProfileFramesLeft--;
+		return;
+	}
+
+	// Disconnecting while a scene is still sending events would cut its frame
+	for (const auto& state : Scenes)
+	{
+		if (state->Simulating)
+			return;
+	}
+	StopProfileCapture();
+}
+
+uint64_t PhysicsEngine::HashTriangleMeshDesc(const PxTriangleMeshDesc& MeshDesc) const
+{
+	uint64_t hash = HashValue(CookingParamsHash, 14695981039346656037ull);
+	hash = HashValue(uint32_t(MeshDesc.flags), hash);
+
+	// Only the positions are part of the key, whatever else the vertex type holds is skipped
+	auto points = static_cast<const uint8_t*>(MeshDesc.points.data);
+	for (PxU32 i = 0; i < MeshDesc.points.count; i++)
+		hash = HashBytes(points + i * MeshDesc.points.stride, sizeof(PxVec3), hash);
+
+	const PxU32 index_size = (MeshDesc.flags & PxMeshFlag::e16_BIT_INDICES) ? sizeof(PxU16) : sizeof(PxU32);
+	auto triangles = static_cast<const uint8_t*>(MeshDesc.triangles.data);
+	for (PxU32 i = 0; i < MeshDesc.triangles.count; i++)
+		hash = HashBytes(triangles + i * MeshDesc.triangles.stride, 3 * index_size, hash);
+
+	return hash;
+}
+
+std::unique_ptr<PxDefaultMappedFileInputData> PhysicsEngine::LoadCachedData(uint64_t Key, const char * Extension) const
+{
+	using namespace std;
+
+	if (CacheDirectory.empty())
+		return nullptr;
+
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.%s", (unsigned long long)Key, Extension);
+
+	// Blobs are replaced by a rename, so a mapping always sees a complete file
+	unique_ptr<PxDefaultMappedFileInputData> stream(new PxDefaultMappedFileInputData((CacheDirectory + "/" + name).c_str()));
+	if (!stream->isValid())
+		return nullptr;
+	return stream;
+}
+
+void PhysicsEngine::StoreCachedData(uint64_t Key, const char * Extension, const void * Data, size_t Size) const
+{
+	using namespace std;
+
+	if (CacheDirectory.empty())
+		return;
+
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.%s", (unsigned long long)Key, Extension);
+
+	// Write to a temporary file and move it over the blob, so other processes sharing the cache never read a partial one
+	// The temporary name is unique to this process and call, two writers of the same key don't share the file
+	static atomic<uint32_t> temp_counter(0);
+	char temp_suffix[64];
+	snprintf(temp_suffix, sizeof(temp_suffix), ".%d.%zx.%u.tmp", int(getpid()), hash<thread::id>()(this_thread::get_id()), unsigned(temp_counter++));
+
+	string path = CacheDirectory + "/" + name;
+	string temp_path = path + temp_suffix;
+	{
+		ofstream file(temp_path, ios::binary | ios::trunc);
+		if (!file || !file.write(static_cast<const char*>(Data), Size))
+		{
+			cout << "[Warning] Failed to write the cooked data to " << temp_path << endl;
+			return;
+		}
+	}
+
+	// The move replaces an existing blob in one step, a reader sees either the old file or the new one
+#ifdef _WIN32
+	const bool moved = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	const bool moved = rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+	if (!moved)
+		remove(temp_path.c_str());
+}
+
+PxTriangleMesh * PhysicsEngine::CookTriangleMesh(const PxTriangleMeshDesc& MeshDesc, MeshCookingMode Mode, PxDefaultMemoryOutputStream * CookedData)
+{
+	using namespace std;
+
+	PxTriangleMesh * mesh = nullptr;
+
+	uint64_t cache_key = 0;
+	if (!CacheDirectory.empty())
+	{
+		cache_key = HashTriangleMeshDesc(MeshDesc);
+
+		if (auto cached_data = LoadCachedData(cache_key, "mesh"))
+		{
+			// The blob is only copied out once it loaded, an invalid one must not end up in front of the cooked bytes
+			mesh = Physics->createTriangleMesh(*cached_data);
+			if (mesh)
+			{
+				if (CookedData)
+					CookedData->write(cached_data->getData(), cached_data->getLength());
+				return mesh;
+			}
+
+			cout << "[Warning] Discarding invalid cached triangle mesh" << endl;
+		}
+
+		// The cooked bytes are needed to fill the cache
+		Mode = MeshCookingMode::Stream;
+	}
+
+	if (Mode == MeshCookingMode::Direct)
+	{
+		// Single cook, the result is inserted in the SDK without going through a stream
+		mesh = Cooker->createTriangleMesh(MeshDesc, Physics->getPhysicsInsertionCallback());
+		if (!mesh)
+			cout << "Failed to create the triangle mesh" << endl;
+
+		return mesh;
+	}
+
+	PxDefaultMemoryOutputStream local_buffer;
+	PxDefaultMemoryOutputStream& write_buffer = CookedData ? *CookedData : local_buffer;
+	PxTriangleMeshCookingResult::Enum result;
+	if (!Cooker->cookTriangleMesh(MeshDesc, write_buffer, &result))
+	{
+		cout << "Failed to cook the triangle mesh" << endl;
+		return nullptr;
+	}
+
+	PxDefaultMemoryInputData read_buffer(write_buffer.getData(), write_buffer.getSize());
+	mesh = Physics->createTriangleMesh(read_buffer);
+	if (!mesh)
+	{
+		cout << "Failed to create the triangle mesh from the cooked data" << endl;
+		return nullptr;
+	}
+
+	if (!CacheDirectory.empty())
+		StoreCachedData(cache_key, "mesh", write_buffer.getData(), write_buffer.getSize());
+
+	return mesh;
+}
+
+std::vector<MeshID> PhysicsEngine::CreatePhysicsTriangleMeshes(const std::vector<PxTriangleMeshDesc>& MeshDescs, MeshCookingMode Mode)
+{
+	using namespace std;
+
+	vector<MeshID> ids(MeshDescs.size());
+	if (MeshDescs.empty())
+		return ids;
+
+	// Cooking is thread safe, so every mesh gets its own task. Only the final registration happens on this thread
+	// The tasks are low priority so they don't delay a simulation running at the same time
+	vector<PxTriangleMesh*> meshes(MeshDescs.size(), nullptr);
+	vector<FunctionTask> tasks(MeshDescs.size());
+	TaskGroup group(MeshDescs.size());
+
+	for (size_t i = 0; i < MeshDescs.size(); i++)
+	{
+		tasks[i].Set([this, &MeshDescs, &meshes, Mode, i]
+		{
+			meshes[i] = CookTriangleMesh(MeshDescs[i], Mode, nullptr);
+		}, group, PxTaskPriority::eLOW);
+		Dispatcher->submitTask(tasks[i]);
+	}
+	group.Wait();
+
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		if (meshes[i])
+			ids[i] = TriangleMeshes.Insert(meshes[i]);
+	}
+
+	return ids;
+}
+
+bool PhysicsEngine::ReleaseMesh(MeshID ID)
+{
+	auto mesh = TriangleMeshes.Get(ID);
+	if (!mesh)
+	{
+		std::cout << "Invalid mesh ID [" << ID.Index << "] provided to ReleaseMesh" << std::endl;
+		return false;
+	}
+
+	(*mesh)->release();
+	TriangleMeshes.Remove(ID);
+
+	for (auto it = SharedShapes.begin(); it != SharedShapes.end();)
+	{
+		if (it->first.Mesh != ID)
+		{
+			++it;
+			continue;
+		}
+
+		it->second->release();
+		it = SharedShapes.erase(it);
+	}
+
+	return true;
+}
+
+size_t PhysicsEngine::ShapeKeyHash::operator()(const ShapeKey& Key) const
+{
+	uint64_t hash = HashValue(Key.Mesh.Index, 14695981039346656037ull);
+	hash = HashValue(Key.Mesh.Generation, hash);
+	hash = HashValue(Key.Scale, hash);
+	hash = HashValue(Key.Material, hash);
+	return size_t(hash);
+}
+
+MaterialID PhysicsEngine::CreateMaterial(float StaticFriction, float DynamicFriction, float Restitution)
+{
+	auto material = Physics->createMaterial(StaticFriction, DynamicFriction, Restitution);
+	if (!material)
+	{
+		std::cout << "Failed to create the material" << std::endl;
+		return MaterialID();
+	}
+
+	return Materials.Insert(material);
+}
+
+PxMaterial * PhysicsEngine::GetMaterial(MaterialID ID)
+{
+	auto material = Materials.Get(ID);
+	return material ? *material : nullptr;
+}
+
+PxMaterial * PhysicsEngine::ResolveMaterial(MaterialID ID)
+{
+	auto material = GetMaterial(ID);
+	return material ? material : DefaultMaterial;
+}
+
+bool PhysicsEngine::ReleaseMaterial(MaterialID ID)
+{
+	auto material = Materials.Get(ID);
+	if (!material)
+	{
+		std::cout << "Invalid material ID [" << ID.Index << "] provided to ReleaseMaterial" << std::endl;
+		return false;
+	}
+
+	for (auto it = SharedShapes.begin(); it != SharedShapes.end();)
+	{
+		if (it->first.Material != *material)
+		{
+			++it;
+			continue;
+		}
+
+		it->second->release();
+		it = SharedShapes.erase(it);
+	}
+
+	(*material)->release();
+	Materials.Remove(ID);
+
+	return true;
+}
+
+ActorID PhysicsEngine::RegisterActor(PxRigidActor * Actor)
+{
+	ActorID id = Actors.Insert(Actor);
+
+	// Lets the active actors list be mapped back to the registry. Zero is kept for actors the wrapper doesn't track
+	Actor->userData = reinterpret_cast<void*>(size_t(id.Index) + 1);
+
+	const PxTransform pose = Actor->getGlobalPose();
+	PosePositions.push_back(pose.p);
+	PoseRotations.push_back(pose.q);
+
+	return id;
+}
+
+PxRigidActor * PhysicsEngine::GetActor(ActorID ID)
+{
+	auto actor = Actors.Get(ID);
+	return actor ? *actor : nullptr;
+}
+
+bool PhysicsEngine::RemoveActor(ActorID ID)
+{
+	using namespace std;
+
+	const uint32_t dense_idx = Actors.GetDenseIndex(ID);
+	if (dense_idx == UINT32_MAX)
+	{
+		cout << "Invalid actor ID [" << ID.Index << "] provided to RemoveActor" << endl;
+		return false;
+	}
+
+	PxRigidActor * actor = Actors.Data()[dense_idx];
+	if (actor->getScene() && GetSceneState(actor->getScene())->Simulating)
+	{
+		cout << "[Warning] Actors can't be removed while the scene is simulating" << endl;
+		return false;
+	}
+
+	actor->release();
+	Actors.Remove(ID);
+
+	// Mirror the swap with the last element done by the slot map
+	PosePositions[dense_idx] = PosePositions.back();
+	PoseRotations[dense_idx] = PoseRotations.back();
+	PosePositions.pop_back();
+	PoseRotations.pop_back();
+
+	return true;
+}
+
+bool PhysicsEngine::MoveActorToScene(ActorID ID, SceneID Scene)
+{
+	using namespace std;
+
+	auto actor = GetActor(ID);
+	if (!actor)
+	{
+		cout << "Invalid actor ID [" << ID.Index << "] provided to MoveActorToScene" << endl;
+		return false;
+	}
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return false;
+	if (actor->getScene() == state->Scene)
+		return true;
+
+	if (state->Simulating || (actor->getScene() && GetSceneState(actor->getScene())->Simulating))
+	{
+		cout << "[Warning] Actors can't be moved while their scenes are simulating" << endl;
+		return false;
+	}
+	if (actor->getType() != PxActorType::eRIGID_DYNAMIC || actor->getAggregate() || actor->getNbConstraints())
+	{
+		cout << "[Warning] Only dynamic actors outside of aggregates and without joints can be moved to another scene" << endl;
+		return false;
+	}
+
+	// The body keeps its velocities while out of a scene
+	if (actor->getScene())
+		actor->getScene()->removeActor(*actor, false);
+	state->Scene->addActor(*actor);
+
+	return true;
+}
+
+void PhysicsEngine::UpdatePoseCache(SimulationScene& Scene)
+{
+	if (Scene.ActiveActorsEnabled)
+	{
+		Scene.MovedActors.clear();
+
+		PxU32 active_count;
+		PxActor ** active_actors = Scene.Scene->getActiveActors(active_count);
+		for (PxU32 i = 0; i < active_count; i++)
+		{
+			// Character proxies and streamed chunks are not on the registry
+			const size_t slot = reinterpret_cast<size_t>(active_actors[i]->userData);
+			if (!slot)
+				continue;
+
+			const ActorID id = Actors.GetHandle(uint32_t(slot - 1));
+			const uint32_t dense_idx = Actors.GetDenseIndex(id);
+
+			const PxTransform pose = static_cast<PxRigidActor*>(active_actors[i])->getGlobalPose();
+			PosePositions[dense_idx] = pose.p;
+			PoseRotations[dense_idx] = pose.q;
+			Scene.MovedActors.push_back(id);
+		}
+		return;
+	}
+
+	const size_t count = Actors.Size();
+	PxRigidActor * const * actors = Actors.Data();
+	for (size_t i = 0; i < count; i++)
+	{
+		// Static actors can't move by themselves, and the other scenes may still be simulating
+		if (actors[i]->getType() != PxActorType::eRIGID_DYNAMIC || actors[i]->getScene() != Scene.Scene)
+			continue;
+
+		const PxTransform pose = actors[i]->getGlobalPose();
+		PosePositions[i] = pose.p;
+		PoseRotations[i] = pose.q;
+	}
+}
+
+void PhysicsEngine::EnableActiveActors(bool Enable, SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return;
+
+	state->Scene->setFlag(PxSceneFlag::eENABLE_ACTIVE_ACTORS, Enable);
+	state->ActiveActorsEnabled = Enable;
+	state->MovedActors.clear();
+}
+
+const std::vector<ActorID>& PhysicsEngine::GetMovedActorPoses(PxTransform * Poses, SceneID Scene) const
+{
+	static const std::vector<ActorID> no_actors;
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return no_actors;
+
+	for (ActorID id : state->MovedActors)
+	{
+		const uint32_t dense_idx = Actors.GetDenseIndex(id);
+		if (dense_idx != UINT32_MAX)
+			Poses[id.Index] = PxTransform(PosePositions[dense_idx], PoseRotations[dense_idx]);
+	}
+
+	return state->MovedActors;
+}
+
+size_t PhysicsEngine::GetActorPoses(const ActorID *& IDs, const PxVec3 *& Positions, const PxQuat *& Rotations) const
+{
+	IDs = Actors.Handles();
+	Positions = PosePositions.data();
+	Rotations = PoseRotations.data();
+
+	return Actors.Size();
+}
+
+bool SceneState::Assign(const void * Bytes, size_t Size)
+{
+	Data.clear();
+
+	Header header;
+	if (Size < sizeof(Header))
+		return false;
+	memcpy(&header, Bytes, sizeof(Header));
+	if (header.Version != Version || Size != sizeof(Header) + header.BodyCount * sizeof(Body) + header.CharacterCount * sizeof(Character))
+		return false;
+
+	Data.assign(static_cast<const uint8_t*>(Bytes), static_cast<const uint8_t*>(Bytes) + Size);
+	return true;
+}
+
+bool PhysicsEngine::SaveState(SceneState& State, SceneID Scene) const
+{
+	using namespace std;
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return false;
+	if (state->Simulating)
+	{
+		cout << "[Warning] The state can't be saved while the scene is simulating" << endl;
+		return false;
+	}
+
+	// Sized for every registered actor and character, the other scenes' share is trimmed at the end
+	State.Data.resize(sizeof(SceneState::Header) + Actors.Size() * sizeof(SceneState::Body) + Characters.Size() * sizeof(SceneState::Character));
+
+	auto bodies = reinterpret_cast<SceneState::Body*>(State.Data.data() + sizeof(SceneState::Header));
+	uint32_t body_count = 0;
+	PxRigidActor * const * actors = Actors.Data();
+	const ActorID * actor_ids = Actors.Handles();
+	for (size_t i = 0; i < Actors.Size(); i++)
+	{
+		if (actors[i]->getType() != PxActorType::eRIGID_DYNAMIC || actors[i]->getScene() != state->Scene)
+			continue;
+
+		auto actor = static_cast<PxRigidDynamic*>(actors[i]);
+		auto& body = bodies[body_count++];
+		body.ID = actor_ids[i];
+		body.Pose = actor->getGlobalPose();
+		body.Padding = 0;
+		if (actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC)
+		{
+			body.LinearVelocity = PxVec3(0.0f);
+			body.AngularVelocity = PxVec3(0.0f);
+			body.WakeCounter = 0.0f;
+			body.Flags = SceneState::Kinematic;
+		}
+		else
+		{
+			body.LinearVelocity = actor->getLinearVelocity();
+			body.AngularVelocity = actor->getAngularVelocity();
+			body.WakeCounter = actor->getWakeCounter();
+			body.Flags = actor->isSleeping() ? uint32_t(SceneState::Sleeping) : 0u;
+		}
+	}
+
+	auto characters = reinterpret_cast<SceneState::Character*>(bodies + body_count);
+	uint32_t character_count = 0;
+	PxController * const * controllers = Characters.Data();
+	const CharacterID * character_ids = Characters.Handles();
+	for (size_t i = 0; i < Characters.Size(); i++)
+	{
+		if (controllers[i]->getScene() != state->Scene)
+			continue;
+
+		characters[character_count].ID = character_ids[i];
+		characters[character_count].Position = controllers[i]->getPosition();
+		character_count++;
+	}
+
+	State.Data.resize(sizeof(SceneState::Header) + body_count * sizeof(SceneState::Body) + character_count * sizeof(SceneState::Character));
+
+	SceneState::Header header;
+	header.Version = SceneState::Version;
+	header.BodyCount = body_count;
+	header.CharacterCount = character_count;
+	header.Padding = 0;
+	header.Scene = Scene.IsValid() ? Scene : DefaultScene;
+	memcpy(State.Data.data(), &header, sizeof(header));
+
+	return true;
+}
+
+bool PhysicsEngine::RestoreState(const SceneState& State, SceneID Scene)
+{
+	using namespace std;
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return false;
+	if (state->Simulating)
+	{
+		cout << "[Warning] The state can't be restored while the scene is simulating" << endl;
+		return false;
+	}
+
+	if (!State.IsValid())
+	{
+		cout << "RestoreState needs a saved state" << endl;
+		return false;
+	}
+	SceneState::Header header;
+	memcpy(&header, State.Data.data(), sizeof(header));
+	if (header.Version != SceneState::Version || header.Scene != (Scene.IsValid() ? Scene : DefaultScene))
+	{
+		cout << "The state provided to RestoreState was saved from another scene or version" << endl;
+		return false;
+	}
+
+	if (state->ActiveActorsEnabled)
+		state->MovedActors.clear();
+
+	auto bodies = reinterpret_cast<const SceneState::Body*>(State.Data.data() + sizeof(SceneState::Header));
+	for (uint32_t i = 0; i < header.BodyCount; i++)
+	{
+		const auto& body = bodies[i];
+		const uint32_t dense_idx = Actors.GetDenseIndex(body.ID);
+		if (dense_idx == UINT32_MAX)
+			continue;
+
+		auto actor = static_cast<PxRigidDynamic*>(Actors.Data()[dense_idx]);
+		if (actor->getScene() != state->Scene)
+			continue;
+
+		// Nothing is woken up here, the sleep state is put back explicitly below
+		actor->setGlobalPose(body.Pose, false);
+		if (!(body.Flags & SceneState::Kinematic) && !(actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+		{
+			if (body.Flags & SceneState::Sleeping)
+				actor->putToSleep();
+			else
+			{
+				// A sleeping body ignores a wake counter of 0, and would stay asleep
+				if (actor->isSleeping())
+					actor->wakeUp();
+				actor->setLinearVelocity(body.LinearVelocity, false);
+				actor->setAngularVelocity(body.AngularVelocity, false);
+				actor->setWakeCounter(body.WakeCounter);
+			}
+		}
+
+		PosePositions[dense_idx] = body.Pose.p;
+		PoseRotations[dense_idx] = body.Pose.q;
+		if (state->ActiveActorsEnabled)
+			state->MovedActors.push_back(body.ID);
+	}
+
+	auto characters = reinterpret_cast<const SceneState::Character*>(bodies + header.BodyCount);
+	for (uint32_t i = 0; i < header.CharacterCount; i++)
+	{
+		auto controller = Characters.Get(characters[i].ID);
+		if (controller && (*controller)->getScene() == state->Scene)
+			(*controller)->setPosition(characters[i].Position);
+	}
+
+	return true;
+}
+
+PxConvexMesh * PhysicsEngine::CookConvexHull(const std::vector<PxVec3>& Points, const ConvexCookingOptions& Options)
+{
+	PxConvexMeshDesc convex_desc;
+	convex_desc.points.count = PxU32(Points.size());
+	convex_desc.points.stride = sizeof(PxVec3);
+	convex_desc.points.data = Points.data();
+	convex_desc.vertexLimit = Options.VertexLimit;
+
+	convex_desc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+	if (Options.QuantizedCount)
+	{
+		convex_desc.flags |= PxConvexFlag::eQUANTIZE_INPUT;
+		convex_desc.quantizedCount = Options.QuantizedCount;
+	}
+	if (Options.PlaneShifting)
+		convex_desc.flags |= PxConvexFlag::ePLANE_SHIFTING;
+	if (Options.ShiftVertices)
+		convex_desc.flags |= PxConvexFlag::eSHIFT_VERTICES;
+	if (Options.CheckZeroAreaTriangles)
+		convex_desc.flags |= PxConvexFlag::eCHECK_ZERO_AREA_TRIANGLES;
+	if (Options.FastInertiaComputation)
+		convex_desc.flags |= PxConvexFlag::eFAST_INERTIA_COMPUTATION;
+
+	PxConvexMeshCookingResult::Enum result;
+	PxConvexMesh * mesh = Cooker->createConvexMesh(convex_desc, Physics->getPhysicsInsertionCallback(), &result);
+	if (!mesh)
+	{
+		switch (result)
+		{
+		case PxConvexMeshCookingResult::eZERO_AREA_TEST_FAILED:
+			std::cout << "Failed to cook the convex hull, the points have no volume" << std::endl;
+			break;
+		case PxConvexMeshCookingResult::ePOLYGONS_LIMIT_REACHED:
+			std::cout << "Failed to cook the convex hull, the polygon limit was reached" << std::endl;
+			break;
+		default:
+			std::cout << "Failed to cook the convex hull" << std::endl;
+			break;
+		}
+	}
+
+	return mesh;
+}
+
+ConvexID PhysicsEngine::CreateConvexMesh(const std::vector<PxVec3>& Points, const ConvexCookingOptions& Options)
+{
+	PxConvexMesh * mesh = CookConvexHull(Points, Options);
+	if (!mesh)
+		return ConvexID();
+
+	ConvexCompound compound;
+	compound.Hulls.push_back(mesh);
+	compound.LocalPoses.push_back(PxTransform(PxIdentity));
+
+	return Convexes.Insert(std::move(compound));
+}
+
+ConvexID PhysicsEngine::CreateConvexCompound(const std::vector<ConvexHullDesc>& Hulls, const ConvexCookingOptions& Options)
+{
+	using namespace std;
+
+	if (Hulls.empty())
+	{
+		cout << "A convex compound needs at least one hull" << endl;
+		return ConvexID();
+	}
+
+	ConvexCompound compound;
+	compound.Hulls.resize(Hulls.size(), nullptr);
+
+	vector<FunctionTask> tasks(Hulls.size());
+	TaskGroup group(Hulls.size());
+	for (size_t i = 0; i < Hulls.size(); i++)
+	{
+		tasks[i].Set([this, &Hulls, &compound, &Options, i]
+		{
+			compound.Hulls[i] = CookConvexHull(Hulls[i].Points, Options);
+		}, group, PxTaskPriority::eLOW);
+		Dispatcher->submitTask(tasks[i]);
+	}
+	group.Wait();
+
+	bool failed = false;
+	for (size_t i = 0; i < Hulls.size(); i++)
+	{
+		failed |= !compound.Hulls[i];
+		compound.LocalPoses.push_back(Hulls[i].LocalPose);
+	}
+
+	if (failed)
+	{
+		for (auto hull : compound.Hulls)
+		{
+			if (hull)
+				hull->release();
+		}
+		return ConvexID();
+	}
+
+	return Convexes.Insert(std::move(compound));
+}
+
+bool PhysicsEngine::ReleaseConvex(ConvexID ID)
+{
+	auto convex = Convexes.Get(ID);
+	if (!convex)
+	{
+		std::cout << "Invalid convex ID [" << ID.Index << "] provided to ReleaseConvex" << std::endl;
+		return false;
+	}
+
+	for (auto hull : convex->Hulls)
+		hull->release();
+	Convexes.Remove(ID);
+
+	return true;
+}
+
+ActorID PhysicsEngine::CreateStaticActor(MeshID Mesh, PxVec3 Position, PxQuat Rotation, PxVec3 Scale, MaterialID Material, SceneID Scene)
+{
+	using namespace std;
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return ActorID();
+
+	auto mesh = TriangleMeshes.Get(Mesh);
+	if (!mesh)
+	{
+		cout << "Invalid mesh ID [" << Mesh.Index << "] provided to CreateStaticActor" << endl;
+		return ActorID();
+	}
+
+	PxMaterial * material = ResolveMaterial(Material);
+
+	// Instances of the same mesh, scale and material share one shape
+	ShapeKey key = { Mesh, Scale, material };
+	PxShape *& shape = SharedShapes[key];
+	if (!shape)
+	{
+		PxTriangleMeshGeometry instance(*mesh, PxMeshScale(Scale));
+		shape = Physics->createShape(instance, *material, false);
+		if (!shape)
+		{
+			cout << "Failed to create the shape for the static actor" << endl;
+			SharedShapes.erase(key);
+			return ActorID();
+		}
+	}
+
+	// The SDK removes the actor on shutdown, but it can be removed earlier with RemoveActor
+	auto actor = Physics->createRigidStatic(PxTransform(Position, Rotation));
+	if (!actor)
+	{
+		cout << "Failed to create the static actor" << endl;
+		return ActorID();
+	}
+	actor->attachShape(*shape);
+	state->Scene->addActor(*actor);
+
+	return RegisterActor(actor);
+}
+
+std::vector<ActorID> PhysicsEngine::CreateDynamicActors(const std::vector<DynamicActorDesc>& Descs, bool UseAggregate, SceneID Scene)
+{
+	using namespace std;
+
+	vector<ActorID> ids(Descs.size());
+	auto state = ResolveScene(Scene);
+	if (Descs.empty() || !state)
+		return ids;
+
+	if (state->Simulating)
+	{
+		cout << "[Warning] Actors can't be added while the scene is simulating" << endl;
+		return ids;
+	}
+
+	vector<PxActor*> actors;
+	actors.reserve(Descs.size());
+	// The convex actors get their mass in one go at the end, the pieces of a convex share its hulls
+	vector<PxRigidBody*> convex_bodies;
+	vector<PxReal> convex_densities;
+	for (size_t i = 0; i < Descs.size(); i++)
+	{
+		const DynamicActorDesc& desc = Descs[i];
+		PxMaterial * material = ResolveMaterial(desc.Material);
+
+		// PxCreateDynamic takes care of the mass and inertia (through PxRigidBodyExt::updateMassAndInertia)
+		PxRigidDynamic * actor = nullptr;
+		switch (desc.Type)
+		{
+		case DynamicShapeType::Box:
+			actor = PxCreateDynamic(*Physics, desc.Pose, PxBoxGeometry(desc.HalfExtents), *material, desc.Density);
+			break;
+		case DynamicShapeType::Sphere:
+			actor = PxCreateDynamic(*Physics, desc.Pose, PxSphereGeometry(desc.Radius), *material, desc.Density);
+			break;
+		case DynamicShapeType::Capsule:
+			actor = PxCreateDynamic(*Physics, desc.Pose, PxCapsuleGeometry(desc.Radius, desc.HalfHeight), *material, desc.Density);
+			break;
+		case DynamicShapeType::Convex:
+			if (auto convex = Convexes.Get(desc.Convex))
+			{
+				actor = Physics->createRigidDynamic(desc.Pose);
+				if (!actor)
+					break;
+
+				// One shape per hull. The hull offsets are scaled along with the hulls
+				for (size_t hull = 0; hull < convex->Hulls.size(); hull++)
+				{
+					PxTransform local_pose = convex->LocalPoses[hull];
+					local_pose.p = local_pose.p.multiply(desc.ConvexScale);
+
+					PxShape * shape = PxRigidActorExt::createExclusiveShape(*actor, PxConvexMeshGeometry(convex->Hulls[hull], PxMeshScale(desc.ConvexScale)), *material);
+					if (shape)
+						shape->setLocalPose(local_pose);
+				}
+				convex_bodies.push_back(actor);
+				convex_densities.push_back(desc.Density);
+			}
+			break;
+		}
+
+		if (!actor)
+		{
+			cout << "Failed to create dynamic actor [" << i << "]" << endl;
+			continue;
+		}
+
+		actor->setLinearVelocity(desc.LinearVelocity);
+		actor->setAngularVelocity(desc.AngularVelocity);
+		if (desc.EnableCCD)
+			actor->setRigidBodyFlag(PxRigidBodyFlag::eENABLE_CCD, true);
+		if (desc.SpeculativeCCD)
+			actor->setRigidBodyFlag(PxRigidBodyFlag::eENABLE_SPECULATIVE_CCD, true);
+		actors.push_back(actor);
+		ids[i] = RegisterActor(actor);
+	}
+
+	if (!convex_bodies.empty())
+		PxRigidBodyExt::updateMassAndInertia(convex_bodies.data(), PxU32(convex_bodies.size()), convex_densities.data());
+
+	if (actors.empty())
+		return ids;
+
+	if (UseAggregate)
+	{
+		// An aggregate can't hold more than 128 actors, bigger batches are split
+		const size_t max_aggregate_size = 128;
+		size_t first = 0;
+		for (; first < actors.size(); first += max_aggregate_size)
+		{
+			const size_t count = min(max_aggregate_size, actors.size() - first);
+			PxAggregate * aggregate = Physics->createAggregate(PxU32(count), true);
+			if (!aggregate)
+				break;
+
+			for (size_t i = first; i < first + count; i++)
+				aggregate->addActor(*actors[i]);
+			state->Scene->addAggregate(*aggregate);
+		}
+
+		if (first >= actors.size())
+			return ids;
+
+		cout << "[Warning] Failed to create the aggregate, adding the actors to the scene instead" << endl;
+		actors.erase(actors.begin(), actors.begin() + first);
+	}
+
+	state->Scene->addActors(actors.data(), PxU32(actors.size()));
+
+	return ids;
+}
+
+PxHeightField * PhysicsEngine::CookHeightField(const PxHeightFieldDesc& HeightFieldDesc)
+{
+	using namespace std;
+
+	// Registered with the first terrain when Initialize left them out
+	EnableFeatures(FeatureHeightFields);
+
+	if (CacheDirectory.empty())
+		return Cooker->createHeightField(HeightFieldDesc, Physics->getPhysicsInsertionCallback());
+
+	uint64_t cache_key = HashValue(CookingParamsHash, 14695981039346656037ull);
+	cache_key = HashValue(HeightFieldDesc.nbColumns, cache_key);
+	cache_key = HashValue(HeightFieldDesc.nbRows, cache_key);
+	cache_key = HashBytes(HeightFieldDesc.samples.data, size_t(HeightFieldDesc.nbRows) * HeightFieldDesc.nbColumns * sizeof(PxHeightFieldSample), cache_key);
+
+	if (auto cached_data = LoadCachedData(cache_key, "hf"))
+	{
+		if (auto hf_ptr = Physics->createHeightField(*cached_data))
+			return hf_ptr;
+	}
+
+	PxDefaultMemoryOutputStream write_buffer;
+	if (!Cooker->cookHeightField(HeightFieldDesc, write_buffer))
+		return nullptr;
+
+	PxDefaultMemoryInputData read_buffer(write_buffer.getData(), write_buffer.getSize());
+	auto hf_ptr = Physics->createHeightField(read_buffer);
+	if (hf_ptr)
+		StoreCachedData(cache_key, "hf", write_buffer.getData(), write_buffer.getSize());
+
+	return hf_ptr;
+}
+
+ActorID PhysicsEngine::CreateTerrainTile(PxVec3 Position, PxVec3 Scale, const HeightmapView& Heightmap, float MinZ, float MaxZ, uint32_t X0, uint32_t Y0, uint32_t CountX, uint32_t CountY, PxMaterial& Material, std::vector<PxHeightFieldSample>& Samples, PxScene& Scene)
+{
+	using namespace std;
+
+	// Rows of the heightfield go along X and its columns along Z
+	PxHeightFieldDesc hf_desc;
+	hf_desc.format = PxHeightFieldFormat::eS16_TM;
+	hf_desc.nbRows = CountX;
+	hf_desc.nbColumns = CountY;
+
+	// The full 16 bit range is used, the offset and scale are applied on the geometry and the actor pose
+	const bool is_float = Heightmap.Format == HeightmapFormat::Float;
+	const int32_t min_sample = is_float ? -32767 : -32768;
+	const float height_scale = PxMax(MaxZ - MinZ, 1e-6f) / (is_float ? 65534.0f : 65535.0f);
+
+	// The buffer is reused between the tiles, so every sample is reset
+	Samples.assign(size_t(CountX) * CountY, PxHeightFieldSample());
+
+	vector<PxI16> row(CountX);
+	const size_t sample_size = is_float ? sizeof(float) : sizeof(uint16_t);
+	for (uint32_t y = 0; y < CountY; y++)
+	{
+		auto src = static_cast<const uint8_t*>(Heightmap.Data) + size_t(Y0 + y) * Heightmap.RowStride + size_t(X0) * sample_size;
+		if (is_float)
+			QuantizeHeights(reinterpret_cast<const float*>(src), CountX, row.data());
+		else
+			QuantizeHeights(reinterpret_cast<const uint16_t*>(src), CountX, row.data());
+
+		// Transposed write, the input rows become heightfield columns
+		for (uint32_t x = 0; x < CountX; x++)
+			Samples[size_t(x) * CountY + y].height = row[x];
+	}
+
+	hf_desc.samples.data = Samples.data();
+	hf_desc.samples.stride = sizeof(PxHeightFieldSample);
+
+	PxHeightField * hf_ptr = CookHeightField(hf_desc);
+	if (!hf_ptr)
+	{
+		cout << "Failed to create the heightfield" << endl;
+		return ActorID();
+	}
+
+	const float row_scale = Scale.x / (Heightmap.SizeX - 1);
+	const float column_scale = Scale.z / (Heightmap.SizeY - 1);
+	PxHeightFieldGeometry geo(hf_ptr, PxMeshGeometryFlags(), height_scale, row_scale, column_scale);
+
+	PxTransform tworld(Position + PxVec3(X0 * row_scale, MinZ - min_sample * height_scale, Y0 * column_scale));
+
+	// The SDK removes the actor on shutdown, but it can be removed earlier with RemoveActor
+	auto actor = PxCreateStatic(*Physics, tworld, geo, Material);
+
+	// The actor holds its own reference
+	hf_ptr->release();
+
+	if (!actor)
+	{
+		cout << "Failed to create the terrain actor" << endl;
+		return ActorID();
+	}
+	Scene.addActor(*actor);
+
+	return RegisterActor(actor);
+}
+
+ActorID PhysicsEngine::CreateTerrain(PxVec3 Position, PxVec3 Scale, uint32_t SizeX, uint32_t SizeY, float MinZ, float MaxZ, const std::vector<float>& Heightmap)
+{
+	if (Heightmap.size() < size_t(SizeX) * SizeY)
+	{
+		std::cout << "The heightmap has less than SizeX * SizeY samples" << std::endl;
+		return ActorID();
+	}
+
+	HeightmapView view;
+	view.Data = Heightmap.data();
+	view.Format = HeightmapFormat::Float;
+	view.SizeX = SizeX;
+	view.SizeY = SizeY;
+	view.RowStride = SizeX * sizeof(float);
+
+	return CreateTerrain(Position, Scale, view, MinZ, MaxZ);
+}
+
+ActorID PhysicsEngine::CreateTerrain(PxVec3 Position, PxVec3 Scale, const HeightmapView& Heightmap, float MinZ, float MaxZ, MaterialID Material, SceneID Scene)
+{
+	if (Heightmap.SizeX < 2 || Heightmap.SizeY < 2)
+	{
+		std::cout << "A terrain needs at least 2x2 samples" << std::endl;
+		return ActorID();
+	}
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return ActorID();
+
+	std::vector<PxHeightFieldSample> samples;
+	return CreateTerrainTile(Position, Scale, Heightmap, MinZ, MaxZ, 0, 0, Heightmap.SizeX, Heightmap.SizeY, *ResolveMaterial(Material), samples, *state->Scene);
+}
+
+std::vector<ActorID> PhysicsEngine::CreateTiledTerrain(PxVec3 Position, PxVec3 Scale, const HeightmapView& Heightmap, float MinZ, float MaxZ, uint32_t TileSize, MaterialID Material, SceneID Scene)
+{
+	using namespace std;
+
+	vector<ActorID> ids;
+	if (Heightmap.SizeX < 2 || Heightmap.SizeY < 2 || TileSize < 2)
+	{
+		cout << "A terrain needs at least 2x2 samples, and so does each tile" << endl;
+		return ids;
+	}
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return ids;
+
+	// The samples buffer is reused by every tile
+	vector<PxHeightFieldSample> samples;
+	PxMaterial& material = *ResolveMaterial(Material);
+	const uint32_t step = TileSize - 1;
+	for (uint32_t y0 = 0; y0 + 1 < Heightmap.SizeY; y0 += step)
+	{
+		for (uint32_t x0 = 0; x0 + 1 < Heightmap.SizeX; x0 += step)
+		{
+			const uint32_t count_x = PxMin(TileSize, Heightmap.SizeX - x0);
+			const uint32_t count_y = PxMin(TileSize, Heightmap.SizeY - y0);
+			ids.push_back(CreateTerrainTile(Position, Scale, Heightmap, MinZ, MaxZ, x0, y0, count_x, count_y, material, samples, *state->Scene));
+		}
+	}
+
+	return ids;
+}
+
+void PhysicsEngine::EnableStreaming(float ChunkSize, int32_t Radius, ChunkLoaderFn Loader)
+{
+	if (StreamingThread.joinable())
+	{
+		std::cout << "[Warning] Streaming is already enabled" << std::endl;
+		return;
+	}
+
+	this->ChunkSize = ChunkSize;
+	ChunkRadius = Radius;
+	ChunkLoader = std::move(Loader);
+	StreamingThread = std::thread(&PhysicsEngine::StreamingLoop, this);
+}
+
+void PhysicsEngine::StreamingLoop()
+{
+	using namespace std;
+
+	while (true)
+	{
+		int64_t key;
+		{
+			unique_lock<mutex> lock(StreamingMutex);
+			StreamingWake.wait(lock, [this] { return StreamingQuit || !LoadQueue.empty(); });
+			if (StreamingQuit)
+				return;
+
+			// The queue is sorted farthest first, so the closest chunk is at the back
+			key = LoadQueue.back();
+			LoadQueue.pop_back();
+		}
+
+		StreamedChunk chunk;
+		BuildChunk(key, chunk);
+
+		lock_guard<mutex> lock(StreamingMutex);
+		ReadyChunks.push_back(move(chunk));
+	}
+}
+
+void PhysicsEngine::BuildChunk(int64_t Key, StreamedChunk& Chunk)
+{
+	using namespace std;
+
+	Chunk.Key = Key;
+
+	ChunkContent content;
+	if (!ChunkLoader(ChunkKeyX(Key), ChunkKeyZ(Key), content))
+		return;
+
+	for (const auto& chunk_mesh : content.Meshes)
+	{
+		PxTriangleMeshDesc mesh_desc;
+		mesh_desc.points.count = PxU32(chunk_mesh.Vertices.size());
+		mesh_desc.points.stride = sizeof(PxVec3);
+		mesh_desc.points.data = chunk_mesh.Vertices.data();
+		mesh_desc.triangles.count = PxU32(chunk_mesh.Indices.size() / 3);
+		mesh_desc.triangles.stride = 3 * sizeof(uint32_t);
+		mesh_desc.triangles.data = chunk_mesh.Indices.data();
+
+		auto mesh = CookTriangleMesh(mesh_desc, MeshCookingMode::Direct, nullptr);
+		if (!mesh)
+			continue;
+
+		PxTriangleMeshGeometry instance(mesh, PxMeshScale(chunk_mesh.Scale));
+		auto actor = PxCreateStatic(*Physics, chunk_mesh.Pose, instance, *DefaultMaterial);
+
+		// The shape keeps its own reference, so the mesh goes away along with the chunk
+		mesh->release();
+
+		if (!actor)
+		{
+			cout << "Failed to create a static actor for chunk [" << ChunkKeyX(Key) << ", " << ChunkKeyZ(Key) << "]" << endl;
+			continue;
+		}
+		Chunk.Actors.push_back(actor);
+	}
+
+	if (Chunk.Actors.empty())
+		return;
+
+	// Precomputing the query tree here means the insertion on the main thread is only a merge
+	// Big chunks build their tree on the workers too, small ones stay on this thread
+	Chunk.Pruning = Physics->createPruningStructure(reinterpret_cast<PxRigidActor* const*>(Chunk.Actors.data()), PxU32(Chunk.Actors.size()), Dispatcher);
+}
+
+void PhysicsEngine::ReleaseChunkActors(std::vector<PxActor*>& Actors, bool InScene)
+{
+	if (InScene && !Actors.empty())
+		GetScene(DefaultScene)->removeActors(Actors.data(), PxU32(Actors.size()));
+
+	for (auto actor : Actors)
+		actor->release();
+	Actors.clear();
+}
+
+void PhysicsEngine::UpdateStreaming(PxVec3 FocusPosition)
+{
+	using namespace std;
+
+	if (!StreamingThread.joinable())
+		return;
+
+	PxScene * scene = GetScene(DefaultScene);
+	if (GetSceneState(scene)->Simulating)
+	{
+		cout << "[Warning] UpdateStreaming can't be called while the scene is simulating" << endl;
+		return;
+	}
+
+	const int32_t focus_x = int32_t(floorf(FocusPosition.x / ChunkSize));
+	const int32_t focus_z = int32_t(floorf(FocusPosition.z / ChunkSize));
+	auto in_range = [&](int64_t Key)
+	{
+		return abs(ChunkKeyX(Key) - focus_x) <= ChunkRadius && abs(ChunkKeyZ(Key) - focus_z) <= ChunkRadius;
+	};
+
+	const int64_t focus_key = ChunkKey(focus_x, focus_z);
+	if (!HasFocusChunk || focus_key != FocusChunk)
+	{
+		HasFocusChunk = true;
+		FocusChunk = focus_key;
+
+		// Unload what went out of range
+		for (auto it = LoadedChunks.begin(); it != LoadedChunks.end();)
+		{
+			if (in_range(it->first))
+			{
+				++it;
+				continue;
+			}
+
+			ReleaseChunkActors(it->second, true);
+			it = LoadedChunks.erase(it);
+		}
+
+		vector<int64_t> new_requests;
+		for (int32_t x = focus_x - ChunkRadius; x <= focus_x + ChunkRadius; x++)
+		{
+			for (int32_t z = focus_z - ChunkRadius; z <= focus_z + ChunkRadius; z++)
+			{
+				int64_t key = ChunkKey(x, z);
+				if (!LoadedChunks.count(key) && RequestedChunks.insert(key).second)
+					new_requests.push_back(key);
+			}
+		}
+
+		{
+			lock_guard<mutex> lock(StreamingMutex);
+
+			// Drop the queued requests that are not needed anymore
+			auto queue_end = remove_if(LoadQueue.begin(), LoadQueue.end(), [&](int64_t Key) { return !in_range(Key); });
+			for (auto it = queue_end; it != LoadQueue.end(); ++it)
+				RequestedChunks.erase(*it);
+			LoadQueue.erase(queue_end, LoadQueue.end());
+
+			LoadQueue.insert(LoadQueue.end(), new_requests.begin(), new_requests.end());
+			sort(LoadQueue.begin(), LoadQueue.end(), [&](int64_t A, int64_t B)
+			{
+				auto distance = [&](int64_t Key) { return max(abs(ChunkKeyX(Key) - focus_x), abs(ChunkKeyZ(Key) - focus_z)); };
+				return distance(A) > distance(B);
+			});
+		}
+		StreamingWake.notify_one();
+	}
+
+	vector<StreamedChunk> ready;
+	{
+		lock_guard<mutex> lock(StreamingMutex);
+		ready.swap(ReadyChunks);
+	}
+
+	for (auto& chunk : ready)
+	{
+		const bool wanted = RequestedChunks.erase(chunk.Key) && in_range(chunk.Key);
+		if (!chunk.Pruning)
+		{
+			// Empty chunk, only remember it so it's not requested again
+			if (wanted)
+				LoadedChunks[chunk.Key];
+			ReleaseChunkActors(chunk.Actors, false);
+			continue;
+		}
+
+		if (wanted)
+			scene->addActors(*chunk.Pruning);
+
+		// Must be released before its actors, once merged in the scene it's not needed anymore
+		chunk.Pruning->release();
+
+		if (wanted)
+			LoadedChunks[chunk.Key] = move(chunk.Actors);
+		else
+			ReleaseChunkActors(chunk.Actors, false);
+	}
+}
+
+uint32_t QueryBatch::AddRaycast(PxVec3 Origin, PxVec3 Direction, float MaxDistance, bool AnyHit)
+{
+	Raycasts.push_back(Raycast{ Origin, Direction, MaxDistance, AnyHit });
+	return uint32_t(Raycasts.size() - 1);
+}
+
+uint32_t QueryBatch::AddSweep(const PxGeometry& Geometry, const PxTransform& Pose, PxVec3 Direction, float MaxDistance, bool AnyHit)
+{
+	Sweeps.push_back(Sweep{ PxGeometryHolder(Geometry), Pose, Direction, MaxDistance, AnyHit });
+	return uint32_t(Sweeps.size() - 1);
+}
+
+uint32_t QueryBatch::AddOverlap(const PxGeometry& Geometry, const PxTransform& Pose)
+{
+	Overlaps.push_back(Overlap{ PxGeometryHolder(Geometry), Pose });
+	return uint32_t(Overlaps.size() - 1);
+}
+
+void QueryBatch::Clear()
+{
+	Raycasts.clear();
+	Sweeps.clear();
+	Overlaps.clear();
+	RaycastHits.clear();
+	SweepHits.clear();
+	OverlapCounts.clear();
+	OverlapActors.clear();
+}
+
+void PhysicsEngine::ExecuteQueries(QueryBatch& Batch, SceneID Scene)
+{
+	using namespace std;
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return;
+
+	if (state->Simulating)
+	{
+		cout << "[Warning] Queries can't be executed while the scene is simulating" << endl;
+		return;
+	}
+
+	Batch.RaycastHits.assign(Batch.Raycasts.size(), QueryHit());
+	Batch.SweepHits.assign(Batch.Sweeps.size(), QueryHit());
+	Batch.OverlapCounts.assign(Batch.Overlaps.size(), 0);
+	Batch.OverlapActors.assign(Batch.Overlaps.size() * QueryBatch::MaxOverlapActors, ActorID());
+
+	// The queries only read the scene, so they can run at the same time on every worker
+	// All the requests are seen as a single range, split in jobs of a fixed size
+	const size_t job_size = 64;
+	const size_t raycast_end = Batch.Raycasts.size();
+	const size_t sweep_end = raycast_end + Batch.Sweeps.size();
+	const size_t total = sweep_end + Batch.Overlaps.size();
+	if (!total)
+		return;
+
+	PxScene * scene = state->Scene;
+	auto to_actor_id = [this](PxRigidActor * Actor)
+	{
+		const size_t slot = reinterpret_cast<size_t>(Actor->userData);
+		return slot ? Actors.GetHandle(uint32_t(slot - 1)) : ActorID();
+	};
+	auto fill_hit = [&](const PxLocationHit& Hit, PxRigidActor * Actor, QueryHit& Result)
+	{
+		Result.Hit = true;
+		Result.Actor = to_actor_id(Actor);
+		Result.Position = Hit.position;
+		Result.Normal = Hit.normal;
+		Result.Distance = Hit.distance;
+	};
+
+	const size_t job_count = (total + job_size - 1) / job_size;
+	vector<FunctionTask> tasks(job_count);
+	TaskGroup group(job_count);
+	for (size_t job = 0; job < job_count; job++)
+	{
+		tasks[job].Set([&, job]
+		{
+			const size_t end = min(total, (job + 1) * job_size);
+			for (size_t i = job * job_size; i < end; i++)
+			{
+				if (i < raycast_end)
+				{
+					const auto& request = Batch.Raycasts[i];
+					PxQueryFilterData filter;
+					if (request.AnyHit)
+						filter.flags |= PxQueryFlag::eANY_HIT;
+
+					PxRaycastBuffer hit;
+					if (scene->raycast(request.Origin, request.Direction, request.MaxDistance, hit, PxHitFlag::eDEFAULT, filter) && hit.hasBlock)
+						fill_hit(hit.block, hit.block.actor, Batch.RaycastHits[i]);
+				}
+				else if (i < sweep_end)
+				{
+					const size_t index = i - raycast_end;
+					const auto& request = Batch.Sweeps[index];
+					PxQueryFilterData filter;
+					if (request.AnyHit)
+						filter.flags |= PxQueryFlag::eANY_HIT;
+
+					PxSweepBuffer hit;
+					if (scene->sweep(request.Geometry.any(), request.Pose, request.Direction, request.MaxDistance, hit, PxHitFlag::eDEFAULT, filter) && hit.hasBlock)
+						fill_hit(hit.block, hit.block.actor, Batch.SweepHits[index]);
+				}
+				else
+				{
+					const size_t index = i - sweep_end;
+					const auto& request = Batch.Overlaps[index];
+
+					// Every overlap is a touch, otherwise only a single blocking hit would be reported
+					PxQueryFilterData filter;
+					filter.flags |= PxQueryFlag::eNO_BLOCK;
+
+					PxOverlapHit touches[QueryBatch::MaxOverlapActors];
+					PxOverlapBuffer hits(touches, QueryBatch::MaxOverlapActors);
+					scene->overlap(request.Geometry.any(), request.Pose, hits, filter);
+
+					ActorID * actors = Batch.OverlapActors.data() + index * QueryBatch::MaxOverlapActors;
+					for (PxU32 touch = 0; touch < hits.nbTouches; touch++)
+						actors[touch] = to_actor_id(touches[touch].actor);
+					Batch.OverlapCounts[index] = hits.nbTouches;
+				}
+			}
+		}, group);
+		Dispatcher->submitTask(tasks[job]);
+	}
+	group.Wait();
+}
+
+uint32_t PhysicsEngine::StreamOverlap(const PxGeometry& Geometry, const PxTransform& Pose, const std::function<bool(const ActorID * Actors, uint32_t Count)>& Callback, SceneID Scene)
+{
+	using namespace std;
+
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return 0;
+
+	if (state->Simulating)
+	{
+		cout << "[Warning] Queries can't be executed while the scene is simulating" << endl;
+		return 0;
+	}
+
+	const uint32_t block_size = 64;
+	struct StreamState
+	{
+		PhysicsEngine * Engine;
+		const std::function<bool(const ActorID*, uint32_t)> * Callback;
+		ActorID Actors[block_size];
+	} stream_state{ this, &Callback, {} };
+
+	// The SDK hands out the hits each time the block fills up, so no buffer has to fit the whole result
+	PxOverlapStreamN<block_size> hits([](const PxOverlapHit * Hits, PxU32 Count, void * UserData) -> PxAgain
+	{
+		auto& stream = *static_cast<StreamState*>(UserData);
+		for (PxU32 i = 0; i < Count; i++)
+		{
+			const size_t slot = reinterpret_cast<size_t>(Hits[i].actor->userData);
+			stream.Actors[i] = slot ? stream.Engine->Actors.GetHandle(uint32_t(slot - 1)) : ActorID();
+		}
+		return (*stream.Callback)(stream.Actors, Count);
+	}, &stream_state);
+
+	// Every overlap is a touch, otherwise only a single blocking hit would be reported
+	PxQueryFilterData filter;
+	filter.flags |= PxQueryFlag::eNO_BLOCK;
+	state->Scene->overlap(Geometry, Pose, hits, filter);
+
+	return hits.nbStreamed;
+}
+
+CharacterID PhysicsEngine::CreateCharacterController(PxVec3 StartPosition, float Height, float Radius, SceneID Scene)
+{
+	auto state = ResolveScene(Scene);
+	if (!state)
+		return CharacterID();
+
+	PxCapsuleControllerDesc desc;
+
+	desc.height = Height;
+	desc.radius = Radius;
+	desc.position = PxExtendedVec3(StartPosition.x, StartPosition.y, StartPosition.z);
+	desc.contactOffset = Radius + Radius * 0.1;
+	desc.stepOffset = Height * 0.25;
+	desc.material = DefaultMaterial;
+
+	PxController * controller = state->CharacterManager->createController(desc);
+	if (!controller)
+	{
+		std::cout << "Failed to create the character controller" << std::endl;
+		return CharacterID();
+	}
+
+	return Characters.Insert(controller);
+}
+
+PxController * PhysicsEngine::GetCharacter(CharacterID ID)
+{
+	auto controller = Characters.Get(ID);
+	if (!controller)
+	{
+		std::cout << "Invalid character ID [" << ID.Index << "] provided to GetCharacter" << std::endl;
+		return nullptr;
+	}
+
+	return *controller;
+}
+
+bool PhysicsEngine::RemoveCharacter(CharacterID ID)
+{
+	auto controller = Characters.Get(ID);
+	if (!controller)
+	{
+		std::cout << "Invalid character ID [" << ID.Index << "] provided to RemoveCharacter" << std::endl;
+		return false;
+	}
+
+	(*controller)->release();
+	Characters.Remove(ID);
+
+	return true;
+}
+
+float PhysicsEngine::SimulateFixedFrequency(float Frequency, std::function<void(float ElapsedTime)> Callback, uint32_t MaxSubSteps)
+{
+	using namespace std;
+
+	const float step_size = 1.0f / Frequency;
+	const auto now = chrono::steady_clock::now();
+	if (!StepClockStarted)
+	{
+		StepClockStarted = true;
+		LastStepClock = now;
+	}
+
+	TimeAccumulator += chrono::duration<float>(now - LastStepClock).count();
+	LastStepClock = now;
+
+	uint32_t steps = 0;
+	while (TimeAccumulator >= step_size && steps < MaxSubSteps)
+	{
+		if (Callback) Callback(step_size);
+
+		SimulateScenes(step_size);
+		TimeAccumulator -= step_size;
+		steps++;
+	}
+
+	// Under heavy load, drop the time that couldn't be simulated instead of accumulating it
+	if (TimeAccumulator >= step_size)
+		TimeAccumulator = fmodf(TimeAccumulator, step_size);
+
+	return TimeAccumulator / step_size;
+}
+
+void PhysicsEngine::WaitForNextStep(float Frequency)
+{
+	using namespace std;
+
+	if (!StepClockStarted)
+		return;
+
+	const float step_size = 1.0f / Frequency;
+	const float elapsed = TimeAccumulator + chrono::duration<float>(chrono::steady_clock::now() - LastStepClock).count();
+	if (elapsed < step_size)
+		this_thread::sleep_for(chrono::duration<float>(step_size - elapsed));
+}
+
+PxControllerCollisionFlags PhysicsEngine::MoveCharacter(CharacterID ID, PxVec3 Disp, float ElapsedTime, bool ApplyGravity)
+{
+	auto char_ptr = GetCharacter(ID);
+	SimulationScene& scene = *GetSceneState(char_ptr->getScene());
+	if (ApplyGravity) Disp += scene.Gravity;
+
+	if (!scene.CostEntries)
+		return char_ptr->move(Disp, 1e-6, ElapsedTime, PxControllerFilters());
+
+	const auto start = std::chrono::steady_clock::now();
+	const PxControllerCollisionFlags flags = char_ptr->move(Disp, 1e-6, ElapsedTime, PxControllerFilters());
+	AddCharacterCost(scene, ID, std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count());
+	return flags;
+}
+
+std::vector<PxControllerCollisionFlags> PhysicsEngine::MoveCharacters(const std::vector<CharacterID>& IDs, const std::vector<PxVec3>& Displacements, float ElapsedTime, bool ApplyGravity)
+{
+	using namespace std;
+
+	vector<PxControllerCollisionFlags> flags(IDs.size());
+	if (IDs.size() != Displacements.size())
+	{
+		cout << "MoveCharacters needs one displacement per character" << endl;
+		return flags;
+	}
+
+	// The controller manager of each scene groups the characters that can touch and moves the groups on the worker threads
+	// The moves of a scene are handed to it in a single batch, sorted by scene but in the order of IDs otherwise
+	vector<size_t> order(IDs.size());
+	vector<SimulationScene*> scenes(IDs.size());
+	for (size_t i = 0; i < IDs.size(); i++)
+	{
+		order[i] = i;
+		scenes[i] = GetSceneState((*Characters.Get(IDs[i]))->getScene());
+	}
+	stable_sort(order.begin(), order.end(), [&](size_t A, size_t B) { return scenes[A] < scenes[B]; });
+
+	vector<PxControllerMove> moves;
+	for (size_t begin = 0; begin < order.size();)
+	{
+		SimulationScene& scene = *scenes[order[begin]];
+		size_t end = begin;
+		moves.clear();
+		for (; end < order.size() && scenes[order[end]] == &scene; end++)
+		{
+			PxControllerMove move;
+			move.controller = *Characters.Get(IDs[order[end]]);
+			move.disp = Displacements[order[end]];
+			if (ApplyGravity) move.disp += scene.Gravity;
+			move.minDist = 1e-6f;
+			moves.push_back(move);
+		}
+
+		const auto start = chrono::steady_clock::now();
+		scene.CharacterManager->moveControllers(moves.data(), PxU32(moves.size()), ElapsedTime);
+
+		// The moves of a batch are not timed one by one, each character is charged an equal share for the cost reports
+		const float time = chrono::duration<float, micro>(chrono::steady_clock::now() - start).count() / moves.size();
+		for (size_t i = begin; i < end; i++)
+		{
+			flags[order[i]] = moves[i - begin].collisionFlags;
+			AddCharacterCost(scene, IDs[order[i]], time);
+		}
+		begin = end;
+	}
+
+	return flags;
+}
+
+void PhysicsEngine::RunParallel(size_t Count, const std::function<void(size_t Index)>& Function)
+{
+	using namespace std;
+
+	if (!Count)
+		return;
+
+	// One task per worker, each one takes the next index until there are none left. The calling thread helps too
+	atomic<size_t> next(0);
+	auto work = [&next, Count, &Function]
+	{
+		for (size_t i = next++; i < Count; i = next++)
+			Function(i);
+	};
+
+	const size_t task_count = min<size_t>(Dispatcher->getWorkerCount(), Count - 1);
+	vector<FunctionTask> tasks(task_count);
+	TaskGroup group(task_count);
+	for (size_t i = 0; i < task_count; i++)
+	{
+		tasks[i].Set(work, group);
+		Dispatcher->submitTask(tasks[i]);
+	}
+	work();
+	group.Wait();
 }
@@ -1,57 +1,599 @@
 #pragma once
 #include <PxPhysicsAPI.h>
+#include "SlotMap.h"
+#include "Allocators.h"
+#include "LogSink.h"
 #include <iostream>
 #include <functional>
+#include <chrono>
+#include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 using namespace physx;
 
-class PhysicsEngine
+// Handles to the objects owned by the engine. A handle to a removed object is detected on lookup
+using MeshID = Handle<struct MeshTag>;
+using ActorID = Handle<struct ActorTag>;
+using CharacterID = Handle<struct CharacterTag>;
+using MaterialID = Handle<struct MaterialTag>;
+using ConvexID = Handle<struct ConvexTag>;
+using SceneID = Handle<struct SceneTag>;
+
+// Format of the samples of a HeightmapView
+enum class HeightmapFormat
 {
-private:
-	class ErrorLogger : public PxErrorCallback
+	// Normalized floats ([0,1])
+	Float,
+	// Unsigned 16 bit integers, with 0 being the lowest height and 65535 the highest
+	UInt16
+};
+
+// Non owning view of a row major heightmap. Rows are along X, and consecutive rows advance along Z
+// RowStride is the distance in bytes between the start of two rows, which allows using a sub rectangle of a bigger image
+struct HeightmapView
+{
+	const void * Data = nullptr;
+	HeightmapFormat Format = HeightmapFormat::Float;
+	uint32_t SizeX = 0;
+	uint32_t SizeY = 0;
+	size_t RowStride = 0;
+};
+
+// Geometry of a dynamic actor
+enum class DynamicShapeType
+{
+	Box,
+	Sphere,
+	Capsule,
+	Convex
+};
+
+// Describes a dynamic rigid body for CreateDynamicActors
+struct DynamicActorDesc
+{
+	DynamicShapeType Type = DynamicShapeType::Box;
+	PxTransform Pose = PxTransform(PxIdentity);
+
+	// Box only
+	PxVec3 HalfExtents = PxVec3(0.5f);
+	// Sphere and capsule. Capsules are aligned with the X axis
+	float Radius = 0.5f;
+	// Capsule only
+	float HalfHeight = 0.5f;
+	// Convex only, can be a compound of several hulls
+	ConvexID Convex;
+	PxVec3 ConvexScale = PxVec3(1.0f);
+
+	float Density = 1.0f;
+	PxVec3 LinearVelocity = PxVec3(0.0f);
+	PxVec3 AngularVelocity = PxVec3(0.0f);
+	// Sweeps the body between steps so it doesn't tunnel through thin geometry. Needs SceneSettings::EnableCCD
+	bool EnableCCD = false;
+	// Cheaper alternative to EnableCCD that doesn't need SceneSettings::EnableCCD. The contact distance grows with the velocity
+	// so the contacts are found before the body gets there, and the solver stops it. Good for bullets and fast debris,
+	// but a fast spinning body can hit a surface it was moving away from
+	bool SpeculativeCCD = false;
+	// If not valid the default material is used
+	MaterialID Material;
+};
+
+// Optional parts of the SDK, see PhysicsEngine::Initialize. Leaving out the unused ones makes the startup cheaper
+enum PhysicsFeatures : uint32_t
+{
+	FeatureHeightFields = 1 << 0,
+	FeatureArticulations = 1 << 1,
+	FeatureCloth = 1 << 2,
+	FeatureParticles = 1 << 3,
+	// The visual debugger binding, needed for the debug connection and the profile captures. Can only be chosen on Initialize
+	FeatureVisualDebugger = 1 << 4,
+	FeatureAll = FeatureHeightFields | FeatureArticulations | FeatureCloth | FeatureParticles | FeatureVisualDebugger
+};
+
+// Settings of the simulation scene, see PxSceneDesc
+struct SceneSettings
+{
+	// SAP works well for most scenes, MBP scales better for big worlds with many objects moving at the same time
+	PxBroadPhaseType::Enum BroadPhase = PxBroadPhaseType::eSAP;
+	// MBP only. The world bounds are split in a grid of Subdivisions x Subdivisions regions (at most 16) along the ground plane
+	// Objects outside of the regions are not simulated
+	PxBounds3 WorldBounds = PxBounds3(PxVec3(-100000.0f), PxVec3(100000.0f));
+	PxU32 BroadPhaseSubdivisions = 4;
+	// MBP only. Let the broad phase split and merge its regions based on the object density, instead of using the grid
+	// The regions then cover the whole space, so WorldBounds and BroadPhaseSubdivisions are ignored
+	bool AdaptiveBroadPhaseRegions = false;
+	// Keep the static shapes in their own rarely rebuilt tree, so the broad phase cost follows the moving objects
+	// Best for big static worlds with comparatively few dynamic objects
+	bool StaticBroadPhaseTree = false;
+
+	// Persistent contact manifolds
+	bool EnablePCM = true;
+	// PCM only. Reuse the contact manifolds of resting pairs for longer before generating the contacts again
+	bool AdaptivePCMThresholds = false;
+	// Store the contact points with 16 bit positions, halves the contact memory at the cost of a small quantization error
+	bool CompactContacts = false;
+	// Partition the solver constraints by graph coloring, fewer and more even partitions when a few bodies touch many others
+	bool BalancedPartitions = false;
+	// PCM only. Keep the contact manifolds of sleeping pairs, so waking up a pile only refreshes them instead of regenerating everything
+	bool WarmSleeping = false;
+	// Extra stabilization for piles of bodies, at the cost of some momentum
+	bool EnableStabilization = false;
+	// Same results on every run whatever the thread count, for lockstep multiplayer (PxSceneFlag::eENABLE_ENHANCED_DETERMINISM)
+	// The inputs still have to be applied in the same order. Slightly slower, and BalancedPartitions is ignored
+	bool Deterministic = false;
+	bool EnableCCD = false;
+	PxU32 CCDMaxPasses = 1;
+
+	// PhysX 3.4 only has the PGS solver, these are its remaining knobs
+	PxFrictionType::Enum FrictionType = PxFrictionType::ePATCH;
+	PxU32 SolverBatchSize = 128;
+	// Velocity change under which an island stops iterating early, 0 always runs every iteration. Saves solver time on resting piles
+	float SolverConvergenceThreshold = 0.0f;
+
+	// Keep the scene query tree of the dynamic objects always up to date with in place refits and rotations, instead of rebuilding it over several frames
+	// Query costs stay predictable with objects continuously spawned and destroyed, the tree is a bit less tight than a rebuilt one
+	bool IncrementalQueryTree = false;
+	// Keep the dynamic objects in a hashed grid instead of a tree for the scene queries, moving an object is then constant time
+	// Best for crowds of similarly sized objects spread evenly, takes precedence over IncrementalQueryTree
+	bool HashGridQueryStructure = false;
+	// Remember the results of the raycasts, sweeps and overlaps until the next step, so a query repeated in the same frame is a lookup
+	// Queries with a filter callback are never cached
+	bool QueryCache = false;
+	// Run the queries on copies of the query trees taken at the start and at the end of each step, so they can be issued from any thread while the scene simulates
+	// Changes to the objects are seen by the queries once the next step starts or ends
+	bool QuerySnapshots = false;
+
+	// Capacity hints, used to size the scene buffers up front
+	PxSceneLimits Limits;
+
+	// Memory PhysX uses for the temporary data of a step before touching the heap. Rounded up to a multiple of 16 KB, 0 disables it
+	PxU32 ScratchBlockSize = 64 * 1024;
+};
+
+// Options for convex hull cooking, see PxConvexMeshDesc and PxConvexFlag
+struct ConvexCookingOptions
+{
+	// Maximum number of vertices of each hull ([8, 255], or [4, 255] with plane shifting)
+	PxU16 VertexLimit = 255;
+	// When not 0, the input points are quantized (PxConvexFlag::eQUANTIZE_INPUT) to this count before computing the hull
+	PxU16 QuantizedCount = 0;
+	// Use plane shifting instead of the quickhull vertex limiting, which gives tighter hulls when the limit is hit
+	bool PlaneShifting = false;
+	// Shift the input around the origin first, improves precision for points far away from it
+	bool ShiftVertices = true;
+	bool CheckZeroAreaTriangles = false;
+	bool FastInertiaComputation = false;
+};
+
+// One hull of a convex compound, i.e. one piece of a convex decomposition
+struct ConvexHullDesc
+{
+	std::vector<PxVec3> Points;
+	PxTransform LocalPose = PxTransform(PxIdentity);
+};
+
+// Selects how a triangle mesh gets cooked
+enum class MeshCookingMode
+{
+	// Cooks straight into the SDK using the insertion callback, skipping the serialization step
+	Direct,
+	// Cooks into a byte stream first and creates the mesh from it, so the cooked data can be kept (for caching)
+	Stream
+};
+
+// A static triangle mesh instance inside a streamed world chunk
+struct ChunkMesh
+{
+	std::vector<PxVec3> Vertices;
+	std::vector<uint32_t> Indices;
+	PxTransform Pose = PxTransform(PxIdentity);
+	PxVec3 Scale = PxVec3(1.0f);
+};
+
+// Everything that needs to be built for a streamed world chunk
+struct ChunkContent
+{
+	std::vector<ChunkMesh> Meshes;
+};
+
+// Fills the content of the chunk at the provided grid coordinates. Called from the streaming thread
+// Returns false if the chunk has nothing to load
+using ChunkLoaderFn = std::function<bool(int32_t ChunkX, int32_t ChunkZ, ChunkContent& Content)>;
+
+// Closest hit of a raycast or sweep
+struct QueryHit
+{
+	bool Hit = false;
+	// Invalid if nothing was hit, or if the actor is not on the registry (e.g. character proxies and streamed chunks)
+	ActorID Actor;
+	PxVec3 Position = PxVec3(0.0f);
+	PxVec3 Normal = PxVec3(0.0f);
+	float Distance = 0.0f;
+};
+
+// Where the time of a step went, see PhysicsEngine::SetCostReportCallback
+// Every list is sorted costliest first, and times are in microseconds
+struct CostReport
+{
+	// Narrow phase time of a pair of shapes
+	struct Pair
 	{
-	public:
-		virtual void reportError(PxErrorCode::Enum code, const char* message, const char* file, int line)
-		{
-			using namespace std;
-
-			switch (code)
-			{
-			case PxErrorCode::eDEBUG_INFO:
-			case PxErrorCode::eNO_ERROR:
-				cout << "[Info]";
-				break;
-			case PxErrorCode::eDEBUG_WARNING:
-			case PxErrorCode::ePERF_WARNING:
-				cout << "[Warning]";
-				break;
-			default:
-				cout << "[Error]";
-				break;
-			}
-			cout << " : " << message << endl;
-			cout << "    " << file << " @ " << line << endl;
-		}
+		// Invalid if the actor is not on the registry, the object then tells which one it is (character proxies and streamed chunks)
+		ActorID Actor0;
+		ActorID Actor1;
+		PxActor * Object0;
+		PxActor * Object1;
+		PxGeometryType::Enum Type0;
+		PxGeometryType::Enum Type1;
+		float Time;
 	};
-	
-	static ErrorLogger ErrorCallback;
-	static PxDefaultAllocator Allocator;
+	// Narrow phase time of an actor, summed over its pairs. Both actors of a pair get its time, so a dense static mesh shows up too
+	struct Actor
+	{
+		ActorID ID;
+		PxActor * Object;
+		uint32_t PairCount;
+		float Time;
+	};
+	// Solver time of an island. Small islands are solved together, in which case the counts and the time are those of the group
+	struct Island
+	{
+		// One of the bodies of the island, invalid for articulations
+		ActorID Actor;
+		uint32_t IslandCount;
+		uint32_t BodyCount;
+		uint32_t ContactCount;
+		uint32_t ConstraintCount;
+		float Time;
+	};
+	// Time spent in the moves of a character since the last report
+	struct Character
+	{
+		CharacterID ID;
+		uint32_t MoveCount;
+		float Time;
+	};
+
+	SceneID Scene;
+	std::vector<Pair> Pairs;
+	std::vector<Actor> Actors;
+	std::vector<Island> Islands;
+	std::vector<Character> Characters;
+
+	// Totals over every pair, island and character move, not just the reported ones
+	float NarrowPhaseTime = 0.0f;
+	float SolverTime = 0.0f;
+	float CharacterTime = 0.0f;
+
+	// Narrow phase time and pair count per pair of geometry types, indexed by the lowest type first (e.g. [eCONVEXMESH][eTRIANGLEMESH])
+	float GeometryPairTime[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT] = {};
+	uint32_t GeometryPairCount[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT] = {};
+};
+
+// Called after each step of a scene with the costliest pairs, actors, islands and characters
+using CostReportFn = std::function<void(const CostReport& Report)>;
+
+// Scene queries collected over a frame, to be run together with PhysicsEngine::ExecuteQueries
+// Every Add function returns the index of the request, which is also the index of its result
+class QueryBatch
+{
+	friend class PhysicsEngine;
+
+	struct Raycast
+	{
+		PxVec3 Origin;
+		PxVec3 Direction;
+		float MaxDistance;
+		bool AnyHit;
+	};
+	struct Sweep
+	{
+		PxGeometryHolder Geometry;
+		PxTransform Pose;
+		PxVec3 Direction;
+		float MaxDistance;
+		bool AnyHit;
+	};
+	struct Overlap
+	{
+		PxGeometryHolder Geometry;
+		PxTransform Pose;
+	};
+
+	std::vector<Raycast> Raycasts;
+	std::vector<Sweep> Sweeps;
+	std::vector<Overlap> Overlaps;
+
+	std::vector<QueryHit> RaycastHits;
+	std::vector<QueryHit> SweepHits;
+	// Overlap i has OverlapCounts[i] actors, stored from OverlapActors[i * MaxOverlapActors]
+	std::vector<uint32_t> OverlapCounts;
+	std::vector<ActorID> OverlapActors;
+public:
+	// Overlaps touching more actors than this only report the first ones found
+	static const uint32_t MaxOverlapActors = 16;
+
+	// Direction must be normalized. With AnyHit the query stops at the first hit found instead of the closest one (enough for line of sight checks)
+	uint32_t AddRaycast(PxVec3 Origin, PxVec3 Direction, float MaxDistance, bool AnyHit = false);
+	uint32_t AddSweep(const PxGeometry& Geometry, const PxTransform& Pose, PxVec3 Direction, float MaxDistance, bool AnyHit = false);
+	uint32_t AddOverlap(const PxGeometry& Geometry, const PxTransform& Pose);
+
+	// Removes every request and result, keeping the memory for the next frame
+	void Clear();
+
+	// Results of the last ExecuteQueries, indexed by request
+	const std::vector<QueryHit>& GetRaycastHits() const { return RaycastHits; }
+	const std::vector<QueryHit>& GetSweepHits() const { return SweepHits; }
+	uint32_t GetOverlapCount(uint32_t Index) const { return OverlapCounts[Index]; }
+	const ActorID * GetOverlapActors(uint32_t Index) const { return OverlapActors.data() + size_t(Index) * MaxOverlapActors; }
+};
+
+// Dynamic state of a scene saved by PhysicsEngine::SaveState, to rewind the scene with RestoreState (rollback, server side rewind)
+// The bytes are a header followed by flat arrays of bodies and characters. The buffer only grows, so saving every frame into the same state doesn't allocate
+class SceneState
+{
+	friend class PhysicsEngine;
+
+	struct Header
+	{
+		uint32_t Version;
+		uint32_t BodyCount;
+		uint32_t CharacterCount;
+		uint32_t Padding;
+		SceneID Scene;
+	};
+	enum BodyFlags : uint32_t
+	{
+		Kinematic = 1,
+		Sleeping = 2,
+	};
+	struct Body
+	{
+		ActorID ID;
+		PxTransform Pose;
+		PxVec3 LinearVelocity;
+		PxVec3 AngularVelocity;
+		float WakeCounter;
+		uint32_t Flags;
+		// Keeps the characters after the bodies 8 byte aligned
+		uint32_t Padding;
+	};
+	struct Character
+	{
+		CharacterID ID;
+		PxExtendedVec3 Position;
+	};
+
+	std::vector<uint8_t> Data;
+public:
+	// Layout version of the data, states with another version are rejected
+	static const uint32_t Version = 1;
+
+	// Makes room for a scene with up to that many bodies and characters, so the first save doesn't allocate either
+	void Reserve(uint32_t Bodies, uint32_t Characters) { Data.reserve(sizeof(Header) + Bodies * sizeof(Body) + Characters * sizeof(Character)); }
+
+	// The saved bytes, which can be copied elsewhere (e.g. a ring of past frames) and assigned back with Assign
+	const uint8_t * GetData() const { return Data.data(); }
+	size_t GetSize() const { return Data.size(); }
+
+	// Copies saved bytes into the state. Returns false (leaving the state empty) if they are not a state of this version
+	bool Assign(const void * Bytes, size_t Size);
+
+	// Returns true if the state holds something saved
+	bool IsValid() const { return Data.size() >= sizeof(Header); }
+};
+
+class PhysicsEngine
+{
+private:
+	// Printed on a background thread, so reporting never blocks the worker threads
+	static LogSink ErrorCallback;
+	// The foundation is a singleton and keeps using the allocator until it's released, so it can't belong to an instance
+	static PoolAllocator DefaultAllocator;
+	PxAllocatorCallback * Allocator = nullptr;
 	PxFoundation  * Foundation = nullptr;
 	PxPvd * PVD = nullptr;
+	PxPvdTransport * PvdTransport = nullptr;
+
+	// SDK modules registered so far, see EnableFeatures. Guarded by FeatureMutex, as the streaming thread can register heightfields
+	uint32_t EnabledFeatures = 0;
+	std::mutex FeatureMutex;
+
+	// Profile capture state, see StartProfileCapture. ProfileFramesLeft is 0 for a capture without a frame limit
+	bool ProfileCapturing = false;
+	uint32_t ProfileFramesLeft = 0;
+
+	// Created by the first SetTracingEnabled(true), and installed as the profiler callback from then on
+	PxTraceProfiler * TraceProfiler = nullptr;
+
+	// Where the signal handler installed by DumpAllocationProfileOnSignal asks for a dump, empty if it's not installed
+	std::string AllocationDumpPath;
 	PxPhysics * Physics = nullptr;
 	PxCooking * Cooker = nullptr;
-	PxScene * GlobalScene = nullptr;
 	PxDefaultCpuDispatcher * Dispatcher = nullptr;
 	PxMaterial * DefaultMaterial = nullptr;
-	PxControllerManager * CharacterManager = nullptr;
+
+	// State of one simulation scene. Every scene shares the SDK, the cooker, the registries and the worker threads
+	struct SimulationScene
+	{
+		PxScene * Scene = nullptr;
+		PxControllerManager * CharacterManager = nullptr;
+		PxVec3 Gravity;
+
+		// True between BeginSimulate (or BeginCollide) and the EndSimulate call that fetches the results
+		bool Simulating = false;
+		// True between BeginCollide and Advance
+		bool Colliding = false;
+
+		// Transient memory of a step, handed to the scene as its scratch block
+		// PhysX takes the temporary allocations of simulate from it before touching the heap
+		FrameArena StepArena;
+		PxU32 ScratchBlockSize = 0;
+
+		// Actors that moved on the last step, only filled with active actors enabled
+		bool ActiveActorsEnabled = false;
+		std::vector<ActorID> MovedActors;
+
+		// Cost reporting, see SetCostReportCallback. The character moves are timed between two reports, by CharacterID::Index
+		CostReportFn CostCallback;
+		uint32_t CostEntries = 0;
+		std::unordered_map<uint32_t, CostReport::Character> CharacterCosts;
+
+		// Resets the arena and returns the scratch block for the next step, or nullptr if it's disabled
+		void * GetScratchBlock();
+	};
+
+	// Held by pointer so the state doesn't move when another scene is released, PxScene::userData points to it
+	SlotMap<std::unique_ptr<SimulationScene>, SceneTag> Scenes;
+	// Created by Initialize, used when no scene is specified
+	SceneID DefaultScene;
+
+	// Returns the scene, or the default one when the ID is not valid
+	// Returns nullptr (and reports it) if the ID is stale
+	SimulationScene * ResolveScene(SceneID ID) const;
+
+	// Returns the engine state of a PxScene created by CreateScene
+	static SimulationScene * GetSceneState(PxScene * Scene) { return static_cast<SimulationScene*>(Scene->userData); }
+
+	// Counts the captured frames after each step, and ends the capture once every scene is done with the last one
+	void UpdateProfileCapture(const SimulationScene& Scene);
+
+	// Writes the allocation profile if the signal asked for it since the last step
+	void UpdateAllocationDump();
+
+	// Hands the costs of the step that was just fetched to the cost report callback of the scene, if any
+	void UpdateCostReport(SimulationScene& Scene, SceneID ID);
+	// Adds the time of a move to the character costs of its scene, if the scene reports its costs
+	void AddCharacterCost(SimulationScene& Scene, CharacterID ID, float Time);
 
 	// No need to clean this by hand, they get removed by the sdk along with all the other bodies and stuff
-	std::vector<PxTriangleMesh*> TriangleMeshes;
-	std::vector<PxController *> Characters;
+	SlotMap<PxTriangleMesh*, MeshTag> TriangleMeshes;
+	SlotMap<PxRigidActor*, ActorTag> Actors;
+	SlotMap<PxController*, CharacterTag> Characters;
+
+	SlotMap<PxMaterial*, MaterialTag> Materials;
+
+	// A cooked convex, made of one or more hulls
+	struct ConvexCompound
+	{
+		std::vector<PxConvexMesh*> Hulls;
+		std::vector<PxTransform> LocalPoses;
+	};
+	SlotMap<ConvexCompound, ConvexTag> Convexes;
+
+	// Cooks a single hull with quickhull. Thread safe, returns nullptr on failure
+	PxConvexMesh * CookConvexHull(const std::vector<PxVec3>& Points, const ConvexCookingOptions& Options);
+
+	// Identifies a shared mesh shape, instances with the same key use the same PxShape
+	struct ShapeKey
+	{
+		MeshID Mesh;
+		PxVec3 Scale;
+		PxMaterial * Material;
+
+		bool operator==(const ShapeKey& Other) const { return Mesh == Other.Mesh && Scale == Other.Scale && Material == Other.Material; }
+	};
+	struct ShapeKeyHash
+	{
+		size_t operator()(const ShapeKey& Key) const;
+	};
+
+	// Non exclusive shapes shared between the static actors. The cache holds one reference of each
+	std::unordered_map<ShapeKey, PxShape*, ShapeKeyHash> SharedShapes;
+
+	// Returns the material, falling back to the default one when the ID is not valid
+	PxMaterial * ResolveMaterial(MaterialID ID);
+
+	// Pose of every actor, in the same (dense) order as Actors. Refreshed after each step
+	std::vector<PxVec3> PosePositions;
+	std::vector<PxQuat> PoseRotations;
+
+	// Cooks the heightfield, going through the cooked data cache when enabled
+	// Returns nullptr on failure
+	PxHeightField * CookHeightField(const PxHeightFieldDesc& HeightFieldDesc);
+
+	// Creates and adds a single heightfield actor for the [X0, X0 + CountX) x [Y0, Y0 + CountY) samples of the heightmap
+	ActorID CreateTerrainTile(PxVec3 Position, PxVec3 Scale, const HeightmapView& Heightmap, float MinZ, float MaxZ, uint32_t X0, uint32_t Y0, uint32_t CountX, uint32_t CountY, PxMaterial& Material, std::vector<PxHeightFieldSample>& Samples, PxScene& Scene);
+
+	// Registers the actor and its pose on the pose cache
+	ActorID RegisterActor(PxRigidActor * Actor);
+
+	// Copies the poses of the dynamic actors of the scene to the pose cache
+	// With active actors enabled only the actors that moved on the last step are read
+	void UpdatePoseCache(SimulationScene& Scene);
+
+	// Ends the running step (if any) and releases the scene along with its actors and characters
+	void DestroyScene(SimulationScene& Scene);
+
+	// Waits for the running step of the scene (if any) and fetches its results
+	void FinishStep(SimulationScene& Scene);
+
+	// Drops the registry entries of the actors and characters on the scene, and returns those actors
+	std::vector<PxRigidActor*> DropSceneEntries(SimulationScene& Scene);
+
+	// Fixed step state, see SimulateFixedFrequency
+	std::chrono::steady_clock::time_point LastStepClock;
+	bool StepClockStarted = false;
+	float TimeAccumulator = 0.0f;
+
+	// Directory where cooked data is stored between runs. Caching is disabled when empty
+	std::string CacheDirectory;
+	// Hash of the cooking parameters, mixed into every cache key so changing them invalidates old entries
+	uint64_t CookingParamsHash = 0;
 
-	PxVec3 Gravity;
-	float ElapsedTime;
+	// A chunk built by the streaming thread, waiting to be inserted on the main thread
+	struct StreamedChunk
+	{
+		int64_t Key = 0;
+		std::vector<PxActor*> Actors;
+		PxPruningStructure * Pruning = nullptr;
+	};
+
+	// Chunk streaming state, see EnableStreaming
+	float ChunkSize = 0.0f;
+	int32_t ChunkRadius = 0;
+	ChunkLoaderFn ChunkLoader;
+	bool HasFocusChunk = false;
+	int64_t FocusChunk = 0;
+	std::unordered_map<int64_t, std::vector<PxActor*>> LoadedChunks;
+	// Chunks that were requested but are not in the scene yet
+	std::unordered_set<int64_t> RequestedChunks;
+
+	// Shared with the streaming thread, guarded by StreamingMutex
+	std::mutex StreamingMutex;
+	std::condition_variable StreamingWake;
+	std::vector<int64_t> LoadQueue;
+	std::vector<StreamedChunk> ReadyChunks;
+	bool StreamingQuit = false;
+	std::thread StreamingThread;
+
+	// Body of the streaming thread, builds the queued chunks until StreamingQuit is set
+	void StreamingLoop();
+
+	// Calls the loader for the chunk and creates its actors and pruning structure (without adding them to the scene)
+	void BuildChunk(int64_t Key, StreamedChunk& Chunk);
+
+	// Releases the actors of a chunk, removing them from the scene first if needed
+	void ReleaseChunkActors(std::vector<PxActor*>& Actors, bool InScene);
+
+	// Computes the cache key for a triangle mesh from its vertices, indices, flags and the cooking parameters
+	uint64_t HashTriangleMeshDesc(const PxTriangleMeshDesc& MeshDesc) const;
+
+	// Maps a cooked blob of the cache directory, the SDK reads it straight from the mapping
+	// Returns nullptr on a cache miss, or when caching is disabled
+	std::unique_ptr<PxDefaultMappedFileInputData> LoadCachedData(uint64_t Key, const char * Extension) const;
+
+	// Writes a cooked blob to the cache directory, does nothing when caching is disabled
+	void StoreCachedData(uint64_t Key, const char * Extension, const void * Data, size_t Size) const;
+
+	// Cooks the mesh described by MeshDesc a single time, using the provided mode
+	// Returns nullptr on failure
+	PxTriangleMesh * CookTriangleMesh(const PxTriangleMeshDesc& MeshDesc, MeshCookingMode Mode, PxDefaultMemoryOutputStream * CookedData);
 public:
 	PhysicsEngine() = default;
 	PhysicsEngine(const PhysicsEngine&) = delete;
@@ -61,26 +603,150 @@ public:
 	// Initializes the engine
 	// Returns true if successful
 	// Optionaly you can specify the number of threads to use for simulation and the gravity  acceleration vector
-	bool Initialize(uint32_t NumThreads = 2, PxVec3 Gravity = PxVec3(0.0f, -9.81f, 0.0f));
+	// If CacheDirectory is not empty, cooked meshes and heightfields are stored there (keyed by a hash of their input) and reused on later runs
+	// The directory must already exist
+	// Allocator is used for every allocation of the SDK and must outlive the engine. If null the thread caching PoolAllocator is used
+	// Settings configure the default scene, see SceneSettings
+	// If EnableTracing is true the trace profiler records from the start, see SetTracingEnabled
+	// Features selects the SDK modules registered up front (see PhysicsFeatures). The others are registered on first use by the engine (heightfields on the first terrain),
+	// or by EnableFeatures before using them straight through the SDK
+	bool Initialize(uint32_t NumThreads = 2, PxVec3 Gravity = PxVec3(0.0f, -9.81f, 0.0f), const std::string& CacheDirectory = std::string(), PxAllocatorCallback * Allocator = nullptr, const SceneSettings& Settings = SceneSettings(), bool EnableTracing = false, uint32_t Features = FeatureAll);
+
+	// Registers the SDK modules of the mask that are not registered yet. FeatureVisualDebugger is ignored, it can only be chosen on Initialize
+	// Heightfields can't be registered anymore once a heightfield exists, which only happens if they were created behind the engine's back
+	void EnableFeatures(uint32_t Features);
+
+	// Creates an additional scene, and returns its ID (invalid on failure)
+	// Scenes are independent simulations that share the meshes, materials and worker threads of the engine
+	SceneID CreateScene(const SceneSettings& Settings = SceneSettings(), PxVec3 Gravity = PxVec3(0.0f, -9.81f, 0.0f));
+
+	// Releases the scene, along with every actor and character on it. The default scene can't be released
+	// Returns false if the ID is not valid
+	bool ReleaseScene(SceneID ID);
+
+	// Releases every actor, aggregate and character on the scene, but keeps the scene itself along with its settings
+	// and the memory of its internal structures, so refilling it (on a round restart, say) is much cheaper than ReleaseScene plus CreateScene
+	// On the default scene this also drops the streamed chunks, they are loaded again by the next UpdateStreaming
+	// Returns false if the ID is not valid
+	bool ResetScene(SceneID ID = SceneID());
+
+	// Returns the totals of the messages reported by the SDK
+	static LogCounters GetLogCounters() { return ErrorCallback.GetCounters(); }
+
+	// Sets how many messages per second each SDK call site can print, 0 disables the limit (10 by default)
+	static void SetLogRateLimit(uint32_t MessagesPerSecond) { ErrorCallback.SetRateLimit(MessagesPerSecond); }
+
+	// Starts capturing profiling events (PxPvdInstrumentationFlag::ePROFILE, no object data) to a PVD file, for the next Frames steps of the default scene
+	// If Frames is 0 it goes on until StopProfileCapture. Costs almost nothing while no capture is running
+	// Needs a PhysX build with PVD support (debug, checked or profile). Returns false if the capture couldn't start
+	bool StartProfileCapture(const std::string& FilePath, uint32_t Frames = 0);
+
+	// Ends the running capture and closes its file. Can't be called while simulating
+	void StopProfileCapture();
+
+	// Returns true while a profile capture is running
+	bool IsCapturingProfile() const { return ProfileCapturing; }
+
+	// Starts or stops recording the SDK profile zones in memory, each thread keeps its last 65536 zone events
+	// Much lighter than a PVD capture, so it can stay on in a live server and be dumped when a frame goes wrong
+	// It replaces the profiler callback of a connected visual debugger. Needs a debug, checked or profile PhysX build
+	void SetTracingEnabled(bool Enabled);
+
+	// Returns true while the trace profiler records
+	bool IsTracing() const { return TraceProfiler && TraceProfiler->isEnabled(); }
+
+	// Writes the recorded zones as a Chrome trace (chrome://tracing or ui.perfetto.dev). Can be called while simulating
+	// Returns false if nothing was ever recorded or the file couldn't be written
+	bool ExportTrace(const std::string& FilePath) const;
+
+	// Starts or stops aggregating the SDK allocations by call site (count, bytes, live and peak bytes), to find the allocation churn of hot paths
+	// Cheap enough to leave on in staging. Can't be called while simulating, the first call hooks into the allocator
+	void SetAllocationProfilingEnabled(bool Enabled);
+
+	// Returns true while the allocations are profiled
+	bool IsProfilingAllocations() const { return PxIsAllocationProfilingEnabled(); }
+
+	// Writes the MaxSites call sites that allocated the most bytes since profiling started (or the last reset) as a text table
+	// Returns false if the file couldn't be written
+	bool DumpAllocationProfile(const std::string& FilePath, uint32_t MaxSites = 64) const;
+
+	// Clears the allocation totals, the live bytes are kept
+	void ResetAllocationProfile() { PxResetAllocationProfile(); }
+
+	// Dumps the allocation profile to FilePath when the process gets SIGUSR1 (SIGBREAK on Windows), at the end of the next step
+	// An empty path removes the handler
+	void DumpAllocationProfileOnSignal(const std::string& FilePath);
+
+	// Returns the ID of the scene created by Initialize
+	SceneID GetDefaultScene() const { return DefaultScene; }
+
+	// Returns the scene (the default one if the ID is not valid), or nullptr if the ID is stale
+	PxScene * GetScene(SceneID ID = SceneID()) const;
+
+	// Every function below that takes a SceneID uses the default scene when it's not provided
 
 	// Advances to the next step of the simulation
-	void Simulate(float ElapsedTimeSeconds);
+	// Blocks until the step is done, it's the same as BeginSimulate followed by EndSimulate
+	void Simulate(float ElapsedTimeSeconds, SceneID Scene = SceneID());
+
+	// Steps every scene at once. All of them are started before waiting for any, so they run concurrently on the worker threads
+	void SimulateScenes(float ElapsedTimeSeconds);
+
+	// Starts the next step of the simulation on the worker threads and returns right away
+	// The scene can't be modified until EndSimulate fetches the results, but game logic and rendering can run meanwhile
+	void BeginSimulate(float ElapsedTimeSeconds, SceneID Scene = SceneID());
+
+	// Fetches the results of the step started by BeginSimulate
+	// If Block is false it doesn't wait, and returns false if the step is still running
+	bool EndSimulate(bool Block = true, SceneID Scene = SceneID());
+
+	// Same as EndSimulate(true), but the simulation event callbacks (contact reports and such) are processed in parallel on the worker threads
+	// The callbacks must be thread safe
+	void EndSimulateParallelCallbacks(SceneID Scene = SceneID());
+
+	// Starts only the collision detection part of the next step (broadphase and narrowphase), like PxScene::collide
+	// Kinematic targets and character controllers can be moved while it runs, the changes are applied when Advance is called
+	void BeginCollide(float ElapsedTimeSeconds, SceneID Scene = SceneID());
+
+	// Waits for the collision detection started by BeginCollide, and starts the solver and integration of the step
+	// Finish the step with EndSimulate
+	void Advance(SceneID Scene = SceneID());
+
+	// Returns true while a step started with BeginSimulate hasn't been fetched
+	bool IsSimulating(SceneID Scene = SceneID()) const;
+
+	// Copies the statistics of the last step, counts and the wall and CPU time of each stage (PxSimulationStatistics::StageType)
+	// Returns false if the ID is stale or the scene is simulating
+	bool GetSimulationStatistics(PxSimulationStatistics& Stats, SceneID Scene = SceneID()) const;
+
+	// Times every pair of the narrow phase, every island of the solver and every character move, and calls the callback
+	// after each step with the MaxEntries costliest ones of each kind (see CostReport). Finds the assets that blow the frame budget,
+	// like a dense dynamic mesh, at the price of a timer read per pair. An empty callback disables it
+	// Returns false if the ID is stale or the scene is simulating
+	bool SetCostReportCallback(CostReportFn Callback, uint32_t MaxEntries = 16, SceneID Scene = SceneID());
 	
-	// Keeps track of the time and simulates only on a fixed frequency (when possible)
-	// It accepts an optional lambda that is called just before Simulate is called, which can be used to move stuff
-	void SimulateFixedFrequency(float Frequency, std::function<void(float ElapsedTime)> Callback = std::function<void(float)>());
+	// Keeps track of the real time elapsed since the last call, and simulates (every scene) as many fixed steps of 1/Frequency seconds as fit in it
+	// At most MaxSubSteps steps are done per call, any time left over beyond that is dropped so the simulation can't fall behind forever
+	// It accepts an optional lambda that is called just before each step (with the fixed step size), which can be used to move stuff
+	// Returns the interpolation factor ([0,1)) between the last two steps, to be used for rendering
+	float SimulateFixedFrequency(float Frequency, std::function<void(float ElapsedTime)> Callback = std::function<void(float)>(), uint32_t MaxSubSteps = 4);
+
+	// Blocks the calling thread until the next fixed step of SimulateFixedFrequency is due, instead of polling the clock
+	void WaitForNextStep(float Frequency);
 
-	// Creates a physics triangle mesh from the provided data
+	// Creates a physics triangle mesh from the provided data, and returns its ID
+	// The mesh is cooked only once, using the selected mode. On Stream mode, if CookedData is provided it will hold the cooked bytes
+	// When the cache is enabled, previously cooked data is loaded from disk instead of cooking again
 	// IMPORTANT : The vertex type (VertexT) MUST have as it's first member(s) 3 floats with the X, Y and Z of the vertex
 	template<typename VertexT, typename IndexT = uint32_t>
-	size_t CreatePhysicsTriangleMesh(const std::vector<VertexT>& VertexList, const std::vector<IndexT>& IndexList)
+	MeshID CreatePhysicsTriangleMesh(const std::vector<VertexT>& VertexList, const std::vector<IndexT>& IndexList, MeshCookingMode Mode = MeshCookingMode::Direct, PxDefaultMemoryOutputStream * CookedData = nullptr)
 	{
 		using namespace std;
 
 		if (IndexList.size() % 3 != 0)
 		{
 			cout << "The index count must be a multiple of 3" << endl;
-			return -1;
+			return MeshID();
 		}
 
 		PxTriangleMeshDesc mesh_desc;
@@ -91,44 +757,146 @@ public:
 		mesh_desc.triangles.count = IndexList.size() / 3;
 		mesh_desc.triangles.stride = 3 * sizeof(IndexT);
 		mesh_desc.triangles.data = IndexList.data();
+		if (sizeof(IndexT) == sizeof(PxU16))
+			mesh_desc.flags |= PxMeshFlag::e16_BIT_INDICES;
 
-		auto cooked_mesh = Cooker->createTriangleMesh(mesh_desc, Physics->getPhysicsInsertionCallback());
+		auto cooked_mesh = CookTriangleMesh(mesh_desc, Mode, CookedData);
 		if (!cooked_mesh)
-		{
-			cout << "Failed to create the triangle mesh" << endl;
-			return -1;
-		}
+			return MeshID();
 
-		PxDefaultMemoryOutputStream write_buffer;
-		PxTriangleMeshCookingResult::Enum result;
-		if (!Cooker->cookTriangleMesh(mesh_desc, write_buffer, &result))
-		{
-			cout << "Failed to cook the triangle mesh" << endl;
-			return -1;
-		}
+		return TriangleMeshes.Insert(cooked_mesh);
+	}
 
-		PxDefaultMemoryInputData read_buffer(write_buffer.getData(), write_buffer.getSize());
-		Physics->createTriangleMesh(read_buffer);
-		TriangleMeshes.push_back(cooked_mesh);
+	// Cooks many triangle meshes at the same time on the simulation worker threads, and returns their IDs (in the same order)
+	// A failed mesh gets an invalid ID. The descriptors (and the data they point to) must stay valid until the call returns
+	std::vector<MeshID> CreatePhysicsTriangleMeshes(const std::vector<PxTriangleMeshDesc>& MeshDescs, MeshCookingMode Mode = MeshCookingMode::Direct);
 
-		return TriangleMeshes.size() - 1;
-	}
+	// Releases the engine reference to the mesh (and its shared shapes). Actors already using it keep it alive
+	// Returns false if the ID is not valid
+	bool ReleaseMesh(MeshID ID);
+
+	// Creates a material, and returns its ID
+	MaterialID CreateMaterial(float StaticFriction, float DynamicFriction, float Restitution);
+
+	// Returns the material, or nullptr if the ID is not valid
+	PxMaterial * GetMaterial(MaterialID ID);
+
+	// Returns the material used when none is given
+	PxMaterial * GetDefaultMaterial() const { return DefaultMaterial; }
 
-	// Creates a static actor from a triangle mesh
-	bool CreateStaticActor(size_t MeshID, PxVec3 Position, PxQuat Rotation, PxVec3 Scale);
+	// Releases the engine reference to the material (and the shared shapes using it). Shapes already using it keep it alive
+	// Returns false if the ID is not valid
+	bool ReleaseMaterial(MaterialID ID);
+
+	// Cooks a convex hull around the points, and returns its ID (invalid on failure)
+	// Identical hulls, for instance the same asset cooked twice, share one PxConvexMesh
+	ConvexID CreateConvexMesh(const std::vector<PxVec3>& Points, const ConvexCookingOptions& Options = ConvexCookingOptions());
+
+	// Cooks every hull of a convex decomposition (in parallel on the worker threads) and returns their compound ID (invalid if any hull fails)
+	// Actors created from the ID get one shape per hull, placed at its local pose
+	ConvexID CreateConvexCompound(const std::vector<ConvexHullDesc>& Hulls, const ConvexCookingOptions& Options = ConvexCookingOptions());
+
+	// Releases the engine reference to the hulls. Actors already using them keep them alive
+	// Returns false if the ID is not valid
+	bool ReleaseConvex(ConvexID ID);
+
+	// Creates a static actor from a triangle mesh, and returns its ID (invalid on failure)
+	// All the actors with the same mesh, scale and material share a single shape. If no material is given the default one is used
+	ActorID CreateStaticActor(MeshID Mesh, PxVec3 Position, PxQuat Rotation, PxVec3 Scale, MaterialID Material = MaterialID(), SceneID Scene = SceneID());
 	
-	// Creates an heightfield mesh from the pixel data
-	// Returns true if successful
+	// Creates many dynamic actors at once, and returns their IDs in the same order (a failed actor gets an invalid ID)
+	// Mass and inertia are computed from the density. All the actors are inserted with a single call, so the broadphase is updated once
+	// If UseAggregate is true they are put together on new PxAggregates (with self collisions, 128 actors at most each), which is cheap for debris and such
+	std::vector<ActorID> CreateDynamicActors(const std::vector<DynamicActorDesc>& Descs, bool UseAggregate = false, SceneID Scene = SceneID());
+
+	// Creates an heightfield mesh from the pixel data, and returns its actor ID (invalid on failure)
 	// Heightmap is assumed to be on Row Major order and normalized ([0,1])
-	bool CreateTerrain(PxVec3 Position, PxVec3 Scale, uint32_t SizeX, uint32_t SizeY, float MinZ, float MaxZ, const std::vector<float>& Heightmap);
+	// Scale.x and Scale.z are the size of the whole terrain, and the heights go from MinZ to MaxZ
+	ActorID CreateTerrain(PxVec3 Position, PxVec3 Scale, uint32_t SizeX, uint32_t SizeY, float MinZ, float MaxZ, const std::vector<float>& Heightmap);
+
+	// Same as above, but reading the heights straight from the view (no copy of the input is made)
+	ActorID CreateTerrain(PxVec3 Position, PxVec3 Scale, const HeightmapView& Heightmap, float MinZ, float MaxZ, MaterialID Material = MaterialID(), SceneID Scene = SceneID());
+
+	// Splits the terrain in tiles of at most TileSize x TileSize samples, each one being its own heightfield actor, and returns their IDs
+	// Neighbour tiles share their border samples so there are no cracks. Only one tile worth of samples is allocated at any time
+	std::vector<ActorID> CreateTiledTerrain(PxVec3 Position, PxVec3 Scale, const HeightmapView& Heightmap, float MinZ, float MaxZ, uint32_t TileSize, MaterialID Material = MaterialID(), SceneID Scene = SceneID());
+
+	// Returns the actor, or nullptr if the ID is not valid
+	PxRigidActor * GetActor(ActorID ID);
+
+	// Removes the actor from its scene and releases it. Can't be called while that scene is simulating
+	// Returns false if the ID is not valid
+	bool RemoveActor(ActorID ID);
+
+	// Moves a dynamic actor to another scene, keeping its ID, pose and velocities. Can't be called while either scene is simulating
+	// Returns false if an ID is not valid, or if the actor is part of an aggregate or has joints (they can't span scenes)
+	bool MoveActorToScene(ActorID ID, SceneID Scene);
+
+	// Gives access to the pose cache, which holds the pose of every actor as of the last step, in structure of arrays form
+	// The three arrays have the returned number of elements, and stay valid until an actor is created or removed
+	size_t GetActorPoses(const ActorID *& IDs, const PxVec3 *& Positions, const PxQuat *& Rotations) const;
 
-	// Creates a capsule character controller, and returns its ID
-	size_t CreateCharacterController(PxVec3 StartPosition, float Height, float Radius);
+	// Enables the tracking of active actors (PxSceneFlag::eENABLE_ACTIVE_ACTORS)
+	// With it the pose cache only reads the actors that moved, and GetMovedActorPoses can be used
+	void EnableActiveActors(bool Enable = true, SceneID Scene = SceneID());
 
-	// Returns the character controller
-	PxController * GetCharacter(size_t ID);
+	// Copies the pose of each actor of the scene that moved on its last step to Poses[ID.Index], and returns the IDs of those actors
+	// Poses must have room for GetActorSlotCount() elements. Requires EnableActiveActors
+	const std::vector<ActorID>& GetMovedActorPoses(PxTransform * Poses, SceneID Scene = SceneID()) const;
 
-	// Applies the provided displacement to the character, and the gravity (unless ApplyGravity is false)
+	// Returns the number of slots used by the actor registry, which is an upper bound for ActorID::Index
+	size_t GetActorSlotCount() const { return Actors.SlotCount(); }
+
+	// Saves the pose, velocities and sleep state of every dynamic actor of the scene, and the position of its characters
+	// Static actors, joints and settings are not saved, and neither are the contact caches of the touching pairs, which are refreshed by the next step
+	// Returns false if the ID is stale or the scene is simulating
+	bool SaveState(SceneState& State, SceneID Scene = SceneID()) const;
+
+	// Puts back the state saved from the same scene. Actors and characters removed since the save are skipped, and the ones created after it are left as they are
+	// The pose cache is updated (and the restored actors are reported as moved with active actors enabled)
+	// Returns false if the state comes from another scene or version, the ID is stale or the scene is simulating
+	bool RestoreState(const SceneState& State, SceneID Scene = SceneID());
+
+	// Enables streaming of world chunks. The world is split on a grid of ChunkSize x ChunkSize squares on the XZ plane
+	// and every chunk up to Radius cells away from the focus position is kept loaded
+	// The loader is called on a background thread, and the cooking and actor creation also happens there
+	// Chunks are added to the default scene
+	void EnableStreaming(float ChunkSize, int32_t Radius, ChunkLoaderFn Loader);
+
+	// Requests the chunks around FocusPosition, unloads the ones that went out of range and inserts the chunks that finished loading
+	// Must be called while the default scene is not simulating (i.e. between fetchResults and the next simulate)
+	void UpdateStreaming(PxVec3 FocusPosition);
+
+	// Runs every query of the batch on the worker threads, and fills its results
+	// Must be called while the scene is not simulating. Blocks until all the queries are done
+	void ExecuteQueries(QueryBatch& Batch, SceneID Scene = SceneID());
+
+	// Reports every actor touching the geometry, in blocks of up to 64 actors, without a limit on the total
+	// Returning false from the callback stops the query. Returns the number of actors reported
+	// Must be called while the scene is not simulating
+	uint32_t StreamOverlap(const PxGeometry& Geometry, const PxTransform& Pose, const std::function<bool(const ActorID * Actors, uint32_t Count)>& Callback, SceneID Scene = SceneID());
+
+	// Creates a capsule character controller, and returns its ID (invalid on failure)
+	CharacterID CreateCharacterController(PxVec3 StartPosition, float Height, float Radius, SceneID Scene = SceneID());
+
+	// Returns the character controller, or nullptr if the ID is not valid
+	PxController * GetCharacter(CharacterID ID);
+
+	// Releases the character controller
+	// Returns false if the ID is not valid
+	bool RemoveCharacter(CharacterID ID);
+
+	// Applies the provided displacement to the character, and the gravity of its scene (unless ApplyGravity is false)
 	// Assumes the provided ID is valid
-	PxControllerCollisionFlags MoveCharacter(size_t ID, PxVec3 Disp, float ElapsedTime, bool ApplyGravity = true);
+	PxControllerCollisionFlags MoveCharacter(CharacterID ID, PxVec3 Disp, float ElapsedTime, bool ApplyGravity = true);
+
+	// Moves many characters at once, Displacements[i] is applied to the character IDs[i]. Returns the collision flags of each move
+	// Characters whose swept volumes can touch are moved one after the other, the independent groups are moved in parallel on the worker threads
+	// The moves only read the scene, the kinematic actors of the characters get their new targets once every group is done
+	// Assumes the provided IDs are valid and not repeated
+	std::vector<PxControllerCollisionFlags> MoveCharacters(const std::vector<CharacterID>& IDs, const std::vector<PxVec3>& Displacements, float ElapsedTime, bool ApplyGravity = true);
+
+	// Calls Function(i) for every i in [0, Count) on the worker threads and the calling one, and blocks until every call returned
+	// The calls can run in any order and at the same time, so they must only write to data of their own index
+	void RunParallel(size_t Count, const std::function<void(size_t Index)>& Function);
 };
\ No newline at end of file
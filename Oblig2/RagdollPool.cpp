@@ -0,0 +1,196 @@
+#include "RagdollPool.h"
+#include <algorithm>
+
+bool RagdollPool::Initialize(PhysicsEngine& Engine, SceneID Scene, const RagdollDesc& Desc, uint32_t Count)
+{
+	using namespace std;
+
+	Release();
+
+	this->Scene = Engine.GetScene(Scene);
+	if (!this->Scene)
+	{
+		cout << "Failed to create the ragdoll pool, the scene is not valid" << endl;
+		return false;
+	}
+
+	// The articulation links have 64 entries at most
+	if (Desc.Links.empty() || Desc.Links.size() > 64 || Desc.Links[0].Parent != -1)
+	{
+		cout << "Failed to create the ragdoll pool, a ragdoll needs 1 to 64 links and the first one must be the root" << endl;
+		return false;
+	}
+	for (size_t i = 1; i < Desc.Links.size(); i++)
+	{
+		if (Desc.Links[i].Parent < 0 || size_t(Desc.Links[i].Parent) >= i)
+		{
+			cout << "Failed to create the ragdoll pool, the parent of link " << i << " must be one of the links before it" << endl;
+			return false;
+		}
+	}
+
+	this->Engine = &Engine;
+	this->Desc = Desc;
+
+	// Initialize can leave the articulations out of the SDK
+	Engine.EnableFeatures(FeatureArticulations);
+
+	return Reserve(Count);
+}
+
+bool RagdollPool::Reserve(uint32_t Count)
+{
+	if (!Scene)
+		return false;
+
+	Instances.reserve(Instances.size() + Count);
+	Dormant.reserve(Dormant.size() + Count);
+	for (uint32_t i = 0; i < Count; i++)
+	{
+		Instances.emplace_back();
+		if (!Build(Instances.back()))
+		{
+			Instances.pop_back();
+			return false;
+		}
+		Dormant.push_back(uint32_t(Instances.size() - 1));
+	}
+
+	return true;
+}
+
+bool RagdollPool::Build(Instance& Ragdoll)
+{
+	using namespace std;
+
+	PxPhysics& physics = Scene->getPhysics();
+	PxMaterial * material = Engine->GetMaterial(Desc.Material);
+	if (!material)
+		material = Engine->GetDefaultMaterial();
+
+	Ragdoll.Articulation = physics.createArticulation();
+	// Self collisions are left to the joint limits
+	Ragdoll.Aggregate = physics.createAggregate(PxU32(Desc.Links.size()), false);
+	if (!Ragdoll.Articulation || !Ragdoll.Aggregate)
+	{
+		cout << "Failed to create a ragdoll articulation" << endl;
+		if (Ragdoll.Articulation)
+			Ragdoll.Articulation->release();
+		if (Ragdoll.Aggregate)
+			Ragdoll.Aggregate->release();
+		return false;
+	}
+
+	Ragdoll.Articulation->setSolverIterationCounts(Desc.PositionIterations, Desc.VelocityIterations);
+	Ragdoll.Articulation->setSleepThreshold(Desc.SleepThreshold);
+
+	Ragdoll.Links.resize(Desc.Links.size());
+	for (size_t i = 0; i < Desc.Links.size(); i++)
+	{
+		const RagdollLinkDesc& link_desc = Desc.Links[i];
+		PxArticulationLink * parent = link_desc.Parent >= 0 ? Ragdoll.Links[link_desc.Parent] : nullptr;
+
+		PxArticulationLink * link = Ragdoll.Articulation->createLink(parent, link_desc.Pose);
+		Ragdoll.Links[i] = link;
+		PxRigidActorExt::createExclusiveShape(*link, PxCapsuleGeometry(link_desc.Radius, link_desc.HalfHeight), *material);
+		PxRigidBodyExt::updateMassAndInertia(*link, link_desc.Density);
+
+		if (!parent)
+			continue;
+
+		// The frame of the joint on the parent is where it sits in the bind pose
+		PxArticulationJoint * joint = link->getInboundJoint();
+		joint->setChildPose(link_desc.JointFrame);
+		joint->setParentPose(Desc.Links[link_desc.Parent].Pose.getInverse() * link_desc.Pose * link_desc.JointFrame);
+		joint->setSwingLimit(link_desc.SwingLimitY, link_desc.SwingLimitZ);
+		joint->setSwingLimitEnabled(true);
+		joint->setTwistLimit(-link_desc.TwistLimit, link_desc.TwistLimit);
+		joint->setTwistLimitEnabled(true);
+	}
+
+	Ragdoll.Aggregate->addArticulation(*Ragdoll.Articulation);
+	return true;
+}
+
+void RagdollPool::Release()
+{
+	for (auto& ragdoll : Instances)
+	{
+		if (ragdoll.Active)
+			Scene->removeAggregate(*ragdoll.Aggregate);
+		ragdoll.Aggregate->removeArticulation(*ragdoll.Articulation);
+		ragdoll.Aggregate->release();
+		ragdoll.Articulation->release();
+	}
+	Instances.clear();
+	Dormant.clear();
+	Scene = nullptr;
+	Engine = nullptr;
+}
+
+void RagdollPool::ResetPose(Instance& Ragdoll, const PxTransform& Pose, PxVec3 LinearVelocity)
+{
+	// Out of the scene the links are written straight to the SDK objects, without waking anything
+	for (size_t i = 0; i < Ragdoll.Links.size(); i++)
+	{
+		PxArticulationLink * link = Ragdoll.Links[i];
+		link->setGlobalPose(Pose * Desc.Links[i].Pose);
+		link->setLinearVelocity(LinearVelocity);
+		link->setAngularVelocity(PxVec3(0.0f));
+	}
+}
+
+uint32_t RagdollPool::Spawn(const PxTransform& Pose, PxVec3 LinearVelocity)
+{
+	if (Dormant.empty())
+		return InvalidRagdoll;
+
+	const uint32_t index = Dormant.back();
+	Dormant.pop_back();
+
+	Instance& ragdoll = Instances[index];
+	ResetPose(ragdoll, Pose, LinearVelocity);
+	Scene->addAggregate(*ragdoll.Aggregate);
+	ragdoll.Articulation->wakeUp();
+	ragdoll.Active = true;
+	return index;
+}
+
+std::vector<uint32_t> RagdollPool::Spawn(const std::vector<PxTransform>& Poses, const std::vector<PxVec3>& LinearVelocities)
+{
+	std::vector<uint32_t> indices(Poses.size(), InvalidRagdoll);
+	const size_t count = std::min(Poses.size(), Dormant.size());
+	for (size_t i = 0; i < count; i++)
+	{
+		indices[i] = Dormant.back();
+		Dormant.pop_back();
+	}
+
+	// The ragdolls are out of the scene, so their poses can be written from any thread
+	Engine->RunParallel(count, [&](size_t i)
+	{
+		ResetPose(Instances[indices[i]], Poses[i], i < LinearVelocities.size() ? LinearVelocities[i] : PxVec3(0.0f));
+	});
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Instance& ragdoll = Instances[indices[i]];
+		Scene->addAggregate(*ragdoll.Aggregate);
+		ragdoll.Articulation->wakeUp();
+		ragdoll.Active = true;
+	}
+
+	return indices;
+}
+
+bool RagdollPool::Despawn(uint32_t Index)
+{
+	if (!IsSpawned(Index))
+		return false;
+
+	Instance& ragdoll = Instances[Index];
+	Scene->removeAggregate(*ragdoll.Aggregate);
+	ragdoll.Active = false;
+	Dormant.push_back(Index);
+	return true;
+}
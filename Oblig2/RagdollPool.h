@@ -0,0 +1,92 @@
+#pragma once
+#include "PhysicsEngine.h"
+#include <cstdint>
+#include <vector>
+
+// One body of a ragdoll, see RagdollDesc
+struct RagdollLinkDesc
+{
+	// Index of the parent link, -1 for the root. The root must be the first link, and parents must come before their children
+	int32_t Parent = -1;
+	// Pose of the link when the ragdoll is spawned with an identity pose (the bind pose)
+	PxTransform Pose = PxTransform(PxIdentity);
+	// The link is a capsule along its X axis
+	float HalfHeight = 0.2f;
+	float Radius = 0.1f;
+	float Density = 1000.0f;
+	// Joint with the parent, in the frame of this link. The twist axis is X
+	PxTransform JointFrame = PxTransform(PxIdentity);
+	float SwingLimitY = PxPi / 4;
+	float SwingLimitZ = PxPi / 4;
+	float TwistLimit = PxPi / 8;
+};
+
+// Layout of the ragdolls of a RagdollPool
+struct RagdollDesc
+{
+	std::vector<RagdollLinkDesc> Links;
+	// The default material if not valid
+	MaterialID Material;
+	uint32_t PositionIterations = 8;
+	uint32_t VelocityIterations = 2;
+	float SleepThreshold = 0.05f;
+};
+
+// Keeps pre-built ragdolls dormant until they are needed, so spawning one on a death doesn't allocate anything or insert every link in the broadphase
+// Every ragdoll lives in its own aggregate: spawning resets the link poses in bulk and adds the aggregate (a single broadphase entry) to the scene,
+// despawning removes the aggregate and keeps the ragdoll for the next spawn
+// The pool must be released before its scene, and used while the scene is not simulating
+class RagdollPool
+{
+	struct Instance
+	{
+		PxArticulation * Articulation = nullptr;
+		PxAggregate * Aggregate = nullptr;
+		std::vector<PxArticulationLink*> Links;
+		bool Active = false;
+	};
+
+	PhysicsEngine * Engine = nullptr;
+	PxScene * Scene = nullptr;
+	RagdollDesc Desc;
+	std::vector<Instance> Instances;
+	std::vector<uint32_t> Dormant;
+
+	bool Build(Instance& Ragdoll);
+	void ResetPose(Instance& Ragdoll, const PxTransform& Pose, PxVec3 LinearVelocity);
+public:
+	static const uint32_t InvalidRagdoll = 0xffffffff;
+
+	RagdollPool() = default;
+	RagdollPool(const RagdollPool&) = delete;
+	RagdollPool& operator=(const RagdollPool&) = delete;
+	~RagdollPool() { Release(); }
+
+	// Builds Count dormant ragdolls for the scene. Returns false if the layout is not valid or the SDK objects can't be created
+	bool Initialize(PhysicsEngine& Engine, SceneID Scene, const RagdollDesc& Desc, uint32_t Count);
+
+	// Builds more dormant ragdolls, returns false if they can't be created
+	bool Reserve(uint32_t Count);
+
+	// Releases every ragdoll, spawned or not
+	void Release();
+
+	// Spawns a dormant ragdoll at the pose, every link moving at LinearVelocity. Returns the index of the ragdoll, or InvalidRagdoll if none is dormant
+	uint32_t Spawn(const PxTransform& Pose, PxVec3 LinearVelocity = PxVec3(0.0f));
+
+	// Spawns a ragdoll per pose, the link poses are reset in parallel. Returns the indices, InvalidRagdoll for the poses beyond the dormant ragdolls
+	std::vector<uint32_t> Spawn(const std::vector<PxTransform>& Poses, const std::vector<PxVec3>& LinearVelocities = std::vector<PxVec3>());
+
+	// Takes the ragdoll out of the scene, it stays built for a next spawn. Returns false if it is not spawned
+	bool Despawn(uint32_t Index);
+
+	// Returns the articulation of a ragdoll (spawned or not), or nullptr if the index is not valid
+	PxArticulation * GetArticulation(uint32_t Index) const { return Index < Instances.size() ? Instances[Index].Articulation : nullptr; }
+
+	// Returns the links of a ragdoll, in the order of RagdollDesc::Links
+	const std::vector<PxArticulationLink*>& GetLinks(uint32_t Index) const { return Instances[Index].Links; }
+
+	bool IsSpawned(uint32_t Index) const { return Index < Instances.size() && Instances[Index].Active; }
+	uint32_t GetDormantCount() const { return uint32_t(Dormant.size()); }
+	uint32_t GetCount() const { return uint32_t(Instances.size()); }
+};
@@ -0,0 +1,680 @@
+#include "Replication.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Appends values of up to 32 bits to a byte buffer, least significant bits first
+	class BitWriter
+	{
+		std::vector<uint8_t>& Bytes;
+		uint64_t Scratch = 0;
+		uint32_t ScratchBits = 0;
+	public:
+		explicit BitWriter(std::vector<uint8_t>& Bytes) : Bytes(Bytes) { Bytes.clear(); }
+
+		void Write(uint32_t Value, uint32_t Bits)
+		{
+			Scratch |= (uint64_t(Value) & ((uint64_t(1) << Bits) - 1)) << ScratchBits;
+			ScratchBits += Bits;
+			while (ScratchBits >= 8)
+			{
+				Bytes.push_back(uint8_t(Scratch));
+				Scratch >>= 8;
+				ScratchBits -= 8;
+			}
+		}
+
+		// Writes the last partial byte
+		void Flush()
+		{
+			if (ScratchBits)
+				Bytes.push_back(uint8_t(Scratch));
+			Scratch = 0;
+			ScratchBits = 0;
+		}
+	};
+
+	// Reads back the values of a BitWriter. Reading past the end returns zeros and sets Overrun
+	class BitReader
+	{
+		const uint8_t * Bytes;
+		size_t Size;
+		size_t Next = 0;
+		uint64_t Scratch = 0;
+		uint32_t ScratchBits = 0;
+	public:
+		bool Overrun = false;
+
+		BitReader(const uint8_t * Bytes, size_t Size) : Bytes(Bytes), Size(Size) {}
+
+		uint32_t Read(uint32_t Bits)
+		{
+			while (ScratchBits < Bits)
+			{
+				if (Next == Size)
+				{
+					Overrun = true;
+					return 0;
+				}
+				Scratch |= uint64_t(Bytes[Next++]) << ScratchBits;
+				ScratchBits += 8;
+			}
+
+			const uint32_t value = uint32_t(Scratch & ((uint64_t(1) << Bits) - 1));
+			Scratch >>= Bits;
+			ScratchBits -= Bits;
+			return value;
+		}
+	};
+
+	// Small values take fewer bits, a 2 bit prefix selects a 4, 8, 16 or 32 bit value
+	const uint32_t UnsignedWidths[4] = { 4, 8, 16, 32 };
+
+	void WriteUnsigned(BitWriter& Writer, uint32_t Value)
+	{
+		uint32_t prefix = 0;
+		while (prefix < 3 && Value >= (uint64_t(1) << UnsignedWidths[prefix]))
+			prefix++;
+		Writer.Write(prefix, 2);
+		Writer.Write(Value, UnsignedWidths[prefix]);
+	}
+
+	uint32_t ReadUnsigned(BitReader& Reader)
+	{
+		return Reader.Read(UnsignedWidths[Reader.Read(2)]);
+	}
+
+	// Zigzag encoded, so the small negative values are short too
+	void WriteSigned(BitWriter& Writer, int32_t Value)
+	{
+		WriteUnsigned(Writer, (uint32_t(Value) << 1) ^ uint32_t(Value >> 31));
+	}
+
+	int32_t ReadSigned(BitReader& Reader)
+	{
+		const uint32_t value = ReadUnsigned(Reader);
+		return int32_t(value >> 1) ^ -int32_t(value & 1);
+	}
+
+	bool AreSettingsValid(const ReplicationSettings& Settings)
+	{
+		return Settings.CellSize > 0.0f && Settings.PositionBits >= 1 && Settings.PositionBits <= 24 &&
+			Settings.RotationBits >= 2 && Settings.RotationBits <= 16 && Settings.VelocityBits >= 2 && Settings.VelocityBits <= 16 &&
+			Settings.MaxLinearVelocity > 0.0f && Settings.MaxAngularVelocity > 0.0f && Settings.RegionCells >= 1;
+	}
+
+	// Velocities are quantized symmetrically around zero, so a body at rest is sent exactly
+	void QuantizeVelocity(PxVec3 Velocity, float MaxVelocity, uint32_t Bits, uint32_t * Out)
+	{
+		const float half = float((1u << (Bits - 1)) - 1);
+		for (uint32_t i = 0; i < 3; i++)
+			Out[i] = uint32_t(int32_t(half) + int32_t(floorf(PxClamp(Velocity[i] / MaxVelocity, -1.0f, 1.0f) * half + 0.5f)));
+	}
+
+	PxVec3 DequantizeVelocity(const uint32_t * Values, float MaxVelocity, uint32_t Bits)
+	{
+		const int32_t half = int32_t((1u << (Bits - 1)) - 1);
+		const float scale = MaxVelocity / float(half);
+		return PxVec3(float(int32_t(Values[0]) - half), float(int32_t(Values[1]) - half), float(int32_t(Values[2]) - half)) * scale;
+	}
+
+	ReplicatedBody Quantize(const PxTransform& Pose, PxVec3 LinearVelocity, PxVec3 AngularVelocity, const ReplicationSettings& Settings)
+	{
+		ReplicatedBody body;
+		body.Valid = true;
+
+		const PxVec3 local = (Pose.p - Settings.Origin) / Settings.CellSize;
+		const float scale = float(1u << Settings.PositionBits);
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			const float cell = floorf(local[i]);
+			body.Cell[i] = int32_t(cell);
+			body.Position[i] = std::min(uint32_t((local[i] - cell) * scale), (1u << Settings.PositionBits) - 1);
+		}
+
+		// Smallest three: the largest component is left out and rebuilt from the others, which are within +-1/sqrt(2)
+		// It's made positive, as q and -q are the same rotation
+		const PxQuat q = Pose.q.getNormalized();
+		const float components[4] = { q.x, q.y, q.z, q.w };
+		uint32_t axis = 0;
+		for (uint32_t i = 1; i < 4; i++)
+		{
+			if (fabsf(components[i]) > fabsf(components[axis]))
+				axis = i;
+		}
+		const float sign = components[axis] < 0.0f ? -1.0f : 1.0f;
+		const float max_value = float((1u << Settings.RotationBits) - 1);
+		body.RotationAxis = axis;
+		for (uint32_t i = 0, j = 0; i < 4; i++)
+		{
+			if (i == axis)
+				continue;
+			const float unit = PxClamp(components[i] * sign * PxSqrt(0.5f) + 0.5f, 0.0f, 1.0f);
+			body.Rotation[j++] = uint32_t(unit * max_value + 0.5f);
+		}
+
+		QuantizeVelocity(LinearVelocity, Settings.MaxLinearVelocity, Settings.VelocityBits, body.LinearVelocity);
+		QuantizeVelocity(AngularVelocity, Settings.MaxAngularVelocity, Settings.VelocityBits, body.AngularVelocity);
+		const uint32_t rest = (1u << (Settings.VelocityBits - 1)) - 1;
+		for (uint32_t i = 0; i < 3; i++)
+			body.Moving |= body.LinearVelocity[i] != rest || body.AngularVelocity[i] != rest;
+
+		return body;
+	}
+
+	PxTransform DequantizePose(const ReplicatedBody& Body, const ReplicationSettings& Settings)
+	{
+		const float scale = 1.0f / float(1u << Settings.PositionBits);
+		PxVec3 position;
+		for (uint32_t i = 0; i < 3; i++)
+			position[i] = Settings.Origin[i] + (float(Body.Cell[i]) + (float(Body.Position[i]) + 0.5f) * scale) * Settings.CellSize;
+
+		const float max_value = float((1u << Settings.RotationBits) - 1);
+		float components[4];
+		float sum = 0.0f;
+		for (uint32_t i = 0, j = 0; i < 4; i++)
+		{
+			if (i == Body.RotationAxis)
+				continue;
+			components[i] = (float(Body.Rotation[j++]) / max_value - 0.5f) * PxSqrt(2.0f);
+			sum += components[i] * components[i];
+		}
+		components[Body.RotationAxis] = PxSqrt(PxMax(0.0f, 1.0f - sum));
+
+		return PxTransform(position, PxQuat(components[0], components[1], components[2], components[3]).getNormalized());
+	}
+
+	bool SameVelocity(const ReplicatedBody& A, const ReplicatedBody& B)
+	{
+		return !memcmp(A.LinearVelocity, B.LinearVelocity, sizeof(A.LinearVelocity)) && !memcmp(A.AngularVelocity, B.AngularVelocity, sizeof(A.AngularVelocity));
+	}
+
+	bool SameState(const ReplicatedBody& A, const ReplicatedBody& B)
+	{
+		return !memcmp(A.Cell, B.Cell, sizeof(A.Cell)) && !memcmp(A.Position, B.Position, sizeof(A.Position)) &&
+			A.RotationAxis == B.RotationAxis && !memcmp(A.Rotation, B.Rotation, sizeof(A.Rotation)) && SameVelocity(A, B);
+	}
+
+	// Writes the body as a delta against its baseline, or whole when the baseline is not valid
+	// Every part is preceded by a bit telling whether it changed, and velocities are only written when moving
+	void WriteBody(BitWriter& Writer, const ReplicatedBody& Body, const ReplicatedBody& Base, const ReplicationSettings& Settings)
+	{
+		const bool full = !Base.Valid;
+		Writer.Write(full, 1);
+
+		const bool cell_changed = full || memcmp(Body.Cell, Base.Cell, sizeof(Body.Cell));
+		if (!full)
+			Writer.Write(cell_changed, 1);
+		if (cell_changed)
+		{
+			// A new cell is written relative to the previous one, and the position inside it as is
+			for (uint32_t i = 0; i < 3; i++)
+				WriteSigned(Writer, full ? Body.Cell[i] : Body.Cell[i] - Base.Cell[i]);
+			for (uint32_t i = 0; i < 3; i++)
+				Writer.Write(Body.Position[i], Settings.PositionBits);
+		}
+		else
+		{
+			const bool position_changed = memcmp(Body.Position, Base.Position, sizeof(Body.Position)) != 0;
+			Writer.Write(position_changed, 1);
+			if (position_changed)
+			{
+				for (uint32_t i = 0; i < 3; i++)
+					WriteSigned(Writer, int32_t(Body.Position[i]) - int32_t(Base.Position[i]));
+			}
+		}
+
+		const bool rotation_changed = full || Body.RotationAxis != Base.RotationAxis || memcmp(Body.Rotation, Base.Rotation, sizeof(Body.Rotation));
+		if (!full)
+			Writer.Write(rotation_changed, 1);
+		if (rotation_changed)
+		{
+			Writer.Write(Body.RotationAxis, 2);
+			for (uint32_t i = 0; i < 3; i++)
+				Writer.Write(Body.Rotation[i], Settings.RotationBits);
+		}
+
+		const bool velocity_changed = full || !SameVelocity(Body, Base);
+		if (!full)
+			Writer.Write(velocity_changed, 1);
+		if (velocity_changed)
+		{
+			Writer.Write(Body.Moving, 1);
+			if (Body.Moving)
+			{
+				for (uint32_t i = 0; i < 3; i++)
+					Writer.Write(Body.LinearVelocity[i], Settings.VelocityBits);
+				for (uint32_t i = 0; i < 3; i++)
+					Writer.Write(Body.AngularVelocity[i], Settings.VelocityBits);
+			}
+		}
+	}
+
+	// Applies a body written by WriteBody to its baseline. Returns false if it's a delta without a baseline
+	bool ReadBody(BitReader& Reader, ReplicatedBody& Body, bool& VelocityChanged, const ReplicationSettings& Settings)
+	{
+		const bool full = Reader.Read(1) != 0;
+		if (!full && !Body.Valid)
+			return false;
+		Body.Valid = true;
+
+		if (full || Reader.Read(1))
+		{
+			for (uint32_t i = 0; i < 3; i++)
+				Body.Cell[i] = full ? ReadSigned(Reader) : Body.Cell[i] + ReadSigned(Reader);
+			for (uint32_t i = 0; i < 3; i++)
+				Body.Position[i] = Reader.Read(Settings.PositionBits);
+		}
+		else if (Reader.Read(1))
+		{
+			for (uint32_t i = 0; i < 3; i++)
+				Body.Position[i] = uint32_t(int32_t(Body.Position[i]) + ReadSigned(Reader));
+		}
+
+		if (full || Reader.Read(1))
+		{
+			Body.RotationAxis = Reader.Read(2);
+			for (uint32_t i = 0; i < 3; i++)
+				Body.Rotation[i] = Reader.Read(Settings.RotationBits);
+		}
+
+		VelocityChanged = full || Reader.Read(1);
+		if (VelocityChanged)
+		{
+			Body.Moving = Reader.Read(1) != 0;
+			const uint32_t rest = (1u << (Settings.VelocityBits - 1)) - 1;
+			for (uint32_t i = 0; i < 3; i++)
+				Body.LinearVelocity[i] = Body.Moving ? Reader.Read(Settings.VelocityBits) : rest;
+			for (uint32_t i = 0; i < 3; i++)
+				Body.AngularVelocity[i] = Body.Moving ? Reader.Read(Settings.VelocityBits) : rest;
+		}
+
+		return !Reader.Overrun;
+	}
+
+	int32_t FloorDiv(int32_t Value, int32_t Divisor)
+	{
+		return Value >= 0 ? Value / Divisor : -((Divisor - 1 - Value) / Divisor);
+	}
+
+	int64_t RegionKey(int32_t X, int32_t Z)
+	{
+		return (int64_t(X) << 32) | int64_t(uint32_t(Z));
+	}
+}
+
+bool ReplicationSnapshot::Assign(const void * Bytes, size_t Size)
+{
+	Data.clear();
+
+	Header header;
+	if (Size < sizeof(Header))
+		return false;
+	memcpy(&header, Bytes, sizeof(Header));
+	if (header.Version != Version || Size < sizeof(Header) + size_t(header.RegionCount) * sizeof(Region))
+		return false;
+
+	// Every region has to be in the data, after the region table
+	const size_t data_start = sizeof(Header) + size_t(header.RegionCount) * sizeof(Region);
+	for (uint32_t i = 0; i < header.RegionCount; i++)
+	{
+		Region region;
+		memcpy(&region, static_cast<const uint8_t*>(Bytes) + sizeof(Header) + i * sizeof(Region), sizeof(Region));
+		if (region.Offset < data_start || size_t(region.Offset) + region.Size > Size)
+			return false;
+	}
+
+	Data.assign(static_cast<const uint8_t*>(Bytes), static_cast<const uint8_t*>(Bytes) + Size);
+	return true;
+}
+
+uint32_t ReplicationSnapshot::GetBodyCount() const
+{
+	if (!IsValid())
+		return 0;
+
+	Header header;
+	memcpy(&header, Data.data(), sizeof(Header));
+	auto regions = reinterpret_cast<const Region*>(Data.data() + sizeof(Header));
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < header.RegionCount; i++)
+		count += regions[i].BodyCount;
+	return count;
+}
+
+bool ReplicationEncoder::Initialize(PhysicsEngine& Engine, SceneID Scene, const ReplicationSettings& Settings)
+{
+	if (!AreSettingsValid(Settings))
+	{
+		std::cout << "Invalid replication settings, see ReplicationSettings for the limits" << std::endl;
+		return false;
+	}
+
+	this->Engine = &Engine;
+	this->Scene = Scene;
+	this->Settings = Settings;
+	Sequence = 0;
+	Baseline.clear();
+	return true;
+}
+
+bool ReplicationEncoder::Encode(ReplicationSnapshot& Snapshot, bool Full)
+{
+	using namespace std;
+
+	if (!Engine)
+	{
+		cout << "The replication encoder needs to be initialized" << endl;
+		return false;
+	}
+	PxScene * scene = Engine->GetScene(Scene);
+	if (!scene)
+		return false;
+	if (Engine->IsSimulating(Scene))
+	{
+		cout << "[Warning] Snapshots can't be encoded while the scene is simulating" << endl;
+		return false;
+	}
+
+	const size_t slot_count = Engine->GetActorSlotCount();
+	Baseline.resize(slot_count);
+	Poses.resize(slot_count);
+
+	// Only the region of each body is computed here, the quantization happens in the region tasks
+	Bodies.clear();
+	auto add_body = [this](ActorID ID)
+	{
+		const PxVec3 local = (Poses[ID.Index].p - Settings.Origin) / Settings.CellSize;
+		const int32_t region_cells = int32_t(Settings.RegionCells);
+		Bodies.emplace_back(RegionKey(FloorDiv(int32_t(floorf(local.x)), region_cells), FloorDiv(int32_t(floorf(local.z)), region_cells)), ID);
+	};
+	if (Full)
+	{
+		// Nothing sent before counts, every body is written whole
+		for (auto& body : Baseline)
+			body.Valid = false;
+
+		const ActorID * ids;
+		const PxVec3 * positions;
+		const PxQuat * rotations;
+		const size_t count = Engine->GetActorPoses(ids, positions, rotations);
+		for (size_t i = 0; i < count; i++)
+		{
+			PxRigidActor * actor = Engine->GetActor(ids[i]);
+			if (actor->getType() != PxActorType::eRIGID_DYNAMIC || actor->getScene() != scene)
+				continue;
+			Poses[ids[i].Index] = PxTransform(positions[i], rotations[i]);
+			add_body(ids[i]);
+		}
+	}
+	else
+	{
+		for (ActorID id : Engine->GetMovedActorPoses(Poses.data(), Scene))
+		{
+			if (Engine->GetActor(id))
+				add_body(id);
+		}
+	}
+
+	sort(Bodies.begin(), Bodies.end(), [](const pair<int64_t, ActorID>& A, const pair<int64_t, ActorID>& B)
+	{
+		return A.first != B.first ? A.first < B.first : A.second.Index < B.second.Index;
+	});
+	RegionStarts.clear();
+	for (size_t i = 0; i < Bodies.size(); i++)
+	{
+		if (!i || Bodies[i].first != Bodies[i - 1].first)
+			RegionStarts.push_back(i);
+	}
+	const size_t region_count = RegionStarts.size();
+	RegionStarts.push_back(Bodies.size());
+
+	// Each body belongs to a single region, so the tasks write to distinct baseline entries
+	if (RegionBytes.size() < region_count)
+		RegionBytes.resize(region_count);
+	RegionCounts.assign(region_count, 0);
+	Engine->RunParallel(region_count, [this](size_t Region)
+	{
+		BitWriter writer(RegionBytes[Region]);
+		uint32_t last_index = 0;
+		for (size_t i = RegionStarts[Region]; i < RegionStarts[Region + 1]; i++)
+		{
+			const ActorID id = Bodies[i].second;
+			auto actor = static_cast<PxRigidDynamic*>(Engine->GetActor(id));
+			ReplicatedBody& base = Baseline[id.Index];
+			if (base.Generation != id.Generation)
+				base.Valid = false;
+
+			// Kinematic bodies have no velocity of their own, the clients only follow their poses
+			const bool kinematic = actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC;
+			ReplicatedBody body = Quantize(Poses[id.Index], kinematic ? PxVec3(0.0f) : actor->getLinearVelocity(), kinematic ? PxVec3(0.0f) : actor->getAngularVelocity(), Settings);
+			if (base.Valid && SameState(body, base))
+				continue;
+
+			WriteUnsigned(writer, id.Index - last_index);
+			WriteBody(writer, body, base, Settings);
+			last_index = id.Index;
+
+			body.Generation = id.Generation;
+			base = body;
+			RegionCounts[Region]++;
+		}
+		writer.Flush();
+	});
+
+	// Regions where nothing changed are left out
+	uint32_t written_regions = 0;
+	size_t data_size = 0;
+	for (size_t i = 0; i < region_count; i++)
+	{
+		if (RegionCounts[i])
+		{
+			written_regions++;
+			data_size += RegionBytes[i].size();
+		}
+	}
+
+	const size_t data_start = sizeof(ReplicationSnapshot::Header) + written_regions * sizeof(ReplicationSnapshot::Region);
+	Snapshot.Data.resize(data_start + data_size);
+
+	ReplicationSnapshot::Header header;
+	header.Version = ReplicationSnapshot::Version;
+	header.Sequence = ++Sequence;
+	header.Flags = Full ? uint32_t(ReplicationSnapshot::Full) : 0u;
+	header.SlotCount = uint32_t(slot_count);
+	header.RegionCount = written_regions;
+	header.Padding = 0;
+	memcpy(Snapshot.Data.data(), &header, sizeof(header));
+
+	auto regions = reinterpret_cast<ReplicationSnapshot::Region*>(Snapshot.Data.data() + sizeof(header));
+	uint32_t offset = uint32_t(data_start);
+	for (size_t i = 0; i < region_count; i++)
+	{
+		if (!RegionCounts[i])
+			continue;
+
+		regions->BodyCount = RegionCounts[i];
+		regions->Offset = offset;
+		regions->Size = uint32_t(RegionBytes[i].size());
+		if (!RegionBytes[i].empty())
+			memcpy(Snapshot.Data.data() + offset, RegionBytes[i].data(), RegionBytes[i].size());
+		offset += regions->Size;
+		regions++;
+	}
+
+	return true;
+}
+
+bool ReplicationDecoder::Initialize(PhysicsEngine& Engine, SceneID Scene, const ReplicationSettings& Settings)
+{
+	if (!AreSettingsValid(Settings))
+	{
+		std::cout << "Invalid replication settings, see ReplicationSettings for the limits" << std::endl;
+		return false;
+	}
+
+	this->Engine = &Engine;
+	this->Scene = Scene;
+	this->Settings = Settings;
+	HasSequence = false;
+	Baseline.clear();
+	Bindings.clear();
+	return true;
+}
+
+void ReplicationDecoder::BindActor(uint32_t NetworkID, ActorID Actor)
+{
+	if (NetworkID >= Bindings.size())
+		Bindings.resize(NetworkID + 1);
+	Bindings[NetworkID] = Actor;
+}
+
+void ReplicationDecoder::UnbindActor(uint32_t NetworkID)
+{
+	if (NetworkID < Bindings.size())
+		Bindings[NetworkID] = ActorID();
+}
+
+bool ReplicationDecoder::Apply(const ReplicationSnapshot& Snapshot)
+{
+	using namespace std;
+
+	if (!Engine)
+	{
+		cout << "The replication decoder needs to be initialized" << endl;
+		return false;
+	}
+	PxScene * scene = Engine->GetScene(Scene);
+	if (!scene)
+		return false;
+	if (Engine->IsSimulating(Scene))
+	{
+		cout << "[Warning] Snapshots can't be applied while the scene is simulating" << endl;
+		return false;
+	}
+	if (!Snapshot.IsValid())
+	{
+		cout << "Apply needs an encoded snapshot" << endl;
+		return false;
+	}
+
+	ReplicationSnapshot::Header header;
+	memcpy(&header, Snapshot.Data.data(), sizeof(header));
+	const bool full = (header.Flags & ReplicationSnapshot::Full) != 0;
+	if (header.Version != ReplicationSnapshot::Version || (!full && (!HasSequence || header.Sequence != LastSequence + 1)))
+	{
+		cout << "The snapshot doesn't follow the last applied one, a full snapshot is needed" << endl;
+		return false;
+	}
+
+	if (full)
+	{
+		for (auto& body : Baseline)
+			body.Valid = false;
+	}
+	if (Baseline.size() < header.SlotCount)
+		Baseline.resize(header.SlotCount);
+
+	// Each network ID is in a single region, so the regions are decoded at the same time into distinct baseline entries
+	auto regions = reinterpret_cast<const ReplicationSnapshot::Region*>(Snapshot.Data.data() + sizeof(header));
+	if (RegionBodies.size() < header.RegionCount)
+		RegionBodies.resize(header.RegionCount);
+	RegionErrors.assign(header.RegionCount, 0);
+	Engine->RunParallel(header.RegionCount, [&](size_t Region)
+	{
+		const auto& region = regions[Region];
+		auto& decoded = RegionBodies[Region];
+		decoded.clear();
+
+		BitReader reader(Snapshot.Data.data() + region.Offset, region.Size);
+		uint32_t index = 0;
+		for (uint32_t i = 0; i < region.BodyCount; i++)
+		{
+			index += ReadUnsigned(reader);
+			bool velocity_changed;
+			if (index >= header.SlotCount || !ReadBody(reader, Baseline[index], velocity_changed, Settings))
+			{
+				RegionErrors[Region] = 1;
+				return;
+			}
+
+			if (index >= Bindings.size() || !Bindings[index].IsValid())
+				continue;
+			PxRigidActor * actor = Engine->GetActor(Bindings[index]);
+			if (!actor || actor->getType() != PxActorType::eRIGID_DYNAMIC || actor->getScene() != scene)
+				continue;
+
+			const ReplicatedBody& body = Baseline[index];
+			DecodedBody out;
+			out.Actor = static_cast<PxRigidDynamic*>(actor);
+			out.Pose = DequantizePose(body, Settings);
+			out.LinearVelocity = DequantizeVelocity(body.LinearVelocity, Settings.MaxLinearVelocity, Settings.VelocityBits);
+			out.AngularVelocity = DequantizeVelocity(body.AngularVelocity, Settings.MaxAngularVelocity, Settings.VelocityBits);
+			out.Kinematic = out.Actor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC;
+			out.HasVelocity = velocity_changed;
+			decoded.push_back(out);
+		}
+	});
+
+	// The baselines of a corrupt snapshot are partly updated, only a full snapshot can fix them
+	for (uint32_t i = 0; i < header.RegionCount; i++)
+	{
+		if (RegionErrors[i])
+		{
+			cout << "The snapshot is corrupt, a full snapshot is needed" << endl;
+			HasSequence = false;
+			return false;
+		}
+	}
+
+	Dynamics.clear();
+	DynamicPoses.clear();
+	Kinematics.clear();
+	KinematicTargets.clear();
+	MovingBodies.clear();
+	MovingVelocities.clear();
+	for (uint32_t i = 0; i < header.RegionCount; i++)
+	{
+		for (const auto& body : RegionBodies[i])
+		{
+			if (body.Kinematic)
+			{
+				Kinematics.push_back(body.Actor);
+				KinematicTargets.push_back(body.Pose);
+				continue;
+			}
+
+			Dynamics.push_back(body.Actor);
+			DynamicPoses.push_back(body.Pose);
+			if (!body.HasVelocity)
+				continue;
+
+			// A body that came to rest is not woken up for it
+			if (body.LinearVelocity.isZero() && body.AngularVelocity.isZero())
+			{
+				body.Actor->setLinearVelocity(PxVec3(0.0f), false);
+				body.Actor->setAngularVelocity(PxVec3(0.0f), false);
+			}
+			else
+			{
+				MovingBodies.push_back(body.Actor);
+				MovingVelocities.push_back(body.LinearVelocity);
+				body.Actor->setAngularVelocity(body.AngularVelocity, false);
+			}
+		}
+	}
+
+	// The poses don't wake the bodies up, the velocities of the moving ones do
+	if (!Dynamics.empty())
+		scene->setGlobalPoses(Dynamics.data(), DynamicPoses.data(), PxU32(Dynamics.size()), false);
+	if (!Kinematics.empty())
+		scene->setKinematicTargets(Kinematics.data(), KinematicTargets.data(), PxU32(Kinematics.size()));
+	if (!MovingBodies.empty())
+		scene->setLinearVelocities(MovingBodies.data(), MovingVelocities.data(), PxU32(MovingBodies.size()), true);
+
+	HasSequence = true;
+	LastSequence = header.Sequence;
+	return true;
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include "PhysicsEngine.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Quantization of the replicated state, the encoder and every decoder of its snapshots must use the same values
+struct ReplicationSettings
+{
+	// Positions are sent relative to the corner of their cell, on a grid of CellSize cubes with a corner at Origin
+	PxVec3 Origin = PxVec3(0.0f);
+	float CellSize = 64.0f;
+	// Bits per axis of a position inside its cell, the precision is CellSize / 2^PositionBits (1 mm with the defaults)
+	uint32_t PositionBits = 16;
+	// Bits per component of the smallest three rotation encoding (at most 16)
+	uint32_t RotationBits = 12;
+	// Velocities are clamped to these speeds, and sent with VelocityBits per axis (at most 16)
+	float MaxLinearVelocity = 64.0f;
+	float MaxAngularVelocity = 32.0f;
+	uint32_t VelocityBits = 12;
+	// The snapshot is split in regions of RegionCells x RegionCells cells on the XZ plane, which are encoded and decoded in parallel
+	uint32_t RegionCells = 4;
+};
+
+// The bytes of an encoded snapshot, see ReplicationEncoder
+class ReplicationSnapshot
+{
+	friend class ReplicationEncoder;
+	friend class ReplicationDecoder;
+
+	struct Header
+	{
+		uint32_t Version;
+		uint32_t Sequence;
+		uint32_t Flags;
+		// Upper bound of the network IDs of the snapshot
+		uint32_t SlotCount;
+		uint32_t RegionCount;
+		uint32_t Padding;
+	};
+	enum HeaderFlags : uint32_t
+	{
+		// Every body is sent whole, the decoder doesn't need the previous snapshots
+		Full = 1,
+	};
+	struct Region
+	{
+		uint32_t BodyCount;
+		uint32_t Offset;
+		uint32_t Size;
+	};
+
+	std::vector<uint8_t> Data;
+public:
+	// Layout version of the data, snapshots with another version are rejected
+	static const uint32_t Version = 1;
+
+	// The encoded bytes, to be sent to the clients
+	const uint8_t * GetData() const { return Data.data(); }
+	size_t GetSize() const { return Data.size(); }
+
+	// Copies received bytes into the snapshot. Returns false (leaving the snapshot empty) if they are not a snapshot of this version
+	bool Assign(const void * Bytes, size_t Size);
+
+	// Returns true if the snapshot holds something encoded
+	bool IsValid() const { return Data.size() >= sizeof(Header); }
+
+	// Number of bodies in the snapshot
+	uint32_t GetBodyCount() const;
+};
+
+// Quantized state of a body, as last sent by the encoder or last applied by the decoder (the baseline of the next delta)
+struct ReplicatedBody
+{
+	bool Valid = false;
+	bool Moving = false;
+	// Generation of the actor on the server, used by the encoder to detect a reused index
+	uint32_t Generation = 0;
+	int32_t Cell[3] = {};
+	uint32_t Position[3] = {};
+	// Index of the largest component, and the three others
+	uint32_t RotationAxis = 0;
+	uint32_t Rotation[3] = {};
+	uint32_t LinearVelocity[3] = {};
+	uint32_t AngularVelocity[3] = {};
+};
+
+// Encodes the bodies of a scene that moved on its last step into compact snapshots, meant to be sent by a server to its clients
+// Bodies are delta compressed against what the previous snapshot sent: only moved bodies whose quantized state changed are written,
+// and within them only the cell, position, rotation or velocity that changed. Velocities are only sent when they change, and a body at rest costs a single bit for them
+// The snapshots must therefore be decoded in order and without gaps (over a reliable channel). When one is lost, EncodeFull gives a snapshot that stands alone
+// The bodies are identified by their network ID, which is ActorID::Index on the server
+class ReplicationEncoder
+{
+	PhysicsEngine * Engine = nullptr;
+	SceneID Scene;
+	ReplicationSettings Settings;
+	uint32_t Sequence = 0;
+
+	// By network ID
+	std::vector<ReplicatedBody> Baseline;
+	std::vector<PxTransform> Poses;
+
+	// Reused between snapshots. The bodies are sorted by region and then by network ID, so each region is a range of growing IDs
+	std::vector<std::pair<int64_t, ActorID>> Bodies;
+	std::vector<size_t> RegionStarts;
+	std::vector<std::vector<uint8_t>> RegionBytes;
+	std::vector<uint32_t> RegionCounts;
+
+	bool Encode(ReplicationSnapshot& Snapshot, bool Full);
+public:
+	// The engine must outlive the encoder, and the scene must have active actors enabled (see PhysicsEngine::EnableActiveActors)
+	// Returns false if the settings are not valid
+	bool Initialize(PhysicsEngine& Engine, SceneID Scene, const ReplicationSettings& Settings = ReplicationSettings());
+
+	// Encodes the dynamic bodies that moved on the last step of the scene. Must be called while the scene is not simulating
+	bool EncodeMoved(ReplicationSnapshot& Snapshot) { return Encode(Snapshot, false); }
+
+	// Encodes every dynamic body of the scene whole, for a new client or one that lost a snapshot
+	// Every client has to get it, as the next deltas are relative to it
+	bool EncodeFull(ReplicationSnapshot& Snapshot) { return Encode(Snapshot, true); }
+};
+
+// Applies the snapshots of a ReplicationEncoder to the local copies of the bodies, with one batched pose write for the whole snapshot
+// (and one for the velocities). Local bodies that are kinematic are driven to the received pose instead
+class ReplicationDecoder
+{
+	PhysicsEngine * Engine = nullptr;
+	SceneID Scene;
+	ReplicationSettings Settings;
+	bool HasSequence = false;
+	uint32_t LastSequence = 0;
+
+	// By network ID
+	std::vector<ReplicatedBody> Baseline;
+	std::vector<ActorID> Bindings;
+
+	// The decoded bodies of each region, reused between snapshots
+	struct DecodedBody
+	{
+		PxRigidDynamic * Actor;
+		PxTransform Pose;
+		PxVec3 LinearVelocity;
+		PxVec3 AngularVelocity;
+		bool Kinematic;
+		bool HasVelocity;
+	};
+	std::vector<std::vector<DecodedBody>> RegionBodies;
+	std::vector<uint8_t> RegionErrors;
+
+	// Gathered from every region for the batched writes
+	std::vector<PxRigidDynamic*> Dynamics;
+	std::vector<PxTransform> DynamicPoses;
+	std::vector<PxRigidDynamic*> Kinematics;
+	std::vector<PxTransform> KinematicTargets;
+	std::vector<PxRigidDynamic*> MovingBodies;
+	std::vector<PxVec3> MovingVelocities;
+public:
+	// The engine must outlive the decoder, and the settings must be the ones of the encoder
+	// Returns false if the settings are not valid
+	bool Initialize(PhysicsEngine& Engine, SceneID Scene, const ReplicationSettings& Settings = ReplicationSettings());
+
+	// Makes the bodies with that network ID move the local actor, which has to be dynamic and in the scene of the decoder
+	void BindActor(uint32_t NetworkID, ActorID Actor);
+	void UnbindActor(uint32_t NetworkID);
+
+	// Decodes the snapshot and writes the poses and velocities of the bound actors. Must be called while the scene is not simulating
+	// Returns false if the snapshot is corrupt or doesn't follow the last applied one, in which case a full snapshot is needed
+	bool Apply(const ReplicationSnapshot& Snapshot);
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+// Identifies an object stored on a SlotMap
+// The generation is bumped every time a slot is reused, so a handle to a removed object is detected instead of silently returning a new one
+// The tag type only exists to avoid mixing handles of different kinds
+template<typename Tag>
+struct Handle
+{
+	uint32_t Index = UINT32_MAX;
+	uint32_t Generation = 0;
+
+	bool IsValid() const { return Index != UINT32_MAX; }
+
+	bool operator==(const Handle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const Handle& Other) const { return !(*this == Other); }
+};
+
+// Stores objects contiguously, and gives out generational handles to them
+// Lookup, insertion and removal are O(1). Removal moves the last object into the hole, so the dense order is not stable
+template<typename T, typename Tag = T>
+class SlotMap
+{
+public:
+	using HandleT = Handle<Tag>;
+
+private:
+	struct Slot
+	{
+		// Index on the dense arrays when in use, next free slot otherwise
+		uint32_t DenseIndex;
+		uint32_t Generation;
+	};
+
+	std::vector<T> Items;
+	std::vector<HandleT> DenseHandles;
+	std::vector<Slot> Slots;
+	uint32_t FirstFree = UINT32_MAX;
+
+public:
+	// Adds a new object and returns its handle
+	HandleT Insert(T Item)
+	{
+		uint32_t slot_idx;
+		if (FirstFree != UINT32_MAX)
+		{
+			slot_idx = FirstFree;
+			FirstFree = Slots[slot_idx].DenseIndex;
+		}
+		else
+		{
+			slot_idx = uint32_t(Slots.size());
+			Slots.push_back(Slot{ 0, 0 });
+		}
+
+		HandleT handle;
+		handle.Index = slot_idx;
+		handle.Generation = Slots[slot_idx].Generation;
+
+		Slots[slot_idx].DenseIndex = uint32_t(Items.size());
+		Items.push_back(std::move(Item));
+		DenseHandles.push_back(handle);
+
+		return handle;
+	}
+
+	// Returns true if the handle points to an object that wasn't removed
+	bool Contains(HandleT ID) const
+	{
+		return ID.Index < Slots.size() && Slots[ID.Index].Generation == ID.Generation;
+	}
+
+	// Returns the object, or nullptr if the handle is invalid or stale
+	T * Get(HandleT ID)
+	{
+		return Contains(ID) ? &Items[Slots[ID.Index].DenseIndex] : nullptr;
+	}
+
+	const T * Get(HandleT ID) const
+	{
+		return Contains(ID) ? &Items[Slots[ID.Index].DenseIndex] : nullptr;
+	}
+
+	// Returns the position of the object on the dense arrays, or UINT32_MAX if the handle is invalid or stale
+	uint32_t GetDenseIndex(HandleT ID) const
+	{
+		return Contains(ID) ? Slots[ID.Index].DenseIndex : UINT32_MAX;
+	}
+
+	// Returns the current handle of a slot that is known to be in use (i.e. an index stored on the object itself)
+	HandleT GetHandle(uint32_t SlotIndex) const
+	{
+		return DenseHandles[Slots[SlotIndex].DenseIndex];
+	}
+
+	// Removes the object, returns false if the handle is invalid or stale
+	bool Remove(HandleT ID)
+	{
+		if (!Contains(ID))
+			return false;
+
+		const uint32_t dense_idx = Slots[ID.Index].DenseIndex;
+		const uint32_t last_idx = uint32_t(Items.size() - 1);
+		if (dense_idx != last_idx)
+		{
+			Items[dense_idx] = std::move(Items[last_idx]);
+			DenseHandles[dense_idx] = DenseHandles[last_idx];
+			Slots[DenseHandles[dense_idx].Index].DenseIndex = dense_idx;
+		}
+		Items.pop_back();
+		DenseHandles.pop_back();
+
+		// Invalidate every outstanding handle to this slot, then put it on the free list
+		Slots[ID.Index].Generation++;
+		Slots[ID.Index].DenseIndex = FirstFree;
+		FirstFree = ID.Index;
+
+		return true;
+	}
+
+	size_t Size() const { return Items.size(); }
+	size_t SlotCount() const { return Slots.size(); }
+	bool Empty() const { return Items.empty(); }
+
+	// Dense access, valid indices are [0, Size())
+	T * Data() { return Items.data(); }
+	const T * Data() const { return Items.data(); }
+	const HandleT * Handles() const { return DenseHandles.data(); }
+
+	typename std::vector<T>::iterator begin() { return Items.begin(); }
+	typename std::vector<T>::iterator end() { return Items.end(); }
+	typename std::vector<T>::const_iterator begin() const { return Items.begin(); }
+	typename std::vector<T>::const_iterator end() const { return Items.end(); }
+};
@@ -44,11 +44,13 @@ namespace Gu
 		PX_FORCE_INLINE	NarrowPhaseParams(PxReal contactDistance, PxReal meshContactMargin, PxReal toleranceLength) :
 				mContactDistance(contactDistance),
 				mMeshContactMargin(meshContactMargin),
-				mToleranceLength(toleranceLength)	{}
+				mToleranceLength(toleranceLength),
+				mPCMThresholdScale(1.0f)			{}
 
 		PxReal	mContactDistance;
 		PxReal	mMeshContactMargin;	// PT: Margin used to generate mesh contacts. Temp & unclear, should be removed once GJK is default path.
 		PxReal	mToleranceLength;	// PT: copy of PxTolerancesScale::length
+		PxReal	mPCMThresholdScale;	// Scale of the PCM manifold reuse thresholds, above 1 for resting pairs with PxSceneFlag::eENABLE_ADAPTIVE_PCM_THRESHOLDS
 	};
 
 //sizeof(SavedContactData)/sizeof(PxU32) = 17, 1088/17 = 64 triangles in the local array
@@ -45,6 +45,7 @@ namespace physx
 
 class PxBoxGeometry;
 class PxSphereGeometry;
+class PxCpuDispatcher;
 struct PxQueryCache;
 
 /**
@@ -63,6 +64,23 @@ class PX_DEPRECATED PxBatchQuery
 	*/
 	virtual	void							execute() = 0;
 
+	/**
+	\brief Executes batched queries, splitting them across the worker threads of a dispatcher.
+
+	The queries are divided into contiguous chunks which are run by the calling thread and by tasks submitted to the dispatcher,
+	each chunk writing its touches to its own scratch buffer. The touches are then copied to the user touch buffers in query order,
+	so the results are laid out as with execute(). When a touch buffer overflows, the touches kept for the overflowing query
+	can differ from the ones execute() would keep.
+
+	The call returns once all the queries are done. Filter shaders are called from the worker threads and must be thread safe.
+	Small batches, or a dispatcher without workers, are executed on the calling thread like execute().
+
+	\param[in] dispatcher Dispatcher running the helper tasks.
+
+	@see execute PxCpuDispatcher
+	*/
+	virtual	void							executeParallel(PxCpuDispatcher& dispatcher) = 0;
+
 	/**
 	\brief Gets the prefilter shader in use for this scene query.
 
@@ -46,6 +46,7 @@ namespace physx
 
 struct	PxSweepHit;
 struct	PxRaycastHit;
+class	PxScene;
 
 /**
 \brief Batched query status.
@@ -207,6 +208,57 @@ protected:
  	PxU32							overlapResultBufferSize;
 };
 
+/**
+\brief A raycast of a batch, as passed to PxBatchQueryRaycastOffload.
+
+\deprecated The batched query feature has been deprecated in PhysX version 3.4
+
+@see PxBatchQueryRaycastOffload PxBatchQuery::raycast()
+*/
+struct PX_DEPRECATED PxBatchQueryRaycast
+{
+	PxVec3							origin;
+	PxVec3							unitDir;
+	PxReal							distance;
+	PxHitFlags						hitFlags;
+	PxQueryFilterData				filterData;	//!< The clientId is already replaced with PxBatchQueryDesc::ownerClient if it was zero
+	void*							userData;
+};
+
+/**
+\brief Executes large raycast batches outside of the SDK, for example on the GPU.
+
+The SDK only hands over batches where the offload gives the same results as the CPU path can be expected,
+see PxBatchQueryDesc::raycastOffload. The implementation typically keeps its own copy of the static shapes, such as
+a bounding volume tree and the triangles of the meshes (PxTriangleMesh::getVertices(), PxTriangleMesh::getTriangles()),
+in memory of a PxCudaContextManager. PxScene::getSceneQueryStaticTimestamp() changes whenever a static shape is
+added, removed or moved, which tells the implementation when its copy has to be updated.
+
+\deprecated The batched query feature has been deprecated in PhysX version 3.4
+
+@see PxBatchQueryDesc::raycastOffload
+*/
+class PX_DEPRECATED PxBatchQueryRaycastOffload
+{
+public:
+	/**
+	\brief Runs the raycasts of a batch.
+
+	The offload writes the closest hit of each raycast to block and hasBlock of its result, the SDK fills in the
+	other members. The actor and shape of a hit are the SDK objects the hit shape was copied from.
+
+	\param[in] scene		The scene the batch query belongs to.
+	\param[in] raycasts		The raycasts of the batch in the order of issue.
+	\param[in] nbRaycasts	Number of raycasts.
+	\param[out] results		The results of the raycasts, in the same order.
+	\return True if the raycasts were executed, false to run them on the CPU instead.
+	*/
+	virtual bool					raycast(const PxScene& scene, const PxBatchQueryRaycast* raycasts, PxU32 nbRaycasts, PxRaycastQueryResult* results) = 0;
+
+protected:
+	virtual							~PxBatchQueryRaycastOffload() {}
+};
+
 /**
 \brief Descriptor class for #PxBatchQuery.
 
@@ -268,6 +320,42 @@ public:
 	*/
 	PxBatchQueryMemory				queryMemory;	
 
+	/**
+	\brief Traverse the scene with packets of raycasts.
+
+	Up to 4 consecutive raycasts without touch hits (maxTouchHits of 0) and without cache traverse the pruners together,
+	which saves most of the node tests for coherent rays, such as the rays of a sensor fan cast from nearby origins
+	in similar directions. Rays that go different ways inside the trees continue one by one.
+
+	The closest hits are the same as with single raycasts. With PxQueryFlag::eANY_HIT, the reported hit can be a different one.
+
+	<b>Default:</b> false
+	*/
+	bool							raycastPackets;
+
+	/**
+	\brief Executes large raycast batches outside of the SDK.
+
+	The offload is used for batches of at least raycastOffloadThreshold raycasts that have no sweeps or overlaps, when
+	no pre or post filter shader is set, and when all raycasts have a maxTouchHits of 0, no cache, and PxQueryFlag::eSTATIC
+	without PxQueryFlag::eDYNAMIC in their filter data flags. The other batches, and the batches the offload returns
+	false for, are executed on the CPU as usual.
+
+	<b>Default:</b> NULL
+
+	@see PxBatchQueryRaycastOffload raycastOffloadThreshold
+	*/
+	PxBatchQueryRaycastOffload*		raycastOffload;
+
+	/**
+	\brief Smallest number of raycasts of a batch to use the raycastOffload for.
+
+	<b>Default:</b> 4096
+
+	@see raycastOffload
+	*/
+	PxU32							raycastOffloadThreshold;
+
 	/**
 	\brief Construct a batch query with specified maximum number of queries per batch.
 
@@ -291,7 +379,10 @@ PX_INLINE PxBatchQueryDesc::PxBatchQueryDesc(PxU32 maxRaycastsPerExecute, PxU32
 	preFilterShader			(NULL),
 	postFilterShader		(NULL),
 	ownerClient				(PX_DEFAULT_CLIENT),
-	queryMemory				(maxRaycastsPerExecute, maxSweepsPerExecute, maxOverlapsPerExecute)
+	queryMemory				(maxRaycastsPerExecute, maxSweepsPerExecute, maxOverlapsPerExecute),
+	raycastPackets			(false),
+	raycastOffload			(NULL),
+	raycastOffloadThreshold	(4096)
 {
 }
 
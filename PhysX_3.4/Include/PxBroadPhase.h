@@ -159,6 +159,80 @@ namespace physx
 		bool	needsPredefinedBounds;	//!< If true, broad-phase needs 'regions' to work
 	};
 
+	/**
+	\brief Settings for the adaptive regions of the PxBroadPhaseType::eMBP broad-phase.
+
+	In this mode the broad-phase manages the regions itself. They form a binary partition of the whole space: regions holding
+	too many objects are split in two at the median of their objects, and sibling regions holding few objects are merged back.
+	The outer regions extend to the limits of the broad-phase, so objects never go out of bounds, wherever the world grows.
+
+	The layout is checked during the broad-phase update, every updatePeriod updates.
+
+	@see PxScene.setBroadPhaseAdaptiveRegions
+	*/
+	struct PxBroadPhaseAdaptiveRegionsDesc
+	{
+		PxU32	maxObjectsPerRegion;	//!< A region is split when it holds more objects than this
+		PxU32	minObjectsPerRegion;	//!< Two sibling regions are merged when they hold fewer objects than this together
+		PxU32	maxNbRegions;			//!< Max number of regions used by the layout, limited by PxBroadPhaseCaps::maxNbRegions
+		PxU32	updatePeriod;			//!< Number of broad-phase updates between two checks of the layout
+
+		PX_INLINE PxBroadPhaseAdaptiveRegionsDesc() :
+			maxObjectsPerRegion	(1024),
+			minObjectsPerRegion	(128),
+			maxNbRegions		(64),
+			updatePeriod		(16)
+		{
+		}
+
+		/**
+		\brief Returns true if the descriptor is valid.
+		*/
+		PX_INLINE bool isValid() const
+		{
+			return minObjectsPerRegion < maxObjectsPerRegion && maxNbRegions>0 && updatePeriod>0;
+		}
+	};
+
+	/**
+	\brief Read-only view of overlap pairs created or lost by the broad-phase.
+
+	The view points to the broad-phase's own pair array, nothing is copied. It remains valid until the next simulation step
+	starts, or until one of the shapes it refers to is released or removed from the scene.
+
+	@see PxScene.getBroadPhaseTriggerPairs
+	*/
+	class PxBroadPhasePairView
+	{
+		public:
+		typedef bool	(*DecodeFunction)(const void* pairs, PxU32 index, PxShape*& shape0, PxShape*& shape1);
+
+		PX_INLINE PxBroadPhasePairView() : mPairs(NULL), mNbPairs(0), mDecode(NULL)	{}
+
+		/**
+		\brief Returns the number of pairs in the view.
+		*/
+		PX_FORCE_INLINE	PxU32	getNbPairs()	const	{ return mNbPairs;	}
+
+		/**
+		\brief Retrieves the shapes of a pair.
+
+		\param[in] index	Pair index, between 0 and getNbPairs()
+		\param[out] shape0	First shape of the pair
+		\param[out] shape1	Second shape of the pair
+		\return False if one of the objects is not a shape (e.g. a particle system touching a trigger). Its pointer is then NULL.
+		*/
+		PX_FORCE_INLINE	bool	getPair(PxU32 index, PxShape*& shape0, PxShape*& shape1)	const
+		{
+			PX_ASSERT(index<mNbPairs);
+			return mDecode(mPairs, index, shape0, shape1);
+		}
+
+		const void*		mPairs;		//!< Internal pair array
+		PxU32			mNbPairs;	//!< Number of pairs
+		DecodeFunction	mDecode;	//!< Internal function reading a pair
+	};
+
 #if !PX_DOXYGEN
 } // namespace physx
 #endif
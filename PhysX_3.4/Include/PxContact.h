@@ -73,7 +73,8 @@ struct PxContactPatch
 		eHAS_MAX_IMPULSE = 32,				//!< Indicates this contact stream has max impulses set
 		eREGENERATE_PATCHES = 64,		//!< Indicates this contact stream needs patches re-generated. 
 											//!< This is required if the application modified either the contact normal or the material properties
-		eCOMPRESSED_MODIFIED_CONTACT = 128
+		eCOMPRESSED_MODIFIED_CONTACT = 128,
+		eCOMPACT_CONTACT = eCOMPRESSED_MODIFIED_CONTACT	//!< Without eMODIFIABLE: the points are stored as PxCompactContact (see PxSceneFlag::eENABLE_COMPACT_CONTACTS).
 	};
 
 	PX_ALIGN(16, PxMassModificationProps mMassModification);			//16
@@ -132,6 +133,45 @@ struct PxExtendedContact : public PxContact
 }
 PX_ALIGN_SUFFIX(16);
 
+/**
+\brief Header of the contact points of a compact stream, followed by the PxCompactContact points.
+
+Points and separations are 16 bit fixed point values in units of 'quantum', so the error is below quantum/2. The quantum is
+computed for each stream from the extents of its points, use PxContactStreamIterator to read them.
+
+@see PxCompactContact PxSceneFlag::eENABLE_COMPACT_CONTACTS
+*/
+PX_ALIGN_PREFIX(16)
+struct PxCompactContactHeader
+{
+	/**
+	\brief Contact point of zero offsets, in world space
+	*/
+	PxVec3	origin;								//12
+	/**
+	\brief Size of a unit of the offsets and separations
+	*/
+	PxReal	quantum;							//16
+}
+PX_ALIGN_SUFFIX(16);
+
+/**
+\brief Quantized contact point of a compact stream.
+
+@see PxCompactContactHeader
+*/
+struct PxCompactContact
+{
+	/**
+	\brief Contact point minus the origin, in quantums
+	*/
+	PxI16	offset[3];							//6
+	/**
+	\brief Separation in quantums
+	*/
+	PxI16	separation;							//8
+};
+
 /**
 \brief A modifiable contact point. This has additional fields per-contact to permit modification by user.
 \note Not all fields are currently exposed to the user.
@@ -181,7 +221,8 @@ struct PxContactStreamIterator
 	{
 		eSIMPLE_STREAM,
 		eMODIFIABLE_STREAM,
-		eCOMPRESSED_MODIFIABLE_STREAM
+		eCOMPRESSED_MODIFIABLE_STREAM,
+		eCOMPACT_STREAM
 	};
 	/**
 	\brief Utility zero vector to optimize functions returning zero vectors when a certain flag isn't set.
@@ -204,6 +245,17 @@ struct PxContactStreamIterator
 	*/
 	const PxU32* faceIndice;
 
+	/**
+	\brief The quantization header of a compact stream, NULL for the other formats.
+	*/
+	const PxCompactContactHeader* compactHeader;
+
+	/**
+	\brief The current contact point and separation, decoded for compact streams.
+	*/
+	PxVec3 decodedPoint;
+	PxReal decodedSeparation;
+
 
 	/**
 	\brief The total number of patches in this contact stream
@@ -252,10 +304,11 @@ struct PxContactStreamIterator
 	\brief Constructor
 	*/
 	PX_CUDA_CALLABLE PX_FORCE_INLINE PxContactStreamIterator(const PxU8* contactPatches, const PxU8* contactPoints, const PxU32* contactFaceIndices, PxU32 nbPatches, PxU32 nbContacts) 
-		: zero(0.f)
+		: zero(0.f), compactHeader(NULL), decodedPoint(0.f), decodedSeparation(0.f)
 	{		
 		bool modify = false;
 		bool compressedModify = false;
+		bool compact = false;
 		bool response = false;
 		bool indices = false; 
 		
@@ -267,22 +320,32 @@ struct PxContactStreamIterator
 		if(patches)
 		{
 			modify = (patches->internalFlags & PxContactPatch::eMODIFIABLE) != 0;
-			compressedModify = (patches->internalFlags & PxContactPatch::eCOMPRESSED_MODIFIED_CONTACT) != 0;
+			// modified streams keep eMODIFIABLE, so the same bit tells the compact streams apart
+			compressedModify = modify && (patches->internalFlags & PxContactPatch::eCOMPRESSED_MODIFIED_CONTACT) != 0;
+			compact = !modify && (patches->internalFlags & PxContactPatch::eCOMPACT_CONTACT) != 0;
 			indices = (patches->internalFlags & PxContactPatch::eHAS_FACE_INDICES) != 0;
 
 			patch = patches;
 
-			contact = reinterpret_cast<const PxContact*>(contactPoints);
+			if(compact)
+			{
+				compactHeader = reinterpret_cast<const PxCompactContactHeader*>(contactPoints);
+				contact = reinterpret_cast<const PxContact*>(contactPoints + sizeof(PxCompactContactHeader));
+			}
+			else
+			{
+				contact = reinterpret_cast<const PxContact*>(contactPoints);
+			}
 
 			faceIndice = contactFaceIndices;
 
-			pointSize = compressedModify ?  sizeof(PxExtendedContact) : modify ? sizeof(PxModifiableContact) : sizeof(PxContact);
+			pointSize = compact ? sizeof(PxCompactContact) : compressedModify ?  sizeof(PxExtendedContact) : modify ? sizeof(PxModifiableContact) : sizeof(PxContact);
 
 			response = (patch->internalFlags & PxContactPatch::eFORCE_NO_RESPONSE) == 0;
 		}
 
 
-		mStreamFormat = compressedModify ? eCOMPRESSED_MODIFIABLE_STREAM : modify ? eMODIFIABLE_STREAM : eSIMPLE_STREAM;
+		mStreamFormat = compact ? eCOMPACT_STREAM : compressedModify ? eCOMPRESSED_MODIFIABLE_STREAM : modify ? eMODIFIABLE_STREAM : eSIMPLE_STREAM;
 		hasFaceIndices = PxU32(indices);
 		forceNoResponse = PxU32(!response);
 
@@ -360,6 +423,8 @@ struct PxContactStreamIterator
 		}
 		nextContactIndex++;
 		pointStepped = true;
+		if(mStreamFormat == eCOMPACT_STREAM)
+			decodeCompactContact();
 	}
 
 
@@ -414,7 +479,7 @@ struct PxContactStreamIterator
 	*/
 	PX_CUDA_CALLABLE PX_FORCE_INLINE PxReal getMaxImpulse() const
 	{
-		return mStreamFormat != eSIMPLE_STREAM ? getExtendedContact().maxImpulse : PX_MAX_REAL;
+		return hasExtendedContacts() ? getExtendedContact().maxImpulse : PX_MAX_REAL;
 	}
 
 	/**
@@ -423,7 +488,7 @@ struct PxContactStreamIterator
 	*/
 	PX_CUDA_CALLABLE PX_FORCE_INLINE const PxVec3& getTargetVel() const
 	{
-		return mStreamFormat != eSIMPLE_STREAM ? getExtendedContact().targetVelocity : zero;
+		return hasExtendedContacts() ? getExtendedContact().targetVelocity : zero;
 	}
 
 	/**
@@ -432,7 +497,7 @@ struct PxContactStreamIterator
 	*/
 	PX_CUDA_CALLABLE PX_FORCE_INLINE const PxVec3& getContactPoint() const
 	{
-		return contact->contact;
+		return mStreamFormat == eCOMPACT_STREAM ? decodedPoint : contact->contact;
 	}
 
 	/**
@@ -441,7 +506,7 @@ struct PxContactStreamIterator
 	*/
 	PX_CUDA_CALLABLE PX_FORCE_INLINE PxReal getSeparation() const
 	{
-		return contact->separation;
+		return mStreamFormat == eCOMPACT_STREAM ? decodedSeparation : contact->separation;
 	}
 
 	/**
@@ -542,6 +607,8 @@ struct PxContactStreamIterator
 				{
 					contact = reinterpret_cast<const PxContact*>(reinterpret_cast<const PxU8*>(contact) + contactPointSize * numToAdvance);
 					nextContactIndex += numToAdvance;
+					if(mStreamFormat == eCOMPACT_STREAM)
+						decodeCompactContact();
 					return true;
 				}
 				else
@@ -563,6 +630,19 @@ private:
 		return *static_cast<const PxContactPatch*>(patch);
 	}
 
+	PX_CUDA_CALLABLE PX_FORCE_INLINE bool hasExtendedContacts() const
+	{
+		return mStreamFormat == eMODIFIABLE_STREAM || mStreamFormat == eCOMPRESSED_MODIFIABLE_STREAM;
+	}
+
+	PX_CUDA_CALLABLE PX_FORCE_INLINE void decodeCompactContact()
+	{
+		const PxCompactContact& c = *reinterpret_cast<const PxCompactContact*>(contact);
+		const PxReal quantum = compactHeader->quantum;
+		decodedPoint = compactHeader->origin + PxVec3(PxReal(c.offset[0]), PxReal(c.offset[1]), PxReal(c.offset[2])) * quantum;
+		decodedSeparation = PxReal(c.separation) * quantum;
+	}
+
 	PX_CUDA_CALLABLE PX_FORCE_INLINE const PxExtendedContact& getExtendedContact() const
 	{
 		PX_ASSERT(mStreamFormat == eMODIFIABLE_STREAM || mStreamFormat == eCOMPRESSED_MODIFIABLE_STREAM);
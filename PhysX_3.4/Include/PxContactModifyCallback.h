@@ -431,7 +431,10 @@ public:
 	The number of contacts can not be changed, so you cannot add your own contacts.  You may however
 	disable contacts using PxContactSet::ignore().
 
-	@see PxContactModifyPair
+	\note This is called from the narrow phase tasks, once per batch of pairs. The calls are serialized unless the scene
+	was created with PxSceneFlag::eENABLE_PARALLEL_CONTACT_MODIFICATION, in which case they run concurrently.
+
+	@see PxContactModifyPair PxSceneFlag::eENABLE_PARALLEL_CONTACT_MODIFICATION
 	*/
 	virtual void onContactModify(PxContactModifyPair* const pairs, PxU32 count) = 0;
 
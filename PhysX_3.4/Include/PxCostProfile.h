@@ -0,0 +1,136 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_NX_COSTPROFILE
+#define PX_PHYSICS_NX_COSTPROFILE
+/** \addtogroup physics
+@{
+*/
+
+#include "PxPhysXConfig.h"
+#include "geometry/PxGeometry.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxActor;
+class PxShape;
+
+/**
+\brief Narrow phase time of a pair of shapes.
+
+@see PxCostProfile
+*/
+struct PxPairCost
+{
+	PxActor*	actor0;
+	PxActor*	actor1;
+	PxShape*	shape0;
+	PxShape*	shape1;
+	PxReal		time;				//!< Time spent generating the contacts of the pair, in microseconds
+};
+
+/**
+\brief Narrow phase time of an actor, summed over its pairs.
+
+The time of a pair goes to both of its actors, static ones included, so that a dense mesh touched by many bodies
+shows up as well as a body touching many shapes.
+
+@see PxCostProfile
+*/
+struct PxActorCost
+{
+	PxActor*	actor;
+	PxReal		time;				//!< Sum of the time of the pairs of the actor, in microseconds
+	PxU32		nbPairs;			//!< Number of pairs of the actor processed by the narrow phase
+};
+
+/**
+\brief Solver time of an island.
+
+Small islands are solved together by the same task chain until they reach PxSceneDesc::solverBatchSize bodies,
+in which case the time and the counts are those of the whole batch.
+
+@see PxCostProfile
+*/
+struct PxIslandCost
+{
+	PxActor*	actor;				//!< One of the bodies of the island, NULL for islands of articulations only
+	PxU32		nbIslands;			//!< Number of islands solved together
+	PxU32		nbBodies;
+	PxU32		nbArticulations;
+	PxU32		nbContactManagers;	//!< Pairs of shapes with contacts, or within their contact offsets
+	PxU32		nbConstraints;		//!< Joints and other constraints
+	PxReal		time;				//!< Wall clock time from the preparation of the constraints to the end of the integration, in microseconds
+};
+
+/**
+\brief Where the time of the last simulation step went, per pair, per actor and per island.
+
+The entries are sorted costliest first, there are at most as many as set with PxScene::setCostProfiling() per array.
+The buffers belong to the scene and stay valid until the next simulation step.
+
+Only the first discrete pass of each pair is accounted, the pairs of islands going to sleep during the step are not reported.
+
+@see PxScene::setCostProfiling PxScene::getCostProfile
+*/
+struct PxCostProfile
+{
+	const PxPairCost*	pairs;
+	PxU32				nbPairs;
+	const PxActorCost*	actors;
+	PxU32				nbActors;
+	const PxIslandCost*	islands;
+	PxU32				nbIslands;
+
+	PxReal				narrowPhaseTime;	//!< Sum of the time of every pair, in microseconds
+	PxReal				solverTime;			//!< Sum of the time of every island, in microseconds. The islands are solved in parallel
+
+	/**
+	\brief Narrow phase time per pair of geometry types in microseconds, indexed by the lowest type first.
+
+	E.g. the time of the convex-triangle mesh pairs is geometryPairTime[PxGeometryType::eCONVEXMESH][PxGeometryType::eTRIANGLEMESH].
+	*/
+	PxReal				geometryPairTime[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+
+	/**
+	\brief Number of pairs per pair of geometry types, indexed like geometryPairTime.
+	*/
+	PxU32				nbGeometryPairs[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+};
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
@@ -614,6 +614,35 @@ typedef PxFilterFlags (*PxSimulationFilterShader)
 	 PxFilterObjectAttributes attributes1, PxFilterData filterData1,
 	 PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize);
 
+/**
+\brief Filter method evaluating a batch of pairs, see #PxSimulationFilterShader.
+
+When a batch shader is set in #PxSceneDesc.filterBatchShader, the pairs found by the broadphase are passed to it in batches
+once the hardwired filter criteria (see #PxSimulationFilterShader) have been applied. This saves an indirect call per pair and
+lets the shader process several pairs at once.
+
+The batch shader has to give the same result as PxSceneDesc.filterShader for every pair, the per pair shader still
+runs for re-filtering, CCD passes and pairs involving particles or cloth.
+
+\param[in] nbPairs Number of pairs in the batch
+\param[in] attributes0 The filter attributes of the first object of each pair
+\param[in] filterData0 The custom filter data of the first object of each pair
+\param[in] attributes1 The filter attributes of the second object of each pair
+\param[in] filterData1 The custom filter data of the second object of each pair
+\param[out] pairFlags Pair flags of each pair, see #PxSimulationFilterShader
+\param[out] filterFlags Filter flags of each pair, see #PxSimulationFilterShader
+\param[in] constantBlock The constant global filter data (see #PxSceneDesc.filterShaderData)
+\param[in] constantBlockSize Size of the global filter data (see #PxSceneDesc.filterShaderDataSize)
+
+@see PxSimulationFilterShader PxSceneDesc.filterBatchShader PxDefaultSimulationFilterBatchShader
+*/
+
+typedef void (*PxSimulationFilterBatchShader)
+	(PxU32 nbPairs,
+	 const PxFilterObjectAttributes* attributes0, const PxFilterData* filterData0,
+	 const PxFilterObjectAttributes* attributes1, const PxFilterData* filterData1,
+	 PxPairFlags* pairFlags, PxFilterFlags* filterFlags, const void* constantBlock, PxU32 constantBlockSize);
+
 
 
 /**
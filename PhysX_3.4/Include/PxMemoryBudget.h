@@ -0,0 +1,113 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_NX_MEMORYBUDGET
+#define PX_PHYSICS_NX_MEMORYBUDGET
+/** \addtogroup physics
+@{
+*/
+
+#include "PxPhysXConfig.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxScene;
+
+/**
+\brief Subsystems the memory of a scene is accounted to, from the source file of each allocation.
+
+@see PxSceneMemoryUsage
+*/
+struct PxSceneMemoryCategory
+{
+	enum Enum
+	{
+		eBROADPHASE,		//!< Broadphase and AABB manager
+		eNARROWPHASE,		//!< Contact generation, pair caches and contact streams
+		eSOLVER,			//!< Islands, constraint preparation and solver
+		eSCENE_QUERY,		//!< Scene query pruning structures
+		eCLOTH,				//!< Cloth simulation
+		ePARTICLES,			//!< Particle simulation
+		eOTHER,				//!< Anything else allocated on behalf of the scene
+		eCOUNT
+	};
+};
+
+/**
+\brief Memory currently allocated on behalf of a scene.
+
+Allocations are attributed to a scene when they are made by its simulation tasks, or by the thread calling
+its simulate(), collide(), advance(), fetchCollision() and fetchResults() functions. Objects created through
+PxPhysics (actors, shapes, meshes...) are shared between scenes and not accounted.
+
+@see PxScene::getMemoryUsage
+*/
+struct PxSceneMemoryUsage
+{
+	PxU64	bytes[PxSceneMemoryCategory::eCOUNT];	//!< Bytes allocated per category
+	PxU64	total;									//!< Sum of the categories
+	PxU64	peak;									//!< Highest total since the scene was created
+	PxU32	nbAllocations;							//!< Number of live allocations
+};
+
+/**
+\brief Called when a scene goes over its memory budget.
+
+Calls are made from the thread calling fetchResults() (soft limit) or simulate()/collide() (hard limit),
+never from inside an allocation, so the callback can use the SDK. It must not release the scene.
+
+@see PxScene::setMemoryBudget
+*/
+class PxMemoryBudgetCallback
+{
+public:
+	/**
+	\brief Reports that the scene uses more than its budget.
+
+	\param[in] scene The scene over budget.
+	\param[in] usage Memory usage of the scene.
+	\param[in] budget The limit that was exceeded.
+	\param[in] hardLimit True if the hard limit was exceeded, in which case the scene won't simulate until its usage drops below it.
+	*/
+	virtual void onBudgetExceeded(PxScene& scene, const PxSceneMemoryUsage& usage, PxU64 budget, bool hardLimit) = 0;
+
+protected:
+	virtual ~PxMemoryBudgetCallback() {}
+};
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
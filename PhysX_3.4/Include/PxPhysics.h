@@ -65,6 +65,7 @@ class PxFoundation;
 class PxSerializationRegistry;
 
 class PxPruningStructure;
+class PxCpuDispatcher;
 
 /**
 \brief Abstract singleton factory class used for instancing objects in the Physics SDK.
@@ -219,6 +220,9 @@ public:
 
 	This can then be instanced into #PxShape objects.
 
+	\note If an identical convex mesh already exists (e.g. the same cooked data was loaded before), it is returned
+	with an extra reference instead of creating a copy. Each returned pointer must still be released once.
+
 	\param[in] stream The stream to load the convex mesh from.
 	\return The new convex mesh.
 
@@ -441,10 +445,11 @@ public:
 
 	\param[in] actors Array of actors to add to the pruning structure. Must be non NULL.
 	\param[in] nbActors Number of actors in the array. Must be >0.
+	\param[in] dispatcher If set, the trees of large structures are built in parallel with tasks on this dispatcher. The call still returns once they are done.
 	\return Pruning structure created from given actors, or NULL if any of the actors did not comply with the above requirements.
 	@see PxActor PxPruningStructure
 	*/
-	virtual PxPruningStructure*	createPruningStructure(PxRigidActor*const* actors, PxU32 nbActors)	= 0;
+	virtual PxPruningStructure*	createPruningStructure(PxRigidActor*const* actors, PxU32 nbActors, PxCpuDispatcher* dispatcher = NULL)	= 0;
 	
 	//@}
 	/** @name Shapes
@@ -525,6 +530,23 @@ public:
 	*/
 	virtual	PxU32				getShapes(PxShape** userBuffer, PxU32 bufferSize, PxU32 startIndex=0) const = 0;
 
+	/**
+	\brief Preallocates the memory of rigid actors and shapes that are about to be created.
+
+	The next nbRigidDynamics calls to createRigidDynamic(), nbRigidStatics calls to createRigidStatic() and nbShapes
+	shape creations then don't allocate memory. The objects are created from pools that keep a small cache per thread,
+	so creating them from several threads at once mostly doesn't contend on a lock, reserved or not.
+
+	The reserved memory is kept until the objects are created, and reused after they are released.
+
+	\param[in] nbRigidDynamics The number of dynamic rigid actors to reserve room for
+	\param[in] nbRigidStatics The number of static rigid actors to reserve room for
+	\param[in] nbShapes The number of shapes to reserve room for
+
+	@see createRigidDynamic() createRigidStatic() createShape()
+	*/
+	virtual	void				reserve(PxU32 nbRigidDynamics, PxU32 nbRigidStatics, PxU32 nbShapes) = 0;
+
 	//@}
 	/** @name Constraints and Articulations
 	*/
@@ -708,8 +730,9 @@ to save on code memory if your application does not use heightfields.  In this c
 the relevant implementation code from the library.  If you need to use heightfield but not some other optional
 component, you shoud call PxCreateBasePhysics() followed by this call.
 
-You must call this function at a time where no ::PxScene instance exists, typically before calling PxPhysics::createScene().
-This is to prevent a change to the heightfield implementation code at runtime which would have undefined results.
+You must call this function at a time where no ::PxHeightField instance exists if scenes were already created, typically
+before calling PxPhysics::createScene() or before creating the first heightfield. This is to prevent a change to the
+heightfield implementation code at runtime which would have undefined results.
 
 Calling PxCreateBasePhysics() and then attempting to create a heightfield shape without first calling 
 ::PxRegisterHeightFields(), ::PxRegisterUnifiedHeightFields() or ::PxRegisterLegacyHeightFields() will result in an error.
@@ -722,8 +745,9 @@ PX_C_EXPORT PX_PHYSX_CORE_API void PX_CALL_CONV PxRegisterHeightFields(physx::Px
 This call will link the default 'legacy' implementation of heightfields which uses a special purpose collison code
 path distinct from triangle meshes.
 
-You must call this function at a time where no ::PxScene instance exists, typically before calling PxPhysics::createScene().
-This is to prevent a change to the heightfield implementation code at runtime which would have undefined results.
+You must call this function at a time where no ::PxHeightField instance exists if scenes were already created, typically
+before calling PxPhysics::createScene() or before creating the first heightfield. This is to prevent a change to the
+heightfield implementation code at runtime which would have undefined results.
 
 Calling PxCreateBasePhysics() and then attempting to create a heightfield shape without first calling
 ::PxRegisterHeightFields(), ::PxRegisterLegacyHeightFields() or ::PxRegisterUnifiedHeightFields() will result in an error.
@@ -761,6 +785,9 @@ to save on code memory if your application does not use particles.  In this case
 the relevant implementation code from the library.  If you need to use particles but not some other optional
 component, you shoud call PxCreateBasePhysics() followed by this call.
 
+This function can also be called after scenes were created. A scene creates its particle context when its first
+particle system is added, so scenes without particles don't pay for it either way.
+
 \deprecated The PhysX particle feature has been deprecated in PhysX version 3.4
 */
 PX_DEPRECATED PX_C_EXPORT PX_PHYSX_CORE_API void PX_CALL_CONV PxRegisterParticles(physx::PxPhysics& physics);
@@ -780,6 +807,7 @@ has been created already will result in an error message and NULL will be return
 			so a debugger connection partway through your physics simulation will get
 			an accurate map of everything that has been allocated so far.  This could have a memory
 			and performance impact on your simulation hence it defaults to off.
+			It also enables the per scene memory accounting, see PxScene::getMemoryUsage().
 \param pvd When pvd points to a valid PxPvd instance (PhysX Visual Debugger), a connection to the specified PxPvd instance is created.
 			If pvd is NULL no connection will be attempted.
 \return PxPhysics instance on success, NULL if operation failed
@@ -813,6 +841,7 @@ with a call to ::PxRegisterUnifiedHeightFields().
 			so a debugger connection partway through your physics simulation will get
 			an accurate map of everything that has been allocated so far.  This could have a memory
 			and performance impact on your simulation hence it defaults to off.
+			It also enables the per scene memory accounting, see PxScene::getMemoryUsage().
 \param pvd When pvd points to a valid PxPvd instance (PhysX Visual Debugger), a connection to the specified PxPvd instance is created.
 			If pvd is NULL no connection will be attempted.
 \return PxPhysics instance on success, NULL if operation failed
@@ -44,6 +44,8 @@ Alternatively, one can instead directly #include a subset of the below files.
 // Foundation SDK 
 #include "foundation/Px.h"
 #include "foundation/PxAllocatorCallback.h"
+#include "foundation/PxAllocationProfiler.h"
+#include "foundation/PxHugePageAllocator.h"
 #include "foundation/PxAssert.h"
 #include "foundation/PxBitAndData.h"
 #include "foundation/PxBounds3.h"
@@ -132,6 +134,8 @@ Alternatively, one can instead directly #include a subset of the below files.
 #include "PxForceMode.h"
 #include "PxLockedData.h"
 #include "PxMaterial.h"
+#include "PxMemoryBudget.h"
+#include "PxCostProfile.h"
 #include "PxPhysics.h"
 #include "PxPhysicsVersion.h"
 #include "PxPhysXConfig.h"
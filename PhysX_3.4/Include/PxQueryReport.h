@@ -206,6 +206,20 @@ struct PxSweepHit : public PxLocationHit
 };
 
 
+/**
+\brief Stores results of nearest shape queries.
+
+@see PxScene.nearest
+*/
+struct PxNearestHit : public PxActorShape
+{
+	PX_INLINE			PxNearestHit() : position(PxVec3(0)), distance(PX_MAX_REAL)	{}
+
+	PxVec3				position;	//!< Closest point of the shape, the query point for a point inside a solid shape
+	PxReal				distance;	//!< Distance from the query point to the shape, 0 inside a solid shape
+};
+
+
 /**
 \brief Describes query behavior after returning a partial query result via a callback.
 
@@ -384,6 +398,56 @@ struct PxSweepBufferN : public PxHitBuffer<PxSweepHit>
 	PxSweepBufferN() : PxHitBuffer<PxSweepHit>(hits, N) {}
 };
 
+/**
+\brief	Streams touching hits to a user function in blocks of N, using a fixed size array embedded in the class.
+
+Every time the block is full the function receives it, and the query carries on writing the next hits in the same block.
+The last partial block is reported before the query returns. Returning false from the function stops the query.
+The number of hits a query can report is then not limited by the buffer size, which suits overlaps touching thousands of shapes.
+
+\note	For raycasts and sweeps, the first full block triggers a second query for the closest blocking hit, as described for
+PxHitCallback::processTouches. Overlaps don't have this cost.
+\note	The hits of a block are only valid during the call, the block is reused for the next hits.
+
+@see PxHitCallback PxOverlapStreamN
+*/
+template <typename HitType, int N>
+struct PxHitStreamN : public PxHitCallback<HitType>
+{
+	/**
+	\brief	Receives a block of touching hits.
+
+	\param[in]	hits		The touching hits of the block.
+	\param[in]	nbHits		Number of hits in the block, at most N.
+	\param[in]	userData	The user data given to the constructor.
+
+	\return	true to continue the query, false to stop it.
+	*/
+	typedef PxAgain (*StreamFunction)(const HitType* hits, PxU32 nbHits, void* userData);
+
+	HitType			hits[N];
+	StreamFunction	function;
+	void*			userData;
+	PxU32			nbStreamed;	//!< Number of touching hits passed to the function so far
+
+	PxHitStreamN(StreamFunction aFunction, void* aUserData = NULL) :
+		PxHitCallback<HitType>(hits, N), function(aFunction), userData(aUserData), nbStreamed(0) {}
+
+	virtual PxAgain processTouches(const HitType* buffer, PxU32 nbHits)
+	{
+		nbStreamed += nbHits;
+		return function(buffer, nbHits, userData);
+	}
+};
+
+/** \brief	Streams touching overlap hits to a user function in blocks of N. */
+template <int N>
+struct PxOverlapStreamN : public PxHitStreamN<PxOverlapHit, N>
+{
+	PxOverlapStreamN(typename PxHitStreamN<PxOverlapHit, N>::StreamFunction aFunction, void* aUserData = NULL) :
+		PxHitStreamN<PxOverlapHit, N>(aFunction, aUserData) {}
+};
+
 #if !PX_DOXYGEN
 } // namespace physx
 #endif
@@ -226,6 +226,37 @@ public:
 	virtual void				detachShape(PxShape& shape, bool wakeOnLostTouch = true) = 0;
 
 
+	/** attach several shared shapes to an actor
+
+	Same as calling attachShape() for each shape, but the scene query structures are updated once for all the shapes,
+	which is faster for compounds rebuilt at runtime. If one of the shapes can't be attached, none is.
+
+	<b>Sleeping:</b> Does <b>NOT</b> wake the actor up automatically.
+
+	\param[in] shapes		the shapes to attach.
+	\param[in] nbShapes	the number of shapes.
+
+	@see attachShape()
+	*/
+	virtual void				attachShapes(PxShape*const* shapes, PxU32 nbShapes) = 0;
+
+
+	/** detach several shapes from an actor
+
+	Same as calling detachShape() for each shape, but the scene query structures are updated once for all the shapes.
+	Shapes not attached to this actor cause an error and are skipped.
+
+	<b>Sleeping:</b> Does <b>NOT</b> wake the actor up automatically.
+
+	\param[in] shapes		the shapes to detach.
+	\param[in] nbShapes	the number of shapes.
+	\param[in] wakeOnLostTouch Specifies whether touching objects from the previous frame should get woken up in the next frame.
+
+	@see detachShape()
+	*/
+	virtual void				detachShapes(PxShape*const* shapes, PxU32 nbShapes, bool wakeOnLostTouch = true) = 0;
+
+
 	/**
 	\brief Returns the number of shapes assigned to the actor.
 
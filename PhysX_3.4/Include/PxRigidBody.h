@@ -125,6 +125,16 @@ struct PxRigidBodyFlag
 
 		/**
 		\brief Register a rigid body to dynamicly adjust contact offset based on velocity. This can be used to achieve a CCD effect.
+
+		Before the narrow phase the contact distance of the body's shapes is raised by the distance the body covers
+		in a step at its current linear and angular velocity. The contacts found ahead of the body are given to the solver,
+		which only lets the body close the gap. This runs in the regular contact generation, so it neither needs
+		PxSceneFlag::eENABLE_CCD nor the sweep passes, and is much cheaper than eENABLE_CCD with many fast bodies.
+
+		\note The inflated contact distance can create contacts with surfaces the body is moving away from (ghost collisions),
+		in particular for fast spinning bodies. PxSceneDesc::ccdMaxSeparation controls how these contacts are resolved.
+
+		@see eENABLE_CCD PxSceneDesc::ccdMaxSeparation
 		*/
 		eENABLE_SPECULATIVE_CCD 			= (1 << 5),
 
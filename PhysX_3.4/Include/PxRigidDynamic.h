@@ -110,6 +110,10 @@ public:
 
 	<b>Sleeping:</b> This call wakes the actor if it is sleeping and will set the wake counter to #PxSceneDesc::wakeCounterResetValue.
 
+	\note A destination equal to the current pose is ignored if no other target is pending, as it would not move the actor.
+	The call then doesn't wake the actor, so a kinematic kept in place this way can fall asleep, along with the objects resting
+	on it, and its bounds are not updated.
+
 	\param[in] destination The desired pose for the kinematic actor, in the global frame. <b>Range:</b> rigid body transform.
 
 	@see getKinematicTarget() PxRigidBodyFlag setRigidBodyFlag()
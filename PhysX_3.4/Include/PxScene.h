@@ -37,6 +37,8 @@
 #include "PxVisualizationParameter.h"
 #include "PxSceneDesc.h"
 #include "PxSimulationStatistics.h"
+#include "PxMemoryBudget.h"
+#include "PxCostProfile.h"
 #include "PxQueryReport.h"
 #include "PxQueryFiltering.h"
 #include "PxClient.h"
@@ -165,6 +167,115 @@ struct PxActorTypeFlag
 typedef PxFlags<PxActorTypeFlag::Enum,PxU16> PxActorTypeFlags;
 PX_FLAGS_OPERATORS(PxActorTypeFlag::Enum,PxU16)
 
+/**
+\brief Coherence cache for a stream of related raycasts or sweeps, such as the probes of one AI agent, wheel or camera.
+
+It remembers the shapes that gave the last blocking hits of the stream, most recent first. When passed to a query through
+PxQueryCache::coherence, these shapes are tested before the scene is traversed: a hit on one of them shrinks the query distance,
+so the traversal culls everything farther away, and ends an eANY_HIT query right away. The blocking hit of the query is then
+recorded in the cache.
+
+\note Like the single hit cache, it is only used for queries without a touch buffer (nearest blocking hit and eANY_HIT queries).
+Overlaps do not use it.
+\note Unlike the single hit cache, the cached shapes go through the regular filtering, so one cache can be shared by queries with
+different filters.
+\note Shapes that are not scene query shapes of the queried scene (anymore) are skipped. It is still the user's responsibility to
+call invalidate() or reset() before releasing a cached shape or actor.
+\note The cache is modified by the queries it is passed to, so it must not be used by several queries at the same time.
+
+@see PxQueryCache
+*/
+class PxQueryCoherenceCache
+{
+public:
+	enum
+	{
+		eMAX_ENTRIES = 8	//!< Maximum number of shapes remembered
+	};
+
+	/**
+	\brief Creates an empty cache remembering up to capacity shapes (clamped to eMAX_ENTRIES).
+	*/
+	PX_INLINE PxQueryCoherenceCache(PxU32 capacity = eMAX_ENTRIES) : mCapacity(capacity < PxU32(eMAX_ENTRIES) ? capacity : PxU32(eMAX_ENTRIES)), mNbEntries(0) {}
+
+	/**
+	\brief Forgets every shape.
+	*/
+	PX_INLINE void reset() { mNbEntries = 0; }
+
+	/**
+	\brief Forgets the shapes of an actor, to be called before it is released or removed from its scene.
+	*/
+	PX_INLINE void invalidate(const PxRigidActor* actor)
+	{
+		PxU32 nb = 0;
+		for(PxU32 i=0; i<mNbEntries; i++)
+		{
+			if(mActors[i] != actor)
+			{
+				mShapes[nb] = mShapes[i];
+				mActors[nb] = mActors[i];
+				nb++;
+			}
+		}
+		mNbEntries = nb;
+	}
+
+	/**
+	\brief Forgets a shape, to be called before it is released or detached from its actor.
+	*/
+	PX_INLINE void invalidate(const PxShape* shape)
+	{
+		PxU32 nb = 0;
+		for(PxU32 i=0; i<mNbEntries; i++)
+		{
+			if(mShapes[i] != shape)
+			{
+				mShapes[nb] = mShapes[i];
+				mActors[nb] = mActors[i];
+				nb++;
+			}
+		}
+		mNbEntries = nb;
+	}
+
+	/**
+	\brief Makes a shape the most recent entry, dropping the oldest one if the cache is full. Called by the queries with their blocking hit.
+	*/
+	PX_INLINE void record(PxShape* shape, PxRigidActor* actor)
+	{
+		if(!mCapacity)
+			return;
+
+		PxU32 i = 0;
+		while(i < mNbEntries && mShapes[i] != shape)
+			i++;
+		if(i == mNbEntries)
+		{
+			if(mNbEntries < mCapacity)
+				mNbEntries++;
+			i = mNbEntries - 1;
+		}
+		for(; i>0; i--)
+		{
+			mShapes[i] = mShapes[i-1];
+			mActors[i] = mActors[i-1];
+		}
+		mShapes[0] = shape;
+		mActors[0] = actor;
+	}
+
+	PX_INLINE PxU32			getNbEntries()		const	{ return mNbEntries;	}
+	PX_INLINE PxShape*		getShape(PxU32 i)	const	{ PX_ASSERT(i < mNbEntries); return mShapes[i];	}
+	PX_INLINE PxRigidActor*	getActor(PxU32 i)	const	{ PX_ASSERT(i < mNbEntries); return mActors[i];	}
+
+private:
+	PxShape*		mShapes[eMAX_ENTRIES];
+	PxRigidActor*	mActors[eMAX_ENTRIES];
+	PxU32			mCapacity;
+	PxU32			mNbEntries;
+};
+
 /**
 \brief single hit cache for scene queries.
 
@@ -181,23 +292,32 @@ when deleting shapes to invalidate cached references.
 
 The faceIndex field is an additional hint for a mesh or height field which is not currently used.
 
-@see PxScene.raycast
+The coherence field optionally points to a PxQueryCoherenceCache, tested after the cached shape (which can then be NULL) and
+updated by the query.
+
+@see PxScene.raycast PxQueryCoherenceCache
 */
 struct PxQueryCache
 {
 	/**
 	\brief constructor sets to default 
 	*/
-	PX_INLINE PxQueryCache() : shape(NULL), actor(NULL), faceIndex(0xffffffff) {}
+	PX_INLINE PxQueryCache() : shape(NULL), actor(NULL), faceIndex(0xffffffff), coherence(NULL) {}
 
 	/**
 	\brief constructor to set properties
 	*/
-	PX_INLINE PxQueryCache(PxShape* s, PxU32 findex) : shape(s), actor(NULL), faceIndex(findex) {}
+	PX_INLINE PxQueryCache(PxShape* s, PxU32 findex) : shape(s), actor(NULL), faceIndex(findex), coherence(NULL) {}
 
-	PxShape*		shape;			//!< Shape to test for intersection first
-	PxRigidActor*	actor;			//!< Actor to which the shape belongs
-	PxU32			faceIndex;		//!< Triangle index to test first - NOT CURRENTLY SUPPORTED
+	/**
+	\brief constructor for a cache that only uses a coherence cache
+	*/
+	PX_INLINE explicit PxQueryCache(PxQueryCoherenceCache* c) : shape(NULL), actor(NULL), faceIndex(0xffffffff), coherence(c) {}
+
+	PxShape*				shape;			//!< Shape to test for intersection first
+	PxRigidActor*			actor;			//!< Actor to which the shape belongs
+	PxU32					faceIndex;		//!< Triangle index to test first - NOT CURRENTLY SUPPORTED
+	PxQueryCoherenceCache*	coherence;		//!< Shapes of the previous queries of the stream to test next, updated by the query (optional)
 };
 
 /** 
@@ -237,6 +357,22 @@ class PxScene
 	*/
 	virtual		void			release() = 0;
 
+	/**
+	\brief Removes everything from the scene, so that it can be reused instead of being released and created again.
+
+	Removes the aggregates, articulations, actors, particle systems and cloths of the scene, along with the constraints
+	attached to them. The objects are not released, that is left to the user.
+
+	The scene keeps its settings and the capacity of its internal pools and structures (broad phase, scene query
+	pruners, islands, contact and constraint memory), so filling it again for the next round allocates little or
+	nothing, unlike createScene().
+
+	\note Not allowed while the scene is simulating (in between simulate() and fetchResults() calls).
+
+	@see release() removeActors()
+	*/
+	virtual		void			reset() = 0;
+
 	/**
 	\brief Sets a scene flag. You can only set one flag at a time.
 
@@ -416,6 +552,56 @@ class PxScene
 	*/
 	virtual	void				removeActors(PxActor*const* actors, PxU32 nbActors, bool wakeOnLostTouch = true) = 0;
 
+	/**
+	\brief Sets the global poses of dynamic actors.
+
+	Same as calling #PxRigidDynamic::setGlobalPose() for each actor, but the write check is done once for the whole array.
+	While the simulation is running, the actors are collected in a flat list instead of the set of buffered objects,
+	and the list is flushed in a single pass by #fetchResults(). Meant for applying many updates per frame, from network replication for example.
+
+	\note If some actor is not part of this scene (see #PxActor::getScene), the remaining entries are ignored and an error is issued.
+
+	\param[in] actors Array of actors.
+	\param[in] poses Array of new actor poses, one per actor.
+	\param[in] count Number of entries in the arrays.
+	\param[in] autowake Whether to wake the actors up if they are asleep, see #PxRigidDynamic::setGlobalPose().
+
+	@see PxRigidDynamic::setGlobalPose() setKinematicTargets() setLinearVelocities()
+	*/
+	virtual	void				setGlobalPoses(PxRigidDynamic*const* actors, const PxTransform* poses, PxU32 count, bool autowake = true) = 0;
+
+	/**
+	\brief Sets the kinematic targets of kinematic actors.
+
+	Same as calling #PxRigidDynamic::setKinematicTarget() for each actor, see #setGlobalPoses() for the buffering. As there,
+	actors whose destination is their current pose are skipped, so animated props can be driven every frame at no cost while idle.
+
+	\note If some actor is not part of this scene (see #PxActor::getScene), the remaining entries are ignored and an error is issued.
+
+	\param[in] actors Array of kinematic actors.
+	\param[in] destinations Array of kinematic targets, one per actor, in the global frame.
+	\param[in] count Number of entries in the arrays.
+
+	@see PxRigidDynamic::setKinematicTarget() setGlobalPoses()
+	*/
+	virtual	void				setKinematicTargets(PxRigidDynamic*const* actors, const PxTransform* destinations, PxU32 count) = 0;
+
+	/**
+	\brief Sets the linear velocities of dynamic actors.
+
+	Same as calling #PxRigidDynamic::setLinearVelocity() for each actor, see #setGlobalPoses() for the buffering.
+
+	\note If some actor is not part of this scene (see #PxActor::getScene), the remaining entries are ignored and an error is issued.
+
+	\param[in] actors Array of non kinematic actors.
+	\param[in] velocities Array of linear velocities, one per actor.
+	\param[in] count Number of entries in the arrays.
+	\param[in] autowake Whether to wake the actors up if they are asleep, see #PxRigidDynamic::setLinearVelocity().
+
+	@see PxRigidDynamic::setLinearVelocity() setGlobalPoses()
+	*/
+	virtual	void				setLinearVelocities(PxRigidDynamic*const* actors, const PxVec3* velocities, PxU32 count, bool autowake = true) = 0;
+
 	/**
 	\brief Adds an aggregate to this scene.
 	
@@ -457,6 +643,28 @@ class PxScene
 	@see PxCollection, PxConstraint::isValid()
 	*/
 	virtual	void				addCollection(const PxCollection& collection) = 0;
+
+	/**
+	\brief Adds part of the objects of a collection to this scene, to spread the insertion of a big collection across frames.
+
+	Processes the objects of the collection from startIndex, like addCollection, and stops before the number of inserted actors
+	exceeds maxActors. The returned index is passed as startIndex to the next call, the collection is fully added once it
+	returns PxCollection::getNbObjects. The budget counts the actors of aggregates, articulations and pruning structures,
+	which are inserted whole, and at least one object is processed by each call.
+
+	The collection must not be modified between the calls.
+
+	\note If the processed objects contain an actor with an invalid constraint, in checked builds they are ignored,
+	an error is issued and PxCollection::getNbObjects is returned.
+
+	\param[in] collection Objects to add to this scene. See #PxCollection
+	\param[in] startIndex Index of the first object of the collection to process
+	\param[in] maxActors Maximum number of actors to insert in this call
+	\return The index of the first object left for the next call
+
+	@see PxCollection, PxConstraint::isValid()
+	*/
+	virtual	PxU32				addCollection(const PxCollection& collection, PxU32 startIndex, PxU32 maxActors) = 0;
 	//@}
 	/************************************************************************************************/
 
@@ -954,6 +1162,14 @@ class PxScene
 	virtual	PxSimulationFilterShader
 								getFilterShader() const = 0;
 
+	/**
+	\brief Gets the batched collision filter shader in use for this scene, NULL if the pairs are filtered one at a time.
+
+	@see PxSceneDesc.filterBatchShader PxSimulationFilterBatchShader
+	*/
+	virtual	PxSimulationFilterBatchShader
+								getFilterBatchShader() const = 0;
+
 	/**
 	\brief Gets the custom collision filter callback in use for this scene.
 
@@ -1328,6 +1544,67 @@ class PxScene
 	@see PxSimulationStatistics
 	*/
 	virtual	void				getSimulationStatistics(PxSimulationStatistics& stats) const = 0;
+
+	/**
+	\brief Retrieves the memory currently allocated on behalf of the scene, per subsystem.
+
+	Memory accounting is enabled by the trackOutstandingAllocations argument of PxCreatePhysics. It can be polled at any time,
+	while the simulation runs the values are approximate.
+
+	\param[out] usage Receives the memory usage.
+	\return False if memory accounting is disabled, in which case usage is zeroed.
+
+	@see PxSceneMemoryUsage setMemoryBudget
+	*/
+	virtual	bool				getMemoryUsage(PxSceneMemoryUsage& usage) const = 0;
+
+	/**
+	\brief Sets the memory budget of the scene. Requires memory accounting, see getMemoryUsage().
+
+	When the usage is over the soft limit at the end of fetchResults(), the callback is notified, once until the usage drops back below.
+	When it is over the hard limit at the start of simulate() or collide(), the callback is notified and the step
+	is not started, which is reported as a PxErrorCode::eOUT_OF_MEMORY error, so that a runaway scene stops growing.
+
+	\param[in] softLimit Soft limit in bytes, 0 to disable.
+	\param[in] hardLimit Hard limit in bytes, 0 to disable.
+	\param[in] callback Callback notified when a limit is exceeded, can be NULL.
+
+	@see PxMemoryBudgetCallback getMemoryUsage
+	*/
+	virtual	void				setMemoryBudget(PxU64 softLimit, PxU64 hardLimit, PxMemoryBudgetCallback* callback) = 0;
+
+	/**
+	\brief Enables the cost profiling of the simulation steps, see getCostProfile().
+
+	While it is enabled, every pair of the narrow phase and every island task chain of the solver is timed,
+	which adds a couple of timer reads per pair, and the costliest entries are gathered at the end of the step.
+
+	\note Do not use this method while the simulation is running.
+
+	\param[in] maxEntries Max number of pairs, actors and islands reported per step, 0 disables the profiling.
+
+	@see getCostProfile PxCostProfile
+	*/
+	virtual	void				setCostProfiling(PxU32 maxEntries) = 0;
+
+	/**
+	\brief Returns the max number of entries reported by the cost profiling, 0 when it is disabled.
+
+	@see setCostProfiling
+	*/
+	virtual	PxU32				getCostProfiling() const = 0;
+
+	/**
+	\brief Retrieves the costliest pairs, actors and islands of the last simulation step.
+
+	\note Do not use this method while the simulation is running.
+
+	\param[out] profile Receives the costs, the buffers stay valid until the next simulation step.
+	\return False if the cost profiling is disabled, in which case the profile is empty.
+
+	@see setCostProfiling PxCostProfile
+	*/
+	virtual	bool				getCostProfile(PxCostProfile& profile) const = 0;
 	
 	
 	//@}
@@ -1414,6 +1691,8 @@ class PxScene
 	\param[in] rebuildStaticStructure	True to rebuild the dynamic tree containing static objects
 	\param[in] rebuildDynamicStructure	True to rebuild the dynamic tree containing dynamic objects
 
+	\note Incremental trees (PxPruningStructureType::eINCREMENTAL_AABB_TREE) are rebuilt from scratch as well, which restores their quality.
+
 	@see PxSceneDesc.dynamicTreeRebuildRateHint setDynamicTreeRebuildRateHint() getDynamicTreeRebuildRateHint()
 	*/
 	virtual void				forceDynamicTreeRebuild(bool rebuildStaticStructure, bool rebuildDynamicStructure)	= 0;
@@ -1564,6 +1843,32 @@ class PxScene
 									) const = 0;
 
 
+	/**
+	\brief Finds the k shapes closest to a point, within a maximum distance.
+
+	The scene query structures are searched closest bounds first. Once k shapes are found the search radius shrinks to the distance
+	of the k-th closest one, so only the shapes whose bounds are closer get their exact distance computed.
+
+	Spheres, capsules, boxes, convex meshes and planes are solid: the distance is 0 for a point inside them, as for #PxGeometryQuery::pointDistance().
+	Triangle meshes and height fields are surfaces, the distance is to their closest triangle.
+
+	\param[in] point		Query point.
+	\param[in] maxDist		Maximum distance of the returned shapes. Has to be in the [0, inf) range.
+	\param[in] k			Maximum number of shapes to return, the size of the hits buffer.
+	\param[out] hits		Closest shapes, sorted by increasing distance.
+	\param[in] filterData	Filtering data and simple logic. See #PxQueryFilterData
+	\param[in] filterCall	Custom filtering logic (optional). Only the pre-filter is called, if PxQueryFlag::ePREFILTER is set. Shapes for which it returns eNONE are skipped.
+
+	\return Number of hits written to the buffer, at most k.
+
+	\note Touching and blocking shapes are returned alike, the flags eANY_HIT, eNO_BLOCK and ePOSTFILTER are ignored.
+
+	@see PxNearestHit PxQueryFilterData PxQueryFilterCallback PxGeometryQuery::pointDistance
+	*/
+	virtual PxU32				nearest(const PxVec3& point, PxReal maxDist, PxU32 k, PxNearestHit* hits,
+									const PxQueryFilterData& filterData = PxQueryFilterData(), PxQueryFilterCallback* filterCall = NULL) const = 0;
+
+
 	/**
 	\brief Retrieves the scene's internal scene query timestamp, increased each time a change to the
 	static scene query structure is performed.
@@ -1643,6 +1948,37 @@ class PxScene
 	*/
 	virtual	bool					removeBroadPhaseRegion(PxU32 handle)				= 0;
 
+	/**
+	\brief Lets the broad-phase manage its regions, splitting and merging them based on object density.
+
+	Only supported by PxBroadPhaseType::eMBP. The layout is built during the next simulation step: it starts with a single
+	region covering the whole space, which replaces the existing regions. While the mode is enabled, addBroadPhaseRegion and
+	removeBroadPhaseRegion fail. Disabling it keeps the current regions, which can then be managed by hand.
+
+	\param[in]	desc	Adaptive region settings, or NULL to disable the mode
+	\return True if success, false if the broad-phase doesn't support it or the settings are invalid
+
+	@see PxBroadPhaseAdaptiveRegionsDesc
+	*/
+	virtual	bool					setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)	= 0;
+
+	/**
+	\brief Retrieves the trigger pairs created and lost by the broad-phase during the last simulation step.
+
+	These are the overlaps between trigger shapes (PxShapeFlag::eTRIGGER_SHAPE) and other objects, as found by the broad-phase,
+	i.e. between bounds, before the filter shader and the trigger reports. The views point to the broad-phase's internal arrays,
+	they can be read without copy between fetchResults() and the next simulate() call.
+
+	\note With CCD enabled, each CCD pass runs its own broad-phase update and only the pairs of the last one are reported.
+
+	\param[out]	createdPairs	Pairs that started overlapping
+	\param[out]	lostPairs		Pairs that stopped overlapping
+	\return False if the simulation is running, in which case the views are empty
+
+	@see PxBroadPhasePairView
+	*/
+	virtual	bool					getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs)	const	= 0;
+
 	//@}
 
 	/************************************************************************************************/
@@ -1730,6 +2066,11 @@ class PxScene
 	This call will force allocation of cache blocks if the numBlocks parameter is greater than the currently allocated number
 	of blocks, and less than the max16KContactDataBlocks parameter specified at scene creation time.
 
+	Blocks allocated during the simulation beyond this number are kept while they are needed and given back to the allocator
+	a few at a time once the usage decreases, over a few seconds at 60Hz. The numBlocks blocks themselves are kept until
+	flushSimulation(). Setting it to the peak returned by getMaxNbContactDataBlocksUsed() prewarms the scene, so that the
+	frames with many contacts do not go through the allocator.
+
 	\param[in] numBlocks The number of blocks to allocate.	
 
 	@see PxSceneDesc.nbContactDataBlocks PxSceneDesc.maxNbContactDataBlocks flushSimulation() getNbContactDataBlocksUsed getMaxNbContactDataBlocksUsed
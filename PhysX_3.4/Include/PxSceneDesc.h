@@ -63,6 +63,20 @@ dynamic AABB tree, without the per-frame overhead. This can be a good choice for
 objects, if no static objects are added, moved or removed after the scene has been
 created. If there is no such guarantee (e.g. when streaming parts of the world in and out),
 then the dynamic version is a better choice even for static objects.
+
+eINCREMENTAL_AABB_TREE keeps a single AABB tree that is updated in place. Added objects are
+inserted right away, moved objects refit their leaf or get reinserted, and the tree is rebalanced
+with local rotations instead of being rebuilt. There is no rebuild spread over the frames, so the
+query cost stays predictable when objects are continuously added or removed, at the cost of a
+slightly lower tree quality than a freshly rebuilt eDYNAMIC_AABB_TREE.
+#PxSceneDesc::dynamicTreeRebuildRateHint is not used.
+
+eHASH_GRID puts the objects in the cells of a hashed loose grid, by the center of their bounds.
+Moving an object is a constant time operation and there is no tree to maintain, which suits
+many moving objects of similar sizes spread evenly, such as crowds of agents. The cell size is
+derived from the average object size. Queries covering a large part of the scene, long rays and
+scenes with very different object sizes are faster with the trees.
+#PxSceneDesc::dynamicTreeRebuildRateHint is not used.
 */
 struct PxPruningStructureType
 {
@@ -71,6 +85,8 @@ struct PxPruningStructureType
 		eNONE,					//!< Using a simple data structure
 		eDYNAMIC_AABB_TREE,		//!< Using a dynamic AABB tree
 		eSTATIC_AABB_TREE,		//!< Using a static AABB tree
+		eINCREMENTAL_AABB_TREE,	//!< Using an AABB tree updated incrementally, without rebuilds
+		eHASH_GRID,				//!< Using a hashed loose grid
 
 		eLAST
 	};
@@ -372,6 +388,10 @@ struct PxSceneFlag
 		with the existing actors in the scene. Determinism is only guaranteed if the actors are inserted in a consistent order each run in a newly-created scene and simulated using a consistent time-stepping
 		scheme.
 
+		The results also don't depend on the number of worker threads of the CPU dispatcher or on the task scheduling. The
+		broadphase pair deltas are sorted by bounds index before the interactions are created or destroyed, and the trigger pairs
+		are processed in sequence so their reports keep the same order.
+
 		Note that this flag is not mutable and must be set at scene creation.
 
 		Note that enabling this flag can have a negative impact on performance.
@@ -382,6 +402,172 @@ struct PxSceneFlag
 		*/
 		eENABLE_ENHANCED_DETERMINISM = (1<<20),
 
+		/**
+		\brief Keeps the static shapes out of the SAP or MBP broadphase.
+
+		Static shapes are stored in a separate AABB tree that is only rebuilt after enough of them have been added, moved
+		or removed. Pairs between dynamic and static shapes come from tree queries with the bounds of the shapes that moved,
+		so the broadphase cost depends on the number of moving shapes instead of the size of the world.
+
+		This is best for scenes with many static shapes and a lot fewer dynamic ones. Static shapes are never reported
+		out-of-bounds by MBP.
+
+		Note that this flag is not mutable and must be set at scene creation.
+
+		Note that this feature is not supported with PxBroadPhaseType::eGPU.
+
+		<b>Default</b> false
+
+		@see PxBroadPhaseType
+		*/
+		eENABLE_STATIC_BROADPHASE_TREE = (1<<21),
+
+		/**
+		\brief Widens the PCM contact reuse thresholds for slow moving and resting pairs.
+
+		Persistent contact manifolds are only regenerated when the relative transform of a pair moved more than a threshold
+		since the last full contact generation. With this flag, the thresholds are scaled up for pairs whose bodies all have a
+		kinetic energy below a few times their sleep threshold, so resting stacks reuse their manifolds instead of running GJK/EPA
+		every frame. Contacts of these pairs can lag a bit more behind the shapes before they are refreshed.
+
+		The effect can be checked with the manifold counters of PxSimulationStatistics.
+
+		Note that this flag is not mutable and must be set at scene creation. It is only used with eENABLE_PCM.
+
+		<b>Default</b> false
+
+		@see eENABLE_PCM PxSimulationStatistics::ePCM_MANIFOLD_HITS
+		*/
+		eENABLE_ADAPTIVE_PCM_THRESHOLDS = (1<<22),
+
+		/**
+		\brief Stores the contact points with 16 bit fixed point positions and separations.
+
+		The points of non-modifiable contact streams with at least 3 points are stored relative to the center of the stream
+		as PxCompactContact, which halves their size. The quantization step is computed for each stream from the extents of its
+		points (and separations), so the error stays below 1/65534 of these extents. The points are decoded by
+		PxContactStreamIterator, so the solver and the contact reports don't see the difference apart from this error.
+
+		Note that this flag is not mutable and must be set at scene creation. It isn't used by the GPU pipeline.
+
+		<b>Default</b> false
+
+		@see PxCompactContact PxContactStreamIterator
+		*/
+		eENABLE_COMPACT_CONTACTS = (1<<23),
+
+		/**
+		\brief Partitions the constraints by graph coloring.
+
+		The constraints between dynamic bodies are assigned to the solver partitions in decreasing order of the constraint count
+		of their most constrained body, and each one goes to the least filled partition it fits in. Scenes with a few bodies
+		touching many others (a ground body, a vehicle chassis) then get fewer and more even partitions, which helps the
+		parallel solver. Partitioning takes slightly longer.
+
+		The solver results only change through the order the constraints are solved in. This flag is ignored with
+		eENABLE_ENHANCED_DETERMINISM and by the GPU pipeline. It is not mutable and must be set at scene creation.
+
+		<b>Default</b> false
+
+		@see eENABLE_ENHANCED_DETERMINISM
+		*/
+		eENABLE_BALANCED_PARTITIONS = (1<<24),
+
+		/**
+		\brief Keeps the persistent contact manifolds of the pairs that fall asleep.
+
+		Pairs normally drop their contact data when their bodies go to sleep and regenerate it from scratch when they wake up.
+		With this flag the manifolds of the primitive and convex pairs are kept while asleep, and on wake up the contact
+		generation only refreshes them, which lowers the cost of the first frame after a large group of bodies wakes up.
+		The manifolds of the mesh and heightfield pairs and the friction data are still regenerated.
+
+		Sleeping pairs then keep holding their manifold memory. This flag has no effect without eENABLE_PCM and is ignored
+		by the GPU pipeline. It is not mutable and must be set at scene creation.
+
+		<b>Default</b> false
+
+		@see eENABLE_PCM
+		*/
+		eENABLE_WARM_SLEEPING = (1<<25),
+
+		/**
+		\brief Memoizes the results of PxScene::raycast(), sweep() and overlap() until the next simulation step.
+
+		A query issued again with the same geometry, pose, direction, distance, hit flags, filter data and touch buffer size
+		returns the stored hits instead of traversing the pruners. The results are dropped when fetchResults() completes,
+		when the pruners change (shapes added, removed or moved) and when shape query filter data changes.
+
+		Queries with a filter callback or a PxQueryCache, with a triangle mesh or heightfield as query geometry, and results that
+		fill the touch buffer are never cached. Batched queries don't use the cache. Cached hits are not sent to PVD.
+		It is not mutable and must be set at scene creation.
+
+		<b>Default</b> false
+		*/
+		eENABLE_QUERY_CACHE = (1<<26),
+
+		/**
+		\brief Runs the scene queries on frozen copies of the pruners, so they can be issued from any thread while the scene simulates.
+
+		A copy of the pruned objects, their bounds and their poses, with its own tree, is published when simulate() starts and when
+		fetchResults() completes. Queries take no lock and always see a consistent state, while the pruners themselves are updated with the
+		simulation results. The copies are double buffered: the one that isn't being read is refitted or rebuilt and then swapped in.
+
+		Bounds and poses changed by the user become visible to the queries at the next publish only. Removed shapes disappear right away:
+		the queries then wait until the shape is hidden from the copies, which also happens when the origin is shifted. Shape geometry and
+		query filter data are still read from the shapes. The scene must not be modified from a query callback.
+		It is not mutable and must be set at scene creation.
+
+		<b>Default</b> false
+
+		@see PxScene::raycast PxScene::sweep PxScene::overlap
+		*/
+		eENABLE_QUERY_SNAPSHOTS = (1<<27),
+
+		/**
+		\brief Builds the contact report headers in parallel tasks on the scene's CPU dispatcher.
+
+		fetchResults() then splits the contact report pairs in batches of 256, the calling thread takes the first batch and
+		waits for the others (see PxCpuDispatcher::waitUntil). Smaller reports are built on the calling thread.
+		The callbacks themselves still run on the thread calling fetchResults(), see PxSimulationEventCallback::onContacts().
+
+		<b>Default</b> false
+
+		@see PxSimulationEventCallback::onContacts
+		*/
+		eENABLE_PARALLEL_CONTACT_REPORTS = (1<<28),
+
+		/**
+		\brief Uses a read-biased lock for PxScene::lockRead() and lockWrite().
+
+		With the default lock every lockRead() goes through a mutex and a counter shared by all threads, which becomes the
+		bottleneck when many threads issue scene queries. With this flag readers only increment a counter on a cache line
+		picked for their thread, and don't touch the mutex unless a writer holds the lock. lockWrite() is more expensive in
+		exchange, since it waits for the counters of all the threads.
+
+		This flag has no effect without eREQUIRE_RW_LOCK. It is not mutable and must be set at scene creation.
+
+		<b>Default</b> false
+
+		@see eREQUIRE_RW_LOCK PxScene::lockRead PxScene::lockWrite
+		*/
+		eENABLE_DISTRIBUTED_READ_LOCK = (1<<29),
+
+		/**
+		\brief Lets the contact modification callback run on several worker threads at once.
+
+		The narrow phase tasks pass the modifiable pairs of their own batch to PxContactModifyCallback::onContactModify().
+		By default only one call runs at a time, the tasks wait for each other around the callback. With this flag the
+		calls are not serialized, so the cost of the modification scales with the worker threads, and the callback must be
+		thread-safe. The pairs of a call are never part of another call in the same simulation step.
+
+		This flag is not mutable and must be set at scene creation.
+
+		<b>Default</b> false
+
+		@see PxContactModifyCallback
+		*/
+		eENABLE_PARALLEL_CONTACT_MODIFICATION = (1<<30),
+
 		eMUTABLE_FLAGS = eENABLE_ACTIVE_ACTORS|eENABLE_ACTIVETRANSFORMS|eEXCLUDE_KINEMATICS_FROM_ACTIVE_ACTORS
 	};
 };
@@ -580,6 +766,18 @@ public:
 	*/
 	PxSimulationFilterShader	filterShader;
 
+	/**
+	\brief Optional filter shader evaluating the new broadphase pairs in batches.
+
+	\note It has to give the same result as #filterShader, which is still used for re-filtering. When using
+	#PxDefaultSimulationFilterShader, set it to #PxDefaultSimulationFilterBatchShader.
+
+	<b>Default:</b> NULL
+
+	@see PxSimulationFilterBatchShader
+	*/
+	PxSimulationFilterBatchShader	filterBatchShader;
+
 	/**
 	\brief A custom collision filter callback which can be used to implement more complex filtering operations which need
 	access to the simulation state, for example.
@@ -695,6 +893,23 @@ public:
 
 	PxReal solverOffsetSlop;
 
+	/**
+	\brief Velocity change below which the solver considers an island converged and skips its remaining iterations.
+
+	When non-zero, the solver measures the largest change of the body velocities during each position iteration of an island.
+	Once it drops below this value, the iterations left before the friction iterations (the last 3), or the friction iterations
+	left before the final one, are skipped. Islands at rest then only run a few of their iterations, while the islands still
+	moving run all of them.
+
+	Only islands solved by a single thread, without articulations, are affected. The early-out doesn't apply to the
+	velocity iterations, to the coulomb friction models or to the GPU pipeline.
+
+	<b>Range:</b> [0, PX_MAX_F32)<br>
+	<b>Default:</b> 0.0 (disabled)
+	*/
+
+	PxReal solverConvergenceThreshold;
+
 	/**
 	\brief Flags used to select scene options.
 
@@ -721,7 +936,7 @@ public:
 	/**
 	\brief Defines the structure used to store static objects.
 
-	\note Only PxPruningStructureType::eSTATIC_AABB_TREE and PxPruningStructureType::eDYNAMIC_AABB_TREE are allowed here.
+	\note Only PxPruningStructureType::eSTATIC_AABB_TREE, PxPruningStructureType::eDYNAMIC_AABB_TREE and PxPruningStructureType::eINCREMENTAL_AABB_TREE are allowed here.
 	*/
 	PxPruningStructureType::Enum	staticStructure;
 
@@ -959,6 +1174,7 @@ PX_INLINE PxSceneDesc::PxSceneDesc(const PxTolerancesScale& scale):
 	filterShaderData					(NULL),
 	filterShaderDataSize				(0),
 	filterShader						(NULL),
+	filterBatchShader					(NULL),
 	filterCallback						(NULL),
 
 	kineKineFilteringMode				(PxPairFilteringMode::eDEFAULT),
@@ -972,6 +1188,7 @@ PX_INLINE PxSceneDesc::PxSceneDesc(const PxTolerancesScale& scale):
 	frictionOffsetThreshold				(0.04f * scale.length),
 	ccdMaxSeparation					(0.04f * scale.length),
 	solverOffsetSlop					(0.0f),
+	solverConvergenceThreshold			(0.0f),
 
 	flags								(PxSceneFlag::eENABLE_PCM),
 
@@ -1019,7 +1236,7 @@ PX_INLINE bool PxSceneDesc::isValid() const
 	if(!limits.isValid())
 		return false;
 
-	if(staticStructure!=PxPruningStructureType::eSTATIC_AABB_TREE && staticStructure!=PxPruningStructureType::eDYNAMIC_AABB_TREE)
+	if(staticStructure!=PxPruningStructureType::eSTATIC_AABB_TREE && staticStructure!=PxPruningStructureType::eDYNAMIC_AABB_TREE && staticStructure!=PxPruningStructureType::eINCREMENTAL_AABB_TREE)
 		return false;
 
 	if(dynamicTreeRebuildRateHint < 4)
@@ -1031,6 +1248,8 @@ PX_INLINE bool PxSceneDesc::isValid() const
 		return false;
 	if(ccdMaxSeparation < 0.0f)
 		return false;
+	if(solverConvergenceThreshold < 0.0f)
+		return false;
 
 	if(!cpuDispatcher)
 		return false;
@@ -117,7 +117,32 @@ struct PxShapeFlag
 		/**
 		\brief Sets the shape to be a particle drain.
 		*/
-		ePARTICLE_DRAIN					= (1<<4)
+		ePARTICLE_DRAIN					= (1<<4),
+
+		/**
+		\brief Trigger shape whose pairs only use the broadphase bounds.
+
+		A pair is reported as eNOTIFY_TOUCH_FOUND when the broadphase finds the bounds of the two shapes overlapping (including
+		the contact offsets), and as eNOTIFY_TOUCH_LOST when they stop overlapping. No exact overlap test is run, and the pairs
+		don't need any work from one frame to the next. Meant for large numbers of coarse trigger volumes.
+
+		\note Only has an effect together with eTRIGGER_SHAPE.
+
+		@see eTRIGGER_TEST_ON_ENTER
+		*/
+		eTRIGGER_BOUNDS_ONLY			= (1<<5),
+
+		/**
+		\brief Like eTRIGGER_BOUNDS_ONLY, but eNOTIFY_TOUCH_FOUND waits for an exact overlap of the shapes.
+
+		The exact test runs while the bounds overlap and the shapes don't, as for regular triggers. Once the shapes overlap,
+		the pair stays in contact until the bounds separate.
+
+		\note Only has an effect together with eTRIGGER_SHAPE.
+
+		@see eTRIGGER_BOUNDS_ONLY
+		*/
+		eTRIGGER_TEST_ON_ENTER			= (1<<6)
 	};
 };
 
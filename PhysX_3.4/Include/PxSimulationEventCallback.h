@@ -862,6 +862,26 @@ class PxSimulationEventCallback
 	*/
 	virtual void onContact(const PxContactPairHeader& pairHeader, const PxContactPair* pairs, PxU32 nbPairs) = 0;
 
+	/**
+	\brief Delivers all the contact reports of a simulation step at once.
+
+	PxScene::fetchResults() calls this method once per client, with the headers of every actor pair the client receives reports for.
+	The default implementation calls #onContact() for each header in turn, override it to process the reports in bulk and save
+	the virtual call per actor pair.
+
+	The same lifetime rules as for #onContact() apply: the headers and their contact pairs are invalid after this function returns.
+
+	\param[in] pairHeaders The actor pairs whose shapes triggered contact reports, the contact pairs of each are in PxContactPairHeader::pairs.
+	\param[in] nbPairHeaders The number of provided headers.
+
+	@see onContact() PxSceneFlag::eENABLE_PARALLEL_CONTACT_REPORTS
+	*/
+	virtual void onContacts(const PxContactPairHeader* pairHeaders, PxU32 nbPairHeaders)
+	{
+		for(PxU32 i = 0; i < nbPairHeaders; i++)
+			onContact(pairHeaders[i], pairHeaders[i].pairs, pairHeaders[i].nbPairs);
+	}
+
 	/**
 	\brief This is called with the current trigger pair events.
 
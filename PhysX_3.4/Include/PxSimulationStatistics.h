@@ -117,7 +117,50 @@ public:
 
 		@see PxShapeFlag::eTRIGGER_SHAPE
 		*/
-		eTRIGGER_PAIRS
+		eTRIGGER_PAIRS,
+
+		/**
+		\brief Discrete PCM pairs that reused their persistent contact manifold for the current simulation step.
+
+		The relative motion of the shapes since the last contact generation was below the reuse thresholds, so only the
+		existing manifold contacts were updated.
+
+		@see PxSceneFlag::eENABLE_PCM PxSceneFlag::eENABLE_ADAPTIVE_PCM_THRESHOLDS
+		*/
+		ePCM_MANIFOLD_HITS,
+
+		/**
+		\brief Discrete PCM pairs that discarded a non-empty manifold and ran the contact generation again for the current simulation step.
+		*/
+		ePCM_MANIFOLD_REFRESHES,
+
+		/**
+		\brief Discrete PCM pairs that generated their contacts from an empty manifold for the current simulation step.
+
+		This includes the new pairs and the separated pairs.
+		*/
+		ePCM_MANIFOLD_REGENERATIONS
+	};
+
+	/**
+	\brief Stages of the simulation step timed by stageWallTime and stageCpuTime.
+
+	The stages of the task graph overlap, e.g. the broad phase runs alongside the first narrow phase pass, so the wall times
+	add up to more than the duration of the step.
+
+	@see stageWallTime stageCpuTime
+	*/
+	enum StageType
+	{
+		eSTAGE_BROAD_PHASE,			//!< Bounds update and broad phase, up to the creation of the new pairs
+		eSTAGE_NARROW_PHASE,		//!< Contact generation, both passes
+		eSTAGE_ISLAND_GEN,			//!< Island generation, trigger pairs and touch events
+		eSTAGE_SOLVER,				//!< Constraint preparation, solver and integration of the bodies
+		eSTAGE_INTEGRATION,			//!< Update of the body poses, bounds and sleep state after the solver
+		eSTAGE_CCD,					//!< Continuous collision detection passes
+		eSTAGE_SCENE_QUERY_UPDATE,	//!< Update of the scene query structures in fetchResults()
+		eSTAGE_CALLBACKS,			//!< Simulation event callbacks fired by fetchResults()
+		eSTAGE_COUNT
 	};
 
 
@@ -247,7 +290,7 @@ public:
 	PxU32 getRbPairStats(RbPairStatsType pairType, PxGeometryType::Enum g0, PxGeometryType::Enum g1) const
 	{
 		PX_ASSERT_WITH_MESSAGE(	(pairType >= eDISCRETE_CONTACT_PAIRS) &&
-								(pairType <= eTRIGGER_PAIRS),
+								(pairType <= ePCM_MANIFOLD_REGENERATIONS),
 								"Invalid pairType in PxSimulationStatistics::getRbPairStats");
 
 		if (g0 >= PxGeometryType::eGEOMETRY_COUNT || g1 >= PxGeometryType::eGEOMETRY_COUNT)
@@ -271,6 +314,15 @@ public:
 			case eTRIGGER_PAIRS:
 				nbPairs = nbTriggerPairs[g0][g1];
 				break;
+			case ePCM_MANIFOLD_HITS:
+				nbPairs = nbPCMManifoldHits[g0][g1];
+				break;
+			case ePCM_MANIFOLD_REFRESHES:
+				nbPairs = nbPCMManifoldRefreshes[g0][g1];
+				break;
+			case ePCM_MANIFOLD_REGENERATIONS:
+				nbPairs = nbPCMManifoldRegenerations[g0][g1];
+				break;
 		}
 		return nbPairs;
 	}
@@ -316,6 +368,25 @@ public:
 	*/
 	PxU32	nbPartitions;
 
+	/**
+	\brief Wall clock time of each stage for the last simulation step, in microseconds.
+
+	Measured from the task starting the stage to the task ending it, waits for worker threads included.
+
+	@see StageType
+	*/
+	PxU32	stageWallTime[eSTAGE_COUNT];
+
+	/**
+	\brief CPU time of each stage for the last simulation step, in microseconds, summed over every thread.
+
+	The time of a task goes to the stage that was current when it started: with overlapping stages that is the one started last.
+	The fetchResults() stages run on the calling thread, their CPU time is their wall time.
+
+	@see StageType
+	*/
+	PxU32	stageCpuTime[eSTAGE_COUNT];
+
 	PxSimulationStatistics() :
 		nbActiveConstraints					(0),
 		nbActiveDynamicBodies				(0),
@@ -354,6 +425,9 @@ public:
 				nbModifiedContactPairs[i][j] = 0;
 				nbCCDPairs[i][j] = 0;
 				nbTriggerPairs[i][j] = 0;
+				nbPCMManifoldHits[i][j] = 0;
+				nbPCMManifoldRefreshes[i][j] = 0;
+				nbPCMManifoldRegenerations[i][j] = 0;
 			}
 		}
 
@@ -361,6 +435,12 @@ public:
 		{
 			nbShapes[i] = 0;
 		}
+
+		for(PxU32 i=0; i < eSTAGE_COUNT; i++)
+		{
+			stageWallTime[i] = 0;
+			stageCpuTime[i] = 0;
+		}
 	}
 
 
@@ -376,6 +456,9 @@ public:
 	PxU32   nbCCDPairs[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
 	PxU32   nbModifiedContactPairs[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
 	PxU32   nbTriggerPairs[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+	PxU32   nbPCMManifoldHits[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+	PxU32   nbPCMManifoldRefreshes[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+	PxU32   nbPCMManifoldRegenerations[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
 
 //triangle mesh cache statistics
 	PxU32	particlesGpuMeshCacheSize;
@@ -43,6 +43,8 @@ namespace physx
 {
 #endif
 
+class PxCpuDispatcher;
+
 typedef PxU32 PxSpatialIndexItemId;
 static const PxSpatialIndexItemId PX_SPATIAL_INDEX_INVALID_ITEM_ID = 0xffffffff;
 
@@ -109,6 +111,9 @@ checks.
 It is not thread-safe and defers handling some updates until queries are invoked, so care must be taken when calling any methods in parallel. Specifically,
 to call query methods (raycast, overlap, sweep) in parallel, first call flush() to force immediate update of internal structures.
 
+For indices with many moving items, the tree can be rebuilt on worker threads with startRebuild(), while queries keep using the
+current tree until fetchRebuild() swaps in the new one.
+
 \deprecated Spatial index feature has been deprecated in PhysX version 3.4
 
 @see PxCreateSpatialIndex
@@ -211,6 +216,71 @@ public:
 	*/
 	virtual void					rebuildStep()											= 0;
 
+	/**
+	\brief insert a batch of bounding boxes into a spatial index
+
+	Same as calling insert() for each item, but the index is only updated once.
+
+	\param[in] items the items to be inserted
+	\param[in] bounds the bounds of the new items, one per item
+	\param[in] count the number of items
+	\param[out] ids receives the ids of the new items, one per item
+
+	@see insert()
+	*/
+	virtual	void					insertItems(PxSpatialIndexItem*const* items,
+												const PxBounds3* bounds,
+												PxU32 count,
+												PxSpatialIndexItemId* ids)					= 0;
+
+	/**
+	\brief update a batch of bounding boxes in a spatial index
+
+	\param[in] ids the ids of the items to be updated
+	\param[in] bounds the new bounds of the items, one per id
+	\param[in] count the number of items
+
+	@see update()
+	*/
+	virtual	void					updateItems(const PxSpatialIndexItemId* ids,
+												const PxBounds3* bounds,
+												PxU32 count)								= 0;
+
+	/**
+	\brief remove a batch of items from a spatial index
+
+	\param[in] ids the ids of the items to be removed
+	\param[in] count the number of items
+
+	@see remove()
+	*/
+	virtual	void					removeItems(const PxSpatialIndexItemId* ids,
+												PxU32 count)								= 0;
+
+	/**
+	\brief start a full rebuild of the index on a worker thread
+
+	The new tree is built from the bounds of the items at the time of the call. Queries can be made while the rebuild
+	runs, and use the current tree. The index must not be modified (no insertion, update, removal, flush or other rebuild)
+	until fetchRebuild() has returned true.
+
+	\param[in] dispatcher the dispatcher running the rebuild. If it has no worker threads, the rebuild runs during this call.
+	\return true if a rebuild was started, false if the tree is up to date or a rebuild is already running
+
+	@see fetchRebuild()
+	*/
+	virtual	bool					startRebuild(PxCpuDispatcher& dispatcher)				= 0;
+
+	/**
+	\brief swap in the tree built by startRebuild()
+
+	\param[in] block if true, waits for the rebuild to complete
+	\return true if the rebuild completed and the new tree is used by the following queries, or if no rebuild was running
+
+	@see startRebuild()
+	*/
+	virtual	bool					fetchRebuild(bool block = false)						= 0;
+
 	/**
 	\brief release this object
 	*/
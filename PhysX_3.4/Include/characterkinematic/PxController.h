@@ -131,6 +131,7 @@ struct PxControllerState
 	bool			standOnAnotherCCT;	//!< Are we standing on another CCT?
 	bool			standOnObstacle;	//!< Are we standing on a user-defined obstacle?
 	bool			isMovingUp;			//!< is CCT moving up or not? (i.e. explicit jumping)
+	bool			isSimplified;		//!< Did the last move use the simplified level of detail? (see PxControllerManager::setLodFocusPoints)
 };
 
 /**
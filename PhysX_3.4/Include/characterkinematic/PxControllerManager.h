@@ -35,6 +35,7 @@
 */
 
 #include "characterkinematic/PxCharacter.h"
+#include "characterkinematic/PxController.h"
 
 #include "PxPhysXConfig.h"
 #include "foundation/PxFlags.h"
@@ -53,6 +54,25 @@ class PxControllerDesc;
 class PxObstacleContext;
 class PxControllerFilterCallback;
 
+/**
+\brief A controller move submitted to PxControllerManager::moveControllers().
+
+The parameters match the ones of PxController::move().
+
+@see PxControllerManager::moveControllers PxController::move
+*/
+struct PxControllerMove
+{
+	PxController*				controller;		//!< Controller to move
+	PxVec3						disp;			//!< Displacement vector
+	PxF32						minDist;		//!< Minimum travelled distance to consider
+	const PxControllerFilters*	filters;		//!< User-defined filters for this move, NULL for the default filters
+	const PxObstacleContext*	obstacles;		//!< Potential additional obstacles, can be NULL
+	PxControllerCollisionFlags	collisionFlags;	//!< Output: the flags returned by the move
+
+	PxControllerMove() : controller(NULL), disp(0.0f), minDist(0.0f), filters(NULL), obstacles(NULL), collisionFlags(0)	{}
+};
+
 /**
 \brief specifies debug-rendering flags
 */
@@ -194,6 +214,29 @@ public:
 	*/
 	virtual	void				computeInteractions(PxF32 elapsedTime, PxControllerFilterCallback* cctFilterCb=NULL) = 0;
 
+	/**
+	\brief Moves a batch of characters, using the scene's CPU dispatcher for characters that can't interact.
+
+	Characters are grouped by the volumes they can sweep this frame: their bounds grown by the displacement, the pending overlap
+	recovery, the motion of the object they stand on (as of the previous move) and the contact and step offsets. Groups are moved
+	in parallel, the characters of a group one after the other in the order of the batch. The results are the same as calling
+	PxController::move() for each character in the order of the batch, whatever the number of worker threads.
+
+	Characters that are not part of the batch are still seen as obstacles.
+
+	\note The hit report, behavior and filter callbacks of the characters are called from the worker threads and must be thread safe.
+	\note The batch runs on the calling thread when debug rendering is enabled or when the scene has no CPU dispatcher with worker threads.
+	\note A character should appear only once in a batch.
+	\note The moves only read the scene. The targets of the kinematic actors of the characters are set once the whole batch is done.
+
+	\param[in] moves		Moves to perform, the collision flags are written back to each entry
+	\param[in] nbMoves		Number of moves
+	\param[in] elapsedTime	Time elapsed since last call
+
+	@see PxControllerMove PxController::move
+	*/
+	virtual	void				moveControllers(PxControllerMove* moves, PxU32 nbMoves, PxF32 elapsedTime) = 0;
+
 	/**
 	\brief Enables or disables runtime tessellation.
 
@@ -256,6 +299,50 @@ public:
 	*/
 	virtual	void				setPreventVerticalSlidingAgainstCeiling(bool flag) = 0;
 
+	/**
+	\brief Enables or disables the static geometry cache shared by the characters.
+
+	Each character normally queries the scene around itself and transforms the touched static triangles on its own, so crowds
+	walking on the same terrain collect the same triangles many times. With the shared cache, static geometry is gathered once
+	per cell of a grid and characters copy the triangles touching their own cached volume from it.
+
+	Cells are gathered with a margin of half a cell on each side. Characters whose cached volume (see PxControllerDesc::volumeGrowth)
+	doesn't fit in a cell and its margin, or that use a PxQueryFilterCallback, query the scene themselves as before.
+	Cells are thrown away when the static scene query structure changes, when a static actor or a shape is released, and on origin shifts.
+
+	\note A cell is gathered with a single scene query which, like the query of each character, reports at most 100 shapes. Keep cells small in dense scenes.
+
+	By default, the cache is disabled.
+
+	\param[in] flag		True/false to enable/disable the cache.
+	\param[in] cellSize	Size of the grid cells, should be a few times the size of the characters' cached volumes.
+	*/
+	virtual	void				setSharedGeometryCache(bool flag, PxF32 cellSize) = 0;
+
+	/**
+	\brief Sets the focus points of the characters' level of detail, usually the cameras or the players.
+
+	Characters farther than fullDistance from all the focus points use a simplified move: the displacement is applied at once,
+	the character is pushed out of the geometry it overlaps in the plane orthogonal to its up direction, then snapped to the
+	ground with a single raycast covering the step offset. There is no collide-and-slide, no slope limit, no riding on moving
+	objects, no collision with other characters and no hit reports in this mode. The overlap recovery from computeInteractions()
+	is still applied.
+
+	Characters switch back to the full move once closer than fullDistance. They only switch to the simplified move beyond
+	fullDistance plus 10%, so that characters near the limit don't switch every frame.
+
+	By default there are no focus points and all characters use the full move.
+
+	\note The points are copied. Don't call this while PxControllerManager::moveControllers() runs.
+
+	\param[in] points			Focus points. NULL or nbPoints=0 disables the level of detail.
+	\param[in] nbPoints		Number of focus points
+	\param[in] fullDistance	Distance to the closest focus point below which characters use the full move
+
+	@see PxControllerState::isSimplified
+	*/
+	virtual	void				setLodFocusPoints(const PxVec3* points, PxU32 nbPoints, PxF32 fullDistance) = 0;
+
 	/**
 	\brief Shift the origin of the character controllers and obstacle objects by the specified vector.
 
@@ -175,6 +175,50 @@ struct PX_DEPRECATED PxClothMotionConstraintConfig
 	{}
 };
 
+/**
+\brief Level of detail of a cloth instance, trades accuracy for simulation cost.
+\details Distant cloth (e.g. the capes of a crowd) can be simulated at a fraction of the cost of hero cloth
+by solving less often and fewer constraints. See PxClothUpdateLod() for picking levels by distance.
+\see PxCloth.setLod()
+\deprecated The PhysX cloth feature has been deprecated in PhysX version 3.4.1
+*/
+struct PX_DEPRECATED PxClothLod
+{
+	/**
+	\brief Scales the solver frequency (see PxCloth::setSolverFrequency).
+	The default scale is 1.0.
+	*/
+	PxReal solverFrequencyScale;
+
+	/**
+	\brief Phase types to solve, bit (1 << PxClothFabricPhaseType::Enum) set for each.
+	\details Dropping e.g. the bending and shearing phases leaves a coarser fabric of the stretch constraints.
+	Only the first 32 phases of a fabric can be disabled.
+	The default solves all phases.
+	*/
+	PxU32 phaseTypes;
+
+	/**
+	\brief False skips self-collision, true uses the self-collision settings of the cloth.
+	The default is true.
+	*/
+	bool selfCollision;
+
+	/**
+	\brief Solve the cloth every n-th simulation step only.
+	\details In between, the particles move on with their last velocity and are carried along with the global pose.
+	The default interval is 1.
+	*/
+	PxU32 updateInterval;
+
+	/**
+	\brief Constructor sets to default.
+	*/
+	PX_INLINE PxClothLod(PxReal frequencyScale = 1.0f, PxU32 types = 0xffffffff, bool selfCollision_ = true, PxU32 interval = 1) 
+		: solverFrequencyScale(frequencyScale), phaseTypes(types), selfCollision(selfCollision_), updateInterval(interval)
+	{}
+};
+
 /**
 \brief Set of connected particles tailored towards simulating character cloth.
 \details A cloth object consists of the following components:
@@ -851,6 +895,21 @@ public:
 	*/
 	virtual PxU32 getNbSelfCollisionIndices() const = 0;
 
+	/**
+	\brief Sets how often self-collision runs.
+	\details Self-collision is expensive on dense cloth, running it every nth solver iteration only
+	keeps it affordable as long as particles can't pass each other in between, i.e. the self collision
+	distance is large compared to the distance particles travel per iteration.
+	\param [in] interval Number of solver iterations between self-collision passes (default: 1).
+	\note Only supported by the CPU solver.
+	*/
+	virtual void setSelfCollisionInterval(PxU32 interval) = 0;
+	/**
+	\brief Returns the number of solver iterations between self-collision passes.
+	\return Self-collision interval.
+	*/
+	virtual PxU32 getSelfCollisionInterval() const = 0;
+
 	/**
 	\brief Sets the cloth particles rest positions.
 	\details If non-null the cloth self-collision will consider the rest positions by
@@ -992,6 +1051,26 @@ public:
 
 	/// @}
 
+	/** @name Level of Detail
+	 *  Functions related to reducing the simulation cost.
+	 */
+	/// @{
+
+	/**
+	\brief Sets the level of detail of the cloth.
+	\param [in] lod Level of detail (default: full detail).
+	\note Only the solver frequency scale is supported by the GPU solver.
+	\see PxClothLod PxClothUpdateLod()
+	*/
+	virtual void setLod(const PxClothLod& lod) = 0;
+	/**
+	\brief Returns the level of detail of the cloth.
+	\return Level of detail.
+	*/
+	virtual PxClothLod getLod() const = 0;
+
+	/// @}
+
 	virtual const char*	getConcreteTypeName() const { return "PxCloth"; }
 
 protected:
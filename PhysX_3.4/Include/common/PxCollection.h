@@ -121,6 +121,28 @@ public:
 	*/
 	virtual void						add(PxBase& object, PxSerialObjectId id = PX_SERIAL_OBJECT_ID_INVALID) = 0;
 
+	/**
+	\brief Adds an array of PxBase objects to the collection.
+
+	Same as calling add(PxBase&, PxSerialObjectId) for each object, but the collection grows once for the whole array.
+	NULL entries are skipped.
+
+	\param[in] objects Objects to be added to the collection
+	\param[in] nbObjects Number of objects
+	\param[in] ids Optional array of nbObjects PxSerialObjectId ids, PX_SERIAL_OBJECT_ID_INVALID entries leave the object without id
+	*/
+	virtual void						add(PxBase* const* objects, PxU32 nbObjects, const PxSerialObjectId* ids = NULL) = 0;
+
+	/**
+	\brief Reserves memory for a number of objects and ids.
+
+	Avoids the repeated rehashing of the collection when many objects are added one by one. The collection never shrinks.
+
+	\param[in] nbObjects Number of objects the collection should hold without growing
+	\param[in] nbIds Number of ids the collection should hold without growing
+	*/
+	virtual void						reserve(PxU32 nbObjects, PxU32 nbIds = 0) = 0;
+
 	/**
 	\brief Removes a PxBase member object from the collection.
 
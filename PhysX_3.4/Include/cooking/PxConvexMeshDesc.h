@@ -147,7 +147,18 @@ struct PxConvexFlag
 		numerical stability.
 		\note Is used only with eCOMPUTE_CONVEX flag.
 		*/
-		eSHIFT_VERTICES = (1 << 9)
+		eSHIFT_VERTICES = (1 << 9),
+
+		/**
+		\brief The hull is snapped to a compact representation, which is stored in the cooked data.
+
+		The hull vertices are snapped to a 16-bit grid over the hull bounds, and the polygon normals to 16-bit octahedral
+		coordinates. The cooked data then takes 6 bytes per vertex instead of 12, and 7 bytes per polygon instead of 20.
+		Snapping happens before the mass properties and gauss maps are computed, so the loaded hull is exactly the one that was cooked.
+
+		\note The loaded mesh still uses floating point vertices and planes, this only reduces the size of the cooked data.
+		*/
+		eQUANTIZE_HULL = (1 << 10)
 	};
 };
 
@@ -50,6 +50,7 @@ namespace physx
 class PxBinaryConverter;
 class PxPhysicsInsertionCallback;
 class PxFoundation;
+class PxCpuDispatcher;
 
 struct PX_DEPRECATED PxPlatform
 {
@@ -199,7 +200,15 @@ struct PxMeshPreprocessingFlag
 
 		\note By default mesh will be created with 16-bit indices for triangle count <= 0xFFFF and 32-bit otherwise.
 		*/
-		eFORCE_32BIT_INDICES							=	1 << 3
+		eFORCE_32BIT_INDICES							=	1 << 3,
+
+		/**
+		\brief When set, the triangle indices are stored as variable length deltas in the cooked data.
+
+		After the midphase reordering consecutive triangles mostly share nearby vertices, so most indices take one or two bytes.
+		The indices are decoded when the mesh is loaded.
+		*/
+		eCOMPRESS_INDICES								=	1 << 4
 	};
 };
 
@@ -396,6 +405,18 @@ struct PxCookingParams
 	*/
 	PxU32	gaussMapLimit;
 
+	/**
+	\brief Dispatcher running parts of the triangle mesh cooking, and the hulls of PxCooking::createConvexMeshes, in parallel.
+
+	For large meshes, the BVH34 midphase computes the triangle bounds and builds its subtrees on the dispatcher's workers,
+	and the BVH33 midphase with PxMeshCookingHint::eSIM_PERFORMANCE sorts the three axes in parallel. The calling thread
+	takes part in the work, so meshes can be cooked from a task running on the same dispatcher. The cooked data is the same
+	with or without a dispatcher. Mesh cleaning and the edge list are still computed on the calling thread.
+
+	<b>Default value:</b> NULL
+	*/
+	PxCpuDispatcher*	dispatcher;
+
 	PxCookingParams(const PxTolerancesScale& sc):
 		skinWidth						(0.025f*sc.length),
 		areaTestEpsilon					(0.06f*sc.length*sc.length),
@@ -408,7 +429,8 @@ struct PxCookingParams
 		meshPreprocessParams			(0),
 		meshCookingHint					(PxMeshCookingHint::eSIM_PERFORMANCE),
 		meshSizePerformanceTradeOff		(0.55f),
-		meshWeldTolerance				(0.f)
+		meshWeldTolerance				(0.f),
+		dispatcher						(NULL)
 	{
 #if PX_INTEL_FAMILY
 		targetPlatform = PxPlatform::ePC;
@@ -481,6 +503,21 @@ public:
 	*/
 	virtual bool  cookTriangleMesh(const PxTriangleMeshDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition = NULL) const = 0;
 
+	/**
+	\brief Cooks a triangle mesh read in chunks from a callback. The results are written to the stream.
+
+	Same as the descriptor version, but the vertices, triangles and materials are read straight into the cooker's arrays,
+	which avoids that the caller has to load the whole mesh in memory first.
+
+	\param[in] desc The stream descriptor to read the mesh from.
+	\param[in] stream User stream to output the cooked data.
+	\param[out] condition Result from triangle mesh cooking.
+	\return true on success
+
+	@see PxTriangleMeshStreamDesc PxTriangleMeshStreamCallback
+	*/
+	virtual bool  cookTriangleMesh(const PxTriangleMeshStreamDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition = NULL) const = 0;
+
 	/**
 	\brief Cooks and creates a triangle mesh and inserts it into PxPhysics.
 
@@ -543,6 +580,9 @@ public:
 
 	\note PxPhysicsInsertionCallback can be obtained through PxPhysics::getPhysicsInsertionCallback().
 
+	\note If PxPhysics already has an identical convex mesh, it is returned with an extra reference instead of inserting
+	a copy, see PxPhysics::createConvexMesh().
+
 	\param[in] desc The convex mesh descriptor to read the mesh from.
 	\param[in] insertionCallback The insertion interface from PxPhysics.
 	\param[out] condition Result from convex mesh cooking.
@@ -552,6 +592,24 @@ public:
 	*/
 	virtual PxConvexMesh*    createConvexMesh(const PxConvexMeshDesc& desc, PxPhysicsInsertionCallback& insertionCallback, PxConvexMeshCookingResult::Enum* condition = NULL) const = 0;
 
+	/**
+	\brief Cooks and creates several convex meshes and inserts them into PxPhysics.
+
+	Same as calling createConvexMesh for each descriptor, but when PxCookingParams::dispatcher is set the hulls are cooked
+	concurrently on its worker threads and the calling thread. The meshes are then inserted one by one on the calling thread,
+	in the order of the descriptors.
+
+	\param[in] descs The convex mesh descriptors to read the meshes from.
+	\param[in] nbDescs Number of descriptors.
+	\param[in] insertionCallback The insertion interface from PxPhysics.
+	\param[out] meshes Receives nbDescs pointers, NULL for the meshes that failed.
+	\param[out] conditions Optional, receives the result of each cooking.
+	\return The number of meshes created.
+
+	@see createConvexMesh() PxCookingParams::dispatcher
+	*/
+	virtual PxU32    createConvexMeshes(const PxConvexMeshDesc* descs, PxU32 nbDescs, PxPhysicsInsertionCallback& insertionCallback, PxConvexMesh** meshes, PxConvexMeshCookingResult::Enum* conditions = NULL) const = 0;
+
 	/**
 	\brief Verifies if the convex mesh is valid. Prints an error message for each inconsistency found.
 
@@ -112,6 +112,70 @@ PX_INLINE bool PxTriangleMeshDesc::isValid() const
 	return PxSimpleTriangleMesh::isValid();
 }
 
+/**
+\brief Callback feeding the mesh data to the cooker in chunks, see #PxTriangleMeshStreamDesc.
+
+Each read copies count consecutive elements starting at start, packed without stride. Reads are done in order,
+from a single thread, and never overlap, so the data can come straight from a file.
+
+A read that returns false aborts the cooking.
+
+@see PxTriangleMeshStreamDesc PxCooking::cookTriangleMesh
+*/
+class PxTriangleMeshStreamCallback
+{
+public:
+	virtual ~PxTriangleMeshStreamCallback() {}
+
+	/**
+	\brief Reads count vertex positions.
+	*/
+	virtual bool readVertices(PxU32 start, PxU32 count, PxVec3* vertices) = 0;
+
+	/**
+	\brief Reads count triangles, three 32-bit vertex indices each.
+	*/
+	virtual bool readTriangles(PxU32 start, PxU32 count, PxU32* indices) = 0;
+
+	/**
+	\brief Reads count per triangle material indices. Only called when PxTriangleMeshStreamDesc::hasMaterialIndices is set.
+	*/
+	virtual bool readMaterialIndices(PxU32 start, PxU32 count, PxMaterialTableIndex* materialIndices) { PX_UNUSED(start); PX_UNUSED(count); PX_UNUSED(materialIndices); return false; }
+};
+
+/**
+\brief Descriptor for cooking a triangle mesh that is pulled from a callback instead of user arrays.
+
+The cooker reads the data directly into its own arrays, so the caller doesn't need to hold a copy of the whole mesh
+and the strided gather of #PxTriangleMeshDesc is skipped. The cooked mesh is identical to the one of the equivalent
+#PxTriangleMeshDesc.
+
+\note The cleaning and the midphase build still work on the whole mesh, what is saved is the caller side copy
+of the mesh, which is usually the largest one for meshes loaded from a file.
+
+@see PxTriangleMeshStreamCallback PxCooking::cookTriangleMesh
+*/
+class PxTriangleMeshStreamDesc
+{
+public:
+	PxU32							nbVertices;		//!< Number of vertices
+	PxU32							nbTriangles;	//!< Number of triangles, the mesh must be indexed
+	PxU32							chunkSize;		//!< Maximum number of elements per read. <b>Default:</b> 65536
+	PxMeshFlags						flags;			//!< Only PxMeshFlag::eFLIPNORMALS is used, indices are always 32-bit
+	bool							hasMaterialIndices;	//!< Whether PxTriangleMeshStreamCallback::readMaterialIndices should be called. <b>Default:</b> false
+	PxTriangleMeshStreamCallback*	callback;		//!< Source of the data
+
+	PX_INLINE PxTriangleMeshStreamDesc() : nbVertices(0), nbTriangles(0), chunkSize(65536), hasMaterialIndices(false), callback(NULL)	{}
+
+	/**
+	\brief Returns true if the descriptor is valid.
+	*/
+	PX_INLINE bool isValid() const
+	{
+		return callback && nbVertices >= 3 && nbTriangles && chunkSize;
+	}
+};
+
 #if !PX_DOXYGEN
 } // namespace physx
 #endif
@@ -118,6 +118,18 @@ public:
 	*/
 	virtual		bool	convert(PxInputStream& srcStream, PxU32 srcSize, PxOutputStream& targetStream)		= 0;
 
+	/**
+	\brief Bounds the memory used to hold the source data during conversion.
+
+	By default convert() loads the whole source into memory. With a window size, only the header, the reference tables
+	and the object headers are kept in memory, the extra data (mesh and heightfield arrays, etc.) is read through a window
+	of about windowSize bytes. The window grows for a single array that doesn't fit. Sources smaller than the window
+	are still loaded at once. The output is always written to the target stream as it is produced.
+
+	\param[in] windowSize	Window size in bytes, 0 to load the whole source
+	*/
+	virtual		void	setStreamingWindowSize(PxU32 windowSize)											= 0;
+
 
 protected:
 						PxBinaryConverter()		{}
@@ -45,6 +45,7 @@ namespace physx
 #endif
 
 class PxPhysics;
+class PxCpuDispatcher;
 
 struct PxFabricCookerImpl;
 
@@ -62,13 +63,19 @@ public:
 	\param useGeodesicTether A flag to indicate whether to compute geodesic distance for tether constraints.
 	\note The geodesic option for tether only works for manifold input.  For non-manifold input, a simple Euclidean distance will be used.
 	For more detailed cooker status for such cases, try running PxClothGeodesicTetherCooker directly.
+	\param dispatcher Optional dispatcher running the geodesic tether computation on its worker threads, see PxClothGeodesicTetherCooker.
 	*/
-	PxClothFabricCooker(const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether = true);
+	PxClothFabricCooker(const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether = true, PxCpuDispatcher* dispatcher = NULL);
 	~PxClothFabricCooker();
 
 	/** \brief Returns the fabric descriptor to create the fabric. */
 	PxClothFabricDesc getDescriptor() const;
-	/** \brief Saves the fabric data to a platform and version dependent stream. */
+	/**
+	\brief Saves the fabric data to a platform and version dependent stream.
+	\details The stream is loaded with PxPhysics::createClothFabric(PxInputStream&), which doesn't cook again.
+	Content can be cooked offline and saved, so the fabrics are only loaded at runtime.
+	The stream holds the triangles of the fabric as well (used for the wind and drag), older streams without them can still be loaded.
+	*/
 	void save(PxOutputStream& stream, bool platformMismatch) const;
 
 private:
@@ -83,10 +90,11 @@ private:
 \param gravity A normalized vector which specifies the direction of gravity. 
 This information allows the cooker to generate a fabric with higher quality simulation behavior.
 \param useGeodesicTether A flag to indicate whether to compute geodesic distance for tether constraints.
+\param dispatcher Optional dispatcher running the geodesic tether computation on its worker threads, see PxClothGeodesicTetherCooker.
 \return The created cloth fabric, or NULL if creation failed.
 */
 PxClothFabric* PxClothFabricCreate(PxPhysics& physics, 
-	const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether = true);
+	const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether = true, PxCpuDispatcher* dispatcher = NULL);
 
 #if !PX_DOXYGEN
 } // namespace physx
@@ -0,0 +1,83 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_CLOTH_LOD_H
+#define PX_PHYSICS_EXTENSIONS_CLOTH_LOD_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "common/PxPhysXCommonConfig.h"
+#include "cloth/PxCloth.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+/**
+\brief A level of detail used by PxClothUpdateLod, from the given distance on.
+\deprecated The PhysX cloth feature has been deprecated in PhysX version 3.4.1
+*/
+struct PX_DEPRECATED PxClothLodLevel
+{
+	PxReal		distance;	//!< Distance from the viewer to the world bounds of the cloth from which on the level applies
+	PxClothLod	lod;		//!< Level of detail set on the cloth
+};
+
+/**
+\brief Sets the level of detail of each cloth from its distance to the viewer.
+
+The distance is measured from the viewer to the closest point of the world bounds. Levels must be sorted by increasing distance,
+the first one also applies below its distance. A cloth only moves to another level once the distance is more than hysteresis
+past the boundary, so that cloth near a boundary doesn't switch back and forth.
+
+\param[in] cloths Cloths to update, all in the same scene.
+\param[in] nbCloths Number of cloths.
+\param[in] viewer World position the distances are measured from, e.g. the camera.
+\param[in] levels Levels of detail, by increasing distance.
+\param[in] nbLevels Number of levels.
+\param[in] hysteresis Distance past a level boundary before switching.
+
+\return The number of cloths whose level of detail changed.
+
+\note Call this before PxScene::simulate(), changing the level of detail wakes the cloth up.
+
+@see PxClothLod PxCloth::setLod
+*/
+PX_DEPRECATED PxU32 PxClothUpdateLod(PxCloth* const* cloths, PxU32 nbCloths, const PxVec3& viewer,
+									 const PxClothLodLevel* levels, PxU32 nbLevels, PxReal hysteresis = 0.0f);
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
@@ -38,6 +38,8 @@
 namespace physx
 {
 #endif
+
+class PxCpuDispatcher;
 	
 struct PxClothSimpleTetherCookerImpl;
 
@@ -92,8 +94,11 @@ public:
 	This is by no means a general purpose geodesic computation code for arbitrary meshes.
 	\note The geodesic cooker does not work with non-manifold input such as edges having more than two incident triangles, 
 	or adjacent triangles following inconsitent winding order (e.g. clockwise vs counter-clockwise). 
+	\param dispatcher Optional dispatcher. The distance searches from each island of attached particles, and the tethers
+	of each batch of particles, then run on its worker threads. The calling thread takes part in the work and returns when
+	the tethers are done, so the cooker can be used from a task of the same dispatcher. The tethers are the same with or without it.
 	*/
-	PxClothGeodesicTetherCooker(const PxClothMeshDesc &desc);
+	PxClothGeodesicTetherCooker(const PxClothMeshDesc &desc, PxCpuDispatcher* dispatcher = NULL);
 	~PxClothGeodesicTetherCooker();
 
 	/**
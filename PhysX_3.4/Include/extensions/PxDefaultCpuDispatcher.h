@@ -42,6 +42,41 @@ namespace physx
 {
 #endif
 
+/**
+\brief Statistics gathered by the dispatcher telemetry for the tasks sharing a name.
+
+Times are in microseconds. Bucket i of the histograms counts the tasks that took less than 2^i microseconds
+(and at least 2^(i-1)), the last bucket counts everything above.
+
+@see PxDefaultCpuDispatcher::getTaskTelemetry
+*/
+struct PxDispatcherTaskStats
+{
+	enum { eHISTOGRAM_BUCKETS = 16 };
+
+	const char*	name;									//!< Task name, NULL for the tasks that didn't fit the name table
+	PxU64		count;									//!< Number of tasks run
+	PxU64		runTime;								//!< Total time spent in PxBaseTask::run()
+	PxU64		waitTime;								//!< Total time spent on the queues, from submission until a worker picked the task
+	PxU32		runHistogram[eHISTOGRAM_BUCKETS];
+	PxU32		waitHistogram[eHISTOGRAM_BUCKETS];
+};
+
+/**
+\brief Statistics gathered by the dispatcher telemetry for a worker thread.
+
+Times are in microseconds, the idle percentage is idleTime / (busyTime + idleTime).
+
+@see PxDefaultCpuDispatcher::getWorkerTelemetry
+*/
+struct PxDispatcherWorkerStats
+{
+	PxU64		busyTime;		//!< Time spent running tasks
+	PxU64		idleTime;		//!< Time spent waiting for tasks
+	PxU64		nbTasks;		//!< Number of tasks run
+	PxU64		nbSteals;		//!< Number of tasks taken from the local queue of another worker
+};
+
 /**
 \brief A default implementation for a CPU task dispatcher.
 
@@ -74,21 +109,130 @@ public:
 	\return True if tasks should be profiled.
 	*/
 	virtual bool getRunProfiled() const = 0;
+
+	/**
+	\brief Enables the built-in telemetry, which doesn't need a profiler callback.
+
+	Workers time every task and keep the statistics in their own tables, so the overhead is two clock reads per task.
+	The statistics can be polled from any thread while the dispatcher runs.
+
+	\return False if the dispatcher doesn't support telemetry.
+
+	@see getTaskTelemetry getWorkerTelemetry getQueueTelemetry resetTelemetry
+	*/
+	virtual bool setTelemetryEnabled(bool enabled) { PX_UNUSED(enabled); return false; }
+
+	/**
+	\brief Copies the statistics of every task name, returns the number of entries written.
+
+	Polling while tasks run gives approximate values, the counters are not read atomically.
+	*/
+	virtual PxU32 getTaskTelemetry(PxDispatcherTaskStats* stats, PxU32 maxStats) const { PX_UNUSED(stats); PX_UNUSED(maxStats); return 0; }
+
+	/**
+	\brief Copies the statistics of each worker, returns the number of entries written.
+	*/
+	virtual PxU32 getWorkerTelemetry(PxDispatcherWorkerStats* stats, PxU32 maxStats) const { PX_UNUSED(stats); PX_UNUSED(maxStats); return 0; }
+
+	/**
+	\brief Returns the number of tasks waiting on the queues, and the highest number since the last reset.
+	*/
+	virtual void getQueueTelemetry(PxU32& depth, PxU32& maxDepth) const { depth = 0; maxDepth = 0; }
+
+	/**
+	\brief Clears the statistics. Workers clear their tables on their next task, so a poll right after can still see old values.
+	*/
+	virtual void resetTelemetry() {}
 };
 
 
+/**
+\brief How the worker threads of the default dispatcher wait for work.
+
+An idle worker first spins (with pause instructions) checking for new tasks, then yields its time slice
+while checking, and only then parks on its own semaphore. Parked workers are woken one at a time, one per submitted task.
+Spinning wastes some CPU but hides the OS wake up latency for the bursts of tasks of each simulation step.
+
+@see PxDefaultCpuDispatcherCreate
+*/
+struct PxDefaultCpuDispatcherWaitPolicy
+{
+	PxU32	spinMicroseconds;	//!< Time spent spinning before yielding
+	PxU32	yieldMicroseconds;	//!< Time spent yielding (after spinning) before parking
+
+	PxDefaultCpuDispatcherWaitPolicy() : spinMicroseconds(0), yieldMicroseconds(0) {}
+};
+
 /**
 \brief Create default dispatcher, extensions SDK needs to be initialized first.
 
+\param[in] numThreads Number of worker threads the dispatcher should use.
+\param[in] affinityMasks Array with affinity mask for each thread. If not defined, default masks will be used.
+\param[in] waitPolicy How idle workers wait for new tasks. If not defined, they park right away.
+
+\note numThreads may be zero in which case no worker thread are initialized and
+simulation tasks will be executed on the thread that calls PxScene::simulate()
+
+@see PxDefaultCpuDispatcher PxDefaultCpuDispatcherWaitPolicy
+*/
+PxDefaultCpuDispatcher* PxDefaultCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks = NULL, const PxDefaultCpuDispatcherWaitPolicy* waitPolicy = NULL);
+
+/**
+\brief Create a work stealing dispatcher, extensions SDK needs to be initialized first.
+
+Every worker owns a Chase-Lev deque. Tasks submitted from a worker go to its own deque and are executed in LIFO order,
+idle workers steal the oldest tasks from a random victim. Only tasks submitted from other threads go through a shared queue,
+which avoids the contention on the single job list of the default dispatcher with many worker threads.
+
 \param[in] numThreads Number of worker threads the dispatcher should use.
 \param[in] affinityMasks Array with affinity mask for each thread. If not defined, default masks will be used.
 
 \note numThreads may be zero in which case no worker thread are initialized and
 simulation tasks will be executed on the thread that calls PxScene::simulate()
 
-@see PxDefaultCpuDispatcher
+@see PxDefaultCpuDispatcherCreate PxDefaultCpuDispatcher
+*/
+PxDefaultCpuDispatcher* PxWorkStealingCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks = NULL);
+
+/**
+\brief How worker threads are placed on the CPUs by PxDefaultCpuDispatcherComputeAffinityMasks.
+
+@see PxDefaultCpuDispatcherComputeAffinityMasks
+*/
+struct PxThreadPlacement
+{
+	enum Enum
+	{
+		eDEFAULT,				//!< No affinity, the OS schedules the threads (same as the default masks)
+		ePHYSICAL_CORES_FIRST,	//!< One thread per physical core, filling a node before moving to the next. SMT siblings are only used once every core has a thread
+		eSINGLE_NODE			//!< Like ePHYSICAL_CORES_FIRST, but only using the CPUs of one node (socket)
+	};
+};
+
+/**
+\brief Computes affinity masks for PxDefaultCpuDispatcherCreate or PxWorkStealingCpuDispatcherCreate from the CPU topology.
+
+The topology is read from sysfs on Linux and from GetLogicalProcessorInformation on Windows. Nodes are the physical packages (sockets).
+Since affinity masks are 32 bits wide, only the first 32 logical CPUs are considered.
+
+To keep each scene on its own socket, create a dispatcher per scene with eSINGLE_NODE and a different node for each.
+Tasks submitted from a worker go to the worker's own queue, so the work of a scene then stays on its node.
+
+\param[out] affinityMasks Array receiving one mask per thread.
+\param[in] numThreads Number of worker threads. CPUs are reused in the same order when there are more threads than CPUs.
+\param[in] placement Placement policy.
+\param[in] node Node used by eSINGLE_NODE, wrapped around the node count.
+
+\return The number of distinct CPUs used, or 0 if the topology is not known (or with eDEFAULT), in which case every mask is 0.
+
+@see PxThreadPlacement PxGetCpuNodeCount
+*/
+PxU32 PxDefaultCpuDispatcherComputeAffinityMasks(PxU32* affinityMasks, PxU32 numThreads, PxThreadPlacement::Enum placement, PxU32 node = 0);
+
+/**
+\brief Returns the number of nodes (sockets) seen by PxDefaultCpuDispatcherComputeAffinityMasks, or 0 if the topology is not known.
 */
-PxDefaultCpuDispatcher* PxDefaultCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks = NULL);
+PxU32 PxGetCpuNodeCount();
 
 #if !PX_DOXYGEN
 } // namespace physx
@@ -122,6 +122,25 @@ PxFilterFlags PxDefaultSimulationFilterShader(
 	const void* constantBlock,
 	PxU32 constantBlockSize);
 
+/**
+\brief Batched version of #PxDefaultSimulationFilterShader, evaluating the filter equation of four pairs at a time with SIMD.
+
+Set it as #PxSceneDesc.filterBatchShader along with PxDefaultSimulationFilterShader as #PxSceneDesc.filterShader.
+
+@see PxSimulationFilterBatchShader PxDefaultSimulationFilterShader
+*/
+
+void PxDefaultSimulationFilterBatchShader(
+	PxU32 nbPairs,
+	const PxFilterObjectAttributes* attributes0,
+	const PxFilterData* filterData0,
+	const PxFilterObjectAttributes* attributes1,
+	const PxFilterData* filterData1,
+	PxPairFlags* pairFlags,
+	PxFilterFlags* filterFlags,
+	const void* constantBlock,
+	PxU32 constantBlockSize);
+
 /**
 	\brief Determines if collision detection is performed between a pair of groups
 
@@ -97,35 +97,57 @@ private:
 
 
 
+/**
+\brief default size of the buffers of the file streams
+*/
+static const PxU32 PX_DEFAULT_FILE_BUFFER_SIZE = 64*1024;
+
 /** 
 \brief default implementation of a file write stream
 
+Serialization and cooking write many small fields, so they are gathered in a buffer written to the file in large blocks.
+The buffer is written when it is full, when flush() is called and when the stream is deleted.
+
 @see PxOutputStream
 */
 
 class PxDefaultFileOutputStream: public PxOutputStream
 {
 public:
-						PxDefaultFileOutputStream(const char* name);
+						PxDefaultFileOutputStream(const char* name, PxU32 bufferSize = PX_DEFAULT_FILE_BUFFER_SIZE);
 	virtual				~PxDefaultFileOutputStream();
 
 	virtual		PxU32	write(const void* src, PxU32 count);
 	virtual		bool	isValid();
+
+	/**
+	\brief Writes the buffered data to the file.
+	\return false if the file could not be written
+	*/
+				bool	flush();
 private:
+		PxDefaultFileOutputStream(const PxDefaultFileOutputStream&);
+		PxDefaultFileOutputStream& operator=(const PxDefaultFileOutputStream&);
+
 		PxFileHandle	mFile;
+		PxU8*			mBuffer;
+		PxU32			mBufferSize;
+		PxU32			mBufferCount;
 };
 
 
 /** 
 \brief default implementation of a file read stream
 
+The file is read in large blocks, small reads and seeks within the current block don't access the file.
+
 @see PxInputData
 */
 
 class PxDefaultFileInputData: public PxInputData
 {
 public:
-						PxDefaultFileInputData(const char* name);
+						PxDefaultFileInputData(const char* name, PxU32 bufferSize = PX_DEFAULT_FILE_BUFFER_SIZE);
 	virtual				~PxDefaultFileInputData();
 
 	virtual		PxU32	read(void* dest, PxU32 count);
@@ -135,8 +157,57 @@ public:
 				
 				bool	isValid() const;
 private:
+		PxDefaultFileInputData(const PxDefaultFileInputData&);
+		PxDefaultFileInputData& operator=(const PxDefaultFileInputData&);
+
 		PxFileHandle	mFile;
 		PxU32			mLength;
+		PxU8*			mBuffer;
+		PxU32			mBufferSize;
+		PxU32			mBufferStart;	// file offset of the buffered block
+		PxU32			mBufferCount;	// bytes in the buffered block
+		PxU32			mPos;
+		PxU32			mFilePos;		// offset of the file handle, to skip redundant seeks
+};
+
+
+/** 
+\brief file read stream mapping the file in memory
+
+The file is mapped read-only and the system is told it is read sequentially, so it pages the file in ahead of the
+reads in the background. getData() gives access to the whole file without copying, e.g. for PxDefaultMemoryInputData
+users or to create objects straight from the mapped bytes.
+
+The file must not be modified while the stream exists.
+
+@see PxInputData, PxDefaultFileInputData
+*/
+
+class PxDefaultMappedFileInputData: public PxInputData
+{
+public:
+						PxDefaultMappedFileInputData(const char* name);
+	virtual				~PxDefaultMappedFileInputData();
+
+	virtual		PxU32	read(void* dest, PxU32 count);
+	virtual		void	seek(PxU32 pos);
+	virtual		PxU32	tell() const;
+	virtual		PxU32	getLength() const;
+
+				bool	isValid() const;
+
+	/**
+	\brief Returns the mapped file, getLength() bytes or NULL if the file could not be mapped.
+	*/
+		const	PxU8*	getData() const	{ return mData; }
+private:
+		PxDefaultMappedFileInputData(const PxDefaultMappedFileInputData&);
+		PxDefaultMappedFileInputData& operator=(const PxDefaultMappedFileInputData&);
+
+		const PxU8*		mData;
+		PxU32			mLength;
+		PxU32			mPos;
+		void*			mMapping;	// mapping handle on Windows
 };
 
 #if !PX_DOXYGEN
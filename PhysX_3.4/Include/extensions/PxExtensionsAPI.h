@@ -53,14 +53,19 @@
 #include "extensions/PxTriangleMeshExt.h"
 #include "extensions/PxSerialization.h"
 #include "extensions/PxDefaultCpuDispatcher.h"
+#include "extensions/PxExternalCpuDispatcher.h"
+#include "extensions/PxTraceProfiler.h"
 #include "extensions/PxSmoothNormals.h"
 #include "extensions/PxSimpleFactory.h"
 #include "extensions/PxStringTableExt.h"
 #include "extensions/PxClothFabricCooker.h"
 #include "extensions/PxBroadPhaseExt.h"
 #include "extensions/PxClothMeshQuadifier.h"
+#include "extensions/PxClothLod.h"
 #include "extensions/PxMassProperties.h"
 #include "extensions/PxSceneQueryExt.h"
+#include "extensions/PxImmediatePairCache.h"
+#include "extensions/PxImmediateScene.h"
 
 /** \brief Initialize the PhysXExtensions library. 
 
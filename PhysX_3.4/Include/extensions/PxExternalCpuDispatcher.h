@@ -0,0 +1,112 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_EXTERNAL_CPU_DISPATCHER_H
+#define PX_PHYSICS_EXTENSIONS_EXTERNAL_CPU_DISPATCHER_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "common/PxPhysXCommonConfig.h"
+#include "extensions/PxDefaultCpuDispatcher.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxExternalCpuDispatcher;
+
+/**
+\brief Interface to an external (e.g. fiber based) job system, used by PxExternalCpuDispatcher.
+
+@see PxExternalCpuDispatcherCreate
+*/
+class PxExternalJobSystem
+{
+public:
+	/**
+	\brief Schedules a task of the SDK as a job.
+
+	The job must call PxExternalCpuDispatcher::executeTask() exactly once, from any thread or fiber.
+	Tasks are small and must not be delayed behind long jobs, the SDK might be waiting for them.
+
+	\param[in] dispatcher The dispatcher the task was submitted to.
+	\param[in] task The task to execute.
+	*/
+	virtual void submitJob(PxExternalCpuDispatcher& dispatcher, PxBaseTask& task) = 0;
+
+	/**
+	\brief Returns the number of jobs that can run in parallel, used by the SDK to split its work.
+	*/
+	virtual PxU32 getWorkerCount() const = 0;
+
+	/**
+	\brief Suspends the calling job until isDone(userData) returns true, running other jobs meanwhile.
+
+	Called when the SDK would otherwise block the thread, see PxCpuDispatcher::waitUntil().
+
+	\return False if the calling thread can't be suspended (e.g. it is not a fiber), in which case the SDK blocks it.
+	*/
+	virtual bool yieldUntil(PxWaitConditionFunction isDone, void* userData) = 0;
+
+protected:
+	virtual ~PxExternalJobSystem() {}
+};
+
+/**
+\brief A dispatcher forwarding the tasks of the SDK to an external job system, which avoids running two thread pools on the same cores.
+
+@see PxExternalCpuDispatcherCreate PxExternalJobSystem
+*/
+class PxExternalCpuDispatcher : public PxDefaultCpuDispatcher
+{
+public:
+	/**
+	\brief Runs a task submitted through PxExternalJobSystem::submitJob() and releases it.
+	*/
+	virtual void executeTask(PxBaseTask& task) = 0;
+};
+
+/**
+\brief Create a dispatcher running the tasks of the SDK on an external job system, extensions SDK needs to be initialized first.
+
+\param[in] jobSystem The job system, must outlive the dispatcher.
+
+@see PxExternalCpuDispatcher PxExternalJobSystem
+*/
+PxExternalCpuDispatcher* PxExternalCpuDispatcherCreate(PxExternalJobSystem& jobSystem);
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
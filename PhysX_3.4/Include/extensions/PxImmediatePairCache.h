@@ -0,0 +1,216 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_IMMEDIATE_PAIR_CACHE_H
+#define PX_PHYSICS_EXTENSIONS_IMMEDIATE_PAIR_CACHE_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "common/PxPhysXCommonConfig.h"
+#include "collision/PxCollisionDefs.h"
+#include "solver/PxSolverDefs.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+#define PX_INVALID_IMMEDIATE_PAIR 0xffffffff
+
+/**
+\brief Persistent state of a pair, kept by PxImmediatePairCache from one step to the next.
+*/
+struct PxImmediatePair
+{
+	PxCache		cache;				//!< Contact cache, to pass to immediate::PxGenerateContacts with PxImmediatePairCacheAllocator
+	PxU8*		frictionPatches;	//!< Friction patches of the last step, to pass as PxSolverContactDesc::frictionPtr
+	PxU8		nbFrictionPatches;	//!< Number of friction patches, to pass as PxSolverContactDesc::frictionCount
+	PxU32		id0;				//!< Lowest id of the pair
+	PxU32		id1;				//!< Highest id of the pair
+};
+
+/**
+\brief Keeps the contact caches and the friction patches of the immediate mode pairs.
+
+A pair is identified by the ids of its two objects (e.g. body indices), in any order, and gets a handle that stays the same for as long as the pair lives.
+The cache and friction data of each pair live in blocks of pooled memory owned by the pair, so that they stay valid from one step to the next
+without double buffering whole frames, and are recycled as soon as the pair is removed.
+
+A step typically does:
+\li acquirePair() for every pair found by the broad phase,
+\li evictStalePairs() to drop the pairs that were not acquired,
+\li immediate::PxGenerateContacts() on each pair with a PxImmediatePairCacheAllocator,
+\li immediate::PxCreateContactConstraints() with the friction patches of the pairs and a PxImmediateFrictionRecorder, then
+PxImmediateFrictionRecorder::storeFrictionPatches() for each pair.
+
+\note acquirePair(), removePair(), removePairs() and evictStalePairs() are not thread safe. The other calls can run in parallel on different pairs.
+
+@see PxImmediatePairCacheCreate PxImmediatePairCacheAllocator PxImmediateFrictionRecorder
+*/
+class PxImmediatePairCache
+{
+public:
+	/**
+	\brief Releases the cache and all the pair memory.
+	*/
+	virtual void				release() = 0;
+
+	/**
+	\brief Returns the handle of the pair of id0 and id1, creating it if needed, and marks it as used by the current step.
+	*/
+	virtual PxU32				acquirePair(PxU32 id0, PxU32 id1) = 0;
+
+	/**
+	\brief Returns the handle of the pair of id0 and id1, or PX_INVALID_IMMEDIATE_PAIR.
+	*/
+	virtual PxU32				findPair(PxU32 id0, PxU32 id1) const = 0;
+
+	/**
+	\brief Returns the persistent state of a pair.
+	*/
+	virtual PxImmediatePair&	getPair(PxU32 pair) = 0;
+
+	/**
+	\brief Drops the contact cache and the friction patches of a pair, e.g. when one of its objects is teleported.
+	*/
+	virtual void				resetPair(PxU32 pair) = 0;
+
+	/**
+	\brief Removes a pair, its memory is recycled right away.
+	*/
+	virtual void				removePair(PxU32 pair) = 0;
+
+	/**
+	\brief Removes all the pairs of an object, e.g. when it is released. Returns the number of removed pairs.
+	*/
+	virtual PxU32				removePairs(PxU32 id) = 0;
+
+	/**
+	\brief Removes the pairs that were not acquired since the last call, and starts a new step. Returns the number of removed pairs.
+	*/
+	virtual PxU32				evictStalePairs() = 0;
+
+	/**
+	\brief Number of pairs.
+	*/
+	virtual PxU32				getNbPairs() const = 0;
+
+	/**
+	\brief Returns memory for the contact cache of a pair, used by PxImmediatePairCacheAllocator.
+
+	Each pair owns two blocks and alternates between them, the contact generation reads the old cache while it writes the new one.
+	*/
+	virtual PxU8*				allocateCacheData(PxU32 pair, PxU32 byteSize) = 0;
+
+	/**
+	\brief Copies the friction patches produced by the constraint preparation into the memory of a pair, NULL patches clear them.
+	*/
+	virtual void				storeFrictionPatches(PxU32 pair, const PxU8* patches, PxU32 nbPatches, PxU32 byteSize) = 0;
+
+protected:
+	virtual						~PxImmediatePairCache() {}
+};
+
+/**
+\brief Cache allocator of a pair, to pass to immediate::PxGenerateContacts for that pair only.
+*/
+class PxImmediatePairCacheAllocator : public PxCacheAllocator
+{
+public:
+	PxImmediatePairCacheAllocator(PxImmediatePairCache& cache, PxU32 pair) : mCache(cache), mPair(pair) {}
+
+	virtual PxU8*	allocateCacheData(const PxU32 byteSize)	{ return mCache.allocateCacheData(mPair, byteSize);	}
+
+private:
+	PxImmediatePairCacheAllocator& operator=(const PxImmediatePairCacheAllocator&);
+
+	PxImmediatePairCache&	mCache;
+	PxU32					mPair;
+};
+
+/**
+\brief Constraint allocator recording the friction allocations of immediate::PxCreateContactConstraints, to copy them into the pairs afterwards.
+
+The constraint and friction memory comes from the wrapped allocator, and only needs to live until the patches are stored.
+
+\code
+recorder.reset();
+PxCreateContactConstraints(&header, 1, contactDescs, recorder, ...);
+for(PxU32 i = 0; i < header.mStride; i++)
+	recorder.storeFrictionPatches(pairs[i], contactDescs[i]);
+\endcode
+*/
+class PxImmediateFrictionRecorder : public PxConstraintAllocator
+{
+public:
+	PxImmediateFrictionRecorder(PxImmediatePairCache& cache, PxConstraintAllocator& allocator) : mCache(cache), mAllocator(allocator), mNbBlocks(0) {}
+
+	virtual PxU8*	reserveConstraintData(const PxU32 byteSize)	{ return mAllocator.reserveConstraintData(byteSize);	}
+	virtual PxU8*	reserveFrictionData(const PxU32 byteSize);
+
+	/**
+	\brief Forgets the recorded friction allocations, call before each immediate::PxCreateContactConstraints.
+	*/
+	void			reset()	{ mNbBlocks = 0;	}
+
+	/**
+	\brief Stores the friction patches produced for a contact desc in its pair.
+	*/
+	void			storeFrictionPatches(PxU32 pair, const PxSolverContactDesc& desc);
+
+private:
+	PxImmediateFrictionRecorder& operator=(const PxImmediateFrictionRecorder&);
+
+	struct Block
+	{
+		PxU8*	data;
+		PxU32	size;
+	};
+
+	PxImmediatePairCache&	mCache;
+	PxConstraintAllocator&	mAllocator;
+	Block					mBlocks[4];		// a batch header has up to 4 pairs
+	PxU32					mNbBlocks;
+};
+
+/**
+\brief Creates an immediate mode pair cache, extensions SDK needs to be initialized first.
+
+@see PxImmediatePairCache
+*/
+PxImmediatePairCache* PxImmediatePairCacheCreate();
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
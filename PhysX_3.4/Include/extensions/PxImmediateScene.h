@@ -0,0 +1,382 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_IMMEDIATE_SCENE_H
+#define PX_PHYSICS_EXTENSIONS_IMMEDIATE_SCENE_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "common/PxPhysXCommonConfig.h"
+#include "common/PxTolerancesScale.h"
+#include "foundation/PxTransform.h"
+#include "PxConstraintDesc.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxCpuDispatcher;
+class PxGeometry;
+
+/**
+\brief Handle of a body or a joint of a PxImmediateScene.
+
+Handles of removed bodies and joints are reused by the next additions.
+*/
+typedef PxU32 PxImmediateHandle;
+
+#define PX_INVALID_IMMEDIATE_HANDLE 0xffffffff
+
+/**
+\brief Descriptor of a PxImmediateScene.
+
+@see PxImmediateSceneCreate
+*/
+class PxImmediateSceneDesc
+{
+public:
+	/**
+	\brief Gravity applied to the dynamic bodies.
+	*/
+	PxVec3				gravity;
+
+	/**
+	\brief Dispatcher running the tasks of PxImmediateScene::step(). NULL runs everything on the thread calling step().
+
+	The dispatcher is not owned by the scene and must outlive it.
+	*/
+	PxCpuDispatcher*	cpuDispatcher;
+
+	/**
+	\brief Distance at which contacts are generated. The broad phase bounds are inflated by half this distance.
+
+	<b>Default:</b> 0.04 * PxTolerancesScale::length
+	*/
+	PxReal				contactDistance;
+
+	/**
+	\brief Mesh contact margin, see immediate::PxGenerateContacts.
+
+	<b>Default:</b> 0.01 * PxTolerancesScale::length
+	*/
+	PxReal				meshContactMargin;
+
+	/**
+	\brief Tolerance length, see immediate::PxGenerateContacts.
+
+	<b>Default:</b> PxTolerancesScale::length
+	*/
+	PxReal				toleranceLength;
+
+	/**
+	\brief Relative normal velocity above which restitution is applied.
+
+	<b>Default:</b> 0.2 * PxTolerancesScale::speed
+	*/
+	PxReal				bounceThreshold;
+
+	/**
+	\brief Contacts closer than this distance generate friction, see immediate::PxCreateContactConstraints.
+
+	<b>Default:</b> 0.04 * PxTolerancesScale::length
+	*/
+	PxReal				frictionOffsetThreshold;
+
+	/**
+	\brief Correlation distance of the friction patches, see immediate::PxCreateContactConstraints.
+
+	<b>Default:</b> 0.025 * PxTolerancesScale::length
+	*/
+	PxReal				correlationDistance;
+
+	/**
+	\brief Number of position iterations of the solver.
+
+	<b>Default:</b> 4
+	*/
+	PxU32				nbPositionIterations;
+
+	/**
+	\brief Number of velocity iterations of the solver.
+
+	<b>Default:</b> 1
+	*/
+	PxU32				nbVelocityIterations;
+
+	/**
+	\brief Number of pairs sent to immediate::PxGenerateContacts by each contact generation task.
+
+	<b>Default:</b> 256
+	*/
+	PxU32				pairsPerTask;
+
+	/**
+	\brief Number of dynamic bodies solved by each solver task. Islands are never split, so a task can get more bodies than this.
+
+	<b>Default:</b> 256
+	*/
+	PxU32				bodiesPerTask;
+
+	PX_INLINE PxImmediateSceneDesc(const PxTolerancesScale& scale);
+
+	/**
+	\brief Returns true if the descriptor is valid.
+	*/
+	PX_INLINE bool isValid() const;
+};
+
+PX_INLINE PxImmediateSceneDesc::PxImmediateSceneDesc(const PxTolerancesScale& scale) :
+	gravity					(0.0f),
+	cpuDispatcher			(NULL),
+	contactDistance			(0.04f * scale.length),
+	meshContactMargin		(0.01f * scale.length),
+	toleranceLength			(scale.length),
+	bounceThreshold			(0.2f * scale.speed),
+	frictionOffsetThreshold	(0.04f * scale.length),
+	correlationDistance		(0.025f * scale.length),
+	nbPositionIterations	(4),
+	nbVelocityIterations	(1),
+	pairsPerTask			(256),
+	bodiesPerTask			(256)
+{
+}
+
+PX_INLINE bool PxImmediateSceneDesc::isValid() const
+{
+	if(!gravity.isFinite())
+		return false;
+	if(contactDistance <= 0.0f || meshContactMargin <= 0.0f || toleranceLength <= 0.0f)
+		return false;
+	if(bounceThreshold < 0.0f || frictionOffsetThreshold < 0.0f || correlationDistance < 0.0f)
+		return false;
+	if(nbPositionIterations == 0 || pairsPerTask == 0 || bodiesPerTask == 0)
+		return false;
+	return true;
+}
+
+/**
+\brief Descriptor of a body of a PxImmediateScene. A body has a single shape.
+
+Bodies with a zero inverse mass are static, they are neither moved by the solver nor integrated.
+
+@see PxImmediateScene::addBody
+*/
+class PxImmediateBodyDesc
+{
+public:
+	const PxGeometry*	geometry;					//!< Geometry of the shape, copied. Meshes and height fields must outlive the body
+	PxTransform			pose;						//!< World pose of the body, which is also its mass frame
+	PxTransform			shapeLocalPose;				//!< Pose of the shape relative to the body
+	PxVec3				linearVelocity;				//!< Initial linear velocity
+	PxVec3				angularVelocity;			//!< Initial angular velocity
+	PxReal				invMass;					//!< Inverse mass, 0 for a static body
+	PxVec3				invInertia;					//!< Mass space inverse inertia diagonal
+	PxReal				linearDamping;				//!< Linear damping coefficient
+	PxReal				angularDamping;				//!< Angular damping coefficient
+	PxReal				maxLinearVelocity;			//!< Maximum linear velocity
+	PxReal				maxAngularVelocity;			//!< Maximum angular velocity
+	PxReal				maxDepenetrationVelocity;	//!< Maximum velocity the solver uses to resolve penetrations
+	PxReal				maxContactImpulse;			//!< Maximum impulse of a contact on the body
+	PxReal				staticFriction;				//!< Static friction, averaged with the other body of a pair
+	PxReal				dynamicFriction;			//!< Dynamic friction, averaged with the other body of a pair
+	PxReal				restitution;				//!< Restitution, averaged with the other body of a pair
+	PxU32				collisionGroup;				//!< Bodies sharing a non zero group don't collide, e.g. the parts of a ragdoll
+	void*				userData;					//!< User data
+
+	PX_INLINE PxImmediateBodyDesc();
+
+	/**
+	\brief Returns true if the descriptor is valid.
+	*/
+	PX_INLINE bool isValid() const;
+};
+
+PX_INLINE PxImmediateBodyDesc::PxImmediateBodyDesc() :
+	geometry					(NULL),
+	pose						(PxIdentity),
+	shapeLocalPose				(PxIdentity),
+	linearVelocity				(0.0f),
+	angularVelocity				(0.0f),
+	invMass						(0.0f),
+	invInertia					(0.0f),
+	linearDamping				(0.0f),
+	angularDamping				(0.05f),
+	maxLinearVelocity			(PX_MAX_F32),
+	maxAngularVelocity			(100.0f),
+	maxDepenetrationVelocity	(PX_MAX_F32),
+	maxContactImpulse			(PX_MAX_F32),
+	staticFriction				(0.5f),
+	dynamicFriction				(0.5f),
+	restitution					(0.0f),
+	collisionGroup				(0),
+	userData					(NULL)
+{
+}
+
+PX_INLINE bool PxImmediateBodyDesc::isValid() const
+{
+	if(!geometry || !pose.isSane() || !shapeLocalPose.isSane())
+		return false;
+	if(!linearVelocity.isFinite() || !angularVelocity.isFinite())
+		return false;
+	if(invMass < 0.0f || !invInertia.isFinite() || invInertia.minElement() < 0.0f)
+		return false;
+	if(linearDamping < 0.0f || angularDamping < 0.0f || maxLinearVelocity < 0.0f || maxAngularVelocity < 0.0f)
+		return false;
+	if(maxDepenetrationVelocity <= 0.0f || maxContactImpulse < 0.0f)
+		return false;
+	if(staticFriction < 0.0f || dynamicFriction < 0.0f || restitution < 0.0f || restitution > 1.0f)
+		return false;
+	return true;
+}
+
+/**
+\brief Descriptor of a joint of a PxImmediateScene.
+
+The rows of the joint are generated by the solver prep shader, with the body poses as frames (which are also the mass frames).
+
+@see PxImmediateScene::addJoint
+*/
+class PxImmediateJointDesc
+{
+public:
+	PxImmediateHandle		body0;			//!< First body, dynamic
+	PxImmediateHandle		body1;			//!< Second body, dynamic or static
+	PxConstraintSolverPrep	solverPrep;		//!< Shader generating the rows of the joint
+	const void*				constantBlock;	//!< Passed to the shader, must outlive the joint
+	PxReal					minResponseThreshold;	//!< Rows with a lower response are dropped, see PxConstraint::setMinResponseThreshold
+
+	PX_INLINE PxImmediateJointDesc() :
+		body0(PX_INVALID_IMMEDIATE_HANDLE), body1(PX_INVALID_IMMEDIATE_HANDLE), solverPrep(NULL), constantBlock(NULL), minResponseThreshold(0.0f)
+	{
+	}
+};
+
+/**
+\brief A minimal scene built on the immediate mode API.
+
+Each step() runs the broad phase, the contact generation, the constraint preparation, the solver and the integration,
+spreading the work of each stage over the tasks of the dispatcher of the descriptor:
+
+\li The broad phase sorts the bounds along the x axis and sweeps ranges of the sorted bodies in parallel.
+\li The overlapping pairs are cut in batches of PxImmediateSceneDesc::pairsPerTask pairs for the contact generation.
+\li The islands of bodies connected by contacts or joints are grouped in tasks of about PxImmediateSceneDesc::bodiesPerTask bodies,
+each task preparing, solving and integrating its islands. Many small independent islands (e.g. ragdolls) therefore scale with the worker count.
+
+The contact caches and the friction patches of the pairs are kept in a PxImmediatePairCache from one step to the next,
+as long as the bounds of the pair overlap. The solver then warm starts from the friction anchors of the last step.
+
+\note The scene is not thread safe, step() must not run at the same time as other calls.
+
+@see PxImmediateSceneCreate PxImmediateSceneDesc
+*/
+class PxImmediateScene
+{
+public:
+	/**
+	\brief Releases the scene.
+	*/
+	virtual void				release() = 0;
+
+	/**
+	\brief Adds a body, returns its handle or PX_INVALID_IMMEDIATE_HANDLE if the descriptor is invalid.
+	*/
+	virtual PxImmediateHandle	addBody(const PxImmediateBodyDesc& desc) = 0;
+
+	/**
+	\brief Removes a body, and the joints attached to it.
+	*/
+	virtual void				removeBody(PxImmediateHandle body) = 0;
+
+	/**
+	\brief Adds a joint, returns its handle or PX_INVALID_IMMEDIATE_HANDLE if the descriptor is invalid.
+	*/
+	virtual PxImmediateHandle	addJoint(const PxImmediateJointDesc& desc) = 0;
+
+	/**
+	\brief Removes a joint.
+	*/
+	virtual void				removeJoint(PxImmediateHandle joint) = 0;
+
+	/**
+	\brief Moves a body. Teleporting a body resets the contact caches and the friction patches of its pairs.
+	*/
+	virtual void				setBodyPose(PxImmediateHandle body, const PxTransform& pose) = 0;
+	virtual PxTransform			getBodyPose(PxImmediateHandle body) const = 0;
+
+	virtual void				setBodyVelocity(PxImmediateHandle body, const PxVec3& linearVelocity, const PxVec3& angularVelocity) = 0;
+	virtual PxVec3				getBodyLinearVelocity(PxImmediateHandle body) const = 0;
+	virtual PxVec3				getBodyAngularVelocity(PxImmediateHandle body) const = 0;
+
+	virtual void*				getBodyUserData(PxImmediateHandle body) const = 0;
+
+	/**
+	\brief Simulates the scene, blocking until the step is over.
+
+	The calling thread runs tasks too, so the dispatcher may have zero workers.
+	*/
+	virtual void				step(PxReal dt) = 0;
+
+	/**
+	\brief Number of bodies.
+	*/
+	virtual PxU32				getNbBodies() const = 0;
+
+	/**
+	\brief Number of pairs found by the broad phase, and the number of them touching, in the last step.
+	*/
+	virtual void				getNbPairs(PxU32& nbPairs, PxU32& nbTouchingPairs) const = 0;
+
+	/**
+	\brief Number of islands solved in the last step.
+	*/
+	virtual PxU32				getNbIslands() const = 0;
+
+protected:
+	virtual						~PxImmediateScene() {}
+};
+
+/**
+\brief Creates an immediate mode scene, extensions SDK needs to be initialized first.
+
+\return The scene, or NULL if the descriptor is invalid.
+
+@see PxImmediateScene PxImmediateSceneDesc
+*/
+PxImmediateScene* PxImmediateSceneCreate(const PxImmediateSceneDesc& desc);
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
@@ -64,6 +64,10 @@ namespace physx
 	Finally, since it is using the SDK's scene queries under the hood, it only works provided the simulation shapes also have
 	scene-query shapes associated with them. That is, if the objects in the scene only use PxShapeFlag::eSIMULATION_SHAPE
 	(and no PxShapeFlag::eSCENE_QUERY_SHAPE), then the raycast-CCD system will not work.
+
+	The queries of all the objects are made against the scene as the simulation left it, and the corrections are then applied
+	in registration order. With many moving objects, the queries run on the worker threads of the scene's CPU dispatcher
+	(except for scenes with PxSceneFlag::eREQUIRE_RW_LOCK), with the same result as on a single thread.
 	*/
 	class RaycastCCDManager
 	{
@@ -74,12 +78,16 @@ namespace physx
 			/**
 			\brief Register dynamic object for raycast CCD.
 
-			\param[in] actor	object's actor
-			\param[in] shape	object's shape
+			Thin objects (plates, shells) are not reliably caught by a ray from their center, and can sweep their shape instead.
+			The sweep is more expensive, and assumes the object doesn't overlap anything where it was on the previous frame.
+
+			\param[in] actor		object's actor
+			\param[in] shape		object's shape
+			\param[in] useSweep	True to sweep the shape instead of casting a ray from its center
 
 			\return True if success
 			*/
-			bool	registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape);
+			bool	registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape, bool useSweep = false);
 
 			/**
 			\brief Perform raycast CCD. Call this after your simulate/fetchResults calls.
@@ -108,6 +108,23 @@ public:
 	@see PxRigidBody::setMassLocalPose PxRigidBody::setMassSpaceInertiaTensor PxRigidBody::setMass
 	*/
 	static		bool			updateMassAndInertia(PxRigidBody& body, PxReal density, const PxVec3* massLocalPose = NULL, bool includeNonSimShapes = false);
+
+	/**
+	\brief Computation of mass properties for an array of rigid body actors
+
+	Same as the single density updateMassAndInertia() for each body, with the mass properties of the convex meshes looked up
+	once per mesh for the whole batch. Meant for spawning many bodies sharing their convex meshes at once, e.g. fracture pieces.
+
+	\param[in,out] bodies The rigid bodies.
+	\param[in] nbBodies The number of rigid bodies.
+	\param[in] densities The density of each body. The densities must be greater than 0.
+	\param[in] massLocalPoses The center of mass of each body relative to its actor frame. If set to null the center of mass is computed from the shapes.
+	\param[in] includeNonSimShapes True if all kind of shapes (PxShapeFlag::eSCENE_QUERY_SHAPE, PxShapeFlag::eTRIGGER_SHAPE, PxShapeFlag::ePARTICLE_DRAIN) should be taken into account.
+	\return The number of bodies updated successfully. The others get a mass of 1 and an inertia tensor of (1,1,1), as with the single body version.
+
+	@see updateMassAndInertia
+	*/
+	static		PxU32			updateMassAndInertia(PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* densities, const PxVec3* massLocalPoses = NULL, bool includeNonSimShapes = false);
 	
 
 	/**
@@ -55,7 +55,7 @@ The following binary format versions are compatible with the current physics ver
 The PX_BINARY_SERIAL_VERSION for a given PhysX release is typically 0. If incompatible modifications are made to a customer specific branch the
 number should be increased.
 */
-#define PX_BINARY_SERIAL_VERSION 0
+#define PX_BINARY_SERIAL_VERSION 1
 
 
 #if !PX_DOXYGEN
@@ -63,6 +63,86 @@ namespace physx
 {
 #endif
 
+class PxCpuDispatcher;
+
+/**
+\brief A binary collection file mapped into memory.
+
+The file is mapped copy-on-write: pages are only read from the file when they are first accessed, and pages that are
+never written stay shared with the file cache, so processes mapping the same file share a single physical copy of them.
+Deserialization creates the objects in place, which gives each process a private copy of the pages holding the objects,
+while the extra data following them (mesh vertices, triangles and midphase structures, height field samples...) is only read.
+
+The mapping must stay alive while objects deserialized from it exist, and the file must not be modified meanwhile.
+
+@see PxSerialization::createBinaryFileMapping, PxSerialization::createCollectionFromBinary
+*/
+class PxBinaryFileMapping
+{
+public:
+	/**
+	\brief Returns the start of the mapped file, which is page aligned and can be passed to PxSerialization::createCollectionFromBinary.
+	*/
+	virtual	void*			getData() const = 0;
+
+	/**
+	\brief Returns the size of the mapped file in bytes.
+	*/
+	virtual	PxU64			getSize() const = 0;
+
+	/**
+	\brief Unmaps the file. Objects deserialized from it must be released first.
+	*/
+	virtual	void			release() = 0;
+
+protected:
+	virtual					~PxBinaryFileMapping() {}
+};
+
+/**
+\brief Deserializes a binary collection over several calls, to spread the cost of loading a big collection across frames.
+
+The header and the reference tables are read when the deserializer is created, then each call to deserializeObjects
+creates the next objects of the collection in place. The collection is added to the physics SDK (see PxAddCollectionToPhysics)
+once the last object is created, and can then be retrieved and added to a scene, for example with the budgeted PxScene::addCollection.
+
+The memory block must stay valid as long as the objects exist, as with PxSerialization::createCollectionFromBinary.
+
+@see PxSerialization::createBinaryDeserializer, PxScene::addCollection
+*/
+class PxBinaryDeserializer
+{
+public:
+	/**
+	\brief Creates the next objects of the collection.
+
+	\param[in] maxObjects Maximum number of objects to create in this call
+	\return False if an object couldn't be created, in which case the deserialization is aborted
+	*/
+	virtual	bool			deserializeObjects(PxU32 maxObjects) = 0;
+
+	/**
+	\brief Returns the number of objects still to be created, the deserialization is complete once it reaches 0.
+	*/
+	virtual	PxU32			getNbObjectsLeft() const = 0;
+
+	/**
+	\brief Returns the deserialized collection once complete, or NULL. The caller owns the collection afterwards.
+	*/
+	virtual	PxCollection*	getCollection() = 0;
+
+	/**
+	\brief Deletes the deserializer.
+
+	If the deserialization didn't complete, the partial collection is released. As for a failed PxSerialization::createCollectionFromBinary,
+	the objects already created in the memory block are then left as they are.
+	*/
+	virtual	void			release() = 0;
+
+protected:
+	virtual					~PxBinaryDeserializer() {}
+};
+
 /**
 \brief Utility functions for serialization
 
@@ -142,13 +222,18 @@ public:
 	Specifying followJoints will make whole jointed actor chains being added to the collection. Following chains 
 	is interrupted whenever a object in exceptFor is encountered.
 
+	With a dispatcher, the required objects of large collections are gathered on the worker threads. The objects 
+	of the collection are only read meanwhile and must not be modified by other threads. The result is the same 
+	as without a dispatcher.
+
 	\param[in,out] collection Collection which is completed
 	\param[in] sr PxSerializationRegistry instance with information about registered classes.
 	\param[in] exceptFor Optional exemption collection
 	\param[in] followJoints Specifies whether joints should be added for jointed actors
+	\param[in] dispatcher Optional dispatcher the gathering of required objects is split on
 	@see PxCollection, PxSerialization::serializeCollectionToBinary, PxSerialization::serializeCollectionToXml, PxSerializationRegistry
 	*/
-	static	void			complete(PxCollection& collection, PxSerializationRegistry& sr, const PxCollection* exceptFor = NULL, bool followJoints = false);
+	static	void			complete(PxCollection& collection, PxSerializationRegistry& sr, const PxCollection* exceptFor = NULL, bool followJoints = false, PxCpuDispatcher* dispatcher = NULL);
 	
 	/**
 	\brief Creates PxSerialObjectId values for unnamed objects in a collection.
@@ -196,6 +281,33 @@ public:
 	*/
 	static	PxCollection*	createCollectionFromBinary(void* memBlock, PxSerializationRegistry& sr, const PxCollection* externalRefs = NULL);
 
+	/**
+	\brief Maps a file written by PxSerialization::serializeCollectionToBinary into memory.
+
+	Instead of loading the whole file into an aligned buffer, pass PxBinaryFileMapping::getData to createCollectionFromBinary.
+	The file is then paged in as the data gets accessed, and the read-only parts are shared between the processes mapping it.
+
+	\param[in] path Path of the binary collection file
+	\return The mapping, or NULL if the file couldn't be mapped or the platform doesn't support file mappings
+
+	@see PxBinaryFileMapping, PxSerialization::createCollectionFromBinary
+	*/
+	static	PxBinaryFileMapping*	createBinaryFileMapping(const char* path);
+
+	/**
+	\brief Creates a deserializer for a collection in memory, which creates the objects over several calls.
+
+	The memory block has the same requirements as for createCollectionFromBinary.
+
+	\param[in] memBlock Pointer to memory block containing the serialized collection
+	\param[in] sr PxSerializationRegistry instance with information about registered classes.
+	\param[in] externalRefs Collection to resolve external dependencies
+	\return The deserializer, or NULL if the header is invalid or external references are missing
+
+	@see PxBinaryDeserializer, PxSerialization::createCollectionFromBinary
+	*/
+	static	PxBinaryDeserializer*	createBinaryDeserializer(void* memBlock, PxSerializationRegistry& sr, const PxCollection* externalRefs = NULL);
+
 	/**
 	\brief Serializes a physics collection to an XML output stream.
 
@@ -0,0 +1,132 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_TRACE_PROFILER_H
+#define PX_PHYSICS_EXTENSIONS_TRACE_PROFILER_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "common/PxPhysXCommonConfig.h"
+#include "foundation/PxProfiler.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxOutputStream;
+
+/**
+\brief Descriptor of the trace profiler.
+
+@see PxTraceProfilerCreate
+*/
+struct PxTraceProfilerDesc
+{
+	PxU32	eventsPerThread;	//!< Capacity of the ring buffer of each thread, rounded up to a power of two. Each event takes 32 bytes
+	PxU32	maxNbThreads;		//!< Number of threads that can record events, events of the threads above the limit are dropped
+
+	PxTraceProfilerDesc() : eventsPerThread(1 << 16), maxNbThreads(64) {}
+
+	bool isValid() const { return eventsPerThread > 0 && maxNbThreads > 0; }
+};
+
+/**
+\brief A lightweight profiler callback recording the SDK profile zones in memory.
+
+Each thread records its zones in its own ring buffer, so recording takes no lock and no atomic operation,
+only two clock reads per zone. When a buffer is full the oldest events are overwritten, so the last
+eventsPerThread events of each thread are always available. The trace can be exported at any time,
+also while the simulation runs, in the Chrome trace event format (chrome://tracing, Perfetto).
+
+Install it with PxSetProfilerCallback(). The profile zones are only compiled in the debug, checked and profile
+builds of the SDK, so a release build records nothing.
+
+\note PxPvd::connect() and PxPvd::disconnect() replace the profiler callback, install the trace profiler again after them.
+
+@see PxTraceProfilerCreate PxSetProfilerCallback
+*/
+class PxTraceProfiler : public PxProfilerCallback
+{
+public:
+	/**
+	\brief Deletes the profiler. It must not be the installed profiler callback anymore.
+	*/
+	virtual void		release() = 0;
+
+	/**
+	\brief Starts or stops the recording. Zones already started when disabling still record their end.
+	*/
+	virtual void		setEnabled(bool enabled) = 0;
+
+	/**
+	\brief Returns true if the profiler records events.
+	*/
+	virtual bool		isEnabled() const = 0;
+
+	/**
+	\brief Discards the recorded events, the next export only contains the events recorded after the call.
+	*/
+	virtual void		clear() = 0;
+
+	/**
+	\brief Writes the recorded events as a Chrome trace JSON document.
+
+	Events overwritten by the recording threads while exporting are skipped.
+
+	\return False if writing to the stream failed.
+	*/
+	virtual bool		exportChromeTrace(PxOutputStream& stream) const = 0;
+
+	/**
+	\brief Returns the number of events dropped because more than maxNbThreads threads recorded events.
+	*/
+	virtual PxU64		getNbDroppedEvents() const = 0;
+
+protected:
+	virtual				~PxTraceProfiler() {}
+};
+
+/**
+\brief Creates a trace profiler, extensions SDK needs to be initialized first.
+
+\return The profiler, or NULL if the descriptor is invalid.
+
+@see PxTraceProfiler PxTraceProfilerDesc
+*/
+PxTraceProfiler* PxTraceProfilerCreate(const PxTraceProfilerDesc& desc = PxTraceProfilerDesc());
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif
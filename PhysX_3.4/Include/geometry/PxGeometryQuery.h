@@ -45,6 +45,7 @@ The reason for this is GJK support cannot be evaluated near infinity. A viable a
 
 #include "common/PxPhysXCommonConfig.h"
 #include "PxQueryReport.h"
+#include "foundation/PxTransform.h"
 
 #if !PX_DOXYGEN
 namespace physx
@@ -57,6 +58,29 @@ struct PxRaycastHit;
 
 class PxTriangle;
 
+/**
+\brief Strided array of geometry objects and poses, one per test of the batched #PxGeometryQuery functions.
+
+All geometry objects of an array must be of the same type, so that the batched queries pick the test once for the whole batch.
+A stride of 0 uses the first element for every test, e.g. to test a single weapon capsule against an array of bone capsules.
+
+@see PxGeometryQuery::overlapBatch PxGeometryQuery::raycastBatch PxGeometryQuery::sweepBatch PxGeometryQuery::computePenetrationBatch
+*/
+struct PxGeometryPoseArray
+{
+	PX_INLINE PxGeometryPoseArray() : geometries(NULL), geometryStride(0), poses(NULL), poseStride(0)	{}
+	PX_INLINE PxGeometryPoseArray(const PxGeometry* geometries_, PxU32 geometryStride_, const PxTransform* poses_, PxU32 poseStride_ = sizeof(PxTransform)) :
+		geometries(geometries_), geometryStride(geometryStride_), poses(poses_), poseStride(poseStride_)	{}
+
+	PX_FORCE_INLINE const PxGeometry&	getGeometry(PxU32 index)	const	{ return *reinterpret_cast<const PxGeometry*>(reinterpret_cast<const PxU8*>(geometries) + index * geometryStride);	}
+	PX_FORCE_INLINE const PxTransform&	getPose(PxU32 index)		const	{ return *reinterpret_cast<const PxTransform*>(reinterpret_cast<const PxU8*>(poses) + index * poseStride);			}
+
+	const PxGeometry*	geometries;		//!< First geometry object
+	PxU32				geometryStride;	//!< Bytes from one geometry object to the next, e.g. sizeof(PxCapsuleGeometry). 0 to use the first one for every test
+	const PxTransform*	poses;			//!< Pose of the first geometry object
+	PxU32				poseStride;		//!< Bytes from one pose to the next. 0 to use the first one for every test
+};
+
 /**
 \brief Collection of geometry object queries (sweeps, raycasts, overlaps, ...).
 */
@@ -214,6 +238,81 @@ public:
 	@see PxGeometry PxSphereGeometry, PxCapsuleGeometry, PxBoxGeometry, PxConvexGeometry
 	*/
 	PX_PHYSX_COMMON_API static bool isValid(const PxGeometry& geom);
+
+	/**
+	\brief Overlap tests for an array of geometry pairs.
+
+	Same as #overlap() for each pair (geoms0[i], geoms1[i]). The test is selected once for the whole batch, and pairs of spheres
+	and capsules are tested four at a time. The same combinations as #overlap() are supported.
+
+	\param[in] nbTests Number of pairs to test
+	\param[in] geoms0 The first geometry objects, all of the same type
+	\param[in] geoms1 The second geometry objects, all of the same type
+	\param[out] results Receives nbTests values, true where the pair overlaps
+	\return Number of overlapping pairs
+
+	@see overlap PxGeometryPoseArray
+	*/
+	PX_PHYSX_COMMON_API static PxU32 overlapBatch(PxU32 nbTests, const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1, bool* PX_RESTRICT results);
+
+	/**
+	\brief Raycasts of an array of rays against an array of geometry objects.
+
+	Same as #raycast() with maxHits = 1 for each ray i against geoms[i]. The test is selected once for the whole batch.
+
+	\param[in] nbTests Number of rays
+	\param[in] origins The origins of the rays
+	\param[in] unitDirs The normalized directions of the rays
+	\param[in] maxDist Maximum ray length, for all rays, has to be in the [0, inf) range
+	\param[in] geoms The geometry objects to test the rays against, all of the same type
+	\param[in] hitFlags Specification of the kind of information to retrieve on hit. Combination of #PxHitFlag flags
+	\param[out] rayHits Receives nbTests hits. A ray that misses gets a distance of PX_MAX_REAL and no flags
+	\return Number of rays hitting their geometry object
+
+	@see raycast PxGeometryPoseArray
+	*/
+	PX_PHYSX_COMMON_API static PxU32 raycastBatch(PxU32 nbTests, const PxVec3* origins, const PxVec3* unitDirs, PxReal maxDist,
+											const PxGeometryPoseArray& geoms, PxHitFlags hitFlags, PxRaycastHit* PX_RESTRICT rayHits);
+
+	/**
+	\brief Sweeps of an array of geometry objects against another one.
+
+	Same as #sweep() for each geoms0[i] swept along unitDirs[i] against geoms1[i]. The test is selected once for the whole batch.
+
+	\param[in] nbTests Number of sweeps
+	\param[in] unitDirs The normalized sweep directions
+	\param[in] maxDist Maximum sweep distance, for all sweeps, has to be in the [0, inf) range
+	\param[in] geoms0 The geometry objects to sweep, all of the same type. Supported geometries are #PxSphereGeometry, #PxCapsuleGeometry, #PxBoxGeometry and #PxConvexMeshGeometry
+	\param[in] geoms1 The geometry objects to sweep against, all of the same type
+	\param[out] sweepHits Receives nbTests hits. A sweep that misses gets a distance of PX_MAX_REAL and no flags
+	\param[in] hitFlags Specify which properties per hit should be computed and written to result hit array. Combination of #PxHitFlag flags
+	\param[in] inflation Surface of the swept shape is additively extruded in the normal direction, rounding corners and edges.
+	\return Number of sweeps hitting their geometry object
+
+	@see sweep PxGeometryPoseArray
+	*/
+	PX_PHYSX_COMMON_API static PxU32 sweepBatch(PxU32 nbTests, const PxVec3* unitDirs, PxReal maxDist,
+											const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1,
+											PxSweepHit* PX_RESTRICT sweepHits, PxHitFlags hitFlags = PxHitFlag::eDEFAULT, PxReal inflation = 0.0f);
+
+	/**
+	\brief Computes the minimum translational distance of an array of geometry pairs.
+
+	Same as #computePenetration() for each pair (geoms0[i], geoms1[i]). The test is selected once for the whole batch, and pairs of
+	spheres and capsules are processed four at a time. The same combinations as #computePenetration() are supported.
+
+	\param[in] nbTests Number of pairs
+	\param[in] geoms0 The first geometry objects, all of the same type
+	\param[in] geoms1 The second geometry objects, all of the same type
+	\param[out] directions Receives nbTests MTD unit directions, only valid where results is true
+	\param[out] depths Receives nbTests penetration depths, only valid where results is true
+	\param[out] results Receives nbTests values, true where the pair overlaps and the MTD has been computed
+	\return Number of overlapping pairs
+
+	@see computePenetration PxGeometryPoseArray
+	*/
+	PX_PHYSX_COMMON_API static PxU32 computePenetrationBatch(PxU32 nbTests, const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1,
+											PxVec3* PX_RESTRICT directions, PxF32* PX_RESTRICT depths, bool* PX_RESTRICT results);
 };
 
 
@@ -45,6 +45,18 @@ namespace physx
 
 class PxHeightFieldDesc;
 
+/**
+\brief A subfield replaced by the batched PxHeightField::modifySamples.
+
+@see PxHeightField.modifySamples
+*/
+struct PxHeightFieldModification
+{
+	PxI32						startCol;		//!< First column of the heightfield to be modified. Can be negative.
+	PxI32						startRow;		//!< First row of the heightfield to be modified. Can be negative.
+	const PxHeightFieldDesc*	subfieldDesc;	//!< Description of the source subfield to read the samples from.
+};
+
 /**
 \brief A height field class.
 
@@ -128,6 +140,22 @@ class PxHeightField	: public PxBase
 	*/
 	PX_PHYSX_COMMON_API virtual		bool						modifySamples(PxI32 startCol, PxI32 startRow, const PxHeightFieldDesc& subfieldDesc, bool shrinkBounds = false) = 0;
 
+	/**
+	\brief Replaces several rectangular subfields at once, in the order given.
+
+	Meant for runtime deformation such as craters, where many small modifications are made each frame.
+	Compressed samples are only decompressed and recompressed once for the whole batch, the modify count is incremented once,
+	and the bounds are either grown from the modified samples or, with shrinkBounds, recomputed once at the end.
+
+	\param[in] modifications The subfields to replace. Overlapping subfields are applied in order.
+	\param[in] nbModifications Number of subfields.
+	\param[in] shrinkBounds Same as for the single subfield version.
+	\return True on success, false on failure. Nothing is modified if the format of any subfield mismatches.
+
+	@see PxHeightFieldModification
+	*/
+	PX_PHYSX_COMMON_API virtual		bool						modifySamples(const PxHeightFieldModification* modifications, PxU32 nbModifications, bool shrinkBounds = false) = 0;
+
 	/**
 	\brief Retrieves the number of sample rows in the samples array.
 
@@ -241,9 +269,28 @@ class PxHeightField	: public PxBase
 	\param[in] row Given heightfield row
 	\param[in] column Given heightfield column
 	\return Heightfield sample
+
+	\note With PxHeightFieldFlag::eCOMPRESS_SAMPLES the first call decompresses a copy of all the samples, which the
+	height field keeps until it is released or modified. Use getSampleValue() to read the compressed samples directly.
+
+	@see getSampleValue() PxHeightFieldFlag::eCOMPRESS_SAMPLES
 	*/
 	PX_PHYSX_COMMON_API virtual	const PxHeightFieldSample&	getSample(PxU32 row, PxU32 column) const = 0;
 
+	/**
+	\brief Returns a copy of the heightfield sample of given row and column
+
+	Unlike getSample(), this decodes the sample without an uncompressed copy of the samples for
+	PxHeightFieldFlag::eCOMPRESS_SAMPLES.
+
+	\param[in] row Given heightfield row
+	\param[in] column Given heightfield column
+	\return Heightfield sample
+
+	@see getSample() PxHeightFieldFlag::eCOMPRESS_SAMPLES
+	*/
+	PX_PHYSX_COMMON_API virtual	PxHeightFieldSample		getSampleValue(PxU32 row, PxU32 column) const = 0;
+
 	/**
 	\brief Returns the number of times the heightfield data has been modified
 	
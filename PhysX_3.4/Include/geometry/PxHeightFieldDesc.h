@@ -48,7 +48,7 @@ namespace physx
 \brief Descriptor class for #PxHeightField.
 
 \note The heightfield data is *copied* when a PxHeightField object is created from this descriptor. After the call the
-user may discard the height data.
+user may discard the height data, unless the buffer is handed over with adoptSamples.
 
 @see PxHeightField PxHeightFieldGeometry PxShape PxPhysics.createHeightField() PxCooking.createHeightField()
 */
@@ -90,7 +90,7 @@ public:
 	/**
 	\brief The samples array.
 
-	It is copied to the SDK's storage at creation time.
+	It is copied to the SDK's storage at creation time, unless adoptSamples is set.
 
 	There are nbRows * nbColumn samples in the array,
 	which define nbRows * nbColumn vertices and cells,
@@ -151,6 +151,23 @@ public:
 	*/
 	PxHeightFieldFlags		flags;
 
+	/**
+	\brief Hands the samples buffer over to the SDK instead of having it copied.
+
+	For large terrains this avoids a second copy of the height data at creation time. The buffer must be tightly packed
+	(samples.stride = sizeof(PxHeightFieldSample)) and must have been allocated with the PhysX allocator callback, since the SDK
+	writes the hole bits of the samples in place and frees the buffer with it.
+	The ownership is transferred by the call to PxCooking::createHeightField or PxCooking::cookHeightField, including when it fails,
+	so the user must not access or free the buffer afterwards.
+
+	\note The SDK may also free the buffer early and keep a compressed copy when PxHeightFieldFlag::eCOMPRESS_SAMPLES is set.
+
+	<b>Default:</b> false
+
+	@see samples PxAllocatorCallback
+	*/
+	bool					adoptSamples;
+
 	/**
 	\brief Constructor sets to default.
 	*/
@@ -176,6 +193,7 @@ PX_INLINE PxHeightFieldDesc::PxHeightFieldDesc()	//constructor sets to default
 	thickness					= -1.0f;
 	convexEdgeThreshold			= 0.0f;
 	flags						= PxHeightFieldFlags();
+	adoptSamples				= false;
 }
 
 PX_INLINE void PxHeightFieldDesc::setToDefault()
@@ -193,9 +211,11 @@ PX_INLINE bool PxHeightFieldDesc::isValid() const
 		return false;
 	if (samples.stride < 4)
 		return false;
+	if (adoptSamples && samples.stride != 4)
+		return false;
 	if (convexEdgeThreshold < 0)
 		return false;
-	if ((flags & PxHeightFieldFlag::eNO_BOUNDARY_EDGES) != flags)
+	if ((flags & (PxHeightFieldFlag::eNO_BOUNDARY_EDGES | PxHeightFieldFlag::eCOMPRESS_SAMPLES)) != flags)
 		return false;
 	if (thickness < -PX_MAX_BOUNDS_EXTENTS || thickness > PX_MAX_BOUNDS_EXTENTS)
 		return false;
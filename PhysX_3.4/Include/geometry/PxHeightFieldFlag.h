@@ -142,7 +142,26 @@ struct PxHeightFieldFlag
 
 		@see PxHeightFieldDesc.flags
 		*/
-		eNO_BOUNDARY_EDGES = (1 << 0)
+		eNO_BOUNDARY_EDGES = (1 << 0),
+
+		/**
+		\brief Store the samples compressed.
+
+		Samples are stored in tiles of 16x16, with 8-bit height deltas (or 16-bit heights where the height range
+		of a tile is too large) and 4-bit indices into a per tile table of material pairs. This typically takes
+		2 to 3 times less memory than the 4 bytes per sample of the uncompressed format, at the cost of a
+		decode on every sample access.
+
+		Tiles using more than 16 different material pairs are stored uncompressed.
+
+		\note PxHeightField::getSample() keeps an uncompressed copy of the samples from its first call on.
+		PxHeightField::getSampleValue() decodes the samples without it.
+
+		\note PxHeightField::modifySamples() decompresses and compresses the whole height field again.
+
+		@see PxHeightFieldDesc.flags
+		*/
+		eCOMPRESS_SAMPLES = (1 << 1)
 	};
 };
 
@@ -49,6 +49,7 @@ class PxTriangleMeshGeometry;
 class PxHeightFieldGeometry;
 
 class PxTriangle;
+class PxGeometryHolder;
 
 class PxMeshQuery
 {
@@ -113,6 +114,33 @@ public:
 																const PxTriangleMeshGeometry& meshGeom, const PxTransform& meshPose,
 																PxU32* results, PxU32 maxResults, PxU32 startIndex, bool& overflow);
 
+	/**
+	\brief Find the mesh triangles which touch each geometry object of a batch.
+
+	This returns the same triangles as calling #findOverlapTriangleMesh() for each object, but meshes using PxMeshMidPhase::eBVH34 without scaling
+	are traversed for 4 objects at a time, so each tree node is fetched once for the whole group. This is meant for many small queries against the
+	same mesh, like character controller or wheel queries. Nearby objects should be next to each other in the batch to share most of the traversal.
+
+	\param[in] geoms The geometry objects to test for mesh triangle overlaps. Supported geometries are #PxSphereGeometry and #PxCapsuleGeometry
+	\param[in] geomPoses Poses of the geometry objects
+	\param[in] nbGeoms Number of geometry objects
+	\param[in] meshGeom The triangle mesh geometry to check overlap against
+	\param[in] meshPose Pose of the triangle mesh
+	\param[out] results Indices of overlapping triangles
+	\param[out] queryIndices Index in 'geoms' of the object touching each returned triangle. Can be NULL.
+	\param[in] maxResults Size of the 'results' and 'queryIndices' buffers
+	\param[out] overflow True if a buffer overflow occurred
+	\return Number of overlaps found, i.e. number of elements written to the results buffer
+
+	\note A triangle touched by several objects is returned once for each of them. The triangles of an object are not necessarily contiguous.
+	\note Unsupported geometries are skipped.
+
+	@see PxTriangleMeshGeometry getTriangle() findOverlapTriangleMesh()
+	*/
+	PX_PHYSX_COMMON_API static PxU32 findOverlapTriangleMeshBatch(	const PxGeometryHolder* geoms, const PxTransform* geomPoses, PxU32 nbGeoms,
+																	const PxTriangleMeshGeometry& meshGeom, const PxTransform& meshPose,
+																	PxU32* results, PxU32* queryIndices, PxU32 maxResults, bool& overflow);
+
 	/**
 	\brief Find the height field triangles which touch the specified geometry object.
 
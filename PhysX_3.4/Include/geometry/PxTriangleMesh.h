@@ -50,6 +50,19 @@ namespace physx
 */
 #define PX_ENABLE_DYNAMIC_MESH_RTREE 1
 
+class PxCpuDispatcher;
+
+/**
+\brief Range of vertices modified through PxTriangleMesh::getVerticesForModification.
+
+@see PxTriangleMesh::refitBVH
+*/
+struct PxMeshVertexRange
+{
+	PxU32	start;	//!< First modified vertex
+	PxU32	count;	//!< Number of modified vertices
+};
+
 /**
 \brief Mesh midphase structure. This enum is used to select the desired acceleration structure for midphase queries
  (i.e. raycasts, overlaps, sweeps vs triangle meshes).
@@ -181,6 +194,26 @@ class PxTriangleMesh : public PxBase
 	@see getVerticesForModification()	
 	*/
 	virtual PxBounds3				refitBVH() = 0;
+
+	/**
+	\brief Refits the part of the BVH touched by the given modified vertices.
+
+	Only the leaves holding a triangle that uses one of the vertices are recomputed, then their ancestors. This is much cheaper
+	than refitBVH() when a small part of the mesh moves, for example when craters are carved in a terrain.
+	The vertices outside of the ranges must not have been modified since the last refit.
+
+	\param[in] ranges Modified vertex ranges, they can overlap.
+	\param[in] nbRanges Number of ranges.
+	\param[in] dispatcher Optional dispatcher used to recompute the leaves on the worker threads. The call still returns once the refit is done.
+
+	\return New bounds for the entire mesh.
+
+	\note works only for PxMeshMidPhase::eBVH33
+	\note Like refitBVH(), the tree is not reoptimized, and the shapes which reference the mesh must be updated with PxShape::setGeometry.
+	\note Active edges information is only lost for the triangles using a modified vertex.
+	@see refitBVH() getVerticesForModification() PxMeshVertexRange
+	*/
+	virtual PxBounds3				refitBVH(const PxMeshVertexRange* ranges, PxU32 nbRanges, PxCpuDispatcher* dispatcher = NULL) = 0;
 #endif // PX_ENABLE_DYNAMIC_MESH_RTREE
 
 	/**
@@ -449,6 +449,18 @@ class PX_DEPRECATED PxParticleBase : public PxActor
 	*/
 	virtual		void						setParticleReadDataFlag(PxParticleReadDataFlag::Enum flag, bool val)= 0;
 
+	/**
+	\brief Sets buffers the particle system writes positions and velocities into at the end of each simulation step.
+
+	This avoids copying the particle data out of PxParticleReadData, see PxParticleWriteBuffers.
+	The particle system needs to be part of a scene, removing it from the scene clears the buffers.
+	Not allowed while the simulation is running.
+
+	\param buffers The buffers to write to, copied by the particle system. NULL stops writing.
+	@see PxParticleWriteBuffers
+	*/
+	virtual		void						setParticleWriteBuffers(const PxParticleWriteBuffers* buffers)	= 0;
+
 protected:
 	PX_INLINE								PxParticleBase(PxType concreteType, PxBaseFlags baseFlags) : PxActor(concreteType, baseFlags) {}
 	PX_INLINE								PxParticleBase(PxBaseFlags baseFlags) : PxActor(baseFlags) {}
@@ -216,6 +216,51 @@ class PX_DEPRECATED PxParticleReadData : public PxLockedData
 
 	};
 
+/**
+\brief Application owned buffers the particle system writes particle data into at the end of each simulation step. (deprecated)
+
+The buffers can for example be persistently mapped upload memory of the renderer, which saves copying the particle data
+out of PxParticleReadData every frame. The particle system writes into the buffers from a worker thread before PxScene::fetchResults()
+returns, so they need to stay valid until they are replaced or cleared with PxParticleBase::setParticleWriteBuffers().
+
+Without compact, each valid particle is written at its index, and the slots of invalid particles are left untouched. With compact,
+the valid particles are packed at the start of the buffers, in index order.
+
+\deprecated The PhysX particle feature has been deprecated in PhysX version 3.4
+
+@see PxParticleBase::setParticleWriteBuffers()
+*/
+struct PX_DEPRECATED PxParticleWriteBuffers
+	{
+	/**
+	\brief Receives the particle positions. Not written if ptr() is NULL.
+	*/
+	PxStrideIterator<PxVec3>					positionBuffer;
+
+	/**
+	\brief Receives the particle velocities. Not written if ptr() is NULL.
+	*/
+	PxStrideIterator<PxVec3>					velocityBuffer;
+
+	/**
+	\brief Number of slots in the buffers, particles that don't fit are not written.
+	*/
+	PxU32										capacity;
+
+	/**
+	\brief Packs the valid particles at the start of the buffers instead of writing them at their index.
+	*/
+	bool										compact;
+
+	/**
+	\brief Receives the number of slots written after each simulation step, can be NULL.
+	Without compact, this is the valid particle range clamped to the capacity.
+	*/
+	PxU32*										nbWrittenParticles;
+
+	PxParticleWriteBuffers() : capacity(0), compact(false), nbWrittenParticles(NULL) {}
+	};
+
 #if !PX_DOXYGEN
 } // namespace physx
 #endif
@@ -74,6 +74,37 @@ struct PxPvdSceneFlag
 typedef PxFlags<PxPvdSceneFlag::Enum, PxU8> PxPvdSceneFlags;
 PX_FLAGS_OPERATORS(PxPvdSceneFlag::Enum, PxU8)
 
+/**
+\brief Controls how the poses and velocities of the dynamic actors are sent to PVD at the end of each frame.
+
+By default every awake actor is sent every frame, which doesn't keep up with large scenes over a live connection.
+With delta updates the actor poses and velocities are quantized, and an actor is only sent when one of its quantized
+values differs from the ones sent last time. The quantization only decides what counts as a change, the values sent are not rounded.
+
+The budget caps the number of rigid dynamic updates per frame. The actors are visited round-robin, resuming where the previous
+frame stopped, so every actor is eventually sent and the remaining ones are picked up in the following frames.
+
+@see PxPvdSceneClient::setUpdateSettings
+*/
+struct PxPvdSceneUpdateSettings
+{
+	bool	deltaUpdates;				//!< Only send the actors whose quantized pose or velocity changed
+	PxReal	positionQuantum;			//!< Quantization step for positions, in distance units
+	PxReal	rotationQuantum;			//!< Quantization step for the quaternion components
+	PxReal	velocityQuantum;			//!< Quantization step for linear and angular velocities
+	PxU32	maxActorUpdatesPerFrame;	//!< Maximum number of rigid dynamics sent per frame, 0 for no limit
+
+	PxPvdSceneUpdateSettings() : deltaUpdates(false), positionQuantum(1e-3f), rotationQuantum(1e-3f), velocityQuantum(1e-2f), maxActorUpdatesPerFrame(0) {}
+
+	/**
+	\brief Returns true if the quantization steps are positive.
+	*/
+	bool isValid() const
+	{
+		return positionQuantum > 0.0f && rotationQuantum > 0.0f && velocityQuantum > 0.0f;
+	}
+};
+
 /**
 \brief Special client for PxScene.
 It provides access to the PxPvdSceneFlag.
@@ -100,6 +131,17 @@ class PxPvdSceneClient
 	*/
 	virtual PxPvdSceneFlags getScenePvdFlags() const = 0;
 
+	/**
+	Sets how the dynamic actors are updated each frame. See PxPvdSceneUpdateSettings.
+	\param settings New settings, ignored if not valid.
+	*/
+	virtual void setUpdateSettings(const PxPvdSceneUpdateSettings& settings) = 0;
+
+	/**
+	Retrieves the actor update settings. See PxPvdSceneUpdateSettings.
+	*/
+	virtual PxPvdSceneUpdateSettings getUpdateSettings() const = 0;
+
 	/**
 	update camera on PVD application's render window
 	*/
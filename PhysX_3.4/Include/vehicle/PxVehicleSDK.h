@@ -229,6 +229,24 @@ generates an acceleration greater than the specified value.
 */
 void PxVehicleSetMaxHitActorAcceleration(const PxF32 maxHitActorAcceleration);
 
+/**
+\brief Allow PxVehicleSuspensionRaycasts to reuse the hit planes of the previous raycasts instead of issuing new ones.
+
+The raycasts of a block of 4 wheels are skipped if each active wheel of the block hit a PxRigidStatic in the most recent 
+raycasts and if neither the start nor the end of its suspension line moved by more than maxWheelMotion since then. 
+The skipped block is then updated with the cached hit planes, as if it was excluded with the vehiclesToRaycast array 
+of PxVehicleSuspensionRaycasts. Vehicles driving slowly on flat static ground issue far fewer raycasts.
+
+\note The motion is measured from the most recent raycasts that were actually issued, so a slow drift still triggers new raycasts.
+
+\note Wheels using cached hit planes report NULL for the hit actor, shape and material in PxWheelQueryResult.
+
+\note Default value of maxWheelMotion is 0, which disables the reuse.
+
+@see PxVehicleSuspensionRaycasts
+*/
+void PxVehicleSetSuspensionRaycastReuseThreshold(const PxF32 maxWheelMotion);
+
 #if !PX_DOXYGEN
 } // namespace physx
 #endif
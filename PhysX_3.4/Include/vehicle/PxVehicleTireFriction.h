@@ -173,6 +173,14 @@ private:
 	*/
 	PxVehicleDrivableSurfaceType* mDrivableSurfaceTypes;
 
+	/**
+	\brief Ptr to the open addressing hash table of mDrivableSurfaceMaterials, built in setup.
+
+	\note Each slot stores x+1 for the material mDrivableSurfaceMaterials[x], or 0 for an empty slot.
+	The table has mSurfaceTypeHashMask+1 slots, a power of two at least twice mNbSurfaceTypes.
+	*/
+	PxU16* mSurfaceTypeHash;
+
 	/**
 	\brief Number of different driving surface types.
 	
@@ -203,12 +211,47 @@ private:
 	*/	
 	PxU32 mMaxNbTireTypes;			
 
+	/**
+	\brief Number of slots of mSurfaceTypeHash minus one.
+	*/	
+	PxU32 mSurfaceTypeHashMask;
 
-#if !PX_P64_FAMILY
-	PxU32 mPad[1];
-#else
-	PxU32 mPad[2];
-#endif
+	PxU32 mPad[3];
+
+	static PX_FORCE_INLINE PxU32 computeSurfaceTypeHashSize(const PxU32 nbSurfaceTypes)
+	{
+		PxU32 size = 2;
+		while(size < 2*nbSurfaceTypes)
+		{
+			size <<= 1;
+		}
+		return size;
+	}
+
+	static PX_FORCE_INLINE PxU32 computeSurfaceTypeHash(const PxMaterial* material)
+	{
+		//Materials are heap allocated so the low bits of the pointers carry little information.
+		const PxU64 key = PxU64(size_t(material));
+		return PxU32((key*PxU64(0x9E3779B97F4A7C15ULL)) >> 32);
+	}
+
+	/**
+	\brief Return the surface type of a material, 0 if the material is not in mDrivableSurfaceMaterials.
+	*/
+	PX_FORCE_INLINE PxU32 getSurfaceType(const PxMaterial* material) const
+	{
+		PxU32 slot = computeSurfaceTypeHash(material) & mSurfaceTypeHashMask;
+		PxU32 id;
+		while(0 != (id = mSurfaceTypeHash[slot]))
+		{
+			if(material == mDrivableSurfaceMaterials[id-1])
+			{
+				return mDrivableSurfaceTypes[id-1].mType;
+			}
+			slot = (slot + 1) & mSurfaceTypeHashMask;
+		}
+		return 0;
+	}
 
 	PxVehicleDrivableSurfaceToTireFrictionPairs(){}
 	~PxVehicleDrivableSurfaceToTireFrictionPairs(){}
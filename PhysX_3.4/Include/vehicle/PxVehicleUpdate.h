@@ -50,6 +50,9 @@ namespace physx
 	class PxVehicleWheels;
 	class PxVehicleDrivableSurfaceToTireFrictionPairs;
 	class PxVehicleTelemetryData;
+	class PxCpuDispatcher;
+	class PxRigidActor;
+	class PxShape;
 
 	/**
 	\brief Structure containing data describing the non-persistent state of each suspension/wheel/tire unit.
@@ -349,6 +352,43 @@ namespace physx
 		 const PxU32 nbSceneQueryResults, PxRaycastQueryResult* sceneQueryResults, 
 		 const bool* vehiclesToRaycast = NULL);
 
+	/**
+	\brief Perform the suspension line raycasts of all vehicles straight against a single heightfield shape, without the scene query system.
+
+	The suspension lines are the same as in PxVehicleSuspensionRaycasts, and the results are written to sceneQueryResults as a PxBatchQuery would, 
+	so PxVehicleUpdates uses them in the same way. Each ray is intersected with the plane of the heightfield triangle under it, which skips the
+	scene query pruners and the heightfield traversal. Rays over holes, and the few that don't settle on a triangle, use PxGeometryQuery::raycast 
+	against the heightfield instead.
+
+	\param[in] heightFieldActor is the actor of heightFieldShape. The hits report it as the hit actor.
+
+	\param[in] heightFieldShape is a shape with a PxHeightFieldGeometry. Its material table gives the drivable surface of each hit.
+
+	\param[in] nbVehicles is the number of vehicles in the vehicles array.
+
+	\param[in] vehicles is an array of all vehicles that are to have a raycast issued from each wheel. 
+
+	\param[in] nbSceneQueryResults must be greater than or equal to the total number of wheels of all the vehicles in the vehicles array.
+
+	\param[in] sceneQueryResults must persist without being overwritten until the end of the next PxVehicleUpdates call. 
+
+	\param[in] vehiclesToRaycast is an array of bools of length nbVehicles used to decide if raycasts will be performed for the corresponding vehicle, 
+	as in PxVehicleSuspensionRaycasts.
+
+	\note Only the heightfield is tested. The scene query filter data of the wheels is not used, and other shapes standing on the terrain, or the vehicle 
+	itself, are not seen. Vehicles close to other drivable geometry should use PxVehicleSuspensionRaycasts for that update instead, a vehicle can 
+	change between the two from one update to the next.
+
+	\note The hit planes of wheels that moved less than PxVehicleSetSuspensionRaycastReuseThreshold are reused as with PxVehicleSuspensionRaycasts.
+
+	@see PxVehicleSuspensionRaycasts
+	*/
+	void PxVehicleSuspensionHeightFieldRaycasts
+		(PxRigidActor* heightFieldActor, PxShape* heightFieldShape,
+		 const PxU32 nbVehicles, PxVehicleWheels** vehicles,
+		 const PxU32 nbSceneQueryResults, PxRaycastQueryResult* sceneQueryResults, 
+		 const bool* vehiclesToRaycast = NULL);
+
 
 	/**
 	\brief Perform sweeps for all suspension lines for all vehicles.  
@@ -516,6 +556,47 @@ namespace physx
 		const PxVehicleConcurrentUpdateData* vehicleConcurrentUpdates, const PxU32 nbVehicles, PxVehicleWheels** vehicles);
 
 
+	/**
+	\brief Update an array of vehicles on the worker threads of a dispatcher, then apply the actor changes that were deferred by the concurrent updates.
+
+	The vehicles array is split in batches of nbVehiclesPerTask vehicles.  The calling thread and up to one task per worker thread update the batches
+	with PxVehicleUpdates, after which the calling thread applies the deferred changes with PxVehiclePostUpdates.  The function returns when
+	all vehicles have been updated.
+
+	\param[in] dispatcher is the dispatcher running the tasks, usually the one of the scene.  If it has no worker thread or if there is a single batch,
+	the vehicles are updated on the calling thread as with PxVehicleUpdates.
+
+	\param[in] timestep is the timestep of the update
+
+	\param[in] gravity is the value of gravitational acceleration
+
+	\param[in] vehicleDrivableSurfaceToTireFrictionPairs describes the mapping between each PxMaterial ptr and an integer representing a 
+	surface type. It also stores the friction value for each combination of surface and tire type.
+
+	\param[in] nbVehicles is the number of vehicles pointers in the vehicles array
+
+	\param[in,out] vehicles is an array of length nbVehicles containing all vehicles to be updated by the specified timestep
+
+	\param[out] vehicleWheelQueryResults is an array of length nbVehicles storing the wheel query results of each corresponding vehicle and wheel in the 
+	vehicles array.  A NULL pointer is permitted.  
+
+	\param[in] vehicleConcurrentUpdates is an array of length nbVehicles used to store the deferred changes, configured as for PxVehicleUpdates.  If NULL, the 
+	buffers are allocated for the duration of the call.
+
+	\param[in] nbVehiclesPerTask is the number of vehicles updated by each batch.
+
+	\note The same restrictions as concurrent calls to PxVehicleUpdates apply: all vehicles must be in the scene specified by PxVehicleUpdateSetScene and the
+	function must not run concurrently with PxVehicleUpdateSingleVehicleAndStoreTelemetryData.
+
+	@see PxVehicleUpdates, PxVehiclePostUpdates, PxVehicleConcurrentUpdateData
+	*/
+	void PxVehicleUpdatesParallel(
+		PxCpuDispatcher& dispatcher, const PxReal timestep, const PxVec3& gravity, 
+		const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, 
+		const PxU32 nbVehicles, PxVehicleWheels** vehicles, PxVehicleWheelQueryResult* vehicleWheelQueryResults, 
+		PxVehicleConcurrentUpdateData* vehicleConcurrentUpdates = NULL, const PxU32 nbVehiclesPerTask = 8);
+
+
 	/**
 	\brief Shift the origin of vehicles by the specified vector.
 
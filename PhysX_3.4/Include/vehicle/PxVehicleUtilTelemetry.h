@@ -400,7 +400,148 @@ PX_COMPILE_TIME_ASSERT(0==(sizeof(PxVehicleTelemetryData) & 15));
 
 #endif //PX_DEBUG_VEHICLE_ON
 
-//#endif // PX_DEBUG_VEHICLE_ON
+class PxVehicleWheels;
+
+/**
+\brief Entry of the binary recording of a PxVehicleTelemetryRecorder.
+
+Each recorded vehicle update stores a vehicle entry followed by one wheel entry per wheel.
+
+@see PxVehicleTelemetryRecorder::read
+*/
+struct PxVehicleTelemetryEntry
+{
+	enum Flag
+	{
+		eWHEEL		= (1<<0),	//!< Wheel entry, otherwise vehicle entry
+		eIN_AIR		= (1<<1),	//!< Wheel entries: the wheel was in the air
+		eSLEEPING	= (1<<2),	//!< Vehicle entries: the actor was asleep
+		eHAS_TIRE_DATA = (1<<3)	//!< Wheel entries: suspension and tire values come from the PxWheelQueryResult of the update
+	};
+
+	struct VehicleData
+	{
+		PxReal	engineRotationSpeed;	//!< Zero for PxVehicleNoDrive
+		PxReal	forwardSpeed;			//!< PxVehicleWheels::computeForwardSpeed
+		PxReal	sidewaysSpeed;			//!< PxVehicleWheels::computeSidewaysSpeed
+		PxU32	currentGear;			//!< Zero for PxVehicleNoDrive
+		PxU32	simulationTier;			//!< PxVehicleSimulationTier
+	};
+
+	struct WheelData
+	{
+		PxReal	rotationSpeed;
+		PxReal	suspJounce;
+		PxReal	tireFriction;
+		PxReal	longitudinalSlip;
+		PxReal	lateralSlip;
+	};
+
+	PxU32	sequence;	//!< Position of the entry in the recording, starting from 1
+	PxU32	frame;		//!< Frame set with PxVehicleTelemetryRecorder::setFrame
+	PxU16	vehicleId;	//!< Id passed to PxVehicleTelemetryRecorder::addVehicle
+	PxU8	flags;		//!< Combination of Flag values
+	PxU8	index;		//!< Wheel index for wheel entries, number of wheels for vehicle entries
+
+	union
+	{
+		VehicleData	vehicle;
+		WheelData	wheel;
+	};
+};
+PX_COMPILE_TIME_ASSERT(32==sizeof(PxVehicleTelemetryEntry));
+
+/**
+\brief Binary ring buffer recording the state of a set of vehicles after each of their updates.
+
+Unlike PxVehicleTelemetryData, the recorder is available in all builds, records any number of vehicles and can be used 
+with the concurrent and parallel updates: each update reserves its entries with an atomic increment and writes a few 
+values, all formatting is left to the reader. Once the buffer is full the oldest entries are overwritten, so the 
+recording always holds the most recent history, which is typically attached to bug reports.
+
+\note addVehicle, removeVehicle, setFrame and clear must not be called while vehicles are updated.
+read may be called at any time, including from another thread during the updates.
+
+@see PxVehicleSetTelemetryRecorder, PxVehicleTelemetryEntry
+*/
+class PxVehicleTelemetryRecorder
+{
+public:
+
+	friend class PxVehicleUpdate;
+
+	/**
+	\brief Allocate a recorder holding the nbEntries most recent entries (rounded up to a power of two) of up to maxNbVehicles vehicles.
+	@see free
+	*/
+	static PxVehicleTelemetryRecorder* allocate(const PxU32 nbEntries, const PxU32 maxNbVehicles);
+
+	/**
+	\brief Free a recorder allocated with allocate.
+	*/
+	void free();
+
+	/**
+	\brief Start recording a vehicle, its entries are tagged with vehicleId.
+	\return False if maxNbVehicles vehicles are already recorded.
+	*/
+	bool addVehicle(const PxVehicleWheels* vehicle, const PxU16 vehicleId);
+
+	/**
+	\brief Stop recording a vehicle.
+	*/
+	void removeVehicle(const PxVehicleWheels* vehicle);
+
+	/**
+	\brief Set the frame stored in the entries of the following updates.
+	*/
+	void setFrame(const PxU32 frame) {mFrame=frame;}
+
+	/**
+	\brief Discard all entries.
+	*/
+	void clear();
+
+	/**
+	\brief Copy the entries recorded since cursor, oldest first, and advance cursor.
+
+	Start with a cursor of zero.  Entries overwritten before they could be read are skipped, which shows as a gap in 
+	PxVehicleTelemetryEntry::sequence.  Entries still being written by concurrent updates are left for the next call.
+
+	\return The number of entries copied.
+	*/
+	PxU32 read(PxU32& cursor, PxVehicleTelemetryEntry* entries, const PxU32 maxNbEntries) const;
+
+	/**
+	\brief Return the number of entries that the recorder holds.
+	*/
+	PxU32 getNbEntries() const {return mNbEntries;}
+
+private:
+
+	PxVehicleTelemetryEntry* mEntries;
+	const PxVehicleWheels** mVehicles;
+	PxU16* mVehicleIds;
+	PxU32 mNbEntries;
+	PxU32 mMaxNbVehicles;
+	PxU32 mNbVehicles;
+	volatile PxI32 mWriteCount;
+	PxU32 mFrame;
+
+	PxVehicleTelemetryRecorder(){}
+	~PxVehicleTelemetryRecorder(){}
+};
+
+/**
+\brief Record the vehicles added to recorder after each of their updates in PxVehicleUpdates, PxVehicleUpdatesParallel 
+and PxVehicleUpdateSingleVehicleAndStoreTelemetryData.
+
+\note Pass NULL to stop recording, which is the default.  Without a recorder the updates are unaffected.
+
+@see PxVehicleTelemetryRecorder
+*/
+void PxVehicleSetTelemetryRecorder(PxVehicleTelemetryRecorder* recorder);
+
 
 #if !PX_DOXYGEN
 } // namespace physx
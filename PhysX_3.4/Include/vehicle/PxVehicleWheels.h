@@ -669,6 +669,41 @@ public:
 };
 PX_COMPILE_TIME_ASSERT(0==(sizeof(PxVehicleWheelsDynData) & 15));
 
+/**
+\brief Level of detail used by PxVehicleUpdates to simulate a vehicle.
+
+\note Distant or off-screen vehicles can be moved to a cheaper tier and back at any time, the state that the 
+cheaper tiers don't simulate is kept consistent so that the switch doesn't produce a visible pop.
+
+@see PxVehicleWheels::setSimulationTier
+*/
+struct PxVehicleSimulationTier
+{
+	enum Enum
+	{
+		/**
+		\brief Full simulation of suspensions, tires and drivetrain.
+		*/
+		eFULL = 0,
+
+		/**
+		\brief Suspensions and tires are simulated as for eFULL but the gears are held fixed (no autobox, no gear changes) 
+		and the driven wheels of PxVehicleDrive4W and PxVehicleDriveNW spin at a single lumped speed coupled to the engine, 
+		which replaces the solve of the coupled engine and wheels.  PxVehicleDriveTank only holds the gears fixed.
+		*/
+		eSIMPLIFIED_DRIVETRAIN,
+
+		/**
+		\brief No suspension raycasts, tire forces or drivetrain solve.  The actor moves as a plain rigid body (or kinematic actor),
+		wheels spin to match the speed of the ground under them and engine speeds follow the wheels through the current gear.
+		Wheel query results report the wheels at rest on the ground.
+		*/
+		eRIGID_BODY,
+
+		eMAX_NB_SIMULATION_TIERS
+	};
+};
+
 /**
 \brief Data structure with instanced dynamics data and configuration data of a vehicle with just wheels
 @see PxVehicleDrive, PxVehicleDrive4W, PxVehicleDriveTank
@@ -714,6 +749,20 @@ public:
 	*/
 	PxReal computeSidewaysSpeed() const;
 
+	/**
+	\brief Set the level of detail used by PxVehicleUpdates to simulate the vehicle.
+	\note The tier is eFULL by default.
+	\note Only eRIGID_BODY vehicles may be kinematic actors.
+	@see PxVehicleSimulationTier
+	*/
+	void setSimulationTier(const PxVehicleSimulationTier::Enum tier);
+
+	/**
+	\brief Return the level of detail used by PxVehicleUpdates to simulate the vehicle.
+	@see setSimulationTier
+	*/
+	PX_FORCE_INLINE PxVehicleSimulationTier::Enum getSimulationTier() const {return PxVehicleSimulationTier::Enum(mSimulationTier);}
+
 	/**
 	\brief Data describing the setup of all the wheels/suspensions/tires.
 	*/
@@ -778,11 +827,16 @@ protected:
 	\brief Vehicle type (eVehicleDriveTypes)
 	*/
 	PxU8 mType;
+
+	/**
+	\brief Simulation tier (PxVehicleSimulationTier)
+	*/
+	PxU8 mSimulationTier;
 		
 #if PX_P64_FAMILY
-	PxU8 mPad0[14];
+	PxU8 mPad0[13];
 #else
-	PxU8 mPad0[14];
+	PxU8 mPad0[13];
 #endif
 
 //serialization
@@ -55,6 +55,7 @@
 //  --dstBinFile=<filename>              Outputs target binary file
 //  --generateExampleFile=<filename>     Generates an example file
 //  --dumpBinaryMetaData=<filename>      Dump binary meta data for current runtime platform
+//  --windowSize=<bytes>                 Streams the source through a window of this size
 //  --verbose                            Enables verbose mode
 //
 // ***********************************************************************************************
@@ -85,6 +86,7 @@ struct CmdLineParameters
 	const char*		dstBinFile;		
 	const char*		exampleFile;
 	const char*		dumpMetaDataFile;
+	PxU32			windowSize;
 
 	CmdLineParameters()
 		: verbose(false)
@@ -94,6 +96,7 @@ struct CmdLineParameters
 		, dstBinFile(NULL)
 		, exampleFile(NULL)
 		, dumpMetaDataFile(NULL)
+		, windowSize(0)
 	{
 	}
 };
@@ -115,6 +118,7 @@ static void printHelpMsg()
 		"--dstBinFile=<filename> "
 		"--generateExampleFile=<filename> "
 		"--dumpBinaryMetaData=<filename> "
+		"--windowSize=<bytes> "
 	    "--verbose \n"
 		"A set of pre-built binary metadata is included with the PhysX SDK "
 		"at [path to installed PhysX SDK]/Tools/BinaryMetaData.\n");
@@ -137,6 +141,9 @@ static void printHelpMsg()
 	printf("--dumpBinaryMetaData=<filename>\n");
 	printf("  Dump binary meta data for current runtime platform\n");
 
+	printf("--windowSize=<bytes>\n");
+	printf("  Converts large files through a window of this size instead of loading them at once\n");
+
 	printf("--verbose\n");
 	printf("  Enables verbose mode\n");
 }
@@ -186,6 +193,12 @@ static bool parseCommandLine(CmdLineParameters& result, int argc, const char *co
 		{
 			GET_PARAMETER(result.dstMetadata, "--dstMetadata=");
 		}
+		else if(match(argv[i], "--windowSize="))
+		{
+			const char* windowSize;
+			GET_PARAMETER(windowSize, "--windowSize=");
+			result.windowSize = PxU32(strtoul(windowSize, NULL, 10));
+		}
 		else if(match(argv[i], "--srcBinFile="))
 		{
 			GET_PARAMETER(result.srcBinFile, "--srcBinFile=");
@@ -300,7 +313,7 @@ int snippetMain(int argc, const char *const*argv)
 			binaryConverter->setReportMode(PxConverterReportMode::eVERBOSE);
 		else
 			binaryConverter->setReportMode(PxConverterReportMode::eNORMAL);
-
+		binaryConverter->setStreamingWindowSize(result.windowSize);
 		
 		PxDefaultFileInputData srcMetaDataStream(result.srcMetadata);
 		PxDefaultFileInputData dstMetaDataStream(result.dstMetadata);
@@ -313,7 +326,9 @@ int snippetMain(int argc, const char *const*argv)
 		{
 			PxDefaultFileInputData  srcBinaryDataStream(result.srcBinFile);
 			PxDefaultFileOutputStream dstBinaryDataStream(result.dstBinFile);
-			binaryConverter->convert(srcBinaryDataStream, srcBinaryDataStream.getLength(), dstBinaryDataStream);
+			bret = binaryConverter->convert(srcBinaryDataStream, srcBinaryDataStream.getLength(), dstBinaryDataStream);
+			if(!bret)
+				printf("convert failed\n");
 		}
 
 		binaryConverter->release();
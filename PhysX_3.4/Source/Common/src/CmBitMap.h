@@ -40,6 +40,7 @@
 #include "PsMathUtils.h"
 #include "CmPhysXCommon.h"
 #include "PsBitUtils.h"
+#include "PsVecMath.h"
 // PX_SERIALIZATION
 #include "PxSerialFramework.h"
 //~PX_SERIALIZATION
@@ -48,6 +49,64 @@ namespace physx
 {
 namespace Cm
 {
+	// Index of the first non-zero word at or after index, wordCount if there is none
+	PX_FORCE_INLINE PxU32 findNonZeroWord(const PxU32* words, PxU32 index, PxU32 wordCount)
+	{
+		if(index < wordCount && words[index])
+			return index;
+
+		// empty words are skipped 4 at a time, which is most of the map when few bits are set
+		using namespace Ps::aos;
+		const VecU32V zero = U4Zero();
+		while(index + 4 <= wordCount && BAllEqTTTT(V4IsEqU32(U4LoadU(words + index), zero)))
+			index += 4;
+		while(index < wordCount && !words[index])
+			index++;
+		return index;
+	}
+
+	// Number of set bits in the words
+	PX_INLINE PxU32 countBits(const PxU32* words, PxU32 wordCount)
+	{
+		// SWAR count of 64 bits at a time. The per-byte sums are accumulated over batches of 31 pairs of words (at most
+		// 248 per byte), so the horizontal add is only done once per batch instead of once per word.
+		PxU32 count = 0;
+		PxU32 i = 0;
+		const PxU32 pairEnd = wordCount & ~1u;
+		while(i < pairEnd)
+		{
+			const PxU32 batchEnd = PxMin(pairEnd, i + 62);
+			PxU64 bytes = 0;
+			for(; i < batchEnd; i += 2)
+			{
+				PxU64 v = PxU64(words[i]) | (PxU64(words[i + 1]) << 32);
+				v = v - ((v >> 1) & 0x5555555555555555ull);
+				v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+				bytes += (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			}
+			const PxU64 shorts = (bytes & 0x00FF00FF00FF00FFull) + ((bytes >> 8) & 0x00FF00FF00FF00FFull);
+			count += PxU32((shorts * 0x0001000100010001ull) >> 48);
+		}
+		if(i < wordCount)
+			count += Ps::bitCount(words[i]);
+		return count;
+	}
+
+	// Calls functor(index) for every set bit of words [startWord, startWord+nbWords), in increasing order
+	template<class Functor>
+	PX_FORCE_INLINE void forEachSetBit(const PxU32* words, PxU32 startWord, PxU32 nbWords, Functor& functor)
+	{
+		const PxU32 endWord = startWord + nbWords;
+		for(PxU32 i = findNonZeroWord(words, startWord, endWord); i < endWord; i = findNonZeroWord(words, i + 1, endWord))
+		{
+			PxU32 block = words[i];
+			do
+			{
+				functor((i << 5) | Ps::lowestSetBit(block));
+				block &= block - 1;
+			} while(block);
+		}
+	}
 
 	/*!
 	Hold a bitmap with operations to set,reset or test given bit.
@@ -223,23 +282,84 @@ namespace Cm
 
 		PX_INLINE PxU32 count()		const
 		{
-			// NOTE: we can probably do this faster, since the last steps in PxcBitCount32 can be defered to
-			// the end of the seq. + 64/128bits at a time + native bit counting instructions(360 is fast non micro code).
-			PxU32 count = 0;
-			PxU32 wordCount = getWordCount();
-			for(PxU32 i=0; i<wordCount; i++)
-				count += Ps::bitCount(mMap[i]);
-
-			return count;
+			return countBits(mMap, getWordCount());
 		}
 
 		PX_INLINE PxU32 count(PxU32 start, PxU32 length) const
 		{
-			PxU32 end = PxMin(getWordCount()<<5,start+length);
-			PxU32 count = 0;
-			for(PxU32 i=start; i<end; i++)
-				count+= (test(i)!=0);
-			return count;
+			const PxU32 bitCount = getWordCount()<<5;
+			if(start >= bitCount || !length)
+				return 0;
+			const PxU32 last = start + PxMin(length, bitCount - start) - 1;
+
+			// masked first and last words, whole words in between
+			const PxU32 firstWord = start>>5;
+			const PxU32 lastWord = last>>5;
+			const PxU32 firstMask = 0xffffffff << (start&31);
+			const PxU32 lastMask = 0xffffffff >> (31 - (last&31));
+			if(firstWord == lastWord)
+				return Ps::bitCount(mMap[firstWord] & firstMask & lastMask);
+
+			return Ps::bitCount(mMap[firstWord] & firstMask) + countBits(mMap + firstWord + 1, lastWord - firstWord - 1) + Ps::bitCount(mMap[lastWord] & lastMask);
+		}
+
+		//! returns the first set bit at or after index, 0xffffffff if there is none
+		PxU32 findNext(PxU32 index) const
+		{
+			const PxU32 wordCount = getWordCount();
+			PxU32 wordIndex = index>>5;
+			if(wordIndex >= wordCount)
+				return 0xffffffff;
+
+			const PxU32 block = mMap[wordIndex] & (0xffffffff << (index&31));
+			if(block)
+				return (wordIndex<<5) | Ps::lowestSetBit(block);
+
+			wordIndex = findNonZeroWord(mMap, wordIndex+1, wordCount);
+			return wordIndex < wordCount ? (wordIndex<<5) | Ps::lowestSetBit(mMap[wordIndex]) : 0xffffffff;
+		}
+
+		//! returns the first bit at or after index that is set in both maps, 0xffffffff if there is none
+		template<class _>
+		PxU32 findNextCommon(const BitMapBase<_>& b, PxU32 index) const
+		{
+			const PxU32 wordCount = PxMin(getWordCount(), b.getWordCount());
+			const PxU32* words = b.getWords();
+			PxU32 wordIndex = index>>5;
+			if(wordIndex >= wordCount)
+				return 0xffffffff;
+
+			PxU32 block = mMap[wordIndex] & words[wordIndex] & (0xffffffff << (index&31));
+			while(!block)
+			{
+				if(++wordIndex == wordCount)
+					return 0xffffffff;
+
+				// 4 words at a time while nothing is in common
+				using namespace Ps::aos;
+				const VecU32V zero = U4Zero();
+				while(wordIndex + 4 <= wordCount && BAllEqTTTT(V4IsEqU32(V4U32and(U4LoadU(mMap + wordIndex), U4LoadU(words + wordIndex)), zero)))
+					wordIndex += 4;
+				if(wordIndex == wordCount)
+					return 0xffffffff;
+
+				block = mMap[wordIndex] & words[wordIndex];
+			}
+			return (wordIndex<<5) | Ps::lowestSetBit(block);
+		}
+
+		//! returns true if a bit is set in both maps
+		template<class _>
+		bool intersects(const BitMapBase<_>& b) const
+		{
+			return findNextCommon(b, 0) != 0xffffffff;
+		}
+
+		// Calls functor(index) for every set bit, in increasing order
+		template<class Functor>
+		PX_INLINE void forEachSetBit(Functor& functor) const
+		{
+			Cm::forEachSetBit(mMap, 0, getWordCount(), functor);
 		}
 
 		//! returns 0 if no bits set (!!!)
@@ -257,9 +377,13 @@ namespace Cm
 
 		// the obvious combiners and some used in the SDK
 
-		struct OR		{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a|b;		}	};
-		struct AND		{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a&b;		}	};
-		struct XOR		{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a^b;		}	};
+		// the vector versions combine 4 words at a time
+
+		struct OR		{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a|b;		}	PX_FORCE_INLINE Ps::aos::VecU32V operator()(const Ps::aos::VecU32V a, const Ps::aos::VecU32V b) { return Ps::aos::V4U32or(a, b);	}	};
+		struct AND		{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a&b;		}	PX_FORCE_INLINE Ps::aos::VecU32V operator()(const Ps::aos::VecU32V a, const Ps::aos::VecU32V b) { return Ps::aos::V4U32and(a, b);	}	};
+		struct XOR		{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a^b;		}	PX_FORCE_INLINE Ps::aos::VecU32V operator()(const Ps::aos::VecU32V a, const Ps::aos::VecU32V b) { return Ps::aos::V4U32xor(a, b);	}	};
+		// a & ~b, e.g. to remove the bits already processed from a dirty set
+		struct ANDNOT	{ PX_INLINE PxU32 operator()(PxU32 a, PxU32 b) {	return a&~b;	}	PX_FORCE_INLINE Ps::aos::VecU32V operator()(const Ps::aos::VecU32V a, const Ps::aos::VecU32V b) { return Ps::aos::V4U32Andc(a, b);	}	};
 
 		// we use auxiliary functions here so as not to generate combiners for every combination
 		// of allocators
@@ -317,9 +441,13 @@ namespace Cm
 				{
 					PxU32 bitIndex = mIndex<<5 | Ps::lowestSetBit(mBlock);
 					mBlock &= mBlock-1;
-					PxU32 wordCount = mBitMap.getWordCount();
-					while(!mBlock && ++mIndex < wordCount)
-						mBlock = mBitMap.mMap[mIndex];
+					if(!mBlock)
+					{
+						const PxU32 wordCount = mBitMap.getWordCount();
+						mIndex = findNonZeroWord(mBitMap.mMap, mIndex+1, wordCount);
+						if(mIndex < wordCount)
+							mBlock = mBitMap.mMap[mIndex];
+					}
 					return bitIndex;
 				}
 				return DONE;
@@ -327,10 +455,11 @@ namespace Cm
 
 			PX_INLINE void reset()
 			{
-				mIndex = mBlock = 0;
-				PxU32 wordCount = mBitMap.getWordCount();
-				while(mIndex < wordCount && ((mBlock = mBitMap.mMap[mIndex]) == 0))
-					++mIndex;
+				mBlock = 0;
+				const PxU32 wordCount = mBitMap.getWordCount();
+				mIndex = findNonZeroWord(mBitMap.mMap, 0, wordCount);
+				if(mIndex < wordCount)
+					mBlock = mBitMap.mMap[mIndex];
 			}
 		private:
 			PxU32 mBlock, mIndex;
@@ -348,9 +477,10 @@ namespace Cm
 		PX_FORCE_INLINE bool hasBits()
 		{
 			PX_ASSERT(mIndex<mWordCount);
-			while (mBlock == 0)
+			if (mBlock == 0)
 			{
-				if (++mIndex == mWordCount)
+				mIndex = PxI32(findNonZeroWord(mMap, PxU32(mIndex + 1), PxU32(mWordCount)));
+				if (mIndex == mWordCount)
 					return false;
 				mBlock = mMap[mIndex];
 			}
@@ -468,7 +598,15 @@ namespace Cm
 		{
 			extend(length<<5);
 			PxU32 combineLength = PxMin(getWordCount(), length);
-			for(PxU32 i=0;i<combineLength;i++)
+			PxU32 i=0;
+			// our words are 16-byte aligned unless they are in user memory
+			if(!(size_t(mMap) & 15))
+			{
+				using namespace Ps::aos;
+				for(;i+4<=combineLength;i+=4)
+					U4StoreA(Combiner()(U4LoadA(mMap+i), U4LoadU(words+i)), mMap+i);
+			}
+			for(;i<combineLength;i++)
 				mMap[i] = Combiner()(mMap[i], words[i]);
 		}
 
@@ -480,13 +618,20 @@ namespace Cm
 
 			PxU32 commonSize = PxMin(length1,length2);
 
-			for(PxU32 i=0;i<commonSize;i++)
+			PxU32 i=0;
+			if(!(size_t(mMap) & 15))
+			{
+				using namespace Ps::aos;
+				for(;i+4<=commonSize;i+=4)
+					U4StoreA(Combiner()(U4LoadU(words1+i), U4LoadU(words2+i)), mMap+i);
+			}
+			for(;i<commonSize;i++)
 				mMap[i] = Combiner()(words1[i],words2[i]);
 
-			for(PxU32 i=commonSize;i<length1;i++)
+			for(i=commonSize;i<length1;i++)
 				mMap[i] = Combiner()(words1[i],0);
 
-			for(PxU32 i=commonSize;i<length2;i++)
+			for(i=commonSize;i<length2;i++)
 				mMap[i] = Combiner()(0,words2[i]);
 		}
 
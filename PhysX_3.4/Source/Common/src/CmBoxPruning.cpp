@@ -140,6 +140,25 @@ bool Cm::BipartiteBoxPruning(const PxBounds3* bounds0, PxU32 nb0, const PxBounds
  */
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 bool Cm::CompleteBoxPruning(const PxBounds3* bounds, PxU32 nb, Ps::Array<PxU32>& pairs, const Axes& axes)
+{
+	RadixSortBuffered RS;
+	Ps::Array<float> PosList;
+	return CompleteBoxPruning(bounds, nb, pairs, axes, RS, PosList);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Complete box pruning using caller-owned buffers.
+ *	\param		bounds	[in] list of boxes
+ *	\param		nb		[in] number of boxes
+ *	\param		pairs	[out] list of overlapping pairs
+ *	\param		axes	[in] projection order (0,2,1 is often best)
+ *	\param		sorter	[in/out] sorter, its ranks from the previous call speed up the sort when the boxes barely moved
+ *	\param		posList	[in/out] scratch buffer for the sorted positions
+ *	\return		true if success.
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool Cm::CompleteBoxPruning(const PxBounds3* bounds, PxU32 nb, Ps::Array<PxU32>& pairs, const Axes& axes, RadixSortBuffered& sorter, Ps::Array<float>& posList)
 {
 	pairs.clear();
 
@@ -155,15 +174,15 @@ bool Cm::CompleteBoxPruning(const PxBounds3* bounds, PxU32 nb, Ps::Array<PxU32>&
 	PX_UNUSED(Axis1);
 	PX_UNUSED(Axis2);
 
-	// Allocate some temporary data
-	float* PosList = reinterpret_cast<float*>(PX_ALLOC_TEMP(sizeof(float)*nb, "Cm::CompleteBoxPruning"));
+	// Size the scratch buffer, it only grows
+	posList.resizeUninitialized(nb);
+	float* PosList = posList.begin();
 
 	// 1) Build main list using the primary axis
 	for(PxU32 i=0;i<nb;i++)	PosList[i] = bounds[i].minimum[Axis0];
 
 	// 2) Sort the list
-	/*static*/ RadixSortBuffered RS;	// Static for coherence
-	const PxU32* Sorted = RS.Sort(PosList, nb).GetRanks();
+	const PxU32* Sorted = sorter.Sort(PosList, nb).GetRanks();
 
 	// 3) Prune the list
 	const PxU32* const LastSorted = &Sorted[nb];
@@ -190,8 +209,6 @@ bool Cm::CompleteBoxPruning(const PxBounds3* bounds, PxU32 nb, Ps::Array<PxU32>&
 		}
 	}
 
-	PX_FREE(PosList);
-
 	return true;
 }
 
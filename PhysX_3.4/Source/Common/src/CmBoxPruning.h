@@ -41,7 +41,11 @@ namespace physx
 
 namespace Cm
 {
+	class RadixSortBuffered;
+
 	PX_PHYSX_COMMON_API bool CompleteBoxPruning(const PxBounds3* bounds, PxU32 nb, Ps::Array<PxU32>& pairs, const Gu::Axes& axes);
+	// Same with caller-owned buffers, kept from one call to the next. The sorter then also benefits from the temporal coherence of its ranks.
+	PX_PHYSX_COMMON_API bool CompleteBoxPruning(const PxBounds3* bounds, PxU32 nb, Ps::Array<PxU32>& pairs, const Gu::Axes& axes, RadixSortBuffered& sorter, Ps::Array<float>& posList);
 	PX_PHYSX_COMMON_API bool BipartiteBoxPruning(const PxBounds3* bounds0, PxU32 nb0, const PxBounds3* bounds1, PxU32 nb1, Ps::Array<PxU32>& pairs, const Gu::Axes& axes);
 }
 }
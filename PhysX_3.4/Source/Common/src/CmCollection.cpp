@@ -33,12 +33,21 @@
 using namespace physx;
 using namespace Cm;
 
+namespace
+{
+	// the hash tables only grow once their entries exceed 3/4 of the table
+	PX_FORCE_INLINE PxU32 getTableSize(PxU32 nbEntries)
+	{
+		return nbEntries + nbEntries/3 + 1;
+	}
+}
+
 void Collection::add(PxBase& object, PxSerialObjectId id)
 {
-	PxSerialObjectId originId = getId(object);
-	if( originId != PX_SERIAL_OBJECT_ID_INVALID)
+	const ObjectToIdMap::Entry* e = mObjects.find(&object);
+	if(e && e->second != PX_SERIAL_OBJECT_ID_INVALID)
 	{
-		if( originId != id)
+		if(e->second != id)
 		{
 			 physx::shdfnd::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__,
 		        "PxCollection::add called for an object that has an associated id already present in the collection!");
@@ -55,8 +64,27 @@ void Collection::add(PxBase& object, PxSerialObjectId id)
 		   return;	
 		}
 	}
-    
-	mObjects[&object] = id;	
+
+	mObjects[&object] = id;
+}
+
+void Collection::add(PxBase* const* objects, PxU32 nbObjects, const PxSerialObjectId* ids)
+{
+	PX_CHECK_AND_RETURN(objects != NULL || nbObjects == 0, "PxCollection::add called with objects NULL!");
+
+	reserve(mObjects.size() + nbObjects, ids ? mIds.size() + nbObjects : 0);
+	for(PxU32 i = 0; i < nbObjects; ++i)
+	{
+		if(objects[i])
+			Collection::add(*objects[i], ids ? ids[i] : PX_SERIAL_OBJECT_ID_INVALID);
+	}
+}
+
+void Collection::reserve(PxU32 nbObjects, PxU32 nbIds)
+{
+	mObjects.reserve(getTableSize(nbObjects));
+	if(nbIds)
+		mIds.reserve(getTableSize(nbIds));
 }
 
 void Collection::remove(PxBase& object)
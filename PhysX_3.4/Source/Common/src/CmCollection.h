@@ -69,6 +69,8 @@ namespace Cm
 		typedef CollectionHashMap<PxSerialObjectId, PxBase*> IdToObjectMap;
 					
 		virtual void						add(PxBase& object, PxSerialObjectId ref);
+		virtual void						add(PxBase* const* objects, PxU32 nbObjects, const PxSerialObjectId* ids);
+		virtual void						reserve(PxU32 nbObjects, PxU32 nbIds);
 		virtual	void						remove(PxBase& object);	
 		virtual bool						contains(PxBase& object) const;
 		virtual void						addId(PxBase& object, PxSerialObjectId id);
@@ -92,10 +94,17 @@ namespace Cm
 		PX_INLINE	PxU32		            internalGetNbObjects()		 const	{ return mObjects.size();								               }
 		PX_INLINE	PxBase*		            internalGetObject(PxU32 i)	 const	{ PX_ASSERT(i<mObjects.size());	return mObjects.getEntries()[i].first; }
 		PX_INLINE	const ObjectToIdMap::Entry*	internalGetObjects() const  { return mObjects.getEntries(); 			                           }
+		// index of the object in [0, internalGetNbObjects()) or INVALID_INDEX, stable as long as nothing is removed
+		PX_INLINE	PxU32					internalGetIndex(const PxBase& s) const
+		{
+			const ObjectToIdMap::Entry* e = mObjects.find(const_cast<PxBase*>(&s));
+			return e ? PxU32(e - mObjects.getEntries()) : INVALID_INDEX;
+		}
+
+		static const PxU32					INVALID_INDEX = 0xffffffff;
 			
 		IdToObjectMap					    mIds;
 		ObjectToIdMap                       mObjects;
-		
 	};
 }
 }
@@ -0,0 +1,276 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_COMMON_PARALLEL_FOR
+#define PX_PHYSICS_COMMON_PARALLEL_FOR
+
+#include "foundation/PxMath.h"
+#include "task/PxTask.h"
+#include "CmPhysXCommon.h"
+#include "CmBitMap.h"
+#include "CmFlushPool.h"
+#include "CmTask.h"
+#include "PsAtomic.h"
+#include "PsFPU.h"
+#include "PsThread.h"
+#include "task/PxCpuDispatcher.h"
+
+/*
+Helpers to split a loop over a number of tasks that depends on the dispatcher, instead of fixed size batches.
+
+A few tasks are spawned (at most one per worker) and they all claim chunks of the loop from a shared ParallelForRange.
+Chunks start big and shrink as the loop runs out (guided self-scheduling), so a worker that is late or has slow items
+doesn't leave the others idle at the end, while most of the loop is still processed in big cache friendly chunks.
+*/
+
+namespace physx
+{
+namespace Cm
+{
+	class ParallelForRange
+	{
+	public:
+		ParallelForRange() : mNext(0), mCount(0), mNbTasks(1), mMinChunk(1), mMaxChunk(1) {}
+
+		PX_FORCE_INLINE void init(PxU32 count, PxU32 nbTasks, PxU32 minChunk, PxU32 maxChunk)
+		{
+			PX_ASSERT(minChunk && minChunk <= maxChunk);
+			mNext = 0;
+			mCount = count;
+			mNbTasks = PxMax(nbTasks, 1u);
+			mMinChunk = minChunk;
+			mMaxChunk = maxChunk;
+		}
+
+		// Claims the next chunk, returns false once the whole range was handed out
+		PX_FORCE_INLINE bool claim(PxU32& start, PxU32& nb)
+		{
+			while(true)
+			{
+				const PxI32 current = mNext;
+				if(PxU32(current) >= mCount)
+					return false;
+
+				// Half of the fair share of what is left, so the last chunks are small enough to balance the tasks
+				const PxU32 remaining = mCount - PxU32(current);
+				PxU32 size = PxClamp(remaining / (2 * mNbTasks), mMinChunk, mMaxChunk);
+				size = PxMin(size, remaining);
+
+				if(Ps::atomicCompareExchange(&mNext, PxI32(PxU32(current) + size), current) == current)
+				{
+					start = PxU32(current);
+					nb = size;
+					return true;
+				}
+			}
+		}
+
+		PX_FORCE_INLINE PxU32 getCount() const { return mCount; }
+
+	private:
+		volatile PxI32	mNext;
+		PxU32			mCount;
+		PxU32			mNbTasks;
+		PxU32			mMinChunk;
+		PxU32			mMaxChunk;
+	};
+
+	// Number of tasks to spawn for a loop of count items, so that every task gets at least minChunk items.
+	// Returns 0 for an empty loop.
+	PX_FORCE_INLINE PxU32 getParallelForTaskCount(PxU32 count, PxTaskManager* taskManager, PxU32 minChunk)
+	{
+		const PxU32 nbWorkers = taskManager && taskManager->getCpuDispatcher() ? taskManager->getCpuDispatcher()->getWorkerCount() : 0;
+		const PxU32 nbChunks = (count + minChunk - 1) / minChunk;
+		return PxMin(nbChunks, PxMax(nbWorkers, 1u));
+	}
+
+	typedef void (*BlockingParallelForFunction)(void* context, PxU32 start, PxU32 nb);
+
+	class BlockingParallelForTask;
+
+	// Shared state of blockingParallelFor. It is reference counted, since a helper can start after the calling thread
+	// has processed the whole range and returned, in which case the helper just releases its reference.
+	struct BlockingParallelForJob
+	{
+		ParallelForRange			mRange;
+		BlockingParallelForFunction	mFunction;
+		void*						mContext;	// Only valid while there are chunks left
+		const char*					mName;
+		volatile PxI32				mNbDone;
+		volatile PxI32				mRefCount;
+		BlockingParallelForTask*	mTasks;		// Allocated right after the job
+		PxU32						mNbTasks;
+
+		PX_INLINE void processChunks()
+		{
+			PX_SIMD_GUARD;
+			PxU32 start, nb;
+			while(mRange.claim(start, nb))
+			{
+				mFunction(mContext, start, nb);
+				Ps::atomicAdd(&mNbDone, PxI32(nb));
+			}
+		}
+
+		PX_INLINE void releaseReference();
+	};
+
+	class BlockingParallelForTask : public PxBaseTask
+	{
+	public:
+		BlockingParallelForTask(BlockingParallelForJob& job) : mJob(job)	{}
+
+		virtual	void		run()					{ mJob.processChunks();		}
+		virtual	void		release()				{ mJob.releaseReference();	}
+		virtual	const char*	getName()		const	{ return mJob.mName;		}
+		virtual	void		addReference()			{}
+		virtual	void		removeReference()		{}
+		virtual	PxI32		getReference()	const	{ return 1;	}
+
+	private:
+		BlockingParallelForJob&	mJob;
+
+		PX_NOCOPY(BlockingParallelForTask)
+	};
+
+	PX_INLINE void BlockingParallelForJob::releaseReference()
+	{
+		if(!Ps::atomicDecrement(&mRefCount))
+		{
+			for(PxU32 i=0;i<mNbTasks;i++)
+				mTasks[i].~BlockingParallelForTask();
+			this->~BlockingParallelForJob();
+			PX_FREE(this);
+		}
+	}
+
+	// Calls function(context, start, nb) over chunks of [0, count) and returns once the whole range was processed. This is for
+	// work outside of the simulation (cooking, tree builds, batched queries) that has a dispatcher but no continuation: the chunks
+	// are claimed like the ones of a ParallelForRange, by the calling thread and by up to one helper task per worker, so the
+	// function has to be thread safe. The calling thread yields while it waits for the chunks that helpers are still processing.
+	// Small ranges, or a call without dispatcher or workers, run right away on the calling thread.
+	PX_INLINE void blockingParallelFor(PxCpuDispatcher* dispatcher, PxU32 count, PxU32 minChunk, PxU32 maxChunk,
+		BlockingParallelForFunction function, void* context, const char* name)
+	{
+		PX_ASSERT(minChunk && minChunk <= maxChunk);
+		const PxU32 nbChunks = (count + minChunk - 1) / minChunk;
+		const PxU32 nbHelpers = dispatcher && nbChunks ? PxMin(dispatcher->getWorkerCount(), nbChunks - 1) : 0;
+		if(!nbHelpers)
+		{
+			if(count)
+				function(context, 0, count);
+			return;
+		}
+
+		BlockingParallelForJob* job = reinterpret_cast<BlockingParallelForJob*>(PX_ALLOC(sizeof(BlockingParallelForJob) + sizeof(BlockingParallelForTask)*nbHelpers, "Cm::BlockingParallelForJob"));
+		PX_PLACEMENT_NEW(job, BlockingParallelForJob)();
+		job->mRange.init(count, nbHelpers + 1, minChunk, maxChunk);
+		job->mFunction = function;
+		job->mContext = context;
+		job->mName = name;
+		job->mNbDone = 0;
+		job->mRefCount = PxI32(nbHelpers + 1);
+		job->mTasks = reinterpret_cast<BlockingParallelForTask*>(job + 1);
+		job->mNbTasks = nbHelpers;
+
+		for(PxU32 i=0;i<nbHelpers;i++)
+		{
+			PX_PLACEMENT_NEW(job->mTasks + i, BlockingParallelForTask)(*job);
+			dispatcher->submitTask(job->mTasks[i]);
+		}
+
+		job->processChunks();
+		while(job->mNbDone!=PxI32(count))
+			Ps::Thread::yield();
+		Ps::memoryBarrier();
+
+		job->releaseReference();
+	}
+
+	// Task of parallelForEachSetBit, the range is over words of the map
+	template<class Functor>
+	class ForEachSetBitTask : public Cm::Task
+	{
+	public:
+		ForEachSetBitTask(PxU64 contextId, const PxU32* words, ParallelForRange& range, Functor& functor) :
+			Cm::Task(contextId), mWords(words), mRange(range), mFunctor(functor)	{}
+
+		virtual void runInternal()
+		{
+			PxU32 start, nb;
+			while(mRange.claim(start, nb))
+				forEachSetBit(mWords, start, nb, mFunctor);
+		}
+
+		virtual const char* getName() const { return "Cm.forEachSetBit"; }
+
+		static const PxU32 MinWords = 256;
+		static const PxU32 MaxWords = 4096;
+	private:
+		const PxU32*		mWords;
+		ParallelForRange&	mRange;
+		Functor&			mFunctor;
+
+		PX_NOCOPY(ForEachSetBitTask)
+	};
+
+	// Calls functor(index) for every set bit of the map, from tasks spawned under the continuation. Bits are visited in
+	// increasing order within a chunk of words, but the chunks run in any order and concurrently, so the functor has to be
+	// thread safe. The map and the functor must not change until the continuation runs.
+	// Small maps, or a call without continuation, are walked right away on the calling thread.
+	template<class Allocator, class Functor>
+	void parallelForEachSetBit(const BitMapBase<Allocator>& map, Functor& functor, PxBaseTask* continuation, FlushPool& pool, PxU64 contextId)
+	{
+		typedef ForEachSetBitTask<Functor> TaskType;
+
+		const PxU32 wordCount = map.getWordCount();
+		const PxU32 nbTasks = continuation ? getParallelForTaskCount(wordCount, continuation->getTaskManager(), TaskType::MinWords) : 1;
+		if(nbTasks <= 1)
+		{
+			forEachSetBit(map.getWords(), 0, wordCount, functor);
+			return;
+		}
+
+		ParallelForRange* range = PX_PLACEMENT_NEW(pool.allocate(sizeof(ParallelForRange)), ParallelForRange)();
+		range->init(wordCount, nbTasks, TaskType::MinWords, TaskType::MaxWords);
+
+		for(PxU32 i=0; i<nbTasks; i++)
+		{
+			TaskType* task = PX_PLACEMENT_NEW(pool.allocate(sizeof(TaskType)), TaskType)(contextId, map.getWords(), *range, functor);
+			task->setContinuation(continuation);
+			task->removeReference();
+		}
+	}
+
+} // namespace Cm
+
+}
+
+#endif
@@ -30,11 +30,34 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "foundation/PxMemory.h"
 #include "foundation/PxAssert.h"
+#include "foundation/PxMath.h"
+#include "CmPhysXCommon.h"
 #include "CmRadixSort.h"
+#include "PsAllocator.h"
+#include "PsIntrinsics.h"
+#include "CmParallelFor.h"
+#if PX_SSE2
+	#include <emmintrin.h>
+#endif
 
 using namespace physx;
 using namespace Cm;
 
+// 11-bits digits: 3 passes (bits 0-10, 11-21, 22-31) instead of 4, for bigger histograms. Only worth it for big inputs.
+#define RADIX11_THRESHOLD			4096
+#define RADIX11_PARALLEL_THRESHOLD	32768
+#define RADIX11_SIZE				2048
+#define RADIX11_MASK				2047
+#define RADIX11_MAX_TASKS			16
+
+// Key types of the 11-bits versions
+enum RadixKeyType
+{
+	RADIX_KEY_UNSIGNED,
+	RADIX_KEY_SIGNED,
+	RADIX_KEY_FLOAT
+};
+
 #if defined(__BIG_ENDIAN__) || defined(_XBOX)
 	#define H0_OFFSET	768
 	#define H1_OFFSET	512
@@ -194,6 +217,10 @@ RadixSort& RadixSort::Sort(const PxU32* input, PxU32 nb, RadixHint hint)
 	// Stats
 	mTotalCalls++;
 
+	// Big inputs are sorted with 11-bits digits, saving a pass
+	if(nb>=RADIX11_THRESHOLD)
+		return Sort11(input, nb, hint==RADIX_UNSIGNED ? RADIX_KEY_UNSIGNED : RADIX_KEY_SIGNED);
+
 	// Create histograms (counters). Counters for all passes are created in one run.
 	// Pros:	read input buffer once instead of four times
 	// Cons:	mHistogram1024 is 4Kb instead of 1Kb
@@ -304,6 +331,10 @@ RadixSort& RadixSort::Sort(const float* input2, PxU32 nb)
 
 	const PxU32* PX_RESTRICT input = reinterpret_cast<const PxU32*>(input2);
 
+	// Big inputs are sorted with 11-bits digits, saving a pass
+	if(nb>=RADIX11_THRESHOLD)
+		return Sort11(input, nb, RADIX_KEY_FLOAT);
+
 	// Allocate histograms & offsets on the stack
 	//PxU32 mHistogram1024[256*4];
 	//PxU32* mLinks256[256];
@@ -458,3 +489,398 @@ bool RadixSort::SetBuffers(PxU32* ranks0, PxU32* ranks1, PxU32* histogram1024, P
 	return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Maps the keys to unsigned integers with the same order, so the passes don't have to deal with negative values.
+// This is done on-the-fly when reading the keys, there's no separate flip pass.
+template<PxU32 keyType>
+static PX_FORCE_INLINE PxU32 toSortableKey(PxU32 key)
+{
+	if(keyType==RADIX_KEY_SIGNED)
+		return key ^ 0x80000000;
+	if(keyType==RADIX_KEY_FLOAT)
+		return key ^ (PxU32(PxI32(key)>>31) | 0x80000000);	// Flip all bits of negative values, only the sign of positive ones
+	return key;
+}
+
+// Builds the histograms of the 3 passes for input[start..end[
+template<PxU32 keyType>
+static void createHistograms11(const PxU32* PX_RESTRICT input, PxU32 start, PxU32 end, PxU32* PX_RESTRICT histograms)
+{
+	PxU32* PX_RESTRICT h0 = histograms;
+	PxU32* PX_RESTRICT h1 = histograms + RADIX11_SIZE;
+	PxU32* PX_RESTRICT h2 = histograms + RADIX11_SIZE*2;
+
+	PxU32 i = start;
+#if PX_SSE2
+	// Keys are converted & split in digits 4 at a time, only the counters are updated one by one
+	const __m128i signBit = _mm_set1_epi32(PxI32(0x80000000));
+	const __m128i digitMask = _mm_set1_epi32(RADIX11_MASK);
+	PX_ALIGN(16, PxU32 digits[12]);
+	for(;i+4<=end;i+=4)
+	{
+		__m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+		if(keyType==RADIX_KEY_SIGNED)
+			keys = _mm_xor_si128(keys, signBit);
+		else if(keyType==RADIX_KEY_FLOAT)
+			keys = _mm_xor_si128(keys, _mm_or_si128(_mm_srai_epi32(keys, 31), signBit));
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(digits), _mm_and_si128(keys, digitMask));
+		_mm_store_si128(reinterpret_cast<__m128i*>(digits+4), _mm_and_si128(_mm_srli_epi32(keys, 11), digitMask));
+		_mm_store_si128(reinterpret_cast<__m128i*>(digits+8), _mm_srli_epi32(keys, 22));
+
+		h0[digits[0]]++;	h0[digits[1]]++;	h0[digits[2]]++;	h0[digits[3]]++;
+		h1[digits[4]]++;	h1[digits[5]]++;	h1[digits[6]]++;	h1[digits[7]]++;
+		h2[digits[8]]++;	h2[digits[9]]++;	h2[digits[10]]++;	h2[digits[11]]++;
+	}
+#endif
+	for(;i<end;i++)
+	{
+		const PxU32 key = toSortableKey<keyType>(input[i]);
+		h0[key & RADIX11_MASK]++;
+		h1[(key>>11) & RADIX11_MASK]++;
+		h2[key>>22]++;
+	}
+}
+
+// Builds the histogram of a single pass for the keys referenced by ranks[start..end[
+template<PxU32 keyType>
+static void createHistogram11(const PxU32* PX_RESTRICT input, const PxU32* PX_RESTRICT ranks, PxU32 start, PxU32 end, PxU32 shift, PxU32* PX_RESTRICT histogram)
+{
+	for(PxU32 i=start;i<end;i++)
+		histogram[(toSortableKey<keyType>(input[ranks[i]])>>shift) & RADIX11_MASK]++;
+}
+
+// Scatters the indices of input[start..end[ (or of ranks[start..end[ if ranks is not NULL) using the offsets
+template<PxU32 keyType>
+static void scatter11(const PxU32* PX_RESTRICT input, const PxU32* PX_RESTRICT ranks, PxU32 start, PxU32 end, PxU32 shift, PxU32* PX_RESTRICT offsets, PxU32* PX_RESTRICT dst)
+{
+	if(!ranks)
+	{
+		for(PxU32 i=start;i<end;i++)
+			dst[offsets[(toSortableKey<keyType>(input[i])>>shift) & RADIX11_MASK]++] = i;
+	}
+	else
+	{
+		for(PxU32 i=start;i<end;i++)
+		{
+			const PxU32 id = ranks[i];
+			dst[offsets[(toSortableKey<keyType>(input[id])>>shift) & RADIX11_MASK]++] = id;
+		}
+	}
+}
+
+static void createHistograms11(PxU32 keyType, const PxU32* input, PxU32 start, PxU32 end, PxU32* histograms)
+{
+	if(keyType==RADIX_KEY_UNSIGNED)		createHistograms11<RADIX_KEY_UNSIGNED>(input, start, end, histograms);
+	else if(keyType==RADIX_KEY_SIGNED)	createHistograms11<RADIX_KEY_SIGNED>(input, start, end, histograms);
+	else								createHistograms11<RADIX_KEY_FLOAT>(input, start, end, histograms);
+}
+
+static void createHistogram11(PxU32 keyType, const PxU32* input, const PxU32* ranks, PxU32 start, PxU32 end, PxU32 shift, PxU32* histogram)
+{
+	if(keyType==RADIX_KEY_UNSIGNED)		createHistogram11<RADIX_KEY_UNSIGNED>(input, ranks, start, end, shift, histogram);
+	else if(keyType==RADIX_KEY_SIGNED)	createHistogram11<RADIX_KEY_SIGNED>(input, ranks, start, end, shift, histogram);
+	else								createHistogram11<RADIX_KEY_FLOAT>(input, ranks, start, end, shift, histogram);
+}
+
+static void scatter11(PxU32 keyType, const PxU32* input, const PxU32* ranks, PxU32 start, PxU32 end, PxU32 shift, PxU32* offsets, PxU32* dst)
+{
+	if(keyType==RADIX_KEY_UNSIGNED)		scatter11<RADIX_KEY_UNSIGNED>(input, ranks, start, end, shift, offsets, dst);
+	else if(keyType==RADIX_KEY_SIGNED)	scatter11<RADIX_KEY_SIGNED>(input, ranks, start, end, shift, offsets, dst);
+	else								scatter11<RADIX_KEY_FLOAT>(input, ranks, start, end, shift, offsets, dst);
+}
+
+static PX_FORCE_INLINE PxU32 getSortableKey(PxU32 keyType, PxU32 key)
+{
+	if(keyType==RADIX_KEY_UNSIGNED)		return toSortableKey<RADIX_KEY_UNSIGNED>(key);
+	else if(keyType==RADIX_KEY_SIGNED)	return toSortableKey<RADIX_KEY_SIGNED>(key);
+	else								return toSortableKey<RADIX_KEY_FLOAT>(key);
+}
+
+// Returns true if the keys are already sorted in the order given by ranks (or in the input order if ranks is NULL)
+template<PxU32 keyType>
+static bool isSorted11(const PxU32* PX_RESTRICT input, const PxU32* PX_RESTRICT ranks, PxU32 nb)
+{
+	PxU32 prevKey = toSortableKey<keyType>(input[ranks ? ranks[0] : 0]);
+	for(PxU32 i=1;i<nb;i++)
+	{
+		const PxU32 key = toSortableKey<keyType>(input[ranks ? ranks[i] : i]);
+		if(key<prevKey)
+			return false;
+		prevKey = key;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	11-bits digits sort routine, for all key types. Same results as the 8-bits version, except for the order of equal negative floats and of -0/+0.
+ *	\param		input	[in] a list of values to sort
+ *	\param		nb		[in] number of values to sort
+ *	\param		keyType	[in] RadixKeyType of the values
+ *	\return		Self-Reference
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RadixSort& RadixSort::Sort11(const PxU32* input, PxU32 nb, PxU32 keyType)
+{
+	// Temporal coherence: early exit if the previous order is still valid. This is a separate loop so that
+	// the histograms can be created linearly (and with SIMD) afterwards, unsorted inputs usually exit this loop quickly.
+	{
+		const PxU32* ranks = INVALID_RANKS ? NULL : mRanks;
+		bool alreadySorted;
+		if(keyType==RADIX_KEY_UNSIGNED)		alreadySorted = isSorted11<RADIX_KEY_UNSIGNED>(input, ranks, nb);
+		else if(keyType==RADIX_KEY_SIGNED)	alreadySorted = isSorted11<RADIX_KEY_SIGNED>(input, ranks, nb);
+		else								alreadySorted = isSorted11<RADIX_KEY_FLOAT>(input, ranks, nb);
+		if(alreadySorted)
+		{
+			mNbHits++;
+			if(!ranks)
+				for(PxU32 i=0;i<nb;i++)	mRanks[i] = i;
+			return *this;
+		}
+	}
+
+	PxU32* histograms = reinterpret_cast<PxU32*>(PX_ALLOC_TEMP(sizeof(PxU32)*RADIX11_SIZE*3, "Cm::RadixSort::Sort11"));
+	PxMemZero(histograms, sizeof(PxU32)*RADIX11_SIZE*3);
+	createHistograms11(keyType, input, 0, nb, histograms);
+
+	const PxU32 firstKey = getSortableKey(keyType, input[0]);
+	for(PxU32 pass=0;pass<3;pass++)
+	{
+		const PxU32 shift = pass*11;
+		PxU32* PX_RESTRICT offsets = histograms + pass*RADIX11_SIZE;
+
+		// If all values have the same digit, the pass is useless
+		if(offsets[(firstKey>>shift) & RADIX11_MASK]==nb)
+			continue;
+
+		// Create offsets in place
+		PxU32 sum = 0;
+		for(PxU32 i=0;i<RADIX11_SIZE;i++)
+		{
+			const PxU32 count = offsets[i];
+			offsets[i] = sum;
+			sum += count;
+		}
+
+		scatter11(keyType, input, INVALID_RANKS ? NULL : mRanks, 0, nb, shift, offsets, mRanks2);
+		VALIDATE_RANKS;
+
+		// Swap pointers for next pass. Valid indices - the most recent ones - are in mRanks after the swap.
+		PxU32* Tmp	= mRanks;	mRanks = mRanks2; mRanks2 = Tmp;
+	}
+
+	// All keys equal, and no previous order
+	if(INVALID_RANKS)
+	{
+		for(PxU32 i=0;i<nb;i++)	mRanks[i] = i;
+		VALIDATE_RANKS;
+	}
+
+	PX_FREE(histograms);
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	// Data shared by the chunks of a step of the multi-threaded sort
+	struct ParallelSortData
+	{
+		enum Step
+		{
+			eHISTOGRAMS,	// Histograms of the 3 passes, in input order
+			eHISTOGRAM,		// Histogram of the current pass, in the order of the previous pass
+			eSCATTER
+		};
+
+		const PxU32*	mInput;
+		const PxU32*	mSrcRanks;	// NULL for the input order
+		PxU32*			mDstRanks;
+		PxU32*			mHistograms;	// RADIX11_SIZE*3 counters per chunk
+		PxU32			mNb;
+		PxU32			mNbChunks;
+		PxU32			mKeyType;
+		PxU32			mPass;
+		Step			mStep;
+
+		PX_FORCE_INLINE	PxU32	getChunkStart(PxU32 chunk)	const	{ return PxU32((PxU64(mNb)*chunk)/mNbChunks);	}
+
+		void runChunk(PxU32 chunk) const
+		{
+			const PxU32 start = getChunkStart(chunk);
+			const PxU32 end = getChunkStart(chunk+1);
+			PxU32* histograms = mHistograms + chunk*RADIX11_SIZE*3;
+			if(mStep==eHISTOGRAMS)
+			{
+				PxMemZero(histograms, sizeof(PxU32)*RADIX11_SIZE*3);
+				createHistograms11(mKeyType, mInput, start, end, histograms);
+			}
+			else if(mStep==eHISTOGRAM)
+			{
+				PxU32* histogram = histograms + mPass*RADIX11_SIZE;
+				PxMemZero(histogram, sizeof(PxU32)*RADIX11_SIZE);
+				createHistogram11(mKeyType, mInput, mSrcRanks, start, end, mPass*11, histogram);
+			}
+			else
+			{
+				scatter11(mKeyType, mInput, mSrcRanks, start, end, mPass*11, histograms + mPass*RADIX11_SIZE, mDstRanks);
+			}
+		}
+	};
+
+	void runChunks(void* context, PxU32 start, PxU32 nb)
+	{
+		const ParallelSortData& data = *reinterpret_cast<const ParallelSortData*>(context);
+		for(PxU32 chunk=start;chunk<start+nb;chunk++)
+			data.runChunk(chunk);
+	}
+
+	// Processes the chunks of a step on the calling thread and the helper tasks, returns when all of them are done
+	PX_FORCE_INLINE void runParallelStep(const ParallelSortData& data, PxCpuDispatcher& dispatcher)
+	{
+		Cm::blockingParallelFor(&dispatcher, data.mNbChunks, 1, 1, runChunks, const_cast<ParallelSortData*>(&data), "Cm::RadixSort.parallelSort");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Multi-threaded 11-bits digits sort routine, for all key types.
+ *	\param		input		[in] a list of values to sort
+ *	\param		nb			[in] number of values to sort
+ *	\param		keyType		[in] RadixKeyType of the values
+ *	\param		dispatcher	[in] dispatcher running the helper tasks
+ *	\param		nbTasks		[in] number of chunks, including the one processed by the calling thread
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void RadixSort::SortParallel11(const PxU32* input, PxU32 nb, PxU32 keyType, PxCpuDispatcher& dispatcher, PxU32 nbTasks)
+{
+	ParallelSortData data;
+	data.mInput			= input;
+	data.mSrcRanks		= NULL;
+	data.mDstRanks		= mRanks2;
+	data.mHistograms	= reinterpret_cast<PxU32*>(PX_ALLOC_TEMP(sizeof(PxU32)*RADIX11_SIZE*3*nbTasks, "Cm::RadixSort::SortParallel11"));
+	data.mNb			= nb;
+	data.mNbChunks		= nbTasks;
+	data.mKeyType		= keyType;
+	data.mPass			= 0;
+	data.mStep			= ParallelSortData::eHISTOGRAMS;
+
+	// The histograms of the first pass are computed for all passes at once, in input order
+	runParallelStep(data, dispatcher);
+
+	// Total counts, to skip the useless passes
+	PxU32 totals[3];
+	const PxU32 firstKey = getSortableKey(keyType, input[0]);
+	for(PxU32 pass=0;pass<3;pass++)
+	{
+		const PxU32 digit = (firstKey>>(pass*11)) & RADIX11_MASK;
+		totals[pass] = 0;
+		for(PxU32 chunk=0;chunk<nbTasks;chunk++)
+			totals[pass] += data.mHistograms[chunk*RADIX11_SIZE*3 + pass*RADIX11_SIZE + digit];
+	}
+
+	bool firstPass = true;
+	for(PxU32 pass=0;pass<3;pass++)
+	{
+		// If all values have the same digit, the pass is useless
+		if(totals[pass]==nb)
+			continue;
+
+		data.mPass = pass;
+		data.mSrcRanks = firstPass ? NULL : mRanks;
+		data.mDstRanks = mRanks2;
+
+		// After the first pass the chunks hold different values, their histograms must be recomputed
+		if(!firstPass)
+		{
+			data.mStep = ParallelSortData::eHISTOGRAM;
+			runParallelStep(data, dispatcher);
+		}
+
+		// Offsets of each chunk: values of the first chunks come first, to keep the sort stable
+		PxU32 sum = 0;
+		for(PxU32 i=0;i<RADIX11_SIZE;i++)
+		{
+			PxU32* PX_RESTRICT counts = data.mHistograms + pass*RADIX11_SIZE + i;
+			for(PxU32 chunk=0;chunk<nbTasks;chunk++)
+			{
+				const PxU32 count = counts[chunk*RADIX11_SIZE*3];
+				counts[chunk*RADIX11_SIZE*3] = sum;
+				sum += count;
+			}
+		}
+
+		data.mStep = ParallelSortData::eSCATTER;
+		runParallelStep(data, dispatcher);
+
+		// Swap pointers for next pass. Valid indices - the most recent ones - are in mRanks after the swap.
+		PxU32* Tmp	= mRanks;	mRanks = mRanks2; mRanks2 = Tmp;
+		firstPass = false;
+	}
+
+	// All keys equal
+	if(firstPass)
+	{
+		for(PxU32 i=0;i<nb;i++)	mRanks[i] = i;
+	}
+	VALIDATE_RANKS;
+
+	PX_FREE(data.mHistograms);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Multi-threaded sort routine for integer values. Small inputs, or a missing dispatcher, go through the single-threaded version.
+ *	\param		input		[in] a list of integer values to sort
+ *	\param		nb			[in] number of values to sort, must be < 2^31
+ *	\param		dispatcher	[in] dispatcher running the helper tasks
+ *	\param		nbTasks		[in] number of threads taking part in the sort, including the calling one
+ *	\param		hint		[in] RADIX_SIGNED to handle negative values, RADIX_UNSIGNED if you know your input buffer only contains positive values
+ *	\return		Self-Reference
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RadixSort& RadixSort::SortParallel(const PxU32* input, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks, RadixHint hint)
+{
+	// Checkings
+	if(!input || !nb || nb&0x80000000)	return *this;
+
+	nbTasks = PxMin(PxMin(nbTasks, PxU32(RADIX11_MAX_TASKS)), nb/(RADIX11_PARALLEL_THRESHOLD/4));
+	if(!dispatcher || nbTasks<2 || nb<RADIX11_PARALLEL_THRESHOLD)
+		return Sort(input, nb, hint);
+
+	// Stats
+	mTotalCalls++;
+
+	SortParallel11(input, nb, hint==RADIX_UNSIGNED ? RADIX_KEY_UNSIGNED : RADIX_KEY_SIGNED, *dispatcher, nbTasks);
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Multi-threaded sort routine for floating-point values. Small inputs, or a missing dispatcher, go through the single-threaded version.
+ *	\param		input2		[in] a list of floating-point values to sort
+ *	\param		nb			[in] number of values to sort, must be < 2^31
+ *	\param		dispatcher	[in] dispatcher running the helper tasks
+ *	\param		nbTasks		[in] number of threads taking part in the sort, including the calling one
+ *	\return		Self-Reference
+ *	\warning	only sorts IEEE floating-point values
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RadixSort& RadixSort::SortParallel(const float* input2, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks)
+{
+	// Checkings
+	if(!input2 || !nb || nb&0x80000000)	return *this;
+
+	nbTasks = PxMin(PxMin(nbTasks, PxU32(RADIX11_MAX_TASKS)), nb/(RADIX11_PARALLEL_THRESHOLD/4));
+	if(!dispatcher || nbTasks<2 || nb<RADIX11_PARALLEL_THRESHOLD)
+		return Sort(input2, nb);
+
+	// Stats
+	mTotalCalls++;
+
+	SortParallel11(reinterpret_cast<const PxU32*>(input2), nb, RADIX_KEY_FLOAT, *dispatcher, nbTasks);
+	return *this;
+}
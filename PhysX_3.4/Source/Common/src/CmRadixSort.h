@@ -34,6 +34,8 @@
 
 namespace physx
 {
+class PxCpuDispatcher;
+
 namespace Cm
 {
 
@@ -58,6 +60,11 @@ namespace Cm
 		// Sorting methods
 						RadixSort&		Sort(const PxU32* input, PxU32 nb, RadixHint hint=RADIX_SIGNED);
 						RadixSort&		Sort(const float* input, PxU32 nb);
+		// Multi-threaded sorting methods, for big inputs. Chunks of each pass are processed by tasks submitted to the dispatcher,
+		// the calling thread takes part and returns when the sort is done. Small inputs are sorted with the single-threaded version.
+		// Temporal coherence is not used, the ranks are always recomputed.
+						RadixSort&		SortParallel(const PxU32* input, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks, RadixHint hint=RADIX_SIGNED);
+						RadixSort&		SortParallel(const float* input, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks);
 
 		//! Access to results. mRanks is a list of indices in sorted order, i.e. in the order you may further process your data
 		PX_FORCE_INLINE	const PxU32*	GetRanks()			const	{ return mRanks;		}
@@ -77,6 +84,10 @@ namespace Cm
 										RadixSort(const RadixSort& object);
 										RadixSort& operator=(const RadixSort& object);
 		protected:
+		// 11-bits digits versions (3 passes instead of 4), used for big inputs
+						RadixSort&		Sort11(const PxU32* input, PxU32 nb, PxU32 keyType);
+						void			SortParallel11(const PxU32* input, PxU32 nb, PxU32 keyType, PxCpuDispatcher& dispatcher, PxU32 nbTasks);
+
 						PxU32			mCurrentSize;		//!< Current size of the indices list
 						PxU32*			mRanks;				//!< Two lists, swapped each pass
 						PxU32*			mRanks2;
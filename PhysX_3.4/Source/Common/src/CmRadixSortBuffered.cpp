@@ -140,3 +140,43 @@ RadixSortBuffered& RadixSortBuffered::Sort(const float* input2, PxU32 nb)
 	return *this;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Multi-threaded sort routines, see RadixSort::SortParallel.
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RadixSortBuffered& RadixSortBuffered::SortParallel(const PxU32* input, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks, RadixHint hint)
+{
+	// Checkings
+	if(!input || !nb || nb&0x80000000)	return *this;
+
+	// Resize lists if needed
+	CheckResize(nb);
+
+	//Set histogram buffers, for the single-threaded fallback
+	PxU32 histogram[1024];
+	PxU32* links[256];
+	mHistogram1024=histogram;
+	mLinks256=links;
+
+	RadixSort::SortParallel(input,nb,dispatcher,nbTasks,hint);
+	return *this;
+}
+
+RadixSortBuffered& RadixSortBuffered::SortParallel(const float* input2, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks)
+{
+	// Checkings
+	if(!input2 || !nb || nb&0x80000000)	return *this;
+
+	// Resize lists if needed
+	CheckResize(nb);
+
+	//Set histogram buffers, for the single-threaded fallback
+	PxU32 histogram[1024];
+	PxU32* links[256];
+	mHistogram1024=histogram;
+	mLinks256=links;
+
+	RadixSort::SortParallel(input2,nb,dispatcher,nbTasks);
+	return *this;
+}
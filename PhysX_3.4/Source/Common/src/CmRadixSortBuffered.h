@@ -45,6 +45,8 @@ namespace Cm
 
 		RadixSortBuffered&	Sort(const PxU32* input, PxU32 nb, RadixHint hint=RADIX_SIGNED);
 		RadixSortBuffered&	Sort(const float* input, PxU32 nb);
+		RadixSortBuffered&	SortParallel(const PxU32* input, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks, RadixHint hint=RADIX_SIGNED);
+		RadixSortBuffered&	SortParallel(const float* input, PxU32 nb, PxCpuDispatcher* dispatcher, PxU32 nbTasks);
 
 	private:
 							RadixSortBuffered(const RadixSortBuffered& object);
@@ -38,6 +38,8 @@
 #include "PsMutex.h"
 #include "PsInlineArray.h"
 #include "PsFPU.h"
+#include "PsFoundation.h"
+#include "CmTaskTimer.h"
 
 namespace physx
 {
@@ -63,6 +65,8 @@ namespace Cm
 #else
 			PX_SIMD_GUARD;
 #endif
+			shdfnd::AllocationContextScope allocationContext(mContextID);
+			TaskTimerScope timing(mContextID);
 			runInternal();
 		}
 
@@ -82,6 +86,8 @@ namespace Cm
 #else
 			PX_SIMD_GUARD;
 #endif
+			shdfnd::AllocationContextScope allocationContext(mContextID);
+			TaskTimerScope timing(mContextID);
 			runInternal();
 		}
 
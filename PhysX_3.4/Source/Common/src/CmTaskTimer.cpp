@@ -0,0 +1,97 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "CmPhysXCommon.h"
+#include "CmTaskTimer.h"
+#include "PsAtomic.h"
+#include "PsIntrinsics.h"
+
+using namespace physx;
+
+namespace
+{
+	Cm::TaskTimer	gTimers[Cm::TaskTimer::MAX_TIMERS];
+	// High water mark of the acquired timers, the lookups stop there
+	volatile PxI32	gNbTimers = 0;
+}
+
+Cm::TaskTimer* Cm::TaskTimer::acquire(PxU64 contextId)
+{
+	PX_ASSERT(contextId);
+
+	for(PxU32 i = 0; i < MAX_TIMERS; i++)
+	{
+		TaskTimer& timer = gTimers[i];
+		if(Ps::atomicCompareExchange(&timer.mUsed, 1, 0) != 0)
+			continue;
+
+		timer.mStage = NO_STAGE;
+		timer.reset();
+		Ps::memoryBarrier();
+		timer.mContextId = contextId;
+
+		PxI32 nbTimers = gNbTimers;
+		while(nbTimers <= PxI32(i) && Ps::atomicCompareExchange(&gNbTimers, PxI32(i + 1), nbTimers) != nbTimers)
+			nbTimers = gNbTimers;
+		return &timer;
+	}
+	return NULL;
+}
+
+void Cm::TaskTimer::release()
+{
+	mContextId = 0;
+	mStage = NO_STAGE;
+	Ps::memoryBarrier();
+	mUsed = 0;
+}
+
+Cm::TaskTimer* Cm::TaskTimer::find(PxU64 contextId)
+{
+	const PxU32 nbTimers = PxU32(gNbTimers);
+	for(PxU32 i = 0; i < nbTimers; i++)
+	{
+		if(contextId && gTimers[i].mContextId == contextId)
+			return &gTimers[i];
+	}
+	return NULL;
+}
+
+void Cm::TaskTimer::addTime(PxI32 stage, PxU64 counterStart)
+{
+	const PxU64 elapsed = Ps::Time::getBootCounterFrequency().toTensOfNanos(Ps::Time::getCurrentCounterValue() - counterStart);
+	Ps::atomicAdd(&mTime[stage], PxI32(elapsed));
+}
+
+void Cm::TaskTimer::reset()
+{
+	for(PxU32 i = 0; i < MAX_STAGES; i++)
+		mTime[i] = 0;
+}
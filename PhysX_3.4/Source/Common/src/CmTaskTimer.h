@@ -0,0 +1,102 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef CM_TASK_TIMER_H
+#define CM_TASK_TIMER_H
+
+#include "PxPhysXCommonConfig.h"
+#include "PsTime.h"
+
+namespace physx
+{
+namespace Cm
+{
+	// CPU time of the SDK tasks of a context, sorted by the stage of the simulation step that was current when they started.
+	// Cm::Task and Cm::BaseTask look up the timer of their context on every run. Timers live in a static table and are never
+	// freed, so a task still finishing after its scene was released only adds a little time to whoever reuses the timer.
+	class PX_PHYSX_COMMON_API TaskTimer
+	{
+	public:
+		static const PxU32	MAX_STAGES = 16;
+		static const PxU32	MAX_TIMERS = 16;
+		static const PxI32	NO_STAGE = -1;
+
+		// Returns NULL when every timer is taken, the tasks of the context are then not timed
+		static	TaskTimer*	acquire(PxU64 contextId);
+				void		release();
+
+		// Returns NULL if the context has no timer
+		static	TaskTimer*	find(PxU64 contextId);
+
+		PX_FORCE_INLINE	void	setStage(PxI32 stage)	{ mStage = stage;	}
+		PX_FORCE_INLINE	PxI32	getStage()	const		{ return mStage;	}
+
+		// Times are in tens of nanoseconds, for at most 40 seconds per stage between resets
+				void		addTime(PxI32 stage, PxU64 counterStart);
+		PX_FORCE_INLINE	PxU64	getTime(PxU32 stage)	const	{ return PxU64(PxU32(mTime[stage]));	}
+				void		reset();
+
+	private:
+		volatile PxU64		mContextId;	// 0 while free
+		volatile PxI32		mUsed;
+		volatile PxI32		mStage;
+		volatile PxI32		mTime[MAX_STAGES];
+	};
+
+	// Times a task run for the timer of its context
+	class TaskTimerScope
+	{
+	public:
+		PX_FORCE_INLINE TaskTimerScope(PxU64 contextId) : mTimer(TaskTimer::find(contextId))
+		{
+			if(mTimer)
+			{
+				mStage = mTimer->getStage();
+				mStart = shdfnd::Time::getCurrentCounterValue();
+			}
+		}
+
+		PX_FORCE_INLINE ~TaskTimerScope()
+		{
+			if(mTimer && mStage != TaskTimer::NO_STAGE)
+				mTimer->addTime(mStage, mStart);
+		}
+
+	private:
+		TaskTimer*	mTimer;
+		PxI32		mStage;
+		PxU64		mStart;
+	};
+
+} // namespace Cm
+
+}
+
+#endif
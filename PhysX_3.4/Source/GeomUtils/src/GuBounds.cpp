@@ -396,6 +396,126 @@ void Gu::computeBounds(PxBounds3& bounds, const PxGeometry& geometry, const PxTr
 	}
 }
 
+bool Gu::BoundsBatch::add(PxBounds3& bounds, const PxGeometry& geometry, const PxTransform& pose)
+{
+	PxVec3 center(0.0f), extents(0.0f);
+	PxReal radius = 0.0f;
+
+	switch(geometry.getType())
+	{
+		case PxGeometryType::eSPHERE:
+		{
+			radius = static_cast<const PxSphereGeometry&>(geometry).radius;
+		}
+		break;
+
+		case PxGeometryType::eCAPSULE:
+		{
+			const PxCapsuleGeometry& shape = static_cast<const PxCapsuleGeometry&>(geometry);
+			extents.x = shape.halfHeight;
+			radius = shape.radius;
+		}
+		break;
+
+		case PxGeometryType::eBOX:
+		{
+			extents = static_cast<const PxBoxGeometry&>(geometry).halfExtents;
+		}
+		break;
+
+		case PxGeometryType::eCONVEXMESH:
+		{
+			const PxConvexMeshGeometry& shape = static_cast<const PxConvexMeshGeometry&>(geometry);
+			if((shape.meshFlags & PxConvexMeshGeometryFlag::eTIGHT_BOUNDS) || isNonIdentity(shape.scale.scale))
+				return false;
+
+			const CenterExtentsPadded& localBounds = static_cast<const Gu::ConvexMesh*>(shape.convexMesh)->getHull().getPaddedBounds();
+			center = localBounds.mCenter;
+			extents = localBounds.mExtents;
+		}
+		break;
+
+		case PxGeometryType::ePLANE:
+		case PxGeometryType::eTRIANGLEMESH:
+		case PxGeometryType::eHEIGHTFIELD:
+		case PxGeometryType::eGEOMETRY_COUNT:
+		case PxGeometryType::eINVALID:
+			return false;
+	}
+
+	const PxU32 i = mNb++;
+	mData[ePX][i] = pose.p.x;	mData[ePY][i] = pose.p.y;	mData[ePZ][i] = pose.p.z;
+	mData[eQX][i] = pose.q.x;	mData[eQY][i] = pose.q.y;	mData[eQZ][i] = pose.q.z;	mData[eQW][i] = pose.q.w;
+	mData[eCX][i] = center.x;	mData[eCY][i] = center.y;	mData[eCZ][i] = center.z;
+	mData[eEX][i] = extents.x;	mData[eEY][i] = extents.y;	mData[eEZ][i] = extents.z;
+	mData[eRADIUS][i] = radius;
+	mBounds[i] = &bounds;
+
+	if(mNb==4)
+		computeBatch();
+	return true;
+}
+
+void Gu::BoundsBatch::computeBatch()
+{
+	// the unused lanes of a partial batch compute garbage, they are not written back
+	const Vec4V px = V4LoadU(mData[ePX]);
+	const Vec4V py = V4LoadU(mData[ePY]);
+	const Vec4V pz = V4LoadU(mData[ePZ]);
+	const Vec4V qx = V4LoadU(mData[eQX]);
+	const Vec4V qy = V4LoadU(mData[eQY]);
+	const Vec4V qz = V4LoadU(mData[eQZ]);
+	const Vec4V qw = V4LoadU(mData[eQW]);
+
+	// rotation matrix of the quaternions, same as PxMat33(const PxQuat&)
+	const Vec4V x2 = V4Add(qx, qx);
+	const Vec4V y2 = V4Add(qy, qy);
+	const Vec4V z2 = V4Add(qz, qz);
+	const Vec4V xx = V4Mul(x2, qx);
+	const Vec4V yy = V4Mul(y2, qy);
+	const Vec4V zz = V4Mul(z2, qz);
+	const Vec4V xy = V4Mul(x2, qy);
+	const Vec4V xz = V4Mul(x2, qz);
+	const Vec4V xw = V4Mul(x2, qw);
+	const Vec4V yz = V4Mul(y2, qz);
+	const Vec4V yw = V4Mul(y2, qw);
+	const Vec4V zw = V4Mul(z2, qw);
+	const Vec4V one = V4One();
+
+	const Vec4V m00 = V4Sub(V4Sub(one, yy), zz);	const Vec4V m01 = V4Sub(xy, zw);				const Vec4V m02 = V4Add(xz, yw);
+	const Vec4V m10 = V4Add(xy, zw);				const Vec4V m11 = V4Sub(V4Sub(one, xx), zz);	const Vec4V m12 = V4Sub(yz, xw);
+	const Vec4V m20 = V4Sub(xz, yw);				const Vec4V m21 = V4Add(yz, xw);				const Vec4V m22 = V4Sub(V4Sub(one, xx), yy);
+
+	const Vec4V cx = V4LoadU(mData[eCX]);
+	const Vec4V cy = V4LoadU(mData[eCY]);
+	const Vec4V cz = V4LoadU(mData[eCZ]);
+	const Vec4V ex = V4LoadU(mData[eEX]);
+	const Vec4V ey = V4LoadU(mData[eEY]);
+	const Vec4V ez = V4LoadU(mData[eEZ]);
+	const Vec4V radius = V4LoadU(mData[eRADIUS]);
+
+	// world center = p + R*c, world extents = |R|*e + radius
+	const Vec4V wcx = V4MulAdd(m02, cz, V4MulAdd(m01, cy, V4MulAdd(m00, cx, px)));
+	const Vec4V wcy = V4MulAdd(m12, cz, V4MulAdd(m11, cy, V4MulAdd(m10, cx, py)));
+	const Vec4V wcz = V4MulAdd(m22, cz, V4MulAdd(m21, cy, V4MulAdd(m20, cx, pz)));
+	const Vec4V wex = V4MulAdd(V4Abs(m02), ez, V4MulAdd(V4Abs(m01), ey, V4MulAdd(V4Abs(m00), ex, radius)));
+	const Vec4V wey = V4MulAdd(V4Abs(m12), ez, V4MulAdd(V4Abs(m11), ey, V4MulAdd(V4Abs(m10), ex, radius)));
+	const Vec4V wez = V4MulAdd(V4Abs(m22), ez, V4MulAdd(V4Abs(m21), ey, V4MulAdd(V4Abs(m20), ex, radius)));
+
+	PX_ALIGN(16, PxReal minX[4]);	PX_ALIGN(16, PxReal minY[4]);	PX_ALIGN(16, PxReal minZ[4]);
+	PX_ALIGN(16, PxReal maxX[4]);	PX_ALIGN(16, PxReal maxY[4]);	PX_ALIGN(16, PxReal maxZ[4]);
+	V4StoreA(V4Sub(wcx, wex), minX);	V4StoreA(V4Sub(wcy, wey), minY);	V4StoreA(V4Sub(wcz, wez), minZ);
+	V4StoreA(V4Add(wcx, wex), maxX);	V4StoreA(V4Add(wcy, wey), maxY);	V4StoreA(V4Add(wcz, wez), maxZ);
+
+	for(PxU32 i=0;i<mNb;i++)
+	{
+		PxBounds3& bounds = *mBounds[i];
+		bounds.minimum = PxVec3(minX[i], minY[i], minZ[i]);
+		bounds.maximum = PxVec3(maxX[i], maxY[i], maxZ[i]);
+	}
+	mNb = 0;
+}
+
 // PT: TODO: refactor this with regular function
 PxF32 Gu::computeBoundsWithCCDThreshold(Vec3p& origin, Vec3p& extent, const PxGeometry& geometry, const PxTransform& pose, const CenterExtentsPadded* PX_RESTRICT localSpaceBounds)
 {
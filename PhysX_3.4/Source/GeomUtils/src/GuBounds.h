@@ -68,6 +68,45 @@ PX_FORCE_INLINE PxBounds3 computeBounds(const PxGeometry& geometry, const PxTran
 	return bounds;
 }
 
+// computes the world bounds of 4 shapes at a time, in SoA form. This covers the shapes whose bounds are a box in shape
+// space grown by a radius: spheres, capsules, boxes, and convexes with identity scale and without tight bounds (using the
+// local bounds of the hull). Same results as computeBounds() without contact offset and inflation, up to rounding.
+//
+// add() returns false for the other shapes, which then have to go through computeBounds(). The bounds are written when 4
+// shapes are waiting, and by flush(), which must be called before the bounds are read.
+class BoundsBatch
+{
+public:
+	PX_FORCE_INLINE							BoundsBatch() : mNb(0)	{}
+	PX_FORCE_INLINE							~BoundsBatch()			{ PX_ASSERT(!mNb);	}
+
+	PX_PHYSX_COMMON_API	bool				add(PxBounds3& bounds, const PxGeometry& geometry, const PxTransform& pose);
+
+	PX_FORCE_INLINE		void				flush()
+											{
+												if(mNb)
+													computeBatch();
+											}
+private:
+	PX_PHYSX_COMMON_API	void				computeBatch();
+
+	enum Channel
+	{
+		ePX, ePY, ePZ,
+		eQX, eQY, eQZ, eQW,
+		eCX, eCY, eCZ,			// center of the local box
+		eEX, eEY, eEZ,			// extents of the local box
+		eRADIUS,
+		eCHANNEL_COUNT
+	};
+
+	PxReal				mData[eCHANNEL_COUNT][4];
+	PxBounds3*			mBounds[4];
+	PxU32				mNb;
+
+	PX_NOCOPY(BoundsBatch)
+};
+
 class ShapeData
 {
 public:
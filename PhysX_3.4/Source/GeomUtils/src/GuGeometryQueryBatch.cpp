@@ -0,0 +1,505 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#include "PxGeometryQuery.h"
+#include "GuInternal.h"
+#include "GuOverlapTests.h"
+#include "GuSweepTests.h"
+#include "GuRaycastTests.h"
+#include "GuBoxConversion.h"
+#include "GuMTD.h"
+#include "PsVecMath.h"
+#include "PsFPU.h"
+#include "PxSphereGeometry.h"
+#include "PxBoxGeometry.h"
+#include "PxCapsuleGeometry.h"
+#include "PxConvexMeshGeometry.h"
+
+using namespace physx;
+using namespace Gu;
+using namespace Ps::aos;
+
+extern GeomSweepFuncs gGeomSweepFuncs;
+extern GeomOverlapTable gGeomOverlapMethodTable[];
+extern RaycastFunc gRaycastMap[PxGeometryType::eGEOMETRY_COUNT];
+extern GeomMTDFunc gGeomMTDMethodTable[][PxGeometryType::eGEOMETRY_COUNT];
+
+// the batched versions of the PxGeometryQuery functions. Each batch is made of a single pair of geometry types, so the
+// test is looked up once, and the pairs of spheres and capsules (i.e. pairs of segments with a radius) are done four at a time.
+
+#if PX_CHECKED
+static bool checkBatch(const char* name, PxU32 nbTests, const PxGeometryPoseArray& geoms)
+{
+	const PxGeometryType::Enum type = geoms.getGeometry(0).getType();
+	for(PxU32 i=0;i<nbTests;i++)
+	{
+		if(geoms.getGeometry(i).getType()!=type)
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "%s: all the geometry objects of an array must be of the same type.", name);
+			return false;
+		}
+		if(!PxGeometryQuery::isValid(geoms.getGeometry(i)))
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "%s: provided geometry %d is not valid.", name, i);
+			return false;
+		}
+		if(!geoms.getPose(i).isValid())
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "%s: pose %d is not valid.", name, i);
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
+static PX_FORCE_INLINE bool isSegmentType(PxGeometryType::Enum type)
+{
+	return type==PxGeometryType::eSPHERE || type==PxGeometryType::eCAPSULE;
+}
+
+namespace
+{
+	// four pairs of spheres or capsules in SoA form. A sphere is a capsule with a null half-height.
+	struct SegmentPairs4
+	{
+		enum
+		{
+			ePX0, ePY0, ePZ0, eQX0, eQY0, eQZ0, eQW0, eHALF_HEIGHT0, eRADIUS0,
+			ePX1, ePY1, ePZ1, eQX1, eQY1, eQZ1, eQW1, eHALF_HEIGHT1, eRADIUS1,
+			eCOUNT
+		};
+
+		PX_FORCE_INLINE void set(PxU32 lane, PxU32 offset, const PxGeometry& geom, const PxTransform& pose)
+		{
+			PxReal halfHeight, radius;
+			if(geom.getType()==PxGeometryType::eSPHERE)
+			{
+				halfHeight = 0.0f;
+				radius = static_cast<const PxSphereGeometry&>(geom).radius;
+			}
+			else
+			{
+				const PxCapsuleGeometry& capsuleGeom = static_cast<const PxCapsuleGeometry&>(geom);
+				halfHeight = capsuleGeom.halfHeight;
+				radius = capsuleGeom.radius;
+			}
+
+			mData[offset + ePX0][lane] = pose.p.x;	mData[offset + ePY0][lane] = pose.p.y;	mData[offset + ePZ0][lane] = pose.p.z;
+			mData[offset + eQX0][lane] = pose.q.x;	mData[offset + eQY0][lane] = pose.q.y;	mData[offset + eQZ0][lane] = pose.q.z;	mData[offset + eQW0][lane] = pose.q.w;
+			mData[offset + eHALF_HEIGHT0][lane] = halfHeight;
+			mData[offset + eRADIUS0][lane] = radius;
+		}
+
+		PX_FORCE_INLINE void gather(PxU32 lane, const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1, PxU32 index)
+		{
+			set(lane, 0, geoms0.getGeometry(index), geoms0.getPose(index));
+			set(lane, ePX1, geoms1.getGeometry(index), geoms1.getPose(index));
+		}
+
+		// the unused lanes of a partial batch are zeroed, which makes them pairs of points
+		PX_FORCE_INLINE void clearLanes(PxU32 nb)
+		{
+			for(PxU32 i=0;i<eCOUNT;i++)
+				for(PxU32 lane=nb;lane<4;lane++)
+					mData[i][lane] = 0.0f;
+		}
+
+		// segment of the capsule, p - axis*halfHeight to p + axis*halfHeight, as a start point and a direction.
+		// The axis is the first column of the rotation matrix, as in getCapsuleHalfHeightVector().
+		PX_FORCE_INLINE void getSegment(PxU32 offset, Vec4V* PX_RESTRICT start, Vec4V* PX_RESTRICT dir) const
+		{
+			const Vec4V qx = V4LoadA(mData[offset + eQX0]);
+			const Vec4V qy = V4LoadA(mData[offset + eQY0]);
+			const Vec4V qz = V4LoadA(mData[offset + eQZ0]);
+			const Vec4V qw = V4LoadA(mData[offset + eQW0]);
+			const Vec4V halfHeight = V4LoadA(mData[offset + eHALF_HEIGHT0]);
+
+			const Vec4V two = V4Load(2.0f);
+			const Vec4V ax = V4Sub(V4One(), V4Mul(two, V4MulAdd(qy, qy, V4Mul(qz, qz))));
+			const Vec4V ay = V4Mul(two, V4MulAdd(qx, qy, V4Mul(qz, qw)));
+			const Vec4V az = V4Mul(two, V4Sub(V4Mul(qx, qz), V4Mul(qy, qw)));
+
+			const Vec4V hx = V4Mul(ax, halfHeight);
+			const Vec4V hy = V4Mul(ay, halfHeight);
+			const Vec4V hz = V4Mul(az, halfHeight);
+
+			start[0] = V4Sub(V4LoadA(mData[offset + ePX0]), hx);
+			start[1] = V4Sub(V4LoadA(mData[offset + ePY0]), hy);
+			start[2] = V4Sub(V4LoadA(mData[offset + ePZ0]), hz);
+			dir[0] = V4Add(hx, hx);
+			dir[1] = V4Add(hy, hy);
+			dir[2] = V4Add(hz, hz);
+		}
+
+		// closest points between the two segments, as in distanceSegmentSegmentSquared(). Returns the vector from the
+		// closest point on the second segment to the one on the first segment, and the sum of the radii.
+		void computeClosestPoints(Vec4V* PX_RESTRICT delta, Vec4V& radiusSum) const
+		{
+			Vec4V p1[3], d1[3], p2[3], d2[3];
+			getSegment(0, p1, d1);
+			getSegment(ePX1, p2, d2);
+
+			const Vec4V rx = V4Sub(p1[0], p2[0]);
+			const Vec4V ry = V4Sub(p1[1], p2[1]);
+			const Vec4V rz = V4Sub(p1[2], p2[2]);
+
+			const Vec4V a = V4MulAdd(d1[2], d1[2], V4MulAdd(d1[1], d1[1], V4Mul(d1[0], d1[0])));
+			const Vec4V e = V4MulAdd(d2[2], d2[2], V4MulAdd(d2[1], d2[1], V4Mul(d2[0], d2[0])));
+			const Vec4V b = V4MulAdd(d1[2], d2[2], V4MulAdd(d1[1], d2[1], V4Mul(d1[0], d2[0])));
+			const Vec4V c = V4MulAdd(d1[2], rz, V4MulAdd(d1[1], ry, V4Mul(d1[0], rx)));
+			const Vec4V f = V4MulAdd(d2[2], rz, V4MulAdd(d2[1], ry, V4Mul(d2[0], rx)));
+
+			const Vec4V zero = V4Zero();
+			const Vec4V one = V4One();
+			const Vec4V eps = V4Load(1e-12f);
+			const Vec4V aSafe = V4Max(a, eps);
+			const Vec4V eSafe = V4Max(e, eps);
+
+			// general case, clamped to the first segment, then to the second one and back to the first one.
+			// Parallel segments (null denominator) start from s=0.
+			const Vec4V denom = V4NegMulSub(b, b, V4Mul(a, e));
+			const Vec4V s0 = V4Sel(V4IsGrtr(denom, eps), V4Clamp(V4Div(V4Sub(V4Mul(b, f), V4Mul(c, e)), V4Max(denom, eps)), zero, one), zero);
+			const Vec4V tN = V4Div(V4MulAdd(b, s0, f), eSafe);
+			const Vec4V sLow = V4Clamp(V4Div(V4Neg(c), aSafe), zero, one);
+			const Vec4V sHigh = V4Clamp(V4Div(V4Sub(b, c), aSafe), zero, one);
+			Vec4V s = V4Sel(V4IsGrtr(zero, tN), sLow, V4Sel(V4IsGrtr(tN, one), sHigh, s0));
+			Vec4V t = V4Clamp(tN, zero, one);
+
+			// the second segment is a point (sphere)
+			const BoolV eNull = V4IsGrtrOrEq(eps, e);
+			s = V4Sel(eNull, sLow, s);
+			t = V4Sel(eNull, zero, t);
+
+			// the first segment is a point (sphere). For two points f is null, hence t=0 as well
+			const BoolV aNull = V4IsGrtrOrEq(eps, a);
+			s = V4Sel(aNull, zero, s);
+			t = V4Sel(aNull, V4Clamp(V4Div(f, eSafe), zero, one), t);
+
+			delta[0] = V4Sub(V4MulAdd(d1[0], s, p1[0]), V4MulAdd(d2[0], t, p2[0]));
+			delta[1] = V4Sub(V4MulAdd(d1[1], s, p1[1]), V4MulAdd(d2[1], t, p2[1]));
+			delta[2] = V4Sub(V4MulAdd(d1[2], s, p1[2]), V4MulAdd(d2[2], t, p2[2]));
+			radiusSum = V4Add(V4LoadA(mData[eRADIUS0]), V4LoadA(mData[eRADIUS1]));
+		}
+
+		PX_ALIGN(16, PxReal mData[eCOUNT][4]);
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PxU32 PxGeometryQuery::overlapBatch(PxU32 nbTests, const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1, bool* PX_RESTRICT results)
+{
+	PX_SIMD_GUARD;
+	if(!nbTests)
+		return 0;
+
+#if PX_CHECKED
+	if(!checkBatch("PxGeometryQuery::overlapBatch()", nbTests, geoms0) || !checkBatch("PxGeometryQuery::overlapBatch()", nbTests, geoms1))
+		return 0;
+#endif
+
+	const PxGeometryType::Enum type0 = geoms0.getGeometry(0).getType();
+	const PxGeometryType::Enum type1 = geoms1.getGeometry(0).getType();
+
+	PxU32 nbHits = 0;
+	if(isSegmentType(type0) && isSegmentType(type1))
+	{
+		SegmentPairs4 pairs;
+		for(PxU32 start=0;start<nbTests;start+=4)
+		{
+			const PxU32 nb = PxMin(nbTests - start, PxU32(4));
+			for(PxU32 lane=0;lane<nb;lane++)
+				pairs.gather(lane, geoms0, geoms1, start + lane);
+			if(nb<4)
+				pairs.clearLanes(nb);
+
+			Vec4V delta[3], radiusSum;
+			pairs.computeClosestPoints(delta, radiusSum);
+
+			const Vec4V sqDist = V4MulAdd(delta[2], delta[2], V4MulAdd(delta[1], delta[1], V4Mul(delta[0], delta[0])));
+			const BoolV overlap = V4IsGrtrOrEq(V4Mul(radiusSum, radiusSum), sqDist);
+
+			PX_ALIGN(16, PxU32 mask[4]);
+			V4U32StoreAligned(VecU32V_From_BoolV(overlap), reinterpret_cast<VecU32V*>(mask));
+			for(PxU32 lane=0;lane<nb;lane++)
+			{
+				const bool hit = mask[lane]!=0;
+				results[start + lane] = hit;
+				nbHits += PxU32(hit);
+			}
+		}
+		return nbHits;
+	}
+
+	// same ordering as Gu::overlap(), decided once for the batch
+	const bool swap = type0 > type1;
+	const GeomOverlapFunc func = swap ? gGeomOverlapMethodTable[type1][type0] : gGeomOverlapMethodTable[type0][type1];
+	PX_ASSERT(func);
+
+	for(PxU32 i=0;i<nbTests;i++)
+	{
+		const bool hit = swap ?	func(geoms1.getGeometry(i), geoms1.getPose(i), geoms0.getGeometry(i), geoms0.getPose(i), NULL)
+							:	func(geoms0.getGeometry(i), geoms0.getPose(i), geoms1.getGeometry(i), geoms1.getPose(i), NULL);
+		results[i] = hit;
+		nbHits += PxU32(hit);
+	}
+	return nbHits;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static PX_FORCE_INLINE void setNoHit(PxLocationHit& hit)
+{
+	hit.flags		= PxHitFlags(0);
+	hit.distance	= PX_MAX_REAL;
+}
+
+PxU32 PxGeometryQuery::raycastBatch(PxU32 nbTests, const PxVec3* origins, const PxVec3* unitDirs, PxReal maxDist,
+									const PxGeometryPoseArray& geoms, PxHitFlags hitFlags, PxRaycastHit* PX_RESTRICT rayHits)
+{
+	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN_VAL(maxDist >= 0.0f, "PxGeometryQuery::raycastBatch(): maxDist is negative.", 0);
+	PX_CHECK_AND_RETURN_VAL(PxIsFinite(maxDist), "PxGeometryQuery::raycastBatch(): maxDist is not valid.", 0);
+	if(!nbTests)
+		return 0;
+
+#if PX_CHECKED
+	if(!checkBatch("PxGeometryQuery::raycastBatch()", nbTests, geoms))
+		return 0;
+	for(PxU32 i=0;i<nbTests;i++)
+	{
+		PX_CHECK_AND_RETURN_VAL(origins[i].isFinite(), "PxGeometryQuery::raycastBatch(): ray origin is not valid.", 0);
+		PX_CHECK_AND_RETURN_VAL(unitDirs[i].isFinite() && PxAbs(unitDirs[i].magnitudeSquared()-1)<1e-4f, "PxGeometryQuery::raycastBatch(): ray direction must be unit vector.", 0);
+	}
+#endif
+
+	const RaycastFunc func = gRaycastMap[geoms.getGeometry(0).getType()];
+
+	PxU32 nbHits = 0;
+	for(PxU32 i=0;i<nbTests;i++)
+	{
+		if(func(geoms.getGeometry(i), geoms.getPose(i), origins[i], unitDirs[i], maxDist, hitFlags, 1, rayHits + i))
+			nbHits++;
+		else
+			setNoHit(rayHits[i]);
+	}
+	return nbHits;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PxU32 PxGeometryQuery::sweepBatch(	PxU32 nbTests, const PxVec3* unitDirs, PxReal maxDist,
+									const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1,
+									PxSweepHit* PX_RESTRICT sweepHits, PxHitFlags hitFlags, PxReal inflation)
+{
+	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN_VAL(PxIsFinite(maxDist), "PxGeometryQuery::sweepBatch(): distance is not valid.", 0);
+	PX_CHECK_AND_RETURN_VAL((maxDist >= 0.0f && !(hitFlags & PxHitFlag::eASSUME_NO_INITIAL_OVERLAP)) || maxDist > 0.0f,
+		"PxGeometryQuery::sweepBatch(): sweep distance must be >=0 or >0 with eASSUME_NO_INITIAL_OVERLAP.", 0);
+	if(!nbTests)
+		return 0;
+
+#if PX_CHECKED
+	if(!checkBatch("PxGeometryQuery::sweepBatch()", nbTests, geoms0) || !checkBatch("PxGeometryQuery::sweepBatch()", nbTests, geoms1))
+		return 0;
+	for(PxU32 i=0;i<nbTests;i++)
+		PX_CHECK_AND_RETURN_VAL(unitDirs[i].isFinite(), "PxGeometryQuery::sweepBatch(): unitDir is not valid.", 0);
+#endif
+
+	const GeomSweepFuncs& sf = gGeomSweepFuncs;
+	const PxGeometryType::Enum type1 = geoms1.getGeometry(0).getType();
+	const bool precise = hitFlags & PxHitFlag::ePRECISE_SWEEP;
+
+	PxU32 nbHits = 0;
+	switch(geoms0.getGeometry(0).getType())
+	{
+		case PxGeometryType::eSPHERE:
+		{
+			const SweepCapsuleFunc func = precise ? sf.preciseCapsuleMap[type1] : sf.capsuleMap[type1];
+			for(PxU32 i=0;i<nbTests;i++)
+			{
+				const PxSphereGeometry& sphereGeom = static_cast<const PxSphereGeometry&>(geoms0.getGeometry(i));
+				const PxTransform& pose0 = geoms0.getPose(i);
+
+				// same as PxGeometryQuery::sweep(), the sphere is swept as a capsule with a null half-height
+				const PxCapsuleGeometry capsuleGeom(sphereGeom.radius, 0.0f);
+				const Capsule worldCapsule(pose0.p, pose0.p, sphereGeom.radius);
+
+				if(func(geoms1.getGeometry(i), geoms1.getPose(i), capsuleGeom, pose0, worldCapsule, unitDirs[i], maxDist, sweepHits[i], hitFlags, inflation))
+					nbHits++;
+				else
+					setNoHit(sweepHits[i]);
+			}
+		}
+		break;
+
+		case PxGeometryType::eCAPSULE:
+		{
+			const SweepCapsuleFunc func = precise ? sf.preciseCapsuleMap[type1] : sf.capsuleMap[type1];
+			for(PxU32 i=0;i<nbTests;i++)
+			{
+				const PxCapsuleGeometry& capsuleGeom = static_cast<const PxCapsuleGeometry&>(geoms0.getGeometry(i));
+				const PxTransform& pose0 = geoms0.getPose(i);
+
+				Capsule worldCapsule;
+				getCapsule(worldCapsule, capsuleGeom, pose0);
+
+				if(func(geoms1.getGeometry(i), geoms1.getPose(i), capsuleGeom, pose0, worldCapsule, unitDirs[i], maxDist, sweepHits[i], hitFlags, inflation))
+					nbHits++;
+				else
+					setNoHit(sweepHits[i]);
+			}
+		}
+		break;
+
+		case PxGeometryType::eBOX:
+		{
+			const SweepBoxFunc func = precise ? sf.preciseBoxMap[type1] : sf.boxMap[type1];
+			for(PxU32 i=0;i<nbTests;i++)
+			{
+				const PxBoxGeometry& boxGeom = static_cast<const PxBoxGeometry&>(geoms0.getGeometry(i));
+				const PxTransform& pose0 = geoms0.getPose(i);
+
+				Box box;
+				buildFrom(box, pose0.p, boxGeom.halfExtents, pose0.q);
+
+				if(func(geoms1.getGeometry(i), geoms1.getPose(i), boxGeom, pose0, box, unitDirs[i], maxDist, sweepHits[i], hitFlags, inflation))
+					nbHits++;
+				else
+					setNoHit(sweepHits[i]);
+			}
+		}
+		break;
+
+		case PxGeometryType::eCONVEXMESH:
+		{
+			const SweepConvexFunc func = sf.convexMap[type1];
+			for(PxU32 i=0;i<nbTests;i++)
+			{
+				const PxConvexMeshGeometry& convexGeom = static_cast<const PxConvexMeshGeometry&>(geoms0.getGeometry(i));
+
+				if(func(geoms1.getGeometry(i), geoms1.getPose(i), convexGeom, geoms0.getPose(i), unitDirs[i], maxDist, sweepHits[i], hitFlags, inflation))
+					nbHits++;
+				else
+					setNoHit(sweepHits[i]);
+			}
+		}
+		break;
+
+		case PxGeometryType::ePLANE:
+		case PxGeometryType::eTRIANGLEMESH:
+		case PxGeometryType::eHEIGHTFIELD:
+		case PxGeometryType::eGEOMETRY_COUNT:
+		case PxGeometryType::eINVALID:
+			PX_CHECK_MSG(false, "PxGeometryQuery::sweepBatch(): first geometry objects must be sphere, capsule, box or convex geometries.");
+			break;
+	}
+	return nbHits;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PxU32 PxGeometryQuery::computePenetrationBatch(	PxU32 nbTests, const PxGeometryPoseArray& geoms0, const PxGeometryPoseArray& geoms1,
+												PxVec3* PX_RESTRICT directions, PxF32* PX_RESTRICT depths, bool* PX_RESTRICT results)
+{
+	PX_SIMD_GUARD;
+	if(!nbTests)
+		return 0;
+
+#if PX_CHECKED
+	if(!checkBatch("PxGeometryQuery::computePenetrationBatch()", nbTests, geoms0) || !checkBatch("PxGeometryQuery::computePenetrationBatch()", nbTests, geoms1))
+		return 0;
+#endif
+
+	const PxGeometryType::Enum type0 = geoms0.getGeometry(0).getType();
+	const PxGeometryType::Enum type1 = geoms1.getGeometry(0).getType();
+	const bool swap = type0 > type1;
+
+	PxU32 nbHits = 0;
+	if(isSegmentType(type0) && isSegmentType(type1))
+	{
+		// computePenetration() flips the direction when it swaps the geometries, including the arbitrary one picked for a null normal
+		const PxVec3 nullDirection(swap ? -1.0f : 1.0f, 0.0f, 0.0f);
+
+		SegmentPairs4 pairs;
+		for(PxU32 start=0;start<nbTests;start+=4)
+		{
+			const PxU32 nb = PxMin(nbTests - start, PxU32(4));
+			for(PxU32 lane=0;lane<nb;lane++)
+				pairs.gather(lane, geoms0, geoms1, start + lane);
+			if(nb<4)
+				pairs.clearLanes(nb);
+
+			Vec4V delta[3], radiusSum;
+			pairs.computeClosestPoints(delta, radiusSum);
+
+			PX_ALIGN(16, PxReal dx[4]);	PX_ALIGN(16, PxReal dy[4]);	PX_ALIGN(16, PxReal dz[4]);	PX_ALIGN(16, PxReal rs[4]);
+			V4StoreA(delta[0], dx);	V4StoreA(delta[1], dy);	V4StoreA(delta[2], dz);	V4StoreA(radiusSum, rs);
+
+			for(PxU32 lane=0;lane<nb;lane++)
+			{
+				const PxU32 i = start + lane;
+				const PxVec3 normal(dx[lane], dy[lane], dz[lane]);
+				const PxReal lenSq = normal.magnitudeSquared();
+				if(lenSq > rs[lane]*rs[lane])
+				{
+					results[i] = false;
+					continue;
+				}
+
+				// same as manualNormalize() and validateDepth() in GuMTD.cpp
+				const PxReal len = PxSqrt(lenSq);
+				directions[i] = lenSq < 1e-6f ? nullDirection : normal / len;
+				depths[i] = PxMax(rs[lane] - len, 0.0f);
+				results[i] = true;
+				nbHits++;
+			}
+		}
+		return nbHits;
+	}
+
+	const GeomMTDFunc func = swap ? gGeomMTDMethodTable[type1][type0] : gGeomMTDMethodTable[type0][type1];
+	PX_ASSERT(func);
+
+	for(PxU32 i=0;i<nbTests;i++)
+	{
+		bool hit;
+		if(swap)
+		{
+			hit = func(directions[i], depths[i], geoms1.getGeometry(i), geoms1.getPose(i), geoms0.getGeometry(i), geoms0.getPose(i));
+			directions[i] = -directions[i];
+		}
+		else
+			hit = func(directions[i], depths[i], geoms0.getGeometry(i), geoms0.getPose(i), geoms1.getGeometry(i), geoms1.getPose(i));
+		results[i] = hit;
+		nbHits += PxU32(hit);
+	}
+	return nbHits;
+}
@@ -36,6 +36,7 @@
 #include "GuConvexMesh.h"
 #include "GuHeightField.h"
 #include "GuConvexMeshData.h"
+#include "GuBigConvexData.h"
 #include "CmUtils.h"
 #include "GuMeshData.h"
 #include "PsFoundation.h"
@@ -80,9 +81,11 @@ void GuMeshFactory::release()
 	while(mConvexMeshes.size())
 	{
 		Gu::ConvexMesh* mesh = mConvexMeshes.getEntries()[0];
-		PX_ASSERT(mesh->getRefCount()==1);
+		// a shared mesh holds one reference per creation
+		PX_ASSERT(mesh->getRefCount()>=1);
 		GU_MESH_FACTORY_GPU_NOTIFICATION(notifyReleaseConvexMesh, *mesh);
-		mesh->release();
+		for(PxU32 nbReferences=mesh->getRefCount(); nbReferences; nbReferences--)
+			mesh->release();
 	}
 
 	while(mHeightFields.size())
@@ -144,6 +147,42 @@ PxTriangleMesh* GuMeshFactory::createTriangleMesh(void* data)
 	return createTriangleMesh(*reinterpret_cast<TriangleMeshData*>(data));
 }
 
+// Reads the zigzag varint deltas written with IMSF_DELTA_INDICES
+template<class T>
+static bool readDeltaIndices(PxU32 nbIndices, T* indices, PxInputStream& stream, bool mismatch)
+{
+	const PxU32 nbBytes = readDword(mismatch, stream);
+	PxU8* bytes = reinterpret_cast<PxU8*>(PX_ALLOC_TEMP(nbBytes ? nbBytes : 1, "DeltaIndices"));
+	stream.read(bytes, nbBytes);
+
+	PxU32 previous = 0;
+	PxU32 offset = 0;
+	for(PxU32 i=0;i<nbIndices;i++)
+	{
+		PxU32 zigzag = 0;
+		PxU32 shift = 0;
+		PxU8 byte;
+		do
+		{
+			if(offset>=nbBytes || shift>28)
+			{
+				PX_FREE(bytes);
+				return false;
+			}
+			byte = bytes[offset++];
+			zigzag |= PxU32(byte & 0x7f)<<shift;
+			shift += 7;
+		}
+		while(byte & 0x80);
+
+		previous += (zigzag>>1) ^ (0-(zigzag&1));
+		indices[i] = T(previous);
+	}
+
+	PX_FREE(bytes);
+	return true;
+}
+
 static TriangleMeshData* loadMeshData(PxInputStream& stream)
 {
 	// Import header
@@ -204,7 +243,18 @@ static TriangleMeshData* loadMeshData(PxInputStream& stream)
 	}
 	//TODO: stop support for format conversion on load!!
 	const PxU32 nbIndices = 3*data->mNbTriangles;
-	if(serialFlags & IMSF_8BIT_INDICES)
+	if(serialFlags & IMSF_DELTA_INDICES)
+	{
+		const bool ok = data->has16BitIndices() ? readDeltaIndices(nbIndices, reinterpret_cast<PxU16*>(tris), stream, mismatch)
+												: readDeltaIndices(nbIndices, reinterpret_cast<PxU32*>(tris), stream, mismatch);
+		if(!ok)
+		{
+			Ps::getFoundation().error(PxErrorCode::eINTERNAL_ERROR, __FILE__, __LINE__, "Loading triangle mesh failed: corrupted index data.");
+			PX_DELETE(data);
+			return NULL;
+		}
+	}
+	else if(serialFlags & IMSF_8BIT_INDICES)
 	{
 		PxU8 x;
 		if(data->has16BitIndices())
@@ -527,6 +577,104 @@ PxConvexMesh* GuMeshFactory::createConvexMesh(void* data)
 	return createConvexMesh(*reinterpret_cast<Gu::ConvexHullData*>(data));
 }
 
+// the hull is cooked into one buffer, polygons first and vertices second. They are enough for the hash,
+// the full comparison is only done for meshes with the same hash.
+static PxU32 hashConvexHull(const ConvexHullData& hull)
+{
+	const PxU8* bytes = reinterpret_cast<const PxU8*>(hull.mPolygons);
+	const PxU32 size = sizeof(HullPolygonData)*hull.mNbPolygons + sizeof(PxVec3)*hull.mNbHullVertices;
+	PxU32 hash = 2166136261u;	// FNV-1a
+	for(PxU32 i=0;i<size;i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+// Same as computeBufferSize, without the padding bytes which are not initialized
+static PxU32 computeConvexHullDataSize(const ConvexHullData& hull)
+{
+	PxU32 nb = 0;
+	for(PxU32 i=0;i<hull.mNbPolygons;i++)
+		nb += hull.mPolygons[i].mNbVerts;
+
+	PxU32 size = sizeof(HullPolygonData) * hull.mNbPolygons;
+	size += sizeof(PxVec3) * hull.mNbHullVertices;
+	size += sizeof(PxU8) * hull.mNbEdges * 2;
+	size += sizeof(PxU8) * hull.mNbHullVertices * 3;
+	size += hull.mNbEdges.isBitSet() ? (sizeof(PxU16) * hull.mNbEdges * 2) : 0;
+	size += sizeof(PxU8) * nb;
+	return size;
+}
+
+static bool sameBytes(const void* a, const void* b, PxU32 size)
+{
+	const PxU8* PX_RESTRICT ba = reinterpret_cast<const PxU8*>(a);
+	const PxU8* PX_RESTRICT bb = reinterpret_cast<const PxU8*>(b);
+	for(PxU32 i=0;i<size;i++)
+	{
+		if(ba[i]!=bb[i])
+			return false;
+	}
+	return true;
+}
+
+static bool sameConvexMesh(const ConvexMesh& a, const ConvexMesh& b)
+{
+	const ConvexHullData& ha = a.getHull();
+	const ConvexHullData& hb = b.getHull();
+	if(ha.mNbHullVertices!=hb.mNbHullVertices || ha.mNbPolygons!=hb.mNbPolygons || ha.mNbEdges!=hb.mNbEdges
+		|| (ha.mNbEdges.isBitSet()!=0)!=(hb.mNbEdges.isBitSet()!=0) || a.getBufferSize()!=b.getBufferSize())
+		return false;
+
+	if(!sameBytes(ha.mPolygons, hb.mPolygons, computeConvexHullDataSize(ha)))
+		return false;
+
+	if(a.getMass()!=b.getMass() || !sameBytes(&a.getInertia(), &b.getInertia(), sizeof(PxMat33))
+		|| ha.mCenterOfMass!=hb.mCenterOfMass || ha.mAABB.mCenter!=hb.mAABB.mCenter || ha.mAABB.mExtents!=hb.mAABB.mExtents
+		|| !sameBytes(&ha.mInternal, &hb.mInternal, sizeof(InternalObjectsData)))
+		return false;
+
+	const BigConvexRawData* ba = ha.mBigConvexRawData;
+	const BigConvexRawData* bb = hb.mBigConvexRawData;
+	if(!ba || !bb)
+		return ba==bb;
+
+	return ba->mSubdiv==bb->mSubdiv && ba->mNbSamples==bb->mNbSamples && ba->mNbVerts==bb->mNbVerts && ba->mNbAdjVerts==bb->mNbAdjVerts
+		&& sameBytes(ba->mSamples, bb->mSamples, sizeof(PxU8)*ba->mNbSamples*2)
+		&& sameBytes(ba->mValencies, bb->mValencies, sizeof(Valency)*ba->mNbVerts)
+		&& sameBytes(ba->mAdjacentVerts, bb->mAdjacentVerts, sizeof(PxU8)*ba->mNbAdjVerts);
+}
+
+PxConvexMesh* GuMeshFactory::shareConvexMesh(Gu::ConvexMesh* mesh)
+{
+	PX_ASSERT(mesh);
+	const PxU32 hash = hashConvexHull(mesh->getHull());
+
+	ConvexMesh* shared = NULL;
+	{
+		Ps::Mutex::ScopedLock lock(mTrackingMutex);
+		const Ps::HashMap<PxU32, ConvexMesh*>::Entry* entry = mSharedConvexMeshes.find(hash);
+		if(!entry)
+		{
+			mSharedConvexMeshes.insert(hash, mesh);
+			return mesh;
+		}
+
+		// a mesh whose last reference is being released can't be revived, the new one is kept instead
+		if(entry->second!=mesh && entry->second->getRefCount() && sameConvexMesh(*entry->second, *mesh))
+		{
+			shared = entry->second;
+			shared->acquireReference();
+		}
+	}
+
+	if(!shared)
+		return mesh;
+
+	// outside of the lock, removeConvexMesh takes it again
+	mesh->release();
+	return shared;
+}
+
 PxConvexMesh* GuMeshFactory::createConvexMesh(Gu::ConvexHullData& data)
 {
 	Gu::ConvexMesh *np;
@@ -553,7 +701,7 @@ PxConvexMesh* GuMeshFactory::createConvexMesh(PxInputStream& desc)
 	}
 
 	addConvexMesh(np);
-	return np;
+	return shareConvexMesh(np);
 }
 
 bool GuMeshFactory::removeConvexMesh(PxConvexMesh& m)
@@ -564,6 +712,11 @@ bool GuMeshFactory::removeConvexMesh(PxConvexMesh& m)
 	bool found = mConvexMeshes.erase(gu);
 	if(found)
 	{
+		const PxU32 hash = hashConvexHull(gu->getHull());
+		const Ps::HashMap<PxU32, ConvexMesh*>::Entry* entry = mSharedConvexMeshes.find(hash);
+		if(entry && entry->second==gu)
+			mSharedConvexMeshes.erase(hash);
+
 		GU_MESH_FACTORY_GPU_NOTIFICATION(notifyReleaseConvexMesh, m)
 	}
 
@@ -42,6 +42,7 @@
 
 #include "PsUserAllocated.h"
 #include "PsHashSet.h"
+#include "PsHashMap.h"
 
 namespace physx
 {
@@ -95,6 +96,8 @@ public:
 	bool							removeConvexMesh(PxConvexMesh&);
 	PxU32							getNbConvexMeshes() const;
 	PxU32							getConvexMeshes(PxConvexMesh** userBuffer, PxU32 bufferSize, PxU32 startIndex)	const;
+	// Returns a tracked mesh identical to the fully built 'mesh', with a new reference, and releases 'mesh'. Returns 'mesh' if there is none.
+	PxConvexMesh*					shareConvexMesh(Gu::ConvexMesh* mesh);
 
 	// Heightfields
 	void							addHeightField(Gu::HeightField* np, bool lock=true);
@@ -123,6 +126,7 @@ protected:
 private:
 	Ps::CoalescedHashSet<Gu::TriangleMesh*>	mTriangleMeshes;
 	Ps::CoalescedHashSet<Gu::ConvexMesh*>	mConvexMeshes;
+	Ps::HashMap<PxU32, Gu::ConvexMesh*>		mSharedConvexMeshes;	// first mesh created for each hull hash, see shareConvexMesh
 	Ps::CoalescedHashSet<Gu::HeightField*>	mHeightFields;
 
 	Ps::Array<GuMeshFactoryListener*>		mFactoryListeners;
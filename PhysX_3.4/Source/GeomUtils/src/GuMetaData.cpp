@@ -191,6 +191,8 @@ static void getBinaryMetaData_HeightFieldData(PxOutputStream& stream)
 	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxReal,				colLimit,				0)
 	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxReal,				nbColumns,				0)
 	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxHeightFieldSample,	samples,				PxMetaDataFlag::ePTR)
+	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, void,					compressedSamples,		PxMetaDataFlag::ePTR)
+	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxU8,					activeEdges,			PxMetaDataFlag::ePTR)
 	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxReal,				thickness,				0)
 	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxReal,				convexEdgeThreshold,	0)
 	PX_DEF_BIN_METADATA_ITEM(stream,	HeightFieldData, PxHeightFieldFlags,	flags,					0)
@@ -224,6 +226,7 @@ void Gu::HeightField::getBinaryMetaData(PxOutputStream& stream)
 
 	// mData.samples
 	PX_DEF_BIN_METADATA_EXTRA_ARRAY(stream,	HeightField, PxHeightFieldSample, mNbSamples, PX_SERIAL_ALIGN, 0)	// PT: ### try to remove mNbSamples later
+	PX_DEF_BIN_METADATA_EXTRA_ARRAY(stream,	HeightField, PxU8, mNbSamples, PX_SERIAL_ALIGN, 0)	// mData.activeEdges
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -157,7 +157,7 @@ Gu::ConvexMesh* Gu::ConvexMesh::createObject(PxU8*& address, PxDeserializationCo
 	return obj;
 }
 
-static bool convexHullLoad(Gu::ConvexHullData& data, PxInputStream& stream, PxBitAndDword& bufferSize)
+static bool convexHullLoad(Gu::ConvexHullData& data, PxInputStream& stream, PxBitAndDword& bufferSize, bool quantized)
 {
 	PxU32 version;
 	bool Mismatch;
@@ -206,22 +206,49 @@ static bool convexHullLoad(Gu::ConvexHullData& data, PxInputStream& stream, PxBi
 	PX_ASSERT(!(size_t(data.mPolygons) % sizeof(PxReal)));
 	PX_ASSERT(size_t(address)<=size_t(mDataMemory)+bytesNeeded);
 
-	// Import vertices
-	readFloatBuffer(&mDataHullVertices->x, PxU32(3*data.mNbHullVertices), Mismatch, stream);
-
-	if(version<=6)
+	if(quantized)
 	{
-		PxU16 useUnquantizedNormals = readWord(Mismatch, stream);
-		PX_UNUSED(useUnquantizedNormals);
+		// Import vertices
+		PxVec3 base, scale;
+		readFloatBuffer(&base.x, 3, Mismatch, stream);
+		readFloatBuffer(&scale.x, 3, Mismatch, stream);
+		for(PxU32 i=0;i<data.mNbHullVertices;i++)
+		{
+			PxU16 q[3];
+			readWordBuffer(q, 3, Mismatch, stream);
+			mDataHullVertices[i] = Gu::dequantizeHullVertex(base, scale, q[0], q[1], q[2]);
+		}
+
+		// Import polygons, the planes are finished once all the vertices are known
+		for(PxU32 i=0;i<data.mNbPolygons;i++)
+		{
+			PxU16 q[3];
+			readWordBuffer(q, 3, Mismatch, stream);
+			Gu::HullPolygonData& polygon = data.mPolygons[i];
+			polygon.mVRef8 = q[2];
+			stream.read(&polygon.mNbVerts, sizeof(PxU8));
+			Gu::computeQuantizedHullPlane(polygon, Gu::dequantizeHullNormal(q[0], q[1]), mDataHullVertices, data.mNbHullVertices);
+		}
 	}
+	else
+	{
+		// Import vertices
+		readFloatBuffer(&mDataHullVertices->x, PxU32(3*data.mNbHullVertices), Mismatch, stream);
 
-	// Import polygons
-	stream.read(data.mPolygons, data.mNbPolygons*sizeof(Gu::HullPolygonData));
+		if(version<=6)
+		{
+			PxU16 useUnquantizedNormals = readWord(Mismatch, stream);
+			PX_UNUSED(useUnquantizedNormals);
+		}
 
-	if(Mismatch)
-	{
-		for(PxU32 i=0;i<data.mNbPolygons;i++)
-			flipData(data.mPolygons[i]);
+		// Import polygons
+		stream.read(data.mPolygons, data.mNbPolygons*sizeof(Gu::HullPolygonData));
+
+		if(Mismatch)
+		{
+			for(PxU32 i=0;i<data.mNbPolygons;i++)
+				flipData(data.mPolygons[i]);
+		}
 	}
 
 	stream.read(mDataVertexData8, Nb);
@@ -317,9 +344,8 @@ bool Gu::ConvexMesh::load(PxInputStream& stream)
 
 	// Import serialization flags
 	PxU32 serialFlags	= readDword(mismatch, stream);
-	PX_UNUSED(serialFlags);
 
-	if(!convexHullLoad(mHullData, stream, mNb))
+	if(!convexHullLoad(mHullData, stream, mNb, (serialFlags & ICSF_QUANTIZED_HULL)!=0))
 		return false;
 
 	// Import local bounds
@@ -86,6 +86,58 @@ namespace Gu
 	//12: removed explicit minimum, maximum from Poly
 	//13: internal objects
     #define  PX_CONVEX_VERSION 13
+
+	// these flags are used to indicate/validate the contents of a cooked convex mesh file
+	enum InternalConvexSerialFlag
+	{
+		ICSF_QUANTIZED_HULL	=	(1<<0)	//!< if set, the vertices are stored as 16bit coordinates on a grid over the hull bounds, and the polygon normals as 16bit octahedral coordinates
+	};
+
+	// Decodes a vertex stored with ICSF_QUANTIZED_HULL. Cooking snaps the vertices with the same expression, so the
+	// loaded hull is bit exact with the one the mass properties and gauss maps were computed from.
+	PX_FORCE_INLINE PxVec3 dequantizeHullVertex(const PxVec3& base, const PxVec3& scale, PxU16 x, PxU16 y, PxU16 z)
+	{
+		return PxVec3(base.x + scale.x * PxReal(x), base.y + scale.y * PxReal(y), base.z + scale.z * PxReal(z));
+	}
+
+	// Decodes a polygon normal stored with ICSF_QUANTIZED_HULL, as a point of the octahedron unfolded on [0, 65534]^2.
+	// the grid is centered on 32767 so that axis aligned normals (boxes...) stay exact.
+	PX_FORCE_INLINE PxVec3 dequantizeHullNormal(PxU16 u, PxU16 v)
+	{
+		const PxReal x = (PxReal(u) - 32767.0f) * (1.0f / 32767.0f);
+		const PxReal y = (PxReal(v) - 32767.0f) * (1.0f / 32767.0f);
+		const PxReal z = 1.0f - PxAbs(x) - PxAbs(y);
+		PxVec3 n(x, y, z);
+		if(z<0.0f)
+		{
+			n.x = (1.0f - PxAbs(y)) * (x>=0.0f ? 1.0f : -1.0f);
+			n.y = (1.0f - PxAbs(x)) * (y>=0.0f ? 1.0f : -1.0f);
+		}
+		return n.getNormalized();
+	}
+
+	// a quantized normal doesn't go through the polygon vertices anymore, so the planes of a quantized hull are pushed
+	// to the support vertex along their normal. The hull stays on the inner side of every plane, and getMin() / getMax()
+	// remain exact. Cooking and loading both finish the planes with this function.
+	PX_FORCE_INLINE void computeQuantizedHullPlane(HullPolygonData& polygon, const PxVec3& normal, const PxVec3* hullVertices, PxU32 nbHullVertices)
+	{
+		PxReal minDist = PX_MAX_REAL;
+		PxReal maxDist = -PX_MAX_REAL;
+		PxU32 minIndex = 0;
+		for(PxU32 i=0;i<nbHullVertices;i++)
+		{
+			const PxReal dist = normal.dot(hullVertices[i]);
+			if(dist<minDist)
+			{
+				minDist = dist;
+				minIndex = i;
+			}
+			maxDist = PxMax(maxDist, dist);
+		}
+		polygon.mPlane.n = normal;
+		polygon.mPlane.d = -maxDist;
+		polygon.mMinIndex = Ps::to8(minIndex);
+	}
   
 	class ConvexMesh : public PxConvexMesh, public Ps::UserAllocated, public Cm::RefCountable
 	{
@@ -154,6 +206,7 @@ namespace Gu
 		PX_PHYSX_COMMON_API virtual				~ConvexMesh();
 
 		PX_FORCE_INLINE	void					setMeshFactory(GuMeshFactory* f)							{ mMeshFactory = f;						}
+		PX_FORCE_INLINE	GuMeshFactory*			getMeshFactory()									const	{ return mMeshFactory;					}
 
 		PX_FORCE_INLINE void					setNb(PxU32 nb)												{ mNb = nb; }
 
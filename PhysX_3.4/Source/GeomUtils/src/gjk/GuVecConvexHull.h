@@ -337,19 +337,64 @@ namespace Gu
 			return index;
 		}
 
+		//dot products of 4 vertices with dir, transposed to SoA on the fly
+		PX_FORCE_INLINE Ps::aos::Vec4V dot4(const PxU32 i, const Ps::aos::Vec4VArg dirX, const Ps::aos::Vec4VArg dirY, const Ps::aos::Vec4VArg dirZ)const
+		{
+			using namespace Ps::aos;
+			Vec4V v0 = V4LoadU(&verts[i].x);	// safe because of the way vertex memory is allocated in ConvexHullData (and 'verts' is initialized with ConvexHullData::getHullVertices())
+			Vec4V v1 = V4LoadU(&verts[i+1].x);
+			Vec4V v2 = V4LoadU(&verts[i+2].x);
+			Vec4V v3 = V4LoadU(&verts[i+3].x);
+			V4Transpose(v0, v1, v2, v3);
+			return V4MulAdd(v2, dirZ, V4MulAdd(v1, dirY, V4Mul(v0, dirX)));
+		}
+
 		PX_SUPPORT_INLINE PxU32 bruteForceSearch(const Ps::aos::Vec3VArg _dir)const 
 		{
 			using namespace Ps::aos;
 			//brute force
 			//get the support point from the orignal margin
-			FloatV max = V3Dot(V3LoadU_SafeReadW(verts[0]), _dir);	// PT: safe because of the way vertex memory is allocated in ConvexHullData (and 'verts' is initialized with ConvexHullData::getHullVertices())
+			FloatV max = FNegMax();
 			PxU32 maxIndex=0;
+			PxU32 i = 0;
+
+			if(numVerts >= 4)
+			{
+				//4 vertices at a time, each lane keeps its first max so that the result matches the scalar loop
+				const Vec4V dirX = V4Splat(V3GetX(_dir));
+				const Vec4V dirY = V4Splat(V3GetY(_dir));
+				const Vec4V dirZ = V4Splat(V3GetZ(_dir));
+				const Vec4V four = V4Load(4.0f);
+				Vec4V indices = V4LoadXYZW(0.0f, 1.0f, 2.0f, 3.0f);
+				Vec4V maxIndices = indices;
+				Vec4V maxDist = dot4(0, dirX, dirY, dirZ);
+
+				for(i = 4; i + 4 <= numVerts; i += 4)
+				{
+					indices = V4Add(indices, four);
+					const Vec4V dist = dot4(i, dirX, dirY, dirZ);
+					const BoolV con = V4IsGrtr(dist, maxDist);
+					maxDist = V4Sel(con, dist, maxDist);
+					maxIndices = V4Sel(con, indices, maxIndices);
+				}
+
+				PX_ALIGN(16, PxF32 dists[4]);
+				PX_ALIGN(16, PxF32 lanes[4]);
+				V4StoreA(maxDist, dists);
+				V4StoreA(maxIndices, lanes);
 
-			// PT: TODO: not sure SIMD is useful here...
+				PxU32 best = 0;
+				for(PxU32 j = 1; j < 4; ++j)
+				{
+					if(dists[j] > dists[best] || (dists[j] == dists[best] && lanes[j] < lanes[best]))
+						best = j;
+				}
+				max = FLoad(dists[best]);
+				maxIndex = PxU32(lanes[best]);
+			}
 
-			for(PxU32 i = 1; i < numVerts; ++i)
+			for(; i < numVerts; ++i)
 			{
-//				Ps::prefetchLine(&verts[i], 128);			// PT: TODO: 128 doesn't help when your cache line is 64. HW prefetchers do a better job here.
 				const Vec3V vertex = V3LoadU_SafeReadW(verts[i]);	// PT: safe because of the way vertex memory is allocated in ConvexHullData (and 'verts' is initialized with ConvexHullData::getHullVertices())
 				const FloatV dist = V3Dot(vertex, _dir);
 				if(FAllGrtr(dist, max))
@@ -379,10 +424,28 @@ namespace Gu
 			//get the support point from the orignal margin
 			FloatV _max = V3Dot(V3LoadU_SafeReadW(verts[0]), dir);	// PT: safe because of the way vertex memory is allocated in ConvexHullData (and 'verts' is initialized with ConvexHullData::getHullVertices())
 			FloatV _min = _max;
+			PxU32 i = 1;
+
+			if(numVerts >= 4)
+			{
+				const Vec4V dirX = V4Splat(V3GetX(dir));
+				const Vec4V dirY = V4Splat(V3GetY(dir));
+				const Vec4V dirZ = V4Splat(V3GetZ(dir));
+				Vec4V maxDist = dot4(0, dirX, dirY, dirZ);
+				Vec4V minDist = maxDist;
+
+				for(i = 4; i + 4 <= numVerts; i += 4)
+				{
+					const Vec4V dist = dot4(i, dirX, dirY, dirZ);
+					maxDist = V4Max(dist, maxDist);
+					minDist = V4Min(dist, minDist);
+				}
+				_max = V4ExtractMax(maxDist);
+				_min = V4ExtractMin(minDist);
+			}
 
-			for(PxU32 i = 1; i < numVerts; ++i)
+			for(; i < numVerts; ++i)
 			{ 
-//				Ps::prefetchLine(&verts[i], 128);			// PT: TODO: 128 doesn't help when your cache line is 64. HW prefetchers do a better job here.
 				const FloatV dist = V3Dot(V3LoadU_SafeReadW(verts[i]), dir);
 				_max = FMax(dist, _max);
 				_min = FMin(dist, _min);
@@ -39,8 +39,51 @@
 #include "CmBitMap.h"
 #include "PsFoundation.h"
 
+#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+	#include <emmintrin.h>
+#endif
+
 using namespace physx;
 
+// range of the heights of nb (>0) contiguous samples
+static void computeHeightRange(const PxHeightFieldSample* PX_RESTRICT samples, PxU32 nb, PxI16& minHeight, PxI16& maxHeight)
+{
+	PxI16 minH = PX_MAX_I16;
+	PxI16 maxH = PX_MIN_I16;
+	PxU32 i = 0;
+#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+	if(nb >= 4)
+	{
+		// 4 samples per load, the shift moves the heights to the odd 16 bit lanes and zeroes the even ones, which are ignored
+		__m128i vMin = _mm_set1_epi16(PX_MAX_I16);
+		__m128i vMax = _mm_set1_epi16(PX_MIN_I16);
+		for(; i + 4 <= nb; i += 4)
+		{
+			const __m128i heights = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i)), 16);
+			vMin = _mm_min_epi16(vMin, heights);
+			vMax = _mm_max_epi16(vMax, heights);
+		}
+		PX_ALIGN(16, PxI16 mins[8]);
+		PX_ALIGN(16, PxI16 maxs[8]);
+		_mm_store_si128(reinterpret_cast<__m128i*>(mins), vMin);
+		_mm_store_si128(reinterpret_cast<__m128i*>(maxs), vMax);
+		for(PxU32 j = 1; j < 8; j += 2)
+		{
+			minH = mins[j] < minH ? mins[j] : minH;
+			maxH = maxs[j] > maxH ? maxs[j] : maxH;
+		}
+	}
+#endif
+	for(; i < nb; i++)
+	{
+		const PxI16 height = samples[i].height;
+		minH = height < minH ? height : minH;
+		maxH = height > maxH ? height : maxH;
+	}
+	minHeight = minH;
+	maxHeight = maxH;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Gu::HeightField::HeightField(GuMeshFactory* meshFactory)
@@ -58,6 +101,8 @@ Gu::HeightField::HeightField(GuMeshFactory* meshFactory)
 	mData.convexEdgeThreshold	= 0;
 	mData.flags					= PxHeightFieldFlags();
 	mData.samples				= NULL;
+	mData.compressedSamples		= NULL;
+	mData.activeEdges			= NULL;
 	mData.thickness				= 0;
 }
 
@@ -74,6 +119,8 @@ Gu::HeightField::HeightField(GuMeshFactory& factory, Gu::HeightFieldData& data)
 {
 	mData = data;
 	data.samples = NULL; // set to null so that we don't release the memory
+	data.compressedSamples = NULL;
+	data.activeEdges = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -105,14 +152,44 @@ void Gu::HeightField::onRefCountZero()
 void Gu::HeightField::exportExtraData(PxSerializationContext& stream)
 {
 	// PT: warning, order matters for the converter. Needs to export the base stuff first
-	const PxU32 size = mData.rows * mData.columns * sizeof(PxHeightFieldSample);
+	const PxU32 nbVerts = mData.rows * mData.columns;
+	const PxU32 size = nbVerts * sizeof(PxHeightFieldSample);
 	stream.alignData(PX_SERIAL_ALIGN);	// PT: generic align within the generic allocator
-	stream.writeData(mData.samples, size);
+	if(mData.compressedSamples)
+	{
+		// compressed samples are serialized uncompressed, the deserialized height field doesn't own its memory and stays uncompressed
+		PxHeightFieldSample* samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC_TEMP(size, "PxHeightFieldSample"));
+		if(samples)
+		{
+			mData.compressedSamples->decompress(samples);
+			stream.writeData(samples, size);
+			PX_FREE(samples);
+		}
+	}
+	else
+	{
+		stream.writeData(mData.samples, size);
+	}
+
+	stream.alignData(PX_SERIAL_ALIGN);
+	if(mData.activeEdges)
+	{
+		stream.writeData(mData.activeEdges, nbVerts * sizeof(PxU8));
+	}
+	else
+	{
+		// every edge is a candidate, the contact generation then does the full test
+		const PxU8 allEdges = 7;
+		for(PxU32 i=0;i<nbVerts;i++)
+			stream.writeData(&allEdges, sizeof(PxU8));
+	}
 }
 
 void Gu::HeightField::importExtraData(PxDeserializationContext& context)
 {
 	mData.samples = context.readExtraData<PxHeightFieldSample, PX_SERIAL_ALIGN>(mData.rows * mData.columns);
+	mData.compressedSamples = NULL;
+	mData.activeEdges = context.readExtraData<PxU8, PX_SERIAL_ALIGN>(mData.rows * mData.columns);
 }
 
 Gu::HeightField* Gu::HeightField::createObject(PxU8*& address, PxDeserializationContext& context)
@@ -145,58 +222,43 @@ PxU32 Gu::HeightField::getReferenceCount() const
 
 bool Gu::HeightField::modifySamples(PxI32 startCol, PxI32 startRow, const PxHeightFieldDesc& desc, bool shrinkBounds)
 {
-	const PxU32 nbCols = getNbColumns();
-	const PxU32 nbRows = getNbRows();
-	PX_CHECK_AND_RETURN_NULL(desc.format == mData.format, "Gu::HeightField::modifySamples: desc.format mismatch");
-	//PX_CHECK_AND_RETURN_NULL(startCol + desc.nbColumns <= nbCols,
-	//	"Gu::HeightField::modifySamples: startCol + nbColumns out of range");
-	//PX_CHECK_AND_RETURN_NULL(startRow + desc.nbRows <= nbRows,
-	//	"Gu::HeightField::modifySamples: startRow + nbRows out of range");
+	PxHeightFieldModification modification;
+	modification.startCol = startCol;
+	modification.startRow = startRow;
+	modification.subfieldDesc = &desc;
+	return modifySamples(&modification, 1, shrinkBounds);
+}
+
+bool Gu::HeightField::modifySamples(const PxHeightFieldModification* modifications, PxU32 nbModifications, bool shrinkBounds)
+{
+#if PX_CHECKED
+	for(PxU32 i=0;i<nbModifications;i++)
+	{
+		PX_CHECK_AND_RETURN_NULL(modifications[i].subfieldDesc->format == mData.format, "Gu::HeightField::modifySamples: desc.format mismatch");
+	}
+#endif
 	//PX_CHECK_AND_RETURN_NULL(desc.samples.stride == mSampleStride, "Gu::HeightField::modifySamples: desc.samples.stride mismatch");
 
+	// the tiles are rebuilt from scratch, that's simpler than re-encoding the modified tiles since their size can change
+	// done once for the whole batch
+	const bool compressed = mData.compressedSamples!=NULL;
+	if(compressed && !decompressSamples())
+		return false;
+
 	// by default bounds don't shrink since the whole point of this function is to avoid modifying the whole HF
 	// unless shrinkBounds is specified. then the bounds will be fully recomputed later
 	PxReal minHeight = mMinHeight;
 	PxReal maxHeight = mMaxHeight;
-	PxU32 hiRow = PxMin(PxU32(PxMax(0, startRow + PxI32(desc.nbRows))), nbRows);
-	PxU32 hiCol = PxMin(PxU32(PxMax(0, startCol + PxI32(desc.nbColumns))), nbCols);
-	for (PxU32 row = PxU32(PxMax(startRow, 0)); row < hiRow; row++)
-	{
-		for (PxU32 col = PxU32(PxMax(startCol, 0)); col < hiCol; col++)
-		{
-			const PxU32 vertexIndex = col + row*nbCols;
-			PxHeightFieldSample* targetSample = &mData.samples[vertexIndex];
-
-			// update target sample from source sample
-			const PxHeightFieldSample& sourceSample =
-				(reinterpret_cast<const PxHeightFieldSample*>(desc.samples.data))[col - startCol + (row - startRow) * desc.nbColumns];
-			*targetSample = sourceSample;
-
-			if(isCollisionVertexPreca(vertexIndex, row, col, PxHeightFieldMaterial::eHOLE))
-				targetSample->materialIndex1.setBit();
-			else
-				targetSample->materialIndex1.clearBit();
-
-			// grow (but not shrink) the height extents
-			const PxReal h = getHeight(vertexIndex);
-			minHeight = physx::intrinsics::selectMin(h, minHeight);
-			maxHeight = physx::intrinsics::selectMax(h, maxHeight);
-		}
-	}
+	for(PxU32 i=0;i<nbModifications;i++)
+		modifySubfield(modifications[i], minHeight, maxHeight);
 
 	if (shrinkBounds)
 	{
 		// do a full recompute on vertical bounds to allow shrinking
-		minHeight = PX_MAX_REAL;
-		maxHeight = -PX_MAX_REAL;
-		// have to recompute the min&max from scratch...
-		for (PxU32 vertexIndex = 0; vertexIndex < nbRows * nbCols; vertexIndex ++)
-		{
-				// update height extents
-				const PxReal h = getHeight(vertexIndex);
-				minHeight = physx::intrinsics::selectMin(h, minHeight);
-				maxHeight = physx::intrinsics::selectMax(h, maxHeight);
-		}
+		PxI16 minH, maxH;
+		computeHeightRange(mData.samples, mData.rows * mData.columns, minH, maxH);
+		minHeight = PxReal(minH);
+		maxHeight = PxReal(maxH);
 	}
 	mMinHeight = minHeight;
 	mMaxHeight = maxHeight;
@@ -208,9 +270,66 @@ bool Gu::HeightField::modifySamples(PxI32 startCol, PxI32 startRow, const PxHeig
 
 	mModifyCount++;
 
+	if(compressed)
+		compressSamples();
+
 	return true;
 }
 
+void Gu::HeightField::modifySubfield(const PxHeightFieldModification& modification, PxReal& minHeight, PxReal& maxHeight)
+{
+	const PxHeightFieldDesc& desc = *modification.subfieldDesc;
+	const PxI32 startCol = modification.startCol;
+	const PxI32 startRow = modification.startRow;
+	const PxU32 nbCols = getNbColumnsFast();
+	const PxU32 nbRows = getNbRowsFast();
+	//PX_CHECK_AND_RETURN_NULL(startCol + desc.nbColumns <= nbCols,
+	//	"Gu::HeightField::modifySamples: startCol + nbColumns out of range");
+	//PX_CHECK_AND_RETURN_NULL(startRow + desc.nbRows <= nbRows,
+	//	"Gu::HeightField::modifySamples: startRow + nbRows out of range");
+
+	const PxU32 loRow = PxU32(PxMax(startRow, 0));
+	const PxU32 loCol = PxU32(PxMax(startCol, 0));
+	const PxU32 hiRow = PxMin(PxU32(PxMax(0, startRow + PxI32(desc.nbRows))), nbRows);
+	const PxU32 hiCol = PxMin(PxU32(PxMax(0, startCol + PxI32(desc.nbColumns))), nbCols);
+	if(loRow >= hiRow || loCol >= hiCol)
+		return;
+
+	// copy the rows first, so that the hole bits below see the new neighbors and not half updated data
+	// the bounds only grow from the modified samples
+	const PxU32 rowLength = hiCol - loCol;
+	const PxHeightFieldSample* source = reinterpret_cast<const PxHeightFieldSample*>(desc.samples.data);
+	PxI16 minH = PX_MAX_I16;
+	PxI16 maxH = PX_MIN_I16;
+	for(PxU32 row = loRow; row < hiRow; row++)
+	{
+		PxHeightFieldSample* target = mData.samples + loCol + row*nbCols;
+		PxMemCopy(target, source + (loCol - startCol) + (row - startRow) * desc.nbColumns, rowLength*sizeof(PxHeightFieldSample));
+
+		PxI16 rowMin, rowMax;
+		computeHeightRange(target, rowLength, rowMin, rowMax);
+		minH = rowMin < minH ? rowMin : minH;
+		maxH = rowMax > maxH ? rowMax : maxH;
+	}
+	minHeight = physx::intrinsics::selectMin(PxReal(minH), minHeight);
+	maxHeight = physx::intrinsics::selectMax(PxReal(maxH), maxHeight);
+
+	for(PxU32 row = loRow; row < hiRow; row++)
+	{
+		for(PxU32 col = loCol; col < hiCol; col++)
+		{
+			const PxU32 vertexIndex = col + row*nbCols;
+			if(isCollisionVertexPreca(vertexIndex, row, col, PxHeightFieldMaterial::eHOLE))
+				mData.samples[vertexIndex].materialIndex1.setBit();
+			else
+				mData.samples[vertexIndex].materialIndex1.clearBit();
+		}
+	}
+
+	// the edges of the cells around the modified samples
+	computeActiveEdges(loRow ? loRow - 1 : 0, PxMin(hiRow, nbRows - 1), loCol ? loCol - 1 : 0, PxMin(hiCol, nbCols - 1));
+}
+
 bool Gu::HeightField::load(PxInputStream& stream)
 {
 	// release old memory
@@ -256,7 +375,7 @@ bool Gu::HeightField::load(PxInputStream& stream)
 	const PxU32 nbVerts = mData.rows * mData.columns;
 	if (nbVerts > 0) 
 	{
-		mData.samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC(nbVerts*sizeof(PxHeightFieldSample), "PxHeightFieldSample"));
+		mData.samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC_LARGE(nbVerts*sizeof(PxHeightFieldSample), "PxHeightFieldSample"));
 		if (mData.samples == NULL)
 		{
 			Ps::getFoundation().error(PxErrorCode::eOUT_OF_MEMORY, __FILE__, __LINE__, "Gu::HeightField::load: PX_ALLOC failed!");
@@ -270,6 +389,13 @@ bool Gu::HeightField::load(PxInputStream& stream)
 				PX_ASSERT(sizeof(PxU16) == sizeof(s.height));
 				flip(s.height);
 			}
+
+		// not stored, recomputed from the heights
+		mData.activeEdges = reinterpret_cast<PxU8*>(PX_ALLOC(nbVerts*sizeof(PxU8), "PxU8"));
+		computeActiveEdges(0, mData.rows - 1, 0, mData.columns - 1);
+
+		if(mData.flags & PxHeightFieldFlag::eCOMPRESS_SAMPLES)
+			compressSamples();
 	}
 
 	return true;
@@ -297,7 +423,7 @@ bool Gu::HeightField::loadFromDesc(const PxHeightFieldDesc& desc)
 	mData.colLimit				= float(mData.columns - 2);
 	mData.nbColumns				= float(desc.nbColumns);
 
-	// allocate and copy height samples
+	// allocate and copy height samples, or take over the user buffer
 	// compute extents too
 	mData.samples = NULL;
 	const PxU32 nbVerts = desc.nbRows * desc.nbColumns;
@@ -306,25 +432,37 @@ bool Gu::HeightField::loadFromDesc(const PxHeightFieldDesc& desc)
 
 	if (nbVerts > 0) 
 	{
-		mData.samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC(nbVerts*sizeof(PxHeightFieldSample), "PxHeightFieldSample"));
-		if (mData.samples == NULL)
+		if(desc.adoptSamples)
 		{
-			Ps::getFoundation().error(PxErrorCode::eOUT_OF_MEMORY, __FILE__, __LINE__, "Gu::HeightField::load: PX_ALLOC failed!");
-			return false;
+			// the hole bits are written in place, the buffer is freed with the height field
+			PX_ASSERT(desc.samples.stride == sizeof(PxHeightFieldSample));
+			mData.samples = const_cast<PxHeightFieldSample*>(reinterpret_cast<const PxHeightFieldSample*>(desc.samples.data));
 		}
-		const PxU8* PX_RESTRICT src = reinterpret_cast<const PxU8*>(desc.samples.data);
-		PxHeightFieldSample* PX_RESTRICT dst = mData.samples;
-		PxI16 minHeight = PX_MAX_I16;
-		PxI16 maxHeight = PX_MIN_I16;
-		for(PxU32 i=0;i<nbVerts;i++)
-		{			
-			const PxHeightFieldSample& sample = *reinterpret_cast<const PxHeightFieldSample*>(src);
-			*dst++ = sample;
-			const PxI16 height = sample.height;
-			minHeight = height < minHeight ? height : minHeight;
-			maxHeight = height > maxHeight ? height : maxHeight;
-			src += desc.samples.stride;	
+		else
+		{
+			mData.samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC_LARGE(nbVerts*sizeof(PxHeightFieldSample), "PxHeightFieldSample"));
+			if (mData.samples == NULL)
+			{
+				Ps::getFoundation().error(PxErrorCode::eOUT_OF_MEMORY, __FILE__, __LINE__, "Gu::HeightField::load: PX_ALLOC failed!");
+				return false;
+			}
+			if(desc.samples.stride == sizeof(PxHeightFieldSample))
+			{
+				PxMemCopy(mData.samples, desc.samples.data, nbVerts*sizeof(PxHeightFieldSample));
+			}
+			else
+			{
+				const PxU8* PX_RESTRICT src = reinterpret_cast<const PxU8*>(desc.samples.data);
+				PxHeightFieldSample* PX_RESTRICT dst = mData.samples;
+				for(PxU32 i=0;i<nbVerts;i++)
+				{			
+					*dst++ = *reinterpret_cast<const PxHeightFieldSample*>(src);
+					src += desc.samples.stride;	
+				}
+			}
 		}
+		PxI16 minHeight, maxHeight;
+		computeHeightRange(mData.samples, nbVerts, minHeight, maxHeight);
 		mMinHeight = PxReal(minHeight);
 		mMaxHeight = PxReal(maxHeight);
 	}
@@ -333,6 +471,16 @@ bool Gu::HeightField::loadFromDesc(const PxHeightFieldDesc& desc)
 
 	parseTrianglesForCollisionVertices(PxHeightFieldMaterial::eHOLE);
 
+	if(nbVerts > 0)
+	{
+		mData.activeEdges = reinterpret_cast<PxU8*>(PX_ALLOC(nbVerts*sizeof(PxU8), "PxU8"));
+		computeActiveEdges(0, mData.rows - 1, 0, mData.columns - 1);
+	}
+
+	// compress once the collision vertex bits are computed, they're kept in the material pairs
+	if(mData.samples && (mData.flags & PxHeightFieldFlag::eCOMPRESS_SAMPLES))
+		compressSamples();
+
 // PT: "mNbSamples" only used by binary converter
 	mNbSamples	= mData.rows * mData.columns;
 
@@ -356,6 +504,22 @@ PxU32 Gu::HeightField::saveCells(void* destBuffer, PxU32 destBufferSize) const
 {
 	PxU32 n = mData.columns * mData.rows * sizeof(PxHeightFieldSample);
 	if (n > destBufferSize) n = destBufferSize;
+	if(mData.compressedSamples)
+	{
+		const PxU32 nbSamples = n / sizeof(PxHeightFieldSample);
+		PxHeightFieldSample* dest = reinterpret_cast<PxHeightFieldSample*>(destBuffer);
+		for(PxU32 i=0;i<nbSamples;i++)
+			dest[i] = mData.compressedSamples->decode(i);
+
+		// partial last sample
+		const PxU32 remaining = n - nbSamples*sizeof(PxHeightFieldSample);
+		if(remaining)
+		{
+			const PxHeightFieldSample sample = mData.compressedSamples->decode(nbSamples);
+			PxMemCopy(dest + nbSamples, &sample, remaining);
+		}
+		return n;
+	}
 	PxMemCopy(destBuffer, mData.samples, n);
 
 	return n;
@@ -371,9 +535,51 @@ PX_PHYSX_COMMON_API void Gu::HeightField::releaseMemory()
 	{
 		PX_FREE(mData.samples);
 		mData.samples = NULL;
+
+		PX_FREE(mData.activeEdges);
+		mData.activeEdges = NULL;
+
+		if(mData.compressedSamples)
+		{
+			mData.compressedSamples->release();
+			mData.compressedSamples = NULL;
+		}
 	}
 }
 
+bool Gu::HeightField::compressSamples()
+{
+	PX_ASSERT(mData.samples && !mData.compressedSamples);
+
+	// keep the raw samples if the compression doesn't save anything, or if we run out of memory
+	Gu::HeightFieldCompressedSamples* compressed = Gu::HeightFieldCompressedSamples::create(mData.samples, mData.rows, mData.columns);
+	if(!compressed)
+		return false;
+
+	PX_FREE(mData.samples);
+	mData.samples = NULL;
+	mData.compressedSamples = compressed;
+	return true;
+}
+
+bool Gu::HeightField::decompressSamples()
+{
+	PX_ASSERT(!mData.samples && mData.compressedSamples);
+
+	PxHeightFieldSample* samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC_LARGE(mData.rows*mData.columns*sizeof(PxHeightFieldSample), "PxHeightFieldSample"));
+	if(!samples)
+	{
+		Ps::getFoundation().error(PxErrorCode::eOUT_OF_MEMORY, __FILE__, __LINE__, "Gu::HeightField::decompressSamples: PX_ALLOC failed!");
+		return false;
+	}
+
+	mData.compressedSamples->decompress(samples);
+	mData.compressedSamples->release();
+	mData.compressedSamples = NULL;
+	mData.samples = samples;
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // PT: TODO: use those faster functions everywhere
@@ -609,6 +815,87 @@ void Gu::HeightField::parseTrianglesForCollisionVertices(PxU16 holeMaterialIndex
 	}
 }
 
+// vertex in unscaled heightfield space, integer so the convexity test below is exact
+static PX_FORCE_INLINE void getIntegerVertex(const Gu::HeightField& hf, PxU32 vertexIndex, PxI64 v[3])
+{
+	const PxU32 nbColumns = hf.getNbColumnsFast();
+	v[0] = PxI64(vertexIndex / nbColumns);
+	v[1] = PxI64(hf.getSample(vertexIndex).height);
+	v[2] = PxI64(vertexIndex % nbColumns);
+}
+
+static PX_FORCE_INLINE PxU32 getOppositeVertex(const Gu::HeightField& hf, PxU32 triangleIndex, PxU32 edgeVertex0, PxU32 edgeVertex1)
+{
+	PxU32 v0, v1, v2;
+	hf.getTriangleVertexIndices(triangleIndex, v0, v1, v2);
+	if(v0 != edgeVertex0 && v0 != edgeVertex1)
+		return v0;
+	if(v1 != edgeVertex0 && v1 != edgeVertex1)
+		return v1;
+	return v2;
+}
+
+// Contact generation only keeps the convex edges between two triangles (and the boundary edges), the others are rejected by
+// fetching the adjacent triangle for every edge of every triangle. The convexity only depends on the heights, so it is computed
+// here once per edge. Ranges are in vertices, inclusive.
+void Gu::HeightField::computeActiveEdges(PxU32 minRow, PxU32 maxRow, PxU32 minColumn, PxU32 maxColumn)
+{
+	if(!mData.activeEdges)
+		return;
+
+	PX_ASSERT(maxRow < mData.rows && maxColumn < mData.columns);
+
+	// triangles are flipped for positive thickness, the collision side is then below the surface
+	const bool flipped = mData.thickness > 0.0f;
+
+	for(PxU32 row = minRow; row <= maxRow; row++)
+	{
+		for(PxU32 column = minColumn; column <= maxColumn; column++)
+		{
+			const PxU32 vertexIndex = row * mData.columns + column;
+			PxU8 edgeFlags = 0;
+			for(PxU32 k = 0; k < 3; k++)
+			{
+				const PxU32 edgeIndex = vertexIndex * 3 + k;
+				PxU32 triangleIndices[2];
+				const PxU32 count = getEdgeTriangleIndices(edgeIndex, triangleIndices);
+				if(count == 1)
+				{
+					edgeFlags |= PxU8(1 << k);
+				}
+				else if(count == 2)
+				{
+					PxU32 e0, e1;
+					getEdgeVertexIndices(edgeIndex, e0, e1);
+
+					PxI64 p[3], q[3], a[3], b[3];
+					getIntegerVertex(*this, e0, p);
+					getIntegerVertex(*this, e1, q);
+					getIntegerVertex(*this, getOppositeVertex(*this, triangleIndices[0], e0, e1), a);
+					getIntegerVertex(*this, getOppositeVertex(*this, triangleIndices[1], e0, e1), b);
+
+					const PxI64 ex = q[0] - p[0], ey = q[1] - p[1], ez = q[2] - p[2];
+					const PxI64 ax = a[0] - p[0], ay = a[1] - p[1], az = a[2] - p[2];
+					PxI64 nx = ey * az - ez * ay;
+					PxI64 ny = ez * ax - ex * az;
+					PxI64 nz = ex * ay - ey * ax;
+					// upward normal of the first triangle, the rows and columns span the XZ plane so ny is never 0
+					if(ny < 0)
+					{
+						nx = -nx; ny = -ny; nz = -nz;
+					}
+					const PxI64 d = nx * (b[0] - p[0]) + ny * (b[1] - p[1]) + nz * (b[2] - p[2]);
+
+					// convex if the other triangle goes away from the collision side, coplanar edges are never active
+					if(flipped ? d > 0 : d < 0)
+						edgeFlags |= PxU8(1 << k);
+				}
+			}
+			mData.activeEdges[vertexIndex] = edgeFlags;
+		}
+	}
+}
+
 bool Gu::HeightField::isSolidVertex(PxU32 vertexIndex, PxU32 row, PxU32 column, PxU16 holeMaterialIndex, bool& nbSolid) const
 {
 	// check if solid and boundary
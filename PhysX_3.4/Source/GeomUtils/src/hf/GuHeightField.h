@@ -79,6 +79,7 @@ public:
 		PX_PHYSX_COMMON_API virtual		void						release();
 		PX_PHYSX_COMMON_API virtual		PxU32						saveCells(void* destBuffer, PxU32 destBufferSize) const;
 		PX_PHYSX_COMMON_API virtual		bool						modifySamples(PxI32 startCol, PxI32 startRow, const PxHeightFieldDesc& subfieldDesc, bool shrinkBounds);
+		PX_PHYSX_COMMON_API virtual		bool						modifySamples(const PxHeightFieldModification* modifications, PxU32 nbModifications, bool shrinkBounds);
 		PX_PHYSX_COMMON_API virtual		PxU32						getNbRows()						const	{ return mData.rows;				}
 		PX_PHYSX_COMMON_API virtual		PxU32						getNbColumns()					const	{ return mData.columns;				}
 		PX_PHYSX_COMMON_API virtual		PxHeightFieldFormat::Enum	getFormat()						const	{ return mData.format;				}
@@ -106,7 +107,17 @@ public:
 		PX_PHYSX_COMMON_API virtual	const PxHeightFieldSample&	getSample(PxU32 row, PxU32 column) const
 												{
 													const PxU32 cell = row * getNbColumnsFast() + column;
-													return getSample(cell);
+													if(mData.compressedSamples)
+													{
+														const PxHeightFieldSample* samples = mData.compressedSamples->getDecompressedSamples();
+														PX_ASSERT(samples);
+														return samples[cell];
+													}
+													return mData.samples[cell];
+												}
+		PX_PHYSX_COMMON_API virtual	PxHeightFieldSample			getSampleValue(PxU32 row, PxU32 column) const
+												{
+													return mData.getSample(row * getNbColumnsFast() + column);
 												}
 
 		/**
@@ -180,6 +191,16 @@ public:
 	PX_INLINE		PxU32						getEdgeTriangleIndices(PxU32 edgeIndex, PxU32 triangleIndices[2]) const;
 	PX_INLINE		PxU32						getEdgeTriangleIndices(PxU32 edgeIndex, PxU32 triangleIndices[2], PxU32 cell, PxU32 row, PxU32 column) const;
 	PX_INLINE		void						getEdgeVertexIndices(PxU32 edgeIndex, PxU32& vertexIndex0, PxU32& vertexIndex1) const;
+	PX_INLINE		PxU32						getEdgeIndex(PxU32 vertexIndex0, PxU32 vertexIndex1) const;
+
+												// precomputed in computeActiveEdges: false if the two triangles of the edge are coplanar or form a concave edge,
+												// so contact generation doesn't need to fetch the adjacent triangle to reject it
+	PX_FORCE_INLINE	bool						isActiveEdgeCandidate(PxU32 edgeIndex) const
+												{
+													if(!mData.activeEdges)
+														return true;
+													return (mData.activeEdges[edgeIndex / 3] & (1 << (edgeIndex % 3))) != 0;
+												}
 //	PX_INLINE		bool						isConvexEdge(PxU32 edgeIndex) const;
 	PX_INLINE		bool						isConvexEdge(PxU32 edgeIndex, PxU32 cell, PxU32 row, PxU32 column) const;
 	PX_FORCE_INLINE	bool						isConvexEdge(PxU32 edgeIndex) const
@@ -270,14 +291,15 @@ public:
 													return getSample(vertexIndex).materialIndex1.isBitSet()!=0;
 												}
 					void						parseTrianglesForCollisionVertices(PxU16 holeMaterialIndex);					
+					void						computeActiveEdges(PxU32 minRow, PxU32 maxRow, PxU32 minColumn, PxU32 maxColumn);
 
 	PX_PHYSX_COMMON_API 		PxReal			computeExtreme(PxU32 minRow, PxU32 maxRow, PxU32 minColumn, PxU32 maxColumn)	const;
 
 	PX_FORCE_INLINE
-	PX_CUDA_CALLABLE const PxHeightFieldSample&	getSample(PxU32 vertexIndex) const
+	PX_CUDA_CALLABLE PxHeightFieldSample		getSample(PxU32 vertexIndex) const
 												{
 													PX_ASSERT(isValidVertex(vertexIndex));
-													return mData.samples[vertexIndex];
+													return mData.getSample(vertexIndex);
 												}
 
 #ifdef __CUDACC__
@@ -293,6 +315,13 @@ public:
 					// methods
 	PX_PHYSX_COMMON_API void					releaseMemory();
 
+												// switch between the raw and compressed samples, see PxHeightFieldFlag::eCOMPRESS_SAMPLES
+					bool						compressSamples();
+					bool						decompressSamples();
+
+												// copies the clipped subfield of a modification and grows the height range, raw samples only
+					void						modifySubfield(const PxHeightFieldModification& modification, PxReal& minHeight, PxReal& maxHeight);
+
 	PX_PHYSX_COMMON_API virtual					~HeightField();
 
 private:
@@ -531,6 +560,24 @@ PX_INLINE void Gu::HeightField::getEdgeVertexIndices(PxU32 edgeIndex, PxU32& ver
 	}
 }
 
+// inverse of getEdgeVertexIndices, the vertices must be the two ends of a valid edge
+PX_INLINE PxU32 Gu::HeightField::getEdgeIndex(PxU32 vertexIndex0, PxU32 vertexIndex1) const
+{
+	const PxU32 v0 = PxMin(vertexIndex0, vertexIndex1);
+	const PxU32 v1 = PxMax(vertexIndex0, vertexIndex1);
+	const PxU32 nbColumns = mData.columns;
+
+	// with 2 columns the next vertex can also be the other end of a diagonal, check it's on the same row
+	if(v1 == v0 + 1 && (v1 % nbColumns) != 0)
+		return v0 * 3;
+	if(v1 == v0 + nbColumns)
+		return v0 * 3 + 2;
+	if(v1 == v0 + nbColumns + 1)
+		return v0 * 3 + 1;
+	PX_ASSERT(v1 == v0 + nbColumns - 1);
+	return (v0 - 1) * 3 + 1;
+}
+
 PX_INLINE bool Gu::HeightField::isConvexEdge(PxU32 edgeIndex, PxU32 cell, PxU32 row, PxU32 column) const
 {
 //	const PxU32 cell = edgeIndex / 3;
@@ -0,0 +1,253 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "GuHeightFieldCompression.h"
+#include "PsAllocator.h"
+#include "PsUtilities.h"
+#include "PsAtomic.h"
+#include "PsFoundation.h"
+#include "foundation/PxMemory.h"
+
+using namespace physx;
+using namespace Gu;
+
+static PX_FORCE_INLINE PxU32 encodeMaterials(const PxHeightFieldSample& sample)
+{
+	const PxU32 material0 = PxU32(PxU8(sample.materialIndex0)) | (sample.materialIndex0.isBitSet() ? 0x80 : 0);
+	const PxU32 material1 = PxU32(PxU8(sample.materialIndex1)) | (sample.materialIndex1.isBitSet() ? 0x80 : 0);
+	return material0 | (material1<<8);
+}
+
+static PX_FORCE_INLINE PxU32 alignTileSize(PxU32 size)
+{
+	return (size + 3) & ~3;
+}
+
+namespace
+{
+	// Samples of a tile, padded to the full tile size
+	struct TileSamples
+	{
+		PxHeightFieldSample	samples[GU_HF_TILE_NB_SAMPLES];
+		PxU16				palette[GU_HF_TILE_PALETTE_SIZE];
+		PxU8				indices[GU_HF_TILE_NB_SAMPLES];
+		PxI16				minHeight;
+		PxI16				maxHeight;
+		PxU32				nbMaterials;	// GU_HF_TILE_PALETTE_SIZE+1 if the palette overflowed
+
+		void	gather(const PxHeightFieldSample* PX_RESTRICT src, PxU32 nbRows, PxU32 nbColumns, PxU32 tileRow, PxU32 tileColumn)
+		{
+			const PxU32 row0 = tileRow<<GU_HF_TILE_SHIFT;
+			const PxU32 column0 = tileColumn<<GU_HF_TILE_SHIFT;
+			const PxHeightFieldSample& first = src[row0*nbColumns + column0];
+
+			minHeight = PX_MAX_I16;
+			maxHeight = PX_MIN_I16;
+			nbMaterials = 0;
+			for(PxU32 i=0;i<GU_HF_TILE_NB_SAMPLES;i++)
+			{
+				const PxU32 row = row0 + (i>>GU_HF_TILE_SHIFT);
+				const PxU32 column = column0 + (i & GU_HF_TILE_MASK);
+				const PxHeightFieldSample& sample = (row<nbRows && column<nbColumns) ? src[row*nbColumns + column] : first;
+				samples[i] = sample;
+
+				minHeight = PxMin(minHeight, sample.height);
+				maxHeight = PxMax(maxHeight, sample.height);
+
+				if(nbMaterials>GU_HF_TILE_PALETTE_SIZE)
+					continue;
+
+				const PxU16 materials = PxU16(encodeMaterials(sample));
+				PxU32 index = 0;
+				while(index<nbMaterials && palette[index]!=materials)
+					index++;
+				if(index==nbMaterials)
+				{
+					if(nbMaterials==GU_HF_TILE_PALETTE_SIZE)
+					{
+						nbMaterials++;
+						continue;
+					}
+					palette[nbMaterials++] = materials;
+				}
+				indices[i] = PxU8(index);
+			}
+		}
+
+		HeightFieldTileFormat::Enum	getFormat()	const
+		{
+			if(nbMaterials>GU_HF_TILE_PALETTE_SIZE)
+				return HeightFieldTileFormat::eRAW;
+			return PxI32(maxHeight) - PxI32(minHeight) <= 0xff ? HeightFieldTileFormat::eDELTA8 : HeightFieldTileFormat::eHEIGHT16;
+		}
+	};
+}
+
+static PxU32 getTileDataSize(HeightFieldTileFormat::Enum format, PxU32 nbMaterials)
+{
+	if(format==HeightFieldTileFormat::eRAW)
+		return GU_HF_TILE_NB_SAMPLES*sizeof(PxHeightFieldSample);
+
+	const PxU32 heightSize = format==HeightFieldTileFormat::eDELTA8 ? sizeof(PxU8) : sizeof(PxI16);
+	return alignTileSize(GU_HF_TILE_NB_SAMPLES*heightSize + GU_HF_TILE_NB_SAMPLES/2 + nbMaterials*sizeof(PxU16));
+}
+
+static void writeTile(const TileSamples& tile, HeightFieldTileFormat::Enum format, PxU8* PX_RESTRICT dest)
+{
+	if(format==HeightFieldTileFormat::eRAW)
+	{
+		PxMemCopy(dest, tile.samples, sizeof(tile.samples));
+		return;
+	}
+
+	PxU8* PX_RESTRICT indices;
+	if(format==HeightFieldTileFormat::eDELTA8)
+	{
+		for(PxU32 i=0;i<GU_HF_TILE_NB_SAMPLES;i++)
+			dest[i] = PxU8(tile.samples[i].height - tile.minHeight);
+		indices = dest + GU_HF_TILE_NB_SAMPLES;
+	}
+	else
+	{
+		PxI16* PX_RESTRICT heights = reinterpret_cast<PxI16*>(dest);
+		for(PxU32 i=0;i<GU_HF_TILE_NB_SAMPLES;i++)
+			heights[i] = tile.samples[i].height;
+		indices = dest + GU_HF_TILE_NB_SAMPLES*sizeof(PxI16);
+	}
+
+	for(PxU32 i=0;i<GU_HF_TILE_NB_SAMPLES;i+=2)
+		indices[i>>1] = PxU8(tile.indices[i] | (tile.indices[i+1]<<4));
+
+	PxMemCopy(indices + GU_HF_TILE_NB_SAMPLES/2, tile.palette, tile.nbMaterials*sizeof(PxU16));
+}
+
+HeightFieldCompressedSamples* HeightFieldCompressedSamples::create(const PxHeightFieldSample* samples, PxU32 nbRows, PxU32 nbColumns)
+{
+	if(!nbRows || !nbColumns)
+		return NULL;
+
+	const PxU32 nbTileRows = (nbRows + GU_HF_TILE_MASK)>>GU_HF_TILE_SHIFT;
+	const PxU32 nbTileColumns = (nbColumns + GU_HF_TILE_MASK)>>GU_HF_TILE_SHIFT;
+	const PxU32 nbTiles = nbTileRows * nbTileColumns;
+
+	// First pass only computes the formats and the sizes, so that everything fits in a single allocation
+	HeightFieldTile* tiles = reinterpret_cast<HeightFieldTile*>(PX_ALLOC_TEMP(sizeof(HeightFieldTile)*nbTiles, "HeightFieldTile"));
+	if(!tiles)
+		return NULL;
+
+	TileSamples tile;
+
+	PxU32 dataSize = 0;
+	for(PxU32 i=0;i<nbTiles;i++)
+	{
+		tile.gather(samples, nbRows, nbColumns, i / nbTileColumns, i % nbTileColumns);
+		const HeightFieldTileFormat::Enum format = tile.getFormat();
+		tiles[i].minHeight = tile.minHeight;
+		tiles[i].format = PxU8(format);
+		tiles[i].nbMaterials = PxU8(format==HeightFieldTileFormat::eRAW ? 0 : tile.nbMaterials);
+		tiles[i].offset = dataSize;
+		dataSize += getTileDataSize(format, tiles[i].nbMaterials);
+	}
+
+	HeightFieldCompressedSamples* compressed = NULL;
+	const PxU32 totalSize = sizeof(HeightFieldTile)*nbTiles + dataSize;
+	if(totalSize < nbRows*nbColumns*sizeof(PxHeightFieldSample))
+	{
+		PxU8* memory = reinterpret_cast<PxU8*>(PX_ALLOC(totalSize, "HeightFieldCompressedSamples"));
+		if(memory)
+		{
+			PxMemCopy(memory, tiles, sizeof(HeightFieldTile)*nbTiles);
+			PxU8* data = memory + sizeof(HeightFieldTile)*nbTiles;
+
+			for(PxU32 i=0;i<nbTiles;i++)
+			{
+				tile.gather(samples, nbRows, nbColumns, i / nbTileColumns, i % nbTileColumns);
+				writeTile(tile, HeightFieldTileFormat::Enum(tiles[i].format), data + tiles[i].offset);
+			}
+
+			compressed = PX_NEW(HeightFieldCompressedSamples);
+			compressed->mTiles			= reinterpret_cast<HeightFieldTile*>(memory);
+			compressed->mData			= data;
+			compressed->mNbRows			= nbRows;
+			compressed->mNbColumns		= nbColumns;
+			compressed->mNbTileColumns	= nbTileColumns;
+			compressed->mNbTiles		= nbTiles;
+			compressed->mDataSize		= dataSize;
+			compressed->mDecompressed	= NULL;
+		}
+	}
+
+	PX_FREE(tiles);
+	return compressed;
+}
+
+void HeightFieldCompressedSamples::release()
+{
+	if(mDecompressed)
+		PX_FREE(const_cast<void*>(mDecompressed));
+	PX_FREE(mTiles);
+	PX_DELETE(this);
+}
+
+void HeightFieldCompressedSamples::decompress(PxHeightFieldSample* dest) const
+{
+	for(PxU32 row=0;row<mNbRows;row++)
+		for(PxU32 column=0;column<mNbColumns;column++)
+			*dest++ = decode(row, column);
+}
+
+const PxHeightFieldSample* HeightFieldCompressedSamples::getDecompressedSamples() const
+{
+	if(mDecompressed)
+		return reinterpret_cast<const PxHeightFieldSample*>(const_cast<const void*>(mDecompressed));
+
+	PxHeightFieldSample* samples = reinterpret_cast<PxHeightFieldSample*>(PX_ALLOC(mNbRows*mNbColumns*sizeof(PxHeightFieldSample), "PxHeightFieldSample"));
+	if(!samples)
+	{
+		Ps::getFoundation().error(PxErrorCode::eOUT_OF_MEMORY, __FILE__, __LINE__, "Gu::HeightFieldCompressedSamples::getDecompressedSamples: PX_ALLOC failed!");
+		return NULL;
+	}
+	decompress(samples);
+
+	// several threads can get here at the same time, the first copy wins and the others are dropped
+	void* previous = Ps::atomicCompareExchangePointer(&mDecompressed, samples, NULL);
+	if(previous)
+	{
+		PX_FREE(samples);
+		return reinterpret_cast<const PxHeightFieldSample*>(previous);
+	}
+	return samples;
+}
+
+PxU32 HeightFieldCompressedSamples::getMemorySize() const
+{
+	const PxU32 decompressedSize = mDecompressed ? mNbRows*mNbColumns*PxU32(sizeof(PxHeightFieldSample)) : 0;
+	return sizeof(HeightFieldCompressedSamples) + sizeof(HeightFieldTile)*mNbTiles + mDataSize + decompressedSize;
+}
@@ -0,0 +1,142 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef GU_HEIGHTFIELD_COMPRESSION_H
+#define GU_HEIGHTFIELD_COMPRESSION_H
+
+#include "foundation/PxSimpleTypes.h"
+#include "PxHeightFieldSample.h"
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+
+// Samples are compressed in square tiles of GU_HF_TILE_SIZE x GU_HF_TILE_SIZE
+#define GU_HF_TILE_SHIFT			4
+#define GU_HF_TILE_SIZE				(1<<GU_HF_TILE_SHIFT)
+#define GU_HF_TILE_MASK				(GU_HF_TILE_SIZE-1)
+#define GU_HF_TILE_NB_SAMPLES		(GU_HF_TILE_SIZE*GU_HF_TILE_SIZE)
+// Max number of material pairs in a compressed tile, i.e. the range of the 4-bit material indices
+#define GU_HF_TILE_PALETTE_SIZE		16
+
+namespace physx
+{
+namespace Gu
+{
+	struct HeightFieldTileFormat
+	{
+		enum Enum
+		{
+			eDELTA8,	// 8-bit deltas to the tile's min height, 4-bit material indices
+			eHEIGHT16,	// 16-bit heights, 4-bit material indices
+			eRAW		// PxHeightFieldSample array, for tiles with too many material pairs
+		};
+	};
+
+	// Tile data layout, for the compressed formats:
+	// - GU_HF_TILE_NB_SAMPLES heights (PxU8 deltas or PxI16 heights)
+	// - GU_HF_TILE_NB_SAMPLES/2 bytes of 4-bit material indices
+	// - nbMaterials PxU16 material pairs (materialIndex0 in the low byte, materialIndex1 in the high byte, including the flag bits)
+	struct HeightFieldTile
+	{
+		PxI16	minHeight;
+		PxU8	format;			// HeightFieldTileFormat
+		PxU8	nbMaterials;
+		PxU32	offset;			// Offset of the tile data, in bytes. Multiple of 4.
+	};
+
+	// Compressed version of the HeightFieldData samples, see PxHeightFieldFlag::eCOMPRESS_SAMPLES.
+	// Samples of the tiles on the last rows and columns that fall outside of the height field are padded with the tile's first sample.
+	class HeightFieldCompressedSamples : public Ps::UserAllocated
+	{
+	public:
+		// Returns NULL if the compressed samples wouldn't take less memory than the uncompressed ones
+		static	HeightFieldCompressedSamples*	create(const PxHeightFieldSample* samples, PxU32 nbRows, PxU32 nbColumns);
+				void							release();
+
+				void							decompress(PxHeightFieldSample* dest)	const;
+				PxU32							getMemorySize()							const;
+
+		PX_CUDA_CALLABLE PX_FORCE_INLINE	PxHeightFieldSample	decode(PxU32 vertexIndex)	const
+		{
+			const PxU32 row = vertexIndex / mNbColumns;
+			const PxU32 column = vertexIndex - row * mNbColumns;
+			return decode(row, column);
+		}
+
+		PX_CUDA_CALLABLE PX_FORCE_INLINE	PxHeightFieldSample	decode(PxU32 row, PxU32 column)	const
+		{
+			const HeightFieldTile& tile = mTiles[(row>>GU_HF_TILE_SHIFT) * mNbTileColumns + (column>>GU_HF_TILE_SHIFT)];
+			const PxU32 local = ((row & GU_HF_TILE_MASK)<<GU_HF_TILE_SHIFT) | (column & GU_HF_TILE_MASK);
+			const PxU8* PX_RESTRICT tileData = mData + tile.offset;
+
+			if(tile.format==HeightFieldTileFormat::eRAW)
+				return reinterpret_cast<const PxHeightFieldSample*>(tileData)[local];
+
+			PxHeightFieldSample sample;
+			const PxU8* PX_RESTRICT indices;
+			if(tile.format==HeightFieldTileFormat::eDELTA8)
+			{
+				sample.height = PxI16(tile.minHeight + tileData[local]);
+				indices = tileData + GU_HF_TILE_NB_SAMPLES;
+			}
+			else
+			{
+				sample.height = reinterpret_cast<const PxI16*>(tileData)[local];
+				indices = tileData + GU_HF_TILE_NB_SAMPLES*sizeof(PxI16);
+			}
+
+			const PxU32 materialIndex = (indices[local>>1] >> ((local&1)<<2)) & 15;
+			const PxU32 materials = reinterpret_cast<const PxU16*>(indices + GU_HF_TILE_NB_SAMPLES/2)[materialIndex];
+			sample.materialIndex0 = PxBitAndByte(PxU8(materials & 0x7f), (materials & 0x80)!=0);
+			sample.materialIndex1 = PxBitAndByte(PxU8((materials>>8) & 0x7f), (materials & 0x8000)!=0);
+			return sample;
+		}
+
+		// Uncompressed copy of the samples, for the PxHeightField::getSample() reference. Built on first use and kept until
+		// release(), so the returned storage stays valid. Thread safe. Returns NULL if the allocation failed.
+				const PxHeightFieldSample*	getDecompressedSamples()				const;
+
+	private:
+											HeightFieldCompressedSamples()		{}
+											~HeightFieldCompressedSamples()		{}
+
+				HeightFieldTile*			mTiles;		// Single allocation, the tile data follows the tiles
+				const PxU8*					mData;
+				PxU32						mNbRows;
+				PxU32						mNbColumns;
+				PxU32						mNbTileColumns;
+				PxU32						mNbTiles;
+				PxU32						mDataSize;
+		mutable	volatile void*				mDecompressed;	// PxHeightFieldSample array, see getDecompressedSamples()
+	};
+
+} // namespace Gu
+}
+
+#endif
@@ -34,6 +34,7 @@
 #include "PxHeightFieldFlag.h"
 #include "PxHeightFieldSample.h"
 #include "GuCenterExtents.h"
+#include "GuHeightFieldCompression.h"
 
 namespace physx
 {
@@ -61,6 +62,8 @@ struct PX_PHYSX_COMMON_API HeightFieldData
 					PxReal						colLimit;				// PT: to avoid runtime int-to-float conversions on Xbox
 					PxReal						nbColumns;				// PT: to avoid runtime int-to-float conversions on Xbox
 					PxHeightFieldSample*		samples;				// PT: WARNING: don't change this member's name (used in ConvX)
+					HeightFieldCompressedSamples*	compressedSamples;	// Replaces 'samples' (then NULL) with PxHeightFieldFlag::eCOMPRESS_SAMPLES
+					PxU8*						activeEdges;			// One byte per vertex, bit k set if edge 3*vertex+k can be an active (convex or boundary) edge
 					PxReal						thickness;
 					PxReal						convexEdgeThreshold;
 
@@ -73,6 +76,11 @@ struct PX_PHYSX_COMMON_API HeightFieldData
 													// PT: see compile-time assert below
 													return static_cast<const CenterExtentsPadded&>(mAABB);
 												}
+
+	PX_CUDA_CALLABLE PX_FORCE_INLINE	PxHeightFieldSample	getSample(PxU32 vertexIndex)	const
+												{
+													return compressedSamples ? compressedSamples->decode(vertexIndex) : samples[vertexIndex];
+												}
 };
 #if PX_VC 
      #pragma warning(pop) 
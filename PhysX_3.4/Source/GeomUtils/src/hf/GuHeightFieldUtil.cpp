@@ -35,6 +35,7 @@
 #include "GuHeightField.h"
 #include "GuEntityReport.h"
 #include "PxMeshScale.h"
+#include "PsVecMath.h"
 
 using namespace physx;
 
@@ -657,6 +658,54 @@ void Gu::HeightFieldUtil::getEdge(PxU32 edgeIndex, PxU32 cell, PxU32 row, PxU32
 	}
 }
 
+// Adds the solid triangles of a cell to the index buffer, flushing it to the callback when full.
+// Returns true when the query must stop, i.e. for eFIRST_CONTACT queries once a triangle has been found.
+static PX_FORCE_INLINE bool reportCellTriangles(const Gu::HeightField& hf, PxU32 offset, PxU32 flags, PxU32* indexBuffer, PxU32& indexBufferUsed, PxU32& nb, Gu::EntityReport<PxU32>* callback)
+{
+	const PxU32 material0 = hf.getMaterialIndex0(offset);
+	if(material0 != PxHeightFieldMaterial::eHOLE) 
+	{
+		if(indexBufferUsed >= HF_SWEEP_REPORT_BUFFER_SIZE)
+		{
+			callback->onEvent(indexBufferUsed, indexBuffer);
+			indexBufferUsed = 0;
+		}
+
+		indexBuffer[indexBufferUsed++] = offset << 1;
+		nb++;
+
+		if(flags & GuHfQueryFlags::eFIRST_CONTACT)
+			return true;
+	}
+
+	const PxU32 material1 = hf.getMaterialIndex1(offset);
+	if(material1 != PxHeightFieldMaterial::eHOLE)
+	{
+		if(indexBufferUsed >= HF_SWEEP_REPORT_BUFFER_SIZE)
+		{
+			callback->onEvent(indexBufferUsed, indexBuffer);
+			indexBufferUsed = 0;
+		}
+
+		indexBuffer[indexBufferUsed++] = (offset << 1) + 1;
+		nb++;
+
+		if(flags & GuHfQueryFlags::eFIRST_CONTACT)
+			return true;
+	}
+	return false;
+}
+
+#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+// Heights of 4 consecutive samples. The height is the low 16 bits of each 4 bytes sample, sign extended.
+static PX_FORCE_INLINE Ps::aos::Vec4V loadSampleHeights4(const PxHeightFieldSample* samples)
+{
+	PX_COMPILE_TIME_ASSERT(sizeof(PxHeightFieldSample)==4);
+	const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples));
+	return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(data, 16), 16));
+}
+#endif
+
 bool Gu::HeightFieldUtil::overlapAABBTriangles(const PxTransform& pose, const PxBounds3& bounds, PxU32 flags, EntityReport<PxU32>* callback) const
 {
 	PX_ASSERT(!bounds.isEmpty());
@@ -703,61 +752,69 @@ bool Gu::HeightFieldUtil::overlapAABBTriangles(const PxTransform& pose, const Px
 	if(flags & GuHfQueryFlags::eFIRST_CONTACT)
 		maxNbTriangles = 1;
 
-	const PxU32 bufferSize = HF_SWEEP_REPORT_BUFFER_SIZE;
-	PxU32 indexBuffer[bufferSize];
+	PxU32 indexBuffer[HF_SWEEP_REPORT_BUFFER_SIZE];
 	PxU32 indexBufferUsed = 0;
 	PxU32 nb = 0;
 
-	PxU32 offset = minRow * mHeightField->getNbColumnsFast() + minColumn;
+	PxU32 offset = minRow * nbColumns + minColumn;
 
 	const PxReal miny = localBounds.minimum.y;
 	const PxReal maxy = localBounds.maximum.y;
 
+#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+	using namespace Ps::aos;
+	const Vec4V minyV = V4Load(miny);
+	const Vec4V maxyV = V4Load(maxy);
+	// Compressed samples take the scalar loop
+	const PxHeightFieldSample* rawSamples = mHeightField->getData().samples;
+#endif
+
 	for(PxU32 row=minRow; row<maxRow; row++)
 	{
-		for(PxU32 column=minColumn; column<maxColumn; column++)
+		PxU32 column = minColumn;
+
+#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+		// Height test of 4 cells at a time. The vertices of the last cell are at most on column maxColumn, so the loads stay within the rows.
+		for(; rawSamples && column+4<=maxColumn; column+=4)
+		{
+			const PxHeightFieldSample* samples = rawSamples + offset;
+			const Vec4V h0 = loadSampleHeights4(samples);
+			const Vec4V h1 = loadSampleHeights4(samples + 1);
+			const Vec4V h2 = loadSampleHeights4(samples + nbColumns);
+			const Vec4V h3 = loadSampleHeights4(samples + nbColumns + 1);
+			const Vec4V minH = V4Min(V4Min(h0, h1), V4Min(h2, h3));
+			const Vec4V maxH = V4Max(V4Max(h0, h1), V4Max(h2, h3));
+
+			// Same test as the scalar loop below, a cell is skipped if the bounds are fully above or below its heights
+			const PxU32 rejected = BGetBitMask(BOr(V4IsGrtr(minH, maxyV), V4IsGrtr(minyV, maxH)));
+			if(rejected==15)
+			{
+				offset += 4;
+				continue;
+			}
+
+			for(PxU32 i=0; i<4; i++, offset++)
+			{
+				if(!(rejected & (1<<i)) && reportCellTriangles(*mHeightField, offset, flags, indexBuffer, indexBufferUsed, nb, callback))
+					goto search_done;
+			}
+		}
+#endif
+
+		for(; column<maxColumn; column++)
 		{
 			const PxReal h0 = mHeightField->getHeight(offset);
 			const PxReal h1 = mHeightField->getHeight(offset + 1);
-			const PxReal h2 = mHeightField->getHeight(offset + mHeightField->getNbColumnsFast());
-			const PxReal h3 = mHeightField->getHeight(offset + mHeightField->getNbColumnsFast() + 1);
+			const PxReal h2 = mHeightField->getHeight(offset + nbColumns);
+			const PxReal h3 = mHeightField->getHeight(offset + nbColumns + 1);
 			if(!((maxy < h0 && maxy < h1 && maxy < h2 && maxy < h3) || (miny > h0 && miny > h1 && miny > h2 && miny > h3)))
 			{
-				const PxU32 material0 = mHeightField->getMaterialIndex0(offset);
-				if(material0 != PxHeightFieldMaterial::eHOLE) 
-				{
-					if(indexBufferUsed >= bufferSize)
-					{
-						callback->onEvent(indexBufferUsed, indexBuffer);
-						indexBufferUsed = 0;
-					}
-
-					indexBuffer[indexBufferUsed++] = offset << 1;
-					nb++;
-
-					if(flags & GuHfQueryFlags::eFIRST_CONTACT)
-						goto search_done;
-				}
-
-				const PxU32 material1 = mHeightField->getMaterialIndex1(offset);
-				if(material1 != PxHeightFieldMaterial::eHOLE)
-				{
-					if(indexBufferUsed >= bufferSize)
-					{
-						callback->onEvent(indexBufferUsed, indexBuffer);
-						indexBufferUsed = 0;
-					}
-
-					indexBuffer[indexBufferUsed++] = (offset << 1) + 1;
-					nb++;
-
-					if(flags & GuHfQueryFlags::eFIRST_CONTACT)
-						goto search_done;
-				}
+				if(reportCellTriangles(*mHeightField, offset, flags, indexBuffer, indexBufferUsed, nb, callback))
+					goto search_done;
 			}
 			offset++;
 		}
-		offset += (mHeightField->getNbColumnsFast() - (maxColumn - minColumn));
+		offset += (nbColumns - (maxColumn - minColumn));
 	}
 
 search_done:
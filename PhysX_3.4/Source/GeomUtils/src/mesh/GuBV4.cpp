@@ -244,7 +244,7 @@ bool BV4Tree::load(PxInputStream& stream, bool mismatch_)
 	if(nbNodes)
 	{
 #ifdef GU_BV4_USE_SLABS
-		BVDataPacked* nodes = reinterpret_cast<BVDataPacked*>(PX_ALLOC(sizeof(BVDataPacked)*nbNodes, "BV4 nodes"));	// PT: PX_NEW breaks alignment here
+		BVDataPacked* nodes = reinterpret_cast<BVDataPacked*>(PX_ALLOC_LARGE(sizeof(BVDataPacked)*nbNodes, "BV4 nodes"));	// PX_NEW breaks alignment here
 #else
 		BVDataPacked* nodes = PX_NEW(BVDataPacked)[nbNodes];
 #endif
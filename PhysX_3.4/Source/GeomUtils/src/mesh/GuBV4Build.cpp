@@ -35,6 +35,9 @@
 #include "CmPhysXCommon.h"
 #include "PsBasicTemplates.h"
 #include "GuCenterExtents.h"
+#include "PsSort.h"
+#include "PsArray.h"
+#include "CmParallelFor.h"
 
 using namespace physx;
 using namespace Gu;
@@ -242,41 +245,180 @@ static void local_BuildHierarchy(AABBTreeNode* PX_RESTRICT node, const PxBounds3
 	}
 }
 
-bool AABBTree::buildFromMesh(SourceMesh& mesh, PxU32 limit)
+namespace
+{
+	// Meshes smaller than this are built on the calling thread
+	const PxU32 gParallelBuildMinTriangles = 16384;
+	// The top of the tree is split until there are about this many subtrees per thread, for load balancing
+	const PxU32 gParallelBuildSubtreesPerThread = 8;
+	const PxU32 gParallelBuildMinSubtreeTriangles = 1024;
+	// Number of triangles per chunk when computing the boxes
+	const PxU32 gParallelBoxesChunkSize = 16384;
+
+	struct ComputeBoxesContext
+	{
+		SourceMesh*	mMesh;
+		PxBounds3*	mBoxes;
+		PxVec3*		mCenters;
+	};
+
+	// The 4 floats stores of an element spill over the next one, so the last element of a range is stored separately:
+	// another thread can be computing the next range.
+	void computeBoxes(SourceMesh& mesh, PxBounds3* PX_RESTRICT boxes, PxVec3* PX_RESTRICT centers, PxU32 start, PxU32 end)
+	{
+		const FloatV halfV = FLoad(0.5f);
+		for(PxU32 i=start;i<end;i++)
+		{
+			VertexPointers VP;
+			mesh.getTriangle(VP, i);
+
+			const Vec4V v0V = V4LoadU(&VP.Vertex[0]->x);	
+			const Vec4V v1V = V4LoadU(&VP.Vertex[1]->x);
+			const Vec4V v2V = V4LoadU(&VP.Vertex[2]->x);
+			Vec4V minV = V4Min(v0V, v1V);
+			minV = V4Min(minV, v2V);
+			Vec4V maxV = V4Max(v0V, v1V);
+			maxV = V4Max(maxV, v2V);
+			const Vec4V centerV = V4Scale(V4Add(maxV, minV), halfV);
+
+			if(i!=end-1)
+			{
+				V4StoreU_Safe(minV, &boxes[i].minimum.x);	// PT: safe because 'maximum' follows 'minimum'
+				V4StoreU_Safe(maxV, &boxes[i].maximum.x);	// safe because it is overwritten by the next element
+				V4StoreU_Safe(centerV, &centers[i].x);		// safe because it is overwritten by the next element
+			}
+			else
+			{
+				PX_ALIGN_PREFIX(16) PxVec4 tmp PX_ALIGN_SUFFIX(16);
+				V4StoreA_Safe(minV, &tmp.x);	boxes[i].minimum = tmp.getXYZ();
+				V4StoreA_Safe(maxV, &tmp.x);	boxes[i].maximum = tmp.getXYZ();
+				V4StoreA_Safe(centerV, &tmp.x);	centers[i] = tmp.getXYZ();
+			}
+		}
+	}
+
+	void computeBoxesChunk(void* context, PxU32 start, PxU32 nb)
+	{
+		ComputeBoxesContext& ctx = *reinterpret_cast<ComputeBoxesContext*>(context);
+		computeBoxes(*ctx.mMesh, ctx.mBoxes, ctx.mCenters, start, start + nb);
+	}
+
+	struct BuildSubtreesContext
+	{
+		const PxBounds3*	mBoxes;
+		const PxVec3*		mCenters;
+		AABBTreeNode*		mPool;
+		AABBTreeNode**		mRoots;
+		BuildStats*			mStats;		// One per subtree
+		PxU32				mLimit;
+	};
+
+	void buildSubtrees(void* context, PxU32 start, PxU32 nb)
+	{
+		const BuildSubtreesContext& ctx = *reinterpret_cast<const BuildSubtreesContext*>(context);
+		for(PxU32 subtree=start;subtree<start+nb;subtree++)
+			local_BuildHierarchy(ctx.mRoots[subtree], ctx.mBoxes, ctx.mCenters, ctx.mStats[subtree], ctx.mPool, ctx.mLimit);
+	}
+
+	// Largest subtrees first, so that the last ones to finish are small
+	struct SubtreeSizeCompare
+	{
+		PX_FORCE_INLINE bool operator()(const AABBTreeNode* a, const AABBTreeNode* b) const
+		{
+			return a->mNbPrimitives > b->mNbPrimitives;
+		}
+	};
+}
+
+// The calling thread splits the top of the tree, then the subtrees are built in parallel. A subtree of n triangles has at most
+// 2n-1 nodes, so each one is given its own range of the pool in a fixed order: the tree is the same as the one built serially,
+// only the node layout differs and the pool can have unused nodes between the ranges.
+static PxU32 buildHierarchyParallel(AABBTreeNode* pool, const PxBounds3* boxes, const PxVec3* centers, PxU32 nbBoxes, PxU32 limit, PxCpuDispatcher& dispatcher)
+{
+	const PxU32 nbWorkers = dispatcher.getWorkerCount();
+	const PxU32 maxSubtreePrims = PxMax(PxMax(nbBoxes / ((nbWorkers + 1)*gParallelBuildSubtreesPerThread), gParallelBuildMinSubtreeTriangles), limit);
+
+	BuildStats stats;
+	stats.setCount(1);
+
+	Ps::Array<AABBTreeNode*> roots;
+	Ps::Array<AABBTreeNode*> stack;
+	stack.pushBack(pool);
+	while(stack.size())
+	{
+		AABBTreeNode* node = stack.popBack();
+		if(node->mNbPrimitives <= maxSubtreePrims)
+		{
+			roots.pushBack(node);
+			continue;
+		}
+
+		if(local_Subdivide(node, boxes, centers, stats, pool, limit))
+		{
+			AABBTreeNode* pos = const_cast<AABBTreeNode*>(node->getPos());
+			stack.pushBack(pos + 1);
+			stack.pushBack(pos);
+		}
+	}
+
+	const PxU32 nbSubtrees = roots.size();
+	Ps::sort(roots.begin(), nbSubtrees, SubtreeSizeCompare());
+
+	// The top nodes come first, then the range of each subtree
+	PxU32 nbNodes = stats.getCount();
+	BuildStats* subtreeStats = PX_NEW(BuildStats)[nbSubtrees];
+	PxU32 offset = nbNodes;
+	for(PxU32 i=0;i<nbSubtrees;i++)
+	{
+		subtreeStats[i].setCount(offset);
+		offset += roots[i]->mNbPrimitives*2 - 2;
+	}
+	PX_ASSERT(offset <= nbBoxes*2 - 1);
+
+	BuildSubtreesContext ctx;
+	ctx.mBoxes		= boxes;
+	ctx.mCenters	= centers;
+	ctx.mPool		= pool;
+	ctx.mRoots		= roots.begin();
+	ctx.mStats		= subtreeStats;
+	ctx.mLimit		= limit;
+	Cm::blockingParallelFor(&dispatcher, nbSubtrees, 1, 1, buildSubtrees, &ctx, "Gu::BV4.parallelBuild");
+
+	offset = stats.getCount();
+	for(PxU32 i=0;i<nbSubtrees;i++)
+	{
+		nbNodes += subtreeStats[i].getCount() - offset;
+		offset += roots[i]->mNbPrimitives*2 - 2;
+	}
+	PX_DELETE_ARRAY(subtreeStats);
+	return nbNodes;
+}
+
+bool AABBTree::buildFromMesh(SourceMesh& mesh, PxU32 limit, PxCpuDispatcher* dispatcher)
 {
 	const PxU32 nbBoxes = mesh.getNbTriangles();
 	if(!nbBoxes)
 		return false;
+
+	const bool parallel = dispatcher && dispatcher->getWorkerCount() && nbBoxes >= gParallelBuildMinTriangles;
+
 	PxBounds3* boxes = reinterpret_cast<PxBounds3*>(PX_ALLOC(sizeof(PxBounds3)*(nbBoxes+1), "BV4"));	// PT: +1 to safely V4Load/V4Store the last element
 	PxVec3* centers = reinterpret_cast<PxVec3*>(PX_ALLOC(sizeof(PxVec3)*(nbBoxes+1), "BV4"));			// PT: +1 to safely V4Load/V4Store the last element
-	const FloatV halfV = FLoad(0.5f);
-	for(PxU32 i=0;i<nbBoxes;i++)
+	if(parallel)
 	{
-		VertexPointers VP;
-		mesh.getTriangle(VP, i);
-
-		const Vec4V v0V = V4LoadU(&VP.Vertex[0]->x);	
-		const Vec4V v1V = V4LoadU(&VP.Vertex[1]->x);
-		const Vec4V v2V = V4LoadU(&VP.Vertex[2]->x);
-		Vec4V minV = V4Min(v0V, v1V);
-		minV = V4Min(minV, v2V);
-		Vec4V maxV = V4Max(v0V, v1V);
-		maxV = V4Max(maxV, v2V);
-		V4StoreU_Safe(minV, &boxes[i].minimum.x);	// PT: safe because 'maximum' follows 'minimum'
-		V4StoreU_Safe(maxV, &boxes[i].maximum.x);	// PT: safe because we allocated one more box
-
-		const Vec4V centerV = V4Scale(V4Add(maxV, minV), halfV);
-		V4StoreU_Safe(centerV, &centers[i].x);	// PT: safe because we allocated one more PxVec3
+		ComputeBoxesContext ctx;
+		ctx.mMesh		= &mesh;
+		ctx.mBoxes		= boxes;
+		ctx.mCenters	= centers;
+		Cm::blockingParallelFor(dispatcher, nbBoxes, gParallelBoxesChunkSize, gParallelBoxesChunkSize, computeBoxesChunk, &ctx, "Gu::BV4.parallelBuild");
 	}
+	else
+		computeBoxes(mesh, boxes, centers, 0, nbBoxes);
 
 	{
 		// Release previous tree
 		release();
 
-		// Init stats
-		BuildStats Stats;
-		Stats.setCount(1);
-
 		// Initialize indices. This list will be modified during build.
 		mIndices = reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*nbBoxes, "BV4 indices"));
 		// Identity permutation
@@ -292,11 +434,23 @@ bool AABBTree::buildFromMesh(SourceMesh& mesh, PxU32 limit)
 		mPool->mNodePrimitives	= mIndices;
 		mPool->mNbPrimitives	= nbBoxes;
 
-		// Build the hierarchy
-		local_BuildHierarchy(mPool, boxes, centers, Stats, mPool, limit);
+		if(parallel)
+		{
+			// Build the hierarchy, get back total number of nodes
+			mTotalNbNodes = buildHierarchyParallel(mPool, boxes, centers, nbBoxes, limit, *dispatcher);
+		}
+		else
+		{
+			// Init stats
+			BuildStats Stats;
+			Stats.setCount(1);
+
+			// Build the hierarchy
+			local_BuildHierarchy(mPool, boxes, centers, Stats, mPool, limit);
 
-		// Get back total number of nodes
-		mTotalNbNodes = Stats.getCount();
+			// Get back total number of nodes
+			mTotalNbNodes = Stats.getCount();
+		}
 	}
 
 	PX_FREE(centers);
@@ -1072,7 +1226,7 @@ static bool BuildBV4Internal(BV4Tree& tree, const AABBTree& Source, SourceMesh*
 #ifdef GU_BV4_USE_SLABS
 		PX_UNUSED(NbSingleNodes);
 		const PxU32 NbNeeded = (Params.mStats[0]+Params.mStats[1]+Params.mStats[2]+Params.mStats[3])*4;
-		BVDataPacked* Nodes = reinterpret_cast<BVDataPacked*>(PX_ALLOC(sizeof(BVDataPacked)*NbNeeded, "BV4 nodes"));	// PT: PX_NEW breaks alignment here
+		BVDataPacked* Nodes = reinterpret_cast<BVDataPacked*>(PX_ALLOC_LARGE(sizeof(BVDataPacked)*NbNeeded, "BV4 nodes"));	// PX_NEW breaks alignment here
 //		BVDataPacked* Nodes = PX_NEW(BVDataPacked)[NbNeeded];
 
 		if(CurID==2)
@@ -1262,12 +1416,12 @@ static bool gReorderCallback(const AABBTreeNode* current, PxU32 /*depth*/, void*
 	return true;
 }
 
-bool physx::Gu::BuildBV4Ex(BV4Tree& tree, SourceMesh& mesh, float epsilon, PxU32 nbTrisPerLeaf)
+bool physx::Gu::BuildBV4Ex(BV4Tree& tree, SourceMesh& mesh, float epsilon, PxU32 nbTrisPerLeaf, PxCpuDispatcher* dispatcher)
 {
 	const PxU32 nbTris = mesh.mNbTris;
 
 	AABBTree Source;
-	if(!Source.buildFromMesh(mesh, nbTrisPerLeaf))
+	if(!Source.buildFromMesh(mesh, nbTrisPerLeaf, dispatcher))
 		return false;
 
 	{
@@ -35,6 +35,8 @@
 
 namespace physx
 {
+class PxCpuDispatcher;
+
 namespace Gu
 {
 	class BV4Tree;
@@ -99,7 +101,8 @@ namespace Gu
 											AABBTree();
 											~AABBTree();
 
-						bool				buildFromMesh(SourceMesh& mesh, PxU32 limit);
+						// The subtrees are built in parallel when a dispatcher is given, the resulting tree is the same
+						bool				buildFromMesh(SourceMesh& mesh, PxU32 limit, PxCpuDispatcher* dispatcher = NULL);
 						void				release();
 
 		PX_FORCE_INLINE	const PxU32*		getIndices()		const	{ return mIndices;		}	//!< Catch the indices
@@ -117,7 +120,7 @@ namespace Gu
 						PxU32				mTotalNbNodes;		//!< Number of nodes in the tree.
 	};
 
-	PX_PHYSX_COMMON_API bool BuildBV4Ex(BV4Tree& tree, SourceMesh& mesh, float epsilon, PxU32 nbTrisPerLeaf);
+	PX_PHYSX_COMMON_API bool BuildBV4Ex(BV4Tree& tree, SourceMesh& mesh, float epsilon, PxU32 nbTrisPerLeaf, PxCpuDispatcher* dispatcher = NULL);
 
 } // namespace Gu
 }
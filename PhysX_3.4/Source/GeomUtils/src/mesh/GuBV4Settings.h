@@ -35,5 +35,6 @@
 	#define GU_BV4_PRECOMPUTED_NODE_SORT	// Use node sorting or not. This should probably always be enabled.
 	#define GU_BV4_QUANTIZED_TREE			// Use AABB quantization/compression or not.
 	#define GU_BV4_USE_SLABS				// Use swizzled data format or not. Swizzled = faster raycasts, but slower overlaps & larger trees.
+	#define GU_BV4_PACKET_SIZE	4			// Number of queries traversed together by packet queries, one per SIMD lane.
 
 #endif // GU_BV4_SETTINGS_H
@@ -0,0 +1,312 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "GuBV4.h"
+using namespace physx;
+using namespace Gu;
+
+#if PX_INTEL_FAMILY  && !defined(PX_SIMD_DISABLED)
+
+#include "PsVecMath.h"
+using namespace physx::shdfnd::aos;
+
+#include "GuBV4_Common.h"
+#include "GuCapsule.h"
+#include "GuMidphaseInterface.h"
+#include "GuDistancePointTriangle.h"
+#include "GuIntersectionCapsuleTriangle.h"
+#include "PsBitUtils.h"
+
+#if PX_VC
+#pragma warning ( disable : 4324 )
+#endif
+
+// Capsule packet overlap all.
+// Up to GU_BV4_PACKET_SIZE capsules (or spheres) are tested against each visited node, one per SIMD lane. Each stack entry
+// keeps the mask of the queries that touched the node, so a subtree is only visited once for the whole packet and the leaf
+// tests are only done for the queries that reached the leaf.
+
+struct CapsulePacketParams
+{
+	const IndTri32*	PX_RESTRICT	mTris32;
+	const IndTri16*	PX_RESTRICT	mTris16;
+	const PxVec3*	PX_RESTRICT	mVerts;
+
+#ifdef GU_BV4_QUANTIZED_TREE
+	BV4_ALIGN16(Vec3p	mCenterOrMinCoeff_PaddedAligned);
+	BV4_ALIGN16(Vec3p	mExtentsOrMaxCoeff_PaddedAligned);
+#endif
+
+	// Bounds of the capsule segments in mesh space, one query per lane. The node test is the distance between the node
+	// and these bounds, which is exact for spheres and conservative for capsules.
+	BV4_ALIGN16(float	mMinX[GU_BV4_PACKET_SIZE]);
+	BV4_ALIGN16(float	mMinY[GU_BV4_PACKET_SIZE]);
+	BV4_ALIGN16(float	mMinZ[GU_BV4_PACKET_SIZE]);
+	BV4_ALIGN16(float	mMaxX[GU_BV4_PACKET_SIZE]);
+	BV4_ALIGN16(float	mMaxY[GU_BV4_PACKET_SIZE]);
+	BV4_ALIGN16(float	mMaxZ[GU_BV4_PACKET_SIZE]);
+	BV4_ALIGN16(float	mRadius2[GU_BV4_PACKET_SIZE]);
+
+	Capsule						mLocalCapsules[GU_BV4_PACKET_SIZE];	// Capsules in mesh space
+	CapsuleTriangleOverlapData	mData[GU_BV4_PACKET_SIZE];
+	PxU32						mFirstQueryIndex;
+	PxU32						mActiveMask;
+	PacketResults*				mResults;
+};
+
+static PX_FORCE_INLINE Ps::IntBool __CapsuleTriangle(const CapsulePacketParams* PX_RESTRICT params, PxU32 lane, const PxVec3& p0, const PxVec3& p1, const PxVec3& p2)
+{
+	const Capsule& capsule = params->mLocalCapsules[lane];
+	const float radius2 = params->mRadius2[lane];
+
+	// Spheres are capsules with a zero length segment
+	if(params->mData[lane].mBDotB==0.0f)
+	{
+		if((p0 - capsule.p0).magnitudeSquared() <= radius2)
+			return 1;
+
+		const PxVec3 edge10 = p1 - p0;
+		const PxVec3 edge20 = p2 - p0;
+		const PxVec3 cp = closestPtPointTriangle2(capsule.p0, p0, p1, p2, edge10, edge20);
+		return (cp - capsule.p0).magnitudeSquared() <= radius2;
+	}
+
+	const PxVec3 normal = (p0 - p1).cross(p0 - p2);
+	return intersectCapsuleTriangle(normal, p0, p1, p2, capsule, params->mData[lane]);
+}
+
+static PX_FORCE_INLINE Ps::IntBool doPacketLeafTest(const CapsulePacketParams* PX_RESTRICT params, PxU32 primIndex, PxU32 mask)
+{
+	PxU32 nbToGo = getNbPrimitives(primIndex);
+	do
+	{
+		PxU32 VRef0, VRef1, VRef2;
+		getVertexReferences(VRef0, VRef1, VRef2, primIndex, params->mTris32, params->mTris16);
+
+		const PxVec3& p0 = params->mVerts[VRef0];
+		const PxVec3& p1 = params->mVerts[VRef1];
+		const PxVec3& p2 = params->mVerts[VRef2];
+
+		PxU32 lanes = mask;
+		while(lanes)
+		{
+			const PxU32 lane = Ps::lowestSetBit(lanes);
+			lanes &= lanes - 1;
+
+			if(__CapsuleTriangle(params, lane, p0, p1, p2))
+			{
+				// PacketResults::add returns false on overflow, which stops the traversal
+				if(!params->mResults->add(params->mFirstQueryIndex + lane, primIndex))
+					return 1;
+			}
+		}
+		primIndex++;
+	}while(nbToGo--);
+
+	return 0;
+}
+
+static void setupCapsulePacketParams(CapsulePacketParams* PX_RESTRICT params, const Capsule* PX_RESTRICT capsules, PxU32 nbCapsules, const BV4Tree* PX_RESTRICT tree, const PxMat44* PX_RESTRICT worldm_Aligned, const SourceMesh* PX_RESTRICT mesh)
+{
+	PX_ASSERT(nbCapsules && nbCapsules<=GU_BV4_PACKET_SIZE);
+
+	params->mActiveMask = (1<<nbCapsules) - 1;
+	for(PxU32 i=0;i<GU_BV4_PACKET_SIZE;i++)
+	{
+		if(i<nbCapsules)
+		{
+			Capsule& localCapsule = params->mLocalCapsules[i];
+			computeLocalCapsule(localCapsule, capsules[i], worldm_Aligned);
+			params->mData[i].init(localCapsule);
+
+			const PxVec3 minV = localCapsule.p0.minimum(localCapsule.p1);
+			const PxVec3 maxV = localCapsule.p0.maximum(localCapsule.p1);
+			params->mMinX[i] = minV.x;	params->mMaxX[i] = maxV.x;
+			params->mMinY[i] = minV.y;	params->mMaxY[i] = maxV.y;
+			params->mMinZ[i] = minV.z;	params->mMaxZ[i] = maxV.z;
+			params->mRadius2[i] = localCapsule.radius * localCapsule.radius;
+		}
+		else
+		{
+			// Unused lanes never pass the node test since distances are never negative
+			params->mMinX[i] = params->mMaxX[i] = 0.0f;
+			params->mMinY[i] = params->mMaxY[i] = 0.0f;
+			params->mMinZ[i] = params->mMaxZ[i] = 0.0f;
+			params->mRadius2[i] = -1.0f;
+		}
+	}
+
+	setupMeshPointersAndQuantizedCoeffs(params, mesh, tree);
+}
+
+#include "GuBV4_Internal.h"
+#ifdef GU_BV4_USE_SLABS
+	#include "GuBV4_Slabs.h"
+
+	// Squared distance between the segment bounds of each lane and child i of the current node, then mask of the lanes
+	// within their radius among the lanes that reached the node.
+	#define PACKET_NODE_TEST(i)																	\
+	{																							\
+		const Vec4V gapX = V4Max(zeroV, V4Max(V4Sub(V4SplatElement<i>(minx4a), qMaxX), V4Sub(qMinX, V4SplatElement<i>(maxx4a))));	\
+		const Vec4V gapY = V4Max(zeroV, V4Max(V4Sub(V4SplatElement<i>(miny4a), qMaxY), V4Sub(qMinY, V4SplatElement<i>(maxy4a))));	\
+		const Vec4V gapZ = V4Max(zeroV, V4Max(V4Sub(V4SplatElement<i>(minz4a), qMaxZ), V4Sub(qMinZ, V4SplatElement<i>(maxz4a))));	\
+		const Vec4V d2 = V4MulAdd(gapZ, gapZ, V4MulAdd(gapY, gapY, V4Mul(gapX, gapX)));		\
+		const PxU32 childMask = PxU32(_mm_movemask_ps(V4IsGrtrOrEq(qRadius2, d2))) & parentMask;	\
+		if(childMask)																			\
+		{																						\
+			if(tn->isLeaf(i))																	\
+			{																					\
+				if(doPacketLeafTest(params, tn->getPrimitive(i), childMask))					\
+					return 1;																	\
+			}																					\
+			else																				\
+			{																					\
+				stack[nb] = tn->getChildData(i);												\
+				masks[nb++] = childMask;														\
+			}																					\
+		}																						\
+	}
+
+	static Ps::IntBool BV4_ProcessStreamPacketNoOrder(const BVDataPacked* PX_RESTRICT node, PxU32 initData, const CapsulePacketParams* PX_RESTRICT params)
+	{
+		const BVDataPacked* root = node;
+
+		PxU32 nb=1;
+		PxU32 stack[GU_BV4_STACK_SIZE];
+		PxU32 masks[GU_BV4_STACK_SIZE];
+		stack[0] = initData;
+		masks[0] = params->mActiveMask;
+
+		const Vec4V zeroV = V4Zero();
+		const Vec4V qMinX = V4LoadA(params->mMinX);
+		const Vec4V qMinY = V4LoadA(params->mMinY);
+		const Vec4V qMinZ = V4LoadA(params->mMinZ);
+		const Vec4V qMaxX = V4LoadA(params->mMaxX);
+		const Vec4V qMaxY = V4LoadA(params->mMaxY);
+		const Vec4V qMaxZ = V4LoadA(params->mMaxZ);
+		const Vec4V qRadius2 = V4LoadA(params->mRadius2);
+
+#ifdef GU_BV4_QUANTIZED_TREE
+		const Vec4V minCoeffV = V4LoadA_Safe(&params->mCenterOrMinCoeff_PaddedAligned.x);
+		const Vec4V maxCoeffV = V4LoadA_Safe(&params->mExtentsOrMaxCoeff_PaddedAligned.x);
+		const Vec4V minCoeffxV = V4SplatElement<0>(minCoeffV);
+		const Vec4V minCoeffyV = V4SplatElement<1>(minCoeffV);
+		const Vec4V minCoeffzV = V4SplatElement<2>(minCoeffV);
+		const Vec4V maxCoeffxV = V4SplatElement<0>(maxCoeffV);
+		const Vec4V maxCoeffyV = V4SplatElement<1>(maxCoeffV);
+		const Vec4V maxCoeffzV = V4SplatElement<2>(maxCoeffV);
+#endif
+
+		do
+		{
+			--nb;
+			const PxU32 childData = stack[nb];
+			const PxU32 parentMask = masks[nb];
+			node = root + getChildOffset(childData);
+
+			const BVDataSwizzled* tn = reinterpret_cast<const BVDataSwizzled*>(node);
+
+#ifdef GU_BV4_QUANTIZED_TREE
+			Vec4V minx4a;
+			Vec4V maxx4a;
+			OPC_DEQ4(maxx4a, minx4a, mX, minCoeffxV, maxCoeffxV)
+
+			Vec4V miny4a;
+			Vec4V maxy4a;
+			OPC_DEQ4(maxy4a, miny4a, mY, minCoeffyV, maxCoeffyV)
+
+			Vec4V minz4a;
+			Vec4V maxz4a;
+			OPC_DEQ4(maxz4a, minz4a, mZ, minCoeffzV, maxCoeffzV)
+#else
+			const Vec4V minx4a = V4LoadA(tn->mMinX);
+			const Vec4V miny4a = V4LoadA(tn->mMinY);
+			const Vec4V minz4a = V4LoadA(tn->mMinZ);
+
+			const Vec4V maxx4a = V4LoadA(tn->mMaxX);
+			const Vec4V maxy4a = V4LoadA(tn->mMaxY);
+			const Vec4V maxz4a = V4LoadA(tn->mMaxZ);
+#endif
+			const PxU32 nodeType = getChildType(childData);
+			if(nodeType>1)
+				PACKET_NODE_TEST(3)
+			if(nodeType>0)
+				PACKET_NODE_TEST(2)
+			PACKET_NODE_TEST(1)
+			PACKET_NODE_TEST(0)
+
+		}while(nb);
+
+		return 0;
+	}
+	#undef PACKET_NODE_TEST
+#endif
+
+#ifndef GU_BV4_USE_SLABS
+PxU32	BV4_OverlapCapsuleAll(const Capsule& capsule, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, PxU32* results, PxU32 size, bool& overflow);
+#endif
+
+void BV4_OverlapCapsulePacketAll(const Capsule* capsules, PxU32 nbCapsules, PxU32 firstQueryIndex, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, PacketResults& results)
+{
+#ifdef GU_BV4_USE_SLABS
+	const SourceMesh* PX_RESTRICT mesh = tree.mMeshInterface;
+
+	CapsulePacketParams Params;
+	Params.mFirstQueryIndex	= firstQueryIndex;
+	Params.mResults			= &results;
+	setupCapsulePacketParams(&Params, capsules, nbCapsules, &tree, worldm_Aligned, mesh);
+
+	if(tree.mNodes)
+	{
+		BV4_ProcessStreamPacketNoOrder(tree.mNodes, tree.mInitData, &Params);
+	}
+	else
+	{
+		const PxU32 nbTris = mesh->getNbTriangles();
+		PX_ASSERT(nbTris<16);
+		doPacketLeafTest(&Params, nbTris, Params.mActiveMask);
+	}
+#else
+	// The packed format has no SIMD friendly layout for the children of a node, so the queries are done one by one
+	for(PxU32 i=0;i<nbCapsules && !results.mOverflow;i++)
+	{
+		const PxU32 first = results.mNbResults;
+		const PxU32 nbHits = BV4_OverlapCapsuleAll(capsules[i], tree, worldm_Aligned, results.mResults + first, results.mMaxResults - first, results.mOverflow);
+		if(results.mQueryIndices)
+		{
+			for(PxU32 j=0;j<nbHits;j++)
+				results.mQueryIndices[first + j] = firstQueryIndex + i;
+		}
+		results.mNbResults += nbHits;
+	}
+#endif
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include "PxMeshQuery.h"
 #include "GuInternal.h"
 #include "PxSphereGeometry.h"
+#include "PxGeometryHelpers.h"
 #include "PxGeometryQuery.h"
 #include "GuEntityReport.h"
 #include "GuHeightFieldUtil.h"
@@ -183,6 +184,87 @@ PxU32 physx::PxMeshQuery::findOverlapTriangleMesh(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Number of queries converted to capsules at a time
+#define MESH_QUERY_BATCH_SIZE	64
+
+PxU32 physx::PxMeshQuery::findOverlapTriangleMeshBatch(
+	const PxGeometryHolder* geoms, const PxTransform* geomPoses, PxU32 nbGeoms,
+	const PxTriangleMeshGeometry& meshGeom, const PxTransform& meshPose,
+	PxU32* results, PxU32* queryIndices, PxU32 maxResults, bool& overflow)
+{
+	PX_SIMD_GUARD;
+
+	PacketResults packetResults(results, queryIndices, maxResults);
+
+	TriangleMesh* tm = static_cast<TriangleMesh*>(meshGeom.triangleMesh);
+
+	// Spheres are converted to capsules with a zero length segment. Unsupported geometries are skipped, so the index
+	// of each capsule in 'geoms' is kept to remap the query indices.
+	Capsule capsules[MESH_QUERY_BATCH_SIZE];
+	PxU32 capsuleToGeom[MESH_QUERY_BATCH_SIZE];
+
+	PxU32 geomIndex = 0;
+	while(geomIndex<nbGeoms && !packetResults.mOverflow)
+	{
+		PxU32 nbCapsules = 0;
+		while(geomIndex<nbGeoms && nbCapsules<MESH_QUERY_BATCH_SIZE)
+		{
+			const PxGeometryHolder& geom = geoms[geomIndex];
+			if(geom.getType()==PxGeometryType::eSPHERE)
+			{
+				const PxVec3& center = geomPoses[geomIndex].p;
+				capsules[nbCapsules] = Capsule(center, center, geom.sphere().radius);
+				capsuleToGeom[nbCapsules++] = geomIndex;
+			}
+			else if(geom.getType()==PxGeometryType::eCAPSULE)
+			{
+				getCapsule(capsules[nbCapsules], geom.capsule(), geomPoses[geomIndex]);
+				capsuleToGeom[nbCapsules++] = geomIndex;
+			}
+			else
+			{
+				PX_CHECK_MSG(false, "findOverlapTriangleMeshBatch: Only capsule and sphere geometries are supported.");
+			}
+			geomIndex++;
+		}
+
+		const PxU32 first = packetResults.mNbResults;
+		if(!Midphase::intersectCapsulePacketVsMesh(capsules, nbCapsules, *tm, meshPose, meshGeom.scale, packetResults))
+		{
+			for(PxU32 i=0;i<nbCapsules && !packetResults.mOverflow;i++)
+			{
+				const PxU32 start = packetResults.mNbResults;
+				LimitedResults limitedResults(results + start, maxResults - start, 0);
+
+				const Capsule& capsule = capsules[i];
+				if(capsule.p0==capsule.p1)
+					Midphase::intersectSphereVsMesh(Sphere(capsule.p0, capsule.radius), *tm, meshPose, meshGeom.scale, &limitedResults);
+				else
+					Midphase::intersectCapsuleVsMesh(capsule, *tm, meshPose, meshGeom.scale, &limitedResults);
+
+				if(queryIndices)
+				{
+					for(PxU32 j=0;j<limitedResults.mNbResults;j++)
+						queryIndices[start + j] = i;
+				}
+				packetResults.mNbResults += limitedResults.mNbResults;
+				packetResults.mOverflow = limitedResults.mOverflow;
+			}
+		}
+
+		if(queryIndices)
+		{
+			for(PxU32 i=first;i<packetResults.mNbResults;i++)
+				queryIndices[i] = capsuleToGeom[queryIndices[i]];
+		}
+	}
+
+	overflow = packetResults.mOverflow;
+	return packetResults.mNbResults;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 PxU32 physx::PxMeshQuery::findOverlapHeightField(	const PxGeometry& geom, const PxTransform& geomPose,
 													const PxHeightFieldGeometry& hfGeom, const PxTransform& hfPose,
 													PxU32* results, PxU32 maxResults, PxU32 startIndex, bool& overflow)
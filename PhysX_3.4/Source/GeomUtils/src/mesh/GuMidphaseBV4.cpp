@@ -73,6 +73,7 @@ void		BV4_OverlapBoxCB		(const Box& box, const BV4Tree& tree, MeshOverlapCallbac
 Ps::IntBool	BV4_OverlapCapsuleAny	(const Capsule& capsule, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned);
 PxU32		BV4_OverlapCapsuleAll	(const Capsule& capsule, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, PxU32* results, PxU32 size, bool& overflow);
 void		BV4_OverlapCapsuleCB	(const Capsule& capsule, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, MeshOverlapCallback callback, void* userData);
+void		BV4_OverlapCapsulePacketAll(const Capsule* capsules, PxU32 nbCapsules, PxU32 firstQueryIndex, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, PacketResults& results);
 
 Ps::IntBool	BV4_SphereSweepSingle	(const Sphere& sphere, const PxVec3& dir, float maxDist, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, SweepHit* PX_RESTRICT hit, PxU32 flags);
 void		BV4_SphereSweepCB		(const Sphere& sphere, const PxVec3& dir, float maxDist, const BV4Tree& tree, const PxMat44* PX_RESTRICT worldm_Aligned, SweepUnlimitedCallback callback, void* userData, PxU32 flags, bool nodeSorting);
@@ -723,6 +724,18 @@ bool physx::Gu::intersectCapsuleVsMesh_BV4(const Capsule& capsule, const Triangl
 	}
 }
 
+void physx::Gu::intersectCapsulePacketVsMesh_BV4(const Capsule* capsules, PxU32 nbCapsules, const TriangleMesh& triMesh, const PxTransform& meshTransform, PacketResults& results)
+{
+	PX_ASSERT(triMesh.getConcreteType()==PxConcreteType::eTRIANGLE_MESH_BVH34);
+	const BV4Tree& tree = static_cast<const BV4TriangleMesh&>(triMesh).getBV4Tree();
+
+	BV4_ALIGN16(PxMat44 World);
+	const PxMat44* TM = setupWorldMatrix(World, &meshTransform.p.x, &meshTransform.q.x);
+
+	for(PxU32 i=0;i<nbCapsules && !results.mOverflow;i+=GU_BV4_PACKET_SIZE)
+		BV4_OverlapCapsulePacketAll(capsules + i, PxMin<PxU32>(nbCapsules - i, GU_BV4_PACKET_SIZE), i, tree, TM, results);
+}
+
 // PT: TODO: get rid of this (TA34704)
 static bool gVolumeCallback(void* userData, const PxVec3& p0, const PxVec3& p1, const PxVec3& p2, PxU32 triangleIndex, const PxU32* vertexIndices)
 {
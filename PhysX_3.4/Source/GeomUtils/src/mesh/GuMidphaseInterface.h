@@ -113,6 +113,36 @@ namespace Gu
 		}
 	};
 
+	// Results of a batch of overlap queries. Triangles touched by several queries are reported once per query.
+	struct PacketResults
+	{
+		PxU32*	mResults;		// Triangle indices
+		PxU32*	mQueryIndices;	// Index of the query that touched each triangle
+		PxU32	mNbResults;
+		PxU32	mMaxResults;
+		bool	mOverflow;
+
+		PX_FORCE_INLINE PacketResults(PxU32* results, PxU32* queryIndices, PxU32 maxResults)
+			: mResults(results), mQueryIndices(queryIndices), mNbResults(0), mMaxResults(maxResults), mOverflow(false)
+		{
+		}
+
+		PX_FORCE_INLINE	bool add(PxU32 queryIndex, PxU32 index)
+		{
+			if(mNbResults>=mMaxResults)
+			{
+				mOverflow = true;
+				return false;
+			}
+
+			mResults[mNbResults] = index;
+			if(mQueryIndices)
+				mQueryIndices[mNbResults] = queryIndex;
+			mNbResults++;
+			return true;
+		}
+	};
+
 	// Exposing wrapper for Midphase::intersectOBB just for particles in order to avoid DelayLoad performance problem. This should be removed with particles in PhysX 3.5 (US16993)
 	PX_PHYSX_COMMON_API void intersectOBB_Particles(const TriangleMesh* mesh, const Box& obb, MeshHitCallback<PxRaycastHit>& callback, bool bothTriangleSidesCollide, bool checkObbIsAligned = true);
 
@@ -148,6 +178,7 @@ namespace Gu
 								const Gu::Box& box, const PxVec3& unitDir, const PxReal distance,
 								PxSweepHit& sweepHit, PxHitFlags hitFlags, const PxReal inflation);
 	PX_PHYSX_COMMON_API void sweepConvex_MeshGeom_BV4(const TriangleMesh* mesh, const Gu::Box& hullBox, const PxVec3& localDir, const PxReal distance, SweepConvexMeshHitCallback& callback, bool anyHit);
+	PX_PHYSX_COMMON_API void intersectCapsulePacketVsMesh_BV4(const Capsule* capsules, PxU32 nbCapsules, const TriangleMesh& triMesh, const PxTransform& meshTransform, PacketResults& results);
 #endif
 
 	typedef PxU32 (*MidphaseRaycastFunction)(	const TriangleMesh* mesh, const PxTriangleMeshGeometry& meshGeom, const PxTransform& pose,
@@ -414,6 +445,33 @@ namespace Midphase
 		const PxU32 index = PxU32(mesh->getConcreteType() - PxConcreteType::eTRIANGLE_MESH_BVH33);
 		gMidphaseConvexSweepTable[index](mesh, hullBox, localDir, distance, callback, anyHit);
 	}
+
+	// \param[in]	capsules		capsules, spheres are capsules whose segment is a point
+	// \param[in]	nbCapsules		number of capsules
+	// \param[in]	mesh			triangle mesh
+	// \param[in]	meshTransform	pose/transform of triangle mesh
+	// \param[in]	meshScale		mesh scale
+	// \param[out]	results			results object, filled with the triangles touched by each capsule
+	// \return		false if the mesh doesn't support packet queries, in which case nothing is done and the capsules must be tested one by one
+	// \note		only BV4 meshes without scaling are supported. The queries are traversed 4 at a time.
+	PX_FORCE_INLINE bool intersectCapsulePacketVsMesh(const Capsule* capsules, PxU32 nbCapsules, const TriangleMesh& mesh, const PxTransform& meshTransform, const PxMeshScale& meshScale, PacketResults& results)
+	{
+	#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+		if(mesh.getConcreteType()==PxConcreteType::eTRIANGLE_MESH_BVH34 && meshScale.isIdentity())
+		{
+			intersectCapsulePacketVsMesh_BV4(capsules, nbCapsules, mesh, meshTransform, results);
+			return true;
+		}
+	#else
+		PX_UNUSED(capsules);
+		PX_UNUSED(nbCapsules);
+		PX_UNUSED(mesh);
+		PX_UNUSED(meshTransform);
+		PX_UNUSED(meshScale);
+		PX_UNUSED(results);
+	#endif
+		return false;
+	}
 }
 }
 }
@@ -41,10 +41,12 @@
 #define RTREE_INFLATION_EPSILON 5e-4f
 
 #include "GuRTree.h"
+#include "foundation/PxMemory.h"
 #include "PsSort.h"
 #include "GuSerialize.h"
 #include "CmUtils.h"
 #include "PsUtilities.h"
+#include "CmParallelFor.h"
 
 using namespace physx;
 #if PX_ENABLE_DYNAMIC_MESH_RTREE
@@ -349,6 +351,60 @@ void RTree::validate()
 }
 
 #if PX_ENABLE_DYNAMIC_MESH_RTREE
+static PX_FORCE_INLINE void refitLeaf(RTree::CallbackRefit& cb, RTreePage& page, PxU32 j)
+{
+	Vec3V childMn, childMx;
+	cb.recomputeBounds(page.ptrs[j]-1, childMn, childMx); // compute the bound around triangles
+	PxVec3 mn3, mx3;
+	V3StoreU(childMn, mn3);
+	V3StoreU(childMx, mx3);
+	page.minx[j] = mn3.x; page.miny[j] = mn3.y; page.minz[j] = mn3.z;
+	page.maxx[j] = mx3.x; page.maxy[j] = mx3.y; page.maxz[j] = mx3.z;
+}
+
+static PX_FORCE_INLINE void refitNode(RTreePage& page, PxU32 j, const RTreePage* child)
+{
+	PX_COMPILE_TIME_ASSERT(RTREE_N == 4);
+	bool first = true;
+	for (PxU32 k = 0; k < RTREE_N; k++)
+	{
+		if (child->isEmpty(k))
+			continue;
+		if (first)
+		{
+			page.minx[j] = child->minx[k]; page.miny[j] = child->miny[k]; page.minz[j] = child->minz[k];
+			page.maxx[j] = child->maxx[k]; page.maxy[j] = child->maxy[k]; page.maxz[j] = child->maxz[k];
+			first = false;
+		} else
+		{
+			page.minx[j] = PxMin(page.minx[j], child->minx[k]);
+			page.miny[j] = PxMin(page.miny[j], child->miny[k]);
+			page.minz[j] = PxMin(page.minz[j], child->minz[k]);
+			page.maxx[j] = PxMax(page.maxx[j], child->maxx[k]);
+			page.maxy[j] = PxMax(page.maxy[j], child->maxy[k]);
+			page.maxz[j] = PxMax(page.maxz[j], child->maxz[k]);
+		}
+	}
+}
+
+static void computeRootBounds(RTreePage* pages, PxU32 nbRootPages, PxBounds3& retBounds)
+{
+	RTreeNodeQ bound1;
+	for (PxU32 ii = 0; ii<nbRootPages; ii++)
+	{
+		pages[ii].computeBounds(bound1);
+		if (ii == 0)
+		{
+			retBounds.minimum = PxVec3(bound1.minx, bound1.miny, bound1.minz);
+			retBounds.maximum = PxVec3(bound1.maxx, bound1.maxy, bound1.maxz);
+		} else
+		{
+			retBounds.minimum = retBounds.minimum.minimum(PxVec3(bound1.minx, bound1.miny, bound1.minz));
+			retBounds.maximum = retBounds.maximum.maximum(PxVec3(bound1.maxx, bound1.maxy, bound1.maxz));
+		}
+	}
+}
+
 void RTree::refitAllStaticTree(CallbackRefit& cb, PxBounds3* retBounds)
 {
 	PxU8* treeNodes8 = reinterpret_cast<PxU8*>(mPages);
@@ -362,59 +418,81 @@ void RTree::refitAllStaticTree(CallbackRefit& cb, PxBounds3* retBounds)
 			if (page.isEmpty(j))
 				continue;
 			if (page.isLeaf(j))
-			{
-				Vec3V childMn, childMx;
-				cb.recomputeBounds(page.ptrs[j]-1, childMn, childMx); // compute the bound around triangles
-				PxVec3 mn3, mx3;
-				V3StoreU(childMn, mn3);
-				V3StoreU(childMx, mx3);
-				page.minx[j] = mn3.x; page.miny[j] = mn3.y; page.minz[j] = mn3.z;
-				page.maxx[j] = mx3.x; page.maxy[j] = mx3.y; page.maxz[j] = mx3.z;
-			} else
-			{
-				const RTreePage* child = reinterpret_cast<const RTreePage*>(treeNodes8 + page.ptrs[j]);
-				PX_COMPILE_TIME_ASSERT(RTREE_N == 4);
-				bool first = true;
-				for (PxU32 k = 0; k < RTREE_N; k++)
-				{
-					if (child->isEmpty(k))
-						continue;
-					if (first)
-					{
-						page.minx[j] = child->minx[k]; page.miny[j] = child->miny[k]; page.minz[j] = child->minz[k];
-						page.maxx[j] = child->maxx[k]; page.maxy[j] = child->maxy[k]; page.maxz[j] = child->maxz[k];
-						first = false;
-					} else
-					{
-						page.minx[j] = PxMin(page.minx[j], child->minx[k]);
-						page.miny[j] = PxMin(page.miny[j], child->miny[k]);
-						page.minz[j] = PxMin(page.minz[j], child->minz[k]);
-						page.maxx[j] = PxMax(page.maxx[j], child->maxx[k]);
-						page.maxy[j] = PxMax(page.maxy[j], child->maxy[k]);
-						page.maxz[j] = PxMax(page.maxz[j], child->maxz[k]);
-					}
-				}
-			}
+				refitLeaf(cb, page, j);
+			else
+				refitNode(page, j, reinterpret_cast<const RTreePage*>(treeNodes8 + page.ptrs[j]));
 		}
 	}
 
 	if (retBounds)
+		computeRootBounds(mPages, mNumRootPages, *retBounds);
+
+#if PX_CHECKED
+	validate(&cb);
+#endif
+}
+
+namespace
+{
+	// Number of pages per chunk when the leaves are refit in parallel
+	const PxU32 gParallelRefitPagesPerChunk = 256;
+
+	struct PartialRefitContext
+	{
+		RTree::CallbackRefit*	mCallback;
+		RTreePage*				mPages;
+		PxU8*					mModified;	// One flag per page, set when one of its boxes changed
+	};
+
+	void refitModifiedLeaves(void* context, PxU32 start, PxU32 nb)
 	{
-		RTreeNodeQ bound1;
-		for (PxU32 ii = 0; ii<mNumRootPages; ii++)
+		PartialRefitContext& ctx = *reinterpret_cast<PartialRefitContext*>(context);
+		for (PxU32 iPage = start; iPage < start + nb; iPage++)
 		{
-			mPages[ii].computeBounds(bound1);
-			if (ii == 0)
+			RTreePage& page = ctx.mPages[iPage];
+			for (PxU32 j = 0; j < RTREE_N; j++)
 			{
-				retBounds->minimum = PxVec3(bound1.minx, bound1.miny, bound1.minz);
-				retBounds->maximum = PxVec3(bound1.maxx, bound1.maxy, bound1.maxz);
-			} else
-			{
-				retBounds->minimum = retBounds->minimum.minimum(PxVec3(bound1.minx, bound1.miny, bound1.minz));
-				retBounds->maximum = retBounds->maximum.maximum(PxVec3(bound1.maxx, bound1.maxy, bound1.maxz));
+				if (page.isEmpty(j) || !page.isLeaf(j) || !ctx.mCallback->isModified(page.ptrs[j]-1))
+					continue;
+				refitLeaf(*ctx.mCallback, page, j);
+				ctx.mModified[iPage] = 1;
 			}
 		}
 	}
+}
+
+void RTree::refitModifiedStaticTree(CallbackRefit& cb, PxCpuDispatcher* dispatcher, PxBounds3* retBounds)
+{
+	PartialRefitContext ctx;
+	ctx.mCallback = &cb;
+	ctx.mPages = mPages;
+	ctx.mModified = reinterpret_cast<PxU8*>(PX_ALLOC_TEMP(mTotalPages ? mTotalPages : 1, "RTree refit flags"));
+	PxMemZero(ctx.mModified, mTotalPages);
+
+	// Leaves first, they are the expensive part and the pages don't depend on each other
+	Cm::blockingParallelFor(dispatcher, mTotalPages, gParallelRefitPagesPerChunk, gParallelRefitPagesPerChunk, refitModifiedLeaves, &ctx, "Gu::RTree.parallelRefit");
+
+	// Then the ancestors of the modified pages. Children come after their parent, so a back to front scan sees them refit already
+	const PxU8* treeNodes8 = reinterpret_cast<const PxU8*>(mPages);
+	for (PxI32 iPage = PxI32(mTotalPages)-1; iPage>=0; iPage--)
+	{
+		RTreePage& page = mPages[iPage];
+		for (PxU32 j = 0; j < RTREE_N; j++)
+		{
+			if (page.isEmpty(j) || page.isLeaf(j))
+				continue;
+			const PxU32 childPage = page.ptrs[j]/sizeof(RTreePage);
+			if (!ctx.mModified[childPage])
+				continue;
+			refitNode(page, j, reinterpret_cast<const RTreePage*>(treeNodes8 + page.ptrs[j]));
+			ctx.mModified[iPage] = 1;
+		}
+	}
+
+	PX_FREE(ctx.mModified);
+
+	if (retBounds)
+		computeRootBounds(mPages, mNumRootPages, *retBounds);
 
 #if PX_CHECKED
 	validate(&cb);
@@ -184,9 +184,14 @@ namespace Gu {
 		{
 			// In this callback index is the number stored in the RTree, which is a LeafTriangles object for current PhysX mesh
 			virtual void recomputeBounds(PxU32 index, shdfnd::aos::Vec3V& mn, shdfnd::aos::Vec3V& mx) = 0;
+			// Used by refitModifiedStaticTree, returns true if the bounds of the leaf must be recomputed
+			virtual bool isModified(PxU32 index) { PX_UNUSED(index); return true; }
 			virtual ~CallbackRefit() {}
 		};
 		void		refitAllStaticTree(CallbackRefit& cb, PxBounds3* resultMeshBounds); // faster version of refit for static RTree only
+		// Only refits the leaves for which the callback returns isModified, and their ancestors.
+		// With a dispatcher the leaves are processed on the workers too, so both callback functions must be thread safe.
+		void		refitModifiedStaticTree(CallbackRefit& cb, PxCpuDispatcher* dispatcher, PxBounds3* resultMeshBounds);
 #endif
 
 
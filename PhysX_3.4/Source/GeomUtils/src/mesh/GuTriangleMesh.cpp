@@ -227,6 +227,13 @@ PxBounds3 Gu::TriangleMesh::refitBVH()
 
 	return PxBounds3(mAABB.getMin(), mAABB.getMax());
 }
+
+PxBounds3 Gu::TriangleMesh::refitBVH(const PxMeshVertexRange*, PxU32, PxCpuDispatcher*)
+{
+	Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxTriangleMesh::refitBVH() is only supported for meshes with PxMeshMidPhase::eBVH33.");
+
+	return PxBounds3(mAABB.getMin(), mAABB.getMax());
+}
 #endif
 
 } // namespace physx
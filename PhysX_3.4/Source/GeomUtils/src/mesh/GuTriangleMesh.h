@@ -99,6 +99,7 @@ public:
 #if PX_ENABLE_DYNAMIC_MESH_RTREE
 						virtual PxVec3*					getVerticesForModification();
 						virtual PxBounds3				refitBVH();
+						virtual PxBounds3				refitBVH(const PxMeshVertexRange* ranges, PxU32 nbRanges, PxCpuDispatcher* dispatcher);
 #endif 
 
 						virtual	PxBounds3				getLocalBounds()					const
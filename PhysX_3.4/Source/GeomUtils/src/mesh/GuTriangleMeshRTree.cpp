@@ -31,6 +31,8 @@
 #include "GuTriangleMeshRTree.h"
 #if PX_ENABLE_DYNAMIC_MESH_RTREE
 #include "GuConvexEdgeFlags.h"
+#include "CmBitMap.h"
+#include "PsFoundation.h"
 #endif
 
 using namespace physx;
@@ -146,6 +148,82 @@ PxBounds3 Gu::RTreeTriangleMesh::refitBVH()
 	mAABB = meshBounds;
 	return meshBounds;
 }
+
+template<typename IndexType>
+struct PartialRefitCallback : RefitCallback<IndexType>
+{
+	const Cm::BitMap& modifiedVerts;
+
+	PartialRefitCallback(const PxVec3* aNewPositions, const IndexType* aIndices, const Cm::BitMap& aModifiedVerts) :
+		RefitCallback<IndexType>(aNewPositions, aIndices), modifiedVerts(aModifiedVerts)	{}
+
+	virtual bool isModified(PxU32 index)
+	{
+		Gu::LeafTriangles currentLeaf; currentLeaf.Data = index;
+		const IndexType* vInds = this->indices + 3 * currentLeaf.GetTriangleIndex();
+		const IndexType* last = vInds + 3 * currentLeaf.GetNbTriangles();
+		for (; vInds < last; vInds++)
+		{
+			if (modifiedVerts.test(*vInds))
+				return true;
+		}
+		return false;
+	}
+private:
+	PartialRefitCallback& operator=(const PartialRefitCallback&);
+};
+
+template<typename IndexType>
+static void resetModifiedEdgeFlags(PxU8* extraTrigData, const IndexType* indices, PxU32 nbTris, const Cm::BitMap& modifiedVerts)
+{
+	for (PxU32 i = 0; i < nbTris; i++)
+	{
+		const IndexType* vInds = indices + 3 * i;
+		if (modifiedVerts.test(vInds[0]) || modifiedVerts.test(vInds[1]) || modifiedVerts.test(vInds[2]))
+			extraTrigData[i] |= Gu::ETD_CONVEX_EDGE_ALL;
+	}
+}
+
+PxBounds3 Gu::RTreeTriangleMesh::refitBVH(const PxMeshVertexRange* ranges, PxU32 nbRanges, PxCpuDispatcher* dispatcher)
+{
+	const PxU32 nbVerts = getNbVertices();
+	Cm::BitMap modifiedVerts;
+	modifiedVerts.resizeAndClear(nbVerts);
+	for (PxU32 i = 0; i < nbRanges; i++)
+	{
+		if (ranges[i].start > nbVerts || ranges[i].count > nbVerts - ranges[i].start)
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "PxTriangleMesh::refitBVH(): vertex range out of bounds, it is ignored.");
+			continue;
+		}
+		for (PxU32 j = ranges[i].start; j < ranges[i].start + ranges[i].count; j++)
+			modifiedVerts.set(j);
+	}
+
+	PxBounds3 meshBounds;
+	if (has16BitIndices())
+	{
+		PartialRefitCallback<PxU16> cb(mVertices, static_cast<const PxU16*>(mTriangles), modifiedVerts);
+		mRTree.refitModifiedStaticTree(cb, dispatcher, &meshBounds);
+	}
+	else
+	{
+		PartialRefitCallback<PxU32> cb(mVertices, static_cast<const PxU32*>(mTriangles), modifiedVerts);
+		mRTree.refitModifiedStaticTree(cb, dispatcher, &meshBounds);
+	}
+
+	// only the triangles that moved lose their edge flags, unless the full refit already reset them all
+	if ((mRTree.mFlags & RTree::IS_EDGE_SET) == 0 && mExtraTrigData)
+	{
+		if (has16BitIndices())
+			resetModifiedEdgeFlags(mExtraTrigData, static_cast<const PxU16*>(mTriangles), getNbTriangles(), modifiedVerts);
+		else
+			resetModifiedEdgeFlags(mExtraTrigData, static_cast<const PxU32*>(mTriangles), getNbTriangles(), modifiedVerts);
+	}
+
+	mAABB = meshBounds;
+	return meshBounds;
+}
 #endif
 
 } // namespace physx
@@ -943,7 +943,7 @@ bool pcmContactBoxBox(GU_CONTACT_METHOD_ARGS)
   
 	PX_UNUSED(bLostContacts);
 
-	if(bLostContacts || manifold.invalidate_BoxConvex(curRTrans, minMargin))	
+	if(bLostContacts || manifold.invalidate_BoxConvex(curRTrans, minMargin, FLoad(params.mPCMThresholdScale)))	
 	{
 		
 		manifold.setRelativeTransform(curRTrans);
@@ -975,10 +975,9 @@ bool pcmContactBoxBox(GU_CONTACT_METHOD_ARGS)
 
 				Vec3V closestA(zeroV), closestB(zeroV), normal(zeroV); // these will be in the local space of B
 				FloatV penDep = FZero(); 
-				manifold.mNumWarmStartPoints = 0;
 				RelativeConvex<BoxV> convexA(box0, aToB);
 				LocalConvex<BoxV> convexB(box1);
-				GjkStatus status = gjkPenetration<RelativeConvex<BoxV>, LocalConvex<BoxV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+				GjkStatus status = gjkPenetration<RelativeConvex<BoxV>, LocalConvex<BoxV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 					manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints, false);
 
 				if(status == EPA_CONTACT)
@@ -203,7 +203,7 @@ bool pcmContactBoxConvex(GU_CONTACT_METHOD_ARGS)
 
 	PX_UNUSED(bLostContacts);
 
-	if(bLostContacts || manifold.invalidate_BoxConvex(curRTrans, minMargin))	
+	if(bLostContacts || manifold.invalidate_BoxConvex(curRTrans, minMargin, FLoad(params.mPCMThresholdScale)))	
 	{
 		
 		GjkStatus status = manifold.mNumContacts > 0 ? GJK_UNDEFINED : GJK_NON_INTERSECT;
@@ -221,13 +221,13 @@ bool pcmContactBoxConvex(GU_CONTACT_METHOD_ARGS)
 		if(idtScale)
 		{
 			const LocalConvex<ShrunkConvexHullNoScaleV> convexB(*PX_SCONVEX_TO_NOSCALECONVEX(&convexHull));
-			status = gjkPenetration<RelativeConvex<BoxV>, LocalConvex<ShrunkConvexHullNoScaleV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+			status = gjkPenetration<RelativeConvex<BoxV>, LocalConvex<ShrunkConvexHullNoScaleV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 				manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints, false);
 		}
 		else
 		{
 			const LocalConvex<ShrunkConvexHullV> convexB(convexHull);
-			status = gjkPenetration<RelativeConvex<BoxV>, LocalConvex<ShrunkConvexHullV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+			status = gjkPenetration<RelativeConvex<BoxV>, LocalConvex<ShrunkConvexHullV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 				manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints, false);
 
 		} 
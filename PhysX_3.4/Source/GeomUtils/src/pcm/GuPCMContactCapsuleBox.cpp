@@ -125,7 +125,7 @@ bool pcmContactCapsuleBox(GU_CONTACT_METHOD_ARGS)
 
 	const bool bLostContacts = (manifold.mNumContacts != initialContacts);
 
-	if(bLostContacts || manifold.invalidate_SphereCapsule(curRTrans, minMargin))	
+	if(bLostContacts || manifold.invalidate_SphereCapsule(curRTrans, minMargin, FLoad(params.mPCMThresholdScale)))	
 	{
 
 		GjkStatus status = manifold.mNumContacts > 0 ? GJK_UNDEFINED : GJK_NON_INTERSECT;
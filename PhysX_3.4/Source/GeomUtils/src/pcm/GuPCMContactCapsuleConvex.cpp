@@ -143,7 +143,7 @@ bool pcmContactCapsuleConvex(GU_CONTACT_METHOD_ARGS)
 	FloatV penDep = zero;
 
 	PX_UNUSED(bLostContacts);
-	if(bLostContacts || manifold.invalidate_SphereCapsule(curRTrans, minMargin))
+	if(bLostContacts || manifold.invalidate_SphereCapsule(curRTrans, minMargin, FLoad(params.mPCMThresholdScale)))
 	{
 		const bool idtScale = shapeConvex.scale.isIdentity();
 
@@ -103,7 +103,7 @@ bool Gu::pcmContactCapsuleHeightField(GU_CONTACT_METHOD_ARGS)
 	
 	const FloatV replaceBreakingThreshold = FMul(capsuleRadius, FLoad(0.001f));
 
-	if(multiManifold.invalidate(curTransform, capsuleRadius, FLoad(0.02f)))
+	if(multiManifold.invalidate(curTransform, capsuleRadius, FLoad(0.02f), FLoad(params.mPCMThresholdScale)))
 	{
 
 		multiManifold.mNumManifolds = 0;
@@ -105,7 +105,7 @@ bool Gu::pcmContactCapsuleMesh(GU_CONTACT_METHOD_ARGS)
 	const PsTransformV curTransform = meshTransform.transformInv(capsuleTransform);
 	
 	// We must be in local space to use the cache
-	if(multiManifold.invalidate(curTransform, capsuleRadius, FLoad(0.02f)))
+	if(multiManifold.invalidate(curTransform, capsuleRadius, FLoad(0.02f), FLoad(params.mPCMThresholdScale)))
 	{
 		const FloatV replaceBreakingThreshold = FMul(capsuleRadius, FLoad(0.001f));
 		//const FloatV capsuleHalfHeight = FloatV_From_F32(shapeCapsule.halfHeight);
@@ -116,13 +116,13 @@ static GjkStatus convexHullNoScale0(const ShrunkConvexHullV& convexHull0, const
 	if(idtScale1)
 	{
 		const LocalConvex<ShrunkConvexHullNoScaleV> convexB(static_cast<const ShrunkConvexHullNoScaleV&>(convexHull1));
-		return gjkPenetration<RelativeConvex<ShrunkConvexHullNoScaleV>, LocalConvex<ShrunkConvexHullNoScaleV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+		return gjkPenetration<RelativeConvex<ShrunkConvexHullNoScaleV>, LocalConvex<ShrunkConvexHullNoScaleV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 						manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints, false);
 	}
 	else
 	{
 		const LocalConvex<ShrunkConvexHullV> convexB(convexHull1);
-		return gjkPenetration<RelativeConvex<ShrunkConvexHullNoScaleV>, LocalConvex<ShrunkConvexHullV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+		return gjkPenetration<RelativeConvex<ShrunkConvexHullNoScaleV>, LocalConvex<ShrunkConvexHullV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 					manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints,false);
 	}
 }
@@ -134,13 +134,13 @@ static GjkStatus convexHullHasScale0(ShrunkConvexHullV& convexHull0, ShrunkConve
 	if(idtScale1)
 	{
 		LocalConvex<ShrunkConvexHullNoScaleV> convexB(static_cast<ShrunkConvexHullNoScaleV&>(convexHull1));
-		return gjkPenetration< RelativeConvex<ShrunkConvexHullV>, LocalConvex<ShrunkConvexHullNoScaleV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+		return gjkPenetration< RelativeConvex<ShrunkConvexHullV>, LocalConvex<ShrunkConvexHullNoScaleV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 						manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints,false);
 	}
 	else
 	{
 		LocalConvex<ShrunkConvexHullV> convexB(convexHull1);
-		return gjkPenetration<RelativeConvex<ShrunkConvexHullV>, LocalConvex<ShrunkConvexHullV> >(convexA, convexB, aToB.p, contactDist, closestA, closestB, normal, penDep,
+		return gjkPenetration<RelativeConvex<ShrunkConvexHullV>, LocalConvex<ShrunkConvexHullV> >(convexA, convexB, manifold.getInitialSearchDir(aToB.p), contactDist, closestA, closestB, normal, penDep,
 					manifold.mAIndice, manifold.mBIndice, manifold.mNumWarmStartPoints, false);
 	}
 }
@@ -236,7 +236,7 @@ bool pcmContactConvexConvex(GU_CONTACT_METHOD_ARGS)
 	//ML: after refreshContactPoints, we might lose some contacts
 	const bool bLostContacts = (manifold.mNumContacts != initialContacts);
 
-	if(bLostContacts || manifold.invalidate_BoxConvex(curRTrans, minMargin) )
+	if(bLostContacts || manifold.invalidate_BoxConvex(curRTrans, minMargin, FLoad(params.mPCMThresholdScale)) )
 	{
 
 		GjkStatus status = manifold.mNumContacts > 0 ? GJK_UNDEFINED : GJK_NON_INTERSECT;
@@ -97,7 +97,7 @@ bool Gu::PCMContactConvexHeightfield(
 	const Gu::PolygonalData& polyData, Gu::SupportLocal* polyMap, const Ps::aos::FloatVArg minMargin,
 	const PxBounds3& hullAABB, const PxHeightFieldGeometry& shapeHeightfield,
 	const PxTransform& transform0, const PxTransform& transform1,
-	PxReal contactDistance, Gu::ContactBuffer& contactBuffer,
+	PxReal contactDistance, PxReal thresholdScale, Gu::ContactBuffer& contactBuffer,
 	const Cm::FastVertex2ShapeScaling& convexScaling, bool idtConvexScale,
 	Gu::MultiplePersistentContactManifold& multiManifold, Cm::RenderOutput* renderOutput)
 
@@ -119,7 +119,7 @@ bool Gu::PCMContactConvexHeightfield(
 	const PsTransformV curTransform = heightfieldTransform.transformInv(convexTransform);
 	
 
-	if(multiManifold.invalidate(curTransform, minMargin))
+	if(multiManifold.invalidate(curTransform, minMargin, FLoad(thresholdScale)))
 	{
 		const FloatV replaceBreakingThreshold = FMul(minMargin, FLoad(0.05f));
 		multiManifold.mNumManifolds = 0;
@@ -218,13 +218,13 @@ bool Gu::pcmContactConvexHeightField(GU_CONTACT_METHOD_ARGS)
 	if(idtScaleConvex)
 	{
 		SupportLocalImpl<Gu::ConvexHullNoScaleV> convexMap(static_cast<ConvexHullNoScaleV&>(convexHull), convexTransform, convexHull.vertex2Shape, convexHull.shape2Vertex, idtScaleConvex);
-		return Gu::PCMContactConvexHeightfield(polyData, &convexMap, minMargin, hullAABB, shapHeightField, transform0, transform1, params.mContactDistance, contactBuffer, convexScaling, 
+		return Gu::PCMContactConvexHeightfield(polyData, &convexMap, minMargin, hullAABB, shapHeightField, transform0, transform1, params.mContactDistance, params.mPCMThresholdScale, contactBuffer, convexScaling, 
 			idtScaleConvex, multiManifold, renderOutput);
 	}
 	else
 	{
 		SupportLocalImpl<Gu::ConvexHullV> convexMap(convexHull, convexTransform, convexHull.vertex2Shape, convexHull.shape2Vertex, idtScaleConvex);
-		return Gu::PCMContactConvexHeightfield(polyData, &convexMap, minMargin, hullAABB, shapHeightField, transform0, transform1, params.mContactDistance, contactBuffer, convexScaling, 
+		return Gu::PCMContactConvexHeightfield(polyData, &convexMap, minMargin, hullAABB, shapHeightField, transform0, transform1, params.mContactDistance, params.mPCMThresholdScale, contactBuffer, convexScaling, 
 			idtScaleConvex, multiManifold, renderOutput);
 	}
 }  
@@ -263,7 +263,7 @@ bool Gu::pcmContactBoxHeightField(GU_CONTACT_METHOD_ARGS)
 	//SupportLocalImpl<Gu::BoxV> boxMap(boxV, boxTransform, identity, identity);
 	SupportLocalImpl<Gu::BoxV> boxMap(boxV, boxTransform, identity, identity, true);
 
-	return Gu::PCMContactConvexHeightfield(polyData, &boxMap, minMargin, hullAABB, shapHeightField, transform0, transform1, params.mContactDistance, contactBuffer, 
+	return Gu::PCMContactConvexHeightfield(polyData, &boxMap, minMargin, hullAABB, shapHeightField, transform0, transform1, params.mContactDistance, params.mPCMThresholdScale, contactBuffer, 
 		idtScaling, true, multiManifold, renderOutput);
 }
 }
@@ -102,7 +102,7 @@ public:
 
 bool Gu::PCMContactConvexMesh(const PolygonalData& polyData, SupportLocal* polyMap, const Ps::aos::FloatVArg minMargin, const PxBounds3& hullAABB, const PxTriangleMeshGeometryLL& shapeMesh,
 						const PxTransform& transform0, const PxTransform& transform1,
-						PxReal contactDistance, ContactBuffer& contactBuffer,
+						PxReal contactDistance, PxReal thresholdScale, ContactBuffer& contactBuffer,
 						const Cm::FastVertex2ShapeScaling& convexScaling, const Cm::FastVertex2ShapeScaling& meshScaling,
 						bool idtConvexScale, bool idtMeshScale, Gu::MultiplePersistentContactManifold& multiManifold,
 						Cm::RenderOutput* renderOutput)
@@ -123,7 +123,7 @@ bool Gu::PCMContactConvexMesh(const PolygonalData& polyData, SupportLocal* polyM
 	const PsTransformV curTransform = meshTransform.transformInv(convexTransform);
 	
 	
-	if(multiManifold.invalidate(curTransform, minMargin))
+	if(multiManifold.invalidate(curTransform, minMargin, FLoad(thresholdScale)))
 	{
 		const FloatV replaceBreakingThreshold = FMul(minMargin, FLoad(0.05f));
 		multiManifold.mNumManifolds = 0;
@@ -206,13 +206,13 @@ bool Gu::pcmContactConvexMesh(GU_CONTACT_METHOD_ARGS)
 	if(idtScaleConvex)
 	{
 		SupportLocalImpl<Gu::ConvexHullNoScaleV> convexMap(static_cast<ConvexHullNoScaleV&>(convexHull), convexTransform, convexHull.vertex2Shape, convexHull.shape2Vertex, true);
-		return Gu::PCMContactConvexMesh(polyData, &convexMap, minMargin, hullAABB, shapeMesh,transform0,transform1, params.mContactDistance, contactBuffer, convexScaling,  
+		return Gu::PCMContactConvexMesh(polyData, &convexMap, minMargin, hullAABB, shapeMesh,transform0,transform1, params.mContactDistance, params.mPCMThresholdScale, contactBuffer, convexScaling,  
 			meshScaling, idtScaleConvex, idtScaleMesh, multiManifold, renderOutput);
 	}
 	else
 	{
 		SupportLocalImpl<Gu::ConvexHullV> convexMap(convexHull, convexTransform, convexHull.vertex2Shape, convexHull.shape2Vertex, false);
-		return Gu::PCMContactConvexMesh(polyData, &convexMap, minMargin, hullAABB, shapeMesh,transform0,transform1, params.mContactDistance, contactBuffer, convexScaling,  
+		return Gu::PCMContactConvexMesh(polyData, &convexMap, minMargin, hullAABB, shapeMesh,transform0,transform1, params.mContactDistance, params.mPCMThresholdScale, contactBuffer, convexScaling,  
 			meshScaling, idtScaleConvex, idtScaleMesh, multiManifold, renderOutput);
 	}
 }
@@ -252,7 +252,7 @@ bool Gu::pcmContactBoxMesh(GU_CONTACT_METHOD_ARGS)
 	Mat33V identity =  M33Identity();
 	SupportLocalImpl<BoxV> boxMap(boxV, boxTransform, identity, identity, true);
 
-	return Gu::PCMContactConvexMesh(polyData, &boxMap, minMargin, hullAABB, shapeMesh,transform0,transform1, params.mContactDistance, contactBuffer, idtScaling,  meshScaling, 
+	return Gu::PCMContactConvexMesh(polyData, &boxMap, minMargin, hullAABB, shapeMesh,transform0,transform1, params.mContactDistance, params.mPCMThresholdScale, contactBuffer, idtScaling,  meshScaling, 
 		true, idtMeshScale, multiManifold, renderOutput);
 }
 
@@ -130,6 +130,7 @@ public:
 		PxU32* inds0 = indices;
 
 		const PxU8 nextInd[] = {2,0,1};
+		const Gu::HeightField& hf = mHfUtil.getHeightField();
 
 		for(PxU32 i = 0; i < nbPasses; ++i)
 		{
@@ -156,6 +157,10 @@ public:
 
 					if (adjInds[a] != 0xFFFFFFFF)
 					{
+						// coplanar and concave edges are known from the heights, no need to fetch the adjacent triangle
+						if(!hf.isActiveEdgeCandidate(hf.getEdgeIndex(vertIndices[a], vertIndices[(a + 1) % 3])))
+							continue;
+
 						PxTriangle adjTri;
 						PxU32 inds[3];
 						mHfUtil.getTriangle(mHeightfieldTransform, adjTri, inds, NULL, adjInds[a], false, false);
@@ -88,7 +88,7 @@ bool pcmContactPlaneCapsule(GU_CONTACT_METHOD_ARGS)
 	const PxU32 newContacts = manifold.mNumContacts;
 	const bool bLostContacts = (newContacts != initialContacts);//((initialContacts == 0) || (newContacts != initialContacts));
 
-	if(bLostContacts || manifold.invalidate_PrimitivesPlane(aToB, radius, FLoad(0.02f)))  
+	if(bLostContacts || manifold.invalidate_PrimitivesPlane(aToB, radius, FLoad(0.02f), FLoad(params.mPCMThresholdScale)))  
 	{
 		manifold.mNumContacts = 0;
 		manifold.setRelativeTransform(aToB);
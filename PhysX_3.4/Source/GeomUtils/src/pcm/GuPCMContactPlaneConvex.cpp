@@ -80,7 +80,7 @@ bool pcmContactPlaneConvex(GU_CONTACT_METHOD_ARGS)
 	const bool bLostContacts = (newContacts != initialContacts);//((initialContacts == 0) || (newContacts != initialContacts));
 
 	
-	if(bLostContacts || manifold.invalidate_PrimitivesPlane(curTransf, convexMargin, FLoad(0.2f)))
+	if(bLostContacts || manifold.invalidate_PrimitivesPlane(curTransf, convexMargin, FLoad(0.2f), FLoad(params.mPCMThresholdScale)))
 	{
 		const PsMatTransformV aToB(curTransf);
 		const QuatV vQuat = QuatVLoadU(&shapeConvex.scale.rotation.x);
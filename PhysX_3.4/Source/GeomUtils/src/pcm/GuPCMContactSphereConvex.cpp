@@ -159,7 +159,7 @@ bool pcmContactSphereConvex(GU_CONTACT_METHOD_ARGS)
 	PX_UNUSED(bLostContacts);
 
 
-	if(bLostContacts || manifold.invalidate_SphereCapsule(curRTrans, minMargin))
+	if(bLostContacts || manifold.invalidate_SphereCapsule(curRTrans, minMargin, FLoad(params.mPCMThresholdScale)))
 	{
 
 		manifold.setRelativeTransform(curRTrans);
@@ -110,7 +110,7 @@ bool Gu::pcmContactSphereHeightField(GU_CONTACT_METHOD_ARGS)
 
 	// We must be in local space to use the cache
 
-	if(multiManifold.invalidate(curTransform, sphereRadius, FLoad(0.02f)))
+	if(multiManifold.invalidate(curTransform, sphereRadius, FLoad(0.02f), FLoad(params.mPCMThresholdScale)))
 	{
 		multiManifold.mNumManifolds = 0;
 		multiManifold.setRelativeTransform(curTransform);
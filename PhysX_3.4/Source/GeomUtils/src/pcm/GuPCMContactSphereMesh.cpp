@@ -112,7 +112,7 @@ bool Gu::pcmContactSphereMesh(GU_CONTACT_METHOD_ARGS)
 	const PsTransformV curTransform = meshTransform.transformInv(sphereTransform);
 	
 	// We must be in local space to use the cache
-	if(multiManifold.invalidate(curTransform, sphereRadius, FLoad(0.02f)))
+	if(multiManifold.invalidate(curTransform, sphereRadius, FLoad(0.02f), FLoad(params.mPCMThresholdScale)))
 	{
 		const FloatV replaceBreakingThreshold = FMul(sphereRadius, FLoad(0.001f));
 		const PxVec3 sphereCenterShape1Space = transform1.transformInv(transform0.p);
@@ -47,7 +47,7 @@ namespace Gu
 						const PxBounds3& hullAABB, 
 						const PxTriangleMeshGeometryLL& shapeMesh,
 						const PxTransform& transform0, const PxTransform& transform1,
-						PxReal contactDistance, Gu::ContactBuffer& contactBuffer,
+						PxReal contactDistance, PxReal thresholdScale, Gu::ContactBuffer& contactBuffer,
 						const Cm::FastVertex2ShapeScaling& convexScaling, const Cm::FastVertex2ShapeScaling& meshScaling,
 						bool idtConvexScale, bool idtMeshScale, Gu::MultiplePersistentContactManifold& multiManifold,
 						Cm::RenderOutput* renderOutput);
@@ -58,7 +58,7 @@ namespace Gu
 						const PxBounds3& hullAABB, 
 						const PxHeightFieldGeometry& shapeHeightfield,
 						const PxTransform& transform0, const PxTransform& transform1,
-						PxReal contactDistance, Gu::ContactBuffer& contactBuffer,
+						PxReal contactDistance, PxReal thresholdScale, Gu::ContactBuffer& contactBuffer,
 						const Cm::FastVertex2ShapeScaling& convexScaling, bool idtConvexScale, Gu::MultiplePersistentContactManifold& multiManifold,
 						Cm::RenderOutput* renderOutput);
 
@@ -77,6 +77,15 @@ extern const PxF32 invalidateQuatThresholds[5];
 extern const PxF32 invalidateThresholds2[3]; 
 extern const PxF32 invalidateQuatThresholds2[3];
 
+//Scales the rotational thresholds the same way as the translational ones: the allowed deviation of the quat dot product from 1 is
+//multiplied by the scale
+PX_FORCE_INLINE Ps::aos::FloatV scaleQuatThreshold(const Ps::aos::FloatVArg thresholdQ, const Ps::aos::FloatVArg thresholdScale)
+{
+	using namespace Ps::aos;
+	const FloatV one = FOne();
+	return FSub(one, FMul(FSub(one, thresholdQ), thresholdScale));
+}
+
 
 Ps::aos::Mat33V findRotationMatrixFromZAxis(const Ps::aos::Vec3VArg to);
 
@@ -232,15 +241,15 @@ public:
 
 	//This is used for the box/convexhull vs box/convexhull contact gen to decide whether the relative movement of a pair of objects are 
 	//small enough. In this case, we can skip the collision detection all together
-	PX_FORCE_INLINE PxU32 invalidate_BoxConvex(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin)
+	PX_FORCE_INLINE PxU32 invalidate_BoxConvex(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg thresholdScale)
 	{
 		using namespace Ps::aos;
 		PX_ASSERT(mNumContacts <= GU_MANIFOLD_CACHE_SIZE);
 		const FloatV ratio = FLoad(invalidateThresholds[mNumContacts]);
-		const FloatV thresholdP = FMul(minMargin, ratio);
+		const FloatV thresholdP = FMul(FMul(minMargin, ratio), thresholdScale);
 		const FloatV deltaP = maxTransformPositionDelta(curRTrans.p);
 
-		const FloatV thresholdQ = FLoad(invalidateQuatThresholds[mNumContacts]);
+		const FloatV thresholdQ = scaleQuatThreshold(FLoad(invalidateQuatThresholds[mNumContacts]), thresholdScale);
 		const FloatV deltaQ = QuatDot(curRTrans.q, mRelativeTransform.q);
 		const BoolV con = BOr(FIsGrtr(deltaP, thresholdP), FIsGrtr(thresholdQ, deltaQ));
 
@@ -249,16 +258,16 @@ public:
 
 	//This is used for the sphere/capsule vs other primitives contact gen to decide whether the relative movement of a pair of objects are 
 	//small enough. In this case, we can skip the collision detection all together
-	PX_FORCE_INLINE PxU32 invalidate_SphereCapsule(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin)
+	PX_FORCE_INLINE PxU32 invalidate_SphereCapsule(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg thresholdScale)
 	{
 		using namespace Ps::aos;
 		PX_ASSERT(mNumContacts <= 2);
 		const FloatV ratio = FLoad(invalidateThresholds2[mNumContacts]);
 		
-		const FloatV thresholdP = FMul(minMargin, ratio);
+		const FloatV thresholdP = FMul(FMul(minMargin, ratio), thresholdScale);
 		const FloatV deltaP = maxTransformPositionDelta(curRTrans.p);
 
-		const FloatV thresholdQ = FLoad(invalidateQuatThresholds2[mNumContacts]);
+		const FloatV thresholdQ = scaleQuatThreshold(FLoad(invalidateQuatThresholds2[mNumContacts]), thresholdScale);
 		const FloatV deltaQ = QuatDot(curRTrans.q, mRelativeTransform.q);
 		const BoolV con = BOr(FIsGrtr(deltaP, thresholdP), FIsGrtr(thresholdQ, deltaQ));
 
@@ -267,13 +276,13 @@ public:
 
 	//This is used for plane contact gen to decide whether the relative movement of a pair of objects are small enough. In this case, 
 	//we can skip the collision detection all together
-	PX_FORCE_INLINE PxU32 invalidate_PrimitivesPlane(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg ratio)
+	PX_FORCE_INLINE PxU32 invalidate_PrimitivesPlane(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg ratio, const Ps::aos::FloatVArg thresholdScale)
 	{
 		using namespace Ps::aos;
-		const FloatV thresholdP = FMul(minMargin, ratio);
+		const FloatV thresholdP = FMul(FMul(minMargin, ratio), thresholdScale);
 		const FloatV deltaP = maxTransformPositionDelta(curRTrans.p);
 	
-		const FloatV thresholdQ = FLoad(0.9998f);//about 1 degree
+		const FloatV thresholdQ = scaleQuatThreshold(FLoad(0.9998f), thresholdScale);//about 1 degree
 		const FloatV deltaQ = QuatDot(curRTrans.q, mRelativeTransform.q);
 		const BoolV con = BOr(FIsGrtr(deltaP, thresholdP), FIsGrtr(thresholdQ, deltaQ));
 
@@ -349,6 +358,8 @@ public:
 	Ps::aos::Vec3V getWorldNormal(const Ps::aos::PsTransformV& trB);
 	//get the average normal in the manifold in local B object space
 	Ps::aos::Vec3V getLocalNormal();
+	//get the direction GJK starts from when there is no warm-start simplex: the manifold normal if contacts are left, otherwise defaultDir
+	Ps::aos::Vec3V getInitialSearchDir(const Ps::aos::Vec3VArg defaultDir);
 	
 	void drawManifold(Cm::RenderOutput& out, const Ps::aos::PsTransformV& trA, const Ps::aos::PsTransformV& trB);
 	void drawManifold(Cm::RenderOutput& out, const Ps::aos::PsTransformV& trA, const Ps::aos::PsTransformV& trB, const Ps::aos::FloatVArg radius);
@@ -530,23 +541,23 @@ public:
 		return V4ExtractMax(delta);
 	}
 
-	PX_FORCE_INLINE PxU32 invalidate(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg ratio)
+	PX_FORCE_INLINE PxU32 invalidate(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg ratio, const Ps::aos::FloatVArg thresholdScale)
 	{
 		using namespace Ps::aos;
 		
-		const FloatV thresholdP = FMul(minMargin, ratio);
+		const FloatV thresholdP = FMul(FMul(minMargin, ratio), thresholdScale);
 		const FloatV deltaP = maxTransformPositionDelta(curRTrans.p);
-		const FloatV thresholdQ = FLoad(0.9998f);//about 1 degree
+		const FloatV thresholdQ = scaleQuatThreshold(FLoad(0.9998f), thresholdScale);//about 1 degree
 		const FloatV deltaQ = QuatDot(curRTrans.q, mRelativeTransform.q);
 		const BoolV con = BOr(FIsGrtr(deltaP, thresholdP), FIsGrtr(thresholdQ, deltaQ));
 
 		return BAllEqTTTT(con);
 	}
 
-	PX_FORCE_INLINE PxU32 invalidate(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin)
+	PX_FORCE_INLINE PxU32 invalidate(const Ps::aos::PsTransformV& curRTrans, const Ps::aos::FloatVArg minMargin, const Ps::aos::FloatVArg thresholdScale)
 	{
 		using namespace Ps::aos;
-		return invalidate(curRTrans, minMargin, FLoad(0.2f));
+		return invalidate(curRTrans, minMargin, FLoad(0.2f), thresholdScale);
 	}
 
 	/*
@@ -764,6 +775,15 @@ PX_FORCE_INLINE Ps::aos::Vec3V PersistentContactManifold::getLocalNormal()
 	return V3Normalize(Vec3V_From_Vec4V(nPen));
 }
 
+/*
+	This function returns the initial search direction for GJK in local B space. Without warm-start points, GJK starts from the direction between the shapes' centers, which
+	can take several iterations to find the separating axis of flat or elongated shapes. The normal of the contacts kept from the previous frames is a better guess.
+*/
+PX_FORCE_INLINE Ps::aos::Vec3V PersistentContactManifold::getInitialSearchDir(const Ps::aos::Vec3VArg defaultDir)
+{
+	return mNumContacts ? getLocalNormal() : defaultDir;
+}
+
 /*
 	This function recalculates the contacts in the manifold based on the current relative transform between a pair of objects. If the recalculated contacts are within some threshold,
 	we will keep the contacts; Otherwise, we will remove the contacts.
@@ -42,6 +42,18 @@ namespace physx
 		PxU16 mMaterialIndex1;
 	};
 
+	// friction and restitution of a material pair with the combine modes applied, see PxsMaterialCombiner
+	struct PxsCombinedMaterialData
+	{
+		PxReal	staticFriction;
+		PxReal	dynamicFriction;
+		PxReal	restitution;
+		PxU32	flags;	//PxMaterialFlag::eDISABLE_FRICTION, PxMaterialFlag::eDISABLE_STRONG_FRICTION.
+	};
+
+	// the combined materials are precomputed for the pairs of the first materials only, the table grows with the square of the count
+	#define PXS_MAX_COMBINED_MATERIALS	256
+
 	class PxsMaterialManager 
 	{
 	public:
@@ -54,10 +66,13 @@ namespace physx
 			{
 				materials[i].setMaterialIndex(MATERIAL_INVALID_HANDLE);
 			}
+			combinedMaterials = NULL;
+			combinedMaterialCount = 0;
 		}
 
 		~PxsMaterialManager()
 		{
+			physx::shdfnd::AlignedAllocator<16>().deallocate(combinedMaterials);
 			physx::shdfnd::AlignedAllocator<16>().deallocate(materials);
 		}
 
@@ -66,11 +81,13 @@ namespace physx
 			const PxU32 materialIndex = mat->getMaterialIndex();
 			resize(materialIndex+1);
 			materials[materialIndex] = *mat;
+			updateCombinedMaterials(materialIndex);
 		}
 
 		void updateMaterial(PxsMaterialCore* mat)
 		{
 			materials[mat->getMaterialIndex()] =*mat;
+			updateCombinedMaterials(mat->getMaterialIndex());
 		}
 
 		void removeMaterial(PxsMaterialCore* mat)
@@ -89,6 +106,13 @@ namespace physx
 			return maxMaterials;
 		}
 
+		// NULL if the pair is not in the table, the materials have to be combined at runtime then
+		PX_FORCE_INLINE const PxsCombinedMaterialData* getCombinedMaterial(const PxU32 index0, const PxU32 index1)const
+		{
+			const PxU32 count = combinedMaterialCount;
+			return (index0 < count && index1 < count) ? &combinedMaterials[index0*count + index1] : NULL;
+		}
+
 		void resize(PxU32 minValueForMax)
 		{			
 			if(maxMaterials>=minValueForMax)
@@ -115,6 +139,13 @@ namespace physx
 		PxsMaterialCore* materials;//make sure materials's start address is 16 bytes align
 		PxU32 maxMaterials;
 		PxU32 mPad[2];
+
+	private:
+		// recomputes the pairs of a material that got added or changed, implemented in PxsMaterialCombiner.cpp
+		void updateCombinedMaterials(PxU32 materialIndex);
+
+		PxsCombinedMaterialData* combinedMaterials;	//combinedMaterialCount x combinedMaterialCount entries
+		PxU32 combinedMaterialCount;
 	};
 
 	class PxsMaterialManagerIterator
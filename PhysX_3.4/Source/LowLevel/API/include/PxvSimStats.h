@@ -88,6 +88,11 @@ struct PxvSimStats
 
 	PxU32	mNbModifiedContactPairs	[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
 
+	// PCM manifold outcomes of the discrete pairs, see PxSimulationStatistics::ePCM_MANIFOLD_HITS
+	PxU32	mNbPCMManifoldHits			[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+	PxU32	mNbPCMManifoldRefreshes		[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+	PxU32	mNbPCMManifoldRegenerations	[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+
 	PxU32	mNbDiscreteContactPairsTotal;		// PT: sum of mNbDiscreteContactPairs, i.e. number of pairs reaching narrow phase
 	PxU32	mNbDiscreteContactPairsWithCacheHits;
 	PxU32	mNbDiscreteContactPairsWithContacts;
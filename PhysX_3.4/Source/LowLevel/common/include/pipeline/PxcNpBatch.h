@@ -31,6 +31,7 @@
 #define PXC_NP_BATCH_H
 
 #include "PxvConfig.h"
+#include "foundation/PxTransform.h"
 
 namespace physx
 {
@@ -58,8 +59,22 @@ namespace Gu
 	class PxgGpuNarrowphaseCoreInterface;
 }
 
-void PxcDiscreteNarrowPhase(PxcNpThreadContext& context, const PxcNpWorkUnit& cmInput, Gu::Cache& cache, PxsContactManagerOutput& output);
-void PxcDiscreteNarrowPhasePCM(PxcNpThreadContext& context, const PxcNpWorkUnit& cmInput, Gu::Cache& cache, PxsContactManagerOutput& output);
+/**
+\brief Relative pose of a pair against static geometry at its last contact generation.
+
+While neither the pose nor the contact distance change, the contact generation is skipped and the previous contacts are kept.
+This mostly helps bodies resting on the ground until they fall asleep.
+*/
+struct PxcNpFrozenPair
+{
+	PxTransform	mPose;				// pose of shape0 in the space of shape1
+	PxReal		mContactDistance;	// negative while the pose is not valid
+
+	PX_FORCE_INLINE void invalidate()	{ mContactDistance = -1.0f;	}
+};
+
+void PxcDiscreteNarrowPhase(PxcNpThreadContext& context, const PxcNpWorkUnit& cmInput, Gu::Cache& cache, PxsContactManagerOutput& output, PxcNpFrozenPair& frozenPair);
+void PxcDiscreteNarrowPhasePCM(PxcNpThreadContext& context, const PxcNpWorkUnit& cmInput, Gu::Cache& cache, PxsContactManagerOutput& output, PxcNpFrozenPair& frozenPair);
 }
 
 #endif
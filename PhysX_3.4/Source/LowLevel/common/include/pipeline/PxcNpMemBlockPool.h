@@ -63,6 +63,7 @@ public:
 	PxU32			getMaxUsedBlockCount() const;
 	PxU32			getPeakConstraintBlockCount() const;
 	void			releaseUnusedBlocks();
+	void			trimUnusedBlocks();
 
 	PxcNpMemBlock*	acquireConstraintBlock();
 	PxcNpMemBlock*	acquireConstraintBlock(PxcNpMemBlockArray& memBlocks);
@@ -103,6 +104,8 @@ private:
 	PxU32					mInitialBlocks;
 	PxU32					mUsedBlocks;
 	PxU32					mMaxUsedBlocks;
+	PxU32					mFrameMaxUsedBlocks;	// peak since the last trimUnusedBlocks
+	PxReal					mRetainedBlocks;		// decaying peak, the unused blocks above it are freed
 	PxcNpMemBlock*			mScratchBlockAddr;
 	PxU32					mNbScratchBlocks;
 	PxcScratchAllocator&	mScratchAllocator;
@@ -110,6 +113,7 @@ private:
 	PxU32					mPeakConstraintAllocations;
 	PxU32					mConstraintAllocations;
 
+	void			reserveTracking(PxU32 blockCount);
 	PxcNpMemBlock*	acquire(PxcNpMemBlockArray& trackingArray, PxU32* allocationCount = NULL, PxU32* peakAllocationCount = NULL, bool isScratchAllocation = false);
 	void			release(PxcNpMemBlockArray& deadArray, PxU32* allocationCount = NULL);
 };
@@ -155,6 +155,9 @@ public:
 #if PX_ENABLE_SIM_STATS
 					PxU32						mDiscreteContactPairs	[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
 					PxU32						mModifiedContactPairs	[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+					PxU32						mPCMManifoldHits		[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+					PxU32						mPCMManifoldRefreshes	[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+					PxU32						mPCMManifoldRegenerations[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
 #endif
 					PxcContactBlockStream 		mContactBlockStream;		// constraint block pool
 					PxcNpCacheStreamPair		mNpCacheStreamPair;			// narrow phase pairwise data cache
@@ -174,9 +177,11 @@ public:
 					PxsTransformCache*			mTransformCache;
 					PxReal*						mContactDistance;
 					bool						mPCM;
+					bool						mAdaptivePCMThresholds;	// scale the PCM reuse thresholds up for resting pairs
 					bool						mContactCache;
 					bool						mCreateContactStream;	// flag to enforce that contacts are stored persistently per workunit. Used for PVD.
 					bool						mCreateAveragePoint;	// flag to enforce whether we create average points
+					bool						mCompactContacts;		// quantize the points of the contact streams, see PxSceneFlag::eENABLE_COMPACT_CONTACTS
 #if PX_ENABLE_SIM_STATS
 					PxU32						mCompressedCacheSize;
 					PxU32						mNbDiscreteContactPairsWithCacheHits;
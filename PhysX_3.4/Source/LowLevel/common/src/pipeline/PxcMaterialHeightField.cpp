@@ -49,8 +49,30 @@ physx::PxU32 physx::GetMaterialIndex(const Gu::HeightFieldData* hfData, PxU32 tr
 	const bool isFirstTriangle = (triangleIndex & 0x1) == 0;
 
 	//get sample
-	const PxHeightFieldSample* hf = &hfData->samples[sampleIndex];
-	return isFirstTriangle ? hf->materialIndex0 : hf->materialIndex1;
+	const PxHeightFieldSample hf = hfData->getSample(sampleIndex);
+	return isFirstTriangle ? hf.materialIndex0 : hf.materialIndex1;
+}
+
+// Contacts of the same triangle come in a row, the sample is only fetched once per triangle
+static PX_FORCE_INLINE void getTriangleMaterials(const PxHeightFieldGeometryLL& hfGeom, const ContactBuffer& contactBuffer, const PxU32 index, PxsMaterialInfo* materialInfo)
+{
+	const PxU16* materialIndices = hfGeom.materials.indices;
+	const Gu::HeightFieldData* hf = hfGeom.heightFieldData;
+
+	PxU32 lastFaceIndex = 0;
+	PxU16 materialIndex = 0;
+	for(PxU32 i=0; i< contactBuffer.count; ++i)
+	{
+		const PxU32 faceIndex = contactBuffer.contacts[i].internalFaceIndex1;
+		if(i == 0 || faceIndex != lastFaceIndex)
+		{
+			lastFaceIndex = faceIndex;
+			const PxU32 localMaterialIndex = GetMaterialIndex(hf, faceIndex);
+			PX_ASSERT(localMaterialIndex<hfGeom.materials.numIndices);
+			materialIndex = materialIndices[localMaterialIndex];
+		}
+		(&materialInfo[i].mMaterialIndex0)[index] = materialIndex;
+	}
 }
 
 bool physx::PxcGetMaterialHeightField(const PxsShapeCore* shape, const PxU32 index, PxcNpThreadContext& context, PxsMaterialInfo* materialInfo)
@@ -68,16 +90,7 @@ bool physx::PxcGetMaterialHeightField(const PxsShapeCore* shape, const PxU32 ind
 	}
 	else
 	{
-		const PxU16* materialIndices = hfGeom.materials.indices;
-			
-		const Gu::HeightFieldData* hf = hfGeom.heightFieldData;
-		
-		for(PxU32 i=0; i< contactBuffer.count; ++i)
-		{
-			const Gu::ContactPoint& contact = contactBuffer.contacts[i];
-			const PxU32 localMaterialIndex = GetMaterialIndex(hf, contact.internalFaceIndex1);
-			(&materialInfo[i].mMaterialIndex0)[index] = materialIndices[localMaterialIndex];
-		}
+		getTriangleMaterials(hfGeom, contactBuffer, index, materialInfo);
 	}
 	return true;
 }
@@ -96,20 +109,10 @@ bool physx::PxcGetMaterialShapeHeightField(const PxsShapeCore* shape0, const Pxs
 	}
 	else
 	{
-		const PxU16* materialIndices = hfGeom.materials.indices;
-			
-		const Gu::HeightFieldData* hf = hfGeom.heightFieldData;
-		
 		for(PxU32 i=0; i< contactBuffer.count; ++i)
-		{
-			const Gu::ContactPoint& contact = contactBuffer.contacts[i];
 			materialInfo[i].mMaterialIndex0 = shape0->materialIndex;
-			//contact.featureIndex0 = shape0->materialIndex;
-			const PxU32 localMaterialIndex = GetMaterialIndex(hf, contact.internalFaceIndex1);
-			//contact.featureIndex1 = materialIndices[localMaterialIndex];
-			PX_ASSERT(localMaterialIndex<hfGeom.materials.numIndices);
-			materialInfo[i].mMaterialIndex1 = materialIndices[localMaterialIndex];
-		}
+
+		getTriangleMaterials(hfGeom, contactBuffer, 1, materialInfo);
 	}
 	return true;
 }
@@ -43,6 +43,26 @@ namespace physx
 	bool PxcGetMaterialMesh(const PxsShapeCore* shape, const PxU32 index,  PxcNpThreadContext& context, PxsMaterialInfo* materialInfo);
 }
 
+// Contacts of the same triangle come in a row, the material is only looked up once per triangle
+static PX_FORCE_INLINE void getTriangleMaterials(const PxTriangleMeshGeometryLL& shapeMesh, const ContactBuffer& contactBuffer, const PxU32 index, PxsMaterialInfo* materialInfo)
+{
+	const PxU16* eaMaterialIndices = shapeMesh.materialIndices;
+	const PxU16* materialIndices = shapeMesh.materials.indices;
+
+	PxU32 lastFaceIndex = 0;
+	PxU16 materialIndex = 0;
+	for(PxU32 i=0; i< contactBuffer.count; ++i)
+	{
+		const PxU32 faceIndex = contactBuffer.contacts[i].internalFaceIndex1;
+		if(i == 0 || faceIndex != lastFaceIndex)
+		{
+			lastFaceIndex = faceIndex;
+			materialIndex = materialIndices[eaMaterialIndices[faceIndex]];
+		}
+		(&materialInfo[i].mMaterialIndex0)[index] = materialIndex;
+	}
+}
+
 bool physx::PxcGetMaterialMesh(const PxsShapeCore* shape, const PxU32 index, PxcNpThreadContext& context, PxsMaterialInfo* materialInfo)
 {
 	PX_ASSERT(index == 1);
@@ -58,15 +78,7 @@ bool physx::PxcGetMaterialMesh(const PxsShapeCore* shape, const PxU32 index, Pxc
 	}
 	else
 	{
-		for(PxU32 i=0; i< contactBuffer.count; ++i)
-		{
-
-			Gu::ContactPoint& contact = contactBuffer.contacts[i];
-			const PxU16* eaMaterialIndices = shapeMesh.materialIndices;
-
-			const PxU32 localMaterialIndex = eaMaterialIndices[contact.internalFaceIndex1];//shapeMesh.triangleMesh->getTriangleMaterialIndex(contact.featureIndex1);
-			(&materialInfo[i].mMaterialIndex0)[index] = shapeMesh.materials.indices[localMaterialIndex];
-		}
+		getTriangleMaterials(shapeMesh, contactBuffer, index, materialInfo);
 	}
 	return true;
 }
@@ -87,20 +99,10 @@ bool physx::PxcGetMaterialShapeMesh(const PxsShapeCore* shape0, const PxsShapeCo
 	}
 	else
 	{
-
 		for(PxU32 i=0; i< contactBuffer.count; ++i)
-		{
-
-			Gu::ContactPoint& contact = contactBuffer.contacts[i];
-			//contact.featureIndex0 = shape0->materialIndex;
 			materialInfo[i].mMaterialIndex0 = shape0->materialIndex;
-			const PxU16* eaMaterialIndices = shapeMesh.materialIndices;
 
-			const PxU32 localMaterialIndex = eaMaterialIndices[contact.internalFaceIndex1];//shapeMesh.triangleMesh->getTriangleMaterialIndex(contact.featureIndex1);
-			//contact.featureIndex1 = shapeMesh.materials.indices[localMaterialIndex];
-			materialInfo[i].mMaterialIndex1 = shapeMesh.materials.indices[localMaterialIndex];
-
-		}
+		getTriangleMaterials(shapeMesh, contactBuffer, 1, materialInfo);
 	}
 
 	return true;
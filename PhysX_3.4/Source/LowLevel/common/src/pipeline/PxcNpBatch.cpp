@@ -81,6 +81,46 @@ static PX_FORCE_INLINE void updateDiscreteContactStats(PxcNpThreadContext& conte
 #endif
 }
 
+#if PX_ENABLE_SIM_STATS
+static PX_FORCE_INLINE void updatePCMManifoldStats(PxcNpThreadContext& context, PxGeometryType::Enum type0, PxGeometryType::Enum type1,
+	const Ps::aos::PsTransformV& previousTransform, const Ps::aos::PsTransformV& currentTransform, PxU32 previousNbContacts)
+{
+	using namespace Ps::aos;
+	PX_ASSERT(type0<=type1);
+
+	// The contact generation only stores a new relative transform when it discards the manifold
+	if(V3AllEq(previousTransform.p, currentTransform.p) && V4AllEq(previousTransform.q, currentTransform.q))
+		context.mPCMManifoldHits[type0][type1]++;
+	else if(previousNbContacts)
+		context.mPCMManifoldRefreshes[type0][type1]++;
+	else
+		context.mPCMManifoldRegenerations[type0][type1]++;
+}
+#endif
+
+// Bodies with a kinetic energy below this many times their sleep threshold count as resting for the adaptive PCM thresholds
+#define PCM_RESTING_ENERGY_SCALE	4.0f
+// Scale of the PCM reuse thresholds for pairs where both bodies are resting
+#define PCM_RESTING_THRESHOLD_SCALE	2.0f
+
+static PX_FORCE_INLINE bool isRestingBody(const PxsRigidCore* rigidCore, PxU16 flags, PxU16 bodyFlags)
+{
+	if(!(flags & bodyFlags))
+		return true;
+
+	// Mass-normalized energy, like the sleep check but without the inertia
+	const PxsBodyCore* bodyCore = static_cast<const PxsBodyCore*>(rigidCore);
+	const PxReal energy = 0.5f * (bodyCore->linearVelocity.magnitudeSquared() + bodyCore->angularVelocity.magnitudeSquared());
+	return energy < bodyCore->sleepThreshold * PCM_RESTING_ENERGY_SCALE;
+}
+
+static PX_FORCE_INLINE PxReal computePCMThresholdScale(const PxcNpWorkUnit& input)
+{
+	const bool resting0 = isRestingBody(input.rigidCore0, input.flags, PxcNpWorkUnitFlag::eDYNAMIC_BODY0 | PxcNpWorkUnitFlag::eARTICULATION_BODY0);
+	const bool resting1 = isRestingBody(input.rigidCore1, input.flags, PxcNpWorkUnitFlag::eDYNAMIC_BODY1 | PxcNpWorkUnitFlag::eARTICULATION_BODY1);
+	return (resting0 && resting1) ? PCM_RESTING_THRESHOLD_SCALE : 1.0f;
+}
+
 static bool copyBuffers(PxsContactManagerOutput& cmOutput, Gu::Cache& cache, PxcNpThreadContext& context, const bool useContactCache, const bool isMeshType)
 {
 	bool ret = false;
@@ -270,9 +310,46 @@ static bool finishContacts(const PxcNpWorkUnit& input, PxsContactManagerOutput&
 	return res;
 }
 
+template<bool useContactCacheT>
+static PX_FORCE_INLINE void keepPreviousContacts(PxcNpThreadContext& context, Gu::Cache& cache, PxsContactManagerOutput& output,
+										 const bool flip, PxGeometryType::Enum type0, PxGeometryType::Enum type1)
+{
+	if(flip)
+		Ps::swap(type0, type1);
+
+	const bool useContactCache = useContactCacheT ? context.mContactCache && g_CanUseContactCache[type0][type1] : false;
+	
+#if PX_ENABLE_SIM_STATS
+	if(output.nbContacts)
+		context.mNbDiscreteContactPairsWithContacts++;
+#endif
+	const bool isMeshType = type1 > PxGeometryType::eCONVEXMESH;
+	copyBuffers(output, cache, context, useContactCache, isMeshType);
+}
+
+// Largest motion of a pair against static geometry for which the previous contacts are kept, as a fraction of PxTolerancesScale::length
+#define FROZEN_PAIR_LINEAR_EPSILON	1e-4f
+// Same for the rotation, in radians
+#define FROZEN_PAIR_ANGULAR_EPSILON	1e-4f
+
+static PX_FORCE_INLINE bool isFrozenPair(const PxcNpFrozenPair& frozenPair, const PxTransform& pose, const PxReal contactDistance, const PxReal toleranceLength)
+{
+	if(frozenPair.mContactDistance != contactDistance)
+		return false;
+
+	const PxReal linearEpsilon = FROZEN_PAIR_LINEAR_EPSILON * toleranceLength;
+	if((pose.p - frozenPair.mPose.p).magnitudeSquared() > linearEpsilon * linearEpsilon)
+		return false;
+
+	// The imaginary part of the delta rotation is sin(angle/2)
+	const PxQuat deltaQ = frozenPair.mPose.q.getConjugate() * pose.q;
+	const PxReal halfAngularEpsilon = FROZEN_PAIR_ANGULAR_EPSILON * 0.5f;
+	return deltaQ.getImaginaryPart().magnitudeSquared() <= halfAngularEpsilon * halfAngularEpsilon;
+}
+
 template<bool useContactCacheT>
 static PX_FORCE_INLINE bool checkContactsMustBeGenerated(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output,
-										 const PxsCachedTransform* cachedTransform0, const PxsCachedTransform* cachedTransform1,
+										 PxcNpFrozenPair& frozenPair, const PxsCachedTransform* cachedTransform0, const PxsCachedTransform* cachedTransform1,
 										 const bool flip, PxGeometryType::Enum type0, PxGeometryType::Enum type1)
 {
 	PX_ASSERT(cachedTransform0->transform.isSane() && cachedTransform1->transform.isSane());
@@ -281,6 +358,19 @@ static PX_FORCE_INLINE bool checkContactsMustBeGenerated(PxcNpThreadContext& con
 	if(!(input.flags & PxcNpWorkUnitFlag::eDETECT_DISCRETE_CONTACT))
 		return false;
 
+	const PxReal contactDist0 = context.mContactDistance[input.mTransformCache0];
+	const PxReal contactDist1 = context.mContactDistance[input.mTransformCache1];
+	const PxReal contactDistance = contactDist0 + contactDist1;
+
+	// Pairs against static geometry keep their contacts while they don't move relative to it, which is what bodies
+	// resting on the ground do until their island falls asleep
+	const bool staticPair =	!(input.flags & (PxcNpWorkUnitFlag::eDYNAMIC_BODY0 | PxcNpWorkUnitFlag::eARTICULATION_BODY0))
+						||	!(input.flags & (PxcNpWorkUnitFlag::eDYNAMIC_BODY1 | PxcNpWorkUnitFlag::eARTICULATION_BODY1));
+	const bool canFreeze = staticPair && !(input.flags & PxcNpWorkUnitFlag::eMODIFIABLE_CONTACT);
+	PxTransform pose;
+	if(canFreeze)
+		pose = cachedTransform1->transform.transformInv(cachedTransform0->transform);
+
 	if(!(output.statusFlag & PxcNpWorkUnitStatusFlag::eDIRTY_MANAGER) && !(input.flags & PxcNpWorkUnitFlag::eMODIFIABLE_CONTACT))
 	{
 		const PxU32 body0Dynamic = PxU32(input.flags & PxcNpWorkUnitFlag::eDYNAMIC_BODY0);
@@ -289,35 +379,32 @@ static PX_FORCE_INLINE bool checkContactsMustBeGenerated(PxcNpThreadContext& con
 		const PxU32 active0 = PxU32(body0Dynamic && !cachedTransform0->isFrozen());
 		const PxU32 active1 = PxU32(body1Dynamic && !cachedTransform1->isFrozen());
 
-		if(!(active0 || active1))
+		if(!(active0 || active1) || (canFreeze && isFrozenPair(frozenPair, pose, contactDistance, context.mNarrowPhaseParams.mToleranceLength)))
 		{
-			if(flip)
-				Ps::swap(type0, type1);
-
-			const bool useContactCache = useContactCacheT ? context.mContactCache && g_CanUseContactCache[type0][type1] : false;
-			
-#if PX_ENABLE_SIM_STATS
-			if(output.nbContacts)
-				context.mNbDiscreteContactPairsWithContacts++;
-#endif
-			const bool isMeshType = type1 > PxGeometryType::eCONVEXMESH;
-			copyBuffers(output, cache, context, useContactCache, isMeshType);
+			keepPreviousContacts<useContactCacheT>(context, cache, output, flip, type0, type1);
 			return false;
 		}
 	}
 
 	output.statusFlag &= (~PxcNpWorkUnitStatusFlag::eDIRTY_MANAGER);
 
-	const PxReal contactDist0 = context.mContactDistance[input.mTransformCache0];
-	const PxReal contactDist1 = context.mContactDistance[input.mTransformCache1];
+	// The pose is compared with the one of the last contact generation, so a slow drift eventually regenerates the contacts
+	if(canFreeze)
+	{
+		frozenPair.mPose = pose;
+		frozenPair.mContactDistance = contactDistance;
+	}
+	else
+		frozenPair.invalidate();
+
 	//context.mNarrowPhaseParams.mContactDistance = shape0->contactOffset + shape1->contactOffset;
-	context.mNarrowPhaseParams.mContactDistance = contactDist0 + contactDist1;
+	context.mNarrowPhaseParams.mContactDistance = contactDistance;
 
 	return true;
 }
 
 template<bool useLegacyCodepath>
-static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output)
+static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output, PxcNpFrozenPair& frozenPair)
 {
 	PxGeometryType::Enum type0 = static_cast<PxGeometryType::Enum>(input.geomType0);
 	PxGeometryType::Enum type1 = static_cast<PxGeometryType::Enum>(input.geomType1);
@@ -327,7 +414,7 @@ static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, con
 	const PxsCachedTransform* cachedTransform0 = &context.mTransformCache->getTransformCache(input.mTransformCache0);
 	const PxsCachedTransform* cachedTransform1 = &context.mTransformCache->getTransformCache(input.mTransformCache1);
 
-	if(!checkContactsMustBeGenerated<useLegacyCodepath>(context, input, cache, output, cachedTransform0, cachedTransform1, flip, type0, type1))
+	if(!checkContactsMustBeGenerated<useLegacyCodepath>(context, input, cache, output, frozenPair, cachedTransform0, cachedTransform1, flip, type0, type1))
 		return;
 
 	PxsShapeCore* shape0 = const_cast<PxsShapeCore*>(input.shapeCore0);
@@ -345,6 +432,13 @@ static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, con
 	Gu::MultiplePersistentContactManifold& manifold = context.mTempManifold;
 	bool isMultiManifold = false;
 
+#if PX_ENABLE_SIM_STATS
+	// State of the manifold before the contact generation, to tell the reused manifolds from the regenerated ones
+	const Ps::aos::PsTransformV* manifoldTransform = NULL;
+	Ps::aos::PsTransformV previousManifoldTransform;
+	PxU32 previousManifoldContacts = 0;
+#endif
+
 	if(!useLegacyCodepath)
 	{
 		if(cache.isMultiManifold())
@@ -354,6 +448,10 @@ static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, con
 			uintptr_t address = uintptr_t(&cache.getMultipleManifold());
 			manifold.fromBuffer(reinterpret_cast<PxU8*>(address));
 			cache.setMultiManifold(&manifold);
+#if PX_ENABLE_SIM_STATS
+			manifoldTransform = &manifold.mRelativeTransform;
+			previousManifoldContacts = manifold.mNumTotalContacts;
+#endif
 		}
 		else if(cache.isManifold())
 		{
@@ -361,7 +459,17 @@ static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, con
 			Ps::prefetch(address);
 			Ps::prefetch(address, 128);
 			Ps::prefetch(address, 256);
+#if PX_ENABLE_SIM_STATS
+			manifoldTransform = &cache.getManifold().mRelativeTransform;
+			previousManifoldContacts = cache.getManifold().mNumContacts;
+#endif
 		}
+
+#if PX_ENABLE_SIM_STATS
+		if(manifoldTransform)
+			previousManifoldTransform = *manifoldTransform;
+#endif
+		context.mNarrowPhaseParams.mPCMThresholdScale = context.mAdaptivePCMThresholds ? computePCMThresholdScale(input) : 1.0f;
 	}
 
 	updateDiscreteContactStats(context, type0, type1);
@@ -402,6 +510,11 @@ static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, con
 		PX_ASSERT(conMethod);
 
 		conMethod(shape0->geometry, shape1->geometry, *tm0, *tm1, context.mNarrowPhaseParams, cache, context.mContactBuffer, &context.mRenderOutput);
+
+#if PX_ENABLE_SIM_STATS
+		if(manifoldTransform)
+			updatePCMManifoldStats(context, type0, type1, previousManifoldTransform, *manifoldTransform, previousManifoldContacts);
+#endif
 	}
 
 	const PxcGetMaterialMethod materialMethod = g_GetMaterialMethodTable[type0][type1];
@@ -431,15 +544,17 @@ static PX_FORCE_INLINE void discreteNarrowPhase(PxcNpThreadContext& context, con
 	}
 
 	const bool isMeshType = type1 > PxGeometryType::eCONVEXMESH; 
-	finishContacts(input, output, context, materialInfo, isMeshType);
+	// Contacts lost to a full buffer must not be kept
+	if(!finishContacts(input, output, context, materialInfo, isMeshType))
+		frozenPair.invalidate();
 }
 
-void physx::PxcDiscreteNarrowPhase(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output)
+void physx::PxcDiscreteNarrowPhase(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output, PxcNpFrozenPair& frozenPair)
 {
-	discreteNarrowPhase<true>(context, input, cache, output);
+	discreteNarrowPhase<true>(context, input, cache, output, frozenPair);
 }
 
-void physx::PxcDiscreteNarrowPhasePCM(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output)
+void physx::PxcDiscreteNarrowPhasePCM(PxcNpThreadContext& context, const PxcNpWorkUnit& input, Gu::Cache& cache, PxsContactManagerOutput& output, PxcNpFrozenPair& frozenPair)
 {
-	discreteNarrowPhase<false>(context, input, cache, output);
+	discreteNarrowPhase<false>(context, input, cache, output, frozenPair);
 }
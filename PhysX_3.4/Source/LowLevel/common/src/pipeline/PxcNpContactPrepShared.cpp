@@ -42,6 +42,7 @@ using namespace Gu;
 #include "PxcNpContactPrepShared.h"
 #include "PsAtomic.h"
 #include "PxsContactManagerState.h"
+#include "foundation/PxBounds3.h"
 
 #include "PsVecMath.h"
 using namespace physx;
@@ -57,6 +58,75 @@ static PX_FORCE_INLINE void copyContactPoint(PxContact* PX_RESTRICT point, const
 	point->separation = cp->separation;
 }
 
+// Computes the quantization of a compact stream, see PxSceneFlag::eENABLE_COMPACT_CONTACTS. The origin is the center of the points,
+// so the offsets and the separations all fit in 16 bits. Returns false if the points are not finite.
+static bool computeCompactQuantization(const Gu::ContactPoint* PX_RESTRICT contactPoints, PxU32 numContactPoints, PxVec3& origin, PxReal& quantum)
+{
+	PxBounds3 bounds = PxBounds3::empty();
+	PxReal maxSeparation = 0.0f;
+	for(PxU32 a = 0; a < numContactPoints; ++a)
+	{
+		bounds.include(contactPoints[a].point);
+		maxSeparation = PxMax(maxSeparation, PxAbs(contactPoints[a].separation));
+	}
+
+	origin = bounds.getCenter();
+	const PxVec3 extents = bounds.getExtents();
+	const PxReal range = PxMax(PxMax(extents.x, extents.y), PxMax(extents.z, maxSeparation));
+	// a bit of margin for the rounding of the center
+	quantum = range > 0.0f ? range / 32766.0f : 1.0f;
+	return origin.isFinite() && PxIsFinite(quantum);
+}
+
+static PX_FORCE_INLINE PxI16 quantizeContactValue(PxReal value, PxReal invQuantum)
+{
+	const PxReal q = value * invQuantum;
+	return PxI16(PxClamp(q >= 0.0f ? q + 0.5f : q - 0.5f, -32767.0f, 32767.0f));
+}
+
+// Writes the points of the non-modifiable streams, as PxContact or as PxCompactContact for the compact streams
+struct ContactPointWriter
+{
+	PxU8*	mPoint;
+	PxVec3	mOrigin;
+	PxReal	mInvQuantum;
+	bool	mCompact;
+
+	PX_FORCE_INLINE void write(const PxVec3& point, PxReal separation)
+	{
+		if(mCompact)
+		{
+			PxCompactContact* PX_RESTRICT contact = reinterpret_cast<PxCompactContact*>(mPoint);
+			const PxVec3 offset = point - mOrigin;
+			contact->offset[0] = quantizeContactValue(offset.x, mInvQuantum);
+			contact->offset[1] = quantizeContactValue(offset.y, mInvQuantum);
+			contact->offset[2] = quantizeContactValue(offset.z, mInvQuantum);
+			contact->separation = quantizeContactValue(separation, mInvQuantum);
+			mPoint += sizeof(PxCompactContact);
+		}
+		else
+		{
+			PxContact* PX_RESTRICT contact = reinterpret_cast<PxContact*>(mPoint);
+			contact->contact = point;
+			contact->separation = separation;
+			mPoint += sizeof(PxContact);
+		}
+	}
+
+	PX_FORCE_INLINE void write(const Gu::ContactPoint& cp)
+	{
+		if(mCompact)
+		{
+			write(cp.point, cp.separation);
+		}
+		else
+		{
+			copyContactPoint(reinterpret_cast<PxContact*>(mPoint), &cp);
+			mPoint += sizeof(PxContact);
+		}
+	}
+};
+
 struct StridePatch
 {
 	PxU8 startIndex;
@@ -175,8 +245,15 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 
 	//Calculate the number of patches/points required
 
+	// with 2 points the compact stream is as big as the simple one because of its header
+	PxVec3 compactOrigin(0.0f);
+	PxReal compactQuantum = 1.0f;
+	const bool isCompact = !isModifiable && threadContext && threadContext->mCompactContacts && !contactStreamPool && totalContactPoints > 2
+		&& computeCompactQuantization(contactPoints, numContactPoints, compactOrigin, compactQuantum);
+
 	const PxU32 patchHeaderSize = sizeof(PxContactPatch) * (isModifiable ? totalContactPoints : totalUniquePatches) + additionalHeaderSize;
-	const PxU32 pointSize = totalContactPoints * (isModifiable ? sizeof(PxModifiableContact) : sizeof(PxContact));
+	const PxU32 pointSize = isCompact ? PxU32(sizeof(PxCompactContactHeader) + totalContactPoints * sizeof(PxCompactContact))
+		: totalContactPoints * (isModifiable ? sizeof(PxModifiableContact) : sizeof(PxContact));
 
 	PxU32 requiredContactSize = pointSize;
 	PxU32 requiredPatchSize = patchHeaderSize;
@@ -296,17 +373,7 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 
 	PxReal staticFriction, dynamicFriction, combinedRestitution;
 	PxU32 materialFlags;
-	{
-		const PxsMaterialData& data0 = *materialManager->getMaterial(origMatIndex0);
-		const PxsMaterialData& data1 = *materialManager->getMaterial(origMatIndex1);
-
-		combinedRestitution = PxsMaterialCombiner::combineRestitution(data0, data1);
-		PxsMaterialCombiner combiner(1.0f, 1.0f);
-		PxsMaterialCombiner::PxsCombinedMaterial combinedMat = combiner.combineIsotropicFriction(data0, data1);
-		staticFriction  = combinedMat.staFriction;
-		dynamicFriction = combinedMat.dynFriction;
-		materialFlags = combinedMat.flags;
-	}
+	PxsMaterialCombiner::getCombinedMaterial(*materialManager, origMatIndex0, origMatIndex1, staticFriction, dynamicFriction, combinedRestitution, materialFlags);
 
 
 	PxU8* PX_RESTRICT dataPlusOffset = patchData + additionalHeaderSize;
@@ -341,15 +408,7 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 				const PxU16 matIndex1 = pMaterial[startIndex].mMaterialIndex1;
 				if(matIndex0 != origMatIndex0 || matIndex1 != origMatIndex1)
 				{
-					const PxsMaterialData& data0 = *materialManager->getMaterial(matIndex0);
-					const PxsMaterialData& data1 = *materialManager->getMaterial(matIndex1);
-
-					combinedRestitution = PxsMaterialCombiner::combineRestitution(data0, data1);
-					PxsMaterialCombiner combiner(1.0f, 1.0f);
-					PxsMaterialCombiner::PxsCombinedMaterial combinedMat = combiner.combineIsotropicFriction(data0, data1);
-					staticFriction = combinedMat.staFriction;
-					dynamicFriction = combinedMat.dynFriction;
-					materialFlags = combinedMat.flags;
+					PxsMaterialCombiner::getCombinedMaterial(*materialManager, matIndex0, matIndex1, staticFriction, dynamicFriction, combinedRestitution, materialFlags);
 					origMatIndex0 = matIndex0;
 					origMatIndex1 = matIndex1;
 				}
@@ -449,7 +508,19 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 	{
 		PxU32 flags = PxU32(isMeshType ? PxContactPatch::eHAS_FACE_INDICES : 0);
 
-		PxContact* PX_RESTRICT point = reinterpret_cast<PxContact*>(contactData);
+		ContactPointWriter point;
+		point.mPoint = contactData;
+		point.mOrigin = compactOrigin;
+		point.mInvQuantum = 1.0f / compactQuantum;
+		point.mCompact = isCompact;
+		if(isCompact)
+		{
+			PxCompactContactHeader* PX_RESTRICT header = reinterpret_cast<PxCompactContactHeader*>(contactData);
+			header->origin = compactOrigin;
+			header->quantum = compactQuantum;
+			point.mPoint += sizeof(PxCompactContactHeader);
+			flags |= PxContactPatch::eCOMPACT_CONTACT;
+		}
 		
 		PxU32 currentIndex = 0;
 		{
@@ -463,15 +534,7 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 					const PxU16 matIndex1 = pMaterial[rootPatch.startIndex].mMaterialIndex1;
 					if(matIndex0 != origMatIndex0 || matIndex1 != origMatIndex1)
 					{
-						const PxsMaterialData& data0 = *materialManager->getMaterial(matIndex0);
-						const PxsMaterialData& data1 = *materialManager->getMaterial(matIndex1);
-
-						combinedRestitution = PxsMaterialCombiner::combineRestitution(data0, data1);
-						PxsMaterialCombiner combiner(1.0f, 1.0f);
-						PxsMaterialCombiner::PxsCombinedMaterial combinedMat = combiner.combineIsotropicFriction(data0, data1);
-						staticFriction = combinedMat.staFriction;
-						dynamicFriction = combinedMat.dynFriction;
-						materialFlags = combinedMat.flags;
+						PxsMaterialCombiner::getCombinedMaterial(*materialManager, matIndex0, matIndex1, staticFriction, dynamicFriction, combinedRestitution, materialFlags);
 						origMatIndex0 = matIndex0;
 						origMatIndex1 = matIndex1;
 					}
@@ -517,12 +580,9 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 							*faceIndice = contactPoints[p.startIndex].internalFaceIndex1;
 							faceIndice++;
 						}
-						point->contact = avgPt * recipCount;
-						point->separation = avgPen * recipCount;
-						
-						point++;
+						point.write(avgPt * recipCount, avgPen * recipCount);
 						currentIndex++;
-						Ps::prefetchLine(point, 128);
+						Ps::prefetchLine(point.mPoint, 128);
 					}
 
 					PxU32 index = a;
@@ -531,15 +591,14 @@ PxU32 physx::writeCompressedContact(const Gu::ContactPoint* const PX_RESTRICT co
 						StridePatch& p = stridePatches[index];
 						for(PxU32 b = p.startIndex; b < p.endIndex; ++b)
 						{
-							copyContactPoint(point, &contactPoints[b]);
+							point.write(contactPoints[b]);
 							if (faceIndice)
 							{
 								*faceIndice = contactPoints[b].internalFaceIndex1;
 								faceIndice++;
 							}
-							point++;
 							currentIndex++;
-							Ps::prefetchLine(point, 128);
+							Ps::prefetchLine(point.mPoint, 128);
 						}
 						index = stridePatches[index].nextIndex;
 					}
@@ -36,6 +36,10 @@
 
 using namespace physx;
 
+// Fraction of the retained block count kept from one frame to the next, see trimUnusedBlocks. The unused blocks of a peak
+// are given back over a few seconds at 60Hz, so that bursts of contacts a few frames apart don't go through the allocator.
+static const PxReal RETAINED_BLOCKS_DECAY = 0.995f;
+
 PxcNpMemBlockPool::PxcNpMemBlockPool(PxcScratchAllocator& allocator):
   mConstraints(PX_DEBUG_EXP("PxcNpMemBlockPool::mConstraints")),
   mExceptionalConstraints(PX_DEBUG_EXP("PxcNpMemBlockPool::mExceptionalConstraints")),
@@ -47,6 +51,8 @@ PxcNpMemBlockPool::PxcNpMemBlockPool(PxcScratchAllocator& allocator):
   mMaxBlocks(0),
   mUsedBlocks(0),
   mMaxUsedBlocks(0),
+  mFrameMaxUsedBlocks(0),
+  mRetainedBlocks(0.0f),
   mScratchBlockAddr(0),
   mNbScratchBlocks(0),
   mScratchAllocator(allocator),
@@ -58,22 +64,27 @@ PxcNpMemBlockPool::PxcNpMemBlockPool(PxcScratchAllocator& allocator):
 void PxcNpMemBlockPool::init(PxU32 initialBlockCount, PxU32 maxBlocks)
 {
 	mMaxBlocks = maxBlocks;
-	mInitialBlocks = initialBlockCount;
-
-	PxU32 reserve = PxMax<PxU32>(initialBlockCount, 64);
+	mInitialBlocks = 0;
 
-	mConstraints.reserve(reserve);
 	mExceptionalConstraints.reserve(16);
 
-	mFriction[0].reserve(reserve);
-	mFriction[1].reserve(reserve);
-	mNpCache[0].reserve(reserve);
-	mNpCache[1].reserve(reserve);
-	mUnused.reserve(reserve);
-
+	reserveTracking(64);
 	setBlockCount(initialBlockCount);
 }
 
+// The tracking arrays can each end up with all the blocks, reserving them up front avoids growing them under the lock
+void PxcNpMemBlockPool::reserveTracking(PxU32 blockCount)
+{
+	mConstraints.reserve(blockCount);
+	for(PxU32 i=0;i<2;i++)
+	{
+		mContacts[i].reserve(blockCount);
+		mFriction[i].reserve(blockCount);
+		mNpCache[i].reserve(blockCount);
+	}
+	mUnused.reserve(blockCount);
+}
+
 PxU32 PxcNpMemBlockPool::getUsedBlockCount() const
 {
 	return mUsedBlocks;
@@ -90,13 +101,20 @@ PxU32 PxcNpMemBlockPool::getPeakConstraintBlockCount() const
 }
 
 
+// Prewarms the pool: allocates blocks until blockCount are allocated (used or not), within the max block count.
+// The blocks asked for here are never trimmed, only releaseUnusedBlocks frees them.
 void PxcNpMemBlockPool::setBlockCount(PxU32 blockCount)
 {
 	Ps::Mutex::ScopedLock lock(mLock);
-	PxU32 current = getUsedBlockCount();
-	for(PxU32 i=current;i<blockCount;i++)
+	mInitialBlocks = blockCount;
+	blockCount = PxMin(blockCount, mMaxBlocks);
+	reserveTracking(blockCount);
+	while(mAllocatedBlocks<blockCount)
 	{
-		mUnused.pushBack(reinterpret_cast<PxcNpMemBlock *>(PX_ALLOC(PxcNpMemBlock::SIZE, "PxcNpMemBlock")));
+		PxcNpMemBlock* block = reinterpret_cast<PxcNpMemBlock *>(PX_ALLOC(PxcNpMemBlock::SIZE, "PxcNpMemBlock"));
+		if(!block)
+			break;
+		mUnused.pushBack(block);
 		mAllocatedBlocks++;
 	}
 }
@@ -109,6 +127,23 @@ void PxcNpMemBlockPool::releaseUnusedBlocks()
 		PX_FREE(mUnused.popBack());
 		mAllocatedBlocks--;
 	}
+	mRetainedBlocks = 0.0f;
+}
+
+// Called once per frame, outside of the simulation. Keeps enough blocks for the peak of the recent frames, which decays
+// towards the current usage, and frees the unused blocks above it (never below the prewarmed count).
+void PxcNpMemBlockPool::trimUnusedBlocks()
+{
+	Ps::Mutex::ScopedLock lock(mLock);
+	mRetainedBlocks = PxMax(PxReal(mFrameMaxUsedBlocks), mRetainedBlocks * RETAINED_BLOCKS_DECAY);
+	mFrameMaxUsedBlocks = mUsedBlocks;
+
+	const PxU32 keep = PxMax(mInitialBlocks, PxU32(PxCeil(mRetainedBlocks)));
+	while(mAllocatedBlocks>keep && mUnused.size())
+	{
+		PX_FREE(mUnused.popBack());
+		mAllocatedBlocks--;
+	}
 }
 
 
@@ -182,62 +217,68 @@ void PxcNpMemBlockPool::releaseConstraintMemory()
 
 PxcNpMemBlock* PxcNpMemBlockPool::acquire(PxcNpMemBlockArray& trackingArray, PxU32* allocationCount, PxU32* peakAllocationCount, bool isScratchAllocation)
 {
-	Ps::Mutex::ScopedLock lock(mLock);
-	if(allocationCount && peakAllocationCount)
 	{
-		*peakAllocationCount = PxMax(*allocationCount + 1, *peakAllocationCount);
-		(*allocationCount)++;
-	}
+		Ps::Mutex::ScopedLock lock(mLock);
+		if(allocationCount && peakAllocationCount)
+		{
+			*peakAllocationCount = PxMax(*allocationCount + 1, *peakAllocationCount);
+			(*allocationCount)++;
+		}
 
-	// this is a bit of hack - the logic would be better placed in acquireConstraintBlock, but then we'd have to grab the mutex
-	// once there to check the scratch block array and once here if we fail - or, we'd need a larger refactor to separate out
-	// locking and acquisition.
+		// this is a bit of hack - the logic would be better placed in acquireConstraintBlock, but then we'd have to grab the mutex
+		// once there to check the scratch block array and once here if we fail - or, we'd need a larger refactor to separate out
+		// locking and acquisition.
 
-	if(isScratchAllocation && mScratchBlocks.size()>0)
-	{
-		PxcNpMemBlock* block = mScratchBlocks.popBack();
-		trackingArray.pushBack(block);
-		return block;
-	}
+		if(isScratchAllocation && mScratchBlocks.size()>0)
+		{
+			PxcNpMemBlock* block = mScratchBlocks.popBack();
+			trackingArray.pushBack(block);
+			return block;
+		}
 
 	
-	if(mUnused.size())
-	{
-		PxcNpMemBlock* block = mUnused.popBack();
-		trackingArray.pushBack(block);
-		mMaxUsedBlocks = PxMax<PxU32>(mUsedBlocks+1, mMaxUsedBlocks);
-		mUsedBlocks++;
-		return block;
-	}	
+		if(mUnused.size())
+		{
+			PxcNpMemBlock* block = mUnused.popBack();
+			trackingArray.pushBack(block);
+			mUsedBlocks++;
+			mMaxUsedBlocks = PxMax<PxU32>(mUsedBlocks, mMaxUsedBlocks);
+			mFrameMaxUsedBlocks = PxMax<PxU32>(mUsedBlocks, mFrameMaxUsedBlocks);
+			return block;
+		}	
 
 
-	if(mAllocatedBlocks == mMaxBlocks)
-	{
+		if(mAllocatedBlocks == mMaxBlocks)
+		{
 #if PX_CHECKED
-		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, 
-				"Reached maximum number of allocated blocks so 16k block allocation will fail!");
+			Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, 
+					"Reached maximum number of allocated blocks so 16k block allocation will fail!");
 #endif
-		return NULL;
-	}
+			return NULL;
+		}
 
 #if PX_CHECKED
-	if(mInitialBlocks)
-	{
-		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, 
-			"Number of required 16k memory blocks has exceeded the initial number of blocks. Allocator is being called. Consider increasing the number of pre-allocated 16k blocks.");
-	}
+		if(mInitialBlocks)
+		{
+			Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, 
+				"Number of required 16k memory blocks has exceeded the initial number of blocks. Allocator is being called. Consider increasing the number of pre-allocated 16k blocks.");
+		}
 #endif
 
-	// increment here so that if we hit the limit in separate threads we won't overallocated
-	mAllocatedBlocks++;
-	
+		// increment here so that if we hit the limit in separate threads we won't overallocated
+		mAllocatedBlocks++;
+	}
+
+	// the other threads keep acquiring from the pool while this one waits on the allocator
 	PxcNpMemBlock* block = reinterpret_cast<PxcNpMemBlock*>(PX_ALLOC(sizeof(PxcNpMemBlock), "PxcNpMemBlock"));
 
+	Ps::Mutex::ScopedLock lock(mLock);
 	if(block)
 	{
 		trackingArray.pushBack(block);
-		mMaxUsedBlocks = PxMax<PxU32>(mUsedBlocks+1, mMaxUsedBlocks);
 		mUsedBlocks++;
+		mMaxUsedBlocks = PxMax<PxU32>(mUsedBlocks, mMaxUsedBlocks);
+		mFrameMaxUsedBlocks = PxMax<PxU32>(mUsedBlocks, mFrameMaxUsedBlocks);
 	}
 	else
 		mAllocatedBlocks--;
@@ -279,7 +320,10 @@ void PxcNpMemBlockPool::release(PxcNpMemBlockArray& deadArray, PxU32* allocation
 void PxcNpMemBlockPool::flushUnused()
 {
 	while(mUnused.size())
+	{
 		PX_FREE(mUnused.popBack());
+		mAllocatedBlocks--;
+	}
 }
 
 
@@ -38,9 +38,11 @@ PxcNpThreadContext::PxcNpThreadContext(PxcNpContext* params) :
 	mNpCacheStreamPair					(params->mNpMemBlockPool),
 	mNarrowPhaseParams					(0.0f, params->mMeshContactMargin, params->mToleranceLength),
 	mPCM								(false),
+	mAdaptivePCMThresholds				(false),
 	mContactCache						(false),
 	mCreateContactStream				(params->mCreateContactStream),
 	mCreateAveragePoint					(false),
+	mCompactContacts					(false),
 #if PX_ENABLE_SIM_STATS
 	mCompressedCacheSize				(0),
 	mNbDiscreteContactPairsWithCacheHits(0),
@@ -71,6 +73,9 @@ void PxcNpThreadContext::clearStats()
 {
 	PxMemSet(mDiscreteContactPairs, 0, sizeof(mDiscreteContactPairs));
 	PxMemSet(mModifiedContactPairs, 0, sizeof(mModifiedContactPairs));
+	PxMemSet(mPCMManifoldHits, 0, sizeof(mPCMManifoldHits));
+	PxMemSet(mPCMManifoldRefreshes, 0, sizeof(mPCMManifoldRefreshes));
+	PxMemSet(mPCMManifoldRegenerations, 0, sizeof(mPCMManifoldRegenerations));
 	mCompressedCacheSize					= 0;
 	mNbDiscreteContactPairsWithCacheHits	= 0;
 	mNbDiscreteContactPairsWithContacts		= 0;
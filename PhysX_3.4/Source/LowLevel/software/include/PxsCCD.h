@@ -592,9 +592,11 @@ private:
 		Ps::Array<PxsCCDPair*> mCCDPtrPairs;
 		// number of pairs per island
 		Ps::Array<PxU32> mCCDIslandHistogram; 
+		// index of the first pair of each island in mCCDPtrPairs, used to sort the pairs by island
+		Ps::Array<PxU32> mCCDIslandOffsets;
 		// thread context valid during CCD update
 		PxcNpThreadContext* mCCDThreadContext;
-		// number of pairs to process per thread
+		// number of pairs to process per advance task
 		PxU32 mCCDPairsPerBatch;
 		PxU32 mCCDMaxPasses;
 
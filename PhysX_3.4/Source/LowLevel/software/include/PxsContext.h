@@ -107,8 +107,10 @@ public:
 						void					createTransformCache(Ps::VirtualAllocatorCallback& allocatorCallback);
 
 						PxsContactManager*		createContactManager(PxsContactManager* contactManager, const bool useCCD);
-						void					createCache(Gu::Cache& cache, PxsContactManager* cm, PxU8 geomType0, PxU8 geomType1);
+						// keptManifold is a manifold kept while the pair was asleep, reused if the pair still needs one of the same kind and released otherwise
+						void					createCache(Gu::Cache& cache, PxsContactManager* cm, PxU8 geomType0, PxU8 geomType1, void* keptManifold = NULL);
 						void					destroyCache(Gu::Cache& cache);
+						void					releaseManifold(void* manifold);
 						void					destroyContactManager(PxsContactManager* cm);
 
 						
@@ -162,8 +164,14 @@ public:
 	PX_FORCE_INLINE	PxReal						getRenderScale()			const	{ return mVisualizationParams[PxVisualizationParameter::eSCALE];	}
 					Cm::RenderOutput			getRenderOutput()					{ return Cm::RenderOutput(mRenderBuffer);							}
 	PX_FORCE_INLINE	bool						getPCM()					const	{ return mPCM;														}
+	PX_FORCE_INLINE	bool						getAdaptivePCMThresholds()	const	{ return mAdaptivePCMThresholds;									}
 	PX_FORCE_INLINE	bool						getContactCacheFlag()		const	{ return mContactCache;												}
 	PX_FORCE_INLINE	bool						getCreateAveragePoint()		const	{ return mCreateAveragePoint;										}
+	PX_FORCE_INLINE	bool						getCompactContacts()		const	{ return mCompactContacts;											}
+	PX_FORCE_INLINE	bool						getParallelContactModification()	const	{ return mParallelContactModification;						}
+	PX_FORCE_INLINE	Ps::Mutex&					getContactModifyLock()				{ return mContactModifyLock;									}
+	PX_FORCE_INLINE	bool						getCostProfiling()			const	{ return mCostProfiling;											}
+	PX_FORCE_INLINE	void						setCostProfiling(bool enabled)		{ mCostProfiling = enabled;										}
 
 	// general stuff
 					void						shiftOrigin(const PxVec3& shift);
@@ -277,6 +285,7 @@ private:
 
 
 	PxContactModifyCallback*					mContactModifyCallback;
+	Ps::Mutex									mContactModifyLock;	// serializes the callback, see PxSceneFlag::eENABLE_PARALLEL_CONTACT_MODIFICATION
 
 	// narrowphase platform-dependent implementations support
 	PxvNphaseImplementationContext*				mNpImplementationContext;
@@ -298,8 +307,12 @@ private:
 						// PX_ENABLE_SIM_STATS
 					PxvSimStats									mSimStats;
 					bool										mPCM;
+					bool										mAdaptivePCMThresholds;
 					bool										mContactCache;
 					bool										mCreateAveragePoint;
+					bool										mCompactContacts;
+					bool										mParallelContactModification;
+					bool										mCostProfiling;		// every pair is timed by the narrow phase, see PxScene::setCostProfiling
 
 					PxsTransformCache*							mTransformCache;
 					Ps::Array<PxReal, Ps::VirtualAllocator>*	mContactDistance;
@@ -64,7 +64,8 @@ namespace physx
 #if 0 //PX_USE_NAMED_ALLOCATOR
 			return PX_ALLOC(newByteSize, mName);
 #else
-			return PX_ALLOC(newByteSize, filename);
+			// the bounds and contact distance arrays of the broadphase, as big and long lived as the scene
+			return PX_ALLOC_LARGE(newByteSize, filename);
 #endif
 		}
 
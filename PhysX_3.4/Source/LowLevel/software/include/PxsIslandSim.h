@@ -33,6 +33,7 @@
 #include "CmPhysXCommon.h"
 #include "foundation/PxAssert.h"
 #include "PsArray.h"
+#include "PsIntrinsics.h"
 #include "CmBitMap.h"
 #include "CmPriorityQueue.h"
 
@@ -439,6 +440,7 @@ class IslandSim
 	Ps::Array<IslandId> mIslandIds;		//! The array of per-node island ids
 	
 	Cm::BitMap mIslandAwake;								//! Indicates whether an island is awake or not
+	Ps::Array<PxU8> mIslandReadyForSleeping;				//! Per active island, whether it can be deactivated. Only valid during deactivation
 
 	Cm::BitMap mActiveContactEdges;
 
@@ -619,7 +621,16 @@ private:
 	void wakeIslands();
 	void wakeIslands2();
 	void processNewEdges();
-	void processLostEdges(Ps::Array<NodeIndex>& destroyedNodes, bool allowDeactivation, bool permitKinematicDeactivation, PxU32 dirtyNodeLimit);
+	//If deferDeactivation is set, only prepareDeactivation runs and the caller has to call findIslandsReadyForSleeping over all
+	//the active islands and then deactivateIslandsReadyForSleeping.
+	void processLostEdges(Ps::Array<NodeIndex>& destroyedNodes, bool allowDeactivation, bool permitKinematicDeactivation, PxU32 dirtyNodeLimit,
+		bool deferDeactivation = false);
+
+	//Island deactivation, in 3 stages. The first and last ones are serial, findIslandsReadyForSleeping only reads the graph and writes
+	//mIslandReadyForSleeping for its range of active islands, so it can be run over disjoint ranges in parallel.
+	void prepareDeactivation(bool permitKinematicDeactivation);
+	void findIslandsReadyForSleeping(PxU32 startIndex, PxU32 nbIslands);
+	void deactivateIslandsReadyForSleeping();
 
 	void removeConnectionInternal(EdgeIndex edgeIndex);
 
@@ -861,6 +872,38 @@ private:
 		edge.mNextIslandEdge = edge.mPrevIslandEdge = IG_INVALID_EDGE;
 	}
 
+	//The loops over the dirty and destroyed edges miss the cache on almost every edge and node they touch, so they prefetch ahead:
+	//first the edge and its node indices, then (once these indices are expected to be cached) the nodes and their island ids.
+	PX_FORCE_INLINE void prefetchEdge(EdgeIndex edgeIndex) const
+	{
+		Ps::prefetchLine(mEdges.begin() + edgeIndex);
+		Ps::prefetchLine(mEdgeNodeIndices.begin() + 2 * edgeIndex);
+	}
+
+	PX_FORCE_INLINE void prefetchEdgeNodes(EdgeIndex edgeIndex) const
+	{
+		const PxU32 index1 = mEdgeNodeIndices[2 * edgeIndex].index();
+		const PxU32 index2 = mEdgeNodeIndices[2 * edgeIndex + 1].index();
+		if(index1 != IG_INVALID_NODE)
+		{
+			Ps::prefetchLine(mNodes.begin() + index1);
+			Ps::prefetchLine(mIslandIds.begin() + index1);
+		}
+		if(index2 != IG_INVALID_NODE)
+		{
+			Ps::prefetchLine(mNodes.begin() + index2);
+			Ps::prefetchLine(mIslandIds.begin() + index2);
+		}
+	}
+
+	PX_FORCE_INLINE void prefetchEdges(const EdgeIndex* edges, PxU32 index, PxU32 count) const
+	{
+		if((index + 8) < count)
+			prefetchEdge(edges[index + 8]);
+		if((index + 4) < count)
+			prefetchEdgeNodes(edges[index + 4]);
+	}
+
 	PX_FORCE_INLINE void addEdgeToIsland(Island& island, EdgeIndex edgeIndex)
 	{
 		Edge& edge = mEdges[edgeIndex];
@@ -918,6 +961,8 @@ private:
 
 	friend class SimpleIslandManager;
 	friend class ThirdPassTask;
+	friend class IslandSleepTask;
+	friend class DeactivateIslandsTask;
 
 };
 
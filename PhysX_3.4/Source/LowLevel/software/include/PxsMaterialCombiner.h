@@ -32,6 +32,7 @@
 #define PXS_MATERIALCOMBINER_H
 
 #include "PxsMaterialCore.h"
+#include "PxsMaterialManager.h"
 
 namespace physx
 {
@@ -50,6 +51,31 @@ namespace physx
 
 		static PxReal combineRestitution(const PxsMaterialData& material0, const PxsMaterialData& material1);
 
+		// combined material of a pair without friction scaling, read from the precomputed table of the manager when available
+		static PX_FORCE_INLINE void getCombinedMaterial(const PxsMaterialManager& manager, const PxU32 index0, const PxU32 index1, PxReal& staticFriction, PxReal& dynamicFriction, PxReal& restitution, PxU32& flags)
+		{
+			const PxsCombinedMaterialData* combined = manager.getCombinedMaterial(index0, index1);
+			if(combined)
+			{
+				staticFriction = combined->staticFriction;
+				dynamicFriction = combined->dynamicFriction;
+				restitution = combined->restitution;
+				flags = combined->flags;
+			}
+			else
+			{
+				const PxsMaterialData& data0 = *manager.getMaterial(index0);
+				const PxsMaterialData& data1 = *manager.getMaterial(index1);
+
+				restitution = combineRestitution(data0, data1);
+				PxsMaterialCombiner combiner(1.0f, 1.0f);
+				const PxsCombinedMaterial combinedMat = combiner.combineIsotropicFriction(data0, data1);
+				staticFriction = combinedMat.staFriction;
+				dynamicFriction = combinedMat.dynFriction;
+				flags = combinedMat.flags;
+			}
+		}
+
 		PxsMaterialCombiner(PxReal staticFrictionScaling, PxReal dynamicFrictionScaling);
 
 		PxsCombinedMaterial combineIsotropicFriction(const PxsMaterialData& material0, const PxsMaterialData& material1);
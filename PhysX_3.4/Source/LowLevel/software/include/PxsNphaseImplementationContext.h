@@ -34,6 +34,7 @@
 #include "PxvNphaseImplementationContext.h" 
 #include "PxsContactManagerState.h"
 #include "PxcNpCache.h"
+#include "PxcNpBatch.h"
 
 namespace physx
 {
@@ -43,12 +44,16 @@ struct PxsContactManagers : PxsContactManagerBase
 	Ps::Array<PxsContactManagerOutput>			mOutputContactManagers;
 	Ps::Array<PxsContactManager*>				mContactManagerMapping;
 	Ps::Array<Gu::Cache>						mCaches;
+	Ps::Array<PxcNpFrozenPair>					mFrozenPairs;
+	Ps::Array<PxU32>							mCosts;		// time spent on the pair by the last narrow phase in tens of ns, mesh pairs only
 
 
 	PxsContactManagers(const PxU32 bucketId) : PxsContactManagerBase(bucketId),
 		mOutputContactManagers(PX_DEBUG_EXP("mOutputContactManagers")),
 		mContactManagerMapping(PX_DEBUG_EXP("mContactManagerMapping")),
-		mCaches(PX_DEBUG_EXP("mCaches"))
+		mCaches(PX_DEBUG_EXP("mCaches")),
+		mFrozenPairs(PX_DEBUG_EXP("mFrozenPairs")),
+		mCosts(PX_DEBUG_EXP("mCosts"))
 	{
 	}
 		
@@ -57,7 +62,8 @@ struct PxsContactManagers : PxsContactManagerBase
 		mOutputContactManagers.forceSize_Unsafe(0);
 		mContactManagerMapping.forceSize_Unsafe(0);
 		mCaches.forceSize_Unsafe(0);
-		
+		mFrozenPairs.forceSize_Unsafe(0);
+		mCosts.forceSize_Unsafe(0);
 	}
 private:
 	PX_NOCOPY(PxsContactManagers)
@@ -70,7 +76,7 @@ public:
 	static PxsNphaseImplementationContext*	create(PxsContext& context, IG::IslandSim* islandSim);
 
 	PxsNphaseImplementationContext(PxsContext& context, IG::IslandSim* islandSim, PxU32 index = 0): PxvNphaseImplementationContextUsableAsFallback(context), mNarrowPhasePairs(index), mNewNarrowPhasePairs(index),
-										mModifyCallback(NULL), mIslandSim(islandSim) {}
+										mModifyCallback(NULL), mIslandSim(islandSim), mSlowPairsFound(0) {}
 	virtual void				destroy();
 	virtual void				updateContactManager(PxReal dt, bool hasBoundsArrayChanged, bool hasContactDistanceChanged, PxBaseTask* continuation, PxBaseTask* firstPassContinuation);
 	virtual void				postBroadPhaseUpdateContactManager() {}
@@ -83,6 +89,9 @@ public:
 
 	
 	virtual void				refreshContactManager(PxsContactManager* cm);
+	virtual void*				unregisterSleepingContactManager(PxsContactManager* cm);
+	virtual void				registerWokenContactManager(PxsContactManager* cm, PxI32 touching, PxU32 patchCount, void* sleepingState);
+	virtual void				releaseSleepingContactState(void* sleepingState);
 	virtual void				refreshContactManagerFallback(PxsContactManager* cm, PxsContactManagerOutput* cmOutputs);
 
 	virtual void				registerShape(const PxsShapeCore& shapeCore);
@@ -109,6 +118,8 @@ public:
 
 	virtual PxsContactManagerOutput*	getGPUContactManagerOutputBase() { return NULL; }
 
+	virtual PxU32							getPairCosts(PxsContactManager* const*& managers, const PxU32*& costs) const;
+
 	virtual void							acquireContext(){}
 	virtual void							releaseContext(){}
 	virtual void				preallocateNewBuffers(PxU32 /*nbNewPairs*/, PxU32 /*maxIndex*/) { /*TODO - implement if it's useful to do so*/}
@@ -131,8 +142,13 @@ public:
 
 	IG::IslandSim*				mIslandSim;
 
+	// Set by the narrow phase tasks when a pair went over the slow pair cost, see selectSlowPairs
+	volatile PxI32				mSlowPairsFound;
+
 private:
 
+	PxU32						selectSlowPairs(PxU32* indices, PxU32 maxIndices);
+
 	void						unregisterContactManagerInternal(PxU32 npIndex, PxsContactManagers& managers, PxsContactManagerOutput* cmOutputs);
 
 	PX_NOCOPY(PxsNphaseImplementationContext)
@@ -32,6 +32,7 @@
 
 #include "PxsIslandSim.h"
 #include "CmTask.h"
+#include "CmParallelFor.h"
 
 namespace physx
 {
@@ -45,11 +46,58 @@ namespace IG
 
 	class SimpleIslandManager;
 
+//Finds which active islands of an island sim are ready for sleeping, over chunks of the active islands claimed from a shared range
+class IslandSleepTask : public Cm::Task
+{
+	IslandSim& mIslandSim;
+	Cm::ParallelForRange& mRange;
+
+public:
+
+	IslandSleepTask(PxU64 contextID, IslandSim& islandSim, Cm::ParallelForRange& range);
+
+	virtual void runInternal();
+
+	virtual const char* getName() const
+	{
+		return "IslandSleepTask";
+	}
+
+	static const PxU32 MinIslandsPerTask = 256;
+	static const PxU32 MaxIslandsPerTask = 2048;
+
+private:
+	PX_NOCOPY(IslandSleepTask)
+};
+
+//Deactivates the islands found by the IslandSleepTasks. This edits the active lists, so it runs once after all of them
+class DeactivateIslandsTask : public Cm::Task
+{
+	IslandSim& mIslandSim;
+
+public:
+
+	DeactivateIslandsTask(PxU64 contextID, IslandSim& islandSim);
+
+	virtual void runInternal();
+
+	virtual const char* getName() const
+	{
+		return "DeactivateIslandsTask";
+	}
+
+private:
+	PX_NOCOPY(DeactivateIslandsTask)
+};
+
 class ThirdPassTask : public Cm::Task
 {
 	SimpleIslandManager& mIslandManager;
 	IslandSim& mIslandSim;
 
+	Cm::ParallelForRange mSleepRange;
+	DeactivateIslandsTask mDeactivateIslandsTask;
+
 public:
 
 	ThirdPassTask(PxU64 contextID, SimpleIslandManager& islandManager, IslandSim& islandSim);
@@ -115,6 +163,8 @@ class SimpleIslandManager
 	PostThirdPassTask mPostThirdPassTask;
 	PxU32 mMaxDirtyNodesPerFrame;
 
+	Cm::FlushPool* mTaskPool;								//! Pool of the island sleep tasks, set by thirdPassIslandGen
+
 	PxU64	mContextID;
 public:
 
@@ -145,7 +195,8 @@ public:
 	void firstPassIslandGen();
 	void additionalSpeculativeActivation();
 	void secondPassIslandGen();
-	void thirdPassIslandGen(PxBaseTask* continuation);
+	//The task pool must not be cleared before the continuation ran
+	void thirdPassIslandGen(PxBaseTask* continuation, Cm::FlushPool& taskPool);
 
 	void clearDestroyedEdges();
 
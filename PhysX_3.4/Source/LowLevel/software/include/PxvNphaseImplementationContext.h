@@ -122,6 +122,8 @@ public:
 	}
 };
 
+// Bits of the pair costs holding the time, see PxvNphaseImplementationContext::getPairCosts
+static const PxU32 PXS_PAIR_COST_MASK = 0x7fffffff;
 
 class PxvNphaseImplementationContext
 {
@@ -142,6 +144,16 @@ public:
 	virtual void						unregisterContactManager(PxsContactManager* cm) = 0;
 	virtual void						refreshContactManager(PxsContactManager* cm) = 0;
 
+	// Unregisters a pair whose bodies fell asleep, returns the narrow phase state kept for registerWokenContactManager (or NULL).
+	// Kept state must be given back to registerWokenContactManager or released with releaseSleepingContactState.
+	virtual void*						unregisterSleepingContactManager(PxsContactManager* cm)	{ unregisterContactManager(cm); return NULL; }
+	virtual void						registerWokenContactManager(PxsContactManager* cm, PxI32 touching, PxU32 patchCount, void* sleepingState)
+										{
+											releaseSleepingContactState(sleepingState);
+											registerContactManager(cm, touching, patchCount);
+										}
+	virtual void						releaseSleepingContactState(void* sleepingState)	{ PX_UNUSED(sleepingState); }
+
 	virtual void						registerShape(const PxsShapeCore& shapeCore) = 0;
 	virtual void						unregisterShape(const PxsShapeCore& shapeCore) = 0;
 
@@ -163,6 +175,14 @@ public:
 
 	virtual void							setContactModifyCallback(PxContactModifyCallback* callback) = 0;
 
+	/**
+	\brief Returns the pairs of the narrow phase and the time spent on each one by the last update, in tens of nanoseconds.
+
+	Only the pairs against meshes and heightfields are timed, unless PxsContext::getCostProfiling() is set. The top bit
+	of the costs is used internally, see PXS_PAIR_COST_MASK. Implementations that don't time their pairs return 0.
+	*/
+	virtual PxU32							getPairCosts(PxsContactManager* const*& managers, const PxU32*& costs) const	{ managers = NULL; costs = NULL; return 0; }
+
 	virtual void							acquireContext() = 0;
 	virtual void							releaseContext() = 0;
 	virtual void							preallocateNewBuffers(PxU32 nbNewPairs, PxU32 maxIndex) = 0;
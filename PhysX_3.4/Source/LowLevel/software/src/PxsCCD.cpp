@@ -66,6 +66,11 @@ using namespace physx::shdfnd;
 using namespace physx::Dy;
 using namespace Gu;
 
+// Tasks per worker thread for the sweeps and the island advance. The sweep cost varies a lot between pairs (convex vs mesh, estimates vs full sweeps)
+// and the advance cost with the island size, so more tasks than threads let the workers that get cheap batches pick up more
+static const PxU32 gCCDSweepTasksPerThread = 4;
+static const PxU32 gCCDAdvanceTasksPerThread = 2;
+
 
 static PX_FORCE_INLINE void verifyCCDPair(const PxsCCDPair& /*pair*/)
 {
@@ -384,14 +389,10 @@ PxReal PxsCCDPair::sweepFindToi(PxcNpThreadContext& context, PxReal dt, PxU32 pa
 	g_GetSingleMaterialMethodTable[g0](ccdShape0->mShapeCore, 0, context, &materialInfo);
 	g_GetSingleMaterialMethodTable[g1](ccdShape1->mShapeCore, 1, context, &materialInfo);
 
-	const PxsMaterialData& data0 = *context.mMaterialManager->getMaterial(materialInfo.mMaterialIndex0);
-	const PxsMaterialData& data1 = *context.mMaterialManager->getMaterial(materialInfo.mMaterialIndex1);
-
-	const PxReal restitution = PxsMaterialCombiner::combineRestitution(data0, data1);
-	PxsMaterialCombiner combiner(1.0f, 1.0f);
-	PxsMaterialCombiner::PxsCombinedMaterial combinedMat = combiner.combineIsotropicFriction(data0, data1);
-	const PxReal sFriction = combinedMat.staFriction;
-	const PxReal dFriction = combinedMat.dynFriction;
+	PxReal sFriction, dFriction, restitution;
+	PxU32 materialFlags;
+	PxsMaterialCombiner::getCombinedMaterial(*context.mMaterialManager, materialInfo.mMaterialIndex0, materialInfo.mMaterialIndex1, sFriction, dFriction, restitution, materialFlags);
+	PX_UNUSED(materialFlags);
 
 	mMaterialIndex0 = materialInfo.mMaterialIndex0;
 	mMaterialIndex1 = materialInfo.mMaterialIndex1;
@@ -813,11 +814,6 @@ struct IslandCompare
 	bool operator()(PxsCCDPair& a, PxsCCDPair& b) const { return a.mIslandId < b.mIslandId; }
 };
 
-struct IslandPtrCompare
-{
-	bool operator()(PxsCCDPair*& a, PxsCCDPair*& b) const { return a->mIslandId < b->mIslandId; }
-};
-
 struct ToiCompare
 {
 	bool operator()(PxsCCDPair& a, PxsCCDPair& b) const 
@@ -1707,19 +1703,33 @@ void PxsCCDContext::updateCCD(PxReal dt, PxBaseTask* continuation, bool disableR
 
 	// --------------------------------------------------------------------------------------
 	// sort all pairs by islands
-	shdfnd::sort(mCCDPtrPairs.begin(), mCCDPtrPairs.size(), IslandPtrCompare());
+	// the island ids are dense and the histogram has the pair count of each island, so a counting sort does it in linear time
+	mCCDIslandOffsets.forceSize_Unsafe(0);
+	mCCDIslandOffsets.reserve(islandCount);
+	mCCDIslandOffsets.forceSize_Unsafe(islandCount);
+	for (PxU32 a = 0, offset = 0; a < islandCount; ++a)
+	{
+		mCCDIslandOffsets[a] = offset;
+		offset += mCCDIslandHistogram[a];
+	}
+	for (PxU32 a = 0, n = mCCDPairs.size(); a < n; ++a)
+	{
+		PxsCCDPair& pair = mCCDPairs[a];
+		mCCDPtrPairs[mCCDIslandOffsets[pair.mIslandId]++] = &pair;
+	}
 
 	// --------------------------------------------------------------------------------------
 	// sweep all CCD pairs
 	const PxU32 nPairs = mCCDPtrPairs.size();
 	const PxU32 numThreads = PxMax(1u, mContext->mTaskManager->getCpuDispatcher()->getWorkerCount()); PX_ASSERT(numThreads > 0);
-	mCCDPairsPerBatch = PxMax<PxU32>((nPairs)/numThreads, 1);
+	mCCDPairsPerBatch = PxMax<PxU32>(nPairs/(numThreads*gCCDAdvanceTasksPerThread), 1);
+	const PxU32 sweepPairsPerBatch = PxMax<PxU32>(nPairs/(numThreads*gCCDSweepTasksPerThread), 1);
 
-	for (PxU32 batchBegin = 0; batchBegin < nPairs; batchBegin += mCCDPairsPerBatch)
+	for (PxU32 batchBegin = 0; batchBegin < nPairs; batchBegin += sweepPairsPerBatch)
 	{
 		void* ptr = mContext->mTaskPool.allocate(sizeof(PxsCCDSweepTask));
 		PX_ASSERT_WITH_MESSAGE(ptr, "Failed to allocate PxsCCDSweepTask");
-		const PxU32 batchEnd = PxMin(nPairs, batchBegin + mCCDPairsPerBatch);
+		const PxU32 batchEnd = PxMin(nPairs, batchBegin + sweepPairsPerBatch);
 		PX_ASSERT(batchEnd >= batchBegin);
 		PxsCCDSweepTask* task = PX_PLACEMENT_NEW(ptr, PxsCCDSweepTask)(mContext->getContextId(), mCCDPtrPairs.begin() + batchBegin, batchEnd - batchBegin);
 		task->setContinuation(*mContext->mTaskManager, &mPostCCDSweepTask);
@@ -1743,10 +1753,11 @@ void PxsCCDContext::postCCDSweep(PxBaseTask* continuation)
 		PxU32 lastIslandInBatch = firstIslandInBatch+1;
 		PxU32 j;
 		// add up the numbers in the histogram until we reach target pairsPerBatch
+		// islands are not split, so a big island gets a batch of its own
 		for (j = firstIslandInBatch; j < islandCount; j++)
 		{
 			pairSum += mCCDIslandHistogram[j];
-			if (pairSum > mCCDPairsPerBatch)
+			if (pairSum >= mCCDPairsPerBatch)
 			{
 				lastIslandInBatch = j+1;
 				break;
@@ -74,8 +74,12 @@ PxsContext::PxsContext(const PxSceneDesc& desc, PxTaskManager* taskManager, Cm::
 	mTaskManager				(taskManager),
 	mTaskPool					(taskPool),
 	mPCM						(desc.flags & PxSceneFlag::eENABLE_PCM),
+	mAdaptivePCMThresholds		(desc.flags & PxSceneFlag::eENABLE_ADAPTIVE_PCM_THRESHOLDS),
 	mContactCache				(false),
 	mCreateAveragePoint			(desc.flags & PxSceneFlag::eENABLE_AVERAGE_POINT),
+	mCompactContacts			(desc.flags & PxSceneFlag::eENABLE_COMPACT_CONTACTS),
+	mParallelContactModification(desc.flags & PxSceneFlag::eENABLE_PARALLEL_CONTACT_MODIFICATION),
+	mCostProfiling				(false),
 	mContextID					(contextID)
 {
 	clearManagerTouchEvents();
@@ -223,7 +227,7 @@ PxsContactManager* PxsContext::createContactManager(PxsContactManager* contactMa
 	return cm;
 }
 
-void PxsContext::createCache(Gu::Cache& cache, PxsContactManager* cm, PxU8 geomType0, PxU8 geomType1)
+void PxsContext::createCache(Gu::Cache& cache, PxsContactManager* cm, PxU8 geomType0, PxU8 geomType1, void* keptManifold)
 {
 	if(cm)
 	{
@@ -234,20 +238,30 @@ void PxsContext::createCache(Gu::Cache& cache, PxsContactManager* cm, PxU8 geomT
 				if(geomType0 <= PxGeometryType::eCONVEXMESH && 
 				   geomType1 <= PxGeometryType::eCONVEXMESH)
 				{
-					if(geomType0 == PxGeometryType::eSPHERE || geomType1 == PxGeometryType::eSPHERE)
+					const bool sphere = geomType0 == PxGeometryType::eSPHERE || geomType1 == PxGeometryType::eSPHERE;
+					if(keptManifold && (reinterpret_cast<Gu::PersistentContactManifold*>(keptManifold)->mCapacity == GU_SPHERE_MANIFOLD_CACHE_SIZE) == sphere)
 					{
-						Gu::PersistentContactManifold* manifold = mSphereManifoldPool.allocate();
-						new(manifold) Gu::SpherePersistentContactManifold();
-						cache.setManifold(manifold);
+						// the manifold remembers the relative transform it was built with, the contact gen refreshes or regenerates it as needed
+						cache.setManifold(keptManifold);
+						keptManifold = NULL;
 					}
 					else
 					{
-						Gu::PersistentContactManifold* manifold = mManifoldPool.allocate();
-						new(manifold) Gu::LargePersistentContactManifold();
-						cache.setManifold(manifold);
-
+						if(sphere)
+						{
+							Gu::PersistentContactManifold* manifold = mSphereManifoldPool.allocate();
+							new(manifold) Gu::SpherePersistentContactManifold();
+							cache.setManifold(manifold);
+						}
+						else
+						{
+							Gu::PersistentContactManifold* manifold = mManifoldPool.allocate();
+							new(manifold) Gu::LargePersistentContactManifold();
+							cache.setManifold(manifold);
+
+						}
+						cache.getManifold().clearManifold();
 					}
-					cache.getManifold().clearManifold();
 
 				}
 				else
@@ -265,6 +279,9 @@ void PxsContext::createCache(Gu::Cache& cache, PxsContactManager* cm, PxU8 geomT
 			}			
 		}
 	}
+
+	if(keptManifold)
+		releaseManifold(keptManifold);
 }
 
 void PxsContext::destroyContactManager(PxsContactManager* cm)
@@ -283,22 +300,25 @@ void PxsContext::destroyCache(Gu::Cache& cache)
 	if(cache.isManifold())
 	{
 		if(!cache.isMultiManifold())
-		{
-			Gu::PersistentContactManifold& manifold = cache.getManifold();
-			if (manifold.mCapacity == GU_SPHERE_MANIFOLD_CACHE_SIZE)
-			{
-				mSphereManifoldPool.deallocate(static_cast<Gu::SpherePersistentContactManifold*>(&manifold));
-			}
-			else
-			{
-				mManifoldPool.deallocate(static_cast<Gu::LargePersistentContactManifold*>(&manifold));
-			}
-		}
+			releaseManifold(&cache.getManifold());
 		cache.mCachedData = NULL;
 		cache.mManifoldFlags = 0;
 	}
 }
 
+void PxsContext::releaseManifold(void* manifold)
+{
+	Gu::PersistentContactManifold* pcm = reinterpret_cast<Gu::PersistentContactManifold*>(manifold);
+	if (pcm->mCapacity == GU_SPHERE_MANIFOLD_CACHE_SIZE)
+	{
+		mSphereManifoldPool.deallocate(static_cast<Gu::SpherePersistentContactManifold*>(pcm));
+	}
+	else
+	{
+		mManifoldPool.deallocate(static_cast<Gu::LargePersistentContactManifold*>(pcm));
+	}
+}
+
 void PxsContext::setScratchBlock(void* addr, PxU32 size)
 {
 	mScratchAllocator.setBlock(addr, size);
@@ -421,6 +441,9 @@ void PxsContext::mergeCMDiscreteUpdateResults(PxBaseTask* /*continuation*/)
 				const PxU32 nbModified = threadContext->mModifiedContactPairs[i][j];
 				mSimStats.mNbDiscreteContactPairs[i][j] += nb;
 				mSimStats.mNbModifiedContactPairs[i][j] += nbModified;
+				mSimStats.mNbPCMManifoldHits[i][j] += threadContext->mPCMManifoldHits[i][j];
+				mSimStats.mNbPCMManifoldRefreshes[i][j] += threadContext->mPCMManifoldRefreshes[i][j];
+				mSimStats.mNbPCMManifoldRegenerations[i][j] += threadContext->mPCMManifoldRegenerations[i][j];
 				mSimStats.mNbDiscreteContactPairsTotal += nb;
 			}
 		}
@@ -54,6 +54,7 @@ namespace IG
 		mIslandIds(PX_DEBUG_EXP("IslandSim::mIslandIds")),
 		//mIslandAwake(PX_DEBUG_EXP("IslandSim::mIslandAwake")),
 		//mActiveContactEdges(PX_DEBUG_EXP("IslandSim::mActiveContactEdges")),
+		mIslandReadyForSleeping(PX_DEBUG_EXP("IslandSim::mIslandReadyForSleeping")),
 		mActiveIslands(PX_DEBUG_EXP("IslandSim::mActiveIslands")),
 		mLastMapIndex(0),
 		mActivatingNodes(PX_DEBUG_EXP("IslandSim::mActivatingNodes")),
@@ -884,6 +885,8 @@ void IslandSim::insertNewEdges()
 	{
 		for(PxU32 a = 0; a < mDirtyEdges[i].size(); ++a)
 		{
+			prefetchEdges(mDirtyEdges[i].begin(), a, mDirtyEdges[i].size());
+
 			EdgeIndex edgeIndex = mDirtyEdges[i][a];
 
 			Edge& edge = mEdges[edgeIndex];
@@ -907,6 +910,8 @@ void IslandSim::removeDestroyedEdges()
 
 	for(PxU32 a = 0; a < mDestroyedEdges.size(); ++a)
 	{
+		prefetchEdges(mDestroyedEdges.begin(), a, mDestroyedEdges.size());
+
 		EdgeIndex edgeIndex = mDestroyedEdges[a];
 
 		Edge& edge = mEdges[edgeIndex];
@@ -940,6 +945,8 @@ void IslandSim::processNewEdges()
 	{
 		for(PxU32 a = 0; a < mDirtyEdges[i].size(); ++a)
 		{
+			prefetchEdges(mDirtyEdges[i].begin(), a, mDirtyEdges[i].size());
+
 			EdgeIndex edgeIndex = mDirtyEdges[i][a];
 			Edge& edge = mEdges[edgeIndex];
 			
@@ -1334,7 +1341,7 @@ bool IslandSim::findRoute(NodeIndex startNode, NodeIndex targetNode, IslandId is
 
 
 void IslandSim::processLostEdges(Ps::Array<NodeIndex>& destroyedNodes, bool allowDeactivation, bool permitKinematicDeactivation,
-	PxU32 dirtyNodeLimit)
+	PxU32 dirtyNodeLimit, bool deferDeactivation)
 {
 	PX_UNUSED(dirtyNodeLimit);
 	PX_PROFILE_ZONE("Basic.processLostEdges", getContextId());
@@ -1357,6 +1364,8 @@ void IslandSim::processLostEdges(Ps::Array<NodeIndex>& destroyedNodes, bool allo
 		PX_PROFILE_ZONE("Basic.removeEdgesFromIslands", getContextId());
 		for(PxU32 a = 0; a < mDestroyedEdges.size(); ++a)
 		{
+			prefetchEdges(mDestroyedEdges.begin(), a, mDestroyedEdges.size());
+
 			EdgeIndex lostIndex = mDestroyedEdges[a];
 			Edge& lostEdge = mEdges[lostIndex];
 
@@ -1780,108 +1789,135 @@ void IslandSim::processLostEdges(Ps::Array<NodeIndex>& destroyedNodes, bool allo
 	}
 	//Now we need to produce the list of active edges and nodes!!!
 
+	//KS - deactivation doesn't use the dirty edges so they are reset first, the deactivation may be deferred to other tasks
+	{
+		PX_PROFILE_ZONE("Basic.resetDirtyEdges", getContextId());
+		for (PxU32 i = 0; i < Edge::eEDGE_TYPE_COUNT; ++i)
+		{
+			for (PxU32 a = 0; a < mDirtyEdges[i].size(); ++a)
+			{
+				Edge& edge = mEdges[mDirtyEdges[i][a]];
+				edge.clearInDirtyList();
+			}
+			mDirtyEdges[i].clear(); //All new edges processed
+		}
+	}
+
 	//If we get here, we have a list of active islands. From this, we need to iterate over all active islands and establish if that island
 	//can, in fact, go to sleep. In order to become deactivated, all nodes in the island must be ready for sleeping...
-
 	if(allowDeactivation)
 	{
-		PX_PROFILE_ZONE("Basic.deactivation", getContextId());
-		for(PxU32 a = 0; a < mActiveIslands.size(); a++)
+		prepareDeactivation(permitKinematicDeactivation);
+		if(!deferDeactivation)
 		{
-			IslandId islandId = mActiveIslands[a];
-
-			mIslandAwake.reset(islandId);
+			findIslandsReadyForSleeping(0, mActiveIslands.size());
+			deactivateIslandsReadyForSleeping();
 		}
+	}
+}
 
-		//Loop over the active kinematic nodes and tag all islands touched by active kinematics as awake
-		for(PxU32 a = mActiveKinematicNodes.size(); a > 0; --a)
-		{
-			NodeIndex kinematicIndex = mActiveKinematicNodes[a-1];
+void IslandSim::prepareDeactivation(bool permitKinematicDeactivation)
+{
+	PX_PROFILE_ZONE("Basic.prepareDeactivation", getContextId());
+	for(PxU32 a = 0; a < mActiveIslands.size(); a++)
+	{
+		IslandId islandId = mActiveIslands[a];
+
+		mIslandAwake.reset(islandId);
+	}
+
+	//Loop over the active kinematic nodes and tag all islands touched by active kinematics as awake
+	for(PxU32 a = mActiveKinematicNodes.size(); a > 0; --a)
+	{
+		NodeIndex kinematicIndex = mActiveKinematicNodes[a-1];
 
-			Node& kinematicNode = mNodes[kinematicIndex.index()];
+		Node& kinematicNode = mNodes[kinematicIndex.index()];
 
-			if(kinematicNode.isReadyForSleeping())
+		if(kinematicNode.isReadyForSleeping())
+		{
+			if(permitKinematicDeactivation)
 			{
-				if(permitKinematicDeactivation)
-				{
-					kinematicNode.clearActive();
-					markKinematicInactive(kinematicIndex);
-				}
+				kinematicNode.clearActive();
+				markKinematicInactive(kinematicIndex);
 			}
-			else //if(!kinematicNode.isReadyForSleeping())
+		}
+		else //if(!kinematicNode.isReadyForSleeping())
+		{
+			//KS - if kinematic is active, then wake up all islands the kinematic is touching
+			EdgeInstanceIndex edgeId = kinematicNode.mFirstEdgeIndex;
+			while(edgeId != IG_INVALID_EDGE)
 			{
-				//KS - if kinematic is active, then wake up all islands the kinematic is touching
-				EdgeInstanceIndex edgeId = kinematicNode.mFirstEdgeIndex;
-				while(edgeId != IG_INVALID_EDGE)
+				EdgeInstance& instance = mEdgeInstances[edgeId];
+				//Edge& edge = mEdges[edgeId/2];
+				//Only wake up islands if a connection was present
+				//if(edge.isConnected())
 				{
-					EdgeInstance& instance = mEdgeInstances[edgeId];
-					//Edge& edge = mEdges[edgeId/2];
-					//Only wake up islands if a connection was present
-					//if(edge.isConnected())
+					NodeIndex outNode = mEdgeNodeIndices[edgeId^1];
+					if(outNode.index() != IG_INVALID_NODE)
 					{
-						NodeIndex outNode = mEdgeNodeIndices[edgeId^1];
-						if(outNode.index() != IG_INVALID_NODE)
+						IslandId islandId = mIslandIds[outNode.index()];
+						if(islandId != IG_INVALID_ISLAND)
 						{
-							IslandId islandId = mIslandIds[outNode.index()];
-							if(islandId != IG_INVALID_ISLAND)
-							{
-								mIslandAwake.set(islandId);
-								PX_ASSERT(mIslands[islandId].mActiveIndex != IG_INVALID_ISLAND);
-							}
+							mIslandAwake.set(islandId);
+							PX_ASSERT(mIslands[islandId].mActiveIndex != IG_INVALID_ISLAND);
 						}
 					}
-					edgeId = instance.mNextEdge;
 				}
+				edgeId = instance.mNextEdge;
 			}
 		}
+	}
 
-		for(PxU32 a = mActiveIslands.size(); a > 0; --a)
-		{
-			IslandId islandId = mActiveIslands[a-1];
-
-			Island& island = mIslands[islandId];				
+	mIslandReadyForSleeping.resizeUninitialized(mActiveIslands.size());
+}
 
-			bool canDeactivate = !mIslandAwake.test(islandId);
-			mIslandAwake.set(islandId);			
+void IslandSim::findIslandsReadyForSleeping(PxU32 startIndex, PxU32 nbIslands)
+{
+	PX_PROFILE_ZONE("Basic.findIslandsReadyForSleeping", getContextId());
+	PX_ASSERT(startIndex + nbIslands <= mIslandReadyForSleeping.size());
+	for(PxU32 a = startIndex; a < startIndex + nbIslands; ++a)
+	{
+		const Island& island = mIslands[mActiveIslands[a]];
 
-			//If it was touched by an active kinematic in the above loop, we can't deactivate it.
-			//Therefore, no point in testing the nodes in the island. They must remain awake
-			if(canDeactivate) 
+		//If it was touched by an active kinematic in prepareDeactivation, we can't deactivate it.
+		//Therefore, no point in testing the nodes in the island. They must remain awake
+		bool canDeactivate = !mIslandAwake.test(mActiveIslands[a]);
+		if(canDeactivate)
+		{
+			NodeIndex nodeId = island.mRootNode;
+			while(nodeId.index() != IG_INVALID_NODE)
 			{
-				NodeIndex nodeId = island.mRootNode;
-				while(nodeId.index() != IG_INVALID_NODE)
-				{
-					Node& node = mNodes[nodeId.index()];
-					if(!node.isReadyForSleeping())
-					{
-						canDeactivate = false;
-						break;
-					}
-					nodeId = node.mNextNode;
-				}
-				if(canDeactivate)
+				const Node& node = mNodes[nodeId.index()];
+				if(!node.isReadyForSleeping())
 				{
-					//If all nodes in this island are ready for sleeping and there were no active 
-					//kinematics interacting with the any bodies in the island, we can deactivate the island.
-					deactivateIsland(islandId);
+					canDeactivate = false;
+					break;
 				}
+				nodeId = node.mNextNode;
 			}
 		}
+		mIslandReadyForSleeping[a] = PxU8(canDeactivate);
 	}
+}
+
+void IslandSim::deactivateIslandsReadyForSleeping()
+{
+	PX_PROFILE_ZONE("Basic.deactivation", getContextId());
+	PX_ASSERT(mIslandReadyForSleeping.size() == mActiveIslands.size());
 
+	//Walk backwards, deactivateIsland moves the last active island to the slot it frees, which was already visited,
+	//so the islands that remain to visit keep the index they had in findIslandsReadyForSleeping
+	for(PxU32 a = mActiveIslands.size(); a > 0; --a)
 	{
-		PX_PROFILE_ZONE("Basic.resetDirtyEdges", getContextId());
-		for (PxU32 i = 0; i < Edge::eEDGE_TYPE_COUNT; ++i)
-		{
-			for (PxU32 a = 0; a < mDirtyEdges[i].size(); ++a)
-			{
-				Edge& edge = mEdges[mDirtyEdges[i][a]];
-				edge.clearInDirtyList();
-			}
-			mDirtyEdges[i].clear(); //All new edges processed
-		}
-	}
+		IslandId islandId = mActiveIslands[a-1];
+		mIslandAwake.set(islandId);
 
+		//If all nodes in this island are ready for sleeping and there were no active 
+		//kinematics interacting with the any bodies in the island, we can deactivate the island.
+		if(mIslandReadyForSleeping[a-1])
+			deactivateIsland(islandId);
+	}
+	mIslandReadyForSleeping.forceSize_Unsafe(0);
 }
 
 
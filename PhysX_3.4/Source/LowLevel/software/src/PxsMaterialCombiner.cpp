@@ -32,6 +32,7 @@
 #include "PsMathUtils.h"
 #include "CmPhysXCommon.h"
 #include "PsFoundation.h"
+#include "foundation/PxMemory.h"
 
 namespace physx   
 {
@@ -99,4 +100,59 @@ PxsMaterialCombiner::PxsCombinedMaterial PxsMaterialCombiner::combineIsotropicFr
 
 	return dest;
 }
+
+
+static PX_FORCE_INLINE void combineMaterials(const PxsMaterialData& data0, const PxsMaterialData& data1, PxsCombinedMaterialData& dest)
+{
+	PxsMaterialCombiner combiner(1.0f, 1.0f);
+	const PxsMaterialCombiner::PxsCombinedMaterial combinedMat = combiner.combineIsotropicFriction(data0, data1);
+	dest.staticFriction = combinedMat.staFriction;
+	dest.dynamicFriction = combinedMat.dynFriction;
+	dest.restitution = PxsMaterialCombiner::combineRestitution(data0, data1);
+	dest.flags = combinedMat.flags;
+}
+
+
+void PxsMaterialManager::updateCombinedMaterials(PxU32 materialIndex)
+{
+	if(materialIndex >= PXS_MAX_COMBINED_MATERIALS)
+		return;	// pairs with this material get combined at runtime
+
+	if(materialIndex >= combinedMaterialCount)
+	{
+		// grow the table, rows and columns are only needed up to the materials the manager has room for
+		const PxU32 oldCount = combinedMaterialCount;
+		const PxU32 newCount = PxMin(PxMin((materialIndex + 16) & ~15, PxU32(PXS_MAX_COMBINED_MATERIALS)), maxMaterials);
+		PX_ASSERT(newCount > materialIndex);
+
+		PxsCombinedMaterialData* table = reinterpret_cast<PxsCombinedMaterialData*>(physx::shdfnd::AlignedAllocator<16>().allocate(sizeof(PxsCombinedMaterialData)*newCount*newCount, __FILE__, __LINE__));
+		PxMemZero(table, sizeof(PxsCombinedMaterialData)*newCount*newCount);
+		for(PxU32 i=0; i<oldCount; ++i)
+			PxMemCopy(table + i*newCount, combinedMaterials + i*oldCount, sizeof(PxsCombinedMaterialData)*oldCount);
+
+		physx::shdfnd::AlignedAllocator<16>().deallocate(combinedMaterials);
+		combinedMaterials = table;
+		combinedMaterialCount = newCount;
+
+		// the materials in the new range other than this one were registered while the table was smaller
+		for(PxU32 i=oldCount; i<newCount; ++i)
+		{
+			if(i != materialIndex && materials[i].getMaterialIndex() != MATERIAL_INVALID_HANDLE)
+				updateCombinedMaterials(i);
+		}
+	}
+
+	// combining is symmetric, the row and the column of the material hold the same values
+	const PxU32 count = combinedMaterialCount;
+	const PxsMaterialData& data0 = materials[materialIndex];
+	for(PxU32 i=0; i<count; ++i)
+	{
+		if(materials[i].getMaterialIndex() == MATERIAL_INVALID_HANDLE)
+			continue;
+
+		PxsCombinedMaterialData& dest = combinedMaterials[materialIndex*count + i];
+		combineMaterials(data0, materials[i], dest);
+		combinedMaterials[i*count + materialIndex] = dest;
+	}
+}
 }
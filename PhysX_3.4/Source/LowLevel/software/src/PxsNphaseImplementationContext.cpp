@@ -30,6 +30,7 @@
        
 #include "PxsContext.h"
 #include "CmFlushPool.h"
+#include "CmParallelFor.h"
 #include "PxsSimpleIslandManager.h"
 
 #if PX_SUPPORT_GPU_PHYSX
@@ -44,23 +45,51 @@
 #include "PxvDynamics.h"
 
 #include "PxcNpContactPrepShared.h"
+#include "PsSort.h"
+#include "PsTime.h"
 
 using namespace physx;
 using namespace physx::shdfnd;
 
+// a mesh or heightfield pair that took longer than this in the last narrow phase (in tens of ns) is processed first
+// in the next one. The regular chunks are claimed in pair order, so a slow pair near the end of the array would otherwise
+// start late and keep one worker busy long after the others ran out of pairs.
+static const PxU32 SLOW_PAIR_COST = 5000;
+// max number of pairs scheduled first, only the slowest ones matter
+static const PxU32 MAX_SLOW_PAIRS = 64;
+// set in the cost of the pairs scheduled first for the current frame, the regular chunks skip them
+static const PxU32 SCHEDULED_FIRST = ~PXS_PAIR_COST_MASK;
+
+// the pairs scheduled first, shared by the narrow phase tasks. They are handed out one at a time.
+struct PxsSlowPairs
+{
+	const PxU32*	mIndices;
+	PxU32			mCount;
+	volatile PxI32	mNext;
+	volatile PxI32*	mFound;		// set when a pair goes over SLOW_PAIR_COST
+};
+
 
 class PxsCMUpdateTask : public Cm::Task
 {
 public:
 
-	static const PxU32 BATCH_SIZE = 128;
+	// Bounds of the chunks claimed from the shared range, see Cm::ParallelForRange
+	static const PxU32 MIN_BATCH_SIZE = 32;
+	static const PxU32 BATCH_SIZE = 256;
 
-	PxsCMUpdateTask(PxsContext* context, PxReal dt, PxsContactManager** cmArray, PxsContactManagerOutput* cmOutputs, Gu::Cache* caches, PxU32 cmCount, PxContactModifyCallback* callback) :
+	PxsCMUpdateTask(PxsContext* context, PxReal dt, PxsContactManager** cmArray, PxsContactManagerOutput* cmOutputs, Gu::Cache* caches, PxcNpFrozenPair* frozenPairs,
+		PxU32* costs, Cm::ParallelForRange* range, PxsSlowPairs* slowPairs, PxContactModifyCallback* callback) :
 			Cm::Task	(context->getContextId()),
 			mCmArray	(cmArray),
 			mCmOutputs	(cmOutputs),
 			mCaches		(caches),
-			mCmCount	(cmCount),
+			mFrozenPairs(frozenPairs),
+			mCosts		(costs),
+			mCmCount	(0),
+			mSkipSlowPairs(false),
+			mRange		(range),
+			mSlowPairs	(slowPairs),
 			mDt			(dt),
 			mContext	(context),
 			mCallback	(callback)
@@ -77,10 +106,16 @@ public:
 
 protected:	
 	//PxsContactManager*	mCmArray[BATCH_SIZE];
+	// Current chunk, the range hands out the chunks of the arrays passed to the constructor
 	PxsContactManager**	mCmArray;
 	PxsContactManagerOutput* mCmOutputs;
 	Gu::Cache* mCaches;
+	PxcNpFrozenPair*	mFrozenPairs;
+	PxU32*				mCosts;
 	PxU32				mCmCount;
+	bool				mSkipSlowPairs;	// the slow pairs of the chunk were already handed out on their own
+	Cm::ParallelForRange* mRange;
+	PxsSlowPairs*		mSlowPairs;
 	PxReal				mDt;		//we could probably retrieve from context to save space?
 	PxsContext*			mContext;
 	PxContactModifyCallback* mCallback;
@@ -104,9 +139,9 @@ void PxsCMUpdateTask::release()
 class PxsCMDiscreteUpdateTask : public PxsCMUpdateTask
 {
 public:
-	PxsCMDiscreteUpdateTask(PxsContext* context, PxReal dt, PxsContactManager** cms, PxsContactManagerOutput* cmOutputs, Gu::Cache* caches, PxU32 nbCms,
-		PxContactModifyCallback* callback):
-	  PxsCMUpdateTask(context, dt, cms, cmOutputs, caches, nbCms, callback) 
+	PxsCMDiscreteUpdateTask(PxsContext* context, PxReal dt, PxsContactManager** cms, PxsContactManagerOutput* cmOutputs, Gu::Cache* caches, PxcNpFrozenPair* frozenPairs,
+		PxU32* costs, Cm::ParallelForRange* range, PxsSlowPairs* slowPairs, PxContactModifyCallback* callback):
+	  PxsCMUpdateTask(context, dt, cms, cmOutputs, caches, frozenPairs, costs, range, slowPairs, callback) 
 	{}
 
 	virtual ~PxsCMDiscreteUpdateTask()
@@ -187,7 +222,14 @@ public:
 				}
 			}
 	
-			mCallback->onContactModify(mModifiablePairArray, nbModifiableManagers);
+			// the batches of the tasks don't share pairs, the lock is only there for callbacks that aren't thread-safe
+			if(mContext->getParallelContactModification())
+				mCallback->onContactModify(mModifiablePairArray, nbModifiableManagers);
+			else
+			{
+				Ps::Mutex::ScopedLock lock(mContext->getContactModifyLock());
+				mCallback->onContactModify(mModifiablePairArray, nbModifiableManagers);
+			}
 		}
 	
 		for(PxU32 i = 0; i < nbModifiableManagers; ++i)
@@ -390,7 +432,53 @@ public:
 	}
 
 
-	template < void (*NarrowPhase)(PxcNpThreadContext&, const PxcNpWorkUnit&, Gu::Cache&, PxsContactManagerOutput&)>
+	// computes the order in which the pairs of the batch are processed, grouped by geometry types so that consecutive
+	// pairs go through the same contact functions. This is a counting sort, so pairs of the same types keep their order.
+	// Returns false if the batch only contains one kind of pair, in which case the order is not written.
+	static bool sortCmsByType(PxsContactManager** PX_RESTRICT cmArray, PxU32 nb, PxU32* PX_RESTRICT order)
+	{
+		const PxU32 nbTypes = PxGeometryType::eGEOMETRY_COUNT;
+		PxU32 counts[nbTypes*nbTypes+1];
+		PxMemZero(counts, sizeof(counts));
+
+		PX_ALLOCA(keys, PxU8, nb);
+		PxU32 firstKey = 0xffffffff;
+		bool sameKeys = true;
+		for(PxU32 i=0;i<nb;i++)
+		{
+			// null entries go first, they are skipped anyway
+			PxU32 key = 0;
+			if(cmArray[i])
+			{
+				const PxcNpWorkUnit& unit = cmArray[i]->getWorkUnit();
+				const PxU32 type0 = PxMin(unit.geomType0, unit.geomType1);
+				const PxU32 type1 = PxMax(unit.geomType0, unit.geomType1);
+				key = 1 + type0*nbTypes + type1;
+			}
+			if(i==0)
+				firstKey = key;
+			else if(key!=firstKey)
+				sameKeys = false;
+			keys[i] = PxU8(key);
+			counts[key]++;
+		}
+		if(sameKeys)
+			return false;
+
+		PxU32 offset = 0;
+		for(PxU32 i=0;i<nbTypes*nbTypes+1;i++)
+		{
+			const PxU32 count = counts[i];
+			counts[i] = offset;
+			offset += count;
+		}
+
+		for(PxU32 i=0;i<nb;i++)
+			order[counts[keys[i]]++] = i;
+		return true;
+	}
+
+	template < void (*NarrowPhase)(PxcNpThreadContext&, const PxcNpWorkUnit&, Gu::Cache&, PxsContactManagerOutput&, PxcNpFrozenPair&)>
 	void processCms(PxcNpThreadContext* threadContext)
 	{
 		// PT: use local variables to avoid reading class members N times, if possible
@@ -408,21 +496,32 @@ public:
 		PX_ALLOCA(modifiableIndices, PxU32, nb);
 		PxU32 modifiableCount = 0;
 
-		for(PxU32 i=0;i<nb;i++)
+		PX_ALLOCA(order, PxU32, nb);
+		const bool sorted = sortCmsByType(cmArray, nb, order);
+
+		// with cost profiling every pair is timed, for PxScene::getCostProfile. The costs of the other pairs are left
+		// as they are once it is disabled, which at worst schedules them first for a frame.
+		const bool timeAllPairs = mContext->getCostProfiling();
+
+		for(PxU32 j=0;j<nb;j++)
 		{
-			const PxU32 prefetch1 = PxMin(i + 1, nb - 1);
-			const PxU32 prefetch2 = PxMin(i + 2, nb - 1);
+			const PxU32 i = sorted ? order[j] : j;
+			const PxU32 prefetch1 = sorted ? order[PxMin(j + 1, nb - 1)] : PxMin(j + 1, nb - 1);
+			const PxU32 prefetch2 = sorted ? order[PxMin(j + 2, nb - 1)] : PxMin(j + 2, nb - 1);
 
 			Ps::prefetchLine(cmArray[prefetch2]);
 			Ps::prefetchLine(&mCmOutputs[prefetch2]);
-			Ps::prefetchLine(cmArray[prefetch1]->getWorkUnit().shapeCore0);
-			Ps::prefetchLine(cmArray[prefetch1]->getWorkUnit().shapeCore1);
-			Ps::prefetchLine(&threadContext->mTransformCache->getTransformCache(cmArray[prefetch1]->getWorkUnit().mTransformCache0));
-			Ps::prefetchLine(&threadContext->mTransformCache->getTransformCache(cmArray[prefetch1]->getWorkUnit().mTransformCache1));
+			if(cmArray[prefetch1])
+			{
+				Ps::prefetchLine(cmArray[prefetch1]->getWorkUnit().shapeCore0);
+				Ps::prefetchLine(cmArray[prefetch1]->getWorkUnit().shapeCore1);
+				Ps::prefetchLine(&threadContext->mTransformCache->getTransformCache(cmArray[prefetch1]->getWorkUnit().mTransformCache0));
+				Ps::prefetchLine(&threadContext->mTransformCache->getTransformCache(cmArray[prefetch1]->getWorkUnit().mTransformCache1));
+			}
 
 			PxsContactManager* cm = cmArray[i];			
 
-			if(cm)
+			if(cm && !(mSkipSlowPairs && (mCosts[i] & SCHEDULED_FIRST)))
 			{
 				PxsContactManagerOutput& output = mCmOutputs[i];
 				PxcNpWorkUnit& unit = cm->getWorkUnit();
@@ -436,7 +535,14 @@ public:
 
 				Gu::Cache& cache = mCaches[i];
 
-				NarrowPhase(*threadContext, unit, cache, output);
+				// only the pairs against meshes and heightfields can be slow enough to matter, the others are not timed
+				const bool timed = timeAllPairs || PxMax(unit.geomType0, unit.geomType1) >= PxGeometryType::eTRIANGLEMESH;
+				const PxU64 startTime = timed ? Ps::Time::getCurrentCounterValue() : 0;
+
+				NarrowPhase(*threadContext, unit, cache, output, mFrozenPairs[i]);
+
+				if(timed)
+					recordCost(mCosts[i], startTime);
 				
 				PxU16 newTouch = Ps::to8(output.statusFlag & PxsContactManagerStatusFlag::eHAS_TOUCH);
 				
@@ -479,6 +585,9 @@ public:
 
 		if(modifiableCount)
 		{
+			// contact modification still sees the pairs in batch order
+			if(sorted)
+				Ps::sort<PxU32>(modifiableIndices, modifiableCount);
 			runModifiableContactManagers(modifiableIndices, modifiableCount, *threadContext, foundPatchCount, lostPatchCount, maxPatches);
 		}
 
@@ -492,6 +601,26 @@ public:
 		threadContext->mMaxPatches = maxPatches;
 	}
 
+	PX_FORCE_INLINE void recordCost(PxU32& cost, PxU64 startTime)
+	{
+		const PxU64 elapsed = Ps::Time::getBootCounterFrequency().toTensOfNanos(Ps::Time::getCurrentCounterValue() - startTime);
+		const PxU32 newCost = PxU32(PxMin(elapsed, PxU64(~SCHEDULED_FIRST)));
+		cost = newCost | (cost & SCHEDULED_FIRST);
+		if(newCost >= SLOW_PAIR_COST && !*mSlowPairs->mFound)
+			Ps::atomicExchange(mSlowPairs->mFound, 1);
+	}
+
+	PX_FORCE_INLINE void setChunk(PxU32 start, PxU32 nb, PxsContactManager** cmArray, PxsContactManagerOutput* cmOutputs, Gu::Cache* caches,
+		PxcNpFrozenPair* frozenPairs, PxU32* costs)
+	{
+		mCmArray = cmArray + start;
+		mCmOutputs = cmOutputs + start;
+		mCaches = caches + start;
+		mFrozenPairs = frozenPairs + start;
+		mCosts = costs + start;
+		mCmCount = nb;
+	}
+
 	virtual void runInternal()
 	{
 		PX_PROFILE_ZONE("Sim.narrowPhase", mContext->getContextId());
@@ -502,18 +631,49 @@ public:
 
 		const bool pcm = mContext->getPCM();
 		threadContext->mPCM = pcm;
+		threadContext->mAdaptivePCMThresholds = pcm && mContext->getAdaptivePCMThresholds();
 		threadContext->mCreateAveragePoint = mContext->getCreateAveragePoint();
+		threadContext->mCompactContacts = mContext->getCompactContacts();
 		threadContext->mContactCache = mContext->getContactCacheFlag();
 		threadContext->mTransformCache = &mContext->getTransformCache();
 		threadContext->mContactDistance = mContext->getContactDistance();
 
-		if(pcm)
+		PxsContactManager** cmArray = mCmArray;
+		PxsContactManagerOutput* cmOutputs = mCmOutputs;
+		Gu::Cache* caches = mCaches;
+		PxcNpFrozenPair* frozenPairs = mFrozenPairs;
+		PxU32* costs = mCosts;
+
+		// the slow pairs first, one at a time, so that they start right away on as many workers as possible
+		PxsSlowPairs& slowPairs = *mSlowPairs;
+		while(true)
 		{
-			processCms<PxcDiscreteNarrowPhasePCM>(threadContext);
+			const PxU32 index = PxU32(Ps::atomicIncrement(&slowPairs.mNext) - 1);
+			if(index >= slowPairs.mCount)
+				break;
+
+			setChunk(slowPairs.mIndices[index], 1, cmArray, cmOutputs, caches, frozenPairs, costs);
+			if(pcm)
+				processCms<PxcDiscreteNarrowPhasePCM>(threadContext);
+			else
+				processCms<PxcDiscreteNarrowPhase>(threadContext);
 		}
-		else
+
+		mSkipSlowPairs = slowPairs.mCount != 0;
+
+		PxU32 start, nb;
+		while(mRange->claim(start, nb))
 		{
-			processCms<PxcDiscreteNarrowPhase>(threadContext);
+			setChunk(start, nb, cmArray, cmOutputs, caches, frozenPairs, costs);
+
+			if(pcm)
+			{
+				processCms<PxcDiscreteNarrowPhasePCM>(threadContext);
+			}
+			else
+			{
+				processCms<PxcDiscreteNarrowPhase>(threadContext);
+			}
 		}
 
 		mContext->putNpThreadContext(threadContext);
@@ -525,48 +685,105 @@ public:
 	}
 };
 
-void PxsNphaseImplementationContext::processContactManager(PxReal dt, PxsContactManagerOutput* cmOutputs, PxBaseTask* continuation)
+// Spawns one task per worker (fewer for small scenes), the tasks share the pairs through a Cm::ParallelForRange
+// after processing the slow pairs, if any
+static void spawnNarrowPhaseTasks(PxsContext& context, PxReal dt, PxsContactManager** cms, PxsContactManagerOutput* cmOutputs, Gu::Cache* caches,
+	PxcNpFrozenPair* frozenPairs, PxU32* costs, PxU32 nbCms, const PxU32* slowIndices, PxU32 nbSlow, volatile PxI32* slowPairsFound,
+	PxContactModifyCallback* callback, PxBaseTask* continuation)
 {
-		//Iterate all active contact managers
-	mContext.mTaskPool.lock();
-	const PxU32 nbCmsToProcess = mNarrowPhasePairs.mContactManagerMapping.size();
-
-	for(PxU32 a = 0; a < nbCmsToProcess;)
+	const PxU32 nbTasks = Cm::getParallelForTaskCount(nbCms, continuation->getTaskManager(), PxsCMUpdateTask::MIN_BATCH_SIZE);
+	if(!nbTasks)
+		return;
+
+	Cm::FlushPool& taskPool = context.getTaskPool();
+	taskPool.lock();
+
+	Cm::ParallelForRange* range = PX_PLACEMENT_NEW(taskPool.allocateNotThreadSafe(sizeof(Cm::ParallelForRange)), Cm::ParallelForRange)();
+	range->init(nbCms, nbTasks, PxsCMUpdateTask::MIN_BATCH_SIZE, PxsCMUpdateTask::BATCH_SIZE);
+
+	PxsSlowPairs* slowPairs = reinterpret_cast<PxsSlowPairs*>(taskPool.allocateNotThreadSafe(sizeof(PxsSlowPairs)));
+	slowPairs->mIndices = NULL;
+	slowPairs->mCount = nbSlow;
+	slowPairs->mNext = 0;
+	slowPairs->mFound = slowPairsFound;
+	if(nbSlow)
 	{
-		void* ptr = mContext.mTaskPool.allocateNotThreadSafe(sizeof(PxsCMDiscreteUpdateTask));
-		PxU32 nbToProcess = PxMin(nbCmsToProcess - a, PxsCMUpdateTask::BATCH_SIZE);
-		PxsCMDiscreteUpdateTask* task = PX_PLACEMENT_NEW(ptr, PxsCMDiscreteUpdateTask)(&mContext, dt, mNarrowPhasePairs.mContactManagerMapping.begin() + a, 
-			cmOutputs + a, mNarrowPhasePairs.mCaches.begin() + a, nbToProcess, mModifyCallback);
+		PxU32* indices = reinterpret_cast<PxU32*>(taskPool.allocateNotThreadSafe(sizeof(PxU32)*nbSlow));
+		PxMemCopy(indices, slowIndices, sizeof(PxU32)*nbSlow);
+		slowPairs->mIndices = indices;
+	}
 
-		a += nbToProcess;
+	for(PxU32 a = 0; a < nbTasks; ++a)
+	{
+		void* ptr = taskPool.allocateNotThreadSafe(sizeof(PxsCMDiscreteUpdateTask));
+		PxsCMDiscreteUpdateTask* task = PX_PLACEMENT_NEW(ptr, PxsCMDiscreteUpdateTask)(&context, dt, cms, cmOutputs, caches, frozenPairs, costs, range, slowPairs, callback);
 
 		task->setContinuation(continuation);
 		task->removeReference();
 	}
-	mContext.mTaskPool.unlock();
+	taskPool.unlock();
 }
 
-void PxsNphaseImplementationContext::processContactManagerSecondPass(PxReal dt, PxBaseTask* continuation)
+// collects the slowest pairs of the last frame, slowest first, and marks them in their cost so that the regular chunks skip them.
+// The costs are only scanned when a task found a slow pair, which doesn't happen in scenes without large meshes or heightfields.
+PxU32 PxsNphaseImplementationContext::selectSlowPairs(PxU32* indices, PxU32 maxIndices)
 {
-		//Iterate all active contact managers
-	mContext.mTaskPool.lock();
+	if(!mSlowPairsFound)
+		return 0;
+	mSlowPairsFound = 0;
+
+	PxU32* costs = mNarrowPhasePairs.mCosts.begin();
+	const PxU32 nbPairs = mNarrowPhasePairs.mCosts.size();
+	PxU32 nb = 0;
+	for(PxU32 i=0;i<nbPairs;i++)
+	{
+		const PxU32 cost = costs[i] & ~SCHEDULED_FIRST;
+		costs[i] = cost;
+		if(cost < SLOW_PAIR_COST || (nb == maxIndices && cost <= costs[indices[nb-1]]))
+			continue;
+
+		// insertion in the sorted list, dropping the fastest pair when it is full. The listed pairs were already
+		// visited so their costs are not marked anymore.
+		PxU32 j = nb < maxIndices ? nb++ : nb - 1;
+		while(j && costs[indices[j-1]] < cost)
+		{
+			indices[j] = indices[j-1];
+			j--;
+		}
+		indices[j] = i;
+	}
 
-	const PxU32 nbCmsToProcess = mNewNarrowPhasePairs.mContactManagerMapping.size();
+	for(PxU32 i=0;i<nb;i++)
+		costs[indices[i]] |= SCHEDULED_FIRST;
+	return nb;
+}
 
-	for(PxU32 a = 0; a < nbCmsToProcess;)
-	{
-		void* ptr = mContext.mTaskPool.allocateNotThreadSafe(sizeof(PxsCMDiscreteUpdateTask));
-		PxU32 nbToProcess = PxMin(nbCmsToProcess - a, PxsCMUpdateTask::BATCH_SIZE);
-		PxsCMDiscreteUpdateTask* task = PX_PLACEMENT_NEW(ptr, PxsCMDiscreteUpdateTask)(&mContext, dt, mNewNarrowPhasePairs.mContactManagerMapping.begin() + a, 
-			mNewNarrowPhasePairs.mOutputContactManagers.begin() + a, mNewNarrowPhasePairs.mCaches.begin() + a, nbToProcess,
-			mModifyCallback);
+void PxsNphaseImplementationContext::processContactManager(PxReal dt, PxsContactManagerOutput* cmOutputs, PxBaseTask* continuation)
+{
+	PxU32 slowIndices[MAX_SLOW_PAIRS];
+	const PxU32 nbSlow = selectSlowPairs(slowIndices, MAX_SLOW_PAIRS);
 
-		a += nbToProcess;
+		//Iterate all active contact managers
+	spawnNarrowPhaseTasks(mContext, dt, mNarrowPhasePairs.mContactManagerMapping.begin(), cmOutputs, mNarrowPhasePairs.mCaches.begin(),
+		mNarrowPhasePairs.mFrozenPairs.begin(), mNarrowPhasePairs.mCosts.begin(), mNarrowPhasePairs.mContactManagerMapping.size(),
+		slowIndices, nbSlow, &mSlowPairsFound, mModifyCallback, continuation);
+}
 
-		task->setContinuation(continuation);
-		task->removeReference();
-	}
-	mContext.mTaskPool.unlock();
+PxU32 PxsNphaseImplementationContext::getPairCosts(PxsContactManager* const*& managers, const PxU32*& costs) const
+{
+	// the pairs of the second pass were appended to mNarrowPhasePairs along with their costs
+	managers = mNarrowPhasePairs.mContactManagerMapping.begin();
+	costs = mNarrowPhasePairs.mCosts.begin();
+	return mNarrowPhasePairs.mContactManagerMapping.size();
+}
+
+void PxsNphaseImplementationContext::processContactManagerSecondPass(PxReal dt, PxBaseTask* continuation)
+{
+	// the new pairs were never timed
+		//Iterate all active contact managers
+	spawnNarrowPhaseTasks(mContext, dt, mNewNarrowPhasePairs.mContactManagerMapping.begin(), mNewNarrowPhasePairs.mOutputContactManagers.begin(),
+		mNewNarrowPhasePairs.mCaches.begin(), mNewNarrowPhasePairs.mFrozenPairs.begin(), mNewNarrowPhasePairs.mCosts.begin(),
+		mNewNarrowPhasePairs.mContactManagerMapping.size(), NULL, 0, &mSlowPairsFound, mModifyCallback, continuation);
 }
 
 void PxsNphaseImplementationContext::updateContactManager(PxReal dt, bool /*hasBoundsArrayChanged*/, bool /*hasContactDistanceChanged*/, PxBaseTask* continuation, PxBaseTask* firstPassNpContinuation)
@@ -628,6 +845,11 @@ void PxsNphaseImplementationContext::registerContactManagers(PxsContactManager**
 }
 
 void PxsNphaseImplementationContext::registerContactManager(PxsContactManager* cm, PxI32 touching, PxU32 patchCount)
+{
+	registerWokenContactManager(cm, touching, patchCount, NULL);
+}
+
+void PxsNphaseImplementationContext::registerWokenContactManager(PxsContactManager* cm, PxI32 touching, PxU32 patchCount, void* sleepingState)
 {
 	PxcNpWorkUnit& workUnit = cm->getWorkUnit();
 	PxsContactManagerOutput output;
@@ -637,7 +859,7 @@ void PxsNphaseImplementationContext::registerContactManager(PxsContactManager* c
 
 	Gu::Cache cache;
 
-	mContext.createCache(cache, cm, geomType0, geomType1);
+	mContext.createCache(cache, cm, geomType0, geomType1, sleepingState);
 
 	PxMemZero(&output, sizeof(output));
 	output.nbPatches = Ps::to8(patchCount);
@@ -661,6 +883,10 @@ void PxsNphaseImplementationContext::registerContactManager(PxsContactManager* c
 
 	mNewNarrowPhasePairs.mOutputContactManagers.pushBack(output);
 	mNewNarrowPhasePairs.mCaches.pushBack(cache);
+	PxcNpFrozenPair frozenPair;
+	frozenPair.invalidate();
+	mNewNarrowPhasePairs.mFrozenPairs.pushBack(frozenPair);
+	mNewNarrowPhasePairs.mCosts.pushBack(0);
 	mNewNarrowPhasePairs.mContactManagerMapping.pushBack(cm);
 	PxU32 newSz = mNewNarrowPhasePairs.mOutputContactManagers.size();
 	cm->getWorkUnit().mNpIndex = mNewNarrowPhasePairs.computeId(newSz - 1) | PxsContactManagerBase::NEW_CONTACT_MANAGER_MASK;
@@ -704,6 +930,33 @@ void PxsNphaseImplementationContext::unregisterContactManager(PxsContactManager*
 	}
 }
 
+void* PxsNphaseImplementationContext::unregisterSleepingContactManager(PxsContactManager* cm)
+{
+	const PxU32 index = cm->getWorkUnit().mNpIndex;
+	PX_ASSERT(index != 0xFFffFFff);
+
+	PxsContactManagers& managers = (index & PxsContactManagerBase::NEW_CONTACT_MANAGER_MASK) ? mNewNarrowPhasePairs : mNarrowPhasePairs;
+	Gu::Cache& cache = managers.mCaches[PxsContactManagerBase::computeIndexFromId(index & (~PxsContactManagerBase::NEW_CONTACT_MANAGER_MASK))];
+
+	//Only the single manifolds come from the pools, the multi manifolds and the friction data live in the per frame streams
+	void* manifold = NULL;
+	if(cache.isManifold() && !cache.isMultiManifold())
+	{
+		manifold = cache.mCachedData;
+		cache.mCachedData = NULL;
+		cache.mManifoldFlags = 0;
+	}
+
+	unregisterContactManager(cm);
+	return manifold;
+}
+
+void PxsNphaseImplementationContext::releaseSleepingContactState(void* sleepingState)
+{
+	if(sleepingState)
+		mContext.releaseManifold(sleepingState);
+}
+
 void PxsNphaseImplementationContext::refreshContactManager(PxsContactManager* cm)
 {
 	PxcNpWorkUnit& unit = cm->getWorkUnit();
@@ -797,15 +1050,21 @@ void PxsNphaseImplementationContext::appendContactManagers()
 		mNarrowPhasePairs.mContactManagerMapping.reserve(newSz);
 		mNarrowPhasePairs.mOutputContactManagers.reserve(newSz);
 		mNarrowPhasePairs.mCaches.reserve(newSz);
+		mNarrowPhasePairs.mFrozenPairs.reserve(newSz);
+		mNarrowPhasePairs.mCosts.reserve(newSz);
 	}
 
 	mNarrowPhasePairs.mContactManagerMapping.forceSize_Unsafe(newSize);
 	mNarrowPhasePairs.mOutputContactManagers.forceSize_Unsafe(newSize);
 	mNarrowPhasePairs.mCaches.forceSize_Unsafe(newSize);
+	mNarrowPhasePairs.mFrozenPairs.forceSize_Unsafe(newSize);
+	mNarrowPhasePairs.mCosts.forceSize_Unsafe(newSize);
 
 	PxMemCopy(mNarrowPhasePairs.mContactManagerMapping.begin() + existingSize, mNewNarrowPhasePairs.mContactManagerMapping.begin(), sizeof(PxsContactManager*)*nbToAdd);
 	PxMemCopy(mNarrowPhasePairs.mOutputContactManagers.begin() + existingSize, mNewNarrowPhasePairs.mOutputContactManagers.begin(), sizeof(PxsContactManagerOutput)*nbToAdd);
 	PxMemCopy(mNarrowPhasePairs.mCaches.begin() + existingSize, mNewNarrowPhasePairs.mCaches.begin(), sizeof(Gu::Cache)*nbToAdd);
+	PxMemCopy(mNarrowPhasePairs.mFrozenPairs.begin() + existingSize, mNewNarrowPhasePairs.mFrozenPairs.begin(), sizeof(PxcNpFrozenPair)*nbToAdd);
+	PxMemCopy(mNarrowPhasePairs.mCosts.begin() + existingSize, mNewNarrowPhasePairs.mCosts.begin(), sizeof(PxU32)*nbToAdd);
 
 	PxU32* edgeNodeIndices = mIslandSim->getEdgeNodeIndexPtr();
 
@@ -849,16 +1108,22 @@ void PxsNphaseImplementationContext::appendContactManagersFallback(PxsContactMan
 
 		mNarrowPhasePairs.mContactManagerMapping.reserve(newSz);
 		mNarrowPhasePairs.mCaches.reserve(newSz);
+		mNarrowPhasePairs.mFrozenPairs.reserve(newSz);
+		mNarrowPhasePairs.mCosts.reserve(newSz);
 		/*mNarrowPhasePairs.mLostFoundPairsCms.reserve(2 * newSz);
 		mNarrowPhasePairs.mLostFoundPairsOutputData.reserve(2*newSz);*/
 	}
 
 	mNarrowPhasePairs.mContactManagerMapping.forceSize_Unsafe(newSize);
 	mNarrowPhasePairs.mCaches.forceSize_Unsafe(newSize);
+	mNarrowPhasePairs.mFrozenPairs.forceSize_Unsafe(newSize);
+	mNarrowPhasePairs.mCosts.forceSize_Unsafe(newSize);
 
 	PxMemCopy(mNarrowPhasePairs.mContactManagerMapping.begin() + existingSize, mNewNarrowPhasePairs.mContactManagerMapping.begin(), sizeof(PxsContactManager*)*nbToAdd);
 	PxMemCopy(cmOutputs + existingSize, mNewNarrowPhasePairs.mOutputContactManagers.begin(), sizeof(PxsContactManagerOutput)*nbToAdd);
 	PxMemCopy(mNarrowPhasePairs.mCaches.begin() + existingSize, mNewNarrowPhasePairs.mCaches.begin(), sizeof(Gu::Cache)*nbToAdd);
+	PxMemCopy(mNarrowPhasePairs.mFrozenPairs.begin() + existingSize, mNewNarrowPhasePairs.mFrozenPairs.begin(), sizeof(PxcNpFrozenPair)*nbToAdd);
+	PxMemCopy(mNarrowPhasePairs.mCosts.begin() + existingSize, mNewNarrowPhasePairs.mCosts.begin(), sizeof(PxU32)*nbToAdd);
 
 	PxU32* edgeNodeIndices = mIslandSim->getEdgeNodeIndexPtr();
 
@@ -921,6 +1186,8 @@ void PxsNphaseImplementationContext::unregisterContactManagerInternal(PxU32 npIn
 
 	managers.mContactManagerMapping[index] = replaceManager;
 	managers.mCaches[index] = managers.mCaches[replaceIndex];
+	managers.mFrozenPairs[index] = managers.mFrozenPairs[replaceIndex];
+	managers.mCosts[index] = managers.mCosts[replaceIndex];
 	cmOutputs[index] = cmOutputs[replaceIndex];
 
 	PxU32* edgeNodeIndices = mIslandSim->getEdgeNodeIndexPtr();
@@ -942,6 +1209,8 @@ void PxsNphaseImplementationContext::unregisterContactManagerInternal(PxU32 npIn
 
 	managers.mContactManagerMapping.forceSize_Unsafe(replaceIndex);
 	managers.mCaches.forceSize_Unsafe(replaceIndex);
+	managers.mFrozenPairs.forceSize_Unsafe(replaceIndex);
+	managers.mCosts.forceSize_Unsafe(replaceIndex);
 }
 
 PxsContactManagerOutput& PxsNphaseImplementationContext::getNewContactManagerOutput(PxU32 npId)
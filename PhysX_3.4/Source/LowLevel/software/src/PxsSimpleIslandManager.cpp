@@ -40,7 +40,16 @@ namespace physx
 namespace IG
 {
 
-	ThirdPassTask::ThirdPassTask(PxU64 contextID, SimpleIslandManager& islandManager, IslandSim& islandSim) : Cm::Task(contextID), mIslandManager(islandManager), mIslandSim(islandSim)
+	IslandSleepTask::IslandSleepTask(PxU64 contextID, IslandSim& islandSim, Cm::ParallelForRange& range) : Cm::Task(contextID), mIslandSim(islandSim), mRange(range)
+	{
+	}
+
+	DeactivateIslandsTask::DeactivateIslandsTask(PxU64 contextID, IslandSim& islandSim) : Cm::Task(contextID), mIslandSim(islandSim)
+	{
+	}
+
+	ThirdPassTask::ThirdPassTask(PxU64 contextID, SimpleIslandManager& islandManager, IslandSim& islandSim) : Cm::Task(contextID), mIslandManager(islandManager), mIslandSim(islandSim),
+		mDeactivateIslandsTask(contextID, islandSim)
 	{
 	}
 
@@ -61,6 +70,7 @@ namespace IG
 		mSpeculativeThirdPassTask(contextID, *this, mSpeculativeIslandManager),
 		mAccurateThirdPassTask(contextID, *this, mIslandManager),
 		mPostThirdPassTask(contextID, *this),
+		mTaskPool(NULL),
 		mContextID(contextID)
 {
 	mFirstPartitionEdges.resize(1024);
@@ -251,11 +261,48 @@ bool SimpleIslandManager::validateDeactivations() const
 	return true;
 }
 
+void IslandSleepTask::runInternal()
+{
+	PxU32 start, nb;
+	while(mRange.claim(start, nb))
+		mIslandSim.findIslandsReadyForSleeping(start, nb);
+}
+
+void DeactivateIslandsTask::runInternal()
+{
+	mIslandSim.deactivateIslandsReadyForSleeping();
+}
+
 void ThirdPassTask::runInternal()
 {
 	PX_PROFILE_ZONE("Basic.thirdPassIslandGen", mIslandSim.getContextId());
 	mIslandSim.removeDestroyedEdges();
-	mIslandSim.processLostEdges(mIslandManager.mDestroyedNodes, true, true, mIslandManager.mMaxDirtyNodesPerFrame);
+	mIslandSim.processLostEdges(mIslandManager.mDestroyedNodes, true, true, mIslandManager.mMaxDirtyNodesPerFrame, true);
+
+	//KS - when a lot of islands settle at once (e.g. after an explosion), walking all their nodes is the bulk of the deactivation cost.
+	//That walk is split over tasks, only the deactivation of the islands found ready, which edits the active lists, stays serial.
+	const PxU32 nbActiveIslands = mIslandSim.getNbActiveIslands();
+	const PxU32 nbTasks = Cm::getParallelForTaskCount(nbActiveIslands, getTaskManager(), IslandSleepTask::MinIslandsPerTask);
+	if(nbTasks <= 1)
+	{
+		mIslandSim.findIslandsReadyForSleeping(0, nbActiveIslands);
+		mIslandSim.deactivateIslandsReadyForSleeping();
+		return;
+	}
+
+	mSleepRange.init(nbActiveIslands, nbTasks, IslandSleepTask::MinIslandsPerTask, IslandSleepTask::MaxIslandsPerTask);
+
+	mDeactivateIslandsTask.setContinuation(mCont);
+
+	Cm::FlushPool& taskPool = *mIslandManager.mTaskPool;
+	for(PxU32 a = 0; a < nbTasks; ++a)
+	{
+		IslandSleepTask* task = PX_PLACEMENT_NEW(taskPool.allocate(sizeof(IslandSleepTask)), IslandSleepTask)(getContextId(), mIslandSim, mSleepRange);
+		task->setContinuation(&mDeactivateIslandsTask);
+		task->removeReference();
+	}
+
+	mDeactivateIslandsTask.removeReference();
 }
 
 void PostThirdPassTask::runInternal()
@@ -275,8 +322,9 @@ void PostThirdPassTask::runInternal()
 	PX_ASSERT(mIslandManager.validateDeactivations());
 }
 
-void SimpleIslandManager::thirdPassIslandGen(PxBaseTask* continuation)
+void SimpleIslandManager::thirdPassIslandGen(PxBaseTask* continuation, Cm::FlushPool& taskPool)
 {
+	mTaskPool = &taskPool;
 
 	mIslandManager.clearDeactivations();
 
@@ -154,6 +154,18 @@ class BroadPhaseBase
 		return false;	
 	}
 
+	/**
+	\brief Enables or disables the adaptive regions, see PxScene::setBroadPhaseAdaptiveRegions.
+
+	\param[in]	desc	Adaptive region settings, or NULL to disable the mode
+	\return True if success
+	*/
+	virtual	bool					setAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)
+	{
+		PX_UNUSED(desc);
+		return false;
+	}
+
 	/*
 	\brief Return the number of objects that are not in any region.
 	*/
@@ -208,6 +220,7 @@ public:
 	\param[in] maxNbBroadPhaseOverlaps is the expected maximum number of broad-phase overlaps.
 	\param[in] maxNbStaticShapes is the expected maximum number of static shapes.
 	\param[in] maxNbDynamicShapes is the expected maximum number of dynamic shapes.
+	\param[in] staticTree keeps the static shapes in a separate AABB tree (see PxSceneFlag::eENABLE_STATIC_BROADPHASE_TREE)
 	\param[in] contextID is the context ID parameter sent to the profiler
 	\return The instantiated BroadPhase.
 	\note maxNbRegions is only used if mbp is the chosen broadphase (PxBroadPhaseType::eMBP)
@@ -219,6 +232,7 @@ public:
 		const PxU32 maxNbBroadPhaseOverlaps,
 		const PxU32 maxNbStaticShapes,
 		const PxU32 maxNbDynamicShapes,
+		const bool staticTree,
 		PxU64 contextID);
 
 
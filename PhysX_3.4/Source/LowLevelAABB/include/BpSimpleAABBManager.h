@@ -419,6 +419,10 @@ namespace Bp
 
 		void						shiftOrigin(const PxVec3& shift);
 
+		// Sorts the created and destroyed overlaps by volume indices, so their order doesn't depend on the task scheduling
+		// or on the history of the broadphase and aggregate pair maps (used with PxSceneFlag::eENABLE_ENHANCED_DETERMINISM)
+		PX_FORCE_INLINE	void		setSortedOverlaps(bool sorted)	{ mSortedOverlaps = sorted;	}
+
 		void						visualize(Cm::RenderOutput& out);
 
 		PX_FORCE_INLINE	BroadPhase*					getBroadPhase()				const	{ return &mBroadPhase;				}
@@ -522,9 +526,11 @@ namespace Bp
 		PxcScratchAllocator*		mScratchAllocator;
 
 		PxBaseTask*					mNarrowPhaseUnblockTask;
+		PxCpuDispatcher*			mPostBroadPhaseDispatcher;	// Used to sort the overlaps, NULL when postBroadPhase() runs inline
 		PxU32						mUsedSize;				// highest used value + 1
 		bool						mOriginShifted;
 		bool						mPersistentStateChanged;
+		bool						mSortedOverlaps;
 
 		PxU32						mNbAggregates;
 		PxU32						mFirstFreeAggregate;
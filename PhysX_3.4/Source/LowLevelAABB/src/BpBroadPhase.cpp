@@ -30,6 +30,7 @@
 #include "BpBroadPhase.h"
 #include "BpBroadPhaseSap.h"
 #include "BpBroadPhaseMBP.h"
+#include "BpBroadPhaseStaticTree.h"
 #include "PxSceneDesc.h"
 #include "BpSimpleAABBManager.h"
 #include "CmBitMap.h"
@@ -44,14 +45,21 @@ BroadPhase* BroadPhase::create(
 	const PxU32 maxNbBroadPhaseOverlaps,
 	const PxU32 maxNbStaticShapes,
 	const PxU32 maxNbDynamicShapes,
+	const bool staticTree,
 	PxU64 contextID)
 {
 	PX_ASSERT(bpType==PxBroadPhaseType::eMBP || bpType == PxBroadPhaseType::eSAP);
 
+	// the handles are shared with the static tree, so the wrapped broadphase still needs room for all of them
+	BroadPhase* bp;
 	if(bpType==PxBroadPhaseType::eMBP)
-		return PX_NEW(BroadPhaseMBP)(maxNbRegions, maxNbBroadPhaseOverlaps, maxNbStaticShapes, maxNbDynamicShapes, contextID);
+		bp = PX_NEW(BroadPhaseMBP)(maxNbRegions, maxNbBroadPhaseOverlaps, maxNbStaticShapes, maxNbDynamicShapes, contextID);
 	else
-		return PX_NEW(BroadPhaseSap)(maxNbBroadPhaseOverlaps, maxNbStaticShapes, maxNbDynamicShapes, contextID);
+		bp = PX_NEW(BroadPhaseSap)(maxNbBroadPhaseOverlaps, maxNbStaticShapes, maxNbDynamicShapes, contextID);
+
+	if(staticTree)
+		return PX_NEW(BroadPhaseStaticTree)(bp, contextID);
+	return bp;
 }
 
 #if PX_CHECKED
@@ -30,9 +30,11 @@
 #include "foundation/PxProfiler.h"
 #include "PsHash.h"
 #include "BpBroadPhaseMBP.h"
+#include "BpEncodedBounds.h"
 #include "CmRadixSortBuffered.h"
 #include "CmUtils.h"
 #include "PsUtilities.h"
+#include "PsSort.h"
 #include "PsFoundation.h"
 #include "PsVecMath.h"
 
@@ -524,6 +526,16 @@ struct RegionData : public Ps::UserAllocated
 	#define MAX_NB_MBP	256
 //	#define MAX_NB_MBP	16
 
+	// node of the adaptive regions kd-tree. Leaves own a region, internal nodes only link their two children.
+	// The box of a node is the box of its region, or the union of its children's boxes.
+	struct AdaptiveRegionNode
+	{
+		PxU32	mParent;
+		PxU32	mChildren[2];		// INVALID_ID for leaves
+		PxU32	mRegion;			// Region handle for leaves, INVALID_ID for internal nodes
+		PxU32	mSplitFailedCount;	// Number of objects in the region when the last split attempt failed, 0 if none
+	};
+
 	class MBP : public Ps::UserAllocated
 	{
 		public:
@@ -544,6 +556,7 @@ struct RegionData : public Ps::UserAllocated
 						bool					updateObject(MBP_Handle handle, const MBP_AABB& box);
 						bool					updateObjectAfterRegionRemoval(MBP_Handle handle, Region* removedRegion);
 						bool					updateObjectAfterNewRegionAdded(MBP_Handle handle, const MBP_AABB& box, Region* addedRegion, PxU32 regionIndex);
+						void					addObjectToNewRegion(MBP_Handle handle, const MBP_AABB& box, Region* addedRegion, PxU32 regionIndex);
 						void					prepareOverlaps();
 						void					findOverlaps(const Bp::FilterGroup::Enum* PX_RESTRICT groups
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
@@ -581,6 +594,25 @@ struct RegionData : public Ps::UserAllocated
 #endif
 						void					populateNewRegion(const MBP_AABB& box, Region* addedRegion, PxU32 regionIndex);
 
+						// Adaptive regions
+						void					setAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc);
+						void					updateAdaptiveRegions();
+						bool					resetAdaptiveRegions();
+						void					refreshAdaptiveObjects(PxU32 regionIndex, const MBP_AABB* skipBox);
+						bool					splitAdaptiveNode(PxU32 nodeIndex);
+						void					mergeAdaptiveNode(PxU32 nodeIndex);
+						PxU32					addAdaptiveRegion(const MBP_AABB& box);
+						PxU32					allocateAdaptiveNode(PxU32 parent, PxU32 region);
+
+						PxBroadPhaseAdaptiveRegionsDesc	mAdaptiveDesc;
+						Ps::Array<AdaptiveRegionNode>	mAdaptiveNodes;
+						Ps::Array<PxU32>		mAdaptiveFreeNodes;
+						Ps::Array<PxU32>		mAdaptiveCenters;
+						PxU32					mAdaptiveCounter;	// Updates since the last layout check
+						PxU32					mNbAdaptiveLeaves;
+						bool					mAdaptiveEnabled;
+						bool					mAdaptiveReset;		// The layout must be rebuilt from a single region on next update
+
 #ifdef MBP_REGION_BOX_PRUNING
 						void					buildRegionData();
 						MBP_AABB				mSortedRegionBoxes[MAX_NB_MBP];
@@ -1983,7 +2015,11 @@ void Region::findOverlaps(MBP_PairManager& pairManager)
 MBP::MBP() :
 	mNbRegions			(0),
 	mFirstFreeIndex		(INVALID_ID),
-	mFirstFreeIndexBP	(INVALID_ID)
+	mFirstFreeIndexBP	(INVALID_ID),
+	mAdaptiveCounter	(0),
+	mNbAdaptiveLeaves	(0),
+	mAdaptiveEnabled	(false),
+	mAdaptiveReset		(false)
 #ifdef MBP_REGION_BOX_PRUNING
 	,mNbActiveRegions	(0),
 	mDirtyRegions		(true)
@@ -2477,6 +2513,428 @@ bool MBP::removeRegion(PxU32 handle)
 	return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// adaptive regions. The regions are the leaves of a kd-tree covering the whole space: a region holding too many objects
+// is split in two at the median of the object centers, two sibling regions holding too few objects are merged back. Since
+// the children of a node exactly cover their parent there is no gap between regions, and the outer regions extend to the
+// broadphase limits, so they also catch the objects that would otherwise be out-of-bounds.
+//
+// Objects are moved from the old regions to the new ones directly, without going through populateNewRegion(): we know
+// exactly which objects can touch the new regions, and this doesn't rely on the "fully inside" flags.
+
+// the layout of the bounds depends on MBP_SIMD_OVERLAP, so don't index them directly
+static PX_FORCE_INLINE PxU32 boxMin(const MBP_AABB& box, PxU32 axis)	{ return axis==0 ? box.mMinX : axis==1 ? box.mMinY : box.mMinZ;	}
+static PX_FORCE_INLINE PxU32 boxMax(const MBP_AABB& box, PxU32 axis)	{ return axis==0 ? box.mMaxX : axis==1 ? box.mMaxY : box.mMaxZ;	}
+static PX_FORCE_INLINE PxU32& boxMin(MBP_AABB& box, PxU32 axis)		{ return axis==0 ? box.mMinX : axis==1 ? box.mMinY : box.mMinZ;	}
+static PX_FORCE_INLINE PxU32& boxMax(MBP_AABB& box, PxU32 axis)		{ return axis==0 ? box.mMaxX : axis==1 ? box.mMaxY : box.mMaxZ;	}
+
+static PX_FORCE_INLINE Ps::IntBool regionOverlaps(const MBP_AABB& regionBox, const MBP_AABB& box)
+{
+	// must be the same test as in MBP::updateObject()
+#ifdef MBP_USE_NO_CMP_OVERLAP_3D
+	return intersect3D(regionBox, box);
+#else
+	return regionBox.intersects(box);
+#endif
+}
+
+void MBP::setAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)
+{
+	if(desc)
+	{
+		mAdaptiveDesc = *desc;
+		if(!mAdaptiveEnabled)
+		{
+			mAdaptiveEnabled	= true;
+			mAdaptiveReset		= true;
+		}
+		mAdaptiveCounter = 0;
+	}
+	else
+	{
+		// the current regions are kept, they become regular user regions
+		mAdaptiveEnabled	= false;
+		mAdaptiveReset		= false;
+		mAdaptiveNodes.clear();
+		mAdaptiveFreeNodes.clear();
+		mNbAdaptiveLeaves	= 0;
+	}
+}
+
+PxU32 MBP::allocateAdaptiveNode(PxU32 parent, PxU32 region)
+{
+	PxU32 nodeIndex;
+	if(mAdaptiveFreeNodes.size())
+	{
+		nodeIndex = mAdaptiveFreeNodes.back();
+		mAdaptiveFreeNodes.popBack();
+	}
+	else
+	{
+		nodeIndex = mAdaptiveNodes.size();
+		mAdaptiveNodes.insert();
+	}
+
+	AdaptiveRegionNode& node = mAdaptiveNodes[nodeIndex];
+	node.mParent			= parent;
+	node.mChildren[0]		= INVALID_ID;
+	node.mChildren[1]		= INVALID_ID;
+	node.mRegion			= region;
+	node.mSplitFailedCount	= 0;
+	return nodeIndex;
+}
+
+PxU32 MBP::addAdaptiveRegion(const MBP_AABB& box)
+{
+	// decoding then re-encoding gives back the same box, so the region box is exactly "box"
+	PxBroadPhaseRegion region;
+	box.decode(region.bounds);
+	region.userData = NULL;
+	const PxU32 regionIndex = addRegion(region, false);
+	PX_ASSERT(regionIndex==INVALID_ID || (mRegions[regionIndex].mBox.mMinX==box.mMinX && mRegions[regionIndex].mBox.mMaxZ==box.mMaxZ));
+	return regionIndex;
+}
+
+// objects moved to a new region are only updated in that region. They must be updated in all the regions they touch,
+// otherwise their pairs with objects of the other regions would not be found again and would be reported as lost. This
+// also recomputes their "fully inside" flags. Objects touching "skipBox" have already been updated.
+void MBP::refreshAdaptiveObjects(PxU32 regionIndex, const MBP_AABB* skipBox)
+{
+	const Region* bp = mRegions[regionIndex].mBP;
+	const PxU32 maxNbObjects = bp->mMaxNbObjects;
+	const MBPEntry* PX_RESTRICT entries = bp->mObjects;
+	for(PxU32 j=0;j<maxNbObjects;j++)
+	{
+		if(entries[j].mMBPHandle==INVALID_ID)
+			continue;
+
+		MBP_AABB bounds;
+		const MBP_Handle mbpHandle = bp->retrieveBounds(bounds, j);
+		if(skipBox && regionOverlaps(*skipBox, bounds))
+			continue;
+
+		updateObject(mbpHandle, bounds);
+	}
+}
+
+bool MBP::resetAdaptiveRegions()
+{
+	PxU32 nbOldRegions = 0;
+	PxU32 oldRegions[MAX_NB_MBP];
+	for(PxU32 i=0;i<mNbRegions;i++)
+	{
+		if(mRegions[i].mBP)
+			oldRegions[nbOldRegions++] = i;
+	}
+
+	mAdaptiveNodes.clear();
+	mAdaptiveFreeNodes.clear();
+	mNbAdaptiveLeaves = 0;
+
+	// the new root region must exist before the old regions are removed, otherwise their objects would be reported as out-of-bounds
+	if(nbOldRegions==MAX_NB_MBP)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "MBP::resetAdaptiveRegions: all regions are used, adaptive regions are disabled.");
+		mAdaptiveEnabled = false;
+		mAdaptiveReset = false;
+		return false;
+	}
+
+	MBP_AABB rootBox;
+	rootBox.initFrom2(PxBounds3(PxVec3(-PX_MAX_BOUNDS_EXTENTS), PxVec3(PX_MAX_BOUNDS_EXTENTS)));
+	const PxU32 rootRegion = addAdaptiveRegion(rootBox);
+	PX_ASSERT(rootRegion!=INVALID_ID);
+	Region* root = mRegions[rootRegion].mBP;
+
+	const RegionData* PX_RESTRICT regions = mRegions.begin();
+	MBP_Object* PX_RESTRICT objects = mMBP_Objects.begin();
+	const PxU32 nbObjects = mMBP_Objects.size();
+	for(PxU32 i=0;i<nbObjects;i++)
+	{
+		const MBP_Object& currentObject = objects[i];
+		if(currentObject.mFlags & MBP_REMOVED)
+			continue;
+
+		MBP_AABB bounds;
+		MBP_Handle mbpHandle;
+		const PxU32 nbHandles = currentObject.mNbHandles;
+		if(nbHandles)
+		{
+			// all regions contain the same bounds, just retrieve them from the first one
+			const RegionHandle& h = getHandles(objects[i], nbHandles)[0];
+			mbpHandle = regions[h.mInternalBPHandle].mBP->retrieveBounds(bounds, h.mHandle);
+		}
+		else
+		{
+			// same as in populateNewRegion(), out-of-bounds objects are re-encoded from the AABB manager's bounds
+			const PxBounds3 rawBounds = mTransientBounds[currentObject.mUserID];
+			PxVec3 c(mTransientContactDistance[currentObject.mUserID]);
+			const PxBounds3 decodedBounds(rawBounds.minimum - c, rawBounds.maximum + c);
+			bounds.initFrom2(decodedBounds);
+
+			mbpHandle = currentObject.mHandlesIndex;
+		}
+
+		if(regionOverlaps(rootBox, bounds))
+		{
+			addObjectToNewRegion(mbpHandle, bounds, root, rootRegion);
+		}
+	}
+
+	for(PxU32 i=0;i<nbOldRegions;i++)
+		removeRegion(oldRegions[i]);
+
+	refreshAdaptiveObjects(rootRegion, NULL);
+
+	allocateAdaptiveNode(INVALID_ID, rootRegion);
+	mNbAdaptiveLeaves = 1;
+	mAdaptiveReset = false;
+	mAdaptiveCounter = 0;
+	return true;
+}
+
+bool MBP::splitAdaptiveNode(PxU32 nodeIndex)
+{
+	const PxU32 regionIndex = mAdaptiveNodes[nodeIndex].mRegion;
+	const MBP_AABB nodeBox = mRegions[regionIndex].mBox;
+	Region* bp = mRegions[regionIndex].mBP;
+	const PxU32 nbObjects = bp->mNbObjects;
+	const PxU32 maxNbObjects = bp->mMaxNbObjects;
+	const MBPEntry* PX_RESTRICT entries = bp->mObjects;
+
+	// split along the axis where the object centers are the most spread out. Encoded bounds are 31 bits so the sums don't overflow.
+	PxU32 minCenter[3] = { 0xffffffff, 0xffffffff, 0xffffffff };
+	PxU32 maxCenter[3] = { 0, 0, 0 };
+	for(PxU32 j=0;j<maxNbObjects;j++)
+	{
+		if(entries[j].mMBPHandle==INVALID_ID)
+			continue;
+
+		MBP_AABB bounds;
+		bp->retrieveBounds(bounds, j);
+		for(PxU32 axis=0;axis<3;axis++)
+		{
+			const PxU32 center = (boxMin(bounds, axis) + boxMax(bounds, axis))>>1;
+			minCenter[axis] = PxMin(minCenter[axis], center);
+			maxCenter[axis] = PxMax(maxCenter[axis], center);
+		}
+	}
+
+	PxU32 axis = 0;
+	for(PxU32 i=1;i<3;i++)
+	{
+		if(maxCenter[i] - minCenter[i] > maxCenter[axis] - minCenter[axis])
+			axis = i;
+	}
+
+	const PxU32 nodeMin = boxMin(nodeBox, axis);
+	const PxU32 nodeMax = boxMax(nodeBox, axis);
+	if(maxCenter[axis]<=minCenter[axis] || nodeMax - nodeMin < 2)
+	{
+		mAdaptiveNodes[nodeIndex].mSplitFailedCount = nbObjects;
+		return false;
+	}
+
+	mAdaptiveCenters.clear();
+	mAdaptiveCenters.reserve(nbObjects);
+	for(PxU32 j=0;j<maxNbObjects;j++)
+	{
+		if(entries[j].mMBPHandle==INVALID_ID)
+			continue;
+
+		MBP_AABB bounds;
+		bp->retrieveBounds(bounds, j);
+		mAdaptiveCenters.pushBack((boxMin(bounds, axis) + boxMax(bounds, axis))>>1);
+	}
+	Ps::sort(mAdaptiveCenters.begin(), mAdaptiveCenters.size());
+
+	// the split plane must be strictly inside the box, so that both children are valid regions
+	const PxU32 splitValue = PxClamp(mAdaptiveCenters[mAdaptiveCenters.size()/2], nodeMin+1, nodeMax-1);
+
+	MBP_AABB childBoxes[2] = { nodeBox, nodeBox };
+	boxMax(childBoxes[0], axis) = splitValue;
+	boxMin(childBoxes[1], axis) = splitValue;
+
+	// objects crossing the plane end up in both children. Give up if that doesn't reduce the number of objects enough,
+	// typically when a lot of big objects overlap the same area.
+	PxU32 nbChildObjects[2] = { 0, 0 };
+	for(PxU32 j=0;j<maxNbObjects;j++)
+	{
+		if(entries[j].mMBPHandle==INVALID_ID)
+			continue;
+
+		MBP_AABB bounds;
+		bp->retrieveBounds(bounds, j);
+		for(PxU32 k=0;k<2;k++)
+		{
+			if(regionOverlaps(childBoxes[k], bounds))
+				nbChildObjects[k]++;
+		}
+	}
+	if(PxMax(nbChildObjects[0], nbChildObjects[1]) > nbObjects - nbObjects/4)
+	{
+		mAdaptiveNodes[nodeIndex].mSplitFailedCount = nbObjects;
+		return false;
+	}
+
+	PxU32 childRegions[2];
+	childRegions[0] = addAdaptiveRegion(childBoxes[0]);
+	childRegions[1] = addAdaptiveRegion(childBoxes[1]);
+	if(childRegions[0]==INVALID_ID || childRegions[1]==INVALID_ID)
+	{
+		// can't happen since the caller checked the number of regions, but don't lose objects if it does
+		if(childRegions[0]!=INVALID_ID)
+			removeRegion(childRegions[0]);
+		if(childRegions[1]!=INVALID_ID)
+			removeRegion(childRegions[1]);
+		return false;
+	}
+
+	// don't keep pointers to RegionData across addRegion() calls, the array can be resized
+	Region* childBPs[2] = { mRegions[childRegions[0]].mBP, mRegions[childRegions[1]].mBP };
+	for(PxU32 j=0;j<maxNbObjects;j++)
+	{
+		if(entries[j].mMBPHandle==INVALID_ID)
+			continue;
+
+		MBP_AABB bounds;
+		const MBP_Handle mbpHandle = bp->retrieveBounds(bounds, j);
+		for(PxU32 k=0;k<2;k++)
+		{
+			if(regionOverlaps(childBoxes[k], bounds))
+			{
+				addObjectToNewRegion(mbpHandle, bounds, childBPs[k], childRegions[k]);
+			}
+		}
+	}
+
+	// all the objects now touch at least one child, so none of them goes out-of-bounds here
+	removeRegion(regionIndex);
+
+	refreshAdaptiveObjects(childRegions[0], NULL);
+	refreshAdaptiveObjects(childRegions[1], &childBoxes[0]);
+
+	const PxU32 child0 = allocateAdaptiveNode(nodeIndex, childRegions[0]);
+	const PxU32 child1 = allocateAdaptiveNode(nodeIndex, childRegions[1]);
+	AdaptiveRegionNode& node = mAdaptiveNodes[nodeIndex];
+	node.mChildren[0]		= child0;
+	node.mChildren[1]		= child1;
+	node.mRegion			= INVALID_ID;
+	node.mSplitFailedCount	= 0;
+	mNbAdaptiveLeaves++;
+	return true;
+}
+
+void MBP::mergeAdaptiveNode(PxU32 nodeIndex)
+{
+	const PxU32 child0 = mAdaptiveNodes[nodeIndex].mChildren[0];
+	const PxU32 child1 = mAdaptiveNodes[nodeIndex].mChildren[1];
+	const PxU32 region0 = mAdaptiveNodes[child0].mRegion;
+	const PxU32 region1 = mAdaptiveNodes[child1].mRegion;
+
+	const MBP_AABB box0 = mRegions[region0].mBox;
+	const MBP_AABB box1 = mRegions[region1].mBox;
+	MBP_AABB mergedBox;
+	mergedBox.mMinX = PxMin(box0.mMinX, box1.mMinX);
+	mergedBox.mMinY = PxMin(box0.mMinY, box1.mMinY);
+	mergedBox.mMinZ = PxMin(box0.mMinZ, box1.mMinZ);
+	mergedBox.mMaxX = PxMax(box0.mMaxX, box1.mMaxX);
+	mergedBox.mMaxY = PxMax(box0.mMaxY, box1.mMaxY);
+	mergedBox.mMaxZ = PxMax(box0.mMaxZ, box1.mMaxZ);
+
+	const PxU32 mergedRegion = addAdaptiveRegion(mergedBox);
+	PX_ASSERT(mergedRegion!=INVALID_ID);
+	Region* mergedBP = mRegions[mergedRegion].mBP;
+
+	// objects touching both children are in both regions, only add them once. Objects of the second child that
+	// touch the first child's box are in the first region too.
+	for(PxU32 c=0;c<2;c++)
+	{
+		const Region* bp = mRegions[c ? region1 : region0].mBP;
+		const PxU32 maxNbObjects = bp->mMaxNbObjects;
+		const MBPEntry* PX_RESTRICT entries = bp->mObjects;
+		for(PxU32 j=0;j<maxNbObjects;j++)
+		{
+			if(entries[j].mMBPHandle==INVALID_ID)
+				continue;
+
+			MBP_AABB bounds;
+			const MBP_Handle mbpHandle = bp->retrieveBounds(bounds, j);
+			if(c && regionOverlaps(box0, bounds))
+				continue;
+
+			addObjectToNewRegion(mbpHandle, bounds, mergedBP, mergedRegion);
+		}
+	}
+
+	removeRegion(region0);
+	removeRegion(region1);
+
+	refreshAdaptiveObjects(mergedRegion, NULL);
+
+	mAdaptiveFreeNodes.pushBack(child0);
+	mAdaptiveFreeNodes.pushBack(child1);
+	mAdaptiveNodes[child0].mRegion = INVALID_ID;
+	mAdaptiveNodes[child1].mRegion = INVALID_ID;
+
+	AdaptiveRegionNode& node = mAdaptiveNodes[nodeIndex];
+	node.mChildren[0]		= INVALID_ID;
+	node.mChildren[1]		= INVALID_ID;
+	node.mRegion			= mergedRegion;
+	node.mSplitFailedCount	= 0;
+	mNbAdaptiveLeaves--;
+}
+
+void MBP::updateAdaptiveRegions()
+{
+	PX_ASSERT(mAdaptiveEnabled && !mAdaptiveReset);
+
+	if(++mAdaptiveCounter < mAdaptiveDesc.updatePeriod)
+		return;
+	mAdaptiveCounter = 0;
+
+	const PxU32 maxNbLeaves = PxMin(mAdaptiveDesc.maxNbRegions, PxU32(MAX_NB_MBP-1));
+
+	// a few passes so that a big change (e.g. a lot of objects added at once) converges quickly. Nodes created during
+	// a pass are only visited on the next one.
+	for(PxU32 pass=0;pass<8;pass++)
+	{
+		bool changed = false;
+		const PxU32 nbNodes = mAdaptiveNodes.size();
+		for(PxU32 i=0;i<nbNodes;i++)
+		{
+			const AdaptiveRegionNode& node = mAdaptiveNodes[i];
+			if(node.mRegion!=INVALID_ID)
+			{
+				// leaf, split it if it is too crowded. After a failed attempt, wait until the region grows a bit.
+				const PxU32 nbObjects = mRegions[node.mRegion].mBP->mNbObjects;
+				if(nbObjects <= mAdaptiveDesc.maxObjectsPerRegion || mNbAdaptiveLeaves >= maxNbLeaves)
+					continue;
+				if(node.mSplitFailedCount && nbObjects < node.mSplitFailedCount + node.mSplitFailedCount/2)
+					continue;
+				if(splitAdaptiveNode(i))
+					changed = true;
+			}
+			else if(node.mChildren[0]!=INVALID_ID)
+			{
+				// internal node, merge its children if they are both leaves and almost empty
+				const AdaptiveRegionNode& child0 = mAdaptiveNodes[node.mChildren[0]];
+				const AdaptiveRegionNode& child1 = mAdaptiveNodes[node.mChildren[1]];
+				if(child0.mRegion==INVALID_ID || child1.mRegion==INVALID_ID)
+					continue;
+				const PxU32 nbObjects = mRegions[child0.mRegion].mBP->mNbObjects + mRegions[child1.mRegion].mBP->mNbObjects;
+				if(nbObjects >= mAdaptiveDesc.minObjectsPerRegion)
+					continue;
+				mergeAdaptiveNode(i);
+				changed = true;
+			}
+		}
+		if(!changed)
+			break;
+	}
+}
+
 const Region* MBP::getRegion(PxU32 i) const
 {
 	if(i>=mNbRegions)
@@ -2916,6 +3374,36 @@ bool MBP::updateObjectAfterRegionRemoval(MBP_Handle handle, Region* removedRegio
 }
 
 bool MBP::updateObjectAfterNewRegionAdded(MBP_Handle handle, const MBP_AABB& box, Region* addedRegion, PxU32 regionIndex)
+{
+	// PT: here we know that we're touching one more region than before and we'll need to update the handles.
+	// So there is no "fast path" in this case - well the whole function is a fast path if you want.
+	//
+	// We don't need to "find regions overlapping object's new position": we know it's going to be the
+	// same as before, plus the newly added region ("addedRegion").
+
+#ifdef USE_FULLY_INSIDE_FLAG
+	// PT: we know that the object is not marked as "fully inside", otherwise this function would not have been called.
+	#ifdef HWSCAN
+	PX_ASSERT(mFullyInsideBitmap.isSet(decodeHandle_Index(handle)));	//HWSCAN
+	#else
+	PX_ASSERT(!mFullyInsideBitmap.isSet(decodeHandle_Index(handle)));
+	#endif
+#endif
+
+	addObjectToNewRegion(handle, box, addedRegion, regionIndex);
+
+#ifdef USE_FULLY_INSIDE_FLAG
+	// PT: we know that the object was not "fully inside" before, so even if it is fully inside the new region, it
+	// will not be fully inside all of them => no need to change its fully inside flag
+	// TODO: an exception to this would be the case where the object was out-of-bounds, and it's now fully inside the new region
+	// => we could set the flag in that case.
+#endif
+	return true;
+}
+
+// same as updateObjectAfterNewRegionAdded() but without assumptions on the "fully inside" flag. Used when moving objects
+// to the regions built by the adaptive mode, where the caller takes care of the flag.
+void MBP::addObjectToNewRegion(MBP_Handle handle, const MBP_AABB& box, Region* addedRegion, PxU32 regionIndex)
 {
 	PX_ASSERT(addedRegion);
 
@@ -2931,21 +3419,6 @@ bool MBP::updateObjectAfterNewRegionAdded(MBP_Handle handle, const MBP_AABB& box
 		mUpdatedObjects.setBitChecked(objectIndex);
 	}
 
-	// PT: here we know that we're touching one more region than before and we'll need to update the handles.
-	// So there is no "fast path" in this case - well the whole function is a fast path if you want.
-	//
-	// We don't need to "find regions overlapping object's new position": we know it's going to be the
-	// same as before, plus the newly added region ("addedRegion").
-
-#ifdef USE_FULLY_INSIDE_FLAG
-	// PT: we know that the object is not marked as "fully inside", otherwise this function would not have been called.
-	#ifdef HWSCAN
-	PX_ASSERT(mFullyInsideBitmap.isSet(objectIndex));	//HWSCAN
-	#else
-	PX_ASSERT(!mFullyInsideBitmap.isSet(objectIndex));
-	#endif
-#endif
-
 	const PxU32 nbHandles = currentObject.mNbHandles;
 	PxU32 nbNewHandles = 0;
 	RegionHandle newHandles[MAX_NB_MBP+1];
@@ -2977,14 +3450,6 @@ bool MBP::updateObjectAfterNewRegionAdded(MBP_Handle handle, const MBP_AABB& box
 
 	// PT: we know that we have at least one handle (from the newly added region), so we can't be "out of bounds" here.
 	PX_ASSERT(nbNewHandles);
-
-#ifdef USE_FULLY_INSIDE_FLAG
-	// PT: we know that the object was not "fully inside" before, so even if it is fully inside the new region, it
-	// will not be fully inside all of them => no need to change its fully inside flag
-	// TODO: an exception to this would be the case where the object was out-of-bounds, and it's now fully inside the new region
-	// => we could set the flag in that case.
-#endif
-	return true;
 }
 
 bool MBP_PairManager::computeCreatedDeletedPairs(const MBP_Object* objects, BroadPhaseMBP* mbp, const BitArray& updated, const BitArray& removed)
@@ -3146,6 +3611,12 @@ void MBP::reset()
 #ifdef USE_FULLY_INSIDE_FLAG
 	mFullyInsideBitmap.empty();
 #endif
+
+	// the adaptive layout starts again from a single region when the next objects are added
+	mAdaptiveNodes.clear();
+	mAdaptiveFreeNodes.clear();
+	mNbAdaptiveLeaves	= 0;
+	mAdaptiveReset		= mAdaptiveEnabled;
 }
 
 void MBP::shiftOrigin(const PxVec3& shift)
@@ -3316,14 +3787,30 @@ PxU32 BroadPhaseMBP::getRegions(PxBroadPhaseRegionInfo* userBuffer, PxU32 buffer
 
 PxU32 BroadPhaseMBP::addRegion(const PxBroadPhaseRegion& region, bool populateRegion)
 {
+	if(mMBP->mAdaptiveEnabled)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "BroadPhaseMBP::addRegion: regions are managed by the broadphase in adaptive mode.");
+		return INVALID_ID;
+	}
 	return mMBP->addRegion(region, populateRegion);
 }
 
 bool BroadPhaseMBP::removeRegion(PxU32 handle)
 {
+	if(mMBP->mAdaptiveEnabled)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "BroadPhaseMBP::removeRegion: regions are managed by the broadphase in adaptive mode.");
+		return false;
+	}
 	return mMBP->removeRegion(handle);
 }
 
+bool BroadPhaseMBP::setAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)
+{
+	mMBP->setAdaptiveRegions(desc);
+	return true;
+}
+
 void BroadPhaseMBP::update(const PxU32 numCpuTasks, PxcScratchAllocator* scratchAllocator, const BroadPhaseUpdateData& updateData, physx::PxBaseTask* continuation, physx::PxBaseTask* narrowPhaseUnblockTask)
 {
 #if PX_CHECKED
@@ -3364,25 +3851,18 @@ void BroadPhaseMBP::singleThreadedUpdate(PxcScratchAllocator* /*scratchAllocator
 
 static PX_FORCE_INLINE void computeMBPBounds(MBP_AABB& aabb, const PxBounds3* PX_RESTRICT boundsXYZ, const PxReal* PX_RESTRICT contactDistances, const BpHandle index)
 {
-	const PxBounds3& b = boundsXYZ[index];
-	const Vec4V contactDistanceV = V4Load(contactDistances[index]);
-	const Vec4V inflatedMinV = V4Sub(V4LoadU(&b.minimum.x), contactDistanceV);
-	const Vec4V inflatedMaxV = V4Add(V4LoadU(&b.maximum.x), contactDistanceV);	// PT: this one is safe because we allocated one more box in the array (in BoundsArray::initEntry)
+	// the SIMD encoding reads one float past the bounds, this is safe because we allocated one more box in the array (in BoundsArray::initEntry)
+	PX_ALIGN(16, ValType min[4]);
+	PX_ALIGN(16, ValType max[4]);
+	encodeInflatedBounds(boundsXYZ[index], contactDistances[index], min, max);
 
-	PX_ALIGN(16, PxVec4) boxMin;
-	PX_ALIGN(16, PxVec4) boxMax;
-	V4StoreA(inflatedMinV, &boxMin.x);
-	V4StoreA(inflatedMaxV, &boxMax.x);
-
-	const PxU32* PX_RESTRICT min = PxUnionCast<const PxU32*, const PxF32*>(&boxMin.x);
-	const PxU32* PX_RESTRICT max = PxUnionCast<const PxU32*, const PxF32*>(&boxMax.x);
 	//Avoid min=max by enforcing the rule that mins are even and maxs are odd.
-	aabb.mMinX = IntegerAABB::encodeFloatMin(min[0])>>1;
-	aabb.mMinY = IntegerAABB::encodeFloatMin(min[1])>>1;
-	aabb.mMinZ = IntegerAABB::encodeFloatMin(min[2])>>1;
-	aabb.mMaxX = (IntegerAABB::encodeFloatMax(max[0]) | (1<<2))>>1;
-	aabb.mMaxY = (IntegerAABB::encodeFloatMax(max[1]) | (1<<2))>>1;
-	aabb.mMaxZ = (IntegerAABB::encodeFloatMax(max[2]) | (1<<2))>>1;
+	aabb.mMinX = min[0]>>1;
+	aabb.mMinY = min[1]>>1;
+	aabb.mMinZ = min[2]>>1;
+	aabb.mMaxX = max[0]>>1;
+	aabb.mMaxY = max[1]>>1;
+	aabb.mMaxZ = max[2]>>1;
 
 /*	const IntegerAABB bounds(boundsXYZ[index], contactDistances[index]);
 
@@ -3504,6 +3984,10 @@ void BroadPhaseMBP::setUpdateData(const BroadPhaseUpdateData& updateData)
 {
 	mMBP->setTransientBounds(updateData.getAABBs(), updateData.getContactDistance());
 
+	// the initial adaptive region must exist before objects are added, otherwise they would be reported as out-of-bounds
+	if(mMBP->mAdaptiveReset)
+		mMBP->resetAdaptiveRegions();
+
 	const PxU32 newCapacity = updateData.getCapacity();
 	if(newCapacity>mCapacity)
 		allocateMappingArray(newCapacity);
@@ -3529,6 +4013,11 @@ void BroadPhaseMBP::setUpdateData(const BroadPhaseUpdateData& updateData)
 	addObjects(updateData);
 	updateObjects(updateData);
 
+	// done after the updates so that the layout matches the current bounds, and before the overlaps are prepared
+	// since it marks the moved objects as updated.
+	if(mMBP->mAdaptiveEnabled)
+		mMBP->updateAdaptiveRegions();
+
 	PX_ASSERT(!mCreated.size());
 	PX_ASSERT(!mDeleted.size());
 
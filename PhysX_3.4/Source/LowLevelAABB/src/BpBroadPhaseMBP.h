@@ -59,6 +59,7 @@ namespace Bp
 		virtual	PxU32						getRegions(PxBroadPhaseRegionInfo* userBuffer, PxU32 bufferSize, PxU32 startIndex=0) const;
 		virtual	PxU32						addRegion(const PxBroadPhaseRegion& region, bool populateRegion);
 		virtual	bool						removeRegion(PxU32 handle);
+		virtual	bool						setAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc);
 		virtual	PxU32						getNbOutOfBoundsObjects()	const;
 		virtual	const PxU32*				getOutOfBoundsObjects()		const;
 	//~BroadPhaseBase
@@ -38,6 +38,7 @@
 #include "CmRadixSortBuffered.h"
 #include "PsFoundation.h"
 #include "PsAllocator.h"
+#include "PsMathUtils.h"
 
 namespace physx
 {
@@ -46,6 +47,40 @@ namespace Bp
 #define DEFAULT_DATA_ARRAY_CAPACITY 1024
 #define DEFAULT_CREATEDDELETED_PAIR_ARRAY_CAPACITY 64
 #define DEFAULT_CREATEDDELETED1AXIS_CAPACITY 8192
+// below this number of updated boxes the cost of the tasks outweighs the gains
+#define BP_SAP_PARALLEL_AXES_THRESHOLD 256
+
+static void allocateBatchUpdateScratch(const PxU32 endPointsCapacity, BpHandle** sortedUpdateElements, BroadPhaseActivityPocket** activityPockets, BpHandle** listNext, BpHandle** listPrev)
+{
+	for(PxU32 Axis=0;Axis<3;Axis++)
+	{
+		sortedUpdateElements[Axis] = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*endPointsCapacity)), "SortedUpdateElements"));
+		activityPockets[Axis] = reinterpret_cast<BroadPhaseActivityPocket*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BroadPhaseActivityPocket)*endPointsCapacity)), "BroadPhaseActivityPocket"));
+		listNext[Axis] = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*endPointsCapacity)), "NextList"));
+		listPrev[Axis] = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*endPointsCapacity)), "PrevList"));
+
+		BpHandle* PX_RESTRICT next = listNext[Axis];
+		BpHandle* PX_RESTRICT prev = listPrev[Axis];
+		for(PxU32 a = 1; a < endPointsCapacity; ++a)
+		{
+			next[a-1] = BpHandle(a);
+			prev[a] = BpHandle(a-1);
+		}
+		next[endPointsCapacity-1] = BpHandle(endPointsCapacity-1);
+		prev[0] = 0;
+	}
+}
+
+static void freeBatchUpdateScratch(BpHandle** sortedUpdateElements, BroadPhaseActivityPocket** activityPockets, BpHandle** listNext, BpHandle** listPrev)
+{
+	for(PxU32 Axis=0;Axis<3;Axis++)
+	{
+		PX_FREE(sortedUpdateElements[Axis]);
+		PX_FREE(activityPockets[Axis]);
+		PX_FREE(listNext[Axis]);
+		PX_FREE(listPrev[Axis]);
+	}
+}
 
 BroadPhaseSap::BroadPhaseSap(
 	const PxU32 maxNbBroadPhaseOverlaps,
@@ -82,8 +117,6 @@ BroadPhaseSap::BroadPhaseSap(
 	mEndPointsCapacity = mBoxesCapacity*2 + NUM_SENTINELS;
 
 	mBoxesUpdated = reinterpret_cast<PxU8*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(PxU8)*mBoxesCapacity)), "BoxesUpdated"));
-	mSortedUpdateElements = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*mEndPointsCapacity)), "SortedUpdateElements"));
-	mActivityPockets = reinterpret_cast<BroadPhaseActivityPocket*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BroadPhaseActivityPocket)*mEndPointsCapacity)), "BroadPhaseActivityPocket"));
 
 	mEndPointValues[0] = reinterpret_cast<ValType*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(ValType)*(mEndPointsCapacity))), "ValType"));
 	mEndPointValues[1] = reinterpret_cast<ValType*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(ValType)*(mEndPointsCapacity))), "ValType"));
@@ -100,16 +133,8 @@ BroadPhaseSap::BroadPhaseSap(
 	setMinSentinel(mEndPointValues[2][0],mEndPointDatas[2][0]);
 	setMaxSentinel(mEndPointValues[2][1],mEndPointDatas[2][1]);
 
-	mListNext = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*mEndPointsCapacity)), "NextList"));
-	mListPrev = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*mEndPointsCapacity)), "PrevList"));
-
-	for(PxU32 a = 1; a < mEndPointsCapacity; ++a)
-	{
-		mListNext[a-1] = BpHandle(a);
-		mListPrev[a] = BpHandle(a-1);
-	}
-	mListNext[mEndPointsCapacity-1] = BpHandle(mEndPointsCapacity-1);
-	mListPrev[0] = 0;
+	allocateBatchUpdateScratch(mEndPointsCapacity, mSortedUpdateElements, mActivityPockets, mListNext, mListPrev);
+	mParallelAxes = false;
 
 	mDefaultPairsCapacity = PxMax(maxNbBroadPhaseOverlaps, PxU32(DEFAULT_CREATEDDELETED_PAIR_ARRAY_CAPACITY));
 
@@ -154,11 +179,7 @@ BroadPhaseSap::~BroadPhaseSap()
 	PX_FREE(mEndPointDatas[1]);
 	PX_FREE(mEndPointDatas[2]);
 
-	PX_FREE(mListNext);
-	PX_FREE(mListPrev);
-
-	PX_FREE(mSortedUpdateElements);
-	PX_FREE(mActivityPockets);
+	freeBatchUpdateScratch(mSortedUpdateElements, mActivityPockets, mListNext, mListPrev);
 	PX_FREE(mBoxesUpdated);
 
 	mPairs.release();
@@ -491,6 +512,7 @@ void BroadPhaseSap::singleThreadedUpdate(PxcScratchAllocator* scratchAllocator,
 	{
 		mScratchAllocator = scratchAllocator;
 		resizeBuffers();
+		mSapUpdateWorkTask.set(0);
 		update();
 		postUpdate();
 	}
@@ -578,20 +600,8 @@ bool BroadPhaseSap::setUpdateData(const BroadPhaseUpdateData& updateData)
 		BpHandle* newEndPointDatasY = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*(newEndPointsCapacity))), "BpHandle"));
 		BpHandle* newEndPointDatasZ = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*(newEndPointsCapacity))), "BpHandle"));
 
-		PX_FREE(mListNext);
-		PX_FREE(mListPrev);
-
-		mListNext = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*newEndPointsCapacity)), "NextList"));
-		mListPrev = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*newEndPointsCapacity)), "Prev"));
-
-
-		for(PxU32 a = 1; a < newEndPointsCapacity; ++a)
-		{
-			mListNext[a-1] = BpHandle(a);
-			mListPrev[a] = BpHandle(a-1);
-		}
-		mListNext[newEndPointsCapacity-1] = BpHandle(newEndPointsCapacity-1);
-		mListPrev[0] = 0;
+		freeBatchUpdateScratch(mSortedUpdateElements, mActivityPockets, mListNext, mListPrev);
+		allocateBatchUpdateScratch(newEndPointsCapacity, mSortedUpdateElements, mActivityPockets, mListNext, mListPrev);
 
 		PxMemCopy(newEndPointValuesX, mEndPointValues[0], sizeof(ValType)*(mBoxesSize*2+NUM_SENTINELS));
 		PxMemCopy(newEndPointValuesY, mEndPointValues[1], sizeof(ValType)*(mBoxesSize*2+NUM_SENTINELS));
@@ -612,13 +622,10 @@ bool BroadPhaseSap::setUpdateData(const BroadPhaseUpdateData& updateData)
 		mEndPointDatas[1] = newEndPointDatasY;
 		mEndPointDatas[2] = newEndPointDatasZ;
 		mEndPointsCapacity = newEndPointsCapacity;
-
-		PX_FREE(mSortedUpdateElements);
-		PX_FREE(mActivityPockets);
-		mSortedUpdateElements = reinterpret_cast<BpHandle*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BpHandle)*newEndPointsCapacity)), "SortedUpdateElements"));
-		mActivityPockets = reinterpret_cast<BroadPhaseActivityPocket*>(PX_ALLOC(ALIGN_SIZE_16((sizeof(BroadPhaseActivityPocket)*newEndPointsCapacity)), "BroadPhaseActivityPocket"));
 	}
 
+	mEncodedBounds.resize(mBoxesCapacity);
+
 	PxMemZero(mBoxesUpdated, sizeof(PxU8) * (mBoxesCapacity));	
 
 	for(PxU32 a=0;a<mUpdatedSize;a++)
@@ -695,6 +702,10 @@ void BroadPhaseSap::update()
 {
 	PX_PROFILE_ZONE("BroadPhase.SapUpdate", mContextID);
 
+	// Encode the new & updated boxes once, for the 3 axes
+	mEncodedBounds.update(mBoxBoundsMinMax, mContactDistance, mCreated, mCreatedSize);
+	mEncodedBounds.update(mBoxBoundsMinMax, mContactDistance, mUpdated, mUpdatedSize);
+
 	batchRemove();
 
 	//Check that the overlap pairs per axis have been reset.
@@ -702,9 +713,26 @@ void BroadPhaseSap::update()
 	PX_ASSERT(0==mBatchUpdateTasks[1].getPairsSize());
 	PX_ASSERT(0==mBatchUpdateTasks[2].getPairsSize());
 
-	mBatchUpdateTasks[0].runInternal();
-	mBatchUpdateTasks[1].runInternal();
-	mBatchUpdateTasks[2].runInternal();
+	// the axes are independent as long as the 2D overlap tests don't look at the other axes' sorted arrays. In that mode the
+	// tests of new overlaps use the encoded bounds, and the tests of lost overlaps are skipped (removing a missing pair is a no-op).
+	// Each axis writes its own pairs, postUpdate merges them in axis order so the results don't depend on the scheduling.
+	mParallelAxes = mSapUpdateWorkTask.getNumCpuTasks()>1 && mSapUpdateWorkTask.getContinuation() && mUpdatedSize >= BP_SAP_PARALLEL_AXES_THRESHOLD;
+
+	if(mParallelAxes)
+	{
+		PxBaseTask* postUpdateTask = mSapUpdateWorkTask.getContinuation();
+		mBatchUpdateTasks[2].setContinuation(postUpdateTask);
+		mBatchUpdateTasks[1].setContinuation(postUpdateTask);
+		mBatchUpdateTasks[2].removeReference();
+		mBatchUpdateTasks[1].removeReference();
+		mBatchUpdateTasks[0].runInternal();
+	}
+	else
+	{
+		mBatchUpdateTasks[0].runInternal();
+		mBatchUpdateTasks[1].runInternal();
+		mBatchUpdateTasks[2].runInternal();
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -876,9 +904,6 @@ void BroadPhaseSap::batchCreate()
 	//Array of newly-created box indices.
 	const BpHandle* PX_RESTRICT created = mCreated;
 
-	//Arrays of min and max coords for each box for each axis.
-	const PxBounds3* PX_RESTRICT minMax = mBoxBoundsMinMax;
-
 	//Insert new boxes into sorted endpoints lists.
 	{
 		const PxU32 numEndPoints = numNewBoxes*2;
@@ -890,6 +915,10 @@ void BroadPhaseSap::batchCreate()
 		// PT: TODO: use the scratch allocator
 		Cm::RadixSortBuffered RS;
 
+		// big batches (e.g. when a level is loaded) are sorted with the worker threads
+		const PxU32 numCpuTasks = mSapUpdateWorkTask.getNumCpuTasks();
+		PxCpuDispatcher* dispatcher = numCpuTasks>1 && mSapUpdateWorkTask.getTaskManager() ? mSapUpdateWorkTask.getTaskManager()->getCpuDispatcher() : NULL;
+
 		for(PxU32 Axis=0;Axis<3;Axis++)
 		{
 			for(PxU32 i=0;i<numNewBoxes;i++)
@@ -900,16 +929,15 @@ void BroadPhaseSap::batchCreate()
 
 //				const ValType minValue = minMax[boxIndex].getMin(Axis);
 //				const ValType maxValue = minMax[boxIndex].getMax(Axis);
-				const PxReal contactDistance = mContactDistance[boxIndex];
-				newEPSortedValues[i*2+0] = encodeMin(minMax[boxIndex], Axis, contactDistance);
-				newEPSortedValues[i*2+1] = encodeMax(minMax[boxIndex], Axis, contactDistance);
+				newEPSortedValues[i*2+0] = mEncodedBounds.getMin(Axis, boxIndex);
+				newEPSortedValues[i*2+1] = mEncodedBounds.getMax(Axis, boxIndex);
 			}
 
 			// Sort endpoints backwards
 			BpHandle* bufferDatas;
 			{
 				RS.invalidateRanks();	// PT: there's no coherence between axes
-				const PxU32* Sorted = RS.Sort(newEPSortedValues, numEndPoints, Cm::RADIX_UNSIGNED).GetRanks();
+				const PxU32* Sorted = RS.SortParallel(newEPSortedValues, numEndPoints, dispatcher, numCpuTasks, Cm::RADIX_UNSIGNED).GetRanks();
 				bufferDatas = RS.GetRecyclable();
 
 				// PT: TODO: with two passes here we could reuse the "newEPSortedValues" buffer and drop "bufferValues"
@@ -981,13 +1009,17 @@ void BroadPhaseSap::batchCreate()
 	{
 		const AuxData data0(newBoxCount, mBoxEndPts, newBoxesIndicesSorted, mBoxGroups);
 
+		// big batches are pruned with the worker threads as well
+		const PxU32 numCpuTasks = mSapUpdateWorkTask.getNumCpuTasks();
+		PxCpuDispatcher* dispatcher = numCpuTasks>1 && mSapUpdateWorkTask.getTaskManager() ? mSapUpdateWorkTask.getTaskManager()->getCpuDispatcher() : NULL;
+
 		if(!allNewBoxesStatics)
 		{
 			performBoxPruningNewNew(&data0, mScratchAllocator,
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 				mLUT,
 #endif
-				mPairs, mData, mDataSize, mDataCapacity);
+				mPairs, mData, mDataSize, mDataCapacity, dispatcher);
 		}
 
 		// the old boxes are not the first ones in the array
@@ -1001,7 +1033,7 @@ void BroadPhaseSap::batchCreate()
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 					mLUT,
 #endif
-					mPairs, mData, mDataSize, mDataCapacity);
+					mPairs, mData, mDataSize, mDataCapacity, dispatcher);
 			}
 		}
 	}
@@ -1121,6 +1153,17 @@ static BroadPhasePair* resizeBroadPhasePairArray(const PxU32 oldMaxNb, const PxU
 
 #define PERFORM_COMPARISONS 1
 
+// 2D overlap test on the two other axes, using the encoded bounds instead of the positions in the other axes' sorted arrays.
+// These arrays are modified while the axes are updated in parallel, the encoded bounds are not. Encoded mins and maxs never
+// compare equal, so once all axes are sorted this gives the same result as Intersect2D_Handle.
+static PX_FORCE_INLINE bool intersect2DEncoded(const EncodedBounds& bounds, const PxU32 axis, const PxU32 box0, const PxU32 box1)
+{
+	const PxU32 axis0 = Ps::getNextIndex3(axis);
+	const PxU32 axis1 = Ps::getNextIndex3(axis0);
+	return	bounds.getMax(axis0, box0) > bounds.getMin(axis0, box1) && bounds.getMax(axis0, box1) > bounds.getMin(axis0, box0) &&
+			bounds.getMax(axis1, box0) > bounds.getMin(axis1, box1) && bounds.getMax(axis1, box1) > bounds.getMin(axis1, box0);
+}
+
 
 void BroadPhaseSap::batchUpdate
 (const PxU32 Axis, BroadPhasePair*& pairs, PxU32& pairsSize, PxU32& pairsCapacity)
@@ -1139,7 +1182,7 @@ void BroadPhaseSap::batchUpdate
 	PxU32 numPairs=0;
 	PxU32 maxNumPairs=pairsCapacity;
 
-	const PxBounds3* PX_RESTRICT boxMinMax3D = mBoxBoundsMinMax;
+	const EncodedBounds& encodedBounds = mEncodedBounds;
 	SapBox1D* boxMinMax2D[6]={mBoxEndPts[1],mBoxEndPts[2],mBoxEndPts[2],mBoxEndPts[0],mBoxEndPts[0],mBoxEndPts[1]};
 
 	const SapBox1D* PX_RESTRICT boxMinMax0=boxMinMax2D[2*Axis+0];
@@ -1159,6 +1202,10 @@ void BroadPhaseSap::batchUpdate
 
 	PxU8* PX_RESTRICT updated = mBoxesUpdated;
 
+	BpHandle* PX_RESTRICT listNext = mListNext[Axis];
+	BpHandle* PX_RESTRICT listPrev = mListPrev[Axis];
+	BroadPhaseActivityPocket* const activityPockets = mActivityPockets[Axis];
+
 	//KS - can we lazy create these inside the loop? Might benefit us
 
 	//There are no extents, jus the sentinels, so exit early.
@@ -1174,7 +1221,7 @@ void BroadPhaseSap::batchUpdate
 	//KS - in theory, we should just be able to grab the min element but there's some issue where a body's max < min (i.e. an invalid extents) that
 	//appears in a unit test
 	// ValType ThisValue_ = boxMinMax3D[startHandle].getMin(Axis);
-	ValType ThisValue_ = encodeMin(boxMinMax3D[startHandle], Axis, mContactDistance[startHandle]);
+	ValType ThisValue_ = encodedBounds.getMin(Axis, startHandle);
 
 	BaseEPValues[1] = ThisValue_;
 	
@@ -1185,7 +1232,7 @@ void BroadPhaseSap::batchUpdate
 	//We'll never overlap with this sentinel but it just ensures that we don't need to branch to see if
 	//there's a pocket that we need to test against
 	
-	BroadPhaseActivityPocket* PX_RESTRICT currentPocket = mActivityPockets;
+	BroadPhaseActivityPocket* PX_RESTRICT currentPocket = activityPockets;
 
 	currentPocket->mEndIndex = 0;
 	currentPocket->mStartIndex = 0;
@@ -1212,8 +1259,8 @@ void BroadPhaseSap::batchUpdate
 			//BPValType ThisValue = startIsMax ? boxMinMax3D[handle].getMax(Axis) : boxMinMax3D[handle].getMin(Axis);
 			//ValType ThisValue = boxMinMax3D[handle].getExtent(startIsMax, Axis);
 
-			ValType ThisValue = startIsMax ? encodeMax(boxMinMax3D[handle], Axis, mContactDistance[handle])
-										   : encodeMin(boxMinMax3D[handle], Axis, mContactDistance[handle]);
+			ValType ThisValue = startIsMax ? encodedBounds.getMax(Axis, handle)
+										   : encodedBounds.getMin(Axis, handle);
 
 			BaseEPValues[ThisIndex] = ThisValue;
 
@@ -1221,7 +1268,7 @@ void BroadPhaseSap::batchUpdate
 
 			//We always iterate back through the list...
 
-			BpHandle CurrentIndex = mListPrev[ThisIndex];
+			BpHandle CurrentIndex = listPrev[ThisIndex];
 			ValType CurrentValue = BaseEPValues[CurrentIndex];
 			//PxBpHandle CurrentData = BaseEPDatas[CurrentIndex];
 
@@ -1236,7 +1283,7 @@ void BroadPhaseSap::batchUpdate
 				
 				// const ValType boxMax=boxMinMax3D[handle].getMax(Axis);
 
-				const ValType boxMax=encodeMax(boxMinMax3D[handle], Axis, mContactDistance[handle]);
+				const ValType boxMax=encodedBounds.getMax(Axis, handle);
 
 				PxU32 endIndex = ind;
 				PxU32 startIndex = ind;
@@ -1261,8 +1308,9 @@ void BroadPhaseSap::batchUpdate
 							if(
 								BaseEPValues[id1->mMinMax[0]] < boxMax && 
 								//2D intersection test using up-to-date values
+								(mParallelAxes ? intersect2DEncoded(encodedBounds, Axis, handle, ownerId) :
 								Intersect2D_Handle(boxMinMax0[handle].mMinMax[0], boxMinMax0[handle].mMinMax[1], boxMinMax1[handle].mMinMax[0], boxMinMax1[handle].mMinMax[1],
-								            boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1])
+								            boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1]))
 
 	#if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
 		#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
@@ -1290,7 +1338,7 @@ void BroadPhaseSap::batchUpdate
 						}
 	#endif
 						startIndex--;
-						CurrentIndex = mListPrev[CurrentIndex];
+						CurrentIndex = listPrev[CurrentIndex];
 						CurrentValue = BaseEPValues[CurrentIndex];
 					}
 					while(ThisValue < CurrentValue);
@@ -1312,8 +1360,9 @@ void BroadPhaseSap::batchUpdate
 #if 1
 							if(
 #if BP_SAP_USE_OVERLAP_TEST_ON_REMOVES
+								(mParallelAxes ||
 								Intersect2D_Handle(boxMinMax0[handle].mMinMax[0], boxMinMax0[handle].mMinMax[1], boxMinMax1[handle].mMinMax[0], boxMinMax1[handle].mMinMax[1],
-								       boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1])
+								       boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1]))
 #endif
 #if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
 	#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
@@ -1342,7 +1391,7 @@ void BroadPhaseSap::batchUpdate
 						}
 	#endif
 						startIndex--;
-						CurrentIndex = mListPrev[CurrentIndex];
+						CurrentIndex = listPrev[CurrentIndex];
 						CurrentValue = BaseEPValues[CurrentIndex];
 					}
 					while(ThisValue < CurrentValue);
@@ -1351,21 +1400,21 @@ void BroadPhaseSap::batchUpdate
 				//This test is unnecessary. If we entered the outer loop, we're doing the swap in here
 				{
 					//Unlink from old position and re-link to new position
-					BpHandle oldNextIndex = mListNext[ThisIndex];
-					BpHandle oldPrevIndex = mListPrev[ThisIndex];
+					BpHandle oldNextIndex = listNext[ThisIndex];
+					BpHandle oldPrevIndex = listPrev[ThisIndex];
 
-					BpHandle newNextIndex = mListNext[CurrentIndex];
+					BpHandle newNextIndex = listNext[CurrentIndex];
 					BpHandle newPrevIndex = CurrentIndex;
 					
 					//Unlink this node
-					mListNext[oldPrevIndex] = oldNextIndex;
-					mListPrev[oldNextIndex] = oldPrevIndex;
+					listNext[oldPrevIndex] = oldNextIndex;
+					listPrev[oldNextIndex] = oldPrevIndex;
 
 					//Link it to it's new place in the list
-					mListNext[ThisIndex] = newNextIndex;
-					mListPrev[ThisIndex] = newPrevIndex;
-					mListPrev[newNextIndex] = ThisIndex;
-					mListNext[newPrevIndex] = ThisIndex;
+					listNext[ThisIndex] = newNextIndex;
+					listPrev[ThisIndex] = newPrevIndex;
+					listPrev[newNextIndex] = ThisIndex;
+					listNext[newPrevIndex] = ThisIndex;
 				}
 
 				//There is a sentinel with 0 index, so we don't need
@@ -1375,7 +1424,7 @@ void BroadPhaseSap::batchUpdate
 					currentPocket--;
 				}
 				//If our start index > currentPocket->mEndIndex, then we don't overlap so create a new pocket
-				if(currentPocket == mActivityPockets || startIndex > (currentPocket->mEndIndex+1))
+				if(currentPocket == activityPockets || startIndex > (currentPocket->mEndIndex+1))
 				{
 					currentPocket++;
 					currentPocket->mStartIndex = startIndex;
@@ -1393,13 +1442,13 @@ void BroadPhaseSap::batchUpdate
 	pairsCapacity=maxNumPairs;
 
 
-	BroadPhaseActivityPocket* pocket = mActivityPockets+1;
+	BroadPhaseActivityPocket* pocket = activityPockets+1;
 
 	while(pocket <= currentPocket)
 	{
 		for(PxU32 a = pocket->mStartIndex; a <= pocket->mEndIndex; ++a)
 		{
-			mListPrev[a] = BpHandle(a);
+			listPrev[a] = BpHandle(a);
 		}
 
 		//Now copy all the data to the array, updating the remap table
@@ -1407,9 +1456,9 @@ void BroadPhaseSap::batchUpdate
 		PxU32 CurrIndex = pocket->mStartIndex-1;
 		for(PxU32 a = pocket->mStartIndex; a <= pocket->mEndIndex; ++a)
 		{
-			CurrIndex = mListNext[CurrIndex];
+			CurrIndex = listNext[CurrIndex];
 			PxU32 origIndex =  CurrIndex;
-			BpHandle remappedIndex = mListPrev[origIndex];
+			BpHandle remappedIndex = listPrev[origIndex];
 
 			if(origIndex != a)
 			{
@@ -1424,9 +1473,9 @@ void BroadPhaseSap::batchUpdate
 				BaseEPValues[remappedIndex] = tmp;
 				BaseEPDatas[remappedIndex] = tmpHandle;
 
-				mListPrev[remappedIndex] = mListPrev[a];
+				listPrev[remappedIndex] = listPrev[a];
 				//Write back remap index (should be an immediate jump to original index)
-				mListPrev[mListPrev[a]] = remappedIndex;
+				listPrev[listPrev[a]] = remappedIndex;
 				asapBoxes[ownerId].mMinMax[IsMax] = BpHandle(a);
 			}
 			
@@ -1435,13 +1484,13 @@ void BroadPhaseSap::batchUpdate
 		////Reset next and prev ptrs back
 		for(PxU32 a = pocket->mStartIndex-1; a <= pocket->mEndIndex; ++a)
 		{
-			mListPrev[a+1] = BpHandle(a);
-			mListNext[a] = BpHandle(a+1);
+			listPrev[a+1] = BpHandle(a);
+			listNext[a] = BpHandle(a+1);
 		}
 
 		pocket++;
 	}
-	mListPrev[0] = 0;
+	listPrev[0] = 0;
 }
 
 
@@ -1451,7 +1500,7 @@ void BroadPhaseSap::batchUpdateFewUpdates
 	PxU32 numPairs=0;
 	PxU32 maxNumPairs=pairsCapacity;
 
-	const PxBounds3* PX_RESTRICT boxMinMax3D = mBoxBoundsMinMax;
+	const EncodedBounds& encodedBounds = mEncodedBounds;
 	SapBox1D* boxMinMax2D[6]={mBoxEndPts[1],mBoxEndPts[2],mBoxEndPts[2],mBoxEndPts[0],mBoxEndPts[0],mBoxEndPts[1]};
 
 #if BP_SAP_TEST_GROUP_ID_CREATEUPDATE 
@@ -1474,6 +1523,11 @@ void BroadPhaseSap::batchUpdateFewUpdates
 
 	PxU8* PX_RESTRICT updated = mBoxesUpdated;
 
+	BpHandle* PX_RESTRICT listNext = mListNext[Axis];
+	BpHandle* PX_RESTRICT listPrev = mListPrev[Axis];
+	BroadPhaseActivityPocket* const activityPockets = mActivityPockets[Axis];
+	BpHandle* PX_RESTRICT sortedUpdateElements = mSortedUpdateElements[Axis];
+
 	const PxU32 endPointSize = mBoxesSize*2 + 1;
 
 	//There are no extents, just the sentinels, so exit early.
@@ -1501,16 +1555,16 @@ void BroadPhaseSap::batchUpdateFewUpdates
 //			const ValType boxMin=boxMinMax3D[handle].getMin(Axis);
 //			const ValType boxMax=boxMinMax3D[handle].getMax(Axis);
 
-			const ValType boxMin = encodeMin(boxMinMax3D[handle], Axis, mContactDistance[handle]);
-			const ValType boxMax = encodeMax(boxMinMax3D[handle], Axis, mContactDistance[handle]);
+			const ValType boxMin = encodedBounds.getMin(Axis, handle);
+			const ValType boxMax = encodedBounds.getMax(Axis, handle);
 
 			BaseEPValues[Object->mMinMax[0]] = boxMin;
 			BaseEPValues[Object->mMinMax[1]] = boxMax;
 
-			mSortedUpdateElements[ind_++] = Object->mMinMax[0];
-			mSortedUpdateElements[ind_++] = Object->mMinMax[1];
+			sortedUpdateElements[ind_++] = Object->mMinMax[0];
+			sortedUpdateElements[ind_++] = Object->mMinMax[1];
 		}
-		Ps::sort(mSortedUpdateElements, ind_);
+		Ps::sort(sortedUpdateElements, ind_);
 	}
 	else
 	{
@@ -1524,10 +1578,10 @@ void BroadPhaseSap::batchUpdateFewUpdates
 			if(updated[owner])
 			{
 				//BPValType ThisValue = isMax(ThisData) ? boxMinMax3D[owner].getMax(Axis) : boxMinMax3D[owner].getMin(Axis);
-				ValType ThisValue = isMax(ThisData) ? encodeMax(boxMinMax3D[owner], Axis, mContactDistance[owner])
-													: encodeMin(boxMinMax3D[owner], Axis, mContactDistance[owner]);
+				ValType ThisValue = isMax(ThisData) ? encodedBounds.getMax(Axis, owner)
+													: encodedBounds.getMin(Axis, owner);
 				BaseEPValues[index] = ThisValue;
-				mSortedUpdateElements[ind_++] = BpHandle(index);
+				sortedUpdateElements[ind_++] = BpHandle(index);
 			}
 		}
 	}
@@ -1536,13 +1590,13 @@ void BroadPhaseSap::batchUpdateFewUpdates
 	
 	//We'll never overlap with this sentinel but it just ensures that we don't need to branch to see if
 	//there's a pocket that we need to test against
-	BroadPhaseActivityPocket* PX_RESTRICT currentPocket = mActivityPockets;
+	BroadPhaseActivityPocket* PX_RESTRICT currentPocket = activityPockets;
 	currentPocket->mEndIndex = 0;
 	currentPocket->mStartIndex = 0;
 
 	for(PxU32 a = 0; a < updateCounter; ++a)
 	{
-		BpHandle ind = mSortedUpdateElements[a];
+		BpHandle ind = sortedUpdateElements[a];
 
 		BpHandle NextData;
 		BpHandle PrevData;
@@ -1567,10 +1621,10 @@ void BroadPhaseSap::batchUpdateFewUpdates
 			//Get the bounds of the curr aabb.
 			//const PxU32 twoHandle = 2*handle;
 			
-			const ValType boxMax=encodeMax(boxMinMax3D[handle], Axis, mContactDistance[handle]);
+			const ValType boxMax=encodedBounds.getMax(Axis, handle);
 
 			//We always iterate back through the list...
-			BpHandle CurrentIndex = mListPrev[ThisIndex];
+			BpHandle CurrentIndex = listPrev[ThisIndex];
 			ValType CurrentValue = BaseEPValues[CurrentIndex];
 
 			if(CurrentValue > ThisValue)
@@ -1604,8 +1658,9 @@ void BroadPhaseSap::batchUpdateFewUpdates
 							if(
 								BaseEPValues[id1->mMinMax[0]] < boxMax && 
 								//2D intersection test using up-to-date values
+								(mParallelAxes ? intersect2DEncoded(encodedBounds, Axis, handle, ownerId) :
 								Intersect2D_Handle(boxMinMax0[handle].mMinMax[0], boxMinMax0[handle].mMinMax[1], boxMinMax1[handle].mMinMax[0], boxMinMax1[handle].mMinMax[1],
-								       boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1])
+								       boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1]))
 	#if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
 		#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 								&& groupFiltering(group, asapBoxGroupIds[ownerId], mLUT)
@@ -1632,7 +1687,7 @@ void BroadPhaseSap::batchUpdateFewUpdates
 						}
 	#endif
 						startIndex--;
-						CurrentIndex = mListPrev[CurrentIndex];
+						CurrentIndex = listPrev[CurrentIndex];
 						CurrentValue = BaseEPValues[CurrentIndex];
 					}
 					while(ThisValue < CurrentValue);
@@ -1654,8 +1709,9 @@ void BroadPhaseSap::batchUpdateFewUpdates
 #if 1
 							if(
 #if BP_SAP_USE_OVERLAP_TEST_ON_REMOVES
+								(mParallelAxes ||
 								Intersect2D_Handle(boxMinMax0[handle].mMinMax[0], boxMinMax0[handle].mMinMax[1], boxMinMax1[handle].mMinMax[0], boxMinMax1[handle].mMinMax[1],
-								       boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1])
+								       boxMinMax0[ownerId].mMinMax[0],boxMinMax0[ownerId].mMinMax[1],boxMinMax1[ownerId].mMinMax[0],boxMinMax1[ownerId].mMinMax[1]))
 #endif
 #if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
 	#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
@@ -1684,7 +1740,7 @@ void BroadPhaseSap::batchUpdateFewUpdates
 						}
 	#endif
 						startIndex--;
-						CurrentIndex = mListPrev[CurrentIndex];
+						CurrentIndex = listPrev[CurrentIndex];
 						CurrentValue = BaseEPValues[CurrentIndex];
 					}
 					while(ThisValue < CurrentValue);
@@ -1693,21 +1749,21 @@ void BroadPhaseSap::batchUpdateFewUpdates
 				//This test is unnecessary. If we entered the outer loop, we're doing the swap in here
 				{
 					//Unlink from old position and re-link to new position
-					BpHandle oldNextIndex = mListNext[ThisIndex];
-					BpHandle oldPrevIndex = mListPrev[ThisIndex];
+					BpHandle oldNextIndex = listNext[ThisIndex];
+					BpHandle oldPrevIndex = listPrev[ThisIndex];
 
-					BpHandle newNextIndex = mListNext[CurrentIndex];
+					BpHandle newNextIndex = listNext[CurrentIndex];
 					BpHandle newPrevIndex = CurrentIndex;
 					
 					//Unlink this node
-					mListNext[oldPrevIndex] = oldNextIndex;
-					mListPrev[oldNextIndex] = oldPrevIndex;
+					listNext[oldPrevIndex] = oldNextIndex;
+					listPrev[oldNextIndex] = oldPrevIndex;
 
 					//Link it to it's new place in the list
-					mListNext[ThisIndex] = newNextIndex;
-					mListPrev[ThisIndex] = newPrevIndex;
-					mListPrev[newNextIndex] = ThisIndex;
-					mListNext[newPrevIndex] = ThisIndex;
+					listNext[ThisIndex] = newNextIndex;
+					listPrev[ThisIndex] = newPrevIndex;
+					listPrev[newNextIndex] = ThisIndex;
+					listNext[newPrevIndex] = ThisIndex;
 				}
 
 				//Loop over the activity pocket stack to make sure this set of shuffles didn't 
@@ -1718,7 +1774,7 @@ void BroadPhaseSap::batchUpdateFewUpdates
 					currentPocket--;
 				}
 				//If our start index > currentPocket->mEndIndex, then we don't overlap so create a new pocket
-				if(currentPocket == mActivityPockets || startIndex > (currentPocket->mEndIndex+1))
+				if(currentPocket == activityPockets || startIndex > (currentPocket->mEndIndex+1))
 				{
 					currentPocket++;
 					currentPocket->mStartIndex = startIndex;
@@ -1728,7 +1784,7 @@ void BroadPhaseSap::batchUpdateFewUpdates
 			//Get prev and next ptr...
 
 			NextData = BaseEPDatas[++ind];
-			PrevData = BaseEPDatas[mListPrev[ind]];
+			PrevData = BaseEPDatas[listPrev[ind]];
 
 		}while(!isSentinel(NextData) && !updated[getOwner(NextData)] && updated[getOwner(PrevData)]);
 		
@@ -1738,23 +1794,23 @@ void BroadPhaseSap::batchUpdateFewUpdates
 	pairsCapacity=maxNumPairs;
 
 
-	BroadPhaseActivityPocket* pocket = mActivityPockets+1;
+	BroadPhaseActivityPocket* pocket = activityPockets+1;
 
 	while(pocket <= currentPocket)
 	{
-		//PxU32 CurrIndex = mListPrev[pocket->mStartIndex];
+		//PxU32 CurrIndex = listPrev[pocket->mStartIndex];
 		for(PxU32 a = pocket->mStartIndex; a <= pocket->mEndIndex; ++a)
 		{
-			mListPrev[a] = BpHandle(a);
+			listPrev[a] = BpHandle(a);
 		}
 
 		//Now copy all the data to the array, updating the remap table
 		PxU32 CurrIndex = pocket->mStartIndex-1;
 		for(PxU32 a = pocket->mStartIndex; a <= pocket->mEndIndex; ++a)
 		{
-			CurrIndex = mListNext[CurrIndex];
+			CurrIndex = listNext[CurrIndex];
 			PxU32 origIndex =  CurrIndex;
-			BpHandle remappedIndex = mListPrev[origIndex];
+			BpHandle remappedIndex = listPrev[origIndex];
 
 			if(origIndex != a)
 			{
@@ -1769,9 +1825,9 @@ void BroadPhaseSap::batchUpdateFewUpdates
 				BaseEPValues[remappedIndex] = tmp;
 				BaseEPDatas[remappedIndex] = tmpHandle;
 
-				mListPrev[remappedIndex] = mListPrev[a];
+				listPrev[remappedIndex] = listPrev[a];
 				//Write back remap index (should be an immediate jump to original index)
-				mListPrev[mListPrev[a]] = remappedIndex;
+				listPrev[listPrev[a]] = remappedIndex;
 				asapBoxes[ownerId].mMinMax[IsMax] = BpHandle(a);
 			}
 			
@@ -1779,8 +1835,8 @@ void BroadPhaseSap::batchUpdateFewUpdates
 
 		for(PxU32 a = pocket->mStartIndex-1; a <= pocket->mEndIndex; ++a)
 		{
-			mListPrev[a+1] = BpHandle(a);
-			mListNext[a] = BpHandle(a+1);
+			listPrev[a+1] = BpHandle(a);
+			listNext[a] = BpHandle(a+1);
 		}
 		pocket++;
 	}
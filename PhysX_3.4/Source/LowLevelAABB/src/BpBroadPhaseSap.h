@@ -33,6 +33,7 @@
 
 #include "BpBroadPhase.h"
 #include "BpBroadPhaseSapAux.h"
+#include "BpEncodedBounds.h"
 #include "CmPool.h"
 #include "CmPhysXCommon.h"
 #include "BpSAPTasks.h"
@@ -165,10 +166,13 @@ private:
 			BpHandle*					mEndPointDatas[3];		//Corresponding owner id and isMin/isMax for each entry in the sorted arrays of min and max box coords.
 
 			PxU8*						mBoxesUpdated;	
-			BpHandle*					mSortedUpdateElements;	
-			BroadPhaseActivityPocket*	mActivityPockets;
-			BpHandle*					mListNext;
-			BpHandle*					mListPrev;
+			EncodedBounds				mEncodedBounds;		//Inflated & encoded bounds of the boxes, updated once per frame for the created & updated boxes
+	//Per-axis scratch of the batch update, so that the 3 axes can be updated in parallel.
+			BpHandle*					mSortedUpdateElements[3];	
+			BroadPhaseActivityPocket*	mActivityPockets[3];
+			BpHandle*					mListNext[3];
+			BpHandle*					mListPrev[3];
+			bool						mParallelAxes;			//The axes are updated in parallel, the 2D overlap tests must not read the other axes' sorted arrays
 
 			PxU32						mBoxesSize;				//Number of sorted boxes + number of unsorted (new) boxes
 			PxU32						mBoxesSizePrev;			//Number of sorted boxes 
@@ -30,6 +30,8 @@
 #include "CmPhysXCommon.h"
 #include "BpBroadPhaseSapAux.h"
 #include "PsFoundation.h"
+#include "PsArray.h"
+#include "CmParallelFor.h"
 
 namespace physx
 {
@@ -787,94 +789,123 @@ AuxData::~AuxData()
 	PX_FREE(mBoxX);
 }
 
-void performBoxPruningNewNew(	const AuxData* PX_RESTRICT auxData, PxcScratchAllocator* scratchAllocator,
-#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
-								const bool* lut,
-#endif
-								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity)
+// Receivers of the pairs found by the box pruning loops. The serial loops add them to the pair manager right away, the parallel
+// ones record them per chunk and they're added afterwards in chunk order, so that the pair manager sees the same sequence.
+struct AddPairSink
 {
-	const PxU32 nb = auxData->mNb;
-	if(!nb)
-		return;
+	AddPairSink(const AddPairParams* params) : mParams(params)	{}
 
-	DataArray da(dataArray, dataArraySize, dataArrayCapacity);
+	PX_FORCE_INLINE	void	add(const PxU32 index0, const PxU32 index1)	{ addPair(mParams, index0, index1);	}
 
-	START_STATS
-	{
-		BoxX* boxX = auxData->mBoxX;
-		BoxYZ* boxYZ = auxData->mBoxYZ;
-		Bp::FilterGroup::Enum* groups = auxData->mGroups;
-		PxU32* remap = auxData->mRemap;
+	const AddPairParams*	mParams;
+};
 
-		AddPairParams params(remap, remap, scratchAllocator, &pairManager, &da);
+struct RecordPairSink
+{
+	RecordPairSink(Ps::Array<PxU32>& pairs) : mPairs(pairs)	{}
 
-		PxU32 runningIndex = 0;
-		PxU32 index0 = 0;
+	PX_FORCE_INLINE	void	add(const PxU32 index0, const PxU32 index1)	{ mPairs.pushBack(index0); mPairs.pushBack(index1);	}
 
-		while(runningIndex<nb && index0<nb)
-		{
+	Ps::Array<PxU32>&		mPairs;
+
+	PX_NOCOPY(RecordPairSink)
+};
+
+// Box pruning of the boxes [start, end) of a sorted list against the following boxes of the same list
+template<class PairSink>
+static void boxPruningNewNew(
+	const PxU32 nb, const BoxX* PX_RESTRICT boxX, const BoxYZ* PX_RESTRICT boxYZ, const Bp::FilterGroup::Enum* PX_RESTRICT groups,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	const bool* lut,
+#endif
+	const PxU32 start, const PxU32 end, PairSink& sink)
+{
+#if !BP_SAP_TEST_GROUP_ID_CREATEUPDATE
+	PX_UNUSED(groups);
+#endif
+	// the running index is always index0 at the start of an iteration, so the loop can start at any box
+	PxU32 runningIndex = start;
+	PxU32 index0 = start;
+
+	while(runningIndex<nb && index0<end)
+	{
 #if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
-			const Bp::FilterGroup::Enum group0 = groups[index0];
+		const Bp::FilterGroup::Enum group0 = groups[index0];
 #endif
-			const BoxX& boxX0 = boxX[index0];
+		const BoxX& boxX0 = boxX[index0];
 
-			const BpHandle minLimit = boxX0.mMinX;
-			while(boxX[runningIndex++].mMinX<minLimit);
+		const BpHandle minLimit = boxX0.mMinX;
+		while(boxX[runningIndex++].mMinX<minLimit);
 
-			const BpHandle maxLimit = boxX0.mMaxX;
-			PxU32 index1 = runningIndex;
-			while(boxX[index1].mMinX <= maxLimit)
-			{
-				INCREASE_STATS_NB_ITER
+		const BpHandle maxLimit = boxX0.mMaxX;
+		PxU32 index1 = runningIndex;
+		while(boxX[index1].mMinX <= maxLimit)
+		{
+			INCREASE_STATS_NB_ITER
 #if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
 	#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
-				if(groupFiltering(group0, groups[index1], lut))
+			if(groupFiltering(group0, groups[index1], lut))
 	#else
-				if(groupFiltering(group0, groups[index1]))
+			if(groupFiltering(group0, groups[index1]))
 	#endif
 #endif
+			{
+				INCREASE_STATS_NB_TESTS
+				if(intersect2D(boxYZ[index0], boxYZ[index1]))
+/*				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&boxYZ[index0].mMinY));
+				b = _mm_shuffle_epi32(b, 78);
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&boxYZ[index1].mMinY));
+				const __m128i d = _mm_cmpgt_epi32(a, b);
+				const int mask = _mm_movemask_epi8(d);
+				if(mask==0x0000ff00)*/
 				{
-					INCREASE_STATS_NB_TESTS
-					if(intersect2D(boxYZ[index0], boxYZ[index1]))
-/*					__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&boxYZ[index0].mMinY));
-					b = _mm_shuffle_epi32(b, 78);
-					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&boxYZ[index1].mMinY));
-					const __m128i d = _mm_cmpgt_epi32(a, b);
-					const int mask = _mm_movemask_epi8(d);
-					if(mask==0x0000ff00)*/
-					{
-						INCREASE_STATS_NB_PAIRS
-						addPair(&params, index0, index1);
-					}
+					INCREASE_STATS_NB_PAIRS
+					sink.add(index0, index1);
 				}
-				index1++;
 			}
-			index0++;
+			index1++;
 		}
+		index0++;
 	}
-	DUMP_STATS
-
-	dataArray = da.mData;
-	dataArraySize = da.mSize;
-	dataArrayCapacity = da.mCapacity;
 }
 
-template<int codepath>
+// Box pruning of the boxes [start, end) of the first sorted list against the second list
+template<int codepath, class PairSink>
 static void bipartitePruning(
-	const PxU32 nb0, const BoxX* PX_RESTRICT boxX0, const BoxYZ* PX_RESTRICT boxYZ0, const PxU32* PX_RESTRICT remap0, const Bp::FilterGroup::Enum* PX_RESTRICT groups0,
-	const PxU32 nb1, const BoxX* PX_RESTRICT boxX1, const BoxYZ* PX_RESTRICT boxYZ1, const PxU32* PX_RESTRICT remap1, const Bp::FilterGroup::Enum* PX_RESTRICT groups1,
+	const PxU32 nb0, const BoxX* PX_RESTRICT boxX0, const BoxYZ* PX_RESTRICT boxYZ0, const Bp::FilterGroup::Enum* PX_RESTRICT groups0,
+	const PxU32 nb1, const BoxX* PX_RESTRICT boxX1, const BoxYZ* PX_RESTRICT boxYZ1, const Bp::FilterGroup::Enum* PX_RESTRICT groups1,
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 	const bool* lut,
 #endif
-	PxcScratchAllocator* scratchAllocator, SapPairManager& pairManager, DataArray& dataArray
+	const PxU32 start, const PxU32 end, PairSink& sink
 	)
 {
-	AddPairParams params(remap0, remap1, scratchAllocator, &pairManager, &dataArray);
+#if !BP_SAP_TEST_GROUP_ID_CREATEUPDATE
+	PX_UNUSED(groups0);
+	PX_UNUSED(groups1);
+#endif
+	PX_UNUSED(nb0);
 
+	// the running index only depends on the previous box of the first list, so a range starts where the full loop would be.
+	// boxX1[nb1] is a sentinel, so the search stays within the list.
 	PxU32 runningIndex = 0;
-	PxU32 index0 = 0;
+	if(start)
+	{
+		const BpHandle minLimit = boxX0[start-1].mMinX;
+		PxU32 last = nb1;
+		while(runningIndex<last)
+		{
+			const PxU32 middle = (runningIndex + last)>>1;
+			if(codepath ? boxX1[middle].mMinX<=minLimit : boxX1[middle].mMinX<minLimit)
+				runningIndex = middle + 1;
+			else
+				last = middle;
+		}
+	}
+
+	PxU32 index0 = start;
 
-	while(runningIndex<nb1 && index0<nb0)
+	while(runningIndex<nb1 && index0<end)
 	{
 #if BP_SAP_TEST_GROUP_ID_CREATEUPDATE
 		const Bp::FilterGroup::Enum group0 = groups0[index0];
@@ -909,7 +940,7 @@ static void bipartitePruning(
 				if(intersect2D(boxYZ0[index0], boxYZ1[index1]))
 				{
 					INCREASE_STATS_NB_PAIRS
-					addPair(&params, index0, index1);
+					sink.add(index0, index1);
 				}
 			}
 			index1++;
@@ -918,11 +949,168 @@ static void bipartitePruning(
 	}
 }
 
+// below this number of boxes in the pruned list, the pruning stays on the calling thread
+#define BP_SAP_PARALLEL_PRUNING_THRESHOLD	1024
+// boxes of the pruned list per chunk, the pairs of each chunk are recorded separately
+#define BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE	256
+
+namespace
+{
+	struct ParallelPruningContext
+	{
+		const AuxData*		mAuxData0;	// The pruned list
+		const AuxData*		mAuxData1;	// The other list for the bipartite pruning, NULL otherwise
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+		const bool*			mLUT;
+#endif
+		Ps::Array<PxU32>*	mChunkPairs;
+	};
+}
+
+static void pruneNewNewChunks(void* context, PxU32 start, PxU32 nb)
+{
+	const ParallelPruningContext& pc = *reinterpret_cast<const ParallelPruningContext*>(context);
+	const AuxData& data = *pc.mAuxData0;
+
+	// chunks are claimed in multiples of the chunk size, but a serial run gets the whole range at once
+	for(PxU32 chunkStart=start;chunkStart<start+nb;chunkStart+=BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE)
+	{
+		const PxU32 chunkEnd = PxMin(chunkStart+BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE, start+nb);
+		RecordPairSink sink(pc.mChunkPairs[chunkStart/BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE]);
+		boxPruningNewNew(data.mNb, data.mBoxX, data.mBoxYZ, data.mGroups,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+			pc.mLUT,
+#endif
+			chunkStart, chunkEnd, sink);
+	}
+}
+
+template<int codepath>
+static void pruneBipartiteChunks(void* context, PxU32 start, PxU32 nb)
+{
+	const ParallelPruningContext& pc = *reinterpret_cast<const ParallelPruningContext*>(context);
+	const AuxData& data0 = *pc.mAuxData0;
+	const AuxData& data1 = *pc.mAuxData1;
+
+	for(PxU32 chunkStart=start;chunkStart<start+nb;chunkStart+=BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE)
+	{
+		const PxU32 chunkEnd = PxMin(chunkStart+BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE, start+nb);
+		RecordPairSink sink(pc.mChunkPairs[chunkStart/BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE]);
+		bipartitePruning<codepath>(data0.mNb, data0.mBoxX, data0.mBoxYZ, data0.mGroups, data1.mNb, data1.mBoxX, data1.mBoxYZ, data1.mGroups,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+			pc.mLUT,
+#endif
+			chunkStart, chunkEnd, sink);
+	}
+}
+
+// Prunes the boxes of auxData0 (against auxData1 for a bipartite pruning) on the worker threads, then adds the pairs in the order
+// of the serial loop
+static void parallelBoxPruning(PxCpuDispatcher* dispatcher, Cm::BlockingParallelForFunction function, const AuxData* auxData0, const AuxData* auxData1,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	const bool* lut,
+#endif
+	const AddPairParams* params)
+{
+	const PxU32 nb = auxData0->mNb;
+	const PxU32 nbChunks = (nb + BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE - 1)/BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE;
+	Ps::Array<Ps::Array<PxU32> > chunkPairs;
+	chunkPairs.resize(nbChunks);
+
+	ParallelPruningContext context;
+	context.mAuxData0	= auxData0;
+	context.mAuxData1	= auxData1;
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	context.mLUT		= lut;
+#endif
+	context.mChunkPairs	= chunkPairs.begin();
+
+	Cm::blockingParallelFor(dispatcher, nb, BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE, BP_SAP_PARALLEL_PRUNING_CHUNK_SIZE, function, &context, "BroadPhaseSap.boxPruning");
+
+	for(PxU32 i=0;i<nbChunks;i++)
+	{
+		const PxU32* pairs = chunkPairs[i].begin();
+		const PxU32 nbPairs = chunkPairs[i].size()>>1;
+		for(PxU32 j=0;j<nbPairs;j++)
+			addPair(params, pairs[j*2+0], pairs[j*2+1]);
+	}
+}
+
+void performBoxPruningNewNew(	const AuxData* PX_RESTRICT auxData, PxcScratchAllocator* scratchAllocator,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+								const bool* lut,
+#endif
+								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity,
+								PxCpuDispatcher* dispatcher)
+{
+	const PxU32 nb = auxData->mNb;
+	if(!nb)
+		return;
+
+	DataArray da(dataArray, dataArraySize, dataArrayCapacity);
+
+	START_STATS
+	{
+		AddPairParams params(auxData->mRemap, auxData->mRemap, scratchAllocator, &pairManager, &da);
+
+		if(dispatcher && nb>=BP_SAP_PARALLEL_PRUNING_THRESHOLD)
+		{
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+			parallelBoxPruning(dispatcher, pruneNewNewChunks, auxData, NULL, lut, &params);
+#else
+			parallelBoxPruning(dispatcher, pruneNewNewChunks, auxData, NULL, &params);
+#endif
+		}
+		else
+		{
+			AddPairSink sink(&params);
+			boxPruningNewNew(nb, auxData->mBoxX, auxData->mBoxYZ, auxData->mGroups,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+				lut,
+#endif
+				0, nb, sink);
+		}
+	}
+	DUMP_STATS
+
+	dataArray = da.mData;
+	dataArraySize = da.mSize;
+	dataArrayCapacity = da.mCapacity;
+}
+
+template<int codepath>
+static void bipartitePruning(const AuxData* PX_RESTRICT auxData0, const AuxData* PX_RESTRICT auxData1,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	const bool* lut,
+#endif
+	PxcScratchAllocator* scratchAllocator, SapPairManager& pairManager, DataArray& dataArray, PxCpuDispatcher* dispatcher)
+{
+	AddPairParams params(auxData0->mRemap, auxData1->mRemap, scratchAllocator, &pairManager, &dataArray);
+
+	if(dispatcher && auxData0->mNb>=BP_SAP_PARALLEL_PRUNING_THRESHOLD)
+	{
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+		parallelBoxPruning(dispatcher, pruneBipartiteChunks<codepath>, auxData0, auxData1, lut, &params);
+#else
+		parallelBoxPruning(dispatcher, pruneBipartiteChunks<codepath>, auxData0, auxData1, &params);
+#endif
+		return;
+	}
+
+	AddPairSink sink(&params);
+	bipartitePruning<codepath>(auxData0->mNb, auxData0->mBoxX, auxData0->mBoxYZ, auxData0->mGroups, auxData1->mNb, auxData1->mBoxX, auxData1->mBoxYZ, auxData1->mGroups,
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+		lut,
+#endif
+		0, auxData0->mNb, sink);
+}
+
 void performBoxPruningNewOld(	const AuxData* PX_RESTRICT auxData0, const AuxData* PX_RESTRICT auxData1, PxcScratchAllocator* scratchAllocator,
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 								const bool* lut,
 #endif
-								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity)
+								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity,
+								PxCpuDispatcher* dispatcher)
 {
 	const PxU32 nb0 = auxData0->mNb;
 	const PxU32 nb1 = auxData1->mNb;
@@ -934,22 +1122,12 @@ void performBoxPruningNewOld(	const AuxData* PX_RESTRICT auxData0, const AuxData
 
 	START_STATS
 	{
-		const BoxX* boxX0 = auxData0->mBoxX;
-		const BoxYZ* boxYZ0 = auxData0->mBoxYZ;
-		const Bp::FilterGroup::Enum* groups0 = auxData0->mGroups;
-		const PxU32* remap0 = auxData0->mRemap;
-
-		const BoxX* boxX1 = auxData1->mBoxX;
-		const BoxYZ* boxYZ1 = auxData1->mBoxYZ;
-		const Bp::FilterGroup::Enum* groups1 = auxData1->mGroups;
-		const PxU32* remap1 = auxData1->mRemap;
-
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
-		bipartitePruning<0>(nb0, boxX0, boxYZ0, remap0, groups0, nb1, boxX1, boxYZ1, remap1, groups1, lut, scratchAllocator, pairManager, da);
-		bipartitePruning<1>(nb1, boxX1, boxYZ1, remap1, groups1, nb0, boxX0, boxYZ0, remap0, groups0, lut, scratchAllocator, pairManager, da);
+		bipartitePruning<0>(auxData0, auxData1, lut, scratchAllocator, pairManager, da, dispatcher);
+		bipartitePruning<1>(auxData1, auxData0, lut, scratchAllocator, pairManager, da, dispatcher);
 #else
-		bipartitePruning<0>(nb0, boxX0, boxYZ0, remap0, groups0, nb1, boxX1, boxYZ1, remap1, groups1, scratchAllocator, pairManager, da);
-		bipartitePruning<1>(nb1, boxX1, boxYZ1, remap1, groups1, nb0, boxX0, boxYZ0, remap0, groups0, scratchAllocator, pairManager, da);
+		bipartitePruning<0>(auxData0, auxData1, scratchAllocator, pairManager, da, dispatcher);
+		bipartitePruning<1>(auxData1, auxData0, scratchAllocator, pairManager, da, dispatcher);
 #endif
 	}
 	DUMP_STATS
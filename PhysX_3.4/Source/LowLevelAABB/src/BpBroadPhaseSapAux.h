@@ -262,13 +262,15 @@ void performBoxPruningNewNew(	const AuxData* PX_RESTRICT auxData, PxcScratchAllo
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 								const bool* lut,
 #endif
-								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity);
+								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity,
+								PxCpuDispatcher* dispatcher);
 
 void performBoxPruningNewOld(	const AuxData* PX_RESTRICT auxData0, const AuxData* PX_RESTRICT auxData1, PxcScratchAllocator* scratchAllocator,
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 								const bool* lut,
 #endif
-								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity);
+								SapPairManager& pairManager, BpHandle*& dataArray, PxU32& dataArraySize, PxU32& dataArrayCapacity,
+								PxCpuDispatcher* dispatcher);
 
 PX_FORCE_INLINE bool Intersect2D_Handle
 (const BpHandle bDir1Min, const BpHandle bDir1Max, const BpHandle bDir2Min, const BpHandle bDir2Max,
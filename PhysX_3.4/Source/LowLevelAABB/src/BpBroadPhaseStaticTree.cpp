@@ -0,0 +1,609 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "foundation/PxProfiler.h"
+#include "BpBroadPhaseStaticTree.h"
+#include "PsSort.h"
+
+using namespace physx;
+using namespace Bp;
+
+// statics waiting for a rebuild are tested brute-force against each moving object, so keep the list short
+#define BP_STATIC_TREE_MAX_PENDING	256
+#define BP_STATIC_TREE_LEAF_SIZE	4
+#define BP_STATIC_TREE_STACK_SIZE	64
+
+void StaticTreeUpdateTask::runInternal()
+{
+	mBP->updateStatics();
+}
+
+BroadPhaseStaticTree::BroadPhaseStaticTree(BroadPhase* broadPhase, PxU64 contextID) :
+	mBroadPhase				(broadPhase),
+	mStaticTreeUpdateTask	(contextID),
+	mBroadPhaseUpdated		(false),
+	mContextID				(contextID),
+	mBounds					(NULL),
+	mContactDistance		(NULL),
+	mGroups					(NULL),
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	mLUT					(NULL),
+#endif
+	mNbStalePrims			(0),
+	mRebuildTree			(false)
+{
+	PX_ASSERT(broadPhase);
+	mStaticTreeUpdateTask.setBroadPhase(this);
+}
+
+BroadPhaseStaticTree::~BroadPhaseStaticTree()
+{
+	mBroadPhase->destroy();
+}
+
+void BroadPhaseStaticTree::resizeBitmaps(PxU32 capacity)
+{
+	if(capacity<=mStatics.size())
+		return;
+
+	mStatics.resize(capacity);
+	mObjects.resize(capacity);
+	mInTree.resize(capacity);
+	mPending.resize(capacity);
+	mMoved.resize(capacity);
+	mRemoved.resize(capacity);
+}
+
+void BroadPhaseStaticTree::setUpdateData(const BroadPhaseUpdateData& updateData)
+{
+	mBounds				= updateData.getAABBs();
+	mContactDistance	= updateData.getContactDistance();
+	mGroups				= updateData.getGroups();
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	mLUT				= updateData.getLUT();
+#endif
+	resizeBitmaps(updateData.getCapacity());
+
+	mCreatedStatics.forceSize_Unsafe(0);
+	mUpdatedStatics.forceSize_Unsafe(0);
+	mRemovedHandles.forceSize_Unsafe(0);
+	mCreatedObjects.forceSize_Unsafe(0);
+	mUpdatedObjects.forceSize_Unsafe(0);
+	mRemovedObjects.forceSize_Unsafe(0);
+
+	// the handles stay sorted, as required by the wrapped broadphase
+	const BpHandle* removed = updateData.getRemovedHandles();
+	const PxU32 nbRemoved = updateData.getNumRemovedHandles();
+	for(PxU32 i=0;i<nbRemoved;i++)
+	{
+		const BpHandle h = removed[i];
+		mRemovedHandles.pushBack(h);
+		mRemoved.set(h);
+		if(mStatics.test(h))
+		{
+			mStatics.reset(h);
+			mPending.reset(h);
+			if(mInTree.test(h))
+			{
+				mInTree.reset(h);
+				mNbStalePrims++;
+			}
+		}
+		else
+		{
+			mObjects.reset(h);
+			mRemovedObjects.pushBack(h);
+		}
+	}
+
+	const BpHandle* created = updateData.getCreatedHandles();
+	const PxU32 nbCreated = updateData.getNumCreatedHandles();
+	for(PxU32 i=0;i<nbCreated;i++)
+	{
+		const BpHandle h = created[i];
+		mMoved.set(h);
+		if(mGroups[h]==FilterGroup::eSTATICS)
+		{
+			mStatics.set(h);
+			mCreatedStatics.pushBack(h);
+		}
+		else
+		{
+			mObjects.set(h);
+			mCreatedObjects.pushBack(h);
+		}
+	}
+
+	const BpHandle* updated = updateData.getUpdatedHandles();
+	const PxU32 nbUpdated = updateData.getNumUpdatedHandles();
+	for(PxU32 i=0;i<nbUpdated;i++)
+	{
+		const BpHandle h = updated[i];
+		mMoved.set(h);
+		if(mStatics.test(h))
+		{
+			mUpdatedStatics.pushBack(h);
+			if(mInTree.test(h))
+			{
+				mInTree.reset(h);
+				mNbStalePrims++;
+			}
+		}
+		else
+			mUpdatedObjects.pushBack(h);
+	}
+
+	// new and moved statics leave the tree until the next rebuild
+	for(PxU32 i=0;i<mCreatedStatics.size();i++)
+	{
+		const BpHandle h = mCreatedStatics[i];
+		mPending.set(h);
+		mPendingStatics.pushBack(h);
+	}
+	for(PxU32 i=0;i<mUpdatedStatics.size();i++)
+	{
+		const BpHandle h = mUpdatedStatics[i];
+		if(!mPending.test(h))
+		{
+			mPending.set(h);
+			mPendingStatics.pushBack(h);
+		}
+	}
+}
+
+void BroadPhaseStaticTree::update(const PxU32 numCpuTasks, PxcScratchAllocator* scratchAllocator, const BroadPhaseUpdateData& updateData, physx::PxBaseTask* continuation, physx::PxBaseTask* narrowPhaseUnblockTask)
+{
+#if PX_CHECKED
+	if(!BroadPhaseUpdateData::isValid(updateData, *this))
+	{
+		PX_CHECK_MSG(false, "Illegal BroadPhaseUpdateData \n");
+		mBroadPhaseUpdated = false;
+		mCreatedStaticPairs.forceSize_Unsafe(0);
+		mDeletedStaticPairs.forceSize_Unsafe(0);
+		if(narrowPhaseUnblockTask)
+			narrowPhaseUnblockTask->removeReference();
+		return;
+	}
+#endif
+
+	setUpdateData(updateData);
+
+	const BroadPhaseUpdateData objectsData(
+		mCreatedObjects.begin(), mCreatedObjects.size(),
+		mUpdatedObjects.begin(), mUpdatedObjects.size(),
+		mRemovedObjects.begin(), mRemovedObjects.size(),
+		updateData.getAABBs(), updateData.getGroups(),
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+		updateData.getLUT(),
+#endif
+		updateData.getContactDistance(), updateData.getCapacity(), updateData.getStateChanged());
+
+	// the statics are processed in parallel with the wrapped broadphase, both share the continuation
+	mBroadPhaseUpdated = mCreatedObjects.size() || mUpdatedObjects.size() || mRemovedObjects.size();
+	if(mBroadPhaseUpdated)
+		mBroadPhase->update(numCpuTasks, scratchAllocator, objectsData, continuation, narrowPhaseUnblockTask);
+	else if(narrowPhaseUnblockTask)
+		narrowPhaseUnblockTask->removeReference();
+
+	if(continuation)
+	{
+		mStaticTreeUpdateTask.setContinuation(continuation);
+		mStaticTreeUpdateTask.removeReference();
+	}
+	else
+		updateStatics();
+}
+
+void BroadPhaseStaticTree::singleThreadedUpdate(PxcScratchAllocator* scratchAllocator, const BroadPhaseUpdateData& updateData)
+{
+	setUpdateData(updateData);
+
+	const BroadPhaseUpdateData objectsData(
+		mCreatedObjects.begin(), mCreatedObjects.size(),
+		mUpdatedObjects.begin(), mUpdatedObjects.size(),
+		mRemovedObjects.begin(), mRemovedObjects.size(),
+		updateData.getAABBs(), updateData.getGroups(),
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+		updateData.getLUT(),
+#endif
+		updateData.getContactDistance(), updateData.getCapacity(), updateData.getStateChanged());
+
+	mBroadPhaseUpdated = mCreatedObjects.size() || mUpdatedObjects.size() || mRemovedObjects.size();
+	if(mBroadPhaseUpdated)
+		mBroadPhase->singleThreadedUpdate(scratchAllocator, objectsData);
+
+	updateStatics();
+	mergePairs();
+}
+
+void BroadPhaseStaticTree::fetchBroadPhaseResults(physx::PxBaseTask* narrowPhaseUnblockTask)
+{
+	if(mBroadPhaseUpdated)
+		mBroadPhase->fetchBroadPhaseResults(narrowPhaseUnblockTask);
+
+	mergePairs();
+}
+
+void BroadPhaseStaticTree::mergePairs()
+{
+	mCreated.forceSize_Unsafe(0);
+	mDeleted.forceSize_Unsafe(0);
+
+	if(mBroadPhaseUpdated)
+	{
+		const PxU32 nbCreated = mBroadPhase->getNbCreatedPairs();
+		const BroadPhasePair* created = mBroadPhase->getCreatedPairs();
+		for(PxU32 i=0;i<nbCreated;i++)
+			mCreated.pushBack(created[i]);
+
+		const PxU32 nbDeleted = mBroadPhase->getNbDeletedPairs();
+		const BroadPhasePair* deleted = mBroadPhase->getDeletedPairs();
+		for(PxU32 i=0;i<nbDeleted;i++)
+			mDeleted.pushBack(deleted[i]);
+	}
+
+	for(PxU32 i=0;i<mCreatedStaticPairs.size();i++)
+		mCreated.pushBack(mCreatedStaticPairs[i]);
+	for(PxU32 i=0;i<mDeletedStaticPairs.size();i++)
+		mDeleted.pushBack(mDeletedStaticPairs[i]);
+}
+
+void BroadPhaseStaticTree::freeBuffers()
+{
+	mBroadPhase->freeBuffers();
+
+	mCreated.forceSize_Unsafe(0);
+	mDeleted.forceSize_Unsafe(0);
+	mCreatedStaticPairs.forceSize_Unsafe(0);
+	mDeletedStaticPairs.forceSize_Unsafe(0);
+}
+
+void BroadPhaseStaticTree::shiftOrigin(const PxVec3& shift)
+{
+	mBroadPhase->shiftOrigin(shift);
+
+	// the bounds have been shifted already, the tree is rebuilt from them on the next update
+	mRebuildTree = true;
+}
+
+#if PX_CHECKED
+bool BroadPhaseStaticTree::isValid(const BroadPhaseUpdateData& updateData) const
+{
+	const PxU32 capacity = mStatics.size();
+
+	const BpHandle* created = updateData.getCreatedHandles();
+	const PxU32 nbCreated = updateData.getNumCreatedHandles();
+	for(PxU32 i=0;i<nbCreated;i++)
+	{
+		const BpHandle h = created[i];
+		if(h<capacity && (mStatics.test(h) || mObjects.test(h)))
+			return false;
+	}
+
+	const BpHandle* updated = updateData.getUpdatedHandles();
+	const PxU32 nbUpdated = updateData.getNumUpdatedHandles();
+	for(PxU32 i=0;i<nbUpdated;i++)
+	{
+		const BpHandle h = updated[i];
+		if(h>=capacity || !(mStatics.test(h) || mObjects.test(h)))
+			return false;
+	}
+
+	const BpHandle* removed = updateData.getRemovedHandles();
+	const PxU32 nbRemoved = updateData.getNumRemovedHandles();
+	for(PxU32 i=0;i<nbRemoved;i++)
+	{
+		const BpHandle h = removed[i];
+		if(h>=capacity || !(mStatics.test(h) || mObjects.test(h)))
+			return false;
+	}
+	return true;
+}
+#endif
+
+namespace
+{
+	struct PrimCenterLess
+	{
+		PrimCenterLess(PxU32 axis) : mAxis(axis)	{}
+
+		PX_FORCE_INLINE bool operator()(const StaticTreePrim& a, const StaticTreePrim& b) const
+		{
+			return PxU64(a.mBox.getMin(mAxis)) + a.mBox.getMax(mAxis) < PxU64(b.mBox.getMin(mAxis)) + b.mBox.getMax(mAxis);
+		}
+
+		PxU32	mAxis;
+	};
+}
+
+PxU32 BroadPhaseStaticTree::buildNode(PxU32 start, PxU32 nbPrims)
+{
+	const StaticTreePrim* PX_RESTRICT prims = mPrims.begin() + start;
+
+	IntegerAABB box = prims[0].mBox;
+	PxU64 minCenter[3];
+	PxU64 maxCenter[3];
+	for(PxU32 axis=0;axis<3;axis++)
+		minCenter[axis] = maxCenter[axis] = PxU64(box.getMin(axis)) + box.getMax(axis);
+
+	for(PxU32 i=1;i<nbPrims;i++)
+	{
+		box.include(prims[i].mBox);
+		for(PxU32 axis=0;axis<3;axis++)
+		{
+			const PxU64 center = PxU64(prims[i].mBox.getMin(axis)) + prims[i].mBox.getMax(axis);
+			minCenter[axis] = PxMin(minCenter[axis], center);
+			maxCenter[axis] = PxMax(maxCenter[axis], center);
+		}
+	}
+
+	const PxU32 nodeIndex = mNodes.size();
+	mNodes.pushBack(StaticTreeNode(box));
+
+	if(nbPrims<=BP_STATIC_TREE_LEAF_SIZE)
+	{
+		mNodes[nodeIndex].mData = start;
+		mNodes[nodeIndex].mNbPrims = nbPrims;
+		return nodeIndex;
+	}
+
+	// median split along the axis where the centers spread the most. The tree is rebuilt rarely, so a simple sort is enough.
+	PxU32 splitAxis = 0;
+	for(PxU32 axis=1;axis<3;axis++)
+	{
+		if(maxCenter[axis] - minCenter[axis] > maxCenter[splitAxis] - minCenter[splitAxis])
+			splitAxis = axis;
+	}
+	Ps::sort(mPrims.begin() + start, nbPrims, PrimCenterLess(splitAxis));
+
+	const PxU32 nbLeft = nbPrims/2;
+	buildNode(start, nbLeft);
+	const PxU32 rightIndex = buildNode(start + nbLeft, nbPrims - nbLeft);
+	mNodes[nodeIndex].mData = rightIndex;
+	return nodeIndex;
+}
+
+void BroadPhaseStaticTree::rebuildTree()
+{
+	PX_PROFILE_ZONE("BroadPhase.StaticTreeRebuild", mContextID);
+
+	mNodes.forceSize_Unsafe(0);
+	mPrims.forceSize_Unsafe(0);
+
+	Cm::BitMap::Iterator it(mStatics);
+	for(PxU32 h=it.getNext(); h!=Cm::BitMap::Iterator::DONE; h=it.getNext())
+	{
+		mPrims.pushBack(StaticTreePrim(IntegerAABB(mBounds[h], mContactDistance[h]), h));
+		mInTree.set(h);
+	}
+
+	for(PxU32 i=0;i<mPendingStatics.size();i++)
+		mPending.reset(mPendingStatics[i]);
+	mPendingStatics.forceSize_Unsafe(0);
+	mPendingPrims.forceSize_Unsafe(0);
+
+	mNbStalePrims = 0;
+	mRebuildTree = false;
+
+	const PxU32 nbPrims = mPrims.size();
+	if(nbPrims)
+	{
+		mNodes.reserve(2*(nbPrims/BP_STATIC_TREE_LEAF_SIZE) + 1);
+		buildNode(0, nbPrims);
+	}
+}
+
+void BroadPhaseStaticTree::addPair(BpHandle object, BpHandle staticHandle)
+{
+	const PxU32 id0 = PxMin(object, staticHandle);
+	const PxU32 id1 = PxMax(object, staticHandle);
+	if(mPairs.insert((PxU64(id0)<<32)|id1))
+		mCreatedStaticPairs.pushBack(BroadPhasePair(id0, id1));
+}
+
+void BroadPhaseStaticTree::queryTree(BpHandle handle)
+{
+	const IntegerAABB box(mBounds[handle], mContactDistance[handle]);
+	const Bp::FilterGroup::Enum group = mGroups[handle];
+
+	if(mNodes.size())
+	{
+		const StaticTreeNode* PX_RESTRICT nodes = mNodes.begin();
+		const StaticTreePrim* PX_RESTRICT prims = mPrims.begin();
+
+		PxU32 stack[BP_STATIC_TREE_STACK_SIZE];
+		PxU32 nbEntries = 0;
+		stack[nbEntries++] = 0;
+		while(nbEntries)
+		{
+			const PxU32 nodeIndex = stack[--nbEntries];
+			const StaticTreeNode& node = nodes[nodeIndex];
+			if(!node.mBox.intersects(box))
+				continue;
+
+			if(node.mNbPrims)
+			{
+				for(PxU32 i=0;i<node.mNbPrims;i++)
+				{
+					const StaticTreePrim& prim = prims[node.mData + i];
+					if(mInTree.test(prim.mHandle) && prim.mBox.intersects(box)
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+						&& groupFiltering(group, mGroups[prim.mHandle], mLUT)
+#else
+						&& groupFiltering(group, mGroups[prim.mHandle])
+#endif
+						)
+						addPair(handle, prim.mHandle);
+				}
+			}
+			else
+			{
+				PX_ASSERT(nbEntries+2<=BP_STATIC_TREE_STACK_SIZE);
+				stack[nbEntries++] = node.mData;
+				stack[nbEntries++] = nodeIndex + 1;
+			}
+		}
+	}
+
+	for(PxU32 i=0;i<mPendingPrims.size();i++)
+	{
+		const StaticTreePrim& prim = mPendingPrims[i];
+		if(prim.mBox.intersects(box)
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+			&& groupFiltering(group, mGroups[prim.mHandle], mLUT)
+#else
+			&& groupFiltering(group, mGroups[prim.mHandle])
+#endif
+			)
+			addPair(handle, prim.mHandle);
+	}
+}
+
+void BroadPhaseStaticTree::updateStatics()
+{
+	PX_PROFILE_ZONE("BroadPhase.StaticTreeUpdate", mContextID);
+
+	mCreatedStaticPairs.forceSize_Unsafe(0);
+	mDeletedStaticPairs.forceSize_Unsafe(0);
+
+	// pairs of removed objects are dropped without being reported
+	if(mRemovedHandles.size() && mPairs.size())
+	{
+		mLostPairs.forceSize_Unsafe(0);
+		const PxU64* PX_RESTRICT pairs = mPairs.getEntries();
+		const PxU32 nbPairs = mPairs.size();
+		for(PxU32 i=0;i<nbPairs;i++)
+		{
+			const PxU32 id0 = PxU32(pairs[i]>>32);
+			const PxU32 id1 = PxU32(pairs[i]);
+			if(mRemoved.test(id0) || mRemoved.test(id1))
+				mLostPairs.pushBack(pairs[i]);
+		}
+		for(PxU32 i=0;i<mLostPairs.size();i++)
+			mPairs.erase(mLostPairs[i]);
+	}
+
+	// drop the removed statics from the pending list
+	{
+		PxU32 nbPending = 0;
+		for(PxU32 i=0;i<mPendingStatics.size();i++)
+		{
+			const BpHandle h = mPendingStatics[i];
+			if(mPending.test(h))
+				mPendingStatics[nbPending++] = h;
+		}
+		mPendingStatics.forceSize_Unsafe(nbPending);
+	}
+
+	if(mRebuildTree || mPendingStatics.size()>BP_STATIC_TREE_MAX_PENDING || (mNbStalePrims>BP_STATIC_TREE_MAX_PENDING && mNbStalePrims*4>mPrims.size()))
+	{
+		rebuildTree();
+	}
+	else
+	{
+		mPendingPrims.forceSize_Unsafe(0);
+		for(PxU32 i=0;i<mPendingStatics.size();i++)
+		{
+			const BpHandle h = mPendingStatics[i];
+			mPendingPrims.pushBack(StaticTreePrim(IntegerAABB(mBounds[h], mContactDistance[h]), h));
+		}
+	}
+
+	const PxU32 nbMovedStatics = mCreatedStatics.size() + mUpdatedStatics.size();
+	const PxU32 nbMovedObjects = mCreatedObjects.size() + mUpdatedObjects.size();
+
+	// Lost pairs, where one of the objects moved
+	if((nbMovedStatics || nbMovedObjects) && mPairs.size())
+	{
+		mLostPairs.forceSize_Unsafe(0);
+		const PxU64* PX_RESTRICT pairs = mPairs.getEntries();
+		const PxU32 nbPairs = mPairs.size();
+		for(PxU32 i=0;i<nbPairs;i++)
+		{
+			const PxU32 id0 = PxU32(pairs[i]>>32);
+			const PxU32 id1 = PxU32(pairs[i]);
+			if(!mMoved.test(id0) && !mMoved.test(id1))
+				continue;
+
+			if(!IntegerAABB(mBounds[id0], mContactDistance[id0]).intersects(IntegerAABB(mBounds[id1], mContactDistance[id1])))
+				mLostPairs.pushBack(pairs[i]);
+		}
+		for(PxU32 i=0;i<mLostPairs.size();i++)
+		{
+			const PxU64 key = mLostPairs[i];
+			mPairs.erase(key);
+			mDeletedStaticPairs.pushBack(BroadPhasePair(PxU32(key>>32), PxU32(key)));
+		}
+	}
+
+	// New pairs of the moved objects, vs the tree and the pending statics
+	for(PxU32 i=0;i<mCreatedObjects.size();i++)
+		queryTree(mCreatedObjects[i]);
+	for(PxU32 i=0;i<mUpdatedObjects.size();i++)
+		queryTree(mUpdatedObjects[i]);
+
+	// New pairs of the moved statics vs the objects that didn't move. Statics rarely move, so this is brute-force.
+	if(nbMovedStatics)
+	{
+		Cm::BitMap::Iterator it(mObjects);
+		for(PxU32 h=it.getNext(); h!=Cm::BitMap::Iterator::DONE; h=it.getNext())
+		{
+			if(mMoved.test(h))
+				continue;
+
+			const IntegerAABB box(mBounds[h], mContactDistance[h]);
+			const Bp::FilterGroup::Enum group = mGroups[h];
+			for(PxU32 i=0;i<nbMovedStatics;i++)
+			{
+				const BpHandle staticHandle = i<mCreatedStatics.size() ? mCreatedStatics[i] : mUpdatedStatics[i - mCreatedStatics.size()];
+				if(box.intersects(IntegerAABB(mBounds[staticHandle], mContactDistance[staticHandle]))
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+					&& groupFiltering(group, mGroups[staticHandle], mLUT)
+#else
+					&& groupFiltering(group, mGroups[staticHandle])
+#endif
+					)
+					addPair(h, staticHandle);
+			}
+		}
+	}
+
+	// Reset the per-frame flags
+	for(PxU32 i=0;i<mCreatedStatics.size();i++)
+		mMoved.reset(mCreatedStatics[i]);
+	for(PxU32 i=0;i<mUpdatedStatics.size();i++)
+		mMoved.reset(mUpdatedStatics[i]);
+	for(PxU32 i=0;i<mCreatedObjects.size();i++)
+		mMoved.reset(mCreatedObjects[i]);
+	for(PxU32 i=0;i<mUpdatedObjects.size();i++)
+		mMoved.reset(mUpdatedObjects[i]);
+	for(PxU32 i=0;i<mRemovedHandles.size();i++)
+		mRemoved.reset(mRemovedHandles[i]);
+}
@@ -0,0 +1,188 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef BP_BROADPHASE_STATIC_TREE_H
+#define BP_BROADPHASE_STATIC_TREE_H
+
+#include "CmPhysXCommon.h"
+#include "CmBitMap.h"
+#include "CmTask.h"
+#include "BpBroadPhase.h"
+#include "BpBroadPhaseUpdate.h"
+#include "PsArray.h"
+#include "PsHashSet.h"
+
+namespace physx
+{
+namespace Bp
+{
+	class BroadPhaseStaticTree;
+
+	class StaticTreeUpdateTask : public Cm::Task
+	{
+	public:
+											StaticTreeUpdateTask(PxU64 contextId) : Cm::Task(contextId), mBP(NULL)	{}
+
+		PX_FORCE_INLINE	void				setBroadPhase(BroadPhaseStaticTree* bp)	{ mBP = bp;	}
+
+		virtual			void				runInternal();
+		virtual			const char*			getName() const { return "BpStaticTree.update"; }
+
+	private:
+						BroadPhaseStaticTree*	mBP;
+	};
+
+	// Static object stored in the tree, with its encoded bounds
+	struct StaticTreePrim
+	{
+		StaticTreePrim(const IntegerAABB& box, BpHandle handle) : mBox(box), mHandle(handle)	{}
+
+		IntegerAABB		mBox;
+		BpHandle		mHandle;
+	};
+
+	// Leaves have mNbPrims!=0 and reference the prims [mData ; mData+mNbPrims[. The first child
+	// of an internal node immediately follows it, mData is the index of the second one.
+	struct StaticTreeNode
+	{
+		StaticTreeNode(const IntegerAABB& box) : mBox(box), mData(0), mNbPrims(0)	{}
+
+		IntegerAABB		mBox;
+		PxU32			mData;
+		PxU32			mNbPrims;
+	};
+
+	/**
+	\brief Broadphase keeping the static objects out of the sweep-and-prune or MBP.
+
+	Objects in the eSTATICS group are stored in an AABB tree that is only rebuilt once enough of them have been added,
+	moved or removed, the others go to the wrapped broadphase. New statics wait in a small list until the next rebuild.
+	Statics vs non-statics pairs come from tree queries with the bounds of the non-static objects that moved, plus
+	brute-force tests of the statics that were added or moved during the frame, so their cost doesn't depend on the
+	number of statics that stay still.
+
+	The pairs of the two parts are disjoint, the reported pairs follow the rules of BroadPhase::getCreatedPairs and
+	BroadPhase::getDeletedPairs. Statics are never reported out-of-bounds by MBP.
+	*/
+	class BroadPhaseStaticTree : public BroadPhase, public Ps::UserAllocated
+	{
+											PX_NOCOPY(BroadPhaseStaticTree)
+		public:
+											BroadPhaseStaticTree(BroadPhase* broadPhase, PxU64 contextID);
+		virtual								~BroadPhaseStaticTree();
+
+	// BroadPhaseBase
+		virtual	bool						getCaps(PxBroadPhaseCaps& caps)														const	{ return mBroadPhase->getCaps(caps);							}
+		virtual	PxU32						getNbRegions()																		const	{ return mBroadPhase->getNbRegions();							}
+		virtual	PxU32						getRegions(PxBroadPhaseRegionInfo* userBuffer, PxU32 bufferSize, PxU32 startIndex=0) const	{ return mBroadPhase->getRegions(userBuffer, bufferSize, startIndex);	}
+		virtual	PxU32						addRegion(const PxBroadPhaseRegion& region, bool populateRegion)							{ return mBroadPhase->addRegion(region, populateRegion);		}
+		virtual	bool						removeRegion(PxU32 handle)																	{ return mBroadPhase->removeRegion(handle);						}
+		virtual	bool						setAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)							{ return mBroadPhase->setAdaptiveRegions(desc);					}
+		virtual	PxU32						getNbOutOfBoundsObjects()	const															{ return mBroadPhase->getNbOutOfBoundsObjects();				}
+		virtual	const PxU32*				getOutOfBoundsObjects()		const															{ return mBroadPhase->getOutOfBoundsObjects();					}
+	//~BroadPhaseBase
+
+	// BroadPhase
+		virtual	PxBroadPhaseType::Enum		getType()					const	{ return mBroadPhase->getType();	}
+		virtual	void						destroy()							{ delete this;						}
+		virtual	void						update(const PxU32 numCpuTasks, PxcScratchAllocator* scratchAllocator, const BroadPhaseUpdateData& updateData, physx::PxBaseTask* continuation, physx::PxBaseTask* narrowPhaseUnblockTask);
+		virtual void						fetchBroadPhaseResults(physx::PxBaseTask* narrowPhaseUnblockTask);
+		virtual	PxU32						getNbCreatedPairs()		const		{ return mCreated.size();			}
+		virtual BroadPhasePair*				getCreatedPairs()					{ return mCreated.begin();			}
+		virtual PxU32						getNbDeletedPairs()		const		{ return mDeleted.size();			}
+		virtual BroadPhasePair*				getDeletedPairs()					{ return mDeleted.begin();			}
+		virtual void						freeBuffers();
+		virtual void						shiftOrigin(const PxVec3& shift);
+#if PX_CHECKED
+		virtual bool						isValid(const BroadPhaseUpdateData& updateData)	const;
+#endif
+		virtual BroadPhasePair*				getBroadPhasePairs() const			{ return NULL;						}
+		virtual void						deletePairs()						{ mBroadPhase->deletePairs();		}
+		virtual	void						singleThreadedUpdate(PxcScratchAllocator* scratchAllocator, const BroadPhaseUpdateData& updateData);
+	//~BroadPhase
+
+				void						updateStatics();
+	private:
+				BroadPhase*					mBroadPhase;	// Broadphase of the non-static objects
+				StaticTreeUpdateTask		mStaticTreeUpdateTask;
+
+				// Handles of the current update, split between the statics and the wrapped broadphase
+				Ps::Array<BpHandle>			mCreatedStatics;
+				Ps::Array<BpHandle>			mUpdatedStatics;
+				Ps::Array<BpHandle>			mRemovedHandles;	// Statics and non-statics, their pairs are dropped
+				Ps::Array<BpHandle>			mCreatedObjects;
+				Ps::Array<BpHandle>			mUpdatedObjects;
+				Ps::Array<BpHandle>			mRemovedObjects;
+				bool						mBroadPhaseUpdated;
+				PxU64						mContextID;
+
+				const PxBounds3*			mBounds;
+				const PxReal*				mContactDistance;
+				const Bp::FilterGroup::Enum*mGroups;
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+				const bool*					mLUT;
+#endif
+
+				Cm::BitMap					mStatics;
+				Cm::BitMap					mObjects;
+				Cm::BitMap					mInTree;	// Statics whose tree entry is up to date
+				Cm::BitMap					mPending;	// Statics waiting for the next rebuild
+				Cm::BitMap					mMoved;		// Created or updated this frame
+				Cm::BitMap					mRemoved;	// Removed this frame
+
+				Ps::Array<StaticTreeNode>	mNodes;
+				Ps::Array<StaticTreePrim>	mPrims;
+				PxU32						mNbStalePrims;
+				bool						mRebuildTree;
+				Ps::Array<BpHandle>			mPendingStatics;
+				Ps::Array<StaticTreePrim>	mPendingPrims;
+
+				Ps::CoalescedHashSet<PxU64>	mPairs;		// Current statics vs non-statics pairs
+				Ps::Array<PxU64>			mLostPairs;
+				Ps::Array<BroadPhasePair>	mCreatedStaticPairs;
+				Ps::Array<BroadPhasePair>	mDeletedStaticPairs;
+
+				Ps::Array<BroadPhasePair>	mCreated;
+				Ps::Array<BroadPhasePair>	mDeleted;
+
+				void						setUpdateData(const BroadPhaseUpdateData& updateData);
+				void						resizeBitmaps(PxU32 capacity);
+				void						rebuildTree();
+				PxU32						buildNode(PxU32 start, PxU32 nbPrims);
+				void						queryTree(BpHandle handle);
+				void						addPair(BpHandle object, BpHandle staticHandle);
+				void						mergePairs();
+	};
+
+} //namespace Bp
+
+} //namespace physx
+
+#endif // BP_BROADPHASE_STATIC_TREE_H
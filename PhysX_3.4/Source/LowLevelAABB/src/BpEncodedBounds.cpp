@@ -0,0 +1,88 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "BpEncodedBounds.h"
+#include "PsAllocator.h"
+#include "foundation/PxMemory.h"
+
+using namespace physx;
+using namespace Bp;
+
+EncodedBounds::EncodedBounds() : mCapacity(0)
+{
+	mValues[0] = mValues[1] = mValues[2] = NULL;
+}
+
+EncodedBounds::~EncodedBounds()
+{
+	PX_FREE(mValues[0]);
+	PX_FREE(mValues[1]);
+	PX_FREE(mValues[2]);
+}
+
+void EncodedBounds::resize(PxU32 capacity)
+{
+	if(capacity<=mCapacity)
+		return;
+
+	for(PxU32 axis=0;axis<3;axis++)
+	{
+		ValType* newValues = reinterpret_cast<ValType*>(PX_ALLOC(sizeof(ValType)*2*capacity, "EncodedBounds"));
+		if(mValues[axis])
+			PxMemCopy(newValues, mValues[axis], sizeof(ValType)*2*mCapacity);
+		PX_FREE(mValues[axis]);
+		mValues[axis] = newValues;
+	}
+	mCapacity = capacity;
+}
+
+void EncodedBounds::update(const PxBounds3* PX_RESTRICT bounds, const PxReal* PX_RESTRICT contactDistances, const BpHandle* PX_RESTRICT handles, PxU32 nbHandles)
+{
+	ValType* PX_RESTRICT values0 = mValues[0];
+	ValType* PX_RESTRICT values1 = mValues[1];
+	ValType* PX_RESTRICT values2 = mValues[2];
+
+	PX_ALIGN(16, ValType encodedMin[4]);
+	PX_ALIGN(16, ValType encodedMax[4]);
+	while(nbHandles--)
+	{
+		const BpHandle index = *handles++;
+		PX_ASSERT(index<mCapacity);
+
+		encodeInflatedBounds(bounds[index], contactDistances[index], encodedMin, encodedMax);
+
+		values0[index*2+0] = encodedMin[0];
+		values0[index*2+1] = encodedMax[0];
+		values1[index*2+0] = encodedMin[1];
+		values1[index*2+1] = encodedMax[1];
+		values2[index*2+0] = encodedMin[2];
+		values2[index*2+1] = encodedMax[2];
+	}
+}
@@ -0,0 +1,116 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef BP_ENCODED_BOUNDS_H
+#define BP_ENCODED_BOUNDS_H
+
+#include "foundation/PxBounds3.h"
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsVecMath.h"
+#include "BpBroadPhaseUpdate.h"
+
+#if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
+	#define BP_SIMD_ENCODE_BOUNDS
+#endif
+
+namespace physx
+{
+namespace Bp
+{
+	/**
+	\brief Encodes the bounds inflated by the contact distance, for the 3 axes at once.
+
+	Gives the same values as encodeMin / encodeMax. Both outputs must have room for 4 values.
+
+	\note The bounds are read with 16 bytes loads, so there must be 4 readable bytes after them. This is the case for the
+	bounds of the BoundsArray, which always allocates one more box (see BoundsArray::initEntry).
+	*/
+	PX_FORCE_INLINE void encodeInflatedBounds(const PxBounds3& bounds, PxReal contactDistance, ValType* PX_RESTRICT encodedMin, ValType* PX_RESTRICT encodedMax)
+	{
+#ifdef BP_SIMD_ENCODE_BOUNDS
+		const __m128 distance = _mm_set1_ps(contactDistance);
+		const __m128i minV = _mm_castps_si128(_mm_sub_ps(_mm_loadu_ps(&bounds.minimum.x), distance));
+		const __m128i maxV = _mm_castps_si128(_mm_add_ps(_mm_loadu_ps(&bounds.maximum.x), distance));
+
+		// encodeFloat: flip all the bits of negative values, only the sign bit of positive ones
+		const __m128i signBit = _mm_set1_epi32(PxI32(0x80000000));
+		const __m128i encodedMinV = _mm_xor_si128(minV, _mm_or_si128(_mm_srai_epi32(minV, 31), signBit));
+		const __m128i encodedMaxV = _mm_xor_si128(maxV, _mm_or_si128(_mm_srai_epi32(maxV, 31), signBit));
+
+		// Grid snapping of IntegerAABB::encodeFloatMin / encodeFloatMax, ((x>>4)-1)<<4 is (x & ~15) - 16
+		const __m128i snapMask = _mm_set1_epi32(~15);
+		const __m128i snap = _mm_set1_epi32(16);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(encodedMin), _mm_sub_epi32(_mm_and_si128(encodedMinV, snapMask), snap));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(encodedMax), _mm_or_si128(_mm_add_epi32(_mm_and_si128(encodedMaxV, snapMask), snap), _mm_set1_epi32(1<<2)));
+#else
+		for(PxU32 axis=0;axis<3;axis++)
+		{
+			encodedMin[axis] = encodeMin(bounds, axis, contactDistance);
+			encodedMax[axis] = encodeMax(bounds, axis, contactDistance);
+		}
+#endif
+	}
+
+	/**
+	\brief Encoded bounds of the broadphase boxes, stored per axis.
+
+	Each axis has its own array of (min, max) pairs, so that the passes over an axis only touch the values of that axis.
+	The contact distance is applied once, when the boxes are updated, instead of each time a value is read.
+	*/
+	class EncodedBounds : public Ps::UserAllocated
+	{
+		PX_NOCOPY(EncodedBounds)
+	public:
+										EncodedBounds();
+										~EncodedBounds();
+
+		// Grows the arrays, keeping the existing values
+						void			resize(PxU32 capacity);
+
+		// Encodes the boxes of the handles list
+						void			update(const PxBounds3* PX_RESTRICT bounds, const PxReal* PX_RESTRICT contactDistances, const BpHandle* PX_RESTRICT handles, PxU32 nbHandles);
+
+		PX_FORCE_INLINE	ValType			getMin(PxU32 axis, PxU32 index)	const	{ PX_ASSERT(index<mCapacity); return mValues[axis][index*2+0];	}
+		PX_FORCE_INLINE	ValType			getMax(PxU32 axis, PxU32 index)	const	{ PX_ASSERT(index<mCapacity); return mValues[axis][index*2+1];	}
+		PX_FORCE_INLINE	ValType			getExtent(PxU32 isMax, PxU32 axis, PxU32 index)	const	{ PX_ASSERT(isMax<=1); return mValues[axis][index*2+isMax];	}
+
+		PX_FORCE_INLINE	PxU32			getCapacity()	const	{ return mCapacity;	}
+
+	private:
+						ValType*		mValues[3];
+						PxU32			mCapacity;
+	};
+
+} //namespace Bp
+
+} //namespace physx
+
+#endif // BP_ENCODED_BOUNDS_H
@@ -44,7 +44,7 @@ namespace Bp
 	{
 	public:
 
-		SapUpdateWorkTask(PxU64 contextId) : Cm::Task(contextId)
+		SapUpdateWorkTask(PxU64 contextId) : Cm::Task(contextId), mSAP(NULL), mNumCpuTasks(0)
 		{
 		}
 
@@ -58,6 +58,11 @@ namespace Bp
 			mNumCpuTasks = numCpuTasks; 
 		}
 
+		PxU32 getNumCpuTasks() const
+		{
+			return mNumCpuTasks;
+		}
+
 		virtual void runInternal();
 
 		virtual const char* getName() const { return "BpSAP.updateWork"; }
@@ -35,7 +35,10 @@
 #include "PsFoundation.h"
 #include "PsHash.h"
 #include "PsSort.h"
+#include "PsParallelSort.h"
 #include "PsHashSet.h"
+#include "PsInlineArray.h"
+#include "PsTempAllocator.h"
 #include "PsVecMath.h"
 #include "GuInternal.h"
 //#include <stdio.h>
@@ -91,6 +94,7 @@ static const bool gUseBruteForce = false;
 //#define EXPERIMENT
 #define USE_MBP_PAIR_MANAGER
 #define STORE_SORTED_BOUNDS
+#define USE_AGGREGATE_TREE
 #if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
 	#define USE_SIMD_BOUNDS
 #endif
@@ -139,6 +143,21 @@ static void resetOrClear(T& a)
 	typedef float		InflatedType;
 #endif
 
+#ifdef USE_AGGREGATE_TREE
+	#define AGGREGATE_TREE_LEAF_SIZE		4
+	#define AGGREGATE_TREE_REFIT_LIMIT		64
+
+	// node of the per-aggregate tree. Nodes are stored in depth-first order, the first child of an internal node
+	// is the next node and mData is the second child. Leaves cover mNbBounds consecutive aggregated bounds starting at mData.
+	struct AggregateTreeNode
+	{
+		InflatedAABB	mBox;
+		PxU32			mData;
+		PxU16			mNbBounds;	// 0 for internal nodes
+		PxU16			mMoved;		// some bounds below this node moved since the previous update
+	};
+#endif
+
 	// PT: TODO: revisit/optimize all that stuff once it works
 	class Aggregate : public Ps::UserAllocated
 	{
@@ -158,8 +177,8 @@ static void resetOrClear(T& a)
 		PX_FORCE_INLINE	PxU32							getNbAggregated()		const	{ return mAggregated.size();					}
 		PX_FORCE_INLINE	BoundsIndex						getAggregated(PxU32 i)	const	{ return mAggregated[i];						}
 		PX_FORCE_INLINE	const BoundsIndex*				getIndices()			const	{ return mAggregated.begin();					}
-		PX_FORCE_INLINE	void							addAggregated(BoundsIndex i)	{ mAggregated.pushBack(i);						}
-		PX_FORCE_INLINE	bool							removeAggregated(BoundsIndex i)	{ return mAggregated.findAndReplaceWithLast(i);	}	// PT: TODO: optimize?
+		PX_FORCE_INLINE	void							addAggregated(BoundsIndex i)	{ mAggregated.pushBack(i);	mTreeDirty = true;		}
+		PX_FORCE_INLINE	bool							removeAggregated(BoundsIndex i)	{ mTreeDirty = true; return mAggregated.findAndReplaceWithLast(i);	}	// TODO: optimize?
 
 		PX_FORCE_INLINE	void							resetDirtyState()				{ mDirtyIndex = PX_INVALID_U32;				}
 		PX_FORCE_INLINE	bool							isDirty()				const	{ return mDirtyIndex != PX_INVALID_U32;		}
@@ -190,8 +209,34 @@ static void resetOrClear(T& a)
 														}
 #endif
 
+#ifdef USE_AGGREGATE_TREE
+		// builds or refits the tree after the bounds have been recomputed, and finds the bounds that moved
+		PX_FORCE_INLINE	void							updateTree()
+														{
+															if(mDirtySort)
+																refitTree();
+														}
+		PX_FORCE_INLINE	const AggregateTreeNode*		getTreeNodes()			const	{ return mTreeNodes.begin();				}
+		// all bounds are considered moved after the aggregated shapes changed
+		PX_FORCE_INLINE	bool							allMoved()				const	{ return mAllMoved;							}
+		PX_FORCE_INLINE	bool							isMovedBounds(PxU32 i)	const	{ return mMovedBounds[i]!=0;				}
+						bool							isMoved(BoundsIndex index)	const;
+#endif
+
 						PxBounds3						mBounds;
 		private:
+#ifdef USE_AGGREGATE_TREE
+						Ps::Array<AggregateTreeNode>	mTreeNodes;
+						Ps::Array<InflatedAABB>			mPreviousBounds;	// bounds used for the previous tree update
+						Ps::Array<PxU8>					mMovedBounds;		// per aggregated bounds, same order as mAggregated
+						Ps::Array<BoundsIndex>			mMovedIndices;		// sorted indices of the moved bounds
+						PxU32							mNbRefits;
+						bool							mAllMoved;
+
+						void							refitTree();
+						void							buildTree();
+#endif
+						bool							mTreeDirty;	// aggregated shapes added or removed since the last tree update
 #ifndef STORE_SORTED_BOUNDS
 						Cm::RadixSortBuffered			mRS;
 #endif
@@ -678,6 +723,46 @@ static PX_FORCE_INLINE InflatedType getMaxX(const InflatedAABB& box)
 #endif
 }
 
+#ifdef USE_AGGREGATE_TREE
+static PX_FORCE_INLINE void includeBounds(InflatedAABB& dst, const InflatedAABB& src)
+{
+#ifdef USE_SIMD_BOUNDS
+	dst.mMinX = PxMin(dst.mMinX, src.mMinX);
+	dst.mMinY = PxMin(dst.mMinY, src.mMinY);
+	dst.mMinZ = PxMin(dst.mMinZ, src.mMinZ);
+	dst.mMaxX = PxMax(dst.mMaxX, src.mMaxX);
+	dst.mMaxY = PxMax(dst.mMaxY, src.mMaxY);
+	dst.mMaxZ = PxMax(dst.mMaxZ, src.mMaxZ);
+#else
+	dst.include(src);
+#endif
+}
+
+static PX_FORCE_INLINE bool sameBounds(const InflatedAABB& a, const InflatedAABB& b)
+{
+#ifdef USE_SIMD_BOUNDS
+	return	a.mMinX==b.mMinX && a.mMinY==b.mMinY && a.mMinZ==b.mMinZ
+		&&	a.mMaxX==b.mMaxX && a.mMaxY==b.mMaxY && a.mMaxZ==b.mMaxZ;
+#else
+	return a.minimum==b.minimum && a.maximum==b.maximum;
+#endif
+}
+
+// twice the center of the box along the given axis, only used to sort the bounds when building the tree
+static PX_FORCE_INLINE double getCenter2(const InflatedAABB& box, PxU32 axis)
+{
+#ifdef USE_SIMD_BOUNDS
+	if(axis==0)
+		return double(box.mMinX) + double(box.mMaxX);
+	if(axis==1)
+		return double(box.mMinY) + double(box.mMaxY);
+	return double(box.mMinZ) + double(box.mMaxZ);
+#else
+	return double(box.minimum[axis]) + double(box.maximum[axis]);
+#endif
+}
+#endif
+
 static PX_FORCE_INLINE void testPair(PairArray& pairs, const InflatedAABB* bounds0, const InflatedAABB* bounds1, const Bp::FilterGroup::Enum* PX_RESTRICT groups,
 #ifdef BP_FILTERING_USES_TYPE_IN_GROUP
 	const bool* PX_RESTRICT lut,
@@ -693,6 +778,196 @@ static PX_FORCE_INLINE void testPair(PairArray& pairs, const InflatedAABB* bound
 			outputPair(pairs, aggIndex0, aggIndex1);
 }
 
+#ifdef USE_AGGREGATE_TREE
+#ifdef BP_FILTERING_USES_TYPE_IN_GROUP
+	#define AGGREGATE_TREE_LUT_PARAM	, const bool* PX_RESTRICT lut
+	#define AGGREGATE_TREE_LUT			, lut
+#else
+	#define AGGREGATE_TREE_LUT_PARAM
+	#define AGGREGATE_TREE_LUT
+#endif
+
+static PX_FORCE_INLINE void testTreePair(PairArray& pairs, const InflatedAABB& box0, const InflatedAABB& box1, BoundsIndex index0, BoundsIndex index1,
+										const Bp::FilterGroup::Enum* PX_RESTRICT groups AGGREGATE_TREE_LUT_PARAM)
+{
+	if(groupFiltering(groups[index0], groups[index1] AGGREGATE_TREE_LUT))
+		if(box0.intersects(box1))
+			outputPair(pairs, index0, index1);
+}
+
+// in incremental mode the pairs between bounds that didn't move are kept as they are (see keepUnmovedPairs), so the
+// subtrees and the leaf pairs without moved bounds are skipped.
+static void treeSelfOverlaps(PairArray& pairs, const Aggregate& aggregate, const Bp::FilterGroup::Enum* PX_RESTRICT groups AGGREGATE_TREE_LUT_PARAM, bool incremental)
+{
+	const AggregateTreeNode* PX_RESTRICT nodes = aggregate.getTreeNodes();
+	const InflatedAABB* PX_RESTRICT bounds = aggregate.mInflatedBounds;
+	const BoundsIndex* PX_RESTRICT indices = aggregate.getIndices();
+
+	Ps::InlineArray<Pair, 64> stack;
+	stack.pushBack(Pair(0, 0));
+	while(stack.size())
+	{
+		const Pair p = stack.popBack();
+		const AggregateTreeNode& node0 = nodes[p.mID0];
+		const AggregateTreeNode& node1 = nodes[p.mID1];
+		if(incremental && !node0.mMoved && !node1.mMoved)
+			continue;
+
+		if(p.mID0==p.mID1)
+		{
+			if(node0.mNbBounds)
+			{
+				const PxU32 last = node0.mData + node0.mNbBounds;
+				for(PxU32 i=node0.mData;i<last;i++)
+				{
+					const bool moved0 = aggregate.isMovedBounds(i);
+					for(PxU32 j=i+1;j<last;j++)
+					{
+						if(incremental && !moved0 && !aggregate.isMovedBounds(j))
+							continue;
+						testTreePair(pairs, bounds[i], bounds[j], indices[i], indices[j], groups AGGREGATE_TREE_LUT);
+					}
+				}
+			}
+			else
+			{
+				const PxU32 left = p.mID0 + 1;
+				const PxU32 right = node0.mData;
+				stack.pushBack(Pair(left, left));
+				stack.pushBack(Pair(right, right));
+				stack.pushBack(Pair(left, right));
+			}
+			continue;
+		}
+
+		if(!node0.mBox.intersects(node1.mBox))
+			continue;
+
+		if(node0.mNbBounds && node1.mNbBounds)
+		{
+			const PxU32 last0 = node0.mData + node0.mNbBounds;
+			const PxU32 last1 = node1.mData + node1.mNbBounds;
+			for(PxU32 i=node0.mData;i<last0;i++)
+			{
+				const bool moved0 = aggregate.isMovedBounds(i);
+				for(PxU32 j=node1.mData;j<last1;j++)
+				{
+					if(incremental && !moved0 && !aggregate.isMovedBounds(j))
+						continue;
+					testTreePair(pairs, bounds[i], bounds[j], indices[i], indices[j], groups AGGREGATE_TREE_LUT);
+				}
+			}
+		}
+		else if(!node0.mNbBounds)
+		{
+			stack.pushBack(Pair(p.mID0 + 1, p.mID1));
+			stack.pushBack(Pair(node0.mData, p.mID1));
+		}
+		else
+		{
+			stack.pushBack(Pair(p.mID0, p.mID1 + 1));
+			stack.pushBack(Pair(p.mID0, node1.mData));
+		}
+	}
+}
+
+static void treeTreeOverlaps(PairArray& pairs, const Aggregate& aggregate0, const Aggregate& aggregate1, const Bp::FilterGroup::Enum* PX_RESTRICT groups AGGREGATE_TREE_LUT_PARAM, bool incremental)
+{
+	const AggregateTreeNode* PX_RESTRICT nodes0 = aggregate0.getTreeNodes();
+	const AggregateTreeNode* PX_RESTRICT nodes1 = aggregate1.getTreeNodes();
+	const InflatedAABB* PX_RESTRICT bounds0 = aggregate0.mInflatedBounds;
+	const InflatedAABB* PX_RESTRICT bounds1 = aggregate1.mInflatedBounds;
+	const BoundsIndex* PX_RESTRICT indices0 = aggregate0.getIndices();
+	const BoundsIndex* PX_RESTRICT indices1 = aggregate1.getIndices();
+
+	Ps::InlineArray<Pair, 64> stack;
+	stack.pushBack(Pair(0, 0));
+	while(stack.size())
+	{
+		const Pair p = stack.popBack();
+		const AggregateTreeNode& node0 = nodes0[p.mID0];
+		const AggregateTreeNode& node1 = nodes1[p.mID1];
+		if(incremental && !node0.mMoved && !node1.mMoved)
+			continue;
+
+		if(!node0.mBox.intersects(node1.mBox))
+			continue;
+
+		if(node0.mNbBounds && node1.mNbBounds)
+		{
+			const PxU32 last0 = node0.mData + node0.mNbBounds;
+			const PxU32 last1 = node1.mData + node1.mNbBounds;
+			for(PxU32 i=node0.mData;i<last0;i++)
+			{
+				const bool moved0 = aggregate0.isMovedBounds(i);
+				for(PxU32 j=node1.mData;j<last1;j++)
+				{
+					if(incremental && !moved0 && !aggregate1.isMovedBounds(j))
+						continue;
+					testTreePair(pairs, bounds0[i], bounds1[j], indices0[i], indices1[j], groups AGGREGATE_TREE_LUT);
+				}
+			}
+		}
+		else if(!node0.mNbBounds)
+		{
+			stack.pushBack(Pair(p.mID0 + 1, p.mID1));
+			stack.pushBack(Pair(node0.mData, p.mID1));
+		}
+		else
+		{
+			stack.pushBack(Pair(p.mID0, p.mID1 + 1));
+			stack.pushBack(Pair(p.mID0, node1.mData));
+		}
+	}
+}
+
+static void boxTreeOverlaps(PairArray& pairs, const InflatedAABB& box, BoundsIndex boxIndex, const Aggregate& aggregate, const Bp::FilterGroup::Enum* PX_RESTRICT groups AGGREGATE_TREE_LUT_PARAM)
+{
+	const AggregateTreeNode* PX_RESTRICT nodes = aggregate.getTreeNodes();
+	const InflatedAABB* PX_RESTRICT bounds = aggregate.mInflatedBounds;
+	const BoundsIndex* PX_RESTRICT indices = aggregate.getIndices();
+
+	Ps::InlineArray<PxU32, 32> stack;
+	stack.pushBack(0);
+	while(stack.size())
+	{
+		const PxU32 nodeIndex = stack.popBack();
+		const AggregateTreeNode& node = nodes[nodeIndex];
+		if(!node.mBox.intersects(box))
+			continue;
+
+		if(node.mNbBounds)
+		{
+			const PxU32 last = node.mData + node.mNbBounds;
+			for(PxU32 i=node.mData;i<last;i++)
+				testTreePair(pairs, bounds[i], box, indices[i], boxIndex, groups AGGREGATE_TREE_LUT);
+		}
+		else
+		{
+			stack.pushBack(nodeIndex + 1);
+			stack.pushBack(node.mData);
+		}
+	}
+}
+
+#ifdef USE_MBP_PAIR_MANAGER
+// marks the pairs between two bounds that didn't move as updated, so that they survive the update without being tested again
+static void keepUnmovedPairs(MBP_PairManager& pairs, const Aggregate& aggregate0, const Aggregate& aggregate1)
+{
+	const PxU32 nbActivePairs = pairs.mNbActivePairs;
+	MBP_Pair* PX_RESTRICT activePairs = pairs.mActivePairs;
+	for(PxU32 i=0;i<nbActivePairs;i++)
+	{
+		MBP_Pair& p = activePairs[i];
+		const PxU32 id0 = p.getId0();
+		const PxU32 id1 = p.getId1();
+		if(!aggregate0.isMoved(id0) && !aggregate0.isMoved(id1) && !aggregate1.isMoved(id0) && !aggregate1.isMoved(id1))
+			p.setUpdated();
+	}
+}
+#endif
+#endif
+
 #ifdef REMOVED_FAILED_EXPERIMENT
 static PX_NOINLINE void processCandidates(PxU32 nbCandidates, const Pair* PX_RESTRICT candidates,
 										PairArray& pairs, const InflatedAABB* bounds0, const InflatedAABB* bounds1, const Bp::FilterGroup::Enum* PX_RESTRICT groups, const PxU32* aggIndices0, const PxU32* aggIndices1)
@@ -945,7 +1220,11 @@ void PersistentActorAggregatePair::findOverlaps(PairArray& pairs, const PxBounds
 		actorBounds[1].minimum.x = PX_MAX_F32;
 #endif
 
-#ifdef STORE_SORTED_BOUNDS
+#if defined(USE_AGGREGATE_TREE)
+		PX_UNUSED(inflatedBounds);
+		mAggregate->updateTree();
+		boxTreeOverlaps(pairs, actorBounds[0], actorHandle, *mAggregate, groups AGGREGATE_TREE_LUT);
+#elif defined(STORE_SORTED_BOUNDS)
 		const InflatedAABB* PX_RESTRICT bounds0 = actorBounds;
 		const InflatedAABB* PX_RESTRICT bounds1 = inflatedBounds;
 		mAggregate->getSortedMinBounds();
@@ -1047,13 +1326,15 @@ class PersistentAggregateAggregatePair : public PersistentPairs
 					ShapeHandle	mAggregateHandle1;
 					Aggregate*	mAggregate0;
 					Aggregate*	mAggregate1;
+					bool		mInitialized;	// pairs have been computed at least once
 };
 
 PersistentAggregateAggregatePair::PersistentAggregateAggregatePair(Aggregate* aggregate0, Aggregate* aggregate1) :
 	mAggregateHandle0	(aggregate0->mIndex),
 	mAggregateHandle1	(aggregate1->mIndex),
 	mAggregate0			(aggregate0),
-	mAggregate1			(aggregate1)
+	mAggregate1			(aggregate1),
+	mInitialized		(false)
 {
 }
 
@@ -1095,7 +1376,19 @@ void PersistentAggregateAggregatePair::findOverlaps(PairArray& pairs, const PxBo
 	}
 	else
 	{
-#ifdef STORE_SORTED_BOUNDS
+#if defined(USE_AGGREGATE_TREE)
+		mAggregate0->updateTree();
+		mAggregate1->updateTree();
+	#ifdef USE_MBP_PAIR_MANAGER
+		const bool incremental = mInitialized && !mAggregate0->allMoved() && !mAggregate1->allMoved();
+		if(incremental)
+			keepUnmovedPairs(pairs, *mAggregate0, *mAggregate1);
+	#else
+		const bool incremental = false;
+	#endif
+		mInitialized = true;
+		treeTreeOverlaps(pairs, *mAggregate0, *mAggregate1, groups AGGREGATE_TREE_LUT, incremental);
+#elif defined(STORE_SORTED_BOUNDS)
 		mAggregate0->getSortedMinBounds();
 		mAggregate1->getSortedMinBounds();
 		const InflatedAABB* PX_RESTRICT bounds0 = mAggregate0->mInflatedBounds;
@@ -1213,10 +1506,12 @@ class PersistentSelfCollisionPairs : public PersistentPairs
 		);
 
 			Aggregate*	mAggregate;
+			bool		mInitialized;	// pairs have been computed at least once
 };
 
 PersistentSelfCollisionPairs::PersistentSelfCollisionPairs(Aggregate* aggregate) :
-	mAggregate	(aggregate)
+	mAggregate		(aggregate),
+	mInitialized	(false)
 {
 }
 
@@ -1256,7 +1551,18 @@ void PersistentSelfCollisionPairs::findOverlaps(PairArray& pairs, const PxBounds
 	}
 	else
 	{
-#ifdef STORE_SORTED_BOUNDS
+#if defined(USE_AGGREGATE_TREE)
+		mAggregate->updateTree();
+	#ifdef USE_MBP_PAIR_MANAGER
+		const bool incremental = mInitialized && !mAggregate->allMoved();
+		if(incremental)
+			keepUnmovedPairs(pairs, *mAggregate, *mAggregate);
+	#else
+		const bool incremental = false;
+	#endif
+		mInitialized = true;
+		treeSelfOverlaps(pairs, *mAggregate, groups AGGREGATE_TREE_LUT, incremental);
+#elif defined(STORE_SORTED_BOUNDS)
 		mAggregate->getSortedMinBounds();
 		const InflatedAABB* PX_RESTRICT bounds = mAggregate->mInflatedBounds;
 
@@ -1323,6 +1629,11 @@ Aggregate::Aggregate(BoundsIndex index, bool selfCollisions) :
 	mIndex			(index),
 	mInflatedBounds	(NULL),
 	mAllocatedSize	(0),
+#ifdef USE_AGGREGATE_TREE
+	mNbRefits		(0),
+	mAllMoved		(true),
+#endif
+	mTreeDirty		(true),
 	mDirtySort		(false)
 {
 	resetDirtyState();
@@ -1423,6 +1734,194 @@ void Aggregate::sortBounds()
 	}*/
 }
 
+#ifdef USE_AGGREGATE_TREE
+bool Aggregate::isMoved(BoundsIndex index) const
+{
+	if(mAllMoved)
+		return true;
+
+	PxU32 first = 0;
+	PxU32 last = mMovedIndices.size();
+	while(first<last)
+	{
+		const PxU32 middle = (first + last)>>1;
+		const BoundsIndex movedIndex = mMovedIndices[middle];
+		if(movedIndex==index)
+			return true;
+		if(movedIndex<index)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return false;
+}
+
+namespace
+{
+	struct AggregateTreeBuildEntry
+	{
+		InflatedAABB	mBox;
+		BoundsIndex		mIndex;
+		PxU32			mMoved;
+	};
+
+	struct AggregateTreeAxisCompare
+	{
+		AggregateTreeAxisCompare(PxU32 axis) : mAxis(axis)	{}
+
+		PX_FORCE_INLINE bool operator()(const AggregateTreeBuildEntry& a, const AggregateTreeBuildEntry& b) const
+		{
+			return getCenter2(a.mBox, mAxis) < getCenter2(b.mBox, mAxis);
+		}
+
+		PxU32	mAxis;
+	};
+}
+
+// top-down build with a median split along the axis where the box centers are the most spread out
+static PxU32 buildAggregateTreeNode(Ps::Array<AggregateTreeNode>& nodes, AggregateTreeBuildEntry* entries, PxU32 start, PxU32 nb)
+{
+	const PxU32 nodeIndex = nodes.size();
+	nodes.insert();
+
+	InflatedAABB box = entries[start].mBox;
+	PxU32 moved = entries[start].mMoved;
+	double minCenter[3], maxCenter[3];
+	for(PxU32 axis=0;axis<3;axis++)
+		minCenter[axis] = maxCenter[axis] = getCenter2(box, axis);
+	for(PxU32 i=start+1;i<start+nb;i++)
+	{
+		includeBounds(box, entries[i].mBox);
+		moved |= entries[i].mMoved;
+		for(PxU32 axis=0;axis<3;axis++)
+		{
+			const double center = getCenter2(entries[i].mBox, axis);
+			minCenter[axis] = PxMin(minCenter[axis], center);
+			maxCenter[axis] = PxMax(maxCenter[axis], center);
+		}
+	}
+
+	if(nb<=AGGREGATE_TREE_LEAF_SIZE)
+	{
+		AggregateTreeNode& node = nodes[nodeIndex];
+		node.mBox = box;
+		node.mData = start;
+		node.mNbBounds = PxU16(nb);
+		node.mMoved = PxU16(moved ? 1 : 0);
+		return nodeIndex;
+	}
+
+	PxU32 splitAxis = 0;
+	for(PxU32 axis=1;axis<3;axis++)
+	{
+		if(maxCenter[axis] - minCenter[axis] > maxCenter[splitAxis] - minCenter[splitAxis])
+			splitAxis = axis;
+	}
+	Ps::sort(entries + start, nb, AggregateTreeAxisCompare(splitAxis));
+
+	const PxU32 nbLeft = nb>>1;
+	buildAggregateTreeNode(nodes, entries, start, nbLeft);
+	const PxU32 right = buildAggregateTreeNode(nodes, entries, start + nbLeft, nb - nbLeft);
+
+	// don't keep a reference across the recursive calls, the array can be resized
+	AggregateTreeNode& node = nodes[nodeIndex];
+	node.mBox = box;
+	node.mData = right;
+	node.mNbBounds = 0;
+	node.mMoved = PxU16(moved ? 1 : 0);
+	return nodeIndex;
+}
+
+// the bounds are reordered to match the leaves
+void Aggregate::buildTree()
+{
+	mNbRefits = 0;
+	const PxU32 nbObjects = getNbAggregated();
+
+	PX_ALLOCA(entries, AggregateTreeBuildEntry, nbObjects);
+	for(PxU32 i=0;i<nbObjects;i++)
+	{
+		entries[i].mBox = mInflatedBounds[i];
+		entries[i].mIndex = mAggregated[i];
+		entries[i].mMoved = mMovedBounds[i];
+	}
+
+	mTreeNodes.clear();
+	mTreeNodes.reserve(nbObjects*2);
+	buildAggregateTreeNode(mTreeNodes, entries, 0, nbObjects);
+
+	for(PxU32 i=0;i<nbObjects;i++)
+	{
+		mInflatedBounds[i] = entries[i].mBox;
+		mAggregated[i] = entries[i].mIndex;
+		mMovedBounds[i] = PxU8(entries[i].mMoved);
+	}
+}
+
+void Aggregate::refitTree()
+{
+	mDirtySort = false;
+	const PxU32 nbObjects = getNbAggregated();
+
+	mAllMoved = mTreeDirty || mPreviousBounds.size()!=nbObjects;
+	mMovedBounds.resizeUninitialized(nbObjects);
+	mMovedIndices.clear();
+	if(mAllMoved)
+	{
+		PxMemSet(mMovedBounds.begin(), 1, nbObjects);
+	}
+	else
+	{
+		for(PxU32 i=0;i<nbObjects;i++)
+		{
+			const bool moved = !sameBounds(mInflatedBounds[i], mPreviousBounds[i]);
+			mMovedBounds[i] = PxU8(moved);
+			if(moved)
+				mMovedIndices.pushBack(mAggregated[i]);
+		}
+		Ps::sort(mMovedIndices.begin(), mMovedIndices.size());
+	}
+
+	// the tree quality degrades with refits so it is rebuilt from time to time
+	if(mTreeDirty || mNbRefits++>=AGGREGATE_TREE_REFIT_LIMIT)
+	{
+		buildTree();
+	}
+	else
+	{
+		AggregateTreeNode* nodes = mTreeNodes.begin();
+		for(PxU32 i=mTreeNodes.size();i--;)
+		{
+			AggregateTreeNode& node = nodes[i];
+			if(node.mNbBounds)
+			{
+				const PxU32 first = node.mData;
+				node.mBox = mInflatedBounds[first];
+				PxU32 moved = mMovedBounds[first];
+				for(PxU32 j=1;j<node.mNbBounds;j++)
+				{
+					includeBounds(node.mBox, mInflatedBounds[first+j]);
+					moved |= mMovedBounds[first+j];
+				}
+				node.mMoved = PxU16(moved ? 1 : 0);
+			}
+			else
+			{
+				const AggregateTreeNode& left = nodes[i+1];
+				const AggregateTreeNode& right = nodes[node.mData];
+				node.mBox = left.mBox;
+				includeBounds(node.mBox, right.mBox);
+				node.mMoved = PxU16((left.mMoved | right.mMoved) ? 1 : 0);
+			}
+		}
+	}
+
+	mPreviousBounds.resizeUninitialized(nbObjects);
+	PxMemCopy(mPreviousBounds.begin(), mInflatedBounds, sizeof(InflatedAABB)*nbObjects);
+	mTreeDirty = false;
+}
+#endif
+
 #if PX_INTEL_FAMILY && !defined(PX_SIMD_DISABLED)
 	#define SSE_CONST4(name, val) static const PX_ALIGN(16, PxU32 name[4]) = { (val), (val), (val), (val) } 
 	#define SSE_CONST(name) *(const __m128i *)&name
@@ -1603,9 +2102,11 @@ SimpleAABBManager::SimpleAABBManager(	BroadPhase& bp, BoundsArray& boundsArray,
 	//mDestroyedOverlaps			{ Ps::Array<Bp::AABBOverlap>(PX_DEBUG_EXP("SimpleAABBManager::mDestroyedOverlaps")) },
 	mScratchAllocator			(NULL),
 	mNarrowPhaseUnblockTask		(NULL),
+	mPostBroadPhaseDispatcher	(NULL),
 	mUsedSize					(0),
 	mOriginShifted				(false),
 	mPersistentStateChanged		(true),
+	mSortedOverlaps				(false),
 	mNbAggregates				(0),
 	mFirstFreeAggregate			(PX_INVALID_U32),
 	mTimestamp					(0),
@@ -2570,7 +3071,8 @@ static void processAggregatePairs(AggPairMap& map, SimpleAABBManager& manager)
 	// PT: TODO: in fact we could handle all the "lost pairs" stuff right there with extra aabb-abb tests
 
 	// PT: TODO: replace with decent hash map - or remove the hashmap entirely and use a linear array
-	Ps::Array<AggPair> removedEntries;
+	// only a few pairs are removed each frame, keep them on the stack
+	Ps::InlineArray<AggPair, 32, Ps::TempAllocator> removedEntries;
 	for(AggPairMap::Iterator iter = map.getIterator(); !iter.done(); ++iter)
 	{
 		PersistentPairs* p = iter->second;
@@ -2711,7 +3213,11 @@ public:
 		{
 			Aggregate* aggregate = mAggregates[i];
 
+#ifdef USE_AGGREGATE_TREE
+			aggregate->updateTree();
+#else
 			aggregate->getSortedMinBounds();
+#endif
 		}
 	}
 
@@ -2800,6 +3306,22 @@ static void processAggregatePairsParallel(AggPairMap& map, SimpleAABBManager& ma
 	}
 }
 
+// the overlaps still hold volume indices at this point. A pair only appears once per array, so the order is unique.
+struct OverlapVolumeLess
+{
+	static PX_FORCE_INLINE PxU64 getKey(const AABBOverlap& overlap)
+	{
+		const PxU32 id0 = PxU32(size_t(overlap.mUserData0));
+		const PxU32 id1 = PxU32(size_t(overlap.mUserData1));
+		return id0 < id1 ? (PxU64(id0)<<32)|id1 : (PxU64(id1)<<32)|id0;
+	}
+
+	PX_FORCE_INLINE bool operator()(const AABBOverlap& a, const AABBOverlap& b) const
+	{
+		return getKey(a) < getKey(b);
+	}
+};
+
 void SimpleAABBManager::postBroadPhase(PxBaseTask* continuation, PxBaseTask* narrowPhaseUnlockTask, Cm::FlushPool& flushPool)
 {
 	PX_PROFILE_ZONE("SimpleAABBManager::postBroadPhase", getContextId());
@@ -2811,6 +3333,7 @@ void SimpleAABBManager::postBroadPhase(PxBaseTask* continuation, PxBaseTask* nar
 		mPostBroadPhase3.setContinuation(continuation);
 		mPostBroadPhase2.setContinuation(&mPostBroadPhase3);
 	}
+	mPostBroadPhaseDispatcher = continuation ? continuation->getTaskManager()->getCpuDispatcher() : NULL;
 
 	mTimestamp++;
 
@@ -2994,6 +3517,17 @@ void SimpleAABBManager::postBpStage3(PxBaseTask*)
 		
 		for (PxU32 idx = 0; idx < VolumeBuckets::eCOUNT; ++idx)
 		{
+			// The pairs come out of the parallel SAP axes and aggregate tasks in an order that depends on the scheduling
+			if (mSortedOverlaps)
+			{
+				PX_PROFILE_ZONE("SimpleAABBManager::postBroadPhase - sort overlaps", getContextId());
+				// Large pair lists are sorted on the workers, stable so that the order doesn't depend on the thread count
+				if (mCreatedOverlaps[idx].size() > 1)
+					Ps::parallelSort(mCreatedOverlaps[idx].begin(), mCreatedOverlaps[idx].size(), OverlapVolumeLess(), mPostBroadPhaseDispatcher, true);
+				if (mDestroyedOverlaps[idx].size() > 1)
+					Ps::parallelSort(mDestroyedOverlaps[idx].begin(), mDestroyedOverlaps[idx].size(), OverlapVolumeLess(), mPostBroadPhaseDispatcher, true);
+			}
+
 			const PxU32 nbDestroyedOverlaps = mDestroyedOverlaps[idx].size();
 			{
 				const PxU32 size = mCreatedOverlaps[idx].size();
@@ -70,6 +70,21 @@ struct MappedRange : public Range<T>
 	void (Cloth::*mUnlock)() const;
 };
 
+// level of detail of a cloth instance, see Cloth::setLodConfig()
+struct LodConfig
+{
+	LodConfig()
+	: mSolverFrequencyScale(1.0f), mPhaseMask(~0u), mPhaseTypes(~0u), mSelfCollision(true), mUpdateInterval(1)
+	{
+	}
+
+	float mSolverFrequencyScale; // scales the solver frequency
+	uint32_t mPhaseMask;         // bit i enables the phase config of phase i, phases past 31 are always solved
+	uint32_t mPhaseTypes;        // not used by the solver, phase types the mask was built from
+	bool mSelfCollision;         // false skips self-collision
+	uint32_t mUpdateInterval;    // solve every nth frame, particles are extrapolated in between
+};
+
 struct GpuParticles
 {
 	PxVec4* mCurrent;
@@ -275,6 +290,10 @@ class Cloth
 	virtual void setSelfCollisionIndices(Range<const uint32_t>) = 0;
 	virtual uint32_t getNumSelfCollisionIndices() const = 0;
 
+	// collide every nth solver iteration (CPU solver only)
+	virtual void setSelfCollisionInterval(uint32_t) = 0;
+	virtual uint32_t getSelfCollisionInterval() const = 0;
+
 	/* rest positions */
 
 	// set rest particle positions used during self-collision
@@ -303,6 +322,11 @@ class Cloth
 	virtual void putToSleep() = 0;
 	virtual void wakeUp() = 0;
 
+	/* level of detail (phase mask, self-collision and update interval are CPU solver only) */
+
+	virtual void setLodConfig(const LodConfig&) = 0;
+	virtual const LodConfig& getLodConfig() const = 0;
+
 	virtual void setUserData(void*) = 0;
 	virtual void* getUserData() const = 0;
 };
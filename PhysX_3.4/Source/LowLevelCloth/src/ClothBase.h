@@ -81,11 +81,13 @@ void initialize(Cloth& cloth, const PxVec4* pIt, const PxVec4* pEnd)
 	cloth.mFriction = 0.0f;
 	cloth.mSelfCollisionDistance = 0.0f;
 	cloth.mSelfCollisionLogStiffness = PxReal(-FLT_MAX_EXP);
+	cloth.mSelfCollisionInterval = 1;
 	cloth.mSleepTestInterval = uint32_t(-1);
 	cloth.mSleepAfterCount = uint32_t(-1);
 	cloth.mSleepThreshold = 0.0f;
 	cloth.mSleepPassCounter = 0;
 	cloth.mSleepTestCounter = 0;
+	cloth.mLod = LodConfig();
 }
 
 template <typename DstCloth, typename SrcCloth>
@@ -121,11 +123,13 @@ void copy(DstCloth& dstCloth, const SrcCloth& srcCloth)
 	dstCloth.mFriction = srcCloth.mFriction;
 	dstCloth.mSelfCollisionDistance = srcCloth.mSelfCollisionDistance;
 	dstCloth.mSelfCollisionLogStiffness = srcCloth.mSelfCollisionLogStiffness;
+	dstCloth.mSelfCollisionInterval = srcCloth.mSelfCollisionInterval;
 	dstCloth.mSleepTestInterval = srcCloth.mSleepTestInterval;
 	dstCloth.mSleepAfterCount = srcCloth.mSleepAfterCount;
 	dstCloth.mSleepThreshold = srcCloth.mSleepThreshold;
 	dstCloth.mSleepPassCounter = srcCloth.mSleepPassCounter;
 	dstCloth.mSleepTestCounter = srcCloth.mSleepTestCounter;
+	dstCloth.mLod = srcCloth.mLod;
 	dstCloth.mUserData = srcCloth.mUserData;
 }
 
@@ -175,6 +175,9 @@ class ClothImpl : public UserAllocated, public Cloth
 	virtual void setSelfCollisionIndices(Range<const uint32_t>);
 	virtual uint32_t getNumSelfCollisionIndices() const;
 
+	virtual void setSelfCollisionInterval(uint32_t);
+	virtual uint32_t getSelfCollisionInterval() const;
+
 	virtual void setRestPositions(Range<const PxVec4>);
 	virtual uint32_t getNumRestPositions() const;
 
@@ -192,6 +195,9 @@ class ClothImpl : public UserAllocated, public Cloth
 	virtual void putToSleep();
 	virtual void wakeUp();
 
+	virtual void setLodConfig(const LodConfig&);
+	virtual const LodConfig& getLodConfig() const;
+
 	virtual void setUserData(void*);
 	virtual void* getUserData() const;
 
@@ -1192,6 +1198,24 @@ inline float ClothImpl<T>::getSelfCollisionStiffness() const
 	return 1 - safeExp2(mCloth.mSelfCollisionLogStiffness);
 }
 
+template <typename T>
+inline void ClothImpl<T>::setSelfCollisionInterval(uint32_t interval)
+{
+	interval = PxMax(interval, 1u);
+	if(interval == mCloth.mSelfCollisionInterval)
+		return;
+
+	mCloth.mSelfCollisionInterval = interval;
+	mCloth.notifyChanged();
+	mCloth.wakeUp();
+}
+
+template <typename T>
+inline uint32_t ClothImpl<T>::getSelfCollisionInterval() const
+{
+	return mCloth.mSelfCollisionInterval;
+}
+
 template <typename T>
 inline const PxVec3& ClothImpl<T>::getBoundingBoxCenter() const
 {
@@ -1279,6 +1303,22 @@ inline void ClothImpl<T>::wakeUp()
 	mCloth.wakeUp();
 }
 
+template <typename T>
+inline void ClothImpl<T>::setLodConfig(const LodConfig& config)
+{
+	mCloth.mLod = config;
+	mCloth.mLod.mSolverFrequencyScale = PxMax(config.mSolverFrequencyScale, 0.0f);
+	mCloth.mLod.mUpdateInterval = PxMax(config.mUpdateInterval, 1u);
+	mCloth.notifyChanged();
+	mCloth.wakeUp();
+}
+
+template <typename T>
+inline const LodConfig& ClothImpl<T>::getLodConfig() const
+{
+	return mCloth.mLod;
+}
+
 template <typename T>
 inline void ClothImpl<T>::setUserData(void* data)
 {
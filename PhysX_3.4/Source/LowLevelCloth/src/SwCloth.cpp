@@ -46,7 +46,7 @@ using namespace physx;
 using namespace shdfnd;
 
 cloth::SwCloth::SwCloth(SwFactory& factory, SwFabric& fabric, Range<const PxVec4> particles)
-: mFactory(factory), mFabric(fabric), mNumVirtualParticles(0), mUserData(0)
+: mFactory(factory), mFabric(fabric), mNumVirtualParticles(0), mSelfCollisionCounter(0), mUserData(0)
 {
 	PX_ASSERT(!particles.empty());
 
@@ -102,6 +102,7 @@ cloth::SwCloth::SwCloth(SwFactory& factory, const SwCloth& cloth)
 , mVirtualParticleWeights(cloth.mVirtualParticleWeights)
 , mNumVirtualParticles(cloth.mNumVirtualParticles)
 , mSelfCollisionIndices(cloth.mSelfCollisionIndices)
+, mSelfCollisionCounter(0)
 , mRestPositions(cloth.mRestPositions)
 {
 	copy(*this, cloth);
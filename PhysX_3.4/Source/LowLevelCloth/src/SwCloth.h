@@ -182,6 +182,10 @@ class SwCloth
 	float mSelfCollisionLogStiffness;
 
 	Vector<uint32_t>::Type mSelfCollisionIndices;
+	uint32_t mSelfCollisionInterval; // collide every nth iteration
+	uint32_t mSelfCollisionCounter;  // iterations since last collided
+
+	Vector<uint16_t>::Type mSelfCollisionOrder; // grid sort order of the last pass
 
 	Vec4fAlignedVector mRestPositions;
 
@@ -192,6 +196,8 @@ class SwCloth
 	uint32_t mSleepPassCounter;  // how many tests passed
 	uint32_t mSleepTestCounter;  // how many iterations since tested
 
+	LodConfig mLod;
+
 	void* mUserData;
 
 } PX_ALIGN_SUFFIX(16);
@@ -55,6 +55,7 @@ cloth::SwClothData::SwClothData(SwCloth& cloth, const SwFabric& fabric)
 
 	mConfigBegin = cloth.mPhaseConfigs.empty() ? 0 : &cloth.mPhaseConfigs.front();
 	mConfigEnd = mConfigBegin + cloth.mPhaseConfigs.size();
+	mPhaseMask = cloth.mLod.mPhaseMask;
 
 	mPhases = &fabric.mPhases.front();
 	mNumPhases = uint32_t(fabric.mPhases.size());
@@ -122,12 +123,28 @@ cloth::SwClothData::SwClothData(SwCloth& cloth, const SwFabric& fabric)
 	mCollisionMassScale = cloth.mCollisionMassScale;
 	mFrictionScale = cloth.mFriction;
 
-	mSelfCollisionDistance = cloth.mSelfCollisionDistance;
+	mSelfCollisionDistance = cloth.mLod.mSelfCollision ? cloth.mSelfCollisionDistance : 0.0f;
 	mSelfCollisionStiffness = 1.0f - Ps::exp(stiffnessExponent * cloth.mSelfCollisionLogStiffness);
 
 	mSelfCollisionIndices = cloth.mSelfCollisionIndices.empty() ? 0 : cloth.mSelfCollisionIndices.begin();
 	mNumSelfCollisionIndices = mSelfCollisionIndices ? cloth.mSelfCollisionIndices.size() : mNumParticles;
 
+	// restart from the identity when the set of indices changes size
+	mSelfCollisionOrder = 0;
+	if(PxMin(mSelfCollisionDistance, mSelfCollisionStiffness) > 0.0f)
+	{
+		if(cloth.mSelfCollisionOrder.size() != mNumSelfCollisionIndices)
+		{
+			cloth.mSelfCollisionOrder.resize(mNumSelfCollisionIndices);
+			for(uint32_t i = 0; i < mNumSelfCollisionIndices; ++i)
+				cloth.mSelfCollisionOrder[i] = uint16_t(i);
+		}
+		mSelfCollisionOrder = cloth.mSelfCollisionOrder.begin();
+	}
+
+	mSelfCollisionInterval = cloth.mSelfCollisionInterval;
+	mSelfCollisionCounter = cloth.mSelfCollisionCounter;
+
 	mRestPositions = cloth.mRestPositions.size() ? array(cloth.mRestPositions.front()) : 0;
 
 	mSleepPassCounter = cloth.mSleepPassCounter;
@@ -139,6 +156,7 @@ void cloth::SwClothData::reconcile(SwCloth& cloth) const
 	cloth.setParticleBounds(mCurBounds);
 	cloth.mSleepTestCounter = mSleepTestCounter;
 	cloth.mSleepPassCounter = mSleepPassCounter;
+	cloth.mSelfCollisionCounter = mSelfCollisionCounter;
 }
 
 void cloth::SwClothData::verify() const
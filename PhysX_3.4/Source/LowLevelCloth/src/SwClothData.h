@@ -69,6 +69,7 @@ struct SwClothData
 	// distance constraints
 	const PhaseConfig* mConfigBegin;
 	const PhaseConfig* mConfigEnd;
+	uint32_t mPhaseMask; // see LodConfig
 
 	const uint32_t* mPhases;
 	uint32_t mNumPhases;
@@ -140,6 +141,10 @@ struct SwClothData
 	uint32_t mNumSelfCollisionIndices;
 	const uint32_t* mSelfCollisionIndices;
 
+	uint16_t* mSelfCollisionOrder; // sort order of the last pass, persists across frames
+	uint32_t mSelfCollisionInterval;
+	uint32_t mSelfCollisionCounter;
+
 	float* mRestPositions;
 
 	// sleep data
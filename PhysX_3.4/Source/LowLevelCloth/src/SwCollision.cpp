@@ -36,6 +36,8 @@
 #include "BoundingBox.h"
 #include "PointInterpolator.h"
 #include "SwCollisionHelpers.h"
+#include "SwParallelFor.h"
+#include "PsAtomic.h"
 #include <cstring> // for memset
 
 using namespace physx;
@@ -246,8 +248,8 @@ cloth::SwCollision<Simd4f>::CollisionData::CollisionData()
 }
 
 template <typename Simd4f>
-cloth::SwCollision<Simd4f>::SwCollision(SwClothData& clothData, SwKernelAllocator& alloc)
-: mClothData(clothData), mAllocator(alloc)
+cloth::SwCollision<Simd4f>::SwCollision(SwClothData& clothData, SwKernelAllocator& alloc, SwParallelFor* parallelFor)
+: mClothData(clothData), mAllocator(alloc), mParallelFor(parallelFor)
 {
 	allocate(mCurData);
 
@@ -1198,8 +1200,41 @@ PX_INLINE void calculateFrictionImpulse(const Simd4f& deltaX, const Simd4f& delt
 
 } // anonymous namespace
 
+namespace
+{
+template <typename Simd4f>
+struct CollideParticlesRange
+{
+	cloth::SwCollision<Simd4f>& mCollision;
+
+	CollideParticlesRange(cloth::SwCollision<Simd4f>& collision) : mCollision(collision)
+	{
+	}
+	void operator()(uint32_t begin, uint32_t end)
+	{
+		mCollision.collideParticles(begin, end);
+	}
+
+  private:
+	CollideParticlesRange& operator=(const CollideParticlesRange&);
+};
+}
+
 template <typename Simd4f>
 void cloth::SwCollision<Simd4f>::collideParticles()
+{
+	// particles are independent, chunks are a multiple of the 4 particles processed at once
+	if(mParallelFor)
+	{
+		CollideParticlesRange<Simd4f> range(*this);
+		mParallelFor->run(range, mClothData.mNumParticles, 1024);
+	}
+	else
+		collideParticles(0, mClothData.mNumParticles);
+}
+
+template <typename Simd4f>
+void cloth::SwCollision<Simd4f>::collideParticles(uint32_t begin, uint32_t end)
 {
 	const bool massScalingEnabled = mClothData.mCollisionMassScale > 0.0f;
 	const Simd4f massScale = simd4f(mClothData.mCollisionMassScale);
@@ -1210,9 +1245,12 @@ void cloth::SwCollision<Simd4f>::collideParticles()
 	Simd4f curPos[4];
 	Simd4f prevPos[4];
 
-	float* __restrict prevIt = mClothData.mPrevParticles;
-	float* __restrict pIt = mClothData.mCurParticles;
-	float* __restrict pEnd = pIt + mClothData.mNumParticles * 4;
+	uint32_t numCollisions = 0;
+	PX_UNUSED(numCollisions);
+
+	float* __restrict prevIt = mClothData.mPrevParticles + begin * 4;
+	float* __restrict pIt = mClothData.mCurParticles + begin * 4;
+	float* __restrict pEnd = mClothData.mCurParticles + end * 4;
 	for(; pIt < pEnd; pIt += 16, prevIt += 16)
 	{
 		curPos[0] = loadAligned(pIt, 0);
@@ -1277,9 +1315,13 @@ void cloth::SwCollision<Simd4f>::collideParticles()
 		storeAligned(pIt, 48, curPos[3]);
 
 #if PX_PROFILE || PX_DEBUG
-		mNumCollisions += horizontalSum(accum.mNumCollisions);
+		numCollisions += horizontalSum(accum.mNumCollisions);
 #endif
 	}
+
+#if PX_PROFILE || PX_DEBUG
+	shdfnd::atomicAdd(reinterpret_cast<volatile int32_t*>(&mNumCollisions), int32_t(numCollisions));
+#endif
 }
 
 template <typename Simd4f>
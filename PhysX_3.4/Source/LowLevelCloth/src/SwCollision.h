@@ -46,6 +46,7 @@ struct IndexPair;
 struct SphereData;
 struct ConeData;
 struct TriangleData;
+class SwParallelFor;
 
 typedef StackAllocator<16> SwKernelAllocator;
 
@@ -77,11 +78,14 @@ class SwCollision
 	struct ImpulseAccumulator;
 
   public:
-	SwCollision(SwClothData& clothData, SwKernelAllocator& alloc);
+	SwCollision(SwClothData& clothData, SwKernelAllocator& alloc, SwParallelFor* parallelFor = NULL);
 	~SwCollision();
 
 	void operator()(const IterationState<Simd4f>& state);
 
+	// discrete collision of the particles [begin, end), begin must be a multiple of 4
+	void collideParticles(uint32_t begin, uint32_t end);
+
 	static size_t estimateTemporaryMemory(const SwCloth& cloth);
 	static size_t estimatePersistentMemory(const SwCloth& cloth);
 
@@ -129,6 +133,7 @@ class SwCollision
 
 	SwClothData& mClothData;
 	SwKernelAllocator& mAllocator;
+	SwParallelFor* mParallelFor; // splits the particle loop of large cloths, may be NULL
 
 	uint32_t mNumCollisions;
 
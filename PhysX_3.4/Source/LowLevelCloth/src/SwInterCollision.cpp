@@ -605,6 +605,37 @@ void cloth::SwInterCollision<Simd4f>::collideParticle(uint32_t index)
 #endif
 }
 
+template <typename Simd4f>
+void cloth::SwInterCollision<Simd4f>::collideCandidates(const uint32_t* jIt, const uint32_t* jEnd)
+{
+	// test 4 candidates at once, most of them are out of reach. mParticle only moves on
+	// a collision, so the group is rerun serially if any one is close enough
+	for(; jEnd - jIt >= 4; jIt += 4)
+	{
+		Simd4f dx = getParticle(jIt[0]) - mParticle;
+		Simd4f dy = getParticle(jIt[1]) - mParticle;
+		Simd4f dz = getParticle(jIt[2]) - mParticle;
+		Simd4f dw = getParticle(jIt[3]) - mParticle;
+
+		transpose(dx, dy, dz, dw);
+		Simd4f distSqr = dx * dx + dy * dy + dz * dz;
+
+		if(allGreater(distSqr, mCollisionSquareDistance))
+		{
+#if PX_DEBUG
+			mNumTests += 4;
+#endif
+			continue;
+		}
+
+		for(uint32_t k = 0; k < 4; ++k)
+			collideParticle(jIt[k]);
+	}
+
+	for(; jIt != jEnd; ++jIt)
+		collideParticle(*jIt);
+}
+
 template <typename Simd4f>
 void cloth::SwInterCollision<Simd4f>::collideParticles(const uint32_t* keys, uint32_t firstColumnSize,
                                                        const uint32_t* indices, uint32_t numParticles,
@@ -649,7 +680,6 @@ void cloth::SwInterCollision<Simd4f>::collideParticles(const uint32_t* keys, uin
 	const uint32_t* __restrict iIt = indices;
 	const uint32_t* __restrict iEnd = indices + numParticles;
 
-	const uint32_t* __restrict jIt;
 	const uint32_t* __restrict jEnd;
 
 	for(; iIt != iEnd; ++iIt, ++kFirst[0])
@@ -679,8 +709,7 @@ void cloth::SwInterCollision<Simd4f>::collideParticles(const uint32_t* keys, uin
 
 		// process potential colliders of same cell
 		jEnd = indices + (kLast[0] - keys);
-		for(jIt = iIt + 1; jIt != jEnd; ++jIt)
-			collideParticle(*jIt);
+		collideCandidates(iIt + 1, jEnd);
 
 		// process neighbor cells
 		for(uint32_t k = 1; k < 5; ++k)
@@ -695,8 +724,7 @@ void cloth::SwInterCollision<Simd4f>::collideParticles(const uint32_t* keys, uin
 
 			// process potential colliders
 			jEnd = indices + (kLast[k] - keys);
-			for(jIt = indices + (kFirst[k] - keys); jIt != jEnd; ++jIt)
-				collideParticle(*jIt);
+			collideCandidates(indices + (kFirst[k] - keys), jEnd);
 		}
 
 		// write back particle and impulse
@@ -106,6 +106,7 @@ class SwInterCollision
 
 	// better wrap these in a struct
 	void collideParticle(uint32_t index);
+	void collideCandidates(const uint32_t* jIt, const uint32_t* jEnd);
 
 	Simd4f mParticle;
 	Simd4f mImpulse;
@@ -0,0 +1,145 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#include "SwParallelFor.h"
+#include "PsAtomic.h"
+#include "PsThread.h"
+#include "foundation/PxMath.h"
+#include "task/PxCpuDispatcher.h"
+
+using namespace physx;
+
+void cloth::SwParallelFor::HelperTask::runInternal()
+{
+	mOwner->help();
+}
+
+const char* cloth::SwParallelFor::HelperTask::getName() const
+{
+	return "cloth.SwSolver.parallelFor";
+}
+
+void cloth::SwParallelFor::HelperTask::release()
+{
+	// the owner may submit this task again as soon as the flag is cleared
+	PxBaseTask* continuation = mCont;
+	shdfnd::atomicExchange(&mInFlight, 0);
+	continuation->removeReference();
+}
+
+cloth::SwParallelFor::SwParallelFor()
+: mNumHelpers(0)
+, mTaskManager(NULL)
+, mContinuation(NULL)
+, mFunction(NULL)
+, mContext(NULL)
+, mCount(0)
+, mChunkSize(0)
+, mNumChunks(0)
+, mOpen(0)
+, mNumActive(0)
+, mNextChunk(0)
+, mNumDone(0)
+{
+	for(uint32_t i = 0; i < sMaxNumHelpers; ++i)
+		mHelpers[i].mOwner = this;
+}
+
+void cloth::SwParallelFor::setup(PxTaskManager* taskManager, PxBaseTask* continuation)
+{
+	mTaskManager = taskManager;
+	mContinuation = continuation;
+
+	// the calling thread is one of the workers
+	const uint32_t numWorkers = taskManager ? taskManager->getCpuDispatcher()->getWorkerCount() : 0;
+	mNumHelpers = PxMin(numWorkers > 0 ? numWorkers - 1 : 0, sMaxNumHelpers);
+}
+
+void cloth::SwParallelFor::run(Function function, void* context, uint32_t count, uint32_t chunkSize)
+{
+	const uint32_t numChunks = (count + chunkSize - 1) / chunkSize;
+	if(numChunks < 2 || !mNumHelpers)
+	{
+		function(context, 0, count);
+		return;
+	}
+
+	mFunction = function;
+	mContext = context;
+	mCount = count;
+	mChunkSize = chunkSize;
+	mNumChunks = int32_t(numChunks);
+	mNextChunk = 0;
+	mNumDone = 0;
+	shdfnd::atomicExchange(&mOpen, 1);
+
+	// helpers still in flight from a previous loop pick this one up if they get there in time
+	const uint32_t numHelpers = PxMin(mNumHelpers, numChunks - 1);
+	for(uint32_t i = 0; i < numHelpers; ++i)
+	{
+		HelperTask& helper = mHelpers[i];
+		if(shdfnd::atomicCompareExchange(&helper.mInFlight, 1, 0) == 0)
+		{
+			helper.setContinuation(*mTaskManager, mContinuation);
+			helper.removeReference();
+		}
+	}
+
+	processChunks();
+
+	while(mNumDone != mNumChunks)
+		shdfnd::Thread::yield();
+
+	// no helper may still look at the loop once its fields are reused
+	shdfnd::atomicExchange(&mOpen, 0);
+	while(mNumActive)
+		shdfnd::Thread::yield();
+}
+
+void cloth::SwParallelFor::help()
+{
+	shdfnd::atomicIncrement(&mNumActive);
+	if(mOpen)
+		processChunks();
+	shdfnd::atomicDecrement(&mNumActive);
+}
+
+void cloth::SwParallelFor::processChunks()
+{
+	for(;;)
+	{
+		const int32_t chunk = shdfnd::atomicIncrement(&mNextChunk) - 1;
+		if(chunk >= mNumChunks)
+			return;
+
+		const uint32_t begin = uint32_t(chunk) * mChunkSize;
+		mFunction(mContext, begin, PxMin(begin + mChunkSize, mCount));
+		shdfnd::atomicIncrement(&mNumDone);
+	}
+}
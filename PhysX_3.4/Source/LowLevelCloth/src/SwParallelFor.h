@@ -0,0 +1,109 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#pragma once
+
+#include "Allocator.h"
+#include "CmTask.h"
+
+namespace physx
+{
+namespace cloth
+{
+
+/**
+   Splits the loops of one cloth kernel across the worker threads.
+   The calling thread takes part in every loop, and only waits for the chunks
+   the helpers already started, so a loop completes even if no helper runs.
+ */
+class SwParallelFor : public UserAllocated
+{
+	struct HelperTask : public Cm::Task
+	{
+		HelperTask() : Cm::Task(0), mOwner(NULL), mInFlight(0)
+		{
+		}
+
+		virtual void runInternal();
+		virtual const char* getName() const;
+		virtual void release();
+
+		SwParallelFor* mOwner;
+		volatile int32_t mInFlight;
+	};
+
+  public:
+	typedef void (*Function)(void* context, uint32_t begin, uint32_t end);
+
+	static const uint32_t sMaxNumHelpers = 7;
+
+	SwParallelFor();
+
+	// helpers hold a reference to continuation until they exit, so it can't run before they do
+	void setup(physx::PxTaskManager* taskManager, physx::PxBaseTask* continuation);
+
+	// calls function on the chunks of [0, count), chunkSize must be a multiple of the SIMD width
+	void run(Function function, void* context, uint32_t count, uint32_t chunkSize);
+
+	template <typename Body>
+	void run(Body& body, uint32_t count, uint32_t chunkSize)
+	{
+		run(&invoke<Body>, &body, count, chunkSize);
+	}
+
+  private:
+	template <typename Body>
+	static void invoke(void* context, uint32_t begin, uint32_t end)
+	{
+		(*static_cast<Body*>(context))(begin, end);
+	}
+
+	void help();
+	void processChunks();
+
+	HelperTask mHelpers[sMaxNumHelpers];
+	uint32_t mNumHelpers;
+	physx::PxTaskManager* mTaskManager;
+	physx::PxBaseTask* mContinuation;
+
+	// current loop, only written while no helper is inside it
+	Function mFunction;
+	void* mContext;
+	uint32_t mCount;
+	uint32_t mChunkSize;
+	int32_t mNumChunks;
+
+	volatile int32_t mOpen;
+	volatile int32_t mNumActive;
+	volatile int32_t mNextChunk;
+	volatile int32_t mNumDone;
+};
+
+} // namespace cloth
+} // namespace physx
@@ -113,6 +113,46 @@ void radixSort(const uint32_t* first, const uint32_t* last, uint16_t* out)
 	}
 }
 
+// sorts the permutation of the previous pass by the new keys, returns false (with
+// order still a permutation) once more than maxMoves elements had to be shifted
+bool insertionSort(const uint32_t* __restrict keys, uint16_t* __restrict order, uint32_t n, uint32_t maxMoves)
+{
+	for(uint32_t i = 1; i < n; ++i)
+	{
+		uint16_t index = order[i];
+		uint32_t key = keys[index];
+
+		uint32_t j = i;
+		for(; j > 0 && keys[order[j - 1]] > key; --j)
+			order[j] = order[j - 1];
+		order[j] = index;
+
+		uint32_t numMoves = i - j;
+		if(numMoves > maxMoves)
+			return false;
+		maxMoves -= numMoves;
+	}
+	return true;
+}
+
+// index of the first key not less than key
+uint32_t findFirstKey(const uint32_t* keys, uint32_t n, uint32_t key)
+{
+	uint32_t first = 0;
+	while(n)
+	{
+		uint32_t half = n >> 1;
+		if(keys[first + half] < key)
+		{
+			first += half + 1;
+			n -= half + 1;
+		}
+		else
+			n = half;
+	}
+	return first;
+}
+
 template <typename Simd4f>
 uint32_t longestAxis(const Simd4f& edgeLength)
 {
@@ -208,17 +248,28 @@ void cloth::SwSelfCollision<Simd4f>::operator()()
 		keys[i] = uint32_t(ptr[sweepAxis] | (ptr[hashAxis0] << 16) | (ptr[hashAxis1] << 24));
 	}
 
-	// compute sorted keys indices
-	radixSort(keys, keys + numIndices, sortedIndices);
-
-	// snoop histogram: offset of first index with 8 msb > 1 (0 is sentinel)
-	uint16_t firstColumnSize = sortedIndices[2 * numIndices + 769];
+	// compute sorted keys indices: particles move little between passes, so the
+	// order of the last pass only needs a few fixes, unless e.g. the sweep axis changed
+	uint16_t* order = mClothData.mSelfCollisionOrder;
+	if(order && insertionSort(keys, order, numIndices, 4 * numIndices))
+	{
+		PxMemCopy(sortedIndices, order, numIndices * sizeof(uint16_t));
+	}
+	else
+	{
+		radixSort(keys, keys + numIndices, sortedIndices);
+		if(order)
+			PxMemCopy(order, sortedIndices, numIndices * sizeof(uint16_t));
+	}
 
 	// sort keys
 	for(uint32_t i = 0; i < numIndices; ++i)
 		sortedKeys[i] = keys[sortedIndices[i]];
 	sortedKeys[numIndices] = uint32_t(-1); // sentinel
 
+	// offset of first index with 8 msb > 1 (0 is sentinel)
+	uint16_t firstColumnSize = uint16_t(findFirstKey(sortedKeys, numIndices, 0x02000000));
+
 	if(indices)
 	{
 		// sort indices (into no-longer-needed keys array)
@@ -321,6 +372,43 @@ void cloth::SwSelfCollision<Simd4f>::collideParticles(Simd4f& pos0, Simd4f& pos1
 #endif
 }
 
+template <typename Simd4f>
+template <bool useRestParticles>
+void cloth::SwSelfCollision<Simd4f>::collideCandidates(Simd4f& particle, const Simd4f& restParticle,
+                                                       const uint16_t* jIt, const uint16_t* jEnd)
+{
+	Simd4f* __restrict particles = reinterpret_cast<Simd4f*>(mClothData.mCurParticles);
+	Simd4f* __restrict restParticles =
+	    useRestParticles ? reinterpret_cast<Simd4f*>(mClothData.mRestPositions) : particles;
+
+	// test 4 candidates at once, most of them are out of reach. particle only moves on
+	// a collision, so the group is rerun serially if any one is close enough
+	for(; jEnd - jIt >= 4; jIt += 4)
+	{
+		Simd4f dx = particles[jIt[0]] - particle;
+		Simd4f dy = particles[jIt[1]] - particle;
+		Simd4f dz = particles[jIt[2]] - particle;
+		Simd4f dw = particles[jIt[3]] - particle;
+
+		transpose(dx, dy, dz, dw);
+		Simd4f distSqr = dx * dx + dy * dy + dz * dz;
+
+		if(allGreater(distSqr, mCollisionSquareDistance))
+		{
+#if PX_DEBUG
+			mNumTests += 4;
+#endif
+			continue;
+		}
+
+		for(uint32_t k = 0; k < 4; ++k)
+			collideParticles<useRestParticles>(particle, particles[jIt[k]], restParticle, restParticles[jIt[k]]);
+	}
+
+	for(; jIt != jEnd; ++jIt)
+		collideParticles<useRestParticles>(particle, particles[*jIt], restParticle, restParticles[*jIt]);
+}
+
 template <typename Simd4f>
 template <bool useRestParticles>
 void cloth::SwSelfCollision<Simd4f>::collideParticles(const uint32_t* keys, uint16_t firstColumnSize,
@@ -369,7 +457,6 @@ void cloth::SwSelfCollision<Simd4f>::collideParticles(const uint32_t* keys, uint
 	const uint16_t* __restrict iIt = indices;
 	const uint16_t* __restrict iEnd = indices + mClothData.mNumSelfCollisionIndices;
 
-	const uint16_t* __restrict jIt;
 	const uint16_t* __restrict jEnd;
 
 	for(; iIt != iEnd; ++iIt, ++kFirst[0])
@@ -392,8 +479,7 @@ void cloth::SwSelfCollision<Simd4f>::collideParticles(const uint32_t* keys, uint
 
 		// process potential colliders of same cell
 		jEnd = indices + (kLast[0] - keys);
-		for(jIt = iIt + 1; jIt != jEnd; ++jIt)
-			collideParticles<useRestParticles>(particle, particles[*jIt], restParticle, restParticles[*jIt]);
+		collideCandidates<useRestParticles>(particle, restParticle, iIt + 1, jEnd);
 
 		// process neighbor cells
 		for(uint32_t k = 1; k < 5; ++k)
@@ -408,8 +494,7 @@ void cloth::SwSelfCollision<Simd4f>::collideParticles(const uint32_t* keys, uint
 
 			// process potential colliders
 			jEnd = indices + (kLast[k] - keys);
-			for(jIt = indices + (kFirst[k] - keys); jIt != jEnd; ++jIt)
-				collideParticles<useRestParticles>(particle, particles[*jIt], restParticle, restParticles[*jIt]);
+			collideCandidates<useRestParticles>(particle, restParticle, indices + (kFirst[k] - keys), jEnd);
 		}
 
 		// store current particle
@@ -63,6 +63,9 @@ class SwSelfCollision
 	template <bool useRestParticles>
 	void collideParticles(Simd4f&, Simd4f&, const Simd4f&, const Simd4f&);
 
+	template <bool useRestParticles>
+	void collideCandidates(Simd4f&, const Simd4f&, const uint16_t*, const uint16_t*);
+
 	template <bool useRestParticles>
 	void collideParticles(const uint32_t*, uint16_t, const uint16_t*, uint32_t);
 
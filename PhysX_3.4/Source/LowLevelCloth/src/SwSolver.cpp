@@ -36,6 +36,7 @@
 #include "SwClothData.h"
 #include "SwSolverKernel.h"
 #include "SwInterCollision.h"
+#include "SwParallelFor.h"
 #include "PsFPU.h"
 #include "PsFoundation.h"
 #include "PsSort.h"
@@ -85,6 +86,41 @@ bool clothSizeGreater(const T& t0, const T& t1)
 	return t0.mCloth->mCurParticles.size() > t1.mCloth->mCurParticles.size();
 }
 
+// moves the particles on with their velocity of the last solved iteration
+void extrapolateParticles(cloth::SwCloth& cloth, float dt)
+{
+	// the particles are in local space, so they get carried along with the frame motion
+	cloth.mCurrentMotion = cloth.mTargetMotion;
+
+	if(cloth.mPrevIterDt == 0.0f)
+		return;
+
+	const float scale = dt / cloth.mPrevIterDt;
+
+	PxVec4* curIt = cloth.mCurParticles.begin();
+	PxVec4* curEnd = cloth.mCurParticles.end();
+	PxVec4* prevIt = cloth.mPrevParticles.begin();
+
+	PxVec3 lower(FLT_MAX), upper(-FLT_MAX);
+	for(; curIt != curEnd; ++curIt, ++prevIt)
+	{
+		// previous w is the unmodified inverse mass, leave attached particles alone
+		if(prevIt->w > 0.0f)
+		{
+			PxVec4 delta = (*curIt - *prevIt) * scale;
+			delta.w = 0.0f;
+			*curIt += delta;
+			*prevIt += delta;
+		}
+
+		lower = lower.minimum(curIt->getXYZ());
+		upper = upper.maximum(curIt->getXYZ());
+	}
+
+	const float bounds[6] = { lower.x, lower.y, lower.z, upper.x, upper.y, upper.z };
+	cloth.setParticleBounds(bounds);
+}
+
 template <typename T>
 void sortTasks(shdfnd::Array<T, physx::shdfnd::NonTrackingAllocator>& tasks)
 {
@@ -113,6 +149,7 @@ void cloth::SwSolver::removeCloth(Cloth* cloth)
 	if(tIt != tEnd)
 	{
 		deallocate(tIt->mScratchMemory);
+		delete tIt->mParallelFor;
 		mCpuClothSimulationTasks.replaceWithLast(tIt);
 		sortTasks(mCpuClothSimulationTasks);
 	}
@@ -225,6 +262,8 @@ const char* cloth::SwSolver::EndSimulationTask::getName() const
 
 cloth::SwSolver::CpuClothSimulationTask::CpuClothSimulationTask(SwCloth& cloth, EndSimulationTask& continuation)
 : Cm::Task(0), mCloth(&cloth), mContinuation(&continuation), mScratchMemorySize(0), mScratchMemory(0), mInvNumIterations(0.0f)
+, mParallelFor(NULL)
+, mLodFrameCounter(0)
 {
 }
 
@@ -245,6 +284,11 @@ void cloth::SwSolver::CpuClothSimulationTask::runInternal()
 	if(mContinuation->mDt == 0.0f)
 		return;
 
+	// level of detail: solve every nth frame only
+	if(++mLodFrameCounter < mCloth->mLod.mUpdateInterval)
+		return extrapolateParticles(*mCloth, mContinuation->mDt);
+	mLodFrameCounter = 0;
+
 	IterationStateFactory factory(*mCloth, mContinuation->mDt);
 	mInvNumIterations = factory.mInvNumIterations;
 
@@ -253,11 +297,18 @@ void cloth::SwSolver::CpuClothSimulationTask::runInternal()
 	SwClothData data(*mCloth, mCloth->mFabric);
 	SwKernelAllocator allocator(mScratchMemory, uint32_t(mScratchMemorySize));
 
+	// split the particle and constraint loops of large cloths across the workers,
+	// smaller ones are better served by the one task per cloth
+	if(!mParallelFor && mCloth->mCurParticles.size() >= 4096)
+		mParallelFor = new SwParallelFor;
+	if(mParallelFor)
+		mParallelFor->setup(getTaskManager(), mContinuation);
+
 // construct kernel functor and execute
 #if PX_ANDROID
 // if(!neonSolverKernel(cloth, data, allocator, factory))
 #endif
-	SwSolverKernel<Simd4fType>(*mCloth, data, allocator, factory)();
+	SwSolverKernel<Simd4fType>(*mCloth, data, allocator, factory, mParallelFor)();
 
 	data.reconcile(*mCloth); // update cloth
 }
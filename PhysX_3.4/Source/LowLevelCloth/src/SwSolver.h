@@ -42,6 +42,7 @@ namespace cloth
 
 class SwCloth;
 class SwFactory;
+class SwParallelFor;
 
 /// CPU/SSE based cloth solver
 class SwSolver : public UserAllocated, public Solver
@@ -82,6 +83,8 @@ class SwSolver : public UserAllocated, public Solver
 		uint32_t mScratchMemorySize;
 		void* mScratchMemory;
 		float mInvNumIterations;
+		SwParallelFor* mParallelFor; // only for large cloths
+		uint32_t mLodFrameCounter;   // frames since last solved
 	};
 
   public:
@@ -35,6 +35,8 @@
 #include "SwFactory.h"
 #include "PointInterpolator.h"
 #include "BoundingBox.h"
+#include "SwParallelFor.h"
+#include "PsCpu.h"
 
 #define PX_AVX (NV_SIMD_SIMD&&(PX_WIN32 || PX_WIN64) && PX_VC >= 10)
 
@@ -54,41 +56,22 @@ namespace
 {
 uint32_t getAvxSupport()
 {
-// Checking for AVX requires 3 things:
-// 1) CPUID indicates that the OS uses XSAVE and XRSTORE
-// 2) CPUID indicates support for AVX
-// 3) XGETBV indicates registers are saved and restored on context switch
-
 #if _MSC_FULL_VER < 160040219 || !defined(_XCR_XFEATURE_ENABLED_MASK)
 	// need at least VC10 SP1 and compile on at least Win7 SP1
 	return 0;
 #else
-	int cpuInfo[4];
-	__cpuid(cpuInfo, 1);
-	int avxFlags = 3 << 27; // checking 1) and 2) above
-	if((cpuInfo[2] & avxFlags) != avxFlags)
-		return 0; // xgetbv not enabled or no AVX support
-
-	if((_xgetbv(_XCR_XFEATURE_ENABLED_MASK) & 0x6) != 0x6)
-		return 0; // OS does not save YMM registers
+	// checks the OS saves the YMM registers as well
+	const uint32_t features = physx::shdfnd::Cpu::getFeatures();
+	if((features & physx::shdfnd::Cpu::eAVX) == 0)
+		return 0;
 
 	avx::initialize();
 
 #if _MSC_VER < 1700
 	return 1;
 #else
-	int fmaFlags = 1 << 12;
-	if((cpuInfo[2] & fmaFlags) != fmaFlags)
-		return 1; // no FMA3 support
-
-	/* only using fma at the moment, don't lock out AMD's piledriver by requiring avx2
-	__cpuid(cpuInfo, 7);
-	int avx2Flags = 1 << 5;
-	if((cpuInfo[1] & avx2Flags) != avx2Flags)
-	    return 1; // no AVX2 support
-	*/
-
-	return 2;
+	// only using fma at the moment, don't lock out AMD's piledriver by requiring avx2
+	return (features & physx::shdfnd::Cpu::eFMA) ? 2u : 1u;
 #endif // _MSC_VER
 #endif // _MSC_FULL_VER
 }
@@ -409,11 +392,13 @@ void applyWind(Simd4f* __restrict curIt, const Simd4f* __restrict prevIt, const
 
 template <typename Simd4f>
 cloth::SwSolverKernel<Simd4f>::SwSolverKernel(SwCloth const& cloth, SwClothData& clothData,
-                                              SwKernelAllocator& allocator, IterationStateFactory& factory)
+                                              SwKernelAllocator& allocator, IterationStateFactory& factory,
+                                              SwParallelFor* parallelFor)
 : mCloth(cloth)
 , mClothData(clothData)
 , mAllocator(allocator)
-, mCollision(clothData, allocator)
+, mParallelFor(parallelFor)
+, mCollision(clothData, allocator, parallelFor)
 , mSelfCollision(clothData, allocator)
 , mState(factory.create<Simd4f>(cloth))
 {
@@ -443,13 +428,24 @@ size_t cloth::SwSolverKernel<Simd4f>::estimateTemporaryMemory(const SwCloth& clo
 	return maxAllocatorOverhead + persistentMemory + tempMemory;
 }
 
+template <typename Simd4f>
+void cloth::SwSolverKernel<Simd4f>::runRange(RangeFunction function, uint32_t count, uint32_t chunkSize)
+{
+	if(!mParallelFor)
+		return (this->*function)(0, count);
+
+	RangeBody body(*this, function);
+	mParallelFor->run(body, count, chunkSize);
+}
+
 template <typename Simd4f>
 template <typename AccelerationIterator>
-void cloth::SwSolverKernel<Simd4f>::integrateParticles(AccelerationIterator& accelIt, const Simd4f& prevBias)
+void cloth::SwSolverKernel<Simd4f>::integrateParticles(uint32_t begin, uint32_t end, AccelerationIterator& accelIt,
+                                                       const Simd4f& prevBias)
 {
-	Simd4f* curIt = reinterpret_cast<Simd4f*>(mClothData.mCurParticles);
-	Simd4f* curEnd = curIt + mClothData.mNumParticles;
-	Simd4f* prevIt = reinterpret_cast<Simd4f*>(mClothData.mPrevParticles);
+	Simd4f* curIt = reinterpret_cast<Simd4f*>(mClothData.mCurParticles) + begin;
+	Simd4f* curEnd = reinterpret_cast<Simd4f*>(mClothData.mCurParticles) + end;
+	Simd4f* prevIt = reinterpret_cast<Simd4f*>(mClothData.mPrevParticles) + begin;
 
 	if(!mState.mIsTurning)
 		::integrateParticles(curIt, curEnd, prevIt, mState.mPrevMatrix[0], accelIt, prevBias);
@@ -462,6 +458,13 @@ void cloth::SwSolverKernel<Simd4f>::integrateParticles()
 {
 	PX_PROFILE_ZONE("cloth::SwSolverKernel::integrateParticles", 0);
 
+	// particles are independent
+	runRange(&SwSolverKernel::integrateParticlesRange, mClothData.mNumParticles, 1024);
+}
+
+template <typename Simd4f>
+void cloth::SwSolverKernel<Simd4f>::integrateParticlesRange(uint32_t begin, uint32_t end)
+{
 	const Simd4f* startAccelIt = reinterpret_cast<const Simd4f*>(mClothData.mParticleAccelerations);
 
 	// dt^2 (todo: should this be the smoothed dt used for gravity?)
@@ -471,13 +474,13 @@ void cloth::SwSolverKernel<Simd4f>::integrateParticles()
 	{
 		// no per-particle accelerations, use a constant
 		ConstantIterator<Simd4f> accelIt(mState.mCurBias);
-		integrateParticles(accelIt, mState.mPrevBias);
+		integrateParticles(begin, end, accelIt, mState.mPrevBias);
 	}
 	else
 	{
 		// iterator implicitly scales by dt^2 and adds gravity
-		ScaleBiasIterator<Simd4f, const Simd4f*> accelIt(startAccelIt, sqrIterDt, mState.mCurBias);
-		integrateParticles(accelIt, mState.mPrevBias);
+		ScaleBiasIterator<Simd4f, const Simd4f*> accelIt(startAccelIt + begin, sqrIterDt, mState.mCurBias);
+		integrateParticles(begin, end, accelIt, mState.mPrevBias);
 	}
 }
 
@@ -535,8 +538,6 @@ void cloth::SwSolverKernel<Simd4f>::solveFabric()
 {
 	PX_PROFILE_ZONE("cloth::SwSolverKernel::solveFabric", 0);
 
-	float* pIt = mClothData.mCurParticles;
-
 	const PhaseConfig* cIt = mClothData.mConfigBegin;
 	const PhaseConfig* cEnd = mClothData.mConfigEnd;
 
@@ -552,6 +553,10 @@ void cloth::SwSolverKernel<Simd4f>::solveFabric()
 
 	for(; cIt != cEnd; ++cIt)
 	{
+		// phases disabled by the level of detail
+		if(cIt->mPhaseIndex < 32 && !((mClothData.mPhaseMask >> cIt->mPhaseIndex) & 1))
+			continue;
+
 		const uint32_t* sIt = sBegin + pBegin[cIt->mPhaseIndex];
 		const float* rIt = rBegin + sIt[0];
 		const float* rEnd = rBegin + sIt[1];
@@ -565,30 +570,48 @@ void cloth::SwSolverKernel<Simd4f>::solveFabric()
 		Simd4f scaledConfig = gSimd4fOne - exp2(config * stiffnessExponent);
 		Simd4f stiffness = select(sMaskXY, scaledConfig, config);
 
-		int neutralMultiplier = allEqual(sMaskYZW & stiffness, gSimd4fZero);
+		mFabricPhase.mRestvalues = rIt;
+		mFabricPhase.mIndices = iIt;
+		mFabricPhase.mStiffness = stiffness;
+		mFabricPhase.mNeutralMultiplier = allEqual(sMaskYZW & stiffness, gSimd4fZero);
+
+		// the constraints of a phase share no particle (graph colouring of the fabric cooker),
+		// so chunks of a multiple of 4 constraints can be solved concurrently
+		runRange(&SwSolverKernel::solveFabricRange, uint32_t(rEnd - rIt), 2048);
+	}
+}
+
+template <typename Simd4f>
+void cloth::SwSolverKernel<Simd4f>::solveFabricRange(uint32_t begin, uint32_t end)
+{
+	float* pIt = mClothData.mCurParticles;
+	const float* rIt = mFabricPhase.mRestvalues + begin;
+	const float* rEnd = mFabricPhase.mRestvalues + end;
+	const uint16_t* iIt = mFabricPhase.mIndices + begin * 2;
+	const Simd4f& stiffness = mFabricPhase.mStiffness;
+	const int neutralMultiplier = mFabricPhase.mNeutralMultiplier;
 
 #if PX_AVX
-		switch(sAvxSupport)
-		{
-		case 2:
+	switch(sAvxSupport)
+	{
+	case 2:
 #if _MSC_VER >= 1700
-			neutralMultiplier ? avx::solveConstraints<false, 2>(pIt, rIt, rEnd, iIt, stiffness)
-			                  : avx::solveConstraints<true, 2>(pIt, rIt, rEnd, iIt, stiffness);
-			break;
+		neutralMultiplier ? avx::solveConstraints<false, 2>(pIt, rIt, rEnd, iIt, stiffness)
+		                  : avx::solveConstraints<true, 2>(pIt, rIt, rEnd, iIt, stiffness);
+		break;
 #endif
-		case 1:
-			neutralMultiplier ? avx::solveConstraints<false, 1>(pIt, rIt, rEnd, iIt, stiffness)
-			                  : avx::solveConstraints<true, 1>(pIt, rIt, rEnd, iIt, stiffness);
-			break;
-		default:
+	case 1:
+		neutralMultiplier ? avx::solveConstraints<false, 1>(pIt, rIt, rEnd, iIt, stiffness)
+		                  : avx::solveConstraints<true, 1>(pIt, rIt, rEnd, iIt, stiffness);
+		break;
+	default:
 #endif
-			neutralMultiplier ? solveConstraints<false>(pIt, rIt, rEnd, iIt, stiffness)
-			                  : solveConstraints<true>(pIt, rIt, rEnd, iIt, stiffness);
+		neutralMultiplier ? solveConstraints<false>(pIt, rIt, rEnd, iIt, stiffness)
+		                  : solveConstraints<true>(pIt, rIt, rEnd, iIt, stiffness);
 #if PX_AVX
-			break;
-		}
-#endif
+		break;
 	}
+#endif
 }
 
 template <typename Simd4f>
@@ -628,11 +651,17 @@ void cloth::SwSolverKernel<Simd4f>::constrainMotion()
 
 	PX_PROFILE_ZONE("cloth::SwSolverKernel::constrainMotion", 0);
 
-	Simd4f* curIt = reinterpret_cast<Simd4f*>(mClothData.mCurParticles);
-	Simd4f* curEnd = curIt + mClothData.mNumParticles;
+	runRange(&SwSolverKernel::constrainMotionRange, mClothData.mNumParticles, 1024);
+}
 
-	const Simd4f* startIt = reinterpret_cast<const Simd4f*>(mClothData.mStartMotionConstraints);
-	const Simd4f* targetIt = reinterpret_cast<const Simd4f*>(mClothData.mTargetMotionConstraints);
+template <typename Simd4f>
+void cloth::SwSolverKernel<Simd4f>::constrainMotionRange(uint32_t begin, uint32_t end)
+{
+	Simd4f* curIt = reinterpret_cast<Simd4f*>(mClothData.mCurParticles) + begin;
+	Simd4f* curEnd = reinterpret_cast<Simd4f*>(mClothData.mCurParticles) + end;
+
+	const Simd4f* startIt = reinterpret_cast<const Simd4f*>(mClothData.mStartMotionConstraints) + begin;
+	const Simd4f* targetIt = reinterpret_cast<const Simd4f*>(mClothData.mTargetMotionConstraints) + begin;
 
 	Simd4f scaleBias = load(&mCloth.mMotionConstraintScale);
 	Simd4f stiffness = simd4f(mClothData.mMotionConstraintStiffness);
@@ -659,11 +688,17 @@ void cloth::SwSolverKernel<Simd4f>::constrainSeparation()
 
 	PX_PROFILE_ZONE("cloth::SwSolverKernel::constrainSeparation", 0);
 
-	Simd4f* curIt = reinterpret_cast<Simd4f*>(mClothData.mCurParticles);
-	Simd4f* curEnd = curIt + mClothData.mNumParticles;
+	runRange(&SwSolverKernel::constrainSeparationRange, mClothData.mNumParticles, 1024);
+}
 
-	const Simd4f* startIt = reinterpret_cast<const Simd4f*>(mClothData.mStartSeparationConstraints);
-	const Simd4f* targetIt = reinterpret_cast<const Simd4f*>(mClothData.mTargetSeparationConstraints);
+template <typename Simd4f>
+void cloth::SwSolverKernel<Simd4f>::constrainSeparationRange(uint32_t begin, uint32_t end)
+{
+	Simd4f* curIt = reinterpret_cast<Simd4f*>(mClothData.mCurParticles) + begin;
+	Simd4f* curEnd = reinterpret_cast<Simd4f*>(mClothData.mCurParticles) + end;
+
+	const Simd4f* startIt = reinterpret_cast<const Simd4f*>(mClothData.mStartSeparationConstraints) + begin;
+	const Simd4f* targetIt = reinterpret_cast<const Simd4f*>(mClothData.mTargetSeparationConstraints) + begin;
 
 	if(!mClothData.mTargetSeparationConstraints)
 		// no interpolation, use the start positions
@@ -689,6 +724,11 @@ void cloth::SwSolverKernel<Simd4f>::collideParticles()
 template <typename Simd4f>
 void cloth::SwSolverKernel<Simd4f>::selfCollideParticles()
 {
+	// the collision distance is usually large enough to not miss pairs in between
+	if(++mClothData.mSelfCollisionCounter < mClothData.mSelfCollisionInterval)
+		return;
+	mClothData.mSelfCollisionCounter = 0;
+
 	PX_PROFILE_ZONE("cloth::SwSolverKernel::selfCollideParticles", 0);
 
 	mSelfCollision();
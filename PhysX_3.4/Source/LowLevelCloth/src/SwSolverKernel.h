@@ -40,12 +40,14 @@ namespace cloth
 
 class SwCloth;
 struct SwClothData;
+class SwParallelFor;
 
 template <typename Simd4f>
 class SwSolverKernel
 {
   public:
-	SwSolverKernel(SwCloth const&, SwClothData&, SwKernelAllocator&, IterationStateFactory&);
+	// with a parallelFor, the particle and constraint loops are split across the worker threads
+	SwSolverKernel(SwCloth const&, SwClothData&, SwKernelAllocator&, IterationStateFactory&, SwParallelFor* parallelFor = NULL);
 
 	void operator()();
 
@@ -54,12 +56,47 @@ class SwSolverKernel
 	static size_t estimateTemporaryMemory(const SwCloth& c);
 
   private:
+	typedef void (SwSolverKernel::*RangeFunction)(uint32_t begin, uint32_t end);
+
+	// calls a range function on a chunk, see SwParallelFor
+	struct RangeBody
+	{
+		SwSolverKernel& mKernel;
+		RangeFunction mFunction;
+
+		RangeBody(SwSolverKernel& kernel, RangeFunction function) : mKernel(kernel), mFunction(function)
+		{
+		}
+		void operator()(uint32_t begin, uint32_t end)
+		{
+			(mKernel.*mFunction)(begin, end);
+		}
+
+	  private:
+		RangeBody& operator=(const RangeBody&);
+	};
+
+	// the fabric phase being solved, read by solveFabricRange
+	struct FabricPhase
+	{
+		const float* mRestvalues;
+		const uint16_t* mIndices;
+		Simd4f mStiffness;
+		int mNeutralMultiplier;
+	};
+
+	void runRange(RangeFunction, uint32_t count, uint32_t chunkSize);
+
 	void integrateParticles();
+	void integrateParticlesRange(uint32_t begin, uint32_t end);
 	void constrainTether();
 	void solveFabric();
+	void solveFabricRange(uint32_t begin, uint32_t end);
 	void applyWind();
 	void constrainMotion();
+	void constrainMotionRange(uint32_t begin, uint32_t end);
 	void constrainSeparation();
+	void constrainSeparationRange(uint32_t begin, uint32_t end);
 	void collideParticles();
 	void selfCollideParticles();
 	void updateSleepState();
@@ -70,15 +107,17 @@ class SwSolverKernel
 	SwCloth const& mCloth;
 	SwClothData& mClothData;
 	SwKernelAllocator& mAllocator;
+	SwParallelFor* mParallelFor;
 
 	SwCollision<Simd4f> mCollision;
 	SwSelfCollision<Simd4f> mSelfCollision;
 	IterationState<Simd4f> mState;
+	FabricPhase mFabricPhase;
 
   private:
 	SwSolverKernel<Simd4f>& operator=(const SwSolverKernel<Simd4f>&);
 	template <typename AccelerationIterator>
-	void integrateParticles(AccelerationIterator& accelIt, const Simd4f&);
+	void integrateParticles(uint32_t begin, uint32_t end, AccelerationIterator& accelIt, const Simd4f&);
 };
 
 #if PX_SUPPORT_EXTERN_TEMPLATE
@@ -32,6 +32,7 @@
 #include "foundation/PxTransform.h"
 #include "foundation/PxVec4.h"
 #include "Range.h"
+#include "Cloth.h"
 #include "PhaseConfig.h"
 #include "MovingAverage.h"
 #include "IndexPair.h"
@@ -194,6 +195,7 @@ public:
 	// self collision
 	float mSelfCollisionDistance;
 	float mSelfCollisionLogStiffness;
+	uint32_t mSelfCollisionInterval; // not used by the GPU solver
 
 	CuDeviceVector<PxVec4> mRestPositions;
 	CuDeviceVector<uint32_t> mSelfCollisionIndices;
@@ -209,6 +211,8 @@ public:
 	uint32_t mSleepPassCounter;
 	uint32_t mSleepTestCounter;
 
+	LodConfig mLod; // only the solver frequency scale is used by the GPU solver
+
 	uint32_t mSharedMemorySize;
 
 	void* mUserData;
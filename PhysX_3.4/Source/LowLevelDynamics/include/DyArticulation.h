@@ -200,7 +200,7 @@ public:
 	PxU32					getSolverDataSize()								const	{ return mSolverDesc->solverDataSize;			}
 	PxU32					getTotalDataSize()								const	{ return mSolverDesc->totalDataSize;			}
 	void					getSolverDesc(ArticulationSolverDesc& d)		const	{ d = *mSolverDesc;	}
-	void					setSolverDesc(const ArticulationSolverDesc& d)			{ mSolverDesc = &d;	}
+	void					setSolverDesc(const ArticulationSolverDesc& d);
 
 	const ArticulationSolverDesc* getSolverDescPtr()						const	{ return mSolverDesc;	}
 	const ArticulationCore*	getCore()										const	{ return mSolverDesc->core;}	
@@ -208,6 +208,9 @@ public:
 
 	Sc::ArticulationSim*	getArticulationSim()							const	{ return mArticulationSim; }
 
+	// hash of the link count and link parents, equal for articulations built from the same rig
+	PxU32					getTopologyKey()								const	{ return mTopologyKey; }
+
 
 	// get data sizes for allocation at higher levels
 	static void		getDataSizes(PxU32 linkCount, 
@@ -219,6 +222,7 @@ private:
 
 	const ArticulationSolverDesc*	mSolverDesc;
 	Sc::ArticulationSim* mArticulationSim;
+	PxU32					mTopologyKey;
 	
 #if DY_DEBUG_ARTICULATION
 	// debug quantities
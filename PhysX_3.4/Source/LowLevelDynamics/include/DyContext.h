@@ -37,6 +37,7 @@
 #include "PxsSimulationController.h"
 #include "DyConstraintWriteBack.h"
 #include "PsAllocator.h"
+#include "PsArray.h"
 
 
 
@@ -69,11 +70,27 @@ struct PxsContactManagerOutput;
 class PxsKernelWranglerManager;
 class PxsHeapMemoryAllocator;
 class PxsMemoryManager;
+class PxsRigidBody;
 
 
 namespace Dy
 {
 
+/**
+\brief Solver time of a batch of islands solved by the same task chain, recorded while cost profiling is enabled.
+
+Islands are batched until they reach the solver batch size, so a large island has a batch of its own.
+*/
+struct IslandCost
+{
+	const PxsRigidBody*	body;				//!< First body of the batch, NULL for a batch of articulations only
+	PxU32				nbIslands;
+	PxU32				nbBodies;
+	PxU32				nbArticulations;
+	PxU32				nbContactManagers;
+	PxU32				nbConstraints;
+	PxU64				time;				//!< Counter ticks from the start of the first task of the chain to the end of the last one
+};
 
 class Context
 {
@@ -95,6 +112,11 @@ public:
 	*/
 	PX_FORCE_INLINE PxReal				getSolverOffsetSlop()	const	{ return mSolverOffsetSlop; }
 	/**
+	\brief Returns the velocity change under which an island skips its remaining iterations, 0 if disabled
+	\return The solver convergence threshold.
+	*/
+	PX_FORCE_INLINE PxReal				getSolverConvergenceThreshold()	const	{ return mSolverConvergenceThreshold; }
+	/**
 	\brief Returns the correlation distance
 	\return The correlation distance.
 	*/
@@ -127,6 +149,11 @@ public:
 	*/
 	PX_FORCE_INLINE void				setSolverOffsetSlop(PxReal offset)		{ mSolverOffsetSlop = offset; }
 	/**
+	\brief Sets the solver convergence threshold, see PxSceneDesc::solverConvergenceThreshold
+	\param[in] threshold The velocity change threshold, 0 to disable
+	*/
+	PX_FORCE_INLINE void				setSolverConvergenceThreshold(PxReal threshold)	{ mSolverConvergenceThreshold = threshold; }
+	/**
 	\brief Sets the friction offset threshold
 	\param[in] offset The friction offset threshold
 	*/
@@ -175,6 +202,19 @@ public:
 	*/
 	PX_FORCE_INLINE void				setFrictionType(PxFrictionType::Enum f) 	{ mFrictionType = f; }
 
+	/**
+	\brief Selects the graph coloring constraint partitioner, see PxSceneFlag::eENABLE_BALANCED_PARTITIONS.
+	*/
+	PX_FORCE_INLINE void				setBalancedPartitions(bool enabled)			{ mBalancedPartitions = enabled; }
+	PX_FORCE_INLINE bool				getBalancedPartitions()				const	{ return mBalancedPartitions; }
+
+	/**
+	\brief Times the island task chains, see PxScene::setCostProfiling. The costs of the last update are returned by getIslandCosts.
+	*/
+	PX_FORCE_INLINE void				setCostProfiling(bool enabled)				{ mCostProfiling = enabled; }
+	PX_FORCE_INLINE bool				getCostProfiling()					const	{ return mCostProfiling; }
+	PX_FORCE_INLINE const Ps::Array<IslandCost>& getIslandCosts()			const	{ return mIslandCosts; }
+
 	/**
 	\brief Destroys this dynamics context
 	*/
@@ -266,7 +306,11 @@ protected:
 		mUseAdaptiveForce			(useAdaptiveForce),
 
 		mBounceThreshold(-2.0f),
+		mSolverConvergenceThreshold(0.0f),
 		mSolverBatchSize(32),
+		mBalancedPartitions(false),
+		mCostProfiling(false),
+		mIslandCosts(PX_DEBUG_EXP("mIslandCosts")),
 		mConstraintWriteBackPool(Ps::VirtualAllocator(allocatorCallback)),
 		mSimStats(simStats)
 		 {
@@ -331,6 +375,11 @@ protected:
 	*/
 	PxReal						mSolverOffsetSlop;
 
+	/**
+	\brief Velocity change under which the position iterations of an island stop early. 0 runs every iteration.
+	*/
+	PxReal						mSolverConvergenceThreshold;
+
 	/**
 	\brief Threshold controlling whether distant contacts are processed using bias, restitution or a combination of the two. This only has effect on pairs involving bodies that have enabled speculative CCD simulation mode.
 	*/
@@ -350,6 +399,17 @@ protected:
 	*/
 	PxFrictionType::Enum		mFrictionType;
 
+	/**
+	\brief Whether the constraints are partitioned by graph coloring
+	*/
+	bool						mBalancedPartitions;
+
+	/**
+	\brief Whether the island task chains are timed, and their costs for the last update
+	*/
+	bool						mCostProfiling;
+	Ps::Array<IslandCost>		mIslandCosts;
+
 	/**
 	\brief Structure to encapsulate contact stream allocations. Used by GPU solver to reference pre-allocated pinned host memory
 	*/
@@ -105,6 +105,9 @@ public:
 
 	void build(const ThresholdStream& stream);
 
+	// Same for the nbIndices elements of the stream listed in indices, all of them if indices is NULL
+	void build(const ThresholdStream& stream, const PxU32* indices, PxU32 nbIndices);
+
 	bool check(const ThresholdStream& stream, const PxU32 nodexIndexA, const PxU32 nodexIndexB, PxReal dt);
 
 	bool check(const ThresholdStream& stream, const ThresholdStreamElement& elem, PxU32& thresholdIndex);
@@ -171,9 +174,14 @@ inline bool ThresholdTable::check(const ThresholdStream& stream, const Threshold
 
 
 inline void ThresholdTable::build(const ThresholdStream& stream)
+{
+	build(stream, NULL, stream.size());
+}
+
+inline void ThresholdTable::build(const ThresholdStream& stream, const PxU32* indices, PxU32 nbIndices)
 {
 	//Handle the case of an empty stream.
-	if(0==stream.size())
+	if(0==nbIndices)
 	{
 		mPairsSize=0;
 		mPairsCapacity=0;
@@ -185,7 +193,7 @@ inline void ThresholdTable::build(const ThresholdStream& stream)
 	}
 
 	//Realloc/resize if necessary.
-	const PxU32 pairsCapacity = stream.size();
+	const PxU32 pairsCapacity = nbIndices;
 	const PxU32 hashCapacity = pairsCapacity*2+1;
 	if((pairsCapacity > mPairsCapacity) || (pairsCapacity < (mPairsCapacity >> 2)))
 	{
@@ -223,8 +231,10 @@ inline void ThresholdTable::build(const ThresholdStream& stream)
 
 	//Add all the pairs from the stream.
 	PxU32 pairsSize = 0;
-	for(PxU32 i = 0; i < pairsCapacity; i++)
+	for(PxU32 k = 0; k < pairsCapacity; k++)
 	{
+		const PxU32 i = indices ? indices[k] : k;
+		PX_ASSERT(i < stream.size());
 		const ThresholdStreamElement& element = stream[i];
 		const PxU32 nodeIndexA = element.nodeIndexA;
 		const PxU32 nodeIndexB = element.nodeIndexB;
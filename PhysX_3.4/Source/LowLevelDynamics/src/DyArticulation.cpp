@@ -59,7 +59,7 @@ namespace physx
 PX_COMPILE_TIME_ASSERT((sizeof(Articulation)&(DY_ARTICULATION_MAX_SIZE-1))==0);
 
 Articulation::Articulation(Sc::ArticulationSim* sim)
-:	mSolverDesc(NULL), mArticulationSim(sim)
+:	mSolverDesc(NULL), mArticulationSim(sim), mTopologyKey(0)
 {
 	PX_ASSERT((reinterpret_cast<size_t>(this) & (DY_ARTICULATION_MAX_SIZE-1))==0);
 }
@@ -68,6 +68,17 @@ Articulation::~Articulation()
 {
 }
 
+void Articulation::setSolverDesc(const ArticulationSolverDesc& d)
+{
+	mSolverDesc = &d;
+
+	// the solver desc is only set again when links are added or removed, so the key is kept up to date here
+	PxU32 key = d.linkCount;
+	for(PxU32 i=0;i<d.linkCount;i++)
+		key = key * 31 + d.links[i].parent;
+	mTopologyKey = key;
+}
+
 
 /* computes the implicit impulse and the drive scale at the joint, in joint coords */
 
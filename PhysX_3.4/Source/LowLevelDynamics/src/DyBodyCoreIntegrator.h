@@ -34,6 +34,7 @@
 #include "CmPhysXCommon.h"
 #include "PxvDynamics.h"
 #include "PsMathUtils.h"
+#include "PsVecMath.h"
 #include "PxsRigidBody.h"
 #include "DySolverBody.h"
 #include "DySleepingConfigulation.h"
@@ -91,7 +92,7 @@ bool disableGravity)
 }
 
 
-PX_FORCE_INLINE void integrateCore(PxVec3& motionLinearVelocity, PxVec3& motionAngularVelocity, PxSolverBody& solverBody, PxSolverBodyData& solverBodyData, const PxF32 dt)
+PX_FORCE_INLINE void applyLockFlags(PxVec3& motionLinearVelocity, PxVec3& motionAngularVelocity, PxSolverBody& solverBody, const PxSolverBodyData& solverBodyData)
 {
 	PxU32 lockFlags = solverBodyData.lockFlags;
 	if (lockFlags)
@@ -129,6 +130,11 @@ PX_FORCE_INLINE void integrateCore(PxVec3& motionLinearVelocity, PxVec3& motionA
 			solverBody.angularState.z = 0.f;
 		}
 	}
+}
+
+PX_FORCE_INLINE void integrateCore(PxVec3& motionLinearVelocity, PxVec3& motionAngularVelocity, PxSolverBody& solverBody, PxSolverBodyData& solverBodyData, const PxF32 dt)
+{
+	applyLockFlags(motionLinearVelocity, motionAngularVelocity, solverBody, solverBodyData);
 
 	// Integrate linear part
 	PxVec3 linearMotionVel = solverBodyData.linearVelocity + motionLinearVelocity;
@@ -176,6 +182,140 @@ PX_FORCE_INLINE void integrateCore(PxVec3& motionLinearVelocity, PxVec3& motionA
 	motionAngularVelocity = angularMotionVel;
 }
 
+// same as integrateCore for the 4 consecutive bodies starting at the given entries. The bodies are gathered to SoA
+// so that the integration and the quaternion update run for the 4 of them at once, the lock flags are applied per body first.
+PX_FORCE_INLINE void integrateCore4(Cm::SpatialVector* PX_RESTRICT motionVelocities, PxSolverBody* PX_RESTRICT solverBodies, PxSolverBodyData* PX_RESTRICT solverBodyData, const PxF32 dt)
+{
+	using namespace Ps::aos;
+
+	enum
+	{
+		eLX, eLY, eLZ,			// solverBodyData.linearVelocity
+		eAX, eAY, eAZ,			// solverBodyData.angularVelocity
+		eMLX, eMLY, eMLZ,		// motion linear velocity
+		eMAX, eMAY, eMAZ,		// motion angular velocity
+		eSLX, eSLY, eSLZ,		// solverBody.linearVelocity
+		eSAX, eSAY, eSAZ,		// solverBody.angularState
+		eI00, eI10, eI20,		// solverBodyData.sqrtInvInertia, column major
+		eI01, eI11, eI21,
+		eI02, eI12, eI22,
+		ePX, ePY, ePZ,			// solverBodyData.body2World
+		eQX, eQY, eQZ, eQW,
+		eCOUNT
+	};
+
+	PX_ALIGN(16, PxReal data[eCOUNT][4]);
+
+	for(PxU32 i=0;i<4;i++)
+	{
+		Cm::SpatialVector& motionVelocity = motionVelocities[i];
+		PxSolverBody& solverBody = solverBodies[i];
+		const PxSolverBodyData& bodyData = solverBodyData[i];
+
+		applyLockFlags(motionVelocity.linear, motionVelocity.angular, solverBody, bodyData);
+
+		const PxMat33& m = bodyData.sqrtInvInertia;
+		data[eLX][i] = bodyData.linearVelocity.x;	data[eLY][i] = bodyData.linearVelocity.y;	data[eLZ][i] = bodyData.linearVelocity.z;
+		data[eAX][i] = bodyData.angularVelocity.x;	data[eAY][i] = bodyData.angularVelocity.y;	data[eAZ][i] = bodyData.angularVelocity.z;
+		data[eMLX][i] = motionVelocity.linear.x;	data[eMLY][i] = motionVelocity.linear.y;	data[eMLZ][i] = motionVelocity.linear.z;
+		data[eMAX][i] = motionVelocity.angular.x;	data[eMAY][i] = motionVelocity.angular.y;	data[eMAZ][i] = motionVelocity.angular.z;
+		data[eSLX][i] = solverBody.linearVelocity.x;	data[eSLY][i] = solverBody.linearVelocity.y;	data[eSLZ][i] = solverBody.linearVelocity.z;
+		data[eSAX][i] = solverBody.angularState.x;	data[eSAY][i] = solverBody.angularState.y;	data[eSAZ][i] = solverBody.angularState.z;
+		data[eI00][i] = m.column0.x;	data[eI10][i] = m.column0.y;	data[eI20][i] = m.column0.z;
+		data[eI01][i] = m.column1.x;	data[eI11][i] = m.column1.y;	data[eI21][i] = m.column1.z;
+		data[eI02][i] = m.column2.x;	data[eI12][i] = m.column2.y;	data[eI22][i] = m.column2.z;
+		data[ePX][i] = bodyData.body2World.p.x;	data[ePY][i] = bodyData.body2World.p.y;	data[ePZ][i] = bodyData.body2World.p.z;
+		data[eQX][i] = bodyData.body2World.q.x;	data[eQY][i] = bodyData.body2World.q.y;	data[eQZ][i] = bodyData.body2World.q.z;	data[eQW][i] = bodyData.body2World.q.w;
+	}
+
+	const Vec4V dtV = V4Load(dt);
+	const Vec4V zero = V4Zero();
+
+	const Vec4V i00 = V4LoadA(data[eI00]);	const Vec4V i01 = V4LoadA(data[eI01]);	const Vec4V i02 = V4LoadA(data[eI02]);
+	const Vec4V i10 = V4LoadA(data[eI10]);	const Vec4V i11 = V4LoadA(data[eI11]);	const Vec4V i12 = V4LoadA(data[eI12]);
+	const Vec4V i20 = V4LoadA(data[eI20]);	const Vec4V i21 = V4LoadA(data[eI21]);	const Vec4V i22 = V4LoadA(data[eI22]);
+
+	// Integrate linear part
+	const Vec4V lx = V4LoadA(data[eLX]);	const Vec4V ly = V4LoadA(data[eLY]);	const Vec4V lz = V4LoadA(data[eLZ]);
+	const Vec4V linMotionVelX = V4Add(lx, V4LoadA(data[eMLX]));
+	const Vec4V linMotionVelY = V4Add(ly, V4LoadA(data[eMLY]));
+	const Vec4V linMotionVelZ = V4Add(lz, V4LoadA(data[eMLZ]));
+	V4StoreA(V4MulAdd(linMotionVelX, dtV, V4LoadA(data[ePX])), data[ePX]);
+	V4StoreA(V4MulAdd(linMotionVelY, dtV, V4LoadA(data[ePY])), data[ePY]);
+	V4StoreA(V4MulAdd(linMotionVelZ, dtV, V4LoadA(data[ePZ])), data[ePZ]);
+
+	const Vec4V ax = V4LoadA(data[eAX]);	const Vec4V ay = V4LoadA(data[eAY]);	const Vec4V az = V4LoadA(data[eAZ]);
+	const Vec4V mvx = V4LoadA(data[eMAX]);	const Vec4V mvy = V4LoadA(data[eMAY]);	const Vec4V mvz = V4LoadA(data[eMAZ]);
+	Vec4V angMotionVelX = V4MulAdd(i02, mvz, V4MulAdd(i01, mvy, V4MulAdd(i00, mvx, ax)));
+	Vec4V angMotionVelY = V4MulAdd(i12, mvz, V4MulAdd(i11, mvy, V4MulAdd(i10, mvx, ay)));
+	Vec4V angMotionVelZ = V4MulAdd(i22, mvz, V4MulAdd(i21, mvy, V4MulAdd(i20, mvx, az)));
+
+	//Store back the linear and angular velocities
+	V4StoreA(V4Add(lx, V4LoadA(data[eSLX])), data[eLX]);
+	V4StoreA(V4Add(ly, V4LoadA(data[eSLY])), data[eLY]);
+	V4StoreA(V4Add(lz, V4LoadA(data[eSLZ])), data[eLZ]);
+	const Vec4V sax = V4LoadA(data[eSAX]);	const Vec4V say = V4LoadA(data[eSAY]);	const Vec4V saz = V4LoadA(data[eSAZ]);
+	V4StoreA(V4MulAdd(i02, saz, V4MulAdd(i01, say, V4MulAdd(i00, sax, ax))), data[eAX]);
+	V4StoreA(V4MulAdd(i12, saz, V4MulAdd(i11, say, V4MulAdd(i10, sax, ay))), data[eAY]);
+	V4StoreA(V4MulAdd(i22, saz, V4MulAdd(i21, say, V4MulAdd(i20, sax, az))), data[eAZ]);
+
+	// Integrate the rotation using closed form quaternion integrator. The bodies that do not rotate keep their quaternion,
+	// their lanes run with w = 1 to stay finite.
+	const Vec4V w2 = V4MulAdd(angMotionVelZ, angMotionVelZ, V4MulAdd(angMotionVelY, angMotionVelY, V4Mul(angMotionVelX, angMotionVelX)));
+	const BoolV rotates = V4IsGrtr(w2, zero);
+	const Vec4V one = V4One();
+	const Vec4V wUnclamped = V4Sqrt(V4Sel(rotates, w2, one));
+
+	//just clamp motionVel to half float-range
+	const Vec4V maxW = V4Load(1e+7f);		//Should be about sqrt(PX_MAX_REAL/2) or smaller
+	const Vec4V w = V4Min(wUnclamped, maxW);
+	const Vec4V clampScale = V4Div(w, wUnclamped);
+	angMotionVelX = V4Mul(angMotionVelX, clampScale);
+	angMotionVelY = V4Mul(angMotionVelY, clampScale);
+	angMotionVelZ = V4Mul(angMotionVelZ, clampScale);
+
+	const Vec4V v = V4Mul(V4Mul(dtV, w), V4Load(0.5f));
+	const Vec4V s = V4Div(V4Sin(v), w);
+	const Vec4V c = V4Cos(v);
+
+	const Vec4V px = V4Mul(angMotionVelX, s);
+	const Vec4V py = V4Mul(angMotionVelY, s);
+	const Vec4V pz = V4Mul(angMotionVelZ, s);
+
+	const Vec4V qx = V4LoadA(data[eQX]);	const Vec4V qy = V4LoadA(data[eQY]);	const Vec4V qz = V4LoadA(data[eQZ]);	const Vec4V qw = V4LoadA(data[eQW]);
+
+	// result = PxQuat(px, py, pz, 0) * q + q * c
+	const Vec4V rx = V4MulAdd(qx, c, V4Sub(V4MulAdd(qw, px, V4Mul(py, qz)), V4Mul(qy, pz)));
+	const Vec4V ry = V4MulAdd(qy, c, V4Sub(V4MulAdd(qw, py, V4Mul(pz, qx)), V4Mul(qz, px)));
+	const Vec4V rz = V4MulAdd(qz, c, V4Sub(V4MulAdd(qw, pz, V4Mul(px, qy)), V4Mul(qx, py)));
+	const Vec4V rw = V4Sub(V4Mul(qw, c), V4MulAdd(pz, qz, V4MulAdd(py, qy, V4Mul(px, qx))));
+
+	const Vec4V invLength = V4Recip(V4Sqrt(V4MulAdd(rw, rw, V4MulAdd(rz, rz, V4MulAdd(ry, ry, V4Mul(rx, rx))))));
+	V4StoreA(V4Sel(rotates, V4Mul(rx, invLength), qx), data[eQX]);
+	V4StoreA(V4Sel(rotates, V4Mul(ry, invLength), qy), data[eQY]);
+	V4StoreA(V4Sel(rotates, V4Mul(rz, invLength), qz), data[eQZ]);
+	V4StoreA(V4Sel(rotates, V4Mul(rw, invLength), qw), data[eQW]);
+
+	V4StoreA(linMotionVelX, data[eMLX]);	V4StoreA(linMotionVelY, data[eMLY]);	V4StoreA(linMotionVelZ, data[eMLZ]);
+	V4StoreA(angMotionVelX, data[eMAX]);	V4StoreA(angMotionVelY, data[eMAY]);	V4StoreA(angMotionVelZ, data[eMAZ]);
+
+	for(PxU32 i=0;i<4;i++)
+	{
+		Cm::SpatialVector& motionVelocity = motionVelocities[i];
+		PxSolverBodyData& bodyData = solverBodyData[i];
+
+		bodyData.linearVelocity = PxVec3(data[eLX][i], data[eLY][i], data[eLZ][i]);
+		bodyData.angularVelocity = PxVec3(data[eAX][i], data[eAY][i], data[eAZ][i]);
+		bodyData.body2World.p = PxVec3(data[ePX][i], data[ePY][i], data[ePZ][i]);
+		bodyData.body2World.q = PxQuat(data[eQX][i], data[eQY][i], data[eQZ][i], data[eQW][i]);
+		PX_ASSERT(bodyData.body2World.p.isFinite());
+		PX_ASSERT(bodyData.body2World.q.isSane());
+
+		motionVelocity.linear = PxVec3(data[eMLX][i], data[eMLY][i], data[eMLZ][i]);
+		motionVelocity.angular = PxVec3(data[eMAX][i], data[eMAY][i], data[eMAZ][i]);
+	}
+}
+
 
 PX_FORCE_INLINE PxReal updateWakeCounter(PxsRigidBody* originalBody, PxReal dt, PxReal /*invDt*/, const bool enableStabilization, const bool useAdaptiveForce, Cm::SpatialVector& motionVelocity,
 	bool hasStaticTouch)
@@ -321,6 +321,166 @@ void classifyConstraintDesc(const PxSolverConstraintDesc* PX_RESTRICT descs, con
 
 }
 
+// Graph coloring alternative to classifyConstraintDesc, see PxSceneFlag::eENABLE_BALANCED_PARTITIONS. The dynamic constraints are
+// colored in decreasing order of the constraint count of their most constrained body, so the bodies needing the most partitions get
+// them first and the constraints of the other bodies fill the gaps. A constraint goes to the least filled of the open partitions it
+// fits in, a new partition is only opened when all of them already contain one of its bodies. Like in classifyConstraintDesc, the
+// partitions are opened 32 at a time with the per-body masks.
+// Returns the partition of each constraint (unused for the static ones), stored in the scratch buffer.
+template <typename Classification>
+const PxU32* colorConstraintDesc(const PxSolverConstraintDesc* PX_RESTRICT descs, const PxU32 numConstraints, Classification& classification,
+								 const PxU32 numNodes, Ps::Array<PxU32>& numConstraintsPerPartition, Ps::Array<PxU32>& scratch)
+{
+	numConstraintsPerPartition.forceSize_Unsafe(32);
+
+	PxMemZero(numConstraintsPerPartition.begin(), sizeof(PxU32) * 32);
+
+	//degrees, coloring order, partitions, then the buckets of the counting sort
+	scratch.forceSize_Unsafe(0);
+	scratch.resize(numNodes + numConstraints * 3 + 2);
+	PxU32* PX_RESTRICT degrees = scratch.begin();
+	PxU32* PX_RESTRICT order = degrees + numNodes;
+	PxU32* PX_RESTRICT partitions = order + numConstraints;
+	PxU32* PX_RESTRICT buckets = partitions + numConstraints;
+
+	PxMemZero(degrees, sizeof(PxU32) * numNodes);
+	PxMemZero(buckets, sizeof(PxU32) * (numConstraints + 2));
+
+	for(PxU32 i = 0; i < numConstraints; ++i)
+	{
+		const PxSolverConstraintDesc& desc = descs[i];
+		uintptr_t indexA, indexB;
+		bool activeA, activeB;
+		if(classification.classifyConstraint(desc, indexA, indexB, activeA, activeB))
+		{
+			degrees[indexA]++;
+			degrees[indexB]++;
+		}
+		else
+		{
+			//Just count the number of static constraints and store in maxSolverFrictionProgress...
+			if(activeA)
+				desc.bodyA->maxSolverFrictionProgress++;
+			else if(activeB)
+				desc.bodyB->maxSolverFrictionProgress++;
+		}
+	}
+
+	//Stable counting sort on the degrees, highest first
+	const PxU32 noPartition = 0xffffffff;
+	for(PxU32 i = 0; i < numConstraints; ++i)
+	{
+		const PxSolverConstraintDesc& desc = descs[i];
+		uintptr_t indexA, indexB;
+		bool activeA, activeB;
+		if(classification.classifyConstraint(desc, indexA, indexB, activeA, activeB))
+		{
+			const PxU32 degree = PxMin(PxMax(degrees[indexA], degrees[indexB]), numConstraints);
+			partitions[i] = numConstraints - degree;
+			buckets[numConstraints - degree + 1]++;
+		}
+		else
+		{
+			partitions[i] = noPartition;
+		}
+	}
+
+	for(PxU32 b = 1; b < numConstraints + 2; ++b)
+		buckets[b] += buckets[b-1];
+
+	PxU32 numToColor = 0;
+	for(PxU32 i = 0; i < numConstraints; ++i)
+	{
+		if(partitions[i] != noPartition)
+		{
+			order[buckets[partitions[i]]++] = i;
+			numToColor++;
+		}
+	}
+
+	PxU32 partitionStartIndex = 0;
+
+	while(numToColor > 0)
+	{
+		PxU32 numOpenPartitions = 0;
+		PxU32 numLeft = 0;
+
+		for(PxU32 a = 0; a < numToColor; ++a)
+		{
+			const PxU32 i = order[a];
+			const PxSolverConstraintDesc& desc = descs[i];
+			Ps::prefetchLine(descs[order[PxMin(a + 4, numToColor - 1)]].bodyA);
+			Ps::prefetchLine(descs[order[PxMin(a + 4, numToColor - 1)]].bodyB);
+
+			PxU32 partitionsA=desc.bodyA->solverProgress;
+			PxU32 partitionsB=desc.bodyB->solverProgress;
+
+			const PxU32 combinedMask = (~partitionsA & ~partitionsB);
+			if(combinedMask == 0)
+			{
+				//Left for the next 32 partitions
+				order[numLeft++] = i;
+				continue;
+			}
+
+			const PxU32 openMask = numOpenPartitions == MAX_NUM_PARTITIONS ? 0xffffffff : getBit(numOpenPartitions) - 1;
+			PxU32 candidates = combinedMask & openMask;
+			PxU32 availablePartition;
+			if(candidates)
+			{
+				availablePartition = Ps::lowestSetBit(candidates);
+				PxU32 bestCount = numConstraintsPerPartition[partitionStartIndex + availablePartition];
+				candidates &= candidates - 1;
+				while(candidates)
+				{
+					const PxU32 partition = Ps::lowestSetBit(candidates);
+					candidates &= candidates - 1;
+					const PxU32 count = numConstraintsPerPartition[partitionStartIndex + partition];
+					if(count < bestCount)
+					{
+						bestCount = count;
+						availablePartition = partition;
+					}
+				}
+			}
+			else
+			{
+				//The partitions past the open ones are still empty
+				availablePartition = numOpenPartitions++;
+				PX_ASSERT(availablePartition == Ps::lowestSetBit(combinedMask));
+			}
+
+			const PxU32 partitionBit = getBit(availablePartition);
+			partitionsA |= partitionBit;
+			partitionsB |= partitionBit;
+
+			desc.bodyA->solverProgress = partitionsA;
+			desc.bodyB->solverProgress = partitionsB;
+			availablePartition += partitionStartIndex;
+			partitions[i] = availablePartition;
+			numConstraintsPerPartition[availablePartition]++;
+			availablePartition++;
+			desc.bodyA->maxSolverNormalProgress = PxMax(desc.bodyA->maxSolverNormalProgress, PxU16(availablePartition));
+			desc.bodyB->maxSolverNormalProgress = PxMax(desc.bodyB->maxSolverNormalProgress, PxU16(availablePartition));
+		}
+
+		numToColor = numLeft;
+
+		if(numToColor > 0)
+		{
+			classification.clearState();
+
+			partitionStartIndex += 32;
+			numConstraintsPerPartition.resize(32 + numConstraintsPerPartition.size());
+			PxMemZero(numConstraintsPerPartition.begin() + partitionStartIndex, sizeof(PxU32) * 32);
+		}
+	}
+
+	classification.reserveSpaceForStaticConstraints(numConstraintsPerPartition);
+
+	return partitions;
+}
+
 template <typename Classification>
 void writeConstraintDesc(const PxSolverConstraintDesc* PX_RESTRICT descs, const PxU32 numConstraints, Classification& classification,
 						 Ps::Array<PxU32>& accumulatedConstraintsPerPartition, PxSolverConstraintDesc* eaTempConstraintDescriptors,
@@ -426,6 +586,44 @@ void writeConstraintDesc(const PxSolverConstraintDesc* PX_RESTRICT descs, const
 	}
 }
 
+// writeConstraintDesc for the partitions computed by colorConstraintDesc
+template <typename Classification>
+void writeColoredConstraintDesc(const PxSolverConstraintDesc* PX_RESTRICT descs, const PxU32 numConstraints, Classification& classification,
+								Ps::Array<PxU32>& accumulatedConstraintsPerPartition, const PxU32* PX_RESTRICT partitions,
+								PxSolverConstraintDesc* PX_RESTRICT eaOrderedConstraintDesc)
+{
+	const PxSolverConstraintDesc* _desc = descs;
+	const PxU32 numConstraintsMin1 = numConstraints - 1;
+
+	for(PxU32 i = 0; i < numConstraints; ++i, _desc++)
+	{
+		const PxU32 prefetchOffset = PxMin(numConstraintsMin1 - i, 4u);
+		Ps::prefetchLine(_desc[prefetchOffset].constraint);
+		Ps::prefetchLine(_desc[prefetchOffset].bodyA);
+		Ps::prefetchLine(_desc[prefetchOffset].bodyB);
+		Ps::prefetchLine(_desc + 8);
+
+		uintptr_t indexA, indexB;
+		bool activeA, activeB;
+		const bool notContainsStatic = classification.classifyConstraint(*_desc, indexA, indexB, activeA, activeB);
+
+		if(notContainsStatic)
+		{
+			eaOrderedConstraintDesc[accumulatedConstraintsPerPartition[partitions[i]]++] = *_desc;
+		}
+		else
+		{
+			PxU32 index = 0;
+			if(activeA)
+				index = PxU32(_desc->bodyA->maxSolverNormalProgress + _desc->bodyA->maxSolverFrictionProgress++);
+			else if(activeB)
+				index = PxU32(_desc->bodyB->maxSolverNormalProgress + _desc->bodyB->maxSolverFrictionProgress++);
+
+			eaOrderedConstraintDesc[accumulatedConstraintsPerPartition[index]++] = *_desc;
+		}
+	}
+}
+
 }
 
 #define PX_NORMALIZE_PARTITIONS 1
@@ -587,11 +785,19 @@ PxU32 partitionContactConstraints(ConstraintPartitionArgs& args)
 
 	PxU32 numSelfConstraintBlocks=0;
 
+	//The enhanced determinism mode keeps the original partitioning, which doesn't depend on the constraint counts of the bodies
+	const bool balancedPartitions = args.balancedPartitions && !args.enhancedDeterminism;
+	const PxU32* partitions = NULL;
+
 	if(numArticulations == 0)
 	{
 		RigidBodyClassification classification(eaAtoms, numBodies);
-		classifyConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition,
-			eaTempConstraintDescriptors);
+		if(balancedPartitions)
+			partitions = colorConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, numBodies,
+				constraintsPerPartition, *args.mColoringScratch);
+		else
+			classifyConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition,
+				eaTempConstraintDescriptors);
 		
 		PxU32 accumulation = 0;
 		for(PxU32 a = 0; a < constraintsPerPartition.size(); ++a)
@@ -612,8 +818,12 @@ PxU32 partitionContactConstraints(ConstraintPartitionArgs& args)
 			body.maxSolverFrictionProgress = 0;
 		}
 
-		writeConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition, 
-			eaTempConstraintDescriptors, eaOrderedConstraintDescriptors);
+		if(partitions)
+			writeColoredConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition,
+				partitions, eaOrderedConstraintDescriptors);
+		else
+			writeConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition, 
+				eaTempConstraintDescriptors, eaOrderedConstraintDescriptors);
 
 		numOrderedConstraints = numConstraintDescriptors;
 
@@ -638,8 +848,12 @@ PxU32 partitionContactConstraints(ConstraintPartitionArgs& args)
 		}
 		ExtendedRigidBodyClassification classification(eaAtoms, numBodies, eaFsDatas, numArticulations);
 
-		classifyConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, 
-			constraintsPerPartition, eaTempConstraintDescriptors);
+		if(balancedPartitions)
+			partitions = colorConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, numBodies + numArticulations,
+				constraintsPerPartition, *args.mColoringScratch);
+		else
+			classifyConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, 
+				constraintsPerPartition, eaTempConstraintDescriptors);
 
 		PxU32 accumulation = 0;
 		for(PxU32 a = 0; a < constraintsPerPartition.size(); ++a)
@@ -667,8 +881,12 @@ PxU32 partitionContactConstraints(ConstraintPartitionArgs& args)
 			data->maxSolverFrictionProgress = 0;
 		}
 
-		writeConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition, 
-			eaTempConstraintDescriptors, eaOrderedConstraintDescriptors);
+		if(partitions)
+			writeColoredConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition,
+				partitions, eaOrderedConstraintDescriptors);
+		else
+			writeConstraintDesc(eaConstraintDescriptors, numConstraintDescriptors, classification, constraintsPerPartition, 
+				eaTempConstraintDescriptors, eaOrderedConstraintDescriptors);
 
 		numOrderedConstraints = numConstraintDescriptors;
 
@@ -63,8 +63,10 @@ struct ConstraintPartitionArgs
 	Ps::Array<PxU32>*						mConstraintsPerPartition;
 	//Ps::Array<PxU32>*						mStartIndices;
 	Ps::Array<PxU32>*						mBitField;
+	Ps::Array<PxU32>*						mColoringScratch;		//only used with balancedPartitions
 
 	bool									enhancedDeterminism;
+	bool									balancedPartitions;		//graph coloring partitioner, see PxSceneFlag::eENABLE_BALANCED_PARTITIONS
 };
 
 PxU32 partitionContactConstraints(ConstraintPartitionArgs& args);
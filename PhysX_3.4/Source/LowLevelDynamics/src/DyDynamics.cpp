@@ -30,6 +30,7 @@
 
 #include "PsTime.h"
 #include "PsAtomic.h"
+#include "PsParallelSort.h"
 #include "PxvDynamics.h"
 
 #include "foundation/PxProfiler.h"
@@ -49,6 +50,7 @@
 #include "DyArticulation.h"
 
 #include "CmFlushPool.h"
+#include "CmParallelFor.h"
 #include "DyArticulationPImpl.h"
 #include "PxsMaterialManager.h"
 #include "DySolverContactPF4.h"
@@ -188,6 +190,7 @@ DynamicsContext::DynamicsContext(	PxcNpMemBlockPool* memBlockPool,
 	mExceededForceThresholdStream[0] = PX_PLACEMENT_NEW(PX_ALLOC(sizeof(ThresholdStream), PX_DEBUG_EXP("ExceededForceThresholdStream[0]")), ThresholdStream(*allocatorCallback));
 	mExceededForceThresholdStream[1] = PX_PLACEMENT_NEW(PX_ALLOC(sizeof(ThresholdStream), PX_DEBUG_EXP("ExceededForceThresholdStream[1]")), ThresholdStream(*allocatorCallback));
 	mThresholdStreamOut = 0;
+	mNbThresholdPartitions = 0;
 	mCurrentIndex = 0;
 	mWorldSolverBody.linearVelocity = PxVec3(0);
 	mWorldSolverBody.angularState = PxVec3(0);
@@ -229,6 +232,8 @@ DynamicsContext::~DynamicsContext()
 	}
 	mExceededForceThresholdStream[1] = NULL;
 
+	for(PxU32 i = 0; i < mThresholdPartitions.size(); ++i)
+		PX_DELETE(mThresholdPartitions[i]);
 }
 
 #if PX_ENABLE_SIM_STATS
@@ -372,8 +377,7 @@ public:
 							PxU32				numBodies,
 							volatile PxU32*		maxSolverPositionIterations,
 							volatile PxU32*		maxSolverVelocityIterations,
-							const PxU32			startIndex,
-							const PxU32			numToIntegrate,
+							Cm::ParallelForRange* range,
 							const PxVec3&		gravity) :
 		Cm::Task(context.getContextId()),
 		mContext(context),
@@ -386,8 +390,7 @@ public:
 		mNumBodies(numBodies),
 		mMaxSolverPositionIterations(maxSolverPositionIterations),
 		mMaxSolverVelocityIterations(maxSolverVelocityIterations),
-		mStartIndex(startIndex),
-		mNumToIntegrate(numToIntegrate),
+		mRange(range),
 		mGravity(gravity)
 	{}
 
@@ -409,14 +412,55 @@ public:
 	PxU32						mNumBodies;
 	volatile PxU32*				mMaxSolverPositionIterations;
 	volatile PxU32*				mMaxSolverVelocityIterations;
-	PxU32						mStartIndex;
-	PxU32						mNumToIntegrate;
+	Cm::ParallelForRange*		mRange;		// Shared by the tasks of the island, hands out the bodies to integrate
 	PxVec3						mGravity;
 
 };
 
 
 
+// Integrates the bodies 4 at a time (see integrateCore4), then writes the results back to the body cores and updates their sleep state
+static void integrateBodies(Cm::SpatialVector* PX_RESTRICT motionVelocities, PxSolverBody* PX_RESTRICT solverBodies, PxSolverBodyData* PX_RESTRICT solverBodyData,
+	PxsRigidBody** PX_RESTRICT rigidBodies, const PxU32 count, const PxReal dt, const PxReal invDt, const bool enableStabilization, const bool useAdaptiveForce,
+	IG::IslandSim& islandSim)
+{
+	const PxU32 count4 = count & ~3u;
+	for(PxU32 i = 0; i < count; i += 4)
+	{
+		const PxU32 prefetch = PxMin(i+4, count - 1);
+		Ps::prefetchLine(&solverBodyData[prefetch]);
+		Ps::prefetchLine(&solverBodyData[prefetch], 128);
+		Ps::prefetchLine(&solverBodies[prefetch], 128);
+		Ps::prefetchLine(&motionVelocities[prefetch], 128);
+		Ps::prefetchLine(rigidBodies[prefetch]);
+		Ps::prefetchLine(rigidBodies[prefetch], 64);
+
+		const PxU32 nb = PxMin(count - i, 4u);
+		if(i < count4)
+			integrateCore4(motionVelocities + i, solverBodies + i, solverBodyData + i, dt);
+		else
+		{
+			for(PxU32 a = i; a < count; ++a)
+				integrateCore(motionVelocities[a].linear, motionVelocities[a].angular, solverBodies[a], solverBodyData[a], dt);
+		}
+
+		for(PxU32 a = i; a < i + nb; ++a)
+		{
+			const PxSolverBodyData& data = solverBodyData[a];
+
+			PxsRigidBody& rBody = *rigidBodies[a];
+			PxsBodyCore& core = rBody.getCore();
+			rBody.mLastTransform = core.body2World;
+			core.body2World = data.body2World;
+			core.linearVelocity = data.linearVelocity;
+			core.angularVelocity = data.angularVelocity;
+
+			const bool hasStaticTouch = islandSim.getIslandStaticTouchCount(IG::NodeIndex(data.nodeIndex)) != 0;
+			sleepCheck(rigidBodies[a], dt, invDt, enableStabilization, useAdaptiveForce, motionVelocities[a], hasStaticTouch);
+		}
+	}
+}
+
 class PxsParallelSolverTask : public Cm::Task
 {
 	PxsParallelSolverTask& operator=(PxsParallelSolverTask&);
@@ -604,108 +648,303 @@ public:
 	PxsContactManagerOutputIterator& mOutputs;
 };
 
-class PxsForceThresholdTask  : public Cm::Task
+// Accumulates the forces of the threshold stream elements (the nbIndices ones listed in indices, or all of them) per body pair. The pairs
+// above their threshold are copied to exceeded with their accumulated force. Then the pairs that started or stopped exceeding it since the
+// previous exceeded force stream (again the listed elements, or all of them), or still do, are copied to forceChanged.
+// preMask has one entry per element of the previous stream, and is only written for the listed ones.
+template<class Stream>
+static void createForceChangeThresholdStream(ThresholdTable& thresholdTable, ThresholdStream& thresholdStream, const PxU32* indices, PxU32 nbIndices,
+	const ThresholdStream& preExceededForceThresholdStream, const PxU32* preIndices, PxU32 nbPreIndices, PxU32* preMask, Ps::Array<PxU32>& curMask,
+	PxReal dt, Stream& curExceededForceThresholdStream, Stream& forceChangeThresholdStream)
+{
+	thresholdTable.build(thresholdStream, indices, nbIndices);
+
+	//fill in the currrent exceeded force threshold stream
+	curExceededForceThresholdStream.forceSize_Unsafe(0);
+	for(PxU32 i=0; i<thresholdTable.mPairsSize; ++i)
+	{
+		ThresholdTable::Pair& pair = thresholdTable.mPairs[i];
+		ThresholdStreamElement& elem = thresholdStream[pair.thresholdStreamIndex];
+		if(pair.accumulatedForce > elem.threshold * dt)
+		{
+			elem.accumulatedForce = pair.accumulatedForce;
+			curExceededForceThresholdStream.pushBack(elem);
+		}
+	}
+
+	forceChangeThresholdStream.forceSize_Unsafe(0);
+
+	const PxU32 nbCurExceededForce = curExceededForceThresholdStream.size();
+
+	//generate force change thresholdStream
+	if(nbPreIndices)
+	{
+		thresholdTable.build(preExceededForceThresholdStream, preIndices, nbPreIndices);
+
+		//initialize the force change masks
+		for(PxU32 i=0; i<nbPreIndices; ++i)
+			preMask[preIndices ? preIndices[i] : i] = 1;
+
+		curMask.reserve(nbCurExceededForce);
+		curMask.forceSize_Unsafe(nbCurExceededForce);
+		for(PxU32 i=0; i<nbCurExceededForce; ++i)
+			curMask[i] = 1;
+
+		for(PxU32 i=0; i< nbCurExceededForce; ++i)
+		{
+			const ThresholdStreamElement& curElem = curExceededForceThresholdStream[i];
+
+			PxU32 pos;
+			if(thresholdTable.check(preExceededForceThresholdStream, curElem, pos))
+			{
+				preMask[pos] = 0;
+				curMask[i] = 0;
+			}
+		}
+
+		//create force change threshold stream: lost and persistent pairs first, then the new ones
+		for(PxU32 i=0; i<nbPreIndices; ++i)
+		{
+			const PxU32 index = preIndices ? preIndices[i] : i;
+			ThresholdStreamElement elt = preExceededForceThresholdStream[index];
+			if(preMask[index])
+				elt.accumulatedForce = 0.f;
+			forceChangeThresholdStream.pushBack(elt);
+		}
+
+		for(PxU32 i=0; i<nbCurExceededForce; ++i)
+		{
+			if(curMask[i])
+				forceChangeThresholdStream.pushBack(curExceededForceThresholdStream[i]);
+		}
+	}
+	else
+	{
+		forceChangeThresholdStream.reserve(nbCurExceededForce);
+		forceChangeThresholdStream.forceSize_Unsafe(nbCurExceededForce);
+		PxMemCopy(forceChangeThresholdStream.begin(), curExceededForceThresholdStream.begin(), sizeof(ThresholdStreamElement) * nbCurExceededForce);
+	}
+}
+
+// Partition of a body pair of the threshold stream. The high bits of the hash are used, as the tables of the partitions index theirs with the low bits
+static PX_FORCE_INLINE PxU32 getThresholdPartition(const ThresholdStreamElement& elem, PxU32 nbPartitions)
+{
+	return PxU32((PxU64(Ps::hash(PxU64(elem.nodeIndexA)<<32 | PxU64(elem.nodeIndexB))) * nbPartitions) >> 32);
+}
+
+// Assigns the elements of a range of the threshold stream to their partition
+class PxsForceThresholdPartitionIdsTask : public Cm::Task
 {
 	DynamicsContext&		mDynamicsContext;
+	Cm::ParallelForRange&	mRange;
 
-	PxsForceThresholdTask& operator=(const PxsForceThresholdTask&);
+	PX_NOCOPY(PxsForceThresholdPartitionIdsTask)
 public:
 
-	PxsForceThresholdTask(DynamicsContext& context) : Cm::Task(context.getContextId()), mDynamicsContext(context) 
+	PxsForceThresholdPartitionIdsTask(DynamicsContext& context, Cm::ParallelForRange& range) : Cm::Task(context.getContextId()), mDynamicsContext(context), mRange(range)
 	{
 	}
 
-	void createForceChangeThresholdStream()
+	virtual void runInternal()
+	{
+		const ThresholdStream& thresholdStream = mDynamicsContext.getThresholdStream();
+		PxU8* PX_RESTRICT partitionIds = mDynamicsContext.mThresholdPartitionIds.begin();
+		const PxU32 nbPartitions = mDynamicsContext.mNbThresholdPartitions;
+
+		PxU32 start, nb;
+		while(mRange.claim(start, nb))
+		{
+			for(PxU32 i=start; i<start+nb; ++i)
+				partitionIds[i] = PxU8(getThresholdPartition(thresholdStream[i], nbPartitions));
+		}
+	}
+
+	virtual const char* getName() const { return "PxsDynamics.forceThresholdPartitionIds"; }
+
+	static const PxU32 MinElements = 1024;
+	static const PxU32 MaxElements = 8192;
+};
+
+// Accumulates the forces and compares them with the previous frame for one partition
+class PxsForceThresholdPartitionTask : public Cm::Task
+{
+	DynamicsContext&		mDynamicsContext;
+	PxU32					mPartition;
+
+	PX_NOCOPY(PxsForceThresholdPartitionTask)
+public:
+
+	PxsForceThresholdPartitionTask(DynamicsContext& context, PxU32 partition) : Cm::Task(context.getContextId()), mDynamicsContext(context), mPartition(partition)
+	{
+	}
+
+	virtual void runInternal()
 	{
+		DynamicsContext::ThresholdPartition& partition = *mDynamicsContext.mThresholdPartitions[mPartition];
 		ThresholdStream& thresholdStream = mDynamicsContext.getThresholdStream();
-		//bool haveThresholding = thresholdStream.size()!=0;
+		const ThresholdStream& preExceededForceThresholdStream = *mDynamicsContext.mExceededForceThresholdStream[1 - mDynamicsContext.mCurrentIndex];
+		const PxU32 nbPartitions = mDynamicsContext.mNbThresholdPartitions;
+
+		// the elements keep the order of the stream, so the merged result doesn't depend on the number of workers for a given stream
+		const PxU8* PX_RESTRICT partitionIds = mDynamicsContext.mThresholdPartitionIds.begin();
+		const PxU32 nbElements = thresholdStream.size();
+		partition.mIndices.forceSize_Unsafe(0);
+		for(PxU32 i=0; i<nbElements; ++i)
+		{
+			if(partitionIds[i] == mPartition)
+				partition.mIndices.pushBack(i);
+		}
 
-		ThresholdTable& thresholdTable = mDynamicsContext.getThresholdTable();
-		thresholdTable.build(thresholdStream);
+		// The previous exceeded stream only has the pairs above their threshold, so it is small enough to be partitioned here
+		const PxU32 nbPreExceededForce = preExceededForceThresholdStream.size();
+		partition.mPreIndices.forceSize_Unsafe(0);
+		for(PxU32 i=0; i<nbPreExceededForce; ++i)
+		{
+			if(getThresholdPartition(preExceededForceThresholdStream[i], nbPartitions) == mPartition)
+				partition.mPreIndices.pushBack(i);
+		}
 
-		//generate current force exceeded threshold stream
-		ThresholdStream& curExceededForceThresholdStream = *mDynamicsContext.mExceededForceThresholdStream[mDynamicsContext.mCurrentIndex];
-		ThresholdStream& preExceededForceThresholdStream = *mDynamicsContext.mExceededForceThresholdStream[1 - mDynamicsContext.mCurrentIndex];
-		curExceededForceThresholdStream.forceSize_Unsafe(0);
+		createForceChangeThresholdStream(partition.mTable, thresholdStream, partition.mIndices.begin(), partition.mIndices.size(),
+			preExceededForceThresholdStream, partition.mPreIndices.begin(), partition.mPreIndices.size(), mDynamicsContext.mExceededForceThresholdStreamMask.begin(),
+			partition.mMask, mDynamicsContext.mDt, partition.mExceeded, partition.mForceChanged);
+	}
+
+	virtual const char* getName() const { return "PxsDynamics.forceThresholdPartition"; }
+};
+
+// Spawns the partition tasks once every element has its partition
+class PxsForceThresholdPartitionLaunchTask : public Cm::Task
+{
+	DynamicsContext&		mDynamicsContext;
+
+	PX_NOCOPY(PxsForceThresholdPartitionLaunchTask)
+public:
 
-		//fill in the currrent exceeded force threshold stream
-		for(PxU32 i=0; i<thresholdTable.mPairsSize; ++i)
+	PxsForceThresholdPartitionLaunchTask(DynamicsContext& context) : Cm::Task(context.getContextId()), mDynamicsContext(context)
+	{
+	}
+
+	virtual void runInternal()
+	{
+		for(PxU32 i=0; i<mDynamicsContext.mNbThresholdPartitions; ++i)
 		{
-			ThresholdTable::Pair& pair = thresholdTable.mPairs[i];
-			ThresholdStreamElement& elem = thresholdStream[pair.thresholdStreamIndex];
-			if(pair.accumulatedForce > elem.threshold * mDynamicsContext.mDt)
-			{
-				elem.accumulatedForce = pair.accumulatedForce;
-				curExceededForceThresholdStream.pushBack(elem);
-			}
+			PxsForceThresholdPartitionTask* task = PX_PLACEMENT_NEW(mDynamicsContext.getTaskPool().allocate(sizeof(PxsForceThresholdPartitionTask)), PxsForceThresholdPartitionTask)(mDynamicsContext, i);
+			task->setContinuation(mCont);
+			task->removeReference();
 		}
+	}
+
+	virtual const char* getName() const { return "PxsDynamics.forceThresholdPartitionLaunch"; }
+};
+
+// Concatenates the results of the partitions
+class PxsForceThresholdMergeTask : public Cm::Task
+{
+	DynamicsContext&		mDynamicsContext;
 
+	PX_NOCOPY(PxsForceThresholdMergeTask)
+public:
+
+	PxsForceThresholdMergeTask(DynamicsContext& context) : Cm::Task(context.getContextId()), mDynamicsContext(context)
+	{
+	}
+
+	virtual void runInternal()
+	{
+		ThresholdStream& curExceededForceThresholdStream = *mDynamicsContext.mExceededForceThresholdStream[mDynamicsContext.mCurrentIndex];
 		ThresholdStream& forceChangeThresholdStream = mDynamicsContext.getForceChangedThresholdStream();
-		forceChangeThresholdStream.forceSize_Unsafe(0);
+
+		PxU32 nbExceeded = 0, nbForceChanged = 0;
+		for(PxU32 i=0; i<mDynamicsContext.mNbThresholdPartitions; ++i)
+		{
+			nbExceeded += mDynamicsContext.mThresholdPartitions[i]->mExceeded.size();
+			nbForceChanged += mDynamicsContext.mThresholdPartitions[i]->mForceChanged.size();
+		}
+
+		curExceededForceThresholdStream.reserve(nbExceeded);
+		curExceededForceThresholdStream.forceSize_Unsafe(nbExceeded);
+		forceChangeThresholdStream.reserve(nbForceChanged);
+		forceChangeThresholdStream.forceSize_Unsafe(nbForceChanged);
+
+		nbExceeded = nbForceChanged = 0;
+		for(PxU32 i=0; i<mDynamicsContext.mNbThresholdPartitions; ++i)
+		{
+			const DynamicsContext::ThresholdPartition& partition = *mDynamicsContext.mThresholdPartitions[i];
+			PxMemCopy(curExceededForceThresholdStream.begin() + nbExceeded, partition.mExceeded.begin(), sizeof(ThresholdStreamElement) * partition.mExceeded.size());
+			PxMemCopy(forceChangeThresholdStream.begin() + nbForceChanged, partition.mForceChanged.begin(), sizeof(ThresholdStreamElement) * partition.mForceChanged.size());
+			nbExceeded += partition.mExceeded.size();
+			nbForceChanged += partition.mForceChanged.size();
+		}
+	}
+
+	virtual const char* getName() const { return "PxsDynamics.forceThresholdMerge"; }
+};
+
+class PxsForceThresholdTask  : public Cm::Task
+{
+	DynamicsContext&		mDynamicsContext;
+
+	PxsForceThresholdTask& operator=(const PxsForceThresholdTask&);
+public:
+
+	PxsForceThresholdTask(DynamicsContext& context) : Cm::Task(context.getContextId()), mDynamicsContext(context) 
+	{
+	}
+
+	// below this many elements the stream is processed by this task alone
+	static const PxU32 MinParallelElements = 4096;
+	static const PxU32 MinPartitionElements = 2048;
+	static const PxU32 MaxPartitions = 16;
+
+	void createForceChangeThresholdStream()
+	{
+		ThresholdStream& thresholdStream = mDynamicsContext.getThresholdStream();
+		ThresholdStream& curExceededForceThresholdStream = *mDynamicsContext.mExceededForceThresholdStream[mDynamicsContext.mCurrentIndex];
+		const ThresholdStream& preExceededForceThresholdStream = *mDynamicsContext.mExceededForceThresholdStream[1 - mDynamicsContext.mCurrentIndex];
 		Ps::Array<PxU32>& forceChangeMask = mDynamicsContext.mExceededForceThresholdStreamMask;
 
 		const PxU32 nbPreExceededForce = preExceededForceThresholdStream.size();
-		const PxU32 nbCurExceededForce = curExceededForceThresholdStream.size();
+		forceChangeMask.reserve(nbPreExceededForce);
+		forceChangeMask.forceSize_Unsafe(nbPreExceededForce);
 
-		//generate force change thresholdStream
-		if(nbPreExceededForce)
+		const PxU32 nbElements = thresholdStream.size();
+		const PxU32 nbPartitions = nbElements >= MinParallelElements ? PxMin(Cm::getParallelForTaskCount(nbElements, mDynamicsContext.mTaskManager, MinPartitionElements), MaxPartitions) : 1;
+		if(nbPartitions <= 1)
 		{
-			thresholdTable.build(preExceededForceThresholdStream);
+			Dy::createForceChangeThresholdStream(mDynamicsContext.getThresholdTable(), thresholdStream, NULL, nbElements, preExceededForceThresholdStream, NULL, nbPreExceededForce,
+				forceChangeMask.begin(), mDynamicsContext.mExceededForceThresholdStreamCurrentMask, mDynamicsContext.mDt, curExceededForceThresholdStream, mDynamicsContext.getForceChangedThresholdStream());
+			return;
+		}
 
-			//set force change mask
-			const PxU32 nbTotalExceededForce = nbPreExceededForce + nbCurExceededForce;
-			forceChangeMask.reserve(nbTotalExceededForce);
-			forceChangeMask.forceSize_Unsafe(nbTotalExceededForce);
-			
-			//initialize the forceChangeMask
-			for (PxU32 i = 0; i < nbTotalExceededForce; ++i)
-				forceChangeMask[i] = 1;
+		// Large streams are partitioned by body pair, each partition building its own table in parallel (see PxsForceThresholdPartitionTask).
+		// The partitions are then concatenated, which only moves the pairs above their threshold
+		while(mDynamicsContext.mThresholdPartitions.size() < nbPartitions)
+			mDynamicsContext.mThresholdPartitions.pushBack(PX_NEW(DynamicsContext::ThresholdPartition));
+		mDynamicsContext.mNbThresholdPartitions = nbPartitions;
+		mDynamicsContext.mThresholdPartitionIds.reserve(nbElements);
+		mDynamicsContext.mThresholdPartitionIds.forceSize_Unsafe(nbElements);
 
-			for(PxU32 i=0; i< nbCurExceededForce; ++i)
-			{
-				ThresholdStreamElement& curElem = curExceededForceThresholdStream[i];
-				
-				PxU32 pos;
-				if(thresholdTable.check(preExceededForceThresholdStream, curElem, pos))
-				{
-					forceChangeMask[pos] = 0;
-					forceChangeMask[i + nbPreExceededForce] = 0;
-				}
-			}
+		Cm::FlushPool& taskPool = mDynamicsContext.getTaskPool();
 
-			//create force change threshold stream
-			for(PxU32 i=0; i<nbTotalExceededForce; ++i)
-			{
-				const PxU32 hasForceChange = forceChangeMask[i];
-				if(hasForceChange)
-				{
-					bool lostPair = (i < nbPreExceededForce);
-					ThresholdStreamElement& elem = lostPair ?  preExceededForceThresholdStream[i] : curExceededForceThresholdStream[i - nbPreExceededForce];
-					ThresholdStreamElement elt;
-					elt = elem;
-					elt.accumulatedForce = lostPair ? 0.f : elem.accumulatedForce;
-					forceChangeThresholdStream.pushBack(elt);
-				}
-				else
-				{
-					//persistent pair
-					if (i < nbPreExceededForce)
-					{
-						ThresholdStreamElement& elem = preExceededForceThresholdStream[i];
-						ThresholdStreamElement elt;
-						elt = elem;
-						elt.accumulatedForce = elem.accumulatedForce;
-						forceChangeThresholdStream.pushBack(elt);
-					}
-				}
-			}
-		}
-		else
+		PxsForceThresholdMergeTask* mergeTask = PX_PLACEMENT_NEW(taskPool.allocate(sizeof(PxsForceThresholdMergeTask)), PxsForceThresholdMergeTask)(mDynamicsContext);
+		mergeTask->setContinuation(mCont);
+
+		PxsForceThresholdPartitionLaunchTask* launchTask = PX_PLACEMENT_NEW(taskPool.allocate(sizeof(PxsForceThresholdPartitionLaunchTask)), PxsForceThresholdPartitionLaunchTask)(mDynamicsContext);
+		launchTask->setContinuation(mergeTask);
+
+		const PxU32 nbIdsTasks = Cm::getParallelForTaskCount(nbElements, mDynamicsContext.mTaskManager, PxsForceThresholdPartitionIdsTask::MinElements);
+		Cm::ParallelForRange* range = PX_PLACEMENT_NEW(taskPool.allocate(sizeof(Cm::ParallelForRange)), Cm::ParallelForRange)();
+		range->init(nbElements, nbIdsTasks, PxsForceThresholdPartitionIdsTask::MinElements, PxsForceThresholdPartitionIdsTask::MaxElements);
+
+		for(PxU32 i=0; i<nbIdsTasks; ++i)
 		{
-			forceChangeThresholdStream.reserve(nbCurExceededForce);
-			forceChangeThresholdStream.forceSize_Unsafe(nbCurExceededForce);
-			PxMemCopy(forceChangeThresholdStream.begin(), curExceededForceThresholdStream.begin(), sizeof(ThresholdStreamElement) * nbCurExceededForce);
+			PxsForceThresholdPartitionIdsTask* idsTask = PX_PLACEMENT_NEW(taskPool.allocate(sizeof(PxsForceThresholdPartitionIdsTask)), PxsForceThresholdPartitionIdsTask)(mDynamicsContext, *range);
+			idsTask->setContinuation(launchTask);
+			idsTask->removeReference();
 		}
+
+		launchTask->removeReference();
+		mergeTask->removeReference();
 	}
 
 	virtual void runInternal()
@@ -726,6 +965,14 @@ struct ConstraintLess
 	}
 };
 
+struct ArticulationTopologyPredicate
+{
+	bool operator()(const Articulation* left, const Articulation* right) const
+	{
+		return left->getTopologyKey() < right->getTopologyKey();
+	}
+};
+
 struct ArticulationSortPredicate
 {
 	bool operator()(const PxsIndexedContactManager*& left, const PxsIndexedContactManager*& right) const
@@ -749,7 +996,8 @@ class SolverArticulationUpdateTask : public Cm::Task
 
 public:
 
-	static const PxU32 NbArticulationsPerTask = 8;
+	//Tasks are filled up to this many links, so they get a few big articulations or many small ones
+	static const PxU32 NbLinksPerTask = 128;
 
 	SolverArticulationUpdateTask(ThreadContext& islandThreadContext, Articulation** articulations, ArticulationSolverDesc* articulationDescArray, PxU32 nbToProcess, Dy::DynamicsContext& context,
 		PxU32 startIdx):
@@ -926,6 +1174,14 @@ public:
 				Ps::sort(nodeIndexArray, bodyIndex);
 			}
 
+			//Articulations built from the same rig (ragdoll crowds) are put next to each other, so the update tasks and the
+			//solver go through identical data layouts and loop counts back to back. The articulations are solved independently of
+			//each other, so the order doesn't change the results.
+			if (articIndex > 1)
+			{
+				Ps::sort(articulationPtr, articIndex, ArticulationTopologyPredicate());
+			}
+
 			for (PxU32 a = 0; a < bodyIndex; ++a)
 			{
 				IG::NodeIndex currentIndex(nodeIndexArray[a]);
@@ -1024,7 +1280,8 @@ public:
 
 			if (mEnhancedDeterminism)
 			{
-				Ps::sort(indexedManagers, currentContactIndex, EnhancedSortPredicate());
+				// stable, the order can't depend on the number of workers sorting a large island
+				Ps::parallelSort(indexedManagers, currentContactIndex, EnhancedSortPredicate(), getTaskManager()->getCpuDispatcher(), true);
 			}
 
 			mIslandContext.mCounts.contactManagers = currentContactIndex;
@@ -1061,12 +1318,21 @@ public:
 		ThreadContext& mThreadContext = *mIslandContext.mThreadContext;
 		ArticulationSolverDesc* articulationDescArray = mThreadContext.getArticulations().begin();
 
-		for(PxU32 i=0;i<mIslandContext.mCounts.articulations; i+= SolverArticulationUpdateTask::NbArticulationsPerTask)
+		const PxU32 nbArticulations = mIslandContext.mCounts.articulations;
+		for(PxU32 i=0;i<nbArticulations;)
 		{
+			PxU32 nbToProcess = 0, nbLinks = 0;
+			do
+			{
+				nbLinks += mObjects.articulations[i + nbToProcess]->getBodyCount();
+				nbToProcess++;
+			}
+			while(i + nbToProcess < nbArticulations && nbLinks < SolverArticulationUpdateTask::NbLinksPerTask);
 
 			SolverArticulationUpdateTask* task = PX_PLACEMENT_NEW(mContext.getTaskPool().allocate(sizeof(SolverArticulationUpdateTask)), SolverArticulationUpdateTask)(mThreadContext, 
-				&mObjects.articulations[i], &articulationDescArray[i], PxMin(SolverArticulationUpdateTask::NbArticulationsPerTask, mIslandContext.mCounts.articulations - i), mContext,
+				&mObjects.articulations[i], &articulationDescArray[i], nbToProcess, mContext,
 				i*DY_ARTICULATION_MAX_SIZE);
+			i += nbToProcess;
 
 			task->setContinuation(mCont);
 			task->removeReference();
@@ -1363,7 +1629,13 @@ public:
 
 	virtual void runInternal()
 	{
+		//The start time, turned into the duration of the chain by the end task
+		if(mIslandContext.mCost)
+			mIslandContext.mCost->time = Ps::Time::getCurrentCounterValue();
+
 		startTasks();
+		if(mIslandContext.mCost && mIslandContext.mCounts.bodies)
+			mIslandContext.mCost->body = mObjects.bodies[0];
 		integrate();
 		setupDescTask();
 		articulationTask();
@@ -1462,7 +1734,9 @@ public:
 				args.mNumDifferentBodyConstraints = args.mNumSelfConstraints = args.mNumSelfConstraintBlocks = 0;
 				args.mConstraintsPerPartition = &mThreadContext.mConstraintsPerPartition;
 				args.mBitField = &mThreadContext.mPartitionNormalizationBitmap;
+				args.mColoringScratch = &mThreadContext.mPartitionColoringScratch;
 				args.enhancedDeterminism = mEnhancedDeterminism;
+				args.balancedPartitions = mContext.getBalancedPartitions();
 				
 				mThreadContext.mMaxPartitions = partitionContactConstraints(args);
 				mThreadContext.mNumDifferentBodyConstraints = args.mNumDifferentBodyConstraints;
@@ -1761,6 +2035,7 @@ public:
 				SolverIslandParams& params = *reinterpret_cast<SolverIslandParams*>(mContext.getTaskPool().allocate(sizeof(SolverIslandParams)));
 				params.positionIterations = mThreadContext.mMaxSolverPositionIterations;
 				params.velocityIterations = mThreadContext.mMaxSolverVelocityIterations;
+				params.convergenceThreshold = mContext.getSolverConvergenceThreshold();
 				params.bodyListStart = solverBodies;
 				params.bodyDataList = solverBodyDatas;
 				params.solverBodyOffset = mSolverBodyOffset;
@@ -1772,7 +2047,6 @@ public:
 				params.constraintIndex2 = 0;
 				params.bodyListIndex = 0;
 				params.bodyListIndex2 = 0;
-				params.bodyIntegrationListIndex = 0;
 				params.thresholdStream = mContext.getThresholdStream().begin();
 				params.thresholdStreamLength = mContext.getThresholdStream().size();
 				params.outThresholdPairs = thresholdPairsOut;
@@ -1802,6 +2076,7 @@ public:
 					const PxU32 idealBatchSize = PxMax(unrollSize, idealThreads*unrollSize/(numTasks*2));
 
 					params.batchSize = idealBatchSize; //assigning ideal batch size for the solver to grab work at. Only needed by the multi-threaded island solver.
+					params.bodyIntegrationRange.init(mIslandContext.mCounts.articulations + mIslandContext.mCounts.bodies, numTasks, 16, 128);
 
 					for(PxU32 a = 1; a < numTasks; ++a)
 					{
@@ -1834,33 +2109,8 @@ public:
 					//Only one task - a small island so do a sequential solve (avoid the atomic overheads)
 					solveVBlock(mContext.mSolverCore[mContext.getFrictionType()], params);
 
-					const PxU32 bodyCountMin1 = mIslandContext.mCounts.bodies - 1u;
-					PxSolverBodyData* solverBodyData2 = solverBodyDatas + mSolverBodyOffset + 1;
-					for(PxU32 k=0; k < mIslandContext.mCounts.bodies; k++)
-					{
-						const PxU32 prefetchAddress = PxMin(k+4, bodyCountMin1);
-						Ps::prefetchLine(mThreadContext.mBodyCoreArray[prefetchAddress]);
-						Ps::prefetchLine(&mThreadContext.motionVelocityArray[k], 128);
-						Ps::prefetchLine(&mThreadContext.mBodyCoreArray[prefetchAddress], 128);
-						Ps::prefetchLine(&mObjects.bodies[prefetchAddress]);
-
-						PxSolverBodyData& solverBodyData = solverBodyData2[k];
-
-						integrateCore(mThreadContext.motionVelocityArray[k].linear, mThreadContext.motionVelocityArray[k].angular,
-							solverBodies[k], solverBodyData, mContext.mDt);
-
-						PxsRigidBody& rBody = *mObjects.bodies[k];
-						PxsBodyCore& core = rBody.getCore();
-						rBody.mLastTransform = core.body2World;
-						core.body2World = solverBodyData.body2World;
-						core.linearVelocity = solverBodyData.linearVelocity;
-						core.angularVelocity = solverBodyData.angularVelocity;
-
-
-						bool hasStaticTouch = mIslandSim.getIslandStaticTouchCount(IG::NodeIndex(solverBodyData.nodeIndex)) != 0;
-						sleepCheck(const_cast<PxsRigidBody*>(mObjects.bodies[k]), mContext.mDt, mContext.mInvDt, mContext.mEnableStabilization, mContext.mUseAdaptiveForce, mThreadContext.motionVelocityArray[k],
-							hasStaticTouch);
-					}
+					integrateBodies(mThreadContext.motionVelocityArray, solverBodies, solverBodyDatas + mSolverBodyOffset + 1, const_cast<PxsRigidBody**>(mObjects.bodies),
+						mIslandContext.mCounts.bodies, mContext.mDt, mContext.mInvDt, mContext.mEnableStabilization, mContext.mUseAdaptiveForce, mIslandSim);
 
 					for(PxU32 cnt=0;cnt<mIslandContext.mCounts.articulations;cnt++)
 					{
@@ -1971,6 +2221,9 @@ public:
 		mThreadContext.mConstraintBlockManager.reset();
 
 		mContext.putThreadContext(&mThreadContext);
+
+		if(mIslandContext.mCost)
+			mIslandContext.mCost->time = Ps::Time::getCurrentCounterValue() - mIslandContext.mCost->time;
 	}
 
 
@@ -2031,7 +2284,7 @@ PxBaseTask* createSolverTaskChain(DynamicsContext& dynamicContext,
 										const PxU32 solverBodyOffset, 
 										IG::SimpleIslandManager& islandManager, 
 										PxU32* bodyRemapTable, PxsMaterialManager* materialManager, PxBaseTask* continuation,
-										PxsContactManagerOutputIterator& iterator, bool useEnhancedDeterminism)
+										PxsContactManagerOutputIterator& iterator, bool useEnhancedDeterminism, IslandCost* cost)
 {
 	Cm::FlushPool& taskPool =  dynamicContext.getTaskPool();
 
@@ -2041,6 +2294,7 @@ PxBaseTask* createSolverTaskChain(DynamicsContext& dynamicContext,
 	IslandContext* islandContext = reinterpret_cast<IslandContext*>(taskPool.allocate(sizeof(IslandContext)));
 	islandContext->mThreadContext = NULL;
 	islandContext->mCounts = counts;
+	islandContext->mCost = cost;
 
 
 	// create lead task
@@ -2121,6 +2375,11 @@ void DynamicsContext::update(IG::SimpleIslandManager& simpleIslandManager, PxBas
 
 	resetThreadContexts();
 
+	//There is at most one task chain per island. The array must not be resized once the chains are running.
+	mIslandCosts.forceSize_Unsafe(0);
+	if(mCostProfiling)
+		mIslandCosts.reserve(islandCount);
+
 	//If there is no work to do then we can do nothing at all.
 	if(0 == islandCount)
 	{
@@ -2312,8 +2571,22 @@ void DynamicsContext::update(IG::SimpleIslandManager& simpleIslandManager, PxBas
 		counts.contactManagers	= nbContactManagers;
 		if(counts.articulations + counts.bodies > 0)
 		{
+			IslandCost* cost = NULL;
+			if(mCostProfiling)
+			{
+				IslandCost& islandCost = mIslandCosts.insert();
+				islandCost.body					= NULL;	//the bodies are gathered by the start task
+				islandCost.nbIslands			= objectStarts.numIslands;
+				islandCost.nbBodies				= nbBodies;
+				islandCost.nbArticulations		= nbArticulations;
+				islandCost.nbContactManagers	= nbContactManagers;
+				islandCost.nbConstraints		= nbConstraints;
+				islandCost.time					= 0;
+				cost = &islandCost;
+			}
+
 			PxBaseTask* task = createSolverTaskChain(*this, objectStarts, counts, 
-				kinematicCount + currentBodyIndex, simpleIslandManager, mSolverBodyRemapTable.begin(), mMaterialManager, forceThresholdTask, mOutputIterator, mUseEnhancedDeterminism);		
+				kinematicCount + currentBodyIndex, simpleIslandManager, mSolverBodyRemapTable.begin(), mMaterialManager, forceThresholdTask, mOutputIterator, mUseEnhancedDeterminism, cost);		
 			task->removeReference();
 		}
 
@@ -2372,8 +2645,13 @@ static void preIntegrationParallel(
 	for(PxU32 a = 1; a < bodyCount; ++a)
 	{
 		PxU32 i = a-1;
-		Ps::prefetchLine(bodyArray[a]);
-		Ps::prefetchLine(bodyArray[a],128);
+		//The cores and bodies live in the actors, scattered in memory, so they are fetched a few bodies ahead.
+		//One body ahead isn't enough to hide a miss.
+		const PxU32 prefetch = PxMin(a+3, bodyCount-1);
+		Ps::prefetchLine(bodyArray[prefetch]);
+		Ps::prefetchLine(bodyArray[prefetch],128);
+		Ps::prefetchLine(originalBodyArray[prefetch]);
+		Ps::prefetchLine(originalBodyArray[prefetch],64);
 		Ps::prefetchLine(&solverBodyDataPool[a]);
 		Ps::prefetchLine(&solverBodyDataPool[a],128);
 
@@ -2418,9 +2696,11 @@ static void preIntegrationParallel(
 
 void PxsPreIntegrateTask::runInternal()
 {
+	PxU32 startIndex, numToIntegrate;
+	while(mRange->claim(startIndex, numToIntegrate))
 	{
-		preIntegrationParallel(mDt, mBodyArray + mStartIndex, mOriginalBodyArray + mStartIndex, mNodeIndexArray + mStartIndex, mNumToIntegrate,
-							mSolverBodies + mStartIndex, mSolverBodyDataPool + mStartIndex,
+		preIntegrationParallel(mDt, mBodyArray + startIndex, mOriginalBodyArray + startIndex, mNodeIndexArray + startIndex, numToIntegrate,
+							mSolverBodies + startIndex, mSolverBodyDataPool + startIndex,
 							mMaxSolverPositionIterations, mMaxSolverVelocityIterations, mGravity);
 	}
 }
@@ -2439,31 +2719,29 @@ void DynamicsContext::preIntegrationParallel(
    PxBaseTask& task
    )
 {
-	//TODO - make this based on some variables so we can try different configurations
-	const PxU32 IntegrationPerThread = 256;
+	// One task per worker at most, claiming chunks of bodies from a shared range (see Cm::ParallelForRange)
+	const PxU32 MinIntegrationPerChunk = 64;
+	const PxU32 MaxIntegrationPerChunk = 512;
+
+	PxMemZero(solverBodyPool, bodyCount * sizeof(PxSolverBody));
 
-	const PxU32 numTasks = ((bodyCount + IntegrationPerThread-1)/IntegrationPerThread);
-	const PxU32 taskBatchSize = 64;
+	const PxU32 nbTasks = Cm::getParallelForTaskCount(bodyCount, task.getTaskManager(), MinIntegrationPerChunk);
+	if(!nbTasks)
+		return;
 
-	for(PxU32 i = 0; i < numTasks; i+=taskBatchSize)
+	Cm::ParallelForRange* range = PX_PLACEMENT_NEW(getTaskPool().allocate(sizeof(Cm::ParallelForRange)), Cm::ParallelForRange)();
+	range->init(bodyCount, nbTasks, MinIntegrationPerChunk, MaxIntegrationPerChunk);
+
+	PxsPreIntegrateTask* tasks = reinterpret_cast<PxsPreIntegrateTask*>(getTaskPool().allocate(sizeof(PxsPreIntegrateTask)*nbTasks));
+	for(PxU32 a = 0; a < nbTasks; ++a)
 	{
-		const PxU32 nbTasks = PxMin(numTasks - i, taskBatchSize);
-		PxsPreIntegrateTask* tasks = reinterpret_cast<PxsPreIntegrateTask*>(getTaskPool().allocate(sizeof(PxsPreIntegrateTask)*nbTasks));
-		for(PxU32 a = 0; a < nbTasks; ++a)
-		{
-			PxU32 startIndex = (i+a)*IntegrationPerThread;
-			PxU32 nbToIntegrate = PxMin((bodyCount-startIndex), IntegrationPerThread);
-			PxsPreIntegrateTask* pTask = PX_PLACEMENT_NEW(&tasks[a], PxsPreIntegrateTask)(*this, bodyArray,
-							originalBodyArray, nodeIndexArray, solverBodyPool, solverBodyDataPool, dt, bodyCount,
-							&maxSolverPositionIterations, &maxSolverVelocityIterations, startIndex, 
-							nbToIntegrate, mGravity);
-
-			pTask->setContinuation(&task);
-			pTask->removeReference();
-		}
-	}
+		PxsPreIntegrateTask* pTask = PX_PLACEMENT_NEW(&tasks[a], PxsPreIntegrateTask)(*this, bodyArray,
+						originalBodyArray, nodeIndexArray, solverBodyPool, solverBodyDataPool, dt, bodyCount,
+						&maxSolverPositionIterations, &maxSolverVelocityIterations, range, mGravity);
 
-	PxMemZero(solverBodyPool, bodyCount * sizeof(PxSolverBody));
+		pTask->setContinuation(&task);
+		pTask->removeReference();
+	}
 }
 
 inline void WaitBodyRequiredState(volatile PxU32* state, PxU32 requiredState)
@@ -2492,91 +2770,38 @@ void DynamicsContext::solveParallel(SolverIslandParams& params, IG::IslandSim& i
 
 void DynamicsContext::integrateCoreParallel(SolverIslandParams& params, IG::IslandSim& islandSim)
 {
-	const PxI32 unrollCount = 128;
-
-	PxI32* bodyIntegrationListIndex = &params.bodyIntegrationListIndex;
-
-	PxI32 index = physx::shdfnd::atomicAdd(bodyIntegrationListIndex, unrollCount) - unrollCount;
-
-	const PxI32 numBodies = PxI32(params.bodyListSize);
-	const PxI32 numArtics = PxI32(params.articulationListSize);
+	const PxU32 numArtics = params.articulationListSize;
 
 	Cm::SpatialVector* PX_RESTRICT motionVelocityArray = params.motionVelocityArray;
-	PxsBodyCore*const* bodyArray = params.bodyArray;
 	PxsRigidBody** PX_RESTRICT rigidBodies = params.rigidBodies;
 	ArticulationSolverDesc* PX_RESTRICT articulationListStart = params.articulationListStart;
-
+	PxSolverBody* PX_RESTRICT solverBodies = params.bodyListStart;
+	PxSolverBodyData* PX_RESTRICT solverBodyData = params.bodyDataList + params.solverBodyOffset+1;
 
 	PxI32 numIntegrated = 0;
 
-	PxI32 bodyRemainder = unrollCount;
-
-	while(index < numArtics)
+	// The chunks shrink towards the end of the range, so the threads that come out of the solver first don't leave
+	// the last one with a full batch of bodies
+	PxU32 start, nb;
+	while(params.bodyIntegrationRange.claim(start, nb))
 	{
-		const PxI32 remainder = PxMin(numArtics - index, unrollCount);
-		bodyRemainder -= remainder;
+		const PxU32 end = start + nb;
 
-		for(PxI32 a = 0; a < remainder; ++a, index++)
+		for(PxU32 i = start; i < PxMin(end, numArtics); ++i)
 		{
-			const PxI32 i = index;
-			{
-				PX_PROFILE_ZONE("Articulations.integrate", mContextID);
+			PX_PROFILE_ZONE("Articulations.integrate", mContextID);
 
-				ArticulationPImpl::updateBodies(articulationListStart[i], mDt);
-			}
-
-			++numIntegrated;
-		}
-		if(bodyRemainder == 0)
-		{
-			index = physx::shdfnd::atomicAdd(bodyIntegrationListIndex, unrollCount) - unrollCount;
-			bodyRemainder = unrollCount;
+			ArticulationPImpl::updateBodies(articulationListStart[i], mDt);
 		}
-	}	
 
-	index -= numArtics;
-
-	const PxI32 unrollPlusArtics = unrollCount + numArtics;
-
-	PxSolverBody* PX_RESTRICT solverBodies = params.bodyListStart;
-	PxSolverBodyData* PX_RESTRICT solverBodyData = params.bodyDataList + params.solverBodyOffset+1;
-
-	while(index < numBodies)
-	{
-		const PxI32 remainder = PxMin(numBodies - index, bodyRemainder);
-		bodyRemainder -= remainder;
-		for(PxI32 a = 0; a < remainder; ++a, index++)
+		if(end > numArtics)
 		{
-			const PxI32 prefetch = PxMin(index+4, numBodies - 1);
-			Ps::prefetchLine(bodyArray[prefetch]);
-			Ps::prefetchLine(bodyArray[prefetch],128);
-			Ps::prefetchLine(&solverBodies[index],128);
-			Ps::prefetchLine(&motionVelocityArray[index],128);
-			Ps::prefetchLine(&bodyArray[index+32]);
-			Ps::prefetchLine(&rigidBodies[prefetch]);
-			
-			PxSolverBodyData& data = solverBodyData[index];
-
-			integrateCore(motionVelocityArray[index].linear, motionVelocityArray[index].angular,
-				solverBodies[index], data, mDt);
-
-			PxsRigidBody& rBody = *rigidBodies[index];
-			PxsBodyCore& core = rBody.getCore();
-			rBody.mLastTransform = core.body2World;
-			core.body2World = data.body2World;
-			core.linearVelocity = data.linearVelocity;
-			core.angularVelocity = data.angularVelocity;
-
-			bool hasStaticTouch = islandSim.getIslandStaticTouchCount(IG::NodeIndex(data.nodeIndex)) != 0;
-			sleepCheck(rigidBodies[index], mDt, mInvDt, mEnableStabilization, mUseAdaptiveForce, motionVelocityArray[index], hasStaticTouch);
-
-			++numIntegrated;
+			const PxU32 first = PxMax(start, numArtics) - numArtics;
+			integrateBodies(motionVelocityArray + first, solverBodies + first, solverBodyData + first, rigidBodies + first, end - numArtics - first,
+				mDt, mInvDt, mEnableStabilization, mUseAdaptiveForce, islandSim);
 		}
 
-		{
-			index = physx::shdfnd::atomicAdd(bodyIntegrationListIndex, unrollCount) - unrollPlusArtics;
-			bodyRemainder = unrollCount;
-		}
+		numIntegrated += PxI32(nb);
 	}
 
 	Ps::memoryBarrier();
@@ -2856,6 +3081,32 @@ public:
 	PxU32 mEndIndex;
 };
 
+// Group of a constraint when sorting the constraints of a partition for batching: the contacts and the joints that can go in
+// 4-wide blocks, then everything else
+static PX_FORCE_INLINE PxU32 getBatchGroup(const PxSolverConstraintDesc& desc)
+{
+	if(isArticulationConstraint(desc))
+		return 2;
+	return desc.constraintLengthOver16 == DY_SC_TYPE_RB_CONTACT ? 0u : (desc.constraintLengthOver16 == DY_SC_TYPE_RB_1D ? 1u : 2u);
+}
+
+// The constraints of a partition don't share bodies, so their order doesn't change the results. Batches are cut at every change
+// of constraint type, so grouping the types lets most batches take 4 constraints when contacts and joints are mixed.
+static void groupConstraintsForBatching(PxSolverConstraintDesc* PX_RESTRICT descs, const PxU32 numDescs)
+{
+	PxU32 low = 0, mid = 0, high = numDescs;
+	while(mid < high)
+	{
+		const PxU32 group = getBatchGroup(descs[mid]);
+		if(group == 0)
+			Ps::swap(descs[low++], descs[mid++]);
+		else if(group == 1)
+			mid++;
+		else
+			Ps::swap(descs[mid], descs[--high]);
+	}
+}
+
 void PxsSolverCreateFinalizeConstraintsTask::runInternal()
 {
 	ThreadContext& mThreadContext = *mIslandContext.mThreadContext;
@@ -2875,6 +3126,17 @@ void PxsSolverCreateFinalizeConstraintsTask::runInternal()
 
 	const PxU32 maxBatchSize = mEnhancedDeterminism ? 1u : 4u;
 
+	if(maxBatchSize > 1)
+	{
+		PxU32 startIndex = 0;
+		for(PxU32 a = 0; a < accumulatedConstraintsPerPartition.size() && startIndex < descCount; ++a)
+		{
+			const PxU32 endIndex = accumulatedConstraintsPerPartition[a];
+			groupConstraintsForBatching(mThreadContext.orderedContactConstraints + startIndex, endIndex - startIndex);
+			startIndex = endIndex;
+		}
+	}
+
 	PxU32 headersPerPartition = 0;
 	for(PxU32 a = 0; a < descCount;)
 	{
@@ -109,7 +109,7 @@ struct SolverIslandObjects;
 \brief Solver body pool (array) that enforces 128-byte alignment for base address of array.
 \note This reduces cache misses on platforms with 128-byte-size cache lines by aligning the start of the array to the beginning of a cache line.
 */
-class SolverBodyPool : public Ps::Array<PxSolverBody, Ps::AlignedAllocator<128, Ps::ReflectionAllocator<PxSolverBody> > > 
+class SolverBodyPool : public Ps::Array<PxSolverBody, Ps::AlignedAllocator<128, Ps::LargePersistentAllocator> > 
 { 
 	PX_NOCOPY(SolverBodyPool)
 public:
@@ -120,7 +120,7 @@ public:
 \brief Solver body data pool (array) that enforces 128-byte alignment for base address of array.
 \note This reduces cache misses on platforms with 128-byte-size cache lines by aligning the start of the array to the beginning of a cache line.
 */
-class SolverBodyDataPool : public Ps::Array<PxSolverBodyData, Ps::AlignedAllocator<128, Ps::ReflectionAllocator<PxSolverBodyData> > >
+class SolverBodyDataPool : public Ps::Array<PxSolverBodyData, Ps::AlignedAllocator<128, Ps::LargePersistentAllocator> >
 {
 	PX_NOCOPY(SolverBodyDataPool)
 public:
@@ -143,6 +143,8 @@ struct IslandContext
 	//The thread context for this island (set in in the island start task, released in the island end task)
 	ThreadContext* mThreadContext;
 	PxsIslandIndices		mCounts;
+	//Where the time of the task chain is recorded, NULL unless cost profiling is enabled
+	IslandCost*			mCost;
 };
 
 
@@ -420,6 +422,25 @@ protected:
 	ThresholdStream*		mExceededForceThresholdStream[2]; //this store previous and current exceeded force thresholdStream	
 
 	Ps::Array<PxU32>		mExceededForceThresholdStreamMask;
+	Ps::Array<PxU32>		mExceededForceThresholdStreamCurrentMask;
+
+	/**
+	\brief State of one partition of the threshold stream, when it is large enough to be processed in parallel (see PxsForceThresholdTask).
+	Body pairs are assigned to partitions by hash, so every partition accumulates and compares its own pairs independently.
+	*/
+	struct ThresholdPartition : public Ps::UserAllocated
+	{
+		ThresholdTable						mTable;
+		Ps::Array<PxU32>					mIndices;		// elements of the threshold stream in the partition
+		Ps::Array<PxU32>					mPreIndices;	// elements of the previous exceeded force stream in the partition
+		Ps::Array<PxU32>					mMask;
+		Ps::Array<ThresholdStreamElement>	mExceeded;
+		Ps::Array<ThresholdStreamElement>	mForceChanged;
+	};
+
+	Ps::Array<ThresholdPartition*>	mThresholdPartitions;
+	Ps::Array<PxU8>					mThresholdPartitionIds;	// partition of each element of the threshold stream
+	PxU32							mNbThresholdPartitions;
 
 	/**
 	\brief Interface to the solver core.
@@ -470,6 +491,10 @@ private:
 	friend class PxsSolverEndTask;
 	friend class PxsSolverConstraintPostProcessTask;
 	friend class PxsForceThresholdTask;
+	friend class PxsForceThresholdPartitionIdsTask;
+	friend class PxsForceThresholdPartitionLaunchTask;
+	friend class PxsForceThresholdPartitionTask;
+	friend class PxsForceThresholdMergeTask;
 	friend class SolverArticulationUpdateTask;
 
 	friend void solveParallel(SOLVER_PARALLEL_METHOD_ARGS);
@@ -188,6 +188,24 @@ void SolverCoreGeneral::destroyV()
 	PX_FREE(this);
 }
 
+// Returns true if no body velocity changed by more than the threshold since the previous call, and stores the velocities for the next
+// one. The position iterations keep the previous velocities in the motion velocity array, which only receives its final values after them.
+static bool hasConverged(const PxSolverBody* PX_RESTRICT bodies, Cm::SpatialVector* PX_RESTRICT previousVelocities, const PxU32 nbBodies,
+	const PxReal threshold)
+{
+	PxReal maxChange = 0.0f;
+	for(PxU32 i = 0; i < nbBodies; ++i)
+	{
+		const PxSolverBody& body = bodies[i];
+		Cm::SpatialVector& previous = previousVelocities[i];
+		maxChange = PxMax(maxChange, PxMax((body.linearVelocity - previous.linear).abs().maxElement(),
+			(body.angularState - previous.angular).abs().maxElement()));
+		previous.linear = body.linearVelocity;
+		previous.angular = body.angularState;
+	}
+	return maxChange < threshold;
+}
+
 void SolverCoreGeneral::solveV_Blocks(SolverIslandParams& params) const
 {
 
@@ -243,6 +261,17 @@ void SolverCoreGeneral::solveV_Blocks(SolverIslandParams& params) const
 	//0-(n-1) iterations
 	PxI32 normalIter = 0;
 
+	//The articulations aren't part of the measured velocities
+	const bool earlyOut = params.convergenceThreshold > 0.0f && articulationListSize == 0 && positionIterations > 2;
+	if(earlyOut)
+	{
+		for (PxU32 baIdx = 0; baIdx < bodyListSize; baIdx++)
+		{
+			motionVelocityArray[baIdx].linear = bodyListStart[baIdx].linearVelocity;
+			motionVelocityArray[baIdx].angular = bodyListStart[baIdx].angularState;
+		}
+	}
+
 	for (PxU32 iteration = positionIterations; iteration > 0; iteration--)	//decreasing positive numbers == position iters
 	{
 		cache.doFriction = iteration<=3;
@@ -251,6 +280,10 @@ void SolverCoreGeneral::solveV_Blocks(SolverIslandParams& params) const
 			cache, contactIterator, iteration == 1 ? gVTableSolveConcludeBlock : gVTableSolveBlock, normalIter);
 
 		++normalIter;
+
+		//Converged: skip to the first friction iteration, or from the friction iterations to the concluding one
+		if(earlyOut && iteration > 2 && hasConverged(bodyListStart, motionVelocityArray, bodyListSize, params.convergenceThreshold))
+			iteration = iteration > 3 ? PxMin(iteration, 4u) : 2u;
 	}
 
 	for (PxU32 baIdx = 0; baIdx < bodyListSize; baIdx++)
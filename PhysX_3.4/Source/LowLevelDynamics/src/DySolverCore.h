@@ -34,6 +34,7 @@
 #include "PxvConfig.h"
 #include "PsArray.h"
 #include "PsThread.h"
+#include "CmParallelFor.h"
 
 
 namespace physx
@@ -173,13 +174,14 @@ struct SolverIslandParams
 	PxU32 batchSize;
 	PxsBodyCore*const* bodyArray;
 	PxsRigidBody** PX_RESTRICT rigidBodies;
+	PxReal convergenceThreshold;	//early-out of the single threaded position iterations, 0 if disabled
 
 	//Shared state progress counters
 	PxI32 constraintIndex;
 	PxI32 constraintIndex2;
 	PxI32 bodyListIndex;
 	PxI32 bodyListIndex2;
-	PxI32 bodyIntegrationListIndex;
+	Cm::ParallelForRange bodyIntegrationRange;	//the articulations, then the bodies
 	PxI32 numObjectsIntegrated;
 
 
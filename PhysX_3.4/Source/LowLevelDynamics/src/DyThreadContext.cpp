@@ -46,6 +46,7 @@ ThreadContext::ThreadContext(PxcNpMemBlockPool* memBlockPool):
 	mConstraintsPerPartition(PX_DEBUG_EXP("ThreadContext::mConstraintsPerPartition")),
 	mFrictionConstraintsPerPartition(PX_DEBUG_EXP("ThreadContext::frictionsConstraintsPerPartition")),
 	mPartitionNormalizationBitmap(PX_DEBUG_EXP("ThreadContext::mPartitionNormalizationBitmap")),
+	mPartitionColoringScratch(PX_DEBUG_EXP("ThreadContext::mPartitionColoringScratch")),
 	frictionConstraintDescArray(PX_DEBUG_EXP("ThreadContext::solverFrictionConstraintArray")),
 	frictionConstraintBatchHeaders(PX_DEBUG_EXP("ThreadContext::frictionConstraintBatchHeaders")),
 	compoundConstraints(PX_DEBUG_EXP("ThreadContext::compoundConstraints")),
@@ -130,6 +130,7 @@ public:
 	Ps::Array<PxU32>					mConstraintsPerPartition;
 	Ps::Array<PxU32>					mFrictionConstraintsPerPartition;
 	Ps::Array<PxU32>					mPartitionNormalizationBitmap;
+	Ps::Array<PxU32>					mPartitionColoringScratch;
 	PxsBodyCore**						mBodyCoreArray;
 	PxsRigidBody**						mRigidBodyArray;
 	Articulation**						mArticulationArray;
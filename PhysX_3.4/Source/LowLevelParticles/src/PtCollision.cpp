@@ -113,12 +113,9 @@ void PX_FORCE_INLINE Collision::addTempW2STransform(TaskData& taskData, const Pa
 void Collision::updateCollision(const PxU8* contactManagerStream, physx::PxBaseTask& continuation)
 {
 	mMergeTask.setContinuation(&continuation);
-	PxU32 maxTasks = PT_NUM_PACKETS_PARALLEL_COLLISION;
+	PxU32 maxTasks = mParticleSystem.getContext().getNumParallelTasks(PT_NUM_PACKETS_PARALLEL_COLLISION);
 	PxU32 packetParticleIndicesCount = mParticleSystem.mNumPacketParticlesIndices;
 
-	// would be nice to get available thread count to decide on task decomposition
-	// mParticleSystem.getContext().getTaskManager().getCpuDispatcher();
-
 	// use number of particles for task decomposition
 
 	PxU32 targetParticleCountPerTask =
@@ -135,7 +132,7 @@ void Collision::updateCollision(const PxU8* contactManagerStream, physx::PxBaseT
 		taskData.bounds.setEmpty();
 
 		// if this is the last interation, we need to gather all remaining packets
-		if(i == maxTasks - 1)
+		if(i >= maxTasks - 1)
 			targetParticleCountPerTask = 0xffffffff;
 
 		cmStreamLast = cmStream;
@@ -326,7 +323,7 @@ void Collision::updateFluidShapeCollision(Particle* particles, TwoWayData* fluid
 		updateSubPacket(particlesSp, fluidTwoWayData, transientBuf, collisionVelocities, constraintBufs,
 		                perParticleCacheSp, opcodeCache, localCellHash, worldBounds, packetCorner, particleIndicesSp,
 		                numParticlesSp, streamShape.contactManagers, w2sTransforms, streamShape.numContactManagers,
-		                restOffsetsSp);
+		                restOffsetsSp, particleShape.getMeshCache());
 
 		// store particles back
 		for(PxU32 p = 0; p < numParticlesSp; p++)
@@ -350,7 +347,8 @@ Collision::updateSubPacket(Particle* particlesSp, TwoWayData* fluidTwoWayData, P
                            LocalCellHash& localCellHash, PxBounds3& worldBounds, const PxVec3& packetCorner,
                            const PxU32* particleIndicesSp, const PxU32 numParticlesSp,
                            const ParticleStreamContactManager* contactManagers, const W2STransformTemp* w2sTransforms,
-                           const PxU32 numContactManagers, const PxF32* restOffsetsSp)
+                           const PxU32 numContactManagers, const PxF32* restOffsetsSp,
+                           PacketMeshCache& packetMeshCache)
 {
 	ParticleCollData* collDataSp =
 	    reinterpret_cast<ParticleCollData*>(PX_ALLOC(numParticlesSp * sizeof(ParticleCollData), "ParticleCollData"));
@@ -414,7 +412,7 @@ Collision::updateSubPacket(Particle* particlesSp, TwoWayData* fluidTwoWayData, P
 			continue;
 
 		updateFluidBodyContactPair(particlesSp, numParticlesSp, collDataSp, constraintBufs, perParticleCacheLocal,
-		                           localCellHash, packetCorner, cm, w2sTransforms[i]);
+		                           localCellHash, packetCorner, cm, w2sTransforms[i], NULL);
 
 		numDynamicShapes++;
 	}
@@ -464,7 +462,7 @@ Collision::updateSubPacket(Particle* particlesSp, TwoWayData* fluidTwoWayData, P
 		}
 
 		updateFluidBodyContactPair(particlesSp, numParticlesSp, collDataSp, constraintBufs, perParticleCacheLocal,
-		                           localCellHash, packetCorner, cm, w2sTransforms[i]);
+		                           localCellHash, packetCorner, cm, w2sTransforms[i], &packetMeshCache);
 	}
 
 	if(loadedCache)
@@ -528,7 +526,7 @@ void Collision::updateFluidBodyContactPair(const Particle* particles, PxU32 numP
                                            ParticleCollData* particleCollData, ConstraintBuffers& constraintBufs,
                                            ParticleOpcodeCache* opcodeCacheLocal, LocalCellHash& localCellHash,
                                            const PxVec3& packetCorner, const ParticleStreamContactManager& contactManager,
-                                           const W2STransformTemp& w2sTransform)
+                                           const W2STransformTemp& w2sTransform, PacketMeshCache* packetMeshCache)
 {
 	PX_ASSERT(particles);
 	PX_ASSERT(particleCollData);
@@ -607,7 +605,8 @@ void Collision::updateFluidBodyContactPair(const Particle* particles, PxU32 numP
 			}
 
 			collideCellsWithStaticMesh(particleCollData, localCellHash, shape, world2Shape, shape2World,
-			                           mParams.cellSize, mParams.collisionRange, mParams.contactOffset, packetCorner);
+			                           mParams.cellSize, mParams.collisionRange, mParams.contactOffset, packetCorner,
+			                           packetMeshCache);
 		}
 		isStaticMeshType = true;
 		break;
@@ -102,13 +102,13 @@ class Collision
 	                                     const PxU32* particleIndicesSp, const PxU32 numParticlesSp,
 	                                     const ParticleStreamContactManager* contactManagers,
 	                                     const W2STransformTemp* w2sTransforms, const PxU32 numContactManagers,
-	                                     const PxF32* restOffsetsSp);
+	                                     const PxF32* restOffsetsSp, PacketMeshCache& packetMeshCache);
 
 	void updateFluidBodyContactPair(const Particle* particles, PxU32 numParticles, ParticleCollData* particleCollData,
 	                                ConstraintBuffers& constraintBufs, ParticleOpcodeCache* perParticleCacheLocal,
 	                                LocalCellHash& localCellHash, const PxVec3& packetCorner,
 	                                const ParticleStreamContactManager& contactManager,
-	                                const W2STransformTemp& w2sTransform);
+	                                const W2STransformTemp& w2sTransform, PacketMeshCache* packetMeshCache);
 
 	void PX_FORCE_INLINE addTempW2STransform(TaskData& taskData, const ParticleStreamContactManager& cm);
 
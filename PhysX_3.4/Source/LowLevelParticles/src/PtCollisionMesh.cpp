@@ -35,7 +35,9 @@
 #include "PtConstants.h"
 #include "GuBox.h"
 #include "GuMidphaseInterface.h"
+#include "PsVecMath.h"
 
+using namespace physx::shdfnd::aos;
 using namespace physx;
 using namespace Pt;
 using namespace Gu;
@@ -476,10 +478,178 @@ void collideCellWithMeshTriangles(ParticleCollData* collData, const PxU32* collD
 	}
 }
 
+struct PacketMeshCacheCallback : MeshHitCallback<PxRaycastHit>
+{
+	PacketMeshCache& cache;
+	const Cm::FastVertex2ShapeScaling& meshScaling;
+	bool overflow;
+
+	PacketMeshCacheCallback(PacketMeshCache& cache_, const Cm::FastVertex2ShapeScaling& meshScaling_)
+	: MeshHitCallback<PxRaycastHit>(CallbackMode::eMULTIPLE), cache(cache_), meshScaling(meshScaling_), overflow(false)
+	{
+	}
+	virtual ~PacketMeshCacheCallback()
+	{
+	}
+
+	virtual PxAgain processHit( // all reported coords are in mesh local space including hit.position
+	    const PxRaycastHit&, const PxVec3& v0, const PxVec3& v1, const PxVec3& v2, PxReal&, const PxU32*)
+	{
+		if(cache.getNumTriangles() >= PT_PACKET_MESH_CACHE_MAX_TRIANGLES)
+		{
+			overflow = true;
+			return false;
+		}
+
+		// same winding as collideWithMeshTriangles
+		if(meshScaling.flipsNormal())
+			cache.addTriangle(meshScaling * v0, meshScaling * v2, meshScaling * v1);
+		else
+			cache.addTriangle(meshScaling * v0, meshScaling * v1, meshScaling * v2);
+
+		return true;
+	}
+
+  private:
+	PacketMeshCacheCallback& operator=(const PacketMeshCacheCallback&);
+};
+
+/**
+Returns the cached triangles of the mesh for the packet, querying the midphase if the packet isn't cached yet
+or the mesh moved. Returns NULL if the packet overlaps too many triangles.
+*/
+const PacketMeshCache::Entry* getPacketMeshCacheEntry(PacketMeshCache& cache, const GeometryUnion& meshShape,
+                                                      const TriangleMesh& meshData, const PxTransform& world2Shape,
+                                                      const Cm::FastVertex2ShapeScaling& meshScaling,
+                                                      bool idtScaleMesh, PxReal collisionRange)
+{
+	const PacketMeshCache::Entry* entry = cache.find(&meshShape, world2Shape);
+	if(!entry)
+	{
+		PxBounds3 worldBounds = cache.getPacketBounds();
+		worldBounds.fattenFast(collisionRange);
+		cache.beginEntry(&meshShape, world2Shape, worldBounds);
+
+		Box vertexSpaceAABB;
+		computeVertexSpaceAABB(vertexSpaceAABB, worldBounds, world2Shape, meshScaling, idtScaleMesh);
+
+		PacketMeshCacheCallback callback(cache, meshScaling);
+		Gu::intersectOBB_Particles(&meshData, vertexSpaceAABB, callback, true);
+		entry = &cache.endEntry(callback.overflow);
+	}
+	return entry->numTriangles != PX_INVALID_U32 ? entry : NULL;
+}
+
+/**
+Bounds broadcasted to 4 lanes, for testing against the triangle bounds of the cache.
+*/
+struct BoundsV4
+{
+	Vec4V minX, minY, minZ, maxX, maxY, maxZ;
+
+	PX_FORCE_INLINE explicit BoundsV4(const PxBounds3& bounds)
+	: minX(V4Load(bounds.minimum.x))
+	, minY(V4Load(bounds.minimum.y))
+	, minZ(V4Load(bounds.minimum.z))
+	, maxX(V4Load(bounds.maximum.x))
+	, maxY(V4Load(bounds.maximum.y))
+	, maxZ(V4Load(bounds.maximum.z))
+	{
+	}
+
+	// bit i is set if the bounds overlap the bounds of triangle i of the group
+	PX_FORCE_INLINE PxU32 overlap(const PacketMeshCache::BoundsGroup& group) const
+	{
+		const BoolV x = BAnd(V4IsGrtrOrEq(maxX, V4LoadA(group.minX)), V4IsGrtrOrEq(V4LoadA(group.maxX), minX));
+		const BoolV y = BAnd(V4IsGrtrOrEq(maxY, V4LoadA(group.minY)), V4IsGrtrOrEq(V4LoadA(group.maxY), minY));
+		const BoolV z = BAnd(V4IsGrtrOrEq(maxZ, V4LoadA(group.minZ)), V4IsGrtrOrEq(V4LoadA(group.maxZ), minZ));
+		return BGetBitMask(BAnd(x, BAnd(y, z)));
+	}
+};
+
+void collideCellWithCachedTriangles(ParticleCollData* collData, const PxU32* collDataIndices, PxU32 numCollDataIndices,
+                                    const PacketMeshCache& cache, const PacketMeshCache::Entry& entry,
+                                    PxReal proxRadius, const PxTransform& shape2World)
+{
+	const PacketMeshCache::BoundsGroup* groups = cache.getBoundsGroups(entry);
+	const PacketMeshCache::Triangle* triangles = cache.getTriangles(entry);
+	const PxU32 numGroups = entry.getNumGroups();
+
+	// cell bounds in shape space, the local positions are already transformed
+	PxBounds3 cellBounds = PxBounds3::empty();
+	for(PxU32 i = 0; i < numCollDataIndices; ++i)
+	{
+		ParticleCollData& particle = collData[collDataIndices[i]];
+		particle.localDcNum = 0.0f;
+		particle.localSurfaceNormal = PxVec3(0);
+		particle.localSurfacePos = PxVec3(0);
+		cellBounds.include(particle.localOldPos);
+		cellBounds.include(particle.localNewPos);
+	}
+	cellBounds.fattenFast(proxRadius);
+
+	// groups with triangles overlapping the cell
+	PxU32 cellGroups[(PT_PACKET_MESH_CACHE_MAX_TRIANGLES + 3) / 4];
+	PxU32 numCellGroups = 0;
+	{
+		const BoundsV4 cellBoundsV(cellBounds);
+		for(PxU32 g = 0; g < numGroups; ++g)
+		{
+			if(cellBoundsV.overlap(groups[g]))
+				cellGroups[numCellGroups++] = g;
+		}
+	}
+
+	if(numCellGroups == 0)
+		return;
+
+	PxVec3 tmpSurfaceNormal(0.0f);
+	PxVec3 tmpSurfacePos(0.0f);
+	PxVec3 tmpProxSurfaceNormal(0.0f);
+	PxVec3 tmpProxSurfacePos(0.0f);
+	PxReal tmpCCTime(0.0f);
+	PxReal tmpDistOldToSurface(0.0f);
+
+	for(PxU32 i = 0; i < numCollDataIndices; ++i)
+	{
+		ParticleCollData& collisionShapeData = collData[collDataIndices[i]];
+
+		bool hasCC = ((collisionShapeData.localFlags & ParticleCollisionFlags::CC) ||
+		              (collisionShapeData.localFlags & ParticleCollisionFlags::L_CC));
+
+		PxBounds3 particleBounds =
+		    PxBounds3::boundsOfPoints(collisionShapeData.localOldPos, collisionShapeData.localNewPos);
+		particleBounds.fattenFast(proxRadius);
+		const BoundsV4 particleBoundsV(particleBounds);
+
+		for(PxU32 g = 0; g < numCellGroups; ++g)
+		{
+			const PxU32 group = cellGroups[g];
+			PxU32 mask = particleBoundsV.overlap(groups[group]);
+			while(mask)
+			{
+				const PxU32 lane = Ps::lowestSetBit(mask);
+				mask &= mask - 1;
+
+				const PacketMeshCache::Triangle& triangle = triangles[group * 4 + lane];
+				PxU32 tmpFlags = collideWithMeshTriangle(
+				    tmpSurfaceNormal, tmpSurfacePos, tmpProxSurfaceNormal, tmpProxSurfacePos, tmpCCTime,
+				    tmpDistOldToSurface, collisionShapeData.localOldPos, collisionShapeData.localNewPos,
+				    triangle.origin, triangle.e0, triangle.e1, hasCC, collisionShapeData.restOffset, proxRadius);
+
+				updateCollShapeData(collisionShapeData, hasCC, tmpFlags, tmpCCTime, tmpDistOldToSurface,
+				                    tmpSurfaceNormal, tmpSurfacePos, tmpProxSurfaceNormal, tmpProxSurfacePos,
+				                    shape2World);
+			}
+		}
+	}
+}
+
 void physx::Pt::collideCellsWithStaticMesh(ParticleCollData* collData, const LocalCellHash& localCellHash,
                                            const GeometryUnion& meshShape, const PxTransform& world2Shape,
-                                           const PxTransform& shape2World, PxReal /*cellSize*/,
-                                           PxReal /*collisionRange*/, PxReal proxRadius, const PxVec3& /*packetCorner*/)
+                                           const PxTransform& shape2World, PxReal /*cellSize*/, PxReal collisionRange,
+                                           PxReal proxRadius, const PxVec3& /*packetCorner*/,
+                                           PacketMeshCache* packetMeshCache)
 {
 	PX_ASSERT(collData);
 	PX_ASSERT(localCellHash.isHashValid);
@@ -501,6 +671,11 @@ void physx::Pt::collideCellsWithStaticMesh(ParticleCollData* collData, const Loc
 	if(!idtScaleMesh)
 		meshScaling.init(meshShapeData.scale);
 
+	const PacketMeshCache::Entry* cacheEntry = NULL;
+	if(packetMeshCache)
+		cacheEntry = getPacketMeshCacheEntry(*packetMeshCache, meshShape, *meshData, world2Shape, meshScaling,
+		                                     idtScaleMesh, collisionRange);
+
 	// process the particle cells
 	for(PxU32 c = 0; c < localCellHash.numHashEntries; c++)
 	{
@@ -529,6 +704,14 @@ void physx::Pt::collideCellsWithStaticMesh(ParticleCollData* collData, const Loc
 		if(!cellBounds.intersects(shapeBounds))
 			continue; // early out if (inflated) cell doesn't intersect mesh bounds
 
+		// the cached triangles are complete for cells inside the cached volume
+		if(cacheEntry && cellBounds.isInside(cacheEntry->worldBounds))
+		{
+			collideCellWithCachedTriangles(collData, &(localCellHash.particleIndices[cell.firstParticle]),
+			                               cell.numParticles, *packetMeshCache, *cacheEntry, proxRadius, shape2World);
+			continue;
+		}
+
 		// opcode query: cell bounds against shape bounds in unscaled mesh space
 		PxcContactCellMeshCallback callback(collData, &(localCellHash.particleIndices[cell.firstParticle]),
 		                                    cell.numParticles, *meshData, meshScaling, proxRadius, NULL, shape2World);
@@ -38,6 +38,7 @@
 #include "PtCollisionData.h"
 #include "PtSpatialHash.h"
 #include "PtParticleOpcodeCache.h"
+#include "PtPacketMeshCache.h"
 #include "GuGeometryUnion.h"
 
 namespace physx
@@ -73,10 +74,13 @@ void collideWithCapsule(ParticleCollData* particleCollData, PxU32 numCollData, c
 void collideWithSphere(ParticleCollData* particleCollData, PxU32 numCollData, const Gu::GeometryUnion& sphereShape,
                        PxReal proxRadius);
 
+/**
+packetMeshCache can be NULL, otherwise the triangles of the mesh are cached for the packet.
+*/
 void collideCellsWithStaticMesh(ParticleCollData* particleCollData, const LocalCellHash& localCellHash,
                                 const Gu::GeometryUnion& meshShape, const PxTransform& world2Shape,
                                 const PxTransform& shape2World, PxReal cellSize, PxReal collisionRange,
-                                PxReal proxRadius, const PxVec3& packetCorner);
+                                PxReal proxRadius, const PxVec3& packetCorner, PacketMeshCache* packetMeshCache);
 
 void collideWithStaticMesh(PxU32 numParticles, ParticleCollData* particleCollData, ParticleOpcodeCache* opcodeCaches,
                            const Gu::GeometryUnion& meshShape, const PxTransform& world2Shape,
@@ -92,7 +92,7 @@
 #define PT_SUBPACKET_PARTICLE_HASH_BUCKET_SIZE 512
 
 // Maximum number of parallel tasks created for sph computation
-#define PT_MAX_PARALLEL_TASKS_SPH 8
+#define PT_MAX_PARALLEL_TASKS_SPH 64
 
 // Maximum number of fluid particles in a packet that can be handled at a time for velocity
 // integration
@@ -110,7 +110,15 @@
 #define PT_LOCAL_HASH_SIZE_MESH_COLLISION 256
 
 // Number of fluid packet shapes to run in parallel during collision update.
-#define PT_NUM_PACKETS_PARALLEL_COLLISION 8
+#define PT_NUM_PACKETS_PARALLEL_COLLISION 64
+
+// Number of packet batches created per worker thread for the sph and collision updates,
+// so that workers finishing early pick up the batches left by the others.
+#define PT_PARALLEL_TASKS_PER_WORKER 4
+
+// Maximum number of static mesh triangles cached per packet and mesh. Packets overlapping more triangles
+// of a mesh query the mesh midphase every simulation step.
+#define PT_PACKET_MESH_CACHE_MAX_TRIANGLES 1024
 
 // Initial size of triangle mesh collision buffer (for storing indices of colliding triangles)
 #define PT_INITIAL_MESH_COLLISION_BUFFER_SIZE 1024
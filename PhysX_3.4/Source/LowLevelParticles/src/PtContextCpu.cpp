@@ -39,6 +39,9 @@
 #endif
 
 #include "foundation/PxFoundation.h"
+#include "task/PxTaskManager.h"
+#include "task/PxCpuDispatcher.h"
+#include "PtConfig.h"
 #include "PtParticleData.h"
 #include "PtParticleSystemSimCpu.h"
 #include "PtParticleShapeCpu.h"
@@ -240,6 +243,13 @@ ParticleShapeCpu* ContextCpu::createParticleShape(ParticleSystemSimCpu* particle
 	return shape;
 }
 
+PxU32 ContextCpu::getNumParallelTasks(PxU32 maxTasks) const
+{
+	const PxCpuDispatcher* dispatcher = mTaskManager ? mTaskManager->getCpuDispatcher() : NULL;
+	const PxU32 numWorkers = dispatcher ? dispatcher->getWorkerCount() : 0;
+	return PxClamp(PxMax(numWorkers, PxU32(1)) * PT_PARALLEL_TASKS_PER_WORKER, PxU32(1), maxTasks);
+}
+
 void ContextCpu::releaseParticleShape(ParticleShapeCpu* shape)
 {
 	// for now just lock the mParticleShapePool for concurrent access from different tasks
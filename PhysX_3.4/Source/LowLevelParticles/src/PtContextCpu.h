@@ -94,6 +94,11 @@ class ContextCpu : public Context, Ps::UserAllocated
 		return mTaskPool;
 	}
 
+	/**
+	Number of packet batches to split a parallel update into, based on the worker count of the cpu dispatcher.
+	*/
+	PxU32 getNumParallelTasks(PxU32 maxTasks) const;
+
   private:
 	ContextCpu(physx::PxTaskManager* taskManager, Cm::FlushPool& taskPool);
 
@@ -323,27 +323,42 @@ void Dynamics::updateSph(physx::PxBaseTask& continuation)
 			mTempReorderedParticles[i] = particles[particleIndex];
 		}
 
-		// would be nice to get available thread count to decide on task decomposition
-		// mParticleSystem.getContext().getTaskManager().getCpuDispatcher();
+		// The cost of a packet grows with the number of particles times the number of neighbors, which
+		// is proportional to the particle density of the packet. Weighting packets by the square of their
+		// particle count keeps dense packets from piling up in a single batch.
+		const PxU32 maxTasks = mParticleSystem.getContext().getNumParallelTasks(PT_MAX_PARALLEL_TASKS_SPH);
+		PxU64 totalCost = 0;
+		for(PxU32 p = 0; p < PT_PARTICLE_SYSTEM_PACKET_HASH_SIZE; ++p)
+		{
+			const PxU32 packetParticleCount = packets[p].numParticles;
+			if(packetParticleCount != PX_INVALID_U32)
+				totalCost += PxU64(packetParticleCount) * packetParticleCount;
+		}
 
-		// use number of particles for task decomposition
-		PxU32 targetParticleCountPerTask =
-		    PxMax(PxU32(numParticles / PT_MAX_PARALLEL_TASKS_SPH), PxU32(PT_SUBPACKET_PARTICLE_LIMIT_FORCE_DENSITY));
+		PxU64 targetCostPerTask = totalCost / maxTasks;
 		PxU16 packetIndex = 0;
 		PxU16 lastPacketIndex = 0;
 		PxU32 numTasks = 0;
 		for(PxU32 i = 0; i < PT_MAX_PARALLEL_TASKS_SPH; ++i)
 		{
 			// if this is the last interation, we need to gather all remaining packets
-			if(i == PT_MAX_PARALLEL_TASKS_SPH - 1)
-				targetParticleCountPerTask = 0xffffffff;
+			if(i >= maxTasks - 1)
+				targetCostPerTask = PxU64(-1);
 
 			lastPacketIndex = packetIndex;
 			PxU32 currentParticleCount = 0;
-			while(currentParticleCount < targetParticleCountPerTask && packetIndex < PT_PARTICLE_SYSTEM_PACKET_HASH_SIZE)
+			PxU64 currentCost = 0;
+
+			// batches below a subpacket worth of particles aren't worth a task
+			while((currentCost < targetCostPerTask || currentParticleCount < PT_SUBPACKET_PARTICLE_LIMIT_FORCE_DENSITY) &&
+			      packetIndex < PT_PARTICLE_SYSTEM_PACKET_HASH_SIZE)
 			{
 				const ParticleCell& packet = packets[packetIndex];
-				currentParticleCount += (packet.numParticles != PX_INVALID_U32) ? packet.numParticles : 0;
+				if(packet.numParticles != PX_INVALID_U32)
+				{
+					currentParticleCount += packet.numParticles;
+					currentCost += PxU64(packet.numParticles) * packet.numParticles;
+				}
 				packetIndex++;
 			}
 
@@ -0,0 +1,246 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+#ifndef PT_PACKET_MESH_CACHE_H
+#define PT_PACKET_MESH_CACHE_H
+
+#include "PxPhysXConfig.h"
+#if PX_USE_PARTICLE_SYSTEM_API
+
+#include "foundation/PxBounds3.h"
+#include "foundation/PxTransform.h"
+#include "GuGeometryUnion.h"
+#include "PsArray.h"
+#include "PsAlignedMalloc.h"
+
+namespace physx
+{
+
+namespace Pt
+{
+
+/**
+Per packet cache of the static triangle mesh triangles that can be hit by the particles of the packet.
+
+Packets cover fixed regions of space, so these triangles don't change across simulation steps until the mesh shape
+is moved, changed or removed. The cache keeps them in shape space, with their bounds in groups of 4 for SIMD overlap
+tests, and the mesh midphase only needs to be queried when a packet first touches a mesh.
+
+The cache of a packet is only accessed by the collision task processing the packet.
+*/
+class PacketMeshCache
+{
+  public:
+	struct Triangle
+	{
+		PxVec3 origin;
+		PxVec3 e0;
+		PxVec3 e1;
+	};
+
+	/**
+	Bounds of 4 consecutive triangles, the slots past the last triangle have empty bounds.
+	*/
+	struct BoundsGroup
+	{
+		PX_ALIGN(16, PxF32 minX[4]);
+		PX_ALIGN(16, PxF32 minY[4]);
+		PX_ALIGN(16, PxF32 minZ[4]);
+		PX_ALIGN(16, PxF32 maxX[4]);
+		PX_ALIGN(16, PxF32 maxY[4]);
+		PX_ALIGN(16, PxF32 maxZ[4]);
+	};
+
+	struct Entry
+	{
+		const Gu::GeometryUnion* geometry;
+		PxTransform world2Shape;
+		PxBounds3 worldBounds; // Volume the cached triangles are complete for
+		PxU32 firstGroup;
+		PxU32 numTriangles; // PX_INVALID_U32 if the volume overlaps too many triangles to be cached
+
+		PX_FORCE_INLINE PxU32 getNumGroups() const
+		{
+			return numTriangles != PX_INVALID_U32 ? (numTriangles + 3) >> 2 : 0;
+		}
+	};
+
+	PX_FORCE_INLINE void init(const PxBounds3& packetBounds)
+	{
+		PX_ASSERT(mEntries.empty());
+		mPacketBounds = packetBounds;
+	}
+
+	PX_FORCE_INLINE const PxBounds3& getPacketBounds() const
+	{
+		return mPacketBounds;
+	}
+
+	PX_FORCE_INLINE const Entry* find(const Gu::GeometryUnion* geometry, const PxTransform& world2Shape) const
+	{
+		for(PxU32 i = 0; i < mEntries.size(); i++)
+		{
+			const Entry& entry = mEntries[i];
+			if(entry.geometry == geometry && entry.world2Shape == world2Shape)
+				return &entry;
+		}
+		return NULL;
+	}
+
+	// Number of triangles of the entry started last
+	PX_FORCE_INLINE PxU32 getNumTriangles() const
+	{
+		return mEntries.back().numTriangles;
+	}
+
+	PX_FORCE_INLINE const Triangle* getTriangles(const Entry& entry) const
+	{
+		return mTriangles.begin() + entry.firstGroup * 4;
+	}
+
+	PX_FORCE_INLINE const BoundsGroup* getBoundsGroups(const Entry& entry) const
+	{
+		return mBoundsGroups.begin() + entry.firstGroup;
+	}
+
+	/**
+	Starts a new entry for the geometry, replacing the previous one. Triangles are then added with addTriangle()
+	until endEntry() is called.
+	*/
+	void beginEntry(const Gu::GeometryUnion* geometry, const PxTransform& world2Shape, const PxBounds3& worldBounds)
+	{
+		remove(geometry);
+
+		Entry& entry = mEntries.insert();
+		entry.geometry = geometry;
+		entry.world2Shape = world2Shape;
+		entry.worldBounds = worldBounds;
+		entry.firstGroup = mBoundsGroups.size();
+		entry.numTriangles = 0;
+	}
+
+	/**
+	Adds a triangle in shape space to the entry started last.
+	*/
+	void addTriangle(const PxVec3& v0, const PxVec3& v1, const PxVec3& v2)
+	{
+		Entry& entry = mEntries.back();
+		const PxU32 lane = entry.numTriangles & 3;
+		if(lane == 0)
+		{
+			BoundsGroup& group = mBoundsGroups.insert();
+			for(PxU32 i = 0; i < 4; i++)
+			{
+				group.minX[i] = group.minY[i] = group.minZ[i] = PX_MAX_F32;
+				group.maxX[i] = group.maxY[i] = group.maxZ[i] = -PX_MAX_F32;
+			}
+			mTriangles.resize(mTriangles.size() + 4);
+		}
+
+		Triangle& triangle = mTriangles[entry.firstGroup * 4 + entry.numTriangles];
+		triangle.origin = v0;
+		triangle.e0 = v1 - v0;
+		triangle.e1 = v2 - v0;
+
+		BoundsGroup& group = mBoundsGroups.back();
+		group.minX[lane] = PxMin(v0.x, PxMin(v1.x, v2.x));
+		group.minY[lane] = PxMin(v0.y, PxMin(v1.y, v2.y));
+		group.minZ[lane] = PxMin(v0.z, PxMin(v1.z, v2.z));
+		group.maxX[lane] = PxMax(v0.x, PxMax(v1.x, v2.x));
+		group.maxY[lane] = PxMax(v0.y, PxMax(v1.y, v2.y));
+		group.maxZ[lane] = PxMax(v0.z, PxMax(v1.z, v2.z));
+
+		entry.numTriangles++;
+	}
+
+	/**
+	Finishes the entry started last. If the entry overflowed, its triangles are dropped and the entry only remembers
+	that the geometry can't be cached for this packet.
+	*/
+	const Entry& endEntry(bool overflow)
+	{
+		Entry& entry = mEntries.back();
+		if(overflow)
+		{
+			mBoundsGroups.removeRange(entry.firstGroup, mBoundsGroups.size() - entry.firstGroup);
+			mTriangles.removeRange(entry.firstGroup * 4, mTriangles.size() - entry.firstGroup * 4);
+			entry.numTriangles = PX_INVALID_U32;
+		}
+		return entry;
+	}
+
+	/**
+	Drops the entry of a geometry, called when the mesh shape changes or stops interacting with the packet.
+	*/
+	void remove(const Gu::GeometryUnion* geometry)
+	{
+		for(PxU32 i = 0; i < mEntries.size(); i++)
+		{
+			if(mEntries[i].geometry != geometry)
+				continue;
+
+			const PxU32 firstGroup = mEntries[i].firstGroup;
+			const PxU32 numGroups = mEntries[i].getNumGroups();
+			if(numGroups)
+			{
+				mBoundsGroups.removeRange(firstGroup, numGroups);
+				mTriangles.removeRange(firstGroup * 4, numGroups * 4);
+				for(PxU32 j = 0; j < mEntries.size(); j++)
+				{
+					if(mEntries[j].firstGroup > firstGroup)
+						mEntries[j].firstGroup -= numGroups;
+				}
+			}
+			mEntries.remove(i);
+			return;
+		}
+	}
+
+	void reset()
+	{
+		mEntries.reset();
+		mTriangles.reset();
+		mBoundsGroups.reset();
+	}
+
+  private:
+	typedef Ps::Array<BoundsGroup, shdfnd::AlignedAllocator<16, Ps::ReflectionAllocator<BoundsGroup> > > BoundsGroupArray;
+
+	PxBounds3 mPacketBounds;
+	Ps::Array<Entry> mEntries;
+	Ps::Array<Triangle> mTriangles;
+	BoundsGroupArray mBoundsGroups;
+};
+
+} // namespace Pt
+} // namespace physx
+
+#endif // PX_USE_PARTICLE_SYSTEM_API
+#endif // PT_PACKET_MESH_CACHE_H
@@ -61,6 +61,7 @@ void ParticleShapeCpu::init(ParticleSystemSimCpu* particleSystem, const Particle
 
 	// Compute and store AABB of the assigned packet
 	mParticleSystem->getPacketBounds(mPacketCoordinates, mBounds);
+	mMeshCache.init(mBounds);
 }
 
 void ParticleShapeCpu::destroyV()
@@ -71,6 +72,7 @@ void ParticleShapeCpu::destroyV()
 	mParticleSystem = NULL;
 	mPacket = NULL;
 	mUserData = NULL;
+	mMeshCache.reset();
 }
 
 #endif // PX_USE_PARTICLE_SYSTEM_API
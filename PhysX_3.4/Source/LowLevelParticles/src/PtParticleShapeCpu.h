@@ -38,6 +38,7 @@
 #include "PtConfig.h"
 #include "PtSpatialHash.h"
 #include "PtParticleShape.h"
+#include "PtPacketMeshCache.h"
 
 namespace physx
 {
@@ -98,6 +99,12 @@ class ParticleShapeCpu : public ParticleShape
 		return mPacketCoordinates;
 	}
 
+	// The mesh cache is filled during the collision update, which only sees const shapes.
+	PX_FORCE_INLINE PacketMeshCache& getMeshCache() const
+	{
+		return mMeshCache;
+	}
+
   private:
 	PxU32 mIndex;
 	class ParticleSystemSimCpu* mParticleSystem;
@@ -105,6 +112,7 @@ class ParticleShapeCpu : public ParticleShape
 	GridCellVector mPacketCoordinates; // This is needed for the remapping process.
 	const ParticleCell* mPacket;
 	void* mUserData;
+	mutable PacketMeshCache mMeshCache;
 };
 
 } // namespace Pt
@@ -619,6 +619,9 @@ void ParticleSystemSimCpu::removeInteractionV(const ParticleShape& particleShape
 			setCollisionCacheInvalid(pxsParticleShape, pxsShape->geometry);
 		}
 	}
+
+	if(!isDynamic && pxsShape->geometry.getType() == PxGeometryType::eTRIANGLEMESH)
+		pxsParticleShape.getMeshCache().remove(&pxsShape->geometry);
 }
 
 //----------------------------------------------------------------------------//
@@ -634,6 +637,9 @@ void ParticleSystemSimCpu::onRbShapeChangeV(const ParticleShape& particleShape,
 		// since the cache gets invalidated after one step not being used).
 		setCollisionCacheInvalid(pxsParticleShape, pxsShape->geometry);
 	}
+
+	if(pxsShape->geometry.getType() == PxGeometryType::eTRIANGLEMESH)
+		pxsParticleShape.getMeshCache().remove(&pxsShape->geometry);
 }
 
 //----------------------------------------------------------------------------//
@@ -37,6 +37,7 @@
 #include "PsUtilities.h"
 #include "NpScene.h"
 #include "PxGeometryQuery.h"
+#include "CmParallelFor.h"
 
 using namespace physx;
 using namespace Sq;
@@ -278,105 +279,108 @@ struct PxOverflowBuffer : PxHitBuffer<HitType>
 	}
 };
 
-void NpBatchQuery::execute()
+// A contiguous run of the queries of the stream, with the buffers its results and touches are written to
+namespace physx
 {
-	NP_READ_CHECK(mNpScene);
-
-	if(mNbRaycasts)
-	{
-		PX_CHECK_AND_RETURN(mDesc.queryMemory.userRaycastResultBuffer!=NULL, "PxBatchQuery execute: userRaycastResultBuffer is NULL");
-		PX_CHECK_AND_RETURN(mDesc.queryMemory.raycastTouchBufferSize > 0 ? 
-			(mDesc.queryMemory.userRaycastTouchBuffer != NULL)	: true, "PxBatchQuery execute: userRaycastTouchBuffer is NULL");
-	}
-	if(mNbOverlaps)
-	{
-		PX_CHECK_AND_RETURN(mDesc.queryMemory.userOverlapResultBuffer!=NULL, "PxBatchQuery execute: userOverlapResultBuffer is NULL");
-		PX_CHECK_AND_RETURN(mDesc.queryMemory.overlapTouchBufferSize > 0 ? 
-			(mDesc.queryMemory.userOverlapTouchBuffer != NULL)	: true, "PxBatchQuery execute: userOverlapTouchBuffer is NULL");
-	}
-	if(mNbSweeps)
-	{
-		PX_CHECK_AND_RETURN(mDesc.queryMemory.userSweepResultBuffer!=NULL, "PxBatchQuery execute: userSweepResultBuffer is NULL");
-		PX_CHECK_AND_RETURN(mDesc.queryMemory.sweepTouchBufferSize > 0 ? 
-			(mDesc.queryMemory.userSweepTouchBuffer != NULL)	: true, "PxBatchQuery execute: userSweepTouchBuffer is NULL");
-	}
-
-	PX_SIMD_GUARD;
-
-	PX_PROFILE_ZONE("BatchedSceneQuery.execute", mNpScene->getContextId());
-	PxI32 ret = Ps::atomicCompareExchange(&mBatchQueryIsRunning, 1, 0);
-	if(ret == 1)
-	{
-		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxBatchQuery::execute: This batch is already executing"); 
-		return;
-	}
-	else if(ret == -1)
-	{
-		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxBatchQuery::execute: Another thread is still adding queries to this batch"); 
-		return;
-	}
+struct BatchQueryChunk
+{
+	PxU32					startOffset;		// stream offset of the header of the first query
+	PxU32					nbQueries;
 
-	resetResultBuffers();
+	PxRaycastQueryResult*	raycastResults;
+	PxRaycastHit*			raycastHits;
+	PxU32					raycastHitsSize;
 
-	// If PVD is connected and IS_PVD_SQ_ENABLED, record the offsets for queries in pvd buffers and run the queries on PPU
-	bool isSqCollectorLocked = false;
-	PX_UNUSED(isSqCollectorLocked);
+	PxOverlapQueryResult*	overlapResults;
+	PxOverlapHit*			overlapHits;
+	PxU32					overlapHitsSize;
 
-#if PX_SUPPORT_PVD	
-	PxU32 pvdRayQstartIdx = 0;
-	PxU32 pvdOverlapQstartIdx = 0;
-	PxU32 pvdSweepQstartIdx = 0;
+	PxSweepQueryResult*		sweepResults;
+	PxSweepHit*				sweepHits;
+	PxU32					sweepHitsSize;
+};
+}
 
-	Vd::ScbScenePvdClient& pvdClient = mNpScene->mScene.getScenePvdClient();
-	const bool needUpdatePvd = pvdClient.checkPvdDebugFlag() && (pvdClient.getScenePvdFlagsFast() & PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES);
+// Raycasts that can be part of a packet, see PxBatchQueryDesc::raycastPackets
+static PX_FORCE_INLINE bool isPacketRaycast(const BatchStreamHeader& h)
+{
+	return h.hitTypeId == QTypeROS::eRAYCAST && h.maxTouchHits == 0 && h.cache == NULL;
+}
 
-	if(needUpdatePvd)
-	{
-		mNpScene->getBatchedSqCollector().getLock().lock();
-		isSqCollectorLocked = true;
-	
-		pvdRayQstartIdx = mNpScene->getBatchedSqCollector().mAccumulatedRaycastQueries.size();
-		pvdOverlapQstartIdx = mNpScene->getBatchedSqCollector().mAccumulatedOverlapQueries.size();
-		pvdSweepQstartIdx = mNpScene->getBatchedSqCollector().mAccumulatedSweepQueries.size();
-	}
-#endif
+void NpBatchQuery::runQueries(const BatchQueryChunk& chunk)
+{
+	PX_SIMD_GUARD;
 
 	PxClientID clientId = mDesc.ownerClient;
 
-	// setup local pointers to user provided output buffers
-	PxRaycastHit* raycastHits = mDesc.queryMemory.userRaycastTouchBuffer;					PX_UNUSED(raycastHits);
-	PxRaycastQueryResult* raycastResults = mDesc.queryMemory.userRaycastResultBuffer;		PX_UNUSED(raycastResults);
-	PxU32 raycastHitsSize = mDesc.queryMemory.raycastTouchBufferSize;						PX_UNUSED(raycastHitsSize);
+	// setup local pointers to the output buffers of the chunk
+	PxRaycastHit* raycastHits = chunk.raycastHits;
+	PxRaycastQueryResult* raycastResults = chunk.raycastResults;
+	const PxU32 raycastHitsSize = chunk.raycastHitsSize;
 
-	PxOverlapHit* overlapHits = mDesc.queryMemory.userOverlapTouchBuffer;					PX_UNUSED(overlapHits);
-	PxOverlapQueryResult* overlapResults = mDesc.queryMemory.userOverlapResultBuffer;		PX_UNUSED(overlapResults);
-	PxU32 overlapHitsSize = mDesc.queryMemory.overlapTouchBufferSize;						PX_UNUSED(overlapHitsSize);
+	PxOverlapHit* overlapHits = chunk.overlapHits;
+	PxOverlapQueryResult* overlapResults = chunk.overlapResults;
+	const PxU32 overlapHitsSize = chunk.overlapHitsSize;
 
-	PxSweepHit* sweepHits = mDesc.queryMemory.userSweepTouchBuffer;							PX_UNUSED(sweepHits);
-	PxSweepQueryResult* sweepResults = mDesc.queryMemory.userSweepResultBuffer;				PX_UNUSED(sweepResults);
-	PxU32 sweepHitsSize = mDesc.queryMemory.sweepTouchBufferSize;							PX_UNUSED(sweepHitsSize);
+	PxSweepHit* sweepHits = chunk.sweepHits;
+	PxSweepQueryResult* sweepResults = chunk.sweepResults;
+	const PxU32 sweepHitsSize = chunk.sweepHitsSize;
 
 	BatchQueryFilterData bfd(mDesc.filterShaderData, mDesc.filterShaderDataSize, mDesc.preFilterShader, mDesc.postFilterShader);
 
-	// data declarations for double buffering the input stream
-	PxU32 curQueryOffset = 0; // first query starts at 0
-	if (mPrevOffset == eTERMINAL) // except if zero queries were queued
-	{
-		finalizeExecute();
-		return;
-	}
-
+	PxU32 curQueryOffset = chunk.startOffset;
 	PxU32 hitsSpaceLeft; PX_UNUSED(hitsSpaceLeft);
 
 	// ====================== parse and execute the batch query memory stream ====================== 
-	PxU32 queryCount = 0;
-	do {
+	for(PxU32 queryCount = 0; queryCount < chunk.nbQueries; queryCount++)
+	{
 		// parse a query from the input stream, create a stream reader at current double buffer
 		BatchQueryStreamReader reader(mStream.begin()+curQueryOffset);
 		BatchStreamHeader& h = *reader.read<BatchStreamHeader>();
 		if (h.fd.clientId == 0)
 			h.fd.clientId = clientId; // override a zero clientId with PxBatchQueryDesc.ownerClient
 
+		if (mDesc.raycastPackets && isPacketRaycast(h) && queryCount+1 < chunk.nbQueries &&
+			isPacketRaycast(*reinterpret_cast<const BatchStreamHeader*>(mStream.begin()+h.nextQueryOffset)))
+		{
+			// ====================== consecutive raycasts without touches go through the scene as a packet =====================
+			const MultiQueryInput* inputs[Sq::SQ_RAY_PACKET_SIZE];
+			const BatchStreamHeader* headers[Sq::SQ_RAY_PACKET_SIZE];
+			const PxQueryFilterData* filterData[Sq::SQ_RAY_PACKET_SIZE];
+			PxHitFlags hitFlags[Sq::SQ_RAY_PACKET_SIZE];
+			PxU32 nbRays = 0;
+			while(1)
+			{
+				BatchQueryStreamReader rayReader(mStream.begin()+curQueryOffset);
+				BatchStreamHeader& rh = *rayReader.read<BatchStreamHeader>();
+				if (rh.fd.clientId == 0)
+					rh.fd.clientId = clientId;
+				headers[nbRays] = &rh;
+				filterData[nbRays] = &rh.fd;
+				hitFlags[nbRays] = rh.hitFlags;
+				inputs[nbRays] = readQueryInput(rayReader);
+				nbRays++;
+				curQueryOffset = rh.nextQueryOffset;
+
+				if(nbRays == Sq::SQ_RAY_PACKET_SIZE || queryCount+nbRays == chunk.nbQueries ||
+					!isPacketRaycast(*reinterpret_cast<const BatchStreamHeader*>(mStream.begin()+curQueryOffset)))
+					break;
+			}
+			Ps::prefetchLine(mStream.begin() + curQueryOffset);
+
+			PxRaycastBuffer hits[Sq::SQ_RAY_PACKET_SIZE];
+			mNpScene->NpScene::multiRaycastPacket(nbRays, inputs, hits, hitFlags, filterData, &bfd);
+			for(PxU32 i=0;i<nbRays;i++)
+			{
+				hits[i].touches = raycastHits; // as for the single raycasts, there are no touches
+				writeStatus<PxRaycastQueryResult, PxRaycastHit>(raycastResults++, hits[i], headers[i]->userData, false);
+			}
+
+			queryCount += nbRays - 1;
+			PX_ASSERT(headers[nbRays-1]->nextQueryOffset != eTERMINAL || queryCount+1 == chunk.nbQueries);
+			continue;
+		}
+
 		curQueryOffset = h.nextQueryOffset;
 		Ps::prefetchLine(mStream.begin() + curQueryOffset);
 		
@@ -388,7 +392,7 @@ void NpBatchQuery::execute()
 			// =============== Current query is a raycast =====================
 			case QTypeROS::eRAYCAST:
 			{
-				PxU32 nbRaycastHits = PxU32(raycastHits - mDesc.queryMemory.userRaycastTouchBuffer);
+				PxU32 nbRaycastHits = PxU32(raycastHits - chunk.raycastHits);
 				PX_ASSERT(nbRaycastHits <= raycastHitsSize);
 				hitsSpaceLeft = raycastHitsSize - nbRaycastHits;
 				PxOverflowBuffer<PxRaycastHit> hits(raycastHits, PxMin<PxU32>(h.maxTouchHits, hitsSpaceLeft));
@@ -401,7 +405,7 @@ void NpBatchQuery::execute()
 			// ================ Current query is an overlap ====================
 			case QTypeROS::eOVERLAP:
 			{
-				PxU32 nbOverlapHits = PxU32(overlapHits - mDesc.queryMemory.userOverlapTouchBuffer);
+				PxU32 nbOverlapHits = PxU32(overlapHits - chunk.overlapHits);
 				PX_ASSERT(nbOverlapHits <= overlapHitsSize);
 				hitsSpaceLeft = overlapHitsSize - nbOverlapHits;
 				PxOverflowBuffer<PxOverlapHit> hits(overlapHits, PxMin<PxU32>(h.maxTouchHits, hitsSpaceLeft));
@@ -414,8 +418,7 @@ void NpBatchQuery::execute()
 			// ================== Current query is a sweep =========================
 			case QTypeROS::eSWEEP:
 			{
-
-				PxU32 nbSweepHits = PxU32(sweepHits - mDesc.queryMemory.userSweepTouchBuffer);
+				PxU32 nbSweepHits = PxU32(sweepHits - chunk.sweepHits);
 				PX_ASSERT(nbSweepHits <= sweepHitsSize);
 				hitsSpaceLeft = sweepHitsSize - nbSweepHits;
 				PxOverflowBuffer<PxSweepHit> hits(sweepHits, PxMin<PxU32>(h.maxTouchHits, hitsSpaceLeft));
@@ -428,15 +431,323 @@ void NpBatchQuery::execute()
 				PX_ALWAYS_ASSERT_MESSAGE("Unexpected batch query type (raycast/overlap/sweep).");
 		}
 
-		if (h.nextQueryOffset == eTERMINAL) // end of stream
-			// AP: previously also had a break on hitCount==-1 which is aborted due to out of space
-			// abort stream parsing if we ran into an aborted query (hitCount==-1).. but it was easier to just continue
-			// the perf implications for aborted queries are not a significant consideration and this allows to avoid
-			// writing special case code for filling the query buffers after aborted query
-			break;
-		#undef MULTIQ
-		queryCount++;
-	} while (queryCount < 1000000);
+		// AP: previously also had a break on hitCount==-1 which is aborted due to out of space
+		// abort stream parsing if we ran into an aborted query (hitCount==-1).. but it was easier to just continue
+		// the perf implications for aborted queries are not a significant consideration and this allows to avoid
+		// writing special case code for filling the query buffers after aborted query
+		PX_ASSERT(h.nextQueryOffset != eTERMINAL || queryCount+1 == chunk.nbQueries);
+	}
+}
+
+// Queries below this count per chunk aren't worth a task
+static const PxU32 gBatchQueryMinQueriesPerChunk = 16;
+// Chunks per thread, the cost of the queries varies a lot so the helpers need a few to balance
+static const PxU32 gBatchQueryChunksPerThread = 4;
+
+namespace
+{
+	struct ParallelQueryContext
+	{
+		NpBatchQuery*			mQuery;
+		const BatchQueryChunk*	mChunks;
+	};
+}
+
+void NpBatchQuery::runQueryChunks(void* context, PxU32 start, PxU32 nb)
+{
+	const ParallelQueryContext& ctx = *reinterpret_cast<const ParallelQueryContext*>(context);
+	for(PxU32 i=start;i<start+nb;i++)
+		ctx.mQuery->runQueries(ctx.mChunks[i]);
+}
+
+// Copies the touches of a query from the scratch buffer of its chunk to the user buffer, keeping what fits like execute() does
+template<typename ResultType, typename HitType>
+static void mergeTouches(ResultType& res, PxU16 maxTouchHits, HitType* userHits, PxU32 userHitsSize, PxU32& nbUsed)
+{
+	const PxU32 hitsSpaceLeft = userHitsSize - nbUsed;
+	bool overflow = res.queryStatus == PxBatchQueryStatus::eOVERFLOW;
+	PxU32 nbTouches = res.nbTouches;
+	if(nbTouches > hitsSpaceLeft)
+	{
+		nbTouches = hitsSpaceLeft;
+		overflow = true;
+	}
+	overflow |= (hitsSpaceLeft == 0 && maxTouchHits > 0);
+
+	if(nbTouches)
+		PxMemCopy(userHits + nbUsed, res.touches, sizeof(HitType)*nbTouches);
+
+	res.nbTouches = nbTouches;
+	res.queryStatus = PxU8(overflow ? PxBatchQueryStatus::eOVERFLOW : PxBatchQueryStatus::eSUCCESS);
+	res.touches = (overflow && nbTouches == 0) ? NULL : userHits + nbUsed;
+	nbUsed += nbTouches;
+}
+
+void NpBatchQuery::runParallel(PxCpuDispatcher& dispatcher, PxU32 nbChunks)
+{
+	const PxU32 nbQueries = mNbRaycasts + mNbOverlaps + mNbSweeps;
+	const PxBatchQueryMemory& mem = mDesc.queryMemory;
+
+	// Split the queries evenly by count. A chunk never keeps more touches than the user buffer holds, so the scratch
+	// buffer of a chunk is bounded by the smallest of the user buffer size and the touches its queries can report.
+	Ps::Array<BatchQueryChunk> chunks;
+	chunks.resize(nbChunks);
+
+	PxU32 curQueryOffset = 0;
+	PxU32 nbRaycasts = 0, nbOverlaps = 0, nbSweeps = 0;
+	PxU32 totalRaycastHits = 0, totalOverlapHits = 0, totalSweepHits = 0;
+	for(PxU32 i=0;i<nbChunks;i++)
+	{
+		BatchQueryChunk& chunk = chunks[i];
+		chunk.startOffset = curQueryOffset;
+		chunk.nbQueries = (nbQueries*(i+1))/nbChunks - (nbQueries*i)/nbChunks;
+		chunk.raycastResults = mem.userRaycastResultBuffer + nbRaycasts;
+		chunk.overlapResults = mem.userOverlapResultBuffer + nbOverlaps;
+		chunk.sweepResults = mem.userSweepResultBuffer + nbSweeps;
+		chunk.raycastHitsSize = chunk.overlapHitsSize = chunk.sweepHitsSize = 0;
+
+		for(PxU32 q=0;q<chunk.nbQueries;q++)
+		{
+			const BatchStreamHeader& h = *reinterpret_cast<const BatchStreamHeader*>(mStream.begin()+curQueryOffset);
+			switch (h.hitTypeId)
+			{
+				case QTypeROS::eRAYCAST:	nbRaycasts++;	chunk.raycastHitsSize += h.maxTouchHits;	break;
+				case QTypeROS::eOVERLAP:	nbOverlaps++;	chunk.overlapHitsSize += h.maxTouchHits;	break;
+				case QTypeROS::eSWEEP:		nbSweeps++;		chunk.sweepHitsSize += h.maxTouchHits;		break;
+				default:
+					PX_ALWAYS_ASSERT_MESSAGE("Unexpected batch query type (raycast/overlap/sweep).");
+			}
+			curQueryOffset = h.nextQueryOffset;
+		}
+
+		chunk.raycastHitsSize = PxMin(chunk.raycastHitsSize, mem.raycastTouchBufferSize);
+		chunk.overlapHitsSize = PxMin(chunk.overlapHitsSize, mem.overlapTouchBufferSize);
+		chunk.sweepHitsSize = PxMin(chunk.sweepHitsSize, mem.sweepTouchBufferSize);
+		totalRaycastHits += chunk.raycastHitsSize;
+		totalOverlapHits += chunk.overlapHitsSize;
+		totalSweepHits += chunk.sweepHitsSize;
+	}
+	PX_ASSERT(curQueryOffset == eTERMINAL);
+	PX_ASSERT(nbRaycasts == mNbRaycasts && nbOverlaps == mNbOverlaps && nbSweeps == mNbSweeps);
+
+	// One scratch block for the touches of all the chunks, the hit sizes are multiples of 16 so every array stays aligned
+	const PxU32 scratchSize = sizeof(PxRaycastHit)*totalRaycastHits + sizeof(PxOverlapHit)*totalOverlapHits + sizeof(PxSweepHit)*totalSweepHits;
+	char* scratch = scratchSize ? reinterpret_cast<char*>(PX_ALLOC_TEMP(scratchSize, "NpBatchQuery::executeParallel")) : NULL;
+	PxRaycastHit* raycastScratch = reinterpret_cast<PxRaycastHit*>(scratch);
+	PxOverlapHit* overlapScratch = reinterpret_cast<PxOverlapHit*>(raycastScratch + totalRaycastHits);
+	PxSweepHit* sweepScratch = reinterpret_cast<PxSweepHit*>(overlapScratch + totalOverlapHits);
+	for(PxU32 i=0;i<nbChunks;i++)
+	{
+		BatchQueryChunk& chunk = chunks[i];
+		chunk.raycastHits = raycastScratch;		raycastScratch += chunk.raycastHitsSize;
+		chunk.overlapHits = overlapScratch;		overlapScratch += chunk.overlapHitsSize;
+		chunk.sweepHits = sweepScratch;			sweepScratch += chunk.sweepHitsSize;
+	}
+
+	// The chunks are claimed one at a time, the cost of their queries varies a lot
+	ParallelQueryContext context;
+	context.mQuery = this;
+	context.mChunks = chunks.begin();
+	Cm::blockingParallelFor(&dispatcher, nbChunks, 1, 1, runQueryChunks, &context, "NpBatchQuery.executeParallel");
+
+	// Move the touches to the user buffers in query order
+	PxU32 nbRaycastHits = 0, nbOverlapHits = 0, nbSweepHits = 0;
+	PxRaycastQueryResult* raycastResults = mem.userRaycastResultBuffer;
+	PxOverlapQueryResult* overlapResults = mem.userOverlapResultBuffer;
+	PxSweepQueryResult* sweepResults = mem.userSweepResultBuffer;
+	curQueryOffset = 0;
+	for(PxU32 q=0;q<nbQueries;q++)
+	{
+		const BatchStreamHeader& h = *reinterpret_cast<const BatchStreamHeader*>(mStream.begin()+curQueryOffset);
+		switch (h.hitTypeId)
+		{
+			case QTypeROS::eRAYCAST:
+				mergeTouches<PxRaycastQueryResult, PxRaycastHit>(*raycastResults++, h.maxTouchHits, mem.userRaycastTouchBuffer, mem.raycastTouchBufferSize, nbRaycastHits);
+				break;
+			case QTypeROS::eOVERLAP:
+				mergeTouches<PxOverlapQueryResult, PxOverlapHit>(*overlapResults++, h.maxTouchHits, mem.userOverlapTouchBuffer, mem.overlapTouchBufferSize, nbOverlapHits);
+				break;
+			case QTypeROS::eSWEEP:
+				mergeTouches<PxSweepQueryResult, PxSweepHit>(*sweepResults++, h.maxTouchHits, mem.userSweepTouchBuffer, mem.sweepTouchBufferSize, nbSweepHits);
+				break;
+			default:
+				PX_ALWAYS_ASSERT_MESSAGE("Unexpected batch query type (raycast/overlap/sweep).");
+		}
+		curQueryOffset = h.nextQueryOffset;
+	}
+
+	if(scratch)
+		PX_FREE(scratch);
+}
+
+// Raycasts that PxBatchQueryDesc::raycastOffload can execute, the offload only knows about the static shapes
+static PX_FORCE_INLINE bool isOffloadRaycast(const BatchStreamHeader& h)
+{
+	return isPacketRaycast(h) && (h.fd.flags & PxQueryFlag::eSTATIC) && !(h.fd.flags & PxQueryFlag::eDYNAMIC);
+}
+
+bool NpBatchQuery::runRaycastOffload()
+{
+	if(mNbOverlaps || mNbSweeps || mNbRaycasts < mDesc.raycastOffloadThreshold || mDesc.preFilterShader || mDesc.postFilterShader)
+		return false;
+
+	PxU32 curQueryOffset = 0;
+	for(PxU32 i=0;i<mNbRaycasts;i++)
+	{
+		const BatchStreamHeader& h = *reinterpret_cast<const BatchStreamHeader*>(mStream.begin()+curQueryOffset);
+		if(!isOffloadRaycast(h))
+			return false;
+		curQueryOffset = h.nextQueryOffset;
+	}
+	PX_ASSERT(curQueryOffset == eTERMINAL);
+
+	PxBatchQueryRaycast* raycasts = reinterpret_cast<PxBatchQueryRaycast*>(PX_ALLOC_TEMP(sizeof(PxBatchQueryRaycast)*mNbRaycasts, "NpBatchQuery::runRaycastOffload"));
+	curQueryOffset = 0;
+	for(PxU32 i=0;i<mNbRaycasts;i++)
+	{
+		BatchQueryStreamReader reader(mStream.begin()+curQueryOffset);
+		const BatchStreamHeader& h = *reader.read<BatchStreamHeader>();
+		const MultiQueryInput& input = *readQueryInput(reader);
+		PxBatchQueryRaycast& r = raycasts[i];
+		r.origin = *input.rayOrigin;
+		r.unitDir = *input.unitDir;
+		r.distance = input.maxDistance;
+		r.hitFlags = h.hitFlags;
+		r.filterData = h.fd;
+		if(r.filterData.clientId == 0)
+			r.filterData.clientId = mDesc.ownerClient; // override a zero clientId with PxBatchQueryDesc.ownerClient
+		r.userData = h.userData;
+		curQueryOffset = h.nextQueryOffset;
+	}
+
+	PxRaycastQueryResult* results = mDesc.queryMemory.userRaycastResultBuffer;
+	const bool done = mDesc.raycastOffload->raycast(*mNpScene, raycasts, mNbRaycasts, results);
+	if(done)
+	{
+		for(PxU32 i=0;i<mNbRaycasts;i++)
+		{
+			results[i].userData = raycasts[i].userData;
+			results[i].nbTouches = 0;
+			results[i].touches = NULL;
+			results[i].queryStatus = PxU8(PxBatchQueryStatus::eSUCCESS);
+		}
+	}
+
+	PX_FREE(raycasts);
+	return done;
+}
+
+void NpBatchQuery::execute()
+{
+	executeInternal(NULL);
+}
+
+void NpBatchQuery::executeParallel(PxCpuDispatcher& dispatcher)
+{
+	executeInternal(&dispatcher);
+}
+
+void NpBatchQuery::executeInternal(PxCpuDispatcher* dispatcher)
+{
+	NP_READ_CHECK(mNpScene);
+
+	if(mNbRaycasts)
+	{
+		PX_CHECK_AND_RETURN(mDesc.queryMemory.userRaycastResultBuffer!=NULL, "PxBatchQuery execute: userRaycastResultBuffer is NULL");
+		PX_CHECK_AND_RETURN(mDesc.queryMemory.raycastTouchBufferSize > 0 ? 
+			(mDesc.queryMemory.userRaycastTouchBuffer != NULL)	: true, "PxBatchQuery execute: userRaycastTouchBuffer is NULL");
+	}
+	if(mNbOverlaps)
+	{
+		PX_CHECK_AND_RETURN(mDesc.queryMemory.userOverlapResultBuffer!=NULL, "PxBatchQuery execute: userOverlapResultBuffer is NULL");
+		PX_CHECK_AND_RETURN(mDesc.queryMemory.overlapTouchBufferSize > 0 ? 
+			(mDesc.queryMemory.userOverlapTouchBuffer != NULL)	: true, "PxBatchQuery execute: userOverlapTouchBuffer is NULL");
+	}
+	if(mNbSweeps)
+	{
+		PX_CHECK_AND_RETURN(mDesc.queryMemory.userSweepResultBuffer!=NULL, "PxBatchQuery execute: userSweepResultBuffer is NULL");
+		PX_CHECK_AND_RETURN(mDesc.queryMemory.sweepTouchBufferSize > 0 ? 
+			(mDesc.queryMemory.userSweepTouchBuffer != NULL)	: true, "PxBatchQuery execute: userSweepTouchBuffer is NULL");
+	}
+
+	PX_SIMD_GUARD;
+
+	PX_PROFILE_ZONE("BatchedSceneQuery.execute", mNpScene->getContextId());
+	PxI32 ret = Ps::atomicCompareExchange(&mBatchQueryIsRunning, 1, 0);
+	if(ret == 1)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxBatchQuery::execute: This batch is already executing"); 
+		return;
+	}
+	else if(ret == -1)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxBatchQuery::execute: Another thread is still adding queries to this batch"); 
+		return;
+	}
+
+	resetResultBuffers();
+
+	// If PVD is connected and IS_PVD_SQ_ENABLED, record the offsets for queries in pvd buffers and run the queries on PPU
+	bool isSqCollectorLocked = false;
+	PX_UNUSED(isSqCollectorLocked);
+
+#if PX_SUPPORT_PVD	
+	PxU32 pvdRayQstartIdx = 0;
+	PxU32 pvdOverlapQstartIdx = 0;
+	PxU32 pvdSweepQstartIdx = 0;
+
+	Vd::ScbScenePvdClient& pvdClient = mNpScene->mScene.getScenePvdClient();
+	const bool needUpdatePvd = pvdClient.checkPvdDebugFlag() && (pvdClient.getScenePvdFlagsFast() & PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES);
+
+	if(needUpdatePvd)
+	{
+		mNpScene->getBatchedSqCollector().getLock().lock();
+		isSqCollectorLocked = true;
+	
+		pvdRayQstartIdx = mNpScene->getBatchedSqCollector().mAccumulatedRaycastQueries.size();
+		pvdOverlapQstartIdx = mNpScene->getBatchedSqCollector().mAccumulatedOverlapQueries.size();
+		pvdSweepQstartIdx = mNpScene->getBatchedSqCollector().mAccumulatedSweepQueries.size();
+	}
+#endif
+
+	if (mPrevOffset == eTERMINAL) // zero queries were queued
+	{
+#if PX_SUPPORT_PVD
+		if( isSqCollectorLocked )
+			mNpScene->getBatchedSqCollector().getLock().unlock();
+#endif
+		finalizeExecute();
+		return;
+	}
+
+	const PxU32 nbQueries = mNbRaycasts + mNbOverlaps + mNbSweeps;
+	PxU32 nbChunks = 1;
+	if(dispatcher && dispatcher->getWorkerCount())
+		nbChunks = PxMin((dispatcher->getWorkerCount() + 1)*gBatchQueryChunksPerThread, nbQueries/gBatchQueryMinQueriesPerChunk);
+
+	if(mDesc.raycastOffload && runRaycastOffload())
+	{
+		// all the raycasts were executed by the offload
+	}
+	else if(nbChunks > 1)
+		runParallel(*dispatcher, nbChunks);
+	else
+	{
+		// first query starts at 0, the results and touches go straight to the user buffers
+		BatchQueryChunk chunk;
+		chunk.startOffset = 0;
+		chunk.nbQueries = nbQueries;
+		chunk.raycastResults = mDesc.queryMemory.userRaycastResultBuffer;
+		chunk.raycastHits = mDesc.queryMemory.userRaycastTouchBuffer;
+		chunk.raycastHitsSize = mDesc.queryMemory.raycastTouchBufferSize;
+		chunk.overlapResults = mDesc.queryMemory.userOverlapResultBuffer;
+		chunk.overlapHits = mDesc.queryMemory.userOverlapTouchBuffer;
+		chunk.overlapHitsSize = mDesc.queryMemory.overlapTouchBufferSize;
+		chunk.sweepResults = mDesc.queryMemory.userSweepResultBuffer;
+		chunk.sweepHits = mDesc.queryMemory.userSweepTouchBuffer;
+		chunk.sweepHitsSize = mDesc.queryMemory.sweepTouchBufferSize;
+		runQueries(chunk);
+	}
 
 #if PX_SUPPORT_PVD
 	if( isSqCollectorLocked && needUpdatePvd)	
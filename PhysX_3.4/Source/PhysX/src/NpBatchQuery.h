@@ -44,6 +44,7 @@ namespace physx
 
 class NpSceneQueryManager;
 struct BatchStreamHeader;
+struct BatchQueryChunk;
 class NpScene;
 
 namespace Sq
@@ -115,6 +116,7 @@ public:
 
 	// PxBatchQuery interface
 	virtual	void							execute();
+	virtual	void							executeParallel(PxCpuDispatcher& dispatcher);
 	virtual void							release();
 	virtual	PxBatchQueryPreFilterShader		getPreFilterShader() const;
 	virtual	PxBatchQueryPostFilterShader	getPostFilterShader() const;
@@ -147,6 +149,11 @@ public:
 private:
 			void							resetResultBuffers();
 			void							finalizeExecute();
+			void							executeInternal(PxCpuDispatcher* dispatcher);
+			void							runQueries(const BatchQueryChunk& chunk);
+			void							runParallel(PxCpuDispatcher& dispatcher, PxU32 nbChunks);
+	static	void							runQueryChunks(void* context, PxU32 start, PxU32 nb);
+			bool							runRaycastOffload();
 			void							writeBatchHeader(const BatchStreamHeader& h);
 
 						NpScene*			mNpScene;
@@ -205,6 +205,11 @@ void NpFactory::registerParticles()
 	sCreateParticleFluidFn = &::createParticleFluid;
 }
 
+bool NpFactory::areParticlesRegistered()
+{
+	return sCreateParticleSystemFn!=NULL;
+}
+
 void NpFactory::addParticleSystem(PxParticleSystem* ps, bool lock)
 {	
 	addToTracking<PxActor>(mActorTracking, ps, mTrackingMutex, lock);
@@ -836,12 +841,7 @@ NpShape* NpFactory::createShape(const PxGeometry& geometry,
 		NpMaterial::getMaterialIndices(materials, materialIndices.begin(), materialCount);
 	}
 
-	NpShape* npShape;
-	{
-		Ps::Mutex::ScopedLock lock(mShapePoolLock);
-		PxU16* mi = materialIndices.begin(); // required to placate pool constructor arg passing
-		npShape = mShapePool.construct(geometry, shapeFlags, mi, materialCount, isExclusive);
-	}
+	NpShape* npShape = PX_PLACEMENT_NEW(mShapePool.allocate(), NpShape)(geometry, shapeFlags, materialIndices.begin(), materialCount, isExclusive);
 
 	if(!npShape)
 		return NULL;
@@ -857,7 +857,6 @@ NpShape* NpFactory::createShape(const PxGeometry& geometry,
 void NpFactory::releaseShapeToPool(NpShape& shape)
 {
 	PX_ASSERT(shape.getBaseFlags() & PxBaseFlag::eOWNS_MEMORY);
-	Ps::Mutex::ScopedLock lock(mShapePoolLock);
 	mShapePool.destroy(&shape);
 }
 
@@ -879,17 +878,24 @@ PxU32 NpFactory::getShapes(PxShape** userBuffer, PxU32 bufferSize, PxU32 startIn
 	return count;
 }
 
+void NpFactory::reserve(PxU32 nbRigidDynamics, PxU32 nbRigidStatics, PxU32 nbShapes)
+{
+	mRigidDynamicPool.reserve(nbRigidDynamics);
+	mRigidStaticPool.reserve(nbRigidStatics);
+	mShapePool.reserve(nbShapes);
+
+	// the tracking sets would otherwise grow while the objects are created
+	Ps::Mutex::ScopedLock lock(mTrackingMutex);
+	mActorTracking.reserve(mActorTracking.size() + nbRigidDynamics + nbRigidStatics);
+	mShapeTracking.reserve(mShapeTracking.size() + nbShapes);
+}
+
 
 PxRigidStatic* NpFactory::createRigidStatic(const PxTransform& pose)
 {
 	PX_CHECK_AND_RETURN_NULL(pose.isValid(), "pose is not valid. createRigidStatic returns NULL.");
 
-	NpRigidStatic* npActor;
-
-	{
-		Ps::Mutex::ScopedLock lock(mRigidStaticPoolLock);
-		npActor = mRigidStaticPool.construct(pose);
-	}
+	NpRigidStatic* npActor = PX_PLACEMENT_NEW(mRigidStaticPool.allocate(), NpRigidStatic)(pose);
 
 	addRigidStatic(npActor);
 	return npActor;
@@ -898,7 +904,6 @@ PxRigidStatic* NpFactory::createRigidStatic(const PxTransform& pose)
 void NpFactory::releaseRigidStaticToPool(NpRigidStatic& rigidStatic)
 {
 	PX_ASSERT(rigidStatic.getBaseFlags() & PxBaseFlag::eOWNS_MEMORY);
-	Ps::Mutex::ScopedLock lock(mRigidStaticPoolLock);
 	mRigidStaticPool.destroy(&rigidStatic);
 }
 
@@ -906,11 +911,7 @@ PxRigidDynamic* NpFactory::createRigidDynamic(const PxTransform& pose)
 {
 	PX_CHECK_AND_RETURN_NULL(pose.isValid(), "pose is not valid. createRigidDynamic returns NULL.");
 
-	NpRigidDynamic* npBody;
-	{
-		Ps::Mutex::ScopedLock lock(mRigidDynamicPoolLock);
-		npBody = mRigidDynamicPool.construct(pose);
-	}
+	NpRigidDynamic* npBody = PX_PLACEMENT_NEW(mRigidDynamicPool.allocate(), NpRigidDynamic)(pose);
 	addRigidDynamic(npBody);
 	return npBody;
 }
@@ -919,7 +920,6 @@ PxRigidDynamic* NpFactory::createRigidDynamic(const PxTransform& pose)
 void NpFactory::releaseRigidDynamicToPool(NpRigidDynamic& rigidDynamic)
 {
 	PX_ASSERT(rigidDynamic.getBaseFlags() & PxBaseFlag::eOWNS_MEMORY);
-	Ps::Mutex::ScopedLock lock(mRigidDynamicPoolLock);
 	mRigidDynamicPool.destroy(&rigidDynamic);
 }
 
@@ -34,6 +34,7 @@
 #include "PsPool.h"
 #include "PsMutex.h"
 #include "PsHashSet.h"
+#include "NpFactoryPool.h"
 
 #include "GuMeshFactory.h"
 #include "CmPhysXCommon.h"
@@ -132,6 +133,7 @@ public:
 	static		void							registerArticulations();
 	static		void							registerCloth();
 	static		void							registerParticles();
+	static		bool							areParticlesRegistered();
 
 				void							release();
 
@@ -159,6 +161,8 @@ public:
 				PxU32							getNbShapes() const;
 				PxU32							getShapes(PxShape** userBuffer, PxU32 bufferSize, PxU32 startIndex)	const;
 
+				void							reserve(PxU32 nbRigidDynamics, PxU32 nbRigidStatics, PxU32 nbShapes);
+
 				void							addConstraint(PxConstraint*, bool lock=true);
 				PxConstraint*					createConstraint(PxRigidActor* actor0, PxRigidActor* actor1, PxConstraintConnector& connector, const PxConstraintShaderTable& shaders, PxU32 dataSize);
 				void							releaseConstraintToPool(NpConstraint&);
@@ -248,14 +252,10 @@ private:
 				Ps::HashSet<PxActor*>			mActorTracking;				
 				Ps::CoalescedHashSet<PxShape*>	mShapeTracking;
 
-				Ps::Pool2<NpRigidDynamic, 4096>	mRigidDynamicPool;
-				Ps::Mutex						mRigidDynamicPoolLock;
-
-				Ps::Pool2<NpRigidStatic, 4096>	mRigidStaticPool;
-				Ps::Mutex						mRigidStaticPoolLock;
-
-				Ps::Pool2<NpShape, 4096>		mShapePool;
-				Ps::Mutex						mShapePoolLock;
+				// the objects that streaming threads create in bulk, cached per thread (see NpFactoryPool)
+				NpFactoryPool<NpRigidDynamic>	mRigidDynamicPool;
+				NpFactoryPool<NpRigidStatic>	mRigidStaticPool;
+				NpFactoryPool<NpShape>			mShapePool;
 
 				Ps::Pool2<NpAggregate, 4096>	mAggregatePool;
 				Ps::Mutex						mAggregatePoolLock;
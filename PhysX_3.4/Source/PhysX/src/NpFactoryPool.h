@@ -0,0 +1,159 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_NP_FACTORY_POOL
+#define PX_PHYSICS_NP_FACTORY_POOL
+
+#include "PsPool.h"
+#include "PsMutex.h"
+#include "PsThread.h"
+#include "foundation/PxMemory.h"
+#include "CmPhysXCommon.h"
+
+namespace physx
+{
+
+/*
+Pool for the objects created by the factory from any thread.
+
+Each thread keeps a small cache of free elements, so creating and releasing objects only takes the lock of the pool
+when the cache of the calling thread runs empty or full, and then moves half a cache at once. An object can be
+released from another thread than the one that created it, its memory then goes to the cache of the releasing thread.
+
+reserve() preallocates the slabs, so that the next objects don't allocate at all.
+*/
+template <class T>
+class NpFactoryPool
+{
+	PX_NOCOPY(NpFactoryPool)
+
+	static const PxU32 CacheSize = 64;
+
+	struct ThreadCache
+	{
+		T*				mElements[CacheSize];
+		PxU32			mSize;
+		ThreadCache*	mNext;
+	};
+
+public:
+	NpFactoryPool() : mCaches(NULL), mTlsIndex(Ps::TlsAlloc())
+	{
+	}
+
+	~NpFactoryPool()
+	{
+		// the cached elements are free, they must be back in the pool before it destroys the live ones
+		while(mCaches)
+		{
+			ThreadCache* next = mCaches->mNext;
+			for(PxU32 i=0;i<mCaches->mSize;i++)
+				mPool.deallocate(mCaches->mElements[i]);
+			PX_FREE(mCaches);
+			mCaches = next;
+		}
+		Ps::TlsFree(mTlsIndex);
+	}
+
+	// Allocate space for single object
+	PX_FORCE_INLINE T* allocate()
+	{
+		ThreadCache& cache = getThreadCache();
+		if(!cache.mSize)
+		{
+			Ps::Mutex::ScopedLock lock(mLock);
+			while(cache.mSize < CacheSize/2)
+				cache.mElements[cache.mSize++] = mPool.allocate();
+		}
+
+		T* p = cache.mElements[--cache.mSize];
+#if PX_CHECKED
+		// same as Ps::Pool, so that the meta data checks also see the recycled elements
+		PxMemSet(p, 0xcd, PxU32(sizeof(T)));
+#endif
+		return p;
+	}
+
+	PX_FORCE_INLINE void destroy(T* const p)
+	{
+		if(p)
+		{
+			p->~T();
+
+			ThreadCache& cache = getThreadCache();
+			if(cache.mSize == CacheSize)
+			{
+				Ps::Mutex::ScopedLock lock(mLock);
+				while(cache.mSize > CacheSize/2)
+					mPool.deallocate(cache.mElements[--cache.mSize]);
+			}
+			cache.mElements[cache.mSize++] = p;
+		}
+	}
+
+	// Makes sure the pool holds at least count free elements, not counting the thread caches
+	void reserve(PxU32 count)
+	{
+		Ps::Mutex::ScopedLock lock(mLock);
+
+		Ps::Array<T*> elements;
+		elements.reserve(count);
+		for(PxU32 i=0;i<count;i++)
+			elements.pushBack(mPool.allocate());
+		while(elements.size())
+			mPool.deallocate(elements.popBack());
+	}
+
+private:
+	PX_FORCE_INLINE ThreadCache& getThreadCache()
+	{
+		ThreadCache* cache = reinterpret_cast<ThreadCache*>(Ps::TlsGet(mTlsIndex));
+		if(!cache)
+		{
+			cache = reinterpret_cast<ThreadCache*>(PX_ALLOC(sizeof(ThreadCache), "NpFactoryPool::ThreadCache"));
+			cache->mSize = 0;
+			Ps::TlsSet(mTlsIndex, cache);
+
+			Ps::Mutex::ScopedLock lock(mLock);
+			cache->mNext = mCaches;
+			mCaches = cache;
+		}
+		return *cache;
+	}
+
+	Ps::Pool2<T, 4096>	mPool;
+	Ps::Mutex			mLock;
+	ThreadCache*		mCaches;		// Every thread cache, released along with the pool
+	const PxU32			mTlsIndex;
+};
+
+}
+
+#endif
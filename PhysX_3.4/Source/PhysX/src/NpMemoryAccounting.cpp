@@ -0,0 +1,181 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "NpMemoryAccounting.h"
+#include "PsFoundation.h"
+#include "PsUtilities.h"
+#include "PsArray.h"
+#include "foundation/PxMemory.h"
+#include <string.h>
+
+using namespace physx;
+
+namespace
+{
+	struct CategoryPath
+	{
+		const char*	directory;
+		PxU32		category;
+	};
+
+	// first match wins, so the specific LowLevel directories come before LowLevel itself
+	const CategoryPath gCategoryPaths[] =
+	{
+		{ "LowLevelAABB",		PxSceneMemoryCategory::eBROADPHASE	},
+		{ "LowLevelDynamics",	PxSceneMemoryCategory::eSOLVER		},
+		{ "LowLevelCloth",		PxSceneMemoryCategory::eCLOTH		},
+		{ "LowLevelParticles",	PxSceneMemoryCategory::ePARTICLES	},
+		{ "SceneQuery",			PxSceneMemoryCategory::eSCENE_QUERY	},
+		{ "LowLevel",			PxSceneMemoryCategory::eNARROWPHASE	},
+		{ "particles",			PxSceneMemoryCategory::ePARTICLES	},
+		{ "cloth",				PxSceneMemoryCategory::eCLOTH		}
+	};
+
+	bool matchesDirectory(const char* filename, const char* directory)
+	{
+		const size_t length = strlen(directory);
+		for(const char* found = strstr(filename, directory); found; found = strstr(found + 1, directory))
+		{
+			// whole directory names only, "LowLevel" must not match "LowLevelAABB"
+			const bool start = found == filename || found[-1] == '/' || found[-1] == '\\';
+			const bool end = found[length] == '/' || found[length] == '\\';
+			if(start && end)
+				return true;
+		}
+		return false;
+	}
+}
+
+NpMemoryAccounting::NpMemoryAccounting()
+{
+}
+
+NpMemoryAccounting::~NpMemoryAccounting()
+{
+}
+
+PxU32 NpMemoryAccounting::getCategory(const char* filename)
+{
+	if(!filename)
+		return PxSceneMemoryCategory::eOTHER;
+
+	const CategoryMap::Entry* entry = mCategories.find(filename);
+	if(entry)
+		return entry->second;
+
+	PxU32 category = PxSceneMemoryCategory::eOTHER;
+	for(PxU32 i = 0; i < PX_ARRAY_SIZE(gCategoryPaths); i++)
+	{
+		if(matchesDirectory(filename, gCategoryPaths[i].directory))
+		{
+			category = gCategoryPaths[i].category;
+			break;
+		}
+	}
+	mCategories.insert(filename, category);
+	return category;
+}
+
+void NpMemoryAccounting::onAllocation(size_t size, const char* typeName, const char* filename, int line, void* allocatedMemory)
+{
+	PX_UNUSED(typeName);
+	PX_UNUSED(line);
+
+	const PxU64 context = Ps::getFoundation().getAllocationContext();
+	if(!context || !allocatedMemory)
+		return;
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+
+	Allocation allocation;
+	allocation.context = context;
+	allocation.size = size;
+	allocation.category = getCategory(filename);
+	mAllocations[allocatedMemory] = allocation;
+
+	// value initialized, so zeroed on the first allocation of the context
+	PxSceneMemoryUsage& usage = mUsage[context];
+	usage.bytes[allocation.category] += size;
+	usage.total += size;
+	usage.peak = PxMax(usage.peak, usage.total);
+	usage.nbAllocations++;
+}
+
+void NpMemoryAccounting::onDeallocation(void* allocatedMemory)
+{
+	if(!allocatedMemory)
+		return;
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+
+	const AllocationMap::Entry* allocation = mAllocations.find(allocatedMemory);
+	if(!allocation)
+		return;
+
+	if(mUsage.find(allocation->second.context))
+	{
+		PxSceneMemoryUsage& usage = mUsage[allocation->second.context];
+		usage.bytes[allocation->second.category] -= allocation->second.size;
+		usage.total -= allocation->second.size;
+		usage.nbAllocations--;
+	}
+	mAllocations.erase(allocatedMemory);
+}
+
+bool NpMemoryAccounting::getUsage(PxU64 context, PxSceneMemoryUsage& usage) const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+
+	const UsageMap::Entry* entry = mUsage.find(context);
+	if(!entry)
+	{
+		PxMemZero(&usage, sizeof(usage));
+		return false;
+	}
+	usage = entry->second;
+	return true;
+}
+
+void NpMemoryAccounting::releaseContext(PxU64 context)
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+
+	// a new scene can get the same id, it must not inherit the leftovers
+	Ps::Array<const void*, Ps::RawAllocator> leftovers;
+	for(AllocationMap::Iterator it = mAllocations.getIterator(); !it.done(); ++it)
+	{
+		if(it->second.context == context)
+			leftovers.pushBack(it->first);
+	}
+	for(PxU32 i = 0; i < leftovers.size(); i++)
+		mAllocations.erase(leftovers[i]);
+
+	mUsage.erase(context);
+}
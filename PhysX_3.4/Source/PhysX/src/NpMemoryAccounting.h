@@ -0,0 +1,85 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_NP_MEMORYACCOUNTING_H
+#define PX_PHYSICS_NP_MEMORYACCOUNTING_H
+
+#include "CmPhysXCommon.h"
+#include "PxMemoryBudget.h"
+#include "PsBroadcast.h"
+#include "PsHashMap.h"
+#include "PsMutex.h"
+#include "PsUserAllocated.h"
+
+namespace physx
+{
+// Accounts the allocations made for each scene, identified by the allocation context of the allocating thread
+// (the scene context id, set by the simulation tasks and the stepping calls).
+// Installed as a foundation allocation listener when PxCreatePhysics is asked to track allocations.
+class NpMemoryAccounting : public Ps::AllocationListener, public Ps::UserAllocated
+{
+	PX_NOCOPY(NpMemoryAccounting)
+
+public:
+	NpMemoryAccounting();
+	virtual ~NpMemoryAccounting();
+
+	virtual void onAllocation(size_t size, const char* typeName, const char* filename, int line, void* allocatedMemory);
+	virtual void onDeallocation(void* allocatedMemory);
+
+	// Returns false if nothing was allocated for the context yet, usage is zeroed then
+	bool getUsage(PxU64 context, PxSceneMemoryUsage& usage) const;
+
+	// Forgets the context, when its scene is released. Its allocations still alive are no longer accounted
+	void releaseContext(PxU64 context);
+
+private:
+	struct Allocation
+	{
+		PxU64	context;
+		size_t	size;
+		PxU32	category;
+	};
+
+	// Ps::RawAllocator bypasses the foundation allocator, so the maps don't call back into the listener
+	typedef Ps::HashMap<const void*, Allocation, Ps::Hash<const void*>, Ps::RawAllocator> AllocationMap;
+	typedef Ps::HashMap<PxU64, PxSceneMemoryUsage, Ps::Hash<PxU64>, Ps::RawAllocator> UsageMap;
+	typedef Ps::HashMap<const void*, PxU32, Ps::Hash<const void*>, Ps::RawAllocator> CategoryMap;
+
+	PxU32 getCategory(const char* filename);
+
+	AllocationMap		mAllocations;
+	UsageMap			mUsage;
+	CategoryMap			mCategories;	// category of each source file, keyed by the __FILE__ pointer
+	mutable Ps::Mutex	mMutex;
+};
+}
+
+#endif
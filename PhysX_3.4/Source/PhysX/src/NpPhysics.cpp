@@ -59,6 +59,7 @@
 #include "PsString.h"
 #include "PvdPhysicsClient.h"
 #include "SqPruningStructure.h"
+#include "NpMemoryAccounting.h"
 
 //~PX_SERIALIZATION
 
@@ -96,13 +97,19 @@ NpPhysics::NpPhysics(const PxTolerancesScale& scale, const PxvOffsetTable& pxvOf
 	, mSceneRunning(NULL)
 	, mPhysics(scale, pxvOffsetTable)
 	, mDeletionListenersExist(false)
+	, mMemoryAccounting(NULL)
 #if PX_SUPPORT_GPU_PHYSX
 	, mNbRegisteredGpuClients(0)
 	, mPhysicsGpu(*this)	
 #endif	
 {
 
-	PX_UNUSED(trackOutstandingAllocations);
+	if(trackOutstandingAllocations)
+	{
+		mMemoryAccounting = PX_NEW(NpMemoryAccounting);
+		shdfnd::getFoundation().registerAllocationListener(*mMemoryAccounting);
+		shdfnd::getFoundation().setAllocationContextEnabled(true);
+	}
 
 	//mMasterMaterialTable.reserve(10);
 		
@@ -129,7 +136,12 @@ NpPhysics::~NpPhysics()
 	PxU32 nbScenes = mSceneArray.size();
 	NpScene** scenes = mSceneArray.begin();
 	for(PxU32 i=0;i<nbScenes;i++)
+	{
+		const PxU64 contextId = scenes[i]->getContextId();
 		PX_DELETE_AND_RESET(scenes[i]);
+		if(mMemoryAccounting)
+			mMemoryAccounting->releaseContext(contextId);
+	}
 	mSceneArray.clear();
 
 	//PxU32 matCount = mMasterMaterialTable.size();
@@ -162,6 +174,13 @@ NpPhysics::~NpPhysics()
 		PX_DELETE(delListenerEntries[i].second);
 	}
 	mDeletionListenerMap.clear();
+
+	if(mMemoryAccounting)
+	{
+		shdfnd::getFoundation().setAllocationContextEnabled(false);
+		shdfnd::getFoundation().deregisterAllocationListener(*mMemoryAccounting);
+		PX_DELETE_AND_RESET(mMemoryAccounting);
+	}
 }
 
 void NpPhysics::initOffsetTables(PxvOffsetTable& pxvOffsetTable)
@@ -364,7 +383,10 @@ void NpPhysics::releaseSceneInternal(PxScene& scene)
 		if(mSceneArray[i]==pScene)
 		{
 			mSceneArray.replaceWithLast(i);
+			const PxU64 contextId = pScene->getContextId();
 			PX_DELETE_AND_RESET(pScene);
+			if(mMemoryAccounting)
+				mMemoryAccounting->releaseContext(contextId);
 			return;
 		}
 	}
@@ -415,6 +437,11 @@ PxU32 NpPhysics::getNbShapes()	const
 	return NpFactory::getInstance().getNbShapes();
 }
 
+void NpPhysics::reserve(PxU32 nbRigidDynamics, PxU32 nbRigidStatics, PxU32 nbShapes)
+{
+	NpFactory::getInstance().reserve(nbRigidDynamics, nbRigidStatics, nbShapes);
+}
+
 PxU32 NpPhysics::getShapes(PxShape** userBuffer, PxU32 bufferSize, PxU32 startIndex)	const
 {
 	return NpFactory::getInstance().getShapes(userBuffer, bufferSize, startIndex);
@@ -656,7 +683,7 @@ void NpPhysics::registerCloth()
 }
 #endif
 
-PxPruningStructure* NpPhysics::createPruningStructure(PxRigidActor*const* actors, PxU32 nbActors)
+PxPruningStructure* NpPhysics::createPruningStructure(PxRigidActor*const* actors, PxU32 nbActors, PxCpuDispatcher* dispatcher)
 {
 	PX_SIMD_GUARD;
 
@@ -664,7 +691,7 @@ PxPruningStructure* NpPhysics::createPruningStructure(PxRigidActor*const* actors
 	PX_ASSERT(nbActors > 0);
 
 	Sq::PruningStructure* ps = PX_NEW(Sq::PruningStructure)();	
-	if(!ps->build(actors, nbActors))
+	if(!ps->build(actors, nbActors, dispatcher))
 	{
 		PX_DELETE_AND_RESET(ps);		
 	}
@@ -840,7 +867,7 @@ void PxRegisterArticulations(PxPhysics& physics)
 void PxRegisterHeightFields(PxPhysics& physics)
 {
 	PX_UNUSED(&physics);	// for the moment
-	PX_CHECK_AND_RETURN(NpPhysics::getInstance().getNumScenes() == 0, "PxRegisterHeightFields: it is illegal to call a heightfield registration function after you have a scene.");
+	PX_CHECK_AND_RETURN(NpPhysics::getInstance().getNumScenes() == 0 || NpFactory::getInstance().getNbHeightFields() == 0, "PxRegisterHeightFields: it is illegal to call a heightfield registration function after you have a scene with heightfields.");
 
 	PxvRegisterHeightFields();
 	Gu::registerHeightFields();	
@@ -851,7 +878,7 @@ void PxRegisterHeightFields(PxPhysics& physics)
 
 void PxRegisterLegacyHeightFields(PxPhysics& physics)
 {
-	PX_CHECK_AND_RETURN(NpPhysics::getInstance().getNumScenes() == 0, "PxRegisterLegacyHeightFields: it is illegal to call a heightfield registration function after you have a scene.");
+	PX_CHECK_AND_RETURN(NpPhysics::getInstance().getNumScenes() == 0 || NpFactory::getInstance().getNbHeightFields() == 0, "PxRegisterLegacyHeightFields: it is illegal to call a heightfield registration function after you have a scene with heightfields.");
 	PX_UNUSED(&physics);	// for the moment
 	PxvRegisterLegacyHeightFields();
 	Gu::registerHeightFields();	
@@ -73,6 +73,7 @@ namespace Vd
 	};
 
 	class NpScene;	
+	class NpMemoryAccounting;
 	struct PxvOffsetTable;
 
 #if PX_VC
@@ -132,6 +133,7 @@ public:
 
 	virtual		PxShape*			createShape(const PxGeometry&, PxMaterial*const *, PxU16, bool, PxShapeFlags shapeFlags);
 	virtual		PxU32				getNbShapes()	const;
+	virtual		void				reserve(PxU32 nbRigidDynamics, PxU32 nbRigidStatics, PxU32 nbShapes);
 	virtual		PxU32				getShapes(PxShape** userBuffer, PxU32 bufferSize, PxU32 startIndex)	const;
 
 #if PX_USE_PARTICLE_SYSTEM_API
@@ -175,7 +177,7 @@ public:
 	PX_FORCE_INLINE void			unregisterPhysXIndicatorGpuClient() {}
 #endif
 
-	virtual		PxPruningStructure*	createPruningStructure(PxRigidActor*const* actors, PxU32 nbActors);
+	virtual		PxPruningStructure*	createPruningStructure(PxRigidActor*const* actors, PxU32 nbActors, PxCpuDispatcher* dispatcher);
 
 	virtual		const PxTolerancesScale&		getTolerancesScale() const;
 
@@ -211,6 +213,9 @@ public:
 
 				NpMaterialManager&	getMaterialManager()	{	return mMasterMaterialManager;	}
 
+				// NULL unless allocations are tracked
+				NpMemoryAccounting*	getMemoryAccounting()	const	{	return mMemoryAccounting;	}
+
 				NpMaterial*			addMaterial(NpMaterial* np);
 
 	static		void				initOffsetTables(PxvOffsetTable& pxvOffsetTable);
@@ -245,6 +250,8 @@ private:
 
 				Ps::Mutex								mSceneAndMaterialMutex;  // guarantees thread safety for API calls related to scene and material containers
 
+				NpMemoryAccounting*						mMemoryAccounting;
+
 #if PX_SUPPORT_GPU_PHYSX
 				PhysXIndicator		mPhysXIndicator;
 				PxU32				mNbRegisteredGpuClients;
@@ -0,0 +1,278 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "NpQueryResultCache.h"
+#include "NpSceneQueries.h"
+#include "PsFPU.h"
+#include "geometry/PxSphereGeometry.h"
+#include "geometry/PxCapsuleGeometry.h"
+#include "geometry/PxBoxGeometry.h"
+#include "geometry/PxConvexMeshGeometry.h"
+
+using namespace physx;
+
+namespace
+{
+	class KeyWriter
+	{
+	public:
+		KeyWriter(PxU32* words) : mWords(words), mNbWords(0)	{}
+
+		PX_FORCE_INLINE	void	write(PxU32 word)				{ PX_ASSERT(mNbWords<QueryResultKey::eMAX_WORDS); mWords[mNbWords++] = word;	}
+		// floats are compared bit for bit, -0 and 0 only make different keys
+		PX_FORCE_INLINE	void	write(PxReal value)				{ write(PX_IR(value));								}
+		PX_FORCE_INLINE	void	write(const PxVec3& v)			{ write(v.x); write(v.y); write(v.z);				}
+		PX_FORCE_INLINE	void	write(const PxQuat& q)			{ write(q.x); write(q.y); write(q.z); write(q.w);	}
+		PX_FORCE_INLINE	void	write(const PxTransform& pose)	{ write(pose.q); write(pose.p);					}
+		PX_FORCE_INLINE	void	write(const void* ptr)
+		{
+			const PxU64 value = PxU64(reinterpret_cast<size_t>(ptr));
+			write(PxU32(value));
+			write(PxU32(value>>32));
+		}
+
+		// the geometry structs have padding, so only the members are written
+		bool	write(const PxGeometry& geometry)
+		{
+			write(PxU32(geometry.getType()));
+			switch(geometry.getType())
+			{
+				case PxGeometryType::eSPHERE:
+					write(static_cast<const PxSphereGeometry&>(geometry).radius);
+					return true;
+				case PxGeometryType::eCAPSULE:
+				{
+					const PxCapsuleGeometry& capsule = static_cast<const PxCapsuleGeometry&>(geometry);
+					write(capsule.radius);
+					write(capsule.halfHeight);
+					return true;
+				}
+				case PxGeometryType::eBOX:
+					write(static_cast<const PxBoxGeometry&>(geometry).halfExtents);
+					return true;
+				case PxGeometryType::eCONVEXMESH:
+				{
+					const PxConvexMeshGeometry& convex = static_cast<const PxConvexMeshGeometry&>(geometry);
+					write(convex.scale.scale);
+					write(convex.scale.rotation);
+					write(convex.convexMesh);
+					write(PxU32(PxU8(convex.meshFlags)));
+					return true;
+				}
+				case PxGeometryType::ePLANE:
+				case PxGeometryType::eTRIANGLEMESH:
+				case PxGeometryType::eHEIGHTFIELD:
+				case PxGeometryType::eGEOMETRY_COUNT:
+				case PxGeometryType::eINVALID:
+					break;
+			}
+			return false;
+		}
+
+		PX_FORCE_INLINE	PxU32	getNbWords()	const	{ return mNbWords;	}
+
+	private:
+		PxU32*	mWords;
+		PxU32	mNbWords;
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool QueryResultKey::set(const MultiQueryInput& input, PxHitFlags hitFlags, const PxQueryFilterData& filterData, PxU32 maxNbTouches)
+{
+	KeyWriter writer(mWords);
+	writer.write(PxU32(PxU16(hitFlags)) | (PxU32(PxU16(filterData.flags))<<16));
+	writer.write(maxNbTouches);
+	writer.write(filterData.data.word0);
+	writer.write(filterData.data.word1);
+	writer.write(filterData.data.word2);
+	writer.write(filterData.data.word3);
+
+	if(input.geometry)
+	{
+		if(!writer.write(*input.geometry))
+			return false;
+		writer.write(*input.pose);
+	}
+	else
+		writer.write(input.getOrigin());
+
+	if(input.unitDir)
+	{
+		writer.write(input.getDir());
+		writer.write(input.maxDistance);
+		writer.write(input.inflation);
+	}
+
+	mNbWords = writer.getNbWords();
+
+	// FNV-1a over the words
+	PxU32 hash = 2166136261u;
+	for(PxU32 i=0; i<mNbWords; i++)
+		hash = (hash ^ mWords[i]) * 16777619u;
+	mHash = hash;
+	return true;
+}
+
+bool QueryResultKey::operator==(const QueryResultKey& other) const
+{
+	if(mHash != other.mHash || mNbWords != other.mNbWords)
+		return false;
+
+	for(PxU32 i=0; i<mNbWords; i++)
+		if(mWords[i] != other.mWords[i])
+			return false;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename HitType>
+QueryResultTable<HitType>::QueryResultTable()
+{
+	clear();
+}
+
+template<typename HitType>
+void QueryResultTable<HitType>::clear()
+{
+	for(PxU32 i=0; i<eNB_SLOTS; i++)
+		mSlots[i].mValid = false;
+}
+
+template<typename HitType>
+bool QueryResultTable<HitType>::find(const QueryResultKey& key, PxHitCallback<HitType>& hits) const
+{
+	const Slot& slot = mSlots[key.mHash & (eNB_SLOTS-1)];
+	if(!slot.mValid || !(slot.mKey == key))
+		return false;
+
+	// the key holds maxNbTouches and only results that didn't fill the buffer are stored, so the touches fit
+	const PxU32 nbTouches = slot.mTouches.size();
+	PX_ASSERT(nbTouches < hits.maxNbTouches || !nbTouches);
+	for(PxU32 i=0; i<nbTouches; i++)
+		hits.touches[i] = slot.mTouches[i];
+	hits.nbTouches = nbTouches;
+	hits.hasBlock = slot.mHasBlock;
+	if(slot.mHasBlock)
+		hits.block = slot.mBlock;
+	return true;
+}
+
+template<typename HitType>
+void QueryResultTable<HitType>::store(const QueryResultKey& key, bool hasBlock, const HitType& block, const HitType* touches, PxU32 nbTouches)
+{
+	if(nbTouches > eMAX_TOUCHES)
+		return;
+
+	Slot& slot = mSlots[key.mHash & (eNB_SLOTS-1)];
+	slot.mKey = key;
+	slot.mHasBlock = hasBlock;
+	if(hasBlock)
+		slot.mBlock = block;
+	slot.mTouches.clear();
+	for(PxU32 i=0; i<nbTouches; i++)
+		slot.mTouches.pushBack(touches[i]);
+	slot.mValid = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+NpQueryResultCache::NpQueryResultCache() :
+	mRaycasts			(NULL),
+	mOverlaps			(NULL),
+	mSweeps				(NULL),
+	mStaticTimestamp	(0),
+	mDynamicTimestamp	(0)
+{
+}
+
+NpQueryResultCache::~NpQueryResultCache()
+{
+	PX_DELETE_AND_RESET(mRaycasts);
+	PX_DELETE_AND_RESET(mOverlaps);
+	PX_DELETE_AND_RESET(mSweeps);
+}
+
+void NpQueryResultCache::invalidate()
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	if(mRaycasts)
+	{
+		mRaycasts->clear();
+		mOverlaps->clear();
+		mSweeps->clear();
+	}
+}
+
+bool NpQueryResultCache::validate(PxU32 staticTimestamp, PxU32 dynamicTimestamp)
+{
+	if(!mRaycasts)
+		return false;
+
+	if(staticTimestamp != mStaticTimestamp || dynamicTimestamp != mDynamicTimestamp)
+	{
+		mRaycasts->clear();
+		mOverlaps->clear();
+		mSweeps->clear();
+		mStaticTimestamp = staticTimestamp;
+		mDynamicTimestamp = dynamicTimestamp;
+	}
+	return true;
+}
+
+void NpQueryResultCache::createTables()
+{
+	if(!mRaycasts)
+	{
+		mRaycasts = PX_NEW(QueryResultTable<PxRaycastHit>);
+		mOverlaps = PX_NEW(QueryResultTable<PxOverlapHit>);
+		mSweeps = PX_NEW(QueryResultTable<PxSweepHit>);
+	}
+}
+
+#define FIND_AND_STORE(HitType, table)																											\
+bool NpQueryResultCache::find(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, PxHitCallback<HitType>& hits)			\
+{																																				\
+	Ps::Mutex::ScopedLock lock(mMutex);																											\
+	return validate(staticTimestamp, dynamicTimestamp) && table->find(key, hits);																\
+}																																				\
+void NpQueryResultCache::store(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, bool hasBlock, const HitType& block,	\
+	const HitType* touches, PxU32 nbTouches)																									\
+{																																				\
+	Ps::Mutex::ScopedLock lock(mMutex);																											\
+	createTables();																																\
+	validate(staticTimestamp, dynamicTimestamp);																								\
+	table->store(key, hasBlock, block, touches, nbTouches);																						\
+}
+
+FIND_AND_STORE(PxRaycastHit, mRaycasts)
+FIND_AND_STORE(PxOverlapHit, mOverlaps)
+FIND_AND_STORE(PxSweepHit, mSweeps)
+
+#undef FIND_AND_STORE
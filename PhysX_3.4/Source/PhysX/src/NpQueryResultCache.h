@@ -0,0 +1,127 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_NP_QUERYRESULTCACHE
+#define PX_PHYSICS_NP_QUERYRESULTCACHE
+
+#include "PxQueryReport.h"
+#include "PxQueryFiltering.h"
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsArray.h"
+#include "PsMutex.h"
+
+namespace physx
+{
+	struct MultiQueryInput;
+
+// Inputs of a scene query flattened to 32 bit words, so that they can be hashed and compared bit for bit
+struct QueryResultKey
+{
+	enum { eMAX_WORDS = 32 };
+
+					PxU32	mWords[eMAX_WORDS];
+					PxU32	mNbWords;
+					PxU32	mHash;
+
+	// Returns false for the queries that can't be cached, i.e. with a mesh or heightfield as query geometry
+					bool	set(const MultiQueryInput& input, PxHitFlags hitFlags, const PxQueryFilterData& filterData, PxU32 maxNbTouches);
+
+					bool	operator==(const QueryResultKey& other) const;
+};
+
+// Direct mapped table of the results of one kind of query, a new result replaces the one in its slot
+template<typename HitType>
+class QueryResultTable : public Ps::UserAllocated
+{
+public:
+	enum
+	{
+		eNB_SLOTS	= 64,
+		eMAX_TOUCHES	= 32	// results with more touches are not kept
+	};
+
+									QueryResultTable();
+
+					void			clear();
+
+	// Copies the memoized result into the callback, returns false if there is none
+					bool			find(const QueryResultKey& key, PxHitCallback<HitType>& hits)	const;
+					void			store(const QueryResultKey& key, bool hasBlock, const HitType& block, const HitType* touches, PxU32 nbTouches);
+
+private:
+	struct Slot
+	{
+		QueryResultKey	mKey;
+		HitType			mBlock;
+		bool			mValid;
+		bool			mHasBlock;
+		Ps::Array<HitType>	mTouches;
+	};
+
+					Slot			mSlots[eNB_SLOTS];
+};
+
+// Results of the scene queries issued since the last simulation step, see PxSceneFlag::eENABLE_QUERY_CACHE.
+// Entries are only valid for the pruner timestamps they were stored with, a change of either timestamp drops them all.
+class NpQueryResultCache
+{
+	PX_NOCOPY(NpQueryResultCache)
+public:
+									NpQueryResultCache();
+									~NpQueryResultCache();
+
+	// Drops every entry, for the scene changes not tracked by the pruner timestamps (simulation, shape filter data, origin shift)
+					void			invalidate();
+
+					bool			find(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, PxHitCallback<PxRaycastHit>& hits);
+					bool			find(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, PxHitCallback<PxOverlapHit>& hits);
+					bool			find(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, PxHitCallback<PxSweepHit>& hits);
+
+					void			store(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, bool hasBlock, const PxRaycastHit& block, const PxRaycastHit* touches, PxU32 nbTouches);
+					void			store(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, bool hasBlock, const PxOverlapHit& block, const PxOverlapHit* touches, PxU32 nbTouches);
+					void			store(const QueryResultKey& key, PxU32 staticTimestamp, PxU32 dynamicTimestamp, bool hasBlock, const PxSweepHit& block, const PxSweepHit* touches, PxU32 nbTouches);
+
+private:
+	// Clears the entries if the timestamps moved since they were stored, returns false if the tables don't exist yet
+					bool			validate(PxU32 staticTimestamp, PxU32 dynamicTimestamp);
+					void			createTables();
+
+					Ps::Mutex						mMutex;
+					QueryResultTable<PxRaycastHit>*	mRaycasts;	// created on the first store
+					QueryResultTable<PxOverlapHit>*	mOverlaps;
+					QueryResultTable<PxSweepHit>*	mSweeps;
+					PxU32							mStaticTimestamp;
+					PxU32							mDynamicTimestamp;
+};
+
+}
+
+#endif
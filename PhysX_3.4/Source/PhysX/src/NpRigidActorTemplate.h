@@ -90,6 +90,8 @@ public:
 	// shared shapes
 	virtual			void					attachShape(PxShape& s);
 	virtual			void					detachShape(PxShape& s, bool wakeOnLostTouch);
+	virtual			void					attachShapes(PxShape*const* shapes, PxU32 nbShapes);
+	virtual			void					detachShapes(PxShape*const* shapes, PxU32 nbShapes, bool wakeOnLostTouch);
 
 
 	//---------------------------------------------------------------------------------
@@ -246,6 +248,60 @@ void NpRigidActorTemplate<APIClass>::detachShape(PxShape& shape, bool wakeOnLost
 }
 
 
+template<class APIClass>
+void NpRigidActorTemplate<APIClass>::attachShapes(PxShape*const* shapes, PxU32 nbShapes)
+{
+	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
+	PX_CHECK_AND_RETURN(shapes || !nbShapes, "PxRigidActor::attachShapes: shapes is NULL");
+#if PX_CHECKED
+	for(PxU32 i=0;i<nbShapes;i++)
+		PX_CHECK_AND_RETURN(!static_cast<NpShape*>(shapes[i])->isExclusive() || shapes[i]->getActor()==NULL, "PxRigidActor::attachShapes: shapes must be shared or unowned");
+#endif
+	if(!nbShapes)
+		return;
+
+	PX_SIMD_GUARD
+	// invalidate the pruning structure if the actor bounds changed
+	if (mShapeManager.getPruningStructure())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxRigidActor::attachShapes: Actor is part of a pruning structure, pruning structure is now invalid!");
+		mShapeManager.getPruningStructure()->invalidate(this);
+	}
+
+	Ps::InlineArray<NpShape*, 32> npShapes;
+	npShapes.resize(nbShapes);
+	for(PxU32 i=0;i<nbShapes;i++)
+		npShapes[i] = static_cast<NpShape*>(shapes[i]);
+
+	mShapeManager.attachShapes(npShapes.begin(), nbShapes, *this);
+}
+
+template<class APIClass>
+void NpRigidActorTemplate<APIClass>::detachShapes(PxShape*const* shapes, PxU32 nbShapes, bool wakeOnLostTouch)
+{
+	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
+	PX_CHECK_AND_RETURN(shapes || !nbShapes, "PxRigidActor::detachShapes: shapes is NULL");
+	if(!nbShapes)
+		return;
+
+	if (mShapeManager.getPruningStructure())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxRigidActor::detachShapes: Actor is part of a pruning structure, pruning structure is now invalid!");
+		mShapeManager.getPruningStructure()->invalidate(this);
+	}
+
+	Ps::InlineArray<NpShape*, 32> npShapes;
+	npShapes.resize(nbShapes);
+	for(PxU32 i=0;i<nbShapes;i++)
+		npShapes[i] = static_cast<NpShape*>(shapes[i]);
+
+	if(mShapeManager.detachShapes(npShapes.begin(), nbShapes, *this, wakeOnLostTouch) != nbShapes)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxRigidActor::detachShapes: some shapes are not attached to this actor!");
+	}
+}
+
+
 template<class APIClass>
 PxU32 NpRigidActorTemplate<APIClass>::getNbShapes() const
 {
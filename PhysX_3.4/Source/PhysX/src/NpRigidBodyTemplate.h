@@ -102,6 +102,7 @@ public:
 
 	virtual			PxShape*			createShape(const PxGeometry& geometry, PxMaterial*const* material, PxU16 materialCount, PxShapeFlags shapeFlags);
 	virtual			void				attachShape(PxShape& shape);
+	virtual			void				attachShapes(PxShape*const* shapes, PxU32 nbShapes);
 
 	//---------------------------------------------------------------------------------
 	// Miscellaneous
@@ -216,6 +217,22 @@ void NpRigidBodyTemplate<APIClass>::attachShape(PxShape& shape)
 	RigidActorTemplateClass::attachShape(shape);
 }
 
+template<class APIClass>
+void NpRigidBodyTemplate<APIClass>::attachShapes(PxShape*const* shapes, PxU32 nbShapes)
+{
+	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
+#if PX_CHECKED
+	for(PxU32 i=0;i<nbShapes && shapes;i++)
+	{
+		PX_CHECK_AND_RETURN(!(shapes[i]->getFlags() & PxShapeFlag::eSIMULATION_SHAPE) 
+							|| isSimGeom(shapes[i]->getGeometryType()) 
+							|| isKinematic(),
+							"attachShapes: Triangle mesh, heightfield or plane geometry shapes configured as eSIMULATION_SHAPE are not supported for non-kinematic PxRigidDynamic instances.");
+	}
+#endif
+	RigidActorTemplateClass::attachShapes(shapes, nbShapes);
+}
+
 
 template<class APIClass>
 void NpRigidBodyTemplate<APIClass>::setCMassLocalPoseInternal(const PxTransform& body2Actor)
@@ -397,12 +414,18 @@ void NpRigidBodyTemplate<APIClass>::visualize(Cm::RenderOutput& out, NpScene* sc
 	if (mBody.getActorFlags() & PxActorFlag::eVISUALIZATION)
 	{
 		Scb::Scene& scbScene = scene->getScene();
+
+		// the frames and velocities are drawn at the center of mass
+		const PxBounds3& cullbox = scbScene.getVisualizationCullingBox();
+		if (!cullbox.isEmpty() && !cullbox.contains(mBody.getBody2World().p))
+			return;
+
 		const PxReal scale = scbScene.getVisualizationParameter(PxVisualizationParameter::eSCALE);
 
 		//visualize actor frames
 		const PxReal actorAxes = scale * scbScene.getVisualizationParameter(PxVisualizationParameter::eACTOR_AXES);
 		if (actorAxes != 0.0f)
-			out << getGlobalPose() << Cm::DebugBasis(PxVec3(actorAxes));
+			out << (mBody.getBody2World() * mBody.getBody2Actor().getInverse()) << Cm::DebugBasis(PxVec3(actorAxes));
 
 		const PxReal bodyAxes = scale * scbScene.getVisualizationParameter(PxVisualizationParameter::eBODY_AXES);
 		if (bodyAxes != 0.0f)
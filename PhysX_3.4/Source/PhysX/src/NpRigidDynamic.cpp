@@ -96,12 +96,23 @@ void NpRigidDynamic::setGlobalPose(const PxTransform& pose, bool autowake)
 }
 
 
+// A target at the current pose, with no other target pending, doesn't move the body. Dropping it lets an idle
+// kinematic fall asleep, instead of waking itself and the islands it touches and updating its bounds every step.
+static PX_FORCE_INLINE bool isStationaryTarget(const Scb::Body& b, const PxTransform& bodyTarget)
+{
+	PxTransform pendingTarget;
+	return bodyTarget == b.getBody2World() && !b.getKinematicTarget(pendingTarget);
+}
+
+
 PX_FORCE_INLINE void NpRigidDynamic::setKinematicTargetInternal(const PxTransform& targetPose)
 {
 	Scb::Body& b = getScbBodyFast();
 
 	// The target is actor related. Transform to body related target
 	const PxTransform bodyTarget = targetPose * b.getBody2Actor();
+	if(isStationaryTarget(b, bodyTarget))
+		return;
 
 	b.setKinematicTarget(bodyTarget);
 
@@ -468,7 +479,7 @@ void NpRigidDynamic::switchFromNoSim()
 }
 
 
-void NpRigidDynamic::wakeUpInternalNoKinematicTest(Scb::Body& body, bool forceWakeUp, bool autowake)
+void NpRigidDynamic::wakeUpInternalNoKinematicTest(Scb::Body& body, bool forceWakeUp, bool autowake, bool batched)
 {
 	NpScene* scene = NpActor::getOwnerScene(*this);
 	PX_ASSERT(scene);
@@ -484,7 +495,65 @@ void NpRigidDynamic::wakeUpInternalNoKinematicTest(Scb::Body& body, bool forceWa
 	}
 
 	if (needsWakingUp)
-		body.wakeUpInternal(wakeCounter);
+	{
+		if (batched)
+			body.wakeUpBatched(wakeCounter);
+		else
+			body.wakeUpInternal(wakeCounter);
+	}
+}
+
+
+void NpRigidDynamic::setGlobalPoseBatched(NpScene& scene, const PxTransform& pose, bool autowake)
+{
+#if PX_CHECKED
+	scene.checkPositionSanity(*this, pose, "PxScene::setGlobalPoses");
+#endif
+
+	updateDynamicSceneQueryShapes(mShapeManager, scene.getSceneQueryManagerFast());
+
+	const PxTransform newPose = pose.getNormalized();
+
+	Scb::Body& b = getScbBodyFast();
+	b.setBody2WorldBatched(newPose * b.getBody2Actor());
+
+	if(mShapeManager.getPruningStructure())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxScene::setGlobalPoses: Actor is part of a pruning structure, pruning structure is now invalid!");
+		mShapeManager.getPruningStructure()->invalidate(this);
+	}
+
+	// see wakeUpInternal(), kinematics are only awake when a target is set
+	if(autowake && !(b.getActorFlags() & PxActorFlag::eDISABLE_SIMULATION) && !(b.getFlags() & PxRigidBodyFlag::eKINEMATIC))
+		wakeUpInternalNoKinematicTest(b, false, true, true);
+}
+
+
+void NpRigidDynamic::setKinematicTargetBatched(NpScene& scene, const PxTransform& destination)
+{
+#if PX_CHECKED
+	scene.checkPositionSanity(*this, destination, "PxScene::setKinematicTargets");
+#endif
+
+	// The target is actor related. Transform to body related target
+	Scb::Body& b = getScbBodyFast();
+	const PxTransform bodyTarget = destination.getNormalized() * b.getBody2Actor();
+	if(isStationaryTarget(b, bodyTarget))
+		return;
+
+	b.setKinematicTargetBatched(bodyTarget);
+
+	if(b.getFlags() & PxRigidBodyFlag::eUSE_KINEMATIC_TARGET_FOR_SCENE_QUERIES)
+		updateDynamicSceneQueryShapes(mShapeManager, scene.getSceneQueryManagerFast());
+}
+
+
+void NpRigidDynamic::setLinearVelocityBatched(const PxVec3& velocity, bool autowake)
+{
+	Scb::Body& b = getScbBodyFast();
+	b.setLinearVelocityBatched(velocity);
+
+	wakeUpInternalNoKinematicTest(b, (!velocity.isZero()), autowake, true);
 }
 
 PxRigidDynamicLockFlags NpRigidDynamic::getRigidDynamicLockFlags() const
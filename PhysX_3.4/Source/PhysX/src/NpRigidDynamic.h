@@ -140,7 +140,12 @@ public:
 	virtual		void				switchFromNoSim();
 
 	PX_FORCE_INLINE void			wakeUpInternal();
-					void			wakeUpInternalNoKinematicTest(Scb::Body& body, bool forceWakeUp, bool autowake);
+					void			wakeUpInternalNoKinematicTest(Scb::Body& body, bool forceWakeUp, bool autowake, bool batched = false);
+
+	// Used by the batched writes of NpScene. The caller does the write check, the argument checks and makes sure the actor is in the scene.
+					void			setGlobalPoseBatched(NpScene& scene, const PxTransform& pose, bool autowake);
+					void			setKinematicTargetBatched(NpScene& scene, const PxTransform& destination);
+					void			setLinearVelocityBatched(const PxVec3& velocity, bool autowake);
 
 private:
 	PX_FORCE_INLINE	void			setKinematicTargetInternal(const PxTransform& destination);
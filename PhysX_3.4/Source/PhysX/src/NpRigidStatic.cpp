@@ -172,8 +172,9 @@ void NpRigidStatic::visualize(Cm::RenderOutput& out, NpScene* scene)
 
 		//visualize actor frames
 		PxReal actorAxes = scale * scbScene.getVisualizationParameter(PxVisualizationParameter::eACTOR_AXES);
-		if (actorAxes != 0)
-			out << getGlobalPose() << Cm::DebugBasis(PxVec3(actorAxes));
+		const PxBounds3& cullbox = scbScene.getVisualizationCullingBox();
+		if (actorAxes != 0 && (cullbox.isEmpty() || cullbox.contains(getGlobalPoseFast().p)))
+			out << getGlobalPoseFast() << Cm::DebugBasis(PxVec3(actorAxes));
 	}
 }
 #endif
@@ -31,6 +31,7 @@
 #include "PxSimulationEventCallback.h"
 
 #include "NpScene.h"
+#include "NpMemoryAccounting.h"
 #include "NpRigidStatic.h"
 #include "NpRigidDynamic.h"
 #include "NpArticulation.h"
@@ -59,6 +60,7 @@
 #include "ScbNpDeps.h"
 #include "CmCollection.h"
 #include "CmUtils.h"
+#include "CmParallelFor.h"
 
 #if PX_SUPPORT_GPU_PHYSX
 #include "task/PxGpuDispatcher.h"
@@ -96,7 +98,7 @@ static PX_FORCE_INLINE bool removeFromSceneCheck(NpScene* npScene, PxScene* scen
 ///////////////////////////////////////////////////////////////////////////////
 NpSceneQueries::NpSceneQueries(const PxSceneDesc& desc) : 
 	mScene					(desc, getContextId()),
-	mSQManager				(mScene, desc.staticStructure, desc.dynamicStructure, desc.dynamicTreeRebuildRateHint, desc.limits),
+	mSQManager				(mScene, desc.staticStructure, desc.dynamicStructure, desc.dynamicTreeRebuildRateHint, desc.limits, desc.cpuDispatcher),
 	mCachedRaycastFuncs		(Gu::getRaycastFuncTable()),
 	mCachedSweepFuncs		(Gu::getSweepFuncTable()),
 	mCachedOverlapFuncs		(Gu::getOverlapFuncTable()),
@@ -139,9 +141,14 @@ NpScene::NpScene(const PxSceneDesc& desc) :
 	mConcurrentReadCount	(0),
 	mConcurrentErrorCount	(0),	
 	mCurrentWriter			(0),
+	mDistributedRWLock		(NULL),
 	mSceneQueriesUpdateRunning	(false),
 	mHasSimulatedOnce		(false),
-	mBetweenFetchResults	(false)
+	mBetweenFetchResults	(false),
+	mSoftMemoryBudget		(0),
+	mHardMemoryBudget		(0),
+	mMemoryBudgetCallback	(NULL),
+	mSoftMemoryBudgetReported	(false)
 {
 	
 	mSceneExecution.setObject(this);
@@ -151,6 +158,12 @@ NpScene::NpScene(const PxSceneDesc& desc) :
 	mTaskManager = mScene.getScScene().getTaskManagerPtr();
 	mThreadReadWriteDepth = Ps::TlsAlloc();
 
+	if((desc.flags & PxSceneFlag::eREQUIRE_RW_LOCK) && (desc.flags & PxSceneFlag::eENABLE_DISTRIBUTED_READ_LOCK))
+	{
+		mDistributedRWLock = reinterpret_cast<Ps::DistributedReadWriteLock*>(PX_ALLOC(sizeof(Ps::DistributedReadWriteLock), "DistributedReadWriteLock"));
+		PX_PLACEMENT_NEW(mDistributedRWLock, Ps::DistributedReadWriteLock)();
+	}
+
 #if PX_SUPPORT_GPU_PHYSX
 	updatePhysXIndicator();
 #endif
@@ -218,11 +231,60 @@ NpScene::~NpScene()
 	if (unlock)
 		unlockWrite();
 
+	if(mDistributedRWLock)
+	{
+		mDistributedRWLock->~DistributedReadWriteLock();
+		PX_FREE(mDistributedRWLock);
+	}
+
+	for(PxU32 i=0;i<mVisualizationBuffers.size();i++)
+		PX_DELETE(mVisualizationBuffers[i]);
+
 	TlsFree(mThreadReadWriteDepth);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void NpScene::reset()
+{
+	PX_PROFILE_ZONE("API.reset", getContextId());
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN(getSimulationStage() == Sc::SimulationStage::eCOMPLETE, "PxScene::reset(): Scene is being simulated!");
+
+	// aggregates first, same as in the destructor
+	PxU32 aggregateCount = mAggregates.size();
+	while(aggregateCount--)
+		removeAggregate(*mAggregates.getEntries()[aggregateCount], false);
+
+	PxU32 articCount = mArticulations.size();
+	while(articCount--)
+		removeArticulation(*mArticulations.getEntries()[articCount], false);
+
+	// one batch, in reverse order so that each actor is the last one of mRigidActors when it gets removed
+	const PxU32 rigidActorCount = mRigidActors.size();
+	if(rigidActorCount)
+	{
+		Ps::Array<PxActor*> actors(rigidActorCount);
+		for(PxU32 i=0;i<rigidActorCount;i++)
+			actors[i] = mRigidActors[rigidActorCount - 1 - i];
+		removeActors(actors.begin(), rigidActorCount, false);
+	}
+
+#if PX_USE_PARTICLE_SYSTEM_API
+	PxU32 partCount = mPxParticleBaseSet.size();
+	while(partCount--)
+		removeActor(*mPxParticleBaseSet.getEntries()[partCount], false);
+#endif
+
+#if PX_USE_CLOTH_API
+	PxU32 clothCount = mPxCloths.size();
+	while(clothCount--)
+		removeActor(*mPxCloths.getEntries()[clothCount], false);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void NpScene::release()
 {
 	// need to acquire lock for release, note this is unlocked in the destructor
@@ -726,6 +788,99 @@ void NpScene::removeActors(PxActor*const* PX_RESTRICT actors, PxU32 nbActors, bo
 	scScene.setBatchRemove(NULL);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+static PX_FORCE_INLINE bool batchedWriteCheck(NpScene* npScene, const NpRigidDynamic* actor, const char* name)
+{
+	if (actor && (NpActor::getAPIScene(*actor) == npScene))
+		return true;
+
+	Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "%s: Actor is NULL, not assigned to scene or assigned to another scene. Remaining entries will be ignored!", name);
+	return false;
+}
+
+void NpScene::setGlobalPoses(PxRigidDynamic*const* PX_RESTRICT actors, const PxTransform* PX_RESTRICT poses, PxU32 count, bool autowake)
+{
+	PX_PROFILE_ZONE("API.setGlobalPoses", getContextId());
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN(!count || (actors && poses), "PxScene::setGlobalPoses: actors and poses must not be NULL.");
+
+	if(mScene.isPhysicsBuffering())
+		mScene.reserveBatchedUpdates(count);
+
+	for(PxU32 i=0; i<count; i++)
+	{
+		if(i+1<count)
+			Ps::prefetch(actors[i+1], sizeof(NpRigidDynamic));
+
+		NpRigidDynamic* actor = static_cast<NpRigidDynamic*>(actors[i]);
+		if(!batchedWriteCheck(this, actor, "PxScene::setGlobalPoses"))
+			break;
+
+		PX_CHECK_AND_RETURN(poses[i].isSane(), "PxScene::setGlobalPoses: pose is not valid. Remaining entries will be ignored!");
+
+		actor->setGlobalPoseBatched(*this, poses[i], autowake);
+	}
+}
+
+void NpScene::setKinematicTargets(PxRigidDynamic*const* PX_RESTRICT actors, const PxTransform* PX_RESTRICT destinations, PxU32 count)
+{
+	PX_PROFILE_ZONE("API.setKinematicTargets", getContextId());
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN(!count || (actors && destinations), "PxScene::setKinematicTargets: actors and destinations must not be NULL.");
+
+	if(mScene.isPhysicsBuffering())
+		mScene.reserveBatchedUpdates(count);
+
+	for(PxU32 i=0; i<count; i++)
+	{
+		if(i+1<count)
+			Ps::prefetch(actors[i+1], sizeof(NpRigidDynamic));
+
+		NpRigidDynamic* actor = static_cast<NpRigidDynamic*>(actors[i]);
+		if(!batchedWriteCheck(this, actor, "PxScene::setKinematicTargets"))
+			break;
+
+#if PX_CHECKED
+		const Scb::Body& b = actor->getScbBodyFast();
+		PX_CHECK_AND_RETURN(destinations[i].isSane(), "PxScene::setKinematicTargets: destination is not valid. Remaining entries will be ignored!");
+		PX_CHECK_AND_RETURN((b.getFlags() & PxRigidBodyFlag::eKINEMATIC), "PxScene::setKinematicTargets: Body must be kinematic! Remaining entries will be ignored!");
+		PX_CHECK_AND_RETURN(!(b.getActorFlags() & PxActorFlag::eDISABLE_SIMULATION), "PxScene::setKinematicTargets: Not allowed if PxActorFlag::eDISABLE_SIMULATION is set! Remaining entries will be ignored!");
+#endif
+
+		actor->setKinematicTargetBatched(*this, destinations[i]);
+	}
+}
+
+void NpScene::setLinearVelocities(PxRigidDynamic*const* PX_RESTRICT actors, const PxVec3* PX_RESTRICT velocities, PxU32 count, bool autowake)
+{
+	PX_PROFILE_ZONE("API.setLinearVelocities", getContextId());
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN(!count || (actors && velocities), "PxScene::setLinearVelocities: actors and velocities must not be NULL.");
+
+	if(mScene.isPhysicsBuffering())
+		mScene.reserveBatchedUpdates(count);
+
+	for(PxU32 i=0; i<count; i++)
+	{
+		if(i+1<count)
+			Ps::prefetch(actors[i+1], sizeof(NpRigidDynamic));
+
+		NpRigidDynamic* actor = static_cast<NpRigidDynamic*>(actors[i]);
+		if(!batchedWriteCheck(this, actor, "PxScene::setLinearVelocities"))
+			break;
+
+#if PX_CHECKED
+		const Scb::Body& b = actor->getScbBodyFast();
+		PX_CHECK_AND_RETURN(velocities[i].isFinite(), "PxScene::setLinearVelocities: velocity is not valid. Remaining entries will be ignored!");
+		PX_CHECK_AND_RETURN(!(b.getFlags() & PxRigidBodyFlag::eKINEMATIC), "PxScene::setLinearVelocities: Body must be non-kinematic! Remaining entries will be ignored!");
+		PX_CHECK_AND_RETURN(!(b.getActorFlags() & PxActorFlag::eDISABLE_SIMULATION), "PxScene::setLinearVelocities: Not allowed if PxActorFlag::eDISABLE_SIMULATION is set! Remaining entries will be ignored!");
+#endif
+
+		actor->setLinearVelocityBatched(velocities[i], autowake);
+	}
+}
+
 void NpScene::removeActor(PxActor& actor, bool wakeOnLostTouch)
 {
 	PX_PROFILE_ZONE("API.removeActor", getContextId());
@@ -1218,37 +1373,91 @@ PxU32 NpScene::getAggregates(PxAggregate** userBuffer, PxU32 bufferSize, PxU32 s
 //~PX_AGGREGATE
 
 void NpScene::addCollection(const PxCollection& collection)
+{
+	addCollection(collection, 0, 0xffffffff);
+}
+
+PxU32 NpScene::addCollection(const PxCollection& collection, PxU32 startIndex, PxU32 maxActors)
 {
 	PX_PROFILE_ZONE("API.addCollection", getContextId());
 	const Cm::Collection& col = static_cast<const Cm::Collection&>(collection);
 
-	PxU32 nb = col.internalGetNbObjects();
+	struct Local
+	{
+		static void addActorIfNeeded(PxActor* actor, Ps::Array<PxActor*>& actorArray)
+		{
+			if(actor->getAggregate())
+				return;	// The actor will be added when the aggregate is added
+			actorArray.pushBack(actor);			
+		}
+
+		// number of actors inserted in the scene for the object, mirrors the insertion loop below
+		static PxU32 getNbInsertedActors(PxBase* s)
+		{
+			const PxType serialType = s->getConcreteType();
+			if(serialType==PxConcreteType::eRIGID_DYNAMIC)
+			{
+				NpRigidDynamic* np = static_cast<NpRigidDynamic*>(s);
+				return (np->getAggregate() || np->getShapeManager().getPruningStructure()) ? 0u : 1u;
+			}
+			else if(serialType==PxConcreteType::eRIGID_STATIC)
+			{
+				NpRigidStatic* np = static_cast<NpRigidStatic*>(s);
+				return (np->getAggregate() || np->getShapeManager().getPruningStructure()) ? 0u : 1u;
+			}
+			else if(serialType==PxConcreteType::eCLOTH || serialType==PxConcreteType::ePARTICLE_SYSTEM || serialType==PxConcreteType::ePARTICLE_FLUID)
+			{
+				return static_cast<PxActor*>(s)->getAggregate() ? 0u : 1u;
+			}
+			else if(serialType==PxConcreteType::eARTICULATION)
+			{
+				const PxArticulation* articulation = static_cast<PxArticulation*>(s);
+				return articulation->getAggregate() ? 0u : articulation->getNbLinks();
+			}
+			else if(serialType==PxConcreteType::eAGGREGATE)
+			{
+				return static_cast<PxAggregate*>(s)->getNbActors();
+			}
+			else if(serialType == PxConcreteType::ePRUNING_STRUCTURE)
+			{
+				return static_cast<PxPruningStructure*>(s)->getNbRigidActors();
+			}
+			return 0;
+		}
+	};
+
+	const PxU32 nbObjects = col.internalGetNbObjects();
+	if(startIndex >= nbObjects)
+		return nbObjects;
+
+	// find the objects fitting in the budget
+	PxU32 endIndex = startIndex;
+	PxU32 nbActors = 0;
+	while(endIndex < nbObjects)
+	{
+		const PxU32 nbObjectActors = Local::getNbInsertedActors(col.internalGetObject(endIndex));
+		if(endIndex > startIndex && nbActors + nbObjectActors > maxActors)
+			break;
+		nbActors += nbObjectActors;
+		endIndex++;
+	}
+
 #if PX_CHECKED
-	for(PxU32 i=0;i<nb;i++)
+	for(PxU32 i=startIndex;i<endIndex;i++)
 	{
 		PxRigidStatic* a = col.internalGetObject(i)->is<PxRigidStatic>();
 		if(a && !static_cast<NpRigidStatic*>(a)->checkConstraintValidity())
 		{
 			Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxScene::addCollection(): collection contains an actor with an invalid constraint!");
-			return;
+			return nbObjects;
 		}
 	}	
 #endif
 
 	Ps::Array<PxActor*> actorsToInsert;
-	actorsToInsert.reserve(nb);
+	actorsToInsert.reserve(endIndex - startIndex);
 
-	struct Local
-	{
-		static void addActorIfNeeded(PxActor* actor, Ps::Array<PxActor*>& actorArray)
-		{
-			if(actor->getAggregate())
-				return;	// The actor will be added when the aggregate is added
-			actorArray.pushBack(actor);			
-		}
-	};
-
-	for(PxU32 i=0;i<nb;i++)
+	for(PxU32 i=startIndex;i<endIndex;i++)
 	{
 		PxBase* s = col.internalGetObject(i);
 		const PxType serialType = s->getConcreteType();
@@ -1312,6 +1521,8 @@ void NpScene::addCollection(const PxCollection& collection)
 
 	if(!actorsToInsert.empty())
 		addActorsInternal(&actorsToInsert[0], actorsToInsert.size(), NULL);
+
+	return endIndex;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1498,6 +1709,58 @@ const PxRenderBuffer& NpScene::getRenderBuffer()
 	return mRenderBuffer;
 }
 
+static bool isSyncSet(void* sync)
+{
+	return reinterpret_cast<Ps::Sync*>(sync)->wait(0);
+}
+
+#if PX_ENABLE_DEBUG_VISUALIZATION
+static void visualizeRigidActors(Cm::RenderOutput& out, NpScene* scene, PxRigidActor*const* rigidActors, PxU32 nbActors)
+{
+	for(PxU32 i=0; i < nbActors; i++)
+	{
+		PxRigidActor* a = rigidActors[i];
+		if (a->getType() == PxActorType::eRIGID_DYNAMIC)
+			static_cast<NpRigidDynamic*>(a)->visualize(out, scene);
+		else
+			static_cast<NpRigidStatic*>(a)->visualize(out, scene);
+	}
+}
+
+namespace
+{
+	// Visualizes the chunks of actors it claims into its own buffer. The actors only read their own data (no API calls),
+	// so the tasks run at the same time as the thread calling simulate, which claims chunks as well.
+	class VisualizeActorsTask : public Cm::Task
+	{
+	public:
+		VisualizeActorsTask(PxU64 contextId, NpScene* scene, PxRigidActor*const* actors, Cm::ParallelForRange& range, Cm::RenderBuffer& buffer) :
+			Cm::Task(contextId), mScene(scene), mActors(actors), mRange(range), mBuffer(buffer)	{}
+
+		virtual void runInternal()
+		{
+			PX_SIMD_GUARD;
+			Cm::RenderOutput out(mBuffer);
+			PxU32 start, nb;
+			while(mRange.claim(start, nb))
+				visualizeRigidActors(out, mScene, mActors + start, nb);
+		}
+
+		virtual const char* getName() const { return "NpScene.visualizeActors"; }
+
+		static const PxU32 MinActors = 256;
+		static const PxU32 MaxActors = 2048;
+	private:
+		NpScene*				mScene;
+		PxRigidActor*const*		mActors;
+		Cm::ParallelForRange&	mRange;
+		Cm::RenderBuffer&		mBuffer;
+
+		PX_NOCOPY(VisualizeActorsTask)
+	};
+}
+#endif
+
 void NpScene::visualize()
 {
 	NP_READ_CHECK(this);
@@ -1531,14 +1794,43 @@ void NpScene::visualize()
 		static_cast<NpCloth*>(mPxCloths.getEntries()[i])->visualize(out, this);
 #endif
 
-	for(PxU32 i=0; i < rigidActorCount; i++)
+	// The actors are the bulk of the work on big scenes, they are split over the workers (see VisualizeActorsTask)
+	const PxU32 nbTasks = mTaskManager && mTaskManager->getCpuDispatcher()->getWorkerCount() ? Cm::getParallelForTaskCount(rigidActorCount, mTaskManager, VisualizeActorsTask::MinActors) : 1;
+	if(nbTasks > 1)
 	{
-		PxRigidActor* a = rigidActors[i];
-		if (a->getType() == PxActorType::eRIGID_DYNAMIC)
-			static_cast<NpRigidDynamic*>(a)->visualize(out, this);
-		else
-			static_cast<NpRigidStatic*>(a)->visualize(out, this);
+		Cm::FlushPool& pool = *mScene.getScScene().getFlushPool();
+		Cm::ParallelForRange* range = PX_PLACEMENT_NEW(pool.allocate(sizeof(Cm::ParallelForRange)), Cm::ParallelForRange)();
+		range->init(rigidActorCount, nbTasks, VisualizeActorsTask::MinActors, VisualizeActorsTask::MaxActors);
+
+		SceneCompletion* doneTask = PX_PLACEMENT_NEW(pool.allocate(sizeof(SceneCompletion)), SceneCompletion)(getContextId(), mVisualizationDone);
+		doneTask->setContinuation(*mTaskManager, NULL);
+
+		while(mVisualizationBuffers.size() < nbTasks - 1)
+			mVisualizationBuffers.pushBack(PX_NEW(Cm::RenderBuffer));
+
+		for(PxU32 i=0; i < nbTasks - 1; i++)
+		{
+			mVisualizationBuffers[i]->clear();
+			VisualizeActorsTask* task = PX_PLACEMENT_NEW(pool.allocate(sizeof(VisualizeActorsTask)), VisualizeActorsTask)(getContextId(), this, rigidActors, *range, *mVisualizationBuffers[i]);
+			task->setContinuation(doneTask);
+			task->removeReference();
+		}
+		doneTask->removeReference();
+
+		PxU32 start, nb;
+		while(range->claim(start, nb))
+			visualizeRigidActors(out, this, rigidActors + start, nb);
+
+		PxCpuDispatcher* dispatcher = mTaskManager->getCpuDispatcher();
+		if(!dispatcher->waitUntil(isSyncSet, &mVisualizationDone))
+			mVisualizationDone.wait();
+		mVisualizationDone.reset();
+
+		for(PxU32 i=0; i < nbTasks - 1; i++)
+			mRenderBuffer.append(*mVisualizationBuffers[i]);
 	}
+	else
+		visualizeRigidActors(out, this, rigidActors, rigidActorCount);
 
 	// Visualize pruning structures
 	const bool visStatic = getVisualizationParameter(PxVisualizationParameter::eCOLLISION_STATIC) != 0.0f;
@@ -1604,6 +1896,100 @@ void NpScene::getSimulationStatistics(PxSimulationStatistics& s) const
 	}
 }
 
+bool NpScene::getMemoryUsage(PxSceneMemoryUsage& usage) const
+{
+	const NpMemoryAccounting* accounting = NpPhysics::getInstance().getMemoryAccounting();
+	if(!accounting)
+	{
+		PxMemZero(&usage, sizeof(usage));
+		return false;
+	}
+
+	accounting->getUsage(getContextId(), usage);
+	return true;
+}
+
+void NpScene::setMemoryBudget(PxU64 softLimit, PxU64 hardLimit, PxMemoryBudgetCallback* callback)
+{
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN(!softLimit || !hardLimit || softLimit <= hardLimit, "PxScene::setMemoryBudget: the soft limit must not be above the hard limit!");
+
+	if(!NpPhysics::getInstance().getMemoryAccounting())
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxScene::setMemoryBudget: memory accounting is disabled, enable trackOutstandingAllocations in PxCreatePhysics. The budget will be ignored.");
+
+	mSoftMemoryBudget = softLimit;
+	mHardMemoryBudget = hardLimit;
+	mMemoryBudgetCallback = callback;
+	mSoftMemoryBudgetReported = false;
+}
+
+void NpScene::setCostProfiling(PxU32 maxEntries)
+{
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN(getSimulationStage() == Sc::SimulationStage::eCOMPLETE, "PxScene::setCostProfiling() not allowed while simulation is running. Call will be ignored.");
+
+	mScene.getScScene().setCostProfiling(maxEntries);
+}
+
+PxU32 NpScene::getCostProfiling() const
+{
+	NP_READ_CHECK(this);
+	return mScene.getScScene().getCostProfiling();
+}
+
+bool NpScene::getCostProfile(PxCostProfile& profile) const
+{
+	NP_READ_CHECK(this);
+
+	if(getSimulationStage() != Sc::SimulationStage::eCOMPLETE)
+	{
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxScene::getCostProfile() not allowed while simulation is running. Call will be ignored.");
+		PxMemZero(&profile, sizeof(profile));
+		return false;
+	}
+
+	return mScene.getScScene().getCostProfile(profile);
+}
+
+bool NpScene::checkHardMemoryBudget()
+{
+	if(!mHardMemoryBudget)
+		return true;
+
+	PxSceneMemoryUsage usage;
+	if(!getMemoryUsage(usage) || usage.total <= mHardMemoryBudget)
+		return true;
+
+	Ps::getFoundation().error(PxErrorCode::eOUT_OF_MEMORY, __FILE__, __LINE__, "PxScene::simulate: the scene uses %llu bytes, more than its hard memory budget of %llu bytes. The step is not started.", 
+		static_cast<unsigned long long>(usage.total), static_cast<unsigned long long>(mHardMemoryBudget));
+	if(mMemoryBudgetCallback)
+		mMemoryBudgetCallback->onBudgetExceeded(*this, usage, mHardMemoryBudget, true);
+	return false;
+}
+
+void NpScene::checkSoftMemoryBudget()
+{
+	if(!mSoftMemoryBudget)
+		return;
+
+	PxSceneMemoryUsage usage;
+	if(!getMemoryUsage(usage))
+		return;
+
+	if(usage.total <= mSoftMemoryBudget)
+	{
+		mSoftMemoryBudgetReported = false;
+		return;
+	}
+
+	if(!mSoftMemoryBudgetReported)
+	{
+		mSoftMemoryBudgetReported = true;
+		if(mMemoryBudgetCallback)
+			mMemoryBudgetCallback->onBudgetExceeded(*this, usage, mSoftMemoryBudget, false);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 //Multiclient 
@@ -1805,6 +2191,19 @@ bool NpScene::removeBroadPhaseRegion(PxU32 handle)
 	return mScene.removeBroadPhaseRegion(handle);
 }
 
+bool NpScene::setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)
+{
+	NP_WRITE_CHECK(this);
+	PX_CHECK_AND_RETURN_VAL(!desc || desc->isValid(), "PxScene::setBroadPhaseAdaptiveRegions(): invalid settings provided!", false);
+	return mScene.setBroadPhaseAdaptiveRegions(desc);
+}
+
+bool NpScene::getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs) const
+{
+	NP_READ_CHECK(this);
+	return mScene.getBroadPhaseTriggerPairs(createdPairs, lostPairs);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // Filtering
@@ -1836,6 +2235,12 @@ PxSimulationFilterShader NpScene::getFilterShader() const
 	return mScene.getFilterShader();
 }
 
+PxSimulationFilterBatchShader NpScene::getFilterBatchShader() const
+{
+	NP_READ_CHECK(this);
+	return mScene.getFilterBatchShader();
+}
+
 PxSimulationFilterCallback*	NpScene::getFilterCallback() const
 {
 	NP_READ_CHECK(this);
@@ -1955,6 +2360,7 @@ void NpScene::updateDirtyShaders()
 void NpScene::simulateOrCollide(PxReal elapsedTime, physx::PxBaseTask* completionTask, void* scratchBlock, PxU32 scratchBlockSize, bool controlSimulation, const char* invalidCallMsg, Sc::SimulationStage::Enum simStage)
 {
 	PX_SIMD_GUARD;
+	Ps::AllocationContextScope allocationContext(getContextId());
 
 	{
 		// write guard must end before simulation kicks off worker threads
@@ -1976,6 +2382,9 @@ void NpScene::simulateOrCollide(PxReal elapsedTime, physx::PxBaseTask* completio
 		PX_CHECK_AND_RETURN((reinterpret_cast<size_t>(scratchBlock)&15) == 0, "PxScene::simulate: scratch block must be 16-byte aligned!");
 	
 		PX_CHECK_AND_RETURN((scratchBlockSize&16383) == 0, "PxScene::simulate: scratch block size must be a multiple of 16K");
+
+		if(!checkHardMemoryBudget())
+			return;
 	
 #if PX_SUPPORT_PVD		
 		//signal the frame is starting.	
@@ -2010,6 +2419,9 @@ void NpScene::simulateOrCollide(PxReal elapsedTime, physx::PxBaseTask* completio
 		mScene.preSimulateUpdateAppThread(elapsedTime);
 #endif
 
+		// the queries issued while simulating see the changes made since fetchResults
+		mSQManager.publishSnapshots();
+
 		setSimulationStage(simStage);
 		mScene.setPhysicsBuffering(true);
 		mHasSimulatedOnce = true;
@@ -2073,6 +2485,7 @@ void NpScene::simulate(PxReal elapsedTime, physx::PxBaseTask* completionTask, vo
 void NpScene::advance( physx::PxBaseTask* completionTask)
 {
 	NP_WRITE_CHECK(this);
+	Ps::AllocationContextScope allocationContext(getContextId());
 	//issue error if advance() doesn't get called between fetchCollision() and fetchResult()
 	if(getSimulationStage() != Sc::SimulationStage::eFETCHCOLLIDE)
 	{
@@ -2110,16 +2523,30 @@ void NpScene::collide(PxReal elapsedTime, physx::PxBaseTask* completionTask, voi
 						Sc::SimulationStage::eCOLLIDE);
 }
 
+// Gives the dispatcher a chance to wait cooperatively (e.g. suspending a fiber) before blocking the thread
+static bool waitForSync(Ps::Sync& sync, bool block, PxCpuDispatcher* dispatcher)
+{
+	if(sync.wait(0))
+		return true;
+	if(!block)
+		return false;
+
+	if(dispatcher && dispatcher->waitUntil(isSyncSet, &sync))
+		return true;
+
+	return sync.wait(Ps::Sync::waitForever);
+}
+
 bool NpScene::checkResultsInternal(bool block)
 {
 	PX_PROFILE_ZONE("Basic.checkResults", getContextId());
-	return mPhysicsDone.wait(block ? Ps::Sync::waitForever : 0);
+	return waitForSync(mPhysicsDone, block, getTaskManager()->getCpuDispatcher());
 }
 
 bool NpScene::checkCollisionInternal(bool block)
 {
 	PX_PROFILE_ZONE("Basic.checkCollision", getContextId());
-	return mCollisionDone.wait(block ? Ps::Sync::waitForever : 0);
+	return waitForSync(mCollisionDone, block, getTaskManager()->getCpuDispatcher());
 }
 
 bool NpScene::checkResults(bool block)
@@ -2189,6 +2616,7 @@ void NpScene::fireOutOfBoundsCallbacks()
 
 bool NpScene::fetchCollision(bool block)
 {
+	Ps::AllocationContextScope allocationContext(getContextId());
 	if(getSimulationStage() != Sc::SimulationStage::eCOLLIDE)
 	{
 		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxScene::fetchCollision: fetchCollision() should be called after collide() and before advance()!");
@@ -2239,9 +2667,11 @@ void NpScene::fetchResultsPreContactCallbacks()
 
 	{
 		PX_PROFILE_ZONE("Sim.fireCallbacksPreSync", getContextId());
+		mScene.getScScene().beginStatsStage(PxSimulationStatistics::eSTAGE_CALLBACKS);
 		fireOutOfBoundsCallbacks();		// fire out-of-bounds callbacks
 		mScene.fireBrokenConstraintCallbacks();
 		mScene.fireTriggerCallbacks();
+		mScene.getScScene().endStatsStage(PxSimulationStatistics::eSTAGE_CALLBACKS);
 	}
 }
 
@@ -2250,6 +2680,7 @@ void NpScene::fetchResultsPostContactCallbacks()
 	mScene.postCallbacksPreSync();
 	mScene.syncEntireScene();	// double buffering
 
+	mScene.getScScene().beginStatsStage(PxSimulationStatistics::eSTAGE_SCENE_QUERY_UPDATE);
 	SqRefFinder sqRefFinder;
 	mScene.getScScene().syncSceneQueryBounds(mSQManager.getDynamicBoundsSync(), sqRefFinder);
 
@@ -2258,6 +2689,11 @@ void NpScene::fetchResultsPostContactCallbacks()
 	if((getFlagsFast() & PxSceneFlag::eSUPPRESS_EAGER_SCENE_QUERY_REFIT) && updateMode == PxSceneQueryUpdateMode::eBUILD_ENABLED_COMMIT_ENABLED)
 		updateMode = PxSceneQueryUpdateMode::eBUILD_ENABLED_COMMIT_DISABLED;
 	mSQManager.afterSync(updateMode);
+	mSQManager.publishSnapshots();
+	mScene.getScScene().endStatsStage(PxSimulationStatistics::eSTAGE_SCENE_QUERY_UPDATE);
+
+	// the results memoized for eENABLE_QUERY_CACHE only last a simulation step
+	mQueryResultCache.invalidate();
 
 #if PX_DEBUG && 0
 	mSQManager.validateSimUpdates();
@@ -2274,7 +2710,9 @@ void NpScene::fetchResultsPostContactCallbacks()
 	// we do this after buffer-swapping so that the events have the new state
 	{
 		PX_PROFILE_ZONE("Sim.fireCallbacksPostSync", getContextId());
+		mScene.getScScene().beginStatsStage(PxSimulationStatistics::eSTAGE_CALLBACKS);
 		mScene.fireCallBacksPostSync();
+		mScene.getScScene().endStatsStage(PxSimulationStatistics::eSTAGE_CALLBACKS);
 	}
 
 	mScene.postReportsCleanup();
@@ -2300,10 +2738,14 @@ void NpScene::fetchResultsPostContactCallbacks()
 
 	mPhysicsDone.reset();				// allow Physics to run again
 	mCollisionDone.reset();
+
+	// latch the high water marks of the thread temp arenas for this step
+	Ps::TempAllocator::endFrame();
 }
 
 bool NpScene::fetchResults(bool block, PxU32* errorState)
 {
+	Ps::AllocationContextScope allocationContext(getContextId());
 	if(getSimulationStage() != Sc::SimulationStage::eADVANCE)
 	{
 		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxScene::fetchResults: fetchResults() called illegally! It must be called after advance() or simulate()");
@@ -2331,7 +2773,9 @@ bool NpScene::fetchResults(bool block, PxU32* errorState)
 		{
 			// PT: TODO: why a cross-thread event here?
 			PX_PROFILE_START_CROSSTHREAD("Basic.processCallbacks", getContextId());
+			mScene.getScScene().beginStatsStage(PxSimulationStatistics::eSTAGE_CALLBACKS);
 			mScene.fireQueuedContactCallbacks();
+			mScene.getScScene().endStatsStage(PxSimulationStatistics::eSTAGE_CALLBACKS);
 			PX_PROFILE_STOP_CROSSTHREAD("Basic.processCallbacks", getContextId());
 		}
 
@@ -2344,6 +2788,9 @@ bool NpScene::fetchResults(bool block, PxU32* errorState)
 			*errorState = 0;
 	}
 
+	// out of the write check, so the callback can use the scene
+	checkSoftMemoryBudget();
+
 #if PX_SUPPORT_PVD
 	{
 		PX_SIMD_GUARD;
@@ -2355,6 +2802,7 @@ bool NpScene::fetchResults(bool block, PxU32* errorState)
 
 bool NpScene::fetchResultsStart(const PxContactPairHeader*& contactPairs, PxU32& nbContactPairs, bool block)
 {
+	Ps::AllocationContextScope allocationContext(getContextId());
 	if (getSimulationStage() != Sc::SimulationStage::eADVANCE)
 	{
 		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PXScene::fetchResultsStart: fetchResultsStart() called illegally! It must be called after advance() or simulate()");
@@ -2449,6 +2897,7 @@ void NpScene::processCallbacks(physx::PxBaseTask* continuation)
 
 void NpScene::fetchResultsFinish(PxU32* errorState)
 {
+	Ps::AllocationContextScope allocationContext(getContextId());
 	{
 		PX_SIMD_GUARD;
 		PX_PROFILE_STOP_CROSSTHREAD("Basic.processCallbacks", getContextId());
@@ -2466,6 +2915,9 @@ void NpScene::fetchResultsFinish(PxU32* errorState)
 		PX_PROFILE_STOP_CROSSTHREAD("Basic.simulate", getContextId());
 	}
 
+	// out of the write check, so the callback can use the scene
+	checkSoftMemoryBudget();
+
 #if PX_SUPPORT_PVD
 	mScene.getScenePvdClient().frameEnd();
 #endif
@@ -2581,7 +3033,8 @@ void NpScene::addParticleSystem(NpParticleSystem& system)
 {
 	PX_PROFILE_ZONE("API.addParticleSystem", getContextId());
 
-	PX_CHECK_AND_RETURN(mScene.getScScene().getParticleContext(), "PxRegisterParticles needs to be called before scene creation. PxParticleSystem not added to scene.");
+	// the scene's particle context is created by the first particle system, it only needs the registration
+	PX_CHECK_AND_RETURN(NpFactory::areParticlesRegistered(), "PxRegisterParticles needs to be called before adding particles. PxParticleSystem not added to scene.");
 	mScene.addParticleSystem(system.getScbParticleSystem());
 	mPxParticleBaseSet.insert(&system);
 
@@ -2593,7 +3046,7 @@ void NpScene::removeParticleSystem(NpParticleSystem& system)
 	PX_PROFILE_ZONE("API.removeParticleSystem", getContextId());
 	PX_ASSERT(system.getNpScene() == this);
 
-	PX_CHECK_AND_RETURN(mScene.getScScene().getParticleContext(), "PxRegisterParticles needs to be called before scene creation. PxParticleFluid not added to scene.");
+	PX_CHECK_AND_RETURN(NpFactory::areParticlesRegistered(), "PxRegisterParticles needs to be called before adding particles. PxParticleSystem not removed from scene.");
 	mScene.removeParticleSystem(system.getScbParticleSystem(), false);
 	removeFromParticleBaseList(system);
 
@@ -3015,7 +3468,12 @@ void NpScene::lockRead(const char* /*file*/, PxU32 /*line*/)
 	// only lock on first read
 	// if we are the current writer then increment the reader count but don't actually lock (allow reading from threads with write ownership)
 	if (localCounts.readLockDepth == 1)
-		mRWLock.lockReader(mCurrentWriter != Thread::getId());
+	{
+		if(mDistributedRWLock)
+			mDistributedRWLock->lockReader(mCurrentWriter != Thread::getId());
+		else
+			mRWLock.lockReader(mCurrentWriter != Thread::getId());
+	}
 }
 
 void NpScene::unlockRead()
@@ -3032,7 +3490,12 @@ void NpScene::unlockRead()
 
 	// only unlock on last read
 	if(localCounts.readLockDepth == 0)
-		mRWLock.unlockReader();
+	{
+		if(mDistributedRWLock)
+			mDistributedRWLock->unlockReader();
+		else
+			mRWLock.unlockReader();
+	}
 }
 
 void NpScene::lockWrite(const char* file, PxU32 line)
@@ -3049,7 +3512,12 @@ void NpScene::lockWrite(const char* file, PxU32 line)
 
 	// only lock on first call
 	if (localCounts.writeLockDepth == 1)
-		mRWLock.lockWriter();
+	{
+		if(mDistributedRWLock)
+			mDistributedRWLock->lockWriter();
+		else
+			mRWLock.lockWriter();
+	}
 
 	PX_ASSERT(mCurrentWriter == 0 || mCurrentWriter == Thread::getId());
 
@@ -3074,7 +3542,10 @@ void NpScene::unlockWrite()
 	if (localCounts.writeLockDepth == 0)
 	{
 		mCurrentWriter = 0;	
-		mRWLock.unlockWriter();
+		if(mDistributedRWLock)
+			mDistributedRWLock->unlockWriter();
+		else
+			mRWLock.unlockWriter();
 	}
 }
 
@@ -3106,22 +3577,9 @@ static PX_FORCE_INLINE void shiftRigidActor(PxRigidActor* a, const PxVec3& shift
 	}
 }
 
-void NpScene::shiftOrigin(const PxVec3& shift)
+static void shiftRigidActors(PxRigidActor*const* rigidActors, PxU32 rigidCount, const PxVec3& shift)
 {
-	PX_PROFILE_ZONE("API.shiftOrigin", getContextId());
-	NP_WRITE_CHECK(this);
-
-	if(mScene.isPhysicsBuffering())
-	{
-		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxScene::shiftOrigin() not allowed while simulation is running. Call will be ignored.");
-		return;
-	}
-	
-	PX_SIMD_GUARD;
-
 	const PxU32 prefetchLookAhead = 4;
-	PxU32 rigidCount = mRigidActors.size();
-	PxRigidActor*const* rigidActors = mRigidActors.begin();
 	PxU32 batchIterCount = rigidCount / prefetchLookAhead;
 	
 	PxU32 idx = 0;
@@ -3160,6 +3618,99 @@ void NpScene::shiftOrigin(const PxVec3& shift)
 	{
 		shiftRigidActor(rigidActors[i], shift);
 	}
+}
+
+namespace
+{
+	// Shifts a range of the scene actors. Each actor only touches its own data, so the ranges can run at the same time
+	class ShiftActorsTask : public Cm::Task
+	{
+	public:
+		ShiftActorsTask(PxU64 contextId, PxRigidActor*const* actors, PxU32 nbActors, const PxVec3& shift) :
+			Cm::Task(contextId), mActors(actors), mNbActors(nbActors), mShift(shift)	{}
+
+		virtual void runInternal()
+		{
+			PX_SIMD_GUARD;
+			shiftRigidActors(mActors, mNbActors, mShift);
+		}
+
+		virtual const char* getName() const { return "NpScene.shiftActors"; }
+
+		static const PxU32 MaxActors = 2048;
+	private:
+		PxRigidActor*const*	mActors;
+		const PxU32			mNbActors;
+		const PxVec3		mShift;
+
+		PX_NOCOPY(ShiftActorsTask)
+	};
+
+	// The scene query structures only hold copies of the bounds, and don't depend on the actors or the simulation side
+	class ShiftSceneQueriesTask : public Cm::Task
+	{
+	public:
+		ShiftSceneQueriesTask(PxU64 contextId, Sq::SceneQueryManager& manager, const PxVec3& shift) :
+			Cm::Task(contextId), mManager(manager), mShift(shift)	{}
+
+		virtual void runInternal()
+		{
+			PX_SIMD_GUARD;
+			mManager.shiftOrigin(mShift);
+		}
+
+		virtual const char* getName() const { return "NpScene.shiftSceneQueries"; }
+	private:
+		Sq::SceneQueryManager&	mManager;
+		const PxVec3			mShift;
+
+		PX_NOCOPY(ShiftSceneQueriesTask)
+	};
+}
+
+void NpScene::shiftOrigin(const PxVec3& shift)
+{
+	PX_PROFILE_ZONE("API.shiftOrigin", getContextId());
+	NP_WRITE_CHECK(this);
+
+	if(mScene.isPhysicsBuffering())
+	{
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxScene::shiftOrigin() not allowed while simulation is running. Call will be ignored.");
+		return;
+	}
+	
+	PX_SIMD_GUARD;
+
+	const PxU32 rigidCount = mRigidActors.size();
+	PxRigidActor*const* rigidActors = mRigidActors.begin();
+
+	// The actors, the scene queries and the simulation side share no data, so on large scenes they are shifted
+	// at the same time on the workers. The actors are split in batches, this thread taking the first one
+	const PxU32 nbPerTask = ShiftActorsTask::MaxActors;
+	PxCpuDispatcher* dispatcher = mTaskManager ? mTaskManager->getCpuDispatcher() : NULL;
+	const bool parallel = (rigidCount > nbPerTask) && dispatcher && dispatcher->getWorkerCount();
+	if(parallel)
+	{
+		Cm::FlushPool& pool = *mScene.getScScene().getFlushPool();
+		SceneCompletion* doneTask = PX_PLACEMENT_NEW(pool.allocate(sizeof(SceneCompletion)), SceneCompletion)(getContextId(), mShiftOriginDone);
+		doneTask->setContinuation(*mTaskManager, NULL);
+
+		ShiftSceneQueriesTask* sqTask = PX_PLACEMENT_NEW(pool.allocate(sizeof(ShiftSceneQueriesTask)), ShiftSceneQueriesTask)(getContextId(), mSQManager, shift);
+		sqTask->setContinuation(doneTask);
+		sqTask->removeReference();
+
+		for(PxU32 i=nbPerTask; i < rigidCount; i += nbPerTask)
+		{
+			ShiftActorsTask* task = PX_PLACEMENT_NEW(pool.allocate(sizeof(ShiftActorsTask)), ShiftActorsTask)(getContextId(), rigidActors + i, PxMin(nbPerTask, rigidCount - i), shift);
+			task->setContinuation(doneTask);
+			task->removeReference();
+		}
+		doneTask->removeReference();
+
+		shiftRigidActors(rigidActors, nbPerTask, shift);
+	}
+	else
+		shiftRigidActors(rigidActors, rigidCount, shift);
 
 	PxArticulation*const* articulations = mArticulations.getEntries();
 	for(PxU32 i=0; i < mArticulations.size(); i++)
@@ -3176,11 +3727,20 @@ void NpScene::shiftOrigin(const PxVec3& shift)
 
 	mScene.shiftOrigin(shift);
 
-
-	//
-	// shift scene query related data structures
-	//
-	mSQManager.shiftOrigin(shift);
+	if(parallel)
+	{
+		if(!dispatcher->waitUntil(isSyncSet, &mShiftOriginDone))
+			mShiftOriginDone.wait();
+		mShiftOriginDone.reset();
+	}
+	else
+	{
+		//
+		// shift scene query related data structures
+		//
+		mSQManager.shiftOrigin(shift);
+	}
+	mQueryResultCache.invalidate();
 
 	Ps::HashSet<NpVolumeCache*>::Iterator it = mVolumeCaches.getIterator();
 	while (!it.done())
@@ -37,6 +37,7 @@
 #include "PsArray.h"
 #include "PsThread.h"
 #include "PsHashSet.h"
+#include "PsDistributedReadWriteLock.h"
 #include "PxPhysXConfig.h"
 
 #if PX_SUPPORT_GPU_PHYSX
@@ -116,6 +117,7 @@ class NpScene : public NpSceneQueries, public Ps::UserAllocated
 	public:
 
 	virtual			void							release();
+	virtual			void							reset();
 
 	virtual			void							setFlag(PxSceneFlag::Enum flag, bool value);
 	virtual			PxSceneFlags					getFlags() const;
@@ -152,6 +154,7 @@ class NpScene : public NpSceneQueries, public Ps::UserAllocated
 //~PX_AGGREGATE
 	
 	virtual			void							addCollection(const PxCollection& collection);
+	virtual			PxU32							addCollection(const PxCollection& collection, PxU32 startIndex, PxU32 maxActors);
 
 	// Groups
 	virtual			void							setDominanceGroupPair(PxDominanceGroup group1, PxDominanceGroup group2, const PxDominanceGroupPair& dominance);
@@ -165,6 +168,11 @@ class NpScene : public NpSceneQueries, public Ps::UserAllocated
 
 	// Run
 	virtual			void							getSimulationStatistics(PxSimulationStatistics& s) const;
+	virtual			bool							getMemoryUsage(PxSceneMemoryUsage& usage) const;
+	virtual			void							setMemoryBudget(PxU64 softLimit, PxU64 hardLimit, PxMemoryBudgetCallback* callback);
+	virtual			void							setCostProfiling(PxU32 maxEntries);
+	virtual			PxU32							getCostProfiling() const;
+	virtual			bool							getCostProfile(PxCostProfile& profile) const;
 
 	// Multiclient 
 	virtual			PxClientID						createClient();
@@ -204,6 +212,7 @@ class NpScene : public NpSceneQueries, public Ps::UserAllocated
 	virtual			const void*						getFilterShaderData() const;
 	virtual			PxU32							getFilterShaderDataSize() const;
 	virtual			PxSimulationFilterShader		getFilterShader() const;
+	virtual			PxSimulationFilterBatchShader	getFilterBatchShader() const;
 	virtual			PxSimulationFilterCallback*		getFilterCallback() const;
 	virtual			void							resetFiltering(PxActor& actor);
 	virtual			void							resetFiltering(PxRigidActor& actor, PxShape*const* shapes, PxU32 shapeCount);
@@ -276,11 +285,17 @@ class NpScene : public NpSceneQueries, public Ps::UserAllocated
 	virtual			PxU32							getBroadPhaseRegions(PxBroadPhaseRegionInfo* userBuffer, PxU32 bufferSize, PxU32 startIndex=0) const;
 	virtual			PxU32							addBroadPhaseRegion(const PxBroadPhaseRegion& region, bool populateRegion);
 	virtual			bool							removeBroadPhaseRegion(PxU32 handle);
+	virtual			bool							setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc);
+	virtual			bool							getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs)	const;
 
 	virtual			void							addActors(PxActor*const* actors, PxU32 nbActors);
 	virtual			void							addActors(const PxPruningStructure& prunerStructure);
 	virtual			void							removeActors(PxActor*const* actors, PxU32 nbActors, bool wakeOnLostTouch);
 
+	virtual			void							setGlobalPoses(PxRigidDynamic*const* actors, const PxTransform* poses, PxU32 count, bool autowake);
+	virtual			void							setKinematicTargets(PxRigidDynamic*const* actors, const PxTransform* destinations, PxU32 count);
+	virtual			void							setLinearVelocities(PxRigidDynamic*const* actors, const PxVec3* velocities, PxU32 count, bool autowake);
+
 	virtual			void							lockRead(const char* file=NULL, PxU32 line=0);
 	virtual			void							unlockRead();
 
@@ -399,12 +414,17 @@ private:
 					void							fetchResultsPreContactCallbacks();
 					void							fetchResultsPostContactCallbacks();
 
+					// Notify the budget callback, return false if the step must not start
+					bool							checkHardMemoryBudget();
+					void							checkSoftMemoryBudget();
+
 
 
 					void							updateScbStateAndSetupSq(const PxRigidActor& rigidActor, Scb::Actor& actor, NpShapeManager& shapeManager, bool actorDynamic, const PxBounds3* bounds, bool hasPrunerStructure);
 	PX_FORCE_INLINE	void							updateScbStateAndSetupSq(const PxRigidActor& rigidActor, Scb::Body& body, NpShapeManager& shapeManager, bool actorDynamic, const PxBounds3* bounds, bool hasPrunerStructure);
 
 					Cm::RenderBuffer				mRenderBuffer;
+					Ps::Array<Cm::RenderBuffer*>	mVisualizationBuffers;	// one per visualization task, kept from one frame to the next
 
 					Ps::CoalescedHashSet<PxConstraint*> mConstraints;
 					Ps::Array<PxRigidActor*>		mRigidActors;  // no hash set used because it would be quite a bit slower when adding a large number of actors
@@ -429,6 +449,8 @@ private:
 					Ps::Sync						mPhysicsDone;		// physics thread signals this when update ready
 					Ps::Sync						mCollisionDone;		// physics thread signals this when all collisions ready
 					Ps::Sync						mSceneQueriesDone;	// physics thread signals this when all scene queries update ready
+					Ps::Sync						mShiftOriginDone;	// worker threads signal this when the origin shift tasks are done
+					Ps::Sync						mVisualizationDone;	// worker threads signal this when the visualization tasks are done
 
 
 		//legacy timing settings:
@@ -492,11 +514,18 @@ private:
 					PxU32							mThreadReadWriteDepth;
 					Ps::Thread::Id					mCurrentWriter;
 					Ps::ReadWriteLock				mRWLock;
+					// used instead of mRWLock with PxSceneFlag::eENABLE_DISTRIBUTED_READ_LOCK
+					Ps::DistributedReadWriteLock*	mDistributedRWLock;
 
 					bool							mSceneQueriesUpdateRunning;
 
 					bool							mHasSimulatedOnce;
 					bool							mBetweenFetchResults;
+
+					PxU64							mSoftMemoryBudget;
+					PxU64							mHardMemoryBudget;
+					PxMemoryBudgetCallback*			mMemoryBudgetCallback;
+					bool							mSoftMemoryBudgetReported;	// until the usage drops below the soft limit
 };
 
 
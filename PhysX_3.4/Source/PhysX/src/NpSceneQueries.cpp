@@ -34,6 +34,10 @@
 #include "SqPruner.h"
 #include "GuBounds.h"
 #include "GuIntersectionRay.h"
+#include "PsInlineArray.h"
+#include "PsTempAllocator.h"
+#include "geometry/PxMeshQuery.h"
+#include "GuDistancePointTriangle.h"
 
 // Synchronous scene queries
 
@@ -87,6 +91,8 @@ bool NpSceneQueries::raycast(
 	PX_SIMD_GUARD;
 
 	MultiQueryInput input(origin, unitDir, distance);
+	if(getFlagsFast() & PxSceneFlag::eENABLE_QUERY_CACHE)
+		return cachedMultiQuery<PxRaycastHit>(input, hits, hitFlags, cache, filterData, filterCall);
 	return multiQuery<PxRaycastHit>(input, hits, hitFlags, cache, filterData, filterCall, NULL);
 }
 
@@ -101,6 +107,8 @@ bool NpSceneQueries::overlap(
 
 	MultiQueryInput input(&geometry, &pose);
 	// we are not supporting cache for overlaps for some reason
+	if(getFlagsFast() & PxSceneFlag::eENABLE_QUERY_CACHE)
+		return cachedMultiQuery<PxOverlapHit>(input, hits, PxHitFlags(), NULL, filterData, filterCall);
 	return multiQuery<PxOverlapHit>(input, hits, PxHitFlags(), NULL, filterData, filterCall, NULL);
 }
 
@@ -142,6 +150,8 @@ bool NpSceneQueries::sweep(
 		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, " Precise sweep doesn't support inflation, inflation will be overwritten to be zero");
 	}
 	MultiQueryInput input(&geometry, &pose, unitDir, distance, realInflation);
+	if(getFlagsFast() & PxSceneFlag::eENABLE_QUERY_CACHE)
+		return cachedMultiQuery<PxSweepHit>(input, hits, hitFlags, cache, filterData, filterCall);
 	return multiQuery<PxSweepHit>(input, hits, hitFlags, cache, filterData, filterCall, NULL);
 }
 
@@ -356,6 +366,7 @@ struct MultiQueryCallback : public PrunerCallback
 	PxBounds3					mQueryShapeBounds;
 	bool						mQueryShapeBoundsValid;
 	const ShapeData*			mShapeData;
+	const PrunerSnapshotSet*	mSnapshots; // the snapshots the pruners come from, NULL for the pruners of the scene
 
 	MultiQueryCallback(
 		const NpSceneQueries& scene, const MultiQueryInput& input, bool anyHit, PxHitCallback<HitType>& hitCall, PxHitFlags hitFlags,
@@ -375,8 +386,11 @@ struct MultiQueryCallback : public PrunerCallback
 			mAnyHit					(anyHit),
 			mIsCached				(false),
 			mQueryShapeBoundsValid	(false),
-			mShapeData				(NULL)
+			mShapeData				(NULL),
+			mSnapshots				(NULL)
 	{
+		// the trees can only cull with word0 when it is the only word the filter equation uses. The batch queries skip the equation
+		mFilterMask = (!aBfd && !(filterData.data.word1 | filterData.data.word2 | filterData.data.word3)) ? filterData.data.word0 : 0;
 	}
 	
 	virtual PxAgain invoke(PxReal& aDist, const PrunerPayload& aPayload)
@@ -412,9 +426,10 @@ struct MultiQueryCallback : public PrunerCallback
 		const Scb::Shape* shape = actorShape.scbShape;
 		const Scb::Actor* actor = actorShape.scbActor;
 
-		// compute the global pose for the cached shape and actor
+		// compute the global pose for the cached shape and actor, the snapshots keep the poses of their objects
 		PX_ALIGN(16, PxTransform) globalPose;
-		NpActor::getGlobalPose(globalPose, *shape, *actor);
+		if(!mSnapshots || !mSnapshots->getPose(aPayload, globalPose))
+			NpActor::getGlobalPose(globalPose, *shape, *actor);
 
 		const PxGeometry& shapeGeom = shape->getGeometry();
 
@@ -516,7 +531,7 @@ struct MultiQueryCallback : public PrunerCallback
 							PxQueryFilterData fd1 = mFilterData; fd1.flags |= PxQueryFlag::eRESERVED;
 							PxHitBuffer<HitType> buf1; // create a temp callback buffer for a single blocking hit
 							if(!mFarBlockFound && mHitCall.maxNbTouches > 0 && mScene.NpSceneQueries::multiQuery<HitType>(
-								mInput, buf1, mHitFlags, NULL, fd1, mFilterCall, mBfd))
+								mInput, buf1, mHitFlags, NULL, fd1, mFilterCall, mBfd, mSnapshots))
 							{
 								mHitCall.block = buf1.block;
 								mHitCall.hasBlock = true;
@@ -581,7 +596,7 @@ struct CapturePvdOnReturn : public PxHitCallback<HitType>
 	const PxQueryFilterData&	mFilterData;
 	PxQueryFilterCallback*		mFilterCall;	// PT: TODO: this is not used!
 	BatchQueryFilterData*		mBFD;			// PT: TODO: check if this is sometimes not NULL
-	Ps::Array<HitType>			mAllHits;
+	Ps::InlineArray<HitType, 8, Ps::TempAllocator>	mAllHits;	// most queries return a handful of hits
 	PxHitCallback<HitType>&		mParentCallback;
 
 	CapturePvdOnReturn(
@@ -675,11 +690,79 @@ private:
 
 #undef HITDIST
 
+//========================================================================================================================
+// Records the blocking hit of a query in its coherence cache, once the query is complete (see PxQueryCoherenceCache)
+template<typename HitType>
+struct RecordCoherenceOnReturn
+{
+	PxQueryCoherenceCache*			mCache;
+	const PxHitCallback<HitType>&	mHits;
+
+	PX_FORCE_INLINE RecordCoherenceOnReturn(PxQueryCoherenceCache* cache, const PxHitCallback<HitType>& hits) : mCache(cache), mHits(hits)	{}
+
+	~RecordCoherenceOnReturn()
+	{
+		if(mCache && mHits.hasBlock && mHits.block.shape && mHits.block.actor)
+			mCache->record(mHits.block.shape, mHits.block.actor);
+	}
+
+private:
+	RecordCoherenceOnReturn<HitType>& operator=(const RecordCoherenceOnReturn<HitType>&);
+};
+
+// Tests the shapes of a coherence cache, except the one already tested as the single shape cache. Returns false if the query was ended
+template<typename HitType>
+static PxAgain invokeCoherenceCache(MultiQueryCallback<HitType>& pcb, const PxQueryCoherenceCache& coherence, const PxShape* testedShape, const PxScene& scene, const SceneQueryManager& sqManager)
+{
+	for(PxU32 i=0; i<coherence.getNbEntries(); i++)
+	{
+		PxShape* cachedShape = coherence.getShape(i);
+		PxRigidActor* cachedActor = coherence.getActor(i);
+		if(cachedShape == testedShape || cachedActor->getScene() != &scene)
+			continue;
+
+		const PrunerData data = NpActor::getShapeManager(*cachedActor)->findSceneQueryData(*static_cast<NpShape*>(cachedShape));
+		if(data == SQ_INVALID_PRUNER_DATA)
+			continue;
+
+		PxReal dummyDist;
+		if(!pcb.invoke(dummyDist, sqManager.getPayload(data)))
+			return false;
+	}
+	return true;
+}
+
+//========================================================================================================================
+// Reads the published pruner snapshots for the duration of a query, see PxSceneFlag::eENABLE_QUERY_SNAPSHOTS.
+// Nested queries reuse the snapshots of their parent, acquiring again could wait on a writer that waits on the parent.
+struct SnapshotReadScope
+{
+	const SceneQueryManager&	mSQManager;
+	const PrunerSnapshotSet*	mSnapshots;
+	const bool					mOwner;
+
+	SnapshotReadScope(const SceneQueryManager& sqManager, const PrunerSnapshotSet* parentSnapshots) :
+		mSQManager	(sqManager),
+		mSnapshots	(parentSnapshots ? parentSnapshots : sqManager.acquireSnapshots()),
+		mOwner		(!parentSnapshots)
+	{
+	}
+
+	~SnapshotReadScope()
+	{
+		if(mOwner)
+			mSQManager.releaseSnapshots(mSnapshots);
+	}
+
+private:
+	SnapshotReadScope& operator=(const SnapshotReadScope&);
+};
+
 //========================================================================================================================
 template<typename HitType>
 bool NpSceneQueries::multiQuery(
 	const MultiQueryInput& input, PxHitCallback<HitType>& hits, PxHitFlags hitFlags, const PxQueryCache* cache,
-	const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall, BatchQueryFilterData* bfd) const
+	const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall, BatchQueryFilterData* bfd, const PrunerSnapshotSet* snapshots) const
 {
 	const bool anyHit = (filterData.flags & PxQueryFlag::eANY_HIT) == PxQueryFlag::eANY_HIT;
 
@@ -718,18 +801,28 @@ bool NpSceneQueries::multiQuery(
 			"NpSceneQueries multiQuery input check: zero-length sweep only valid without the PxHitFlag::eASSUME_NO_INITIAL_OVERLAP flag", 0);
 	}
 
-	PX_CHECK_MSG(!cache || (cache && cache->shape && cache->actor), "Raycast cache specified but shape or actor pointer is NULL!");	
-	const PrunerData cacheData = cache ? NpActor::getShapeManager(*cache->actor)->findSceneQueryData(*static_cast<NpShape*>(cache->shape)) : SQ_INVALID_PRUNER_DATA;
+	PX_CHECK_MSG(!cache || (cache->shape ? cache->actor != NULL : cache->coherence != NULL), "Raycast cache specified but shape or actor pointer is NULL!");	
+
+	// destroyed after cbr, the callbacks are issued while the snapshots are still held
+	const SnapshotReadScope snapshotScope(mSQManager, snapshots);
+
+	// the cached payload would come from the pruners that the snapshots stand for, it's only an optimization so it's skipped
+	const PrunerData cacheData = (cache && cache->shape && cache->actor && !snapshotScope.mSnapshots) ? NpActor::getShapeManager(*cache->actor)->findSceneQueryData(*static_cast<NpShape*>(cache->shape)) : SQ_INVALID_PRUNER_DATA;
 
 	// this function is logically const for the SDK user, as flushUpdates() will not have an API-visible effect on this object
 	// internally however, flushUpdates() changes the states of the Pruners in mSQManager
 	// because here is the only place we need this, const_cast instead of making SQM mutable
-	const_cast<NpSceneQueries*>(this)->mSQManager.flushUpdates();
+	// the snapshots are complete when published
+	if(!snapshotScope.mSnapshots)
+		const_cast<NpSceneQueries*>(this)->mSQManager.flushUpdates();
 
 #if PX_SUPPORT_PVD
 	CapturePvdOnReturn<HitType> pvdCapture(this, input, hitFlags, cache, filterData, filterCall, bfd, hits);
 #endif
 
+	// the coherence cache has the same restrictions as the single shape cache, and overlaps don't use caches
+	PxQueryCoherenceCache* coherence = (cache && !HitTypeSupport<HitType>::IsOverlap && hits.maxNbTouches == 0) ? cache->coherence : NULL;
+	RecordCoherenceOnReturn<HitType> rcr(coherence, hits); // destructor records the blocking hit, after cbr
 	IssueCallbacksOnReturn<HitType> cbr(hits); // destructor will execute callbacks on return from this function
 	hits.hasBlock = false;
 	hits.nbTouches = 0;
@@ -738,6 +831,7 @@ bool NpSceneQueries::multiQuery(
 	if(HitTypeSupport<HitType>::IsSweep)
 		shrunkDistance = PxMin(shrunkDistance, PX_MAX_SWEEP_DISTANCE);
 	MultiQueryCallback<HitType> pcb(*this, input, anyHit, hits, hitFlags, filterData, filterCall, shrunkDistance, bfd);
+	pcb.mSnapshots = snapshotScope.mSnapshots;
 
 	if(cacheData!=SQ_INVALID_PRUNER_DATA && hits.maxNbTouches == 0) // don't use cache for queries that can return touch hits
 	{
@@ -764,8 +858,28 @@ bool NpSceneQueries::multiQuery(
 			return hits.hasAnyHits();
 	}
 
-	const Pruner* staticPruner = mSQManager.get(PruningIndex::eSTATIC).pruner();
-	const Pruner* dynamicPruner = mSQManager.get(PruningIndex::eDYNAMIC).pruner();
+	// then the recent hits of the query stream. They go through the filters, and any hit shrinks the distance the pruners traverse below.
+	// Like the single shape cache, they are skipped when reading snapshots since their pruner data comes from the scene.
+	if(coherence && !snapshotScope.mSnapshots && coherence->getNbEntries())
+	{
+		PxAgain againAfterCoherence;
+		if(HitTypeSupport<HitType>::IsSweep)
+		{
+			const ShapeData sd(*input.geometry, *input.pose, input.inflation);
+			pcb.mQueryShapeBounds = sd.getPrunerInflatedWorldAABB();
+			pcb.mQueryShapeBoundsValid = true;
+			pcb.mShapeData = &sd;
+			againAfterCoherence = invokeCoherenceCache(pcb, *coherence, cache->shape, *this, mSQManager);
+			pcb.mShapeData = NULL;
+		} else
+			againAfterCoherence = invokeCoherenceCache(pcb, *coherence, cache->shape, *this, mSQManager);
+		if(!againAfterCoherence)
+			return hits.hasAnyHits();
+	}
+
+	const PrunerSnapshotSet* snapshotSet = snapshotScope.mSnapshots;
+	const Pruner* staticPruner = snapshotSet ? snapshotSet->getPruner(PruningIndex::eSTATIC) : mSQManager.get(PruningIndex::eSTATIC).pruner();
+	const Pruner* dynamicPruner = snapshotSet ? snapshotSet->getPruner(PruningIndex::eDYNAMIC) : mSQManager.get(PruningIndex::eDYNAMIC).pruner();
 
 	const PxU32 doStatics = filterData.flags & PxQueryFlag::eSTATIC;
 	const PxU32 doDynamics = filterData.flags & PxQueryFlag::eDYNAMIC;
@@ -819,6 +933,388 @@ bool NpSceneQueries::multiQuery(
 	}
 }
 
+//========================================================================================================================
+// Forwards the callbacks of a query to the user callback and keeps the touches, for the query result cache.
+// The result can be replayed only if the touches never filled the buffer, since the query might otherwise have been cut short
+// or continued past a processTouches call that a replay wouldn't issue.
+template<typename HitType>
+struct RecordHitsCallback : public PxHitCallback<HitType>
+{
+	PxHitCallback<HitType>&	mParentCallback;
+	Ps::InlineArray<HitType, 8, Ps::TempAllocator>	mTouches;
+	PxU32					mNbProcessCalls;
+	bool					mOverflow;
+	bool					mFinalized;
+
+	RecordHitsCallback(PxHitCallback<HitType>& parentCallback) :
+		PxHitCallback<HitType>	(parentCallback.touches, parentCallback.maxNbTouches),
+		mParentCallback			(parentCallback),
+		mNbProcessCalls			(0),
+		mOverflow				(false),
+		mFinalized				(false)
+	{}
+
+	virtual PxAgain processTouches(const HitType* hits, PxU32 nbHits)
+	{
+		if(nbHits == this->maxNbTouches)
+			mOverflow = true;
+		else if(!mNbProcessCalls)
+		{
+			for(PxU32 i=0; i<nbHits; i++)
+				mTouches.pushBack(hits[i]);
+		}
+		mNbProcessCalls++;
+
+		syncParent(nbHits);
+		return mParentCallback.processTouches(hits, nbHits);
+	}
+
+	virtual void finalizeQuery()
+	{
+		mFinalized = true;
+		syncParent(this->nbTouches);
+		mParentCallback.finalizeQuery();
+	}
+
+	// without a processTouches call the touches must all have been flushed before, which only happens on overflow
+	PX_FORCE_INLINE bool isCacheable() const
+	{
+		return mFinalized && !mOverflow && (mNbProcessCalls == 1 || (mNbProcessCalls == 0 && this->nbTouches == 0));
+	}
+
+private:
+	PX_FORCE_INLINE void syncParent(PxU32 nbTouches)
+	{
+		mParentCallback.hasBlock = this->hasBlock;
+		if(this->hasBlock)
+			mParentCallback.block = this->block;
+		mParentCallback.nbTouches = nbTouches;
+	}
+
+	RecordHitsCallback<HitType>& operator=(const RecordHitsCallback<HitType>&);
+};
+
+//========================================================================================================================
+template<typename HitType>
+bool NpSceneQueries::cachedMultiQuery(
+	const MultiQueryInput& input, PxHitCallback<HitType>& hits, PxHitFlags hitFlags, const PxQueryCache* cache,
+	const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall) const
+{
+	// filter callbacks can depend on state the cache doesn't see, and a query cache changes the hit eANY_HIT reports
+	QueryResultKey key;
+	if(filterCall || cache || !key.set(input, hitFlags, filterData, hits.maxNbTouches))
+		return multiQuery<HitType>(input, hits, hitFlags, cache, filterData, filterCall, NULL);
+
+	// the timestamps must account for the pending pruner updates, see multiQuery. With snapshots the queries see the
+	// published version instead, which changes with every publish or removal.
+	PxU32 staticTimestamp, dynamicTimestamp;
+	const PxU32 snapshotVersion = mSQManager.getSnapshotVersion();
+	if(snapshotVersion)
+	{
+		staticTimestamp = snapshotVersion;
+		dynamicTimestamp = 0xffffffff;
+	}
+	else
+	{
+		const_cast<NpSceneQueries*>(this)->mSQManager.flushUpdates();
+		staticTimestamp = mSQManager.get(PruningIndex::eSTATIC).timestamp();
+		dynamicTimestamp = mSQManager.get(PruningIndex::eDYNAMIC).timestamp();
+	}
+
+	if(mQueryResultCache.find(key, staticTimestamp, dynamicTimestamp, hits))
+	{
+		// same callbacks as IssueCallbacksOnReturn, multiQuery returns before they are issued
+		const bool hasAnyHits = hits.hasAnyHits();
+		if(hits.nbTouches && hits.processTouches(hits.touches, hits.nbTouches))
+			hits.nbTouches = 0;
+		hits.finalizeQuery();
+		return hasAnyHits;
+	}
+
+	RecordHitsCallback<HitType> record(hits);
+	const bool hasAnyHits = multiQuery<HitType>(input, record, hitFlags, NULL, filterData, NULL, NULL);
+	if(record.isCacheable())
+		mQueryResultCache.store(key, staticTimestamp, dynamicTimestamp, record.hasBlock, record.block, record.mTouches.begin(), record.mTouches.size());
+	return hasAnyHits;
+}
+
+//========================================================================================================================
+void NpSceneQueries::multiRaycastPacket(
+	PxU32 nbRays, const MultiQueryInput* const* inputs, PxRaycastBuffer* hits, const PxHitFlags* hitFlags,
+	const PxQueryFilterData* const* filterData, BatchQueryFilterData* bfd) const
+{
+	PX_ASSERT(nbRays && nbRays <= SQ_RAY_PACKET_SIZE);
+
+	// see multiQuery
+	const SnapshotReadScope snapshotScope(mSQManager, NULL);
+	const PrunerSnapshotSet* snapshotSet = snapshotScope.mSnapshots;
+	if(!snapshotSet)
+		const_cast<NpSceneQueries*>(this)->mSQManager.flushUpdates();
+
+	// the per-ray helpers of multiQuery, built in place since they hold references
+#if PX_SUPPORT_PVD
+	PX_ALIGN(16, PxU8 pvdCaptureBuffer[sizeof(CapturePvdOnReturn<PxRaycastHit>)*SQ_RAY_PACKET_SIZE]);
+	CapturePvdOnReturn<PxRaycastHit>* pvdCaptures = reinterpret_cast<CapturePvdOnReturn<PxRaycastHit>*>(pvdCaptureBuffer);
+#endif
+	PX_ALIGN(16, PxU8 cbrBuffer[sizeof(IssueCallbacksOnReturn<PxRaycastHit>)*SQ_RAY_PACKET_SIZE]);
+	IssueCallbacksOnReturn<PxRaycastHit>* cbrs = reinterpret_cast<IssueCallbacksOnReturn<PxRaycastHit>*>(cbrBuffer);
+	PX_ALIGN(16, PxU8 pcbBuffer[sizeof(MultiQueryCallback<PxRaycastHit>)*SQ_RAY_PACKET_SIZE]);
+	MultiQueryCallback<PxRaycastHit>* pcbs = reinterpret_cast<MultiQueryCallback<PxRaycastHit>*>(pcbBuffer);
+
+	PxVec3 origins[SQ_RAY_PACKET_SIZE];
+	PxVec3 unitDirs[SQ_RAY_PACKET_SIZE];
+	PxReal* distances[SQ_RAY_PACKET_SIZE];
+	PrunerCallback* callbacks[SQ_RAY_PACKET_SIZE];
+	PxU32 staticMask = 0, dynamicMask = 0;
+	for(PxU32 i=0;i<nbRays;i++)
+	{
+		const MultiQueryInput& input = *inputs[i];
+		const PxQueryFilterData& fd = *filterData[i];
+		PX_ASSERT(hits[i].maxNbTouches == 0);
+		PX_ASSERT(input.maxDistance > 0.0f && input.getDir().isNormalized());
+
+		const bool anyHit = (fd.flags & PxQueryFlag::eANY_HIT) == PxQueryFlag::eANY_HIT;
+#if PX_SUPPORT_PVD
+		PX_PLACEMENT_NEW(pvdCaptures + i, CapturePvdOnReturn<PxRaycastHit>)(this, input, hitFlags[i], NULL, fd, NULL, bfd, hits[i]);
+#endif
+		PX_PLACEMENT_NEW(cbrs + i, IssueCallbacksOnReturn<PxRaycastHit>)(hits[i]);
+		hits[i].hasBlock = false;
+		hits[i].nbTouches = 0;
+		PX_PLACEMENT_NEW(pcbs + i, MultiQueryCallback<PxRaycastHit>)(*this, input, anyHit, hits[i], hitFlags[i], fd, NULL, input.maxDistance, bfd);
+		pcbs[i].mSnapshots = snapshotSet;
+
+		origins[i] = input.getOrigin();
+		unitDirs[i] = input.getDir();
+		distances[i] = &pcbs[i].mShrunkDistance;
+		callbacks[i] = pcbs + i;
+		if(fd.flags & PxQueryFlag::eSTATIC)
+			staticMask |= 1<<i;
+		if(fd.flags & PxQueryFlag::eDYNAMIC)
+			dynamicMask |= 1<<i;
+	}
+
+	const Pruner* staticPruner = snapshotSet ? snapshotSet->getPruner(PruningIndex::eSTATIC) : mSQManager.get(PruningIndex::eSTATIC).pruner();
+	const Pruner* dynamicPruner = snapshotSet ? snapshotSet->getPruner(PruningIndex::eDYNAMIC) : mSQManager.get(PruningIndex::eDYNAMIC).pruner();
+
+	// as in multiQuery, a ray aborted by the statics skips the dynamics and still issues its callbacks
+	const PxU32 allRays = (1u<<nbRays) - 1;
+	const PxU32 staticAgain = staticMask ? staticPruner->raycastPacket(origins, unitDirs, distances, callbacks, staticMask) : 0;
+	dynamicMask &= staticAgain | (allRays & ~staticMask);
+	const PxU32 dynamicAgain = dynamicMask ? dynamicPruner->raycastPacket(origins, unitDirs, distances, callbacks, dynamicMask) : 0;
+
+	for(PxU32 i=nbRays;i--;)
+	{
+		if(dynamicMask & (1<<i))
+			cbrs[i].again = (dynamicAgain & (1<<i)) != 0; // update the status to avoid duplicate processTouches()
+
+		pcbs[i].~MultiQueryCallback<PxRaycastHit>();
+		cbrs[i].~IssueCallbacksOnReturn<PxRaycastHit>();
+#if PX_SUPPORT_PVD
+		pvdCaptures[i].~CapturePvdOnReturn<PxRaycastHit>();
+#endif
+	}
+}
+
+//========================================================================================================================
+static PX_FORCE_INLINE PxU32 findOverlapTriangles(const PxGeometry& geom, const PxTransform& geomPose, const PxTriangleMeshGeometry& meshGeom, const PxTransform& meshPose,
+	PxU32* results, PxU32 maxResults, PxU32 startIndex, bool& overflow)
+{
+	return PxMeshQuery::findOverlapTriangleMesh(geom, geomPose, meshGeom, meshPose, results, maxResults, startIndex, overflow);
+}
+
+static PX_FORCE_INLINE PxU32 findOverlapTriangles(const PxGeometry& geom, const PxTransform& geomPose, const PxHeightFieldGeometry& hfGeom, const PxTransform& hfPose,
+	PxU32* results, PxU32 maxResults, PxU32 startIndex, bool& overflow)
+{
+	return PxMeshQuery::findOverlapHeightField(geom, geomPose, hfGeom, hfPose, results, maxResults, startIndex, overflow);
+}
+
+// Distance from a point to the triangles of a mesh or height field within maxDist, false if there are none
+template<typename MeshGeometry>
+static bool computeNearestTriangle(const PxVec3& point, const MeshGeometry& meshGeom, const PxTransform& pose, PxReal maxDist, PxReal& distance, PxVec3& closestPoint)
+{
+	// the farthest corner of the bounds is enough to reach every triangle, for the unbounded queries
+	const PxBounds3 bounds = PxGeometryQuery::getWorldBounds(meshGeom, pose, 1.0f);
+	const PxVec3 farthest = (point - bounds.minimum).abs().maximum((point - bounds.maximum).abs());
+	const PxSphereGeometry sphere(PxMax(PxMin(maxDist, farthest.magnitude()), 1e-4f));
+	const PxTransform spherePose(point);
+
+	PxReal bestDist2 = PX_MAX_REAL;
+	PxU32 triangles[64];
+	PxU32 startIndex = 0;
+	bool overflow;
+	do
+	{
+		const PxU32 nbTriangles = findOverlapTriangles(sphere, spherePose, meshGeom, pose, triangles, 64, startIndex, overflow);
+		for(PxU32 i=0;i<nbTriangles;i++)
+		{
+			PxTriangle triangle;
+			PxMeshQuery::getTriangle(meshGeom, pose, triangles[i], triangle);
+
+			float s, t;
+			const PxVec3 closest = Gu::closestPtPointTriangle(point, triangle.verts[0], triangle.verts[1], triangle.verts[2], s, t);
+			const PxReal dist2 = (closest - point).magnitudeSquared();
+			if(dist2 < bestDist2)
+			{
+				bestDist2 = dist2;
+				closestPoint = closest;
+			}
+		}
+		startIndex += nbTriangles;
+	} while(overflow);
+
+	if(bestDist2 == PX_MAX_REAL)
+		return false;
+
+	distance = PxSqrt(bestDist2);
+	return true;
+}
+
+// Exact distance from a point to a shape, false if the shape is further than maxDist
+static bool computeNearestDistance(const PxVec3& point, const PxGeometry& geom, const PxTransform& pose, PxReal maxDist, PxReal& distance, PxVec3& closestPoint)
+{
+	switch(geom.getType())
+	{
+	case PxGeometryType::eSPHERE:
+	case PxGeometryType::eCAPSULE:
+	case PxGeometryType::eBOX:
+	case PxGeometryType::eCONVEXMESH:
+		{
+			const PxReal dist2 = PxGeometryQuery::pointDistance(point, geom, pose, &closestPoint);
+			if(dist2 > 0.0f)
+				distance = PxSqrt(dist2);
+			else
+			{
+				distance = 0.0f;
+				closestPoint = point;
+			}
+			return distance <= maxDist;
+		}
+	case PxGeometryType::ePLANE:
+		{
+			// the plane is x = 0 in shape space, the half space x < 0 is solid
+			const PxVec3 normal = pose.q.getBasisVector0();
+			distance = PxMax(normal.dot(point - pose.p), 0.0f);
+			closestPoint = point - normal * distance;
+			return distance <= maxDist;
+		}
+	case PxGeometryType::eTRIANGLEMESH:
+			return computeNearestTriangle(point, static_cast<const PxTriangleMeshGeometry&>(geom), pose, maxDist, distance, closestPoint) && distance <= maxDist;
+	case PxGeometryType::eHEIGHTFIELD:
+			return computeNearestTriangle(point, static_cast<const PxHeightFieldGeometry&>(geom), pose, maxDist, distance, closestPoint) && distance <= maxDist;
+	case PxGeometryType::eGEOMETRY_COUNT:
+	case PxGeometryType::eINVALID:
+		break;
+	}
+	return false;
+}
+
+// Keeps the k closest shapes sorted in the user buffer, and shrinks the pruner search radius to the k-th distance once the buffer is full
+struct NearestQueryCallback : public PrunerCallback
+{
+	const NpSceneQueries&		mScene;
+	const PxVec3				mPoint;
+	const PxReal				mMaxDist;
+	const PxU32					mMaxNbHits;
+	PxNearestHit*				mHits;
+	PxU32						mNbHits;
+	const PxQueryFilterData&	mFilterData;
+	PxQueryFilterCallback*		mFilterCall;
+	const PrunerSnapshotSet*	mSnapshots;
+
+	NearestQueryCallback(const NpSceneQueries& scene, const PxVec3& point, PxReal maxDist, PxU32 k, PxNearestHit* hits,
+		const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall, const PrunerSnapshotSet* snapshots) :
+		mScene(scene), mPoint(point), mMaxDist(maxDist), mMaxNbHits(k), mHits(hits), mNbHits(0),
+		mFilterData(filterData), mFilterCall(filterCall), mSnapshots(snapshots)
+	{
+		mFilterMask = !(filterData.data.word1 | filterData.data.word2 | filterData.data.word3) ? filterData.data.word0 : 0;
+	}
+
+	PX_FORCE_INLINE PxReal getRadius() const { return mNbHits == mMaxNbHits ? mHits[mNbHits-1].distance : mMaxDist; }
+
+	virtual PxAgain invoke(PxReal& aDist, const PrunerPayload& aPayload)
+	{
+		const PxReal radius = getRadius();
+		aDist = radius;
+
+		local::ActorShape actorShape;
+		local::populate(aPayload, actorShape);
+
+		PxQueryHitType::Enum hitType = PxQueryHitType::eBLOCK;
+		PxHitFlags hitFlags;
+		if(!applyAllPreFiltersSQ(&actorShape, hitType, mFilterData.flags, mFilterData, mFilterCall, mScene, NULL, hitFlags, mMaxNbHits))
+			return true;
+		if(hitType == PxQueryHitType::eNONE)
+			return true;
+
+		PX_ALIGN(16, PxTransform) globalPose;
+		if(!mSnapshots || !mSnapshots->getPose(aPayload, globalPose))
+			NpActor::getGlobalPose(globalPose, *actorShape.scbShape, *actorShape.scbActor);
+
+		PxReal distance;
+		PxVec3 closestPoint;
+		if(!computeNearestDistance(mPoint, actorShape.scbShape->getGeometry(), globalPose, radius, distance, closestPoint))
+			return true;
+		// on ties the shape found first is kept
+		if(mNbHits == mMaxNbHits && distance >= radius)
+			return true;
+
+		// insertion sort, k is expected to be small
+		PxU32 index = mNbHits < mMaxNbHits ? mNbHits++ : mMaxNbHits - 1;
+		while(index && mHits[index-1].distance > distance)
+		{
+			mHits[index] = mHits[index-1];
+			index--;
+		}
+		PxNearestHit& hit = mHits[index];
+		hit.actor = actorShape.actor;
+		hit.shape = actorShape.shape;
+		hit.position = closestPoint;
+		hit.distance = distance;
+
+		aDist = getRadius();
+		return true;
+	}
+
+private:
+	NearestQueryCallback& operator=(const NearestQueryCallback&);
+};
+
+PxU32 NpSceneQueries::nearest(
+	const PxVec3& point, PxReal maxDist, PxU32 k, PxNearestHit* hits,
+	const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall) const
+{
+	PX_PROFILE_ZONE("SceneQuery.nearest", getContextId());
+	NP_READ_CHECK(this);
+	PX_SIMD_GUARD;
+
+	PX_CHECK_AND_RETURN_VAL(point.isFinite(), "PxScene::nearest(): point is not valid.", 0);
+	PX_CHECK_AND_RETURN_VAL(maxDist >= 0.0f, "PxScene::nearest(): maxDist cannot be negative.", 0);
+	PX_CHECK_AND_RETURN_VAL(k && hits, "PxScene::nearest(): a hit buffer of at least one entry is required.", 0);
+
+	// see multiQuery
+	const SnapshotReadScope snapshotScope(mSQManager, NULL);
+	const PrunerSnapshotSet* snapshotSet = snapshotScope.mSnapshots;
+	if(!snapshotSet)
+		const_cast<NpSceneQueries*>(this)->mSQManager.flushUpdates();
+
+	NearestQueryCallback pcb(*this, point, maxDist, k, hits, filterData, filterCall, snapshotSet);
+
+	// the statics and the dynamics share the search radius
+	PxReal radius = maxDist;
+	if(filterData.flags & PxQueryFlag::eSTATIC)
+	{
+		const Pruner* staticPruner = snapshotSet ? snapshotSet->getPruner(PruningIndex::eSTATIC) : mSQManager.get(PruningIndex::eSTATIC).pruner();
+		staticPruner->nearest(point, radius, pcb);
+	}
+	if(filterData.flags & PxQueryFlag::eDYNAMIC)
+	{
+		const Pruner* dynamicPruner = snapshotSet ? snapshotSet->getPruner(PruningIndex::eDYNAMIC) : mSQManager.get(PruningIndex::eDYNAMIC).pruner();
+		dynamicPruner->nearest(point, radius, pcb);
+	}
+
+	return pcb.mNbHits;
+}
+
 void NpSceneQueries::sceneQueriesStaticPrunerUpdate(PxBaseTask* )
 {
 	PX_PROFILE_ZONE("SceneQuery.sceneQueriesStaticPrunerUpdate", getContextId());
@@ -834,7 +1330,10 @@ void NpSceneQueries::sceneQueriesDynamicPrunerUpdate(PxBaseTask*)
 }
 
 //explicit template instantiation
-template bool NpSceneQueries::multiQuery<PxRaycastHit>(const MultiQueryInput&, PxHitCallback<PxRaycastHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*) const; 
-template bool NpSceneQueries::multiQuery<PxOverlapHit>(const MultiQueryInput&, PxHitCallback<PxOverlapHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*) const;
-template bool NpSceneQueries::multiQuery<PxSweepHit>(const MultiQueryInput&, PxHitCallback<PxSweepHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*) const;
+template bool NpSceneQueries::multiQuery<PxRaycastHit>(const MultiQueryInput&, PxHitCallback<PxRaycastHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*, const Sq::PrunerSnapshotSet*) const; 
+template bool NpSceneQueries::multiQuery<PxOverlapHit>(const MultiQueryInput&, PxHitCallback<PxOverlapHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*, const Sq::PrunerSnapshotSet*) const;
+template bool NpSceneQueries::multiQuery<PxSweepHit>(const MultiQueryInput&, PxHitCallback<PxSweepHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*, const Sq::PrunerSnapshotSet*) const;
+template bool NpSceneQueries::cachedMultiQuery<PxRaycastHit>(const MultiQueryInput&, PxHitCallback<PxRaycastHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*) const;
+template bool NpSceneQueries::cachedMultiQuery<PxOverlapHit>(const MultiQueryInput&, PxHitCallback<PxOverlapHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*) const;
+template bool NpSceneQueries::cachedMultiQuery<PxSweepHit>(const MultiQueryInput&, PxHitCallback<PxSweepHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*) const;
 
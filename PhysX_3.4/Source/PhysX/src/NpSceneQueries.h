@@ -40,6 +40,7 @@
 #include "GuSweepTests.h"
 #include "GuOverlapTests.h"
 #include "ScbScene.h"
+#include "NpQueryResultCache.h"
 
 #if PX_SUPPORT_PVD
 #include "NpPvdSceneQueryCollector.h"
@@ -150,7 +151,22 @@ public:
 														const MultiQueryInput& in,
 														PxHitCallback<QueryHit>& hits, PxHitFlags hitFlags, const PxQueryCache* cache,
 														const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall,
-														BatchQueryFilterData* bqFd) const;
+														BatchQueryFilterData* bqFd, const Sq::PrunerSnapshotSet* snapshots = NULL) const;
+
+	// multiQuery through the query result cache, for the scenes with PxSceneFlag::eENABLE_QUERY_CACHE.
+	// Queries the cache can't key, or whose results depend on a filter callback or a query cache, skip it.
+	template<typename QueryHit>
+					bool							cachedMultiQuery(
+														const MultiQueryInput& in,
+														PxHitCallback<QueryHit>& hits, PxHitFlags hitFlags, const PxQueryCache* cache,
+														const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall) const;
+
+	// Raycasts a packet of up to Sq::SQ_RAY_PACKET_SIZE rays through the pruners together, with the same results as multiQuery
+	// for each ray. The rays must not use a cache nor a touch buffer.
+					void							multiRaycastPacket(
+														PxU32 nbRays, const MultiQueryInput* const* in,
+														PxRaycastBuffer* hits, const PxHitFlags* hitFlags,
+														const PxQueryFilterData* const* filterData, BatchQueryFilterData* bqFd) const;
 
 	// Synchronous scene queries
 	virtual			bool							raycast(
@@ -171,6 +187,10 @@ public:
 														PxOverlapCallback& hitCall, 
 														const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall) const;
 
+	virtual			PxU32							nearest(
+														const PxVec3& point, PxReal maxDist, PxU32 k, PxNearestHit* hits,
+														const PxQueryFilterData& filterData, PxQueryFilterCallback* filterCall) const;
+
 	PX_FORCE_INLINE	PxU64							getContextId()				const	{ return PxU64(reinterpret_cast<size_t>(this));	}
 	PX_FORCE_INLINE	Scb::Scene&						getScene()							{ return mScene;								}
 	PX_FORCE_INLINE	const Scb::Scene&				getScene()					const	{ return mScene;								}
@@ -195,6 +215,8 @@ public:
 
 					PxSceneQueryUpdateMode::Enum    mSceneQueryUpdateMode;
 
+					mutable NpQueryResultCache		mQueryResultCache;
+
 #if PX_SUPPORT_PVD
 public:
 					//Scene query and hits for pvd, collected in current frame
@@ -209,13 +231,13 @@ PX_FORCE_INLINE				Vd::PvdSceneQueryCollector&	getBatchedSqCollector() const {re
 #if PX_SUPPORT_EXTERN_TEMPLATE
 //explicit template instantiation declaration
 extern template
-bool NpSceneQueries::multiQuery<PxRaycastHit>(const MultiQueryInput&, PxHitCallback<PxRaycastHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*) const;
+bool NpSceneQueries::multiQuery<PxRaycastHit>(const MultiQueryInput&, PxHitCallback<PxRaycastHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*, const Sq::PrunerSnapshotSet*) const;
 
 extern template
-bool NpSceneQueries::multiQuery<PxOverlapHit>(const MultiQueryInput&, PxHitCallback<PxOverlapHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*) const;
+bool NpSceneQueries::multiQuery<PxOverlapHit>(const MultiQueryInput&, PxHitCallback<PxOverlapHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*, const Sq::PrunerSnapshotSet*) const;
 
 extern template
-bool NpSceneQueries::multiQuery<PxSweepHit>(const MultiQueryInput&, PxHitCallback<PxSweepHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*) const;
+bool NpSceneQueries::multiQuery<PxSweepHit>(const MultiQueryInput&, PxHitCallback<PxSweepHit>&, PxHitFlags, const PxQueryCache*, const PxQueryFilterData&, PxQueryFilterCallback*, BatchQueryFilterData*, const Sq::PrunerSnapshotSet*) const;
 #endif
 
 namespace Sq { class AABBPruner; class AABBTreeRuntimeNode; class AABBTree; }
@@ -380,6 +380,23 @@ void NpShape::setQueryFilterData(const PxFilterData& data)
 
 	mShape.getScShape().setQueryFilterData(data);	// PT: this one doesn't need double-buffering
 
+	// the query result cache doesn't track filter data
+	NpScene* scene = getOwnerScene();
+	if(scene)
+		scene->mQueryResultCache.invalidate();
+
+	// the pruner trees cull with word0, refresh the masks of their nodes
+	if(mActor && (mShape.getFlags() & PxShapeFlag::eSCENE_QUERY_SHAPE))
+	{
+		NpScene* actorScene = NpActor::getAPIScene(*mActor);
+		if(actorScene)
+		{
+			const PrunerData sqData = NpActor::getShapeManager(*mActor)->findSceneQueryData(*this);
+			if(sqData != SQ_INVALID_PRUNER_DATA)
+				actorScene->getSceneQueryManagerFast().setFilterMask(sqData, data.word0);
+		}
+	}
+
 	updatePvdProperties(mShape);
 }
 
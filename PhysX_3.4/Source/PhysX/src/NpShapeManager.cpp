@@ -30,12 +30,15 @@
 #include "NpShapeManager.h"
 #include "NpFactory.h"
 #include "ScbRigidObject.h"
+#include "ScbRigidStatic.h"
+#include "ScbBody.h"
 #include "NpActor.h"
 #include "SqPruningStructure.h"
 #include "NpScene.h"
 #include "NpPtrTableStorageManager.h"
 #include "GuBounds.h"
 #include "CmUtils.h"
+#include "PsInlineArray.h"
 
 using namespace physx;
 using namespace Sq;
@@ -125,6 +128,103 @@ bool NpShapeManager::detachShape(NpShape& s, PxRigidActor& actor, bool wakeOnLos
 	return true;
 }
 
+void NpShapeManager::attachShapes(NpShape*const* shapes, PxU32 nbShapes, PxRigidActor& actor)
+{
+	PX_ASSERT(!mPruningStructure);
+
+	PtrTableStorageManager& sm = NpFactory::getInstance().getPtrTableStorageManager();
+
+	const PxU32 firstIndex = getNbShapes();
+	for(PxU32 i=0;i<nbShapes;i++)
+	{
+		mShapes.add(shapes[i], sm);
+		mSceneQueryData.add(reinterpret_cast<void*>(size_t(SQ_INVALID_PRUNER_DATA)), sm);
+	}
+
+	NpScene* scene = NpActor::getAPIScene(actor);
+	if(scene)
+	{
+		// a single pruner insertion for all the scene query shapes
+		Ps::InlineArray<const NpShape*, 32> sqShapes;
+		Ps::InlineArray<PxU32, 32> sqIndices;
+		for(PxU32 i=0;i<nbShapes;i++)
+		{
+			if(isSceneQuery(*shapes[i]))
+			{
+				sqShapes.pushBack(shapes[i]);
+				sqIndices.pushBack(firstIndex + i);
+			}
+		}
+
+		if(sqShapes.size())
+		{
+			const PxType actorType = actor.getConcreteType();
+			const bool isDynamic = actorType == PxConcreteType::eRIGID_DYNAMIC || actorType == PxConcreteType::eARTICULATION_LINK;
+
+			Ps::InlineArray<PrunerData, 32> sqData;
+			sqData.resize(sqShapes.size());
+			scene->getSceneQueryManagerFast().addPrunerShapes(sqShapes.size(), sqShapes.begin(), actor, isDynamic, sqData.begin());
+			for(PxU32 i=0;i<sqShapes.size();i++)
+				setPrunerData(sqIndices[i], sqData[i]);
+		}
+	}
+
+	Scb::RigidObject& ro = static_cast<Scb::RigidObject&>(NpActor::getScbFromPxActor(actor));
+	for(PxU32 i=0;i<nbShapes;i++)
+	{
+		ro.onShapeAttach(shapes[i]->getScbShape());
+
+		PX_ASSERT(!shapes[i]->isExclusive() || shapes[i]->getActor()==NULL);
+		shapes[i]->onActorAttach(actor);
+	}
+}
+
+PxU32 NpShapeManager::detachShapes(NpShape*const* shapes, PxU32 nbShapes, PxRigidActor& actor, bool wakeOnLostTouch)
+{
+	PX_ASSERT(!mPruningStructure);
+
+	NpScene* scene = NpActor::getAPIScene(actor);
+	if(scene)
+	{
+		// a single pruner removal for all the scene query shapes. The data is reset so that duplicates are only removed once.
+		Ps::InlineArray<PrunerData, 32> sqData;
+		for(PxU32 i=0;i<nbShapes;i++)
+		{
+			const PxU32 index = mShapes.find(shapes[i]);
+			if(index==0xffffffff || !isSceneQuery(*shapes[i]))
+				continue;
+
+			const PrunerData data = getPrunerData(index);
+			if(data!=SQ_INVALID_PRUNER_DATA)
+			{
+				sqData.pushBack(data);
+				setPrunerData(index, SQ_INVALID_PRUNER_DATA);
+			}
+		}
+		scene->getSceneQueryManagerFast().removePrunerShapes(sqData.size(), sqData.begin());
+	}
+
+	Scb::RigidObject& ro = static_cast<Scb::RigidObject&>(NpActor::getScbFromPxActor(actor));
+	PtrTableStorageManager& sm = NpFactory::getInstance().getPtrTableStorageManager();
+
+	PxU32 nbDetached = 0;
+	for(PxU32 i=0;i<nbShapes;i++)
+	{
+		NpShape& s = *shapes[i];
+		const PxU32 index = mShapes.find(&s);
+		if(index==0xffffffff)
+			continue;
+
+		ro.onShapeDetach(s.getScbShape(), wakeOnLostTouch, (s.getRefCount() == 1));
+		mShapes.replaceWithLast(index, sm);
+		mSceneQueryData.replaceWithLast(index, sm);
+
+		s.onActorDetach();
+		nbDetached++;
+	}
+	return nbDetached;
+}
+
 void NpShapeManager::detachAll(NpScene* scene)
 {
 	// assumes all SQ data has been released, which is currently the responsbility of the owning actor
@@ -658,11 +758,14 @@ void NpShapeManager::visualize(RenderOutput& out, NpScene* scene, const PxRigidA
 	const bool visualizeFNormals	= fNormals!=0.0f;
 	const bool visualizeCollision	= visualizeShapes || visualizeFNormals || visualizeEdges;
 	const bool useCullBox			= !cullbox.isEmpty();
-	const bool needsShapeBounds0	= visualizeCompounds || (visualizeCollision && useCullBox);
+	const bool needsShapeBounds0	= visualizeCompounds || useCullBox;
 	const PxReal collisionAxes		= scale * scene->getVisualizationParameter(PxVisualizationParameter::eCOLLISION_AXES);
 	const PxReal fscale				= scale * fNormals;
 
-	const PxTransform actorPose = actor.getGlobalPose();
+	// straight from the Scb actor rather than PxRigidActor::getGlobalPose(), this runs on the worker threads (see NpScene::visualize)
+	const Scb::Actor& scbActor = NpActor::getScbFromPxActor(actor);
+	const PxTransform actorPose = scbActor.getScbType()==ScbType::eRIGID_STATIC ? static_cast<const Scb::RigidStatic&>(scbActor).getActor2World()
+								: static_cast<const Scb::Body&>(scbActor).getBody2World() * static_cast<const Scb::Body&>(scbActor).getBody2Actor().getInverse();
 
 	PxBounds3 compoundBounds(PxBounds3::empty());
 	for(PxU32 i=0;i<nbShapes;i++)
@@ -677,7 +780,8 @@ void NpShapeManager::visualize(RenderOutput& out, NpScene* scene, const PxRigidA
 		const bool needsShapeBounds = needsShapeBounds0 || (visualizeAABBs && shapeDebugVizEnabled);
 		const PxBounds3 currentShapeBounds = needsShapeBounds ? Gu::computeBounds(geom, absPose, !gUnifiedHeightfieldCollision) : PxBounds3::empty();
 
-		if(shapeDebugVizEnabled)
+		// nothing of a shape outside the cull box gets drawn, not only its geometry
+		if(shapeDebugVizEnabled && (!useCullBox || cullbox.intersects(currentShapeBounds)))
 		{
 			if(visualizeAABBs)
 				out << PxU32(PxDebugColor::eARGB_YELLOW) << PxMat44(PxIdentity) << DebugBox(currentShapeBounds);
@@ -686,10 +790,7 @@ void NpShapeManager::visualize(RenderOutput& out, NpScene* scene, const PxRigidA
 				out << PxMat44(absPose) << DebugBasis(PxVec3(collisionAxes), 0xcf0000, 0x00cf00, 0x0000cf);
 
 			if(visualizeCollision)
-			{
-				if(!useCullBox || cullbox.intersects(currentShapeBounds))
-					::visualize(geom, out, absPose, cullbox, fscale, visualizeShapes, visualizeEdges, useCullBox);
-			}
+				::visualize(geom, out, absPose, cullbox, fscale, visualizeShapes, visualizeEdges, useCullBox);
 		}
 
 		if(visualizeCompounds)
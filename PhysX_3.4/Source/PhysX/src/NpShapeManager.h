@@ -74,6 +74,8 @@ public:
 
 					void					attachShape(NpShape& shape, PxRigidActor& actor);
 					bool					detachShape(NpShape& s, PxRigidActor &actor, bool wakeOnLostTouch);
+					void					attachShapes(NpShape*const* shapes, PxU32 nbShapes, PxRigidActor& actor);
+					PxU32					detachShapes(NpShape*const* shapes, PxU32 nbShapes, PxRigidActor& actor, bool wakeOnLostTouch);
 					void					detachAll(NpScene *scene);
 
 					void					teardownSceneQuery(Sq::SceneQueryManager& sqManager, const NpShape& shape);
@@ -33,6 +33,7 @@
 #include "PxBoxGeometry.h"
 #include "PsFoundation.h"
 #include "GuBounds.h"
+#include "task/PxCpuDispatcher.h"
 
 using namespace physx;
 using namespace Sq;
@@ -40,12 +41,17 @@ using namespace Gu;
 
 NpSpatialIndex::NpSpatialIndex()
 : mPendingUpdates(false)
+, mRebuildRunning(false)
+, mRebuildTask(*this)
 {
 	mPruner = createAABBPruner(true);
 }
 
 NpSpatialIndex::~NpSpatialIndex()
 {
+	// the new tree is built inside the pruner
+	if(mRebuildRunning)
+		mRebuildDone.wait();
 	PX_DELETE(mPruner);
 }
 
@@ -53,6 +59,7 @@ PxSpatialIndexItemId NpSpatialIndex::insert(PxSpatialIndexItem& item, const PxBo
 {
 	PX_SIMD_GUARD;
 	PX_CHECK_AND_RETURN_VAL(bounds.isValid(), "PxSpatialIndex::insert: bounds are not valid.", PX_SPATIAL_INDEX_INVALID_ITEM_ID);
+	PX_CHECK_AND_RETURN_VAL(!mRebuildRunning, "PxSpatialIndex::insert: not allowed while a rebuild is running.", PX_SPATIAL_INDEX_INVALID_ITEM_ID);
 
 	PrunerHandle output;
 	PrunerPayload payload;
@@ -66,6 +73,7 @@ void NpSpatialIndex::update(PxSpatialIndexItemId id, const PxBounds3& bounds)
 {
 	PX_SIMD_GUARD;
 	PX_CHECK_AND_RETURN(bounds.isValid(), "PxSpatialIndex::update: bounds are not valid.");
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::update: not allowed while a rebuild is running.");
 
 	PxBounds3* b;
 	mPruner->getPayload(id, b);
@@ -78,11 +86,66 @@ void NpSpatialIndex::update(PxSpatialIndexItemId id, const PxBounds3& bounds)
 void NpSpatialIndex::remove(PxSpatialIndexItemId id)
 {
 	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::remove: not allowed while a rebuild is running.");
 
 	mPruner->removeObjects(&id, 1);
 	mPendingUpdates = true;
 }
 
+void NpSpatialIndex::insertItems(PxSpatialIndexItem*const* items, const PxBounds3* bounds, PxU32 count, PxSpatialIndexItemId* ids)
+{
+	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::insertItems: not allowed while a rebuild is running.");
+#if PX_CHECKED
+	for(PxU32 i=0;i<count;i++)
+		PX_CHECK_AND_RETURN(bounds[i].isValid(), "PxSpatialIndex::insertItems: bounds are not valid.");
+#endif
+	if(!count)
+		return;
+
+	mPayloads.resizeUninitialized(count);
+	for(PxU32 i=0;i<count;i++)
+	{
+		mPayloads[i].data[0] = reinterpret_cast<size_t>(items[i]);
+		mPayloads[i].data[1] = 0;
+	}
+	mPruner->addObjects(ids, bounds, mPayloads.begin(), count, false);
+	mPendingUpdates = true;
+}
+
+void NpSpatialIndex::updateItems(const PxSpatialIndexItemId* ids, const PxBounds3* bounds, PxU32 count)
+{
+	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::updateItems: not allowed while a rebuild is running.");
+#if PX_CHECKED
+	for(PxU32 i=0;i<count;i++)
+		PX_CHECK_AND_RETURN(bounds[i].isValid(), "PxSpatialIndex::updateItems: bounds are not valid.");
+#endif
+	if(!count)
+		return;
+
+	for(PxU32 i=0;i<count;i++)
+	{
+		PxBounds3* b;
+		mPruner->getPayload(ids[i], b);
+		*b = bounds[i];
+	}
+	// a single pass over the tree for the whole batch
+	mPruner->updateObjectsAfterManualBoundsUpdates(ids, count);
+	mPendingUpdates = true;
+}
+
+void NpSpatialIndex::removeItems(const PxSpatialIndexItemId* ids, PxU32 count)
+{
+	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::removeItems: not allowed while a rebuild is running.");
+	if(!count)
+		return;
+
+	mPruner->removeObjects(ids, count);
+	mPendingUpdates = true;
+}
+
 namespace
 {
 	struct OverlapCallback: public PrunerCallback
@@ -180,6 +243,7 @@ void NpSpatialIndex::sweep(const PxBounds3& aabb, const PxVec3& unitDir, PxReal
 void NpSpatialIndex::rebuildFull()
 {
 	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::rebuildFull: not allowed while a rebuild is running.");
 
 	mPruner->purge();
 	mPruner->commit();
@@ -194,10 +258,54 @@ void NpSpatialIndex::setIncrementalRebuildRate(PxU32 rate)
 void NpSpatialIndex::rebuildStep()
 {
 	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN(!mRebuildRunning, "PxSpatialIndex::rebuildStep: not allowed while a rebuild is running.");
 	mPruner->buildStep();
 	mPendingUpdates = true;
 }
 
+void NpSpatialIndex::RebuildTask::runInternal()
+{
+	// the rebuild rate only splits the work between the steps, they all run here
+	while(!mIndex.mPruner->buildStep(false))
+		;
+}
+
+bool NpSpatialIndex::startRebuild(PxCpuDispatcher& dispatcher)
+{
+	PX_SIMD_GUARD;
+	PX_CHECK_AND_RETURN_VAL(!mRebuildRunning, "PxSpatialIndex::startRebuild: a rebuild is already running.", false);
+
+	// the queries made during the rebuild must not commit
+	flushUpdates();
+
+	// copies the bounds, the build then only touches the new tree
+	if(!mPruner->prepareBuild())
+		return false;
+
+	// no continuation and no task manager, the task goes straight to the dispatcher
+	mRebuildRunning = true;
+	dispatcher.submitTask(mRebuildTask);
+	return true;
+}
+
+bool NpSpatialIndex::fetchRebuild(bool block)
+{
+	if(!mRebuildRunning)
+		return true;
+
+	if(!mRebuildDone.wait(block ? Ps::Sync::waitForever : 0))
+		return false;
+
+	PX_SIMD_GUARD;
+	mRebuildDone.reset();
+	mRebuildRunning = false;
+
+	// swaps in the new tree
+	mPendingUpdates = true;
+	flushUpdates();
+	return true;
+}
+
 void NpSpatialIndex::release()
 {
 	delete this;
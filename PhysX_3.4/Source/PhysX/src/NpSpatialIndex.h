@@ -34,12 +34,16 @@
 #include "PxSpatialIndex.h"
 #include "PsUserAllocated.h"
 #include "CmPhysXCommon.h"
+#include "CmTask.h"
+#include "PsArray.h"
+#include "PsSync.h"
 
 namespace physx
 {
 namespace Sq
 {
 	class IncrementalPruner;
+	struct PrunerPayload;
 }
 
 class NpSpatialIndex: public PxSpatialIndex, public Ps::UserAllocated
@@ -74,13 +78,38 @@ public:
 	virtual void					setIncrementalRebuildRate(PxU32 rate);
 	virtual void					rebuildStep();
 	virtual void					release();
+
+	virtual	void					insertItems(PxSpatialIndexItem*const* items, const PxBounds3* bounds, PxU32 count, PxSpatialIndexItemId* ids);
+	virtual	void					updateItems(const PxSpatialIndexItemId* ids, const PxBounds3* bounds, PxU32 count);
+	virtual	void					removeItems(const PxSpatialIndexItemId* ids, PxU32 count);
+	virtual	bool					startRebuild(PxCpuDispatcher& dispatcher);
+	virtual	bool					fetchRebuild(bool block);
 private:
 	
 	// const so that we can call it from const methods
 	void							flushUpdates() const;
 
+	// Runs the build steps of a rebuild until the new tree is complete. Submitted straight to the dispatcher, without a task manager
+	struct RebuildTask : public Cm::Task
+	{
+		RebuildTask(NpSpatialIndex& index) : Cm::Task(0), mIndex(index)	{}
+
+		virtual void runInternal();
+		// the index may be released as soon as the sync is set, so nothing is touched after that
+		virtual void release()	{ mIndex.mRebuildDone.set(); }
+		virtual const char* getName() const { return "NpSpatialIndex.rebuild"; }
+
+		NpSpatialIndex& mIndex;
+	private:
+		RebuildTask& operator=(const RebuildTask&);
+	};
+
 	mutable bool			mPendingUpdates;
+	bool					mRebuildRunning;
 	Sq::IncrementalPruner*	mPruner;
+	RebuildTask				mRebuildTask;
+	Ps::Sync				mRebuildDone;
+	Ps::Array<Sq::PrunerPayload>	mPayloads;	// scratch for insertItems
 };
 
 
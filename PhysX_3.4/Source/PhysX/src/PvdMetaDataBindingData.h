@@ -43,6 +43,24 @@ using namespace physx::shdfnd;
 typedef HashSet<const PxRigidActor*> OwnerActorsValueType;
 typedef HashMap<const PxShape*, OwnerActorsValueType*> OwnerActorsMap;
 
+// Quantized pose and velocities of an actor, as last sent by the delta updates
+struct PvdActorUpdateState
+{
+	enum { eNB_VALUES = 13 };
+	PxI32 mValues[eNB_VALUES];
+
+	bool operator==(const PvdActorUpdateState& other) const
+	{
+		for(PxU32 i = 0; i < eNB_VALUES; i++)
+		{
+			if(mValues[i] != other.mValues[i])
+				return false;
+		}
+		return true;
+	}
+};
+typedef HashMap<const PxActor*, PvdActorUpdateState> ActorUpdateStateMap;
+
 struct PvdMetaDataBindingData : public UserAllocated
 {
 	Array<PxU8> mTempU8Array;
@@ -51,6 +69,8 @@ struct PvdMetaDataBindingData : public UserAllocated
 	Array<PxArticulationLink*> mArticulationLinks;
 	HashSet<PxActor*> mSleepingActors;
 	OwnerActorsMap mOwnerActorsMap;
+	ActorUpdateStateMap mActorUpdateStates;
+	PxU32 mActorUpdateCursor;
 
 	PvdMetaDataBindingData()
 	: mTempU8Array(PX_DEBUG_EXP("TempU8Array"))
@@ -58,6 +78,8 @@ struct PvdMetaDataBindingData : public UserAllocated
 	, mArticulations(PX_DEBUG_EXP("Articulations"))
 	, mArticulationLinks(PX_DEBUG_EXP("ArticulationLinks"))
 	, mSleepingActors(PX_DEBUG_EXP("SleepingActors"))
+	, mActorUpdateStates(PX_DEBUG_EXP("ActorUpdateStates"))
+	, mActorUpdateCursor(0)
 	{
 	}
 
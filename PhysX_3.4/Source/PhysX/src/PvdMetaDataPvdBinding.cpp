@@ -53,6 +53,8 @@ PX_DUMMY_SYMBOL
 #include "gpu/PxParticleGpu.h"
 #include "PvdTypeNames.h"
 #include "PvdMetaDataPvdBinding.h"
+#include "PxPvdSceneClient.h"
+#include "foundation/PxMath.h"
 
 using namespace physx;
 using namespace Sc;
@@ -1228,6 +1230,8 @@ void PvdMetaDataBinding::destroyInstance(PvdDataStream& inStream, const PxRigidD
 {
 	releaseShapes(*this, inStream, inObj);
 	removeSceneGroupProperty(inStream, "RigidDynamics", inObj, ownerScene);
+	mBindingData->mActorUpdateStates.erase(&inObj);
+	mBindingData->mSleepingActors.erase(const_cast<PxRigidDynamic*>(&inObj));
 }
 
 static void addChild(PvdDataStream& inStream, const void* inParent, const PxArticulationLink& inChild)
@@ -1310,6 +1314,7 @@ void PvdMetaDataBinding::destroyInstance(PvdDataStream& inStream, const PxArticu
 		inStream.destroyInstance(joint);
 	releaseShapes(*this, inStream, inObj);
 	inStream.destroyInstance(&inObj);
+	mBindingData->mActorUpdateStates.erase(&inObj);
 }
 // These are created as part of the articulation link's creation process, so outside entities don't need to
 // create them.
@@ -1460,14 +1465,91 @@ void PvdMetaDataBinding::destroyInstance(PvdDataStream& inStream, const PxPartic
 }
 #endif // PX_USE_PARTICLE_SYSTEM_API
 
+static PX_FORCE_INLINE PxI32 quantizeForUpdate(PxReal value, PxReal invQuantum)
+{
+	// keeps far away or fast actors from overflowing, they are then only sent when they get back in range
+	const PxReal scaled = PxClamp(value * invQuantum, -2.0e9f, 2.0e9f);
+	return PxI32(PxFloor(scaled + 0.5f));
+}
+
+// Decides which actors the per frame update sends, and how many
+class ActorUpdateFilter
+{
+	PvdMetaDataBindingData& mBindingData;
+	const bool mDeltaUpdates;
+	const PxReal mInvPositionQuantum;
+	const PxReal mInvRotationQuantum;
+	const PxReal mInvVelocityQuantum;
+	PxU32 mBudget;
+	PX_NOCOPY(ActorUpdateFilter)
+
+  public:
+	ActorUpdateFilter(PvdMetaDataBindingData& bindingData, const PxPvdSceneUpdateSettings& settings, PxU32 budget)
+	: mBindingData(bindingData)
+	, mDeltaUpdates(settings.deltaUpdates)
+	, mInvPositionQuantum(1.0f / settings.positionQuantum)
+	, mInvRotationQuantum(1.0f / settings.rotationQuantum)
+	, mInvVelocityQuantum(1.0f / settings.velocityQuantum)
+	, mBudget(budget)
+	{
+	}
+
+	bool hasBudget() const
+	{
+		return mBudget != 0;
+	}
+
+	// Returns true if the block needs to be sent, and then counts it against the budget
+	bool shouldSend(const PxActor* actor, const PxArticulationLinkUpdateBlock& block, bool forceSend)
+	{
+		if(mDeltaUpdates)
+		{
+			PvdActorUpdateState state;
+			state.mValues[0] = quantizeForUpdate(block.GlobalPose.p.x, mInvPositionQuantum);
+			state.mValues[1] = quantizeForUpdate(block.GlobalPose.p.y, mInvPositionQuantum);
+			state.mValues[2] = quantizeForUpdate(block.GlobalPose.p.z, mInvPositionQuantum);
+			// q and -q are the same rotation, so make w positive to avoid sending a sign flip
+			const PxQuat q = block.GlobalPose.q.w < 0.0f ? -block.GlobalPose.q : block.GlobalPose.q;
+			state.mValues[3] = quantizeForUpdate(q.x, mInvRotationQuantum);
+			state.mValues[4] = quantizeForUpdate(q.y, mInvRotationQuantum);
+			state.mValues[5] = quantizeForUpdate(q.z, mInvRotationQuantum);
+			state.mValues[6] = quantizeForUpdate(q.w, mInvRotationQuantum);
+			state.mValues[7] = quantizeForUpdate(block.LinearVelocity.x, mInvVelocityQuantum);
+			state.mValues[8] = quantizeForUpdate(block.LinearVelocity.y, mInvVelocityQuantum);
+			state.mValues[9] = quantizeForUpdate(block.LinearVelocity.z, mInvVelocityQuantum);
+			state.mValues[10] = quantizeForUpdate(block.AngularVelocity.x, mInvVelocityQuantum);
+			state.mValues[11] = quantizeForUpdate(block.AngularVelocity.y, mInvVelocityQuantum);
+			state.mValues[12] = quantizeForUpdate(block.AngularVelocity.z, mInvVelocityQuantum);
+
+			const ActorUpdateStateMap::Entry* entry = mBindingData.mActorUpdateStates.find(actor);
+			if(!forceSend && entry && entry->second == state)
+				return false;
+			if(!mBudget)
+				return false;
+			mBindingData.mActorUpdateStates[actor] = state;
+		}
+		else if(!mBudget)
+			return false;
+
+		mBudget--;
+		return true;
+	}
+};
+
+// Visits the actors from startIndex, wrapping around, until the filter runs out of budget.
+// Returns the number of actors visited.
 template <typename TBlockType, typename TActorType, typename TOperator>
-static void updateActor(PvdDataStream& inStream, TActorType** actorGroup, PxU32 numActors, TOperator sleepingOp, PvdMetaDataBindingData& bindingData)
+static PxU32 updateActor(PvdDataStream& inStream, TActorType** actorGroup, PxU32 numActors, PxU32 startIndex, TOperator sleepingOp, PvdMetaDataBindingData& bindingData, ActorUpdateFilter& filter)
 {
 	TBlockType theBlock;
 	if(numActors == 0)
-		return;
-	for(PxU32 idx = 0; idx < numActors; ++idx)
+		return 0;
+	PxU32 nbVisited = 0;
+	for(; nbVisited < numActors && filter.hasBudget(); ++nbVisited)
 	{
+		PxU32 idx = startIndex + nbVisited;
+		if(idx >= numActors)
+			idx -= numActors;
 		TActorType* theActor(actorGroup[idx]);
 		bool sleeping = sleepingOp(theActor, theBlock);
 		bool wasSleeping = bindingData.mSleepingActors.contains(theActor);
@@ -1477,6 +1559,8 @@ static void updateActor(PvdDataStream& inStream, TActorType** actorGroup, PxU32
 			theBlock.GlobalPose = theActor->getGlobalPose();
 			theBlock.AngularVelocity = theActor->getAngularVelocity();
 			theBlock.LinearVelocity = theActor->getLinearVelocity();
+			if(!filter.shouldSend(theActor, theBlock, sleeping != wasSleeping))
+				continue;
 			inStream.sendPropertyMessageFromGroup(theActor, theBlock);
 			if(sleeping != wasSleeping)
 			{
@@ -1487,6 +1571,7 @@ static void updateActor(PvdDataStream& inStream, TActorType** actorGroup, PxU32
 			}
 		}
 	}
+	return nbVisited;
 }
 
 struct RigidDynamicUpdateOp
@@ -1511,7 +1596,7 @@ struct ArticulationLinkUpdateOp
 	}
 };
 
-void PvdMetaDataBinding::updateDynamicActorsAndArticulations(PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz)
+void PvdMetaDataBinding::updateDynamicActorsAndArticulations(PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz, const PxPvdSceneUpdateSettings& settings)
 {
 	PX_COMPILE_TIME_ASSERT(sizeof(PxRigidDynamicUpdateBlock) == 14 * 4);
 	{
@@ -1522,7 +1607,13 @@ void PvdMetaDataBinding::updateDynamicActorsAndArticulations(PvdDataStream& inSt
 			mBindingData->mActors.resize(actorCount);
 			PxActor** theActors = mBindingData->mActors.begin();
 			inScene->getActors(PxActorTypeFlag::eRIGID_DYNAMIC, theActors, actorCount);
-			updateActor<PxRigidDynamicUpdateBlock>(inStream, reinterpret_cast<PxRigidDynamic**>(theActors), actorCount, RigidDynamicUpdateOp(), *mBindingData);
+
+			// with a budget, resume where the previous frame stopped so every actor gets its turn
+			const PxU32 budget = settings.maxActorUpdatesPerFrame ? settings.maxActorUpdatesPerFrame : 0xffffffff;
+			const PxU32 startIndex = settings.maxActorUpdatesPerFrame ? mBindingData->mActorUpdateCursor % actorCount : 0;
+			ActorUpdateFilter filter(*mBindingData, settings, budget);
+			const PxU32 nbVisited = updateActor<PxRigidDynamicUpdateBlock>(inStream, reinterpret_cast<PxRigidDynamic**>(theActors), actorCount, startIndex, RigidDynamicUpdateOp(), *mBindingData, filter);
+			mBindingData->mActorUpdateCursor = (startIndex + nbVisited) % actorCount;
 			inStream.endPropertyMessageGroup();
 		}
 	}
@@ -1530,6 +1621,8 @@ void PvdMetaDataBinding::updateDynamicActorsAndArticulations(PvdDataStream& inSt
 		PxU32 articulationCount = inScene->getNbArticulations();
 		if(articulationCount)
 		{
+			// the budget doesn't apply to the links, an articulation is always sent whole
+			ActorUpdateFilter filter(*mBindingData, settings, 0xffffffff);
 			mBindingData->mArticulations.resize(articulationCount);
 			PxArticulation** firstArticulation = mBindingData->mArticulations.begin();
 			PxArticulation** lastArticulation = firstArticulation + articulationCount;
@@ -1544,7 +1637,7 @@ void PvdMetaDataBinding::updateDynamicActorsAndArticulations(PvdDataStream& inSt
 					mBindingData->mArticulationLinks.resize(linkCount);
 					PxArticulationLink** theLink = mBindingData->mArticulationLinks.begin();
 					(*firstArticulation)->getLinks(theLink, linkCount);
-					updateActor<PxArticulationLinkUpdateBlock>(inStream, theLink, linkCount, ArticulationLinkUpdateOp(sleeping), *mBindingData);
+					updateActor<PxArticulationLinkUpdateBlock>(inStream, theLink, linkCount, 0, ArticulationLinkUpdateOp(sleeping), *mBindingData, filter);
 					if(linkJointViz)
 					{
 						for(PxU32 idx = 0; idx < linkCount; ++idx)
@@ -1560,6 +1653,12 @@ void PvdMetaDataBinding::updateDynamicActorsAndArticulations(PvdDataStream& inSt
 	}
 }
 
+void PvdMetaDataBinding::resetActorUpdates()
+{
+	mBindingData->mActorUpdateStates.clear();
+	mBindingData->mActorUpdateCursor = 0;
+}
+
 template <typename TObjType>
 struct CollectionOperator
 {
@@ -48,6 +48,8 @@ namespace physx
 namespace physx
 {
 
+struct PxPvdSceneUpdateSettings;
+
 namespace Sc
 {
 struct Contact;
@@ -131,7 +133,9 @@ class PvdMetaDataBinding
 	void sendAllProperties(PvdDataStream& inStream, const PxArticulationJoint& inObj);
 
 	// per frame update
-	void updateDynamicActorsAndArticulations(PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz);
+	void updateDynamicActorsAndArticulations(PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz, const PxPvdSceneUpdateSettings& settings);
+	// forgets the states sent by the delta updates, so the next update sends every actor
+	void resetActorUpdates();
 
 	// Origin Shift
 	void originShift(PvdDataStream& inStream, const PxScene* inScene, PxVec3 shift);
@@ -103,7 +103,8 @@ struct BodyBuffer : public RigidObjectBuffer		//once RigidObject has its own buf
 		BF_ClearAcceleration		= BF_ClearAccelerationLinear|BF_ClearAccelerationAngular,
 		BF_ClearDeltaVelocityLinear	= 1<<29,
 		BF_ClearDeltaVelocityAngular= 1<<30,
-		BF_ClearDeltaVelocity		= BF_ClearDeltaVelocityLinear|BF_ClearDeltaVelocityAngular
+		BF_ClearDeltaVelocity		= BF_ClearDeltaVelocityLinear|BF_ClearDeltaVelocityAngular,
+		BF_BatchPending				= PxU32(1)<<31  // the body is on the batched update list of the scene, see Scb::Scene::processBatchedBodyUpdates()
 	};
 
 	BodyBuffer(): mLinAcceleration(0), mAngAcceleration(0), mLinDeltaVelocity(0), mAngDeltaVelocity(0) {}
@@ -200,6 +201,16 @@ public:
 	PX_INLINE		bool				getKinematicTarget(PxTransform& p) const;
 	PX_INLINE		void				setKinematicTarget(const PxTransform& p);
 
+	//---------------------------------------------------------------------------------
+	// Batched writes (PxScene::setGlobalPoses() and co). Same as the methods above, except that
+	// while buffering, the body goes to the flat batched update list of the scene instead of the
+	// tracker of buffered objects.
+	//---------------------------------------------------------------------------------
+	PX_INLINE		void				setBody2WorldBatched(const PxTransform& p);
+	PX_INLINE		void				setLinearVelocityBatched(const PxVec3& v);
+	PX_INLINE		void				setKinematicTargetBatched(const PxTransform& p);
+	PX_INLINE		void				wakeUpBatched(PxReal wakeCounter);
+
 	PX_INLINE		void				setMinCCDAdvanceCoefficient(PxReal minCCDAdvanceCoefficient){write<Buf::BF_CCDAdvanceCoefficient>(minCCDAdvanceCoefficient);}
 	PX_INLINE		PxReal				getMinCCDAdvanceCoefficient() const { return read<Buf::BF_CCDAdvanceCoefficient>();}
 
@@ -223,6 +234,15 @@ public:
 	*/
 	PX_FORCE_INLINE	Ps::IntBool			isBuffered(PxU32 flag) const;
 
+	/**
+	\brief Variant of #markUpdated() for the batched writes.
+
+	Bodies which are neither tracked already nor have a pending insert/remove are appended to the batched update list of the scene.
+	*/
+	PX_FORCE_INLINE	void				markUpdatedBatched(PxU32 flag);
+	PX_FORCE_INLINE	bool				isBatchPending() const	{ return (mBodyBufferFlags & Buf::BF_BatchPending) != 0; }
+	PX_FORCE_INLINE	void				clearBatchPending()		{ mBodyBufferFlags &= ~Buf::BF_BatchPending; }
+
 	//---------------------------------------------------------------------------------
 	// Miscellaneous
 	//---------------------------------------------------------------------------------
@@ -610,6 +630,67 @@ PX_INLINE void Body::setKinematicTarget(const PxTransform& p)
 #endif
 }
 
+PX_INLINE void Body::setBody2WorldBatched(const PxTransform& p)
+{
+	if(!isBuffering())
+	{
+		setBody2World(p, false);
+		return;
+	}
+
+	// same as a buffered setGlobalPose(), see setBody2World()
+	mBufferedBody2World = p;
+	mBodyBufferFlags &= ~Buf::BF_Body2World_CoM;
+	markUpdatedBatched(Buf::BF_Body2World);
+}
+
+PX_INLINE void Body::setLinearVelocityBatched(const PxVec3& v)
+{
+	if(!isBuffering())
+	{
+		setLinearVelocity(v);
+		return;
+	}
+
+	mBufferedLinVelocity = v;
+	markUpdatedBatched(Buf::BF_LinearVelocity);
+}
+
+PX_INLINE void Body::setKinematicTargetBatched(const PxTransform& p)
+{
+	if(!isBuffering())
+	{
+		setKinematicTarget(p);
+		return;
+	}
+
+	PX_ASSERT((mBodyBufferFlags & (Buf::BF_DeltaVelocity|Buf::BF_Acceleration)) == 0);  // switching to kinematic should do that.
+	getBodyBuffer()->mKinematicTarget = p;
+	markUpdatedBatched(Buf::BF_KinematicTarget);
+
+	wakeUpBatched(getScbScene()->getWakeCounterResetValue());
+#if PX_SUPPORT_PVD
+	if(getControlState() == ControlState::eIN_SCENE)
+		getScbScene()->getScenePvdClient().updateKinematicTarget(this, p);
+#endif
+}
+
+PX_INLINE void Body::wakeUpBatched(PxReal wakeCounter)
+{
+	PX_ASSERT(getScbScene());
+
+	if(!isBuffering())
+	{
+		wakeUpInternal(wakeCounter);
+		return;
+	}
+
+	mBufferedIsSleeping = 0;
+	mBufferedWakeCounter = wakeCounter;
+	markUpdatedBatched(Buf::BF_WakeUp | Buf::BF_WakeCounter);
+	mBodyBufferFlags &= ~Buf::BF_PutToSleep;
+}
+
 PX_FORCE_INLINE	void Body::onOriginShift(const PxVec3& shift)
 {
 	mBufferedBody2World.p -= shift;
@@ -740,6 +821,19 @@ PX_FORCE_INLINE	Ps::IntBool Body::isBuffered(PxU32 flag) const
 	return Ps::IntBool(mBodyBufferFlags & flag);	
 }
 
+PX_FORCE_INLINE	void Body::markUpdatedBatched(PxU32 flag)
+{
+	if((getControlState() == ControlState::eIN_SCENE) && !(getControlFlags() & ControlFlag::eIS_UPDATED))
+	{
+		if(!(mBodyBufferFlags & Buf::BF_BatchPending))
+			getScbScene()->scheduleForBatchedUpdate(*this);
+
+		mBodyBufferFlags |= flag | Buf::BF_BatchPending;
+	}
+	else
+		markUpdated(flag);  // already tracked (or about to be inserted/removed), the regular sync covers it
+}
+
 PX_INLINE void Body::syncCollisionWriteThroughState()
 {
 	PxU32 bufferFlags = mBodyBufferFlags;
@@ -939,7 +1033,7 @@ PX_INLINE void Body::syncState()
 	//----
 
 	if(bufferFlags & ~(	Buf::BF_WakeCounter|Buf::BF_Body2World|Buf::BF_LinearVelocity|Buf::BF_AngularVelocity
-		|Buf::BF_WakeUp|Buf::BF_PutToSleep))  // Optimization to avoid all the if-statements below if possible
+		|Buf::BF_WakeUp|Buf::BF_PutToSleep|Buf::BF_BatchPending))  // Optimization to avoid all the if-statements below if possible
 	{
 		const Buf& buffer = *getBodyBuffer();
 
@@ -164,6 +164,12 @@ public:
 	PX_INLINE bool						getSelfCollisionIndices(PxU32* indices) const;
 	PX_INLINE PxU32						getNbSelfCollisionIndices() const;
 
+	PX_INLINE void						setSelfCollisionInterval(PxU32 interval);
+	PX_INLINE PxU32						getSelfCollisionInterval() const;
+
+	PX_INLINE void						setLod(const PxClothLod& lod);
+	PX_INLINE PxClothLod				getLod() const;
+
 	PX_INLINE void						setRestPositions(const PxVec4* restPositions);
 	PX_INLINE bool						getRestPositions(PxVec4* restPositions) const;
 	PX_INLINE PxU32						getNbRestPositions() const; 
@@ -813,6 +819,32 @@ PX_INLINE PxU32 Cloth::getNbSelfCollisionIndices() const
 	return mCloth.getNbSelfCollisionIndices();
 }
 
+PX_INLINE void Cloth::setSelfCollisionInterval(PxU32 interval)
+{
+	if(!isBuffering())
+		mCloth.setSelfCollisionInterval(interval);
+	else
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "Call to PxCloth::setSelfCollisionInterval() not allowed while simulation is running.");
+}
+
+PX_INLINE PxU32 Cloth::getSelfCollisionInterval() const
+{
+	return mCloth.getSelfCollisionInterval();
+}
+
+PX_INLINE void Cloth::setLod(const PxClothLod& lod)
+{
+	if(!isBuffering())
+		mCloth.setLod(lod);
+	else
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "Call to PxCloth::setLod() not allowed while simulation is running.");
+}
+
+PX_INLINE PxClothLod Cloth::getLod() const
+{
+	return mCloth.getLod();
+}
+
 PX_INLINE void Cloth::setRestPositions(const PxVec4* restPositions)
 {
 	if(!isBuffering())
@@ -206,6 +206,7 @@ public:
 
 	PX_INLINE 	PxParticleReadDataFlags		getParticleReadDataFlags() const;
 	PX_INLINE 	void						setParticleReadDataFlags(PxParticleReadDataFlags);
+	PX_INLINE 	void						setParticleWriteBuffers(const PxParticleWriteBuffers* buffers);
 
 	PX_INLINE 	PxU32						getParticleCount() const;
 	PX_INLINE	const Cm::BitMap&			getParticleMap() const;
@@ -336,6 +337,18 @@ PX_INLINE void ParticleSystem::setParticleReadDataFlags(PxParticleReadDataFlags
 	}	
 }
 
+PX_INLINE void ParticleSystem::setParticleWriteBuffers(const PxParticleWriteBuffers* buffers)
+{
+	// the buffers are written during the simulation
+	if(isBuffering())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "Particle write buffers can't be changed while simulation is running.");
+		return;
+	}
+
+	mParticleSystem.setParticleWriteBuffers(buffers);
+}
+
 PX_INLINE PxU32 ParticleSystem::getParticleCount() const
 {
 	return mParticleSystem.getParticleCount();
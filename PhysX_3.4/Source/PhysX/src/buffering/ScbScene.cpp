@@ -969,6 +969,39 @@ void Scb::Scene::processUserUpdates(ObjectTracker &tracker)
 	}
 }
 
+void Scb::Scene::processBatchedBodyUpdates()
+{
+#if PX_SUPPORT_PVD
+	bool isPvdValid = mScenePvdClient.checkPvdDebugFlag();
+#endif
+	Scb::Body*const* batched = mBatchedBodies.begin();
+	const PxU32 nbBatched = mBatchedBodies.size();
+	for(PxU32 i=0; i < nbBatched; i++)
+	{
+		if(i+1 < nbBatched)
+			Ps::prefetchLine(batched[i+1]);
+
+		Scb::Body& v = *batched[i];
+
+		// A sync in between (the body got removed, put to sleep by the simulation or tracked by a regular write) clears the flag.
+		// Bodies which are still tracked get synced by processUserUpdates().
+		if(!v.isBatchPending())
+			continue;
+
+		if((v.getControlState() == ControlState::eIN_SCENE) && !(v.getControlFlags() & ControlFlag::eIS_UPDATED))
+		{
+			v.syncState();
+#if PX_SUPPORT_PVD
+			if(isPvdValid)
+				PvdFns<Scb::Body>::updateInstance(*this, mScenePvdClient, &v);
+#endif
+		}
+		else
+			v.clearBatchPending();
+	}
+	mBatchedBodies.clear();
+}
+
 template<typename T, typename S>
 void Scb::Scene::processSimUpdates(S*const * scObjects, PxU32 nbObjects)
 {
@@ -1013,6 +1046,15 @@ void Scb::Scene::syncWriteThroughProperties()
 		bufferedBody.syncCollisionWriteThroughState();
 	}
 
+	Scb::Body*const* batched = mBatchedBodies.begin();
+	count = mBatchedBodies.size();
+	for(PxU32 i=0; i < count; i++)
+	{
+		Scb::Body& batchedBody = *batched[i];
+		if(batchedBody.isBatchPending() && !(batchedBody.getControlFlags() & ControlFlag::eIS_UPDATED))  // else covered above
+			batchedBody.syncCollisionWriteThroughState();
+	}
+
 	mStream.unlock();
 }
 
@@ -1064,7 +1106,7 @@ void Scb::Scene::syncEntireScene()
 		{
 			Sc::BodyCore* bodyCore = *activeBodies++;
 			Scb::Body& bufferedBody = Scb::Body::fromSc(*bodyCore);
-			if (!(bufferedBody.getControlFlags() & ControlFlag::eIS_UPDATED))  // Else the data will be synced further below
+			if (!(bufferedBody.getControlFlags() & ControlFlag::eIS_UPDATED) && !bufferedBody.isBatchPending())  // Else the data will be synced further below
 				bufferedBody.syncState();
 		}
 	}
@@ -1077,6 +1119,7 @@ void Scb::Scene::syncEntireScene()
 
 	// user updates
 	processUserUpdates<Scb::Body>(mBodyManager);
+	processBatchedBodyUpdates();  // before the tracker clears, released bodies are still alive
 	mBodyManager.clear();
 	mShapePtrBuffer.clear();
 
@@ -1373,6 +1416,29 @@ bool Scb::Scene::removeBroadPhaseRegion(PxU32 handle)
 	return false;
 }
 
+bool Scb::Scene::setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)
+{
+	if(!isPhysicsBuffering())
+		return mScene.setBroadPhaseAdaptiveRegions(desc);
+	else
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxScene::setBroadPhaseAdaptiveRegions() not allowed while simulation is running. Call will be ignored.");
+	return false;
+}
+
+bool Scb::Scene::getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs) const
+{
+	createdPairs = PxBroadPhasePairView();
+	lostPairs = PxBroadPhasePairView();
+	if(!isPhysicsBuffering())
+	{
+		mScene.getBroadPhaseTriggerPairs(createdPairs, lostPairs);
+		return true;
+	}
+	else
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxScene::getBroadPhaseTriggerPairs() not allowed while simulation is running. Call will be ignored.");
+	return false;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 //
@@ -239,12 +239,15 @@ namespace Scb
 					PxU32					getBroadPhaseRegions(PxBroadPhaseRegionInfo* userBuffer, PxU32 bufferSize, PxU32 startIndex)	const;
 					PxU32					addBroadPhaseRegion(const PxBroadPhaseRegion& region, bool populateRegion);
 					bool					removeBroadPhaseRegion(PxU32 handle);
+					bool					setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc);
+					bool					getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs)	const;
 
 		// Collision filtering
 		PX_INLINE void						setFilterShaderData(const void* data, PxU32 dataSize);
 		PX_INLINE const void*				getFilterShaderData() const;
 		PX_INLINE PxU32						getFilterShaderDataSize() const;
 		PX_INLINE PxSimulationFilterShader	getFilterShader() const;
+		PX_INLINE PxSimulationFilterBatchShader	getFilterBatchShader() const;
 		PX_INLINE PxSimulationFilterCallback* getFilterCallback() const;
 
 		// Groups
@@ -320,6 +323,15 @@ namespace Scb
 						void				scheduleForUpdate(Scb::Base& object);
 						PxU8*				getStream(ScbType::Enum type);
 
+		/**
+		\brief Batched writes (PxScene::setGlobalPoses() and co) append the bodies to a flat list instead of the tracker of buffered objects.
+
+		The body flags the list membership itself (see Scb::Body::markUpdatedBatched()), so there is no hashing per body.
+		The list is flushed in one pass by syncEntireScene(), together with the regular body updates.
+		*/
+		PX_FORCE_INLINE	void				scheduleForBatchedUpdate(Scb::Body& body)				{ mBatchedBodies.pushBack(&body);									}
+		PX_FORCE_INLINE	void				reserveBatchedUpdates(PxU32 count)						{ mBatchedBodies.reserve(mBatchedBodies.size() + count);			}
+
 		PX_FORCE_INLINE void				removeShapeFromPendingUpdateList(Scb::Base& shape) { mShapeManager.remove(shape); }
 
 		PX_FORCE_INLINE	const Sc::Scene&	getScScene()					const	{ return mScene;						}
@@ -380,6 +392,7 @@ namespace Scb
 	template<typename T>												void processUserUpdates(ObjectTracker& tracker);
 	template<typename T, bool syncOnRemove, bool wakeOnLostTouchCheck>	void processRemoves(ObjectTracker& tracker);
 	template<typename T>												void processShapeRemoves(ObjectTracker& tracker);
+																		void processBatchedBodyUpdates();
 
 					Sc::Scene							mScene;
  
@@ -396,6 +409,7 @@ namespace Scb
 					Ps::Array<Scb::Actor*>				mActorPtrBuffer;
 					RigidStaticManager					mRigidStaticManager;
 					BodyManager							mBodyManager;
+					Ps::Array<Scb::Body*>				mBatchedBodies;  // Bodies written through the batched API while buffering, see scheduleForBatchedUpdate()
 #if PX_USE_PARTICLE_SYSTEM_API
 					ParticleSystemManager				mParticleSystemManager;
 #endif
@@ -605,6 +619,11 @@ PX_INLINE PxSimulationFilterShader Scb::Scene::getFilterShader() const
 	return mScene.getFilterShaderFast();
 }
 
+PX_INLINE PxSimulationFilterBatchShader Scb::Scene::getFilterBatchShader() const
+{
+	return mScene.getFilterBatchShaderFast();
+}
+
 PX_INLINE PxSimulationFilterCallback* Scb::Scene::getFilterCallback() const
 {
 	return mScene.getFilterCallbackFast();
@@ -617,6 +636,7 @@ PX_INLINE void Scb::Scene::flush(bool sendPendingReports)
 	mShapeMaterialBuffer.reset();
 	mShapePtrBuffer.reset();
 	mActorPtrBuffer.reset();
+	mBatchedBodies.reset();
 
 	//!!! TODO: Clear all buffers used for double buffering changes (see ObjectTracker::mBufferPool)
 
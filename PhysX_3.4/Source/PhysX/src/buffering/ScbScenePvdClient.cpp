@@ -356,6 +356,12 @@ void ScbScenePvdClient::setScenePvdFlag(PxPvdSceneFlag::Enum flag, bool value)
 		mFlags &= ~flag;
 }
 
+void ScbScenePvdClient::setUpdateSettings(const PxPvdSceneUpdateSettings& settings)
+{
+	PX_CHECK_AND_RETURN(settings.isValid(), "PxPvdSceneClient::setUpdateSettings: invalid settings");
+	mUpdateSettings = settings;
+}
+
 void ScbScenePvdClient::onPvdConnected()
 {
 	if(mIsConnected || !mPvd)
@@ -369,6 +375,8 @@ void ScbScenePvdClient::onPvdConnected()
 	mRenderClient = PX_NEW(SceneRendererClient)(mUserRender, mPvd);	
 	mUserRender->setClient(mRenderClient);
 
+	// The new connection knows nothing of what was sent to the previous one
+	mMetaDataBinding.resetActorUpdates();
 	sendEntireScene();
 }
 
@@ -941,7 +949,7 @@ void ScbScenePvdClient::frameEnd()
 		if(visualizeJoints)
 			vizualizer = this;
 
-		mMetaDataBinding.updateDynamicActorsAndArticulations(*mPvdDataStream, theScene, vizualizer);
+		mMetaDataBinding.updateDynamicActorsAndArticulations(*mPvdDataStream, theScene, vizualizer, mUpdateSettings);
 	}
 
 	// frame end moved to update contacts to have them in the previous frame.
@@ -91,6 +91,8 @@ class ScbScenePvdClient : public PxPvdSceneClient, public PvdClient, public PvdV
 	virtual	void			setScenePvdFlag(PxPvdSceneFlag::Enum flag, bool value);
 	virtual	void			setScenePvdFlags(PxPvdSceneFlags flags)				{ mFlags = flags;	}
 	virtual	PxPvdSceneFlags	getScenePvdFlags()							const	{ return mFlags;	}
+	virtual	void			setUpdateSettings(const PxPvdSceneUpdateSettings& settings);
+	virtual	PxPvdSceneUpdateSettings getUpdateSettings()				const	{ return mUpdateSettings;	}
 	virtual	void			updateCamera(const char* name, const PxVec3& origin, const PxVec3& up, const PxVec3& target);
 	virtual	void			drawPoints(const PvdDebugPoint* points, PxU32 count);
 	virtual	void			drawLines(const PvdDebugLine* lines, PxU32 count);
@@ -204,6 +206,7 @@ class ScbScenePvdClient : public PxPvdSceneClient, public PvdClient, public PvdV
 	void				setCreateContactReports(bool b);
 
 	PxPvdSceneFlags			mFlags;
+	PxPvdSceneUpdateSettings	mUpdateSettings;
 	PsPvd*					mPvd;
 	Scb::Scene&				mScbScene;
 	
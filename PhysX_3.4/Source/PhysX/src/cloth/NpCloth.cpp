@@ -703,6 +703,35 @@ PxU32 NpCloth::getNbSelfCollisionIndices() const
 	return mCloth.getNbSelfCollisionIndices();
 }
 
+void NpCloth::setSelfCollisionInterval(PxU32 interval)
+{
+	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
+
+	PX_CHECK_AND_RETURN(interval > 0, "PxCloth::setSelfCollisionInterval: interval has to be greater than 0!");
+
+	mCloth.setSelfCollisionInterval(interval);
+}
+PxU32 NpCloth::getSelfCollisionInterval() const
+{
+	return mCloth.getSelfCollisionInterval();
+}
+
+void NpCloth::setLod(const PxClothLod& lod)
+{
+	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
+
+	PX_CHECK_AND_RETURN(lod.solverFrequencyScale > 0.0f, "PxCloth::setLod: solverFrequencyScale has to be greater than 0!");
+	PX_CHECK_AND_RETURN(lod.updateInterval > 0, "PxCloth::setLod: updateInterval has to be greater than 0!");
+
+	mCloth.setLod(lod);
+}
+PxClothLod NpCloth::getLod() const
+{
+	NP_READ_CHECK(NpActor::getOwnerScene(*this));
+
+	return mCloth.getLod();
+}
+
 void NpCloth::setRestPositions(const PxVec4* restPositions)
 {
 	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
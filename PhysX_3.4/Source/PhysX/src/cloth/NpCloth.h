@@ -171,6 +171,12 @@ public:
 	virtual		bool				getSelfCollisionIndices(PxU32* indices) const;
 	virtual		PxU32				getNbSelfCollisionIndices() const;
 
+	virtual		void				setSelfCollisionInterval(PxU32 interval);
+	virtual		PxU32				getSelfCollisionInterval() const;
+
+	virtual		void				setLod(const PxClothLod& lod);
+	virtual		PxClothLod			getLod() const;
+
 	virtual		void				setRestPositions(const PxVec4* restPositions);
 	virtual		bool				getRestPositions(PxVec4* restPositions) const;
 	virtual		PxU32				getNbRestPositions() const; 
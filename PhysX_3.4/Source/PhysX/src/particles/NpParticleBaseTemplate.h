@@ -104,6 +104,7 @@ public:
 
 	virtual		PxParticleReadDataFlags	getParticleReadDataFlags()								const;
 	virtual		void					setParticleReadDataFlag(PxParticleReadDataFlag::Enum, bool);
+	virtual		void					setParticleWriteBuffers(const PxParticleWriteBuffers*);
 
 	virtual		PxU32 					getMaxParticles()										const;
 
@@ -684,6 +685,17 @@ void NpParticleBaseTemplate<APIClass, LeafClass>::setParticleReadDataFlag(PxPart
 	getScbParticleSystem().setParticleReadDataFlags(flags);
 }
 
+template<class APIClass, class LeafClass>
+void NpParticleBaseTemplate<APIClass, LeafClass>::setParticleWriteBuffers(const PxParticleWriteBuffers* buffers)
+{
+	NP_WRITE_CHECK(NpActor::getOwnerScene(*this));
+	PX_CHECK_AND_RETURN(getScbParticleSystem().getScParticleSystem().getSim(), "PxParticleBase::setParticleWriteBuffers: particle system must be part of a scene.");
+	PX_CHECK_AND_RETURN(!buffers || !buffers->positionBuffer.ptr() || buffers->positionBuffer.stride() >= sizeof(PxVec3), "PxParticleBase::setParticleWriteBuffers: invalid position buffer stride.");
+	PX_CHECK_AND_RETURN(!buffers || !buffers->velocityBuffer.ptr() || buffers->velocityBuffer.stride() >= sizeof(PxVec3), "PxParticleBase::setParticleWriteBuffers: invalid velocity buffer stride.");
+
+	getScbParticleSystem().setParticleWriteBuffers(buffers);
+}
+
 template<class APIClass, class LeafClass>
 PxU32 NpParticleBaseTemplate<APIClass, LeafClass>::getMaxParticles() const
 {
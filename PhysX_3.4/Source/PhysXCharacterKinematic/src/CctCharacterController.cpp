@@ -38,8 +38,12 @@
 #include "PsMathUtils.h"
 #include "GuIntersectionBoxBox.h"
 #include "GuDistanceSegmentBox.h"
+#include "GuDistanceSegmentTriangle.h"
 #include "PxMeshQuery.h"
 #include "PsFPU.h"
+#include "PsVecMath.h"
+#include "PsBitUtils.h"
+#include "PsSort.h"
 
 // PT: TODO: remove those includes.... shouldn't be allowed from here
 #include "PxControllerObstacles.h"	// (*)
@@ -300,20 +304,24 @@ static bool SweepBoxUserCapsule(const SweepTest* test, const SweptVolume* volume
 static bool sweepVolumeVsMesh(	const SweepTest* sweepTest, const TouchedMesh* touchedMesh, SweptContact& impact,
 								const PxVec3& unitDir, const PxGeometry& geom, const PxTransform& pose,
 								PxU32 nbTris, const PxTriangle* triangles,
-								PxU32 cachedIndex)
+								PxU32 cachedIndex, const PxU32* remap=NULL)
 {
 	PxSweepHit sweepHit;
-	if(PxMeshQuery::sweep(unitDir, impact.mDistance, geom, pose, nbTris, triangles, sweepHit, getSweepHitFlags(sweepTest->mUserParams), &cachedIndex))
+	// culled triangles are already in the order of the sweep, so the cached index is only used without remap
+	if(PxMeshQuery::sweep(unitDir, impact.mDistance, geom, pose, nbTris, triangles, sweepHit, getSweepHitFlags(sweepTest->mUserParams), remap ? NULL : &cachedIndex))
 	{
 		if(sweepHit.distance >= impact.mDistance)
 			return false;
 
+		if(remap)
+			sweepHit.faceIndex = remap[sweepHit.faceIndex];
+
 		impact.mDistance	= sweepHit.distance;
 		impact.mWorldNormal	= sweepHit.normal;
 		impact.setWorldPos(sweepHit.position, touchedMesh->mOffset);
 
 		// Returned index is only between 0 and nbTris, i.e. it indexes the array of cached triangles, not the original mesh.
-		PX_ASSERT(sweepHit.faceIndex < nbTris);
+		PX_ASSERT(sweepHit.faceIndex < touchedMesh->mNbTris);
 		sweepTest->mCachedTriIndex[sweepTest->mCachedTriIndexIndex] = sweepHit.faceIndex;
 
 		// The CCT loop will use the index from the start of the cache...
@@ -325,6 +333,176 @@ static bool sweepVolumeVsMesh(	const SweepTest* sweepTest, const TouchedMesh* to
 	return false;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const PxU32 gMinNbTrisForCulling = 16;	// below this the exact sweep is cheaper than the culling
+
+void SweepTest::updateTriangleBlocks() const
+{
+	const PxU32 nbTris = mWorldTriangles.size();
+	if(mNbBlockTriangles>=nbTris)
+		return;
+
+	// each block is x,y,z for the 3 vertices of 4 triangles. The existing blocks are preserved by the resize.
+	const PxU32 nbBlocks = (nbTris+3)>>2;
+	mTriangleBlocks.resizeUninitialized(nbBlocks*36);
+	PxF32* blocks = mTriangleBlocks.begin();
+
+	for(PxU32 i=mNbBlockTriangles;i<nbTris;i++)
+	{
+		const PxTriangle& tri = mWorldTriangles.getTriangle(i);
+		PxF32* dst = blocks + (i>>2)*36 + (i&3);
+		for(PxU32 j=0;j<3;j++)
+		{
+			dst[(j*3+0)*4] = tri.verts[j].x;
+			dst[(j*3+1)*4] = tri.verts[j].y;
+			dst[(j*3+2)*4] = tri.verts[j].z;
+		}
+	}
+
+	// unused lanes of the last block are masked out by the culling but should still be valid numbers
+	for(PxU32 i=nbTris;i<nbBlocks*4;i++)
+	{
+		PxF32* dst = blocks + (i>>2)*36 + (i&3);
+		for(PxU32 j=0;j<9;j++)
+			dst[j*4] = 0.0f;
+	}
+
+	mNbBlockTriangles = nbTris;
+}
+
+// culls the triangles of a mesh against a swept capsule, 4 triangles at a time. The culling is conservative: it only
+// rejects backfacing triangles (CCT sweeps are single-sided), triangles whose bounds don't touch the bounds of the swept
+// capsule, and triangles whose plane is farther than the radius from the 4 extreme points of the swept segment.
+// The kept triangles are copied to the sweep test buffers in the order used by the exact sweep when starting from
+// the cached index, so that the results are the same as without culling. Returns the number of kept triangles.
+static PxU32 cullTrianglesVsSweptCapsule(	const SweepTest* sweepTest, PxU32 firstTri, PxU32 nbTris, PxU32 cachedIndex,
+											const PxVec3& p0, const PxVec3& p1, PxF32 radius, const PxVec3& unitDir, PxF32 distance)
+{
+	using namespace Ps::aos;
+
+	sweepTest->updateTriangleBlocks();
+
+	// small margin to stay conservative with respect to the epsilons of the exact sweep
+	const PxF32 cullRadius = radius + (radius + distance)*0.01f;
+
+	const PxVec3 motion = unitDir * distance;
+	const PxVec3 p0b = p0 + motion;
+	const PxVec3 p1b = p1 + motion;
+	const PxVec3 boxMin = p0.minimum(p1).minimum(p0b.minimum(p1b)) - PxVec3(cullRadius);
+	const PxVec3 boxMax = p0.maximum(p1).maximum(p0b.maximum(p1b)) + PxVec3(cullRadius);
+
+	const Vec4V zeroV = V4Zero();
+	const Vec4V radius2V = V4Load(cullRadius*cullRadius);
+	const Vec4V boxMinX = V4Load(boxMin.x);	const Vec4V boxMinY = V4Load(boxMin.y);	const Vec4V boxMinZ = V4Load(boxMin.z);
+	const Vec4V boxMaxX = V4Load(boxMax.x);	const Vec4V boxMaxY = V4Load(boxMax.y);	const Vec4V boxMaxZ = V4Load(boxMax.z);
+	const Vec4V dirX = V4Load(unitDir.x);	const Vec4V dirY = V4Load(unitDir.y);	const Vec4V dirZ = V4Load(unitDir.z);
+	const PxVec3 points[4] = { p0, p1, p0b, p1b };
+	Vec4V pointX[4], pointY[4], pointZ[4];
+	for(PxU32 k=0;k<4;k++)
+	{
+		pointX[k] = V4Load(points[k].x);
+		pointY[k] = V4Load(points[k].y);
+		pointZ[k] = V4Load(points[k].z);
+	}
+
+	IntArray& kept = sweepTest->mCulledTriangleIndices;
+	kept.clear();
+	bool keptCached = false;
+
+	const PxF32* blocks = sweepTest->mTriangleBlocks.begin();
+	const PxU32 lastTri = firstTri + nbTris;
+	for(PxU32 blockStart=firstTri & ~3;blockStart<lastTri;blockStart+=4)
+	{
+		const PxF32* block = blocks + (blockStart>>2)*36;
+		const Vec4V ax = V4LoadA(block);		const Vec4V ay = V4LoadA(block+4);		const Vec4V az = V4LoadA(block+8);
+		const Vec4V bx = V4LoadA(block+12);	const Vec4V by = V4LoadA(block+16);	const Vec4V bz = V4LoadA(block+20);
+		const Vec4V cx = V4LoadA(block+24);	const Vec4V cy = V4LoadA(block+28);	const Vec4V cz = V4LoadA(block+32);
+
+		// Bounds
+		BoolV rejected = BOr(V4IsGrtr(V4Min(ax, V4Min(bx, cx)), boxMaxX), V4IsGrtr(boxMinX, V4Max(ax, V4Max(bx, cx))));
+		rejected = BOr(rejected, BOr(V4IsGrtr(V4Min(ay, V4Min(by, cy)), boxMaxY), V4IsGrtr(boxMinY, V4Max(ay, V4Max(by, cy)))));
+		rejected = BOr(rejected, BOr(V4IsGrtr(V4Min(az, V4Min(bz, cz)), boxMaxZ), V4IsGrtr(boxMinZ, V4Max(az, V4Max(bz, cz)))));
+
+		// Denormalized normals, same winding as PxTriangle::denormalizedNormal
+		const Vec4V e0x = V4Sub(bx, ax);	const Vec4V e0y = V4Sub(by, ay);	const Vec4V e0z = V4Sub(bz, az);
+		const Vec4V e1x = V4Sub(cx, ax);	const Vec4V e1y = V4Sub(cy, ay);	const Vec4V e1z = V4Sub(cz, az);
+		const Vec4V nx = V4NegMulSub(e0z, e1y, V4Mul(e0y, e1z));
+		const Vec4V ny = V4NegMulSub(e0x, e1z, V4Mul(e0z, e1x));
+		const Vec4V nz = V4NegMulSub(e0y, e1x, V4Mul(e0x, e1y));
+
+		// Backface culling
+		rejected = BOr(rejected, V4IsGrtr(V4MulAdd(nx, dirX, V4MulAdd(ny, dirY, V4Mul(nz, dirZ))), zeroV));
+
+		// Plane distances (scaled by the length of the normal) of the swept segment
+		Vec4V minDist = V4Load(PX_MAX_F32);
+		Vec4V maxDist = V4Load(-PX_MAX_F32);
+		for(PxU32 k=0;k<4;k++)
+		{
+			const Vec4V d = V4MulAdd(nx, V4Sub(pointX[k], ax), V4MulAdd(ny, V4Sub(pointY[k], ay), V4Mul(nz, V4Sub(pointZ[k], az))));
+			minDist = V4Min(minDist, d);
+			maxDist = V4Max(maxDist, d);
+		}
+		const Vec4V limit2 = V4Mul(radius2V, V4MulAdd(nx, nx, V4MulAdd(ny, ny, V4Mul(nz, nz))));
+		rejected = BOr(rejected, BAnd(V4IsGrtr(minDist, zeroV), V4IsGrtr(V4Mul(minDist, minDist), limit2)));
+		rejected = BOr(rejected, BAnd(V4IsGrtr(zeroV, maxDist), V4IsGrtr(V4Mul(maxDist, maxDist), limit2)));
+
+		PxU32 keptMask = ~BGetBitMask(rejected) & 0xf;
+		while(keptMask)
+		{
+			const PxU32 lane = Ps::lowestSetBit(keptMask);
+			keptMask &= keptMask - 1;
+
+			const PxU32 triIndex = blockStart + lane;
+			if(triIndex<firstTri || triIndex>=lastTri)
+				continue;
+
+			const PxU32 localIndex = triIndex - firstTri;
+			kept.pushBack(localIndex);
+			if(localIndex==cachedIndex)
+				keptCached = true;
+		}
+	}
+
+	// the exact sweep visits the cached triangle first, then the others in order with the first triangle taking the
+	// place of the cached one. Reorder the sorted list the same way, i.e. swap the cached and the first triangles.
+	const PxU32 nbKept = kept.size();
+	PxU32* remap = kept.begin();
+	if(cachedIndex && nbKept)
+	{
+		const bool keptFirst = remap[0]==0;
+
+		// position of the cached triangle if kept, or of the first index above it otherwise
+		PxU32 pos = 0;
+		while(pos<nbKept && remap[pos]<cachedIndex)
+			pos++;
+
+		if(keptFirst && keptCached)
+			Ps::swap(remap[0], remap[pos]);
+		else if(keptCached)
+		{
+			for(PxU32 i=pos;i>0;i--)
+				remap[i] = remap[i-1];
+			remap[0] = cachedIndex;
+		}
+		else if(keptFirst)
+		{
+			for(PxU32 i=1;i<pos;i++)
+				remap[i-1] = remap[i];
+			remap[pos-1] = 0;
+		}
+	}
+
+	TriArray& culled = sweepTest->mCulledTriangles;
+	culled.clear();
+	PxTriangle* dst = culled.reserve(nbKept);
+	const PxTriangle* triangles = &sweepTest->mWorldTriangles.getTriangle(firstTri);
+	for(PxU32 i=0;i<nbKept;i++)
+		dst[i] = triangles[remap[i]];
+
+	return nbKept;
+}
+
 static bool SweepBoxMesh(const SweepTest* sweep_test, const SweptVolume* volume, const TouchedGeom* geom, const PxExtendedVec3& center, const PxVec3& dir, SweptContact& impact)
 {
 	PX_ASSERT(volume->getType()==SweptVolumeType::eBOX);
@@ -376,6 +554,18 @@ static bool SweepCapsuleMesh(
 	PxTransform capsulePose;
 	relocateCapsule(capsuleGeom, capsulePose, SC, sweep_test->mUserParams.mQuatFromUp, center, TM->mOffset);
 
+	// dense meshes go through the SIMD culling first, the exact sweep then only sees the triangles it can touch
+	if(nbTris>=gMinNbTrisForCulling)
+	{
+		const PxVec3 axis = capsulePose.q.getBasisVector0() * capsuleGeom.halfHeight;
+		const PxU32 nbKept = cullTrianglesVsSweptCapsule(sweep_test, TM->mIndexWorldTriangles, nbTris, CachedIndex,
+														capsulePose.p + axis, capsulePose.p - axis, capsuleGeom.radius, dir, impact.mDistance);
+		if(!nbKept)
+			return false;
+
+		return sweepVolumeVsMesh(sweep_test, TM, impact, dir, capsuleGeom, capsulePose, nbKept, sweep_test->mCulledTriangles.begin(), 0, sweep_test->mCulledTriangleIndices.begin());
+	}
+
 	return sweepVolumeVsMesh(sweep_test, TM, impact, dir, capsuleGeom, capsulePose, nbTris, T, CachedIndex);
 }
 
@@ -789,12 +979,148 @@ static const TouchedGeom* CollideGeoms(
 	return impact.mGeom;
 }
 
+// capsule-vs-mesh MTD using the cached triangles of the touched mesh instead of the generic contact generation.
+// The SIMD culling (with a null motion) first rejects the triangles that can't touch the capsule, then each remaining
+// triangle gives a push along the closest points, combined like the Gu MTD combines its contacts. Backfacing triangles
+// are ignored, as in the sweeps.
+static bool computeCapsuleTrianglesMTD(PxVec3& mtd, PxF32& depth, const SweepTest* sweepTest, const TouchedMesh* touchedMesh, const PxCapsuleGeometry& capsuleGeom, const PxTransform& capsulePose)
+{
+	const PxU32 nbTris = touchedMesh->mNbTris;
+	if(!nbTris)
+		return false;
+
+	const PxVec3 center = capsulePose.p - toVec3(touchedMesh->mOffset);
+	const PxVec3 axis = capsulePose.q.getBasisVector0() * capsuleGeom.halfHeight;
+	const PxVec3 p0 = center + axis;
+	const PxVec3 p1 = center - axis;
+	const PxF32 radius = capsuleGeom.radius;
+
+	const PxU32 nbKept = cullTrianglesVsSweptCapsule(sweepTest, touchedMesh->mIndexWorldTriangles, nbTris, 0, p0, p1, radius, PxVec3(0.0f), 0.0f);
+	if(!nbKept)
+		return false;
+
+	const PxVec3 segment = p1 - p0;
+	const PxTriangle* triangles = sweepTest->mCulledTriangles.begin();
+
+	PxVec3 mn(0.0f), mx(0.0f);
+	bool touched = false;
+	for(PxU32 i=0;i<nbKept;i++)
+	{
+		const PxTriangle& tri = triangles[i];
+
+		PxVec3 normal;
+		tri.denormalizedNormal(normal);
+		if(normal.dot(center - tri.verts[0])<0.0f)
+			continue;
+
+		const PxVec3 edge0 = tri.verts[1] - tri.verts[0];
+		const PxVec3 edge1 = tri.verts[2] - tri.verts[0];
+		PxReal t, u, v;
+		const PxReal d2 = Gu::distanceSegmentTriangleSquared(p0, segment, tri.verts[0], edge0, edge1, &t, &u, &v);
+		if(d2>=radius*radius)
+			continue;
+
+		PxVec3 push;
+		const PxReal d = PxSqrt(d2);
+		if(d>1e-4f)
+		{
+			const PxVec3 segmentPoint = p0 + segment * t;
+			const PxVec3 trianglePoint = tri.verts[0] + edge0 * u + edge1 * v;
+			push = (segmentPoint - trianglePoint) * ((radius - d)/d);
+		}
+		else
+		{
+			// the segment goes through the triangle, push its deepest point out along the normal
+			normal.normalize();
+			const PxReal deepest = PxMin(normal.dot(p0 - tri.verts[0]), normal.dot(p1 - tri.verts[0]));
+			push = normal * (radius - deepest);
+		}
+
+		mn = mn.minimum(push);
+		mx = mx.maximum(push);
+		touched = true;
+	}
+	if(!touched)
+		return false;
+
+	// same as the Gu MTD, equalize the pushes in opposing directions along each axis
+	const PxVec3 mn1((mn.x == 0.0f) ? mx.x : mn.x, (mn.y == 0.0f) ? mx.y : mn.y, (mn.z == 0.0f) ? mx.z : mn.z);
+	const PxVec3 mx1((mx.x == 0.0f) ? mn.x : mx.x, (mx.y == 0.0f) ? mn.y : mx.y, (mx.z == 0.0f) ? mn.z : mx.z);
+	const PxVec3 sepDir = (mn1 + mx1)*0.5f;
+	if(sepDir.magnitudeSquared() < 1e-10f)
+		return false;
+
+	depth = sepDir.magnitude();
+	mtd = sepDir / depth;
+	return true;
+}
+
+static bool sameGeometry(const PxGeometryHolder& a, const PxGeometryHolder& b)
+{
+	const PxGeometryType::Enum type = a.getType();
+	if(type!=b.getType())
+		return false;
+
+	switch(type)
+	{
+		case PxGeometryType::eSPHERE:
+			return a.sphere().radius==b.sphere().radius;
+		case PxGeometryType::ePLANE:
+			return true;
+		case PxGeometryType::eCAPSULE:
+			return a.capsule().radius==b.capsule().radius && a.capsule().halfHeight==b.capsule().halfHeight;
+		case PxGeometryType::eBOX:
+			return a.box().halfExtents==b.box().halfExtents;
+		case PxGeometryType::eCONVEXMESH:
+		{
+			const PxConvexMeshGeometry& ga = a.convexMesh();
+			const PxConvexMeshGeometry& gb = b.convexMesh();
+			return ga.convexMesh==gb.convexMesh && ga.scale.scale==gb.scale.scale && ga.scale.rotation==gb.scale.rotation && ga.meshFlags==gb.meshFlags;
+		}
+		case PxGeometryType::eTRIANGLEMESH:
+		{
+			const PxTriangleMeshGeometry& ga = a.triangleMesh();
+			const PxTriangleMeshGeometry& gb = b.triangleMesh();
+			return ga.triangleMesh==gb.triangleMesh && ga.scale.scale==gb.scale.scale && ga.scale.rotation==gb.scale.rotation && ga.meshFlags==gb.meshFlags;
+		}
+		case PxGeometryType::eHEIGHTFIELD:
+		{
+			const PxHeightFieldGeometry& ga = a.heightField();
+			const PxHeightFieldGeometry& gb = b.heightField();
+			return ga.heightField==gb.heightField && ga.heightScale==gb.heightScale && ga.rowScale==gb.rowScale && ga.columnScale==gb.columnScale && ga.heightFieldFlags==gb.heightFieldFlags;
+		}
+		case PxGeometryType::eGEOMETRY_COUNT:
+		case PxGeometryType::eINVALID:
+			break;
+	}
+	return false;
+}
+
+static const SweepTest::CachedMTD* findCachedMTD(const SweepTest::CachedMTDArray& cache, const PxShape* shape, const PxTransform& shapePose, const PxGeometryHolder& shapeGeometry,
+												const PxTransform& volumePose, const PxVec3& volumeExtents, PxU32 volumeType)
+{
+	const PxU32 nb = cache.size();
+	for(PxU32 i=0;i<nb;i++)
+	{
+		const SweepTest::CachedMTD& entry = cache[i];
+		if(entry.mShape==shape && entry.mVolumeType==volumeType && entry.mVolumePose==volumePose && entry.mVolumeExtents==volumeExtents
+			&& entry.mShapePose==shapePose && sameGeometry(entry.mShapeGeometry, shapeGeometry))
+			return &entry;
+	}
+	return NULL;
+}
+
 static PxVec3 computeMTD(const SweepTest* sweep_test, const SweptVolume& volume, const IntArray& geom_stream, const PxExtendedVec3& center, float contactOffset)
 {
 	PxVec3 p = toVec3(center);
 
 //	contactOffset += 0.01f;
 
+	// results of the previous call can be reused, the ones of this call replace them at the end
+	SweepTest::CachedMTDArray& previousResults = sweep_test->mCachedMTDs;
+	SweepTest::CachedMTDArray& newResults = sweep_test->mNewCachedMTDs;
+	newResults.clear();
+
 	const PxU32 maxIter = 4;
 	PxU32 nbIter = 0;
 	bool isValid = true;
@@ -826,18 +1152,58 @@ static PxVec3 computeMTD(const SweepTest* sweep_test, const SweptVolume& volume,
 					PxF32 depth;
 
 					const PxTransform volumePose(p, sweep_test->mUserParams.mQuatFromUp);
-					if(volume.getType()==SweptVolumeType::eCAPSULE)
+					const PxU32 volumeType = volume.getType();
+					PxVec3 volumeExtents;
+					if(volumeType==SweptVolumeType::eCAPSULE)
 					{
 						const SweptCapsule& sc = static_cast<const SweptCapsule&>(volume);
-						const PxCapsuleGeometry capsuleGeom(sc.mRadius+contactOffset, sc.mHeight*0.5f);
-						isValid = PxGeometryQuery::computePenetration(mtd, depth, capsuleGeom, volumePose, gh.any(), globalPose);
+						volumeExtents = PxVec3(sc.mRadius+contactOffset, sc.mHeight*0.5f, 0.0f);
 					}
 					else
 					{
-						PX_ASSERT(volume.getType()==SweptVolumeType::eBOX);
+						PX_ASSERT(volumeType==SweptVolumeType::eBOX);
 						const SweptBox& sb = static_cast<const SweptBox&>(volume);
-						const PxBoxGeometry boxGeom(sb.mExtents+PxVec3(contactOffset));
-						isValid = PxGeometryQuery::computePenetration(mtd, depth, boxGeom, volumePose, gh.any(), globalPose);
+						volumeExtents = sb.mExtents+PxVec3(contactOffset);
+					}
+
+					const SweepTest::CachedMTD* cached = findCachedMTD(previousResults, touchedShape, globalPose, gh, volumePose, volumeExtents, volumeType);
+					if(!cached)
+						cached = findCachedMTD(newResults, touchedShape, globalPose, gh, volumePose, volumeExtents, volumeType);
+					if(cached)
+					{
+						isValid = cached->mIsValid;
+						mtd = cached->mMTD;
+						depth = cached->mDepth;
+					}
+					else
+					{
+						if(volumeType==SweptVolumeType::eCAPSULE)
+						{
+							const PxCapsuleGeometry capsuleGeom(volumeExtents.x, volumeExtents.y);
+
+							// meshes and heightfields use their cached triangles, the other shapes have cheap analytic MTDs
+							const PxGeometryType::Enum shapeType = gh.getType();
+							if(CurrentGeom->mType==TouchedGeomType::eMESH && (shapeType==PxGeometryType::eTRIANGLEMESH || shapeType==PxGeometryType::eHEIGHTFIELD))
+								isValid = computeCapsuleTrianglesMTD(mtd, depth, sweep_test, static_cast<const TouchedMesh*>(CurrentGeom), capsuleGeom, volumePose);
+							else
+								isValid = PxGeometryQuery::computePenetration(mtd, depth, capsuleGeom, volumePose, gh.any(), globalPose);
+						}
+						else
+						{
+							const PxBoxGeometry boxGeom(volumeExtents);
+							isValid = PxGeometryQuery::computePenetration(mtd, depth, boxGeom, volumePose, gh.any(), globalPose);
+						}
+
+						SweepTest::CachedMTD& entry = newResults.insert();
+						entry.mShape			= touchedShape;
+						entry.mShapePose		= globalPose;
+						entry.mShapeGeometry	= gh;
+						entry.mVolumePose		= volumePose;
+						entry.mVolumeExtents	= volumeExtents;
+						entry.mVolumeType		= volumeType;
+						entry.mMTD				= isValid ? mtd : PxVec3(0.0f);
+						entry.mDepth			= isValid ? depth : 0.0f;
+						entry.mIsValid			= isValid;
 					}
 
 					if(isValid)
@@ -866,6 +1232,8 @@ static PxVec3 computeMTD(const SweepTest* sweep_test, const SweptVolume& volume,
 			Data = reinterpret_cast<const PxU32*>(ptr);
 		}
 	}
+
+	previousResults.swap(newResults);
 	return p;
 }
 
@@ -927,6 +1295,7 @@ SweepTest::SweepTest(bool registerDeletionListener) :
 	mCachedTriIndex[0] = mCachedTriIndex[1] = mCachedTriIndex[2] = 0;
 	mNbCachedStatic = 0;
 	mNbCachedT		= 0;
+	mNbBlockTriangles	= 0;
 
 	mTouchedObstacleHandle	= INVALID_OBSTACLE_HANDLE;
 	mTouchedPos					= PxVec3(0);
@@ -959,6 +1328,7 @@ void SweepTest::voidTestCache()
 	mTouchedActor = NULL;
 	mCacheBounds.setEmpty();
 	mTouchedObstacleHandle	= INVALID_OBSTACLE_HANDLE;
+	mCachedMTDs.clear();
 }
 
 void SweepTest::onRelease(const PxBase& observed)
@@ -971,7 +1341,10 @@ void SweepTest::onRelease(const PxBase& observed)
 	}
 
 	if(ParseGeomStream(&observed, mGeomStream))
+	{
 		mCacheBounds.setEmpty();
+		mCachedMTDs.clear();
+	}
 
 	if (mTouchedShape == &observed)
 		mTouchedShape = NULL;
@@ -1120,36 +1493,113 @@ static PxBounds3 getBounds3(const PxExtendedBounds3& extended)
 	return PxBounds3(toVec3(extended.minimum), toVec3(extended.maximum));	// LOSS OF ACCURACY
 }
 
+// the precise tests run relative to the center of the world box
+static PX_FORCE_INLINE bool touchesWorldBox(const PxExtendedBox& box, const PxBounds3& localWorldBox, const PxExtendedVec3& center)
+{
+	const Gu::Box obb(
+		toLocal(box.center, center),
+		box.extents,
+		PxMat33(box.rot));	// #### TODO: useless conversion here
+
+	return Gu::intersectOBBAABB(obb, localWorldBox);
+}
+
+static PX_FORCE_INLINE bool touchesWorldBox(const PxExtendedCapsule& capsule, const PxExtendedBounds3& worldBox, const PxExtendedVec3& center, const PxVec3& extents)
+{
+	// PT: do a quick AABB check first, to avoid calling the SDK too much
+	const PxF32 r = capsule.radius;
+	const PxExtended capMinx = PxMin(capsule.p0.x, capsule.p1.x);
+	const PxExtended capMaxx = PxMax(capsule.p0.x, capsule.p1.x);
+	if((capMinx - PxExtended(r) > worldBox.maximum.x) || (worldBox.minimum.x > capMaxx + PxExtended(r))) return false;
+
+	const PxExtended capMiny = PxMin(capsule.p0.y, capsule.p1.y);
+	const PxExtended capMaxy = PxMax(capsule.p0.y, capsule.p1.y);
+	if((capMiny - PxExtended(r) > worldBox.maximum.y) || (worldBox.minimum.y > capMaxy + PxExtended(r))) return false;
+
+	const PxExtended capMinz = PxMin(capsule.p0.z, capsule.p1.z);
+	const PxExtended capMaxz = PxMax(capsule.p0.z, capsule.p1.z);
+	if((capMinz - PxExtended(r) > worldBox.maximum.z) || (worldBox.minimum.z > capMaxz + PxExtended(r))) return false;
+
+	// PT: more accurate capsule-box test. Not strictly necessary but worth doing if available
+	const PxReal d2 = Gu::distanceSegmentBoxSquared(toLocal(capsule.p0, center), toLocal(capsule.p1, center), PxVec3(0.0f), extents, PxMat33(PxIdentity));
+	return d2<=r*r;
+}
+
+static PX_FORCE_INLINE void addTouchedUserBox(IntArray& geomStream, const PxExtendedBox& box, const void* userData, const PxExtendedVec3& origin)
+{
+	TouchedUserBox* UserBox = reinterpret_cast<TouchedUserBox*>(reserveContainerMemory(geomStream, sizeof(TouchedUserBox)/sizeof(PxU32)));
+	UserBox->mType			= TouchedGeomType::eUSER_BOX;
+	UserBox->mTGUserData	= userData;
+	UserBox->mActor			= NULL;
+	UserBox->mOffset		= origin;
+	UserBox->mBox			= box;
+}
+
+static PX_FORCE_INLINE void addTouchedUserCapsule(IntArray& geomStream, const PxExtendedCapsule& capsule, const void* userData, const PxExtendedVec3& origin)
+{
+	TouchedUserCapsule* UserCapsule = reinterpret_cast<TouchedUserCapsule*>(reserveContainerMemory(geomStream, sizeof(TouchedUserCapsule)/sizeof(PxU32)));
+	UserCapsule->mType			= TouchedGeomType::eUSER_CAPSULE;
+	UserCapsule->mTGUserData	= userData;
+	UserCapsule->mActor			= NULL;
+	UserCapsule->mOffset		= origin;
+	UserCapsule->mCapsule		= capsule;
+}
+
 // PT: finds both touched CCTs and touched user-defined obstacles
 void SweepTest::findTouchedObstacles(const UserObstacles& userObstacles, const PxExtendedBounds3& worldBox)
 {
 	PxExtendedVec3 Origin;	// Will be TouchedGeom::mOffset
 	getCenter(worldBox, Origin);
 
+	const PxBounds3 singlePrecisionWorldBox = getBounds3(worldBox);
+
+	PxVec3 Extents;
+	getExtents(worldBox, Extents);
+	const PxBounds3 localWorldBox(-Extents, Extents);
+
+	// obstacles from the context that touch the world box, sorted so that they are reported in the same order as
+	// when all of them were tested. Boxes come first since capsule refs have the high bit set.
+	const ObstacleContext* obstacleContext = userObstacles.mObstacleContext;
+	mTouchedObstacleRefs.clear();
+	PxU32 nbTouchedObstacles = 0;
+	if(obstacleContext)
+	{
+		nbTouchedObstacles = obstacleContext->overlap(singlePrecisionWorldBox, mTouchedObstacleRefs);
+		if(nbTouchedObstacles>1)
+			Ps::sort(mTouchedObstacleRefs.begin(), nbTouchedObstacles);
+	}
+	PxU32 nbTouchedBoxObstacles = 0;
+	while(nbTouchedBoxObstacles<nbTouchedObstacles && !(mTouchedObstacleRefs[nbTouchedBoxObstacles] & OBSTACLE_REF_CAPSULE))
+		nbTouchedBoxObstacles++;
+
 	{
 		const PxU32 nbBoxes = userObstacles.mNbBoxes;
 		const PxExtendedBox* boxes = userObstacles.mBoxes;
 		const void** boxUserData = userObstacles.mBoxUserData;
 
-		const PxBounds3 singlePrecisionWorldBox = getBounds3(worldBox);
-
 		// Find touched boxes, i.e. other box controllers
 		for(PxU32 i=0;i<nbBoxes;i++)
 		{
-			const Gu::Box obb(
-				toVec3(boxes[i].center),	// LOSS OF ACCURACY
-				boxes[i].extents,
-				PxMat33(boxes[i].rot));	// #### PT: TODO: useless conversion here
+			if(touchesWorldBox(boxes[i], localWorldBox, Origin))
+				addTouchedUserBox(mGeomStream, boxes[i], boxUserData[i], Origin);
+		}
 
-			if(!Gu::intersectOBBAABB(obb, singlePrecisionWorldBox))
-				continue;
+		// Find touched box obstacles
+		for(PxU32 i=0;i<nbTouchedBoxObstacles;i++)
+		{
+			const PxU32 index = mTouchedObstacleRefs[i];
+			const PxBoxObstacle& userBoxObstacle = obstacleContext->mBoxObstacles[index].mData;
 
-			TouchedUserBox* UserBox = reinterpret_cast<TouchedUserBox*>(reserveContainerMemory(mGeomStream, sizeof(TouchedUserBox)/sizeof(PxU32)));
-			UserBox->mType			= TouchedGeomType::eUSER_BOX;
-			UserBox->mTGUserData	= boxUserData[i];
-			UserBox->mActor			= NULL;
-			UserBox->mOffset		= Origin;
-			UserBox->mBox			= boxes[i];
+			PxExtendedBox extraBox;
+			extraBox.center		= userBoxObstacle.mPos;
+			extraBox.extents	= userBoxObstacle.mHalfExtents;
+			extraBox.rot		= userBoxObstacle.mRot;
+
+			if(touchesWorldBox(extraBox, localWorldBox, Origin))
+			{
+				const size_t code = encodeUserObject(index, USER_OBJECT_BOX_OBSTACLE);
+				addTouchedUserBox(mGeomStream, extraBox, reinterpret_cast<const void*>(code), Origin);
+			}
 		}
 	}
 
@@ -1159,42 +1609,233 @@ void SweepTest::findTouchedObstacles(const UserObstacles& userObstacles, const P
 		const PxExtendedCapsule* capsules = userObstacles.mCapsules;
 		const void** capsuleUserData = userObstacles.mCapsuleUserData;
 
-		PxExtendedVec3 Center;
-		PxVec3 Extents;
-		getCenter(worldBox, Center);
-		getExtents(worldBox, Extents);
-
 		for(PxU32 i=0;i<nbCapsules;i++)
 		{
-			// PT: do a quick AABB check first, to avoid calling the SDK too much
-			const PxF32 r = capsules[i].radius;
-			const PxExtended capMinx = PxMin(capsules[i].p0.x, capsules[i].p1.x);
-			const PxExtended capMaxx = PxMax(capsules[i].p0.x, capsules[i].p1.x);
-			if((capMinx - PxExtended(r) > worldBox.maximum.x) || (worldBox.minimum.x > capMaxx + PxExtended(r))) continue;
+			if(touchesWorldBox(capsules[i], worldBox, Origin, Extents))
+				addTouchedUserCapsule(mGeomStream, capsules[i], capsuleUserData[i], Origin);
+		}
 
-			const PxExtended capMiny = PxMin(capsules[i].p0.y, capsules[i].p1.y);
-			const PxExtended capMaxy = PxMax(capsules[i].p0.y, capsules[i].p1.y);
-			if((capMiny - PxExtended(r) > worldBox.maximum.y) || (worldBox.minimum.y > capMaxy + PxExtended(r))) continue;
+		// Find touched capsule obstacles
+		for(PxU32 i=nbTouchedBoxObstacles;i<nbTouchedObstacles;i++)
+		{
+			const PxU32 index = mTouchedObstacleRefs[i] & ~OBSTACLE_REF_CAPSULE;
+			const PxCapsuleObstacle& userCapsuleObstacle = obstacleContext->mCapsuleObstacles[index].mData;
 
-			const PxExtended capMinz = PxMin(capsules[i].p0.z, capsules[i].p1.z);
-			const PxExtended capMaxz = PxMax(capsules[i].p0.z, capsules[i].p1.z);
-			if((capMinz - PxExtended(r) > worldBox.maximum.z) || (worldBox.minimum.z > capMaxz + PxExtended(r))) continue;
+			PxExtendedCapsule extraCapsule;
+			const PxVec3 capsuleAxis = userCapsuleObstacle.mRot.getBasisVector0() * userCapsuleObstacle.mHalfHeight;
+			extraCapsule.p0		= PxExtendedVec3(	userCapsuleObstacle.mPos.x - PxExtended(capsuleAxis.x),
+													userCapsuleObstacle.mPos.y - PxExtended(capsuleAxis.y),
+													userCapsuleObstacle.mPos.z - PxExtended(capsuleAxis.z));
+			extraCapsule.p1		= PxExtendedVec3(	userCapsuleObstacle.mPos.x + PxExtended(capsuleAxis.x),
+													userCapsuleObstacle.mPos.y + PxExtended(capsuleAxis.y),
+													userCapsuleObstacle.mPos.z + PxExtended(capsuleAxis.z));
+			extraCapsule.radius	= userCapsuleObstacle.mRadius;
 
-			// PT: more accurate capsule-box test. Not strictly necessary but worth doing if available
-			const PxReal d2 = Gu::distanceSegmentBoxSquared(toVec3(capsules[i].p0), toVec3(capsules[i].p1), toVec3(Center), Extents, PxMat33(PxIdentity));
-			if(d2>r*r)
-				continue;
+			if(touchesWorldBox(extraCapsule, worldBox, Origin, Extents))
+			{
+				const size_t code = encodeUserObject(index, USER_OBJECT_CAPSULE_OBSTACLE);
+				addTouchedUserCapsule(mGeomStream, extraCapsule, reinterpret_cast<const void*>(code), Origin);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const PxU32 gMaxSharedCells = 256;	// least recently used cells are evicted past this
+
+bool TouchedGeomCache::CellKey::operator==(const CellKey& other) const
+{
+	return	mX==other.mX && mY==other.mY && mZ==other.mZ
+		&&	mFilterData[0]==other.mFilterData[0] && mFilterData[1]==other.mFilterData[1]
+		&&	mFilterData[2]==other.mFilterData[2] && mFilterData[3]==other.mFilterData[3]
+		&&	mHasFilterData==other.mHasFilterData && mTessellation==other.mTessellation
+		&&	mMaxEdgeLength2==other.mMaxEdgeLength2 && mInvisibleWallHeight==other.mInvisibleWallHeight
+		&&	mSlopeLimit==other.mSlopeLimit && mUpDirection==other.mUpDirection;
+}
 
-			TouchedUserCapsule* UserCapsule = reinterpret_cast<TouchedUserCapsule*>(reserveContainerMemory(mGeomStream, sizeof(TouchedUserCapsule)/sizeof(PxU32)));
-			UserCapsule->mType			= TouchedGeomType::eUSER_CAPSULE;
-			UserCapsule->mTGUserData	= capsuleUserData[i];
-			UserCapsule->mActor			= NULL;
-			UserCapsule->mOffset		= Origin;
-			UserCapsule->mCapsule		= capsules[i];
+PxU32 TouchedGeomCache::CellKeyHash::operator()(const CellKey& key) const
+{
+	PxU32 h = Ps::hash(PxU32(key.mX)*73856093u ^ PxU32(key.mY)*19349663u ^ PxU32(key.mZ)*83492791u);
+	h ^= Ps::hash(key.mFilterData[0] ^ (key.mFilterData[1]<<8) ^ (key.mFilterData[2]<<16) ^ (key.mFilterData[3]<<24));
+	return h;
+}
+
+TouchedGeomCache::TouchedGeomCache(PxF32 cellSize) :
+	mCellSize	(cellSize),
+	mTimestamp	(0xffffffff),
+	mUseCounter	(0)
+{
+}
+
+TouchedGeomCache::~TouchedGeomCache()
+{
+	releaseCells();
+}
+
+void TouchedGeomCache::releaseCells()
+{
+	for(CellMap::Iterator iter = mCells.getIterator(); !iter.done(); ++iter)
+		PX_DELETE(iter->second);
+	mCells.clear();
+}
+
+void TouchedGeomCache::invalidate()
+{
+	Ps::Mutex::ScopedLock lock(mLock);
+	releaseCells();
+}
+
+void TouchedGeomCache::evictOldestCell()
+{
+	const CellKey* oldestKey = NULL;
+	PxU32 oldestUse = 0xffffffff;
+	for(CellMap::Iterator iter = mCells.getIterator(); !iter.done(); ++iter)
+	{
+		if(iter->second->mLastUse<oldestUse)
+		{
+			oldestUse = iter->second->mLastUse;
+			oldestKey = &iter->first;
+		}
+	}
+
+	if(oldestKey)
+	{
+		const CellKey key = *oldestKey;
+		PX_DELETE(mCells[key]);
+		mCells.erase(key);
+	}
+}
+
+// Copies the geoms of the cell, keeping only the triangles touching the bounds so the sweeps don't test the whole cell
+void TouchedGeomCache::copyStaticGeometry(const Cell& cell, const PxExtendedBounds3& worldBounds, TriArray& worldTriangles, IntArray& triIndicesArray, IntArray& geomStream) const
+{
+	const PxU32* data = cell.mGeomStream.begin();
+	const PxU32* last = cell.mGeomStream.end();
+	while(data!=last)
+	{
+		const TouchedGeom* currentGeom = reinterpret_cast<const TouchedGeom*>(data);
+		const PxU32 nbWords = GeomSizes[currentGeom->mType]/sizeof(PxU32);
+
+		PxU32* dst = reserveContainerMemory(geomStream, nbWords);
+		PxMemCopy(dst, data, nbWords*sizeof(PxU32));
+
+		if(currentGeom->mType==TouchedGeomType::eMESH)
+		{
+			const TouchedMesh* srcMesh = static_cast<const TouchedMesh*>(currentGeom);
+			TouchedMesh* dstMesh = reinterpret_cast<TouchedMesh*>(dst);
+
+			// triangles are relative to the mesh offset
+			const PxBounds3 localBounds(worldBounds.minimum - srcMesh->mOffset, worldBounds.maximum - srcMesh->mOffset);
+
+			const PxTriangle* tris = cell.mWorldTriangles.begin() + srcMesh->mIndexWorldTriangles;
+			const PxU32* indices = cell.mTriangleIndices.begin() + srcMesh->mIndexWorldTriangles;
+			const PxU32 nbTris = srcMesh->mNbTris;
+
+			dstMesh->mIndexWorldTriangles = worldTriangles.size();
+			PxU32 nbKept = 0;
+			for(PxU32 i=0;i<nbTris;i++)
+			{
+				PxBounds3 triBounds = PxBounds3::boundsOfPoints(tris[i].verts[0], tris[i].verts[1]);
+				triBounds.include(tris[i].verts[2]);
+				if(!triBounds.intersects(localBounds))
+					continue;
+
+				worldTriangles.pushBack(tris[i]);
+				triIndicesArray.pushBack(indices[i]);
+				nbKept++;
+			}
+
+			if(nbKept)
+				dstMesh->mNbTris = nbKept;
+			else
+				geomStream.forceSize_Unsafe(geomStream.size() - nbWords);
+		}
+
+		data += nbWords;
+	}
+}
+
+bool TouchedGeomCache::fetchStaticGeometry(	const InternalCBData_FindTouchedGeom* userData, const PxExtendedBounds3& worldBounds,
+											TriArray& worldTriangles, IntArray& triIndicesArray, IntArray& geomStream,
+											const CCTFilter& filter, const CCTParams& params, PxU16& nbTessellation)
+{
+	// filter callbacks can give different answers to each controller, so they can't share
+	if(!filter.mStaticShapes || filter.mDynamicShapes || filter.mFilterCallback)
+		return false;
+
+	PxExtendedVec3 center;
+	getCenter(worldBounds, center);
+
+	CellKey key;
+	key.mX = PxI32(PxFloor(PxF32(center.x/mCellSize)));
+	key.mY = PxI32(PxFloor(PxF32(center.y/mCellSize)));
+	key.mZ = PxI32(PxFloor(PxF32(center.z/mCellSize)));
+
+	const PxExtended margin = PxExtended(mCellSize*0.5f);
+	PxExtendedBounds3 cellBounds;
+	cellBounds.minimum = PxExtendedVec3(PxExtended(key.mX)*mCellSize - margin, PxExtended(key.mY)*mCellSize - margin, PxExtended(key.mZ)*mCellSize - margin);
+	cellBounds.maximum = PxExtendedVec3(PxExtended(key.mX+1)*mCellSize + margin, PxExtended(key.mY+1)*mCellSize + margin, PxExtended(key.mZ+1)*mCellSize + margin);
+	if(!worldBounds.isInside(cellBounds))
+		return false;
+
+	key.mHasFilterData = filter.mFilterData!=NULL;
+	key.mFilterData[0] = filter.mFilterData ? filter.mFilterData->word0 : 0;
+	key.mFilterData[1] = filter.mFilterData ? filter.mFilterData->word1 : 0;
+	key.mFilterData[2] = filter.mFilterData ? filter.mFilterData->word2 : 0;
+	key.mFilterData[3] = filter.mFilterData ? filter.mFilterData->word3 : 0;
+	key.mTessellation = params.mTessellation;
+	key.mMaxEdgeLength2 = params.mMaxEdgeLength2;
+	key.mInvisibleWallHeight = params.mInvisibleWallHeight;
+	key.mSlopeLimit = params.mSlopeLimit;
+	key.mUpDirection = params.mUpDirection;
+
+	const PxU32 timestamp = getSceneTimestamp(userData);
+	{
+		Ps::Mutex::ScopedLock lock(mLock);
+		if(timestamp!=mTimestamp)
+		{
+			releaseCells();
+			mTimestamp = timestamp;
 		}
+
+		if(const CellMap::Entry* entry = mCells.find(key))
+		{
+			entry->second->mLastUse = mUseCounter++;
+			copyStaticGeometry(*entry->second, worldBounds, worldTriangles, triIndicesArray, geomStream);
+			return true;
+		}
+	}
+
+	// built without the lock so that controllers in other cells don't wait, two threads can build the same cell
+	Cell* cell = PX_NEW(Cell);
+	findTouchedGeometry(userData, cellBounds, cell->mWorldTriangles, cell->mTriangleIndices, cell->mGeomStream, filter, params, nbTessellation);
+
+	Ps::Mutex::ScopedLock lock(mLock);
+	const CellMap::Entry* entry = timestamp==mTimestamp ? mCells.find(key) : NULL;
+	if(entry)
+	{
+		PX_DELETE(cell);
+		cell = entry->second;
 	}
+	else if(timestamp==mTimestamp)
+	{
+		if(mCells.size()>=gMaxSharedCells)
+			evictOldestCell();
+		mCells.insert(key, cell);
+	}
+
+	cell->mLastUse = mUseCounter++;
+	copyStaticGeometry(*cell, worldBounds, worldTriangles, triIndicesArray, geomStream);
+
+	// the scene changed while building, the cell is only used this once
+	if(timestamp!=mTimestamp)
+		PX_DELETE(cell);
+	return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SweepTest::updateTouchedGeoms(	const InternalCBData_FindTouchedGeom* userData, const UserObstacles& userObstacles,
 									const PxExtendedBounds3& worldTemporalBox, const PxControllerFilters& filters, const PxVec3& sideVector)
 {
@@ -1240,6 +1881,7 @@ void SweepTest::updateTouchedGeoms(	const InternalCBData_FindTouchedGeom* userDa
 			mGeomStream.forceSize_Unsafe(mNbCachedStatic);
 			mWorldTriangles.forceSize_Unsafe(mNbCachedT);
 			mTriangleIndices.forceSize_Unsafe(mNbCachedT);			
+			mNbBlockTriangles = PxMin(mNbBlockTriangles, mNbCachedT);
 
 			filter.mStaticShapes	= false;
 			if(filters.mFilterFlags & PxQueryFlag::eDYNAMIC)
@@ -1289,6 +1931,7 @@ void SweepTest::updateTouchedGeoms(	const InternalCBData_FindTouchedGeom* userDa
 		mWorldTriangles.clear();
 		mTriangleIndices.clear();
 		mGeomStream.clear();
+		mNbBlockTriangles = 0;
 //		mWorldTriangles.reset();
 //		mTriangleIndices.reset();
 //		mGeomStream.reset();
@@ -1301,7 +1944,9 @@ void SweepTest::updateTouchedGeoms(	const InternalCBData_FindTouchedGeom* userDa
 		if(filters.mFilterFlags & PxQueryFlag::eSTATIC)
 			filter.mStaticShapes	= true;
 		filter.mDynamicShapes	= false;
-		findTouchedGeometry(userData, mCacheBounds, mWorldTriangles, mTriangleIndices, mGeomStream, filter, mUserParams, mNbTessellation);
+		TouchedGeomCache* sharedCache = mCctManager ? mCctManager->mTouchedGeomCache : NULL;
+		if(!sharedCache || !sharedCache->fetchStaticGeometry(userData, mCacheBounds, mWorldTriangles, mTriangleIndices, mGeomStream, filter, mUserParams, mNbTessellation))
+			findTouchedGeometry(userData, mCacheBounds, mWorldTriangles, mTriangleIndices, mGeomStream, filter, mUserParams, mNbTessellation);
 
 		mNbCachedStatic = mGeomStream.size();
 		mNbCachedT = mWorldTriangles.size();
@@ -1970,6 +2615,8 @@ PxControllerCollisionFlags SweepTest::moveCharacter(
 #include "PxScene.h"
 #include "PxControllerBehavior.h"
 #include "CctObstacleContext.h"
+#include "PxShape.h"
+#include "PxGeometryQuery.h"
 
 	// PT: we use a local class instead of making "Controller" a PxQueryFilterCallback, since it would waste more memory.
 	// Ideally we'd have a C-style callback and a user-data pointer, instead of being forced to create a class.
@@ -2213,12 +2860,166 @@ bool Controller::rideOnTouchedObject(SweptVolume& volume, const PxVec3& upDirect
 	return standingOnMoving;
 }
 
+// returns true if this move should use the simplified level of detail. The hysteresis keeps controllers near the
+// limit from switching every frame.
+bool Controller::updateLodMode()
+{
+	const PxU32 nbFocusPoints = mManager->mLodFocusPoints.size();
+	if(!nbFocusPoints)
+	{
+		mSimplified = false;
+		return false;
+	}
+
+	PxExtended minDist2 = PX_MAX_EXTENDED;
+	const PxVec3* focusPoints = mManager->mLodFocusPoints.begin();
+	for(PxU32 i=0;i<nbFocusPoints;i++)
+	{
+		const PxExtendedVec3 focusPoint(PxExtended(focusPoints[i].x), PxExtended(focusPoints[i].y), PxExtended(focusPoints[i].z));
+		minDist2 = PxMin(minDist2, mPosition.distanceSquared(focusPoint));
+	}
+
+	const PxExtended limit = PxExtended(mManager->mLodFullDistance) * (mSimplified ? 1.0 : 1.1);
+	mSimplified = minDist2 > limit*limit;
+	return mSimplified;
+}
+
+// the simplified move applies the displacement at once, pushes the controller out of the geometry it overlaps in the
+// plane orthogonal to the up direction, then snaps it to the ground with a single raycast.
+PxControllerCollisionFlags Controller::moveSimplified(SweptVolume& volume, const PxVec3& disp, const PxControllerFilters& filters, const PxObstacleContext* obstacleContext, bool lockProxy)
+{
+	PX_PROFILE_ZONE("CharacterController.moveSimplified", getContextId());
+
+	const PxVec3& upDirection = mUserParams.mUpDirection;
+	PxControllerCollisionFlags collisionFlags = PxControllerCollisionFlags(0);
+
+	// touched objects are not tracked in this mode, the full move looks for them again when the controller switches back
+	mCctModule.mTouchedShape = NULL;
+	mCctModule.mTouchedActor = NULL;
+	mCctModule.mTouchedObstacleHandle = INVALID_OBSTACLE_HANDLE;
+	mCachedStandingOnMoving = false;
+	mDeltaXP = PxVec3(0.0f);
+
+	const PxExtendedVec3 backup = volume.mCenter;
+	volume.mCenter += disp;
+
+	ControllerFilter preFilter;
+	preFilter.mShapeHashSet			= &mManager->mCCTShapes;
+	preFilter.mUserFilterCallback	= filters.mFilterCallback;
+	preFilter.mUserFilterFlags		= filters.mFilterFlags;
+
+	PxQueryFlags filterFlags = (filters.mFilterFlags & (PxQueryFlag::eSTATIC|PxQueryFlag::eDYNAMIC|PxQueryFlag::ePOSTFILTER)) | PxQueryFlag::ePREFILTER;
+	const PxFilterData filterData = filters.mFilterData ? *filters.mFilterData : PxFilterData();
+
+	// 1) Pushout. Walkable penetrations are left to the ground snap.
+	{
+		PxGeometryHolder geom;
+		if(volume.getType()==SweptVolumeType::eCAPSULE)
+		{
+			const SweptCapsule& sc = static_cast<const SweptCapsule&>(volume);
+			geom.storeAny(PxCapsuleGeometry(sc.mRadius, sc.mHeight*0.5f));
+		}
+		else
+		{
+			PX_ASSERT(volume.getType()==SweptVolumeType::eBOX);
+			const SweptBox& sb = static_cast<const SweptBox&>(volume);
+			geom.storeAny(PxBoxGeometry(sb.mExtents));
+		}
+		const PxTransform pose(toVec3(volume.mCenter), mUserParams.mQuatFromUp);	// ### LOSS OF ACCURACY
+
+		PxOverlapHit hits[8];
+		PxOverlapBuffer overlapBuffer(hits, 8);
+		if(mScene->overlap(geom.any(), pose, overlapBuffer, PxQueryFilterData(filterData, filterFlags|PxQueryFlag::eNO_BLOCK), &preFilter))
+		{
+			const PxF32 walkableLimit = mUserParams.mHandleSlope ? mUserParams.mSlopeLimit : 0.5f;
+
+			PxVec3 pushout(0.0f);
+			const PxU32 nbHits = overlapBuffer.getNbTouches();
+			for(PxU32 i=0;i<nbHits;i++)
+			{
+				const PxOverlapHit& hit = overlapBuffer.getTouch(i);
+
+				PxVec3 dir;
+				PxF32 depth;
+				if(!PxGeometryQuery::computePenetration(dir, depth, geom.any(), pose, hit.shape->getGeometry().any(), getShapeGlobalPose(*hit.shape, *hit.actor)))
+					continue;
+
+				if(dir.dot(upDirection)>=walkableLimit)
+					continue;
+
+				PxVec3 normalCompo, tangentCompo;
+				Ps::decomposeVector(normalCompo, tangentCompo, dir*depth, upDirection);
+				pushout += tangentCompo;
+				collisionFlags |= PxControllerCollisionFlag::eCOLLISION_SIDES;
+			}
+			volume.mCenter += pushout;
+		}
+	}
+
+	// 2) Ground snap, skipped when moving up. The ray starts one step offset above the controller and covers the fall, and
+	// the ground is searched up to one step offset below the feet.
+	const PxF32 upMotion = disp.dot(upDirection);
+	if(upMotion<=0.0f)
+	{
+		const PxF32 halfHeight = getHalfHeightInternal();
+		const PxF32 stepOffset = mUserParams.mStepOffset;
+		const PxF32 contactOffset = mUserParams.mContactOffset;
+		const PxF32 rise = stepOffset - upMotion;
+		const PxVec3 rayOrigin = toVec3(volume.mCenter) + upDirection*rise;	// ### LOSS OF ACCURACY
+		const PxF32 rayLength = rise + halfHeight + contactOffset + stepOffset;
+
+		PxRaycastBuffer hit;
+		PxF32 hitDistance = PX_MAX_F32;
+		if(mScene->raycast(rayOrigin, -upDirection, rayLength, hit, PxHitFlag::eDISTANCE, PxQueryFilterData(filterData, filterFlags), &preFilter) && hit.hasBlock)
+			hitDistance = hit.block.distance;
+
+		if(obstacleContext)
+		{
+			const ObstacleContext* obstacles = static_cast<const ObstacleContext*>(obstacleContext);
+			PxRaycastHit obstacleHit;
+			ObstacleHandle obstacleHandle;
+			if(obstacles->raycastSingle(obstacleHit, rayOrigin, -upDirection, rayLength, obstacleHandle) && obstacleHit.distance<hitDistance)
+				hitDistance = obstacleHit.distance;
+		}
+
+		if(hitDistance<=rayLength)
+		{
+			volume.mCenter += upDirection*(rise - (hitDistance - halfHeight - contactOffset));
+			collisionFlags |= PxControllerCollisionFlag::eCOLLISION_DOWN;
+		}
+	}
+
+	mCollisionFlags = collisionFlags;
+
+	// Copy results back
+	mPosition = volume.mCenter;
+
+	// Update kinematic actor
+	if(mKineActor)
+	{
+		const PxVec3 delta = backup - volume.mCenter;
+		if(delta.magnitudeSquared()!=0.0f)
+		{
+			PxTransform targetPose = mKineActor->getGlobalPose();
+			targetPose.p = toVec3(mPosition);
+			targetPose.q = mUserParams.mQuatFromUp;
+			setProxyTarget(targetPose, lockProxy);
+		}
+	}
+
+	return collisionFlags;
+}
+
 PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& originalDisp, PxF32 minDist, PxF32 elapsedTime, const PxControllerFilters& filters, const PxObstacleContext* obstacleContext, bool constrainedClimbingMode)
 {
 	const bool lockWrite = mManager->mLockingEnabled;
 	if(lockWrite)
 		mWriteLock.lock();	
 
+	// controllers of other groups are moved on other threads during a batch. They can't reach this one (see moveControllers)
+	// so they're skipped, which also avoids reading their positions while they change.
+	const PxU32 batchGroup = mBatchGroup;
+
 	mGlobalTime += PxF64(elapsedTime);
 
 	// Init CCT with per-controller settings
@@ -2242,6 +3043,14 @@ PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& o
 	PxVec3 disp = originalDisp + mOverlapRecover;
 	mOverlapRecover = PxVec3(0.0f);
 
+	if(updateLodMode())
+	{
+		const PxControllerCollisionFlags simplifiedFlags = moveSimplified(volume, disp, filters, obstacleContext, lockWrite);
+		if(lockWrite)
+			mWriteLock.unlock();
+		return simplifiedFlags;
+	}
+
 	bool standingOnMoving = false;	// PT: whether the CCT is currently standing on a moving object
 	//printf("Touched shape: %d\n", int(mCctModule.mTouchedShape));
 //standingOnMoving=true;
@@ -2311,10 +3120,10 @@ PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& o
 //	printf("standingOnMoving: %d\n", standingOnMoving);
 
 	///////////
-	Ps::Array<const void*>&			boxUserData		= mManager->mBoxUserData;
-	Ps::Array<PxExtendedBox>&		boxes			= mManager->mBoxes;
-	Ps::Array<const void*>&			capsuleUserData	= mManager->mCapsuleUserData;
-	Ps::Array<PxExtendedCapsule>&	capsules		= mManager->mCapsules;
+	Ps::Array<const void*>&			boxUserData		= mBoxUserData;
+	Ps::Array<PxExtendedBox>&		boxes			= mBoxes;
+	Ps::Array<const void*>&			capsuleUserData	= mCapsuleUserData;
+	Ps::Array<PxExtendedCapsule>&	capsules		= mCapsules;
 	PX_ASSERT(!boxUserData.size());
 	PX_ASSERT(!boxes.size());
 	PX_ASSERT(!capsuleUserData.size());
@@ -2333,6 +3142,9 @@ PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& o
 			if(currentController==this)
 				continue;
 
+			if(batchGroup!=CCT_NO_BATCH_GROUP && currentController->mBatchGroup!=CCT_NO_BATCH_GROUP && currentController->mBatchGroup!=batchGroup)
+				continue;
+
 			bool keepController = true;
 			if(filters.mCCTFilterCallback)
 				keepController = filters.mCCTFilterCallback->filter(*getPxController(), *currentController->getPxController());
@@ -2384,55 +3196,24 @@ PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& o
 	{
 		obstacles = static_cast<const ObstacleContext*>(obstacleContext);
 
-		// PT: TODO: optimize this
-		const PxU32 nbExtraBoxes = obstacles->mBoxObstacles.size();
-		for(PxU32 i=0;i<nbExtraBoxes;i++)
+		// the obstacles themselves are found through the tree of the context, in findTouchedObstacles
+		if(renderBuffer && (debugRenderFlags & PxControllerDebugRenderFlag::eOBSTACLES))
 		{
-			const PxBoxObstacle& userBoxObstacle = obstacles->mBoxObstacles[i].mData;
+			RenderOutput out(*renderBuffer);
+			out << gObstacleDebugColor;
 
-			PxExtendedBox extraBox;
-			extraBox.center		= userBoxObstacle.mPos;
-			extraBox.extents	= userBoxObstacle.mHalfExtents;
-			extraBox.rot		= userBoxObstacle.mRot;
-			boxes.pushBack(extraBox);
-
-			const size_t code = encodeUserObject(i, USER_OBJECT_BOX_OBSTACLE);
-			boxUserData.pushBack(reinterpret_cast<const void*>(code));
-
-			if(renderBuffer && (debugRenderFlags & PxControllerDebugRenderFlag::eOBSTACLES))
+			const PxU32 nbExtraBoxes = obstacles->mBoxObstacles.size();
+			for(PxU32 i=0;i<nbExtraBoxes;i++)
 			{
-				RenderOutput out(*renderBuffer);
-				out << gObstacleDebugColor;
-
+				const PxBoxObstacle& userBoxObstacle = obstacles->mBoxObstacles[i].mData;
 				out << PxTransform(toVec3(userBoxObstacle.mPos), userBoxObstacle.mRot);
-
 				out << DebugBox(userBoxObstacle.mHalfExtents, true);
 			}
-		}
-
-		const PxU32 nbExtraCapsules = obstacles->mCapsuleObstacles.size();
-		for(PxU32 i=0;i<nbExtraCapsules;i++)
-		{
-			const PxCapsuleObstacle& userCapsuleObstacle = obstacles->mCapsuleObstacles[i].mData;
-
-			PxExtendedCapsule extraCapsule;
-			const PxVec3 capsuleAxis = userCapsuleObstacle.mRot.getBasisVector0() * userCapsuleObstacle.mHalfHeight;
-			extraCapsule.p0		= PxExtendedVec3(	userCapsuleObstacle.mPos.x - PxExtended(capsuleAxis.x),
-													userCapsuleObstacle.mPos.y - PxExtended(capsuleAxis.y),
-													userCapsuleObstacle.mPos.z - PxExtended(capsuleAxis.z));
-			extraCapsule.p1		= PxExtendedVec3(	userCapsuleObstacle.mPos.x + PxExtended(capsuleAxis.x),
-													userCapsuleObstacle.mPos.y + PxExtended(capsuleAxis.y),
-													userCapsuleObstacle.mPos.z + PxExtended(capsuleAxis.z));
 
-			extraCapsule.radius	= userCapsuleObstacle.mRadius;
-			capsules.pushBack(extraCapsule);
-			const size_t code = encodeUserObject(i, USER_OBJECT_CAPSULE_OBSTACLE);
-			capsuleUserData.pushBack(reinterpret_cast<const void*>(code));
-
-			if(renderBuffer && (debugRenderFlags & PxControllerDebugRenderFlag::eOBSTACLES))
+			const PxU32 nbExtraCapsules = obstacles->mCapsuleObstacles.size();
+			for(PxU32 i=0;i<nbExtraCapsules;i++)
 			{
-				RenderOutput out(*renderBuffer);
-				out << gObstacleDebugColor;
+				const PxCapsuleObstacle& userCapsuleObstacle = obstacles->mCapsuleObstacles[i].mData;
 				out.outputCapsule(userCapsuleObstacle.mRadius, userCapsuleObstacle.mHalfHeight, PxTransform(toVec3(userCapsuleObstacle.mPos), userCapsuleObstacle.mRot));
 			}
 		}
@@ -2450,6 +3231,7 @@ PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& o
 	userObstacles.mNbCapsules		= nbCapsules;
 	userObstacles.mCapsules			= nbCapsules ? capsules.begin() : NULL;
 	userObstacles.mCapsuleUserData	= nbCapsules ? capsuleUserData.begin() : NULL;
+	userObstacles.mObstacleContext	= obstacles;
 
 	PxInternalCBData_OnHit userHitData;
 	userHitData.controller	= this;
@@ -2508,11 +3290,13 @@ PxControllerCollisionFlags Controller::move(SweptVolume& volume, const PxVec3& o
 			PxTransform targetPose = mKineActor->getGlobalPose();
 			targetPose.p = toVec3(mPosition);
 			targetPose.q = mUserParams.mQuatFromUp;
-			mKineActor->setKinematicTarget(targetPose);
+
+			// deferred during a batch, other controllers may be running scene queries on other threads
+			setProxyTarget(targetPose, lockWrite);
 		}
 	}
 
-	mManager->resetObstaclesBuffers();
+	resetObstaclesBuffers();
 
 	if (lockWrite)
 		mWriteLock.unlock();
@@ -39,6 +39,8 @@
 #include "PxTriangle.h"
 #include "PsArray.h"
 #include "PsHashSet.h"
+#include "PsAlignedMalloc.h"
+#include "geometry/PxGeometryHelpers.h"
 #include "CmPhysXCommon.h"
 
 namespace physx
@@ -55,6 +57,8 @@ namespace Cm
 
 namespace Cct
 {	    
+	class ObstacleContext;
+
 	struct CCTParams
 	{
 											CCTParams();
@@ -262,6 +266,8 @@ namespace Cct
 		PxU32						mNbCapsules;
 		const PxExtendedCapsule*	mCapsules;
 		const void**				mCapsuleUserData;
+
+		const ObstacleContext*		mObstacleContext;	// Obstacles from the context are found through its tree, not from the arrays above
 	};
 
 	struct InternalCBData_OnHit{};
@@ -374,11 +380,37 @@ namespace Cct
 					TriArray			mWorldTriangles;
 					IntArray			mTriangleIndices;
 					IntArray			mGeomStream;
+					IntArray			mTouchedObstacleRefs;
 					PxExtendedBounds3	mCacheBounds;
 					PxU32				mCachedTriIndexIndex;
 					mutable	PxU32		mCachedTriIndex[3];
 					PxU32				mNbCachedStatic;
 					PxU32				mNbCachedT;
+		// SoA copy of mWorldTriangles, 4 triangles per block, used to cull triangles before the capsule sweeps.
+		// It is built on demand and kept as long as the cached triangles don't change.
+		typedef Ps::Array<PxF32, Ps::AlignedAllocator<16> >	TriangleBlockArray;
+		mutable	TriangleBlockArray	mTriangleBlocks;
+		mutable	PxU32				mNbBlockTriangles;		// Number of triangles already copied to mTriangleBlocks
+		mutable	TriArray			mCulledTriangles;		// Triangles kept by the culling...
+		mutable	IntArray			mCulledTriangleIndices;	// ...and their indices in the mesh
+					void				updateTriangleBlocks()	const;
+		// penetration results of the overlap recovery module, one per touched shape. A result is reused as long as
+		// the volume and the shape keep the same pose and geometry, which is typical for characters pushing against a wall.
+		struct CachedMTD
+		{
+			const PxShape*		mShape;
+			PxTransform			mShapePose;
+			PxGeometryHolder	mShapeGeometry;
+			PxTransform			mVolumePose;
+			PxVec3				mVolumeExtents;		// Radius and half-height for capsules, extents for boxes, inflated by the contact offset
+			PxU32				mVolumeType;
+			PxVec3				mMTD;
+			PxF32				mDepth;
+			bool				mIsValid;
+		};
+		typedef Ps::Array<CachedMTD>	CachedMTDArray;
+		mutable	CachedMTDArray		mCachedMTDs;		// Results of the last call to the recovery module...
+		mutable	CachedMTDArray		mNewCachedMTDs;		// ...and the ones being computed by the current call
 	public:
 #ifdef USE_CONTACT_NORMAL_FOR_SLOPE_TEST
 					PxVec3				mContactNormalDownPass;
@@ -470,6 +502,67 @@ namespace Cct
 		const CCTParams& params,
 		PxU16& nbTessellation);
 
+	// static geometry gathered once per cell of a grid and shared by all the controllers of a manager. Controllers whose
+	// cached bounds fit in a cell copy the triangles touching their bounds from it, instead of each querying the scene and
+	// transforming the same triangles again. Cells are queried with a margin of half a cell around them.
+	class TouchedGeomCache : public Ps::UserAllocated
+	{
+		public:
+										TouchedGeomCache(PxF32 cellSize);
+										~TouchedGeomCache();
+
+		// Returns false if the bounds or the filter can't use the cache, nothing is output then
+					bool				fetchStaticGeometry(const InternalCBData_FindTouchedGeom* userData, const PxExtendedBounds3& worldBounds,
+															TriArray& worldTriangles, IntArray& triIndicesArray, IntArray& geomStream,
+															const CCTFilter& filter, const CCTParams& params, PxU16& nbTessellation);
+					void				invalidate();
+
+		PX_FORCE_INLINE	PxF32			getCellSize()	const	{ return mCellSize;	}
+
+		private:
+		// Everything the static geometry of a cell depends on
+		struct CellKey
+		{
+			PxI32	mX, mY, mZ;
+			PxU32	mFilterData[4];
+			bool	mHasFilterData;
+			bool	mTessellation;
+			PxF32	mMaxEdgeLength2;
+			PxF32	mInvisibleWallHeight;
+			PxF32	mSlopeLimit;
+			PxVec3	mUpDirection;
+
+			bool	operator==(const CellKey& other)	const;
+		};
+
+		struct CellKeyHash
+		{
+			PxU32	operator()(const CellKey& key)	const;
+			bool	equal(const CellKey& key0, const CellKey& key1)	const	{ return key0==key1;	}
+		};
+
+		struct Cell : public Ps::UserAllocated
+		{
+			TriArray	mWorldTriangles;
+			IntArray	mTriangleIndices;
+			IntArray	mGeomStream;
+			PxU32		mLastUse;
+		};
+
+		typedef Ps::HashMap<CellKey, Cell*, CellKeyHash>	CellMap;
+
+					void				copyStaticGeometry(const Cell& cell, const PxExtendedBounds3& worldBounds,
+															TriArray& worldTriangles, IntArray& triIndicesArray, IntArray& geomStream)	const;
+					void				releaseCells();
+					void				evictOldestCell();
+
+					PxF32				mCellSize;
+					PxU32				mTimestamp;	// Scene query static timestamp the cells were built with
+					PxU32				mUseCounter;
+					CellMap				mCells;
+					Ps::Mutex			mLock;		// Controllers can be moved from several threads
+	};
+
 	PxU32 shapeHitCallback(const InternalCBData_OnHit* userData, const SweptContact& contact, const PxVec3& dir, PxF32 length);
 	PxU32 userHitCallback(const InternalCBData_OnHit* userData, const SweptContact& contact, const PxVec3& dir, PxF32 length);
 
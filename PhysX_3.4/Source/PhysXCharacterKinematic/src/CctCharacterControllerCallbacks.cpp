@@ -196,22 +196,21 @@ static void tessellateTriangle(PxU32& nbNewTris, const TrianglePadded& tr, PxU32
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void outputPlaneToStream(PxShape* planeShape, const PxRigidActor* actor, const PxTransform& globalPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
-								const PxExtendedVec3& origin, const PxBounds3& tmpBounds, const CCTParams& params, RenderBuffer* renderBuffer)
+static void outputPlaneToStream(PxShape* planeShape, const PxRigidActor* actor, const PxTransform& localPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
+								const PxExtendedVec3& origin, const PxBounds3& localBounds, const CCTParams& params, RenderBuffer* renderBuffer)
 {
 	PX_ASSERT(planeShape->getGeometryType() == PxGeometryType::ePLANE);
 
-	const PxF32 length = (tmpBounds.maximum - tmpBounds.minimum).magnitude();
-	PxVec3 center = toVec3(origin);
+	const PxF32 length = (localBounds.maximum - localBounds.minimum).magnitude();
 
-	const PxPlane plane = PxPlaneEquationFromTransform(globalPose);
+	const PxPlane plane = PxPlaneEquationFromTransform(localPose);
 
 	PxVec3 right, up;
 	Ps::computeBasis(plane.n, right, up);
 	right *= length;
 	up *= length;
 
-	const PxVec3 p = plane.project(center);
+	const PxVec3 p = plane.project(PxVec3(0.0f));
 	const PxVec3 p0 = p - right + up;
 	const PxVec3 p1 = p - right - up;
 	const PxVec3 p2 = p + right - up;
@@ -235,13 +234,13 @@ static void outputPlaneToStream(PxShape* planeShape, const PxRigidActor* actor,
 	triIndicesArray.pushBack(0);
 	triIndicesArray.pushBack(1);
 
-	TouchedTriangles[0].verts[0] = p0 + offset;
-	TouchedTriangles[0].verts[1] = p1 + offset;
-	TouchedTriangles[0].verts[2] = p2 + offset;
+	TouchedTriangles[0].verts[0] = p0;
+	TouchedTriangles[0].verts[1] = p1;
+	TouchedTriangles[0].verts[2] = p2;
 
-	TouchedTriangles[1].verts[0] = p0 + offset;
-	TouchedTriangles[1].verts[1] = p2 + offset;
-	TouchedTriangles[1].verts[2] = p3 + offset;
+	TouchedTriangles[1].verts[0] = p0;
+	TouchedTriangles[1].verts[1] = p2;
+	TouchedTriangles[1].verts[2] = p3;
 
 	if(gVisualizeTouchedTris)
 		visualizeTouchedTriangles(touchedMesh->mNbTris, touchedMesh->mIndexWorldTriangles, worldTriangles.begin(), renderBuffer, offset, params.mUpDirection);
@@ -312,8 +311,8 @@ static void outputCapsuleToStream(PxShape* capsuleShape, const PxRigidActor* act
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void outputBoxToStream(	PxShape* boxShape, const PxRigidActor* actor, const PxTransform& globalPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
-								const PxExtendedVec3& origin, const PxBounds3& tmpBounds, const CCTParams& params, PxU16& nbTessellation)
+static void outputBoxToStream(	PxShape* boxShape, const PxRigidActor* actor, const PxTransform& localPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
+								const PxExtendedVec3& origin, const PxBounds3& localBounds, const CCTParams& params, PxU16& nbTessellation)
 {
 	PX_ASSERT(boxShape->getGeometryType() == PxGeometryType::eBOX);
 	PxBoxGeometry bg;
@@ -334,11 +333,10 @@ static void outputBoxToStream(	PxShape* boxShape, const PxRigidActor* actor, con
 		PxVec3(+dx,+dy,+dz),
 		PxVec3(-dx,+dy,+dz)
 	};
-	//Transform verts into world space.
-	const PxVec3 pxOrigin = toVec3(origin);
+	//Transform verts into the local space of the touched geometry.
 	for(PxU32 i = 0; i < 8; i++)
 	{
-		boxVerts[i] = globalPose.transform(boxVerts[i]) - pxOrigin;
+		boxVerts[i] = localPose.transform(boxVerts[i]);
 	}
 
 	//Index of triangles.
@@ -372,9 +370,7 @@ static void outputBoxToStream(	PxShape* boxShape, const PxRigidActor* actor, con
 
 	if(params.mTessellation)
 	{
-		const PxBoxGeometry boxGeom(tmpBounds.getExtents());
-		const PxVec3 offset(float(-origin.x), float(-origin.y), float(-origin.z));
-		const PxBounds3 cullingBox = PxBounds3::centerExtents(tmpBounds.getCenter() + offset, boxGeom.halfExtents);
+		const PxBounds3& cullingBox = localBounds;
 
 		PxU32 nbCreatedTris = 0;
 		for(PxU32 i=0; i<12; i++)
@@ -484,8 +480,8 @@ static PxU32 createInvisibleWalls(const CCTParams& params, const PxTriangle& cur
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, const PxTransform& meshPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
-								const PxExtendedVec3& origin, const PxBounds3& tmpBounds, const CCTParams& params, RenderBuffer* renderBuffer, PxU16& nbTessellation)
+static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, const PxTransform& localPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
+								const PxExtendedVec3& origin, const PxBounds3& localBounds, const CCTParams& params, RenderBuffer* renderBuffer, PxU16& nbTessellation)
 {
 	PX_ASSERT(meshShape->getGeometryType() == PxGeometryType::eTRIANGLEMESH);
 	// Do AABB-mesh query
@@ -493,12 +489,13 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 	PxTriangleMeshGeometry triGeom;
 	meshShape->getTriangleMeshGeometry(triGeom);
 
-	const PxBoxGeometry boxGeom(tmpBounds.getExtents());
-	const PxTransform boxPose(tmpBounds.getCenter(), PxQuat(PxIdentity));
+	// the query runs in the local space of the touched geometry, so that triangles come out directly relative to the origin
+	const PxBoxGeometry boxGeom(localBounds.getExtents());
+	const PxTransform boxPose(localBounds.getCenter(), PxQuat(PxIdentity));
 
 	// Collide AABB against current mesh
 	PxMeshOverlapUtil overlapUtil;
-	const PxU32 nbTouchedTris = overlapUtil.findOverlap(boxGeom, boxPose, triGeom, meshPose);
+	const PxU32 nbTouchedTris = overlapUtil.findOverlap(boxGeom, boxPose, triGeom, localPose);
 
 	const PxVec3 offset(float(-origin.x), float(-origin.y), float(-origin.z));
 
@@ -524,10 +521,7 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 
 				// Compute triangle in world space, add to array
 				TrianglePadded currentTriangle;
-				PxMeshQuery::getTriangle(triGeom, meshPose, triangleIndex, currentTriangle);
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
+				PxMeshQuery::getTriangle(triGeom, localPose, triangleIndex, currentTriangle);
 
 				const PxU32 nbNewTris = createInvisibleWalls(params, currentTriangle, worldTriangles, triIndicesArray);
 				nbCreatedTris += nbNewTris;
@@ -543,7 +537,7 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 		}
 		else
 		{
-			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p + offset, boxGeom.halfExtents);
+			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p, boxGeom.halfExtents);
 
 			// Loop through touched triangles
 			PxU32 nbCreatedTris = 0;
@@ -553,10 +547,7 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 
 				// Compute triangle in world space, add to array
 				TrianglePadded currentTriangle;
-				PxMeshQuery::getTriangle(triGeom, meshPose, triangleIndex, currentTriangle);
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
+				PxMeshQuery::getTriangle(triGeom, localPose, triangleIndex, currentTriangle);
 
 				PxU32 nbNewTris = createInvisibleWalls(params, currentTriangle, worldTriangles, triIndicesArray);
 				nbCreatedTris += nbNewTris;
@@ -588,17 +579,14 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 
 				// Compute triangle in world space, add to array
 				PxTriangle& currentTriangle = *TouchedTriangles++;
-				PxMeshQuery::getTriangle(triGeom, meshPose, triangleIndex, currentTriangle);
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
+				PxMeshQuery::getTriangle(triGeom, localPose, triangleIndex, currentTriangle);
 
 				triIndicesArray.pushBack(triangleIndex);
 			}
 		}
 		else
 		{
-			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p + offset, boxGeom.halfExtents);
+			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p, boxGeom.halfExtents);
 
 			PxU32 nbCreatedTris = 0;
 			for(PxU32 i=0; i < nbTouchedTris; i++)
@@ -607,11 +595,8 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 
 				// Compute triangle in world space, add to array
 				TrianglePadded currentTriangle;
-				PxMeshQuery::getTriangle(triGeom, meshPose, triangleIndex, currentTriangle);
+				PxMeshQuery::getTriangle(triGeom, localPose, triangleIndex, currentTriangle);
 
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
 
 				PxU32 nbNewTris = 0;
 				tessellateTriangle(nbNewTris, currentTriangle, triangleIndex, worldTriangles, triIndicesArray, cullingBox, params, nbTessellation);
@@ -628,8 +613,8 @@ static void outputMeshToStream(	PxShape* meshShape, const PxRigidActor* actor, c
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* actor, const PxTransform& heightfieldPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
-										const PxExtendedVec3& origin, const PxBounds3& tmpBounds, const CCTParams& params, RenderBuffer* renderBuffer, PxU16& nbTessellation)
+static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* actor, const PxTransform& localPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
+										const PxExtendedVec3& origin, const PxBounds3& localBounds, const CCTParams& params, RenderBuffer* renderBuffer, PxU16& nbTessellation)
 {
 	PX_ASSERT(hfShape->getGeometryType() == PxGeometryType::eHEIGHTFIELD);
 	// Do AABB-mesh query
@@ -637,12 +622,13 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 	PxHeightFieldGeometry hfGeom;
 	hfShape->getHeightFieldGeometry(hfGeom);
 
-	const PxBoxGeometry boxGeom(tmpBounds.getExtents());
-	const PxTransform boxPose(tmpBounds.getCenter(), PxQuat(PxIdentity));
+	// the query runs in the local space of the touched geometry, so that triangles come out directly relative to the origin
+	const PxBoxGeometry boxGeom(localBounds.getExtents());
+	const PxTransform boxPose(localBounds.getCenter(), PxQuat(PxIdentity));
 
 	// Collide AABB against current heightfield
 	PxMeshOverlapUtil overlapUtil;
-	const PxU32 nbTouchedTris = overlapUtil.findOverlap(boxGeom, boxPose, hfGeom, heightfieldPose);
+	const PxU32 nbTouchedTris = overlapUtil.findOverlap(boxGeom, boxPose, hfGeom, localPose);
 
 	const PxVec3 offset(float(-origin.x), float(-origin.y), float(-origin.z));
 
@@ -668,10 +654,7 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 
 				// Compute triangle in world space, add to array
 				TrianglePadded currentTriangle;
-				PxMeshQuery::getTriangle(hfGeom, heightfieldPose, triangleIndex, currentTriangle);
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
+				PxMeshQuery::getTriangle(hfGeom, localPose, triangleIndex, currentTriangle);
 
 				const PxU32 nbNewTris = createInvisibleWalls(params, currentTriangle, worldTriangles, triIndicesArray);
 				nbCreatedTris += nbNewTris;
@@ -687,7 +670,7 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 		}
 		else
 		{
-			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p + offset, boxGeom.halfExtents);
+			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p, boxGeom.halfExtents);
 
 			// Loop through touched triangles
 			PxU32 nbCreatedTris = 0;
@@ -697,10 +680,7 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 
 				// Compute triangle in world space, add to array
 				TrianglePadded currentTriangle;
-				PxMeshQuery::getTriangle(hfGeom, heightfieldPose, triangleIndex, currentTriangle);
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
+				PxMeshQuery::getTriangle(hfGeom, localPose, triangleIndex, currentTriangle);
 
 				PxU32 nbNewTris = createInvisibleWalls(params, currentTriangle, worldTriangles, triIndicesArray);
 				nbCreatedTris += nbNewTris;
@@ -728,17 +708,14 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 
 				// Compute triangle in world space, add to array
 				PxTriangle& currentTriangle = *TouchedTriangles++;
-				PxMeshQuery::getTriangle(hfGeom, heightfieldPose, triangleIndex, currentTriangle);
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
+				PxMeshQuery::getTriangle(hfGeom, localPose, triangleIndex, currentTriangle);
 
 				triIndicesArray.pushBack(triangleIndex);
 			}
 		}
 		else
 		{
-			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p + offset, boxGeom.halfExtents);
+			const PxBounds3 cullingBox = PxBounds3::centerExtents(boxPose.p, boxGeom.halfExtents);
 
 			PxU32 nbCreatedTris = 0;
 			for(PxU32 i=0; i < nbTouchedTris; i++)
@@ -747,11 +724,8 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 
 				// Compute triangle in world space, add to array
 				TrianglePadded currentTriangle;
-				PxMeshQuery::getTriangle(hfGeom, heightfieldPose, triangleIndex, currentTriangle);
+				PxMeshQuery::getTriangle(hfGeom, localPose, triangleIndex, currentTriangle);
 
-				currentTriangle.verts[0] += offset;
-				currentTriangle.verts[1] += offset;
-				currentTriangle.verts[2] += offset;
 
 				PxU32 nbNewTris = 0;
 				tessellateTriangle(nbNewTris, currentTriangle, triangleIndex, worldTriangles, triIndicesArray, cullingBox, params, nbTessellation);
@@ -768,8 +742,8 @@ static void outputHeightFieldToStream(	PxShape* hfShape, const PxRigidActor* act
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void outputConvexToStream(PxShape* convexShape, const PxRigidActor* actor, const PxTransform& absPose_, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
-								 const PxExtendedVec3& origin, const PxBounds3& tmpBounds, const CCTParams& params, RenderBuffer* renderBuffer, PxU16& nbTessellation)
+static void outputConvexToStream(PxShape* convexShape, const PxRigidActor* actor, const PxTransform& localPose, IntArray& geomStream, TriArray& worldTriangles, IntArray& triIndicesArray,
+								 const PxExtendedVec3& origin, const PxBounds3& localBounds, const CCTParams& params, RenderBuffer* renderBuffer, PxU16& nbTessellation)
 {
 	PX_ASSERT(convexShape->getGeometryType() == PxGeometryType::eCONVEXMESH);
 	PxConvexMeshGeometry cg;
@@ -824,13 +798,10 @@ static void outputConvexToStream(PxShape* convexShape, const PxRigidActor* actor
 	}
 
 	// PT: you can't use PxTransform with a non-uniform scaling
-	const PxMat33 rot = PxMat33(absPose_.q) * cg.scale.toMat33();
-	const PxMat44 absPose(rot, absPose_.p);
+	const PxMat33 rot = PxMat33(localPose.q) * cg.scale.toMat33();
+	const PxMat44 absPose(rot, localPose.p);
 
-	const PxVec3 absPosTmp = absPose.getPosition();
-    const PxExtendedVec3 absPos(PxExtended(absPosTmp.x), PxExtended(absPosTmp.y), PxExtended(absPosTmp.z));
-    
-    const PxVec3 MeshOffset(absPos - origin);	// LOSS OF ACCURACY
+	const PxVec3 MeshOffset = localPose.p;
 
 	const PxVec3 offset(float(-origin.x), float(-origin.y), float(-origin.z));
 
@@ -845,8 +816,7 @@ static void outputConvexToStream(PxShape* convexShape, const PxRigidActor* actor
 	// Loop through touched triangles
 	if(params.mTessellation)
 	{
-		const PxBoxGeometry boxGeom(tmpBounds.getExtents());
-		const PxBounds3 cullingBox = PxBounds3::centerExtents(tmpBounds.getCenter() + offset, boxGeom.halfExtents);
+		const PxBounds3& cullingBox = localBounds;
 
 		PxU32 nbCreatedTris = 0;
 		while(Nb--)
@@ -951,6 +921,11 @@ void Cct::findTouchedGeometry(
 	const PxVec3 center = tmpBounds.getCenter();
 	const PxVec3 extents = tmpBounds.getExtents();
 
+	// same bounds relative to the origin (their center), for the touched geometry
+	PxVec3 localExtents;
+	getExtents(worldBounds, localExtents);
+	const PxBounds3 localBounds(-localExtents, localExtents);
+
 	const PxU32 size = 100;
 	PxOverlapHit hits[size];
 
@@ -984,14 +959,19 @@ void Cct::findTouchedGeometry(
 		// Output shape to stream
 		const PxTransform globalPose = getShapeGlobalPose(*shape, *actor);
 
+		// triangles are computed directly relative to the origin, from the shape pose relative to it, instead of being computed
+		// in world space and moved back. Far away from the world origin this is where most of the accuracy was lost.
+		const PxExtendedVec3 shapePos(PxExtended(globalPose.p.x), PxExtended(globalPose.p.y), PxExtended(globalPose.p.z));
+		const PxTransform localPose(toLocal(shapePos, Origin), globalPose.q);
+
 		const PxGeometryType::Enum type = shape->getGeometryType();	// ### VIRTUAL!
 		if(type==PxGeometryType::eSPHERE)				outputSphereToStream		(shape, actor, globalPose, geomStream, Origin);
 		else	if(type==PxGeometryType::eCAPSULE)		outputCapsuleToStream		(shape, actor, globalPose, geomStream, Origin);
-		else	if(type==PxGeometryType::eBOX)			outputBoxToStream			(shape, actor, globalPose, geomStream, worldTriangles, triIndicesArray, Origin, tmpBounds, params, nbTessellation);
-		else	if(type==PxGeometryType::eTRIANGLEMESH)	outputMeshToStream			(shape, actor, globalPose, geomStream, worldTriangles, triIndicesArray, Origin, tmpBounds, params, renderBuffer, nbTessellation);
-		else	if(type==PxGeometryType::eHEIGHTFIELD)	outputHeightFieldToStream	(shape, actor, globalPose, geomStream, worldTriangles, triIndicesArray, Origin, tmpBounds, params, renderBuffer, nbTessellation);
-		else	if(type==PxGeometryType::eCONVEXMESH)	outputConvexToStream		(shape, actor, globalPose, geomStream, worldTriangles, triIndicesArray, Origin, tmpBounds, params, renderBuffer, nbTessellation);
-		else	if(type==PxGeometryType::ePLANE)		outputPlaneToStream			(shape, actor, globalPose, geomStream, worldTriangles, triIndicesArray, Origin, tmpBounds, params, renderBuffer);
+		else	if(type==PxGeometryType::eBOX)			outputBoxToStream			(shape, actor, localPose, geomStream, worldTriangles, triIndicesArray, Origin, localBounds, params, nbTessellation);
+		else	if(type==PxGeometryType::eTRIANGLEMESH)	outputMeshToStream			(shape, actor, localPose, geomStream, worldTriangles, triIndicesArray, Origin, localBounds, params, renderBuffer, nbTessellation);
+		else	if(type==PxGeometryType::eHEIGHTFIELD)	outputHeightFieldToStream	(shape, actor, localPose, geomStream, worldTriangles, triIndicesArray, Origin, localBounds, params, renderBuffer, nbTessellation);
+		else	if(type==PxGeometryType::eCONVEXMESH)	outputConvexToStream		(shape, actor, localPose, geomStream, worldTriangles, triIndicesArray, Origin, localBounds, params, renderBuffer, nbTessellation);
+		else	if(type==PxGeometryType::ePLANE)		outputPlaneToStream			(shape, actor, localPose, geomStream, worldTriangles, triIndicesArray, Origin, localBounds, params, renderBuffer);
 	}
 }
 
@@ -40,11 +40,25 @@
 #include "PxScene.h"
 #include "PxPhysics.h"
 #include "PsFoundation.h"
+#include "CmParallelFor.h"
+#include "foundation/PxMemory.h"
 
 using namespace physx;
 using namespace Cct;
 
 static const PxF32 gMaxOverlapRecover = 4.0f;	// PT: TODO: expose this
+static const PxU32 gInteractionPairsPerTask = 64;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static PX_FORCE_INLINE Controller* getInternalController(PxController* controller)
+{
+	if(controller->getType()==PxControllerShapeType::eCAPSULE)
+		return static_cast<CapsuleController*>(controller);
+
+	PX_ASSERT(controller->getType()==PxControllerShapeType::eBOX);
+	return static_cast<BoxController*>(controller);
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -57,7 +71,9 @@ CharacterControllerManager::CharacterControllerManager(PxScene& scene, bool lock
 	mOverlapRecovery						(true),
 	mPreciseSweeps							(true),
 	mPreventVerticalSlidingAgainstCeiling	(false),
-	mLockingEnabled							(lockingEnabled)
+	mLockingEnabled							(lockingEnabled),
+	mTouchedGeomCache						(NULL),
+	mLodFullDistance						(0.0f)
 {
 	// PT: register ourself as a deletion listener, to be called by the SDK whenever an object is deleted	
 	PxPhysics& physics = scene.getPhysics();
@@ -71,6 +87,8 @@ CharacterControllerManager::~CharacterControllerManager()
 		delete mRenderBuffer;
 		mRenderBuffer = 0;
 	}
+
+	PX_DELETE(mTouchedGeomCache);
 }
 
 void CharacterControllerManager::release() 
@@ -221,6 +239,11 @@ void CharacterControllerManager::onRelease(const PxBase* observed, void* , PxDel
 		observed->getConcreteType()==PxConcreteType::eSHAPE))
 		return;
 
+	// shared cells can reference shapes no controller touches right now, so they are not registered. Flushing the
+	// whole cache is fine since static objects are rarely released.
+	if(mTouchedGeomCache && observed->getConcreteType()!=PxConcreteType::eRIGID_DYNAMIC)
+		mTouchedGeomCache->invalidate();
+
 	// check if object was registered
 	if(mLockingEnabled)
 		mWriteLock.lock();
@@ -330,30 +353,6 @@ void CharacterControllerManager::onObstacleAdded(ObstacleHandle index, const PxO
 }
 
 
-// PT: TODO: move to array class?
-template <class T> 
-void resetOrClear(T& a)
-{
-	const PxU32 c = a.capacity();
-	if(!c)
-		return;
-	const PxU32 s = a.size();
-	if(s>c/2)
-		a.clear();
-	else
-		a.reset();
-}
-
-void CharacterControllerManager::resetObstaclesBuffers()
-{
-	resetOrClear(mBoxUserData);
-	resetOrClear(mBoxes);
-	resetOrClear(mCapsuleUserData);
-	resetOrClear(mCapsules);
-}
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
 void CharacterControllerManager::setTessellation(bool flag, float maxEdgeLength)
 {
 	mTessellation = flag;
@@ -383,6 +382,37 @@ void CharacterControllerManager::setPreventVerticalSlidingAgainstCeiling(bool fl
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void CharacterControllerManager::setSharedGeometryCache(bool flag, PxF32 cellSize)
+{
+	if(flag && cellSize<=0.0f)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "PxControllerManager::setSharedGeometryCache(): cell size must be positive");
+		return;
+	}
+
+	if(mTouchedGeomCache && (!flag || mTouchedGeomCache->getCellSize()!=cellSize))
+		PX_DELETE_AND_RESET(mTouchedGeomCache);
+
+	if(flag && !mTouchedGeomCache)
+		mTouchedGeomCache = PX_NEW(TouchedGeomCache)(cellSize);
+}
+
+void CharacterControllerManager::setLodFocusPoints(const PxVec3* points, PxU32 nbPoints, PxF32 fullDistance)
+{
+	if(nbPoints && (!points || !(fullDistance>=0.0f)))
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "PxControllerManager::setLodFocusPoints(): invalid parameters");
+		return;
+	}
+
+	mLodFocusPoints.clear();
+	for(PxU32 i=0;i<nbPoints;i++)
+		mLodFocusPoints.pushBack(points[i]);
+	mLodFullDistance = fullDistance;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void CharacterControllerManager::shiftOrigin(const PxVec3& shift)
 {
 	for(PxU32 i=0; i < mControllers.size(); i++)
@@ -395,12 +425,14 @@ void CharacterControllerManager::shiftOrigin(const PxVec3& shift)
 		mObstacleContexts[i]->onOriginShift(shift);
 	}
 
+	for(PxU32 i=0; i < mLodFocusPoints.size(); i++)
+		mLodFocusPoints[i] -= shift;
+
+	if(mTouchedGeomCache)
+		mTouchedGeomCache->invalidate();
+
 	if (mRenderBuffer)
 		mRenderBuffer->shift(-shift);
-
-	// assumption is that these are just used for temporary stuff
-	PX_ASSERT(!mBoxes.size());
-	PX_ASSERT(!mCapsules.size());
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -492,7 +524,8 @@ static PxVec3 fixDir(const PxVec3& dir, const PxVec3& up)
 	return tangentCompo.getNormalized();
 }
 
-static void InteractionCharacterCharacter(Controller* entity0, Controller* entity1, PxF32 elapsedTime)
+// returns the separation to add to the overlap recovery of entity0, and to subtract from the one of entity1. Only reads the controllers.
+static PxVec3 InteractionCharacterCharacter(Controller* entity0, Controller* entity1, PxF32 elapsedTime)
 {
 	PX_ASSERT(entity0);
 	PX_ASSERT(entity1);
@@ -500,9 +533,13 @@ static void InteractionCharacterCharacter(Controller* entity0, Controller* entit
 	PxF32 overlap=0.0f;
 	PxVec3 dir(0.0f);
 
-	if(entity0->mType>entity1->mType)
+	const bool swapped = entity0->mType>entity1->mType;
+	if(swapped)
 		Ps::swap(entity0, entity1);
 
+	// the tests run relative to the first controller, the results don't depend on the origin
+	const PxExtendedVec3 origin = entity0->mPosition;
+
 	if(entity0->mType==PxControllerShapeType::eCAPSULE && entity1->mType==PxControllerShapeType::eCAPSULE)
 	{
 		CapsuleController* cc0 = static_cast<CapsuleController*>(entity0);
@@ -516,10 +553,10 @@ static void InteractionCharacterCharacter(Controller* entity0, Controller* entit
 
 		const PxF32 r = capsule0.radius + capsule1.radius;
 
-		const PxVec3 p00 = toVec3(capsule0.p0);
-		const PxVec3 p01 = toVec3(capsule0.p1);
-		const PxVec3 p10 = toVec3(capsule1.p0);
-		const PxVec3 p11 = toVec3(capsule1.p1);
+		const PxVec3 p00 = toLocal(capsule0.p0, origin);
+		const PxVec3 p01 = toLocal(capsule0.p1, origin);
+		const PxVec3 p10 = toLocal(capsule1.p0, origin);
+		const PxVec3 p11 = toLocal(capsule1.p1, origin);
 
 		PxF32 s,t;
 		const PxF32 d = sqrtf(Gu::distanceSegmentSegmentSquared(p00, p01 - p00, p10, p11 - p10, &s, &t));
@@ -542,13 +579,13 @@ static void InteractionCharacterCharacter(Controller* entity0, Controller* entit
 
 		PxExtendedCapsule capsule;
 		cc1->getCapsule(capsule);
-		const PxVec3 p0 = toVec3(capsule.p0);
-		const PxVec3 p1 = toVec3(capsule.p1);
+		const PxVec3 p0 = toLocal(capsule.p0, origin);
+		const PxVec3 p1 = toLocal(capsule.p1, origin);
 
 		PxF32 t;
 		PxVec3 p;
 		const PxMat33 M(obb.rot);
-		const PxVec3 boxCenter = toVec3(obb.center);
+		const PxVec3 boxCenter = toLocal(obb.center, origin);
 		const PxF32 d = sqrtf(Gu::distanceSegmentBoxSquared(p0, p1, boxCenter, obb.extents, M, &t, &p));
 		if(d<capsule.radius)
 		{
@@ -574,14 +611,15 @@ static void InteractionCharacterCharacter(Controller* entity0, Controller* entit
 		PxExtendedBox obb1;
 		cc1->getOBB(obb1);
 
+		const PxVec3 center0 = toLocal(obb0.center, origin);
+		const PxVec3 center1 = toLocal(obb1.center, origin);
+
 		PxVec3 mtd;
 		PxF32 depth;
 		if(computeMTD(	mtd, depth,
-						obb0.extents, toVec3(obb0.center), PxMat33(obb0.rot),
-						obb1.extents, toVec3(obb1.center), PxMat33(obb1.rot)))
+						obb0.extents, center0, PxMat33(obb0.rot),
+						obb1.extents, center1, PxMat33(obb1.rot)))
 		{
-			const PxVec3 center0 = toVec3(obb0.center);
-			const PxVec3 center1 = toVec3(obb1.center);
 			const PxVec3 witness = center0 - center1;
 			if(mtd.dot(witness)<0.0f)
 				dir = -mtd;
@@ -601,9 +639,63 @@ static void InteractionCharacterCharacter(Controller* entity0, Controller* entit
 			overlap=maxOverlap;
 
 		const PxVec3 sep = dir * overlap * 0.5f;
-		entity0->mOverlapRecover += sep;
-		entity1->mOverlapRecover -= sep;
+		return swapped ? -sep : sep;
+	}
+	return PxVec3(0.0f);
+}
+
+namespace
+{
+	struct InteractionContext
+	{
+		Controller**	mControllers;
+		const PxU32*	mPairs;
+		PxVec3*			mSeparations;
+		PxF32			mElapsedTime;
+	};
+
+	struct BatchContext
+	{
+		PxControllerMove*	mMoves;
+		const PxU32*		mOrder;
+		const PxU32*		mGroupStarts;
+		PxF32				mElapsedTime;
+	};
+}
+
+static void computeInteractionChunk(void* context, PxU32 start, PxU32 nb)
+{
+	const InteractionContext& ic = *reinterpret_cast<const InteractionContext*>(context);
+
+	for(PxU32 i=start;i<start+nb;i++)
+		ic.mSeparations[i] = InteractionCharacterCharacter(ic.mControllers[ic.mPairs[i*2+0]], ic.mControllers[ic.mPairs[i*2+1]], ic.mElapsedTime);
+}
+
+static void moveController(PxControllerMove& move, PxF32 elapsedTime)
+{
+	PX_ASSERT(move.controller);
+
+	const PxControllerFilters defaultFilters;
+	move.collisionFlags = move.controller->move(move.disp, move.minDist, elapsedTime, move.filters ? *move.filters : defaultFilters, move.obstacles);
+}
+
+static void moveBatchGroups(void* context, PxU32 start, PxU32 nb)
+{
+	const BatchContext& bc = *reinterpret_cast<const BatchContext*>(context);
+
+	const PxU32 end = bc.mGroupStarts[start+nb];
+	for(PxU32 i=bc.mGroupStarts[start];i<end;i++)
+		moveController(bc.mMoves[bc.mOrder[i]], bc.mElapsedTime);
+}
+
+static PX_FORCE_INLINE PxU32 findBatchRoot(PxU32* parents, PxU32 i)
+{
+	while(parents[i]!=i)
+	{
+		parents[i] = parents[parents[i]];
+		i = parents[i];
 	}
+	return i;
 }
 
 void CharacterControllerManager::computeInteractions(PxF32 elapsedTime, PxControllerFilterCallback* cctFilterCb)
@@ -611,9 +703,13 @@ void CharacterControllerManager::computeInteractions(PxF32 elapsedTime, PxContro
 	PxU32 nbControllers = mControllers.size();
 	Controller** controllers = mControllers.begin();
 
-	PxBounds3* boxes = reinterpret_cast<PxBounds3*>(PX_ALLOC_TEMP(sizeof(PxBounds3)*nbControllers, "CharacterControllerManager::computeInteractions"));	// PT: TODO: get rid of alloc
+	// the bounds & pairs buffers are kept from one call to the next to avoid per-frame allocations
+	mInteractionBounds.resizeUninitialized(nbControllers);
+	PxBounds3* boxes = mInteractionBounds.begin();
 	PxBounds3* runningBoxes = boxes;
 
+	// bounds are relative to the first controller, so that the pruning stays accurate far away from the world origin
+	const PxExtendedVec3 origin = nbControllers ? controllers[0]->mPosition : PxExtendedVec3(0, 0, 0);
 	while(nbControllers--)
 	{
 		Controller* current = *controllers++;
@@ -621,34 +717,175 @@ void CharacterControllerManager::computeInteractions(PxF32 elapsedTime, PxContro
 		PxExtendedBounds3 extBox;
 		current->getWorldBox(extBox);
 
-		*runningBoxes++ = PxBounds3(toVec3(extBox.minimum), toVec3(extBox.maximum));	// ### LOSS OF ACCURACY
+		*runningBoxes++ = PxBounds3(toLocal(extBox.minimum, origin), toLocal(extBox.maximum, origin));
 	}
 
 	//
 
 	const PxU32 nbEntities = PxU32(runningBoxes - boxes);
 
-	Ps::Array<PxU32> pairs;	// PT: TODO: get rid of alloc
-	Cm::CompleteBoxPruning(boxes, nbEntities, pairs, Gu::Axes(physx::Gu::AXES_XZY));	// PT: TODO: revisit for variable up axis
+	Ps::Array<PxU32>& pairs = mInteractionPairs;
+	Cm::CompleteBoxPruning(boxes, nbEntities, pairs, Gu::Axes(physx::Gu::AXES_XZY), mInteractionSorter, mInteractionPosList);	// TODO: revisit for variable up axis
 
+	// the user callback is only called from this thread. Kept pairs are compacted in place.
 	PxU32 nbPairs = pairs.size()>>1;
+	PxU32* indices = pairs.begin();
+	if(cctFilterCb)
+	{
+		PxU32 nbKept = 0;
+		for(PxU32 i=0;i<nbPairs;i++)
+		{
+			const PxU32 index0 = indices[i*2+0];
+			const PxU32 index1 = indices[i*2+1];
+			if(cctFilterCb->filter(*mControllers[index0]->getPxController(), *mControllers[index1]->getPxController()))
+			{
+				indices[nbKept*2+0] = index0;
+				indices[nbKept*2+1] = index1;
+				nbKept++;
+			}
+		}
+		nbPairs = nbKept;
+	}
+
+	if(!nbPairs)
+		return;
+
+	// separations are computed independently for each pair, in parallel for large crowds. They're then accumulated
+	// in pair order, so the results don't depend on the number of threads.
+	mInteractionSeparations.resizeUninitialized(nbPairs);
+
+	InteractionContext context;
+	context.mControllers	= mControllers.begin();
+	context.mPairs			= indices;
+	context.mSeparations	= mInteractionSeparations.begin();
+	context.mElapsedTime	= elapsedTime;
+
+	Cm::blockingParallelFor(mScene.getCpuDispatcher(), nbPairs, gInteractionPairsPerTask, gInteractionPairsPerTask, computeInteractionChunk, &context, "CharacterControllerManager.computeInteractions");
+
+	const PxVec3* separations = mInteractionSeparations.begin();
+	for(PxU32 i=0;i<nbPairs;i++)
+	{
+		mControllers[indices[i*2+0]]->mOverlapRecover += separations[i];
+		mControllers[indices[i*2+1]]->mOverlapRecover -= separations[i];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CharacterControllerManager::moveControllers(PxControllerMove* moves, PxU32 nbMoves, PxF32 elapsedTime)
+{
+	if(!nbMoves)
+		return;
+
+	// the render buffer is shared by all controllers, so debug rendering forces a serial batch
+	PxCpuDispatcher* dispatcher = mScene.getCpuDispatcher();
+	if(nbMoves==1 || !dispatcher || !dispatcher->getWorkerCount() || mDebugRenderingFlags)
+	{
+		for(PxU32 i=0;i<nbMoves;i++)
+			moveController(moves[i], elapsedTime);
+		return;
+	}
+
+	// 1) Bounds of the volume each controller can reach during its move. Sliding can redirect the motion and the stepping
+	// code moves along the up axis, so the motion is applied in all directions. The motion of the touched object is only
+	// known from the previous move. The world box of capsules assumes a Y up axis, so a cube is used for any up direction.
+	mInteractionBounds.resizeUninitialized(nbMoves);
+	PxBounds3* bounds = mInteractionBounds.begin();
+	const PxExtendedVec3 origin = getInternalController(moves[0].controller)->mPosition;	// bounds are relative to the first controller
+	for(PxU32 i=0;i<nbMoves;i++)
+	{
+		Controller* ctrl = getInternalController(moves[i].controller);
+		PX_ASSERT(ctrl->getCctManager()==this);
+
+		PxExtendedBounds3 worldBox;
+		ctrl->getWorldBox(worldBox);
+
+		PxExtendedVec3 center;
+		getCenter(worldBox, center);
+		PxVec3 extents;
+		getExtents(worldBox, extents);
+
+		const PxVec3 motion = moves[i].disp + ctrl->mOverlapRecover + ctrl->mDeltaXP * elapsedTime;
+		const PxF32 halfSize = extents.maxElement() + ctrl->mUserParams.mContactOffset + ctrl->mUserParams.mStepOffset + motion.magnitude();
+		bounds[i] = PxBounds3::centerExtents(toLocal(center, origin), PxVec3(halfSize));
+	}
+
+	Ps::Array<PxU32>& pairs = mInteractionPairs;
+	Cm::CompleteBoxPruning(bounds, nbMoves, pairs, Gu::Axes(physx::Gu::AXES_XZY), mInteractionSorter, mInteractionPosList);
+
+	// 2) Group the controllers whose volumes overlap. Roots are the first move of each group, so groups are numbered
+	// in the order of the batch.
+	mBatchGroups.resizeUninitialized(nbMoves);
+	PxU32* groups = mBatchGroups.begin();
+	for(PxU32 i=0;i<nbMoves;i++)
+		groups[i] = i;
+
+	const PxU32 nbPairs = pairs.size()>>1;
 	const PxU32* indices = pairs.begin();
-	while(nbPairs--)
+	for(PxU32 i=0;i<nbPairs;i++)
 	{
-		const PxU32 index0 = *indices++;
-		const PxU32 index1 = *indices++;
-		Controller* ctrl0 = mControllers[index0];
-		Controller* ctrl1 = mControllers[index1];
+		const PxU32 root0 = findBatchRoot(groups, indices[i*2+0]);
+		const PxU32 root1 = findBatchRoot(groups, indices[i*2+1]);
+		if(root0<root1)
+			groups[root1] = root0;
+		else if(root1<root0)
+			groups[root0] = root1;
+	}
 
-		bool keep=true;
-		if(cctFilterCb)
-			keep = cctFilterCb->filter(*ctrl0->getPxController(), *ctrl1->getPxController());
+	for(PxU32 i=0;i<nbMoves;i++)
+		groups[i] = findBatchRoot(groups, i);
 
-		if(keep)
-			InteractionCharacterCharacter(ctrl0, ctrl1, elapsedTime);
+	PxU32 nbGroups = 0;
+	for(PxU32 i=0;i<nbMoves;i++)
+	{
+		Controller* ctrl = getInternalController(moves[i].controller);
+		if(groups[i]==i)
+			ctrl->mBatchGroup = nbGroups++;
+		else
+			ctrl->mBatchGroup = getInternalController(moves[groups[i]].controller)->mBatchGroup;
 	}
 
-	PX_FREE(boxes);
+	if(nbGroups>1)
+	{
+		// 3) Sort the moves by group, keeping the order of the batch within each group
+		mBatchGroupStarts.resize(nbGroups+1);
+		PxU32* starts = mBatchGroupStarts.begin();
+		PxMemZero(starts, sizeof(PxU32)*(nbGroups+1));
+		for(PxU32 i=0;i<nbMoves;i++)
+			starts[getInternalController(moves[i].controller)->mBatchGroup+1]++;
+		for(PxU32 i=0;i<nbGroups;i++)
+			starts[i+1] += starts[i];
+
+		// the group ids are read from the controllers, the group buffer is reused for the running offsets
+		PxMemCopy(groups, starts, sizeof(PxU32)*nbGroups);
+		mBatchOrder.resizeUninitialized(nbMoves);
+		PxU32* order = mBatchOrder.begin();
+		for(PxU32 i=0;i<nbMoves;i++)
+			order[groups[getInternalController(moves[i].controller)->mBatchGroup]++] = i;
+
+		BatchContext context;
+		context.mMoves			= moves;
+		context.mOrder			= order;
+		context.mGroupStarts	= starts;
+		context.mElapsedTime	= elapsedTime;
+
+		Cm::blockingParallelFor(dispatcher, nbGroups, 1, 1, moveBatchGroups, &context, "CharacterControllerManager.moveControllers");
+	}
+
+	// the scene queries of the batch are done, the kinematic targets recorded by the moves can be written now
+	for(PxU32 i=0;i<nbMoves;i++)
+	{
+		Controller* ctrl = getInternalController(moves[i].controller);
+		ctrl->mBatchGroup = CCT_NO_BATCH_GROUP;
+		ctrl->flushProxyTarget();
+	}
+
+	// a single group is just a serial batch
+	if(nbGroups==1)
+	{
+		for(PxU32 i=0;i<nbMoves;i++)
+			moveController(moves[i], elapsedTime);
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
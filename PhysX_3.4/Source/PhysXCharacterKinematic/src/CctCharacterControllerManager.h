@@ -38,6 +38,7 @@
 #include "PxMeshQuery.h"
 #include "PxDeletionListener.h"
 #include "CmRenderOutput.h"
+#include "CmRadixSortBuffered.h"
 #include "CctUtils.h"
 #include "PsHashSet.h"
 #include "PsHashMap.h"
@@ -49,6 +50,7 @@ namespace Cct
 {
 	class Controller;
 	class ObstacleContext;
+	class TouchedGeomCache;
 
 	struct ObservedRefCounter
 	{
@@ -82,10 +84,13 @@ namespace Cct
 		virtual			PxObstacleContext*				getObstacleContext(PxU32 index);
 		virtual			PxObstacleContext*				createObstacleContext();
 		virtual			void							computeInteractions(PxF32 elapsedTime, PxControllerFilterCallback* cctFilterCb);
+		virtual			void							moveControllers(PxControllerMove* moves, PxU32 nbMoves, PxF32 elapsedTime);
 		virtual			void							setTessellation(bool flag, float maxEdgeLength);
 		virtual			void							setOverlapRecoveryModule(bool flag);
 		virtual			void							setPreciseSweeps(bool flag);
 		virtual			void							setPreventVerticalSlidingAgainstCeiling(bool flag);
+		virtual			void							setSharedGeometryCache(bool flag, PxF32 cellSize);
+		virtual			void							setLodFocusPoints(const PxVec3* points, PxU32 nbPoints, PxF32 fullDistance);
 		virtual			void							shiftOrigin(const PxVec3& shift);		
 		//~PxControllerManager
 
@@ -103,21 +108,21 @@ namespace Cct
 						void							releaseController(PxController& controller);
 						Controller**					getControllers();
 						void							releaseObstacleContext(ObstacleContext& oc);
-						void							resetObstaclesBuffers();
 
 						PxScene&						mScene;
 
 						Cm::RenderBuffer*				mRenderBuffer;
 						PxControllerDebugRenderFlags	mDebugRenderingFlags;
-		// Shared buffers for obstacles
-						Ps::Array<const void*>			mBoxUserData;
-						Ps::Array<PxExtendedBox>		mBoxes;
-
-						Ps::Array<const void*>			mCapsuleUserData;
-						Ps::Array<PxExtendedCapsule>	mCapsules;
-
 						Ps::Array<Controller*>			mControllers;
 						Ps::HashSet<PxShape*>			mCCTShapes;
+						Ps::Array<PxBounds3>			mInteractionBounds;	// Scratch buffers for computeInteractions and moveControllers
+						Ps::Array<PxU32>				mInteractionPairs;
+						Ps::Array<float>				mInteractionPosList;
+						Cm::RadixSortBuffered			mInteractionSorter;
+						Ps::Array<PxVec3>				mInteractionSeparations;
+						Ps::Array<PxU32>				mBatchGroups;		// Scratch buffers for moveControllers
+						Ps::Array<PxU32>				mBatchOrder;
+						Ps::Array<PxU32>				mBatchGroupStarts;
 
 						Ps::Array<ObstacleContext*>		mObstacleContexts;
 
@@ -130,6 +135,14 @@ namespace Cct
 
 						bool							mLockingEnabled;						
 
+						TouchedGeomCache*				mTouchedGeomCache;	// Static geometry shared by the controllers, NULL when disabled
+
+						Ps::Array<PxVec3>				mLodFocusPoints;	// Controllers far from all of them use the simplified move
+						PxF32							mLodFullDistance;
+
+		// Serializes the kinematic proxy updates of controllers moved from different threads
+						Ps::Mutex						mProxyLock;
+
 	protected:
 		CharacterControllerManager &operator=(const CharacterControllerManager &);
 		CharacterControllerManager(const CharacterControllerManager& );
@@ -82,6 +82,10 @@ Controller::Controller(const PxControllerDesc& desc, PxScene* s) :
 
 	mDeltaXP							= PxVec3(0);
 	mOverlapRecover						= PxVec3(0);	
+	mBatchGroup							= CCT_NO_BATCH_GROUP;
+	mSimplified							= false;
+	mHasPendingProxyTarget				= false;
+	mPendingProxyTarget					= PxTransform(PxIdentity);
 
 	mUserParams.mUpDirection = PxVec3(0.0f);
 	setUpDirectionInternal(desc.upDirection);
@@ -105,9 +109,65 @@ void Controller::onRelease(const PxBase& observed)
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// TODO: move to array class?
+template <class T> 
+static void resetOrClear(T& a)
+{
+	const PxU32 c = a.capacity();
+	if(!c)
+		return;
+	const PxU32 s = a.size();
+	if(s>c/2)
+		a.clear();
+	else
+		a.reset();
+}
+
+void Controller::resetObstaclesBuffers()
+{
+	resetOrClear(mBoxUserData);
+	resetOrClear(mBoxes);
+	resetOrClear(mCapsuleUserData);
+	resetOrClear(mCapsules);
+}
+
+void Controller::setProxyTarget(const PxTransform& targetPose, bool lockProxy)
+{
+	// controllers of other groups run scene queries on other threads during a batch, so the scene can't be written
+	// until the whole batch is done. The target is recorded and set by moveControllers() then, see flushProxyTarget().
+	if(mBatchGroup!=CCT_NO_BATCH_GROUP)
+	{
+		mPendingProxyTarget = targetPose;
+		mHasPendingProxyTarget = true;
+		return;
+	}
+
+	if(lockProxy)
+		mManager->mProxyLock.lock();
+	mKineActor->setKinematicTarget(targetPose);
+	if(lockProxy)
+		mManager->mProxyLock.unlock();
+}
+
+void Controller::flushProxyTarget()
+{
+	if(!mHasPendingProxyTarget)
+		return;
+
+	mHasPendingProxyTarget = false;
+	if(mKineActor)
+		mKineActor->setKinematicTarget(mPendingProxyTarget);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void Controller::onOriginShift(const PxVec3& shift)
 {
 	mPosition -= shift;
+
+	// assumption is that these are just used for temporary stuff
+	PX_ASSERT(!mBoxes.size());
+	PX_ASSERT(!mCapsules.size());
 	
 	if(mManager && mManager->mLockingEnabled)
 		mWriteLock.lock();
@@ -162,6 +222,7 @@ void Controller::getInternalState(PxControllerState& state) const
 	state.standOnAnotherCCT		= (mCctModule.mFlags & STF_TOUCH_OTHER_CCT)!=0;
 	state.standOnObstacle		= (mCctModule.mFlags & STF_TOUCH_OBSTACLE)!=0;
 	state.isMovingUp			= (mCctModule.mFlags & STF_IS_MOVING_UP)!=0;
+	state.isSimplified			= mSimplified;
 	state.collisionFlags		= mCollisionFlags;
 
 	if(mManager->mLockingEnabled)
@@ -50,6 +50,8 @@ namespace Cct
 {
 	class CharacterControllerManager;
 
+	#define CCT_NO_BATCH_GROUP	0xffffffff
+
 	class Controller : public Ps::UserAllocated
 	{
 		PX_NOCOPY(Controller)
@@ -69,6 +71,10 @@ namespace Cct
 
 					void								onRelease(const PxBase& observed);
 
+					void								resetObstaclesBuffers();
+					void								setProxyTarget(const PxTransform& targetPose, bool lockProxy);
+					void								flushProxyTarget();
+
 					void								setCctManager(CharacterControllerManager* cm)
 					{
 						mManager = cm;
@@ -99,8 +105,18 @@ namespace Cct
 					PxControllerCollisionFlags			mCollisionFlags;	// Last known collision flags (PxControllerCollisionFlag)
 					bool								mCachedStandingOnMoving;
 					bool								mRegisterDeletionListener;
+					PxU32								mBatchGroup;		// Group of the controller during PxControllerManager::moveControllers(), CCT_NO_BATCH_GROUP otherwise
+					bool								mSimplified;		// Level of detail of the last move, see PxControllerManager::setLodFocusPoints()
+					bool								mHasPendingProxyTarget;
+					PxTransform							mPendingProxyTarget;	// Kinematic target recorded during a batch, see setProxyTarget()
 		mutable		Ps::Mutex							mWriteLock;			// Lock used for guarding touched pointers and cache data from overwriting 
 																			// during onRelease call.
+		// Buffers for obstacles. Owned by each controller so that independent controllers can be moved from different threads
+					Ps::Array<const void*>				mBoxUserData;
+					Ps::Array<PxExtendedBox>			mBoxes;
+
+					Ps::Array<const void*>				mCapsuleUserData;
+					Ps::Array<PxExtendedCapsule>		mCapsules;
 	protected:
 		// Internal methods
 					void								setUpDirectionInternal(const PxVec3& up);
@@ -111,6 +127,8 @@ namespace Cct
 					bool								rideOnTouchedObject(SweptVolume& volume, const PxVec3& upDirection, PxVec3& disp, const PxObstacleContext* obstacleContext);
 					PxControllerCollisionFlags			move(SweptVolume& volume, const PxVec3& disp, PxF32 minDist, PxF32 elapsedTime, const PxControllerFilters& filters, const PxObstacleContext* obstacles, bool constrainedClimbingMode);
 					bool								filterTouchedShape(const PxControllerFilters& filters);
+					bool								updateLodMode();
+					PxControllerCollisionFlags			moveSimplified(SweptVolume& volume, const PxVec3& disp, const PxControllerFilters& filters, const PxObstacleContext* obstacles, bool lockProxy);
 
 	PX_FORCE_INLINE	float								computeTimeCoeff()
 														{
@@ -31,6 +31,8 @@
 #include "CctObstacleContext.h"
 #include "CctCharacterControllerManager.h"
 #include "PsUtilities.h"
+#include "PsInlineArray.h"
+#include "PsIntrinsics.h"
 
 using namespace physx;
 using namespace Cct;
@@ -203,8 +205,22 @@ static PX_FORCE_INLINE PxU32 decodeIndex(ObstacleHandle handle)
 }
 #endif
 
+static const PxU32 gMaxRefsPerLeaf = 4;
+static const PxU32 gInvalidTreeNode = 0xffffffff;
+
+static PX_FORCE_INLINE PxBounds3 getObstacleBounds(const PxBoxObstacle& obstacle)
+{
+	return PxBounds3::basisExtent(toVec3(obstacle.mPos), PxMat33(obstacle.mRot), obstacle.mHalfExtents);	// LOSS OF ACCURACY
+}
+
+static PX_FORCE_INLINE PxBounds3 getObstacleBounds(const PxCapsuleObstacle& obstacle)
+{
+	const PxVec3 extents = obstacle.mRot.getBasisVector0().abs() * obstacle.mHalfHeight + PxVec3(obstacle.mRadius);
+	return PxBounds3::centerExtents(toVec3(obstacle.mPos), extents);	// LOSS OF ACCURACY
+}
+
 ObstacleContext::ObstacleContext(CharacterControllerManager& cctMan)
-	: mCCTManager(cctMan)
+	: mCCTManager(cctMan), mNbRefits(0), mTreeDirty(true)
 {
 }
 
@@ -234,6 +250,7 @@ ObstacleHandle ObstacleContext::addObstacle(const PxObstacle& obstacle)
 		const ObstacleHandle handle = encodeHandle(index, type);
 #endif
 		mBoxObstacles.pushBack(InternalBoxObstacle(handle, static_cast<const PxBoxObstacle&>(obstacle)));
+		mTreeDirty = true;
 		mCCTManager.onObstacleAdded(handle, this);
 		return handle;
 	}
@@ -246,6 +263,7 @@ ObstacleHandle ObstacleContext::addObstacle(const PxObstacle& obstacle)
 		const ObstacleHandle handle = encodeHandle(index, type);
 #endif
 		mCapsuleObstacles.pushBack(InternalCapsuleObstacle(handle, static_cast<const PxCapsuleObstacle&>(obstacle)));
+		mTreeDirty = true;
 		mCCTManager.onObstacleAdded(handle, this);
 		return handle;
 	}
@@ -290,6 +308,7 @@ bool ObstacleContext::removeObstacle(ObstacleHandle handle)
 		remove<InternalBoxObstacle>(mHandleManager, object, handle, index, size, mBoxObstacles);
 #endif
 		mBoxObstacles.replaceWithLast(index);
+		mTreeDirty = true;
 #ifdef NEW_ENCODING
 		mCCTManager.onObstacleRemoved(handle);
 #else
@@ -309,6 +328,7 @@ bool ObstacleContext::removeObstacle(ObstacleHandle handle)
 #endif
 
 		mCapsuleObstacles.replaceWithLast(index);
+		mTreeDirty = true;
 #ifdef NEW_ENCODING
 		mCCTManager.onObstacleRemoved(handle);
 #else
@@ -346,6 +366,8 @@ bool ObstacleContext::updateObstacle(ObstacleHandle handle, const PxObstacle& ob
 			return false;
 
 		mBoxObstacles[index].mData = static_cast<const PxBoxObstacle&>(obstacle);
+		if(!mTreeDirty)
+			refitTree(index, getObstacleBounds(mBoxObstacles[index].mData));
 		mCCTManager.onObstacleUpdated(handle,this);
 		return true;
 	}
@@ -357,6 +379,8 @@ bool ObstacleContext::updateObstacle(ObstacleHandle handle, const PxObstacle& ob
 			return false;
 
 		mCapsuleObstacles[index].mData = static_cast<const PxCapsuleObstacle&>(obstacle);
+		if(!mTreeDirty)
+			refitTree(index|OBSTACLE_REF_CAPSULE, getObstacleBounds(mCapsuleObstacles[index].mData));
 		mCCTManager.onObstacleUpdated(handle,this);
 		return true;
 	}
@@ -414,67 +438,277 @@ const PxObstacle* ObstacleContext::getObstacleByHandle(ObstacleHandle handle) co
 	else return NULL;
 }
 
-#include "GuRaycastTests.h"
-#include "PxBoxGeometry.h"
-#include "PxCapsuleGeometry.h"
-#include "PsMathUtils.h"
-using namespace Gu;
-const PxObstacle* ObstacleContext::raycastSingle(PxRaycastHit& hit, const PxVec3& origin, const PxVec3& unitDir, const PxReal distance, ObstacleHandle& obstacleHandle) const
+void ObstacleContext::buildTree() const
 {
-	PxRaycastHit localHit;
-	PxF32 t = FLT_MAX;
-	const PxObstacle* touchedObstacle = NULL;
+	const PxU32 nbBoxes = mBoxObstacles.size();
+	const PxU32 nbCapsules = mCapsuleObstacles.size();
+	const PxU32 nbRefs = nbBoxes + nbCapsules;
 
-	const PxHitFlags hitFlags = PxHitFlag::eDISTANCE;
+	mTreeRefs.resizeUninitialized(nbRefs);
+	mTreeRefBounds.resizeUninitialized(nbRefs);
+	mBoxLeaves.resizeUninitialized(nbBoxes);
+	mCapsuleLeaves.resizeUninitialized(nbCapsules);
+
+	for(PxU32 i=0;i<nbBoxes;i++)
+	{
+		mTreeRefs[i] = i;
+		mTreeRefBounds[i] = getObstacleBounds(mBoxObstacles[i].mData);
+	}
+	for(PxU32 i=0;i<nbCapsules;i++)
+	{
+		mTreeRefs[nbBoxes+i] = i|OBSTACLE_REF_CAPSULE;
+		mTreeRefBounds[nbBoxes+i] = getObstacleBounds(mCapsuleObstacles[i].mData);
+	}
 
+	mTreeNodes.clear();
+	if(nbRefs)
 	{
-		const RaycastFunc raycastFunc = Gu::getRaycastFuncTable()[PxGeometryType::eBOX];
-		PX_ASSERT(raycastFunc);
+		// a binary tree with at most one ref per leaf would have 2*nbRefs-1 nodes
+		mTreeNodes.reserve(2*nbRefs);
+
+		TreeNode root;
+		root.mParent = gInvalidTreeNode;
+		mTreeNodes.pushBack(root);
+		buildTreeNode(0, 0, nbRefs);
+	}
+	mNbRefits = 0;
+}
 
-		const PxU32 nbExtraBoxes = mBoxObstacles.size();
-		for(PxU32 i=0;i<nbExtraBoxes;i++)
+void ObstacleContext::buildTreeNode(PxU32 nodeIndex, PxU32 start, PxU32 nbRefs) const
+{
+	PxBounds3 bounds = PxBounds3::empty();
+	PxBounds3 centers = PxBounds3::empty();
+	for(PxU32 i=0;i<nbRefs;i++)
+	{
+		bounds.include(mTreeRefBounds[start+i]);
+		centers.include(mTreeRefBounds[start+i].getCenter());
+	}
+	mTreeNodes[nodeIndex].mBounds = bounds;
+
+	if(nbRefs<=gMaxRefsPerLeaf)
+	{
+		mTreeNodes[nodeIndex].mData		= start;
+		mTreeNodes[nodeIndex].mNbRefs	= nbRefs;
+		for(PxU32 i=0;i<nbRefs;i++)
+		{
+			const PxU32 ref = mTreeRefs[start+i];
+			if(ref & OBSTACLE_REF_CAPSULE)
+				mCapsuleLeaves[ref & ~OBSTACLE_REF_CAPSULE] = nodeIndex;
+			else
+				mBoxLeaves[ref] = nodeIndex;
+		}
+		return;
+	}
+
+	// split at the middle of the centers along the largest axis. Badly unbalanced splits are replaced
+	// with two halves, which bounds the depth of the tree (and of the recursion).
+	const PxVec3 dims = centers.getDimensions();
+	const PxU32 axis = dims.y > dims.x ? (dims.z > dims.y ? 2u : 1u) : (dims.z > dims.x ? 2u : 0u);
+	const PxF32 splitValue = centers.getCenter(axis);
+
+	PxU32 nbLeft = 0;
+	for(PxU32 i=0;i<nbRefs;i++)
+	{
+		if(mTreeRefBounds[start+i].getCenter(axis) < splitValue)
 		{
-			const PxBoxObstacle& userBoxObstacle = mBoxObstacles[i].mData;
-
-			PxU32 status = raycastFunc(	PxBoxGeometry(userBoxObstacle.mHalfExtents),
-										PxTransform(toVec3(userBoxObstacle.mPos), userBoxObstacle.mRot),
-										origin, unitDir, distance,
-										hitFlags,
-										1, &localHit);
-			if(status && localHit.distance<t)
+			Ps::swap(mTreeRefs[start+i], mTreeRefs[start+nbLeft]);
+			Ps::swap(mTreeRefBounds[start+i], mTreeRefBounds[start+nbLeft]);
+			nbLeft++;
+		}
+	}
+	if(nbLeft < nbRefs/8 || nbLeft > nbRefs - nbRefs/8)
+		nbLeft = nbRefs/2;
+
+	const PxU32 childIndex = mTreeNodes.size();
+	TreeNode child;
+	child.mParent = nodeIndex;
+	mTreeNodes.pushBack(child);
+	mTreeNodes.pushBack(child);
+	mTreeNodes[nodeIndex].mData		= childIndex;
+	mTreeNodes[nodeIndex].mNbRefs	= 0;
+
+	buildTreeNode(childIndex, start, nbLeft);
+	buildTreeNode(childIndex+1, start+nbLeft, nbRefs-nbLeft);
+}
+
+void ObstacleContext::refitTree(PxU32 ref, const PxBounds3& bounds)
+{
+	// a refit tree gets worse as obstacles move away from where they were when it was built, so it is rebuilt
+	// once enough updates have been made. Rebuilding costs about as much as refitting all obstacles a few times.
+	if(++mNbRefits > 4*mTreeRefs.size() + 64)
+	{
+		mTreeDirty = true;
+		return;
+	}
+
+	const PxU32 leaf = (ref & OBSTACLE_REF_CAPSULE) ? mCapsuleLeaves[ref & ~OBSTACLE_REF_CAPSULE] : mBoxLeaves[ref];
+	TreeNode& leafNode = mTreeNodes[leaf];
+
+	PxBounds3 leafBounds = PxBounds3::empty();
+	for(PxU32 i=0;i<leafNode.mNbRefs;i++)
+	{
+		const PxU32 index = leafNode.mData + i;
+		if(mTreeRefs[index]==ref)
+			mTreeRefBounds[index] = bounds;
+		leafBounds.include(mTreeRefBounds[index]);
+	}
+	leafNode.mBounds = leafBounds;
+
+	PxU32 parent = leafNode.mParent;
+	while(parent!=gInvalidTreeNode)
+	{
+		TreeNode& node = mTreeNodes[parent];
+		node.mBounds = mTreeNodes[node.mData].mBounds;
+		node.mBounds.include(mTreeNodes[node.mData+1].mBounds);
+		parent = node.mParent;
+	}
+}
+
+template<class Callback>
+void ObstacleContext::traverseTree(const PxBounds3& bounds, Callback& callback) const
+{
+	// controllers moved in parallel can query the tree at the same time, only one of them rebuilds it
+	if(mTreeDirty)
+	{
+		Ps::Mutex::ScopedLock lock(mTreeLock);
+		if(mTreeDirty)
+		{
+			buildTree();
+			// make the tree visible before the flag
+			Ps::memoryBarrier();
+			mTreeDirty = false;
+		}
+	}
+
+	if(!mTreeNodes.size())
+		return;
+
+	Ps::InlineArray<PxU32, 64> stack;
+	stack.pushBack(0);
+	while(stack.size())
+	{
+		const TreeNode& node = mTreeNodes[stack.popBack()];
+		if(!node.mBounds.intersects(bounds))
+			continue;
+
+		if(node.mNbRefs)
+		{
+			for(PxU32 i=0;i<node.mNbRefs;i++)
 			{
-				t = localHit.distance;
-				hit = localHit;
-				obstacleHandle = mBoxObstacles[i].mHandle;
-				touchedObstacle = &userBoxObstacle;
+				const PxU32 index = node.mData + i;
+				if(mTreeRefBounds[index].intersects(bounds))
+					callback.invoke(mTreeRefs[index]);
 			}
 		}
+		else
+		{
+			stack.pushBack(node.mData+1);
+			stack.pushBack(node.mData);
+		}
 	}
+}
+
+namespace
+{
+	struct OverlapCallback
+	{
+		OverlapCallback(Ps::Array<PxU32>& refs) : mRefs(refs)	{}
+
+		PX_FORCE_INLINE	void	invoke(PxU32 ref)	{ mRefs.pushBack(ref);	}
+
+		Ps::Array<PxU32>&	mRefs;
+	private:
+		OverlapCallback& operator=(const OverlapCallback&);
+	};
+}
+
+PxU32 ObstacleContext::overlap(const PxBounds3& bounds, Ps::Array<PxU32>& refs) const
+{
+	const PxU32 nbRefs = refs.size();
+	OverlapCallback callback(refs);
+	traverseTree(bounds, callback);
+	return refs.size() - nbRefs;
+}
 
+#include "GuRaycastTests.h"
+#include "PxBoxGeometry.h"
+#include "PxCapsuleGeometry.h"
+#include "PsMathUtils.h"
+using namespace Gu;
+namespace
+{
+	// keeps the closest hit among the obstacles found by the tree
+	struct RaycastCallback
 	{
-		const RaycastFunc raycastFunc = Gu::getRaycastFuncTable()[PxGeometryType::eCAPSULE];
-		PX_ASSERT(raycastFunc);
+		RaycastCallback(const ObstacleContext& context, PxRaycastHit& hit, const PxVec3& origin, const PxVec3& unitDir, const PxReal distance) :
+			mContext(context), mHit(hit), mOrigin(origin), mUnitDir(unitDir), mDistance(distance), mT(FLT_MAX), mTouchedObstacle(NULL), mHandle(INVALID_OBSTACLE_HANDLE)	{}
 
-		const PxU32 nbExtraCapsules = mCapsuleObstacles.size();
-		for(PxU32 i=0;i<nbExtraCapsules;i++)
+		void	invoke(PxU32 ref)
 		{
-			const PxCapsuleObstacle& userCapsuleObstacle = mCapsuleObstacles[i].mData;
-
-			PxU32 status = raycastFunc(	PxCapsuleGeometry(userCapsuleObstacle.mRadius, userCapsuleObstacle.mHalfHeight),
-										PxTransform(toVec3(userCapsuleObstacle.mPos), userCapsuleObstacle.mRot),
-										origin, unitDir, distance,
-										hitFlags,
-										1, &localHit);
-			if(status && localHit.distance<t)
+			const PxHitFlags hitFlags = PxHitFlag::eDISTANCE;
+			PxRaycastHit localHit;
+
+			if(ref & OBSTACLE_REF_CAPSULE)
+			{
+				const ObstacleContext::InternalCapsuleObstacle& obstacle = mContext.mCapsuleObstacles[ref & ~OBSTACLE_REF_CAPSULE];
+				const PxCapsuleObstacle& userCapsuleObstacle = obstacle.mData;
+
+				const PxU32 status = Gu::getRaycastFuncTable()[PxGeometryType::eCAPSULE](
+											PxCapsuleGeometry(userCapsuleObstacle.mRadius, userCapsuleObstacle.mHalfHeight),
+											PxTransform(toVec3(userCapsuleObstacle.mPos), userCapsuleObstacle.mRot),
+											mOrigin, mUnitDir, mDistance,
+											hitFlags,
+											1, &localHit);
+				if(status && localHit.distance<mT)
+				{
+					mT = localHit.distance;
+					mHit = localHit;
+					mHandle = obstacle.mHandle;
+					mTouchedObstacle = &userCapsuleObstacle;
+				}
+			}
+			else
 			{
-				t = localHit.distance;
-				hit = localHit;
-				obstacleHandle = mCapsuleObstacles[i].mHandle;
-				touchedObstacle = &userCapsuleObstacle;
+				const ObstacleContext::InternalBoxObstacle& obstacle = mContext.mBoxObstacles[ref];
+				const PxBoxObstacle& userBoxObstacle = obstacle.mData;
+
+				const PxU32 status = Gu::getRaycastFuncTable()[PxGeometryType::eBOX](
+											PxBoxGeometry(userBoxObstacle.mHalfExtents),
+											PxTransform(toVec3(userBoxObstacle.mPos), userBoxObstacle.mRot),
+											mOrigin, mUnitDir, mDistance,
+											hitFlags,
+											1, &localHit);
+				if(status && localHit.distance<mT)
+				{
+					mT = localHit.distance;
+					mHit = localHit;
+					mHandle = obstacle.mHandle;
+					mTouchedObstacle = &userBoxObstacle;
+				}
 			}
 		}
-	}
-	return touchedObstacle;
+
+		const ObstacleContext&	mContext;
+		PxRaycastHit&			mHit;
+		const PxVec3			mOrigin;
+		const PxVec3			mUnitDir;
+		const PxReal			mDistance;
+		PxF32					mT;
+		const PxObstacle*		mTouchedObstacle;
+		ObstacleHandle			mHandle;
+	private:
+		RaycastCallback& operator=(const RaycastCallback&);
+	};
+}
+
+const PxObstacle* ObstacleContext::raycastSingle(PxRaycastHit& hit, const PxVec3& origin, const PxVec3& unitDir, const PxReal distance, ObstacleHandle& obstacleHandle) const
+{
+	RaycastCallback callback(*this, hit, origin, unitDir, distance);
+	traverseTree(PxBounds3::boundsOfPoints(origin, origin + unitDir*distance), callback);
+
+	if(callback.mTouchedObstacle)
+		obstacleHandle = callback.mHandle;
+	return callback.mTouchedObstacle;
 }
 
 
@@ -535,4 +769,19 @@ void ObstacleContext::onOriginShift(const PxVec3& shift)
 
 	for(PxU32 i=0; i < mCapsuleObstacles.size(); i++)
 		mCapsuleObstacles[i].mData.mPos -= shift;
+
+	if(!mTreeDirty)
+	{
+		for(PxU32 i=0; i < mTreeNodes.size(); i++)
+		{
+			mTreeNodes[i].mBounds.minimum -= shift;
+			mTreeNodes[i].mBounds.maximum -= shift;
+		}
+
+		for(PxU32 i=0; i < mTreeRefBounds.size(); i++)
+		{
+			mTreeRefBounds[i].minimum -= shift;
+			mTreeRefBounds[i].maximum -= shift;
+		}
+	}
 }
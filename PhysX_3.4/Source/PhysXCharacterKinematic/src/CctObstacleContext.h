@@ -36,6 +36,8 @@
 #include "characterkinematic/PxControllerObstacles.h"
 #include "PsUserAllocated.h"
 #include "PsArray.h"
+#include "PsMutex.h"
+#include "foundation/PxBounds3.h"
 #include "CmPhysXCommon.h"
 
 namespace physx
@@ -46,6 +48,9 @@ namespace Cct
 {
 	class CharacterControllerManager;
 
+	// obstacle refs returned by ObstacleContext::overlap, i.e. the index in mBoxObstacles or mCapsuleObstacles
+	#define OBSTACLE_REF_CAPSULE	0x80000000
+
     typedef PxU32  Handle;
 	class HandleManager : public Ps::UserAllocated
 	{
@@ -103,6 +108,10 @@ namespace Cct
 
 				void							onOriginShift(const PxVec3& shift);
 
+				// appends the refs of the obstacles whose bounds touch the query bounds, returns the number of refs written.
+				// Can be called from several threads at the same time, but not while obstacles are added, removed or updated.
+				PxU32							overlap(const PxBounds3& bounds, Ps::Array<PxU32>& refs)	const;
+
 				struct InternalBoxObstacle
 				{
 					InternalBoxObstacle(ObstacleHandle handle, const PxBoxObstacle& data) : mHandle(handle), mData(data)	{}
@@ -125,6 +134,31 @@ namespace Cct
 				ObstacleContext&				operator=(const ObstacleContext&);
 				HandleManager					mHandleManager;
 				CharacterControllerManager&		mCCTManager;
+
+		// AABB tree over all obstacles, so that controllers only test the obstacles around them. The tree is rebuilt
+		// lazily after obstacles have been added or removed, and refit when they are updated.
+				struct TreeNode
+				{
+					PxBounds3	mBounds;
+					PxU32		mData;		// Index of the first child (children are consecutive), or of the first ref for leaves
+					PxU32		mNbRefs;	// 0 for internal nodes
+					PxU32		mParent;
+				};
+
+				template<class Callback>
+				void							traverseTree(const PxBounds3& bounds, Callback& callback)	const;
+				void							buildTree()											const;
+				void							buildTreeNode(PxU32 nodeIndex, PxU32 start, PxU32 nbRefs)	const;
+				void							refitTree(PxU32 ref, const PxBounds3& bounds);
+
+		mutable	Ps::Array<TreeNode>				mTreeNodes;
+		mutable	Ps::Array<PxU32>				mTreeRefs;
+		mutable	Ps::Array<PxBounds3>			mTreeRefBounds;		// Bounds of each ref, same order as mTreeRefs
+		mutable	Ps::Array<PxU32>				mBoxLeaves;			// Leaf of each box obstacle
+		mutable	Ps::Array<PxU32>				mCapsuleLeaves;		// Leaf of each capsule obstacle
+		mutable	PxU32							mNbRefits;
+		mutable	volatile bool					mTreeDirty;
+		mutable	Ps::Mutex						mTreeLock;
 	};
 
 
@@ -209,6 +209,13 @@ PX_INLINE PxTransform getShapeGlobalPose(const PxShape& shape, const PxRigidActo
 	}
 #endif
 
+	// converts a position to a local frame. The difference is computed before the conversion, which keeps it accurate
+	// far away from the world origin, unlike converting both positions and subtracting them.
+	PX_FORCE_INLINE PxVec3 toLocal(const PxExtendedVec3& p, const PxExtendedVec3& origin)
+	{
+		return PxVec3(float(p.x - origin.x), float(p.y - origin.y), float(p.z - origin.z));
+	}
+
 }
 
 #endif
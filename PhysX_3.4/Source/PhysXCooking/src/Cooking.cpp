@@ -33,6 +33,7 @@
 #include "PsUtilities.h"
 #include "PsFPU.h"
 #include "CmPhysXCommon.h"
+#include "CmParallelFor.h"
 #include "PxPhysXConfig.h"
 #include "PxSimpleTriangleMesh.h"
 #include "PxTriangleMeshDesc.h"
@@ -41,6 +42,7 @@
 #include "Cooking.h"
 #include "mesh/TriangleMeshBuilder.h"
 #include "GuConvexMesh.h"
+#include "GuMeshFactory.h"
 #include "ConvexMeshBuilder.h"
 #include "InflationConvexHullLib.h"
 #include "QuickHullConvexHullLib.h"
@@ -148,6 +150,36 @@ bool Cooking::cookTriangleMesh(const PxTriangleMeshDesc& desc, PxOutputStream& s
 	}
 }
 
+bool Cooking::cookTriangleMesh(TriangleMeshBuilder& builder, const PxTriangleMeshStreamDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition) const
+{
+	// cooking code does lots of float bitwise reinterpretation that generates exceptions
+	PX_FPU_GUARD;
+
+	if (condition)
+		*condition = PxTriangleMeshCookingResult::eSUCCESS;
+	if(!builder.loadFromStream(desc, condition))
+	{
+		return false;
+	}
+
+	builder.save(stream, platformMismatch(), mParams);
+	return true;
+}
+
+bool Cooking::cookTriangleMesh(const PxTriangleMeshStreamDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition) const
+{
+	if((mParams.midphaseDesc.getType() == PxMeshMidPhase::eINVALID) || (mParams.midphaseDesc.getType() == PxMeshMidPhase::eBVH33))
+	{
+		RTreeTriangleMeshBuilder builder(mParams);
+		return cookTriangleMesh(builder, desc, stream, condition);
+	}
+	else
+	{
+		BV4TriangleMeshBuilder builder(mParams);
+		return cookTriangleMesh(builder, desc, stream, condition);
+	}
+}
+
 PxTriangleMesh* Cooking::createTriangleMesh(TriangleMeshBuilder& builder, const PxTriangleMeshDesc& desc, PxPhysicsInsertionCallback& insertionCallback, PxTriangleMeshCookingResult::Enum* condition) const
 {	
 	// cooking code does lots of float bitwise reinterpretation that generates exceptions
@@ -274,28 +306,8 @@ bool Cooking::cookConvexMesh(const PxConvexMeshDesc& desc_, PxOutputStream& stre
 {	
 	PX_FPU_GUARD;
 	// choose cooking library if needed
-	ConvexHullLib* hullLib = NULL;
-    PxConvexMeshDesc desc = desc_;
-
-	if(desc_.flags & PxConvexFlag::eCOMPUTE_CONVEX)
-	{			
-		const PxU16 gpuMaxVertsLimit = 64;
-
-		// GRB supports 64 verts max
-		if(desc_.flags & PxConvexFlag::eGPU_COMPATIBLE)
-		{
-			desc.vertexLimit = PxMin(desc.vertexLimit, gpuMaxVertsLimit);
-		}
-
-		if(mParams.convexMeshCookingType == PxConvexMeshCookingType::eINFLATION_INCREMENTAL_HULL)
-		{
-			hullLib = PX_NEW(InflationConvexHullLib) (desc, mParams);			
-		}
-		else
-		{
-			hullLib = PX_NEW(QuickHullConvexHullLib) (desc, mParams);			
-		}
-	}
+	PxConvexMeshDesc desc;
+	ConvexHullLib* hullLib = createConvexHullLib(desc_, desc);
 
 	ConvexMeshBuilder meshBuilder(mParams.buildGPUData);
 	if(!cookConvexMeshInternal(desc,meshBuilder,hullLib , condition))
@@ -325,42 +337,28 @@ bool Cooking::cookConvexMesh(const PxConvexMeshDesc& desc_, PxOutputStream& stre
 //////////////////////////////////////////////////////////////////////////
 // cook convex mesh from given desc, copy the results into internal convex mesh
 // and insert the mesh into PxPhysics
-PxConvexMesh* Cooking::createConvexMesh(const PxConvexMeshDesc& desc_, PxPhysicsInsertionCallback& insertionCallback, PxConvexMeshCookingResult::Enum* condition) const
+ConvexHullLib* Cooking::createConvexHullLib(const PxConvexMeshDesc& desc_, PxConvexMeshDesc& desc) const
 {
-	PX_FPU_GUARD;
-	// choose cooking library if needed
-	ConvexHullLib* hullLib = NULL;	
-	PxConvexMeshDesc desc = desc_;
-
-	if(desc.flags & PxConvexFlag::eCOMPUTE_CONVEX)
-	{
-		const PxU16 gpuMaxVertsLimit = 64;
-
-		// GRB supports 64 verts max
-		if(desc_.flags & PxConvexFlag::eGPU_COMPATIBLE)
-		{
-			desc.vertexLimit = PxMin(desc.vertexLimit, gpuMaxVertsLimit);
-		}
+	desc = desc_;
+	if(!(desc.flags & PxConvexFlag::eCOMPUTE_CONVEX))
+		return NULL;
 
-		if (mParams.convexMeshCookingType == PxConvexMeshCookingType::eINFLATION_INCREMENTAL_HULL)
-		{
-			hullLib = PX_NEW(InflationConvexHullLib) (desc, mParams);
-		}
-		else
-		{
-			hullLib = PX_NEW(QuickHullConvexHullLib) (desc, mParams);
-		}
-	}
+	const PxU16 gpuMaxVertsLimit = 64;
 
-	// cook the mesh
-	ConvexMeshBuilder meshBuilder(mParams.buildGPUData);
-	if (!cookConvexMeshInternal(desc, meshBuilder, hullLib, condition))
+	// GRB supports 64 verts max
+	if(desc_.flags & PxConvexFlag::eGPU_COMPATIBLE)
 	{
-		if(hullLib)
-			PX_DELETE(hullLib);		
-		return NULL;
+		desc.vertexLimit = PxMin(desc.vertexLimit, gpuMaxVertsLimit);
 	}
-	
+
+	if (mParams.convexMeshCookingType == PxConvexMeshCookingType::eINFLATION_INCREMENTAL_HULL)
+		return PX_NEW(InflationConvexHullLib) (desc, mParams);
+	else
+		return PX_NEW(QuickHullConvexHullLib) (desc, mParams);
+}
+
+PxConvexMesh* Cooking::insertConvexMesh(ConvexMeshBuilder& meshBuilder, PxPhysicsInsertionCallback& insertionCallback, PxConvexMeshCookingResult::Enum* condition) const
+{
 	// copy the constructed data into the new mesh
 
 	PxU32 nb = 0;
@@ -373,8 +371,6 @@ PxConvexMesh* Cooking::createConvexMesh(const PxConvexMeshDesc& desc_, PxPhysics
 	{
 		if(condition)
 			*condition = PxConvexMeshCookingResult::eFAILURE;
-		if (hullLib)
-			PX_DELETE(hullLib);
 		return NULL;
 	}
 
@@ -387,6 +383,29 @@ PxConvexMesh* Cooking::createConvexMesh(const PxConvexMeshDesc& desc_, PxPhysics
 		meshBuilder.setBigConvexData(NULL);
 	}
 
+	// now that the mesh is complete, identical hulls cooked before (e.g. the same asset used by several objects) can be reused instead
+	if(convexMesh->getMeshFactory())
+		return convexMesh->getMeshFactory()->shareConvexMesh(convexMesh);
+
+	return convexMesh;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// cook convex mesh from given desc, copy the results into internal convex mesh
+// and insert the mesh into PxPhysics
+PxConvexMesh* Cooking::createConvexMesh(const PxConvexMeshDesc& desc_, PxPhysicsInsertionCallback& insertionCallback, PxConvexMeshCookingResult::Enum* condition) const
+{
+	PX_FPU_GUARD;
+	// choose cooking library if needed
+	PxConvexMeshDesc desc;
+	ConvexHullLib* hullLib = createConvexHullLib(desc_, desc);
+
+	// cook the mesh
+	ConvexMeshBuilder meshBuilder(mParams.buildGPUData);
+	PxConvexMesh* convexMesh = NULL;
+	if (cookConvexMeshInternal(desc, meshBuilder, hullLib, condition))
+		convexMesh = insertConvexMesh(meshBuilder, insertionCallback, condition);
+
 	if(hullLib)
 		PX_DELETE(hullLib);
 	return convexMesh;
@@ -394,6 +413,80 @@ PxConvexMesh* Cooking::createConvexMesh(const PxConvexMeshDesc& desc_, PxPhysics
 
 //////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+	// Convexes are cooked in parallel, then inserted in order on the calling thread
+	struct ConvexBatchItem
+	{
+		ConvexMeshBuilder					mBuilder;
+		PxConvexMeshCookingResult::Enum		mCondition;
+		bool								mCooked;
+
+		ConvexBatchItem(bool buildGRBData) : mBuilder(buildGRBData), mCondition(PxConvexMeshCookingResult::eFAILURE), mCooked(false)	{}
+	};
+
+	struct ConvexBatchContext
+	{
+		const Cooking*				mCooking;
+		const PxConvexMeshDesc*		mDescs;
+		ConvexBatchItem*			mItems;
+	};
+
+	void cookConvexBatchItem(ConvexBatchContext& context, PxU32 i)
+	{
+		PX_FPU_GUARD;
+		ConvexBatchItem& item = context.mItems[i];
+		PxConvexMeshDesc desc;
+		ConvexHullLib* hullLib = context.mCooking->createConvexHullLib(context.mDescs[i], desc);
+		item.mCooked = context.mCooking->cookConvexMeshInternal(desc, item.mBuilder, hullLib, &item.mCondition);
+		// The builder has its own copy of the hull, and the library references the local descriptor
+		if(hullLib)
+			PX_DELETE(hullLib);
+	}
+
+	void cookConvexBatchItems(void* context, PxU32 start, PxU32 nb)
+	{
+		for(PxU32 i=start;i<start+nb;i++)
+			cookConvexBatchItem(*reinterpret_cast<ConvexBatchContext*>(context), i);
+	}
+}
+
+PxU32 Cooking::createConvexMeshes(const PxConvexMeshDesc* descs, PxU32 nbDescs, PxPhysicsInsertionCallback& insertionCallback, PxConvexMesh** meshes, PxConvexMeshCookingResult::Enum* conditions) const
+{
+	if(!nbDescs)
+		return 0;
+
+	ConvexBatchItem* items = reinterpret_cast<ConvexBatchItem*>(PX_ALLOC_TEMP(sizeof(ConvexBatchItem)*nbDescs, "ConvexBatchItem"));
+	for(PxU32 i=0;i<nbDescs;i++)
+		PX_PLACEMENT_NEW(items + i, ConvexBatchItem)(mParams.buildGPUData);
+
+	ConvexBatchContext context;
+	context.mCooking = this;
+	context.mDescs = descs;
+	context.mItems = items;
+
+	// One convex per chunk, their cost varies a lot
+	Cm::blockingParallelFor(mParams.dispatcher, nbDescs, 1, 1, cookConvexBatchItems, &context, "Cooking.createConvexMeshes");
+
+	// The insertion callback is not required to be thread safe, and inserting in order keeps the results deterministic
+	PxU32 nbCreated = 0;
+	for(PxU32 i=0;i<nbDescs;i++)
+	{
+		ConvexBatchItem& item = items[i];
+		meshes[i] = item.mCooked ? insertConvexMesh(item.mBuilder, insertionCallback, &item.mCondition) : NULL;
+		if(meshes[i])
+			nbCreated++;
+		if(conditions)
+			conditions[i] = item.mCondition;
+		item.~ConvexBatchItem();
+	}
+	PX_FREE(items);
+
+	return nbCreated;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 bool Cooking::validateConvexMesh(const PxConvexMeshDesc& desc) const
 {
 	ConvexMeshBuilder mesh(mParams.buildGPUData);
@@ -438,6 +531,16 @@ bool Cooking::computeHullPolygons(const PxSimpleTriangleMesh& mesh, PxAllocatorC
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// the adopted buffer belongs to the SDK even when the desc is rejected
+static void releaseAdoptedSamples(const PxHeightFieldDesc& desc)
+{
+	if(desc.adoptSamples && desc.samples.data)
+	{
+		void* samples = const_cast<void*>(desc.samples.data);
+		PX_FREE(samples);
+	}
+}
+
 bool Cooking::cookHeightField(const PxHeightFieldDesc& desc, PxOutputStream& stream) const
 {
 	PX_FPU_GUARD;
@@ -447,6 +550,7 @@ bool Cooking::cookHeightField(const PxHeightFieldDesc& desc, PxOutputStream& str
 		#if PX_CHECKED
 		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "Cooking::createHeightField: user-provided heightfield descriptor is invalid!");
 		#endif
+		releaseAdoptedSamples(desc);
 		return false;
 	}
 	
@@ -480,6 +584,7 @@ PxHeightField* Cooking::createHeightField(const PxHeightFieldDesc& desc, PxPhysi
 		#if PX_CHECKED
 		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "Cooking::createHeightField: user-provided heightfield descriptor is invalid!");
 		#endif
+		releaseAdoptedSamples(desc);
 		return NULL;
 	}
 
@@ -50,11 +50,13 @@ public:
 	virtual const PxCookingParams&	getParams() const;
 	virtual bool					platformMismatch() const;
 	virtual bool					cookTriangleMesh(const PxTriangleMeshDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition = NULL) const;
+	virtual bool					cookTriangleMesh(const PxTriangleMeshStreamDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition = NULL) const;
 	virtual PxTriangleMesh*			createTriangleMesh(const PxTriangleMeshDesc& desc, PxPhysicsInsertionCallback& insertionCallback, PxTriangleMeshCookingResult::Enum* condition = NULL) const;
 	virtual bool					validateTriangleMesh(const PxTriangleMeshDesc& desc) const;
 
 	virtual bool					cookConvexMesh(const PxConvexMeshDesc& desc, PxOutputStream& stream, PxConvexMeshCookingResult::Enum* condition) const;
 	virtual PxConvexMesh*			createConvexMesh(const PxConvexMeshDesc& desc, PxPhysicsInsertionCallback& insertionCallback, PxConvexMeshCookingResult::Enum* condition) const;
+	virtual PxU32					createConvexMeshes(const PxConvexMeshDesc* descs, PxU32 nbDescs, PxPhysicsInsertionCallback& insertionCallback, PxConvexMesh** meshes, PxConvexMeshCookingResult::Enum* conditions) const;
 	virtual bool					validateConvexMesh(const PxConvexMeshDesc& desc) const;
 	virtual bool					computeHullPolygons(const PxSimpleTriangleMesh& mesh, PxAllocatorCallback& inCallback,PxU32& nbVerts, PxVec3*& vertices,
 											PxU32& nbIndices, PxU32*& indices, PxU32& nbPolygons, PxHullPolygon*& hullPolygons) const;
@@ -73,9 +75,14 @@ public:
 		}
 	}
 
-private:
+	// Steps of createConvexMesh, also used by the parallel batch. Cooking doesn't modify the object so they are thread safe
+	ConvexHullLib*					createConvexHullLib(const PxConvexMeshDesc& desc_, PxConvexMeshDesc& desc) const;
 	bool							cookConvexMeshInternal(const PxConvexMeshDesc& desc, ConvexMeshBuilder& meshBuilder, ConvexHullLib* hullLib, PxConvexMeshCookingResult::Enum* condition) const;
+	PxConvexMesh*					insertConvexMesh(ConvexMeshBuilder& meshBuilder, PxPhysicsInsertionCallback& insertionCallback, PxConvexMeshCookingResult::Enum* condition) const;
+
+private:
 	bool							cookTriangleMesh(TriangleMeshBuilder& builder, const PxTriangleMeshDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition) const;
+	bool							cookTriangleMesh(TriangleMeshBuilder& builder, const PxTriangleMeshStreamDesc& desc, PxOutputStream& stream, PxTriangleMeshCookingResult::Enum* condition) const;
 	PxTriangleMesh*					createTriangleMesh(TriangleMeshBuilder& builder, const PxTriangleMeshDesc& desc, PxPhysicsInsertionCallback& insertionCallback, PxTriangleMeshCookingResult::Enum* condition) const;
 
 private:
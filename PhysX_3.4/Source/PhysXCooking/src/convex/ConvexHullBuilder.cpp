@@ -66,7 +66,10 @@ ConvexHullBuilder::ConvexHullBuilder(Gu::ConvexHullData* hull, const bool buildG
 	mEdgeData16					(NULL),
 	mEdges						(NULL),
 	mHull						(hull),
-	mBuildGRBData				(buildGRBData)
+	mBuildGRBData				(buildGRBData),
+	mQuantizationBase			(PxVec3(0.0f)),
+	mQuantizationScale			(PxVec3(0.0f)),
+	mQuantizedNormals			(NULL)
 {
 }
 
@@ -76,6 +79,7 @@ ConvexHullBuilder::~ConvexHullBuilder()
 {
 	PX_DELETE_POD(mEdgeData16);
 	PX_DELETE_POD(mEdges);
+	PX_DELETE_POD(mQuantizedNormals);
 
 	PX_DELETE_POD(mHullDataHullVertices);
 	PX_DELETE_POD(mHullDataPolygons);
@@ -374,6 +378,64 @@ bool ConvexHullBuilder::computeGeomCenter(PxVec3& center, PxU32 numFaces, HullTr
 // hull data store
 PX_COMPILE_TIME_ASSERT(sizeof(Gu::EdgeDescData)==8);
 PX_COMPILE_TIME_ASSERT(sizeof(Gu::EdgeData)==8);
+static PX_FORCE_INLINE PxU16 quantizeCoordinate(PxReal value, PxReal base, PxReal scale)
+{
+	if(scale==0.0f)
+		return 0;
+	const PxReal q = (value - base) / scale + 0.5f;
+	return q<=0.0f ? PxU16(0) : q>=65535.0f ? PxU16(0xffff) : PxU16(q);
+}
+
+// Octahedral encoding, the inverse of Gu::dequantizeHullNormal
+static void quantizeNormal(const PxVec3& n, PxU16& u, PxU16& v)
+{
+	const PxReal invL1 = 1.0f / (PxAbs(n.x) + PxAbs(n.y) + PxAbs(n.z));
+	PxReal x = n.x * invL1;
+	PxReal y = n.y * invL1;
+	if(n.z<0.0f)
+	{
+		const PxReal fx = (1.0f - PxAbs(y)) * (x>=0.0f ? 1.0f : -1.0f);
+		const PxReal fy = (1.0f - PxAbs(x)) * (y>=0.0f ? 1.0f : -1.0f);
+		x = fx;
+		y = fy;
+	}
+	u = quantizeCoordinate(x, -1.0f, 1.0f / 32767.0f);
+	v = quantizeCoordinate(y, -1.0f, 1.0f / 32767.0f);
+}
+
+void ConvexHullBuilder::quantize()
+{
+	const PxU32 nbVerts = mHull->mNbHullVertices;
+	const PxU32 nbPolygons = mHull->mNbPolygons;
+
+	PxBounds3 bounds = PxBounds3::empty();
+	for(PxU32 i=0;i<nbVerts;i++)
+		bounds.include(mHullDataHullVertices[i]);
+
+	mQuantizationBase = bounds.minimum;
+	mQuantizationScale = (bounds.maximum - bounds.minimum) * (1.0f / 65535.0f);
+
+	for(PxU32 i=0;i<nbVerts;i++)
+	{
+		PxVec3& v = mHullDataHullVertices[i];
+		v = Gu::dequantizeHullVertex(mQuantizationBase, mQuantizationScale,
+			quantizeCoordinate(v.x, mQuantizationBase.x, mQuantizationScale.x),
+			quantizeCoordinate(v.y, mQuantizationBase.y, mQuantizationScale.y),
+			quantizeCoordinate(v.z, mQuantizationBase.z, mQuantizationScale.z));
+	}
+
+	// the planes are finished from the snapped vertices, exactly like the loader does
+	PX_DELETE_POD(mQuantizedNormals);
+	mQuantizedNormals = PX_NEW(PxU16)[nbPolygons*2];
+	for(PxU32 i=0;i<nbPolygons;i++)
+	{
+		Gu::HullPolygonData& polygon = mHullDataPolygons[i];
+		quantizeNormal(polygon.mPlane.n, mQuantizedNormals[i*2+0], mQuantizedNormals[i*2+1]);
+		const PxVec3 normal = Gu::dequantizeHullNormal(mQuantizedNormals[i*2+0], mQuantizedNormals[i*2+1]);
+		Gu::computeQuantizedHullPlane(polygon, normal, mHullDataHullVertices, nbVerts);
+	}
+}
+
 bool ConvexHullBuilder::save(PxOutputStream& stream, bool platformMismatch) const
 {
 	// Export header
@@ -401,18 +463,42 @@ bool ConvexHullBuilder::save(PxOutputStream& stream, bool platformMismatch) cons
 
 	// Export triangles
 
-	writeFloatBuffer(&mHullDataHullVertices->x, PxU32(mHull->mNbHullVertices*3), platformMismatch, stream);
+	if(isQuantized())
+	{
+		// see ICSF_QUANTIZED_HULL. The plane distances and min indices are recomputed by the loader.
+		writeFloatBuffer(&mQuantizationBase.x, 3, platformMismatch, stream);
+		writeFloatBuffer(&mQuantizationScale.x, 3, platformMismatch, stream);
+		for(PxU32 i=0;i<mHull->mNbHullVertices;i++)
+		{
+			const PxVec3& v = mHullDataHullVertices[i];
+			writeWord(quantizeCoordinate(v.x, mQuantizationBase.x, mQuantizationScale.x), platformMismatch, stream);
+			writeWord(quantizeCoordinate(v.y, mQuantizationBase.y, mQuantizationScale.y), platformMismatch, stream);
+			writeWord(quantizeCoordinate(v.z, mQuantizationBase.z, mQuantizationScale.z), platformMismatch, stream);
+		}
 
-	// Export polygons
-	// TODO: allow lazy-evaluation
-	// We can't really store the buffer in one run anymore!
-	for(PxU32 i=0;i<mHull->mNbPolygons;i++)
+		for(PxU32 i=0;i<mHull->mNbPolygons;i++)
+		{
+			writeWord(mQuantizedNormals[i*2+0], platformMismatch, stream);
+			writeWord(mQuantizedNormals[i*2+1], platformMismatch, stream);
+			writeWord(mHullDataPolygons[i].mVRef8, platformMismatch, stream);
+			stream.write(&mHullDataPolygons[i].mNbVerts, sizeof(PxU8));
+		}
+	}
+	else
 	{
-		Gu::HullPolygonData tmpCopy = mHullDataPolygons[i];
-		if(platformMismatch)
-			flipData(tmpCopy);
+		writeFloatBuffer(&mHullDataHullVertices->x, PxU32(mHull->mNbHullVertices*3), platformMismatch, stream);
+
+		// Export polygons
+		// TODO: allow lazy-evaluation
+		// We can't really store the buffer in one run anymore!
+		for(PxU32 i=0;i<mHull->mNbPolygons;i++)
+		{
+			Gu::HullPolygonData tmpCopy = mHullDataPolygons[i];
+			if(platformMismatch)
+				flipData(tmpCopy);
 
-		stream.write(&tmpCopy, sizeof(Gu::HullPolygonData));
+			stream.write(&tmpCopy, sizeof(Gu::HullPolygonData));
+		}
 	}
 
 	// PT: why not storeBuffer here?
@@ -62,6 +62,10 @@ namespace physx
 
 					bool						save(PxOutputStream& stream, bool platformMismatch)	const;
 					bool						copy(Gu::ConvexHullData& hullData, PxU32& nb);
+
+					// Snaps the hull for PxConvexFlag::eQUANTIZE_HULL, must be called before anything is computed from the vertices
+					void						quantize();
+		PX_FORCE_INLINE	bool					isQuantized()			const	{ return mQuantizedNormals!=NULL;	}
 					
 					bool						createEdgeList(bool doValidation, PxU32 nbEdges);
 					bool						checkHullPolygons()	const;										
@@ -85,6 +89,11 @@ namespace physx
 
 					Gu::ConvexHullData*			mHull;
 					bool						mBuildGRBData;
+
+					// Grid and octahedral normals used by PxConvexFlag::eQUANTIZE_HULL, normals are NULL when the hull is not quantized
+					PxVec3						mQuantizationBase;
+					PxVec3						mQuantizationScale;
+					PxU16*						mQuantizedNormals;
 					
 		protected:										
 					bool						computeGeomCenter(PxVec3& , PxU32 numFaces, HullTriangleData* faces) const; 
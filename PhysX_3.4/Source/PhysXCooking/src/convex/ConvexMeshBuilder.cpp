@@ -111,6 +111,8 @@ bool ConvexMeshBuilder::save(PxOutputStream& stream, bool platformMismatch) cons
 
 	// Export serialization flags
 	PxU32 serialFlags = 0;
+	if(hullBuilder.isQuantized())
+		serialFlags |= Gu::ICSF_QUANTIZED_HULL;
 
 	writeDword(serialFlags, platformMismatch, stream);
 
@@ -302,6 +304,11 @@ bool ConvexMeshBuilder::loadConvexHull(const PxConvexMeshDesc& desc, ConvexHullL
 		Ps::getFoundation().error(PxErrorCode::eINTERNAL_ERROR, __FILE__, __LINE__, "Gu::ConvexMesh::loadConvexHull: convex hull init failed!");
   		return false;
   	}
+
+	// Snap before anything is computed from the vertices
+	if(desc.flags & PxConvexFlag::eQUANTIZE_HULL)
+		hullBuilder.quantize();
+
 	computeMassInfo(desc.flags & PxConvexFlag::eFAST_INERTIA_COMPUTATION);
   
 	return true;
@@ -43,7 +43,10 @@
 #include "foundation/PxBounds3.h"
 #include "foundation/PxMemory.h"
 
+#include "PsVecMath.h"
+
 using namespace physx;
+using namespace physx::shdfnd::aos;
 
 namespace local
 {		
@@ -369,6 +372,41 @@ namespace local
 		};
 	};
 
+	//////////////////////////////////////////////////////////////////////////
+	// planes of up to 4 faces stored as SoA, so the distances of a point to all of them take a few SIMD instructions
+	struct QuickHullFacePlanes4
+	{
+		float			nx[4], ny[4], nz[4], d[4];
+		QuickHullFace*	faces[4];
+
+		// unused lanes get a plane no point can be in front of
+		PX_FORCE_INLINE void clear()
+		{
+			for (PxU32 i = 0; i < 4; i++)
+			{
+				nx[i] = ny[i] = nz[i] = 0.0f;
+				d[i] = FLT_MAX;
+				faces[i] = NULL;
+			}
+		}
+
+		PX_FORCE_INLINE void setFace(PxU32 i, QuickHullFace* face)
+		{
+			nx[i] = face->normal.x; ny[i] = face->normal.y; nz[i] = face->normal.z;
+			d[i] = face->planeOffset;
+			faces[i] = face;
+		}
+
+		// same as QuickHullFace::distanceToPlane for each lane, with the same operation order
+		PX_FORCE_INLINE void distancesToPlanes(const PxVec3& p, float* dists) const
+		{
+			const Vec4V dot = V4MulAdd(V4LoadU(nz), V4Load(p.z), V4MulAdd(V4LoadU(ny), V4Load(p.y), V4Mul(V4LoadU(nx), V4Load(p.x))));
+			V4StoreU(V4Sub(dot, V4LoadU(d)), dists);
+		}
+	};
+
+	typedef Ps::Array<QuickHullFacePlanes4> QuickHullFacePlanesArray;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Quickhull base class holding the hull during construction
 	class QuickHull : public Ps::UserAllocated
@@ -492,6 +530,7 @@ namespace local
 		QuickHullFaceArray		mNewFaces;			// new faces created during horizon computation
 		QuickHullFaceArray		mRemovedFaces;		// removd faces during horizon computation
 		QuickHullFaceArray      mDiscardedFaces;	// discarded faces during face merging
+		QuickHullFacePlanesArray	mNewFacePlanes;	// planes of the visible new faces, to claim the unclaimed points
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -1031,6 +1070,10 @@ namespace local
 		}
 		mNumHullFaces = 4;
 
+		QuickHullFacePlanes4 planes;
+		for (PxU32 i = 0; i < 4; i++)
+			planes.setFace(i, tris[i]);
+
 		// go through points and add point to faces if they are on the plane
 		for (PxU32 i = 0; i < mNumVertices; i++)
 		{
@@ -1041,15 +1084,17 @@ namespace local
 				continue;
 			}
 
+			float dists[4];
+			planes.distancesToPlanes(v.point, dists);
+
 			float maxDist = mTolerance;
 			QuickHullFace* maxFace = NULL;
 			for (PxU32 k = 0; k < 4; k++)
 			{
-				const float dist = tris[k]->distanceToPlane(v.point);
-				if (dist > maxDist)
+				if (dists[k] > maxDist)
 				{
 					maxFace = tris[k];
-					maxDist = dist;
+					maxDist = dists[k];
 				}
 			}
 
@@ -1693,22 +1738,41 @@ namespace local
 	// resolve unclaimed points
 	void QuickHull::resolveUnclaimedPoints(const QuickHullFaceArray& newFaces)
 	{
+		if (mUnclaimedPoints.empty())
+			return;
+
+		// pack the visible faces 4 by 4, in order, so the first face with the max distance still wins
+		mNewFacePlanes.clear();
+		PxU32 lane = 4;
+		for (PxU32 j = 0; j < newFaces.size(); j++)
+		{
+			if (newFaces[j]->state != QuickHullFace::eVISIBLE)
+				continue;
+			if (lane == 4)
+			{
+				mNewFacePlanes.insert().clear();
+				lane = 0;
+			}
+			mNewFacePlanes.back().setFace(lane++, newFaces[j]);
+		}
+
 		for (PxU32 i = 0; i < mUnclaimedPoints.size(); i++)
 		{
 			QuickHullVertex* vtx = mUnclaimedPoints[i];
 
 			float maxDist = mTolerance;
 			QuickHullFace* maxFace = NULL;
-			for (PxU32 j = 0; j < newFaces.size(); j++)
+			for (PxU32 j = 0; j < mNewFacePlanes.size(); j++)
 			{
-				const QuickHullFace& newFace = *newFaces[j];
-				if (newFace.state == QuickHullFace::eVISIBLE)
+				const QuickHullFacePlanes4& planes = mNewFacePlanes[j];
+				float dists[4];
+				planes.distancesToPlanes(vtx->point, dists);
+				for (PxU32 k = 0; k < 4; k++)
 				{
-					const float dist = newFace.distanceToPlane(vtx->point);
-					if (dist > maxDist)
+					if (dists[k] > maxDist)
 					{
-						maxDist = dist;
-						maxFace = newFaces[j];
+						maxDist = dists[k];
+						maxFace = planes.faces[k];
 					}
 				}
 			}
@@ -72,7 +72,7 @@ bool saveHeightField(const HeightField& hf, PxOutputStream& stream, bool endian)
 	// write samples
 	for(PxU32 i = 0; i < hf.mNbSamples; i++)
 	{
-		const PxHeightFieldSample& s = hfData.samples[i];
+		const PxHeightFieldSample s = hfData.getSample(i);
 		writeWord(PxU16(s.height), endian, stream);
 		stream.write(&s.materialIndex0, sizeof(s.materialIndex0));
 		stream.write(&s.materialIndex1, sizeof(s.materialIndex1));
@@ -38,7 +38,9 @@
 #include "PxTolerancesScale.h"
 #include "QuickSelect.h"
 #include "PsInlineArray.h"
+#include "PsFPU.h"
 #include "GuRTree.h"
+#include "CmParallelFor.h"
 
 #define PRINT_RTREE_COOKING_STATS 0 // AP: keeping this frequently used macro for diagnostics/benchmarking
 
@@ -84,12 +86,12 @@ struct PxBounds3V
 static void buildFromBounds(
 	Gu::RTree& resultTree, const PxBounds3V* allBounds, PxU32 numBounds,
 	Array<PxU32>& resultPermute, RTreeCooker::RemapCallback* rc, Vec3VArg allMn, Vec3VArg allMx,
-	PxReal sizePerfTradeOff, PxMeshCookingHint::Enum hint);
+	PxReal sizePerfTradeOff, PxMeshCookingHint::Enum hint, PxCpuDispatcher* dispatcher);
 
 /////////////////////////////////////////////////////////////////////////
 void RTreeCooker::buildFromTriangles(
 	Gu::RTree& result, const PxVec3* verts, PxU32 numVerts, const PxU16* tris16, const PxU32* tris32, PxU32 numTris,
-	Array<PxU32>& resultPermute, RTreeCooker::RemapCallback* rc, PxReal sizePerfTradeOff01, PxMeshCookingHint::Enum hint)
+	Array<PxU32>& resultPermute, RTreeCooker::RemapCallback* rc, PxReal sizePerfTradeOff01, PxMeshCookingHint::Enum hint, PxCpuDispatcher* dispatcher)
 {
 	PX_UNUSED(numVerts);
 	Array<PxBounds3V> allBounds;
@@ -117,7 +119,7 @@ void RTreeCooker::buildFromTriangles(
 		allBounds.pushBack(PxBounds3V(mn, mx));
 	}
 
-	buildFromBounds(result, allBounds.begin(), numTris, resultPermute, rc, allMn, allMx, sizePerfTradeOff01, hint);
+	buildFromBounds(result, allBounds.begin(), numTris, resultPermute, rc, allMn, allMx, sizePerfTradeOff01, hint, dispatcher);
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -324,6 +326,44 @@ struct SortBoundsPredicate
 };
 
 
+/////////////////////////////////////////////////////////////////////////
+// sorts the bounds along the 3 axes for the SAH build, each axis on its own task when a dispatcher is given
+namespace
+{
+	// meshes smaller than this are sorted on the calling thread
+	const PxU32 gParallelSortMinBounds = 16384;
+
+	struct AxisSortData
+	{
+		const PxBounds3V*	allBounds;
+		PxU32				numBounds;
+		PxU32*				orders[3];
+		PxU32*				ranks[3];
+
+		void sortAxis(PxU32 axis) const
+		{
+			PX_SIMD_GUARD;
+			PxU32* order = orders[axis];
+			PxU32* rank = ranks[axis];
+			// sort by shuffling the permutation, precompute sorted ranks
+			Ps::sort(order, numBounds, SortBoundsPredicate(axis, allBounds));
+			for(PxU32 i = 0; i < numBounds; i++) rank[order[i]] = i;
+		}
+	};
+
+	void sortAxesChunk(void* context, PxU32 start, PxU32 nb)
+	{
+		const AxisSortData& data = *reinterpret_cast<const AxisSortData*>(context);
+		for(PxU32 axis = start; axis < start + nb; axis++)
+			data.sortAxis(axis);
+	}
+
+	void sortAxes(const AxisSortData& data, PxCpuDispatcher* dispatcher)
+	{
+		Cm::blockingParallelFor(data.numBounds < gParallelSortMinBounds ? NULL : dispatcher, 3, 1, 1, sortAxesChunk, const_cast<AxisSortData*>(&data), "Cooking::RTree.parallelSort");
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////
 // auxiliary class for SAH build (SAH = surface area heuristic)
 struct Interval
@@ -726,7 +766,7 @@ struct SubSortSAH
 static void buildFromBounds(
 	Gu::RTree& result, const PxBounds3V* allBounds, PxU32 numBounds,
 	Array<PxU32>& permute, RTreeCooker::RemapCallback* rc, Vec3VArg allMn, Vec3VArg allMx,
-	PxReal sizePerfTradeOff01, PxMeshCookingHint::Enum hint)
+	PxReal sizePerfTradeOff01, PxMeshCookingHint::Enum hint, PxCpuDispatcher* dispatcher)
 {
 	PX_UNUSED(sizePerfTradeOff01);
 	PxBounds3V treeBounds(allMn, allMx);
@@ -753,12 +793,12 @@ static void buildFromBounds(
 		PxMemCopy(yOrder.begin(), permute.begin(), sizeof(yOrder[0])*numBounds);
 		PxMemCopy(zOrder.begin(), permute.begin(), sizeof(zOrder[0])*numBounds);
 		// sort by shuffling the permutation, precompute sorted ranks for x,y,z-orders
-		Ps::sort(xOrder.begin(), xOrder.size(), SortBoundsPredicate(0, allBounds));
-		for(PxU32 i = 0; i < numBounds; i++) xRanks[xOrder[i]] = i;
-		Ps::sort(yOrder.begin(), yOrder.size(), SortBoundsPredicate(1, allBounds));
-		for(PxU32 i = 0; i < numBounds; i++) yRanks[yOrder[i]] = i;
-		Ps::sort(zOrder.begin(), zOrder.size(), SortBoundsPredicate(2, allBounds));
-		for(PxU32 i = 0; i < numBounds; i++) zRanks[zOrder[i]] = i;
+		AxisSortData sortData;
+		sortData.allBounds = allBounds;
+		sortData.numBounds = numBounds;
+		sortData.orders[0] = xOrder.begin(); sortData.orders[1] = yOrder.begin(); sortData.orders[2] = zOrder.begin();
+		sortData.ranks[0] = xRanks.begin(); sortData.ranks[1] = yRanks.begin(); sortData.ranks[2] = zRanks.begin();
+		sortAxes(sortData, dispatcher);
 
 		SubSortSAH ss(permute.begin(), allBounds, numBounds,
 			xOrder.begin(), yOrder.begin(), zOrder.begin(), xRanks.begin(), yRanks.begin(), zRanks.begin(), sizePerfTradeOff01);
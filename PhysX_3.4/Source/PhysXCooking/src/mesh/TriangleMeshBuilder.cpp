@@ -811,7 +811,33 @@ bool TriangleMeshBuilder::loadFromDesc(const PxTriangleMeshDesc& _desc, PxTriang
 		PX_DELETE_POD(topology);
 	}
 
+	buildImportedMesh(originalTriangleCount);
+	return true;
+}
+
+bool TriangleMeshBuilder::loadFromStream(const PxTriangleMeshStreamDesc& desc, PxTriangleMeshCookingResult::Enum* condition)
+{
+	if(!desc.isValid())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "TriangleMesh::loadFromStream: desc.isValid() failed!");
+		return false;
+	}
+
+	if(!mParams.midphaseDesc.isValid())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "TriangleMesh::loadFromStream: mParams.midphaseDesc.isValid() failed!");
+		return false;
+	}
+
+	if(!importMesh(desc, mParams, condition))
+		return false;
+
+	buildImportedMesh(desc.nbTriangles);
+	return true;
+}
 
+void TriangleMeshBuilder::buildImportedMesh(PxU32 originalTriangleCount)
+{
 	//copy the original triangle indices to grb triangle indices if buildGRBData is true
 	recordTriangleIndices();
 
@@ -823,13 +849,33 @@ bool TriangleMeshBuilder::loadFromDesc(const PxTriangleMeshDesc& _desc, PxTriang
 	createSharedEdgeData(mParams.buildTriangleAdjacencies, !(mParams.meshPreprocessParams & PxMeshPreprocessingFlag::eDISABLE_ACTIVE_EDGES_PRECOMPUTE));
 
 	createGRBMidPhaseAndData(originalTriangleCount);
-
-
-	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Zigzag varint of the difference with the previous index, so the small negative steps also take a single byte
+static void writeDeltaIndices(const PxU32* indices, PxU32 nbIndices, bool platformMismatch, PxOutputStream& stream)
+{
+	Ps::Array<PxU8> bytes;
+	bytes.reserve(nbIndices + nbIndices/2);
+	PxU32 previous = 0;
+	for(PxU32 i=0;i<nbIndices;i++)
+	{
+		const PxI32 delta = PxI32(indices[i] - previous);
+		PxU32 zigzag = (PxU32(delta)<<1) ^ PxU32(delta>>31);
+		previous = indices[i];
+		while(zigzag>=0x80)
+		{
+			bytes.pushBack(PxU8(zigzag|0x80));
+			zigzag >>= 7;
+		}
+		bytes.pushBack(PxU8(zigzag));
+	}
+
+	writeDword(bytes.size(), platformMismatch, stream);
+	stream.write(bytes.begin(), bytes.size());
+}
+
 bool TriangleMeshBuilder::save(PxOutputStream& stream, bool platformMismatch, const PxCookingParams& params) const
 {
 	// Export header
@@ -845,6 +891,8 @@ bool TriangleMeshBuilder::save(PxOutputStream& stream, bool platformMismatch, co
 	if(mMeshData.mFaceRemap)		serialFlags |= Gu::IMSF_FACE_REMAP;
 	if(mMeshData.mAdjacencies)		serialFlags |= Gu::IMSF_ADJACENCIES;
 	if (params.buildGPUData)		serialFlags |= Gu::IMSF_GRB_DATA;
+	if (params.meshPreprocessParams & PxMeshPreprocessingFlag::eCOMPRESS_INDICES)
+		serialFlags |= Gu::IMSF_DELTA_INDICES;
 	// Compute serialization flags for indices
 	PxU32 maxIndex=0;
 	const Gu::TriangleT<PxU32>* tris = reinterpret_cast<const Gu::TriangleT<PxU32>*>(mMeshData.mTriangles);
@@ -864,7 +912,9 @@ bool TriangleMeshBuilder::save(PxOutputStream& stream, bool platformMismatch, co
 	writeDword(mMeshData.mNbVertices, platformMismatch, stream);
 	writeDword(mMeshData.mNbTriangles, platformMismatch, stream);
 	writeFloatBuffer(&mMeshData.mVertices->x, mMeshData.mNbVertices*3, platformMismatch, stream);
-	if(serialFlags & Gu::IMSF_8BIT_INDICES)
+	if(serialFlags & Gu::IMSF_DELTA_INDICES)
+		writeDeltaIndices(tris->v, mMeshData.mNbTriangles*3, platformMismatch, stream);
+	else if(serialFlags & Gu::IMSF_8BIT_INDICES)
 	{
 		const PxU32* indices = tris->v;
 		for(PxU32 i=0;i<mMeshData.mNbTriangles*3;i++)
@@ -1031,6 +1081,73 @@ bool TriangleMeshBuilder::importMesh(const PxTriangleMeshDesc& desc,const PxCook
 		for(PxU32 i=0;i<mMeshData.mNbTriangles;i++)	PX_ASSERT(materials[i]!=0xffff);
 	}
 
+	return cleanImportedMesh(params, condition, validate);
+}
+
+bool TriangleMeshBuilder::importMesh(const PxTriangleMeshStreamDesc& desc, const PxCookingParams& params, PxTriangleMeshCookingResult::Enum* condition)
+{
+	// The chunks are read straight into the mesh arrays, which have no stride, so there is no intermediate copy
+	PxVec3* verts = mMeshData.allocateVertices(desc.nbVertices);
+	PxU32* tris = reinterpret_cast<PxU32*>(mMeshData.allocateTriangles(desc.nbTriangles, true, PxU32(params.buildGPUData)));
+	PxMaterialTableIndex* materials = desc.hasMaterialIndices ? mMeshData.allocateMaterials() : NULL;
+
+	for(PxU32 start=0;start<desc.nbVertices;start+=desc.chunkSize)
+	{
+		const PxU32 count = PxMin(desc.chunkSize, desc.nbVertices - start);
+		if(!desc.callback->readVertices(start, count, verts + start))
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "TriangleMesh::loadFromStream: reading the vertices failed");
+			return false;
+		}
+
+#if PX_CHECKED
+		for(PxU32 i=start;i<start+count;i++)
+		{
+			const PxVec3& p = verts[i];
+			if(!PxIsFinite(p.x) || !PxIsFinite(p.y) || !PxIsFinite(p.z))
+			{
+				Ps::getFoundation().error(PxErrorCode::eINTERNAL_ERROR, __FILE__, __LINE__, "input mesh contains corrupted vertex data");
+				return false;
+			}
+		}
+#endif
+	}
+
+	const bool flip = (desc.flags & PxMeshFlag::eFLIPNORMALS) ? true : false;
+	for(PxU32 start=0;start<desc.nbTriangles;start+=desc.chunkSize)
+	{
+		const PxU32 count = PxMin(desc.chunkSize, desc.nbTriangles - start);
+		PxU32* chunk = tris + start*3;
+		if(!desc.callback->readTriangles(start, count, chunk))
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "TriangleMesh::loadFromStream: reading the triangles failed");
+			return false;
+		}
+
+		// Unlike the descriptor the indices can't be validated upfront, so check them while they are hot
+		for(PxU32 i=0;i<count*3;i+=3)
+		{
+			if(chunk[i]>=desc.nbVertices || chunk[i+1]>=desc.nbVertices || chunk[i+2]>=desc.nbVertices)
+			{
+				Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "TriangleMesh::loadFromStream: triangle index out of range");
+				return false;
+			}
+			if(flip)
+				Ps::swap(chunk[i+1], chunk[i+2]);
+		}
+
+		if(materials && !desc.callback->readMaterialIndices(start, count, materials + start))
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "TriangleMesh::loadFromStream: reading the material indices failed");
+			return false;
+		}
+	}
+
+	return cleanImportedMesh(params, condition, false);
+}
+
+bool TriangleMeshBuilder::cleanImportedMesh(const PxCookingParams& params, PxTriangleMeshCookingResult::Enum* condition, bool validate)
+{
 	// Clean the mesh using ICE's MeshBuilder
 	// This fixes the bug in ConvexTest06 where the inertia tensor computation fails for a mesh => it works with a clean mesh
 
@@ -1186,7 +1303,7 @@ void BV4TriangleMeshBuilder::createMidPhaseStructure()
 
 	const PxU32 nbTrisPerLeaf = (mParams.midphaseDesc.getType() == PxMeshMidPhase::eBVH34) ? mParams.midphaseDesc.mBVH34Desc.numTrisPerLeaf : 4;
 
-	if(!BuildBV4Ex(mData.mBV4Tree, mData.mMeshInterface, gBoxEpsilon, nbTrisPerLeaf))
+	if(!BuildBV4Ex(mData.mBV4Tree, mData.mMeshInterface, gBoxEpsilon, nbTrisPerLeaf, mParams.dispatcher))
 	{
 		Ps::getFoundation().error(PxErrorCode::eINTERNAL_ERROR, __FILE__, __LINE__, "BV4 tree failed to build.");
 		return;
@@ -1375,7 +1492,7 @@ void RTreeTriangleMeshBuilder::createMidPhaseStructure()
 		mMeshData.mVertices, mMeshData.mNbVertices,
 		(mMeshData.mFlags & PxTriangleMeshFlag::e16_BIT_INDICES) ? reinterpret_cast<PxU16*>(mMeshData.mTriangles) : NULL,
 		!(mMeshData.mFlags & PxTriangleMeshFlag::e16_BIT_INDICES) ? reinterpret_cast<PxU32*>(mMeshData.mTriangles) : NULL,
-		mMeshData.mNbTriangles, resultPermute, &rc, meshSizePerformanceTradeOff, meshCookingHint);
+		mMeshData.mNbTriangles, resultPermute, &rc, meshSizePerformanceTradeOff, meshCookingHint, mParams.dispatcher);
 
 	PX_ASSERT(resultPermute.size() == mMeshData.mNbTriangles);
 
@@ -65,12 +65,16 @@ namespace physx
 				void						createGRBData();
 
 				bool						loadFromDesc(const PxTriangleMeshDesc&, PxTriangleMeshCookingResult::Enum* condition, bool validate = false);
+				bool						loadFromStream(const PxTriangleMeshStreamDesc&, PxTriangleMeshCookingResult::Enum* condition);
 				bool						save(PxOutputStream& stream, bool platformMismatch, const PxCookingParams& params) const;
 				void						checkMeshIndicesSize();
 	PX_FORCE_INLINE	Gu::TriangleMeshData&	getMeshData()	{ return mMeshData;	}
 	protected:
 				void						computeLocalBounds();
 				bool						importMesh(const PxTriangleMeshDesc& desc, const PxCookingParams& params, PxTriangleMeshCookingResult::Enum* condition, bool validate = false);
+				bool						importMesh(const PxTriangleMeshStreamDesc& desc, const PxCookingParams& params, PxTriangleMeshCookingResult::Enum* condition);
+				bool						cleanImportedMesh(const PxCookingParams& params, PxTriangleMeshCookingResult::Enum* condition, bool validate);
+				void						buildImportedMesh(PxU32 originalTriangleCount);
 
 				TriangleMeshBuilder& operator=(const TriangleMeshBuilder&);
 				Gu::EdgeListBuilder*		edgeList;
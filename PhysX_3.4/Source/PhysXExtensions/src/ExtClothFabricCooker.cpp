@@ -45,7 +45,7 @@ using namespace physx;
 
 struct physx::PxFabricCookerImpl
 {
-	bool cook(const PxClothMeshDesc& desc, PxVec3 gravity, bool useGeodesicTether);
+	bool cook(const PxClothMeshDesc& desc, PxVec3 gravity, bool useGeodesicTether, PxCpuDispatcher* dispatcher);
 
 	PxClothFabricDesc getDescriptor() const;
 	void save(PxOutputStream& stream, bool platformMismatch) const;
@@ -64,10 +64,10 @@ public:
 	shdfnd::Array<PxU32> mTriangles;
 };
 
-PxClothFabricCooker::PxClothFabricCooker(const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether)
+PxClothFabricCooker::PxClothFabricCooker(const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether, PxCpuDispatcher* dispatcher)
 : mImpl(new PxFabricCookerImpl())
 {
-	mImpl->cook(desc, gravity, useGeodesicTether);
+	mImpl->cook(desc, gravity, useGeodesicTether, dispatcher);
 }
 
 PxClothFabricCooker::~PxClothFabricCooker()
@@ -86,11 +86,11 @@ void PxClothFabricCooker::save(PxOutputStream& stream, bool platformMismatch) co
 }
 
 
-PxClothFabric* physx::PxClothFabricCreate( PxPhysics& physics, const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether )
+PxClothFabric* physx::PxClothFabricCreate( PxPhysics& physics, const PxClothMeshDesc& desc, const PxVec3& gravity, bool useGeodesicTether, PxCpuDispatcher* dispatcher )
 {
 	PxFabricCookerImpl impl;
 
-	if(!impl.cook(desc, gravity, useGeodesicTether))
+	if(!impl.cook(desc, gravity, useGeodesicTether, dispatcher))
 		return 0;
 
 	return physics.createClothFabric(impl.getDescriptor());
@@ -303,7 +303,7 @@ namespace
 
 } // anonymous namespace
 
-bool PxFabricCookerImpl::cook(const PxClothMeshDesc& desc, PxVec3 gravity, bool useGeodesicTether)
+bool PxFabricCookerImpl::cook(const PxClothMeshDesc& desc, PxVec3 gravity, bool useGeodesicTether, PxCpuDispatcher* dispatcher)
 {	
 	if(!desc.isValid())
 	{
@@ -571,7 +571,7 @@ bool PxFabricCookerImpl::cook(const PxClothMeshDesc& desc, PxVec3 gravity, bool
 
 	if (useGeodesicTether)
 	{
-		PxClothGeodesicTetherCooker tetherCooker(desc);
+		PxClothGeodesicTetherCooker tetherCooker(desc, dispatcher);
 		if (tetherCooker.getCookerStatus() == 0)
 		{
 			PxU32 numTethersPerParticle = tetherCooker.getNbTethersPerParticle();
@@ -618,9 +618,10 @@ physx::PxClothFabricDesc physx::PxFabricCookerImpl::getDescriptor() const
 void physx::PxFabricCookerImpl::save( PxOutputStream& stream, bool /*platformMismatch*/ ) const
 {
 	// version 1 is equivalent to 0x030300 and 0x030301 (PX_PHYSICS_VERSION of 3.3.0 and 3.3.1).
+	// version 2 adds the triangles at the end.
 	// If the stream format changes, the loader code in ScClothFabricCore.cpp 
 	// and the version number need to change too. 
-	PxU32 version = 1;
+	PxU32 version = 2;
 	stream.write(&version, sizeof(PxU32));
 
 	PxClothFabricDesc desc = getDescriptor();
@@ -643,6 +644,9 @@ void physx::PxFabricCookerImpl::save( PxOutputStream& stream, bool /*platformMis
 
 	stream.write(desc.tetherAnchors, desc.nbTethers*sizeof(PxU32));
 	stream.write(desc.tetherLengths, desc.nbTethers*sizeof(PxReal));
+
+	stream.write(&desc.nbTriangles, sizeof(PxU32));
+	stream.write(desc.triangles, desc.nbTriangles*3*sizeof(PxU32));
 }
 
 #endif //PX_USE_CLOTH_API
@@ -41,6 +41,10 @@
 #include <Ps.h>
 #include <PsMathUtils.h>
 #include "PsArray.h"
+#include "PsSync.h"
+#include "PsAtomic.h"
+#include "task/PxTask.h"
+#include "task/PxCpuDispatcher.h"
 
 using namespace physx;
 
@@ -314,7 +318,7 @@ namespace
 struct physx::PxClothGeodesicTetherCookerImpl
 {
 
-	PxClothGeodesicTetherCookerImpl(const PxClothMeshDesc& desc);
+	PxClothGeodesicTetherCookerImpl(const PxClothMeshDesc& desc, PxCpuDispatcher* dispatcher);
 
 	PxU32	getCookerStatus() const;
 	PxU32	getNbTethersPerParticle() const;
@@ -340,11 +344,63 @@ public:
 	shdfnd::Array<PxU32>	mTetherAnchors;
 	shdfnd::Array<PxReal>	mTetherLengths;
 
+	// the island searches and the tether lengths of each particle write to disjoint parts of the buffers,
+	// so they are split in batches running on the dispatcher
+	enum Pass
+	{
+		eISLAND_DISTANCES,
+		eTETHER_LENGTHS
+	};
+
+	void	runPass(Pass pass, PxU32 start, PxU32 count);
+	void	onTaskDone()	{ if(!shdfnd::atomicDecrement(&mPendingTasks)) mPassDone.set();	}
+
 protected:
+	class CookTask : public PxLightCpuTask
+	{
+		public:
+							CookTask() : mCooker(NULL), mPass(eISLAND_DISTANCES), mStart(0), mCount(0)	{}
+
+			void			setData(PxClothGeodesicTetherCookerImpl* cooker, Pass pass, PxU32 start, PxU32 count)	{ mCooker = cooker; mPass = pass; mStart = start; mCount = count;	}
+
+			virtual void	run()					{ mCooker->runPass(mPass, mStart, mCount);	}
+			// submitted straight to the dispatcher, there is no continuation
+			virtual void	release()				{ mCooker->onTaskDone();					}
+			virtual const char*	getName() const		{ return "PxClothGeodesicTetherCooker.cook";	}
+		private:
+			PxClothGeodesicTetherCookerImpl*	mCooker;
+			Pass								mPass;
+			PxU32								mStart;
+			PxU32								mCount;
+	};
+
+	static const PxU32		ISLANDS_PER_TASK = 1;
+	static const PxU32		PARTICLES_PER_TASK = 256;
+
+	// input of the island searches
+	shdfnd::Array<PxU32>	mValency;
+	shdfnd::Array<PxU32>	mNeighbors;
+	shdfnd::Array<PxU32>	mIslandFirst;
+	shdfnd::Array<PxU32>	mIslandIndices;
+	PxU32					mIslandCnt;
+	PxU32					mNbTethersPerParticle;
+
+	// distance and closest attached vertex of each island, mNumParticles per island
+	shdfnd::Array<float>	mVertexDistanceBuffer;
+	shdfnd::Array<PxU32>	mVertexParentBuffer;
+
+	PxCpuDispatcher*		mDispatcher;
+	shdfnd::Array<CookTask>	mTasks;
+	shdfnd::Sync			mPassDone;
+	volatile PxI32			mPendingTasks;
+
 	void	createTetherData(const PxClothMeshDesc &desc);
-	int		computeVertexIntersection(PxU32 parent, PxU32 src, PathIntersection &path);
-	int		computeEdgeIntersection(PxU32 parent, PxU32 edge, float in_s, PathIntersection &path);
-	float	computeGeodesicDistance(PxU32 i, PxU32 parent, int &errorCode);
+	void	dispatchPass(Pass pass, PxU32 nbItems, PxU32 itemsPerTask);
+	void	computeIslandDistances(PxU32 start, PxU32 count);
+	void	computeTetherLengths(PxU32 start, PxU32 count);
+	int		computeVertexIntersection(PxU32 parent, PxU32 src, PathIntersection &path) const;
+	int		computeEdgeIntersection(PxU32 parent, PxU32 edge, float in_s, PathIntersection &path) const;
+	float	computeGeodesicDistance(PxU32 i, PxU32 parent, int &errorCode) const;
 	PxU32	findTriNeighbors();
 	void	findVertTriNeighbors();
 
@@ -352,8 +408,8 @@ private:
 	PxClothGeodesicTetherCookerImpl& operator=(const PxClothGeodesicTetherCookerImpl&);
 };
 
-PxClothGeodesicTetherCooker::PxClothGeodesicTetherCooker(const PxClothMeshDesc& desc)
-: mImpl(new PxClothGeodesicTetherCookerImpl(desc))
+PxClothGeodesicTetherCooker::PxClothGeodesicTetherCooker(const PxClothMeshDesc& desc, PxCpuDispatcher* dispatcher)
+: mImpl(new PxClothGeodesicTetherCookerImpl(desc, dispatcher))
 {
 }
 
@@ -378,9 +434,13 @@ void PxClothGeodesicTetherCooker::getTetherData(PxU32* userTetherAnchors, PxReal
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-PxClothGeodesicTetherCookerImpl::PxClothGeodesicTetherCookerImpl(const PxClothMeshDesc &desc)
+PxClothGeodesicTetherCookerImpl::PxClothGeodesicTetherCookerImpl(const PxClothMeshDesc &desc, PxCpuDispatcher* dispatcher)
 	:mDesc(desc),
-	mCookerStatus(0)
+	mCookerStatus(0),
+	mIslandCnt(0),
+	mNbTethersPerParticle(0),
+	mDispatcher(dispatcher),
+	mPendingTasks(0)
 {
 	createTetherData(desc);
 }
@@ -419,7 +479,8 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 		return;
 
 	// build adjacent vertex list
-	shdfnd::Array<PxU32> valency(mNumParticles+1, 0);
+	shdfnd::Array<PxU32>& valency = mValency;
+	valency.resize(mNumParticles+1, 0);
 	shdfnd::Array<PxU32> adjacencies;
 	if(desc.flags & PxMeshFlag::e16_BIT_INDICES)
 		gatherAdjacencies<PxU16>(valency, adjacencies, desc.triangles, desc.quads);
@@ -428,7 +489,8 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 
 	// build unique neighbors from adjacencies
 	shdfnd::Array<PxU32> mark(valency.size(), 0);
-	shdfnd::Array<PxU32> neighbors; neighbors.reserve(adjacencies.size());
+	shdfnd::Array<PxU32>& neighbors = mNeighbors;
+	neighbors.reserve(adjacencies.size());
 	for(PxU32 i=1, j=0; i<valency.size(); ++i)
 	{
 		for(; j<valency[i]; ++j)
@@ -463,8 +525,8 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 		return;
 
 	// identify islands of attached vertices
-	shdfnd::Array<PxU32> islandIndices;
-	shdfnd::Array<PxU32> islandFirst;
+	shdfnd::Array<PxU32>& islandIndices = mIslandIndices;
+	shdfnd::Array<PxU32>& islandFirst = mIslandFirst;
 	PxU32 islandCnt = 0;
 	PxU32 islandIndexCnt = 0;
 
@@ -511,21 +573,88 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 	islandFirst.pushBack(islandIndexCnt);
 
 	PX_ASSERT(islandCnt == (islandFirst.size() - 1));
+	mIslandCnt = islandCnt;
 
 	/////////////////////////////////////////////////////////
 	PxU32 bufferSize = mNumParticles * islandCnt;
 	PX_ASSERT(bufferSize > 0);
 
-	shdfnd::Array<float> vertexDistanceBuffer(bufferSize, PX_MAX_F32);
-	shdfnd::Array<PxU32> vertexParentBuffer(bufferSize, 0);
-	shdfnd::Array<VertexDistanceCount> vertexHeap;
+	mVertexDistanceBuffer.resize(bufferSize, PX_MAX_F32);
+	mVertexParentBuffer.resize(bufferSize, 0);
 
 	// now process each island 
-	for (PxU32 i = 0; i < islandCnt; i++)
+	dispatchPass(eISLAND_DISTANCES, islandCnt, ISLANDS_PER_TASK);
+
+	const PxU32 maxTethersPerParticle = 4; // max tethers
+	mNbTethersPerParticle = (islandCnt > maxTethersPerParticle) ? maxTethersPerParticle : islandCnt;
+
+	PxU32 nbTethers = mNbTethersPerParticle * mNumParticles;
+	mTetherAnchors.resize(nbTethers);
+	mTetherLengths.resize(nbTethers);
+
+	// now process the parent and distance and add to fibers
+	dispatchPass(eTETHER_LENGTHS, mNumParticles, PARTICLES_PER_TASK);
+
+	// only the tethers are kept
+	mVertexDistanceBuffer.reset();
+	mVertexParentBuffer.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+namespace
+{
+	bool isSyncSet(void* sync)
+	{
+		return reinterpret_cast<shdfnd::Sync*>(sync)->wait(0);
+	}
+}
+
+// runs the pass over nbItems items, on the dispatcher's workers if there is more than one batch
+void PxClothGeodesicTetherCookerImpl::dispatchPass(Pass pass, PxU32 nbItems, PxU32 itemsPerTask)
+{
+	if(nbItems > itemsPerTask && mDispatcher && mDispatcher->getWorkerCount())
+	{
+		// the first batch is done by this thread
+		const PxU32 nbTasks = (nbItems - 1) / itemsPerTask;
+		mTasks.resize(nbTasks);
+
+		mPassDone.reset();
+		mPendingTasks = PxI32(nbTasks);
+		for(PxU32 i=0;i<nbTasks;i++)
+		{
+			const PxU32 start = (i+1) * itemsPerTask;
+			mTasks[i].setData(this, pass, start, PxMin(itemsPerTask, nbItems - start));
+			mDispatcher->submitTask(mTasks[i]);
+		}
+
+		runPass(pass, 0, itemsPerTask);
+
+		if(!mDispatcher->waitUntil(isSyncSet, &mPassDone))
+			mPassDone.wait();
+	}
+	else
+		runPass(pass, 0, nbItems);
+}
+
+void PxClothGeodesicTetherCookerImpl::runPass(Pass pass, PxU32 start, PxU32 count)
+{
+	if(pass == eISLAND_DISTANCES)
+		computeIslandDistances(start, count);
+	else
+		computeTetherLengths(start, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Dijkstra search from the attached vertices of each island
+void PxClothGeodesicTetherCookerImpl::computeIslandDistances(PxU32 start, PxU32 count)
+{
+	shdfnd::Array<VertexDistanceCount> vertexHeap;
+
+	for (PxU32 i = start; i < start + count; i++)
 	{
 		vertexHeap.clear();
-		float* vertexDistance = &vertexDistanceBuffer[0] + (i * mNumParticles);
-		PxU32* vertexParent = &vertexParentBuffer[0] + (i * mNumParticles);
+		float* vertexDistance = &mVertexDistanceBuffer[0] + (i * mNumParticles);
+		PxU32* vertexParent = &mVertexParentBuffer[0] + (i * mNumParticles);
 
 		// initialize parent and distance
 		for (PxU32 j = 0; j < mNumParticles; ++j)
@@ -535,11 +664,11 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 		}
 
 		// put all the attached vertices in this island to heap
-		const PxU32 beginIsland = islandFirst[i];
-		const PxU32 endIsland = islandFirst[i+1];
+		const PxU32 beginIsland = mIslandFirst[i];
+		const PxU32 endIsland = mIslandFirst[i+1];
 		for (PxU32 j = beginIsland; j < endIsland; j++)
 		{
-			PxU32 vj = islandIndices[j];
+			PxU32 vj = mIslandIndices[j];
 			vertexDistance[vj] = 0.0f;
 			vertexHeap.pushBack(VertexDistanceCount(int(vj), 0.0f, 0));
 		}
@@ -560,11 +689,11 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 				continue;
 
 			// for each adjacent vj that's not visited
-			const PxI32 begin = PxI32(valency[PxU32(vi.vertNr)]);
-			const PxI32 end = PxI32(valency[PxU32(vi.vertNr + 1)]);
+			const PxI32 begin = PxI32(mValency[PxU32(vi.vertNr)]);
+			const PxI32 end = PxI32(mValency[PxU32(vi.vertNr + 1)]);
 			for (PxI32 j = begin; j < end; ++j)
 			{
-				const PxI32 vj = PxI32(neighbors[PxU32(j)]);
+				const PxI32 vj = PxI32(mNeighbors[PxU32(j)]);
 				PxVec3 edge = mVertices[PxU32(vj)] - mVertices[PxU32(vi.vertNr)];
 				const PxF32 edgeLength = edge.magnitude();
 				float newDistance = vi.distance + edgeLength;
@@ -579,28 +708,28 @@ void PxClothGeodesicTetherCookerImpl::createTetherData(const PxClothMeshDesc &de
 			}
 		}
 	}
+}
 
-	const PxU32 maxTethersPerParticle = 4; // max tethers
-	const PxU32 nbTethersPerParticle = (islandCnt > maxTethersPerParticle) ? maxTethersPerParticle : islandCnt;
-
-	PxU32 nbTethers = nbTethersPerParticle * mNumParticles;
-	mTetherAnchors.resize(nbTethers);
-	mTetherLengths.resize(nbTethers);
+///////////////////////////////////////////////////////////////////////////////
+// tethers of each particle to the closest islands
+void PxClothGeodesicTetherCookerImpl::computeTetherLengths(PxU32 start, PxU32 count)
+{
+	shdfnd::Array<VertexDistanceCount> vertexHeap;
+	vertexHeap.reserve(mIslandCnt);
 
-	// now process the parent and distance and add to fibers
-	for (PxU32 i = 0; i < mNumParticles; i++)
+	for (PxU32 i = start; i < start + count; i++)
 	{
 		// we use the heap to sort out N-closest island
 		vertexHeap.clear();
-		for (PxU32 j = 0; j < islandCnt; j++)
+		for (PxU32 j = 0; j < mIslandCnt; j++)
 		{
-			int parent = int(vertexParentBuffer[j * mNumParticles + i]);
-			float edgeDistance = vertexDistanceBuffer[j * mNumParticles + i];
+			int parent = int(mVertexParentBuffer[j * mNumParticles + i]);
+			float edgeDistance = mVertexDistanceBuffer[j * mNumParticles + i];
 			pushHeap(vertexHeap, VertexDistanceCount(parent, edgeDistance, 0));
 		}
 
 		// take out N-closest island from the heap
-		for (PxU32 j = 0; j < nbTethersPerParticle; j++)
+		for (PxU32 j = 0; j < mNbTethersPerParticle; j++)
 		{
 			VertexDistanceCount vi = popHeap(vertexHeap);
 			PxU32 parent = PxU32(vi.vertNr);
@@ -730,7 +859,7 @@ void PxClothGeodesicTetherCookerImpl::findVertTriNeighbors()
 
 ///////////////////////////////////////////////////////////////////////////////
 // compute intersection of a ray from a source vertex in direction toward parent
-int PxClothGeodesicTetherCookerImpl::computeVertexIntersection(PxU32 parent, PxU32 src, PathIntersection &path)
+int PxClothGeodesicTetherCookerImpl::computeVertexIntersection(PxU32 parent, PxU32 src, PathIntersection &path) const
 {
 	if (src == parent)
 	{
@@ -849,7 +978,7 @@ int PxClothGeodesicTetherCookerImpl::computeVertexIntersection(PxU32 parent, PxU
 
 ///////////////////////////////////////////////////////////////////////////////
 // compute intersection of a ray from a source vertex in direction toward parent
-int PxClothGeodesicTetherCookerImpl::computeEdgeIntersection(PxU32 parent, PxU32 edge, float in_s, PathIntersection &path)
+int PxClothGeodesicTetherCookerImpl::computeEdgeIntersection(PxU32 parent, PxU32 edge, float in_s, PathIntersection &path) const
 {
 	int tid = int(edge / 3);
 	int eid = int(edge % 3);
@@ -965,7 +1094,7 @@ int PxClothGeodesicTetherCookerImpl::computeEdgeIntersection(PxU32 parent, PxU32
 
 ///////////////////////////////////////////////////////////////////////////////
 // compute geodesic distance and path from vertex i to its parent
-float PxClothGeodesicTetherCookerImpl::computeGeodesicDistance(PxU32 i, PxU32 parent, int &errorCode)
+float PxClothGeodesicTetherCookerImpl::computeGeodesicDistance(PxU32 i, PxU32 parent, int &errorCode) const
 {
 	if (i == parent)
 		return 0.0f;
@@ -0,0 +1,98 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#include "PxPhysXConfig.h"
+#if PX_USE_CLOTH_API
+
+#include "extensions/PxClothLod.h"
+#include "foundation/PxBounds3.h"
+
+using namespace physx;
+
+namespace
+{
+	bool isSameLod(const PxClothLod& a, const PxClothLod& b)
+	{
+		return a.solverFrequencyScale == b.solverFrequencyScale && a.phaseTypes == b.phaseTypes 
+			&& a.selfCollision == b.selfCollision && a.updateInterval == b.updateInterval;
+	}
+
+	PxU32 findLevel(const PxClothLodLevel* levels, PxU32 nbLevels, PxReal distance)
+	{
+		PxU32 level = 0;
+		while(level + 1 < nbLevels && distance >= levels[level + 1].distance)
+			++level;
+		return level;
+	}
+}
+
+PxU32 physx::PxClothUpdateLod(PxCloth* const* cloths, PxU32 nbCloths, const PxVec3& viewer,
+							  const PxClothLodLevel* levels, PxU32 nbLevels, PxReal hysteresis)
+{
+	if(!nbLevels)
+		return 0;
+
+	PxU32 nbChanged = 0;
+	for(PxU32 i = 0; i < nbCloths; i++)
+	{
+		PxCloth* cloth = cloths[i];
+
+		const PxBounds3 bounds = cloth->getWorldBounds();
+		const PxReal distance = (viewer.maximum(bounds.minimum).minimum(bounds.maximum) - viewer).magnitude();
+
+		// the hysteresis only applies to cloth already on one of the levels
+		const PxClothLod current = cloth->getLod();
+		PxU32 currentLevel = nbLevels;
+		for(PxU32 j = 0; j < nbLevels && currentLevel == nbLevels; j++)
+		{
+			if(isSameLod(current, levels[j].lod))
+				currentLevel = j;
+		}
+
+		PxU32 level;
+		if(currentLevel == nbLevels)
+			level = findLevel(levels, nbLevels, distance);
+		else
+		{
+			const PxU32 coarser = findLevel(levels, nbLevels, distance - hysteresis);
+			const PxU32 finer = findLevel(levels, nbLevels, distance + hysteresis);
+			level = coarser > currentLevel ? coarser : finer < currentLevel ? finer : currentLevel;
+		}
+
+		if(!isSameLod(current, levels[level].lod))
+		{
+			cloth->setLod(levels[level].lod);
+			nbChanged++;
+		}
+	}
+
+	return nbChanged;
+}
+
+#endif // PX_USE_CLOTH_API
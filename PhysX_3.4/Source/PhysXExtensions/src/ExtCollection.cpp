@@ -86,14 +86,12 @@ void PxCollectionExt::remove(PxCollection& collection, PxType concreteType, PxCo
 	{
 		PxBase& object = collection.getObject(i);
 		if(concreteType == object.getConcreteType())
-		{
-			if(to)
-			   to->add(object);	
-
 			removeObjects.pushBack(&object);
-		}
 	}
 
+	if(to)
+	   to->add(removeObjects.begin(), removeObjects.size());
+
 	for (PxU32 i = 0; i < removeObjects.size(); ++i)
 		collection.remove(*removeObjects[i]);
 }
@@ -104,6 +102,12 @@ PxCollection* PxCollectionExt::createCollection(PxPhysics& physics)
 	if (!collection)
 		return NULL;
 
+	PxU32 nbObjects = physics.getNbConvexMeshes() + physics.getNbTriangleMeshes() + physics.getNbHeightFields() + physics.getNbMaterials() + physics.getNbShapes();
+#if PX_USE_CLOTH_API
+	nbObjects += physics.getNbClothFabrics();
+#endif
+	collection->reserve(nbObjects);
+
 	// Collect convexes
 	{
 		shdfnd::Array<PxConvexMesh*> objects(physics.getNbConvexMeshes());
@@ -185,17 +189,20 @@ PxCollection* PxCollectionExt::createCollection(PxScene& scene)
 	if (!collection)
 		return NULL;
 
-	// Collect actors
-	{
-		PxActorTypeFlags selectionFlags = PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC;
+	PxActorTypeFlags selectionFlags = PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC;
 
 #if PX_USE_PARTICLE_SYSTEM_API
-		selectionFlags |= PxActorTypeFlag::ePARTICLE_SYSTEM | PxActorTypeFlag::ePARTICLE_FLUID;
+	selectionFlags |= PxActorTypeFlag::ePARTICLE_SYSTEM | PxActorTypeFlag::ePARTICLE_FLUID;
 #endif
 #if PX_USE_CLOTH_API
-		selectionFlags |= PxActorTypeFlag::eCLOTH;
+	selectionFlags |= PxActorTypeFlag::eCLOTH;
 #endif
 
+	// joints are counted through their constraints, which is an upper bound
+	collection->reserve(scene.getNbActors(selectionFlags) + scene.getNbConstraints() + scene.getNbArticulations() + scene.getNbAggregates());
+
+	// Collect actors
+	{
 		shdfnd::Array<PxActor*> objects(scene.getNbActors(selectionFlags));
 		const PxU32 nb = scene.getActors(selectionFlags, objects.begin(), objects.size());
 
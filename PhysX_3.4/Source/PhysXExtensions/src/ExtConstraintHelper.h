@@ -237,6 +237,24 @@ namespace Ext
 			PX_FORCE_INLINE PxU32 getCount() { return PxU32(mCurrent - mConstraints); }
 
 			void prepareLockedAxes(const PxQuat& qA, const PxQuat& qB, const PxVec3& cB2cAp, PxU32 lin, PxU32 ang)
+			{
+				prepareLockedAxesInternal(qA, qB, cB2cAp, lin, ang);
+			}
+
+			// same as above for axes known at compile time, the tests on the masks are folded away
+			template<PxU32 lin, PxU32 ang>
+			PX_FORCE_INLINE void prepareLockedAxes(const PxQuat& qA, const PxQuat& qB, const PxVec3& cB2cAp)
+			{
+				prepareLockedAxesInternal(qA, qB, cB2cAp, lin, ang);
+			}
+
+			Px1DConstraint *getConstraintRow()
+			{
+				return mCurrent++;
+			}
+
+		private:
+			PX_FORCE_INLINE void prepareLockedAxesInternal(const PxQuat& qA, const PxQuat& qB, const PxVec3& cB2cAp, PxU32 lin, PxU32 ang)
 			{
 				Px1DConstraint* current = mCurrent;
 				if(ang)
@@ -272,12 +290,6 @@ namespace Ext
 				mCurrent = current;
 			}
 
-			Px1DConstraint *getConstraintRow()
-			{
-				return mCurrent++;
-			}
-
-		private:
 			PX_FORCE_INLINE Px1DConstraint* linear(const PxVec3& axis, PxReal posErr, PxConstraintSolveHint::Enum hint)
 			{
 				Px1DConstraint* c = mCurrent++;
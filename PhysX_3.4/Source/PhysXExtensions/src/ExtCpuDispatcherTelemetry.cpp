@@ -0,0 +1,143 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "ExtCpuDispatcherTelemetry.h"
+#include "PsString.h"
+#include "foundation/PxMemory.h"
+
+using namespace physx;
+
+namespace
+{
+	PX_FORCE_INLINE PxU32 getHistogramBucket(PxU64 microseconds)
+	{
+		PxU32 bucket = 0;
+		while(bucket < PxDispatcherTaskStats::eHISTOGRAM_BUCKETS - 1 && microseconds >= (PxU64(1) << bucket))
+			bucket++;
+		return bucket;
+	}
+
+	PX_FORCE_INLINE PxU32 hashName(const char* name)
+	{
+		// Names are string literals, the pointer is enough to identify them
+		const size_t value = reinterpret_cast<size_t>(name);
+		return PxU32((value >> 4) ^ (value >> 12));
+	}
+
+	PX_FORCE_INLINE bool sameName(const char* a, const char* b)
+	{
+		if(a == b)
+			return true;
+		if(!a || !b)
+			return false;
+		return Ps::strcmp(a, b) == 0;
+	}
+}
+
+Ext::WorkerTelemetry::WorkerTelemetry()
+{
+	reset(0);
+}
+
+void Ext::WorkerTelemetry::reset(PxU32 resetCount)
+{
+	PxMemZero(mTasks, sizeof(mTasks));
+	PxMemZero(&mStats, sizeof(mStats));
+	mResetCount = resetCount;
+}
+
+void Ext::WorkerTelemetry::recordTask(const char* name, PxU64 waitTime, PxU64 runTime)
+{
+	const PxU64 runMicroseconds = runTime / 100;
+	const PxU64 waitMicroseconds = waitTime / 100;
+
+	mStats.busyTime += runMicroseconds;
+	mStats.nbTasks++;
+
+	// Open addressing on the name pointer, full tables fall back to the unnamed entry at the end
+	PxDispatcherTaskStats* stats = &mTasks[MAX_TASK_NAMES];
+	if(name)
+	{
+		const PxU32 start = hashName(name) % MAX_TASK_NAMES;
+		for(PxU32 i = 0; i < MAX_TASK_NAMES; i++)
+		{
+			PxDispatcherTaskStats& entry = mTasks[(start + i) % MAX_TASK_NAMES];
+			if(entry.name == name || !entry.name)
+			{
+				entry.name = name;
+				stats = &entry;
+				break;
+			}
+		}
+	}
+
+	stats->count++;
+	stats->runTime += runMicroseconds;
+	stats->waitTime += waitMicroseconds;
+	stats->runHistogram[getHistogramBucket(runMicroseconds)]++;
+	stats->waitHistogram[getHistogramBucket(waitMicroseconds)]++;
+}
+
+PxU32 Ext::WorkerTelemetry::gatherTaskStats(PxDispatcherTaskStats* stats, PxU32 nbStats, PxU32 maxStats) const
+{
+	for(PxU32 i = 0; i <= MAX_TASK_NAMES; i++)
+	{
+		const PxDispatcherTaskStats& src = mTasks[i];
+		if(!src.count)
+			continue;
+
+		// Linear search, there are a few dozen names at most and this only runs when polling
+		PxU32 index = 0;
+		while(index < nbStats && !sameName(stats[index].name, src.name))
+			index++;
+
+		if(index == nbStats)
+		{
+			if(nbStats == maxStats)
+				continue;
+
+			PxMemZero(&stats[index], sizeof(PxDispatcherTaskStats));
+			stats[index].name = src.name;
+			nbStats++;
+		}
+
+		PxDispatcherTaskStats& dst = stats[index];
+		dst.count += src.count;
+		dst.runTime += src.runTime;
+		dst.waitTime += src.waitTime;
+		for(PxU32 b = 0; b < PxDispatcherTaskStats::eHISTOGRAM_BUCKETS; b++)
+		{
+			dst.runHistogram[b] += src.runHistogram[b];
+			dst.waitHistogram[b] += src.waitHistogram[b];
+		}
+	}
+
+	return nbStats;
+}
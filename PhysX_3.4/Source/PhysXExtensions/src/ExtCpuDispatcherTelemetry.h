@@ -0,0 +1,76 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_NP_CPU_DISPATCHER_TELEMETRY_H
+#define PX_PHYSICS_EXTENSIONS_NP_CPU_DISPATCHER_TELEMETRY_H
+
+#include "CmPhysXCommon.h"
+#include "PxDefaultCpuDispatcher.h"
+
+namespace physx
+{
+namespace Ext
+{
+	// Statistics of a single worker. Only the worker writes them, so recording takes no atomics,
+	// readers polling them from other threads get approximate values.
+	class WorkerTelemetry
+	{
+	public:
+		// Distinct task names tracked per worker, the rest are merged in an unnamed entry
+		static const PxU32 MAX_TASK_NAMES = 128;
+
+								WorkerTelemetry();
+
+		// Times are in tens of nanoseconds (the unit of Ps::Time)
+				void			recordTask(const char* name, PxU64 waitTime, PxU64 runTime);
+		PX_FORCE_INLINE	void	recordIdle(PxU64 idleTime)	{ mStats.idleTime += idleTime / 100;	}
+		PX_FORCE_INLINE	void	recordSteal()				{ mStats.nbSteals++;					}
+
+		// Clears the statistics if resetTelemetry was called since the last check
+		PX_FORCE_INLINE	void	checkReset(PxU32 resetCount) { if(resetCount != mResetCount) reset(resetCount);	}
+
+		const PxDispatcherWorkerStats&	getStats()	const	{ return mStats;	}
+
+		// Adds the task statistics of this worker to the nbStats entries of the output, merging the names.
+		// Returns the new number of entries
+				PxU32			gatherTaskStats(PxDispatcherTaskStats* stats, PxU32 nbStats, PxU32 maxStats) const;
+
+	private:
+				void			reset(PxU32 resetCount);
+
+		PxDispatcherTaskStats	mTasks[MAX_TASK_NAMES + 1];
+		PxDispatcherWorkerStats	mStats;
+		PxU32					mResetCount;
+	};
+
+} // namespace Ext
+}
+
+#endif
@@ -0,0 +1,241 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "ExtCpuTopology.h"
+#include "PsAtomic.h"
+#include "PsString.h"
+#include "PsIntrinsics.h"
+#include "foundation/PxMath.h"
+
+#if PX_WINDOWS
+#include "windows/PsWindowsInclude.h"
+#elif PX_LINUX
+#include <stdio.h>
+#endif
+
+using namespace physx;
+
+namespace physx
+{
+	PxU32 PxDefaultCpuDispatcherComputeAffinityMasks(PxU32* affinityMasks, PxU32 numThreads, PxThreadPlacement::Enum placement, PxU32 node);
+	PxU32 PxGetCpuNodeCount();
+}
+
+PxU32 physx::PxDefaultCpuDispatcherComputeAffinityMasks(PxU32* affinityMasks, PxU32 numThreads, PxThreadPlacement::Enum placement, PxU32 node)
+{
+	const Ext::CpuTopology* topology = Ext::CpuTopology::get();
+	if(!topology)
+	{
+		for(PxU32 i = 0; i < numThreads; i++)
+			affinityMasks[i] = 0;
+		return 0;
+	}
+
+	return Ext::computeAffinityMasks(*topology, affinityMasks, numThreads, placement, node);
+}
+
+PxU32 physx::PxGetCpuNodeCount()
+{
+	const Ext::CpuTopology* topology = Ext::CpuTopology::get();
+	return topology ? topology->nbNodes : 0;
+}
+
+namespace
+{
+	// Maps the ids reported by the OS (sparse, and per package for the core ids) to dense indices
+	PxU32 getDenseIndex(PxU64* ids, PxU32& nbIds, PxU64 id)
+	{
+		for(PxU32 i = 0; i < nbIds; i++)
+		{
+			if(ids[i] == id)
+				return i;
+		}
+		ids[nbIds] = id;
+		return nbIds++;
+	}
+
+	// Adds a CPU given the raw ids of its package and core
+	void addCpu(Ext::CpuTopology& topology, PxU64* nodeIds, PxU64* coreIds, PxU32 cpuIndex, PxU64 nodeId, PxU64 coreId)
+	{
+		const PxU32 index = topology.nbCpus++;
+		topology.cpuIndex[index] = cpuIndex;
+		topology.nodeIndex[index] = getDenseIndex(nodeIds, topology.nbNodes, nodeId);
+		topology.coreIndex[index] = getDenseIndex(coreIds, topology.nbCores, (nodeId << 32) | coreId);
+
+		topology.smtIndex[index] = 0;
+		for(PxU32 i = 0; i < index; i++)
+		{
+			if(topology.coreIndex[i] == topology.coreIndex[index])
+				topology.smtIndex[index]++;
+		}
+	}
+
+#if PX_LINUX
+	bool readSysfsId(PxU32 cpu, const char* name, PxU64& id)
+	{
+		char path[128];
+		Ps::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/%s", cpu, name);
+
+		FILE* f = fopen(path, "r");
+		if(!f)
+			return false;
+
+		long value;
+		const int n = fscanf(f, "%ld", &value);
+		fclose(f);
+
+		// Some virtual machines report -1
+		id = PxU64(value < 0 ? 0 : value);
+		return n == 1;
+	}
+#endif
+
+	bool queryTopology(Ext::CpuTopology& topology)
+	{
+		PxU64 nodeIds[Ext::CpuTopology::MAX_CPUS];
+		PxU64 coreIds[Ext::CpuTopology::MAX_CPUS];
+
+		topology.nbCpus = 0;
+		topology.nbCores = 0;
+		topology.nbNodes = 0;
+
+#if PX_LINUX
+		// https://www.kernel.org/doc/Documentation/cputopology.txt
+		// Offline CPUs don't have a topology directory and are skipped
+		for(PxU32 cpu = 0; cpu < Ext::CpuTopology::MAX_CPUS; cpu++)
+		{
+			PxU64 nodeId, coreId;
+			if(readSysfsId(cpu, "physical_package_id", nodeId) && readSysfsId(cpu, "core_id", coreId))
+				addCpu(topology, nodeIds, coreIds, cpu, nodeId, coreId);
+		}
+#elif PX_WINDOWS
+		DWORD length = 0;
+		if(GetLogicalProcessorInformation(NULL, &length) || GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+			return false;
+
+		SYSTEM_LOGICAL_PROCESSOR_INFORMATION* buffer = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION*>(PX_ALLOC(length, "CpuTopology"));
+		if(!buffer)
+			return false;
+
+		if(GetLogicalProcessorInformation(buffer, &length))
+		{
+			const PxU32 count = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+			for(PxU32 cpu = 0; cpu < Ext::CpuTopology::MAX_CPUS; cpu++)
+			{
+				const ULONG_PTR bit = ULONG_PTR(1) << cpu;
+				PxU64 nodeId = 0, coreId = 0;
+				bool hasCore = false;
+
+				// The entry index identifies the core or package
+				for(PxU32 i = 0; i < count; i++)
+				{
+					if(!(buffer[i].ProcessorMask & bit))
+						continue;
+
+					if(buffer[i].Relationship == RelationProcessorCore)
+					{
+						coreId = i;
+						hasCore = true;
+					}
+					else if(buffer[i].Relationship == RelationProcessorPackage)
+					{
+						nodeId = i;
+					}
+				}
+
+				if(hasCore)
+					addCpu(topology, nodeIds, coreIds, cpu, nodeId, coreId);
+			}
+		}
+
+		PX_FREE(buffer);
+#endif
+
+		return topology.nbCpus != 0;
+	}
+
+	Ext::CpuTopology	gTopology;
+	volatile PxI32		gTopologyState = 0;	// 0 not queried, 1 valid, -1 not available
+}
+
+const Ext::CpuTopology* Ext::CpuTopology::get()
+{
+	if(!gTopologyState)
+	{
+		// Threads racing here compute the same result
+		CpuTopology topology;
+		const bool valid = queryTopology(topology);
+		if(valid)
+			gTopology = topology;
+		Ps::memoryBarrier();
+		Ps::atomicExchange(&gTopologyState, valid ? 1 : -1);
+	}
+
+	return gTopologyState > 0 ? &gTopology : NULL;
+}
+
+PxU32 Ext::computeAffinityMasks(const CpuTopology& topology, PxU32* affinityMasks, PxU32 numThreads, PxThreadPlacement::Enum placement, PxU32 node)
+{
+	if(placement == PxThreadPlacement::eDEFAULT || !topology.nbCpus)
+	{
+		for(PxU32 i = 0; i < numThreads; i++)
+			affinityMasks[i] = 0;
+		return 0;
+	}
+
+	node = node % topology.nbNodes;
+
+	PxU32 maxSmtIndex = 0;
+	for(PxU32 i = 0; i < topology.nbCpus; i++)
+		maxSmtIndex = PxMax(maxSmtIndex, topology.smtIndex[i]);
+
+	// Primary hardware threads node by node, then their siblings. Solver threads sharing a core compete for the same execution units
+	PxU32 order[CpuTopology::MAX_CPUS];
+	PxU32 nbOrdered = 0;
+	for(PxU32 smt = 0; smt <= maxSmtIndex; smt++)
+	{
+		for(PxU32 n = 0; n < topology.nbNodes; n++)
+		{
+			if(placement == PxThreadPlacement::eSINGLE_NODE && n != node)
+				continue;
+
+			for(PxU32 i = 0; i < topology.nbCpus; i++)
+			{
+				if(topology.smtIndex[i] == smt && topology.nodeIndex[i] == n)
+					order[nbOrdered++] = i;
+			}
+		}
+	}
+
+	for(PxU32 i = 0; i < numThreads; i++)
+		affinityMasks[i] = 1u << topology.cpuIndex[order[i % nbOrdered]];
+
+	return PxMin(numThreads, nbOrdered);
+}
@@ -0,0 +1,66 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_CPU_TOPOLOGY_H
+#define PX_PHYSICS_EXTENSIONS_CPU_TOPOLOGY_H
+
+#include "CmPhysXCommon.h"
+#include "PxDefaultCpuDispatcher.h"
+
+namespace physx
+{
+
+namespace Ext
+{
+	// Logical CPUs of the machine, grouped in physical cores and nodes (sockets)
+	// Limited to the CPUs that fit on a 32 bit affinity mask
+	struct CpuTopology
+	{
+		static const PxU32 MAX_CPUS = 32;
+
+		PxU32	nbCpus;
+		PxU32	nbCores;
+		PxU32	nbNodes;
+		PxU32	cpuIndex[MAX_CPUS];		// Bit of the CPU on the affinity mask
+		PxU32	coreIndex[MAX_CPUS];	// Dense physical core index, unique across nodes
+		PxU32	nodeIndex[MAX_CPUS];	// Dense node index
+		PxU32	smtIndex[MAX_CPUS];		// 0 for the first hardware thread of a core, 1 for its first sibling...
+
+		// Reads the topology once and caches it. Returns NULL if it can't be detected on this platform
+		static const CpuTopology* get();
+	};
+
+	// Fills the masks following the policy, returns the number of distinct CPUs used
+	PxU32 computeAffinityMasks(const CpuTopology& topology, PxU32* affinityMasks, PxU32 numThreads, PxThreadPlacement::Enum placement, PxU32 node);
+
+} // namespace Ext
+}
+
+#endif
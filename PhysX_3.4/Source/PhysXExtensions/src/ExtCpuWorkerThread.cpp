@@ -33,11 +33,14 @@
 #include "ExtDefaultCpuDispatcher.h"
 #include "ExtTaskQueueHelper.h"
 #include "PsFPU.h"
+#include "PsTime.h"
 
 using namespace physx;
 
 Ext::CpuWorkerThread::CpuWorkerThread()
-:	mQueueEntryPool(EXT_TASK_QUEUE_ENTRY_POOL_SIZE),
+:	mParked(0),
+	mFetchedSubmitTime(0),
+	mQueueEntryPool(EXT_TASK_QUEUE_ENTRY_POOL_SIZE),
 	mThreadId(0)
 {
 }
@@ -54,13 +57,14 @@ void Ext::CpuWorkerThread::initialize(DefaultCpuDispatcher* ownerDispatcher)
 }
 
 
-bool Ext::CpuWorkerThread::tryAcceptJobToLocalQueue(PxBaseTask& task, Ps::Thread::Id taskSubmitionThread)
+bool Ext::CpuWorkerThread::tryAcceptJobToLocalQueue(PxBaseTask& task, Ps::Thread::Id taskSubmitionThread, PxU64 submitTime)
 {
 	if(taskSubmitionThread == mThreadId)
 	{
 		SharedQueueEntry* entry = mQueueEntryPool.getEntry(&task);
 		if (entry)
 		{
+			entry->mSubmitTime = submitTime;
 			mLocalJobList.push(*entry);
 			return true;
 		}
@@ -72,9 +76,9 @@ bool Ext::CpuWorkerThread::tryAcceptJobToLocalQueue(PxBaseTask& task, Ps::Thread
 }
 
 
-PxBaseTask* Ext::CpuWorkerThread::giveUpJob()
+PxBaseTask* Ext::CpuWorkerThread::giveUpJob(PxU64* submitTime)
 {
-	return TaskQueueHelper::fetchTask(mLocalJobList, mQueueEntryPool);
+	return TaskQueueHelper::fetchTask(mLocalJobList, mQueueEntryPool, submitTime);
 }
 
 
@@ -84,22 +88,39 @@ void Ext::CpuWorkerThread::execute()
 
 	while (!quitIsSignalled())
     {
-        mOwner->resetWakeSignal();
+		const bool telemetry = mOwner->isTelemetryEnabled();
+		if(telemetry)
+			mTelemetry.checkReset(mOwner->getTelemetryResetCount());
+		mFetchedSubmitTime = 0;
 
-		PxBaseTask* task = TaskQueueHelper::fetchTask(mLocalJobList, mQueueEntryPool);
+		// High priority tasks come before the local ones, everything else is handled by fetchNextTask
+		PxBaseTask* task = mOwner->getHighPriorityJob(&mFetchedSubmitTime);
 
 		if(!task)
-			task = mOwner->fetchNextTask();
+			task = TaskQueueHelper::fetchTask(mLocalJobList, mQueueEntryPool, &mFetchedSubmitTime);
+
+		if(!task)
+			task = mOwner->fetchNextTask(*this);
+
+		if(!task)
+		{
+			const PxU64 idleStart = telemetry ? Ps::Time::getCurrentTimeInTensOfNanoSeconds() : 0;
+			task = mOwner->waitForTask(*this);
+			if(telemetry)
+				mTelemetry.recordIdle(Ps::Time::getCurrentTimeInTensOfNanoSeconds() - idleStart);
+		}
 		
 		if (task)
 		{
-			mOwner->runTask(*task);
+			if(mFetchedSubmitTime)
+				mOwner->taskDequeued();
+
+			if(telemetry)
+				mOwner->runTaskWithTelemetry(*this, *task);
+			else
+				mOwner->runTask(*task);
 			task->release();
 		}
-		else
-		{
-			mOwner->waitForWork();
-		}
 	}
 
 	quit();
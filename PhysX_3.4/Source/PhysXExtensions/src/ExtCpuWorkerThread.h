@@ -33,8 +33,10 @@
 
 #include "CmPhysXCommon.h"
 #include "PsThread.h"
+#include "PsSync.h"
 #include "ExtDefaultCpuDispatcher.h"
 #include "ExtSharedQueueEntryPool.h"
+#include "ExtCpuDispatcherTelemetry.h"
 
 
 namespace physx
@@ -57,10 +59,18 @@ class DefaultCpuDispatcher;
 		
 		void					initialize(DefaultCpuDispatcher* ownerDispatcher);
 		void					execute();
-		bool					tryAcceptJobToLocalQueue(PxBaseTask& task, Ps::Thread::Id taskSubmitionThread);
-		PxBaseTask*				giveUpJob();
+		bool					tryAcceptJobToLocalQueue(PxBaseTask& task, Ps::Thread::Id taskSubmitionThread, PxU64 submitTime = 0);
+		PxBaseTask*				giveUpJob(PxU64* submitTime = NULL);
 		Ps::Thread::Id			getWorkerThreadId() const { return mThreadId; }
 
+		// Parking state, see DefaultCpuDispatcher::waitForTask. Each worker has its own semaphore so it can be woken alone
+		Ps::Sync				mWakeSignal;
+		volatile PxI32			mParked;
+
+		// Telemetry, only written by this worker. mFetchedSubmitTime is the time stamp of the last task it fetched
+		PxU64					mFetchedSubmitTime;
+		WorkerTelemetry			mTelemetry;
+
 	protected:
 		SharedQueueEntryPool<>			mQueueEntryPool;
 		DefaultCpuDispatcher*			mOwner;
@@ -81,6 +81,37 @@ namespace Ext
 		PX_ASSERT(cB2w.isValid());
 		PX_ASSERT(cB2cA.isValid());
 
+		// Common configurations get their own paths with the masks known at compile time. The masks are only recomputed
+		// by prepareData when the motions change, and these paths write the same rows as the generic code below.
+		if(!driving)
+		{
+			if(!limited)
+			{
+				if(locked == (LINEAR_MASK | ANGULAR_MASK))		// fixed
+				{
+					g.prepareLockedAxes<7, 7>(cA2w.q, cB2w.q, cB2cA.p);
+					return g.getCount();
+				}
+				if(locked == LINEAR_MASK)						// spherical without limit
+				{
+					g.prepareLockedAxes<7, 0>(cA2w.q, cB2w.q, cB2cA.p);
+					return g.getCount();
+				}
+			}
+			else if(limited == TWIST_FLAG && locked == (LINEAR_MASK | SWING1_FLAG | SWING2_FLAG))	// revolute with limit
+			{
+				PxQuat swing, twist;
+				Ps::separateSwingTwist(cB2cA.q,swing,twist);
+
+				const PxMat33 cB2w_m(cB2w.q);
+				g.quarterAnglePair(Ps::tanHalf(twist.x, twist.w), data.tqTwistLow, data.tqTwistHigh, data.tqTwistPad,
+					cB2w_m[0], data.twistLimit);
+
+				g.prepareLockedAxes<7, 6>(cA2w.q, cB2w.q, cB2cA.p);
+				return g.getCount();
+			}
+		}
+
 		PxMat33 cA2w_m(cA2w.q), cB2w_m(cB2w.q);
 
 		// handy for swing computation
@@ -32,17 +32,33 @@
 #include "ExtCpuWorkerThread.h"
 #include "ExtTaskQueueHelper.h"
 #include "PsString.h"
+#include "PsAtomic.h"
+#include "PsIntrinsics.h"
+#include "PsTime.h"
+#include "foundation/PxMath.h"
+
+#if PX_X86 || PX_X64
+#include <emmintrin.h>
+#endif
 
 using namespace physx;
 
 namespace physx
 {
-	PxDefaultCpuDispatcher* PxDefaultCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks);
+	PxDefaultCpuDispatcher* PxDefaultCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks, const PxDefaultCpuDispatcherWaitPolicy* waitPolicy);
+}
+
+PxDefaultCpuDispatcher* physx::PxDefaultCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks, const PxDefaultCpuDispatcherWaitPolicy* waitPolicy)
+{
+	return PX_NEW(Ext::DefaultCpuDispatcher)(numThreads, affinityMasks, waitPolicy);
 }
 
-PxDefaultCpuDispatcher* physx::PxDefaultCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks)
+// Tells the core it's a spin wait, which saves power and frees resources for the other hardware thread
+static PX_FORCE_INLINE void spinPause()
 {
-	return PX_NEW(Ext::DefaultCpuDispatcher)(numThreads, affinityMasks);
+#if PX_X86 || PX_X64
+	_mm_pause();
+#endif
 }
 
 #if !PX_PS4 && !PX_XBOXONE && !PX_SWITCH
@@ -55,13 +71,17 @@ void Ext::DefaultCpuDispatcher::getAffinityMasks(PxU32* affinityMasks, PxU32 thr
 }
 #endif
 
-Ext::DefaultCpuDispatcher::DefaultCpuDispatcher(PxU32 numThreads, PxU32* affinityMasks)
-	: mQueueEntryPool(EXT_TASK_QUEUE_ENTRY_POOL_SIZE, "QueueEntryPool"), mNumThreads(numThreads), mShuttingDown(false)
+Ext::DefaultCpuDispatcher::DefaultCpuDispatcher(PxU32 numThreads, PxU32* affinityMasks, const PxDefaultCpuDispatcherWaitPolicy* waitPolicy)
+	: mQueueEntryPool(EXT_TASK_QUEUE_ENTRY_POOL_SIZE, "QueueEntryPool"), mNbHighPriorityJobs(0), mNbLowPriorityJobs(0), mNumThreads(numThreads),
+	mSpinTime(waitPolicy ? PxU64(waitPolicy->spinMicroseconds) * 100 : 0),
+	mYieldTime(waitPolicy ? PxU64(waitPolicy->yieldMicroseconds) * 100 : 0),
+	mNbParkedWorkers(0), mShuttingDown(false)
 #if PX_PROFILE
 	,mRunProfiled(true)
 #else
 	,mRunProfiled(false)
 #endif
+	,mTelemetryEnabled(false), mTelemetryResetCount(0), mQueueDepth(0), mMaxQueueDepth(0)
 {
 	PxU32* defaultAffinityMasks = NULL;
 
@@ -114,7 +134,9 @@ Ext::DefaultCpuDispatcher::~DefaultCpuDispatcher()
 		mWorkerThreads[i].signalQuit();
 
 	mShuttingDown = true;
-	mWorkReady.set();
+	Ps::memoryBarrier();
+	for(PxU32 i = 0; i < mNumThreads; ++i)
+		mWorkerThreads[i].mWakeSignal.set();
 	for(PxU32 i = 0; i < mNumThreads; ++i)
 		mWorkerThreads[i].waitForQuit();
 
@@ -137,28 +159,123 @@ void Ext::DefaultCpuDispatcher::submitTask(PxBaseTask& task)
 		return;
 	}	
 
+	// Stamp the task for the queue wait time. 0 means not stamped, so the stamp is at least 1
+	PxU64 submitTime = 0;
+	if(mTelemetryEnabled)
+	{
+		submitTime = PxMax(Ps::Time::getCurrentTimeInTensOfNanoSeconds(), PxU64(1));
+		Ps::atomicMax(&mMaxQueueDepth, Ps::atomicIncrement(&mQueueDepth));
+	}
+
+	if(task.getPriority() == PxTaskPriority::eHIGH)
+	{
+		if(TaskQueueHelper::submitCountedTask(mHighPriorityJobList, mNbHighPriorityJobs, task, mQueueEntryPool, submitTime))
+			wakeOneWorker();
+		return;
+	}
+
+	if(task.getPriority() == PxTaskPriority::eLOW)
+	{
+		if(TaskQueueHelper::submitCountedTask(mLowPriorityJobList, mNbLowPriorityJobs, task, mQueueEntryPool, submitTime))
+			wakeOneWorker();
+		return;
+	}
+
 	// TODO: Could use TLS to make this more efficient
 	const Ps::Thread::Id currentThread = Ps::Thread::getId();
 	for(PxU32 i = 0; i < mNumThreads; ++i)
 	{
-		if(mWorkerThreads[i].tryAcceptJobToLocalQueue(task, currentThread))
-			return mWorkReady.set();
+		if(mWorkerThreads[i].tryAcceptJobToLocalQueue(task, currentThread, submitTime))
+			return wakeOneWorker();
 	}
 
 	SharedQueueEntry* entry = mQueueEntryPool.getEntry(&task);
 	if (entry)
 	{
+		entry->mSubmitTime = submitTime;
 		mJobList.push(*entry);
-		mWorkReady.set();
+		wakeOneWorker();
+	}
+}
+
+void Ext::DefaultCpuDispatcher::wakeOneWorker()
+{
+	// Pairs with the barrier in waitForTask: either the parking worker sees the new task on its last check, or we see it parked
+	Ps::memoryBarrier();
+	if(!mNbParkedWorkers)
+		return;
+
+	for(PxU32 i = 0; i < mNumThreads; ++i)
+	{
+		CpuWorkerThread& worker = mWorkerThreads[i];
+		if(worker.mParked && Ps::atomicCompareExchange(&worker.mParked, 0, 1) == 1)
+		{
+			Ps::atomicDecrement(&mNbParkedWorkers);
+			worker.mWakeSignal.set();
+			return;
+		}
+	}
+}
+
+PxBaseTask* Ext::DefaultCpuDispatcher::waitForTask(CpuWorkerThread& worker)
+{
+	// Spin and then yield while looking for tasks, which hides the kernel wake up latency of short gaps between task bursts
+	if(mSpinTime || mYieldTime)
+	{
+		const PxU64 start = Ps::Time::getCurrentTimeInTensOfNanoSeconds();
+		while(!mShuttingDown)
+		{
+			const PxU64 elapsed = Ps::Time::getCurrentTimeInTensOfNanoSeconds() - start;
+			if(elapsed >= mSpinTime + mYieldTime)
+				break;
+
+			if(elapsed < mSpinTime)
+			{
+				for(PxU32 i = 0; i < 32; ++i)
+					spinPause();
+			}
+			else
+			{
+				Ps::Thread::yield();
+			}
+
+			if(PxBaseTask* task = worker.giveUpJob(&worker.mFetchedSubmitTime))
+				return task;
+			if(PxBaseTask* task = fetchNextTask(worker))
+				return task;
+		}
+	}
+
+	// Park. The state is published before the last check so a task submitted meanwhile can't be missed
+	worker.mWakeSignal.reset();
+	Ps::atomicExchange(&worker.mParked, 1);
+	Ps::atomicIncrement(&mNbParkedWorkers);
+
+	PxBaseTask* task = mShuttingDown ? NULL : fetchNextTask(worker);
+	if(task || mShuttingDown)
+	{
+		// If a submitter already took the parked flag it also set the signal, which is reset before the next park
+		if(Ps::atomicCompareExchange(&worker.mParked, 0, 1) == 1)
+			Ps::atomicDecrement(&mNbParkedWorkers);
+		return task;
 	}
+
+	worker.mWakeSignal.wait();
+	return NULL;
 }
 
-PxBaseTask* Ext::DefaultCpuDispatcher::fetchNextTask()
+PxBaseTask* Ext::DefaultCpuDispatcher::fetchNextTask(CpuWorkerThread& worker)
 {
-	PxBaseTask* task = getJob();
+	PxBaseTask* task = getHighPriorityJob(&worker.mFetchedSubmitTime);
 
 	if(!task)
-		task = stealJob();
+		task = getJob(&worker.mFetchedSubmitTime);
+
+	if(!task)
+		task = stealJob(worker);
+
+	if(!task)
+		task = TaskQueueHelper::fetchCountedTask(mLowPriorityJobList, mNbLowPriorityJobs, mQueueEntryPool, &worker.mFetchedSubmitTime);
 
 	return task;
 }
@@ -168,44 +285,76 @@ void Ext::DefaultCpuDispatcher::release()
 	PX_DELETE(this);
 }
 
-PxBaseTask* Ext::DefaultCpuDispatcher::getJob(void)
+PxBaseTask* Ext::DefaultCpuDispatcher::getJob(PxU64* submitTime)
 {
-	return TaskQueueHelper::fetchTask(mJobList, mQueueEntryPool);
+	return TaskQueueHelper::fetchTask(mJobList, mQueueEntryPool, submitTime);
 }
 
-PxBaseTask* Ext::DefaultCpuDispatcher::stealJob()
+PxBaseTask* Ext::DefaultCpuDispatcher::getHighPriorityJob(PxU64* submitTime)
+{
+	return TaskQueueHelper::fetchCountedTask(mHighPriorityJobList, mNbHighPriorityJobs, mQueueEntryPool, submitTime);
+}
+
+PxBaseTask* Ext::DefaultCpuDispatcher::stealJob(CpuWorkerThread& thief)
 {
 	PxBaseTask* ret = NULL;
 
 	for(PxU32 i = 0; i < mNumThreads; ++i)
 	{
-		ret = mWorkerThreads[i].giveUpJob();
+		ret = mWorkerThreads[i].giveUpJob(&thief.mFetchedSubmitTime);
 
 		if(ret != NULL)
+		{
+			if(mTelemetryEnabled && &mWorkerThreads[i] != &thief)
+				thief.mTelemetry.recordSteal();
 			break;
+		}
 	}
 
 	return ret;
 }
 
-void Ext::DefaultCpuDispatcher::resetWakeSignal()
-{
-	mWorkReady.reset();
-	
-	// The code below is necessary to avoid deadlocks on shut down.
-	// A thread usually loops as follows:
-	// while quit is not signaled
-	// 1)  reset wake signal
-	// 2)  fetch work
-	// 3)  if work -> process
-	// 4)  else -> wait for wake signal
-	//
-	// If a thread reaches 1) after the thread pool signaled wake up,
-	// the wake up sync gets reset and all other threads which have not
-	// passed 4) already will wait forever.
-	// The code below makes sure that on shutdown, the wake up signal gets
-	// sent again after it was reset
-	//
-	if (mShuttingDown)
-		mWorkReady.set();
+void Ext::DefaultCpuDispatcher::runTaskWithTelemetry(CpuWorkerThread& worker, PxBaseTask& task)
+{
+	const PxU64 start = Ps::Time::getCurrentTimeInTensOfNanoSeconds();
+	runTask(task);
+	const PxU64 end = Ps::Time::getCurrentTimeInTensOfNanoSeconds();
+
+	const PxU64 submitTime = worker.mFetchedSubmitTime;
+	worker.mTelemetry.recordTask(task.getName(), submitTime && submitTime < start ? start - submitTime : 0, end - start);
+}
+
+bool Ext::DefaultCpuDispatcher::setTelemetryEnabled(bool enabled)
+{
+	mTelemetryEnabled = enabled;
+	return true;
+}
+
+PxU32 Ext::DefaultCpuDispatcher::getTaskTelemetry(PxDispatcherTaskStats* stats, PxU32 maxStats) const
+{
+	PxU32 nbStats = 0;
+	for(PxU32 i = 0; i < mNumThreads; ++i)
+		nbStats = mWorkerThreads[i].mTelemetry.gatherTaskStats(stats, nbStats, maxStats);
+	return nbStats;
+}
+
+PxU32 Ext::DefaultCpuDispatcher::getWorkerTelemetry(PxDispatcherWorkerStats* stats, PxU32 maxStats) const
+{
+	const PxU32 nbStats = PxMin(maxStats, mNumThreads);
+	for(PxU32 i = 0; i < nbStats; ++i)
+		stats[i] = mWorkerThreads[i].mTelemetry.getStats();
+	return nbStats;
+}
+
+void Ext::DefaultCpuDispatcher::getQueueTelemetry(PxU32& depth, PxU32& maxDepth) const
+{
+	depth = PxU32(PxMax(mQueueDepth, 0));
+	maxDepth = PxU32(PxMax(mMaxQueueDepth, 0));
 }
+
+void Ext::DefaultCpuDispatcher::resetTelemetry()
+{
+	mMaxQueueDepth = mQueueDepth;
+	Ps::atomicIncrement(&mTelemetryResetCount);
+}
+
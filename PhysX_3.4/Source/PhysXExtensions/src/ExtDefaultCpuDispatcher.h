@@ -39,6 +39,7 @@
 #include "ExtSharedQueueEntryPool.h"
 #include "foundation/PxProfiler.h"
 #include "task/PxTask.h"
+#include "PsAtomic.h"
 
 namespace physx
 {
@@ -60,7 +61,7 @@ namespace Ext
 												DefaultCpuDispatcher() : mQueueEntryPool(0) {}
 												~DefaultCpuDispatcher();
 	public:
-												DefaultCpuDispatcher(PxU32 numThreads, PxU32* affinityMasks);
+												DefaultCpuDispatcher(PxU32 numThreads, PxU32* affinityMasks, const PxDefaultCpuDispatcherWaitPolicy* waitPolicy = NULL);
 
 		//---------------------------------------------------------------------------------
 		// PxCpuDispatcher implementation
@@ -77,12 +78,20 @@ namespace Ext
 
 		virtual			bool					getRunProfiled()	const	{ return mRunProfiled;	}
 
+		virtual			bool					setTelemetryEnabled(bool enabled);
+		virtual			PxU32					getTaskTelemetry(PxDispatcherTaskStats* stats, PxU32 maxStats) const;
+		virtual			PxU32					getWorkerTelemetry(PxDispatcherWorkerStats* stats, PxU32 maxStats) const;
+		virtual			void					getQueueTelemetry(PxU32& depth, PxU32& maxDepth) const;
+		virtual			void					resetTelemetry();
+
 		//---------------------------------------------------------------------------------
 		// DefaultCpuDispatcher
 		//---------------------------------------------------------------------------------
-						PxBaseTask*				getJob();
-						PxBaseTask*				stealJob();
-						PxBaseTask*				fetchNextTask();
+						// submitTime receives the telemetry time stamp of the task, see SharedQueueEntry
+						PxBaseTask*				getJob(PxU64* submitTime);
+						PxBaseTask*				getHighPriorityJob(PxU64* submitTime);
+						PxBaseTask*				stealJob(CpuWorkerThread& thief);
+						PxBaseTask*				fetchNextTask(CpuWorkerThread& worker);
 		PX_FORCE_INLINE	void					runTask(PxBaseTask& task)
 												{
 #if PX_SUPPORT_PXTASK_PROFILING
@@ -96,8 +105,17 @@ namespace Ext
 														task.run();
 												}
 
-    					void					waitForWork() { mWorkReady.wait(); }
-						void					resetWakeSignal();
+						// Spins, yields and finally parks the worker as set by the wait policy, until it finds a task or the dispatcher shuts down.
+						// Returns NULL if the worker was parked and woken up, the caller should look for tasks again.
+						PxBaseTask*				waitForTask(CpuWorkerThread& worker);
+						// Wakes a single parked worker, if any
+						void					wakeOneWorker();
+
+						void					runTaskWithTelemetry(CpuWorkerThread& worker, PxBaseTask& task);
+		PX_FORCE_INLINE	bool					isTelemetryEnabled()		const	{ return mTelemetryEnabled;				}
+		PX_FORCE_INLINE	PxU32					getTelemetryResetCount()	const	{ return PxU32(mTelemetryResetCount);	}
+		// Called when a worker fetches a task that was stamped on submission
+		PX_FORCE_INLINE	void					taskDequeued()						{ Ps::atomicDecrement(&mQueueDepth);	}
 
 		static			void					getAffinityMasks(PxU32* affinityMasks, PxU32 threadCount);
 
@@ -105,11 +123,24 @@ namespace Ext
 						CpuWorkerThread*		mWorkerThreads;
 						SharedQueueEntryPool<>	mQueueEntryPool;
 						Ps::SList				mJobList;
-						Ps::Sync				mWorkReady;
+						// Tasks with a non default priority always go through these shared lists
+						Ps::SList				mHighPriorityJobList;
+						Ps::SList				mLowPriorityJobList;
+						volatile PxI32			mNbHighPriorityJobs;
+						volatile PxI32			mNbLowPriorityJobs;
 						PxU8*					mThreadNames;
 						PxU32					mNumThreads;
-						bool					mShuttingDown;
+						// Wait policy, in tens of nanoseconds (the unit of Ps::Time)
+						PxU64					mSpinTime;
+						PxU64					mYieldTime;
+						volatile PxI32			mNbParkedWorkers;
+						volatile bool			mShuttingDown;
 						bool					mRunProfiled;
+						// Telemetry. The queue depth only counts the tasks stamped while it was enabled
+						volatile bool			mTelemetryEnabled;
+						volatile PxI32			mTelemetryResetCount;
+						volatile PxI32			mQueueDepth;
+						volatile PxI32			mMaxQueueDepth;
 	};
 
 #if PX_VC
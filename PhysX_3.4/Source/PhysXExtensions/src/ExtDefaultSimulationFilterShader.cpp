@@ -38,6 +38,7 @@
 #include "CmPhysXCommon.h"
 #include "PsInlineArray.h"
 #include "PsFoundation.h"
+#include "PsVecMath.h"
 
 using namespace physx;
 
@@ -45,18 +46,30 @@ namespace
 {
 	#define GROUP_SIZE	32
 
+	// Bit j of row i tells whether groups i and j collide
 	struct PxCollisionBitMap
 	{
-		PX_INLINE PxCollisionBitMap() : enable(true) {}
+		PX_INLINE PxCollisionBitMap()
+		{
+			for(PxU32 i = 0; i < GROUP_SIZE; i++)
+				rows[i] = 0xffffffff;
+		}
+
+		PX_FORCE_INLINE bool get(PxU32 group0, PxU32 group1) const { return (rows[group0] & (1u << group1)) != 0; }
 
-		bool operator()() const { return enable; }
-		bool& operator= (const bool &v) { enable = v; return enable; } 
+		PX_INLINE void set(PxU32 group0, PxU32 group1, bool enable)
+		{
+			if(enable)
+				rows[group0] |= 1u << group1;
+			else
+				rows[group0] &= ~(1u << group1);
+		}
 
 		private:
-		bool enable;
+		PxU32 rows[GROUP_SIZE];
 	};
 
-	PxCollisionBitMap gCollisionTable[GROUP_SIZE][GROUP_SIZE];
+	PxCollisionBitMap gCollisionTable;
 
 	PxFilterOp::Enum gFilterOps[3] = { PxFilterOp::PX_FILTEROP_AND, PxFilterOp::PX_FILTEROP_AND, PxFilterOp::PX_FILTEROP_AND };
 	
@@ -119,6 +132,48 @@ namespace
 
 	FilterFunction const gTable[] = { gAND, gOR, gXOR, gNAND, gNOR, gNXOR, gSWAP_AND };
 
+	// Same operations on four masks at a time, the masks being split in their word2 (bits0, bits1) and word3 (bits2, bits3) halves
+	PX_FORCE_INLINE static void applyFilterOp(PxFilterOp::Enum op, Ps::aos::VecU32V& results2, Ps::aos::VecU32V& results3,
+											  const Ps::aos::VecU32V mask02, const Ps::aos::VecU32V mask03,
+											  const Ps::aos::VecU32V mask12, const Ps::aos::VecU32V mask13)
+	{
+		using namespace Ps::aos;
+
+		const VecU32V allSet = U4Load(0xffffffff);
+		switch(op)
+		{
+			case PxFilterOp::PX_FILTEROP_OR:
+				results2 = V4U32or(mask02, mask12);
+				results3 = V4U32or(mask03, mask13);
+				break;
+			case PxFilterOp::PX_FILTEROP_XOR:
+				results2 = V4U32xor(mask02, mask12);
+				results3 = V4U32xor(mask03, mask13);
+				break;
+			case PxFilterOp::PX_FILTEROP_NAND:
+				results2 = V4U32xor(V4U32and(mask02, mask12), allSet);
+				results3 = V4U32xor(V4U32and(mask03, mask13), allSet);
+				break;
+			case PxFilterOp::PX_FILTEROP_NOR:
+				results2 = V4U32xor(V4U32or(mask02, mask12), allSet);
+				results3 = V4U32xor(V4U32or(mask03, mask13), allSet);
+				break;
+			case PxFilterOp::PX_FILTEROP_NXOR:
+				results2 = V4U32xor(V4U32xor(mask02, mask12), allSet);
+				results3 = V4U32xor(V4U32xor(mask03, mask13), allSet);
+				break;
+			case PxFilterOp::PX_FILTEROP_SWAP_AND:
+				results2 = V4U32and(mask02, mask13);
+				results3 = V4U32and(mask03, mask12);
+				break;
+			case PxFilterOp::PX_FILTEROP_AND:
+			default:
+				results2 = V4U32and(mask02, mask12);
+				results3 = V4U32and(mask03, mask13);
+				break;
+		}
+	}
+
 	static PxFilterData convert(const PxGroupsMask& mask)
 	{
 		PxFilterData fd;
@@ -281,7 +336,7 @@ PxFilterFlags physx::PxDefaultSimulationFilterShader(
 	}
 
 	// Collision Group
-	if (!gCollisionTable[filterData0.word0][filterData1.word0]())
+	if (!gCollisionTable.get(filterData0.word0, filterData1.word0))
 	{
 		return PxFilterFlag::eSUPPRESS;
 	}
@@ -305,19 +360,96 @@ PxFilterFlags physx::PxDefaultSimulationFilterShader(
 	return PxFilterFlags();
 }
 
+void physx::PxDefaultSimulationFilterBatchShader(
+	PxU32 nbPairs,
+	const PxFilterObjectAttributes* attributes0,
+	const PxFilterData* filterData0,
+	const PxFilterObjectAttributes* attributes1,
+	const PxFilterData* filterData1,
+	PxPairFlags* pairFlags,
+	PxFilterFlags* filterFlags,
+	const void* constantBlock,
+	PxU32 constantBlockSize)
+{
+	using namespace Ps::aos;
+
+	PX_UNUSED(constantBlock);
+	PX_UNUSED(constantBlockSize);
+
+	const PxFilterData k0 = convert(gFilterConstants[0]);
+	const PxFilterData k1 = convert(gFilterConstants[1]);
+	const VecU32V k02 = U4Load(k0.word2);
+	const VecU32V k03 = U4Load(k0.word3);
+	const VecU32V k12 = U4Load(k1.word2);
+	const VecU32V k13 = U4Load(k1.word3);
+	const VecU32V zero = U4Load(0);
+	const VecU32V one = U4Load(1);
+
+	const PxFilterOp::Enum op0 = gFilterOps[0];
+	const PxFilterOp::Enum op1 = gFilterOps[1];
+	const PxFilterOp::Enum op2 = gFilterOps[2];
+	const PxU32 filterBool = gFilterBool ? 1u : 0u;
+
+	PX_ALIGN(16, PxU32 passed[4]);
+	for(PxU32 i = 0; i < nbPairs; i += 4)
+	{
+		const PxFilterData* PX_RESTRICT fd0 = filterData0 + i;
+		const PxFilterData* PX_RESTRICT fd1 = filterData1 + i;
+
+		// The lanes past the end of the last group repeat the first pair
+		const PxU32 nb = PxMin(nbPairs - i, 4u);
+		const PxU32 i1 = nb > 1 ? 1u : 0u;
+		const PxU32 i2 = nb > 2 ? 2u : 0u;
+		const PxU32 i3 = nb > 3 ? 3u : 0u;
+
+		const VecU32V g02 = U4LoadXYZW(fd0[0].word2, fd0[i1].word2, fd0[i2].word2, fd0[i3].word2);
+		const VecU32V g03 = U4LoadXYZW(fd0[0].word3, fd0[i1].word3, fd0[i2].word3, fd0[i3].word3);
+		const VecU32V g12 = U4LoadXYZW(fd1[0].word2, fd1[i1].word2, fd1[i2].word2, fd1[i3].word2);
+		const VecU32V g13 = U4LoadXYZW(fd1[0].word3, fd1[i1].word3, fd1[i2].word3, fd1[i3].word3);
+
+		VecU32V g0k02, g0k03;	applyFilterOp(op0, g0k02, g0k03, g02, g03, k02, k03);
+		VecU32V g1k12, g1k13;	applyFilterOp(op1, g1k12, g1k13, g12, g13, k12, k13);
+		VecU32V final2, final3;	applyFilterOp(op2, final2, final3, g0k02, g0k03, g1k12, g1k13);
+
+		U4StoreA(V4U32Sel(V4IsEqU32(V4U32or(final2, final3), zero), zero, one), passed);
+
+		for(PxU32 j = 0; j < nb; j++)
+		{
+			const PxU32 p = i + j;
+
+			// let triggers through
+			if(PxFilterObjectIsTrigger(attributes0[p]) || PxFilterObjectIsTrigger(attributes1[p]))
+			{
+				pairFlags[p] = PxPairFlag::eTRIGGER_DEFAULT;
+				filterFlags[p] = PxFilterFlags();
+			}
+			else if(!gCollisionTable.get(fd0[j].word0, fd1[j].word0) || passed[j] != filterBool)
+			{
+				pairFlags[p] = PxPairFlags();
+				filterFlags[p] = PxFilterFlag::eSUPPRESS;
+			}
+			else
+			{
+				pairFlags[p] = PxPairFlag::eCONTACT_DEFAULT;
+				filterFlags[p] = PxFilterFlags();
+			}
+		}
+	}
+}
+
 bool physx::PxGetGroupCollisionFlag(const PxU16 group1, const PxU16 group2)
 {
 	PX_CHECK_AND_RETURN_NULL(group1 < 32 && group2 < 32, "Group must be less than 32");	
 
-	return gCollisionTable[group1][group2]();
+	return gCollisionTable.get(group1, group2);
 }
 
 void physx::PxSetGroupCollisionFlag(const PxU16 group1, const PxU16 group2, const bool enable)
 {
 	PX_CHECK_AND_RETURN(group1 < 32 && group2 < 32, "Group must be less than 32");	
 
-	gCollisionTable[group1][group2] = enable;
-	gCollisionTable[group2][group1] = enable;
+	gCollisionTable.set(group1, group2, enable);
+	gCollisionTable.set(group2, group1, enable);
 }
 
 PxU16 physx::PxGetGroup(const PxActor& actor)
@@ -39,6 +39,16 @@
 #include "CmPhysXCommon.h"
 #include "PsUtilities.h"
 #include "PsBitUtils.h"
+#include "PsAllocator.h"
+
+#if PX_WINDOWS
+#include "windows/PsWindowsInclude.h"
+#elif PX_UNIX_FAMILY
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace physx;
 
@@ -109,7 +119,10 @@ PxU32 PxDefaultMemoryInputData::tell() const
 	return mPos;
 }
 
-PxDefaultFileOutputStream::PxDefaultFileOutputStream(const char* filename)
+PxDefaultFileOutputStream::PxDefaultFileOutputStream(const char* filename, PxU32 bufferSize)
+:	mBuffer		(NULL)
+,	mBufferSize	(0)
+,	mBufferCount(0)
 {
 	mFile = NULL;
 	sn::fopen_s(&mFile, filename, "wb");
@@ -122,17 +135,59 @@ PxDefaultFileOutputStream::PxDefaultFileOutputStream(const char* filename)
 			"Unable to open file %s, errno 0x%x\n",filename,errno);
 	}
 	PX_ASSERT(mFile);
+
+	if(mFile && bufferSize)
+	{
+		// we do the buffering ourselves, the stdio buffer would only add a copy
+		setvbuf(mFile, NULL, _IONBF, 0);
+		mBuffer = reinterpret_cast<PxU8*>(PX_ALLOC(bufferSize, "PxDefaultFileOutputStream"));
+		mBufferSize = bufferSize;
+	}
 }
 
 PxDefaultFileOutputStream::~PxDefaultFileOutputStream()
 {
 	if(mFile)
+	{
+		flush();
 		fclose(mFile);
+	}
+	if(mBuffer)
+		PX_FREE(mBuffer);
+}
+
+bool PxDefaultFileOutputStream::flush()
+{
+	if(!mFile)
+		return false;
+
+	const PxU32 count = mBufferCount;
+	mBufferCount = 0;
+	return !count || PxU32(fwrite(mBuffer, 1, count, mFile)) == count;
 }
 
 PxU32 PxDefaultFileOutputStream::write(const void* src, PxU32 count)
 {
-	return mFile ? PxU32(fwrite(src, 1, count, mFile)) : 0;
+	if(!mFile)
+		return 0;
+
+	if(mBufferCount + count <= mBufferSize)
+	{
+		PxMemCopy(mBuffer + mBufferCount, src, count);
+		mBufferCount += count;
+		return count;
+	}
+
+	if(!flush())
+		return 0;
+
+	// large blocks go straight to the file
+	if(count >= mBufferSize)
+		return PxU32(fwrite(src, 1, count, mFile));
+
+	PxMemCopy(mBuffer, src, count);
+	mBufferCount = count;
+	return count;
 }
 
 bool PxDefaultFileOutputStream::isValid()
@@ -142,16 +197,33 @@ bool PxDefaultFileOutputStream::isValid()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-PxDefaultFileInputData::PxDefaultFileInputData(const char* filename)
+PxDefaultFileInputData::PxDefaultFileInputData(const char* filename, PxU32 bufferSize)
+:	mBuffer		(NULL)
+,	mBufferSize	(0)
+,	mBufferStart(0)
+,	mBufferCount(0)
+,	mPos		(0)
+,	mFilePos	(0)
 {
 	mFile = NULL;
 	sn::fopen_s(&mFile, filename, "rb");
 
 	if(mFile)
 	{
+		if(bufferSize)
+			setvbuf(mFile, NULL, _IONBF, 0);
+
 		fseek(mFile, 0, SEEK_END);
 		mLength = PxU32(ftell(mFile));
 		fseek(mFile, 0, SEEK_SET);
+
+		if(bufferSize)
+		{
+			// no need for a buffer larger than the file
+			mBufferSize = PxMin(bufferSize, mLength);
+			if(mBufferSize)
+				mBuffer = reinterpret_cast<PxU8*>(PX_ALLOC(mBufferSize, "PxDefaultFileInputData"));
+		}
 	}
 	else
 	{
@@ -163,14 +235,52 @@ PxDefaultFileInputData::~PxDefaultFileInputData()
 {
 	if(mFile)
 		fclose(mFile);
+	if(mBuffer)
+		PX_FREE(mBuffer);
 }
 
 PxU32 PxDefaultFileInputData::read(void* dest, PxU32 count)
 {
 	PX_ASSERT(mFile);
-	const size_t size = fread(dest, 1, count, mFile);
+	PxU8* dst = reinterpret_cast<PxU8*>(dest);
+	PxU32 nbRead = 0;
+	while(nbRead < count)
+	{
+		// serve what we can from the buffered block
+		if(mPos >= mBufferStart && mPos < mBufferStart + mBufferCount)
+		{
+			const PxU32 length = PxMin(count - nbRead, mBufferStart + mBufferCount - mPos);
+			PxMemCopy(dst + nbRead, mBuffer + (mPos - mBufferStart), length);
+			mPos += length;
+			nbRead += length;
+			continue;
+		}
+
+		if(mFilePos != mPos)
+		{
+			if(fseek(mFile, long(mPos), SEEK_SET))
+				break;
+			mFilePos = mPos;
+		}
+
+		// large reads go straight to the destination
+		if(count - nbRead >= mBufferSize)
+		{
+			const PxU32 length = PxU32(fread(dst + nbRead, 1, count - nbRead, mFile));
+			mPos += length;
+			mFilePos = mPos;
+			nbRead += length;
+			break;
+		}
+
+		mBufferStart = mPos;
+		mBufferCount = PxU32(fread(mBuffer, 1, mBufferSize, mFile));
+		mFilePos = mPos + mBufferCount;
+		if(!mBufferCount)
+			break;
+	}
 	// there should be no assert here since by spec of PxInputStream we can read fewer bytes than expected
-	return PxU32(size);
+	return nbRead;
 }
 
 PxU32 PxDefaultFileInputData::getLength() const
@@ -180,15 +290,113 @@ PxU32 PxDefaultFileInputData::getLength() const
 
 void PxDefaultFileInputData::seek(PxU32 pos)
 {
-	fseek(mFile, long(pos), SEEK_SET);
+	// the file is only repositioned when the next read misses the buffered block
+	mPos = pos;
 }
 
 PxU32 PxDefaultFileInputData::tell() const
 {
-	return PxU32(ftell(mFile));
+	return mPos;
 }
 
 bool PxDefaultFileInputData::isValid() const
 {
 	return mFile != NULL;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+PxDefaultMappedFileInputData::PxDefaultMappedFileInputData(const char* filename)
+:	mData		(NULL)
+,	mLength		(0)
+,	mPos		(0)
+,	mMapping	(NULL)
+{
+#if PX_WINDOWS
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = NULL;
+	if(GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart <= 0xffffffff)
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	// the mapping keeps the file open
+	CloseHandle(file);
+	if(!mapping)
+		return;
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(!data)
+	{
+		CloseHandle(mapping);
+		return;
+	}
+
+	mData = reinterpret_cast<const PxU8*>(data);
+	mLength = PxU32(size.QuadPart);
+	mMapping = mapping;
+#elif PX_UNIX_FAMILY
+	const int fd = open(filename, O_RDONLY);
+	if(fd < 0)
+		return;
+
+	struct stat fileStat;
+	void* data = MAP_FAILED;
+	if(fstat(fd, &fileStat) == 0 && fileStat.st_size > 0 && PxU64(fileStat.st_size) <= 0xffffffff)
+		data = mmap(NULL, size_t(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	// the mapping keeps the file open
+	close(fd);
+	if(data == MAP_FAILED)
+		return;
+
+	// starts the read-ahead of the whole file in the background, the reads then mostly hit resident pages
+	madvise(data, size_t(fileStat.st_size), MADV_SEQUENTIAL);
+	madvise(data, size_t(fileStat.st_size), MADV_WILLNEED);
+
+	mData = reinterpret_cast<const PxU8*>(data);
+	mLength = PxU32(fileStat.st_size);
+#else
+	PX_UNUSED(filename);
+#endif
+}
+
+PxDefaultMappedFileInputData::~PxDefaultMappedFileInputData()
+{
+	if(!mData)
+		return;
+#if PX_WINDOWS
+	UnmapViewOfFile(mData);
+	CloseHandle(mMapping);
+#elif PX_UNIX_FAMILY
+	munmap(const_cast<PxU8*>(mData), size_t(mLength));
+#endif
+}
+
+PxU32 PxDefaultMappedFileInputData::read(void* dest, PxU32 count)
+{
+	PxU32 length = PxMin<PxU32>(count, mLength-mPos);
+	PxMemCopy(dest, mData+mPos, length);
+	mPos += length;
+	return length;
+}
+
+PxU32 PxDefaultMappedFileInputData::getLength() const
+{
+	return mLength;
+}
+
+void PxDefaultMappedFileInputData::seek(PxU32 pos)
+{
+	mPos = PxMin<PxU32>(mLength, pos);
+}
+
+PxU32 PxDefaultMappedFileInputData::tell() const
+{
+	return mPos;
+}
+
+bool PxDefaultMappedFileInputData::isValid() const
+{
+	return mData != NULL;
+}
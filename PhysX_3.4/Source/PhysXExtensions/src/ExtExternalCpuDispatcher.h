@@ -0,0 +1,84 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_NP_EXTERNAL_CPU_DISPATCHER_H
+#define PX_PHYSICS_EXTENSIONS_NP_EXTERNAL_CPU_DISPATCHER_H
+
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PxExternalCpuDispatcher.h"
+#include "foundation/PxProfiler.h"
+#include "task/PxTask.h"
+
+namespace physx
+{
+
+namespace Ext
+{
+	class ExternalCpuDispatcher : public PxExternalCpuDispatcher, public Ps::UserAllocated
+	{
+	private:
+												~ExternalCpuDispatcher() {}
+	public:
+												ExternalCpuDispatcher(PxExternalJobSystem& jobSystem);
+
+		//---------------------------------------------------------------------------------
+		// PxCpuDispatcher implementation
+		//---------------------------------------------------------------------------------
+		virtual			void					submitTask(PxBaseTask& task)	{ mJobSystem.submitJob(*this, task);	}
+		virtual			PxU32					getWorkerCount()	const		{ return mJobSystem.getWorkerCount();	}
+		virtual			bool					waitUntil(PxWaitConditionFunction isDone, void* userData)	{ return mJobSystem.yieldUntil(isDone, userData);	}
+
+		//---------------------------------------------------------------------------------
+		// PxDefaultCpuDispatcher implementation
+		//---------------------------------------------------------------------------------
+		virtual			void					release();
+
+		virtual			void					setRunProfiled(bool runProfiled) { mRunProfiled = runProfiled; }
+
+		virtual			bool					getRunProfiled()	const	{ return mRunProfiled;	}
+
+		//---------------------------------------------------------------------------------
+		// PxExternalCpuDispatcher implementation
+		//---------------------------------------------------------------------------------
+		virtual			void					executeTask(PxBaseTask& task);
+
+	protected:
+						PxExternalJobSystem&	mJobSystem;
+						bool					mRunProfiled;
+
+	private:
+						ExternalCpuDispatcher& operator=(const ExternalCpuDispatcher&);
+	};
+
+} // namespace Ext
+}
+
+#endif
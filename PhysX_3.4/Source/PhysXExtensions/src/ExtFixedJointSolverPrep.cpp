@@ -56,7 +56,7 @@ namespace Ext
 
 		body0WorldOffset = cB2w.p-bA2w.p;
 		joint::ConstraintHelper ch(constraints,cB2w.p-bA2w.p, cB2w.p-bB2w.p);
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, bOriginInA, 7, 7);
+		ch.prepareLockedAxes<7, 7>(cA2w.q, cB2w.q, bOriginInA);
 
 		return ch.getCount();
 	}
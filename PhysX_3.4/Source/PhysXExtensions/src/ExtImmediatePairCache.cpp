@@ -0,0 +1,270 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#include "ExtImmediatePairCache.h"
+#include "PsFoundation.h"
+#include "foundation/PxMemory.h"
+
+using namespace physx;
+
+namespace physx
+{
+	PxImmediatePairCache* PxImmediatePairCacheCreate();
+}
+
+PxImmediatePairCache* physx::PxImmediatePairCacheCreate()
+{
+	return PX_NEW(Ext::ImmediatePairCache);
+}
+
+Ext::ImmediateBlockPool::~ImmediateBlockPool()
+{
+	for(PxU32 i = 0; i < mPages.size(); i++)
+		PX_FREE(mPages[i]);
+}
+
+PxU8* Ext::ImmediateBlockPool::allocate(PxU32 size, PxU32& capacity)
+{
+	PxU32 sizeClass = 0;
+	while(sizeClass < NbClasses && (MinBlockSize << sizeClass) < size)
+		sizeClass++;
+
+	if(sizeClass == NbClasses)
+	{
+		capacity = (size + 15) & ~15;
+		return reinterpret_cast<PxU8*>(PX_ALLOC(capacity, "ImmediateBlockPool"));
+	}
+
+	capacity = MinBlockSize << sizeClass;
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+	Ps::Array<PxU8*>& freeBlocks = mFreeBlocks[sizeClass];
+	if(freeBlocks.empty())
+	{
+		PxU8* page = reinterpret_cast<PxU8*>(PX_ALLOC(PageSize, "ImmediateBlockPool"));
+		mPages.pushBack(page);
+		for(PxU32 offset = PageSize; offset >= capacity; offset -= capacity)
+			freeBlocks.pushBack(page + offset - capacity);
+	}
+	return freeBlocks.popBack();
+}
+
+void Ext::ImmediateBlockPool::free(PxU8* data, PxU32 capacity)
+{
+	if(!data)
+		return;
+
+	if(capacity > (MinBlockSize << (NbClasses - 1)))
+	{
+		PX_FREE(data);
+		return;
+	}
+
+	PxU32 sizeClass = 0;
+	while((MinBlockSize << sizeClass) < capacity)
+		sizeClass++;
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mFreeBlocks[sizeClass].pushBack(data);
+}
+
+Ext::ImmediatePairCache::ImmediatePairCache() :
+	mNbPairs	(0),
+	mStep		(0)
+{
+}
+
+Ext::ImmediatePairCache::~ImmediatePairCache()
+{
+	for(PxU32 i = 0; i < mEntries.size(); i++)
+	{
+		if(mEntries[i].lastStep != PX_INVALID_U32)
+			removePair(i);
+	}
+}
+
+void Ext::ImmediatePairCache::release()
+{
+	PX_DELETE(this);
+}
+
+PxU32 Ext::ImmediatePairCache::acquirePair(PxU32 id0, PxU32 id1)
+{
+	const PxU64 key = getKey(id0, id1);
+	if(const Ps::HashMap<PxU64, PxU32>::Entry* found = mPairMap.find(key))
+	{
+		mEntries[found->second].lastStep = mStep;
+		return found->second;
+	}
+
+	const PxU32 handle = mFreeEntries.size() ? mFreeEntries.popBack() : mEntries.size();
+	if(handle == mEntries.size())
+		mEntries.insert();
+
+	ImmediatePairEntry& entry = mEntries[handle];
+	entry.pair.cache = PxCache();
+	entry.pair.frictionPatches = NULL;
+	entry.pair.nbFrictionPatches = 0;
+	entry.pair.id0 = PxMin(id0, id1);
+	entry.pair.id1 = PxMax(id0, id1);
+	entry.cacheBlocks[0] = entry.cacheBlocks[1] = NULL;
+	entry.cacheCapacities[0] = entry.cacheCapacities[1] = 0;
+	entry.frictionBlock = NULL;
+	entry.frictionCapacity = 0;
+	entry.lastStep = mStep;
+
+	mPairMap.insert(key, handle);
+	mNbPairs++;
+	return handle;
+}
+
+PxU32 Ext::ImmediatePairCache::findPair(PxU32 id0, PxU32 id1) const
+{
+	const Ps::HashMap<PxU64, PxU32>::Entry* found = mPairMap.find(getKey(id0, id1));
+	return found ? found->second : PX_INVALID_IMMEDIATE_PAIR;
+}
+
+void Ext::ImmediatePairCache::resetPair(PxU32 pair)
+{
+	PX_CHECK_AND_RETURN(pair < mEntries.size() && mEntries[pair].lastStep != PX_INVALID_U32, "PxImmediatePairCache::resetPair: invalid pair handle.");
+
+	// the blocks are kept for the next contact generation
+	PxImmediatePair& state = mEntries[pair].pair;
+	state.cache = PxCache();
+	state.frictionPatches = NULL;
+	state.nbFrictionPatches = 0;
+}
+
+void Ext::ImmediatePairCache::removePair(PxU32 pair)
+{
+	PX_CHECK_AND_RETURN(pair < mEntries.size() && mEntries[pair].lastStep != PX_INVALID_U32, "PxImmediatePairCache::removePair: invalid pair handle.");
+
+	ImmediatePairEntry& entry = mEntries[pair];
+	mPool.free(entry.cacheBlocks[0], entry.cacheCapacities[0]);
+	mPool.free(entry.cacheBlocks[1], entry.cacheCapacities[1]);
+	mPool.free(entry.frictionBlock, entry.frictionCapacity);
+	entry.lastStep = PX_INVALID_U32;
+
+	mPairMap.erase(getKey(entry.pair.id0, entry.pair.id1));
+	mFreeEntries.pushBack(pair);
+	mNbPairs--;
+}
+
+PxU32 Ext::ImmediatePairCache::removePairs(PxU32 id)
+{
+	PxU32 nbRemoved = 0;
+	for(PxU32 i = 0; i < mEntries.size(); i++)
+	{
+		const ImmediatePairEntry& entry = mEntries[i];
+		if(entry.lastStep != PX_INVALID_U32 && (entry.pair.id0 == id || entry.pair.id1 == id))
+		{
+			removePair(i);
+			nbRemoved++;
+		}
+	}
+	return nbRemoved;
+}
+
+PxU32 Ext::ImmediatePairCache::evictStalePairs()
+{
+	PxU32 nbRemoved = 0;
+	for(PxU32 i = 0; i < mEntries.size(); i++)
+	{
+		const PxU32 lastStep = mEntries[i].lastStep;
+		if(lastStep != PX_INVALID_U32 && lastStep != mStep)
+		{
+			removePair(i);
+			nbRemoved++;
+		}
+	}
+
+	// PX_INVALID_U32 marks the free entries
+	mStep = mStep + 1 == PX_INVALID_U32 ? 0 : mStep + 1;
+	return nbRemoved;
+}
+
+PxU8* Ext::ImmediatePairCache::allocateCacheData(PxU32 pair, PxU32 byteSize)
+{
+	ImmediatePairEntry& entry = mEntries[pair];
+
+	// take the block the current cache doesn't live in
+	const PxU32 index = (entry.cacheBlocks[0] && entry.cacheBlocks[0] == entry.pair.cache.mCachedData) ? 1u : 0u;
+	if(entry.cacheCapacities[index] < byteSize)
+	{
+		mPool.free(entry.cacheBlocks[index], entry.cacheCapacities[index]);
+		entry.cacheBlocks[index] = mPool.allocate(byteSize, entry.cacheCapacities[index]);
+	}
+	return entry.cacheBlocks[index];
+}
+
+void Ext::ImmediatePairCache::storeFrictionPatches(PxU32 pair, const PxU8* patches, PxU32 nbPatches, PxU32 byteSize)
+{
+	PxImmediatePair& state = mEntries[pair].pair;
+	if(!patches || !nbPatches || !byteSize)
+	{
+		state.frictionPatches = NULL;
+		state.nbFrictionPatches = 0;
+		return;
+	}
+
+	ImmediatePairEntry& entry = mEntries[pair];
+	if(entry.frictionCapacity < byteSize)
+	{
+		mPool.free(entry.frictionBlock, entry.frictionCapacity);
+		entry.frictionBlock = mPool.allocate(byteSize, entry.frictionCapacity);
+	}
+
+	PxMemCopy(entry.frictionBlock, patches, byteSize);
+	state.frictionPatches = entry.frictionBlock;
+	state.nbFrictionPatches = PxU8(nbPatches);
+}
+
+PxU8* PxImmediateFrictionRecorder::reserveFrictionData(const PxU32 byteSize)
+{
+	PxU8* data = mAllocator.reserveFrictionData(byteSize);
+	if(data && mNbBlocks < 4)
+	{
+		mBlocks[mNbBlocks].data = data;
+		mBlocks[mNbBlocks].size = byteSize;
+		mNbBlocks++;
+	}
+	return data;
+}
+
+void PxImmediateFrictionRecorder::storeFrictionPatches(PxU32 pair, const PxSolverContactDesc& desc)
+{
+	// patches that weren't recorded (e.g. preparation failed) are dropped
+	PxU32 size = 0;
+	for(PxU32 i = 0; i < mNbBlocks; i++)
+	{
+		if(mBlocks[i].data == desc.frictionPtr)
+			size = mBlocks[i].size;
+	}
+	mCache.storeFrictionPatches(pair, size ? desc.frictionPtr : NULL, desc.frictionCount, size);
+}
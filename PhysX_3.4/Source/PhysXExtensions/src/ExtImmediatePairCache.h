@@ -0,0 +1,113 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_IMMEDIATE_PAIR_CACHE_INTERNAL_H
+#define PX_PHYSICS_EXTENSIONS_IMMEDIATE_PAIR_CACHE_INTERNAL_H
+
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsArray.h"
+#include "PsHashMap.h"
+#include "PsMutex.h"
+#include "PxImmediatePairCache.h"
+
+namespace physx
+{
+
+namespace Ext
+{
+	// Free lists of blocks of 64 << i bytes carved from pages, larger blocks are allocated on their own
+	class ImmediateBlockPool
+	{
+	public:
+		static const PxU32 NbClasses = 9;
+		static const PxU32 MinBlockSize = 64;
+		static const PxU32 PageSize = 64 * 1024;
+
+											~ImmediateBlockPool();
+
+						PxU8*				allocate(PxU32 size, PxU32& capacity);
+						void				free(PxU8* data, PxU32 capacity);
+
+	private:
+						Ps::Array<PxU8*>	mFreeBlocks[NbClasses];
+						Ps::Array<PxU8*>	mPages;
+						Ps::Mutex			mMutex;
+	};
+
+	struct ImmediatePairEntry
+	{
+		PxImmediatePair		pair;
+		PxU8*				cacheBlocks[2];		// the contact generation reads the old cache while writing the new one
+		PxU32				cacheCapacities[2];
+		PxU8*				frictionBlock;
+		PxU32				frictionCapacity;
+		PxU32				lastStep;			// PX_INVALID_U32 for a free entry
+	};
+
+	class ImmediatePairCache : public PxImmediatePairCache, public Ps::UserAllocated
+	{
+	public:
+											ImmediatePairCache();
+
+		//---------------------------------------------------------------------------------
+		// PxImmediatePairCache implementation
+		//---------------------------------------------------------------------------------
+		virtual			void				release();
+
+		virtual			PxU32				acquirePair(PxU32 id0, PxU32 id1);
+		virtual			PxU32				findPair(PxU32 id0, PxU32 id1) const;
+		virtual			PxImmediatePair&	getPair(PxU32 pair)	{ return mEntries[pair].pair;	}
+		virtual			void				resetPair(PxU32 pair);
+		virtual			void				removePair(PxU32 pair);
+		virtual			PxU32				removePairs(PxU32 id);
+		virtual			PxU32				evictStalePairs();
+		virtual			PxU32				getNbPairs()	const	{ return mNbPairs;	}
+
+		virtual			PxU8*				allocateCacheData(PxU32 pair, PxU32 byteSize);
+		virtual			void				storeFrictionPatches(PxU32 pair, const PxU8* patches, PxU32 nbPatches, PxU32 byteSize);
+
+	private:
+											~ImmediatePairCache();
+
+		static			PxU64				getKey(PxU32 id0, PxU32 id1)	{ return (PxU64(PxMin(id0, id1)) << 32) | PxU64(PxMax(id0, id1));	}
+
+						Ps::HashMap<PxU64, PxU32>			mPairMap;
+						Ps::Array<ImmediatePairEntry>		mEntries;
+						Ps::Array<PxU32>					mFreeEntries;
+						PxU32								mNbPairs;
+						PxU32								mStep;
+						ImmediateBlockPool					mPool;
+	};
+
+} // namespace Ext
+}
+
+#endif
@@ -0,0 +1,891 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#include "ExtImmediateScene.h"
+#include "PsFoundation.h"
+#include "PsAtomic.h"
+#include "PsSort.h"
+#include "PsMathUtils.h"
+#include "geometry/PxGeometryQuery.h"
+#include "task/PxCpuDispatcher.h"
+
+using namespace physx;
+using namespace immediate;
+
+namespace physx
+{
+	PxImmediateScene* PxImmediateSceneCreate(const PxImmediateSceneDesc& desc);
+}
+
+PxImmediateScene* physx::PxImmediateSceneCreate(const PxImmediateSceneDesc& desc)
+{
+	if(!desc.isValid())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "PxImmediateSceneCreate: invalid scene descriptor.");
+		return NULL;
+	}
+	return PX_NEW(Ext::ImmediateScene)(desc);
+}
+
+namespace
+{
+	const PxU32 MaxJointRows = 12;
+
+	struct SortByMinX
+	{
+		SortByMinX(const PxBounds3* bounds) : mBounds(bounds) {}
+
+		bool operator()(PxU32 a, PxU32 b) const	{ return mBounds[a].minimum.x < mBounds[b].minimum.x;	}
+
+		const PxBounds3* mBounds;
+	};
+
+	class ContactRecorder : public PxContactRecorder
+	{
+	public:
+		ContactRecorder(Ps::Array<Gu::ContactPoint>& contacts) : mContacts(contacts), mPair(NULL), mMaxImpulse(PX_MAX_F32),
+			mStaticFriction(0.0f), mDynamicFriction(0.0f), mRestitution(0.0f)
+		{
+		}
+
+		void setPair(Ext::ImmediatePair& pair, const Ext::ImmediateBody& body0, const Ext::ImmediateBody& body1)
+		{
+			mPair = &pair;
+			mMaxImpulse = PxMin(body0.maxContactImpulse, body1.maxContactImpulse);
+			mStaticFriction = (body0.staticFriction + body1.staticFriction) * 0.5f;
+			mDynamicFriction = (body0.dynamicFriction + body1.dynamicFriction) * 0.5f;
+			mRestitution = (body0.restitution + body1.restitution) * 0.5f;
+
+			pair.startContact = mContacts.size();
+			pair.nbContacts = 0;
+		}
+
+		virtual bool recordContacts(const Gu::ContactPoint* contactPoints, const PxU32 nbContacts, const PxU32 index)
+		{
+			PX_UNUSED(index);
+			for(PxU32 i = 0; i < nbContacts; i++)
+			{
+				// fill in what the contact generation doesn't produce
+				Gu::ContactPoint& point = mContacts.insert();
+				point = contactPoints[i];
+				point.maxImpulse = mMaxImpulse;
+				point.targetVel = PxVec3(0.0f);
+				point.staticFriction = mStaticFriction;
+				point.dynamicFriction = mDynamicFriction;
+				point.restitution = mRestitution;
+				point.materialFlags = 0;
+			}
+			mPair->nbContacts += nbContacts;
+			return true;
+		}
+
+	private:
+		Ps::Array<Gu::ContactPoint>&	mContacts;
+		Ext::ImmediatePair*				mPair;
+		PxReal							mMaxImpulse;
+		PxReal							mStaticFriction;
+		PxReal							mDynamicFriction;
+		PxReal							mRestitution;
+
+		PX_NOCOPY(ContactRecorder)
+	};
+
+	bool isSyncSet(void* sync)
+	{
+		return reinterpret_cast<Ps::Sync*>(sync)->wait(0);
+	}
+
+	// [begin, end) of the index-th of nbTasks ranges over count items
+	void getTaskRange(PxU32 index, PxU32 nbTasks, PxU32 count, PxU32& begin, PxU32& end)
+	{
+		const PxU32 perTask = (count + nbTasks - 1) / nbTasks;
+		begin = PxMin(index * perTask, count);
+		end = PxMin(begin + perTask, count);
+	}
+}
+
+Ext::ImmediateBlockAllocator::~ImmediateBlockAllocator()
+{
+	for(PxU32 i = 0; i < mPages.size(); i++)
+		PX_FREE(mPages[i].data);
+}
+
+PxU8* Ext::ImmediateBlockAllocator::allocate(PxU32 size)
+{
+	size = (size + 15) & ~15;
+
+	while(mCurrentPage < mPages.size())
+	{
+		Page& page = mPages[mCurrentPage];
+		if(mCurrentOffset + size <= page.size)
+		{
+			PxU8* data = page.data + mCurrentOffset;
+			mCurrentOffset += size;
+			return data;
+		}
+		mCurrentPage++;
+		mCurrentOffset = 0;
+	}
+
+	// large blocks get a page of their own
+	Page page;
+	page.size = PxMax(size, PageSize);
+	page.data = reinterpret_cast<PxU8*>(PX_ALLOC(page.size, "ImmediateBlockAllocator"));
+	mPages.pushBack(page);
+
+	mCurrentPage = mPages.size() - 1;
+	mCurrentOffset = size;
+	return page.data;
+}
+
+void Ext::ImmediateTask::run()
+{
+	(mScene->*mFunction)(mIndex);
+}
+
+void Ext::ImmediateTask::release()
+{
+	mScene->taskDone();
+}
+
+Ext::ImmediateScene::ImmediateScene(const PxImmediateSceneDesc& desc) :
+	mDesc				(desc),
+	mNbBodies			(0),
+	mNbBoundsTasks		(0),
+	mNbSweepTasks		(0),
+	mPairCache			(PxImmediatePairCacheCreate()),
+	mNbTouchingPairs	(0),
+	mNbSolverBatches	(0),
+	mNbIslands			(0),
+	mDt					(0.0f),
+	mNbPendingTasks		(0)
+{
+}
+
+Ext::ImmediateScene::~ImmediateScene()
+{
+	for(PxU32 i = 0; i < mContactBatches.size(); i++)
+		PX_DELETE(mContactBatches[i]);
+	for(PxU32 i = 0; i < mSolverBatches.size(); i++)
+		PX_DELETE(mSolverBatches[i]);
+	mPairCache->release();
+}
+
+void Ext::ImmediateScene::release()
+{
+	PX_DELETE(this);
+}
+
+PxImmediateHandle Ext::ImmediateScene::addBody(const PxImmediateBodyDesc& desc)
+{
+	if(!desc.isValid())
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "PxImmediateScene::addBody: invalid body descriptor.");
+		return PX_INVALID_U32;
+	}
+
+	PxImmediateHandle handle;
+	if(mFreeBodies.size())
+	{
+		handle = mFreeBodies.popBack();
+	}
+	else
+	{
+		handle = mBodies.size();
+		mBodies.insert();
+		mBounds.insert();
+		mStaticBodyData.insert();
+	}
+
+	ImmediateBody& body = mBodies[handle];
+	body.geometry.storeAny(*desc.geometry);
+	body.pose = desc.pose;
+	body.shapeLocalPose = desc.shapeLocalPose;
+	body.linearVelocity = desc.linearVelocity;
+	body.angularVelocity = desc.angularVelocity;
+	body.invMass = desc.invMass;
+	body.invInertia = desc.invInertia;
+	body.linearDamping = desc.linearDamping;
+	body.angularDamping = desc.angularDamping;
+	body.maxLinearVelocitySq = desc.maxLinearVelocity * desc.maxLinearVelocity;
+	body.maxAngularVelocitySq = desc.maxAngularVelocity * desc.maxAngularVelocity;
+	body.maxDepenetrationVelocity = desc.maxDepenetrationVelocity;
+	body.maxContactImpulse = desc.maxContactImpulse;
+	body.staticFriction = desc.staticFriction;
+	body.dynamicFriction = desc.dynamicFriction;
+	body.restitution = desc.restitution;
+	body.collisionGroup = desc.collisionGroup;
+	body.userData = desc.userData;
+	body.flags = ImmediateBody::eALIVE | (desc.invMass > 0.0f ? ImmediateBody::eDYNAMIC : 0);
+
+	mNbBodies++;
+	return handle;
+}
+
+void Ext::ImmediateScene::removeBody(PxImmediateHandle body)
+{
+	PX_CHECK_AND_RETURN(isValidBody(body), "PxImmediateScene::removeBody: invalid body handle.");
+
+	for(PxU32 i = 0; i < mJoints.size(); i++)
+	{
+		if(mJoints[i].solverPrep && (mJoints[i].body0 == body || mJoints[i].body1 == body))
+			removeJoint(i);
+	}
+
+	// the pairs of the last step that still refer to the body are only used for statistics
+	mPairCache->removePairs(body);
+
+	mBodies[body].flags = 0;
+	mBodies[body].geometry.storeAny(PxSphereGeometry(0.0f));
+	mFreeBodies.pushBack(body);
+	mNbBodies--;
+}
+
+PxImmediateHandle Ext::ImmediateScene::addJoint(const PxImmediateJointDesc& desc)
+{
+	if(!isValidBody(desc.body0) || !isValidBody(desc.body1) || desc.body0 == desc.body1 || !desc.solverPrep
+		|| !((mBodies[desc.body0].flags | mBodies[desc.body1].flags) & ImmediateBody::eDYNAMIC))
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "PxImmediateScene::addJoint: invalid joint descriptor.");
+		return PX_INVALID_U32;
+	}
+
+	const PxImmediateHandle handle = mFreeJoints.size() ? mFreeJoints.popBack() : mJoints.size();
+	if(handle == mJoints.size())
+		mJoints.insert();
+
+	ImmediateJoint& joint = mJoints[handle];
+	joint.body0 = desc.body0;
+	joint.body1 = desc.body1;
+	joint.solverPrep = desc.solverPrep;
+	joint.constantBlock = desc.constantBlock;
+	joint.minResponseThreshold = desc.minResponseThreshold;
+	return handle;
+}
+
+void Ext::ImmediateScene::removeJoint(PxImmediateHandle joint)
+{
+	PX_CHECK_AND_RETURN(joint < mJoints.size() && mJoints[joint].solverPrep, "PxImmediateScene::removeJoint: invalid joint handle.");
+
+	// joints don't carry state from one step to the next, so the handle can be reused right away
+	mJoints[joint].solverPrep = NULL;
+	mFreeJoints.pushBack(joint);
+}
+
+void Ext::ImmediateScene::setBodyPose(PxImmediateHandle body, const PxTransform& pose)
+{
+	PX_CHECK_AND_RETURN(isValidBody(body), "PxImmediateScene::setBodyPose: invalid body handle.");
+	PX_CHECK_AND_RETURN(pose.isSane(), "PxImmediateScene::setBodyPose: invalid pose.");
+
+	mBodies[body].pose = pose;
+	mBodies[body].flags |= ImmediateBody::eTELEPORTED;
+}
+
+PxTransform Ext::ImmediateScene::getBodyPose(PxImmediateHandle body) const
+{
+	PX_CHECK_AND_RETURN_VAL(isValidBody(body), "PxImmediateScene::getBodyPose: invalid body handle.", PxTransform(PxIdentity));
+	return mBodies[body].pose;
+}
+
+void Ext::ImmediateScene::setBodyVelocity(PxImmediateHandle body, const PxVec3& linearVelocity, const PxVec3& angularVelocity)
+{
+	PX_CHECK_AND_RETURN(isValidBody(body), "PxImmediateScene::setBodyVelocity: invalid body handle.");
+	PX_CHECK_AND_RETURN(linearVelocity.isFinite() && angularVelocity.isFinite(), "PxImmediateScene::setBodyVelocity: invalid velocity.");
+
+	mBodies[body].linearVelocity = linearVelocity;
+	mBodies[body].angularVelocity = angularVelocity;
+}
+
+PxVec3 Ext::ImmediateScene::getBodyLinearVelocity(PxImmediateHandle body) const
+{
+	PX_CHECK_AND_RETURN_VAL(isValidBody(body), "PxImmediateScene::getBodyLinearVelocity: invalid body handle.", PxVec3(0.0f));
+	return mBodies[body].linearVelocity;
+}
+
+PxVec3 Ext::ImmediateScene::getBodyAngularVelocity(PxImmediateHandle body) const
+{
+	PX_CHECK_AND_RETURN_VAL(isValidBody(body), "PxImmediateScene::getBodyAngularVelocity: invalid body handle.", PxVec3(0.0f));
+	return mBodies[body].angularVelocity;
+}
+
+void* Ext::ImmediateScene::getBodyUserData(PxImmediateHandle body) const
+{
+	PX_CHECK_AND_RETURN_NULL(isValidBody(body), "PxImmediateScene::getBodyUserData: invalid body handle.");
+	return mBodies[body].userData;
+}
+
+void Ext::ImmediateScene::runTasks(ImmediateTask::Function function, PxU32 nbTasks, const char* name)
+{
+	if(!mDesc.cpuDispatcher || nbTasks <= 1)
+	{
+		for(PxU32 i = 0; i < nbTasks; i++)
+			(this->*function)(i);
+		return;
+	}
+
+	if(mTasks.size() < nbTasks)
+		mTasks.resize(nbTasks);
+
+	mNbPendingTasks = PxI32(nbTasks - 1);
+	mTasksDone.reset();
+
+	for(PxU32 i = 1; i < nbTasks; i++)
+	{
+		ImmediateTask& task = mTasks[i];
+		task.mScene = this;
+		task.mFunction = function;
+		task.mName = name;
+		task.mIndex = i;
+		mDesc.cpuDispatcher->submitTask(task);
+	}
+
+	// the calling thread takes the first task rather than idling
+	(this->*function)(0);
+
+	if(!mDesc.cpuDispatcher->waitUntil(isSyncSet, &mTasksDone))
+		mTasksDone.wait();
+}
+
+void Ext::ImmediateScene::taskDone()
+{
+	if(!Ps::atomicDecrement(&mNbPendingTasks))
+		mTasksDone.set();
+}
+
+void Ext::ImmediateScene::step(PxReal dt)
+{
+	PX_CHECK_AND_RETURN(dt > 0.0f, "PxImmediateScene::step: dt must be positive.");
+
+	mDt = dt;
+	const PxU32 nbWorkerTasks = (mDesc.cpuDispatcher ? mDesc.cpuDispatcher->getWorkerCount() : 0) + 1;
+
+	// broad phase
+	mNbBoundsTasks = PxMin(nbWorkerTasks, mBodies.size());
+	runTasks(&ImmediateScene::updateBounds, mNbBoundsTasks, "PxImmediateScene.updateBounds");
+
+	mSortedBodies.clear();
+	for(PxU32 i = 0; i < mBodies.size(); i++)
+	{
+		if(mBodies[i].flags & ImmediateBody::eALIVE)
+			mSortedBodies.pushBack(i);
+	}
+	if(mSortedBodies.size())
+		Ps::sort(mSortedBodies.begin(), mSortedBodies.size(), SortByMinX(mBounds.begin()));
+
+	mSortedMinX.resize(mSortedBodies.size());
+	for(PxU32 i = 0; i < mSortedBodies.size(); i++)
+		mSortedMinX[i] = mBounds[mSortedBodies[i]].minimum.x;
+
+	mNbSweepTasks = PxMin(nbWorkerTasks, mSortedBodies.size());
+	if(mSweepPairs.size() < mNbSweepTasks)
+		mSweepPairs.resize(mNbSweepTasks);
+	runTasks(&ImmediateScene::sweepBounds, mNbSweepTasks, "PxImmediateScene.sweepBounds");
+
+	findPairs();
+
+	// contact generation
+	const PxU32 nbContactBatches = (mPairs.size() + mDesc.pairsPerTask - 1) / mDesc.pairsPerTask;
+	while(mContactBatches.size() < nbContactBatches)
+		mContactBatches.pushBack(PX_NEW(ImmediateContactBatch));
+	runTasks(&ImmediateScene::generateContacts, nbContactBatches, "PxImmediateScene.generateContacts");
+
+	// islands, then prep, solve and integration of each group of islands
+	buildIslands();
+	runTasks(&ImmediateScene::solveIslands, mNbSolverBatches, "PxImmediateScene.solveIslands");
+}
+
+void Ext::ImmediateScene::updateBounds(PxU32 index)
+{
+	PxU32 begin, end;
+	getTaskRange(index, mNbBoundsTasks, mBodies.size(), begin, end);
+
+	const PxReal inflation = mDesc.contactDistance * 0.5f;
+	for(PxU32 i = begin; i < end; i++)
+	{
+		const ImmediateBody& body = mBodies[i];
+		if(!(body.flags & ImmediateBody::eALIVE))
+			continue;
+
+		PxBounds3 bounds = PxGeometryQuery::getWorldBounds(body.geometry.any(), body.pose.transform(body.shapeLocalPose), 1.0f);
+		bounds.fattenFast(inflation);
+		mBounds[i] = bounds;
+
+		if(!(body.flags & ImmediateBody::eDYNAMIC))
+			PxConstructStaticSolverBody(body.pose, mStaticBodyData[i]);
+	}
+}
+
+void Ext::ImmediateScene::sweepBounds(PxU32 index)
+{
+	const PxU32 nbSorted = mSortedBodies.size();
+	PxU32 begin, end;
+	getTaskRange(index, mNbSweepTasks, nbSorted, begin, end);
+
+	// each pair is found by its body with the lowest bounds, so the ranges don't find the same pairs
+	Ps::Array<ImmediatePair>& pairs = mSweepPairs[index];
+	pairs.clear();
+
+	for(PxU32 i = begin; i < end; i++)
+	{
+		const PxU32 handle0 = mSortedBodies[i];
+		const ImmediateBody& body0 = mBodies[handle0];
+		const PxBounds3& bounds0 = mBounds[handle0];
+
+		for(PxU32 j = i + 1; j < nbSorted && mSortedMinX[j] <= bounds0.maximum.x; j++)
+		{
+			const PxU32 handle1 = mSortedBodies[j];
+			const ImmediateBody& body1 = mBodies[handle1];
+
+			if(!((body0.flags | body1.flags) & ImmediateBody::eDYNAMIC))
+				continue;
+			if(body0.collisionGroup && body0.collisionGroup == body1.collisionGroup)
+				continue;
+			if(!bounds0.intersects(mBounds[handle1]))
+				continue;
+
+			ImmediatePair& pair = pairs.insert();
+			pair.body0 = (body0.flags & ImmediateBody::eDYNAMIC) ? handle0 : handle1;
+			pair.body1 = (body0.flags & ImmediateBody::eDYNAMIC) ? handle1 : handle0;
+			pair.cachePair = PX_INVALID_IMMEDIATE_PAIR;
+			pair.startContact = 0;
+			pair.nbContacts = 0;
+		}
+	}
+}
+
+void Ext::ImmediateScene::findPairs()
+{
+	mPairs.clear();
+	for(PxU32 i = 0; i < mNbSweepTasks; i++)
+	{
+		for(PxU32 j = 0; j < mSweepPairs[i].size(); j++)
+			mPairs.pushBack(mSweepPairs[i][j]);
+	}
+
+	// the pairs that persist get their contact cache and friction patches back, the others are evicted right away
+	for(PxU32 i = 0; i < mPairs.size(); i++)
+	{
+		ImmediatePair& pair = mPairs[i];
+		pair.cachePair = mPairCache->acquirePair(pair.body0, pair.body1);
+		if((mBodies[pair.body0].flags | mBodies[pair.body1].flags) & ImmediateBody::eTELEPORTED)
+			mPairCache->resetPair(pair.cachePair);
+	}
+	mPairCache->evictStalePairs();
+
+	for(PxU32 i = 0; i < mBodies.size(); i++)
+		mBodies[i].flags &= ~PxU32(ImmediateBody::eTELEPORTED);
+}
+
+void Ext::ImmediateScene::generateContacts(PxU32 index)
+{
+	ImmediateContactBatch& batch = *mContactBatches[index];
+	batch.contacts.clear();
+
+	ContactRecorder recorder(batch.contacts);
+
+	const PxU32 begin = index * mDesc.pairsPerTask;
+	const PxU32 end = PxMin(begin + mDesc.pairsPerTask, mPairs.size());
+	for(PxU32 i = begin; i < end; i++)
+	{
+		ImmediatePair& pair = mPairs[i];
+		const ImmediateBody& body0 = mBodies[pair.body0];
+		const ImmediateBody& body1 = mBodies[pair.body1];
+
+		const PxGeometry* geometry0 = &body0.geometry.any();
+		const PxGeometry* geometry1 = &body1.geometry.any();
+		const PxTransform pose0 = body0.pose.transform(body0.shapeLocalPose);
+		const PxTransform pose1 = body1.pose.transform(body1.shapeLocalPose);
+
+		PxImmediatePairCacheAllocator cacheAllocator(*mPairCache, pair.cachePair);
+		recorder.setPair(pair, body0, body1);
+		PxGenerateContacts(&geometry0, &geometry1, &pose0, &pose1, &mPairCache->getPair(pair.cachePair).cache, 1, recorder,
+			mDesc.contactDistance, mDesc.meshContactMargin, mDesc.toleranceLength, cacheAllocator);
+
+		// the friction patches of a pair that stopped touching don't correlate anymore
+		if(!pair.nbContacts)
+			mPairCache->storeFrictionPatches(pair.cachePair, NULL, 0, 0);
+	}
+}
+
+PxU32 Ext::ImmediateScene::findIsland(PxU32 body)
+{
+	PxU32 root = body;
+	while(mIslandParents[root] != root)
+		root = mIslandParents[root];
+
+	while(mIslandParents[body] != root)
+	{
+		const PxU32 next = mIslandParents[body];
+		mIslandParents[body] = root;
+		body = next;
+	}
+	return root;
+}
+
+void Ext::ImmediateScene::buildIslands()
+{
+	const PxU32 nbSlots = mBodies.size();
+	mIslandParents.resize(nbSlots);
+	mBodyIslands.resize(nbSlots);
+	mLocalIndices.resize(nbSlots);
+	for(PxU32 i = 0; i < nbSlots; i++)
+	{
+		mIslandParents[i] = i;
+		mBodyIslands[i] = PX_INVALID_U32;
+	}
+
+	// static bodies don't connect islands
+	mNbTouchingPairs = 0;
+	for(PxU32 i = 0; i < mPairs.size(); i++)
+	{
+		const ImmediatePair& pair = mPairs[i];
+		if(!pair.nbContacts)
+			continue;
+
+		mNbTouchingPairs++;
+		if(mBodies[pair.body1].flags & ImmediateBody::eDYNAMIC)
+			mIslandParents[findIsland(pair.body0)] = findIsland(pair.body1);
+	}
+
+	for(PxU32 i = 0; i < mJoints.size(); i++)
+	{
+		const ImmediateJoint& joint = mJoints[i];
+		if(joint.solverPrep && (mBodies[joint.body0].flags & mBodies[joint.body1].flags & ImmediateBody::eDYNAMIC))
+			mIslandParents[findIsland(joint.body0)] = findIsland(joint.body1);
+	}
+
+	mNbIslands = 0;
+	for(PxU32 i = 0; i < nbSlots; i++)
+	{
+		if((mBodies[i].flags & (ImmediateBody::eALIVE | ImmediateBody::eDYNAMIC)) != (ImmediateBody::eALIVE | ImmediateBody::eDYNAMIC))
+			continue;
+
+		const PxU32 root = findIsland(i);
+		if(mBodyIslands[root] == PX_INVALID_U32)
+			mBodyIslands[root] = mNbIslands++;
+		mBodyIslands[i] = mBodyIslands[root];
+	}
+
+	// counting sorts of the bodies, touching pairs and joints by island
+	mIslandBodyStarts.resize(mNbIslands + 1);
+	mIslandPairStarts.resize(mNbIslands + 1);
+	mIslandJointStarts.resize(mNbIslands + 1);
+	PxMemZero(mIslandBodyStarts.begin(), sizeof(PxU32) * (mNbIslands + 1));
+	PxMemZero(mIslandPairStarts.begin(), sizeof(PxU32) * (mNbIslands + 1));
+	PxMemZero(mIslandJointStarts.begin(), sizeof(PxU32) * (mNbIslands + 1));
+
+	for(PxU32 i = 0; i < nbSlots; i++)
+	{
+		if(mBodyIslands[i] != PX_INVALID_U32)
+			mIslandBodyStarts[mBodyIslands[i] + 1]++;
+	}
+	for(PxU32 i = 0; i < mPairs.size(); i++)
+	{
+		if(mPairs[i].nbContacts)
+			mIslandPairStarts[mBodyIslands[mPairs[i].body0] + 1]++;
+	}
+	for(PxU32 i = 0; i < mJoints.size(); i++)
+	{
+		const ImmediateJoint& joint = mJoints[i];
+		if(joint.solverPrep)
+			mIslandJointStarts[PxMin(mBodyIslands[joint.body0], mBodyIslands[joint.body1]) + 1]++;
+	}
+	for(PxU32 i = 0; i < mNbIslands; i++)
+	{
+		mIslandBodyStarts[i + 1] += mIslandBodyStarts[i];
+		mIslandPairStarts[i + 1] += mIslandPairStarts[i];
+		mIslandJointStarts[i + 1] += mIslandJointStarts[i];
+	}
+
+	mIslandBodies.resize(mIslandBodyStarts[mNbIslands]);
+	mIslandPairs.resize(mIslandPairStarts[mNbIslands]);
+	mIslandJoints.resize(mIslandJointStarts[mNbIslands]);
+	{
+		// the starts are used as write cursors, then shifted back
+		for(PxU32 i = 0; i < nbSlots; i++)
+		{
+			if(mBodyIslands[i] != PX_INVALID_U32)
+				mIslandBodies[mIslandBodyStarts[mBodyIslands[i]]++] = i;
+		}
+		for(PxU32 i = 0; i < mPairs.size(); i++)
+		{
+			if(mPairs[i].nbContacts)
+				mIslandPairs[mIslandPairStarts[mBodyIslands[mPairs[i].body0]]++] = i;
+		}
+		for(PxU32 i = 0; i < mJoints.size(); i++)
+		{
+			const ImmediateJoint& joint = mJoints[i];
+			if(joint.solverPrep)
+				mIslandJoints[mIslandJointStarts[PxMin(mBodyIslands[joint.body0], mBodyIslands[joint.body1])]++] = i;
+		}
+		for(PxU32 i = mNbIslands; i > 0; i--)
+		{
+			mIslandBodyStarts[i] = mIslandBodyStarts[i - 1];
+			mIslandPairStarts[i] = mIslandPairStarts[i - 1];
+			mIslandJointStarts[i] = mIslandJointStarts[i - 1];
+		}
+		mIslandBodyStarts[0] = mIslandPairStarts[0] = mIslandJointStarts[0] = 0;
+	}
+
+	// whole islands are grouped in batches of about bodiesPerTask bodies
+	mNbSolverBatches = 0;
+	PxU32 firstIsland = 0;
+	for(PxU32 i = 0; i < mNbIslands; i++)
+	{
+		const bool last = i + 1 == mNbIslands;
+		if(!last && mIslandBodyStarts[i + 1] - mIslandBodyStarts[firstIsland] < mDesc.bodiesPerTask)
+			continue;
+
+		if(mSolverBatches.size() == mNbSolverBatches)
+			mSolverBatches.pushBack(PX_NEW(ImmediateSolverBatch));
+
+		ImmediateSolverBatch& batch = *mSolverBatches[mNbSolverBatches++];
+		batch.startBody = mIslandBodyStarts[firstIsland];
+		batch.nbBodies = mIslandBodyStarts[i + 1] - batch.startBody;
+		batch.startPair = mIslandPairStarts[firstIsland];
+		batch.nbPairs = mIslandPairStarts[i + 1] - batch.startPair;
+		batch.startJoint = mIslandJointStarts[firstIsland];
+		batch.nbJoints = mIslandJointStarts[i + 1] - batch.startJoint;
+
+		for(PxU32 j = 0; j < batch.nbBodies; j++)
+			mLocalIndices[mIslandBodies[batch.startBody + j]] = j;
+
+		firstIsland = i + 1;
+	}
+}
+
+void Ext::ImmediateScene::solveIslands(PxU32 index)
+{
+	ImmediateSolverBatch& batch = *mSolverBatches[index];
+	const PxU32 nbBodies = batch.nbBodies;
+	const PxReal dt = mDt;
+	const PxReal invDt = 1.0f / dt;
+
+	ImmediateConstraintAllocator& allocator = batch.constraintAllocator;
+	allocator.reset();
+	PxImmediateFrictionRecorder frictionRecorder(*mPairCache, allocator);
+
+	// the static bodies share the solver body after the dynamic ones, outside of the range seen by the batching
+	batch.solverBodies.resize(nbBodies + 1);
+	batch.solverBodyData.resize(nbBodies);
+	PxMemZero(batch.solverBodies.begin(), sizeof(PxSolverBody) * (nbBodies + 1));
+	PxSolverBody* staticSolverBody = batch.solverBodies.begin() + nbBodies;
+
+	for(PxU32 i = 0; i < nbBodies; i++)
+	{
+		const ImmediateBody& body = mBodies[mIslandBodies[batch.startBody + i]];
+
+		PxRigidBodyData data;
+		data.linearVelocity = body.linearVelocity;
+		data.invMass = body.invMass;
+		data.angularVelocity = body.angularVelocity;
+		data.maxDepenetrationVelocity = body.maxDepenetrationVelocity;
+		data.invInertia = body.invInertia;
+		data.maxContactImpulse = body.maxContactImpulse;
+		data.body2World = body.pose;
+		data.linearDamping = body.linearDamping;
+		data.angularDamping = body.angularDamping;
+		data.maxLinearVelocitySq = body.maxLinearVelocitySq;
+		data.maxAngularVelocitySq = body.maxAngularVelocitySq;
+		data.pad = 0;
+
+		PxConstructSolverBodies(&data, &batch.solverBodyData[i], 1, mDesc.gravity, dt);
+	}
+
+	const PxU32 nbPairs = batch.nbPairs;
+	const PxU32 nbJoints = batch.nbJoints;
+	const PxU32 nbConstraints = nbPairs + nbJoints;
+	batch.descs.resize(nbConstraints);
+	batch.orderedDescs.resize(nbConstraints);
+	batch.headers.resize(nbConstraints);
+
+	for(PxU32 i = 0; i < nbConstraints; i++)
+	{
+		PxU32 body0, body1;
+		PxSolverConstraintDesc& desc = batch.descs[i];
+		if(i < nbPairs)
+		{
+			ImmediatePair& pair = mPairs[mIslandPairs[batch.startPair + i]];
+			body0 = pair.body0;
+			body1 = pair.body1;
+			desc.constraint = reinterpret_cast<PxU8*>(&pair);
+			desc.constraintLengthOver16 = PxSolverConstraintDesc::eCONTACT_CONSTRAINT;
+		}
+		else
+		{
+			ImmediateJoint& joint = mJoints[mIslandJoints[batch.startJoint + i - nbPairs]];
+			body0 = joint.body0;
+			body1 = joint.body1;
+			desc.constraint = reinterpret_cast<PxU8*>(&joint);
+			desc.constraintLengthOver16 = PxSolverConstraintDesc::eJOINT_CONSTRAINT;
+		}
+
+		const bool dynamic0 = (mBodies[body0].flags & ImmediateBody::eDYNAMIC) != 0;
+		const bool dynamic1 = (mBodies[body1].flags & ImmediateBody::eDYNAMIC) != 0;
+		desc.bodyA = dynamic0 ? batch.solverBodies.begin() + mLocalIndices[body0] : staticSolverBody;
+		desc.bodyB = dynamic1 ? batch.solverBodies.begin() + mLocalIndices[body1] : staticSolverBody;
+		desc.bodyADataIndex = body0;
+		desc.bodyBDataIndex = body1;
+		desc.linkIndexA = PxSolverConstraintDesc::NO_LINK;
+		desc.linkIndexB = PxSolverConstraintDesc::NO_LINK;
+		desc.writeBack = NULL;
+		desc.writeBackLengthOver4 = 0;
+	}
+
+	// contacts and joints are batched apart so that each header only references one kind
+	const PxU32 nbContactHeaders = nbPairs ? PxBatchConstraints(batch.descs.begin(), nbPairs, batch.solverBodies.begin(), nbBodies,
+		batch.headers.begin(), batch.orderedDescs.begin()) : 0;
+	const PxU32 nbJointHeaders = nbJoints ? PxBatchConstraints(batch.descs.begin() + nbPairs, nbJoints, batch.solverBodies.begin(), nbBodies,
+		batch.headers.begin() + nbContactHeaders, batch.orderedDescs.begin() + nbPairs) : 0;
+
+	for(PxU32 i = 0; i < nbContactHeaders; i++)
+	{
+		PxConstraintBatchHeader& header = batch.headers[i];
+		PX_ASSERT(header.mConstraintType == PxSolverConstraintDesc::eCONTACT_CONSTRAINT);
+
+		PxSolverContactDesc contactDescs[4];
+		PxU32 cachePairs[4];
+		for(PxU32 a = 0; a < header.mStride; a++)
+		{
+			PxSolverConstraintDesc& constraintDesc = batch.orderedDescs[header.mStartIndex + a];
+			const ImmediatePair& pair = *reinterpret_cast<const ImmediatePair*>(constraintDesc.constraint);
+			const PxImmediatePair& cachePair = mPairCache->getPair(pair.cachePair);
+			const bool dynamic1 = constraintDesc.bodyB != staticSolverBody;
+			cachePairs[a] = pair.cachePair;
+
+			PxSolverContactDesc& contactDesc = contactDescs[a];
+			contactDesc.body0 = constraintDesc.bodyA;
+			contactDesc.body1 = constraintDesc.bodyB;
+			contactDesc.data0 = &batch.solverBodyData[mLocalIndices[pair.body0]];
+			contactDesc.data1 = dynamic1 ? &batch.solverBodyData[mLocalIndices[pair.body1]] : &mStaticBodyData[pair.body1];
+			contactDesc.bodyFrame0 = contactDesc.data0->body2World;
+			contactDesc.bodyFrame1 = contactDesc.data1->body2World;
+			contactDesc.bodyState0 = PxSolverConstraintPrepDescBase::eDYNAMIC_BODY;
+			contactDesc.bodyState1 = dynamic1 ? PxSolverConstraintPrepDescBase::eDYNAMIC_BODY : PxSolverConstraintPrepDescBase::eSTATIC_BODY;
+			contactDesc.desc = &constraintDesc;
+			contactDesc.mInvMassScales.linear0 = contactDesc.mInvMassScales.linear1 = 1.0f;
+			contactDesc.mInvMassScales.angular0 = contactDesc.mInvMassScales.angular1 = 1.0f;
+
+			contactDesc.contacts = mContactBatches[PxU32(&pair - mPairs.begin()) / mDesc.pairsPerTask]->contacts.begin() + pair.startContact;
+			contactDesc.numContacts = pair.nbContacts;
+			contactDesc.contactForces = reinterpret_cast<PxReal*>(allocator.reserveConstraintData(sizeof(PxReal) * pair.nbContacts));
+			contactDesc.frictionPtr = cachePair.frictionPatches;
+			contactDesc.frictionCount = cachePair.nbFrictionPatches;
+			contactDesc.disableStrongFriction = false;
+			contactDesc.hasMaxImpulse = PxMin(mBodies[pair.body0].maxContactImpulse, mBodies[pair.body1].maxContactImpulse) < PX_MAX_F32;
+			contactDesc.hasForceThresholds = false;
+			contactDesc.shapeInteraction = NULL;
+			contactDesc.restDistance = 0.0f;
+			contactDesc.maxCCDSeparation = PX_MAX_F32;
+		}
+
+		frictionRecorder.reset();
+		PxCreateContactConstraints(&header, 1, contactDescs, frictionRecorder, invDt, -mDesc.bounceThreshold,
+			mDesc.frictionOffsetThreshold, mDesc.correlationDistance);
+
+		// the new patches are correlated with these ones on the next step
+		for(PxU32 a = 0; a < header.mStride; a++)
+			frictionRecorder.storeFrictionPatches(cachePairs[a], contactDescs[a]);
+	}
+
+	for(PxU32 i = nbContactHeaders; i < nbContactHeaders + nbJointHeaders; i++)
+	{
+		PxConstraintBatchHeader& header = batch.headers[i];
+		PX_ASSERT(header.mConstraintType == PxSolverConstraintDesc::eJOINT_CONSTRAINT);
+
+		// the joint headers index the joint half of the ordered descs
+		header.mStartIndex += nbPairs;
+
+		Px1DConstraint rows[MaxJointRows * 4];
+		PxSolverConstraintPrepDesc jointDescs[4];
+		PxU32 nbRows = 0;
+		for(PxU32 a = 0; a < header.mStride; a++)
+		{
+			PxSolverConstraintDesc& constraintDesc = batch.orderedDescs[header.mStartIndex + a];
+			const ImmediateJoint& joint = *reinterpret_cast<const ImmediateJoint*>(constraintDesc.constraint);
+			const bool dynamic0 = constraintDesc.bodyA != staticSolverBody;
+			const bool dynamic1 = constraintDesc.bodyB != staticSolverBody;
+
+			PxSolverConstraintPrepDesc& jointDesc = jointDescs[a];
+			jointDesc.body0 = constraintDesc.bodyA;
+			jointDesc.body1 = constraintDesc.bodyB;
+			jointDesc.data0 = dynamic0 ? &batch.solverBodyData[mLocalIndices[joint.body0]] : &mStaticBodyData[joint.body0];
+			jointDesc.data1 = dynamic1 ? &batch.solverBodyData[mLocalIndices[joint.body1]] : &mStaticBodyData[joint.body1];
+			jointDesc.bodyFrame0 = jointDesc.data0->body2World;
+			jointDesc.bodyFrame1 = jointDesc.data1->body2World;
+			jointDesc.bodyState0 = dynamic0 ? PxSolverConstraintPrepDescBase::eDYNAMIC_BODY : PxSolverConstraintPrepDescBase::eSTATIC_BODY;
+			jointDesc.bodyState1 = dynamic1 ? PxSolverConstraintPrepDescBase::eDYNAMIC_BODY : PxSolverConstraintPrepDescBase::eSTATIC_BODY;
+			jointDesc.desc = &constraintDesc;
+			jointDesc.mInvMassScales.linear0 = jointDesc.mInvMassScales.linear1 = 1.0f;
+			jointDesc.mInvMassScales.angular0 = jointDesc.mInvMassScales.angular1 = 1.0f;
+			jointDesc.writeback = NULL;
+			jointDesc.linBreakForce = jointDesc.angBreakForce = PX_MAX_F32;
+			jointDesc.minResponseThreshold = joint.minResponseThreshold;
+			jointDesc.disablePreprocessing = false;
+			jointDesc.improvedSlerp = false;
+			jointDesc.driveLimitsAreForces = false;
+			jointDesc.body0WorldOffset = PxVec3(0.0f);
+
+			Px1DConstraint* jointRows = rows + nbRows;
+			PxMemZero(jointRows, sizeof(Px1DConstraint) * MaxJointRows);
+			for(PxU32 b = 0; b < MaxJointRows; b++)
+			{
+				jointRows[b].minImpulse = -PX_MAX_F32;
+				jointRows[b].maxImpulse = PX_MAX_F32;
+			}
+
+			jointDesc.rows = jointRows;
+			jointDesc.numRows = joint.solverPrep(jointRows, jointDesc.body0WorldOffset, MaxJointRows, jointDesc.mInvMassScales,
+				joint.constantBlock, jointDesc.bodyFrame0, jointDesc.bodyFrame1);
+			nbRows += jointDesc.numRows;
+		}
+
+		PxCreateJointConstraints(&header, 1, jointDescs, allocator, dt, invDt);
+	}
+
+	// the batching used the solver bodies as scratch memory
+	PxMemZero(batch.solverBodies.begin(), sizeof(PxSolverBody) * (nbBodies + 1));
+	batch.motionLinearVelocity.resize(nbBodies);
+	batch.motionAngularVelocity.resize(nbBodies);
+
+	PxSolveConstraints(batch.headers.begin(), nbContactHeaders + nbJointHeaders, batch.orderedDescs.begin(), batch.solverBodies.begin(),
+		batch.motionLinearVelocity.begin(), batch.motionAngularVelocity.begin(), nbBodies, mDesc.nbPositionIterations, mDesc.nbVelocityIterations);
+
+	PxIntegrateSolverBodies(batch.solverBodyData.begin(), batch.solverBodies.begin(), batch.motionLinearVelocity.begin(),
+		batch.motionAngularVelocity.begin(), nbBodies, dt);
+
+	for(PxU32 i = 0; i < nbBodies; i++)
+	{
+		ImmediateBody& body = mBodies[mIslandBodies[batch.startBody + i]];
+		const PxSolverBodyData& data = batch.solverBodyData[i];
+		body.pose = data.body2World;
+		body.linearVelocity = data.linearVelocity;
+		body.angularVelocity = data.angularVelocity;
+	}
+}
@@ -0,0 +1,279 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_IMMEDIATE_SCENE_INTERNAL_H
+#define PX_PHYSICS_EXTENSIONS_IMMEDIATE_SCENE_INTERNAL_H
+
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsArray.h"
+#include "PsSync.h"
+#include "foundation/PxBounds3.h"
+#include "PxImmediateScene.h"
+#include "PxImmediatePairCache.h"
+#include "PxImmediateMode.h"
+#include "geometry/PxGeometryHelpers.h"
+#include "GeomUtils/GuContactPoint.h"
+#include "task/PxTask.h"
+
+namespace physx
+{
+
+namespace Ext
+{
+	class ImmediateScene;
+
+	// Linear allocator of 16 byte aligned blocks, reset as a whole
+	class ImmediateBlockAllocator
+	{
+	public:
+		static const PxU32 PageSize = 32 * 1024;
+
+											ImmediateBlockAllocator() : mCurrentPage(0), mCurrentOffset(PageSize) {}
+											~ImmediateBlockAllocator();
+
+						PxU8*				allocate(PxU32 size);
+						void				reset()	{ mCurrentPage = 0; mCurrentOffset = mPages.size() ? 0 : PageSize; }
+
+	private:
+						struct Page
+						{
+							PxU8*	data;
+							PxU32	size;
+						};
+
+						Ps::Array<Page>		mPages;
+						PxU32				mCurrentPage;
+						PxU32				mCurrentOffset;
+	};
+
+	class ImmediateConstraintAllocator : public PxConstraintAllocator
+	{
+	public:
+		virtual			PxU8*				reserveConstraintData(const PxU32 byteSize)	{ return mBlocks.allocate(byteSize);	}
+		virtual			PxU8*				reserveFrictionData(const PxU32 byteSize)	{ return mBlocks.allocate(byteSize);	}
+
+						void				reset()	{ mBlocks.reset();	}
+
+	private:
+						ImmediateBlockAllocator	mBlocks;
+	};
+
+	// Runs one of the parallel stages of ImmediateScene::step() on a dispatcher worker
+	class ImmediateTask : public PxBaseTask
+	{
+	public:
+		typedef void (ImmediateScene::*Function)(PxU32 index);
+
+											ImmediateTask() : mScene(NULL), mFunction(NULL), mName(NULL), mIndex(0) {}
+
+		virtual			void				run();
+		virtual			const char*			getName()		const	{ return mName;	}
+		virtual			void				addReference()			{}
+		virtual			void				removeReference()		{}
+		virtual			int32_t				getReference()	const	{ return 1;		}
+		virtual			void				release();
+
+						ImmediateScene*		mScene;
+						Function			mFunction;
+						const char*			mName;
+						PxU32				mIndex;
+	};
+
+	struct ImmediateBody
+	{
+		enum Flags
+		{
+			eALIVE		= (1<<0),
+			eDYNAMIC	= (1<<1),
+			eTELEPORTED	= (1<<2)	// the pairs are reset on the next step
+		};
+
+		PxGeometryHolder	geometry;
+		PxTransform			pose;
+		PxTransform			shapeLocalPose;
+		PxVec3				linearVelocity;
+		PxVec3				angularVelocity;
+		PxReal				invMass;
+		PxVec3				invInertia;
+		PxReal				linearDamping;
+		PxReal				angularDamping;
+		PxReal				maxLinearVelocitySq;
+		PxReal				maxAngularVelocitySq;
+		PxReal				maxDepenetrationVelocity;
+		PxReal				maxContactImpulse;
+		PxReal				staticFriction;
+		PxReal				dynamicFriction;
+		PxReal				restitution;
+		PxU32				collisionGroup;
+		void*				userData;
+		PxU32				flags;
+	};
+
+	struct ImmediateJoint
+	{
+		PxImmediateHandle		body0;
+		PxImmediateHandle		body1;
+		PxConstraintSolverPrep	solverPrep;
+		const void*				constantBlock;
+		PxReal					minResponseThreshold;
+	};
+
+	// A pair of the broad phase. body0 is always dynamic
+	struct ImmediatePair
+	{
+		PxU32		body0;
+		PxU32		body1;
+		PxU32		cachePair;		// handle of the persistent state in the pair cache
+		PxU32		startContact;	// in the contacts of the contact batch of the pair
+		PxU32		nbContacts;
+	};
+
+	struct ImmediateContactBatch
+	{
+		Ps::Array<Gu::ContactPoint>	contacts;
+	};
+
+	// Islands solved by the same task, as ranges of the island sorted bodies, pairs and joints
+	struct ImmediateSolverBatch
+	{
+		PxU32		startBody, nbBodies;
+		PxU32		startPair, nbPairs;
+		PxU32		startJoint, nbJoints;
+
+		Ps::Array<PxSolverBody>				solverBodies;		// the last one is shared by the static bodies
+		Ps::Array<PxSolverBodyData>			solverBodyData;
+		Ps::Array<PxSolverConstraintDesc>	descs;
+		Ps::Array<PxSolverConstraintDesc>	orderedDescs;
+		Ps::Array<PxConstraintBatchHeader>	headers;
+		Ps::Array<PxReal>					contactForces;
+		Ps::Array<PxVec3>					motionLinearVelocity;
+		Ps::Array<PxVec3>					motionAngularVelocity;
+		ImmediateConstraintAllocator		constraintAllocator;
+	};
+
+	class ImmediateScene : public PxImmediateScene, public Ps::UserAllocated
+	{
+	public:
+											ImmediateScene(const PxImmediateSceneDesc& desc);
+
+		//---------------------------------------------------------------------------------
+		// PxImmediateScene implementation
+		//---------------------------------------------------------------------------------
+		virtual			void				release();
+
+		virtual			PxImmediateHandle	addBody(const PxImmediateBodyDesc& desc);
+		virtual			void				removeBody(PxImmediateHandle body);
+		virtual			PxImmediateHandle	addJoint(const PxImmediateJointDesc& desc);
+		virtual			void				removeJoint(PxImmediateHandle joint);
+
+		virtual			void				setBodyPose(PxImmediateHandle body, const PxTransform& pose);
+		virtual			PxTransform			getBodyPose(PxImmediateHandle body) const;
+		virtual			void				setBodyVelocity(PxImmediateHandle body, const PxVec3& linearVelocity, const PxVec3& angularVelocity);
+		virtual			PxVec3				getBodyLinearVelocity(PxImmediateHandle body) const;
+		virtual			PxVec3				getBodyAngularVelocity(PxImmediateHandle body) const;
+		virtual			void*				getBodyUserData(PxImmediateHandle body) const;
+
+		virtual			void				step(PxReal dt);
+
+		virtual			PxU32				getNbBodies()	const	{ return mNbBodies;	}
+		virtual			void				getNbPairs(PxU32& nbPairs, PxU32& nbTouchingPairs) const	{ nbPairs = mPairs.size(); nbTouchingPairs = mNbTouchingPairs;	}
+		virtual			PxU32				getNbIslands()	const	{ return mNbIslands;	}
+
+		//---------------------------------------------------------------------------------
+		// Stages of step(), run by the tasks
+		//---------------------------------------------------------------------------------
+						void				updateBounds(PxU32 index);
+						void				sweepBounds(PxU32 index);
+						void				generateContacts(PxU32 index);
+						void				solveIslands(PxU32 index);
+
+						void				taskDone();
+
+	private:
+											~ImmediateScene();
+
+						bool				isValidBody(PxImmediateHandle body) const	{ return body < mBodies.size() && (mBodies[body].flags & ImmediateBody::eALIVE);	}
+
+						void				runTasks(ImmediateTask::Function function, PxU32 nbTasks, const char* name);
+						void				findPairs();
+						void				buildIslands();
+						PxU32				findIsland(PxU32 body);
+
+						PxImmediateSceneDesc				mDesc;
+
+						Ps::Array<ImmediateBody>			mBodies;
+						Ps::Array<PxImmediateHandle>		mFreeBodies;
+						PxU32								mNbBodies;
+
+						Ps::Array<ImmediateJoint>			mJoints;
+						Ps::Array<PxImmediateHandle>		mFreeJoints;
+
+						// broad phase
+						Ps::Array<PxBounds3>				mBounds;
+						Ps::Array<PxSolverBodyData>			mStaticBodyData;
+						PxU32								mNbBoundsTasks;
+						PxU32								mNbSweepTasks;
+						Ps::Array<PxU32>					mSortedBodies;
+						Ps::Array<PxReal>					mSortedMinX;
+						Ps::Array<Ps::Array<ImmediatePair> >	mSweepPairs;
+						Ps::Array<ImmediatePair>			mPairs;
+						PxImmediatePairCache*				mPairCache;
+
+						// contact generation
+						Ps::Array<ImmediateContactBatch*>	mContactBatches;
+						PxU32								mNbTouchingPairs;
+
+						// islands
+						Ps::Array<PxU32>					mIslandParents;
+						Ps::Array<PxU32>					mBodyIslands;
+						Ps::Array<PxU32>					mLocalIndices;		// index of a dynamic body in its solver batch
+						Ps::Array<PxU32>					mIslandBodyStarts;
+						Ps::Array<PxU32>					mIslandPairStarts;
+						Ps::Array<PxU32>					mIslandJointStarts;
+						Ps::Array<PxU32>					mIslandBodies;
+						Ps::Array<PxU32>					mIslandPairs;
+						Ps::Array<PxU32>					mIslandJoints;
+						Ps::Array<ImmediateSolverBatch*>	mSolverBatches;
+						PxU32								mNbSolverBatches;
+						PxU32								mNbIslands;
+
+						PxReal								mDt;
+
+						// tasks
+						Ps::Array<ImmediateTask>			mTasks;
+						volatile PxI32						mNbPendingTasks;
+						Ps::Sync							mTasksDone;
+	};
+
+} // namespace Ext
+}
+
+#endif
@@ -60,7 +60,10 @@ namespace Ext
 
 		body0WorldOffset = cB2w.p-bA2w.p;
 		joint::ConstraintHelper ch(constraints,cB2w.p-bA2w.p, cB2w.p-bB2w.p);
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, bOriginInA, limitIsLocked ? 7ul : 6ul, 7ul);
+		if(limitIsLocked)
+			ch.prepareLockedAxes<7, 7>(cA2w.q, cB2w.q, bOriginInA);
+		else
+			ch.prepareLockedAxes<6, 7>(cA2w.q, cB2w.q, bOriginInA);
 
 		if(limitEnabled && !limitIsLocked)
 		{
@@ -39,7 +39,11 @@ using namespace physx;
 #include "PxScene.h"
 #include "PxRigidDynamic.h"
 #include "extensions/PxShapeExt.h"
+#include "task/PxCpuDispatcher.h"
+#include "task/PxTask.h"
 #include "PsArray.h"
+#include "PsAtomic.h"
+#include "PsSync.h"
 
 namespace physx
 {
@@ -47,24 +51,67 @@ class RaycastCCDManagerInternal
 {
 	PX_NOCOPY(RaycastCCDManagerInternal)
 	public:
-				RaycastCCDManagerInternal(PxScene* scene) : mScene(scene)	{}
+				RaycastCCDManagerInternal(PxScene* scene) : mScene(scene), mPendingTasks(0), mDynamicDynamic(false)	{}
 				~RaycastCCDManagerInternal(){}
 
-		bool	registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape);
+		bool	registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape, bool useSweep);
 
 		void	doRaycastCCD(bool doDynamicDynamicCCD);
 
 		struct CCDObject
 		{
-			PX_FORCE_INLINE	CCDObject(PxRigidDynamic* actor, PxShape* shape, const PxVec3& witness) : mActor(actor), mShape(shape), mWitness(witness)	{}
+			PX_FORCE_INLINE	CCDObject(PxRigidDynamic* actor, PxShape* shape, const PxVec3& witness, bool useSweep) : mActor(actor), mShape(shape), mWitness(witness), mUseSweep(useSweep)	{}
 			PxRigidDynamic*	mActor;
 			PxShape*		mShape;
 			PxVec3			mWitness;
+			bool			mUseSweep;
 		};
 
+		// One object moving this frame. The queries only read the scene, the results are applied afterwards in registration order
+		struct CCDQuery
+		{
+			PxTransform		mNewPose;			// shape pose at the end of the frame
+			PxVec3			mNewShapeCenter;
+			PxVec3			mDir;
+			PxReal			mLength;
+			PxReal			mInternalRadius;
+			PxU32			mObject;
+			// results
+			PxRigidActor*	mHitActor;
+			PxReal			mHitDistance;
+			bool			mHasHit;
+		};
+
+		void	runQueries(PxU32 start, PxU32 count);
+		void	onTaskDone()	{ if(!physx::shdfnd::atomicDecrement(&mPendingTasks)) mQueriesDone.set();	}
+
 	private:
+		class QueryTask : public PxLightCpuTask
+		{
+			public:
+								QueryTask() : mManager(NULL), mStart(0), mCount(0)	{}
+
+				void			setData(RaycastCCDManagerInternal* manager, PxU32 start, PxU32 count)	{ mManager = manager; mStart = start; mCount = count;	}
+
+				virtual void	run()					{ mManager->runQueries(mStart, mCount);	}
+				// submitted straight to the dispatcher, there is no continuation
+				virtual void	release()				{ mManager->onTaskDone();				}
+				virtual const char*	getName() const		{ return "RaycastCCDManager.queries";	}
+			private:
+				RaycastCCDManagerInternal*	mManager;
+				PxU32						mStart;
+				PxU32						mCount;
+		};
+
+		static const PxU32				QUERIES_PER_TASK = 32;
+
 		PxScene*						mScene;
 		physx::shdfnd::Array<CCDObject>	mObjects;
+		physx::shdfnd::Array<CCDQuery>	mQueries;
+		physx::shdfnd::Array<QueryTask>	mTasks;
+		physx::shdfnd::Sync						mQueriesDone;
+		volatile PxI32					mPendingTasks;
+		bool							mDynamicDynamic;
 };
 }
 
@@ -180,15 +227,30 @@ public:
 	}
 };
 
-static bool CCDRaycast(PxScene* scene, PxRigidActor* actor, PxShape* shape, const PxVec3& origin, const PxVec3& unitDir, const PxReal distance, PxRaycastHit& hit, bool dyna_dyna)
+static PX_FORCE_INLINE PxQueryFilterData getCCDFilterData(bool dyna_dyna)
 {
 	const PxQueryFlags qf(dyna_dyna ? PxQueryFlags(PxQueryFlag::eSTATIC|PxQueryFlag::eDYNAMIC|PxQueryFlag::ePREFILTER) : PxQueryFlags(PxQueryFlag::eSTATIC));
-	const PxQueryFilterData filterData(PxFilterData(), qf);
+	return PxQueryFilterData(PxFilterData(), qf);
+}
 
+static bool CCDRaycast(PxScene* scene, PxRigidActor* actor, PxShape* shape, const PxVec3& origin, const PxVec3& unitDir, const PxReal distance, PxRaycastHit& hit, bool dyna_dyna)
+{
 	CCDRaycastFilterCallback CB(actor, shape);
 
 	PxRaycastBuffer buf1;
-	scene->raycast(origin, unitDir, distance, buf1, PxHitFlag::eDISTANCE, filterData, &CB);
+	scene->raycast(origin, unitDir, distance, buf1, PxHitFlag::eDISTANCE, getCCDFilterData(dyna_dyna), &CB);
+	hit = buf1.block;
+	return buf1.hasBlock;
+}
+
+// Sweeps the shape itself, for objects too thin for the ray from their center to be reliable
+static bool CCDSweep(PxScene* scene, PxRigidActor* actor, PxShape* shape, const PxTransform& pose, const PxVec3& unitDir, const PxReal distance, PxSweepHit& hit, bool dyna_dyna)
+{
+	CCDRaycastFilterCallback CB(actor, shape);
+
+	// the object starts where the simulation left it last frame, which may be touching something. Only what is in the way counts.
+	PxSweepBuffer buf1;
+	scene->sweep(shape->getGeometry().any(), pose, unitDir, distance, buf1, PxHitFlag::eDISTANCE|PxHitFlag::eASSUME_NO_INITIAL_OVERLAP, getCCDFilterData(dyna_dyna), &CB);
 	hit = buf1.block;
 	return buf1.hasBlock;
 }
@@ -209,65 +271,98 @@ static PxRigidDynamic* canDoCCD(PxRigidActor& actor, PxShape* /*shape*/)
 	return dyna;
 }
 
-static bool doRaycastCCD(PxScene* scene, const RaycastCCDManagerInternal::CCDObject& object, PxTransform& newPose, PxVec3& newShapeCenter, bool dyna_dyna)
+static void setShapeCenter(const RaycastCCDManagerInternal::CCDObject& object, const RaycastCCDManagerInternal::CCDQuery& query, const PxVec3& newShapeCenter)
 {
-	PxRigidDynamic* dyna = canDoCCD(*object.mActor, object.mShape);
-	if(!dyna)
-		return true;
+	const PxVec3 offset = query.mNewPose.p - query.mNewShapeCenter;
+	const PxTransform newPose(offset + newShapeCenter, query.mNewPose.q);
+
+	const PxTransform shapeLocalPose = object.mShape->getLocalPose();
+	const PxTransform inverseShapeLocalPose = shapeLocalPose.getInverse();
+	const PxTransform newGlobalPose = newPose * inverseShapeLocalPose;
+	object.mActor->setGlobalPose(newGlobalPose);
+}
 
-	bool updateCCDWitness = true;
+// Returns true if the witness should move to the new shape center
+static bool applyCCD(const RaycastCCDManagerInternal::CCDObject& object, const RaycastCCDManagerInternal::CCDQuery& query)
+{
+	if(!query.mHasHit)
+		return true;
 
-	const PxVec3 offset = newPose.p - newShapeCenter;
 	const PxVec3& origin = object.mWitness;
-	const PxVec3& dest = newShapeCenter;
 
-	PxVec3 dir = dest - origin;
-	const PxReal length = dir.magnitude();
-	if(length!=0.0f)
+	if(object.mUseSweep)
 	{
-		dir /= length;
+		// the hit distance is where the shape touches, the simulation deals with anything shallower than the contact offset
+		if(query.mLength - query.mHitDistance <= object.mShape->getContactOffset())
+			return true;
 
-		const PxReal internalRadius = computeInternalRadius(object.mActor, object.mShape, dir);
+		setShapeCenter(object, query, origin + query.mDir * query.mHitDistance);
+		return false;
+	}
 
-		PxRaycastHit hit;
-		if(internalRadius!=0.0f && CCDRaycast(scene, object.mActor, object.mShape, origin, dir, length, hit, dyna_dyna))
-		{
-			updateCCDWitness = false;
-
-			const PxReal radiusLimit = internalRadius * 0.75f;
-			if(hit.distance>radiusLimit)
-			{
-				newShapeCenter = origin + dir * (hit.distance - radiusLimit);
-			}
-			else
-			{
-				if(hit.actor->getConcreteType()==PxConcreteType::eRIGID_DYNAMIC)
-					return true;
-
-				newShapeCenter = origin;
-			}
-
-			newPose.p = offset + newShapeCenter;
-			const PxTransform shapeLocalPose = object.mShape->getLocalPose();
-			const PxTransform inverseShapeLocalPose = shapeLocalPose.getInverse();
-			const PxTransform newGlobalPose = newPose * inverseShapeLocalPose;
-			dyna->setGlobalPose(newGlobalPose);
-		}
+	const PxReal radiusLimit = query.mInternalRadius * 0.75f;
+	if(query.mHitDistance>radiusLimit)
+	{
+		setShapeCenter(object, query, origin + query.mDir * (query.mHitDistance - radiusLimit));
 	}
-	return updateCCDWitness;
+	else
+	{
+		if(query.mHitActor->getConcreteType()==PxConcreteType::eRIGID_DYNAMIC)
+			return true;
+
+		setShapeCenter(object, query, origin);
+	}
+	return false;
 }
 
-bool RaycastCCDManagerInternal::registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape)
+bool RaycastCCDManagerInternal::registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape, bool useSweep)
 {
 	if(!actor || !shape)
 		return false;
 
-	mObjects.pushBack(CCDObject(actor, shape, getShapeCenter(actor, shape)));
+	mObjects.pushBack(CCDObject(actor, shape, getShapeCenter(actor, shape), useSweep));
 	return true;
 }
 
+void RaycastCCDManagerInternal::runQueries(PxU32 start, PxU32 count)
+{
+	for(PxU32 i=start;i<start+count;i++)
+	{
+		CCDQuery& query = mQueries[i];
+		const CCDObject& object = mObjects[query.mObject];
+
+		if(object.mUseSweep)
+		{
+			const PxVec3 offset = query.mNewPose.p - query.mNewShapeCenter;
+			const PxTransform pose(object.mWitness + offset, query.mNewPose.q);
+
+			PxSweepHit hit;
+			query.mHasHit = CCDSweep(mScene, object.mActor, object.mShape, pose, query.mDir, query.mLength, hit, mDynamicDynamic);
+			query.mHitActor = hit.actor;
+			query.mHitDistance = hit.distance;
+		}
+		else
+		{
+			PxRaycastHit hit;
+			query.mHasHit = CCDRaycast(mScene, object.mActor, object.mShape, object.mWitness, query.mDir, query.mLength, hit, mDynamicDynamic);
+			query.mHitActor = hit.actor;
+			query.mHitDistance = hit.distance;
+		}
+	}
+}
+
+static bool isSyncSet(void* sync)
+{
+	return reinterpret_cast<physx::shdfnd::Sync*>(sync)->wait(0);
+}
+
 void RaycastCCDManagerInternal::doRaycastCCD(bool doDynamicDynamicCCD)
 {
+	mDynamicDynamic = doDynamicDynamicCCD;
+
+	// gather the objects that moved. Nothing is modified before all the queries are done, so every query sees
+	// the scene as the simulation left it, and the result doesn't depend on the order or number of threads.
+	mQueries.clear();
 	const PxU32 nbObjects = mObjects.size();
 	for(PxU32 i=0;i<nbObjects;i++)
 	{
@@ -276,11 +371,76 @@ void RaycastCCDManagerInternal::doRaycastCCD(bool doDynamicDynamicCCD)
 		if(object.mActor->isSleeping())
 			continue;
 
-		PxTransform newPose = PxShapeExt::getGlobalPose(*object.mShape, *object.mActor);
-		PxVec3 newShapeCenter = getShapeCenter(object.mShape, newPose);
+		const PxTransform newPose = PxShapeExt::getGlobalPose(*object.mShape, *object.mActor);
+		const PxVec3 newShapeCenter = getShapeCenter(object.mShape, newPose);
 
-		if(::doRaycastCCD(mScene, object, newPose, newShapeCenter, doDynamicDynamicCCD))
+		if(!canDoCCD(*object.mActor, object.mShape))
+		{
 			object.mWitness = newShapeCenter;
+			continue;
+		}
+
+		PxVec3 dir = newShapeCenter - object.mWitness;
+		const PxReal length = dir.magnitude();
+		if(length==0.0f)
+		{
+			object.mWitness = newShapeCenter;
+			continue;
+		}
+		dir /= length;
+
+		const PxReal internalRadius = object.mUseSweep ? 0.0f : computeInternalRadius(object.mActor, object.mShape, dir);
+		if(!object.mUseSweep && internalRadius==0.0f)
+		{
+			object.mWitness = newShapeCenter;
+			continue;
+		}
+
+		CCDQuery& query = mQueries.insert();
+		query.mNewPose			= newPose;
+		query.mNewShapeCenter	= newShapeCenter;
+		query.mDir				= dir;
+		query.mLength			= length;
+		query.mInternalRadius	= internalRadius;
+		query.mObject			= i;
+		query.mHitActor			= NULL;
+		query.mHitDistance		= 0.0f;
+		query.mHasHit			= false;
+	}
+
+	// the workers can't take the read lock if the caller already holds the write lock, so scenes that require
+	// the lock run all the queries here
+	const PxU32 nbQueries = mQueries.size();
+	PxCpuDispatcher* dispatcher = mScene->getCpuDispatcher();
+	if(nbQueries>QUERIES_PER_TASK && dispatcher && dispatcher->getWorkerCount() && !(mScene->getFlags() & PxSceneFlag::eREQUIRE_RW_LOCK))
+	{
+		// the first batch is done by this thread
+		const PxU32 nbTasks = (nbQueries - 1) / QUERIES_PER_TASK;
+		mTasks.resize(nbTasks);
+
+		mQueriesDone.reset();
+		mPendingTasks = PxI32(nbTasks);
+		for(PxU32 i=0;i<nbTasks;i++)
+		{
+			const PxU32 start = (i+1) * QUERIES_PER_TASK;
+			mTasks[i].setData(this, start, PxMin(QUERIES_PER_TASK, nbQueries - start));
+			dispatcher->submitTask(mTasks[i]);
+		}
+
+		runQueries(0, QUERIES_PER_TASK);
+
+		if(!dispatcher->waitUntil(isSyncSet, &mQueriesDone))
+			mQueriesDone.wait();
+	}
+	else
+		runQueries(0, nbQueries);
+
+	for(PxU32 i=0;i<nbQueries;i++)
+	{
+		const CCDQuery& query = mQueries[i];
+		CCDObject& object = mObjects[query.mObject];
+		if(applyCCD(object, query))
+			object.mWitness = query.mNewShapeCenter;
 	}
 }
 
@@ -294,9 +454,9 @@ RaycastCCDManager::~RaycastCCDManager()
 	delete mImpl;
 }
 
-bool RaycastCCDManager::registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape)
+bool RaycastCCDManager::registerRaycastCCDObject(PxRigidDynamic* actor, PxShape* shape, bool useSweep)
 {
-	return mImpl->registerRaycastCCDObject(actor, shape);
+	return mImpl->registerRaycastCCDObject(actor, shape, useSweep);
 }
 
 void RaycastCCDManager::doRaycastCCD(bool doDynamicDynamicCCD)
@@ -63,10 +63,13 @@ namespace Ext
 		body0WorldOffset = cB2w.p-bA2w.p;
 		Ext::joint::ConstraintHelper ch(constraints, cB2w.p - bA2w.p, cB2w.p - bB2w.p);
 
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p), 7, PxU32(limitIsLocked ? 7 : 6));
-
 		if(limitIsLocked)
+		{
+			ch.prepareLockedAxes<7, 7>(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p));
 			return ch.getCount();
+		}
+
+		ch.prepareLockedAxes<7, 6>(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p));
 
 		PxVec3 axis = cA2w.rotate(PxVec3(1.f,0,0));
 
@@ -35,6 +35,7 @@
 #include "ExtInertiaTensor.h"
 #include "PsAllocator.h"
 #include "PsFoundation.h"
+#include "PsHashMap.h"
 
 #include "PxShape.h"
 #include "PxScene.h"
@@ -59,6 +60,42 @@
 using namespace physx;
 using namespace Cm;
 
+namespace
+{
+	// Mass properties of a convex mesh at unit density and identity scale, as returned by PxConvexMesh::getMassInformation()
+	struct ConvexMassInfo
+	{
+		PxMat33	inertia;
+		PxVec3	com;
+		PxReal	mass;
+	};
+
+	// Shared by the shapes of a batch of bodies, so that the pieces made from the same hulls look them up once
+	typedef Ps::HashMap<const PxConvexMesh*, ConvexMassInfo> ConvexMassCache;
+}
+
+static PX_FORCE_INLINE void getConvexMassInformation(const PxConvexMesh& convMesh, PxReal& convMass, PxMat33& convInertia, PxVec3& convCoM, ConvexMassCache* cache)
+{
+	if(!cache)
+	{
+		convMesh.getMassInformation(convMass, convInertia, convCoM);
+		return;
+	}
+
+	const ConvexMassCache::Entry* entry = cache->find(&convMesh);
+	if(!entry)
+	{
+		ConvexMassInfo info;
+		convMesh.getMassInformation(info.mass, info.inertia, info.com);
+		cache->insert(&convMesh, info);
+		entry = cache->find(&convMesh);
+	}
+
+	convMass = entry->second.mass;
+	convInertia = entry->second.inertia;
+	convCoM = entry->second.com;
+}
+
 static bool computeMassAndDiagInertia(Ext::InertiaTensorComputer& inertiaComp, 
 		PxVec3& diagTensor, PxQuat& orient, PxReal& massOut, PxVec3& coM, bool lockCOM, const PxRigidBody& body, const char* errorStr)
 {
@@ -103,7 +140,7 @@ static bool computeMassAndDiagInertia(Ext::InertiaTensorComputer& inertiaComp,
 	}
 }
 
-static bool computeMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body, const PxReal* densities, const PxReal* masses, PxU32 densityOrMassCount, bool includeNonSimShapes, Ext::InertiaTensorComputer& computer)
+static bool computeMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body, const PxReal* densities, const PxReal* masses, PxU32 densityOrMassCount, bool includeNonSimShapes, Ext::InertiaTensorComputer& computer, ConvexMassCache* convexCache = NULL)
 {
 	PX_ASSERT(!densities || !masses);
 	PX_ASSERT((densities || masses) && (densityOrMassCount > 0));
@@ -211,7 +248,7 @@ static bool computeMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body,
 				PxReal convMass;
 				PxMat33 convInertia;
 				PxVec3 convCoM;
-				convMesh.getMassInformation(convMass, reinterpret_cast<PxMat33&>(convInertia), convCoM);
+				getConvexMassInformation(convMesh, convMass, convInertia, convCoM, convexCache);
 
 				if (!g.scale.isIdentity())
 				{
@@ -257,7 +294,7 @@ static bool computeMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body,
 	return true;
 }
 
-static bool updateMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body, const PxReal* densities, PxU32 densityCount, const PxVec3* massLocalPose, bool includeNonSimShapes)
+static bool updateMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body, const PxReal* densities, PxU32 densityCount, const PxVec3* massLocalPose, bool includeNonSimShapes, ConvexMassCache* convexCache = NULL)
 {
 	bool success;
 
@@ -272,7 +309,7 @@ static bool updateMassAndInertia(bool multipleMassOrDensity, PxRigidBody& body,
 	if (densities && densityCount)
 	{
 		Ext::InertiaTensorComputer inertiaComp(true);
-		if(computeMassAndInertia(multipleMassOrDensity, body, densities, NULL, densityCount, includeNonSimShapes, inertiaComp))
+		if(computeMassAndInertia(multipleMassOrDensity, body, densities, NULL, densityCount, includeNonSimShapes, inertiaComp, convexCache))
 		{
 			if(inertiaComp.getMass()!=0 && computeMassAndDiagInertia(inertiaComp, diagTensor, orient, massOut, com, lockCom, body, errorStr))
 				success = true;
@@ -316,6 +353,19 @@ bool PxRigidBodyExt::updateMassAndInertia(PxRigidBody& body, PxReal density, con
 	return ::updateMassAndInertia(false, body, &density, 1, massLocalPose, includeNonSimShapes);
 }
 
+PxU32 PxRigidBodyExt::updateMassAndInertia(PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* densities, const PxVec3* massLocalPoses, bool includeNonSimShapes)
+{
+	ConvexMassCache convexCache;
+
+	PxU32 nbUpdated = 0;
+	for(PxU32 i=0; i < nbBodies; i++)
+	{
+		if(::updateMassAndInertia(false, *bodies[i], densities + i, 1, massLocalPoses ? massLocalPoses + i : NULL, includeNonSimShapes, &convexCache))
+			nbUpdated++;
+	}
+	return nbUpdated;
+}
+
 static bool setMassAndUpdateInertia(bool multipleMassOrDensity, PxRigidBody& body, const PxReal* masses, PxU32 massCount, const PxVec3* massLocalPose, bool includeNonSimShapes)
 {
 	bool success;
@@ -43,11 +43,12 @@ namespace Ext
 	class SharedQueueEntry : public Ps::SListEntry
 	{
 	public:
-		SharedQueueEntry(void* objectRef) : mObjectRef(objectRef), mPooledEntry(false) {}
-		SharedQueueEntry() : mObjectRef(NULL), mPooledEntry(true) {}
+		SharedQueueEntry(void* objectRef) : mObjectRef(objectRef), mSubmitTime(0), mPooledEntry(false) {}
+		SharedQueueEntry() : mObjectRef(NULL), mSubmitTime(0), mPooledEntry(true) {}
 
 	public:
 		void* mObjectRef;
+		PxU64 mSubmitTime; // Set by dispatchers with telemetry enabled, 0 otherwise
 		bool mPooledEntry; // True if the entry was preallocated in a pool
 	};
 
@@ -119,6 +120,7 @@ Ext::SharedQueueEntry* Ext::SharedQueueEntryPool<Alloc>::getEntry(void* objectRe
 	{
 		PX_ASSERT(e->mPooledEntry == true);
 		e->mObjectRef = objectRef;
+		e->mSubmitTime = 0;
 		return e;
 	}
 	else
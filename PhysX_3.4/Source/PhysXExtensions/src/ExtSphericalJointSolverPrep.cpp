@@ -75,7 +75,7 @@ namespace Ext
 				ch.angularLimit(cA2w.rotate(axis),error,data.limit);
 		}
 
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p), 7, 0);
+		ch.prepareLockedAxes<7, 0>(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p));
 
 		return ch.getCount();
 	}
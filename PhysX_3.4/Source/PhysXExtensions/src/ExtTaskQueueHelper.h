@@ -34,6 +34,7 @@
 #include "task/PxTask.h"
 #include "CmPhysXCommon.h"
 #include "ExtSharedQueueEntryPool.h"
+#include "PsAtomic.h"
 
 namespace physx
 {
@@ -45,18 +46,46 @@ namespace Ext
 	class TaskQueueHelper
 	{
 	public:
-		static PxBaseTask* fetchTask(Ps::SList& taskQueue, Ext::SharedQueueEntryPool<>& entryPool)
+		// submitTime, if given, receives the time stamp of the entry (0 if it wasn't stamped)
+		static PxBaseTask* fetchTask(Ps::SList& taskQueue, Ext::SharedQueueEntryPool<>& entryPool, PxU64* submitTime = NULL)
 		{
 			SharedQueueEntry* entry = static_cast<SharedQueueEntry*>(taskQueue.pop());
 			if (entry)
 			{
 				PxBaseTask* task = reinterpret_cast<PxBaseTask*>(entry->mObjectRef);
+				if (submitTime)
+					*submitTime = entry->mSubmitTime;
 				entryPool.putEntry(*entry);
 				return task;
 			}
 			else
 				return NULL;
 		}
+
+		// Queues with a task count, for the priority lists that are empty most of the time.
+		// Checking the count avoids the pop, which takes a lock on some platforms, on every fetch.
+		static bool submitCountedTask(Ps::SList& taskQueue, volatile PxI32& count, PxBaseTask& task, Ext::SharedQueueEntryPool<>& entryPool, PxU64 submitTime = 0)
+		{
+			SharedQueueEntry* entry = entryPool.getEntry(&task);
+			if (!entry)
+				return false;
+
+			entry->mSubmitTime = submitTime;
+			taskQueue.push(*entry);
+			Ps::atomicIncrement(&count);
+			return true;
+		}
+
+		static PxBaseTask* fetchCountedTask(Ps::SList& taskQueue, volatile PxI32& count, Ext::SharedQueueEntryPool<>& entryPool, PxU64* submitTime = NULL)
+		{
+			if (!count)
+				return NULL;
+
+			PxBaseTask* task = fetchTask(taskQueue, entryPool, submitTime);
+			if (task)
+				Ps::atomicDecrement(&count);
+			return task;
+		}
 	};
 
 } // namespace Ext
@@ -0,0 +1,263 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "ExtTraceProfiler.h"
+#include "PsAtomic.h"
+#include "PsBitUtils.h"
+#include "PsIntrinsics.h"
+#include "PsString.h"
+#include "PsThread.h"
+#include "PsTime.h"
+#include "foundation/PxIO.h"
+#include "foundation/PxMath.h"
+#include "foundation/PxMemory.h"
+
+using namespace physx;
+
+PxTraceProfiler* physx::PxTraceProfilerCreate(const PxTraceProfilerDesc& desc)
+{
+	PX_CHECK_AND_RETURN_NULL(desc.isValid(), "PxTraceProfilerCreate: invalid descriptor");
+	return PX_NEW(Ext::TraceProfiler)(desc);
+}
+
+namespace
+{
+	// Buffers the JSON text, the stream gets a write per few kilobytes
+	class JsonWriter
+	{
+	public:
+		JsonWriter(PxOutputStream& stream) : mStream(stream), mSize(0), mFailed(false) {}
+		~JsonWriter()	{ flush(); }
+
+		void flush()
+		{
+			if(mSize && mStream.write(mBuffer, mSize) != mSize)
+				mFailed = true;
+			mSize = 0;
+		}
+
+		void write(const char* text)
+		{
+			while(*text)
+				put(*text++);
+		}
+
+		// Zone names are identifiers in the SDK, escaping only keeps a user name from breaking the document
+		void writeString(const char* text)
+		{
+			put('"');
+			for(; text && *text; text++)
+			{
+				if(*text == '"' || *text == '\\')
+					put('\\');
+				put(PxU8(*text) < 0x20 ? ' ' : *text);
+			}
+			put('"');
+		}
+
+		bool failed() const	{ return mFailed; }
+
+	private:
+		PX_FORCE_INLINE void put(char c)
+		{
+			if(mSize == sizeof(mBuffer))
+				flush();
+			mBuffer[mSize++] = c;
+		}
+
+		PX_NOCOPY(JsonWriter)
+
+		PxOutputStream&	mStream;
+		char			mBuffer[4096];
+		PxU32			mSize;
+		bool			mFailed;
+	};
+}
+
+Ext::TraceProfiler::TraceProfiler(const PxTraceProfilerDesc& desc) :
+	mMask			(Ps::nextPowerOfTwo(desc.eventsPerThread - 1) - 1),
+	mMaxNbThreads	(desc.maxNbThreads),
+	mTlsIndex		(Ps::TlsAlloc()),
+	mNbThreads		(0),
+	mNbDroppedEvents(0),
+	mEnabled		(true),
+	mStartTime		(Ps::Time::getCurrentCounterValue())
+{
+	// The extra buffer has no events, it is shared by the threads above the limit
+	const PxU32 size = sizeof(TraceThreadBuffer) * (mMaxNbThreads + 1);
+	mBuffers = reinterpret_cast<TraceThreadBuffer*>(PX_ALLOC(size, "TraceThreadBuffer"));
+	PxMemZero(mBuffers, size);
+}
+
+Ext::TraceProfiler::~TraceProfiler()
+{
+	const PxU32 nbThreads = PxMin(PxU32(mNbThreads), mMaxNbThreads);
+	for(PxU32 i = 0; i < nbThreads; i++)
+	{
+		if(mBuffers[i].events)
+			PX_FREE(mBuffers[i].events);
+	}
+	PX_FREE(mBuffers);
+	Ps::TlsFree(mTlsIndex);
+}
+
+void Ext::TraceProfiler::release()
+{
+	PX_DELETE(this);
+}
+
+Ext::TraceThreadBuffer* Ext::TraceProfiler::registerThread()
+{
+	const PxU32 index = PxU32(Ps::atomicIncrement(&mNbThreads) - 1);
+	TraceThreadBuffer* buffer = &mBuffers[PxMin(index, mMaxNbThreads)];
+	if(index < mMaxNbThreads)
+	{
+		buffer->threadId = PxU64(Ps::Thread::getId());
+		TraceEvent* events = reinterpret_cast<TraceEvent*>(PX_ALLOC(sizeof(TraceEvent) * (mMask + 1), "TraceEvent"));
+		// The exporter skips the buffer until the events are set
+		Ps::memoryBarrier();
+		buffer->events = events;
+	}
+	Ps::TlsSet(mTlsIndex, buffer);
+	return buffer;
+}
+
+PX_FORCE_INLINE void Ext::TraceProfiler::record(const char* name, PxU64 contextId, PxU32 type)
+{
+	TraceThreadBuffer* buffer = reinterpret_cast<TraceThreadBuffer*>(Ps::TlsGet(mTlsIndex));
+	if(!buffer)
+		buffer = registerThread();
+
+	if(!buffer->events)
+	{
+		Ps::atomicIncrement(&mNbDroppedEvents);
+		return;
+	}
+
+	const PxU32 writeCount = buffer->writeCount;
+	TraceEvent& event = buffer->events[writeCount & mMask];
+	event.name = name;
+	event.time = Ps::Time::getCurrentCounterValue();
+	event.contextId = contextId;
+	event.type = type;
+	Ps::memoryBarrier();
+	buffer->writeCount = writeCount + 1;
+}
+
+void* Ext::TraceProfiler::zoneStart(const char* eventName, bool detached, uint64_t contextId)
+{
+	if(!mEnabled)
+		return NULL;
+
+	record(eventName, contextId, detached ? TraceEvent::eBEGIN_DETACHED : TraceEvent::eBEGIN);
+	return this;
+}
+
+void Ext::TraceProfiler::zoneEnd(void* profilerData, const char* eventName, bool detached, uint64_t contextId)
+{
+	// Cross thread zones don't get the profiler data back, they only end while enabled
+	if(detached ? !mEnabled : !profilerData)
+		return;
+
+	record(eventName, contextId, detached ? TraceEvent::eEND_DETACHED : TraceEvent::eEND);
+}
+
+void Ext::TraceProfiler::clear()
+{
+	const PxU32 nbThreads = PxMin(PxU32(mNbThreads), mMaxNbThreads);
+	for(PxU32 i = 0; i < nbThreads; i++)
+		mBuffers[i].readStart = mBuffers[i].writeCount;
+}
+
+bool Ext::TraceProfiler::exportChromeTrace(PxOutputStream& stream) const
+{
+	const PxU32 capacity = mMask + 1;
+	TraceEvent* events = reinterpret_cast<TraceEvent*>(PX_ALLOC_TEMP(sizeof(TraceEvent) * capacity, "TraceEvent"));
+	const Ps::CounterFrequencyToTensOfNanos& frequency = Ps::Time::getBootCounterFrequency();
+
+	JsonWriter writer(stream);
+	writer.write("{\"traceEvents\":[");
+	bool first = true;
+
+	const PxU32 nbThreads = PxMin(PxU32(mNbThreads), mMaxNbThreads);
+	for(PxU32 i = 0; i < nbThreads; i++)
+	{
+		const TraceThreadBuffer& buffer = mBuffers[i];
+		if(!buffer.events)
+			continue;
+		Ps::memoryBarrier();
+
+		// Copy first, the thread can keep writing while we do
+		const PxU32 end = buffer.writeCount;
+		Ps::memoryBarrier();
+		PxU32 start = (end - buffer.readStart) > capacity ? end - capacity : buffer.readStart;
+		for(PxU32 j = start; j != end; j++)
+			events[j - start] = buffer.events[j & mMask];
+
+		// Then skip what was overwritten during the copy
+		Ps::memoryBarrier();
+		const PxU32 newEnd = buffer.writeCount;
+		const PxU32 offset = (newEnd - start) >= capacity ? (newEnd - start) - capacity + 1 : 0;
+		if(offset >= end - start)
+			continue;
+
+		for(PxU32 j = offset; j < end - start; j++)
+		{
+			const TraceEvent& event = events[j];
+			const PxU64 time = frequency.toTensOfNanos(event.time - mStartTime);
+
+			writer.write(first ? "\n{\"name\":" : ",\n{\"name\":");
+			first = false;
+			writer.writeString(event.name);
+			switch(event.type)
+			{
+			case TraceEvent::eBEGIN:			writer.write(",\"ph\":\"B\"");	break;
+			case TraceEvent::eEND:				writer.write(",\"ph\":\"E\"");	break;
+			case TraceEvent::eBEGIN_DETACHED:	writer.write(",\"cat\":\"PhysX\",\"ph\":\"b\"");	break;
+			default:							writer.write(",\"cat\":\"PhysX\",\"ph\":\"e\"");	break;
+			}
+			char text[128];
+			// Cross thread zones are matched by name and id
+			if(event.type == TraceEvent::eBEGIN_DETACHED || event.type == TraceEvent::eEND_DETACHED)
+			{
+				Ps::snprintf(text, sizeof(text), ",\"id\":\"0x%llx\"", static_cast<unsigned long long>(event.contextId));
+				writer.write(text);
+			}
+			Ps::snprintf(text, sizeof(text), ",\"pid\":1,\"tid\":%llu,\"ts\":%llu.%02u}",
+				static_cast<unsigned long long>(buffer.threadId), static_cast<unsigned long long>(time / 100), PxU32(time % 100));
+			writer.write(text);
+		}
+	}
+
+	writer.write("\n]}\n");
+	writer.flush();
+	PX_FREE(events);
+	return !writer.failed();
+}
@@ -0,0 +1,108 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_TRACE_PROFILER_IMPL_H
+#define PX_PHYSICS_EXTENSIONS_TRACE_PROFILER_IMPL_H
+
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PxTraceProfiler.h"
+
+namespace physx
+{
+namespace Ext
+{
+	struct TraceEvent
+	{
+		enum Type
+		{
+			eBEGIN,
+			eEND,
+			eBEGIN_DETACHED,
+			eEND_DETACHED
+		};
+
+		const char*	name;
+		PxU64		time;		// Ps::Time counter value
+		PxU64		contextId;
+		PxU32		type;
+		PxU32		pad;
+	};
+
+	// Events of a single thread. Only the owning thread writes, it publishes the events through mWriteCount,
+	// which grows forever and is only compared through differences so it is allowed to wrap around.
+	struct TraceThreadBuffer
+	{
+		TraceEvent*			events;
+		PxU64				threadId;
+		volatile PxU32		writeCount;
+		PxU32				readStart;	// events before it were discarded by clear()
+	};
+
+	class TraceProfiler : public PxTraceProfiler, public Ps::UserAllocated
+	{
+	public:
+									TraceProfiler(const PxTraceProfilerDesc& desc);
+
+		// PxProfilerCallback
+		virtual		void*			zoneStart(const char* eventName, bool detached, uint64_t contextId);
+		virtual		void			zoneEnd(void* profilerData, const char* eventName, bool detached, uint64_t contextId);
+		//~PxProfilerCallback
+
+		// PxTraceProfiler
+		virtual		void			release();
+		virtual		void			setEnabled(bool enabled)	{ mEnabled = enabled;	}
+		virtual		bool			isEnabled()	const			{ return mEnabled;		}
+		virtual		void			clear();
+		virtual		bool			exportChromeTrace(PxOutputStream& stream) const;
+		virtual		PxU64			getNbDroppedEvents() const	{ return PxU64(PxU32(mNbDroppedEvents));	}
+		//~PxTraceProfiler
+
+	protected:
+		virtual						~TraceProfiler();
+
+	private:
+		PX_FORCE_INLINE	void		record(const char* name, PxU64 contextId, PxU32 type);
+					TraceThreadBuffer*	registerThread();
+
+		TraceThreadBuffer*			mBuffers;
+		PxU32						mMask;			// eventsPerThread - 1
+		PxU32						mMaxNbThreads;
+		PxU32						mTlsIndex;
+		volatile PxI32				mNbThreads;		// registration count, can go above mMaxNbThreads
+		volatile PxI32				mNbDroppedEvents;
+		volatile bool				mEnabled;
+		PxU64						mStartTime;
+	};
+
+} // namespace Ext
+}
+
+#endif
@@ -0,0 +1,321 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "ExtWorkStealingCpuDispatcher.h"
+#include "ExtDefaultCpuDispatcher.h"
+#include "ExtTaskQueueHelper.h"
+#include "PsAtomic.h"
+#include "PsIntrinsics.h"
+#include "PsString.h"
+
+using namespace physx;
+
+namespace physx
+{
+	PxDefaultCpuDispatcher* PxWorkStealingCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks);
+}
+
+PxDefaultCpuDispatcher* physx::PxWorkStealingCpuDispatcherCreate(PxU32 numThreads, PxU32* affinityMasks)
+{
+	return PX_NEW(Ext::WorkStealingCpuDispatcher)(numThreads, affinityMasks);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Distance between two deque indices, valid across wrap around
+static PX_FORCE_INLINE PxI32 indexDistance(PxI32 from, PxI32 to)
+{
+	return PxI32(PxU32(to) - PxU32(from));
+}
+
+static PX_FORCE_INLINE PxI32 indexNext(PxI32 index)
+{
+	return PxI32(PxU32(index) + 1);
+}
+
+bool Ext::WorkStealingDeque::push(PxBaseTask& task)
+{
+	const PxI32 b = mBottom;
+	const PxI32 t = mTop;
+	if(indexDistance(t, b) >= CAPACITY)
+		return false;
+
+	mTasks[b & (CAPACITY - 1)] = &task;
+
+	// The task must be visible before the thieves can see the new bottom
+	Ps::memoryBarrier();
+	mBottom = indexNext(b);
+	return true;
+}
+
+PxBaseTask* Ext::WorkStealingDeque::pop()
+{
+	const PxI32 b = PxI32(PxU32(mBottom) - 1);
+	mBottom = b;
+
+	// The bottom must be published before reading the top, or a thief and the owner could both take the last task
+	Ps::memoryBarrier();
+	const PxI32 t = mTop;
+
+	const PxI32 remaining = indexDistance(t, b);
+	if(remaining < 0)
+	{
+		// Empty
+		mBottom = t;
+		return NULL;
+	}
+
+	PxBaseTask* task = mTasks[b & (CAPACITY - 1)];
+	if(remaining > 0)
+		return task;
+
+	// Last task, race the thieves for it
+	if(Ps::atomicCompareExchange(&mTop, indexNext(t), t) != t)
+		task = NULL;
+	mBottom = indexNext(t);
+	return task;
+}
+
+PxBaseTask* Ext::WorkStealingDeque::steal()
+{
+	const PxI32 t = mTop;
+	Ps::memoryBarrier();
+	const PxI32 b = mBottom;
+
+	if(indexDistance(t, b) <= 0)
+		return NULL;
+
+	PxBaseTask* task = mTasks[t & (CAPACITY - 1)];
+	if(Ps::atomicCompareExchange(&mTop, indexNext(t), t) != t)
+		return NULL;
+
+	return task;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Ext::WorkStealingWorkerThread::initialize(WorkStealingCpuDispatcher* ownerDispatcher, PxU32 index)
+{
+	mOwner = ownerDispatcher;
+	mIndex = index;
+	// Any non zero seed works for xorshift
+	mRandomState = 0x9E3779B9u ^ (index * 0x85EBCA6Bu);
+	if(!mRandomState)
+		mRandomState = 1;
+}
+
+void Ext::WorkStealingWorkerThread::execute()
+{
+	Ps::TlsSet(mOwner->mWorkerTlsIndex, this);
+
+	while(!quitIsSignalled())
+	{
+		mOwner->resetWakeSignal();
+
+		PxBaseTask* task = mOwner->fetchNextTask(*this);
+		if(task)
+		{
+			mOwner->runTask(*task);
+			task->release();
+		}
+		else
+		{
+			mOwner->waitForWork();
+		}
+	}
+
+	quit();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Ext::WorkStealingCpuDispatcher::WorkStealingCpuDispatcher(PxU32 numThreads, PxU32* affinityMasks)
+	: mQueueEntryPool(EXT_TASK_QUEUE_ENTRY_POOL_SIZE, "QueueEntryPool"), mNbHighPriorityJobs(0), mNbLowPriorityJobs(0),
+	mNumThreads(numThreads), mShuttingDown(false)
+#if PX_PROFILE
+	,mRunProfiled(true)
+#else
+	,mRunProfiled(false)
+#endif
+{
+	mWorkerTlsIndex = Ps::TlsAlloc();
+
+	PxU32* defaultAffinityMasks = NULL;
+
+	if(!affinityMasks)
+	{
+		defaultAffinityMasks = reinterpret_cast<PxU32*>(PX_ALLOC(numThreads * sizeof(PxU32), "ThreadAffinityMasks"));
+		DefaultCpuDispatcher::getAffinityMasks(defaultAffinityMasks, numThreads);
+		affinityMasks = defaultAffinityMasks;
+	}
+
+	// initialize threads first, then start
+
+	mWorkerThreads = reinterpret_cast<WorkStealingWorkerThread*>(PX_ALLOC(numThreads * sizeof(WorkStealingWorkerThread), "WorkStealingWorkerThread"));
+	const PxU32 nameLength = 32;
+	mThreadNames = reinterpret_cast<PxU8*>(PX_ALLOC(nameLength * numThreads, "CpuWorkerThreadName"));
+
+	if (mWorkerThreads)
+	{
+		for(PxU32 i = 0; i < numThreads; ++i)
+		{
+			PX_PLACEMENT_NEW(mWorkerThreads+i, WorkStealingWorkerThread)();
+			mWorkerThreads[i].initialize(this, i);
+		}
+
+		for(PxU32 i = 0; i < numThreads; ++i)
+		{
+			mWorkerThreads[i].setAffinityMask(affinityMasks[i]);
+			mWorkerThreads[i].start(Ps::Thread::getDefaultStackSize());
+
+			if (mThreadNames)
+			{
+				char* threadName = reinterpret_cast<char*>(mThreadNames + (i*nameLength));
+				Ps::snprintf(threadName, nameLength, "PxWorker%02d", i);
+				mWorkerThreads[i].setName(threadName);
+			}
+		}
+	}
+	else
+	{
+		mNumThreads = 0;
+	}
+
+	if (defaultAffinityMasks)
+		PX_FREE(defaultAffinityMasks);
+}
+
+Ext::WorkStealingCpuDispatcher::~WorkStealingCpuDispatcher()
+{
+	for(PxU32 i = 0; i < mNumThreads; ++i)
+		mWorkerThreads[i].signalQuit();
+
+	mShuttingDown = true;
+	mWorkReady.set();
+	for(PxU32 i = 0; i < mNumThreads; ++i)
+		mWorkerThreads[i].waitForQuit();
+
+	for(PxU32 i = 0; i < mNumThreads; ++i)
+		mWorkerThreads[i].~WorkStealingWorkerThread();
+
+	PX_FREE(mWorkerThreads);
+
+	if (mThreadNames)
+		PX_FREE(mThreadNames);
+
+	Ps::TlsFree(mWorkerTlsIndex);
+}
+
+void Ext::WorkStealingCpuDispatcher::submitTask(PxBaseTask& task)
+{
+	if(!mNumThreads)
+	{
+		// no worker threads, run directly
+		runTask(task);
+		task.release();
+		return;
+	}
+
+	if(task.getPriority() != PxTaskPriority::eNORMAL)
+	{
+		const bool high = task.getPriority() == PxTaskPriority::eHIGH;
+		if(TaskQueueHelper::submitCountedTask(high ? mHighPriorityJobList : mLowPriorityJobList, high ? mNbHighPriorityJobs : mNbLowPriorityJobs, task, mQueueEntryPool))
+			mWorkReady.set();
+		return;
+	}
+
+	// Tasks spawned by a worker go to its own deque, without touching any shared state
+	WorkStealingWorkerThread* worker = reinterpret_cast<WorkStealingWorkerThread*>(Ps::TlsGet(mWorkerTlsIndex));
+	if(worker && worker->getDeque().push(task))
+		return mWorkReady.set();
+
+	SharedQueueEntry* entry = mQueueEntryPool.getEntry(&task);
+	if (entry)
+	{
+		mJobList.push(*entry);
+		mWorkReady.set();
+	}
+}
+
+PxBaseTask* Ext::WorkStealingCpuDispatcher::fetchNextTask(WorkStealingWorkerThread& worker)
+{
+	PxBaseTask* task = TaskQueueHelper::fetchCountedTask(mHighPriorityJobList, mNbHighPriorityJobs, mQueueEntryPool);
+
+	if(!task)
+		task = worker.getDeque().pop();
+
+	if(!task)
+		task = TaskQueueHelper::fetchTask(mJobList, mQueueEntryPool);
+
+	if(!task)
+		task = stealJob(worker);
+
+	if(!task)
+		task = TaskQueueHelper::fetchCountedTask(mLowPriorityJobList, mNbLowPriorityJobs, mQueueEntryPool);
+
+	return task;
+}
+
+PxBaseTask* Ext::WorkStealingCpuDispatcher::stealJob(WorkStealingWorkerThread& thief)
+{
+	if(mNumThreads < 2)
+		return NULL;
+
+	// Start at a random victim so the thieves spread out instead of all hitting the first worker.
+	// A steal can fail because it lost a race while the deque still has tasks, so it goes over the victims twice.
+	const PxU32 start = thief.nextRandom() % mNumThreads;
+	for(PxU32 i = 0; i < 2 * mNumThreads; ++i)
+	{
+		WorkStealingWorkerThread& victim = mWorkerThreads[(start + i) % mNumThreads];
+		if(&victim == &thief)
+			continue;
+
+		PxBaseTask* task = victim.getDeque().steal();
+		if(task)
+			return task;
+	}
+
+	return NULL;
+}
+
+void Ext::WorkStealingCpuDispatcher::release()
+{
+	PX_DELETE(this);
+}
+
+void Ext::WorkStealingCpuDispatcher::resetWakeSignal()
+{
+	mWorkReady.reset();
+
+	// Avoids a deadlock on shut down: if a worker resets the signal after the dispatcher
+	// set it to wake everybody up, the workers that were not waiting yet would wait forever
+	if (mShuttingDown)
+		mWorkReady.set();
+}
@@ -0,0 +1,179 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_NP_WORK_STEALING_CPU_DISPATCHER_H
+#define PX_PHYSICS_EXTENSIONS_NP_WORK_STEALING_CPU_DISPATCHER_H
+
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsSync.h"
+#include "PsSList.h"
+#include "PsThread.h"
+#include "PxDefaultCpuDispatcher.h"
+#include "ExtSharedQueueEntryPool.h"
+#include "foundation/PxProfiler.h"
+#include "task/PxTask.h"
+
+namespace physx
+{
+	
+namespace Ext
+{
+	class WorkStealingCpuDispatcher;
+
+	// Chase-Lev deque of fixed capacity.
+	// The owner pushes and pops at the bottom (LIFO, so freshly spawned child tasks run while their data is hot in cache),
+	// any other thread steals from the top (FIFO, so it takes the oldest and usually biggest chunk of work).
+	// Indices grow forever and are only compared through differences, so they are allowed to wrap around.
+	class WorkStealingDeque
+	{
+	public:
+		static const PxI32		CAPACITY = 1024;	// power of two
+
+								WorkStealingDeque() : mTop(0), mBottom(0) {}
+
+		// Owner only. Returns false if the deque is full.
+						bool	push(PxBaseTask& task);
+		// Owner only.
+				PxBaseTask*		pop();
+		// Any thread. Returns NULL if the deque is empty or the steal lost a race.
+				PxBaseTask*		steal();
+
+	private:
+		volatile PxI32			mTop;
+		PxU8					mPad[64 - sizeof(PxI32)];	// thieves and owner write different ends, keep them on different cache lines
+		volatile PxI32			mBottom;
+		PxBaseTask* volatile	mTasks[CAPACITY];
+	};
+
+#if PX_VC
+#pragma warning(push)
+#pragma warning(disable:4324)	// Padding was added at the end of a structure because of a __declspec(align) value.
+#endif							// Because of the SList member I assume
+
+	class WorkStealingWorkerThread : public Ps::Thread
+	{
+	public:
+								WorkStealingWorkerThread() : mOwner(NULL), mIndex(0), mRandomState(0) {}
+
+				void			initialize(WorkStealingCpuDispatcher* ownerDispatcher, PxU32 index);
+				void			execute();
+
+		PX_FORCE_INLINE	WorkStealingDeque&	getDeque()	{ return mDeque;	}
+
+		// xorshift, only used to pick steal victims
+		PX_FORCE_INLINE	PxU32	nextRandom()
+								{
+									mRandomState ^= mRandomState << 13;
+									mRandomState ^= mRandomState >> 17;
+									mRandomState ^= mRandomState << 5;
+									return mRandomState;
+								}
+
+	protected:
+		WorkStealingDeque				mDeque;
+		WorkStealingCpuDispatcher*		mOwner;
+		PxU32							mIndex;
+		PxU32							mRandomState;
+	};
+
+	class WorkStealingCpuDispatcher : public PxDefaultCpuDispatcher, public Ps::UserAllocated
+	{
+		friend class WorkStealingWorkerThread;
+
+	private:
+												~WorkStealingCpuDispatcher();
+	public:
+												WorkStealingCpuDispatcher(PxU32 numThreads, PxU32* affinityMasks);
+
+		//---------------------------------------------------------------------------------
+		// PxCpuDispatcher implementation
+		//---------------------------------------------------------------------------------
+		virtual			void					submitTask(PxBaseTask& task);
+		virtual			PxU32					getWorkerCount()	const	{ return mNumThreads;	}
+
+		//---------------------------------------------------------------------------------
+		// PxDefaultCpuDispatcher implementation
+		//---------------------------------------------------------------------------------
+		virtual			void					release();
+
+		virtual			void					setRunProfiled(bool runProfiled) { mRunProfiled = runProfiled; }
+
+		virtual			bool					getRunProfiled()	const	{ return mRunProfiled;	}
+
+		//---------------------------------------------------------------------------------
+		// WorkStealingCpuDispatcher
+		//---------------------------------------------------------------------------------
+						PxBaseTask*				fetchNextTask(WorkStealingWorkerThread& worker);
+		PX_FORCE_INLINE	void					runTask(PxBaseTask& task)
+												{
+#if PX_SUPPORT_PXTASK_PROFILING
+													if(mRunProfiled)
+													{
+														PX_PROFILE_ZONE(task.getName(), task.getContextId());
+														task.run();
+													}
+													else
+#endif
+														task.run();
+												}
+
+    					void					waitForWork() { mWorkReady.wait(); }
+						void					resetWakeSignal();
+
+	protected:
+						PxBaseTask*				stealJob(WorkStealingWorkerThread& thief);
+
+						WorkStealingWorkerThread*	mWorkerThreads;
+						// Tasks submitted from threads that are not workers, and the overflow of full deques
+						SharedQueueEntryPool<>	mQueueEntryPool;
+						Ps::SList				mJobList;
+						// Tasks with a non default priority always go through these shared lists
+						Ps::SList				mHighPriorityJobList;
+						Ps::SList				mLowPriorityJobList;
+						volatile PxI32			mNbHighPriorityJobs;
+						volatile PxI32			mNbLowPriorityJobs;
+						Ps::Sync				mWorkReady;
+						PxU8*					mThreadNames;
+						PxU32					mNumThreads;
+						// TLS slot holding the worker of the current thread, NULL for any other thread
+						PxU32					mWorkerTlsIndex;
+						bool					mShuttingDown;
+						bool					mRunProfiled;
+	};
+
+#if PX_VC
+#pragma warning(pop)
+#endif
+
+} // namespace Ext
+}
+
+#endif
@@ -147,159 +147,250 @@ namespace
 	
 }
 
-PxCollection* PxSerialization::createCollectionFromBinary(void* memBlock, PxSerializationRegistry& sr, const PxCollection* pxExternalRefs)
+namespace
 {
-#if PX_CHECKED
-	if(size_t(memBlock) & (PX_SERIAL_FILE_ALIGN-1))
+	// Creates the objects of a binary collection a few at a time, see PxBinaryDeserializer
+	class BinaryDeserializer : public PxBinaryDeserializer, public Ps::UserAllocated
 	{
-		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "Buffer must be 128-bytes aligned.");
-		return NULL;
-	}
+		PX_NOCOPY(BinaryDeserializer)
+	public:
+		BinaryDeserializer(PxSerializationRegistry& sr, const PxCollection* pxExternalRefs)
+		: mRegistry(static_cast<SerializationRegistry&>(sr))
+		, mExternalRefs(static_cast<const Cm::Collection*>(pxExternalRefs))
+		, mContext(NULL)
+		, mCollection(NULL)
+		, mAddress(NULL)
+		, mAddressObjectData(NULL)
+		, mManifestTable(NULL)
+		, mExportReferences(NULL)
+		, mNbExportReferences(0)
+		, mNbObjects(0)
+		, mNbObjectsLeft(0)
+		{
+		}
+
+		virtual ~BinaryDeserializer()
+		{
+			if(mCollection)
+				mCollection->release();
+			PX_DELETE(mContext);
+		}
+
+		bool	init(void* memBlock);
+
+		virtual	bool			deserializeObjects(PxU32 maxObjects);
+		virtual	PxU32			getNbObjectsLeft() const	{ return mNbObjectsLeft;	}
+		virtual	PxCollection*	getCollection();
+		virtual	void			release()					{ PX_DELETE(this);			}
+
+	private:
+				SerializationRegistry&	mRegistry;
+		const	Cm::Collection*			mExternalRefs;
+				InternalRefMap			mInternalReferencesMap;
+				DeserializationContext*	mContext;
+				Cm::Collection*			mCollection;
+				PxU8*					mAddress;
+				PxU8*					mAddressObjectData;
+				ManifestEntry*			mManifestTable;
+				ExportReference*		mExportReferences;
+				PxU32					mNbExportReferences;
+				PxU32					mNbObjects;
+				PxU32					mNbObjectsLeft;
+	};
+
+	bool BinaryDeserializer::init(void* memBlock)
+	{
+#if PX_CHECKED
+		if(size_t(memBlock) & (PX_SERIAL_FILE_ALIGN-1))
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, "Buffer must be 128-bytes aligned.");
+			return false;
+		}
 #endif
-	PxU8* address = reinterpret_cast<PxU8*>(memBlock);
-	const Cm::Collection* externalRefs = static_cast<const Cm::Collection*>(pxExternalRefs);
+		PxU8* address = reinterpret_cast<PxU8*>(memBlock);
 			
-	PxU32 version;
-	if (!readHeader(address, version))
-	{
-		return NULL;
-	}
-
-	ManifestEntry* manifestTable;
-	PxU32 nbObjectsInCollection;
-	PxU32 objectDataEndOffset;
+		PxU32 version;
+		if (!readHeader(address, version))
+		{
+			return false;
+		}
 
-	// read number of objects in collection
-	address = alignPtr(address);
-	nbObjectsInCollection = read32(address);
+		PxU32 nbObjectsInCollection;
+		PxU32 objectDataEndOffset;
 
-	// read manifest (PxU32 offset, PxConcreteType type)
-	{
+		// read number of objects in collection
 		address = alignPtr(address);
-		PxU32 nbManifestEntries = read32(address);
-		PX_ASSERT(*reinterpret_cast<PxU32*>(address) == 0); //first offset is always 0
-		manifestTable = (nbManifestEntries > 0) ? reinterpret_cast<ManifestEntry*>(address) : NULL;
-		address += nbManifestEntries*sizeof(ManifestEntry);
-		objectDataEndOffset = read32(address);
-	}
+		nbObjectsInCollection = read32(address);
 
-	ImportReference* importReferences;
-	PxU32 nbImportReferences;
-	// read import references
-	{
-		address = alignPtr(address);
-		nbImportReferences = read32(address);
-		importReferences = (nbImportReferences > 0) ? reinterpret_cast<ImportReference*>(address) : NULL;
-		address += nbImportReferences*sizeof(ImportReference);
-	}
+		// read manifest (PxU32 offset, PxConcreteType type)
+		{
+			address = alignPtr(address);
+			PxU32 nbManifestEntries = read32(address);
+			PX_ASSERT(*reinterpret_cast<PxU32*>(address) == 0); //first offset is always 0
+			mManifestTable = (nbManifestEntries > 0) ? reinterpret_cast<ManifestEntry*>(address) : NULL;
+			address += nbManifestEntries*sizeof(ManifestEntry);
+			objectDataEndOffset = read32(address);
+		}
 
-	if (!checkImportReferences(importReferences, nbImportReferences, externalRefs))
-	{
-		return NULL;
-	}
+		ImportReference* importReferences;
+		PxU32 nbImportReferences;
+		// read import references
+		{
+			address = alignPtr(address);
+			nbImportReferences = read32(address);
+			importReferences = (nbImportReferences > 0) ? reinterpret_cast<ImportReference*>(address) : NULL;
+			address += nbImportReferences*sizeof(ImportReference);
+		}
 
-	ExportReference* exportReferences;
-	PxU32 nbExportReferences;
-	// read export references
-	{
-		address = alignPtr(address);
-		nbExportReferences = read32(address);
-		exportReferences = (nbExportReferences > 0) ? reinterpret_cast<ExportReference*>(address) : NULL;
-		address += nbExportReferences*sizeof(ExportReference);
-	}
+		if (!checkImportReferences(importReferences, nbImportReferences, mExternalRefs))
+		{
+			return false;
+		}
 
-	// read internal references arrays
-	PxU32 nbInternalPtrReferences = 0;
-	PxU32 nbInternalIdxReferences = 0;
-	InternalReferencePtr* internalPtrReferences = NULL;
-	InternalReferenceIdx* internalIdxReferences = NULL;
-	{
-		address = alignPtr(address);
+		// read export references
+		{
+			address = alignPtr(address);
+			mNbExportReferences = read32(address);
+			mExportReferences = (mNbExportReferences > 0) ? reinterpret_cast<ExportReference*>(address) : NULL;
+			address += mNbExportReferences*sizeof(ExportReference);
+		}
 
-		nbInternalPtrReferences = read32(address);
-		internalPtrReferences = (nbInternalPtrReferences > 0) ? reinterpret_cast<InternalReferencePtr*>(address) : NULL;
-		address += nbInternalPtrReferences*sizeof(InternalReferencePtr);
+		// read internal references arrays
+		PxU32 nbInternalPtrReferences = 0;
+		PxU32 nbInternalIdxReferences = 0;
+		InternalReferencePtr* internalPtrReferences = NULL;
+		InternalReferenceIdx* internalIdxReferences = NULL;
+		{
+			address = alignPtr(address);
 
-		nbInternalIdxReferences = read32(address);
-		internalIdxReferences = (nbInternalIdxReferences > 0) ? reinterpret_cast<InternalReferenceIdx*>(address) : NULL;
-		address += nbInternalIdxReferences*sizeof(InternalReferenceIdx);
-	}
+			nbInternalPtrReferences = read32(address);
+			internalPtrReferences = (nbInternalPtrReferences > 0) ? reinterpret_cast<InternalReferencePtr*>(address) : NULL;
+			address += nbInternalPtrReferences*sizeof(InternalReferencePtr);
 
-	// create internal references map
-	PxF32 loadFactor = 0.75f;
-	PxF32 _loadFactor = 1.0f / loadFactor;
-	PxU32 hashSize = PxU32((nbInternalPtrReferences + nbInternalIdxReferences + 1)*_loadFactor);
-	InternalRefMap internalReferencesMap(hashSize, loadFactor);
-	{
-		//create hash (we should load the hashes directly from memory)
-		for (PxU32 i=0;i<nbInternalPtrReferences;i++)
-		{
-			const InternalReferencePtr& ref = internalPtrReferences[i];
-			internalReferencesMap.insertUnique( InternalRefKey(ref.reference, ref.kind), SerialObjectIndex(ref.objIndex));
+			nbInternalIdxReferences = read32(address);
+			internalIdxReferences = (nbInternalIdxReferences > 0) ? reinterpret_cast<InternalReferenceIdx*>(address) : NULL;
+			address += nbInternalIdxReferences*sizeof(InternalReferenceIdx);
 		}
-		for (PxU32 i=0;i<nbInternalIdxReferences;i++)
+
+		// create internal references map
+		PxF32 loadFactor = 0.75f;
+		PxF32 _loadFactor = 1.0f / loadFactor;
+		PxU32 hashSize = PxU32((nbInternalPtrReferences + nbInternalIdxReferences + 1)*_loadFactor);
+		mInternalReferencesMap.reserve(hashSize);
 		{
-			const InternalReferenceIdx& ref = internalIdxReferences[i];
-			internalReferencesMap.insertUnique(InternalRefKey(ref.reference, ref.kind), SerialObjectIndex(ref.objIndex));
+			//create hash (we should load the hashes directly from memory)
+			for (PxU32 i=0;i<nbInternalPtrReferences;i++)
+			{
+				const InternalReferencePtr& ref = internalPtrReferences[i];
+				mInternalReferencesMap.insertUnique( InternalRefKey(ref.reference, ref.kind), SerialObjectIndex(ref.objIndex));
+			}
+			for (PxU32 i=0;i<nbInternalIdxReferences;i++)
+			{
+				const InternalReferenceIdx& ref = internalIdxReferences[i];
+				mInternalReferencesMap.insertUnique(InternalRefKey(ref.reference, ref.kind), SerialObjectIndex(ref.objIndex));
+			}
 		}
-	}
 
-	SerializationRegistry& sn = static_cast<SerializationRegistry&>(sr);
-	Cm::Collection* collection = static_cast<Cm::Collection*>(PxCreateCollection());
-	PX_ASSERT(collection);
-	collection->mObjects.reserve(PxU32(nbObjectsInCollection*_loadFactor) + 1);
-	if(nbExportReferences > 0)
-	    collection->mIds.reserve(PxU32(nbExportReferences*_loadFactor) + 1);
+		mCollection = static_cast<Cm::Collection*>(PxCreateCollection());
+		PX_ASSERT(mCollection);
+		mCollection->mObjects.reserve(PxU32(nbObjectsInCollection*_loadFactor) + 1);
+		if(mNbExportReferences > 0)
+			mCollection->mIds.reserve(PxU32(mNbExportReferences*_loadFactor) + 1);
 
-	PxU8* addressObjectData = alignPtr(address);
-	PxU8* addressExtraData = alignPtr(addressObjectData + objectDataEndOffset);
+		mAddressObjectData = alignPtr(address);
+		PxU8* addressExtraData = alignPtr(mAddressObjectData + objectDataEndOffset);
 
-	DeserializationContext context(manifestTable, importReferences, addressObjectData, internalReferencesMap, externalRefs, addressExtraData, version);
-	
-	// iterate over memory containing PxBase objects, create the instances, resolve the addresses, import the external data, add to collection.
+		mContext = PX_NEW(DeserializationContext)(mManifestTable, importReferences, mAddressObjectData, mInternalReferencesMap, mExternalRefs, addressExtraData, version);
+		mAddress = address;
+		mNbObjects = nbObjectsInCollection;
+		mNbObjectsLeft = nbObjectsInCollection;
+		return true;
+	}
+
+	bool BinaryDeserializer::deserializeObjects(PxU32 maxObjects)
 	{
-		PxU32 nbObjects = nbObjectsInCollection;
+		if(!mCollection)
+			return false;
 
+		// iterate over memory containing PxBase objects, create the instances, resolve the addresses, import the external data, add to collection.
+		// the references are resolved from the manifest, so the objects that are not created yet can be referenced
+		PxU32 nbObjects = PxMin(maxObjects, mNbObjectsLeft);
+		mNbObjectsLeft -= nbObjects;
 		while(nbObjects--)
 		{
-			address = alignPtr(address);
-			context.alignExtraData();
+			mAddress = alignPtr(mAddress);
+			mContext->alignExtraData();
 
 			// read PxBase header with type and get corresponding serializer.
-			PxBase* header = reinterpret_cast<PxBase*>(address);
+			PxBase* header = reinterpret_cast<PxBase*>(mAddress);
 			const PxType classType = header->getConcreteType();
-			const PxSerializer* serializer = sn.getSerializer(classType);
+			const PxSerializer* serializer = mRegistry.getSerializer(classType);
 			PX_ASSERT(serializer);
 
-			PxBase* instance = serializer->createObject(address, context);
+			PxBase* instance = serializer->createObject(mAddress, *mContext);
 			if (!instance)
 			{
 				Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
 					"Cannot create class instance for concrete type %d.", classType);
-				collection->release();
-				return NULL;
+				mCollection->release();
+				mCollection = NULL;
+				mNbObjectsLeft = 0;
+				return false;
 			}
 
-			collection->internalAdd(instance);
+			mCollection->internalAdd(instance);
 		}
-	}
 
-	PX_ASSERT(nbObjectsInCollection == collection->internalGetNbObjects());
-	
-	// update new collection with export references
-	{
-		PX_ASSERT(addressObjectData != NULL);
-		for (PxU32 i=0;i<nbExportReferences;i++)
+		if(mNbObjectsLeft)
+			return true;
+
+		PX_ASSERT(mNbObjects == mCollection->internalGetNbObjects());
+
+		// update new collection with export references
 		{
-			bool isExternal;
-			PxU32 manifestIndex = exportReferences[i].objIndex.getIndex(isExternal);
-			PX_ASSERT(!isExternal);
-			PxBase* obj = reinterpret_cast<PxBase*>(addressObjectData + manifestTable[manifestIndex].offset);
-			collection->mIds.insertUnique(exportReferences[i].id, obj);
-			collection->mObjects[obj] = exportReferences[i].id;
+			PX_ASSERT(mAddressObjectData != NULL);
+			for (PxU32 i=0;i<mNbExportReferences;i++)
+			{
+				bool isExternal;
+				PxU32 manifestIndex = mExportReferences[i].objIndex.getIndex(isExternal);
+				PX_ASSERT(!isExternal);
+				PxBase* obj = reinterpret_cast<PxBase*>(mAddressObjectData + mManifestTable[manifestIndex].offset);
+				mCollection->mIds.insertUnique(mExportReferences[i].id, obj);
+				mCollection->mObjects[obj] = mExportReferences[i].id;
+			}
 		}
+
+		PxAddCollectionToPhysics(*mCollection);
+		return true;
+	}
+
+	PxCollection* BinaryDeserializer::getCollection()
+	{
+		if(mNbObjectsLeft || !mCollection)
+			return NULL;
+
+		PxCollection* collection = mCollection;
+		mCollection = NULL;
+		return collection;
 	}
+}
+
+PxCollection* PxSerialization::createCollectionFromBinary(void* memBlock, PxSerializationRegistry& sr, const PxCollection* pxExternalRefs)
+{
+	BinaryDeserializer deserializer(sr, pxExternalRefs);
+	if(!deserializer.init(memBlock) || !deserializer.deserializeObjects(0xffffffff))
+		return NULL;
 
-	PxAddCollectionToPhysics(*collection);
-	return collection;
+	return deserializer.getCollection();
+}
+
+PxBinaryDeserializer* PxSerialization::createBinaryDeserializer(void* memBlock, PxSerializationRegistry& sr, const PxCollection* externalRefs)
+{
+	BinaryDeserializer* deserializer = PX_NEW(BinaryDeserializer)(sr, externalRefs);
+	if(!deserializer->init(memBlock))
+	{
+		PX_DELETE(deserializer);
+		return NULL;
+	}
+	return deserializer;
 }
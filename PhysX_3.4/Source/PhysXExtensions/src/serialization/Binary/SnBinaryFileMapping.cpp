@@ -0,0 +1,157 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "extensions/PxSerialization.h"
+#include "CmPhysXCommon.h"
+#include "PsFoundation.h"
+#include "PsUserAllocated.h"
+
+#if PX_WINDOWS
+#include "windows/PsWindowsInclude.h"
+#elif PX_UNIX_FAMILY
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace physx;
+
+namespace
+{
+	class BinaryFileMapping : public PxBinaryFileMapping, public shdfnd::UserAllocated
+	{
+	public:
+		BinaryFileMapping(void* data, PxU64 size
+#if PX_WINDOWS
+			, HANDLE mappingHandle
+#endif
+			) : mData(data), mSize(size)
+#if PX_WINDOWS
+			, mMappingHandle(mappingHandle)
+#endif
+		{
+		}
+
+		virtual void* getData() const
+		{
+			return mData;
+		}
+
+		virtual PxU64 getSize() const
+		{
+			return mSize;
+		}
+
+		virtual void release()
+		{
+#if PX_WINDOWS
+			UnmapViewOfFile(mData);
+			CloseHandle(mMappingHandle);
+#elif PX_UNIX_FAMILY
+			munmap(mData, size_t(mSize));
+#endif
+			PX_DELETE(this);
+		}
+
+	private:
+		void*	mData;
+		PxU64	mSize;
+#if PX_WINDOWS
+		HANDLE	mMappingHandle;
+#endif
+	};
+
+	void reportMappingError(const char* path)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxSerialization::createBinaryFileMapping: cannot map file %s.", path);
+	}
+}
+
+// The views are copy-on-write, since the objects are deserialized in place. The pages that are never written
+// stay backed by the file, so they are paged in lazily and shared with the other processes mapping the same file.
+PxBinaryFileMapping* PxSerialization::createBinaryFileMapping(const char* path)
+{
+#if PX_WINDOWS
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		reportMappingError(path);
+		return NULL;
+	}
+
+	LARGE_INTEGER size;
+	HANDLE mapping = NULL;
+	if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	// the mapping keeps the file open
+	CloseHandle(file);
+	if(!mapping)
+	{
+		reportMappingError(path);
+		return NULL;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if(!data)
+	{
+		CloseHandle(mapping);
+		reportMappingError(path);
+		return NULL;
+	}
+
+	return PX_NEW(BinaryFileMapping)(data, PxU64(size.QuadPart), mapping);
+#elif PX_UNIX_FAMILY
+	const int fd = open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		reportMappingError(path);
+		return NULL;
+	}
+
+	struct stat fileStat;
+	void* data = MAP_FAILED;
+	if(fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+		data = mmap(NULL, size_t(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file open
+	close(fd);
+	if(data == MAP_FAILED)
+	{
+		reportMappingError(path);
+		return NULL;
+	}
+
+	return PX_NEW(BinaryFileMapping)(data, PxU64(fileStat.st_size));
+#else
+	PX_UNUSED(path);
+	Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxSerialization::createBinaryFileMapping: file mappings are not supported on this platform.");
+	return NULL;
+#endif
+}
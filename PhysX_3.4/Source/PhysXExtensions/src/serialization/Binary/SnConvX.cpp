@@ -44,6 +44,7 @@
 #include "foundation/PxErrorCallback.h"
 #include "foundation/PxAllocatorCallback.h"
 #include "foundation/PxIO.h"
+#include "foundation/PxMemory.h"
 #include "SnConvX.h"
 #include "serialization/SnSerializationRegistry.h"
 #include <assert.h>
@@ -54,6 +55,17 @@ using namespace physx;
 Sn::ConvX::ConvX() :
     mMetaData_Src		(NULL),
 	mMetaData_Dst		(NULL),
+	mWindowSize			(0),
+	mSrcStream			(NULL),
+	mSrcSize			(0),
+	mSrcRead			(0),
+	mSrcBase			(NULL),
+	mSrcBaseOffset		(0),
+	mPrefixMemory		(NULL),
+	mPrefixCapacity		(0),
+	mWindowMemory		(NULL),
+	mWindowCapacity		(0),
+	mSrcFailed			(false),
 	mOutStream			(NULL),
 	mMustFlip			(false),
 	mOutputSize			(0),
@@ -65,7 +77,7 @@ Sn::ConvX::ConvX() :
 	mNbErrors			(0),
 	mNbWarnings			(0),
 	mReportMode			(PxConverterReportMode::eNORMAL),
-	mPerformConversion	(true)	
+	mPerformConversion	(true)
 {
 	//	memset(mZeros, 0, CONVX_ZERO_BUFFER_SIZE);
 	memset(mZeros, 0x42, CONVX_ZERO_BUFFER_SIZE);
@@ -136,6 +148,15 @@ bool Sn::ConvX::convert(PxInputStream& srcStream, PxU32 srcSize, PxOutputStream&
 			return false;
 		}
 
+		if(mWindowSize && mWindowSize<srcSize)
+		{
+			if(!initOutput(targetStream))
+				return false;
+			conversionStatus = convertStreamed(srcStream, srcSize);
+			closeOutput();
+			return conversionStatus;
+		}
+
 		void* memory = PX_ALLOC_TEMP(srcSize+ALIGN_FILE, "ConvX source file");
 		void* memoryA = reinterpret_cast<void*>((size_t(memory) + ALIGN_FILE)&~(ALIGN_FILE-1));
 
@@ -164,3 +185,218 @@ bool Sn::ConvX::convert(PxInputStream& srcStream, PxU32 srcSize, PxOutputStream&
 	}
 	return conversionStatus;
 }
+
+static PX_FORCE_INLINE char* alignSourceMemory(char* memory)
+{
+	return reinterpret_cast<char*>((size_t(memory) + ALIGN_FILE)&~size_t(ALIGN_FILE-1));
+}
+
+static PX_FORCE_INLINE PxU32 alignSourceSize(PxU32 size)
+{
+	return (size + ALIGN_FILE-1)&~PxU32(ALIGN_FILE-1);
+}
+
+// The source is read in two parts. The header, the reference tables and the object headers are loaded first and stay
+// in memory, since the extra data conversion peeks back at the object headers. The extra data, which holds the bulk of
+// the meshes and heightfields, then goes through a sliding window of mWindowSize bytes.
+// In-memory addresses keep the alignment of the file offsets (modulo ALIGN_FILE) so alignStream works unchanged.
+bool Sn::ConvX::convertStreamed(PxInputStream& srcStream, PxU32 srcSize)
+{
+	mSrcStream = &srcStream;
+	mSrcSize = srcSize;
+	mSrcRead = 0;
+	mSrcBase = NULL;
+	mSrcBaseOffset = 0;
+	mSrcFailed = false;
+
+	bool conversionStatus = false;
+	const PxU32 prefixSize = getResidentPrefixSize();
+	if(prefixSize && loadResidentPrefix(prefixSize))
+	{
+		displayMessage(PxErrorCode::eDEBUG_INFO, "\n\nConverting...\n\n");
+		conversionStatus = convert(mSrcBase, int(srcSize)) && !mSrcFailed;
+	}
+
+	releaseSource();
+	return conversionStatus;
+}
+
+bool Sn::ConvX::loadResidentPrefix(PxU32 size)
+{
+	PX_ASSERT(!mWindowMemory);
+	if(size<=mSrcRead)
+		return true;
+
+	if(size>mPrefixCapacity)
+	{
+		const PxU32 capacity = alignSourceSize(PxMax(size, PxMin(mSrcSize, PxMax(mPrefixCapacity*2, PxU32(4096)))));
+		char* memory = reinterpret_cast<char*>(PX_ALLOC_TEMP(capacity+ALIGN_FILE, "ConvX source prefix"));
+		if(mSrcRead)
+			PxMemCopy(alignSourceMemory(memory), mSrcBase, mSrcRead);
+		if(mPrefixMemory)
+			PX_FREE(mPrefixMemory);
+		mPrefixMemory = memory;
+		mPrefixCapacity = capacity;
+		mSrcBase = alignSourceMemory(memory);
+	}
+
+	const PxU32 nbBytes = size - mSrcRead;
+	const PxU32 nbBytesRead = mSrcStream->read(alignSourceMemory(mPrefixMemory) + mSrcRead, nbBytes);
+	mSrcRead += nbBytesRead;
+	if(nbBytesRead != nbBytes)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+			"PxBinaryConverter: failure on reading source serialized data.\n");
+		return false;
+	}
+	return true;
+}
+
+bool Sn::ConvX::peekResidentPrefix(PxU64 offset, PxU32& value)
+{
+	if(offset + 4 > mSrcSize || !loadResidentPrefix(PxU32(offset + 4)))
+		return false;
+	PxMemCopy(&value, mSrcBase + offset, 4);
+	return true;
+}
+
+// Follows the layout written by serializeCollectionToBinary, see convertReferenceTables
+PxU32 Sn::ConvX::getResidentPrefixSize()
+{
+	const MetaClass* manifestEntry = getMetaClass("Sn::ManifestEntry", META_DATA_SRC);
+	const MetaClass* importReference = getMetaClass("Sn::ImportReference", META_DATA_SRC);
+	const MetaClass* exportReference = getMetaClass("Sn::ExportReference", META_DATA_SRC);
+	const MetaClass* internalReferencePtr = getMetaClass("Sn::InternalReferencePtr", META_DATA_SRC);
+	const MetaClass* internalReferenceIdx = getMetaClass("Sn::InternalReferenceIdx", META_DATA_SRC);
+	if(!manifestEntry || !importReference || !exportReference || !internalReferencePtr || !internalReferenceIdx)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, 
+			"PxBinaryConverter: source meta data misses the reference table classes.\n");
+		return 0;
+	}
+
+	// Header: tag, version, binary version, build number, platform tag, marked padding
+	PxU64 offset = 6*sizeof(PxU32);
+	PxU32 nb, objectDataSize;
+	bool ok = true;
+
+	// Number of objects, then the manifest table followed by the end offset of the object headers
+	offset += getPadding(size_t(offset), ALIGN_DEFAULT) + sizeof(PxU32);
+	offset += getPadding(size_t(offset), ALIGN_DEFAULT);
+	ok = ok && peekResidentPrefix(offset, nb);
+	offset += sizeof(PxU32) + PxU64(nb)*PxU64(manifestEntry->mSize);
+	ok = ok && peekResidentPrefix(offset, objectDataSize);
+	offset += sizeof(PxU32);
+
+	offset += getPadding(size_t(offset), ALIGN_DEFAULT);
+	ok = ok && peekResidentPrefix(offset, nb);
+	offset += sizeof(PxU32) + PxU64(nb)*PxU64(importReference->mSize);
+
+	offset += getPadding(size_t(offset), ALIGN_DEFAULT);
+	ok = ok && peekResidentPrefix(offset, nb);
+	offset += sizeof(PxU32) + PxU64(nb)*PxU64(exportReference->mSize);
+
+	offset += getPadding(size_t(offset), ALIGN_DEFAULT);
+	ok = ok && peekResidentPrefix(offset, nb);
+	offset += sizeof(PxU32) + PxU64(nb)*PxU64(internalReferencePtr->mSize);
+	ok = ok && peekResidentPrefix(offset, nb);
+	offset += sizeof(PxU32) + PxU64(nb)*PxU64(internalReferenceIdx->mSize);
+
+	offset += getPadding(size_t(offset), ALIGN_DEFAULT);
+	offset += objectDataSize;
+
+	if(!ok || offset > mSrcSize)
+	{
+		Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+			"PxBinaryConverter: source serialized data is truncated or corrupted.\n");
+		return 0;
+	}
+	return PxU32(offset);
+}
+
+// Called once the object headers are converted, the extra data is read through the window from there on
+const char* Sn::ConvX::startSourceWindow(const char* address)
+{
+	const PxU32 offset = getSourceOffset(address);
+	const PxU32 windowOffset = PxMin(offset, mSrcRead)&~PxU32(ALIGN_FILE-1);
+	const PxU32 nbKept = mSrcRead - windowOffset;
+
+	mWindowCapacity = alignSourceSize(PxMax(mWindowSize, nbKept + ALIGN_FILE));
+	mWindowMemory = reinterpret_cast<char*>(PX_ALLOC_TEMP(mWindowCapacity+ALIGN_FILE, "ConvX source window"));
+	char* window = alignSourceMemory(mWindowMemory);
+	PxMemCopy(window, mSrcBase + windowOffset, nbKept);
+
+	mSrcBase = window;
+	mSrcBaseOffset = windowOffset;
+	return window + (offset - windowOffset);
+}
+
+const char* Sn::ConvX::slideSourceWindow(const char* address, int size)
+{
+	if(!mWindowMemory)
+	{
+		// Still on the resident part, which should have covered all the object headers
+		if(!mSrcFailed)
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+				"PxBinaryConverter: object headers exceed the size found in the manifest table.\n");
+		mSrcFailed = true;
+		return NULL;
+	}
+
+	const PxU32 offset = getSourceOffset(address);
+	const PxU32 end = offset + PxU32(size);
+
+	// Move the window to the block holding the address, keeping the bytes already read
+	const PxU32 windowOffset = PxMin(offset, mSrcRead)&~PxU32(ALIGN_FILE-1);
+	const PxU32 nbKept = mSrcRead - windowOffset;
+	const char* kept = mSrcBase + (windowOffset - mSrcBaseOffset);
+	char* window = alignSourceMemory(mWindowMemory);
+	if(end - windowOffset > mWindowCapacity)
+	{
+		// A single array larger than the window
+		const PxU32 capacity = alignSourceSize(end - windowOffset);
+		char* memory = reinterpret_cast<char*>(PX_ALLOC_TEMP(capacity+ALIGN_FILE, "ConvX source window"));
+		window = alignSourceMemory(memory);
+		PxMemCopy(window, kept, nbKept);
+		PX_FREE(mWindowMemory);
+		mWindowMemory = memory;
+		mWindowCapacity = capacity;
+	}
+	else if(nbKept)
+	{
+		PxMemMove(window, kept, nbKept);
+	}
+	mSrcBase = window;
+	mSrcBaseOffset = windowOffset;
+
+	const PxU32 nbWanted = PxMin(mWindowCapacity - nbKept, mSrcSize - mSrcRead);
+	if(nbWanted)
+		mSrcRead += mSrcStream->read(window + nbKept, nbWanted);
+
+	if(mSrcRead < end)
+	{
+		// Keep going on zeros so the conversion stops cleanly, the result is reported as failed
+		PxMemZero(window + (mSrcRead - windowOffset), end - mSrcRead);
+		if(!mSrcFailed)
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+				"PxBinaryConverter: failure on reading source serialized data.\n");
+		mSrcFailed = true;
+	}
+	return window + (offset - windowOffset);
+}
+
+void Sn::ConvX::releaseSource()
+{
+	if(mPrefixMemory)
+		PX_FREE(mPrefixMemory);
+	if(mWindowMemory)
+		PX_FREE(mWindowMemory);
+	mPrefixMemory = NULL;
+	mPrefixCapacity = 0;
+	mWindowMemory = NULL;
+	mWindowCapacity = 0;
+	mSrcStream = NULL;
+	mSrcBase = NULL;
+	mSrcBaseOffset = 0;
+	mSrcRead = 0;
+}
@@ -34,6 +34,7 @@
 #include "CmPhysXCommon.h"
 #include "PsUserAllocated.h"
 #include "PsArray.h"
+#include "PsHashMap.h"
 #include "SnConvX_Common.h"
 #include "SnConvX_Union.h"
 #include "SnConvX_MetaData.h"
@@ -57,14 +58,10 @@ namespace Sn {
 		bool	checkRefIsNotUsed(PxU32 ref)	const;
 		void	setObjectRef(PxU64 object64, PxU32 ref);
 		bool	getObjectRef(PxU64 object64, PxU32& ref)	const;
+		void	clear();
 
-		struct InternalData
-		{
-			PxU64	object;
-			PxU32	id;
-		};
-
-		Ps::Array<InternalData>	mData;
+		// Every pointer of the collection goes through here, a linear search made the conversion quadratic
+		Ps::CoalescedHashMap<PxU64, PxU32>	mData;
 	};
 
 	class ConvX : public physx::PxBinaryConverter, public shdfnd::UserAllocated
@@ -81,6 +78,7 @@ namespace Sn {
 		virtual			bool					setMetaData(PxInputStream& srcMetaData, PxInputStream& dstMetaData);
 		virtual			bool					compareMetaData() const;
 		virtual			bool					convert(PxInputStream& srcStream, PxU32 srcSize, PxOutputStream& targetStream);
+		virtual			void					setStreamingWindowSize(PxU32 windowSize)	{ mWindowSize = windowSize;	}
 		
 	private:
 						ConvX&					operator=(const ConvX&);
@@ -118,6 +116,38 @@ namespace Sn {
 						const void*				convertReferenceTables(const void* buffer, int& fileSize, int& nbObjectsInCollection);
 						bool					checkPaddingBytes(const char* buffer, int byteCount);
 
+			// Streamed source
+						bool					convertStreamed(PxInputStream& srcStream, PxU32 srcSize);
+						bool					loadResidentPrefix(PxU32 size);
+						bool					peekResidentPrefix(PxU64 offset, PxU32& value);
+						PxU32					getResidentPrefixSize();
+						const char*				startSourceWindow(const char* address);
+						const char*				slideSourceWindow(const char* address, int size);
+						void					releaseSource();
+		PX_FORCE_INLINE	PxU32					getSourceOffset(const char* address)	const	{ return mSrcBaseOffset + PxU32(address - mSrcBase);	}
+		// Makes sure the next size bytes at address are in memory, returns where they are
+		PX_FORCE_INLINE	const char*				fetchSource(const char* address, int size)
+												{
+													if(!mSrcStream || getSourceOffset(address) + PxU32(size) <= mSrcRead)
+														return address;
+													return slideSourceWindow(address, size);
+												}
+		PX_FORCE_INLINE	bool					isInSource(const char* address, const char* lastAddress)	const
+												{
+													return mSrcStream ? getSourceOffset(address)<=mSrcSize : address<=lastAddress;
+												}
+						PxU32					mWindowSize;
+						PxInputStream*			mSrcStream;		// Only set while converting in streamed mode
+						PxU32					mSrcSize;
+						PxU32					mSrcRead;		// Bytes read from mSrcStream so far
+						const char*				mSrcBase;		// Memory holding the source bytes from mSrcBaseOffset
+						PxU32					mSrcBaseOffset;
+						char*					mPrefixMemory;	// Header, tables and object headers, resident for the whole conversion
+						PxU32					mPrefixCapacity;
+						char*					mWindowMemory;	// Sliding window over the extra data
+						PxU32					mWindowCapacity;
+						bool					mSrcFailed;
+
 			// ---- big convex surgery ----
 						PsArray<bool>			mConvexFlags;
 			// Align
@@ -26,6 +26,7 @@
 // Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
 
 #include "foundation/PxErrorCallback.h"
+#include "foundation/PxMemory.h"
 #include "SnConvX.h"
 #include "serialization/SnSerialUtils.h"
 #include "PsAlloca.h"
@@ -666,14 +667,15 @@ const char* Sn::ConvX::convertExtraData_Array(const char* Address, const char* l
 	{
 		Address = alignStream(Address, ed.entry.mAlignment);
 		//		Address = alignStream(Address, ed.entry.mCount);
-		assert(Address<=lastAddress);
+		assert(isInSource(Address, lastAddress));
 	}
 
 	for(int c=0;c<count;c++)
 	{
+		Address = fetchSource(Address, mc->mSize);
 		convertClass(Address, mc, 0);
 		Address += mc->mSize;
-		assert(Address<=lastAddress);
+		assert(isInSource(Address, lastAddress));
 	}
 	return Address;
 }
@@ -699,7 +701,7 @@ const char* Sn::ConvX::convertExtraData_Ptr(const char* Address, const char* las
 
 	convertPtr(Address, tmpSrc, tmpDst);
 	Address += count * ptrSize_Src;
-	assert(Address<=lastAddress);
+	assert(!lastAddress || Address<=lastAddress);	// No last address in streamed mode
 	return Address;
 }
 
@@ -753,8 +755,10 @@ struct Item : public shdfnd::UserAllocated
 
 bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObjects)
 {
-	const char* lastAddress = reinterpret_cast<const char*>(buffer) + fileSize;
+	// In streamed mode only the object headers are behind buffer, see convertStreamed
+	const char* lastAddress = mSrcStream ? NULL : reinterpret_cast<const char*>(buffer) + fileSize;
 	const char* Address = alignStream(reinterpret_cast<const char*>(buffer));
+	const int baseSize = mSrcStream ? getMetaClass("PxBase", META_DATA_SRC)->mSize : 0;
 
 	const int ptrSize_Src = mSrcPtrSize;
 	const int ptrSize_Dst = mDstPtrSize;
@@ -767,11 +771,17 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 		displayMessage(PxErrorCode::eDEBUG_INFO, "Object conversion: %d%%", int(percents*100.0f));
 
 		Address = alignStream(Address);
-		assert(Address<=lastAddress);
+		assert(isInSource(Address, lastAddress));
+
+		if(!fetchSource(Address, baseSize))
+		{
+			PX_DELETE_ARRAY(objects);
+			return false;
+		}
 
 		PxConcreteType::Enum classType = PxConcreteType::Enum(getConcreteType(Address));
 		MetaClass* metaClass = getMetaClass(classType, META_DATA_SRC);
-		if(!metaClass)
+		if(!metaClass || !fetchSource(Address, metaClass->mSize))
 		{
 			PX_DELETE_ARRAY(objects);
 			return false;
@@ -787,12 +797,16 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 		}
 
 		Address += metaClass->mSize;
-		assert(Address<=lastAddress);
+		assert(isInSource(Address, lastAddress));
 	}
 
 	// Fields / extra data
 	if(1)
 	{
+		if(mSrcStream)
+			Address = startSourceWindow(Address);
+
+
 		// ---- big convex surgery ----
 		unsigned int nbConvexes = 0;
 		// ---- big convex surgery ----
@@ -827,7 +841,7 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 			assert(nbEntries<256);
 
 			Address = alignStream(Address);
-			assert(Address<=lastAddress);
+			assert(isInSource(Address, lastAddress));
 
 			for(int j=0;j<nbEntries;j++)
 			{
@@ -861,13 +875,23 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 						if(ed.entry.mAlignment)
 						{
 							Address = alignStream(Address, ed.entry.mAlignment);
-							assert(Address<=lastAddress);
+							assert(isInSource(Address, lastAddress));
 						}
 
+						Address = fetchSource(Address, extraDataType->mSize);
 						const char* classAddress = Address;
+
+						// The window can move while converting the extra data below, which reads the class back
+						PX_ALLOCA(classCopy, char, mSrcStream ? extraDataType->mSize : 0);
+						if(mSrcStream)
+						{
+							PxMemCopy(classCopy, Address, PxU32(extraDataType->mSize));
+							classAddress = classCopy;
+						}
+
 						convertClass(Address, extraDataType, 0);
 						Address += extraDataType->mSize;
-						assert(Address<=lastAddress);
+						assert(isInSource(Address, lastAddress));
 
 						// Enumerate extra data for this optional class, and convert it too.
 						// This assumes the extra data for the optional class is always appended to the class itself,
@@ -908,7 +932,7 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 									{
 										assert(0);	// Never tested
 										Address = alignStream(Address, ed2.entry.mAlignment);
-										assert(Address<=lastAddress);
+										assert(isInSource(Address, lastAddress));
 									}
 
 									if(ed2.entry.mFlags & PxMetaDataFlag::ePTR)
@@ -922,9 +946,10 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 
 										while(count--)
 										{
+											Address = fetchSource(Address, mc->mSize);
 											convertClass(Address, mc, 0);
 											Address += mc->mSize;
-											assert(Address<=lastAddress);
+											assert(isInSource(Address, lastAddress));
 										}
 									}
 
@@ -935,7 +960,7 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 								if( (ed2.entry.mFlags & PxMetaDataFlag::eALIGNMENT) && ed2.entry.mAlignment)
 								{
 									Address = alignStream(Address, ed2.entry.mAlignment);
-									assert(Address<=lastAddress);
+									assert(isInSource(Address, lastAddress));
 								}
 								else
 								{
@@ -986,11 +1011,12 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 						if(ed.entry.mAlignment)
 						{
 							Address = alignStream(Address, ed.entry.mAlignment);
-							assert(Address<=lastAddress);
+							assert(isInSource(Address, lastAddress));
 						}
 
 						if(ed.entry.mFlags & PxMetaDataFlag::ePTR)
 						{
+							Address = fetchSource(Address, count * ptrSize_Src);
 							Address = convertExtraData_Ptr(Address, lastAddress, ed.entry, count, ptrSize_Src, ptrSize_Dst);
 						}
 						else
@@ -1000,9 +1026,10 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 
 							while(count--)
 							{
+								Address = fetchSource(Address, mc->mSize);
 								convertClass(Address, mc, 0);
 								Address += mc->mSize;
-								assert(Address<=lastAddress);
+								assert(isInSource(Address, lastAddress));
 							}
 						}
 					}
@@ -1016,7 +1043,7 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 						displayMessage(PxErrorCode::eDEBUG_INFO, "---------------------------------------------\n");
 
 						Address = alignStream(Address, ed.entry.mAlignment);
-						assert(Address<=lastAddress);
+						assert(isInSource(Address, lastAddress));
 					}
 				}
 				else if(ed.entry.mFlags & PxMetaDataFlag::eEXTRA_NAME)
@@ -1024,13 +1051,14 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 					if(ed.entry.mAlignment)
 					{
 						Address = alignStream(Address, ed.entry.mAlignment);
-						assert(Address<=lastAddress);
+						assert(isInSource(Address, lastAddress));
 					}
 
 					//get string count
 					MetaClass* mc = getMetaClass("PxU32", META_DATA_SRC);
 					assert(mc);
 					//safe to cast to int here since we're reading a count.
+					Address = fetchSource(Address, mc->mSize);
 					const int count = int(peek(mc->mSize, Address, 0));
 
 					displayMessage(PxErrorCode::eDEBUG_INFO, " convert  %d bytes string\n", count);
@@ -1041,11 +1069,12 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 					mc = getMetaClass(ed.entry.mType, META_DATA_SRC);
 					assert(mc);
 
+					Address = fetchSource(Address, count * mc->mSize);
 					for(int c=0;c<count;c++)
 					{
 						convertClass(Address, mc, 0);
 						Address += mc->mSize;
-						assert(Address<=lastAddress);
+						assert(isInSource(Address, lastAddress));
 					}
 				}
 				else
@@ -1058,7 +1087,7 @@ bool Sn::ConvX::convertCollection(const void* buffer, int fileSize, int nbObject
 		assert(nbConvexes==mConvexFlags.size());
 	}
 
-	assert(Address==lastAddress);
+	assert(mSrcStream ? getSourceOffset(Address)==mSrcSize : Address==lastAddress);
 
 	return true;
 }
@@ -1178,9 +1207,10 @@ PointerRemap::~PointerRemap()
 bool PointerRemap::checkRefIsNotUsed(PxU32 ref) const
 {
 	const PxU32 size = mData.size();
+	const Ps::Pair<const PxU64, PxU32>* entries = mData.getEntries();
 	for(PxU32 i=0;i<size;i++)
 	{
-		if(mData[i].id==ref)
+		if(entries[i].second==ref)
 			return false;
 	}
 	return true;
@@ -1188,33 +1218,21 @@ bool PointerRemap::checkRefIsNotUsed(PxU32 ref) const
 
 void PointerRemap::setObjectRef(PxU64 object64, PxU32 ref)
 {
-	const PxU32 size = mData.size();
-	for(PxU32 i=0;i<size;i++)
-	{
-		if(mData[i].object==object64)
-		{
-			mData[i].id = ref;
-			return;
-		}
-	}
-	InternalData data;
-	data.object	= object64;
-	data.id		= ref;
-	mData.pushBack(data);
+	mData[object64] = ref;
 }
 
 bool PointerRemap::getObjectRef(PxU64 object64, PxU32& ref) const
 {	
-	const PxU32 size = mData.size();
-	for(PxU32 i=0;i<size;i++)
-	{
-		if(mData[i].object==object64)
-		{
-			ref = mData[i].id;
-			return true;
-		}
-	}
-	return false;
+	const Ps::CoalescedHashMap<PxU64, PxU32>::Entry* entry = mData.find(object64);
+	if(!entry)
+		return false;
+	ref = entry->second;
+	return true;
+}
+
+void PointerRemap::clear()
+{
+	mData.clear();
 }
 
 /**
@@ -1395,7 +1413,7 @@ const void* Sn::ConvX::convertReferenceTables(const void* buffer, int& fileSize,
 {	
 	// PT: the map should not be used while creating it, so use one indirection
 	mActiveRemap = NULL;
-	mRemap.mData.clear();
+	mRemap.clear();
 	mPointerRemapCounter = 0;
 
 	PxU32 padding = getPadding(size_t(buffer), ALIGN_DEFAULT);
@@ -38,102 +38,260 @@
 #include "ExtSerialization.h"
 #include "PxSerializer.h"
 #include "CmCollection.h"
+#include "CmBitMap.h"
+#include "PsSync.h"
+#include "PsAtomic.h"
+#include "task/PxTask.h"
+#include "task/PxCpuDispatcher.h"
 
 using namespace physx;
 using namespace Sn;
 
 namespace
 {
-	struct RequiresCallback : public PxProcessPxBaseCallback
-	{
-		RequiresCallback(physx::PxCollection& c) : collection(c) {}
-		void process(PxBase& base)
-		{			
-			  if(!collection.contains(base))
-				  collection.add(base);
-		}
-    
-		PxCollection& collection;
-		PX_NOCOPY(RequiresCallback)	
-	};
-
+	// adds the required objects that are neither in the collection nor in exceptFor. The collection is only read,
+	// new objects are added by the caller once the gathering is done.
 	struct CompleteCallback : public PxProcessPxBaseCallback
 	{
-		CompleteCallback(physx::PxCollection& r, physx::PxCollection& c, const physx::PxCollection* e) :
-		requires(r),  complete(c), external(e)	{}
+		CompleteCallback(const Cm::Collection& c, const PxCollection* e, Ps::Array<PxBase*>& r) :
+		complete(c), external(e), requires(r)	{}
 		void process(PxBase& base)
 		{
 			if(complete.contains(base) || (external && external->contains(base)))
 			   return;
-			if(!requires.contains(base))
-				  requires.add(base);			
+			requires.pushBack(&base);
 		}
 
-		PxCollection& requires;		
-		PxCollection& complete;
+		const Cm::Collection& complete;
 		const PxCollection* external;
+		Ps::Array<PxBase*>& requires;
 		PX_NOCOPY(CompleteCallback)
 	};
 
-	void getRequiresCollection(PxCollection& requires, PxCollection& collection, PxCollection& complete, const PxCollection* external, PxSerializationRegistry& sr, bool followJoints)
+	bool isSyncSet(void* sync)
 	{
-		CompleteCallback callback(requires, complete, external);
-		for (PxU32 i = 0; i < collection.getNbObjects(); ++i)
+		return reinterpret_cast<Ps::Sync*>(sync)->wait(0);
+	}
+
+	// gathers the objects required by a range of the collection. The serializers only read the objects,
+	// so large ranges are split in batches running on the dispatcher, each batch with its own output.
+	class RequiresGatherer
+	{
+	public:
+		RequiresGatherer(const Cm::Collection& collection, const PxCollection* exceptFor, PxSerializationRegistry& sr, bool followJoints, PxCpuDispatcher* dispatcher) :
+		mCollection(collection), mExceptFor(exceptFor), mRegistry(sr), mFollowJoints(followJoints), mDispatcher(dispatcher), mNbBatches(0), mPendingTasks(0)	{}
+
+		void	gather(PxU32 start, PxU32 end);
+		void	gatherRange(PxU32 start, PxU32 end, Ps::Array<PxBase*>& requires, Ps::Array<PxConstraint*>& constraints) const;
+		void	onTaskDone()	{ if(!Ps::atomicDecrement(&mPendingTasks)) mGatherDone.set();	}
+
+		PxU32						getNbBatches()			const	{ return mNbBatches;				}
+		const Ps::Array<PxBase*>&	getBatch(PxU32 i)		const	{ return mTasks[i].getRequires();	}
+
+	private:
+		class GatherTask : public PxLightCpuTask
 		{
-			PxBase& s = collection.getObject(i);			
-			const PxSerializer* serializer = sr.getSerializer(s.getConcreteType());
+			public:
+								GatherTask() : mGatherer(NULL), mStart(0), mEnd(0)	{}
+
+				void			setData(RequiresGatherer* gatherer, PxU32 start, PxU32 end)	{ mGatherer = gatherer; mStart = start; mEnd = end; mRequires.clear();	}
+				const Ps::Array<PxBase*>&	getRequires()	const	{ return mRequires;	}
+
+				virtual void	run()					{ mGatherer->gatherRange(mStart, mEnd, mRequires, mConstraints);	}
+				// submitted straight to the dispatcher, there is no continuation
+				virtual void	release()				{ mGatherer->onTaskDone();		}
+				virtual const char*	getName() const		{ return "PxSerialization.complete";	}
+			private:
+				RequiresGatherer*			mGatherer;
+				PxU32						mStart;
+				PxU32						mEnd;
+				Ps::Array<PxBase*>			mRequires;
+				Ps::Array<PxConstraint*>	mConstraints;
+		};
+
+		static const PxU32			OBJECTS_PER_TASK = 256;
+
+		const Cm::Collection&		mCollection;
+		const PxCollection*			mExceptFor;
+		PxSerializationRegistry&	mRegistry;
+		bool						mFollowJoints;
+		PxCpuDispatcher*			mDispatcher;
+		Ps::Array<GatherTask>		mTasks;
+		PxU32						mNbBatches;
+		Ps::Sync					mGatherDone;
+		volatile PxI32				mPendingTasks;
+
+		PX_NOCOPY(RequiresGatherer)
+	};
+
+	void RequiresGatherer::gather(PxU32 start, PxU32 end)
+	{
+		const PxU32 nbObjects = end - start;
+		mNbBatches = (mDispatcher && mDispatcher->getWorkerCount()) ? (nbObjects + OBJECTS_PER_TASK - 1) / OBJECTS_PER_TASK : 1;
+		if(mTasks.size() < mNbBatches)
+			mTasks.resize(mNbBatches);
+
+		for(PxU32 i=0;i<mNbBatches;i++)
+		{
+			const PxU32 batchStart = start + i * OBJECTS_PER_TASK;
+			mTasks[i].setData(this, batchStart, i + 1 < mNbBatches ? batchStart + OBJECTS_PER_TASK : end);
+		}
+
+		if(mNbBatches > 1)
+		{
+			// the first batch is done by this thread
+			mGatherDone.reset();
+			mPendingTasks = PxI32(mNbBatches - 1);
+			for(PxU32 i=1;i<mNbBatches;i++)
+				mDispatcher->submitTask(mTasks[i]);
+
+			mTasks[0].run();
+
+			if(!mDispatcher->waitUntil(isSyncSet, &mGatherDone))
+				mGatherDone.wait();
+		}
+		else
+			mTasks[0].run();
+	}
+
+	void RequiresGatherer::gatherRange(PxU32 start, PxU32 end, Ps::Array<PxBase*>& requires, Ps::Array<PxConstraint*>& constraints) const
+	{
+		CompleteCallback callback(mCollection, mExceptFor, requires);
+		for (PxU32 i = start; i < end; ++i)
+		{
+			PxBase& s = *mCollection.internalGetObject(i);
+			const PxSerializer* serializer = mRegistry.getSerializer(s.getConcreteType());
 			PX_ASSERT(serializer);
 			serializer->requires(s, callback);
 
-			if(followJoints)
+			if(mFollowJoints)
 			{
 				PxRigidActor* actor = s.is<PxRigidActor>();
 				if(actor)
 				{
-					Ps::Array<PxConstraint*> objects(actor->getNbConstraints());
-					actor->getConstraints(objects.begin(), objects.size());
+					constraints.resize(actor->getNbConstraints());
+					actor->getConstraints(constraints.begin(), constraints.size());
 
-					for(PxU32 j=0;j<objects.size();j++)
+					for(PxU32 j=0;j<constraints.size();j++)
 					{
 						PxU32 typeId;
-						PxJoint* joint = reinterpret_cast<PxJoint*>(objects[j]->getExternalReference(typeId));				
+						PxJoint* joint = reinterpret_cast<PxJoint*>(constraints[j]->getExternalReference(typeId));				
 						if(typeId == PxConstraintExtIDs::eJOINT)
 						{							
-							const PxSerializer* sj = sr.getSerializer(joint->getConcreteType());
+							const PxSerializer* sj = mRegistry.getSerializer(joint->getConcreteType());
 							PX_ASSERT(sj);
 							sj->requires(*joint, callback);
-							if(!requires.contains(*joint))
-								requires.add(*joint);							
+							if(!mCollection.contains(*joint))
+								requires.pushBack(joint);
 						}
 					}
 				}
 			}
 		}	
 	}
+
+	// reports the first object required by the current object that is missing from the collection, and clears the 
+	// subordinate flag of the required objects of the collection
+	struct SerializableCallback : public PxProcessPxBaseCallback
+	{
+		SerializableCallback(const Cm::Collection& c, const PxCollection* e, Cm::BitMap& s) :
+		collection(c), external(e), subordinates(s), current(NULL), failed(false)	{}
+		void process(PxBase& base)
+		{
+			if(failed)
+				return;
+
+			const PxU32 index = collection.internalGetIndex(base);
+			if(index != Cm::Collection::INVALID_INDEX)
+			{
+				subordinates.reset(index);
+				return;
+			}
+
+			if(external)
+			{
+				if(!external->contains(base))
+				{						
+					Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+						"PxSerialization::isSerializable: Object of type %s references a missing object of type %s. "
+						"The missing object needs to be added to either the current collection or the externalReferences collection.",
+						current->getConcreteTypeName(), base.getConcreteTypeName());						
+				}
+				else if(external->getId(base) == PX_SERIAL_OBJECT_ID_INVALID)
+				{						
+					Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+						"PxSerialization::isSerializable: Object of type %s in externalReferences collection requires an id.", 
+						base.getConcreteTypeName());
+				}
+				else
+					return;
+			}
+			else
+			{				
+				Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+					"PxSerialization::isSerializable: Object of type %s references a missing serial object of type %s. "
+					"Please completed the collection or specify an externalReferences collection containing the object.",
+					current->getConcreteTypeName(), base.getConcreteTypeName());					
+			}
+			failed = true;
+		}
+
+		const Cm::Collection& collection;
+		const PxCollection* external;
+		Cm::BitMap& subordinates;
+		PxBase* current;
+		bool failed;
+		PX_NOCOPY(SerializableCallback)
+	};
+
+	// reports the first object of the collection required by an object of externalReferences
+	struct CircularCallback : public PxProcessPxBaseCallback
+	{
+		CircularCallback(const Cm::Collection& c) : collection(c), current(NULL), failed(false) {}
+		void process(PxBase& base)
+		{
+			if(failed || !collection.contains(base))
+				return;
+
+			Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+				"PxSerialization::isSerializable: Object of type %s in externalReferences references an object "
+				"of type %s in collection (circular dependency).",
+				current->getConcreteTypeName(), base.getConcreteTypeName());
+			failed = true;
+		}
+
+		const Cm::Collection& collection;
+		PxBase* current;
+		bool failed;
+		PX_NOCOPY(CircularCallback)
+	};
 }
 
-bool PxSerialization::isSerializable(PxCollection& collection, PxSerializationRegistry& sr, const PxCollection* externalReferences) 
+bool PxSerialization::isSerializable(PxCollection& _collection, PxSerializationRegistry& sr, const PxCollection* externalReferences) 
 {		
-	PxCollection* subordinateCollection = PxCreateCollection();
-	PX_ASSERT(subordinateCollection);
+	const Cm::Collection& collection = static_cast<const Cm::Collection&>(_collection);
+	const PxU32 nbObjects = collection.internalGetNbObjects();
+
+	// subordinate objects of the collection not required by another object yet, by index in the collection
+	Cm::BitMap subordinates;
+	subordinates.resizeAndClear(nbObjects);
 
-	for(PxU32 i = 0; i < collection.getNbObjects(); ++i)
+	for(PxU32 i = 0; i < nbObjects; ++i)
 	{
-		PxBase& s = collection.getObject(i);
+		PxBase& s = *collection.internalGetObject(i);
 		const PxSerializer* serializer = sr.getSerializer(s.getConcreteType());
 		PX_ASSERT(serializer);
 		if(serializer->isSubordinate())
-			subordinateCollection->add(s);
+			subordinates.set(i);
 
 		if(externalReferences)
 		{
-			PxSerialObjectId id = collection.getId(s);
+			PxSerialObjectId id = collection.internalGetObjects()[i].second;
 			if(id != PX_SERIAL_OBJECT_ID_INVALID)
 			{
 				PxBase* object = externalReferences->find(id);
 				if(object && (object != &s))
 				{					
-					subordinateCollection->release();					
 					Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
 						"PxSerialization::isSerializable: Reference id %" PX_PRIu64 " used both in current collection and in externalReferences. "
 						"Please use unique identifiers.", id);	
@@ -143,166 +301,107 @@ bool PxSerialization::isSerializable(PxCollection& collection, PxSerializationRe
 		}		
 	}
 
-	PxCollection* requiresCollection = PxCreateCollection();
-	PX_ASSERT(requiresCollection);
-		
-	RequiresCallback requiresCallback0(*requiresCollection);
+	SerializableCallback requiresCallback(collection, externalReferences, subordinates);
 
-	for (PxU32 i = 0; i < collection.getNbObjects(); ++i)
+	for (PxU32 i = 0; i < nbObjects; ++i)
 	{
-		PxBase& s = collection.getObject(i);
+		PxBase& s = *collection.internalGetObject(i);
 		const PxSerializer* serializer = sr.getSerializer(s.getConcreteType());
 		PX_ASSERT(serializer);
-		serializer->requires(s, requiresCallback0);
-
-		Cm::Collection* cmRequiresCollection = static_cast<Cm::Collection*>(requiresCollection);
-
-		for(PxU32 j = 0; j < cmRequiresCollection->getNbObjects(); ++j)
-		{
-			PxBase& s0 = cmRequiresCollection->getObject(j);
-
-			if(subordinateCollection->contains(s0))
-			{
-				subordinateCollection->remove(s0);
-				continue;
-			}
-
-			bool requiredIsInCollection = collection.contains(s0);
-			if(!requiredIsInCollection)
-			{
-				if(externalReferences)
-				{
-					if(!externalReferences->contains(s0))
-					{						
-						Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
-							"PxSerialization::isSerializable: Object of type %s references a missing object of type %s. "
-							"The missing object needs to be added to either the current collection or the externalReferences collection.",
-							s.getConcreteTypeName(), s0.getConcreteTypeName());						
-					}
-					else if(externalReferences->getId(s0) == PX_SERIAL_OBJECT_ID_INVALID)
-					{						
-						Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
-							"PxSerialization::isSerializable: Object of type %s in externalReferences collection requires an id.", 
-							s0.getConcreteTypeName());
-					}
-					else
-						continue;
-				}
-				else
-				{				
-					Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
-						"PxSerialization::isSerializable: Object of type %s references a missing serial object of type %s. "
-						"Please completed the collection or specify an externalReferences collection containing the object.",
-						s.getConcreteTypeName(), s0.getConcreteTypeName());					
-				}
-				subordinateCollection->release();
-				requiresCollection->release();
-				return false;	
-			}		
-		}
-		cmRequiresCollection->mObjects.clear();
+		requiresCallback.current = &s;
+		serializer->requires(s, requiresCallback);
+		if(requiresCallback.failed)
+			return false;
 	}
-	requiresCollection->release();
-	
-	PxU32 numOrphans = subordinateCollection->getNbObjects();
 	
-	for(PxU32 j = 0; j < numOrphans; ++j)
+	PxU32 numOrphans = 0;
+
+	Cm::BitMap::Iterator it(subordinates);
+	for(PxU32 j = it.getNext(); j != Cm::BitMap::Iterator::DONE; j = it.getNext())
 	{
-		PxBase& subordinate = subordinateCollection->getObject(j);
+		PxBase& subordinate = *collection.internalGetObject(j);
 
 		Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
 			"PxSerialization::isSerializable: An object of type %s is subordinate but not required "
 			"by other objects in the collection (orphan). Please remove the object from the collection or add its owner.", 
 			subordinate.getConcreteTypeName());
+		numOrphans++;
 	}
 	
-	subordinateCollection->release();
-
 	if(numOrphans>0)
 		return false;
 
 	if(externalReferences)
 	{
-		PxCollection* oppositeRequiresCollection = PxCreateCollection();
-		PX_ASSERT(oppositeRequiresCollection);
-
-		RequiresCallback requiresCallback(*oppositeRequiresCollection);
+		CircularCallback circularCallback(collection);
 
 		for (PxU32 i = 0; i < externalReferences->getNbObjects(); ++i)
 		{
 			PxBase& s = externalReferences->getObject(i);			
 			const PxSerializer* serializer = sr.getSerializer(s.getConcreteType());
 			PX_ASSERT(serializer);
-			serializer->requires(s, requiresCallback);
-		
-			Cm::Collection* cmCollection = static_cast<Cm::Collection*>(oppositeRequiresCollection);
-
-			for(PxU32 j = 0; j < cmCollection->getNbObjects(); ++j)
-			{
-				PxBase& s0 = cmCollection->getObject(j);
-
-				if(collection.contains(s0))
-				{
-					oppositeRequiresCollection->release();
-					Ps::getFoundation().error(physx::PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
-						"PxSerialization::isSerializable: Object of type %s in externalReferences references an object "
-						"of type %s in collection (circular dependency).",
-						s.getConcreteTypeName(), s0.getConcreteTypeName());
-					return false;
-				}
-			}
-			cmCollection->mObjects.clear();
+			circularCallback.current = &s;
+			serializer->requires(s, circularCallback);
+			if(circularCallback.failed)
+				return false;
 		}
-		oppositeRequiresCollection->release();
 	}
 
 	return true;
 }
 
-void PxSerialization::complete(PxCollection& collection, PxSerializationRegistry& sr, const PxCollection* exceptFor, bool followJoints)
+void PxSerialization::complete(PxCollection& _collection, PxSerializationRegistry& sr, const PxCollection* exceptFor, bool followJoints, PxCpuDispatcher* dispatcher)
 {	
-	PxCollection* curCollection = PxCreateCollection();
-	PX_ASSERT(curCollection);	
-	curCollection->add(collection);
-
-	PxCollection* requiresCollection = PxCreateCollection();
-	PX_ASSERT(requiresCollection);
-
-	do
-	{		
-		getRequiresCollection(*requiresCollection, *curCollection, collection, exceptFor, sr, followJoints);		
-		
-		collection.add(*requiresCollection);
-		PxCollection* swap = curCollection;	
-		curCollection = requiresCollection;
-		requiresCollection = swap;
-		(static_cast<Cm::Collection*>(requiresCollection))->mObjects.clear();
-
-	}while(curCollection->getNbObjects() > 0);
-
-	requiresCollection->release();
-	curCollection->release();
-	
+	Cm::Collection& collection = static_cast<Cm::Collection&>(_collection);
+
+	// objects are only appended, so the objects added by a pass are the range the next pass gathers from
+	RequiresGatherer gatherer(collection, exceptFor, sr, followJoints, dispatcher);
+	PxU32 start = 0;
+	while(start < collection.internalGetNbObjects())
+	{
+		const PxU32 end = collection.internalGetNbObjects();
+		gatherer.gather(start, end);
+
+		PxU32 nbRequires = 0;
+		for(PxU32 i = 0; i < gatherer.getNbBatches(); ++i)
+			nbRequires += gatherer.getBatch(i).size();
+		collection.reserve(end + nbRequires, 0);
+
+		// batches are merged in order, which gives the same collection as a serial pass
+		for(PxU32 i = 0; i < gatherer.getNbBatches(); ++i)
+		{
+			const Ps::Array<PxBase*>& requires = gatherer.getBatch(i);
+			for(PxU32 j = 0; j < requires.size(); ++j)
+			{
+				if(!collection.contains(*requires[j]))
+					collection.internalAdd(requires[j]);
+			}
+		}
+		start = end;
+	}
 }
 
-void PxSerialization::createSerialObjectIds(PxCollection& collection, const PxSerialObjectId base)
+void PxSerialization::createSerialObjectIds(PxCollection& _collection, const PxSerialObjectId base)
 {
+	Cm::Collection& collection = static_cast<Cm::Collection&>(_collection);
 	PxSerialObjectId localBase = base;
-	PxU32 nbObjects = collection.getNbObjects();
+	PxU32 nbObjects = collection.internalGetNbObjects();
+	collection.reserve(nbObjects, nbObjects);
 
 	for (PxU32 i = 0; i < nbObjects; ++i)
 	{
-		while(collection.find(localBase))
-		{
-			localBase++;
-		}
+		PxBase* s = collection.internalGetObject(i);		
+		if(PX_SERIAL_OBJECT_ID_INVALID != collection.internalGetObjects()[i].second)
+			continue;
 
-		PxBase& s = collection.getObject(i);		
-		if(PX_SERIAL_OBJECT_ID_INVALID == collection.getId(s))
+		while(localBase == PX_SERIAL_OBJECT_ID_INVALID || collection.mIds.find(localBase))
 		{
-			collection.addId(s, localBase);
 			localBase++;
 		}
+
+		collection.mIds.insertUnique(localBase, s);
+		collection.mObjects[s] = localBase;
+		localBase++;
 	}
 }
 
@@ -447,6 +447,8 @@ namespace physx { namespace Sn {
 		XmlMemoryAllocatorImpl&					mAllocator;
 		PxSerializationRegistry&				mSerializationRegistry;
 		PxProfileArray<RepXCollectionItem>		mCollection;
+		// index of the first item of each live object, the lookups were a linear search for every added object
+		PxProfileHashMap<const void*, PxU32>	mItemIndices;
 		TMemoryPoolManager						mSerializationManager;
 		MemoryBuffer							mPropertyBuffer;
 		PxTolerancesScale						mScale;
@@ -460,6 +462,7 @@ namespace physx { namespace Sn {
 			, mAllocator( mSharedData->mAllocator )
 			, mSerializationRegistry( inRegistry )
 			, mCollection( mSharedData->mWrapper )
+			, mItemIndices( mSharedData->mWrapper )
 			, mSerializationManager( inAllocator )
 			, mPropertyBuffer( &mSerializationManager )
 			, mUpVector( 0,0,0 )
@@ -475,6 +478,7 @@ namespace physx { namespace Sn {
 			, mAllocator( mSharedData->mAllocator )
 			, mSerializationRegistry( inRegistry )
 			, mCollection( mSharedData->mWrapper )
+			, mItemIndices( mSharedData->mWrapper )
 			, mSerializationManager( mSharedData->mWrapper.getAllocator() )
 			, mPropertyBuffer( &mSerializationManager )
 			, mScale( inSrc.mScale )
@@ -511,12 +515,19 @@ namespace physx { namespace Sn {
 		PX_INLINE RepXCollectionItem findItemBySceneItem( const PxRepXObject& inObject ) const
 		{
 			//See if the object is in the collection
-			for ( PxU32 idx =0; idx < mCollection.size(); ++idx )
-				if ( mCollection[idx].liveObject.serializable == inObject.serializable )
-					return mCollection[idx];
+			const PxProfileHashMap<const void*, PxU32>::Entry* entry = mItemIndices.find( inObject.serializable );
+			if ( entry )
+				return mCollection[entry->second];
 			return RepXCollectionItem();
 		}
 
+		void pushItem( const RepXCollectionItem& inItem )
+		{
+			if ( inItem.liveObject.serializable && !mItemIndices.find( inItem.liveObject.serializable ) )
+				mItemIndices.insert( inItem.liveObject.serializable, mCollection.size() );
+			mCollection.pushBack( inItem );
+		}
+
 		virtual RepXAddToCollectionResult addRepXObjectToCollection( const PxRepXObject& inObject, PxCollection* inCollection, PxRepXInstantiationArgs& inArgs )
 		{
 			PX_ASSERT( inObject.serializable );
@@ -539,7 +550,7 @@ namespace physx { namespace Sn {
 				writeProperty( theXmlWriter, mPropertyBuffer, "Id", inObject.id  );
 				theSerializer->objectToFile( inObject, inCollection, theRepXWriter, mPropertyBuffer,inArgs );
 			}
-			mCollection.pushBack( RepXCollectionItem( inObject, theXmlWriter.getTopNode() ) );
+			pushItem( RepXCollectionItem( inObject, theXmlWriter.getTopNode() ) );
 			return RepXAddToCollectionResult( RepXAddToCollectionResult::Success, inObject.id );
 		}
 
@@ -650,7 +661,7 @@ namespace physx { namespace Sn {
 					PxSerialObjectId theId = 0;
 					theReader.read( "Id", theId );
 					theObject.id = theId;
-					mCollection.pushBack( RepXCollectionItem( theObject, theChild ) );
+					pushItem( RepXCollectionItem( theObject, theChild ) );
 				}
 			}
 			else
@@ -688,7 +699,7 @@ namespace physx { namespace Sn {
 
 		virtual void addCollectionItem( RepXCollectionItem inItem ) 
 		{
-			mCollection.pushBack( inItem );
+			pushItem( inItem );
 		}
 		
 		virtual PxAllocatorCallback& getAllocator() { return mSharedData->mAllocator.getAllocator(); }
@@ -61,21 +61,13 @@ namespace physx { namespace Sn {
 
 	PX_INLINE PxF32 strToFloat(const char *str,const char **nextScan)
 	{
-		PxF32 ret;
 		while ( *str && isspace(static_cast<unsigned char>(*str))) str++; // skip leading whitespace
-		char temp[256] = "";
-		char *dest = temp;
-		char *end = &temp[255];
-		const char *begin = str;
-		while ( *str && !isspace(static_cast<unsigned char>(*str)) && dest < end ) // copy the number up to the first whitespace or eos
-		{
-			*dest++ = *str++;
-		}
-		*dest = 0;
-		ret = PxF32(strtod(temp,&end));
+		// strtod stops at the whitespace following the number, so it can parse in place instead of from a copy of the token
+		char *end = NULL;
+		const PxF32 ret = PxF32(strtod(str,&end));
 		if ( nextScan )
 		{
-			*nextScan = begin+(end-temp);
+			*nextScan = end;
 		}
 		return ret;
 	}
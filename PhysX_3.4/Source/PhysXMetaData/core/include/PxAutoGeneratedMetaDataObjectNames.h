@@ -405,6 +405,7 @@ PxSceneDesc_SanityBounds,
 PxSceneDesc_GpuDynamicsConfig,
 PxSceneDesc_GpuMaxNumPartitions,
 PxSceneDesc_GpuComputeVersion,
+PxSceneDesc_SolverConvergenceThreshold,
 PxSceneDesc_PropertiesStop,
 PxSimulationStatistics_PropertiesStart,
 PxSimulationStatistics_NbActiveConstraints,
@@ -52,6 +52,8 @@ template<> struct PxEnumTraits< physx::PxClothFlag::Enum > { PxEnumTraits() : Na
 		{ "eTRIGGER_SHAPE", static_cast<PxU32>( physx::PxShapeFlag::eTRIGGER_SHAPE ) },
 		{ "eVISUALIZATION", static_cast<PxU32>( physx::PxShapeFlag::eVISUALIZATION ) },
 		{ "ePARTICLE_DRAIN", static_cast<PxU32>( physx::PxShapeFlag::ePARTICLE_DRAIN ) },
+		{ "eTRIGGER_BOUNDS_ONLY", static_cast<PxU32>( physx::PxShapeFlag::eTRIGGER_BOUNDS_ONLY ) },
+		{ "eTRIGGER_TEST_ON_ENTER", static_cast<PxU32>( physx::PxShapeFlag::eTRIGGER_TEST_ON_ENTER ) },
 		{ NULL, 0 }
 	};
 
@@ -2308,6 +2310,7 @@ template<> struct PxEnumTraits< physx::PxMeshGeometryFlag::Enum > { PxEnumTraits
 template<> struct PxEnumTraits< physx::PxHeightFieldFormat::Enum > { PxEnumTraits() : NameConversion( g_physx__PxHeightFieldFormat__EnumConversion ) {} const PxU32ToName* NameConversion; }; 
 	static PxU32ToName g_physx__PxHeightFieldFlag__EnumConversion[] = {
 		{ "eNO_BOUNDARY_EDGES", static_cast<PxU32>( physx::PxHeightFieldFlag::eNO_BOUNDARY_EDGES ) },
+		{ "eCOMPRESS_SAMPLES", static_cast<PxU32>( physx::PxHeightFieldFlag::eCOMPRESS_SAMPLES ) },
 		{ NULL, 0 }
 	};
 
@@ -2403,6 +2406,14 @@ template<> struct PxEnumTraits< physx::PxHeightFieldFlag::Enum > { PxEnumTraits(
 		{ "eSUPPRESS_EAGER_SCENE_QUERY_REFIT", static_cast<PxU32>( physx::PxSceneFlag::eSUPPRESS_EAGER_SCENE_QUERY_REFIT ) },
 		{ "eENABLE_GPU_DYNAMICS", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_GPU_DYNAMICS ) },
 		{ "eENABLE_ENHANCED_DETERMINISM", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_ENHANCED_DETERMINISM ) },
+		{ "eENABLE_STATIC_BROADPHASE_TREE", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_STATIC_BROADPHASE_TREE ) },
+		{ "eENABLE_ADAPTIVE_PCM_THRESHOLDS", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_ADAPTIVE_PCM_THRESHOLDS ) },
+		{ "eENABLE_COMPACT_CONTACTS", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_COMPACT_CONTACTS ) },
+		{ "eENABLE_BALANCED_PARTITIONS", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_BALANCED_PARTITIONS ) },
+		{ "eENABLE_WARM_SLEEPING", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_WARM_SLEEPING ) },
+		{ "eENABLE_QUERY_CACHE", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_QUERY_CACHE ) },
+		{ "eENABLE_QUERY_SNAPSHOTS", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_QUERY_SNAPSHOTS ) },
+		{ "eENABLE_DISTRIBUTED_READ_LOCK", static_cast<PxU32>( physx::PxSceneFlag::eENABLE_DISTRIBUTED_READ_LOCK ) },
 		{ "eMUTABLE_FLAGS", static_cast<PxU32>( physx::PxSceneFlag::eMUTABLE_FLAGS ) },
 		{ NULL, 0 }
 	};
@@ -2482,6 +2493,8 @@ template<> struct PxEnumTraits< physx::PxVisualizationParameter::Enum > { PxEnum
 		{ "eNONE", static_cast<PxU32>( physx::PxPruningStructureType::eNONE ) },
 		{ "eDYNAMIC_AABB_TREE", static_cast<PxU32>( physx::PxPruningStructureType::eDYNAMIC_AABB_TREE ) },
 		{ "eSTATIC_AABB_TREE", static_cast<PxU32>( physx::PxPruningStructureType::eSTATIC_AABB_TREE ) },
+		{ "eINCREMENTAL_AABB_TREE", static_cast<PxU32>( physx::PxPruningStructureType::eINCREMENTAL_AABB_TREE ) },
+		{ "eHASH_GRID", static_cast<PxU32>( physx::PxPruningStructureType::eHASH_GRID ) },
 		{ "eLAST", static_cast<PxU32>( physx::PxPruningStructureType::eLAST ) },
 		{ NULL, 0 }
 	};
@@ -3015,6 +3028,7 @@ template<> struct PxEnumTraits< physx::PxPairFilteringMode::Enum > { PxEnumTrait
 		PxgDynamicsMemoryConfig GpuDynamicsConfig;
 		PxU32 GpuMaxNumPartitions;
 		PxU32 GpuComputeVersion;
+		PxReal SolverConvergenceThreshold;
 		 PX_PHYSX_CORE_API PxSceneDescGeneratedValues( const PxSceneDesc* inSource );
 	};
 	DEFINE_PROPERTY_TO_VALUE_STRUCT_MAP( PxSceneDesc, Gravity, PxSceneDescGeneratedValues)
@@ -3054,6 +3068,7 @@ template<> struct PxEnumTraits< physx::PxPairFilteringMode::Enum > { PxEnumTrait
 	DEFINE_PROPERTY_TO_VALUE_STRUCT_MAP( PxSceneDesc, GpuDynamicsConfig, PxSceneDescGeneratedValues)
 	DEFINE_PROPERTY_TO_VALUE_STRUCT_MAP( PxSceneDesc, GpuMaxNumPartitions, PxSceneDescGeneratedValues)
 	DEFINE_PROPERTY_TO_VALUE_STRUCT_MAP( PxSceneDesc, GpuComputeVersion, PxSceneDescGeneratedValues)
+	DEFINE_PROPERTY_TO_VALUE_STRUCT_MAP( PxSceneDesc, SolverConvergenceThreshold, PxSceneDescGeneratedValues)
 	struct PxSceneDescGeneratedInfo
 
 	{
@@ -3096,6 +3111,7 @@ template<> struct PxEnumTraits< physx::PxPairFilteringMode::Enum > { PxEnumTrait
 		PxPropertyInfo<PX_PROPERTY_INFO_NAME::PxSceneDesc_GpuDynamicsConfig, PxSceneDesc, PxgDynamicsMemoryConfig, PxgDynamicsMemoryConfig > GpuDynamicsConfig;
 		PxPropertyInfo<PX_PROPERTY_INFO_NAME::PxSceneDesc_GpuMaxNumPartitions, PxSceneDesc, PxU32, PxU32 > GpuMaxNumPartitions;
 		PxPropertyInfo<PX_PROPERTY_INFO_NAME::PxSceneDesc_GpuComputeVersion, PxSceneDesc, PxU32, PxU32 > GpuComputeVersion;
+		PxPropertyInfo<PX_PROPERTY_INFO_NAME::PxSceneDesc_SolverConvergenceThreshold, PxSceneDesc, PxReal, PxReal > SolverConvergenceThreshold;
 
 		PX_PHYSX_CORE_API PxSceneDescGeneratedInfo();
 		template<typename TReturnType, typename TOperator>
@@ -3115,7 +3131,7 @@ template<> struct PxEnumTraits< physx::PxPairFilteringMode::Enum > { PxEnumTrait
 			PX_UNUSED(inStartIndex);
 			return inStartIndex;
 		}
-		static PxU32 instancePropertyCount() { return 38; }
+		static PxU32 instancePropertyCount() { return 39; }
 		static PxU32 totalPropertyCount() { return instancePropertyCount(); }
 		template<typename TOperator>
 		PxU32 visitInstanceProperties( TOperator inOperator, PxU32 inStartIndex = 0 ) const
@@ -3160,7 +3176,8 @@ template<> struct PxEnumTraits< physx::PxPairFilteringMode::Enum > { PxEnumTrait
 			inOperator( GpuDynamicsConfig, inStartIndex + 35 );; 
 			inOperator( GpuMaxNumPartitions, inStartIndex + 36 );; 
 			inOperator( GpuComputeVersion, inStartIndex + 37 );; 
-			return 38 + inStartIndex;
+			inOperator( SolverConvergenceThreshold, inStartIndex + 38 );; 
+			return 39 + inStartIndex;
 		}
 	};
 	template<> struct PxClassInfoTraits<PxSceneDesc>
@@ -3182,6 +3199,9 @@ template<> struct PxEnumTraits< physx::PxSimulationStatistics::VolumeType > { Px
 		{ "eCCD_PAIRS", static_cast<PxU32>( physx::PxSimulationStatistics::eCCD_PAIRS ) },
 		{ "eMODIFIED_CONTACT_PAIRS", static_cast<PxU32>( physx::PxSimulationStatistics::eMODIFIED_CONTACT_PAIRS ) },
 		{ "eTRIGGER_PAIRS", static_cast<PxU32>( physx::PxSimulationStatistics::eTRIGGER_PAIRS ) },
+		{ "ePCM_MANIFOLD_HITS", static_cast<PxU32>( physx::PxSimulationStatistics::ePCM_MANIFOLD_HITS ) },
+		{ "ePCM_MANIFOLD_REFRESHES", static_cast<PxU32>( physx::PxSimulationStatistics::ePCM_MANIFOLD_REFRESHES ) },
+		{ "ePCM_MANIFOLD_REGENERATIONS", static_cast<PxU32>( physx::PxSimulationStatistics::ePCM_MANIFOLD_REGENERATIONS ) },
 		{ NULL, 0 }
 	};
 
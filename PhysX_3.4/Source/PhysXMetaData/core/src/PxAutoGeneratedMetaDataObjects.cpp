@@ -1293,6 +1293,8 @@ inline PxU32 getPxSceneDescGpuMaxNumPartitions( const PxSceneDesc* inOwner ) { r
 inline void setPxSceneDescGpuMaxNumPartitions( PxSceneDesc* inOwner, PxU32 inData) { inOwner->gpuMaxNumPartitions = inData; }
 inline PxU32 getPxSceneDescGpuComputeVersion( const PxSceneDesc* inOwner ) { return inOwner->gpuComputeVersion; }
 inline void setPxSceneDescGpuComputeVersion( PxSceneDesc* inOwner, PxU32 inData) { inOwner->gpuComputeVersion = inData; }
+inline PxReal getPxSceneDescSolverConvergenceThreshold( const PxSceneDesc* inOwner ) { return inOwner->solverConvergenceThreshold; }
+inline void setPxSceneDescSolverConvergenceThreshold( PxSceneDesc* inOwner, PxReal inData) { inOwner->solverConvergenceThreshold = inData; }
 PX_PHYSX_CORE_API PxSceneDescGeneratedInfo::PxSceneDescGeneratedInfo()
 	: ToDefault( "ToDefault", setPxSceneDesc_ToDefault)
 	, Gravity( "Gravity", setPxSceneDescGravity, getPxSceneDescGravity )
@@ -1332,6 +1334,7 @@ PX_PHYSX_CORE_API PxSceneDescGeneratedInfo::PxSceneDescGeneratedInfo()
 	, GpuDynamicsConfig( "GpuDynamicsConfig", setPxSceneDescGpuDynamicsConfig, getPxSceneDescGpuDynamicsConfig )
 	, GpuMaxNumPartitions( "GpuMaxNumPartitions", setPxSceneDescGpuMaxNumPartitions, getPxSceneDescGpuMaxNumPartitions )
 	, GpuComputeVersion( "GpuComputeVersion", setPxSceneDescGpuComputeVersion, getPxSceneDescGpuComputeVersion )
+	, SolverConvergenceThreshold( "SolverConvergenceThreshold", setPxSceneDescSolverConvergenceThreshold, getPxSceneDescSolverConvergenceThreshold )
 {}
 PX_PHYSX_CORE_API PxSceneDescGeneratedValues::PxSceneDescGeneratedValues( const PxSceneDesc* inSource )
 		:Gravity( inSource->gravity )
@@ -1371,6 +1374,7 @@ PX_PHYSX_CORE_API PxSceneDescGeneratedValues::PxSceneDescGeneratedValues( const
 		,GpuDynamicsConfig( inSource->gpuDynamicsConfig )
 		,GpuMaxNumPartitions( inSource->gpuMaxNumPartitions )
 		,GpuComputeVersion( inSource->gpuComputeVersion )
+		,SolverConvergenceThreshold( inSource->solverConvergenceThreshold )
 {
 	PX_UNUSED(inSource);
 }
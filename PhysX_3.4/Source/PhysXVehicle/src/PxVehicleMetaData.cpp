@@ -418,6 +418,7 @@ void PxVehicleWheels::getBinaryMetaData(PxOutputStream& stream)
 	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels,	PxU32,					mNbNonDrivenWheels,				0)	
 	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels,	PxU8,					mOnConstraintReleaseCounter,	0)	
 	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels,	PxU8,					mType,							0)	
+	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels,	PxU8,					mSimulationTier,				0)	
 	PX_DEF_BIN_METADATA_ITEMS_AUTO(stream,	PxVehicleWheels,	PxU8,					mPad0,							PxMetaDataFlag::ePADDING)
 }
 
@@ -535,6 +536,7 @@ void PxVehicleWheels4DynData::getBinaryMetaData(PxOutputStream& stream)
 	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels4DynData,	PxSweepQueryResult,			mSweepResults,					PxMetaDataFlag::ePTR)
 
 	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels4DynData,	bool,						mHasCachedRaycastHitPlane,		0)
+	PX_DEF_BIN_METADATA_ITEM(stream,		PxVehicleWheels4DynData,	bool,						mHasCachedHitResults,			0)
 #if PX_P64_FAMILY
 	PX_DEF_BIN_METADATA_ITEMS_AUTO(stream,	PxVehicleWheels4DynData,	PxU32,						mPad,							PxMetaDataFlag::ePADDING)
 #endif
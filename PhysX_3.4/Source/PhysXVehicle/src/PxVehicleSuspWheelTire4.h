@@ -208,6 +208,7 @@ public:
 		mRaycastResults = NULL;
 		mSweepResults = NULL;
 		mHasCachedRaycastHitPlane = false;
+		mHasCachedHitResults = false;
 	}
 
 	void setInternalDynamicsToZero()
@@ -335,6 +336,24 @@ public:
 		*/
 		PxU16 mQueryTypes[4];
 
+		/**
+		\brief Start points of the suspension lines of the raycasts the cached hits come from.
+		@see PxVehicleSetSuspensionRaycastReuseThreshold
+		*/
+		PxVec3 mQueryStarts[4];
+
+		/**
+		\brief End points of the suspension lines of the raycasts the cached hits come from.
+		@see PxVehicleSetSuspensionRaycastReuseThreshold
+		*/
+		PxVec3 mQueryEnds[4];
+
+		/**
+		\brief Store 1 if the cached hit is a raycast hit against a PxRigidStatic, 0 otherwise.
+		@see PxVehicleSetSuspensionRaycastReuseThreshold
+		*/
+		PxU16 mStaticHits[4];
+
 		PxU32 mPad1[16];
 	};
 
@@ -375,6 +394,13 @@ public:
 	*/
 	bool mHasCachedRaycastHitPlane;
 
+	/**
+	\brief Set true if mQueryOrCachedHitResults holds the cached hits written by the last PxVehicleUpdates 
+	rather than the suspension lines of scene queries issued since.
+	@see PxVehicleSetSuspensionRaycastReuseThreshold
+	*/
+	bool mHasCachedHitResults;
+
 
 #if PX_P64_FAMILY
 	PxU32 mPad[12];
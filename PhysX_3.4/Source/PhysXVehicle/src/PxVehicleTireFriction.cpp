@@ -31,15 +31,17 @@
 #include "PxVehicleTireFriction.h"
 #include "CmPhysXCommon.h"
 #include "PsFoundation.h"
+#include "PsUtilities.h"
 
 namespace physx
 {
 
-PX_FORCE_INLINE PxU32 computeByteSize(const PxU32 maxNbTireTypes, const PxU32 maxNbSurfaceTypes)
+PX_FORCE_INLINE PxU32 computeByteSize(const PxU32 maxNbTireTypes, const PxU32 maxNbSurfaceTypes, const PxU32 maxHashSize)
 {
 	PxU32 byteSize = ((sizeof(PxU32)*(maxNbTireTypes*maxNbSurfaceTypes) + 15) & ~15);
 	byteSize += ((sizeof(PxMaterial*)*maxNbSurfaceTypes + 15) & ~15);
 	byteSize += ((sizeof(PxVehicleDrivableSurfaceType)*maxNbSurfaceTypes + 15) & ~15);
+	byteSize += ((sizeof(PxU16)*maxHashSize + 15) & ~15);
 	byteSize += ((sizeof(PxVehicleDrivableSurfaceToTireFrictionPairs) + 15) & ~ 15);
 	return byteSize;
 }
@@ -49,7 +51,7 @@ PxVehicleDrivableSurfaceToTireFrictionPairs* PxVehicleDrivableSurfaceToTireFrict
 {
 	PX_CHECK_AND_RETURN_VAL(maxNbSurfaceTypes <= eMAX_NB_SURFACE_TYPES, "maxNbSurfaceTypes must be less than eMAX_NB_SURFACE_TYPES", NULL);
 
-	PxU32 byteSize = computeByteSize(maxNbTireTypes, maxNbSurfaceTypes);
+	PxU32 byteSize = computeByteSize(maxNbTireTypes, maxNbSurfaceTypes, computeSurfaceTypeHashSize(maxNbSurfaceTypes));
 	PxU8* ptr = static_cast<PxU8*>(PX_ALLOC(byteSize, "PxVehicleDrivableSurfaceToTireFrictionPairs"));
 	PxMemSet(ptr, 0, byteSize);
 	PxVehicleDrivableSurfaceToTireFrictionPairs* pairs = reinterpret_cast<PxVehicleDrivableSurfaceToTireFrictionPairs*>(ptr);
@@ -57,6 +59,8 @@ PxVehicleDrivableSurfaceToTireFrictionPairs* PxVehicleDrivableSurfaceToTireFrict
 	pairs->mPairs = NULL;
 	pairs->mDrivableSurfaceMaterials = NULL;
 	pairs->mDrivableSurfaceTypes = NULL;
+	pairs->mSurfaceTypeHash = NULL;
+	pairs->mSurfaceTypeHashMask = 0;
 	pairs->mNbTireTypes = 0;
 	pairs->mMaxNbTireTypes = maxNbTireTypes;
 	pairs->mNbSurfaceTypes = 0;
@@ -75,7 +79,7 @@ void PxVehicleDrivableSurfaceToTireFrictionPairs::setup
 
 	const PxU32 maxNbTireTypes = mMaxNbTireTypes;
 	const PxU32 maxNbSurfaceTypes = mMaxNbSurfaceTypes;
-	PxU32 byteSize = computeByteSize(mMaxNbTireTypes, mMaxNbSurfaceTypes);
+	PxU32 byteSize = computeByteSize(mMaxNbTireTypes, mMaxNbSurfaceTypes, computeSurfaceTypeHashSize(mMaxNbSurfaceTypes));
 	PxMemSet(ptr, 0, byteSize);
 	mMaxNbTireTypes = maxNbTireTypes;
 	mMaxNbSurfaceTypes = maxNbSurfaceTypes;
@@ -89,12 +93,30 @@ void PxVehicleDrivableSurfaceToTireFrictionPairs::setup
 	ptr += ((sizeof(PxMaterial*)*numSurfaceTypes + 15) & ~15);
 	mDrivableSurfaceTypes = reinterpret_cast<PxVehicleDrivableSurfaceType*>(ptr);
 	ptr += ((sizeof(PxVehicleDrivableSurfaceType)*numSurfaceTypes +15) & ~15);
+	const PxU32 hashSize = computeSurfaceTypeHashSize(numSurfaceTypes);
+	mSurfaceTypeHash = reinterpret_cast<PxU16*>(ptr);
+	mSurfaceTypeHashMask = hashSize - 1;
+	ptr += ((sizeof(PxU16)*hashSize +15) & ~15);
 
 	for(PxU32 i=0;i<numSurfaceTypes;i++)
 	{
 		mDrivableSurfaceTypes[i] = drivableSurfaceTypes[i];
 		mDrivableSurfaceMaterials[i] = drivableSurfaceMaterials[i];
 	}
+
+	//Hash the materials once here rather than searching them for each wheel in the updates.
+	//The hash table is already zeroed, which marks all slots as empty.
+	//A material listed more than once gets the surface type of its last entry.
+	for(PxU32 i=0;i<numSurfaceTypes;i++)
+	{
+		const PxMaterial* material = drivableSurfaceMaterials[i];
+		PxU32 slot = computeSurfaceTypeHash(material) & mSurfaceTypeHashMask;
+		while(0 != mSurfaceTypeHash[slot] && material != mDrivableSurfaceMaterials[mSurfaceTypeHash[slot]-1])
+		{
+			slot = (slot + 1) & mSurfaceTypeHashMask;
+		}
+		mSurfaceTypeHash[slot] = Ps::to16(i+1);
+	}
 	for(PxU32 i=0;i<numTireTypes*numSurfaceTypes;i++)
 	{
 		mPairs[i]=1.0f;
@@ -42,7 +42,12 @@
 #include "PxVehicleLinearMath.h"
 #include "PxShape.h"
 #include "PxRigidDynamic.h"
+#include "PxRigidStatic.h"
 #include "PxBatchQuery.h"
+#include "geometry/PxGeometryQuery.h"
+#include "geometry/PxHeightField.h"
+#include "geometry/PxHeightFieldGeometry.h"
+#include "geometry/PxHeightFieldSample.h"
 #include "PxMaterial.h"
 #include "PxTolerancesScale.h"
 #include "PxRigidBodyExt.h"
@@ -50,8 +55,12 @@
 #include "PsUtilities.h"
 #include "CmBitMap.h"
 #include "CmUtils.h"
+#include "CmParallelFor.h"
 #include "PxContactModifyCallback.h"
 #include "PsFPU.h"
+#include "PsAtomic.h"
+#include "PsVecMath.h"
+#include "task/PxCpuDispatcher.h"
 
 using namespace physx;
 using namespace Cm;
@@ -138,6 +147,30 @@ void PxVehicleSetMaxHitActorAcceleration(const PxF32 maxHitActorAcceleration)
 	gMaxHitActorAcceleration = maxHitActorAcceleration;
 }
 
+////////////////////////////////////////////////////////////////////////////
+//Implementation of public api function PxVehicleSetSuspensionRaycastReuseThreshold
+////////////////////////////////////////////////////////////////////////////
+
+const PxF32 gSuspRaycastReuseThresholdDefault = 0.0f;
+PxF32 gSuspRaycastReuseThreshold;
+
+void PxVehicleSetSuspensionRaycastReuseThreshold(const PxF32 maxWheelMotion)
+{
+	PX_CHECK_AND_RETURN(maxWheelMotion >= 0.0f, "PxVehicleSetSuspensionRaycastReuseThreshold - maxWheelMotion must be greater than or equal to zero");
+	gSuspRaycastReuseThreshold = maxWheelMotion;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//Implementation of public api function PxVehicleSetTelemetryRecorder
+////////////////////////////////////////////////////////////////////////////
+
+PxVehicleTelemetryRecorder* gTelemetryRecorder = NULL;
+
+void PxVehicleSetTelemetryRecorder(PxVehicleTelemetryRecorder* recorder)
+{
+	gTelemetryRecorder = recorder;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //Set all defaults from PxVehicleInitSDK
 ////////////////////////////////////////////////////////////////////////////
@@ -154,6 +187,10 @@ void setVehicleDefaults()
 	gNormalRejectAngleThreshold = gNormalRejectAngleThresholdDefault;
 
 	gMaxHitActorAcceleration = gMaxHitActorAccelerationDefault;
+
+	gSuspRaycastReuseThreshold = gSuspRaycastReuseThresholdDefault;
+
+	gTelemetryRecorder = NULL;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -982,18 +1019,12 @@ PX_FORCE_INLINE void END_TIMER(const PxU32)
 
 
 ////////////////////////////////////////////////////////////////////////////
-//Hash table of PxMaterial pointers used to associate each PxMaterial pointer
-//with a unique PxDrivableSurfaceType.  PxDrivableSurfaceType is just an integer
-//representing an id but introducing this type allows different PxMaterial pointers
-//to be associated with the same surface type.  The friction of a specific tire
-//touching a specific PxMaterial is found from a 2D table using the integers for
-//the tire type (stored in the tire) and drivable surface type (from the hash table).
-//It would be great to use PsHashSet for the hash table of PxMaterials but
-//PsHashSet will never, ever work on spu so this will need to do instead.
-//Perf isn't really critical so this will do in the meantime.
-//It is probably wasteful to compute the hash table each update
-//but this is really not an expensive operation so keeping the api as 
-//simple as possible wins out at the cost of a relatively very small number of wasted cycles.
+//Lookup of the PxDrivableSurfaceType associated with each PxMaterial pointer.
+//PxDrivableSurfaceType is just an integer representing an id but introducing 
+//this type allows different PxMaterial pointers to be associated with the same surface type.  
+//The friction of a specific tire touching a specific PxMaterial is found from a 2D table using 
+//the integers for the tire type (stored in the tire) and drivable surface type (from the hash table).
+//The hash table is built once in PxVehicleDrivableSurfaceToTireFrictionPairs::setup.
 ////////////////////////////////////////////////////////////////////////////
 
 class VehicleSurfaceTypeHashTable
@@ -1001,131 +1032,21 @@ class VehicleSurfaceTypeHashTable
 public:
 
 	VehicleSurfaceTypeHashTable(const PxVehicleDrivableSurfaceToTireFrictionPairs& pairs)
-		: mNbEntries(pairs.mNbSurfaceTypes),
- 	      mMaterials(pairs.mDrivableSurfaceMaterials),
-	      mDrivableSurfaceTypes(pairs.mDrivableSurfaceTypes)
-	{
-		for(PxU32 i=0;i<eHASH_SIZE;i++)
-		{
-			mHeadIds[i]=PX_MAX_U32;
-		}
-		for(PxU32 i=0;i<eMAX_NB_KEYS;i++)
-		{
-			mNextIds[i]=PX_MAX_U32;
-		}
-
-		if(mNbEntries>0)
-		{
-			//Compute the number of bits to right-shift that gives the maximum number of unique hashes.
-			//Keep searching until we find either a set of completely unique hashes or a peak count of unique hashes.
-			PxU32 prevShift=0;
-			PxU32 shift=2;
-			PxU32 prevNumUniqueHashes=0;
-			PxU32 currNumUniqueHashes=0;
-			while( ((currNumUniqueHashes=computeNumUniqueHashes(shift)) > prevNumUniqueHashes) && currNumUniqueHashes!=mNbEntries)
-			{
-				prevNumUniqueHashes=currNumUniqueHashes;
-				prevShift=shift;
-				shift = (shift << 1);
-			}
-			if(currNumUniqueHashes!=mNbEntries)
-			{
-				//Stopped searching because we have gone past the peak number of unqiue hashes.
-				mShift = prevShift;
-			}
-			else
-			{
-				//Stopped searching because we found a unique hash for each key.
-				mShift = shift;
-			}
-
-			//Compute the hash values with the optimum shift.
-			for(PxU32 i=0;i<mNbEntries;i++)
-			{
-				const PxMaterial* const material=mMaterials[i];
-				const PxU32 hash=computeHash(material,mShift);
-				if(PX_MAX_U32==mHeadIds[hash])
-				{
-					mNextIds[i]=PX_MAX_U32;
-					mHeadIds[hash]=i;
-				}
-				else
-				{
-					mNextIds[i]=mHeadIds[hash];
-					mHeadIds[hash]=i;
-				}
-			}
-		}
-	}
-	~VehicleSurfaceTypeHashTable()
+		: mPairs(pairs)
 	{
 	}
 
 	PX_FORCE_INLINE PxU32 get(const PxMaterial* const key) const 
 	{
 		PX_ASSERT(key);
-		const PxU32 hash=computeHash(key, mShift);
-		PxU32 id=mHeadIds[hash];
-		while(PX_MAX_U32!=id)
-		{
-			const PxMaterial* const mat=mMaterials[id];
-			if(key==mat)
-			{
-				return mDrivableSurfaceTypes[id].mType;
-			}
-			id=mNextIds[id];
-		}
-
-		return 0;
+		return mPairs.getSurfaceType(key);
 	}
 
 private:
 
-	PxU32 mNbEntries; 
-	const PxMaterial* const* mMaterials;
-	const PxVehicleDrivableSurfaceType* mDrivableSurfaceTypes;
-
-	static PX_FORCE_INLINE PxU32 computeHash(const PxMaterial* const key, const PxU32 shift) 
-	{
-		const uintptr_t ptr = ((uintptr_t(key)) >> shift);
-		const uintptr_t hash = (ptr & (eHASH_SIZE-1));
-		return PxU32(hash);
-	}
-
-	PxU32 computeNumUniqueHashes(const PxU32 shift) const
-	{
-		PxU32 words[eHASH_SIZE >>5];
-		PxU8* bitmapBuffer[sizeof(BitMap)];
-		BitMap* bitmap=reinterpret_cast<BitMap*>(bitmapBuffer);
-		bitmap->setWords(words, eHASH_SIZE >>5);
-
-		PxU32 numUniqueHashes=0;
-		PxMemZero(words, sizeof(PxU32)*(eHASH_SIZE >>5));
-		for(PxU32 i=0;i<mNbEntries;i++)
-		{
-			const PxMaterial* const material=mMaterials[i];
-			const PxU32 hash=computeHash(material, shift);
-			if(!bitmap->test(hash))
-			{
-				bitmap->set(hash);
-				numUniqueHashes++;
-			}
-		}
-		return numUniqueHashes;
-	}
-
-	enum
-	{
-		eHASH_SIZE=PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NB_SURFACE_TYPES
-	};
-	PxU32 mHeadIds[eHASH_SIZE];
-	enum
-	{
-		eMAX_NB_KEYS=PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NB_SURFACE_TYPES
-	};
-	PxU32 mNextIds[eMAX_NB_KEYS];
+	const PxVehicleDrivableSurfaceToTireFrictionPairs& mPairs;
 
-	PxU32 mShift;
+	VehicleSurfaceTypeHashTable& operator=(const VehicleSurfaceTypeHashTable&);
 };
 
 
@@ -2845,6 +2766,127 @@ void storeHit
 	cachedHitQueryTypes[i] = hitQueryType;
 }
 
+////////////////////////////////////////////////////////////////////////////
+//Suspension and tire load of the 4 wheels of a PxVehicleWheels4SimData block.
+//The inputs are gathered per wheel in structure of arrays form (one lane per wheel) 
+//so that the spring, damper and load filter math is done for the 4 wheels at once.
+//The ops of each lane are done in the same order as in the scalar code they replace.
+////////////////////////////////////////////////////////////////////////////
+
+struct SuspensionData4
+{
+	//Inputs.
+	PxF32 dx[4];
+	PxF32 maxCompressions[4];
+	PxF32 prevJounces[4];
+	PxF32 sprungMasses[4];
+	PxF32 springStrengths[4];
+	PxF32 springDamperRates[4];
+	PxF32 wx[4], wy[4], wz[4];			//Suspension travel dirs in world space.
+	PxF32 nx[4], ny[4], nz[4];			//Hit normals.
+	//Outputs.
+	PxF32 jounces[4];
+	PxF32 suspLimitErrors[4];
+	PxF32 suspensionForceMags[4];
+};
+
+void computeSuspensionForces4(const PxVec3& gravity, const PxF32 recipTimeStep, SuspensionData4& data)
+{
+	using namespace physx::shdfnd::aos;
+
+	const Vec4V zero = V4Zero();
+	const Vec4V dx = V4LoadU(data.dx);
+	const Vec4V maxCompression = V4LoadU(data.maxCompressions);
+	const Vec4V prevJounce = V4LoadU(data.prevJounces);
+	const Vec4V sprungMass = V4LoadU(data.sprungMasses);
+	const Vec4V wx = V4LoadU(data.wx);
+	const Vec4V wy = V4LoadU(data.wy);
+	const Vec4V wz = V4LoadU(data.wz);
+	const Vec4V nx = V4LoadU(data.nx);
+	const Vec4V ny = V4LoadU(data.ny);
+	const Vec4V nz = V4LoadU(data.nz);
+
+	//Clamp the spring compression so that it is never greater than the max bounce.
+	const Vec4V wDotN = V4Add(V4Add(V4Mul(wx, nx), V4Mul(wy, ny)), V4Mul(wz, nz));
+	const Vec4V suspLimitError = V4Mul(wDotN, V4Add(V4Neg(dx), maxCompression));
+	const Vec4V jounce = V4Min(dx, maxCompression);
+
+	//Get the speed of the jounce (zero if there is no previous jounce).
+	const Vec4V jounceSpeed = V4Sel(V4IsEq(prevJounce, V4Load(PX_MAX_F32)), zero, V4Mul(V4Sub(jounce, prevJounce), V4Load(recipTimeStep)));
+
+	//Decompose gravity into a term along w and a term perpendicular to w (see processSuspTireWheels).
+	const Vec4V gx = V4Load(gravity.x);
+	const Vec4V gy = V4Load(gravity.y);
+	const Vec4V gz = V4Load(gravity.z);
+	const Vec4V alpha = V4Max(zero, V4Add(V4Add(V4Mul(gx, wx), V4Mul(gy, wy)), V4Mul(gz, wz)));
+	const BoolV hasAlpha = V4IsGrtr(alpha, zero);
+	const Vec4V tx = V4Sel(hasAlpha, V4Sub(gx, V4Mul(wx, alpha)), zero);
+	const Vec4V ty = V4Sel(hasAlpha, V4Sub(gy, V4Mul(wy, alpha)), zero);
+	const Vec4V tz = V4Sel(hasAlpha, V4Sub(gz, V4Mul(wz, alpha)), zero);
+
+	//Compute the magnitude of the force along w.
+	Vec4V suspensionForceW = V4Max(zero, V4Add(V4Mul(sprungMass, alpha), V4Mul(V4LoadU(data.springStrengths), jounce)));
+	suspensionForceW = V4Add(suspensionForceW, V4Mul(V4LoadU(data.springDamperRates), jounceSpeed));
+
+	//Project -w*suspensionForceW - TTimesBeta*sprungMass onto the hit normal.
+	const Vec4V fx = V4Sub(V4Mul(V4Neg(wx), suspensionForceW), V4Mul(tx, sprungMass));
+	const Vec4V fy = V4Sub(V4Mul(V4Neg(wy), suspensionForceW), V4Mul(ty, sprungMass));
+	const Vec4V fz = V4Sub(V4Mul(V4Neg(wz), suspensionForceW), V4Mul(tz, sprungMass));
+	const Vec4V suspensionForceMag = V4Add(V4Add(V4Mul(nx, fx), V4Mul(ny, fy)), V4Mul(nz, fz));
+
+	V4StoreU(jounce, data.jounces);
+	V4StoreU(suspLimitError, data.suspLimitErrors);
+	V4StoreU(suspensionForceMag, data.suspensionForceMags);
+}
+
+struct TireLoadData4
+{
+	//Inputs.
+	PxF32 tireLoads[4];
+	PxF32 jounces[4];
+	PxF32 cambersAtRest[4];
+	PxF32 cambersAtMaxCompression[4];
+	PxF32 recipMaxCompressions[4];
+	PxF32 cambersAtMaxDroop[4];
+	PxF32 recipMaxDroops[4];
+	//Outputs.
+	PxF32 normalisedTireLoads[4];
+	PxF32 filteredNormalisedTireLoads[4];
+	PxF32 filteredTireLoads[4];
+	PxF32 cambers[4];
+};
+
+void computeTireLoads4
+(const PxVehicleTireLoadFilterData& filterData, const PxF32* PX_RESTRICT tireRestLoads, const PxF32* PX_RESTRICT recipTireRestLoads,
+ const PxF32 gravityMagnitude, const PxF32 recipGravityMagnitude, 
+ TireLoadData4& data)
+{
+	using namespace physx::shdfnd::aos;
+
+	//Normalize the tire load and filter it (same graph as computeFilteredNormalisedTireLoad).
+	const Vec4V normalisedTireLoad = V4Mul(V4Mul(V4LoadU(data.tireLoads), V4Load(recipGravityMagnitude)), V4LoadU(recipTireRestLoads));
+	const Vec4V xmin = V4Load(filterData.mMinNormalisedLoad);
+	const Vec4V xmax = V4Load(filterData.mMaxNormalisedLoad);
+	const Vec4V ymin = V4Load(filterData.mMinFilteredNormalisedLoad);
+	const Vec4V ymax = V4Load(filterData.mMaxFilteredNormalisedLoad);
+	const Vec4V lerp = V4Add(ymin, V4Mul(V4Mul(V4Sub(normalisedTireLoad, xmin), V4Sub(ymax, ymin)), V4Load(filterData.getDenominator())));
+	const Vec4V filteredNormalisedTireLoad = 
+		V4Sel(V4IsGrtr(normalisedTireLoad, xmin), V4Sel(V4IsGrtrOrEq(normalisedTireLoad, xmax), ymax, lerp), ymin);
+	const Vec4V filteredTireLoad = V4Mul(V4Mul(filteredNormalisedTireLoad, V4Load(gravityMagnitude)), V4LoadU(tireRestLoads));
+
+	//Camber angle.
+	const Vec4V jounce = V4LoadU(data.jounces);
+	const Vec4V camberAtRest = V4LoadU(data.cambersAtRest);
+	const Vec4V compressionCamber = V4Add(camberAtRest, V4Mul(V4Mul(jounce, V4LoadU(data.cambersAtMaxCompression)), V4LoadU(data.recipMaxCompressions)));
+	const Vec4V droopCamber = V4Sub(camberAtRest, V4Mul(V4Mul(jounce, V4LoadU(data.cambersAtMaxDroop)), V4LoadU(data.recipMaxDroops)));
+	const Vec4V camber = V4Sel(V4IsGrtr(jounce, V4Zero()), compressionCamber, droopCamber);
+
+	V4StoreU(normalisedTireLoad, data.normalisedTireLoads);
+	V4StoreU(filteredNormalisedTireLoad, data.filteredNormalisedTireLoads);
+	V4StoreU(filteredTireLoad, data.filteredTireLoads);
+	V4StoreU(camber, data.cambers);
+}
+
 void processSuspTireWheels
 (const PxU32 startWheelIndex, 
  const ProcessSuspWheelTireConstData& constData, const ProcessSuspWheelTireInputData& inputData, 
@@ -3178,13 +3220,23 @@ void processSuspTireWheels
 		}
 	}
 
-	//Iterate over all 4 wheels.
+	//Iterate over all 4 wheels and work out which wheels touch the ground.
+	//The suspension forces and tire loads of the touching wheels are then computed 4 at a time 
+	//before the tire forces are computed wheel by wheel.
+	bool isTouchingGround[4]={false,false,false,false};
+	PxF32 frictionMultipliers[4];
+	PxVec3 hitNorms[4];
+	PxVec3 wheelBottomVels[4];
+	PxVec3 hitActorVelocities[4];
+	PxRigidDynamic* dynamicHitActors[4];
+	SuspensionData4 suspData4;
+	TireLoadData4 tireLoadData4;
+	PxU32 numTouchingWheels=0;
 	for(PxU32 i=0;i<4;i++)
 	{
 		//Constant data of the ith wheel.
 		const PxVehicleWheelData& wheel=wheelsSimData.getWheelData(i);
 		const PxVehicleSuspensionData& susp=wheelsSimData.getSuspensionData(i);
-		const PxVehicleTireData& tire=wheelsSimData.getTireData(i);
 		const PxVec3& bodySpaceWheelCentreOffset=wheelsSimData.getWheelCentreOffset(i);
 		const PxVec3& bodySpaceSuspTravelDir=wheelsSimData.getSuspTravelDirection(i);
 
@@ -3201,8 +3253,7 @@ void processSuspTireWheels
 
 		//Reset the jounce to max droop.
 		//This will get updated as we learn more about the suspension and tire.
-		PxF32 jounce=-susp.mMaxDroop;
-		jounces[i]=jounce;
+		jounces[i]=-susp.mMaxDroop;
 
 		//Deactivate the sticky tire and susp limit constraint.
 		//These will get updated as we learn more about the suspension and tire.
@@ -3216,6 +3267,20 @@ void processSuspTireWheels
 		//The vehicle is in the air until we know otherwise.
 		isInAirs[i]=true;
 
+		//Lanes of wheels that don't touch the ground are computed with these values and then ignored.
+		suspData4.dx[i]=0.0f;
+		suspData4.maxCompressions[i]=0.0f;
+		suspData4.prevJounces[i]=PX_MAX_F32;
+		suspData4.sprungMasses[i]=0.0f;
+		suspData4.springStrengths[i]=0.0f;
+		suspData4.springDamperRates[i]=0.0f;
+		suspData4.wx[i]=0.0f;
+		suspData4.wy[i]=0.0f;
+		suspData4.wz[i]=0.0f;
+		suspData4.nx[i]=0.0f;
+		suspData4.ny[i]=0.0f;
+		suspData4.nz[i]=0.0f;
+
 		//If there has been a hit then compute the suspension force and tire load.
 		//Ignore the hit if the raycast starts inside the hit shape (eg wheel completely underneath surface of a heightfield).
 		const bool activeWheelState=activeWheelStates[i];
@@ -3268,22 +3333,14 @@ void processSuspTireWheels
 
 				//We know that the vehicle is not in the air.
 				isInAirs[i]=false;
+				isTouchingGround[i]=true;
+				numTouchingWheels++;
 
-				//Clamp the spring compression so that it is never greater than the max bounce.
 				//Apply the susp limit constraint if the spring compression is greater than the max bounce.
-				suspLimitErrors[i] = (w.dot(hitNorm))*(-dx + susp.mMaxCompression);
+				//The error and the clamped jounce are computed with the suspension forces.
 				suspLimitActiveFlags[i] = (dx > susp.mMaxCompression);
 				suspLimitCMOffsets[i] = bodySpaceWheelCentreOffset;
 				suspLimitDirs[i] = bodySpaceSuspTravelDir;
-				jounce=PxMin(dx,susp.mMaxCompression);
-
-				//Store the jounce (having a local copy avoids lhs).
-				jounces[i]=jounce;
-
-				//Store the jounce in the graph.
-#if PX_DEBUG_VEHICLE_ON
-				updateGraphDataSuspJounce(startWheelIndex, i,jounce);
-#endif
 
 				//Compute the speed of the rigid body along the suspension travel dir at the 
 				//bottom of the wheel.
@@ -3300,247 +3357,291 @@ void processSuspTireWheels
 					wheelBottomVel -= hitActorVelocity;
 				}
 
-				//Get the speed of the jounce.
-				const PxF32 jounceSpeed = (PX_MAX_F32 != prevJounces[i]) ? (jounce - prevJounces[i])*recipTimeStep : 0.0f;
-
-				//Decompose gravity into a term along w and a term perpendicular to w
-				//gravity = w*alpha + T*beta
-				//where T is a unit vector perpendicular to w; alpha and beta are scalars.
-				//The vector w*alpha*mass is the component of gravitational force that acts along the spring direction.
-				//The vector T*beta*mass is the component of gravitational force that will be resisted by the spring 
-				//because the spring only supports a single degree of freedom along w.
-				//We only really need to know T*beta so don't bother calculating T or beta.
-				const PxF32 alpha = PxMax(0.0f, gravity.dot(w));
-				const PxVec3 TTimesBeta = (0.0f != alpha) ? gravity - w*alpha : PxVec3(0,0,0);
-				//Compute the magnitude of the force along w.
-				PxF32 suspensionForceW =	
-					PxMax(0.0f, 
-					susp.mSprungMass*alpha + 							//force to support sprung mass at zero jounce
-					susp.mSpringStrength*jounce);						//linear spring
-				suspensionForceW += susp.mSpringDamperRate*jounceSpeed;	//damping
-				//Compute the total force acting on the suspension.
-				//Remember that the spring force acts along -w.
-				//Remember to account for the term perpendicular to w and that it acts along -TTimesBeta
-				PxF32 suspensionForceMag = hitNorm.dot(-w*suspensionForceW - TTimesBeta*susp.mSprungMass);
-
-				//Apply the opposite force to the hit object.
-				//Clamp suspensionForceMag if required.
-				if (dynamicHitActor && !(dynamicHitActor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
-				{
-					const PxF32 dynamicActorInvMass = dynamicHitActor->getInvMass();
-					const PxF32 dynamicActorMass = dynamicHitActor->getMass();
-					const PxF32 forceSign = computeSign(suspensionForceMag);
-					const PxF32 forceMag = PxAbs(suspensionForceMag);
-					const PxF32 clampedAccelMag = PxMin(forceMag*dynamicActorInvMass, gMaxHitActorAcceleration);
-					const PxF32 clampedForceMag = clampedAccelMag*dynamicActorMass*forceSign;
-					PX_ASSERT(clampedForceMag*suspensionForceMag >= 0.0f);
-
-					suspensionForceMag = clampedForceMag;
-
-					hitActors[i] = dynamicHitActor;
-					hitActorForces[i] = hitNorm*(-clampedForceMag*timeFraction);
-					hitActorForcePositions[i] = hitContactPoints4[i];
-				}
+				//Store everything we need for the remainder of the computation.
+				frictionMultipliers[i]=frictionMultiplier;
+				hitNorms[i]=hitNorm;
+				wheelBottomVels[i]=wheelBottomVel;
+				hitActorVelocities[i]=hitActorVelocity;
+				dynamicHitActors[i]=dynamicHitActor;
+
+				suspData4.dx[i]=dx;
+				suspData4.maxCompressions[i]=susp.mMaxCompression;
+				suspData4.prevJounces[i]=prevJounces[i];
+				suspData4.sprungMasses[i]=susp.mSprungMass;
+				suspData4.springStrengths[i]=susp.mSpringStrength;
+				suspData4.springDamperRates[i]=susp.mSpringDamperRate;
+				suspData4.wx[i]=w.x;
+				suspData4.wy[i]=w.y;
+				suspData4.wz[i]=w.z;
+				suspData4.nx[i]=hitNorm.x;
+				suspData4.ny[i]=hitNorm.y;
+				suspData4.nz[i]=hitNorm.z;
+			}//if(dx > -susp.mMaxCompression)
+		}//if(numHits>0)
+	}//i
+
+	//Nothing more to do if all wheels are in the air.
+	if(0==numTouchingWheels)
+		return;
+
+	//Compute the jounces and the suspension force of each wheel.
+	computeSuspensionForces4(gravity,recipTimeStep,suspData4);
+
+	for(PxU32 i=0;i<4;i++)
+	{
+		const PxVehicleSuspensionData& susp=wheelsSimData.getSuspensionData(i);
 
-				//Store the spring force now (having a local copy avoids lhs).
-				suspensionSpringForces[i] = suspensionForceMag;
+		tireLoadData4.tireLoads[i]=0.0f;
+		tireLoadData4.jounces[i]=suspData4.jounces[i];
+		tireLoadData4.cambersAtRest[i]=susp.mCamberAtRest;
+		tireLoadData4.cambersAtMaxCompression[i]=susp.mCamberAtMaxCompression;
+		tireLoadData4.recipMaxCompressions[i]=susp.getRecipMaxCompression();
+		tireLoadData4.cambersAtMaxDroop[i]=susp.mCamberAtMaxDroop;
+		tireLoadData4.recipMaxDroops[i]=susp.getRecipMaxDroop();
 
-				//Store the spring force in the graph.
+		if(!isTouchingGround[i])
+			continue;
+
+		//Store the jounce and the susp limit error (having a local copy avoids lhs).
+		jounces[i]=suspData4.jounces[i];
+		suspLimitErrors[i]=suspData4.suspLimitErrors[i];
+
+		//Store the jounce in the graph.
+#if PX_DEBUG_VEHICLE_ON
+		updateGraphDataSuspJounce(startWheelIndex, i,jounces[i]);
+#endif
+
+		//Apply the opposite force to the hit object.
+		//Clamp suspensionForceMag if required.
+		PxF32 suspensionForceMag=suspData4.suspensionForceMags[i];
+		PxRigidDynamic* dynamicHitActor=dynamicHitActors[i];
+		if (dynamicHitActor && !(dynamicHitActor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+		{
+			const PxF32 dynamicActorInvMass = dynamicHitActor->getInvMass();
+			const PxF32 dynamicActorMass = dynamicHitActor->getMass();
+			const PxF32 forceSign = computeSign(suspensionForceMag);
+			const PxF32 forceMag = PxAbs(suspensionForceMag);
+			const PxF32 clampedAccelMag = PxMin(forceMag*dynamicActorInvMass, gMaxHitActorAcceleration);
+			const PxF32 clampedForceMag = clampedAccelMag*dynamicActorMass*forceSign;
+			PX_ASSERT(clampedForceMag*suspensionForceMag >= 0.0f);
+
+			suspensionForceMag = clampedForceMag;
+
+			hitActors[i] = dynamicHitActor;
+			hitActorForces[i] = hitNorms[i]*(-clampedForceMag*timeFraction);
+			hitActorForcePositions[i] = hitContactPoints4[i];
+		}
+
+		//Store the spring force now (having a local copy avoids lhs).
+		suspensionSpringForces[i] = suspensionForceMag;
+
+		//Store the spring force in the graph.
 #if PX_DEBUG_VEHICLE_ON
-				updateGraphDataSuspForce(startWheelIndex, i, suspensionForceMag);
+		updateGraphDataSuspForce(startWheelIndex, i, suspensionForceMag);
 #endif
 
-				//Suspension force can be computed now.
-				const PxVec3 suspensionForce = hitNorm*suspensionForceMag;
+		//Now compute the tire load.
+		tireLoadData4.tireLoads[i]=suspensionForceMag;
+	}
+
+	//Compute the normalised and filtered tire loads and the camber of each wheel.
+	computeTireLoads4(tireLoadFilterData,tireRestLoads,recipTireRestLoads,gravityMagnitude,recipGravityMagnitude,tireLoadData4);
+
+	//Iterate over all 4 wheels to compute the tire forces.
+	for(PxU32 i=0;i<4;i++)
+	{
+		if(!isTouchingGround[i])
+			continue;
+
+		//Constant data of the ith wheel.
+		const PxVehicleWheelData& wheel=wheelsSimData.getWheelData(i);
+		const PxVehicleTireData& tire=wheelsSimData.getTireData(i);
+
+		const PxF32 frictionMultiplier=frictionMultipliers[i];
+		const PxVec3& hitNorm=hitNorms[i];
+		const PxVec3& wheelBottomVel=wheelBottomVels[i];
+		const PxVec3& hitActorVelocity=hitActorVelocities[i];
+		const PxF32 suspensionForceMag=suspensionSpringForces[i];
 
-				//Torque from spring force.
-				const PxVec3 suspForceCMOffset = carChassisTrnsfm.rotate(wheelsSimData.getSuspForceAppPointOffset(i));
-				const PxVec3 suspensionTorque = suspForceCMOffset.cross(suspensionForce);
+		//Suspension force can be computed now.
+		const PxVec3 suspensionForce = hitNorm*suspensionForceMag;
 
-				//Add the suspension force/torque to the chassis force/torque.
-				chassisForce+=suspensionForce;
-				chassisTorque+=suspensionTorque;
+		//Torque from spring force.
+		const PxVec3 suspForceCMOffset = carChassisTrnsfm.rotate(wheelsSimData.getSuspForceAppPointOffset(i));
+		const PxVec3 suspensionTorque = suspForceCMOffset.cross(suspensionForce);
 
-				//Now compute the tire load.
-				const PxF32 tireLoad = suspensionForceMag;
+		//Add the suspension force/torque to the chassis force/torque.
+		chassisForce+=suspensionForce;
+		chassisTorque+=suspensionTorque;
 
-				//Normalize the tire load 
-				//Now work out the normalized tire load.
-				const PxF32 normalisedTireLoad=tireLoad*recipGravityMagnitude*recipTireRestLoads[i];
-				//Filter the normalized tire load and compute the filtered tire load too.
-				const PxF32 filteredNormalisedTireLoad=computeFilteredNormalisedTireLoad(tireLoadFilterData,normalisedTireLoad);
-				const PxF32 filteredTireLoad=filteredNormalisedTireLoad*gravityMagnitude*tireRestLoads[i];
+		//Get the tire load.
+		const PxF32 tireLoad = suspensionForceMag;
+		const PxF32 normalisedTireLoad=tireLoadData4.normalisedTireLoads[i];
+		const PxF32 filteredNormalisedTireLoad=tireLoadData4.filteredNormalisedTireLoads[i];
+		const PxF32 filteredTireLoad=tireLoadData4.filteredTireLoads[i];
+		PX_UNUSED(tireLoad);
+		PX_UNUSED(normalisedTireLoad);
 
 #if PX_DEBUG_VEHICLE_ON
-				updateGraphDataTireLoad(startWheelIndex,i,filteredTireLoad);
-				updateGraphDataNormTireLoad(startWheelIndex,i,filteredNormalisedTireLoad);
+		updateGraphDataTireLoad(startWheelIndex,i,filteredTireLoad);
+		updateGraphDataNormTireLoad(startWheelIndex,i,filteredNormalisedTireLoad);
 #endif
 
-				//Compute the lateral and longitudinal tire axes in the ground plane.
-				PxVec3 tireLongDir;
-				PxVec3 tireLatDir;
-				computeTireDirs(latDir,hitNorm,steerAngles[i],tireLongDir,tireLatDir);
-
-				//Store the tire long and lat dirs now (having a local copy avoids lhs).
-				tireLongitudinalDirs[i]= tireLongDir;
-				tireLateralDirs[i]=tireLatDir;
-
-				//Now compute the speeds along each of the tire axes.
-				const PxF32 tireLongSpeed=wheelBottomVel.dot(tireLongDir);
-				const PxF32 tireLatSpeed=wheelBottomVel.dot(tireLatDir);
-
-				//Store the forward speed (having a local copy avoids lhs).
-				forwardSpeeds[i]=tireLongSpeed;
-
-				//Now compute the slips along each axes.
-				const bool hasAccel=isAccelApplied[i];
-				const bool hasBrake=isBrakeApplied[i];
-				const PxF32 wheelOmega=wheelsDynData.mWheelSpeeds[i];
-				const PxF32 wheelRadius=wheel.mRadius;
-				PxF32 longSlip;
-				PxF32 latSlip;
-				computeTireSlips
-					(tireLongSpeed,tireLatSpeed,wheelOmega,wheelRadius,minLongSlipDenominator,
-					 hasAccel,hasBrake,
-					 isTank,
-					 longSlip,latSlip);
-
-				//Store the lat and long slip (having local copies avoids lhs).
-				longSlips[i]=longSlip;
-				latSlips[i]=latSlip;
+		//Compute the lateral and longitudinal tire axes in the ground plane.
+		PxVec3 tireLongDir;
+		PxVec3 tireLatDir;
+		computeTireDirs(latDir,hitNorm,steerAngles[i],tireLongDir,tireLatDir);
 
-				//Camber angle.
-				PxF32 camber=susp.mCamberAtRest;
-				if(jounce>0)
-				{
-					camber += jounce*susp.mCamberAtMaxCompression*susp.getRecipMaxCompression();
-				}
-				else
-				{
-					camber -= jounce*susp.mCamberAtMaxDroop*susp.getRecipMaxDroop();
-				}
+		//Store the tire long and lat dirs now (having a local copy avoids lhs).
+		tireLongitudinalDirs[i]= tireLongDir;
+		tireLateralDirs[i]=tireLatDir;
 
-				//Compute the friction that will be experienced by the tire.
-				PxF32 friction;
-				computeTireFriction(tire,longSlip,frictionMultiplier,friction);
+		//Now compute the speeds along each of the tire axes.
+		const PxF32 tireLongSpeed=wheelBottomVel.dot(tireLongDir);
+		const PxF32 tireLatSpeed=wheelBottomVel.dot(tireLatDir);
 
-				//Store the friction (having a local copy avoids lhs).
-				frictions[i]=friction;
+		//Store the forward speed (having a local copy avoids lhs).
+		forwardSpeeds[i]=tireLongSpeed;
 
-				if(filteredTireLoad*frictionMultiplier>0)
-				{
-					//Either tire forces or sticky tire friction constraint will be applied here.
-					const PxVec3 tireForceCMOffset = carChassisTrnsfm.rotate(wheelsSimData.getTireForceAppPointOffset(i));
+		//Now compute the slips along each axes.
+		const bool hasAccel=isAccelApplied[i];
+		const bool hasBrake=isBrakeApplied[i];
+		const PxF32 wheelOmega=wheelsDynData.mWheelSpeeds[i];
+		const PxF32 wheelRadius=wheel.mRadius;
+		PxF32 longSlip;
+		PxF32 latSlip;
+		computeTireSlips
+			(tireLongSpeed,tireLatSpeed,wheelOmega,wheelRadius,minLongSlipDenominator,
+			 hasAccel,hasBrake,
+			 isTank,
+			 longSlip,latSlip);
 
-					PxF32 newLowForwardSpeedTimer;
-					{
-						//check the accel value here
-						//Update low forward speed timer.
-						const PxF32 recipWheelRadius=wheel.getRecipRadius();
-						newLowForwardSpeedTimer=newLowForwardSpeedTimers[i];
-						updateLowForwardSpeedTimer(tireLongSpeed,wheelOmega,wheelRadius,recipWheelRadius,isIntentionToAccelerate,timeStep,newLowForwardSpeedTimer);
-
-						//Activate sticky tire forward friction constraint if required.
-						//If sticky tire friction is active then set the longitudinal slip to zero because 
-						//the sticky tire constraint will take care of the longitudinal component of motion.
-						bool stickyTireForwardActiveFlag=false;
-						PxF32 stickyTireForwardTargetSpeed=0.0f;
-						activateStickyFrictionForwardConstraint(tireLongSpeed,wheelOmega,newLowForwardSpeedTimer,isIntentionToAccelerate,stickyTireForwardActiveFlag,stickyTireForwardTargetSpeed);
-						stickyTireForwardTargetSpeed += hitActorVelocity.dot(tireLongDir);
-
-						//Store the sticky tire data (having local copies avoids lhs). 
-						newLowForwardSpeedTimers[i] = newLowForwardSpeedTimer;
-						stickyTireForwardActiveFlags[i]=stickyTireForwardActiveFlag;
-						stickyTireForwardTargetSpeeds[i]=stickyTireForwardTargetSpeed;
-						stickyTireForwardDirs[i]=tireLongDir;
-						stickyTireForwardCMOffsets[i]=tireForceCMOffset;
-
-						//Deactivate the long slip if sticky tire constraint is active.
-						longSlip=(!stickyTireForwardActiveFlag ? longSlip : 0.0f); 
-
-						//Store the long slip (having local copies avoids lhs). 
-						longSlips[i]=longSlip;
-					}
+		//Store the lat and long slip (having local copies avoids lhs).
+		longSlips[i]=longSlip;
+		latSlips[i]=latSlip;
 
-					PxF32 newLowSideSpeedTimer;
-					{
-						//check the accel value here
-						//Update low side speed timer.
-						newLowSideSpeedTimer=newLowSideSpeedTimers[i];
-						updateLowSideSpeedTimer(tireLatSpeed,isIntentionToAccelerate,timeStep,newLowSideSpeedTimer);
-
-						//Activate sticky tire side friction constraint if required.
-						//If sticky tire friction is active then set the lateral slip to zero because 
-						//the sticky tire constraint will take care of the lateral component of motion.
-						bool stickyTireSideActiveFlag=false;
-						PxF32 stickyTireSideTargetSpeed=0.0f;
-						activateStickyFrictionSideConstraint(tireLatSpeed,newLowForwardSpeedTimer,newLowSideSpeedTimer,isIntentionToAccelerate,stickyTireSideActiveFlag,stickyTireSideTargetSpeed);
-						stickyTireSideTargetSpeed += hitActorVelocity.dot(tireLatDir);
-
-						//Store the sticky tire data (having local copies avoids lhs). 
-						newLowSideSpeedTimers[i] = newLowSideSpeedTimer;
-						stickyTireSideActiveFlags[i]=stickyTireSideActiveFlag;
-						stickyTireSideTargetSpeeds[i]=stickyTireSideTargetSpeed;
-						stickyTireSideDirs[i]=tireLatDir;
-						stickyTireSideCMOffsets[i]=tireForceCMOffset;
-
-						//Deactivate the lat slip if sticky tire constraint is active.
-						latSlip=(!stickyTireSideActiveFlag ? latSlip : 0.0f); 
-
-						//Store the long slip (having local copies avoids lhs). 
-						latSlips[i]=latSlip;
-					}
+		//Camber angle.
+		const PxF32 camber=tireLoadData4.cambers[i];
+
+		//Compute the friction that will be experienced by the tire.
+		PxF32 friction;
+		computeTireFriction(tire,longSlip,frictionMultiplier,friction);
 
-					//Compute the various tire torques.
-					PxF32 wheelTorque=0;
-					PxF32 tireLongForceMag=0;
-					PxF32 tireLatForceMag=0;
-					PxF32 tireAlignMoment=0;
-					const PxF32 restTireLoad=gravityMagnitude*tireRestLoads[i];
-					const PxF32 recipWheelRadius=wheel.getRecipRadius();
-					tireForceCalculator.mShader(
-						tireForceCalculator.mShaderData[i],
-						friction,
-						longSlip,latSlip,camber,
-						wheelOmega,wheelRadius,recipWheelRadius,
-						restTireLoad,filteredNormalisedTireLoad,filteredTireLoad,
-						gravityMagnitude, recipGravityMagnitude,
-						wheelTorque,tireLongForceMag,tireLatForceMag,tireAlignMoment);
-
-					//Store the tire torque ((having a local copy avoids lhs).
-					tireTorques[i]=wheelTorque;
-
-					//Apply the torque to the chassis.
-					//Compute the tire force to apply to the chassis.
-					const PxVec3 tireLongForce=tireLongDir*tireLongForceMag;
-					const PxVec3 tireLatForce=tireLatDir*tireLatForceMag;
-					const PxVec3 tireForce=tireLongForce+tireLatForce;
-					//Compute the torque to apply to the chassis.
-					const PxVec3 tireTorque=tireForceCMOffset.cross(tireForce);
-					//Add all the forces/torques together.
-					chassisForce+=tireForce;
-					chassisTorque+=tireTorque;
-
-					//Graph all the data we just computed.
+		//Store the friction (having a local copy avoids lhs).
+		frictions[i]=friction;
+
+		if(filteredTireLoad*frictionMultiplier>0)
+		{
+			//Either tire forces or sticky tire friction constraint will be applied here.
+			const PxVec3 tireForceCMOffset = carChassisTrnsfm.rotate(wheelsSimData.getTireForceAppPointOffset(i));
+
+			PxF32 newLowForwardSpeedTimer;
+			{
+				//check the accel value here
+				//Update low forward speed timer.
+				const PxF32 recipWheelRadius=wheel.getRecipRadius();
+				newLowForwardSpeedTimer=newLowForwardSpeedTimers[i];
+				updateLowForwardSpeedTimer(tireLongSpeed,wheelOmega,wheelRadius,recipWheelRadius,isIntentionToAccelerate,timeStep,newLowForwardSpeedTimer);
+
+				//Activate sticky tire forward friction constraint if required.
+				//If sticky tire friction is active then set the longitudinal slip to zero because 
+				//the sticky tire constraint will take care of the longitudinal component of motion.
+				bool stickyTireForwardActiveFlag=false;
+				PxF32 stickyTireForwardTargetSpeed=0.0f;
+				activateStickyFrictionForwardConstraint(tireLongSpeed,wheelOmega,newLowForwardSpeedTimer,isIntentionToAccelerate,stickyTireForwardActiveFlag,stickyTireForwardTargetSpeed);
+				stickyTireForwardTargetSpeed += hitActorVelocity.dot(tireLongDir);
+
+				//Store the sticky tire data (having local copies avoids lhs). 
+				newLowForwardSpeedTimers[i] = newLowForwardSpeedTimer;
+				stickyTireForwardActiveFlags[i]=stickyTireForwardActiveFlag;
+				stickyTireForwardTargetSpeeds[i]=stickyTireForwardTargetSpeed;
+				stickyTireForwardDirs[i]=tireLongDir;
+				stickyTireForwardCMOffsets[i]=tireForceCMOffset;
+
+				//Deactivate the long slip if sticky tire constraint is active.
+				longSlip=(!stickyTireForwardActiveFlag ? longSlip : 0.0f); 
+
+				//Store the long slip (having local copies avoids lhs). 
+				longSlips[i]=longSlip;
+			}
+
+			PxF32 newLowSideSpeedTimer;
+			{
+				//check the accel value here
+				//Update low side speed timer.
+				newLowSideSpeedTimer=newLowSideSpeedTimers[i];
+				updateLowSideSpeedTimer(tireLatSpeed,isIntentionToAccelerate,timeStep,newLowSideSpeedTimer);
+
+				//Activate sticky tire side friction constraint if required.
+				//If sticky tire friction is active then set the lateral slip to zero because 
+				//the sticky tire constraint will take care of the lateral component of motion.
+				bool stickyTireSideActiveFlag=false;
+				PxF32 stickyTireSideTargetSpeed=0.0f;
+				activateStickyFrictionSideConstraint(tireLatSpeed,newLowForwardSpeedTimer,newLowSideSpeedTimer,isIntentionToAccelerate,stickyTireSideActiveFlag,stickyTireSideTargetSpeed);
+				stickyTireSideTargetSpeed += hitActorVelocity.dot(tireLatDir);
+
+				//Store the sticky tire data (having local copies avoids lhs). 
+				newLowSideSpeedTimers[i] = newLowSideSpeedTimer;
+				stickyTireSideActiveFlags[i]=stickyTireSideActiveFlag;
+				stickyTireSideTargetSpeeds[i]=stickyTireSideTargetSpeed;
+				stickyTireSideDirs[i]=tireLatDir;
+				stickyTireSideCMOffsets[i]=tireForceCMOffset;
+
+				//Deactivate the lat slip if sticky tire constraint is active.
+				latSlip=(!stickyTireSideActiveFlag ? latSlip : 0.0f); 
+
+				//Store the long slip (having local copies avoids lhs). 
+				latSlips[i]=latSlip;
+			}
+
+			//Compute the various tire torques.
+			PxF32 wheelTorque=0;
+			PxF32 tireLongForceMag=0;
+			PxF32 tireLatForceMag=0;
+			PxF32 tireAlignMoment=0;
+			const PxF32 restTireLoad=gravityMagnitude*tireRestLoads[i];
+			const PxF32 recipWheelRadius=wheel.getRecipRadius();
+			tireForceCalculator.mShader(
+				tireForceCalculator.mShaderData[i],
+				friction,
+				longSlip,latSlip,camber,
+				wheelOmega,wheelRadius,recipWheelRadius,
+				restTireLoad,filteredNormalisedTireLoad,filteredTireLoad,
+				gravityMagnitude, recipGravityMagnitude,
+				wheelTorque,tireLongForceMag,tireLatForceMag,tireAlignMoment);
+
+			//Store the tire torque ((having a local copy avoids lhs).
+			tireTorques[i]=wheelTorque;
+
+			//Apply the torque to the chassis.
+			//Compute the tire force to apply to the chassis.
+			const PxVec3 tireLongForce=tireLongDir*tireLongForceMag;
+			const PxVec3 tireLatForce=tireLatDir*tireLatForceMag;
+			const PxVec3 tireForce=tireLongForce+tireLatForce;
+			//Compute the torque to apply to the chassis.
+			const PxVec3 tireTorque=tireForceCMOffset.cross(tireForce);
+			//Add all the forces/torques together.
+			chassisForce+=tireForce;
+			chassisTorque+=tireTorque;
+
+			//Graph all the data we just computed.
 #if PX_DEBUG_VEHICLE_ON
-					if(gCarTireForceAppPoints)
-						gCarTireForceAppPoints[i]=carChassisTrnsfm.p + tireForceCMOffset;
-					if(gCarSuspForceAppPoints)
-						gCarSuspForceAppPoints[i]=carChassisTrnsfm.p + suspForceCMOffset;
+			if(gCarTireForceAppPoints)
+				gCarTireForceAppPoints[i]=carChassisTrnsfm.p + tireForceCMOffset;
+			if(gCarSuspForceAppPoints)
+				gCarSuspForceAppPoints[i]=carChassisTrnsfm.p + suspForceCMOffset;
 
-					if(gCarWheelGraphData[0])
-					{
-						updateGraphDataNormLongTireForce(startWheelIndex, i, PxAbs(tireLongForceMag)*normalisedTireLoad/tireLoad);
-						updateGraphDataNormLatTireForce(startWheelIndex, i, PxAbs(tireLatForceMag)*normalisedTireLoad/tireLoad);
-						updateGraphDataNormTireAligningMoment(startWheelIndex, i, tireAlignMoment*normalisedTireLoad/tireLoad);
-						updateGraphDataLongTireSlip(startWheelIndex, i,longSlips[i]);
-						updateGraphDataLatTireSlip(startWheelIndex, i,latSlips[i]);
-						updateGraphDataTireFriction(startWheelIndex, i,frictions[i]);
-					}
+			if(gCarWheelGraphData[0])
+			{
+				updateGraphDataNormLongTireForce(startWheelIndex, i, PxAbs(tireLongForceMag)*normalisedTireLoad/tireLoad);
+				updateGraphDataNormLatTireForce(startWheelIndex, i, PxAbs(tireLatForceMag)*normalisedTireLoad/tireLoad);
+				updateGraphDataNormTireAligningMoment(startWheelIndex, i, tireAlignMoment*normalisedTireLoad/tireLoad);
+				updateGraphDataLongTireSlip(startWheelIndex, i,longSlips[i]);
+				updateGraphDataLatTireSlip(startWheelIndex, i,latSlips[i]);
+				updateGraphDataTireFriction(startWheelIndex, i,frictions[i]);
+			}
 #endif
-				}//filteredTireLoad*frictionMultiplier>0
-			}//if(dx > -susp.mMaxCompression)
-		}//if(numHits>0)
+		}//filteredTireLoad*frictionMultiplier>0
 	}//i
 }
 
@@ -3641,6 +3742,37 @@ void updateCachedHitData
 		wheels4DynData->mHasCachedRaycastHitPlane = true;
 	}
 
+	//The cached hits share their memory with the suspension lines of the scene queries so 
+	//record the suspension lines and the static hits of fresh raycasts before writing the cached hits.
+	//Cached hits that are reused keep the suspension lines and static hits of the raycasts they came from.
+	bool hasFreshQuery = false;
+	PxVec3 queryStarts[4];
+	PxVec3 queryEnds[4];
+	PxU16 staticHits[4]={0,0,0,0};
+	if(wheels4DynData->mRaycastResults)
+	{
+		const PxVehicleWheels4DynData::SuspLineRaycast& raycast = 
+			reinterpret_cast<const PxVehicleWheels4DynData::SuspLineRaycast&>(wheels4DynData->mQueryOrCachedHitResults);
+		for(PxU32 i=0;i<4;i++)
+		{
+			//A hit count can only be non-zero if the ith wheel issued a raycast.
+			const PxRigidActor* hitActor = cachedHitCounts[i] ? wheels4DynData->mRaycastResults[i].block.actor : NULL;
+			staticHits[i] = PxU16((0 == cachedQueryTypes[i] && hitActor && hitActor->is<PxRigidStatic>()) ? 1 : 0);
+			queryStarts[i] = staticHits[i] ? raycast.mStarts[i] : PxVec3(0,0,0);
+			queryEnds[i] = staticHits[i] ? raycast.mStarts[i] + raycast.mDirs[i]*raycast.mLengths[i] : PxVec3(0,0,0);
+		}
+		hasFreshQuery = true;
+	}
+	else if(wheels4DynData->mSweepResults)
+	{
+		for(PxU32 i=0;i<4;i++)
+		{
+			queryStarts[i] = PxVec3(0,0,0);
+			queryEnds[i] = PxVec3(0,0,0);
+		}
+		hasFreshQuery = true;
+	}
+
 	PxVehicleWheels4DynData::CachedSuspLineSceneQuerytHitResult* cachedRaycastHitResults = 
 		reinterpret_cast<PxVehicleWheels4DynData::CachedSuspLineSceneQuerytHitResult*>(wheels4DynData->mQueryOrCachedHitResults);
 
@@ -3653,6 +3785,18 @@ void updateCachedHitData
 		cachedRaycastHitResults->mFrictionMultipliers[i]=cachedFrictionMultipliers[i];
 		cachedRaycastHitResults->mQueryTypes[i] = cachedQueryTypes[i];
 	}
+
+	if(hasFreshQuery)
+	{
+		for(PxU32 i=0;i<4;i++)
+		{
+			cachedRaycastHitResults->mQueryStarts[i] = queryStarts[i];
+			cachedRaycastHitResults->mQueryEnds[i] = queryEnds[i];
+			cachedRaycastHitResults->mStaticHits[i] = staticHits[i];
+		}
+	}
+
+	wheels4DynData->mHasCachedHitResults = true;
 }
 
 
@@ -4034,6 +4178,96 @@ void solveDriveNWInternalDynamicsEnginePlusDrivenWheels
 	driveDynData->setEngineRotationSpeed(result[numActiveWheels]);
 }
 
+//PxVehicleSimulationTier::eSIMPLIFIED_DRIVETRAIN replaces the coupled solve of engine and wheels with a rigid clutch.
+//All driven wheels (non-zero diff torque ratio) spin at a single lumped speed wL and the engine at G*wL.
+//The lumped body has moi I = Ieng*G*G + sum(Ii) and angular momentum L = Ieng*G*wEng + sum(Ii*wi), 
+//which is conserved when the body is formed, and is integrated implicitly:
+//wL(t+dt) = [L + dt*(G*engineDriveTorque + sum(bt(i) + tt(i)))]/[I + dt*(G*G*engineDamping + sum(dampingi))]
+//Undriven wheels are integrated on their own.  In neutral or with the clutch disengaged the engine is integrated on its own too.
+void solveLumpedDrivetrain
+(const ImplicitSolverInput& input, ImplicitSolverOutput* output)
+{
+	const PxF32 subTimestep = input.subTimeStep;
+	const PxF32 G = input.G;
+	const PxF32 engineDriveTorque = input.engineDriveTorque;
+	const PxF32 engineDampingRate = input.engineDampingRate;
+	const PxF32* PX_RESTRICT diffTorqueRatios = input.diffTorqueRatios;
+	const PxF32* PX_RESTRICT brakeTorques = input.brakeTorques;
+	const bool* PX_RESTRICT isBrakeApplied = input.isBrakeApplied;
+	const PxF32* PX_RESTRICT tireTorques = input.tireTorques;
+	const PxU32 numActiveWheels = input.numActiveWheels;
+	const PxVehicleWheels4SimData* PX_RESTRICT wheels4SimDatas = input.wheels4SimData;
+	const PxVehicleEngineData& engineData = input.driveSimData->getEngineData();
+
+	PxVehicleDriveDynData* driveDynData = output->driveDynData;
+	PxVehicleWheels4DynData* wheels4DynDatas = output->wheelsDynData;
+
+	const PxF32 engineOmega = driveDynData->getEngineRotationSpeed();
+
+	PxU32 numDrivenWheels = 0;
+	for(PxU32 i=0;i<numActiveWheels;i++)
+	{
+		numDrivenWheels += (diffTorqueRatios[i] > 0.0f) ? 1 : 0;
+	}
+	const bool isCoupled = (0.0f != input.K) && (0.0f != G) && (numDrivenWheels > 0);
+
+	PxF32 lumpedMOI = 0.0f;
+	PxF32 lumpedMomentum = 0.0f;
+	PxF32 lumpedTorque = 0.0f;
+	PxF32 lumpedDamping = 0.0f;
+	bool isLumpedBrakeApplied = false;
+	if(isCoupled)
+	{
+		lumpedMOI = engineData.mMOI*G*G;
+		lumpedMomentum = engineData.mMOI*G*engineOmega;
+		lumpedTorque = G*engineDriveTorque;
+		lumpedDamping = G*G*engineDampingRate;
+	}
+
+	for(PxU32 i=0;i<numActiveWheels;i++)
+	{
+		const PxVehicleWheelData& wheelData = wheels4SimDatas[i>>2].getWheelData(i&3);
+		PxF32& wheelSpeed = wheels4DynDatas[i>>2].mWheelSpeeds[i&3];
+		if(isCoupled && diffTorqueRatios[i] > 0.0f)
+		{
+			lumpedMOI += wheelData.mMOI;
+			lumpedMomentum += wheelData.mMOI*wheelSpeed;
+			lumpedTorque += brakeTorques[i] + tireTorques[i];
+			lumpedDamping += wheelData.mDampingRate;
+			isLumpedBrakeApplied = isLumpedBrakeApplied || isBrakeApplied[i];
+		}
+		else
+		{
+			//Same as integrateUndriveWheelRotationSpeeds.
+			const PxF32 dtI = subTimestep*wheelData.getRecipMOI();
+			const PxF32 newOmega = (wheelSpeed + dtI*(brakeTorques[i] + tireTorques[i]))/(1.0f + wheelData.mDampingRate*dtI);
+			wheelSpeed = (isBrakeApplied[i] && (wheelSpeed*newOmega <= 0)) ? 0.0f : newOmega;
+		}
+	}
+
+	if(isCoupled)
+	{
+		//Lock the lumped wheels if the brakes reverse them, as the full solvers do for each wheel.
+		const PxF32 oldLumpedOmega = lumpedMomentum/lumpedMOI;
+		PxF32 newLumpedOmega = (lumpedMomentum + subTimestep*lumpedTorque)/(lumpedMOI + subTimestep*lumpedDamping);
+		newLumpedOmega = (isLumpedBrakeApplied && (oldLumpedOmega*newLumpedOmega <= 0)) ? 0.0f : newLumpedOmega;
+
+		for(PxU32 i=0;i<numActiveWheels;i++)
+		{
+			if(diffTorqueRatios[i] > 0.0f)
+			{
+				wheels4DynDatas[i>>2].mWheelSpeeds[i&3] = newLumpedOmega;
+			}
+		}
+		driveDynData->setEngineRotationSpeed(PxClamp(G*newLumpedOmega, 0.0f, engineData.mMaxOmega));
+	}
+	else
+	{
+		const PxF32 dtI = subTimestep*engineData.getRecipMOI();
+		const PxF32 newEngineOmega = (engineOmega + dtI*engineDriveTorque)/(1.0f + dtI*engineDampingRate);
+		driveDynData->setEngineRotationSpeed(PxClamp(newEngineOmega, 0.0f, engineData.mMaxOmega));
+	}
+}
 
 void solveTankInternaDynamicsEnginePlusDrivenWheels
 (const ImplicitSolverInput& input, const bool* PX_RESTRICT activeWheelStates, const PxF32* PX_RESTRICT wheelGearings, ImplicitSolverOutput* output)
@@ -4596,6 +4830,11 @@ public:
 		const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults,
 		const bool* vehiclesToRaycast);
 
+	static void suspensionHeightFieldRaycasts(
+		PxRigidActor* heightFieldActor, PxShape* heightFieldShape,
+		const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults,
+		const bool* vehiclesToRaycast);
+
 	static void suspensionSweeps(
 		PxBatchQuery* batchQuery, 
 		const PxU32 numVehicles, PxVehicleWheels** vehicles, 
@@ -4627,6 +4866,13 @@ public:
 		const PxVehicleDrivableSurfaceToTireFrictionPairs& drivableSurfaceToTireFrictionPairs,
 		PxVehicleNoDrive* vehDriveTank, PxVehicleWheelQueryResult* vehWheelQueryResults, PxVehicleConcurrentUpdateData* vehConcurrentUpdates);
 
+	static void updateRigidBodyTier(
+		const PxF32 timestep, 
+		PxVehicleWheels* vehWheels, PxVehicleWheelQueryResult* vehWheelQueryResults, PxVehicleConcurrentUpdateData* vehConcurrentUpdates);
+
+	static void recordTelemetry(
+		PxVehicleTelemetryRecorder& recorder, const PxVehicleWheels* vehWheels, const PxVehicleWheelQueryResult* vehWheelQueryResults);
+
 	static PxU32 computeNumberOfSubsteps(const PxVehicleWheelsSimData& wheelsSimData, const PxVec3& linVel, const PxTransform& globalPose, const PxVec3& forward)
 	{
 		const PxVec3 z=globalPose.q.rotate(forward);
@@ -4977,13 +5223,16 @@ PxVehicleDrive4W* vehDrive4W, PxVehicleWheelQueryResult* vehWheelQueryResults, P
 	}
 
 	//Update the auto-box and decide whether to change gear up or down.
+	//The simplified drivetrain holds the current gear.
+	const bool isFullDrivetrain = (PxVehicleSimulationTier::eFULL == vehDrive4W->mSimulationTier);
 	PxF32 autoboxCompensatedAnalogAccel = driveDynData.mControlAnalogVals[PxVehicleDrive4WControl::eANALOG_INPUT_ACCEL];
-	if(driveDynData.getUseAutoGears())
+	if(isFullDrivetrain && driveDynData.getUseAutoGears())
 	{
 		autoboxCompensatedAnalogAccel = processAutoBox(PxVehicleDrive4WControl::eANALOG_INPUT_ACCEL,timestep,driveSimData,driveDynData);
 	}
 
 	//Process gear-up/gear-down commands.
+	if(isFullDrivetrain)
 	{
 		const PxVehicleGearsData& gearsData=driveSimData.getGearsData();
 		processGears(timestep,gearsData,driveDynData);
@@ -5198,7 +5447,14 @@ PxVehicleDrive4W* vehDrive4W, PxVehicleWheelQueryResult* vehWheelQueryResults, P
 			{
 				&wheels4DynData, &driveDynData
 			};
-			solveDrive4WInternaDynamicsEnginePlusDrivenWheels(implicitSolverInput, &implicitSolverOutput);
+			if(isFullDrivetrain)
+			{
+				solveDrive4WInternaDynamicsEnginePlusDrivenWheels(implicitSolverInput, &implicitSolverOutput);
+			}
+			else
+			{
+				solveLumpedDrivetrain(implicitSolverInput, &implicitSolverOutput);
+			}
 
 			END_TIMER(TIMER_INTERNAL_DYNAMICS_SOLVER);
 			START_TIMER(TIMER_POSTUPDATE1);
@@ -5560,13 +5816,16 @@ void PxVehicleUpdate::updateDriveNW
 	}
 
 	//Update the auto-box and decide whether to change gear up or down.
+	//The simplified drivetrain holds the current gear.
+	const bool isFullDrivetrain = (PxVehicleSimulationTier::eFULL == vehDriveNW->mSimulationTier);
 	PxF32 autoboxCompensatedAnalogAccel = driveDynData.mControlAnalogVals[PxVehicleDriveNWControl::eANALOG_INPUT_ACCEL];
-	if(driveDynData.getUseAutoGears())
+	if(isFullDrivetrain && driveDynData.getUseAutoGears())
 	{
 		autoboxCompensatedAnalogAccel = processAutoBox(PxVehicleDriveNWControl::eANALOG_INPUT_ACCEL,timestep,driveSimData,driveDynData);
 	}
 
 	//Process gear-up/gear-down commands.
+	if(isFullDrivetrain)
 	{
 		const PxVehicleGearsData& gearsData=driveSimData.getGearsData();
 		processGears(timestep,gearsData,driveDynData);
@@ -5786,7 +6045,14 @@ void PxVehicleUpdate::updateDriveNW
 		{
 			wheels4DynDatas, &driveDynData
 		};
-		solveDriveNWInternalDynamicsEnginePlusDrivenWheels(implicitSolverInput, &implicitSolverOutput);
+		if(isFullDrivetrain)
+		{
+			solveDriveNWInternalDynamicsEnginePlusDrivenWheels(implicitSolverInput, &implicitSolverOutput);
+		}
+		else
+		{
+			solveLumpedDrivetrain(implicitSolverInput, &implicitSolverOutput);
+		}
 
 		END_TIMER(TIMER_INTERNAL_DYNAMICS_SOLVER);
 		START_TIMER(TIMER_POSTUPDATE1);
@@ -6113,12 +6379,15 @@ void PxVehicleUpdate::updateTank
 	{
 		useAutoGears = driveDynData.getUseAutoGears() ? (thrustRight*brakeLeft>0 || thrustLeft*brakeRight>0 ? false : true) : false; 
 	}
-	if(useAutoGears)
+	//The simplified drivetrain holds the current gear.
+	const bool isFullDrivetrain = (PxVehicleSimulationTier::eFULL == vehDriveTank->mSimulationTier);
+	if(isFullDrivetrain && useAutoGears)
 	{
 		processAutoBox(PxVehicleDriveTankControl::eANALOG_INPUT_ACCEL,timestep,driveSimData,driveDynData);
 	}
 
 	//Process gear-up/gear-down commands.
+	if(isFullDrivetrain)
 	{
 		const PxVehicleGearsData& gearsData=driveSimData.getGearsData();
 		processGears(timestep,gearsData,driveDynData);
@@ -6730,37 +6999,327 @@ void PxVehicleUpdate::updateNoDrive
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////
+//PxVehicleSimulationTier::eRIGID_BODY leaves the actor to the rigid body solver.
+//No suspension or tire forces are computed, the wheels roll with the ground speed under them 
+//and the engine follows the wheels through the current gear so that the vehicle can go back 
+//to a higher tier without a jump in wheel or engine speeds.
+////////////////////////////////////////////////////////////////////////////
 
-void PxVehicleUpdate::shiftOrigin(const PxVec3& shift, const PxU32 numVehicles, PxVehicleWheels** vehicles)
+void PxVehicleUpdate::updateRigidBodyTier
+(const PxF32 timestep, 
+ PxVehicleWheels* vehWheels, PxVehicleWheelQueryResult* vehWheelQueryResults, PxVehicleConcurrentUpdateData* vehConcurrentUpdates)
 {
-	for(PxU32 i=0; i < numVehicles; i++)
-	{
-		//Get the current car.
-		PxVehicleWheels& veh = *vehicles[i];
-		PxVehicleWheels4DynData* PX_RESTRICT wheels4DynData=veh.mWheelsDynData.mWheels4DynData;
-		const PxU32 numWheels4=veh.mWheelsSimData.mNbWheels4;
+	PX_SIMD_GUARD; //denorm exception on newRotAngle=wheelRotationAngles[j]+wheelOmega*timestep; on osx
 
-		//Blocks of 4 wheels.
-		for(PxU32 j=0; j < numWheels4; j++)
-		{
-			bool activeWheelStates[4]={false,false,false,false};
-			computeWheelActiveStates(4*j, veh.mWheelsSimData.mActiveWheelsBitmapBuffer, activeWheelStates);
+	PX_CHECK_AND_RETURN(
+		NULL==vehWheelQueryResults || vehWheelQueryResults->nbWheelQueryResults >= vehWheels->mWheelsSimData.getNbWheels(), 
+		"nbWheelQueryResults must always be greater than or equal to number of wheels in corresponding vehicle");
+	PX_CHECK_AND_RETURN(
+		NULL==vehConcurrentUpdates || vehConcurrentUpdates->nbConcurrentWheelUpdates >= vehWheels->mWheelsSimData.getNbWheels(), 
+		"vehConcurrentUpdates->nbConcurrentWheelUpdates must always be greater than or equal to number of wheels in corresponding vehicle");
 
-			if (wheels4DynData[j].mRaycastResults)  // this is set when a query has been scheduled
-			{
-				PxVehicleWheels4DynData::SuspLineRaycast& raycast = 
-					reinterpret_cast<PxVehicleWheels4DynData::SuspLineRaycast&>(wheels4DynData[j].mQueryOrCachedHitResults);
-				
-				for(PxU32 k=0; k < 4; k++)
-				{
-					if (activeWheelStates[k])
-					{
-						raycast.mStarts[k] -= shift;
+	const PxVehicleWheels4SimData* wheels4SimDatas=vehWheels->mWheelsSimData.mWheels4SimData;
+	PxVehicleWheels4DynData* wheels4DynDatas=vehWheels->mWheelsDynData.mWheels4DynData;
+	const PxU32 numWheels4=vehWheels->mWheelsSimData.mNbWheels4;
+	const PxU32 numActiveWheels=vehWheels->mWheelsSimData.mNbActiveWheels;
+	const PxU32 numActiveWheelsInLast4=4-(4*numWheels4 - numActiveWheels);
+	PxRigidDynamic* vehActor=vehWheels->mActor;
+	const bool isKinematic = (vehActor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC);
 
-						if (wheels4DynData[j].mRaycastResults[k].hasBlock)
-							const_cast<PxVec3&>(wheels4DynData[j].mRaycastResults[k].block.position) -= shift;
-					}
-				}
+	//The engine and gears of the drive types.
+	PxVehicleDriveDynData* driveDynData = NULL;
+	const PxVehicleDriveSimData* driveSimData = NULL;
+	switch(vehWheels->mType)
+	{
+	case PxVehicleTypes::eDRIVE4W:
+		driveDynData = &static_cast<PxVehicleDrive4W*>(vehWheels)->mDriveDynData;
+		driveSimData = &static_cast<PxVehicleDrive4W*>(vehWheels)->mDriveSimData;
+		break;
+	case PxVehicleTypes::eDRIVENW:
+		driveDynData = &static_cast<PxVehicleDriveNW*>(vehWheels)->mDriveDynData;
+		driveSimData = &static_cast<PxVehicleDriveNW*>(vehWheels)->mDriveSimData;
+		break;
+	case PxVehicleTypes::eDRIVETANK:
+		driveDynData = &static_cast<PxVehicleDriveTank*>(vehWheels)->mDriveDynData;
+		driveSimData = &static_cast<PxVehicleDriveTank*>(vehWheels)->mDriveSimData;
+		break;
+	default:
+		break;
+	}
+
+	PxVehicleWheelConcurrentUpdateData wheelConcurrentUpdates[PX_MAX_NB_WHEELS];
+	PxVehicleConcurrentUpdateData vehicleConcurrentUpdates;
+	vehicleConcurrentUpdates.nbConcurrentWheelUpdates = numActiveWheels;
+	vehicleConcurrentUpdates.concurrentWheelUpdates = wheelConcurrentUpdates;
+
+	//A sleeping actor stays asleep whatever the driving inputs.
+	if(!isKinematic && vehActor->isSleeping())
+	{
+		setInternalDynamicsToZero(vehWheels->mWheelsDynData);
+		if(driveDynData) setInternalDynamicsToZero(*driveDynData);
+		if(vehConcurrentUpdates) vehConcurrentUpdates->staySleeping = true;
+		return;
+	}
+
+	PxU32 numActiveWheelsPerBlock4[PX_MAX_NB_SUSPWHEELTIRE4]={0,0,0,0,0};
+	numActiveWheelsPerBlock4[0]=PxMin(numActiveWheels,PxU32(4));
+	for(PxU32 i=1;i<numWheels4-1;i++)
+	{
+		numActiveWheelsPerBlock4[i]=4;
+	}
+	numActiveWheelsPerBlock4[numWheels4-1]=numActiveWheelsInLast4;
+
+	//Switch off the suspension limits and sticky tire constraints left active by the last full update.
+	for(PxU32 i=0;i<numWheels4;i++)
+	{
+		PxVehicleConstraintShader::VehicleConstraintData& constraintData=wheels4DynDatas[i].mVehicleConstraints->mData;
+		for(PxU32 j=0;j<4;j++)
+		{
+			constraintData.mSuspLimitData.mActiveFlags[j]=false;
+			constraintData.mStickyTireForwardData.mActiveFlags[j]=false;
+			constraintData.mStickyTireSideData.mActiveFlags[j]=false;
+		}
+		wheels4DynDatas[i].getVehicletConstraintShader().mConstraint->markDirty();
+	}
+
+	PxTransform carChassisCMLocalPose = vehActor->getCMassLocalPose();
+	carChassisCMLocalPose.q = PxQuat(PxIdentity);
+	const PxTransform carChassisTransform = vehActor->getGlobalPose().transform(carChassisCMLocalPose);
+	const PxVec3 carChassisLinVel = vehActor->getLinearVelocity();
+	const PxVec3 carChassisAngVel = vehActor->getAngularVelocity();
+	const PxVec3 forward = carChassisTransform.q.rotate(gForward);
+
+	//Roll the wheels and put them at rest on the ground.
+	PxWheelQueryResult wheelQueryResults[PX_MAX_NB_WHEELS];
+	PxF32 sumWheelSpeeds = 0.0f;
+	PxU32 numEnabledWheels = 0;
+	for(PxU32 i=0;i<numActiveWheels;i++)
+	{
+		const PxVehicleWheelData& wheelData = wheels4SimDatas[i>>2].getWheelData(i&3);
+		PxVehicleWheels4DynData& wheels4DynData = wheels4DynDatas[i>>2];
+		const PxU32 j = i&3;
+
+		PxF32 wheelOmega = 0.0f;
+		if(!vehWheels->mWheelsSimData.getIsWheelDisabled(i))
+		{
+			const PxVec3 r = carChassisTransform.q.rotate(wheels4SimDatas[i>>2].getWheelCentreOffset(j));
+			const PxVec3 wheelVel = carChassisLinVel + carChassisAngVel.cross(r);
+			wheelOmega = wheelVel.dot(forward)*wheelData.getRecipRadius();
+			sumWheelSpeeds += wheelOmega;
+			numEnabledWheels++;
+		}
+
+		PxF32 newRotAngle=wheels4DynData.mWheelRotationAngles[j]+wheelOmega*timestep;
+		//Clamp the wheel rotation angle to a range (-10*pi,10*pi) to stop it getting crazily big.
+		newRotAngle=physx::intrinsics::fsel(newRotAngle-10*PxPi, newRotAngle-10*PxPi, physx::intrinsics::fsel(-newRotAngle-10*PxPi, newRotAngle + 10*PxPi, newRotAngle));
+		wheels4DynData.mWheelRotationAngles[j]=newRotAngle;
+		wheels4DynData.mWheelSpeeds[j]=wheelOmega;
+		wheels4DynData.mCorrectedWheelSpeeds[j]=wheelOmega;
+
+		//Ensure that the jounce speed is zero and the low speed timers restart when the vehicle goes back to a higher tier.
+		wheels4DynData.mJounces[j]=PX_MAX_F32;
+		wheels4DynData.mTireLowForwardSpeedTimers[j]=0.0f;
+		wheels4DynData.mTireLowSideSpeedTimers[j]=0.0f;
+
+		wheelQueryResults[i].suspJounce=0.0f;
+		wheelQueryResults[i].steerAngle=wheelData.mToeAngle;
+		wheelQueryResults[i].isInAir=false;
+	}
+
+	//The engine turns with the wheels unless the gears are in neutral.
+	if(driveDynData && numEnabledWheels > 0)
+	{
+		const PxU32 currentGear=driveDynData->getCurrentGear();
+		const PxF32 G=computeGearRatio(driveSimData->getGearsData(),currentGear);
+		if(0.0f != G)
+		{
+			const PxF32 aveWheelSpeed = sumWheelSpeeds/PxF32(numEnabledWheels);
+			driveDynData->setEngineRotationSpeed(PxClamp(PxAbs(G*aveWheelSpeed), 0.0f, driveSimData->getEngineData().mMaxOmega));
+		}
+	}
+
+	//Leave the momentum of the actor unchanged.
+	if(!gApplyForces)
+	{
+		vehicleConcurrentUpdates.linearMomentumChange = carChassisLinVel;
+		vehicleConcurrentUpdates.angularMomentumChange = carChassisAngVel;
+	}
+	else
+	{
+		vehicleConcurrentUpdates.linearMomentumChange = PxVec3(0,0,0);
+		vehicleConcurrentUpdates.angularMomentumChange = PxVec3(0,0,0);
+	}
+
+	//Compute and pose the wheels from the rest jounces, rotations angles and toe angles.
+	for(PxU32 i=0;i<numWheels4;i++)
+	{
+		PxTransform localPoses[4] = {PxTransform(PxIdentity), PxTransform(PxIdentity), PxTransform(PxIdentity), PxTransform(PxIdentity)};
+		computeWheelLocalPoses(wheels4SimDatas[i],wheels4DynDatas[i],&wheelQueryResults[4*i],numActiveWheelsPerBlock4[i],carChassisCMLocalPose,localPoses);
+		for(PxU32 j=0;j<numActiveWheelsPerBlock4[i];j++)
+		{
+			wheelQueryResults[4*i + j].localPose = localPoses[j];
+			vehicleConcurrentUpdates.concurrentWheelUpdates[4*i + j].localPose = localPoses[j];
+		}
+	}
+
+	if(vehWheelQueryResults && vehWheelQueryResults->wheelQueryResults)
+	{
+		PxMemCopy(vehWheelQueryResults->wheelQueryResults, wheelQueryResults, sizeof(PxWheelQueryResult)*numActiveWheels);
+	}
+
+	if(vehConcurrentUpdates)
+	{
+		//Copy across to input data structure so that writes can be applied later.
+		PxMemCopy(vehConcurrentUpdates->concurrentWheelUpdates, vehicleConcurrentUpdates.concurrentWheelUpdates, sizeof(PxVehicleWheelConcurrentUpdateData)*numActiveWheels);
+		vehConcurrentUpdates->linearMomentumChange = vehicleConcurrentUpdates.linearMomentumChange;
+		vehConcurrentUpdates->angularMomentumChange = vehicleConcurrentUpdates.angularMomentumChange;
+		vehConcurrentUpdates->staySleeping = vehicleConcurrentUpdates.staySleeping;
+		vehConcurrentUpdates->wakeup = vehicleConcurrentUpdates.wakeup;
+	}
+	else
+	{
+		//Apply the writes immediately.
+		PxVehicleWheels* vehWheelsToPost[1]={vehWheels};
+		PxVehiclePostUpdates(&vehicleConcurrentUpdates, 1, vehWheelsToPost);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+//Store the state of a vehicle after its update in the recorder set with PxVehicleSetTelemetryRecorder.
+//Only a binary search and a few copies are done here, the recording is formatted by the reader.
+////////////////////////////////////////////////////////////////////////////
+
+void PxVehicleUpdate::recordTelemetry
+(PxVehicleTelemetryRecorder& recorder, const PxVehicleWheels* vehWheels, const PxVehicleWheelQueryResult* vehWheelQueryResults)
+{
+	//Find the vehicle.
+	PxU32 first = 0;
+	PxU32 last = recorder.mNbVehicles;
+	while(first < last)
+	{
+		const PxU32 mid = (first + last) >> 1;
+		if(recorder.mVehicles[mid] < vehWheels)
+		{
+			first = mid + 1;
+		}
+		else
+		{
+			last = mid;
+		}
+	}
+	if(first == recorder.mNbVehicles || recorder.mVehicles[first] != vehWheels)
+	{
+		return;
+	}
+	const PxU16 vehicleId = recorder.mVehicleIds[first];
+
+	const PxU32 numActiveWheels = vehWheels->mWheelsSimData.mNbActiveWheels;
+	const PxWheelQueryResult* wheelQueryResults = 
+		(vehWheelQueryResults && vehWheelQueryResults->wheelQueryResults) ? vehWheelQueryResults->wheelQueryResults : NULL;
+	const PxVehicleDriveDynData* driveDynData = 
+		(PxVehicleTypes::eNODRIVE != vehWheels->mType) ? &static_cast<const PxVehicleDrive*>(vehWheels)->mDriveDynData : NULL;
+
+	//Reserve one entry for the vehicle and one for each wheel.
+	const PxU32 nbEntries = 1 + numActiveWheels;
+	const PxU32 firstEntry = PxU32(Ps::atomicAdd(&recorder.mWriteCount, PxI32(nbEntries))) - nbEntries;
+	const PxU32 mask = recorder.mNbEntries - 1;
+
+	for(PxU32 i = 0; i < nbEntries; i++)
+	{
+		const PxU32 sequence = firstEntry + i;
+		PxVehicleTelemetryEntry& entry = recorder.mEntries[sequence & mask];
+		entry.sequence = 0;
+		Ps::memoryBarrier();
+
+		entry.frame = recorder.mFrame;
+		entry.vehicleId = vehicleId;
+		if(0 == i)
+		{
+			entry.flags = Ps::to8(vehWheels->mActor->isSleeping() ? PxVehicleTelemetryEntry::eSLEEPING : 0);
+			entry.index = Ps::to8(numActiveWheels);
+			entry.vehicle.engineRotationSpeed = driveDynData ? driveDynData->getEngineRotationSpeed() : 0.0f;
+			entry.vehicle.forwardSpeed = vehWheels->computeForwardSpeed();
+			entry.vehicle.sidewaysSpeed = vehWheels->computeSidewaysSpeed();
+			entry.vehicle.currentGear = driveDynData ? driveDynData->getCurrentGear() : 0;
+			entry.vehicle.simulationTier = vehWheels->mSimulationTier;
+		}
+		else
+		{
+			const PxU32 wheel = i - 1;
+			const PxVehicleWheels4DynData& wheels4DynData = vehWheels->mWheelsDynData.mWheels4DynData[wheel>>2];
+			PxU8 flags = PxVehicleTelemetryEntry::eWHEEL;
+			entry.index = Ps::to8(wheel);
+			entry.wheel.rotationSpeed = wheels4DynData.mWheelSpeeds[wheel&3];
+			if(wheelQueryResults)
+			{
+				const PxWheelQueryResult& wheelQueryResult = wheelQueryResults[wheel];
+				flags |= PxVehicleTelemetryEntry::eHAS_TIRE_DATA;
+				flags |= wheelQueryResult.isInAir ? PxVehicleTelemetryEntry::eIN_AIR : 0;
+				entry.wheel.suspJounce = wheelQueryResult.suspJounce;
+				entry.wheel.tireFriction = wheelQueryResult.tireFriction;
+				entry.wheel.longitudinalSlip = wheelQueryResult.longitudinalSlip;
+				entry.wheel.lateralSlip = wheelQueryResult.lateralSlip;
+			}
+			else
+			{
+				const PxF32 jounce = wheels4DynData.mJounces[wheel&3];
+				entry.wheel.suspJounce = (PX_MAX_F32 != jounce) ? jounce : 0.0f;
+				entry.wheel.tireFriction = 0.0f;
+				entry.wheel.longitudinalSlip = 0.0f;
+				entry.wheel.lateralSlip = 0.0f;
+			}
+			entry.flags = flags;
+		}
+
+		Ps::memoryBarrier();
+		entry.sequence = sequence + 1;
+	}
+}
+
+void PxVehicleUpdate::shiftOrigin(const PxVec3& shift, const PxU32 numVehicles, PxVehicleWheels** vehicles)
+{
+	for(PxU32 i=0; i < numVehicles; i++)
+	{
+		//Get the current car.
+		PxVehicleWheels& veh = *vehicles[i];
+		PxVehicleWheels4DynData* PX_RESTRICT wheels4DynData=veh.mWheelsDynData.mWheels4DynData;
+		const PxU32 numWheels4=veh.mWheelsSimData.mNbWheels4;
+
+		//Blocks of 4 wheels.
+		for(PxU32 j=0; j < numWheels4; j++)
+		{
+			bool activeWheelStates[4]={false,false,false,false};
+			computeWheelActiveStates(4*j, veh.mWheelsSimData.mActiveWheelsBitmapBuffer, activeWheelStates);
+
+			if (wheels4DynData[j].mHasCachedHitResults)  // the query results have been consumed by an update
+			{
+				PxVehicleWheels4DynData::CachedSuspLineSceneQuerytHitResult& cachedHitResult = 
+					reinterpret_cast<PxVehicleWheels4DynData::CachedSuspLineSceneQuerytHitResult&>(wheels4DynData[j].mQueryOrCachedHitResults);
+
+				for(PxU32 k=0; k < 4; k++)
+				{
+					PxVec4& plane = cachedHitResult.mPlanes[k];
+					plane.w += PxVec3(plane.x, plane.y, plane.z).dot(shift);
+					cachedHitResult.mQueryStarts[k] -= shift;
+					cachedHitResult.mQueryEnds[k] -= shift;
+				}
+			}
+			else if (wheels4DynData[j].mRaycastResults)  // this is set when a query has been scheduled
+			{
+				PxVehicleWheels4DynData::SuspLineRaycast& raycast = 
+					reinterpret_cast<PxVehicleWheels4DynData::SuspLineRaycast&>(wheels4DynData[j].mQueryOrCachedHitResults);
+				
+				for(PxU32 k=0; k < 4; k++)
+				{
+					if (activeWheelStates[k])
+					{
+						raycast.mStarts[k] -= shift;
+
+						if (wheels4DynData[j].mRaycastResults[k].hasBlock)
+							const_cast<PxVec3&>(wheels4DynData[j].mRaycastResults[k].block.position) -= shift;
+					}
+				}
 			}
 			else if(wheels4DynData[i].mSweepResults)
 			{
@@ -6806,7 +7365,8 @@ void PxVehicleUpdate::updateSingleVehicleAndStoreTelemetryData
 #if PX_CHECKED
 	for(PxU32 i=0;i<vehWheels->mWheelsSimData.mNbWheels4;i++)
 	{
-		PX_CHECK_MSG(vehWheels->mWheelsDynData.mWheels4DynData[i].mRaycastResults || vehWheels->mWheelsDynData.mWheels4DynData[i].mSweepResults,
+		PX_CHECK_MSG(vehWheels->mWheelsDynData.mWheels4DynData[i].mRaycastResults || vehWheels->mWheelsDynData.mWheels4DynData[i].mSweepResults ||
+			vehWheels->mWheelsDynData.mWheels4DynData[i].mHasCachedRaycastHitPlane,
 			"Need to call PxVehicleSuspensionRaycasts or PxVehicleSuspensionSweeps before trying to update");
 	}
 	for(PxU32 i=0;i<vehWheels->mWheelsSimData.mNbActiveWheels;i++)
@@ -6934,6 +7494,11 @@ void PxVehicleUpdate::updateSingleVehicleAndStoreTelemetryData
 		break;
 	}
 
+	if(gTelemetryRecorder)
+	{
+		PxVehicleUpdate::recordTelemetry(*gTelemetryRecorder, vehWheels, vehWheelQueryResults);
+	}
+
 	END_TIMER(TIMER_ALL);
 
 #if PX_VEHICLE_PROFILE 
@@ -6999,7 +7564,7 @@ void PxVehicleUpdate::update
 	for(PxU32 i=0;i<numVehicles;i++)
 	{
 		const PxVehicleWheels* const vehWheels=vehicles[i];
-		for(PxU32 j=0;j<vehWheels->mWheelsSimData.mNbWheels4;j++)
+		for(PxU32 j=0;j<vehWheels->mWheelsSimData.mNbWheels4 && PxVehicleSimulationTier::eRIGID_BODY!=vehWheels->mSimulationTier;j++)
 		{
 			PX_CHECK_MSG(
 				vehWheels->mWheelsDynData.mWheels4DynData[j].mRaycastResults || 
@@ -7059,6 +7624,15 @@ void PxVehicleUpdate::update
 		PxVehicleWheels* vehWheels=vehicles[i];
 		PxVehicleWheelQueryResult* vehWheelQueryResults = vehicleWheelQueryResults ? &vehicleWheelQueryResults[i] : NULL;
 		PxVehicleConcurrentUpdateData* vehConcurrentUpdateData = vehicleConcurrentUpdates ? &vehicleConcurrentUpdates[i] : NULL;
+		if(PxVehicleSimulationTier::eRIGID_BODY == vehWheels->mSimulationTier)
+		{
+			PxVehicleUpdate::updateRigidBodyTier(timestep, vehWheels, vehWheelQueryResults, vehConcurrentUpdateData);
+			if(gTelemetryRecorder)
+			{
+				PxVehicleUpdate::recordTelemetry(*gTelemetryRecorder, vehWheels, vehWheelQueryResults);
+			}
+			continue;
+		}
 		switch(vehWheels->mType)
 		{
 		case PxVehicleTypes::eDRIVE4W:
@@ -7113,6 +7687,11 @@ void PxVehicleUpdate::update
 			PX_CHECK_MSG(false, "update - unsupported vehicle type"); 
 			break;
 		}
+
+		if(gTelemetryRecorder)
+		{
+			PxVehicleUpdate::recordTelemetry(*gTelemetryRecorder, vehWheels, vehWheelQueryResults);
+		}
 	}
 }
 
@@ -7162,15 +7741,19 @@ void PxVehicleUpdate::updatePost
 			}
 
 			//Apply momentum changes to vehicle's actor
-			if(!gApplyForces)
+			//Kinematic actors (only allowed with PxVehicleSimulationTier::eRIGID_BODY) are moved by the application.
+			if(!(vehActor->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
 			{
-				vehActor->setLinearVelocity(vehicleConcurrentUpdate.linearMomentumChange, false);
-				vehActor->setAngularVelocity(vehicleConcurrentUpdate.angularMomentumChange, false);
-			}
-			else
-			{
-				vehActor->addForce(vehicleConcurrentUpdate.linearMomentumChange, PxForceMode::eACCELERATION, false);
-				vehActor->addTorque(vehicleConcurrentUpdate.angularMomentumChange, PxForceMode::eACCELERATION, false);
+				if(!gApplyForces)
+				{
+					vehActor->setLinearVelocity(vehicleConcurrentUpdate.linearMomentumChange, false);
+					vehActor->setAngularVelocity(vehicleConcurrentUpdate.angularMomentumChange, false);
+				}
+				else
+				{
+					vehActor->addForce(vehicleConcurrentUpdate.linearMomentumChange, PxForceMode::eACCELERATION, false);
+					vehActor->addTorque(vehicleConcurrentUpdate.angularMomentumChange, PxForceMode::eACCELERATION, false);
+				}
 			}
 
 			//In each block of 4 wheels record how many wheels are active.
@@ -7235,12 +7818,173 @@ void physx::PxVehicleShiftOrigin(const PxVec3& shift, const PxU32 numVehicles, P
 	PxVehicleUpdate::shiftOrigin(shift, numVehicles, vehicles);
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+//PxVehicleUpdatesParallel runs batches of vehicles on the calling thread
+//and on helper tasks, see Cm::blockingParallelFor.
+///////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	struct VehicleUpdatesContext
+	{
+		PxF32 mTimestep;
+		PxVec3 mGravity;
+		const PxVehicleDrivableSurfaceToTireFrictionPairs* mFrictionPairs;
+		PxVehicleWheels** mVehicles;
+		PxVehicleWheelQueryResult* mWheelQueryResults;
+		PxVehicleConcurrentUpdateData* mConcurrentUpdates;
+	};
+
+	void updateVehicleBatch(void* context, PxU32 start, PxU32 nb)
+	{
+		const VehicleUpdatesContext& ctx = *reinterpret_cast<const VehicleUpdatesContext*>(context);
+		PxVehicleUpdate::update(ctx.mTimestep, ctx.mGravity, *ctx.mFrictionPairs, nb, ctx.mVehicles + start,
+			ctx.mWheelQueryResults ? ctx.mWheelQueryResults + start : NULL, ctx.mConcurrentUpdates + start);
+	}
+}
+
+void physx::PxVehicleUpdatesParallel
+(PxCpuDispatcher& dispatcher, const PxReal timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, 
+ const PxU32 numVehicles, PxVehicleWheels** vehicles, PxVehicleWheelQueryResult* vehicleWheelQueryResults, PxVehicleConcurrentUpdateData* vehicleConcurrentUpdates,
+ const PxU32 numVehiclesPerTask)
+{
+	PX_CHECK_AND_RETURN(numVehiclesPerTask>0, "PxVehicleUpdatesParallel: numVehiclesPerTask must be greater than zero");
+	PX_PROFILE_ZONE("PxVehicleUpdates::ePROFILE_UPDATES_PARALLEL",0);
+
+	const PxU32 numBatches = (numVehicles + numVehiclesPerTask - 1)/numVehiclesPerTask;
+	const PxU32 numHelpers = numBatches ? PxMin(dispatcher.getWorkerCount(), numBatches - 1) : 0;
+	if(!numHelpers)
+	{
+		//Nothing to share, the actors can be written directly.
+		PxVehicleUpdate::update(timestep, gravity, vehicleDrivableSurfaceToTireFrictionPairs, numVehicles, vehicles, vehicleWheelQueryResults, NULL);
+		return;
+	}
+
+	//Buffers for the deferred writes, unless the user provides them.
+	void* concurrentUpdatesMemory = NULL;
+	if(!vehicleConcurrentUpdates)
+	{
+		PxU32 numWheels = 0;
+		for(PxU32 i=0;i<numVehicles;i++)
+			numWheels += vehicles[i]->mWheelsSimData.getNbWheels();
+
+		concurrentUpdatesMemory = PX_ALLOC(sizeof(PxVehicleConcurrentUpdateData)*numVehicles + sizeof(PxVehicleWheelConcurrentUpdateData)*numWheels, "PxVehicleConcurrentUpdateData");
+		vehicleConcurrentUpdates = reinterpret_cast<PxVehicleConcurrentUpdateData*>(concurrentUpdatesMemory);
+		PxVehicleWheelConcurrentUpdateData* wheelUpdates = reinterpret_cast<PxVehicleWheelConcurrentUpdateData*>(vehicleConcurrentUpdates + numVehicles);
+		for(PxU32 i=0;i<numVehicles;i++)
+		{
+			const PxU32 nbWheels = vehicles[i]->mWheelsSimData.getNbWheels();
+			PX_PLACEMENT_NEW(vehicleConcurrentUpdates + i, PxVehicleConcurrentUpdateData)();
+			for(PxU32 j=0;j<nbWheels;j++)
+				PX_PLACEMENT_NEW(wheelUpdates + j, PxVehicleWheelConcurrentUpdateData)();
+			vehicleConcurrentUpdates[i].concurrentWheelUpdates = wheelUpdates;
+			vehicleConcurrentUpdates[i].nbConcurrentWheelUpdates = nbWheels;
+			wheelUpdates += nbWheels;
+		}
+	}
+
+	//Each batch is one chunk of numVehiclesPerTask vehicles.
+	VehicleUpdatesContext context;
+	context.mTimestep = timestep;
+	context.mGravity = gravity;
+	context.mFrictionPairs = &vehicleDrivableSurfaceToTireFrictionPairs;
+	context.mVehicles = vehicles;
+	context.mWheelQueryResults = vehicleWheelQueryResults;
+	context.mConcurrentUpdates = vehicleConcurrentUpdates;
+	Cm::blockingParallelFor(&dispatcher, numVehicles, numVehiclesPerTask, numVehiclesPerTask, updateVehicleBatch, &context, "PxVehicleUpdatesParallel");
+
+	PxVehicleUpdate::updatePost(vehicleConcurrentUpdates, numVehicles, vehicles);
+
+	if(concurrentUpdatesMemory)
+		PX_FREE(concurrentUpdatesMemory);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 //The following functions issue  a single batch of suspension raycasts for an array of vehicles of any type.
 //The buffer of sceneQueryResults is distributed among the vehicles in the array 
 //for use in the next PxVehicleUpdates call.
 ///////////////////////////////////////////////////////////////////////////////////
 
+PX_FORCE_INLINE PxTransform computeSuspensionRaycastChassisTransform(const PxRigidDynamic* vehActor)
+{
+	PxTransform massXform = vehActor->getCMassLocalPose();
+	massXform.q = PxQuat(PxIdentity);
+	return vehActor->getGlobalPose().transform(massXform);
+}
+
+PX_FORCE_INLINE void computeSuspensionRaycastLine
+(const PxTransform& carChassisTrnsfm, const PxVehicleWheels4SimData& wheels4SimData, const PxU32 j, const bool activeWheelState,
+ PxVec3& suspLineStart, PxVec3& suspLineDir, PxF32& suspLineLength)
+{
+	const PxVehicleSuspensionData& susp=wheels4SimData.getSuspensionData(j);
+	const PxVehicleWheelData& wheel=wheels4SimData.getWheelData(j);
+
+	const PxVec3& bodySpaceSuspTravelDir=wheels4SimData.getSuspTravelDirection(j);
+	PxVec3 bodySpaceWheelCentreOffset=wheels4SimData.getWheelCentreOffset(j);
+	PxF32 maxDroop=susp.mMaxDroop;
+	PxF32 maxBounce=susp.mMaxCompression;
+	PxF32 radius=wheel.mRadius;
+	PX_ASSERT(maxBounce>=0);
+	PX_ASSERT(maxDroop>=0);
+
+	if(!activeWheelState)
+	{
+		//For disabled wheels just issue a raycast of almost zero length.
+		//This should be very cheap and ought to hit nothing.
+		bodySpaceWheelCentreOffset=PxVec3(0,0,0);
+		maxDroop=1e-5f*gToleranceScaleLength;
+		maxBounce=1e-5f*gToleranceScaleLength;
+		radius=1e-5f*gToleranceScaleLength;
+	}
+
+	computeSuspensionRaycast(carChassisTrnsfm,bodySpaceWheelCentreOffset,bodySpaceSuspTravelDir,radius,maxBounce,suspLineStart,suspLineDir);
+
+	//Total length from top of wheel at max compression to bottom of wheel at max droop.
+	suspLineLength=radius + maxBounce  + maxDroop + radius;
+	//Add another radius on for good measure.
+	suspLineLength+=radius;
+}
+
+//Test if the cached hits of a block of 4 wheels can be used instead of new raycasts (see PxVehicleSetSuspensionRaycastReuseThreshold).
+bool canReuseSuspensionRaycastHits
+(const PxVehicleWheels4SimData& wheels4SimData, const PxVehicleWheels4DynData& wheels4DynData, 
+ const bool* activeWheelStates, const PxU32 numActiveWheels,
+ const PxRigidDynamic* vehActor)
+{
+	//The cached hits are lost as soon as new scene queries are issued.
+	if(0.0f == gSuspRaycastReuseThreshold || !wheels4DynData.mHasCachedHitResults)
+		return false;
+
+	const PxVehicleWheels4DynData::CachedSuspLineSceneQuerytHitResult& cachedHitResult = 
+		reinterpret_cast<const PxVehicleWheels4DynData::CachedSuspLineSceneQuerytHitResult&>(wheels4DynData.mQueryOrCachedHitResults);
+
+	const PxTransform carChassisTrnsfm = computeSuspensionRaycastChassisTransform(vehActor);
+	const PxF32 maxMotionSquared = gSuspRaycastReuseThreshold*gSuspRaycastReuseThreshold;
+	bool hasActiveWheel = false;
+	for(PxU32 j=0;j<numActiveWheels;j++)
+	{
+		if(!activeWheelStates[j])
+			continue;
+
+		//Only reuse raycast hits against statics, anything else might have moved since.
+		if(!cachedHitResult.mStaticHits[j] || 0 == cachedHitResult.mCounts[j] || 0 != cachedHitResult.mQueryTypes[j])
+			return false;
+
+		PxVec3 suspLineStart;
+		PxVec3 suspLineDir;
+		PxF32 suspLineLength;
+		computeSuspensionRaycastLine(carChassisTrnsfm, wheels4SimData, j, true, suspLineStart, suspLineDir, suspLineLength);
+		const PxVec3 suspLineEnd = suspLineStart + suspLineDir*suspLineLength;
+		if((suspLineStart - cachedHitResult.mQueryStarts[j]).magnitudeSquared() > maxMotionSquared ||
+		   (suspLineEnd - cachedHitResult.mQueryEnds[j]).magnitudeSquared() > maxMotionSquared)
+			return false;
+
+		hasActiveWheel = true;
+	}
+
+	return hasActiveWheel;
+}
+
 void PxVehicleWheels4SuspensionRaycasts
 (PxBatchQuery* batchQuery, 
  const PxVehicleWheels4SimData& wheels4SimData, PxVehicleWheels4DynData& wheels4DynData, 
@@ -7248,42 +7992,15 @@ void PxVehicleWheels4SuspensionRaycasts
  PxRigidDynamic* vehActor)
 {
 	//Get the transform of the chassis.
-	PxTransform massXform = vehActor->getCMassLocalPose();
-	massXform.q = PxQuat(PxIdentity);
-	PxTransform carChassisTrnsfm = vehActor->getGlobalPose().transform(massXform);
+	const PxTransform carChassisTrnsfm = computeSuspensionRaycastChassisTransform(vehActor);
 
 	//Add a raycast for each wheel.
 	for(PxU32 j=0;j<numActiveWheels;j++)
 	{
-		const PxVehicleSuspensionData& susp=wheels4SimData.getSuspensionData(j);
-		const PxVehicleWheelData& wheel=wheels4SimData.getWheelData(j);
-
-		const PxVec3& bodySpaceSuspTravelDir=wheels4SimData.getSuspTravelDirection(j);
-		PxVec3 bodySpaceWheelCentreOffset=wheels4SimData.getWheelCentreOffset(j);
-		PxF32 maxDroop=susp.mMaxDroop;
-		PxF32 maxBounce=susp.mMaxCompression;
-		PxF32 radius=wheel.mRadius;
-		PX_ASSERT(maxBounce>=0);
-		PX_ASSERT(maxDroop>=0);
-
-		if(!activeWheelStates[j])
-		{
-			//For disabled wheels just issue a raycast of almost zero length.
-			//This should be very cheap and ought to hit nothing.
-			bodySpaceWheelCentreOffset=PxVec3(0,0,0);
-			maxDroop=1e-5f*gToleranceScaleLength;
-			maxBounce=1e-5f*gToleranceScaleLength;
-			radius=1e-5f*gToleranceScaleLength;
-		}
-
 		PxVec3 suspLineStart;
 		PxVec3 suspLineDir;
-		computeSuspensionRaycast(carChassisTrnsfm,bodySpaceWheelCentreOffset,bodySpaceSuspTravelDir,radius,maxBounce,suspLineStart,suspLineDir);
-
-		//Total length from top of wheel at max compression to bottom of wheel at max droop.
-		PxF32 suspLineLength=radius + maxBounce  + maxDroop + radius;
-		//Add another radius on for good measure.
-		suspLineLength+=radius;
+		PxF32 suspLineLength;
+		computeSuspensionRaycastLine(carChassisTrnsfm, wheels4SimData, j, activeWheelStates[j], suspLineStart, suspLineDir, suspLineLength);
 
 		//Store the susp line ray for later use.
 		PxVehicleWheels4DynData::SuspLineRaycast& raycast = 
@@ -7291,6 +8008,7 @@ void PxVehicleWheels4SuspensionRaycasts
 		raycast.mStarts[j]=suspLineStart;
 		raycast.mDirs[j]=suspLineDir;
 		raycast.mLengths[j]=suspLineLength;
+		wheels4DynData.mHasCachedHitResults=false;
 
 		//Add the raycast to the scene query.
 		batchQuery->raycast(
@@ -7342,7 +8060,9 @@ void PxVehicleUpdate::suspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 n
 			wheels4DynData[j].mRaycastResults=NULL;
 			wheels4DynData[j].mSweepResults=NULL;
 
-			if(NULL==vehiclesToRaycast || vehiclesToRaycast[i])
+			//Blocks that reuse their cached hits are updated as if they weren't raycast.
+			if((NULL==vehiclesToRaycast || vehiclesToRaycast[i]) && 
+				!canReuseSuspensionRaycastHits(wheels4SimData[j],wheels4DynData[j],activeWheelStates,4,vehActor))
 			{
 				if((sceneQueryResults + numSceneQueryResults) >= (sqres+4))
 				{
@@ -7371,7 +8091,8 @@ void PxVehicleUpdate::suspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 n
 			wheels4DynData[j].mRaycastResults=NULL;
 			wheels4DynData[j].mSweepResults=NULL;
 			
-			if(NULL==vehiclesToRaycast || vehiclesToRaycast[i])
+			if((NULL==vehiclesToRaycast || vehiclesToRaycast[i]) && 
+				!canReuseSuspensionRaycastHits(wheels4SimData[j],wheels4DynData[j],activeWheelStates,numActiveWheelsInLast4,vehActor))
 			{
 				if((sceneQueryResults + numSceneQueryResults) >= (sqres+numActiveWheelsInLast4))
 				{
@@ -7401,6 +8122,288 @@ void physx::PxVehicleSuspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 nu
 	PxVehicleUpdate::suspensionRaycasts(batchQuery, numVehicles, vehicles, numSceneQueryesults, sceneQueryResults, vehiclesToRaycast);
 }
 
+////////////////////////////////////////////////////////////////////////////
+//Suspension raycasts straight against a heightfield, see PxVehicleSuspensionHeightFieldRaycasts
+////////////////////////////////////////////////////////////////////////////
+
+//Raycasts the suspension lines against a single heightfield shape, without the scene query system.
+//The ray is walked over the triangles under it in the sample space of the heightfield, and intersected 
+//with the plane of each one in turn. Suspension lines are short next to the cells, so the walk usually 
+//stops on the first or second triangle. Holes are left to PxGeometryQuery::raycast.
+class SuspensionHeightFieldRaycaster
+{
+public:
+
+	SuspensionHeightFieldRaycaster(PxRigidActor* actor, PxShape* shape, const PxHeightFieldGeometry& geometry)
+		: mActor(actor),
+		  mShape(shape),
+		  mGeometry(geometry),
+		  mHeightField(*geometry.heightField),
+		  mPose(actor->getGlobalPose()*shape->getLocalPose()),
+		  mNbRows(geometry.heightField->getNbRows()),
+		  mNbColumns(geometry.heightField->getNbColumns())
+	{
+		mRecipScale = PxVec3(1.0f/geometry.rowScale, 1.0f/geometry.heightScale, 1.0f/geometry.columnScale);
+		//Heightfields with a positive thickness face down, and negative scales flip the triangles.
+		//Both are left to the generic raycast.
+		mAnalytic = mHeightField.getThickness() < 0.0f && geometry.rowScale > 0.0f && geometry.columnScale > 0.0f;
+	}
+
+	void raycast(const PxVec3& start, const PxVec3& dir, const PxF32 length, PxRaycastQueryResult& result) const
+	{
+		result.touches = NULL;
+		result.nbTouches = 0;
+		result.userData = NULL;
+		result.queryStatus = PxBatchQueryStatus::eSUCCESS;
+		result.hasBlock = false;
+
+		if(!mAnalytic || !raycastAnalytic(start, dir, length, result.block, result.hasBlock))
+			result.hasBlock = PxGeometryQuery::raycast(start, dir, mGeometry, mPose, length, PxHitFlag::ePOSITION|PxHitFlag::eNORMAL|PxHitFlag::eDISTANCE, 1, &result.block) != 0;
+
+		if(result.hasBlock)
+		{
+			result.block.actor = mActor;
+			result.block.shape = mShape;
+		}
+	}
+
+private:
+
+	//Returns false if the ray has to go through the generic raycast.
+	bool raycastAnalytic(const PxVec3& start, const PxVec3& dir, const PxF32 length, PxRaycastHit& hit, bool& hasHit) const
+	{
+		hasHit = false;
+
+		//Ray in sample space: x over the rows, z over the columns, y in height samples.
+		//The scale is linear so the ray parameter is still the distance along the world ray.
+		const PxVec3 o = mPose.transformInv(start).multiply(mRecipScale);
+		const PxVec3 d = mPose.rotateInv(dir).multiply(mRecipScale);
+
+		//Clip the ray to the extent of the heightfield, it can't come back once it has left.
+		PxF32 tMin = 0.0f;
+		PxF32 tMax = length;
+		if(!clipRay(o.x, d.x, PxF32(mNbRows - 1), tMin, tMax) || !clipRay(o.z, d.z, PxF32(mNbColumns - 1), tMin, tMax))
+			return true;
+
+		const PxF32 eps = 1e-5f*length;
+		PxF32 t = tMin;
+		for(PxU32 iteration=0;iteration<64;iteration++)
+		{
+			//Triangle just past the current point of the ray.
+			const PxF32 tProbe = PxMin(t + eps, tMax);
+			const PxF32 x = o.x + d.x*tProbe;
+			const PxF32 z = o.z + d.z*tProbe;
+			const PxU32 row = PxU32(PxClamp(PxI32(x), 0, PxI32(mNbRows) - 2));
+			const PxU32 column = PxU32(PxClamp(PxI32(z), 0, PxI32(mNbColumns) - 2));
+
+			const PxHeightFieldSample sample00 = mHeightField.getSampleValue(row, column);
+			const bool zerothVertexShared = sample00.tessFlag() != 0;
+			const PxU8 material0 = PxU8(sample00.materialIndex0);
+			const PxU8 material1 = PxU8(sample00.materialIndex1);
+			const PxF32 h00 = PxF32(sample00.height);
+			const PxF32 h10 = PxF32(mHeightField.getSampleValue(row + 1, column).height);
+			const PxF32 h01 = PxF32(mHeightField.getSampleValue(row, column + 1).height);
+			const PxF32 h11 = PxF32(mHeightField.getSampleValue(row + 1, column + 1).height);
+
+			//Height of the triangle as c + gx*fracX + gz*fracZ, same split as Gu::HeightField::getHeight.
+			const PxF32 fracX = x - PxF32(row);
+			const PxF32 fracZ = z - PxF32(column);
+			const bool secondTriangle = zerothVertexShared ? (fracZ > fracX) : (fracX + fracZ > 1.0f);
+			if((secondTriangle ? material1 : material0) == PxHeightFieldMaterial::eHOLE)
+				return false;
+
+			PxF32 c, gx, gz;
+			if(zerothVertexShared)
+			{
+				c = h00;
+				gx = secondTriangle ? h11 - h01 : h10 - h00;
+				gz = secondTriangle ? h01 - h00 : h11 - h10;
+			}
+			else
+			{
+				c = secondTriangle ? h10 + h01 - h11 : h00;
+				gx = secondTriangle ? h11 - h01 : h10 - h00;
+				gz = secondTriangle ? h11 - h10 : h01 - h00;
+			}
+
+			//Ray start relative to the cell.
+			const PxF32 startX = o.x - PxF32(row);
+			const PxF32 startZ = o.z - PxF32(column);
+
+			//Where the ray leaves the triangle: through a side of the cell or through the diagonal.
+			PxF32 tExit = tMax;
+			if(d.x > 0.0f)		tExit = PxMin(tExit, (1.0f - startX)/d.x);
+			else if(d.x < 0.0f)	tExit = PxMin(tExit, -startX/d.x);
+			if(d.z > 0.0f)		tExit = PxMin(tExit, (1.0f - startZ)/d.z);
+			else if(d.z < 0.0f)	tExit = PxMin(tExit, -startZ/d.z);
+			const PxF32 diagonalStart = zerothVertexShared ? startZ - startX : startX + startZ - 1.0f;
+			const PxF32 diagonalDir = zerothVertexShared ? d.z - d.x : d.x + d.z;
+			if(secondTriangle ? diagonalDir < 0.0f : diagonalDir > 0.0f)
+				tExit = PxMin(tExit, -diagonalStart/diagonalDir);
+			tExit = PxMax(tExit, t);
+
+			//Height of the ray above the plane of the triangle, linear in t.
+			const PxF32 gap0 = o.y - (c + gx*startX + gz*startZ);
+			const PxF32 gapDir = d.y - gx*d.x - gz*d.z;
+
+			//The ray starts under the surface, or enters the heightfield from under it. 
+			//A hit at distance zero is ignored by the vehicle update anyway.
+			if(0 == iteration && gap0 + gapDir*t <= 0.0f)
+				return true;
+
+			if(gapDir < 0.0f)
+			{
+				const PxF32 tHit = -gap0/gapDir;
+				if(tHit <= tExit)
+				{
+					const PxF32 distance = PxMax(tHit, t);
+
+					//Gradient of the local space surface, the normal faces up.
+					const PxVec3 localNormal(-gx*mGeometry.heightScale*mRecipScale.x, 1.0f, -gz*mGeometry.heightScale*mRecipScale.z);
+
+					hit.faceIndex = ((row*mNbColumns + column) << 1) + (secondTriangle ? 1 : 0);
+					hit.flags = PxHitFlag::ePOSITION|PxHitFlag::eNORMAL|PxHitFlag::eDISTANCE;
+					hit.position = start + dir*distance;
+					hit.normal = mPose.rotate(localNormal.getNormalized());
+					hit.distance = distance;
+					hit.u = 0.0f;
+					hit.v = 0.0f;
+					hasHit = true;
+					return true;
+				}
+			}
+
+			if(tExit >= tMax)
+				return true;
+			t = tExit;
+		}
+
+		//Very long ray over a very fine heightfield.
+		return false;
+	}
+
+	//Clips the ray parameter range to [0,extent] along one axis of the sample space.
+	static bool clipRay(const PxF32 origin, const PxF32 dir, const PxF32 extent, PxF32& tMin, PxF32& tMax)
+	{
+		if(0.0f == dir)
+			return origin >= 0.0f && origin <= extent;
+
+		PxF32 t0 = -origin/dir;
+		PxF32 t1 = (extent - origin)/dir;
+		if(t0 > t1)
+			Ps::swap(t0, t1);
+		tMin = PxMax(tMin, t0);
+		tMax = PxMin(tMax, t1);
+		return tMin <= tMax;
+	}
+
+	PxRigidActor*					mActor;
+	PxShape*						mShape;
+	const PxHeightFieldGeometry&	mGeometry;
+	const PxHeightField&			mHeightField;
+	PxTransform						mPose;
+	PxVec3							mRecipScale;
+	PxU32							mNbRows;
+	PxU32							mNbColumns;
+	bool							mAnalytic;
+
+	SuspensionHeightFieldRaycaster& operator=(const SuspensionHeightFieldRaycaster&);
+};
+
+void PxVehicleWheels4SuspensionHeightFieldRaycasts
+(const SuspensionHeightFieldRaycaster& raycaster,
+ const PxVehicleWheels4SimData& wheels4SimData, PxVehicleWheels4DynData& wheels4DynData, 
+ const bool* activeWheelStates, const PxU32 numActiveWheels,
+ PxRigidDynamic* vehActor, PxRaycastQueryResult* results)
+{
+	//Get the transform of the chassis.
+	const PxTransform carChassisTrnsfm = computeSuspensionRaycastChassisTransform(vehActor);
+
+	//The results are written straight away, in the order the batch query would have reported them.
+
+	for(PxU32 j=0;j<numActiveWheels;j++)
+	{
+		PxVec3 suspLineStart;
+		PxVec3 suspLineDir;
+		PxF32 suspLineLength;
+		computeSuspensionRaycastLine(carChassisTrnsfm, wheels4SimData, j, activeWheelStates[j], suspLineStart, suspLineDir, suspLineLength);
+
+		//Store the susp line ray for later use.
+		PxVehicleWheels4DynData::SuspLineRaycast& raycast = 
+			reinterpret_cast<PxVehicleWheels4DynData::SuspLineRaycast&>(wheels4DynData.mQueryOrCachedHitResults);
+		raycast.mStarts[j]=suspLineStart;
+		raycast.mDirs[j]=suspLineDir;
+		raycast.mLengths[j]=suspLineLength;
+		wheels4DynData.mHasCachedHitResults=false;
+
+		raycaster.raycast(suspLineStart, suspLineDir, suspLineLength, results[j]);
+	}
+}
+
+void PxVehicleUpdate::suspensionHeightFieldRaycasts(PxRigidActor* heightFieldActor, PxShape* heightFieldShape, const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults, const bool* vehiclesToRaycast)
+{
+	PxHeightFieldGeometry heightFieldGeometry;
+	if(!heightFieldActor || !heightFieldShape || !heightFieldShape->getHeightFieldGeometry(heightFieldGeometry))
+	{
+		PX_CHECK_MSG(false, "PxVehicleSuspensionHeightFieldRaycasts - the shape needs to be a heightfield shape of the actor");
+		return;
+	}
+
+	START_TIMER(TIMER_RAYCASTS);
+
+	//The pose and the scale of the heightfield are fetched once for all the wheels.
+	const SuspensionHeightFieldRaycaster raycaster(heightFieldActor, heightFieldShape, heightFieldGeometry);
+
+	PxRaycastQueryResult* sqres=sceneQueryResults;
+
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		//Get the current car.
+		PxVehicleWheels& veh=*vehicles[i];
+		const PxVehicleWheels4SimData* PX_RESTRICT wheels4SimData=veh.mWheelsSimData.mWheels4SimData;
+		PxVehicleWheels4DynData* PX_RESTRICT wheels4DynData=veh.mWheelsDynData.mWheels4DynData;
+		const PxU32 numActiveWheels=veh.mWheelsSimData.mNbActiveWheels;
+		const PxU32 numWheels4=(numActiveWheels + 3) >> 2;
+		PxRigidDynamic* vehActor=veh.mActor;
+
+		//Blocks of 4 wheels, the last one possibly incomplete.
+		for(PxU32 j=0;j<numWheels4;j++)
+		{
+			const PxU32 numWheelsInBlock = PxMin(4u, numActiveWheels - 4*j);
+
+			bool activeWheelStates[4]={false,false,false,false};
+			computeWheelActiveStates(4*j, veh.mWheelsSimData.mActiveWheelsBitmapBuffer, activeWheelStates);
+
+			wheels4DynData[j].mRaycastResults=NULL;
+			wheels4DynData[j].mSweepResults=NULL;
+
+			//Blocks that reuse their cached hits are updated as if they weren't raycast.
+			if((NULL==vehiclesToRaycast || vehiclesToRaycast[i]) && 
+				!canReuseSuspensionRaycastHits(wheels4SimData[j],wheels4DynData[j],activeWheelStates,numWheelsInBlock,vehActor))
+			{
+				if((sceneQueryResults + numSceneQueryResults) >= (sqres+numWheelsInBlock))
+				{
+					wheels4DynData[j].mRaycastResults=sqres;
+					PxVehicleWheels4SuspensionHeightFieldRaycasts(raycaster,wheels4SimData[j],wheels4DynData[j],activeWheelStates,numWheelsInBlock,vehActor,sqres);
+				}
+				else
+				{
+					PX_CHECK_MSG(false, "PxVehicleSuspensionHeightFieldRaycasts - numSceneQueryResults not big enough to support one raycast hit report per wheel.  Increase size of sceneQueryResults");
+				}
+				sqres+=numWheelsInBlock;
+			}
+		}
+	}
+
+	END_TIMER(TIMER_RAYCASTS);
+}
+
+void physx::PxVehicleSuspensionHeightFieldRaycasts(PxRigidActor* heightFieldActor, PxShape* heightFieldShape, const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults, const bool* vehiclesToRaycast)
+{
+	PX_PROFILE_ZONE("PxVehicleSuspensionHeightFieldRaycasts::ePROFILE_RAYCASTS",0);
+	PxVehicleUpdate::suspensionHeightFieldRaycasts(heightFieldActor, heightFieldShape, numVehicles, vehicles, numSceneQueryResults, sceneQueryResults, vehiclesToRaycast);
+}
+
 
 void PxVehicleWheels4SuspensionSweeps
 (PxBatchQuery* batchQuery, 
@@ -7492,6 +8495,7 @@ void PxVehicleWheels4SuspensionSweeps
 		sweep.mDirs[j] = suspLineDir;
 		sweep.mLengths[j] = suspLineLength;
 		sweep.mGometries[j] = suspGeometry;
+		wheels4DynData.mHasCachedHitResults = false;
 
 		//Add the raycast to the scene query.
 		batchQuery->sweep(sweep.mGometries[j].any(),
@@ -653,6 +653,7 @@ void PxVehicleWheels::setup
  const PxU32 numDrivenWheels, const PxU32 numNonDrivenWheels)
 {
 	mNbNonDrivenWheels = numNonDrivenWheels;
+	mSimulationTier = PxVehicleSimulationTier::eFULL;
 
 	PX_CHECK_AND_RETURN(wheelsData.getNbWheels() == mWheelsSimData.getNbWheels(), "PxVehicleWheels::setup - vehicle must be setup with same number of wheels as wheelsData");
 	PX_CHECK_AND_RETURN(vehActor, "PxVehicleWheels::setup - vehActor is null ptr : you need to instantiate an empty PxRigidDynamic for the vehicle");
@@ -791,6 +792,12 @@ PxReal PxVehicleWheels::computeSidewaysSpeed() const
 	return mActor->getLinearVelocity().dot(vehicleChassisTrnsfm.q.rotate(gRight));
 }
 
+void PxVehicleWheels::setSimulationTier(const PxVehicleSimulationTier::Enum tier)
+{
+	PX_CHECK_AND_RETURN(tier < PxVehicleSimulationTier::eMAX_NB_SIMULATION_TIERS, "PxVehicleWheels::setSimulationTier - illegal tier");
+	mSimulationTier = Ps::to8(tier);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 void PxVehicleWheelsDynData::setUserData(const PxU32 tireIdx, void* userData)
@@ -30,6 +30,9 @@
 #include "PxVehicleUtilTelemetry.h"
 #include "PsFoundation.h"
 #include "PsUtilities.h"
+#include "PsIntrinsics.h"
+#include "PsBitUtils.h"
+#include "foundation/PxMemory.h"
 #include "stdio.h"
 #include "CmPhysXCommon.h"
 
@@ -570,6 +573,142 @@ void physx::PxVehicleTelemetryData::clear()
 
 #endif //PX_DEBUG_VEHICLE_ON
 
+////////////////////////////////////////////////////////////////////////////
+//PxVehicleTelemetryRecorder
+//The entries are written by PxVehicleUpdate::recordTelemetry.
+//A writer clears the sequence of an entry, writes the values and then sets the sequence 
+//so the reader can tell complete entries from entries still being written or overwritten.
+////////////////////////////////////////////////////////////////////////////
+
+PxVehicleTelemetryRecorder* PxVehicleTelemetryRecorder::allocate(const PxU32 nbEntries, const PxU32 maxNbVehicles)
+{
+	PX_CHECK_AND_RETURN_NULL(nbEntries > 0 && nbEntries <= 0x40000000, "PxVehicleTelemetryRecorder::allocate - nbEntries must be in range (0, 2^30]");
+
+	const PxU32 nbEntriesPow2 = Ps::nextPowerOfTwo(nbEntries-1);
+
+	//Work out the byte size required.
+	const PxU32 headerSize = (sizeof(PxVehicleTelemetryRecorder) + 15) & ~15;
+	PxU32 size = headerSize;
+	size += sizeof(PxVehicleTelemetryEntry)*nbEntriesPow2;		//entries
+	size += sizeof(PxVehicleWheels*)*maxNbVehicles;				//vehicles
+	size += sizeof(PxU16)*maxNbVehicles;						//vehicle ids
+
+	//Allocate the memory.
+	PxU8* ptr = static_cast<PxU8*>(PX_ALLOC(size, "PxVehicleTelemetryRecorder"));
+	PxVehicleTelemetryRecorder* recorder = new(ptr) PxVehicleTelemetryRecorder();
+	ptr += headerSize;
+
+	//Patch up the pointers.
+	recorder->mEntries = reinterpret_cast<PxVehicleTelemetryEntry*>(ptr);
+	ptr += sizeof(PxVehicleTelemetryEntry)*nbEntriesPow2;
+	recorder->mVehicles = reinterpret_cast<const PxVehicleWheels**>(ptr);
+	ptr += sizeof(PxVehicleWheels*)*maxNbVehicles;
+	recorder->mVehicleIds = reinterpret_cast<PxU16*>(ptr);
+
+	recorder->mNbEntries = nbEntriesPow2;
+	recorder->mMaxNbVehicles = maxNbVehicles;
+	recorder->mNbVehicles = 0;
+	recorder->mFrame = 0;
+	recorder->clear();
+
+	return recorder;
+}
+
+void PxVehicleTelemetryRecorder::free()
+{
+	PX_FREE(this);
+}
+
+bool PxVehicleTelemetryRecorder::addVehicle(const PxVehicleWheels* vehicle, const PxU16 vehicleId)
+{
+	PX_CHECK_AND_RETURN_VAL(vehicle, "PxVehicleTelemetryRecorder::addVehicle - vehicle must be non-null", false);
+
+	//Keep the vehicles sorted so that the updates can find them with a binary search.
+	PxU32 pos = 0;
+	while(pos < mNbVehicles && mVehicles[pos] < vehicle)
+	{
+		pos++;
+	}
+
+	if(pos < mNbVehicles && mVehicles[pos] == vehicle)
+	{
+		mVehicleIds[pos] = vehicleId;
+		return true;
+	}
+
+	if(mNbVehicles == mMaxNbVehicles)
+	{
+		return false;
+	}
+
+	for(PxU32 i = mNbVehicles; i > pos; i--)
+	{
+		mVehicles[i] = mVehicles[i-1];
+		mVehicleIds[i] = mVehicleIds[i-1];
+	}
+	mVehicles[pos] = vehicle;
+	mVehicleIds[pos] = vehicleId;
+	mNbVehicles++;
+	return true;
+}
+
+void PxVehicleTelemetryRecorder::removeVehicle(const PxVehicleWheels* vehicle)
+{
+	for(PxU32 pos = 0; pos < mNbVehicles; pos++)
+	{
+		if(mVehicles[pos] == vehicle)
+		{
+			for(PxU32 i = pos + 1; i < mNbVehicles; i++)
+			{
+				mVehicles[i-1] = mVehicles[i];
+				mVehicleIds[i-1] = mVehicleIds[i];
+			}
+			mNbVehicles--;
+			return;
+		}
+	}
+}
+
+void PxVehicleTelemetryRecorder::clear()
+{
+	for(PxU32 i = 0; i < mNbEntries; i++)
+	{
+		mEntries[i].sequence = 0;
+	}
+	mWriteCount = 0;
+}
+
+PxU32 PxVehicleTelemetryRecorder::read(PxU32& cursor, PxVehicleTelemetryEntry* entries, const PxU32 maxNbEntries) const
+{
+	const PxU32 writeCount = PxU32(mWriteCount);
+
+	//Skip the entries that were overwritten since the last read.
+	if(writeCount - cursor > mNbEntries)
+	{
+		cursor = writeCount - mNbEntries;
+	}
+
+	PxU32 nbRead = 0;
+	while(cursor != writeCount && nbRead < maxNbEntries)
+	{
+		const volatile PxVehicleTelemetryEntry& entry = mEntries[cursor & (mNbEntries-1)];
+		const PxU32 sequence = entry.sequence;
+		Ps::memoryBarrier();
+		PxMemCopy(&entries[nbRead], const_cast<const PxVehicleTelemetryEntry*>(&entry), sizeof(PxVehicleTelemetryEntry));
+		Ps::memoryBarrier();
+
+		//Stop at an entry that is still being written or that was overwritten while being copied.
+		if(sequence != cursor + 1 || entry.sequence != sequence)
+		{
+			break;
+		}
+
+		nbRead++;
+		cursor++;
+	}
+	return nbRead;
+}
+
 } //physx
 
 
@@ -61,6 +61,7 @@ typedef PxU32 PrunerHandle;
 
 static const PrunerHandle INVALID_PRUNERHANDLE = 0xFFffFFff;
 static const PxReal SQ_PRUNER_INFLATION = 1.01f; // pruner test shape inflation (not narrow phase shape)
+static const PxU32 SQ_RAY_PACKET_SIZE = 4; // max number of rays in a raycastPacket() call, one per SIMD lane
 
 struct PrunerPayload
 {
@@ -74,8 +75,14 @@ struct PrunerPayload
 
 struct PrunerCallback
 {
+	PrunerCallback() : mFilterMask(0) {}
+
 	virtual PxAgain invoke(PxReal& distance, const PrunerPayload& payload) = 0;
     virtual ~PrunerCallback() {}
+
+	// Pruners with per-node filter masks skip the subtrees whose objects all have a filter mask without these bits, see
+	// Pruner::setFilterMask(). The callback must reject these objects anyway, 0 disables the culling.
+	PxU32	mFilterMask;
 };
 
 class Pruner : public Ps::UserAllocated
@@ -161,6 +168,43 @@ public:
 	virtual	PxAgain						overlap(const Gu::ShapeData& queryVolume, PrunerCallback&) const = 0;
 	virtual	PxAgain						sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const = 0;
 
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/**
+	 *	Visits the objects whose bounds are within inOutDistance of a point, trying the closest ones first.
+	 *	\param		point			[in]		query point
+	 *	\param		inOutDistance	[in/out]	search radius, shrunk to the distances returned by the callback
+	 *	\param		pcb				[in]		called with the distance from the point to the object bounds, a lower bound of
+	 *										the distance to the object. It returns the new search radius in it.
+	 */
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	virtual	PxAgain						nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const = 0;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/**
+	 *	Raycasts a packet of up to SQ_RAY_PACKET_SIZE rays, each with its own distance and callback as for raycast().
+	 *	Pruners traversing the rays together should only be faster for coherent rays, which share most of the visited nodes.
+	 *	\param		origins			[in]		ray origins
+	 *	\param		unitDirs		[in]		ray directions
+	 *	\param		inOutDistances	[in/out]	ray distances, shrunk as for raycast()
+	 *	\param		callbacks		[in]		ray callbacks
+	 *	\param		activeMask		[in]		bit i is set if ray i must be cast, the other entries are not accessed
+	 *
+	 *	\return	the rays of activeMask whose callback didn't abort the query
+	 *
+	 *	The default implementation casts the rays one by one.
+	 */
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	virtual	PxU32						raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+										{
+											PxU32 againMask = 0;
+											for(PxU32 i=0;i<SQ_RAY_PACKET_SIZE;i++)
+											{
+												if((activeMask & (1<<i)) && raycast(origins[i], unitDirs[i], *inOutDistances[i], *callbacks[i]))
+													againMask |= 1<<i;
+											}
+											return againMask;
+										}
+
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	/**
 	 *	Retrieve the object data associated with the handle
@@ -184,6 +228,31 @@ public:
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	virtual const PrunerPayload&		getPayload(PrunerHandle handle, PxBounds3*& bounds) const = 0;
 
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/**
+	 *	Gives access to all the objects of the pruner at once, to copy them
+	 *	
+	 *	\param	bounds		[out] the bounds of the objects, as used by the queries
+	 *	\param	payloads	[out] the object data
+	 *	\param	handles		[out] the handle of each object
+	 *
+	 *	
+eturn				The number of objects in the arrays
+	 */
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	virtual PxU32						getObjects(const PxBounds3*& bounds, const PrunerPayload*& payloads, const PrunerHandle*& handles) const = 0;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/**
+	 *	Sets the filter mask of an object, all bits by default. Pruners that support it OR the masks up their hierarchy
+	 *	so the queries can skip the subtrees that don't share any bit with PrunerCallback::mFilterMask.
+	 *	
+	 *	\param	handle		The handle returned by addObjects()
+	 *	\param	mask		The new filter mask
+	 */
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	virtual void						setFilterMask(PrunerHandle handle, PxU32 mask)	{ PX_UNUSED(handle); PX_UNUSED(mask);	}
+
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	/**
 	 *	Preallocate space 
@@ -0,0 +1,114 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef SQ_PRUNER_SNAPSHOT_H
+#define SQ_PRUNER_SNAPSHOT_H
+
+#include "SqPruner.h"
+#include "PsArray.h"
+#include "foundation/PxTransform.h"
+
+namespace physx
+{
+class PxCpuDispatcher;
+
+namespace Sq
+{
+	class AABBTree;
+
+	// Computes the world pose of a pruner object, for the snapshots
+	struct PrunerPoseCallback
+	{
+		virtual void	getPose(PxTransform& pose, const PrunerPayload& payload) const = 0;
+		virtual			~PrunerPoseCallback() {}
+	};
+
+	// Frozen copy of the objects of a pruner and of their poses, queried while the pruner itself keeps changing.
+	// The copy has its own tree, refitted when the objects are the same as for the previous update and rebuilt otherwise.
+	// See SceneQueryManager::publishSnapshots. Snapshots are read only, the maintenance functions of the Pruner interface assert.
+	class PrunerSnapshot : public Pruner
+	{
+	public:
+												PrunerSnapshot(PxU64 contextID);
+		virtual									~PrunerSnapshot();
+
+		// Pruner interface
+		virtual			bool					addObjects(PrunerHandle* results, const PxBounds3* bounds, const PrunerPayload* userData, PxU32 count, bool hasPruningStructure);
+		virtual			void					removeObjects(const PrunerHandle* handles, PxU32 count);
+		virtual			void					updateObjectsAfterManualBoundsUpdates(const PrunerHandle* handles, PxU32 count);
+		virtual			void					updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count);
+		virtual			void					commit()	{}
+		virtual			void					merge(const void* mergeParams);
+		virtual			PxAgain					raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+		virtual			PxAgain					overlap(const Gu::ShapeData& queryVolume, PrunerCallback&) const;
+		virtual			PxAgain					sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+		virtual			PxAgain					nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&) const;
+		virtual			PxU32					raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const;
+		virtual			const PrunerPayload&	getPayload(PrunerHandle handle) const	{ return mPayloads[mHandleToIndex[handle]];	}
+		virtual			const PrunerPayload&	getPayload(PrunerHandle handle, PxBounds3*& bounds) const;
+		virtual			PxU32					getObjects(const PxBounds3*& bounds, const PrunerPayload*& payloads, const PrunerHandle*& handles) const
+												{ bounds = mBounds.begin(); payloads = mPayloads.begin(); handles = mHandles.begin(); return mPayloads.size();	}
+		virtual			void					preallocate(PxU32)	{}
+		virtual			void					shiftOrigin(const PxVec3& shift);
+		//~Pruner interface
+
+		// Copies the objects of the pruner, with the pruner timestamp they correspond to
+						void					update(const Pruner& pruner, PxU32 timestamp, const PrunerPoseCallback& poses, PxCpuDispatcher* dispatcher);
+		// Hides an object from the queries, for an object removed from the pruner after the update
+						void					hideObject(PrunerHandle handle);
+
+		PX_FORCE_INLINE	bool					isUpToDate(PxU32 timestamp)	const	{ return mValid && mTimestamp == timestamp;	}
+
+		// Pose of the object the snapshot gave to a query callback, false for a payload the snapshot doesn't own
+		PX_FORCE_INLINE	bool					getPose(const PrunerPayload& payload, PxTransform& pose) const
+												{
+													const size_t offset = size_t(&payload) - size_t(mPayloads.begin());
+													if(offset >= size_t(mPayloads.size())*sizeof(PrunerPayload))
+														return false;
+													pose = mPoses[PxU32(offset/sizeof(PrunerPayload))];
+													return true;
+												}
+	private:
+						AABBTree*				mTree;
+						Ps::Array<PxBounds3>	mBounds;
+						Ps::Array<PrunerPayload>	mPayloads;
+						Ps::Array<PxTransform>	mPoses;
+						Ps::Array<PrunerHandle>	mHandles;
+						Ps::Array<PxU32>		mHandleToIndex;
+						PxU32					mTimestamp;
+						PxU32					mNbRefits;		// since the last rebuild
+						PxU32					mNbHidden;
+						PxU64					mContextID;
+						bool					mValid;
+	};
+}
+}
+
+#endif // SQ_PRUNER_SNAPSHOT_H
@@ -37,11 +37,13 @@
 #include "CmBitMap.h"
 #include "PsArray.h"
 #include "SqPruner.h"
+#include "SqPrunerSnapshot.h"
 #include "PsMutex.h"
 #include "PxActor.h" // needed for offset table
 #include "ScbActor.h" // needed for offset table
 // threading
 #include "PsSync.h"
+#include "PsAtomic.h"
 
 namespace physx
 {
@@ -87,7 +89,7 @@ namespace Sq
 														PrunerExt();
 														~PrunerExt();
 
-						void							init(PxPruningStructureType::Enum type, PxU64 contextID);
+						void							init(PxPruningStructureType::Enum type, PxU64 contextID, PxCpuDispatcher* dispatcher);
 						void							flushMemory();
 						void							preallocate(PxU32 nbShapes);
 						void							flushShapes(PxU32 index);
@@ -122,17 +124,35 @@ namespace Sq
 		PxU32*	mTimestamp;
 	};
 
+	// Snapshots of both pruners published together, see PxSceneFlag::eENABLE_QUERY_SNAPSHOTS
+	struct PrunerSnapshotSet
+	{
+														PrunerSnapshotSet() : mNbReaders(0)	{ mSnapshots[0] = mSnapshots[1] = NULL;	}
+
+		PX_FORCE_INLINE	const Pruner*					getPruner(PxU32 index)	const	{ return mSnapshots[index];	}
+		PX_FORCE_INLINE	bool							getPose(const PrunerPayload& payload, PxTransform& pose) const
+														{
+															return mSnapshots[0]->getPose(payload, pose) || mSnapshots[1]->getPose(payload, pose);
+														}
+
+						PrunerSnapshot*					mSnapshots[PruningIndex::eCOUNT];
+		mutable			volatile PxI32					mNbReaders;
+	};
+
 	class SceneQueryManager : public Ps::UserAllocated
 	{
 		PX_NOCOPY(SceneQueryManager)
 	public:
 														SceneQueryManager(Scb::Scene& scene, PxPruningStructureType::Enum staticStructure, 
 															PxPruningStructureType::Enum dynamicStructure, PxU32 dynamicTreeRebuildRateHint,
-															const PxSceneLimits& limits);
+															const PxSceneLimits& limits, PxCpuDispatcher* dispatcher);
 														~SceneQueryManager();
 
 						PrunerData						addPrunerShape(const NpShape& shape, const PxRigidActor& actor, bool dynamic, const PxBounds3* bounds=NULL, bool hasPrunerStructure = false);
 						void							removePrunerShape(PrunerData shapeData);
+						// same as addPrunerShape/removePrunerShape for several shapes of an actor, with a single pruner update
+						void							addPrunerShapes(PxU32 nbShapes, const NpShape*const* shapes, const PxRigidActor& actor, bool dynamic, PrunerData* shapeData);
+						void							removePrunerShapes(PxU32 nbShapes, const PrunerData* shapeData);
 						const PrunerPayload&			getPayload(PrunerData shapeData) const;
 
 	public:
@@ -144,6 +164,7 @@ namespace Sq
 
 						void							preallocate(PxU32 staticShapes, PxU32 dynamicShapes);
 						void							markForUpdate(PrunerData s);
+						void							setFilterMask(PrunerData s, PxU32 mask);	// word0 of the shape's query filter data
 						void							setDynamicTreeRebuildRateHint(PxU32 dynTreeRebuildRateHint);
 						
 						void							flushUpdates();
@@ -160,6 +181,16 @@ namespace Sq
 						void							shiftOrigin(const PxVec3& shift);
 
 						void							flushMemory();
+
+		// Snapshots for the queries, when the scene has PxSceneFlag::eENABLE_QUERY_SNAPSHOTS. Readers get NULL when they must use
+		// the pruners themselves, i.e. without the flag and before the first publish. Every acquire must be matched by a release.
+						const PrunerSnapshotSet*		acquireSnapshots()							const;
+		PX_FORCE_INLINE	void							releaseSnapshots(const PrunerSnapshotSet* set)	const	{ if(set) Ps::atomicDecrement(&set->mNbReaders);	}
+		// Copies the current state of the pruners for the queries. Called by the writer only, while no pruner is modified.
+						void							publishSnapshots();
+		// Incremented each time the published snapshots change, 0 until the first publish
+		PX_FORCE_INLINE	PxU32							getSnapshotVersion()	const	{ return mSnapshotVersion;	}
+		PX_FORCE_INLINE	bool							usesSnapshots()			const	{ return mUseSnapshots;		}
 	private:
 						PrunerExt						mPrunerExt[PruningIndex::eCOUNT];
 
@@ -174,7 +205,18 @@ namespace Sq
 
 						volatile bool					mPrunerNeedsUpdating;
 
+						PxCpuDispatcher*				mDispatcher;
+
+						// snapshots
+		mutable			PrunerSnapshotSet				mSnapshotSets[2];
+						volatile PxI32					mPublishedSnapshots;	// index of the set readers use, or one of the values below
+						volatile PxU32					mSnapshotVersion;
+						bool							mUseSnapshots;
+
 						void							flushShapes();
+						// Stops new readers and waits for the current ones, so the snapshots can be modified. Returns what to pass to resumeSnapshots.
+						PxI32							pauseSnapshots();
+						void							resumeSnapshots(PxI32 published);
 
 	};
 
@@ -60,7 +60,7 @@ IncrementalPruner* physx::Sq::createAABBPruner(bool incrementalRebuild)
 // PT: currently limited to 15 max
 #define NB_OBJECTS_PER_NODE	4
 
-AABBPruner::AABBPruner(bool incrementalRebuild, PxU64 contextID) :
+AABBPruner::AABBPruner(bool incrementalRebuild, PxU64 contextID, PxCpuDispatcher* dispatcher) :
 	mAABBTree			(NULL),
 	mNewTree			(NULL),
 	mCachedBoxes		(NULL),
@@ -74,8 +74,10 @@ AABBPruner::AABBPruner(bool incrementalRebuild, PxU64 contextID) :
 	mIncrementalRebuild	(incrementalRebuild),
 	mUncommittedChanges	(false),
 	mNeedsNewTree		(false),
+	mFilterMasksDirty	(false),
 	mNewTreeFixups		(PX_DEBUG_EXP("AABBPruner::mNewTreeFixups")),
-	mContextID			(contextID)
+	mContextID			(contextID),
+	mDispatcher			(dispatcher)
 {
 }
 
@@ -340,6 +342,21 @@ PxAgain AABBPruner::sweep(const ShapeData& queryVolume, const PxVec3& unitDir, P
 	return again;
 }
 
+PxAgain AABBPruner::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	PxAgain again = true;
+
+	if(mAABBTree)
+		again = AABBTreeNearest<AABBTree, AABBTreeRuntimeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, point, inOutDistance, pcb);
+
+	if(again && mIncrementalRebuild && mBucketPruner.getNbObjects())
+		again = mBucketPruner.nearest(point, inOutDistance, pcb);
+
+	return again;
+}
+
 PxAgain AABBPruner::raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
 {
 	PX_ASSERT(!mUncommittedChanges);
@@ -355,6 +372,21 @@ PxAgain AABBPruner::raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal&
 	return again;
 }
 
+PxU32 AABBPruner::raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	PxU32 againMask = activeMask;
+
+	if(mAABBTree)
+		againMask = AABBTreeRaycastPacket<AABBTree, AABBTreeRuntimeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, origins, unitDirs, inOutDistances, callbacks, againMask);
+
+	if(againMask && mIncrementalRebuild && mBucketPruner.getNbObjects())
+		againMask = mBucketPruner.raycastPacket(origins, unitDirs, inOutDistances, callbacks, againMask);
+
+	return againMask;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /**
  *	Other methods of Pruner Interface
@@ -384,6 +416,9 @@ void AABBPruner::commit()
 {
 	PX_PROFILE_ZONE("SceneQuery.prunerCommit", mContextID);
 
+	if(mFilterMasksDirty)
+		updateFilterMasks();
+
 	if(!mUncommittedChanges && (mProgress != BUILD_FINISHED))
 		// Q: seems like this is both for refit and finalization so is this is correct?
 		// i.e. in a situation when we started rebuilding a tree and didn't add anything since
@@ -492,6 +527,9 @@ void AABBPruner::commit()
 			refitUpdatedAndRemoved();
 		}
 
+		// the new tree was built without masks, and its indices are only valid once the fixups are applied
+		updateFilterMasks();
+
 		{
 			PX_PROFILE_ZONE("SceneQuery.prunerNewTreeRemoveObjects", mContextID);
 
@@ -753,6 +791,10 @@ bool AABBPruner::fullRebuildAABBTree()
 		TB.mNbPrimitives	= nbObjects;
 		TB.mAABBArray		= mPool.getCurrentWorldBoxes();
 		TB.mLimit			= NB_OBJECTS_PER_NODE;
+		// full rebuilds happen for the initial tree and for each change of the static pruner, with all the objects at once,
+		// so a better tree is worth the extra build time
+		TB.mBuildStrategy	= BUILD_STRATEGY_SAH;
+		TB.mDispatcher		= mDispatcher;
 		Status = mAABBTree->build(TB);
 	}
 
@@ -760,9 +802,32 @@ bool AABBPruner::fullRebuildAABBTree()
 	if(mIncrementalRebuild)
 		mTreeMap.initMap(PxMax(nbObjects,mNbCachedBoxes),*mAABBTree);
 
+	updateFilterMasks();
+
 	return Status;
 }
 
+void AABBPruner::setFilterMask(PrunerHandle handle, PxU32 mask)
+{
+	mPool.setFilterMask(handle, mask);
+
+	// Only the objects already in the current tree need the node masks to be recomputed. The new objects are in the bucket pruner
+	// (or will be part of the next full rebuild) and the tree being built gets its masks when it is switched in.
+	if(!mAABBTree || (!mIncrementalRebuild && mUncommittedChanges))
+		return;
+	if(mIncrementalRebuild && mTreeMap[mPool.getIndex(handle)]==INVALID_NODE_ID)
+		return;
+	mFilterMasksDirty = true;
+}
+
+// recomputes the filter masks of the current tree nodes from the masks of the pool objects
+void AABBPruner::updateFilterMasks()
+{
+	if(mAABBTree)
+		mAABBTree->computeFilterMasks(mPool.getFilterMasks(), mPool.getNbActiveObjects());
+	mFilterMasksDirty = false;
+}
+
 // called in the end of commit(), but only if mIncrementalRebuild is true
 void AABBPruner::updateBucketPruner()
 {
@@ -839,6 +904,8 @@ void AABBPruner::merge(const void* mergeParams)
 		{
 			// merge tree directly
 			mAABBTree->mergeTree(aabbTreeMergeParams);		
+			// the merged nodes have no masks yet
+			mFilterMasksDirty = true;
 		}
 		else
 		{
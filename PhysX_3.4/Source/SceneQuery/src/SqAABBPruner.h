@@ -124,7 +124,7 @@ namespace Sq
 	class AABBPruner : public IncrementalPruner
 	{
 		public:
-												AABBPruner(bool incrementalRebuild, PxU64 contextID); // true is equivalent to former dynamic pruner
+												AABBPruner(bool incrementalRebuild, PxU64 contextID, PxCpuDispatcher* dispatcher = NULL); // true is equivalent to former dynamic pruner
 		virtual									~AABBPruner();
 
 		// Pruner
@@ -134,11 +134,16 @@ namespace Sq
 		virtual			void					updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count);
 		virtual			void					commit();
 		virtual			PxAgain					raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			PxU32					raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask)	const;
 		virtual			PxAgain					overlap(const Gu::ShapeData& queryVolume, PrunerCallback&)	const;
 		virtual			PxAgain					sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			PxAgain					nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&)	const;
 		virtual			const PrunerPayload&	getPayload(PrunerHandle handle)						const	{ return mPool.getPayload(handle);			}
 		virtual			const PrunerPayload&	getPayload(PrunerHandle handle, PxBounds3*& bounds)	const	{ return mPool.getPayload(handle, bounds);	}
+		virtual			PxU32					getObjects(const PxBounds3*& bounds, const PrunerPayload*& payloads, const PrunerHandle*& handles)	const
+												{ bounds = mPool.getCurrentWorldBoxes(); payloads = mPool.getObjects(); handles = mPool.mIndexToHandle; return mPool.getNbActiveObjects();	}
 		virtual			void					preallocate(PxU32 entries)									{ mPool.preallocate(entries);				}
+		virtual			void					setFilterMask(PrunerHandle handle, PxU32 mask);
 		virtual			void					shiftOrigin(const PxVec3& shift);
 		virtual			void					visualize(Cm::RenderOutput& out, PxU32 color) const;		
 		virtual			void					merge(const void* mergeParams);
@@ -234,6 +239,10 @@ namespace Sq
 		// this is set to true if a new tree has to be created again after the current rebuild is done
 						bool					mNeedsNewTree;
 
+		// The filter masks of the tree nodes are recomputed in commit() when an object's mask changed. This doesn't set
+		// mUncommittedChanges, a mask change alone must not trigger a rebuild of the static tree
+						bool					mFilterMasksDirty;
+
 		// This struct is used to record modifications made to the pruner state
 		// while a tree is building in the background
 		// this is so we can apply the modifications to the tree at the time of completion
@@ -254,11 +263,15 @@ namespace Sq
 
 						PxU64					mContextID;
 
+		// runs the full rebuilds in parallel, can be NULL
+						PxCpuDispatcher*		mDispatcher;
+
 		// Internal methods
 						bool					fullRebuildAABBTree(); // full rebuild function, used with static pruner mode
 						void					release();
 						void					refitUpdatedAndRemoved();
 						void					updateBucketPruner();
+						void					updateFilterMasks();
 						PxBounds3				getAABB(PrunerHandle h);
 	};
 
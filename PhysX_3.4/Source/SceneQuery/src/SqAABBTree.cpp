@@ -75,6 +75,17 @@ void flatten(const NodeAllocator& nodeAllocator, AABBTreeRuntimeNode* dest)
 	// PT: gathers all build nodes allocated so far and flatten them to a linear destination array of smaller runtime nodes
 	PxU32 offset = 0;
 	const PxU32 nbSlabs = nodeAllocator.mSlabs.size();
+
+	// index of the first node of each slab. Children are usually in the same slab as their parent, which is tested first,
+	// this matters for the trees built in parallel which have a few slabs per subtree
+	PxU32* slabBases = reinterpret_cast<PxU32*>(PX_ALLOC_TEMP(sizeof(PxU32)*nbSlabs, "flatten slab bases"));
+	for(PxU32 s=0;s<nbSlabs;s++)
+	{
+		slabBases[s] = offset;
+		offset += nodeAllocator.mSlabs[s].mNbUsedNodes;
+	}
+	offset = 0;
+
 	for(PxU32 s=0;s<nbSlabs;s++)
 	{
 		const NodeAllocator::Slab& currentSlab = nodeAllocator.mSlabs[s];
@@ -95,23 +106,24 @@ void flatten(const NodeAllocator& nodeAllocator, AABBTreeRuntimeNode* dest)
 			else
 			{
 				PX_ASSERT(pool[i].mPos);
-				PxU32 localNodeIndex = 0xffffffff;
-				PxU32 nodeBase = 0;
-				for(PxU32 j=0;j<nbSlabs;j++)
+				PxU32 nodeIndex = 0xffffffff;
+				for(PxU32 k=0;k<nbSlabs;k++)
 				{
+					const PxU32 j = k ? (k<=s ? k-1 : k) : s;
 					if(pool[i].mPos>= nodeAllocator.mSlabs[j].mPool && pool[i].mPos < nodeAllocator.mSlabs[j].mPool + nodeAllocator.mSlabs[j].mNbUsedNodes)
 					{
-						localNodeIndex = PxU32(pool[i].mPos - nodeAllocator.mSlabs[j].mPool);
+						nodeIndex = slabBases[j] + PxU32(pool[i].mPos - nodeAllocator.mSlabs[j].mPool);
 						break;
 					}
-					nodeBase += nodeAllocator.mSlabs[j].mNbUsedNodes;
 				}
-				const PxU32 nodeIndex = nodeBase + localNodeIndex;
+				PX_ASSERT(nodeIndex!=0xffffffff);
 				dest[offset].mData = nodeIndex<<1;
 			}
 			offset++;
 		}
 	}
+
+	PX_FREE(slabBases);
 }
 
 AABBTree::AABBTree() :
@@ -119,6 +131,7 @@ AABBTree::AABBTree() :
 	mNbIndices		(0),
 	mRuntimePool	(NULL),
 	mParentIndices	(NULL),
+	mFilterMasks	(NULL),
 	mTotalNbNodes	(0),
 	mTotalPrims		(0)
 {
@@ -142,7 +155,8 @@ void AABBTree::release(bool clearRefitMap)
 	PX_DELETE_AND_RESET(mStack);
 //~Progressive building
 	PX_FREE_AND_RESET(mParentIndices);
-	PX_DELETE_ARRAY(mRuntimePool);
+	PX_FREE_AND_RESET(mFilterMasks);
+	PX_FREE_AND_RESET(mRuntimePool);
 	mNodeAllocator.release();
 	PX_FREE_AND_RESET(mIndices);
 	mTotalNbNodes = 0;
@@ -163,12 +177,12 @@ void AABBTree::initTree(const AABBTreeMergeData& tree)
 	PX_ASSERT(mParentIndices == NULL);
 
 	// allocate,copy indices
-	mIndices = reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*tree.mNbIndices, "AABB tree indices"));
+	mIndices = reinterpret_cast<PxU32*>(PX_ALLOC_LARGE(sizeof(PxU32)*tree.mNbIndices, "AABB tree indices"));
 	mNbIndices = tree.mNbIndices;
 	PxMemCopy(mIndices, tree.mIndices, sizeof(PxU32)*tree.mNbIndices);
 
 	// allocate,copy nodes
-	mRuntimePool = PX_NEW(AABBTreeRuntimeNode)[tree.mNbNodes];
+	mRuntimePool = reinterpret_cast<AABBTreeRuntimeNode*>(PX_ALLOC_LARGE(sizeof(AABBTreeRuntimeNode)*tree.mNbNodes, "AABB tree nodes"));
 	mTotalNbNodes = tree.mNbNodes;
 	PxMemCopy(mRuntimePool, tree.mNodes, sizeof(AABBTreeRuntimeNode)*tree.mNbNodes);
 }
@@ -197,7 +211,7 @@ bool AABBTree::buildInit(AABBTreeBuildParams& params, BuildStats& stats)
 
 	// Initialize indices. This list will be modified during build.
 	mNbIndices = nbPrimitives;
-	mIndices = reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*nbPrimitives, "AABB tree indices"));
+	mIndices = reinterpret_cast<PxU32*>(PX_ALLOC_LARGE(sizeof(PxU32)*nbPrimitives, "AABB tree indices"));
 	// Identity permutation
 	for(PxU32 i=0;i<nbPrimitives;i++)
 		mIndices[i] = i;
@@ -226,7 +240,8 @@ void AABBTree::buildEnd(AABBTreeBuildParams& params, BuildStats& stats)
 	mTotalNbNodes	= stats.getCount();
 	mTotalPrims		= stats.mTotalPrims;
 
-	mRuntimePool = PX_NEW(AABBTreeRuntimeNode)[mTotalNbNodes];
+	// the nodes are plain data, they are allocated raw so that they can go to huge pages
+	mRuntimePool = reinterpret_cast<AABBTreeRuntimeNode*>(PX_ALLOC_LARGE(sizeof(AABBTreeRuntimeNode)*mTotalNbNodes, "AABB tree nodes"));
 	PX_ASSERT(mTotalNbNodes==mNodeAllocator.mTotalNbNodes);
 	flatten(mNodeAllocator, mRuntimePool);
 	mNodeAllocator.release();
@@ -240,7 +255,7 @@ bool AABBTree::build(AABBTreeBuildParams& params)
 		return false;
 
 	// Build the hierarchy
-	mNodeAllocator.mPool->_buildHierarchy(params, stats, mNodeAllocator, mIndices);
+	buildHierarchy(params, stats, mNodeAllocator, mIndices);
 
 	buildEnd(params, stats);
 	return true;
@@ -450,6 +465,40 @@ void AABBTree::fullRefit(const PxBounds3* boxes)
 	}
 }
 
+static PxU32 _computeFilterMasks(PxU32* filterMasks, const PxU32* objectMasks, PxU32 nbObjects, const PxU32* indices, const AABBTreeRuntimeNode* currentNode, const AABBTreeRuntimeNode* root)
+{
+	PxU32 mask = 0;
+	if(currentNode->isLeaf())
+	{
+		const PxU32* primitives = currentNode->getPrimitives(indices);
+		const PxU32 nbPrims = currentNode->getNbPrimitives();
+		for(PxU32 i=0;i<nbPrims;i++)
+		{
+			// invalidated leaves can still reference removed objects
+			if(primitives[i] < nbObjects)
+				mask |= objectMasks[primitives[i]];
+		}
+	}
+	else
+	{
+		mask =	_computeFilterMasks(filterMasks, objectMasks, nbObjects, indices, currentNode->getPos(root), root)
+			|	_computeFilterMasks(filterMasks, objectMasks, nbObjects, indices, currentNode->getNeg(root), root);
+	}
+	filterMasks[currentNode - root] = mask;
+	return mask;
+}
+
+void AABBTree::computeFilterMasks(const PxU32* objectMasks, PxU32 nbObjects)
+{
+	if(!mRuntimePool || !mTotalNbNodes)
+		return;
+
+	if(!mFilterMasks)
+		mFilterMasks = reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*mTotalNbNodes, "AABB tree filter masks"));
+
+	_computeFilterMasks(mFilterMasks, objectMasks, nbObjects, mIndices, mRuntimePool, mRuntimePool);
+}
+
 static void _createParentArray(PxU32 totalNbNodes, PxU32* parentIndices, const AABBTreeRuntimeNode* parentNode, const AABBTreeRuntimeNode* currentNode, const AABBTreeRuntimeNode* root)
 {
 	const PxU32 parentIndex = PxU32(parentNode - root);
@@ -671,7 +720,7 @@ void AABBTree::mergeRuntimeLeaf(AABBTreeRuntimeNode& targetNode, const AABBTreeM
 	// 1. Allocate new nodes/parent, copy all the nodes/parents
 	// allocate new runtime pool with max combine number of nodes
 	// we allocate only 1 additional node each merge
-	AABBTreeRuntimeNode* newRuntimePool = PX_NEW(AABBTreeRuntimeNode)[mTotalNbNodes + treeParams.mNbNodes + 1];
+	AABBTreeRuntimeNode* newRuntimePool = reinterpret_cast<AABBTreeRuntimeNode*>(PX_ALLOC_LARGE(sizeof(AABBTreeRuntimeNode)*(mTotalNbNodes + treeParams.mNbNodes + 1), "AABB tree nodes"));
 	PxU32* newParentIndices = reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*(mTotalNbNodes + treeParams.mNbNodes + 1), "AABB parent indices"));
 
 	// copy the whole target nodes, we will add the new node at the end together with the merge tree
@@ -695,7 +744,7 @@ void AABBTree::mergeRuntimeLeaf(AABBTreeRuntimeNode& targetNode, const AABBTreeM
 	}
 
 	// swap pointers
-	PX_DELETE_ARRAY(mRuntimePool);
+	PX_FREE(mRuntimePool);
 	mRuntimePool = newRuntimePool;
 	PX_FREE(mParentIndices);
 	mParentIndices = newParentIndices;
@@ -737,7 +786,7 @@ void AABBTree::mergeRuntimeNode(AABBTreeRuntimeNode& targetNode, const AABBTreeM
 	// 1. Allocate new nodes/parent, copy the nodes/parents till targetNodePosIndex
 	// allocate new runtime pool with max combine number of nodes
 	// we allocate only 1 additional node each merge
-	AABBTreeRuntimeNode* newRuntimePool = PX_NEW(AABBTreeRuntimeNode)[mTotalNbNodes + treeParams.mNbNodes + 1];
+	AABBTreeRuntimeNode* newRuntimePool = reinterpret_cast<AABBTreeRuntimeNode*>(PX_ALLOC_LARGE(sizeof(AABBTreeRuntimeNode)*(mTotalNbNodes + treeParams.mNbNodes + 1), "AABB tree nodes"));
 	PxU32* newParentIndices = reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*(mTotalNbNodes + treeParams.mNbNodes + 1), "AABB parent indices"));
 	// copy the untouched part of the nodes and parents
 	PxMemCopy(newRuntimePool, mRuntimePool, sizeof(AABBTreeRuntimeNode)*(targetNodePosIndex));
@@ -766,7 +815,7 @@ void AABBTree::mergeRuntimeNode(AABBTreeRuntimeNode& targetNode, const AABBTreeM
 		PxMemCopy(newParentIndices + targetNodePosIndex + 1 + treeParams.mNbNodes, mParentIndices + targetNodePosIndex, sizeof(PxU32)*(mTotalNbNodes - targetNodePosIndex));
 	}
 	// swap the pointers, release the old memory
-	PX_DELETE_ARRAY(mRuntimePool);
+	PX_FREE(mRuntimePool);
 	mRuntimePool = newRuntimePool;
 	PX_FREE(mParentIndices);
 	mParentIndices = newParentIndices;
@@ -858,6 +907,9 @@ void AABBTree::mergeTree(const AABBTreeMergeData& treeParams)
 	mIndices = newIndices;
 	mTotalPrims += treeParams.mNbIndices;
 
+	// the node array changes, the owner must compute the masks again
+	PX_FREE_AND_RESET(mFilterMasks);
+
 	// copy the new indices, re-index using the provided indicesOffset. Note that indicesOffset 
 	// must be provided, as original mNbIndices can be different than indicesOffset dues to object releases.	
 	for (PxU32 i = 0; i < treeParams.mNbIndices; i++)
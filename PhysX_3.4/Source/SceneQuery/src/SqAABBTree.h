@@ -209,6 +209,11 @@ namespace Sq
 		PX_FORCE_INLINE	void						setNodes(AABBTreeRuntimeNode* nodes) { mRuntimePool = nodes;	}		
 		PX_FORCE_INLINE	PxU32						getTotalPrims()		const	{ return mTotalPrims;	}
 
+		// Filter masks, by node index: the OR of the masks of the objects below each node. NULL until computed, and again
+		// when the nodes change (rebuild or merge). Refits keep them, since moving objects doesn't change their masks.
+		PX_FORCE_INLINE	const PxU32*				getFilterMasks()	const	{ return mFilterMasks;	}
+						void						computeFilterMasks(const PxU32* objectMasks, PxU32 nbObjects);
+
 #if PX_DEBUG 
 						void						validate()			const;
 #endif
@@ -223,6 +228,7 @@ namespace Sq
 						AABBTreeRuntimeNode*		mRuntimePool;		//!< Linear pool of nodes.
 						NodeAllocator				mNodeAllocator;
 						PxU32*						mParentIndices;		//!< PT: hot/cold split, keep parent data in separate array
+						PxU32*						mFilterMasks;		//!< Filter mask of each node, see computeFilterMasks()
 		// Stats
 						PxU32						mTotalNbNodes;		//!< Number of nodes in the tree.
 						PxU32						mTotalPrims;		//!< Copy of final BuildStats::mTotalPrims
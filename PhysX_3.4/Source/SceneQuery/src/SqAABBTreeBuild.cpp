@@ -32,7 +32,9 @@
 
 #include "PsMathUtils.h"
 #include "PsFoundation.h"
+#include "PsSort.h"
 #include "GuInternal.h"
+#include "CmParallelFor.h"
 
 using namespace physx;
 using namespace Sq;
@@ -76,6 +78,39 @@ void NodeAllocator::init(PxU32 nbPrimitives, PxU32 limit)
 	mTotalNbNodes = 1;
 }
 
+void NodeAllocator::initSubtree(PxU32 nbPrimitives, PxU32 limit)
+{
+	// Same estimate as init(), the subtree root itself is already allocated
+	const PxU32 maxSize = nbPrimitives * 2 - 1;
+	const PxU32 estimatedFinalSize = maxSize <= 1024 ? maxSize : maxSize / limit;
+	mPool = PX_NEW(AABBTreeBuildNode)[estimatedFinalSize];
+	PxMemZero(mPool, sizeof(AABBTreeBuildNode)*estimatedFinalSize);
+
+	mSlabs.pushBack(Slab(mPool, 0, estimatedFinalSize));
+	mCurrentSlabIndex = 0;
+	mTotalNbNodes = 0;
+}
+
+void NodeAllocator::takeSlabs(NodeAllocator& other)
+{
+	const PxU32 nbSlabs = other.mSlabs.size();
+	for(PxU32 i=0;i<nbSlabs;i++)
+	{
+		Slab& s = other.mSlabs[i];
+		if(s.mNbUsedNodes)
+			mSlabs.pushBack(s);
+		else
+			PX_DELETE_ARRAY(s.mPool);
+	}
+	mCurrentSlabIndex = mSlabs.size() - 1;
+	mTotalNbNodes += other.mTotalNbNodes;
+
+	other.mSlabs.reset();
+	other.mPool = NULL;
+	other.mCurrentSlabIndex = 0;
+	other.mTotalNbNodes = 0;
+}
+
 // PT: TODO: inline this?
 AABBTreeBuildNode* NodeAllocator::getBiNode()
 {
@@ -142,6 +177,149 @@ static PxU32 split(const PxBounds3& box, PxU32 nb, PxU32* const PX_RESTRICT prim
 	return nbPos;
 }
 
+#define SAH_NB_BINS	16
+
+namespace
+{
+	struct SAHBin
+	{
+		Vec4V	mMin;
+		Vec4V	mMax;
+		PxU32	mCount;
+	};
+
+	// half the surface area is enough to compare the costs
+	PX_FORCE_INLINE float halfArea(const Vec4V& minV, const Vec4V& maxV)
+	{
+		PX_ALIGN(16, PxVec4) d;
+		V4StoreA(V4Sub(maxV, minV), &d.x);
+		return d.x*d.y + d.y*d.z + d.z*d.x;
+	}
+
+	PX_FORCE_INLINE PxU32 getSAHBin(float value, float minValue, float scale)
+	{
+		const PxU32 bin = PxU32((value - minValue)*scale);
+		return PxMin(bin, PxU32(SAH_NB_BINS-1));
+	}
+}
+
+// binned SAH split. The box centers are binned along the 3 axes, and we keep the split between two bins that
+// minimizes area(pos)*count(pos) + area(neg)*count(neg). Returns the number of primitives moved to the positive
+// side, or 0 if all the centers are at the same place.
+static PxU32 splitSAH(PxU32 nb, PxU32* const PX_RESTRICT prims, const AABBTreeBuildParams& params)
+{
+	const PxBounds3* PX_RESTRICT boxes = params.mAABBArray;
+	const PxVec3* PX_RESTRICT centers = params.mCache;
+
+	PxVec3 centerMin = centers[prims[0]];
+	PxVec3 centerMax = centerMin;
+	for(PxU32 i=1;i<nb;i++)
+	{
+		centerMin = centerMin.minimum(centers[prims[i]]);
+		centerMax = centerMax.maximum(centers[prims[i]]);
+	}
+
+	// slightly less than SAH_NB_BINS so that the largest center lands in the last bin
+	float scales[3];
+	for(PxU32 axis=0;axis<3;axis++)
+	{
+		const float extent = centerMax[axis] - centerMin[axis];
+		scales[axis] = extent > 0.0f ? (float(SAH_NB_BINS)*0.9999f)/extent : 0.0f;
+	}
+	if(scales[0]==0.0f && scales[1]==0.0f && scales[2]==0.0f)
+		return 0;
+
+	SAHBin bins[3][SAH_NB_BINS];
+	const Vec4V maxV = V4Load(PX_MAX_F32);
+	const Vec4V minV = V4Load(-PX_MAX_F32);
+	for(PxU32 axis=0;axis<3;axis++)
+	{
+		for(PxU32 i=0;i<SAH_NB_BINS;i++)
+		{
+			bins[axis][i].mMin = maxV;
+			bins[axis][i].mMax = minV;
+			bins[axis][i].mCount = 0;
+		}
+	}
+
+	for(PxU32 i=0;i<nb;i++)
+	{
+		const PxU32 index = prims[i];
+		const Vec4V boxMinV = V4LoadU(&boxes[index].minimum.x);
+		const Vec4V boxMaxV = V4LoadU(&boxes[index].maximum.x);
+		for(PxU32 axis=0;axis<3;axis++)
+		{
+			if(scales[axis]==0.0f)
+				continue;
+			SAHBin& bin = bins[axis][getSAHBin(centers[index][axis], centerMin[axis], scales[axis])];
+			bin.mMin = V4Min(bin.mMin, boxMinV);
+			bin.mMax = V4Max(bin.mMax, boxMaxV);
+			bin.mCount++;
+		}
+	}
+
+	float bestCost = PX_MAX_F32;
+	PxU32 bestAxis = 0xffffffff;
+	PxU32 bestBin = 0;
+	for(PxU32 axis=0;axis<3;axis++)
+	{
+		if(scales[axis]==0.0f)
+			continue;
+
+		// costs of the negative sides (bins 0 to i), then add the positive sides (bins i+1 to the end) going backwards
+		float costs[SAH_NB_BINS-1];
+		Vec4V accMinV = maxV;
+		Vec4V accMaxV = minV;
+		PxU32 count = 0;
+		for(PxU32 i=0;i<SAH_NB_BINS-1;i++)
+		{
+			const SAHBin& bin = bins[axis][i];
+			accMinV = V4Min(accMinV, bin.mMin);
+			accMaxV = V4Max(accMaxV, bin.mMax);
+			count += bin.mCount;
+			costs[i] = count ? halfArea(accMinV, accMaxV)*float(count) : PX_MAX_F32;
+		}
+
+		accMinV = maxV;
+		accMaxV = minV;
+		count = 0;
+		for(PxU32 i=SAH_NB_BINS-1;i>0;i--)
+		{
+			const SAHBin& bin = bins[axis][i];
+			accMinV = V4Min(accMinV, bin.mMin);
+			accMaxV = V4Max(accMaxV, bin.mMax);
+			count += bin.mCount;
+			if(!count || costs[i-1]==PX_MAX_F32)
+				continue;
+
+			const float cost = costs[i-1] + halfArea(accMinV, accMaxV)*float(count);
+			if(cost<bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = i-1;
+			}
+		}
+	}
+
+	if(bestAxis==0xffffffff)
+		return 0;
+
+	// Reorganize the list of indices in this order: positive - negative, as split() does
+	PxU32 nbPos = 0;
+	for(PxU32 i=0;i<nb;i++)
+	{
+		const PxU32 index = prims[i];
+		if(getSAHBin(centers[index][bestAxis], centerMin[bestAxis], scales[bestAxis]) > bestBin)
+		{
+			prims[i] = prims[nbPos];
+			prims[nbPos] = index;
+			nbPos++;
+		}
+	}
+	return nbPos;
+}
+
 void AABBTreeBuildNode::subdivide(const AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& allocator, PxU32* const indices)
 {
 	PxU32* const PX_RESTRICT primitives = indices + mNodeIndex;
@@ -182,6 +360,15 @@ void AABBTreeBuildNode::subdivide(const AABBTreeBuildParams& params, BuildStats&
 
 	bool validSplit = true;
 	PxU32 nbPos;
+	if(params.mBuildStrategy == BUILD_STRATEGY_SAH)
+	{
+		nbPos = splitSAH(nbPrims, primitives, params);
+
+		// Check split validity
+		if (!nbPos || nbPos == nbPrims)
+			validSplit = false;
+	}
+	else
 	{
 		// Compute variances
 		Vec4V varsV = V4Zero();
@@ -237,7 +424,7 @@ void AABBTreeBuildNode::subdivide(const AABBTreeBuildParams& params, BuildStats&
 	Neg->mNbPrimitives = mNbPrimitives - nbPos;
 }
 
-void AABBTreeBuildNode::_buildHierarchy(AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& nodeBase, PxU32* const indices)
+void AABBTreeBuildNode::_buildHierarchy(const AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& nodeBase, PxU32* const indices)
 {
 	// Subdivide current node
 	subdivide(params, stats, nodeBase, indices);
@@ -254,3 +441,106 @@ void AABBTreeBuildNode::_buildHierarchy(AABBTreeBuildParams& params, BuildStats&
 
 	stats.mTotalPrims += mNbPrimitives;
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	// below this number of primitives the calling thread builds the tree alone
+	const PxU32 gParallelBuildMinPrimitives = 4096;
+	// Subtrees per thread. Their sizes differ, so more subtrees than threads balance the load.
+	const PxU32 gParallelBuildSubtreesPerThread = 8;
+	const PxU32 gParallelBuildMinSubtreePrimitives = 256;
+
+	struct SubtreeBuild : public Ps::UserAllocated
+	{
+		AABBTreeBuildNode*	mRoot;
+		NodeAllocator		mAllocator;
+		BuildStats			mStats;
+	};
+
+	struct ParallelBuildContext
+	{
+		const AABBTreeBuildParams*	mParams;
+		PxU32*						mIndices;
+		SubtreeBuild*				mSubtrees;
+	};
+
+	void buildSubtrees(void* context, PxU32 start, PxU32 nb)
+	{
+		const ParallelBuildContext& ctx = *reinterpret_cast<const ParallelBuildContext*>(context);
+		for(PxU32 i=start;i<start+nb;i++)
+		{
+			SubtreeBuild& subtree = ctx.mSubtrees[i];
+			subtree.mAllocator.initSubtree(subtree.mRoot->mNbPrimitives, ctx.mParams->mLimit);
+			subtree.mRoot->_buildHierarchy(*ctx.mParams, subtree.mStats, subtree.mAllocator, ctx.mIndices);
+		}
+	}
+
+	// Largest subtrees first, so that the last ones to finish are small
+	struct SubtreeSizeCompare
+	{
+		PX_FORCE_INLINE bool operator()(const AABBTreeBuildNode* a, const AABBTreeBuildNode* b) const
+		{
+			return a->mNbPrimitives > b->mNbPrimitives;
+		}
+	};
+}
+
+void Sq::buildHierarchy(const AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& allocator, PxU32* const indices)
+{
+	AABBTreeBuildNode* root = allocator.mPool;
+	const PxU32 nbWorkers = params.mDispatcher ? params.mDispatcher->getWorkerCount() : 0;
+	if(!nbWorkers || params.mNbPrimitives < gParallelBuildMinPrimitives)
+	{
+		root->_buildHierarchy(params, stats, allocator, indices);
+		return;
+	}
+
+	// The calling thread splits the top of the tree until the nodes are small enough to be built as independent subtrees.
+	// The split only depends on the worker count, never on the timing, so the tree is the same from build to build.
+	const PxU32 maxSubtreePrims = PxMax(params.mNbPrimitives / ((nbWorkers + 1)*gParallelBuildSubtreesPerThread), gParallelBuildMinSubtreePrimitives);
+	Ps::Array<AABBTreeBuildNode*> roots;
+	Ps::Array<AABBTreeBuildNode*> stack;
+	stack.pushBack(root);
+	while(stack.size())
+	{
+		AABBTreeBuildNode* node = stack.popBack();
+		if(node->mNbPrimitives <= maxSubtreePrims)
+		{
+			roots.pushBack(node);
+			continue;
+		}
+
+		node->subdivide(params, stats, allocator, indices);
+		if(!node->isLeaf())
+		{
+			AABBTreeBuildNode* pos = const_cast<AABBTreeBuildNode*>(node->getPos());
+			stack.pushBack(pos + 1);
+			stack.pushBack(pos);
+		}
+		stats.mTotalPrims += node->mNbPrimitives;
+	}
+
+	const PxU32 nbSubtrees = roots.size();
+	Ps::sort(roots.begin(), nbSubtrees, SubtreeSizeCompare());
+
+	SubtreeBuild* subtrees = PX_NEW(SubtreeBuild)[nbSubtrees];
+	for(PxU32 i=0;i<nbSubtrees;i++)
+		subtrees[i].mRoot = roots[i];
+
+	ParallelBuildContext context;
+	context.mParams = &params;
+	context.mIndices = indices;
+	context.mSubtrees = subtrees;
+	Cm::blockingParallelFor(params.mDispatcher, nbSubtrees, 1, 1, buildSubtrees, &context, "Sq::AABBTree.parallelBuild");
+
+	// Gather the subtree nodes in a fixed order, after the nodes of the top of the tree
+	for(PxU32 i=0;i<nbSubtrees;i++)
+	{
+		allocator.takeSlabs(subtrees[i].mAllocator);
+		stats.increaseCount(subtrees[i].mStats.getCount());
+		stats.mTotalPrims += subtrees[i].mStats.mTotalPrims;
+	}
+	PX_DELETE_ARRAY(subtrees);
+}
@@ -39,6 +39,7 @@
 
 namespace physx
 {
+	class PxCpuDispatcher;
 
 	using namespace shdfnd::aos;
 
@@ -61,12 +62,19 @@ namespace physx
 			PX_FORCE_INLINE	PxU32	getCount()				const { return mCount; }
 		};
 
+		//! How the nodes are split during the AABB-tree build
+		enum BuildStrategy
+		{
+			BUILD_STRATEGY_CENTER,	//!< Split at the center of the node box, along the axis of greatest variance. Cheapest build, used for the progressive rebuilds
+			BUILD_STRATEGY_SAH		//!< Binned surface area heuristic. Better trees for queries, for about twice the build time
+		};
+
 		//! Contains AABB-tree build parameters
 		class AABBTreeBuildParams : public Ps::UserAllocated
 		{
 		public:
 			AABBTreeBuildParams(PxU32 limit = 1, PxU32 nb_prims = 0, const PxBounds3* boxes = NULL) :
-				mLimit(limit), mNbPrimitives(nb_prims), mAABBArray(boxes), mCache(NULL) {}
+				mLimit(limit), mNbPrimitives(nb_prims), mAABBArray(boxes), mCache(NULL), mBuildStrategy(BUILD_STRATEGY_CENTER), mDispatcher(NULL) {}
 			~AABBTreeBuildParams()
 			{
 				reset();
@@ -77,12 +85,16 @@ namespace physx
 				mLimit = mNbPrimitives = 0;
 				mAABBArray = NULL;
 				PX_FREE_AND_RESET(mCache);
+				mBuildStrategy = BUILD_STRATEGY_CENTER;
+				mDispatcher = NULL;
 			}
 
 			PxU32			mLimit;			//!< Limit number of primitives / node. If limit is 1, build a complete tree (2*N-1 nodes)
 			PxU32			mNbPrimitives;	//!< Number of (source) primitives.
 			const	PxBounds3*		mAABBArray;		//!< Shortcut to an app-controlled array of AABBs.
 			PxVec3*			mCache;			//!< Cache for AABB centers - managed by build code.
+			BuildStrategy	mBuildStrategy;	//!< Split strategy
+			PxCpuDispatcher*	mDispatcher;	//!< If set, large trees are built on the dispatcher workers. The build still returns once the tree is complete. Not used by progressive builds.
 		};
 
 		class NodeAllocator;
@@ -116,7 +128,7 @@ namespace physx
 
 			// Internal methods
 			void						subdivide(const AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& allocator, PxU32* const indices);
-			void						_buildHierarchy(AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& allocator, PxU32* const indices);
+			void						_buildHierarchy(const AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& allocator, PxU32* const indices);
 		};
 
 		// Progressive building
@@ -137,6 +149,10 @@ namespace physx
 
 			void						release();
 			void						init(PxU32 nbPrimitives, PxU32 limit);
+			// allocates the nodes of a subtree built separately, the subtree root belongs to another allocator
+			void						initSubtree(PxU32 nbPrimitives, PxU32 limit);
+			// moves the slabs of another allocator to this one, used to gather the subtrees
+			void						takeSlabs(NodeAllocator& other);
 			AABBTreeBuildNode*			getBiNode();
 
 			AABBTreeBuildNode*			mPool;
@@ -154,6 +170,10 @@ namespace physx
 			PxU32						mTotalNbNodes;
 		};
 
+		//! Builds the hierarchy below the root node of the allocator. Subtrees are built in parallel if params.mDispatcher is set
+		//! and the tree is large enough, the resulting tree doesn't depend on the number of threads.
+		void	buildHierarchy(const AABBTreeBuildParams& params, BuildStats& stats, NodeAllocator& allocator, PxU32* const indices);
+
 
 	} // namespace Sq
 
@@ -32,6 +32,7 @@
 
 #include "SqAABBTree.h"
 #include "SqPrunerTestsSIMD.h"
+#include "PsSort.h"
 
 namespace physx
 {
@@ -54,6 +55,16 @@ namespace physx
 
 		//////////////////////////////////////////////////////////////////////////
 
+		// Subtrees none of whose objects can pass the query filter, see PrunerCallback::mFilterMask. The masks are NULL when
+		// the query doesn't filter or the tree has no masks.
+		template<typename Node>
+		static PX_FORCE_INLINE bool culledByFilter(const PxU32* filterMasks, PxU32 filterMask, const Node* node, const Node* nodeBase)
+		{
+			return filterMasks && !(filterMasks[node - nodeBase] & filterMask);
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+
 		template<typename Test, typename Tree, typename Node>
 		class AABBTreeOverlap
 		{
@@ -64,6 +75,7 @@ namespace physx
 				Ps::InlineArray<const Node*, RAW_TRAVERSAL_STACK_SIZE> stack;
 				stack.forceSize_Unsafe(RAW_TRAVERSAL_STACK_SIZE);
 				const Node* const nodeBase = tree.getNodes();
+				const PxU32* filterMasks = visitor.mFilterMask ? tree.getFilterMasks() : NULL;
 				stack[0] = nodeBase;
 				PxU32 stackIndex = 1;
 
@@ -72,7 +84,7 @@ namespace physx
 					const Node* node = stack[--stackIndex];
 					Vec3V center, extents;
 					node->getAABBCenterExtentsV(&center, &extents);
-					while (test(center, extents))
+					while (!culledByFilter(filterMasks, visitor.mFilterMask, node, nodeBase) && test(center, extents))
 					{
 						if (node->isLeaf())
 						{
@@ -166,7 +178,7 @@ namespace physx
 			bool operator()(
 				const PrunerPayload* objects, const PxBounds3* boxes, const Tree& tree,
 				const PxVec3& origin, const PxVec3& unitDir, PxReal& maxDist, const PxVec3& inflation,
-				PrunerCallback& pcb)
+				PrunerCallback& pcb, const Node* root = NULL)	// root of the traversed subtree, the whole tree by default
 			{
 				using namespace Cm;
 
@@ -177,7 +189,8 @@ namespace physx
 				Ps::InlineArray<const Node*, RAW_TRAVERSAL_STACK_SIZE> stack;
 				stack.forceSize_Unsafe(RAW_TRAVERSAL_STACK_SIZE);
 				const Node* const nodeBase = tree.getNodes();
-				stack[0] = nodeBase;
+				const PxU32* filterMasks = pcb.mFilterMask ? tree.getFilterMasks() : NULL;
+				stack[0] = root ? root : nodeBase;
 				PxU32 stackIndex = 1;
 
 				PxReal oldMaxDist;
@@ -186,7 +199,7 @@ namespace physx
 					const Node* node = stack[stackIndex];
 					Vec3V center, extents;
 					node->getAABBCenterExtentsV2(&center, &extents);
-					if (test.check<tInflate>(center, extents))	// TODO: try timestamp ray shortening to skip this
+					if (!culledByFilter(filterMasks, pcb.mFilterMask, node, nodeBase) && test.check<tInflate>(center, extents))	// TODO: try timestamp ray shortening to skip this
 					{
 						PxReal md = maxDist; // has to be before the goto below to avoid compile error
 						while (!node->isLeaf())
@@ -195,11 +208,11 @@ namespace physx
 
 							Vec3V c0, e0;
 							children[0].getAABBCenterExtentsV2(&c0, &e0);
-							const PxU32 b0 = test.check<tInflate>(c0, e0);
+							const PxU32 b0 = !culledByFilter(filterMasks, pcb.mFilterMask, children, nodeBase) && test.check<tInflate>(c0, e0);
 
 							Vec3V c1, e1;
 							children[1].getAABBCenterExtentsV2(&c1, &e1);
-							const PxU32 b1 = test.check<tInflate>(c1, e1);
+							const PxU32 b1 = !culledByFilter(filterMasks, pcb.mFilterMask, children + 1, nodeBase) && test.check<tInflate>(c1, e1);
 
 							if (b0 && b1)	// if both intersect, push the one with the further center on the stack for later
 							{
@@ -231,6 +244,352 @@ namespace physx
 				return true;
 			}
 		};
+
+		//////////////////////////////////////////////////////////////////////////
+
+		// Raycasts a packet of up to 4 rays, each with its own distance and callback. The rays traverse the tree together as long
+		// as several of them overlap the nodes, a subtree only reached by one ray is traversed by AABBTreeRaycast for that ray.
+		// Returns the mask of the active rays whose callback didn't abort the query. The filter masks of the nodes are only used
+		// by the single ray traversals.
+		template <typename Tree, typename Node>
+		class AABBTreeRaycastPacket
+		{
+			struct StackEntry
+			{
+				const Node*	node;
+				PxU32		rays;
+			};
+
+		public:
+			PxU32 operator()(
+				const PrunerPayload* objects, const PxBounds3* boxes, const Tree& tree,
+				const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* maxDists, PrunerCallback* const* pcbs, PxU32 activeMask)
+			{
+				using namespace Cm;
+
+				if(!activeMask)
+					return 0;
+
+				// same center*2 and extents*2 trick as AABBTreeRaycast
+				Gu::RayPacketAABBTest test(origins, unitDirs, maxDists, activeMask, 2.0f);
+
+				Ps::InlineArray<StackEntry, RAW_TRAVERSAL_STACK_SIZE> stack;
+				stack.forceSize_Unsafe(RAW_TRAVERSAL_STACK_SIZE);
+				const Node* const nodeBase = tree.getNodes();
+				stack[0].node = nodeBase;
+				stack[0].rays = activeMask;
+				PxU32 stackIndex = 1;
+
+				PxU32 againMask = activeMask;
+				while (stackIndex--)
+				{
+					const Node* node = stack[stackIndex].node;
+					PxU32 rays = stack[stackIndex].rays & againMask;
+					if(!rays)
+						continue;
+
+					// distances may have shrunk since the node was pushed
+					Vec3V center, extents;
+					node->getAABBCenterExtentsV2(&center, &extents);
+					rays &= test.check(center, extents);
+
+					while (rays)
+					{
+						if(!(rays & (rays - 1)))
+						{
+							// the packet diverged, finish the subtree with a single ray
+							const PxU32 ray = Ps::lowestSetBit(rays);
+							if(!AABBTreeRaycast<false, Tree, Node>()(objects, boxes, tree, origins[ray], unitDirs[ray], *maxDists[ray], PxVec3(0.0f), *pcbs[ray], node))
+								againMask &= ~(1<<ray);
+							else
+								test.setDistance(ray, *maxDists[ray]);
+							break;
+						}
+
+						if (node->isLeaf())
+						{
+							againMask = doLeafTest(node, rays, test, objects, boxes, tree, maxDists, pcbs, againMask);
+							break;
+						}
+
+						const Node* children = node->getPos(nodeBase);
+
+						Vec3V c0, e0;
+						children[0].getAABBCenterExtentsV2(&c0, &e0);
+						const PxU32 rays0 = rays & test.check(c0, e0);
+
+						Vec3V c1, e1;
+						children[1].getAABBCenterExtentsV2(&c1, &e1);
+						const PxU32 rays1 = rays & test.check(c1, e1);
+
+						if (rays0 && rays1)	// push the child further along the direction of the first ray for later
+						{
+							// & 1 because FAllGrtr behavior differs across platforms
+							const Vec3V dir = V3LoadU(unitDirs[Ps::lowestSetBit(rays)]);
+							const PxU32 bit = FAllGrtr(V3Dot(V3Sub(c1, c0), dir), FZero()) & 1;
+							stack[stackIndex].node = children + bit;
+							stack[stackIndex].rays = bit ? rays1 : rays0;
+							stackIndex++;
+							node = children + (1 - bit);
+							rays = bit ? rays0 : rays1;
+							if (stackIndex == stack.capacity())
+								stack.resizeUninitialized(stack.capacity() * 2);
+						}
+						else if (rays0)
+						{
+							node = children;
+							rays = rays0;
+						}
+						else if (rays1)
+						{
+							node = children + 1;
+							rays = rays1;
+						}
+						else
+							break;
+					}
+				}
+				return againMask;
+			}
+
+		private:
+			static PX_FORCE_INLINE PxU32 doLeafTest(const Node* node, PxU32 rays, Gu::RayPacketAABBTest& test,
+				const PrunerPayload* objects, const PxBounds3* boxes, const Tree& tree,
+				PxReal* const* maxDists, PrunerCallback* const* pcbs, PxU32 againMask)
+			{
+				PxU32 nbPrims = node->getNbPrimitives();
+				const bool doBoxTest = nbPrims > 1;
+				const PxU32* prims = node->getPrimitives(tree.getIndices());
+				while (nbPrims--)
+				{
+					const PoolIndex poolIndex = *prims++;
+
+					PxU32 primRays = rays & againMask;
+					if (doBoxTest)
+					{
+						Vec4V center_, extents_;
+						getBoundsTimesTwo(center_, extents_, boxes, poolIndex);
+						primRays &= test.check(Vec3V_From_Vec4V(center_), Vec3V_From_Vec4V(extents_));
+					}
+
+					while (primRays)
+					{
+						const PxU32 ray = Ps::lowestSetBit(primRays);
+						primRays &= primRays - 1;
+
+						PxReal md = *maxDists[ray];
+						const PxReal oldMaxDist = md;
+						if (!pcbs[ray]->invoke(md, objects[poolIndex]))
+						{
+							againMask &= ~(1<<ray);
+							continue;
+						}
+
+						if (md < oldMaxDist)
+						{
+							*maxDists[ray] = md;
+							test.setDistance(ray, md);
+						}
+					}
+				}
+				return againMask;
+			}
+		};
+
+		//////////////////////////////////////////////////////////////////////////
+
+		// Squared distance from a point to a box, 0 if the point is inside
+		static PX_FORCE_INLINE FloatV pointAABBDistanceSquared(const Vec3V& point, const Vec3V& center, const Vec3V& extents)
+		{
+			const Vec3V d = V3Max(V3Sub(V3Abs(V3Sub(point, center)), extents), V3Zero());
+			return V3Dot(d, d);
+		}
+
+		struct NearestCandidate
+		{
+			PxReal		mDistanceSquared;
+			PxU32		mIndex;
+
+			PX_FORCE_INLINE bool operator<(const NearestCandidate& other) const { return mDistanceSquared < other.mDistanceSquared; }
+		};
+
+		// Visits the objects whose bounds are within maxDist of the point, closest bounds first. The callback is passed the distance
+		// to the bounds and returns the new search radius in it. Used by the pruners without a hierarchy.
+		static PX_NOINLINE bool nearestLinear(const PrunerPayload* objects, const PxBounds3* boxes, PxU32 nbObjects,
+			const PxVec3& point, PxReal& maxDist, PrunerCallback& pcb)
+		{
+			if(!nbObjects)
+				return true;
+
+			const Vec3V p = V3LoadU(point);
+			const PxReal maxDist2 = maxDist*maxDist;
+
+			Ps::Array<NearestCandidate> candidates;
+			for(PxU32 i=0;i<nbObjects;i++)
+			{
+				const Vec3V minV = V3LoadU(boxes[i].minimum);
+				const Vec3V maxV = V3LoadU(boxes[i].maximum);
+				const Vec3V d = V3Max(V3Max(V3Sub(minV, p), V3Sub(p, maxV)), V3Zero());
+				NearestCandidate candidate;
+				FStore(V3Dot(d, d), &candidate.mDistanceSquared);
+				if(candidate.mDistanceSquared <= maxDist2)
+				{
+					candidate.mIndex = i;
+					candidates.pushBack(candidate);
+				}
+			}
+
+			if(candidates.size() > 1)
+				Ps::sort(candidates.begin(), candidates.size());
+
+			for(PxU32 i=0;i<candidates.size();i++)
+			{
+				if(candidates[i].mDistanceSquared > maxDist*maxDist)
+					break;
+
+				PxReal md = PxSqrt(candidates[i].mDistanceSquared);
+				if(!pcb.invoke(md, objects[candidates[i].mIndex]))
+					return false;
+				if(md < maxDist)
+					maxDist = md;
+			}
+			return true;
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+
+		// Best-first traversal for nearest object queries: nodes are visited by increasing distance to the point and the traversal
+		// stops once the closest remaining node is further than maxDist. Leaf objects are passed to the callback with the distance
+		// to their bounds, the callback returns the new search radius in it (e.g. the k-th closest exact distance so far).
+		template <typename Tree, typename Node>
+		class AABBTreeNearest
+		{
+			struct HeapEntry
+			{
+				PxReal		mDistanceSquared;
+				const Node*	mNode;
+			};
+
+			static PX_FORCE_INLINE void push(Ps::InlineArray<HeapEntry, RAW_TRAVERSAL_STACK_SIZE>& heap, const HeapEntry& entry)
+			{
+				// min-heap on the distance
+				PxU32 i = heap.size();
+				heap.pushBack(entry);
+				while(i)
+				{
+					const PxU32 parent = (i - 1) >> 1;
+					if(heap[parent].mDistanceSquared <= entry.mDistanceSquared)
+						break;
+					heap[i] = heap[parent];
+					i = parent;
+				}
+				heap[i] = entry;
+			}
+
+			static PX_FORCE_INLINE HeapEntry pop(Ps::InlineArray<HeapEntry, RAW_TRAVERSAL_STACK_SIZE>& heap)
+			{
+				const HeapEntry top = heap[0];
+				const HeapEntry last = heap.popBack();
+				const PxU32 size = heap.size();
+				if(size)
+				{
+					PxU32 i = 0;
+					while(true)
+					{
+						PxU32 child = 2*i + 1;
+						if(child >= size)
+							break;
+						if(child + 1 < size && heap[child + 1].mDistanceSquared < heap[child].mDistanceSquared)
+							child++;
+						if(last.mDistanceSquared <= heap[child].mDistanceSquared)
+							break;
+						heap[i] = heap[child];
+						i = child;
+					}
+					heap[i] = last;
+				}
+				return top;
+			}
+
+		public:
+			bool operator()(const PrunerPayload* objects, const PxBounds3* boxes, const Tree& tree,
+				const PxVec3& point, PxReal& maxDist, PrunerCallback& pcb)
+			{
+				const Node* const nodeBase = tree.getNodes();
+				if(!nodeBase)
+					return true;
+
+				const PxU32* filterMasks = pcb.mFilterMask ? tree.getFilterMasks() : NULL;
+				if(culledByFilter(filterMasks, pcb.mFilterMask, nodeBase, nodeBase))
+					return true;
+
+				const Vec3V p = V3LoadU(point);
+				const FloatV half = FLoad(0.5f);
+
+				Ps::InlineArray<HeapEntry, RAW_TRAVERSAL_STACK_SIZE> heap;
+				HeapEntry root;
+				{
+					Vec3V center, extents;
+					nodeBase->getAABBCenterExtentsV(&center, &extents);
+					FStore(pointAABBDistanceSquared(p, center, extents), &root.mDistanceSquared);
+					root.mNode = nodeBase;
+				}
+				if(root.mDistanceSquared > maxDist*maxDist)
+					return true;
+				heap.pushBack(root);
+
+				while(heap.size())
+				{
+					const HeapEntry entry = pop(heap);
+					// every node left is further, maxDist only shrinks
+					if(entry.mDistanceSquared > maxDist*maxDist)
+						break;
+
+					const Node* node = entry.mNode;
+					if(node->isLeaf())
+					{
+						PxU32 nbPrims = node->getNbPrimitives();
+						const PxU32* prims = node->getPrimitives(tree.getIndices());
+						while(nbPrims--)
+						{
+							const PoolIndex poolIndex = *prims++;
+
+							Vec4V center2, extents2;
+							getBoundsTimesTwo(center2, extents2, boxes, poolIndex);
+							PxReal distance2;
+							FStore(pointAABBDistanceSquared(p, Vec3V_From_Vec4V(V4Scale(center2, half)), Vec3V_From_Vec4V(V4Scale(extents2, half))), &distance2);
+							if(distance2 > maxDist*maxDist)
+								continue;
+
+							PxReal md = PxSqrt(distance2);
+							if(!pcb.invoke(md, objects[poolIndex]))
+								return false;
+							if(md < maxDist)
+								maxDist = md;
+						}
+						continue;
+					}
+
+					const Node* children = node->getPos(nodeBase);
+					for(PxU32 i=0;i<2;i++)
+					{
+						if(culledByFilter(filterMasks, pcb.mFilterMask, children + i, nodeBase))
+							continue;
+
+						Vec3V center, extents;
+						children[i].getAABBCenterExtentsV(&center, &extents);
+						HeapEntry child;
+						FStore(pointAABBDistanceSquared(p, center, extents), &child.mDistanceSquared);
+						if(child.mDistanceSquared <= maxDist*maxDist)
+						{
+							child.mNode = children + i;
+							push(heap, child);
+						}
+					}
+				}
+				return true;
+			}
+		};
 	}
 }
 
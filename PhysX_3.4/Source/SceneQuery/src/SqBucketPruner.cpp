@@ -39,6 +39,7 @@
 #include "PsBitUtils.h"
 #include "PsIntrinsics.h"
 #include "GuBounds.h"
+#include "SqAABBTreeQuery.h"
 
 using namespace physx::shdfnd::aos;
 
@@ -1586,6 +1587,217 @@ PxAgain BucketPrunerCore::sweep(const ShapeData& queryVolume, const PxVec3& unit
 	return ::stab<1>(*this, pcb, queryVolume.getPrunerInflatedWorldAABB().getCenter(), unitDir, inOutDistance, extents);
 }
 
+////////////////////////////////////////////////// The core arrays are kept up to date even when the sorted arrays are dirty, so they are searched directly
+PxAgain BucketPrunerCore::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	if(!nearestLinear(mFreeObjects, mFreeBounds, mNbFree, point, inOutDistance, pcb))
+		return false;
+	return nearestLinear(mCoreObjects, mCoreBoxes, mCoreNbObjects, point, inOutDistance, pcb);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Raycast packets walk the bucket hierarchy once for all the rays, each bucket box being tested against the rays that
+// reached its parent. The objects of the buckets are then processed ray by ray, with the limits along the sort axis.
+#ifdef CAN_USE_MOVEMASK
+	typedef RayParams PacketRayTest;
+
+	static PX_FORCE_INLINE void initPacketRayTest(PacketRayTest* test, const PxVec3& rayOrig, const PxVec3& rayDir, float maxDist)
+	{
+	#ifdef USE_SIMD
+		test->padding0 = test->padding1 = test->padding2 = test->padding3 = 0.0f;
+	#endif
+		precomputeRayData(test, rayOrig, rayDir, maxDist);
+	}
+
+	static PX_FORCE_INLINE IntBool segmentAABBRay(const BucketBox& box, PacketRayTest* test)
+	{
+		return _segmentAABB<0>(box, test);
+	}
+#else
+	typedef BPRayAABBTest PacketRayTest;
+
+	static PX_FORCE_INLINE void initPacketRayTest(PacketRayTest* test, const PxVec3& rayOrig, const PxVec3& rayDir, float maxDist)
+	{
+		PX_PLACEMENT_NEW(test, BPRayAABBTest)(rayOrig, rayDir, maxDist, PxVec3(0.0f));
+	}
+
+	static PX_FORCE_INLINE IntBool segmentAABBRay(const BucketBox& box, PacketRayTest* test)
+	{
+		return _segmentAABB<0>(box, *test);
+	}
+#endif
+
+// returns the rays of the mask overlapping the box
+static PX_FORCE_INLINE PxU32 segmentAABBPacket(const BucketBox& box, PacketRayTest* tests, PxU32 rays)
+{
+	PxU32 hits = 0;
+	while(rays)
+	{
+		const PxU32 ray = lowestSetBit(rays);
+		rays &= rays - 1;
+		if(segmentAABBRay(box, tests + ray))
+			hits |= 1<<ray;
+	}
+	return hits;
+}
+
+static PxU32 stabPacket(const BucketPrunerCore& core, PrunerCallback* const* pcbs, const PxVec3* rayOrigs, const PxVec3* rayDirs, float* const* maxDists, PxU32 activeMask)
+{
+	const PxU32 nb = core.mSortedNb;
+	if(!nb && !core.mNbFree)
+		return activeMask;
+
+	PX_ALIGN(16, PxU8 testBuffer[sizeof(PacketRayTest)*SQ_RAY_PACKET_SIZE]);
+	PacketRayTest* tests = reinterpret_cast<PacketRayTest*>(testBuffer);
+
+	bool clipBoundsValid = false;
+	PxVec3 boxMin, boxMax;
+
+	PxU32 rays = activeMask;
+	while(rays)
+	{
+		const PxU32 ray = lowestSetBit(rays);
+		rays &= rays - 1;
+
+		if(*maxDists[ray]==PX_MAX_F32)
+		{
+			// the clip bounds are shared by the rays of the packet
+			if(!clipBoundsValid)
+			{
+				boxMin = core.mGlobalBox.getMin();
+				boxMax = core.mGlobalBox.getMax();
+				for(PxU32 i=0;i<core.mNbFree;i++)
+				{
+					boxMin = boxMin.minimum(core.mFreeBounds[i].minimum);
+					boxMax = boxMax.maximum(core.mFreeBounds[i].maximum);
+				}
+				clipBoundsValid = true;
+			}
+			clipRay(rayOrigs[ray], rayDirs[ray], *maxDists[ray], boxMin, boxMax);
+		}
+
+		initPacketRayTest(tests + ray, rayOrigs[ray], rayDirs[ray], *maxDists[ray]);
+	}
+
+	PxU32 againMask = activeMask;
+	for(PxU32 i=0;i<core.mNbFree;i++)
+	{
+		BucketBox tmp;
+		tmp.mCenter = core.mFreeBounds[i].getCenter();
+		tmp.mExtents = core.mFreeBounds[i].getExtents();
+
+		PxU32 hits = segmentAABBPacket(tmp, tests, againMask);
+		while(hits)
+		{
+			const PxU32 ray = lowestSetBit(hits);
+			hits &= hits - 1;
+			if(!pcbs[ray]->invoke(*maxDists[ray], core.mFreeObjects[i]))
+				againMask &= ~(1<<ray);
+		}
+	}
+
+	if(!nb)
+		return againMask;
+
+	const PxU32 packetRays = segmentAABBPacket(core.mGlobalBox, tests, againMask);
+	if(!packetRays)
+		return againMask;
+
+	const PxU32 sortAxis = core.mSortAxis;
+	PxU32 rayMinLimitInt[SQ_RAY_PACKET_SIZE], rayMaxLimitInt[SQ_RAY_PACKET_SIZE];
+	rays = packetRays;
+	while(rays)
+	{
+		const PxU32 ray = lowestSetBit(rays);
+		rays &= rays - 1;
+
+		float rayMinLimit, rayMaxLimit;
+		computeRayLimits(rayMinLimit, rayMaxLimit, rayOrigs[ray], rayDirs[ray], *maxDists[ray], sortAxis);
+
+		const PxU32* binaryMinLimit = reinterpret_cast<const PxU32*>(&rayMinLimit);
+		const PxU32* binaryMaxLimit = reinterpret_cast<const PxU32*>(&rayMaxLimit);
+		rayMinLimitInt[ray] = encodeFloat(binaryMinLimit[0]);
+		rayMaxLimitInt[ray] = encodeFloat(binaryMaxLimit[0]);
+	}
+
+#ifdef NODE_SORT
+	// the buckets are sorted along the first ray of the packet
+	const PxU32 dirIndex = computeDirMask(rayDirs[lowestSetBit(packetRays)]);
+	PxU32 orderi = core.mLevel1.mOrder[dirIndex];
+
+	for(PxU32 i_=0;i_<5;i_++)
+	{
+		const PxU32 i = orderi&7;	orderi>>=3;
+#else
+	for(PxU32 i=0;i<5;i++)
+	{
+#endif
+		const PxU32 rays1 = core.mLevel1.mCounters[i] ? segmentAABBPacket(core.mLevel1.mBucketBox[i], tests, packetRays & againMask) : 0;
+		if(rays1)
+		{
+#ifdef NODE_SORT
+			PxU32 orderj = core.mLevel2[i].mOrder[dirIndex];
+
+			for(PxU32 j_=0;j_<5;j_++)
+			{
+				const PxU32 j = orderj&7;	orderj>>=3;
+#else
+			for(PxU32 j=0;j<5;j++)
+			{
+#endif
+				const PxU32 rays2 = core.mLevel2[i].mCounters[j] ? segmentAABBPacket(core.mLevel2[i].mBucketBox[j], tests, rays1 & againMask) : 0;
+				if(rays2)
+				{
+					const BucketPrunerNode& parent = core.mLevel3[i][j];
+					const PxU32 parentOffset = core.mLevel1.mOffsets[i] + core.mLevel2[i].mOffsets[j];
+
+#ifdef NODE_SORT
+					PxU32 orderk = parent.mOrder[dirIndex];
+
+					for(PxU32 k_=0;k_<5;k_++)
+					{
+						const PxU32 k = orderk&7;	orderk>>=3;
+#else
+					for(PxU32 k=0;k<5;k++)
+					{
+#endif
+						const PxU32 nbInBucket = parent.mCounters[k];
+						PxU32 rays3 = nbInBucket ? segmentAABBPacket(parent.mBucketBox[k], tests, rays2 & againMask) : 0;
+						const PxU32 offset = parentOffset + parent.mOffsets[k];
+						while(rays3)
+						{
+							const PxU32 ray = lowestSetBit(rays3);
+							rays3 &= rays3 - 1;
+
+							const PxAgain again = processBucket<0>(	nbInBucket, core.mSortedWorldBoxes, core.mSortedObjects,
+																	offset, core.mSortedNb,
+																	rayOrigs[ray], rayDirs[ray], *maxDists[ray],
+#ifdef CAN_USE_MOVEMASK
+																	tests + ray,
+#else
+																	tests[ray], PxVec3(0.0f),
+#endif
+																	*pcbs[ray],
+																	rayMinLimitInt[ray], rayMaxLimitInt[ray],
+																	sortAxis);
+							if(!again)
+								againMask &= ~(1<<ray);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return againMask;
+}
+
+PxU32 BucketPrunerCore::raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+{
+	return ::stabPacket(*this, callbacks, origins, unitDirs, inOutDistances, activeMask);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template<bool doAssert, typename Test>
@@ -2259,6 +2471,12 @@ PxAgain BucketPruner::sweep(const ShapeData& queryVolume, const PxVec3& unitDir,
 	return mCore.sweep(queryVolume, unitDir, inOutDistance, pcb);
 }
 
+PxAgain BucketPruner::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mCore.mDirty);
+	return mCore.nearest(point, inOutDistance, pcb);
+}
+
 PxAgain BucketPruner::overlap(const ShapeData& queryVolume, PrunerCallback& pcb) const
 {
 	PX_ASSERT(!mCore.mDirty);
@@ -2275,6 +2493,14 @@ PxAgain BucketPruner::raycast(const PxVec3& origin, const PxVec3& unitDir, PxRea
 	return mCore.raycast(origin, unitDir, inOutDistance, pcb);
 }
 
+PxU32 BucketPruner::raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+{
+	PX_ASSERT(!mCore.mDirty);
+	if(mCore.mDirty)
+		return activeMask; // it may crash otherwise
+	return mCore.raycastPacket(origins, unitDirs, inOutDistances, callbacks, activeMask);
+}
+
 void BucketPruner::visualize(Cm::RenderOutput& out, PxU32 color) const
 {
 	mCore.visualize(out, color);
@@ -193,8 +193,10 @@ namespace Sq
 						PxU32				removeMarkedObjects(PxU32 timeStamp);
 
 						PxAgain				raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+						PxU32				raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const;
 						PxAgain				overlap(const Gu::ShapeData& queryVolume, PrunerCallback&) const;
 						PxAgain				sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+						PxAgain				nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&) const;
 
 						void				shiftOrigin(const PxVec3& shift);
 
@@ -256,10 +258,14 @@ namespace Sq
 		virtual void				    updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count);
 		virtual	void					commit();
 		virtual	PxAgain					raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+		virtual	PxU32					raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const;
 		virtual	PxAgain					overlap(const Gu::ShapeData& queryVolume, PrunerCallback&) const;
 		virtual	PxAgain					sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+		virtual	PxAgain					nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&) const;
 		virtual	const PrunerPayload&	getPayload(PrunerHandle handle)						const	{ return mPool.getPayload(handle);			}
 		virtual	const PrunerPayload&	getPayload(PrunerHandle handle, PxBounds3*& bounds)	const	{ return mPool.getPayload(handle, bounds);	}
+		virtual	PxU32					getObjects(const PxBounds3*& bounds, const PrunerPayload*& payloads, const PrunerHandle*& handles)	const
+										{ bounds = mPool.getCurrentWorldBoxes(); payloads = mPool.getObjects(); handles = mPool.mIndexToHandle; return mPool.getNbActiveObjects();	}
 		virtual	void					preallocate(PxU32 entries)									{ mPool.preallocate(entries);				}
 		virtual	void					shiftOrigin(const PxVec3& shift);
 		virtual	void					visualize(Cm::RenderOutput& out, PxU32 color) const;
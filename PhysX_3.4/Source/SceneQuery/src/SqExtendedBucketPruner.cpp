@@ -679,6 +679,34 @@ PxAgain ExtendedBucketPruner::raycast(const PxVec3& origin, const PxVec3& unitDi
 	return again;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// raycast a packet against the extended bucket pruner
+PxU32 ExtendedBucketPruner::raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+{
+	PxU32 againMask = activeMask;
+
+	// search the bucket pruner first
+	if (mPrunerCore.getNbObjects())
+		againMask = mPrunerCore.raycastPacket(origins, unitDirs, inOutDistances, callbacks, againMask);
+
+	// the merged trees only hold the pruning structures added since the last rebuild, cast the rays one by one
+	if (againMask && mExtendedBucketPrunerMap.size())
+	{
+		const PxVec3 extent(0.0f);
+		for (PxU32 i = 0; i < SQ_RAY_PACKET_SIZE; i++)
+		{
+			if (!(againMask & (1 << i)))
+				continue;
+
+			MainTreeRaycastPrunerCallback<false> pcb(origins[i], unitDirs[i], extent, *callbacks[i], mPruningPool);
+			if (!AABBTreeRaycast<false, AABBTree, AABBTreeRuntimeNode>()(reinterpret_cast<const PrunerPayload*>(mMergedTrees), mBounds, *mMainTree, origins[i], unitDirs[i], *inOutDistances[i], extent, pcb))
+				againMask &= ~(1 << i);
+		}
+	}
+
+	return againMask;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // overlap main tree callback
 template<typename Test>
@@ -792,6 +820,51 @@ PxAgain ExtendedBucketPruner::sweep(const Gu::ShapeData& queryVolume, const PxVe
 	return again;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// nearest main tree callback
+struct MainTreeNearestPrunerCallback : public PrunerCallback
+{
+	MainTreeNearestPrunerCallback(const PxVec3& point, PxReal& maxDist, PrunerCallback& prunerCallback, const PruningPool* pool)
+		: mPoint(point), mMaxDist(maxDist), mPrunerCallback(prunerCallback), mPruningPool(pool)
+	{
+	}
+
+	virtual PxAgain invoke(PxReal& distance, const PrunerPayload& payload)
+	{
+		// payload data match merged tree data MergedTree, we can cast it
+		const AABBTree* aabbTree = reinterpret_cast<const AABBTree*> (payload.data[0]);
+		// search the merged tree with the current radius, not the distance to its bounds
+		const PxAgain again = AABBTreeNearest<AABBTree, AABBTreeRuntimeNode>()(mPruningPool->getObjects(), mPruningPool->getCurrentWorldBoxes(), *aabbTree, mPoint, mMaxDist, mPrunerCallback);
+		distance = mMaxDist;
+		return again;
+	}
+
+	PX_NOCOPY(MainTreeNearestPrunerCallback)
+
+private:
+	const PxVec3&		mPoint;
+	PxReal&				mMaxDist;
+	PrunerCallback&		mPrunerCallback;
+	const PruningPool*	mPruningPool;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// nearest implementation
+PxAgain ExtendedBucketPruner::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& prunerCallback) const
+{
+	PxAgain again = true;
+
+	// core bucket pruner search
+	if (mPrunerCore.getNbObjects())
+		again = mPrunerCore.nearest(point, inOutDistance, prunerCallback);
+
+	if(again && mExtendedBucketPrunerMap.size())
+	{
+		MainTreeNearestPrunerCallback pcb(point, inOutDistance, prunerCallback, mPruningPool);
+		again = AABBTreeNearest<AABBTree, AABBTreeRuntimeNode>()(reinterpret_cast<const PrunerPayload*>(mMergedTrees), mBounds, *mMainTree, point, inOutDistance, pcb);
+	}
+	return again;
+}
 
 //////////////////////////////////////////////////////////////////////////
 #include "CmRenderOutput.h"
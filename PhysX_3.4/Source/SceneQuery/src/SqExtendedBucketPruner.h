@@ -149,8 +149,10 @@ namespace Sq
 
 		// queries against the pruner
 		PxAgain							raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+		PxU32							raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const;
 		PxAgain							overlap(const Gu::ShapeData& queryVolume, PrunerCallback&) const;
 		PxAgain							sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&) const;
+		PxAgain							nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&) const;
 
 		// origin shift
 		void							shiftOrigin(const PxVec3& shift);
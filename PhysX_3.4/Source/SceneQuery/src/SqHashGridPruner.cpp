@@ -0,0 +1,804 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "foundation/PxProfiler.h"
+#include "PsFoundation.h"
+#include "PsSort.h"
+#include "PsInlineArray.h"
+#include "SqHashGridPruner.h"
+#include "SqAABBTreeQuery.h"
+#include "GuSphere.h"
+#include "GuBox.h"
+#include "GuCapsule.h"
+#include "GuBounds.h"
+
+using namespace physx;
+using namespace Gu;
+using namespace Sq;
+using namespace Cm;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// cell coordinates are clamped to 21 bits so that the three of them fit the hash key
+static const PxI32 gMaxCoord = (1<<20)-1;
+
+static PX_FORCE_INLINE PxI32 toCoord(PxReal value, PxReal invCellSize)
+{
+	const PxReal coord = PxFloor(value * invCellSize);
+	return PxI32(PxClamp(coord, -PxReal(gMaxCoord+1), PxReal(gMaxCoord)));
+}
+
+static PX_FORCE_INLINE PxU64 packKey(PxI32 x, PxI32 y, PxI32 z)
+{
+	return (PxU64(x + gMaxCoord + 1)<<42) | (PxU64(y + gMaxCoord + 1)<<21) | PxU64(z + gMaxCoord + 1);
+}
+
+template<class Test>
+static PX_FORCE_INLINE bool testBounds(const Test& test, const PxBounds3& bounds)
+{
+	const Vec4V minV = V4LoadU(&bounds.minimum.x);
+	const Vec4V maxV = V4LoadU(&bounds.maximum.x);
+	const FloatV halfV = FLoad(0.5f);
+	return test(Vec3V_From_Vec4V(V4Scale(V4Add(maxV, minV), halfV)), Vec3V_From_Vec4V(V4Scale(V4Sub(maxV, minV), halfV))) != 0;
+}
+
+// distance along the ray at which it enters the bounds, false if it misses them before maxDist
+static PX_FORCE_INLINE bool computeEntryDistance(const PxVec3& origin, const PxVec3& unitDir, const PxVec3& minimum, const PxVec3& maximum, PxReal maxDist, PxReal& entry)
+{
+	PxReal tMin = 0.0f;
+	PxReal tMax = maxDist;
+	for(PxU32 i=0; i<3; i++)
+	{
+		if(PxAbs(unitDir[i]) < 1e-9f)
+		{
+			if(origin[i] < minimum[i] || origin[i] > maximum[i])
+				return false;
+		}
+		else
+		{
+			const PxReal invDir = 1.0f / unitDir[i];
+			PxReal t0 = (minimum[i] - origin[i]) * invDir;
+			PxReal t1 = (maximum[i] - origin[i]) * invDir;
+			if(t0 > t1)
+				Ps::swap(t0, t1);
+			tMin = PxMax(tMin, t0);
+			tMax = PxMin(tMax, t1);
+			if(tMin > tMax)
+				return false;
+		}
+	}
+	entry = tMin;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+HashGridPruner::HashGridPruner(PxU64 contextID) :
+	mCells						(PX_DEBUG_EXP("HashGridPruner::mCells")),
+	mObjectCells				(PX_DEBUG_EXP("HashGridPruner::mObjectCells")),
+	mObjectSlots				(PX_DEBUG_EXP("HashGridPruner::mObjectSlots")),
+	mCellSize					(0.0f),
+	mInvCellSize				(0.0f),
+	mMaxExtents					(0.0f),
+	mNbLargeObjectsAtRebuild	(0),
+	mNeedsRebuild				(false),
+	mContextID					(contextID)
+{
+	mLargeObjects.mBounds.setEmpty();
+	mLargeObjects.mKey = 0;
+	mLargeObjects.mIndex = 0xffffffff;
+	mLargeObjects.mDirty = false;
+}
+
+HashGridPruner::~HashGridPruner()
+{
+	release();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Add, Remove, Update methods
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool HashGridPruner::addObjects(PrunerHandle* results, const PxBounds3* bounds, const PrunerPayload* payload, PxU32 count, bool)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerAddObjects", mContextID);
+
+	if(!count)
+		return true;
+
+	const PxU32 valid = mPool.addObjects(results, bounds, payload, count);
+
+	// the cell size depends on the objects, so the grid is only built in commit() once there are some
+	if(!isBuilt() || mNeedsRebuild)
+	{
+		mNeedsRebuild = true;
+		return valid==count;
+	}
+
+	if(mObjectCells.size() < mPool.getNbActiveObjects())
+	{
+		mObjectCells.resize(mPool.getNbActiveObjects(), NULL);
+		mObjectSlots.resize(mPool.getNbActiveObjects(), 0);
+	}
+
+	for(PxU32 i=0;i<valid;i++)
+		insertObject(mPool.getIndex(results[i]));
+
+	return valid==count;
+}
+
+void HashGridPruner::updateObjectsAfterManualBoundsUpdates(const PrunerHandle* handles, PxU32 count)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerUpdateObjects", mContextID);
+
+	if(!isBuilt() || mNeedsRebuild)
+		return;
+
+	for(PxU32 i=0; i<count; i++)
+		updateObject(mPool.getIndex(handles[i]));
+}
+
+void HashGridPruner::updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerUpdateObjects", mContextID);
+
+	if(!count)
+		return;
+
+	mPool.updateObjectsAndInflateBounds(handles, indices, newBounds, count);
+
+	if(!isBuilt() || mNeedsRebuild)
+		return;
+
+	for(PxU32 i=0; i<count; i++)
+		updateObject(mPool.getIndex(handles[i]));
+}
+
+void HashGridPruner::removeObjects(const PrunerHandle* handles, PxU32 count)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerRemoveObjects", mContextID);
+
+	if(!count)
+		return;
+
+	// a pending rebuild inserts the objects again from the pool
+	const bool updateGrid = isBuilt() && !mNeedsRebuild;
+	for(PxU32 i=0; i<count; i++)
+	{
+		const PoolIndex poolIndex = mPool.getIndex(handles[i]);
+		const PoolIndex poolRelocatedLastIndex = mPool.removeObject(handles[i]);
+		if(!updateGrid)
+			continue;
+
+		removeObject(poolIndex);
+
+		// the pool moved its last object into the removed slot, so the cell must follow
+		if(poolIndex != poolRelocatedLastIndex)
+		{
+			Cell* cell = mObjectCells[poolRelocatedLastIndex];
+			const PxU32 slot = mObjectSlots[poolRelocatedLastIndex];
+			cell->mObjects[slot] = poolIndex;
+			mObjectCells[poolIndex] = cell;
+			mObjectSlots[poolIndex] = slot;
+			mObjectCells[poolRelocatedLastIndex] = NULL;
+		}
+	}
+
+	if(mPool.getNbActiveObjects()==0)
+	{
+		// the next objects can have another size, the grid is built again for them
+		release();
+	}
+}
+
+PxU64 HashGridPruner::computeKey(const PxBounds3& bounds) const
+{
+	const PxVec3 center = bounds.getCenter();
+	return packKey(toCoord(center.x, mInvCellSize), toCoord(center.y, mInvCellSize), toCoord(center.z, mInvCellSize));
+}
+
+bool HashGridPruner::isLarge(const PxBounds3& bounds) const
+{
+	return bounds.getExtents().maxElement() > mCellSize;
+}
+
+HashGridPruner::Cell* HashGridPruner::getCell(PxU64 key)
+{
+	const Ps::HashMap<PxU64, Cell*>::Entry* entry = mCellMap.find(key);
+	if(entry)
+		return entry->second;
+
+	Cell* cell;
+	if(mFreeCells.size())
+		cell = mFreeCells.popBack();
+	else
+		cell = PX_NEW(Cell);
+
+	cell->mBounds.setEmpty();
+	cell->mObjects.clear();
+	cell->mKey = key;
+	cell->mIndex = mCells.size();
+	cell->mDirty = false;
+	mCells.pushBack(cell);
+	mCellMap.insert(key, cell);
+	return cell;
+}
+
+void HashGridPruner::insertObject(PoolIndex poolIndex)
+{
+	const PxBounds3& bounds = mPool.getCurrentWorldBoxes()[poolIndex];
+
+	Cell* cell;
+	if(isLarge(bounds))
+	{
+		cell = &mLargeObjects;
+	}
+	else
+	{
+		cell = getCell(computeKey(bounds));
+		mMaxExtents = mMaxExtents.maximum(bounds.getExtents());
+	}
+
+	cell->mBounds.include(bounds);
+	mObjectCells[poolIndex] = cell;
+	mObjectSlots[poolIndex] = cell->mObjects.size();
+	cell->mObjects.pushBack(poolIndex);
+}
+
+void HashGridPruner::removeObject(PoolIndex poolIndex)
+{
+	Cell* cell = mObjectCells[poolIndex];
+	PX_ASSERT(cell);
+
+	// swap with the last object of the cell
+	const PxU32 slot = mObjectSlots[poolIndex];
+	const PoolIndex last = cell->mObjects.back();
+	cell->mObjects[slot] = last;
+	mObjectSlots[last] = slot;
+	cell->mObjects.popBack();
+	mObjectCells[poolIndex] = NULL;
+
+	if(cell != &mLargeObjects && cell->mObjects.empty())
+	{
+		mCellMap.erase(cell->mKey);
+
+		Cell* moved = mCells.back();
+		moved->mIndex = cell->mIndex;
+		mCells[cell->mIndex] = moved;
+		mCells.popBack();
+
+		// can still be in the dirty list, commit() then just computes empty bounds for it
+		mFreeCells.pushBack(cell);
+	}
+	else if(!cell->mDirty)
+	{
+		cell->mDirty = true;
+		mDirtyCells.pushBack(cell);
+	}
+}
+
+void HashGridPruner::updateObject(PoolIndex poolIndex)
+{
+	const PxBounds3& bounds = mPool.getCurrentWorldBoxes()[poolIndex];
+	Cell* cell = mObjectCells[poolIndex];
+
+	const bool large = isLarge(bounds);
+	const bool sameCell = large ? cell == &mLargeObjects : (cell != &mLargeObjects && cell->mKey == computeKey(bounds));
+	if(!sameCell)
+	{
+		removeObject(poolIndex);
+		insertObject(poolIndex);
+		return;
+	}
+
+	// the bounds only grow here, they are tightened in commit()
+	cell->mBounds.include(bounds);
+	if(!large)
+		mMaxExtents = mMaxExtents.maximum(bounds.getExtents());
+	if(!cell->mDirty)
+	{
+		cell->mDirty = true;
+		mDirtyCells.pushBack(cell);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Query Implementation
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class Visitor>
+bool HashGridPruner::visitCells(const PxBounds3& bounds, Visitor& visitor) const
+{
+	// objects can stick out of their cell by their half extents
+	const PxVec3 minimum = bounds.minimum - mMaxExtents;
+	const PxVec3 maximum = bounds.maximum + mMaxExtents;
+	const PxI32 x0 = toCoord(minimum.x, mInvCellSize), x1 = toCoord(maximum.x, mInvCellSize);
+	const PxI32 y0 = toCoord(minimum.y, mInvCellSize), y1 = toCoord(maximum.y, mInvCellSize);
+	const PxI32 z0 = toCoord(minimum.z, mInvCellSize), z1 = toCoord(maximum.z, mInvCellSize);
+
+	// large queries are cheaper as a scan of the occupied cells than as lookups of mostly empty ones
+	const PxReal nbCoords = PxReal(x1-x0+1) * PxReal(y1-y0+1) * PxReal(z1-z0+1);
+	if(nbCoords > PxReal(mCells.size()))
+	{
+		const PxU32 nbCells = mCells.size();
+		for(PxU32 i=0; i<nbCells; i++)
+		{
+			if(!visitor(*mCells[i]))
+				return false;
+		}
+		return true;
+	}
+
+	for(PxI32 x=x0; x<=x1; x++)
+	{
+		for(PxI32 y=y0; y<=y1; y++)
+		{
+			for(PxI32 z=z0; z<=z1; z++)
+			{
+				const Ps::HashMap<PxU64, Cell*>::Entry* entry = mCellMap.find(packKey(x, y, z));
+				if(entry && !visitor(*entry->second))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+namespace
+{
+	template<class Test>
+	struct OverlapCellVisitor
+	{
+		const Test&				mTest;
+		const PrunerPayload*	mObjects;
+		const PxBounds3*		mBoxes;
+		PrunerCallback&			mCallback;
+
+		OverlapCellVisitor(const Test& test, const PrunerPayload* objects, const PxBounds3* boxes, PrunerCallback& callback) :
+			mTest(test), mObjects(objects), mBoxes(boxes), mCallback(callback)	{}
+
+		bool operator()(const HashGridPruner::Cell& cell)
+		{
+			if(!testBounds(mTest, cell.mBounds))
+				return true;
+
+			const PxU32 nbObjects = cell.mObjects.size();
+			const PoolIndex* indices = cell.mObjects.begin();
+			for(PxU32 i=0; i<nbObjects; i++)
+			{
+				const PoolIndex poolIndex = indices[i];
+				if(nbObjects > 1 && !testBounds(mTest, mBoxes[poolIndex]))
+					continue;
+
+				PxReal unusedDistance;
+				if(!mCallback.invoke(unusedDistance, mObjects[poolIndex]))
+					return false;
+			}
+			return true;
+		}
+
+	private:
+		OverlapCellVisitor& operator=(const OverlapCellVisitor&);
+	};
+
+	struct RayCellCandidate
+	{
+		PxReal							mDistance;
+		const HashGridPruner::Cell*		mCell;
+	};
+
+	struct RayCellCandidateSort
+	{
+		PX_FORCE_INLINE bool operator()(const RayCellCandidate& a, const RayCellCandidate& b) const	{ return a.mDistance < b.mDistance;	}
+	};
+
+	typedef Ps::InlineArray<RayCellCandidate, 64> RayCellCandidates;
+
+	// gathers the cells the ray (or the swept box) enters, with the distance at which it enters them
+	struct RayCellCollector
+	{
+		const PxVec3&		mOrigin;
+		const PxVec3&		mUnitDir;
+		const PxVec3&		mInflation;
+		const PxReal		mMaxDist;
+		RayCellCandidates&	mCandidates;
+
+		RayCellCollector(const PxVec3& origin, const PxVec3& unitDir, const PxVec3& inflation, PxReal maxDist, RayCellCandidates& candidates) :
+			mOrigin(origin), mUnitDir(unitDir), mInflation(inflation), mMaxDist(maxDist), mCandidates(candidates)	{}
+
+		bool operator()(const HashGridPruner::Cell& cell)
+		{
+			RayCellCandidate candidate;
+			if(computeEntryDistance(mOrigin, mUnitDir, cell.mBounds.minimum - mInflation, cell.mBounds.maximum + mInflation, mMaxDist, candidate.mDistance))
+			{
+				candidate.mCell = &cell;
+				mCandidates.pushBack(candidate);
+			}
+			return true;
+		}
+
+	private:
+		RayCellCollector& operator=(const RayCellCollector&);
+	};
+
+	// gathers the cells within the search radius of a point, with the distance to their bounds
+	struct NearestCellCollector
+	{
+		const Vec3V			mPoint;
+		const PxReal		mMaxDist2;
+		RayCellCandidates&	mCandidates;
+
+		NearestCellCollector(const PxVec3& point, PxReal maxDist, RayCellCandidates& candidates) :
+			mPoint(V3LoadU(point)), mMaxDist2(maxDist*maxDist), mCandidates(candidates)	{}
+
+		bool operator()(const HashGridPruner::Cell& cell)
+		{
+			const Vec3V d = V3Max(V3Max(V3Sub(V3LoadU(cell.mBounds.minimum), mPoint), V3Sub(mPoint, V3LoadU(cell.mBounds.maximum))), V3Zero());
+			RayCellCandidate candidate;
+			FStore(V3Dot(d, d), &candidate.mDistance);
+			if(candidate.mDistance <= mMaxDist2)
+			{
+				candidate.mDistance = PxSqrt(candidate.mDistance);
+				candidate.mCell = &cell;
+				mCandidates.pushBack(candidate);
+			}
+			return true;
+		}
+
+	private:
+		NearestCellCollector& operator=(const NearestCellCollector&);
+	};
+}
+
+template<class Test>
+PxAgain HashGridPruner::overlapCells(const PxBounds3& queryBounds, const Test& test, PrunerCallback& pcb) const
+{
+	OverlapCellVisitor<Test> visitor(test, mPool.getObjects(), mPool.getCurrentWorldBoxes(), pcb);
+	if(mLargeObjects.mObjects.size() && !visitor(mLargeObjects))
+		return false;
+
+	return visitCells(queryBounds, visitor);
+}
+
+template<bool tInflate>
+PxAgain HashGridPruner::raycastCells(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, const PxVec3& inflation, PrunerCallback& pcb) const
+{
+	RayCellCandidates candidates;
+	RayCellCollector collector(origin, unitDir, inflation, inOutDistance, candidates);
+	if(mLargeObjects.mObjects.size())
+		collector(mLargeObjects);
+
+	PxBounds3 segmentBounds(PxVec3(-PX_MAX_F32), PxVec3(PX_MAX_F32));
+	if(inOutDistance < PX_MAX_F32)
+	{
+		segmentBounds = PxBounds3::boundsOfPoints(origin, origin + unitDir * inOutDistance);
+		segmentBounds.minimum -= inflation;
+		segmentBounds.maximum += inflation;
+	}
+	visitCells(segmentBounds, collector);
+
+	// the cells are visited front to back, so the ones behind the closest hits are skipped
+	Ps::sort(candidates.begin(), candidates.size(), RayCellCandidateSort());
+
+	// as in AABBTreeRaycast, the test works on center*2 and extents*2
+	Gu::RayAABBTest test(origin*2.0f, unitDir*2.0f, inOutDistance, inflation*2.0f);
+
+	const PrunerPayload* objects = mPool.getObjects();
+	const PxBounds3* boxes = mPool.getCurrentWorldBoxes();
+	for(PxU32 i=0; i<candidates.size(); i++)
+	{
+		if(candidates[i].mDistance > inOutDistance)
+			break;
+
+		const Cell& cell = *candidates[i].mCell;
+		const PxU32 nbObjects = cell.mObjects.size();
+		const PoolIndex* indices = cell.mObjects.begin();
+		for(PxU32 j=0; j<nbObjects; j++)
+		{
+			const PoolIndex poolIndex = indices[j];
+			Vec4V center, extents;
+			getBoundsTimesTwo(center, extents, boxes, poolIndex);
+			if(!test.check<tInflate>(Vec3V_From_Vec4V(center), Vec3V_From_Vec4V(extents)))
+				continue;
+
+			PxReal md = inOutDistance;
+			if(!pcb.invoke(md, objects[poolIndex]))
+				return false;
+
+			if(md < inOutDistance)
+			{
+				inOutDistance = md;
+				test.setDistance(md);
+			}
+		}
+	}
+	return true;
+}
+
+PxAgain HashGridPruner::overlap(const ShapeData& queryVolume, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mNeedsRebuild);
+
+	if(!isBuilt())
+		return true;
+
+	const PxBounds3& queryBounds = queryVolume.getPrunerInflatedWorldAABB();
+	switch(queryVolume.getType())
+	{
+	case PxGeometryType::eBOX:
+		{
+			if(queryVolume.isOBB())
+			{	
+				const Gu::OBBAABBTest test(queryVolume.getPrunerWorldPos(), queryVolume.getPrunerWorldRot33(), queryVolume.getPrunerBoxGeomExtentsInflated());
+				return overlapCells(queryBounds, test, pcb);
+			}
+			else
+			{
+				const Gu::AABBAABBTest test(queryBounds);
+				return overlapCells(queryBounds, test, pcb);
+			}
+		}
+	case PxGeometryType::eCAPSULE:
+		{
+			const Gu::Capsule& capsule = queryVolume.getGuCapsule();
+			const Gu::CapsuleAABBTest test(	capsule.p1, queryVolume.getPrunerWorldRot33().column0,
+											queryVolume.getCapsuleHalfHeight()*2.0f, PxVec3(capsule.radius*SQ_PRUNER_INFLATION));
+			return overlapCells(queryBounds, test, pcb);
+		}
+	case PxGeometryType::eSPHERE:
+		{
+			const Gu::Sphere& sphere = queryVolume.getGuSphere();
+			const Gu::SphereAABBTest test(sphere.center, sphere.radius);
+			return overlapCells(queryBounds, test, pcb);
+		}
+	case PxGeometryType::eCONVEXMESH:
+		{
+			const Gu::OBBAABBTest test(queryVolume.getPrunerWorldPos(), queryVolume.getPrunerWorldRot33(), queryVolume.getPrunerBoxGeomExtentsInflated());
+			return overlapCells(queryBounds, test, pcb);
+		}
+	case PxGeometryType::ePLANE:
+	case PxGeometryType::eTRIANGLEMESH:
+	case PxGeometryType::eHEIGHTFIELD:
+	case PxGeometryType::eGEOMETRY_COUNT:
+	case PxGeometryType::eINVALID:
+		PX_ALWAYS_ASSERT_MESSAGE("unsupported overlap query volume geometry type");
+	}
+	return true;
+}
+
+PxAgain HashGridPruner::sweep(const ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mNeedsRebuild);
+
+	if(!isBuilt())
+		return true;
+
+	const PxBounds3& aabb = queryVolume.getPrunerInflatedWorldAABB();
+	return raycastCells<true>(aabb.getCenter(), unitDir, inOutDistance, aabb.getExtents(), pcb);
+}
+
+PxAgain HashGridPruner::raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mNeedsRebuild);
+
+	if(!isBuilt())
+		return true;
+
+	return raycastCells<false>(origin, unitDir, inOutDistance, PxVec3(0.0f), pcb);
+}
+
+PxAgain HashGridPruner::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mNeedsRebuild);
+
+	if(!isBuilt())
+		return true;
+
+	RayCellCandidates candidates;
+	NearestCellCollector collector(point, inOutDistance, candidates);
+	if(mLargeObjects.mObjects.size())
+		collector(mLargeObjects);
+
+	PxBounds3 searchBounds(PxVec3(-PX_MAX_F32), PxVec3(PX_MAX_F32));
+	if(inOutDistance < PX_MAX_F32)
+		searchBounds = PxBounds3::centerExtents(point, PxVec3(inOutDistance));
+	visitCells(searchBounds, collector);
+
+	// closest cells first, the search radius shrinks as objects are found
+	Ps::sort(candidates.begin(), candidates.size(), RayCellCandidateSort());
+
+	const Vec3V p = V3LoadU(point);
+	const PrunerPayload* objects = mPool.getObjects();
+	const PxBounds3* boxes = mPool.getCurrentWorldBoxes();
+	for(PxU32 i=0; i<candidates.size(); i++)
+	{
+		if(candidates[i].mDistance > inOutDistance)
+			break;
+
+		const Cell& cell = *candidates[i].mCell;
+		const PxU32 nbObjects = cell.mObjects.size();
+		const PoolIndex* indices = cell.mObjects.begin();
+		for(PxU32 j=0; j<nbObjects; j++)
+		{
+			const PoolIndex poolIndex = indices[j];
+			const Vec3V d = V3Max(V3Max(V3Sub(V3LoadU(boxes[poolIndex].minimum), p), V3Sub(p, V3LoadU(boxes[poolIndex].maximum))), V3Zero());
+			PxReal distance2;
+			FStore(V3Dot(d, d), &distance2);
+			if(distance2 > inOutDistance*inOutDistance)
+				continue;
+
+			PxReal md = PxSqrt(distance2);
+			if(!pcb.invoke(md, objects[poolIndex]))
+				return false;
+
+			if(md < inOutDistance)
+				inOutDistance = md;
+		}
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Other methods of Pruner Interface
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void HashGridPruner::commit()
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerCommit", mContextID);
+
+	// too many objects outgrew the cells, the grid needs larger ones
+	const PxU32 nbLargeObjects = mLargeObjects.mObjects.size();
+	if(nbLargeObjects > 16 && nbLargeObjects*4 > mPool.getNbActiveObjects() && nbLargeObjects > mNbLargeObjectsAtRebuild*2)
+		mNeedsRebuild = true;
+
+	if(mNeedsRebuild)
+	{
+		rebuild();
+		return;
+	}
+
+	const PxBounds3* boxes = mPool.getCurrentWorldBoxes();
+	for(PxU32 i=0; i<mDirtyCells.size(); i++)
+	{
+		Cell* cell = mDirtyCells[i];
+		cell->mBounds.setEmpty();
+		for(PxU32 j=0; j<cell->mObjects.size(); j++)
+			cell->mBounds.include(boxes[cell->mObjects[j]]);
+		cell->mDirty = false;
+	}
+	mDirtyCells.clear();
+}
+
+void HashGridPruner::rebuild()
+{
+	PX_PROFILE_ZONE("SceneQuery.hashGridRebuild", mContextID);
+
+	for(PxU32 i=0; i<mCells.size(); i++)
+		mFreeCells.pushBack(mCells[i]);
+	mCells.clear();
+	mCellMap.clear();
+	mDirtyCells.clear();
+	mLargeObjects.mObjects.clear();
+	mLargeObjects.mBounds.setEmpty();
+	mLargeObjects.mDirty = false;
+	mMaxExtents = PxVec3(0.0f);
+	mNeedsRebuild = false;
+
+	const PxU32 nbObjects = mPool.getNbActiveObjects();
+	if(!nbObjects)
+	{
+		mCellSize = mInvCellSize = 0.0f;
+		return;
+	}
+
+	// a cell twice as large as an average object keeps most objects within a cell of their neighbours
+	const PxBounds3* boxes = mPool.getCurrentWorldBoxes();
+	PxReal sumSizes = 0.0f;
+	for(PxU32 i=0; i<nbObjects; i++)
+		sumSizes += boxes[i].getDimensions().maxElement();
+	mCellSize = PxMax(2.0f * sumSizes / PxReal(nbObjects), 1e-3f);
+	mInvCellSize = 1.0f / mCellSize;
+
+	mObjectCells.resize(nbObjects, NULL);
+	mObjectSlots.resize(nbObjects, 0);
+	for(PxU32 i=0; i<nbObjects; i++)
+		insertObject(i);
+
+	mNbLargeObjectsAtRebuild = mLargeObjects.mObjects.size();
+}
+
+void HashGridPruner::merge(const void*)
+{
+	// the objects of the pruning structure were already added by addObjects(), and are in the grid after commit()
+}
+
+void HashGridPruner::preallocate(PxU32 entries)
+{
+	mPool.preallocate(entries);
+	mObjectCells.reserve(entries);
+	mObjectSlots.reserve(entries);
+}
+
+void HashGridPruner::shiftOrigin(const PxVec3& shift)
+{
+	mPool.shiftOrigin(shift);
+
+	// the cell coordinates change with the origin
+	if(isBuilt())
+		rebuild();
+}
+
+#include "CmRenderOutput.h"
+void HashGridPruner::visualize(Cm::RenderOutput& out, PxU32 color) const
+{
+	out << PxTransform(PxIdentity);
+	out << color;
+
+	for(PxU32 i=0; i<mCells.size(); i++)
+		out << Cm::DebugBox(mCells[i]->mBounds, true);
+
+	if(mLargeObjects.mObjects.size())
+		out << Cm::DebugBox(mLargeObjects.mBounds, true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Internal methods
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void HashGridPruner::release()
+{
+	for(PxU32 i=0; i<mCells.size(); i++)
+		PX_DELETE(mCells[i]);
+	for(PxU32 i=0; i<mFreeCells.size(); i++)
+		PX_DELETE(mFreeCells[i]);
+	mCells.reset();
+	mFreeCells.reset();
+	mDirtyCells.reset();
+	mCellMap.clear();
+	mObjectCells.clear();
+	mObjectSlots.clear();
+
+	mLargeObjects.mObjects.reset();
+	mLargeObjects.mBounds.setEmpty();
+	mLargeObjects.mDirty = false;
+
+	mCellSize = mInvCellSize = 0.0f;
+	mMaxExtents = PxVec3(0.0f);
+	mNbLargeObjectsAtRebuild = 0;
+	mNeedsRebuild = false;
+}
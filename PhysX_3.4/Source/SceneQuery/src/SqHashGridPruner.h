@@ -0,0 +1,134 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef SQ_HASH_GRID_PRUNER_H
+#define SQ_HASH_GRID_PRUNER_H
+
+#include "SqPruner.h"
+#include "SqPruningPool.h"
+#include "PsArray.h"
+#include "PsHashMap.h"
+
+namespace physx
+{
+
+namespace Sq
+{
+	// This class implements the Pruner interface with a hashed loose grid, for many moving objects of similar sizes.
+	// Objects go to the cell containing the center of their bounds, cells are only allocated when occupied and are found
+	// through a hash map of their integer coordinates. Each cell keeps the union of the bounds of its objects, which
+	// extend past the cell by up to the largest object half extents, so queries visit the cells whose coordinates are in
+	// the query bounds inflated by these extents and then test the cell bounds.
+	// Updates are O(1): an object that stays in its cell only grows the cell bounds, otherwise it moves to another cell.
+	// Cells that lost objects get tight bounds again in commit().
+	// The cell size is twice the average object size, picked when the first objects are committed. Objects more than
+	// twice as large as a cell are kept in a separate list that every query scans, and the grid is rebuilt with a new
+	// cell size when this list gets too long.
+	class HashGridPruner : public Pruner
+	{
+		public:
+												HashGridPruner(PxU64 contextID);
+		virtual									~HashGridPruner();
+
+		// Pruner
+		virtual			bool					addObjects(PrunerHandle* results, const PxBounds3* bounds, const PrunerPayload* userData, PxU32 count, bool hasPruningStructure);
+		virtual			void					removeObjects(const PrunerHandle* handles, PxU32 count);
+		virtual			void					updateObjectsAfterManualBoundsUpdates(const PrunerHandle* handles, PxU32 count);
+		virtual			void					updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count);
+		virtual			void					commit();
+		virtual			PxAgain					raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			PxAgain					overlap(const Gu::ShapeData& queryVolume, PrunerCallback&)	const;
+		virtual			PxAgain					sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			PxAgain					nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			const PrunerPayload&	getPayload(PrunerHandle handle)						const	{ return mPool.getPayload(handle);			}
+		virtual			const PrunerPayload&	getPayload(PrunerHandle handle, PxBounds3*& bounds)	const	{ return mPool.getPayload(handle, bounds);	}
+		virtual			PxU32					getObjects(const PxBounds3*& bounds, const PrunerPayload*& payloads, const PrunerHandle*& handles)	const
+												{ bounds = mPool.getCurrentWorldBoxes(); payloads = mPool.getObjects(); handles = mPool.mIndexToHandle; return mPool.getNbActiveObjects();	}
+		virtual			void					preallocate(PxU32 entries);
+		virtual			void					shiftOrigin(const PxVec3& shift);
+		virtual			void					visualize(Cm::RenderOutput& out, PxU32 color) const;
+		virtual			void					merge(const void* mergeParams);
+		//~Pruner
+
+		struct Cell
+		{
+			PxBounds3				mBounds;	// contains the bounds of the objects, can be loose until the next commit()
+			Ps::Array<PoolIndex>	mObjects;
+			PxU64					mKey;
+			PxU32					mIndex;		// in mCells
+			bool					mDirty;		// objects left the cell since the last commit()
+		};
+
+		private:
+						void					release();
+						void					rebuild();
+						PxU64					computeKey(const PxBounds3& bounds)	const;
+						bool					isLarge(const PxBounds3& bounds)	const;
+						Cell*					getCell(PxU64 key);
+						void					insertObject(PoolIndex poolIndex);
+						void					removeObject(PoolIndex poolIndex);
+						void					updateObject(PoolIndex poolIndex);
+						bool					isBuilt()	const	{ return mCellSize != 0.0f;	}
+
+		template<class Test>
+						PxAgain					overlapCells(const PxBounds3& queryBounds, const Test& test, PrunerCallback& pcb) const;
+		template<bool tInflate>
+						PxAgain					raycastCells(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, const PxVec3& inflation, PrunerCallback& pcb) const;
+		// calls the function for the cells whose coordinates are in the bounds, or for all the cells if there are fewer of them
+		template<class Visitor>
+						bool					visitCells(const PxBounds3& bounds, Visitor& visitor) const;
+
+						PruningPool				mPool;
+
+						Ps::HashMap<PxU64, Cell*>	mCellMap;
+						Ps::Array<Cell*>		mCells;			// the occupied cells
+						Ps::Array<Cell*>		mFreeCells;		// kept to reuse their object arrays
+						Ps::Array<Cell*>		mDirtyCells;
+						Cell					mLargeObjects;	// objects too large for the grid
+
+		// cell of each object, by pool index
+						Ps::Array<Cell*>		mObjectCells;
+		// position of each object in the object array of its cell, by pool index
+						Ps::Array<PxU32>		mObjectSlots;
+
+						PxReal					mCellSize;		// 0 until the grid is built
+						PxReal					mInvCellSize;
+						PxVec3					mMaxExtents;	// largest half extents of the objects in the grid, only grows until the next rebuild
+						PxU32					mNbLargeObjectsAtRebuild;
+						bool					mNeedsRebuild;	// objects were added to an empty grid, commit() builds it
+
+						PxU64					mContextID;
+	};
+
+} // namespace Sq
+
+}
+
+#endif // SQ_HASH_GRID_PRUNER_H
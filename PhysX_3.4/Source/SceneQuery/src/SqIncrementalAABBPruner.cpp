@@ -0,0 +1,423 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "foundation/PxProfiler.h"
+#include "PsFoundation.h"
+#include "SqIncrementalAABBPruner.h"
+#include "SqAABBTreeQuery.h"
+#include "GuSphere.h"
+#include "GuBox.h"
+#include "GuCapsule.h"
+#include "GuBounds.h"
+
+using namespace physx;
+using namespace Gu;
+using namespace Sq;
+using namespace Cm;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define PARANOIA_CHECKS 0
+
+IncrementalAABBPruner::IncrementalAABBPruner(PxU64 contextID) :
+	mAABBTree			(NULL),
+	mMapping			(PX_DEBUG_EXP("IncrementalAABBPruner::mMapping")),
+	mUncommittedChanges	(false),
+	mContextID			(contextID)
+{
+	mChangedLeaves.reserve(32);
+}
+
+IncrementalAABBPruner::~IncrementalAABBPruner()
+{
+	release();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Add, Remove, Update methods
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool IncrementalAABBPruner::addObjects(PrunerHandle* results, const PxBounds3* bounds, const PrunerPayload* payload, PxU32 count, bool)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerAddObjects", mContextID);
+
+	if(!count)
+		return true;
+
+	const PxU32 valid = mPool.addObjects(results, bounds, payload, count);
+
+	// objects added to an empty pruner are built into the tree at once in commit(), this covers the initial scene load
+	// and the merged pruning structures, which are added right before being merged
+	if(!hasTree())
+	{
+		mUncommittedChanges = true;
+		return valid==count;
+	}
+
+	if(mMapping.size() < mPool.getNbActiveObjects())
+		mMapping.resize(mPool.getNbActiveObjects(), NULL);
+
+	for(PxU32 i=0;i<valid;i++)
+		insertObject(mPool.getIndex(results[i]));
+
+	return valid==count;
+}
+
+void IncrementalAABBPruner::updateObjectsAfterManualBoundsUpdates(const PrunerHandle* handles, PxU32 count)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerUpdateObjects", mContextID);
+
+	if(!count || !hasTree())
+		return;
+
+	for(PxU32 i=0; i<count; i++)
+		updateObject(mPool.getIndex(handles[i]));
+}
+
+void IncrementalAABBPruner::updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerUpdateObjects", mContextID);
+
+	if(!count)
+		return;
+
+	mPool.updateObjectsAndInflateBounds(handles, indices, newBounds, count);
+
+	if(!hasTree())
+		return;
+
+	for(PxU32 i=0; i<count; i++)
+		updateObject(mPool.getIndex(handles[i]));
+}
+
+void IncrementalAABBPruner::removeObjects(const PrunerHandle* handles, PxU32 count)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerRemoveObjects", mContextID);
+
+	if(!count)
+		return;
+
+	for(PxU32 i=0; i<count; i++)
+	{
+		const PoolIndex poolIndex = mPool.getIndex(handles[i]); // save the pool index for removed object
+		const PoolIndex poolRelocatedLastIndex = mPool.removeObject(handles[i]); // save the lastIndex returned by removeObject
+		if(!hasTree())
+			continue;
+
+		// remove the poolIndex from the tree, the bounds of the parents are updated immediately
+		IncrementalAABBTreeNode* node = mAABBTree->remove(mMapping[poolIndex], poolIndex, mPool.getCurrentWorldBoxes());
+		// a returned leaf took over the primitives of the removed node's sibling
+		if(node && node->isLeaf())
+		{
+			for(PxU32 j = 0; j < node->getNbPrimitives(); j++)
+				mMapping[node->getPrimitives(NULL)[j]] = node;
+		}
+		mMapping[poolIndex] = NULL;
+
+		// the pool moved its last object into the removed slot, so the tree must follow
+		if(poolIndex != poolRelocatedLastIndex)
+		{
+			IncrementalAABBTreeNode* relocatedNode = mMapping[poolRelocatedLastIndex];
+			mAABBTree->fixupTreeIndices(relocatedNode, poolRelocatedLastIndex, poolIndex);
+			mMapping[poolIndex] = relocatedNode;
+			mMapping[poolRelocatedLastIndex] = NULL;
+		}
+	}
+
+	if(mPool.getNbActiveObjects()==0)
+	{
+		// release the internal data once all the objects are out of the pruner, as AABBPruner does
+		release();
+	}
+
+#if PARANOIA_CHECKS
+	if(hasTree())
+		mAABBTree->hierarchyCheck(mPool.getNbActiveObjects(), mPool.getCurrentWorldBoxes());
+#endif
+}
+
+void IncrementalAABBPruner::insertObject(PoolIndex poolIndex)
+{
+	mChangedLeaves.clear();
+	IncrementalAABBTreeNode* node = mAABBTree->insert(poolIndex, mPool.getCurrentWorldBoxes(), mChangedLeaves);
+	updateMapping(poolIndex, node);
+}
+
+void IncrementalAABBPruner::updateObject(PoolIndex poolIndex)
+{
+	// refits in place if the object still overlaps its leaf, otherwise reinserts it, which rotates the tree as needed
+	IncrementalAABBTreeNode* oldNode = mMapping[poolIndex];
+	mChangedLeaves.clear();
+	IncrementalAABBTreeNode* node = mAABBTree->updateFast(oldNode, poolIndex, mPool.getCurrentWorldBoxes(), mChangedLeaves);
+	if(!mChangedLeaves.empty() || node != oldNode)
+		updateMapping(poolIndex, node);
+}
+
+void IncrementalAABBPruner::updateMapping(PoolIndex poolIndex, IncrementalAABBTreeNode* node)
+{
+	// if some leaves changed, every primitive they hold must be remapped
+	if(!mChangedLeaves.empty())
+	{
+		if(node && node->isLeaf())
+		{
+			for(PxU32 j = 0; j < node->getNbPrimitives(); j++)
+				mMapping[node->getPrimitives(NULL)[j]] = node;
+		}
+
+		for(PxU32 i = 0; i < mChangedLeaves.size(); i++)
+		{
+			IncrementalAABBTreeNode* changedNode = mChangedLeaves[i];
+			PX_ASSERT(changedNode->isLeaf());
+
+			for(PxU32 j = 0; j < changedNode->getNbPrimitives(); j++)
+				mMapping[changedNode->getPrimitives(NULL)[j]] = changedNode;
+		}
+	}
+	else
+	{
+		PX_ASSERT(node->isLeaf());
+		mMapping[poolIndex] = node;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Query Implementation
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PxAgain IncrementalAABBPruner::overlap(const ShapeData& queryVolume, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	PxAgain again = true;
+
+	if(hasTree())
+	{
+		switch(queryVolume.getType())
+		{
+		case PxGeometryType::eBOX:
+			{
+				if(queryVolume.isOBB())
+				{	
+					const Gu::OBBAABBTest test(queryVolume.getPrunerWorldPos(), queryVolume.getPrunerWorldRot33(), queryVolume.getPrunerBoxGeomExtentsInflated());
+					again = AABBTreeOverlap<Gu::OBBAABBTest, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, test, pcb);
+				}
+				else
+				{
+					const Gu::AABBAABBTest test(queryVolume.getPrunerInflatedWorldAABB());
+					again = AABBTreeOverlap<Gu::AABBAABBTest, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, test, pcb);
+				}
+			}
+			break;
+		case PxGeometryType::eCAPSULE:
+			{
+				const Gu::Capsule& capsule = queryVolume.getGuCapsule();
+				const Gu::CapsuleAABBTest test(	capsule.p1, queryVolume.getPrunerWorldRot33().column0,
+												queryVolume.getCapsuleHalfHeight()*2.0f, PxVec3(capsule.radius*SQ_PRUNER_INFLATION));
+				again = AABBTreeOverlap<Gu::CapsuleAABBTest, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, test, pcb);
+			}
+			break;
+		case PxGeometryType::eSPHERE:
+			{
+				const Gu::Sphere& sphere = queryVolume.getGuSphere();
+				Gu::SphereAABBTest test(sphere.center, sphere.radius);
+				again = AABBTreeOverlap<Gu::SphereAABBTest, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, test, pcb);
+			}
+			break;
+		case PxGeometryType::eCONVEXMESH:
+			{
+				const Gu::OBBAABBTest test(queryVolume.getPrunerWorldPos(), queryVolume.getPrunerWorldRot33(), queryVolume.getPrunerBoxGeomExtentsInflated());
+				again = AABBTreeOverlap<Gu::OBBAABBTest, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, test, pcb);
+			}
+			break;
+		case PxGeometryType::ePLANE:
+		case PxGeometryType::eTRIANGLEMESH:
+		case PxGeometryType::eHEIGHTFIELD:
+		case PxGeometryType::eGEOMETRY_COUNT:
+		case PxGeometryType::eINVALID:
+			PX_ALWAYS_ASSERT_MESSAGE("unsupported overlap query volume geometry type");
+		}
+	}
+
+	return again;
+}
+
+PxAgain IncrementalAABBPruner::sweep(const ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	PxAgain again = true;
+
+	if(hasTree())
+	{
+		const PxBounds3& aabb = queryVolume.getPrunerInflatedWorldAABB();
+		const PxVec3 extents = aabb.getExtents();
+		again = AABBTreeRaycast<true, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, aabb.getCenter(), unitDir, inOutDistance, extents, pcb);
+	}
+
+	return again;
+}
+
+PxAgain IncrementalAABBPruner::raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	PxAgain again = true;
+
+	if(hasTree())
+		again = AABBTreeRaycast<false, IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, origin, unitDir, inOutDistance, PxVec3(0.0f), pcb);
+
+	return again;
+}
+
+PxAgain IncrementalAABBPruner::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	PxAgain again = true;
+
+	if(hasTree())
+		again = AABBTreeNearest<IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, point, inOutDistance, pcb);
+
+	return again;
+}
+
+PxU32 IncrementalAABBPruner::raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+{
+	PX_ASSERT(!mUncommittedChanges);
+
+	if(!hasTree())
+		return activeMask;
+
+	return AABBTreeRaycastPacket<IncrementalAABBTree, IncrementalAABBTreeNode>()(mPool.getObjects(), mPool.getCurrentWorldBoxes(), *mAABBTree, origins, unitDirs, inOutDistances, callbacks, activeMask);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Other methods of Pruner Interface
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void IncrementalAABBPruner::purge()
+{
+	release();
+	mUncommittedChanges = mPool.getNbActiveObjects()!=0; // the next commit() builds the tree again from the pool
+}
+
+// Commit only has work to do when objects were added to an empty tree, every other change is already in the tree
+void IncrementalAABBPruner::commit()
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerCommit", mContextID);
+
+	if(!mUncommittedChanges)
+		return;
+
+	mUncommittedChanges = false;
+
+	const PxU32 nbObjects = mPool.getNbActiveObjects();
+	if(!nbObjects || hasTree())
+		return;
+
+	if(!mAABBTree)
+		mAABBTree = PX_NEW(IncrementalAABBTree)();
+
+	mMapping.resize(nbObjects, NULL);
+
+	AABBTreeBuildParams TB;
+	TB.mNbPrimitives	= nbObjects;
+	TB.mAABBArray		= mPool.getCurrentWorldBoxes();
+	TB.mLimit			= NB_OBJECTS_PER_NODE;
+	mAABBTree->build(TB, mMapping);
+
+#if PARANOIA_CHECKS
+	mAABBTree->hierarchyCheck(nbObjects, mPool.getCurrentWorldBoxes());
+#endif
+}
+
+void IncrementalAABBPruner::merge(const void*)
+{
+	// the objects of the pruning structure were already inserted by addObjects(), or will be part of the build in commit()
+}
+
+void IncrementalAABBPruner::preallocate(PxU32 entries)
+{
+	mPool.preallocate(entries);
+	mMapping.reserve(entries);
+}
+
+void IncrementalAABBPruner::shiftOrigin(const PxVec3& shift)
+{
+	mPool.shiftOrigin(shift);
+
+	if(mAABBTree)
+		mAABBTree->shiftOrigin(shift);
+}
+
+#include "CmRenderOutput.h"
+void IncrementalAABBPruner::visualize(Cm::RenderOutput& out, PxU32 color) const
+{
+	if(!hasTree())
+		return;
+
+	struct Local
+	{
+		static void _Draw(const IncrementalAABBTreeNode* root, const IncrementalAABBTreeNode* node, Cm::RenderOutput& out_)
+		{
+			PxBounds3 bounds;
+			V4StoreU(node->mBVMin, &bounds.minimum.x);
+			V4StoreU(node->mBVMax, &bounds.maximum.x);
+			out_ << Cm::DebugBox(bounds, true);
+			if (node->isLeaf())
+				return;
+			_Draw(root, node->getPos(root), out_);
+			_Draw(root, node->getNeg(root), out_);
+		}
+	};
+	out << PxTransform(PxIdentity);
+	out << color;
+	Local::_Draw(mAABBTree->getNodes(), mAABBTree->getNodes(), out);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ *	Internal methods
+ */
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void IncrementalAABBPruner::release() // this can be called from purge()
+{
+	PX_DELETE_AND_RESET(mAABBTree);
+	mMapping.clear();
+	mChangedLeaves.clear();
+	mUncommittedChanges = false;
+}
@@ -0,0 +1,114 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef SQ_INCREMENTAL_AABB_PRUNER_H
+#define SQ_INCREMENTAL_AABB_PRUNER_H
+
+#include "SqPruner.h"
+#include "SqPruningPool.h"
+#include "SqIncrementalAABBTree.h"
+
+namespace physx
+{
+
+namespace Sq
+{
+	// This class implements the Pruner interface with a single IncrementalAABBTree, which is always valid
+	// Unlike the dynamic AABBPruner there is no second tree being rebuilt over several frames and no bucket pruner for the
+	// objects added in the meantime: insertions, removals and updates are applied to the tree immediately. Insertions
+	// rotate the nodes they pass when the two children got too unbalanced, updates refit the leaf in place when the object
+	// still overlaps it and reinsert the object otherwise.
+	// The tree is built in one go in commit() when objects are added to an empty pruner, so loading a scene doesn't go
+	// through one insertion per object.
+	// The requirements on the order of calls are the same as for AABBPruner.
+	class IncrementalAABBPruner : public IncrementalPruner
+	{
+		public:
+												IncrementalAABBPruner(PxU64 contextID);
+		virtual									~IncrementalAABBPruner();
+
+		// Pruner
+		virtual			bool					addObjects(PrunerHandle* results, const PxBounds3* bounds, const PrunerPayload* userData, PxU32 count, bool hasPruningStructure);
+		virtual			void					removeObjects(const PrunerHandle* handles, PxU32 count);
+		virtual			void					updateObjectsAfterManualBoundsUpdates(const PrunerHandle* handles, PxU32 count);
+		virtual			void					updateObjectsAndInflateBounds(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* newBounds, PxU32 count);
+		virtual			void					commit();
+		virtual			PxAgain					raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			PxU32					raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask)	const;
+		virtual			PxAgain					overlap(const Gu::ShapeData& queryVolume, PrunerCallback&)	const;
+		virtual			PxAgain					sweep(const Gu::ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			PxAgain					nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback&)	const;
+		virtual			const PrunerPayload&	getPayload(PrunerHandle handle)						const	{ return mPool.getPayload(handle);			}
+		virtual			const PrunerPayload&	getPayload(PrunerHandle handle, PxBounds3*& bounds)	const	{ return mPool.getPayload(handle, bounds);	}
+		virtual			PxU32					getObjects(const PxBounds3*& bounds, const PrunerPayload*& payloads, const PrunerHandle*& handles)	const
+												{ bounds = mPool.getCurrentWorldBoxes(); payloads = mPool.getObjects(); handles = mPool.mIndexToHandle; return mPool.getNbActiveObjects();	}
+		virtual			void					preallocate(PxU32 entries);
+		virtual			void					shiftOrigin(const PxVec3& shift);
+		virtual			void					visualize(Cm::RenderOutput& out, PxU32 color) const;
+		virtual			void					merge(const void* mergeParams);
+		//~Pruner
+
+		// IncrementalPruner
+		virtual			void					purge();		// gets rid of the tree, it is built again in the next commit()
+		virtual			void					setRebuildRateHint(PxU32)								{}
+		virtual			bool					buildStep(bool)											{ return true;	}	// nothing to build, the tree is always up to date
+		virtual			bool					prepareBuild()											{ return false;	}
+		//~IncrementalPruner
+
+		PX_FORCE_INLINE	const IncrementalAABBTree*	getAABBTree()	const	{ return mAABBTree;	}
+
+		private:
+						void					release();
+						void					insertObject(PoolIndex poolIndex);
+						void					updateObject(PoolIndex poolIndex);
+						void					updateMapping(PoolIndex poolIndex, IncrementalAABBTreeNode* node);
+						bool					hasTree()	const	{ return mAABBTree && mAABBTree->getNodes();	}
+
+						IncrementalAABBTree*	mAABBTree;
+
+						PruningPool				mPool; // Pool of AABBs
+
+		// maps pruning pool indices to the tree leaf holding the object, only valid while the tree has nodes
+						Ps::Array<IncrementalAABBTreeNode*>	mMapping;
+
+		// leaves whose primitives moved during the last tree operation, their objects must be remapped
+						NodeList				mChangedLeaves;
+
+		// set when objects were added to an empty tree, commit() then builds the whole tree at once
+						bool					mUncommittedChanges;
+
+						PxU64					mContextID;
+	};
+
+} // namespace Sq
+
+}
+
+#endif // SQ_INCREMENTAL_AABB_PRUNER_H
@@ -169,6 +169,9 @@ namespace physx
 			// define this function so we can share the scene query code with regular AABBTree
 			const PxU32*				getIndices() const { return NULL; }
 
+			// no per-node filter masks, the nodes are not kept in a linear array
+			const PxU32*				getFilterMasks() const { return NULL; }
+
 			// paranoia checks
 			void						hierarchyCheck(PoolIndex maxIndex, const PxBounds3* bounds);
 			void						hierarchyCheck(const PxBounds3* bounds);
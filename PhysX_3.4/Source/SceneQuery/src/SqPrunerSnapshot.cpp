@@ -0,0 +1,307 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "foundation/PxProfiler.h"
+#include "PsFoundation.h"
+#include "SqPrunerSnapshot.h"
+#include "SqAABBTree.h"
+#include "SqAABBTreeQuery.h"
+#include "GuSphere.h"
+#include "GuBox.h"
+#include "GuCapsule.h"
+#include "GuBounds.h"
+
+using namespace physx;
+using namespace Gu;
+using namespace Sq;
+
+// same as the AABB pruner
+#define NB_OBJECTS_PER_NODE	4
+
+// refits degrade the tree, it is rebuilt after this many even if the objects didn't change
+static const PxU32 gMaxSnapshotRefits = 64;
+
+namespace
+{
+	// hidden objects keep their slot with a NULL payload, so the tree doesn't change
+	struct HiddenObjectFilter : public PrunerCallback
+	{
+		HiddenObjectFilter() : mCallback(NULL)	{}
+
+		virtual PxAgain invoke(PxReal& distance, const PrunerPayload& payload)
+		{
+			return payload.data[0] ? mCallback->invoke(distance, payload) : true;
+		}
+
+		PrunerCallback*	mCallback;
+	};
+}
+
+PrunerSnapshot::PrunerSnapshot(PxU64 contextID) :
+	mTree		(NULL),
+	mTimestamp	(0),
+	mNbRefits	(0),
+	mNbHidden	(0),
+	mContextID	(contextID),
+	mValid		(false)
+{
+}
+
+PrunerSnapshot::~PrunerSnapshot()
+{
+	PX_DELETE_AND_RESET(mTree);
+}
+
+void PrunerSnapshot::update(const Pruner& pruner, PxU32 timestamp, const PrunerPoseCallback& poses, PxCpuDispatcher* dispatcher)
+{
+	PX_PROFILE_ZONE("SceneQuery.prunerSnapshotUpdate", mContextID);
+
+	const PxBounds3* bounds;
+	const PrunerPayload* payloads;
+	const PrunerHandle* handles;
+	const PxU32 nbObjects = pruner.getObjects(bounds, payloads, handles);
+
+	// the tree only depends on the order of the objects, a refit is enough if they are still in the same slots
+	bool sameObjects = mTree && !mNbHidden && nbObjects == mPayloads.size() && mNbRefits < gMaxSnapshotRefits;
+	for(PxU32 i=0; sameObjects && i<nbObjects; i++)
+		sameObjects = payloads[i] == mPayloads[i];
+
+	mBounds.resizeUninitialized(nbObjects);
+	mPayloads.resizeUninitialized(nbObjects);
+	mPoses.resizeUninitialized(nbObjects);
+	mHandles.resizeUninitialized(nbObjects);
+	PxU32 maxHandle = 0;
+	for(PxU32 i=0; i<nbObjects; i++)
+	{
+		mBounds[i] = bounds[i];
+		mPayloads[i] = payloads[i];
+		poses.getPose(mPoses[i], payloads[i]);
+		mHandles[i] = handles[i];
+		maxHandle = PxMax(maxHandle, handles[i]+1);
+	}
+
+	mHandleToIndex.clear();
+	mHandleToIndex.resize(maxHandle, INVALID_PRUNERHANDLE);
+	for(PxU32 i=0; i<nbObjects; i++)
+		mHandleToIndex[handles[i]] = i;
+
+	if(sameObjects)
+	{
+		mTree->fullRefit(mBounds.begin());
+		mNbRefits++;
+	}
+	else
+	{
+		PX_DELETE_AND_RESET(mTree);
+		mNbRefits = 0;
+		if(nbObjects)
+		{
+			mTree = PX_NEW(AABBTree);
+
+			AABBTreeBuildParams TB;
+			TB.mNbPrimitives	= nbObjects;
+			TB.mAABBArray		= mBounds.begin();
+			TB.mLimit			= NB_OBJECTS_PER_NODE;
+			TB.mBuildStrategy	= BUILD_STRATEGY_SAH;
+			TB.mDispatcher		= dispatcher;
+			mTree->build(TB);
+		}
+	}
+
+	mNbHidden = 0;
+	mTimestamp = timestamp;
+	mValid = true;
+}
+
+void PrunerSnapshot::hideObject(PrunerHandle handle)
+{
+	if(handle >= mHandleToIndex.size() || mHandleToIndex[handle] == INVALID_PRUNERHANDLE)
+		return;
+
+	PrunerPayload& payload = mPayloads[mHandleToIndex[handle]];
+	if(payload.data[0])
+	{
+		payload.data[0] = payload.data[1] = 0;
+		mNbHidden++;
+	}
+	mHandleToIndex[handle] = INVALID_PRUNERHANDLE;
+}
+
+bool PrunerSnapshot::addObjects(PrunerHandle*, const PxBounds3*, const PrunerPayload*, PxU32, bool)
+{
+	PX_ALWAYS_ASSERT_MESSAGE("PrunerSnapshot is read only");
+	return false;
+}
+
+void PrunerSnapshot::removeObjects(const PrunerHandle*, PxU32)
+{
+	PX_ALWAYS_ASSERT_MESSAGE("PrunerSnapshot is read only");
+}
+
+void PrunerSnapshot::updateObjectsAfterManualBoundsUpdates(const PrunerHandle*, PxU32)
+{
+	PX_ALWAYS_ASSERT_MESSAGE("PrunerSnapshot is read only");
+}
+
+void PrunerSnapshot::updateObjectsAndInflateBounds(const PrunerHandle*, const PxU32*, const PxBounds3*, PxU32)
+{
+	PX_ALWAYS_ASSERT_MESSAGE("PrunerSnapshot is read only");
+}
+
+void PrunerSnapshot::merge(const void*)
+{
+	PX_ALWAYS_ASSERT_MESSAGE("PrunerSnapshot is read only");
+}
+
+const PrunerPayload& PrunerSnapshot::getPayload(PrunerHandle handle, PxBounds3*& bounds) const
+{
+	const PxU32 index = mHandleToIndex[handle];
+	bounds = const_cast<PxBounds3*>(mBounds.begin() + index);
+	return mPayloads[index];
+}
+
+void PrunerSnapshot::shiftOrigin(const PxVec3& shift)
+{
+	for(PxU32 i=0; i<mBounds.size(); i++)
+	{
+		mBounds[i].minimum -= shift;
+		mBounds[i].maximum -= shift;
+		mPoses[i].p -= shift;
+	}
+
+	if(mTree)
+		mTree->shiftOrigin(shift);
+}
+
+PxAgain PrunerSnapshot::raycast(const PxVec3& origin, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	if(!mTree)
+		return true;
+
+	HiddenObjectFilter filter;
+	filter.mCallback = &pcb;
+	PrunerCallback& cb = mNbHidden ? static_cast<PrunerCallback&>(filter) : pcb;
+	return AABBTreeRaycast<false, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, origin, unitDir, inOutDistance, PxVec3(0.0f), cb);
+}
+
+PxAgain PrunerSnapshot::sweep(const ShapeData& queryVolume, const PxVec3& unitDir, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	if(!mTree)
+		return true;
+
+	HiddenObjectFilter filter;
+	filter.mCallback = &pcb;
+	PrunerCallback& cb = mNbHidden ? static_cast<PrunerCallback&>(filter) : pcb;
+	const PxBounds3& aabb = queryVolume.getPrunerInflatedWorldAABB();
+	const PxVec3 extents = aabb.getExtents();
+	return AABBTreeRaycast<true, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, aabb.getCenter(), unitDir, inOutDistance, extents, cb);
+}
+
+PxAgain PrunerSnapshot::nearest(const PxVec3& point, PxReal& inOutDistance, PrunerCallback& pcb) const
+{
+	if(!mTree)
+		return true;
+
+	HiddenObjectFilter filter;
+	filter.mCallback = &pcb;
+	PrunerCallback& cb = mNbHidden ? static_cast<PrunerCallback&>(filter) : pcb;
+	return AABBTreeNearest<AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, point, inOutDistance, cb);
+}
+
+PxU32 PrunerSnapshot::raycastPacket(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* inOutDistances, PrunerCallback* const* callbacks, PxU32 activeMask) const
+{
+	if(!mTree)
+		return activeMask;
+
+	if(!mNbHidden)
+		return AABBTreeRaycastPacket<AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, origins, unitDirs, inOutDistances, callbacks, activeMask);
+
+	HiddenObjectFilter filters[SQ_RAY_PACKET_SIZE];
+	PrunerCallback* filtered[SQ_RAY_PACKET_SIZE];
+	for(PxU32 i=0; i<SQ_RAY_PACKET_SIZE; i++)
+	{
+		filters[i].mCallback = (activeMask & (1<<i)) ? callbacks[i] : NULL;
+		filtered[i] = filters + i;
+	}
+	return AABBTreeRaycastPacket<AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, origins, unitDirs, inOutDistances, filtered, activeMask);
+}
+
+PxAgain PrunerSnapshot::overlap(const ShapeData& queryVolume, PrunerCallback& pcb) const
+{
+	if(!mTree)
+		return true;
+
+	HiddenObjectFilter filter;
+	filter.mCallback = &pcb;
+	PrunerCallback& cb = mNbHidden ? static_cast<PrunerCallback&>(filter) : pcb;
+
+	// see AABBPruner::overlap
+	switch(queryVolume.getType())
+	{
+	case PxGeometryType::eBOX:
+		{
+			if(queryVolume.isOBB())
+			{	
+				const Gu::OBBAABBTest test(queryVolume.getPrunerWorldPos(), queryVolume.getPrunerWorldRot33(), queryVolume.getPrunerBoxGeomExtentsInflated());
+				return AABBTreeOverlap<Gu::OBBAABBTest, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, test, cb);
+			}
+			else
+			{
+				const Gu::AABBAABBTest test(queryVolume.getPrunerInflatedWorldAABB());
+				return AABBTreeOverlap<Gu::AABBAABBTest, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, test, cb);
+			}
+		}
+	case PxGeometryType::eCAPSULE:
+		{
+			const Gu::Capsule& capsule = queryVolume.getGuCapsule();
+			const Gu::CapsuleAABBTest test(	capsule.p1, queryVolume.getPrunerWorldRot33().column0,
+											queryVolume.getCapsuleHalfHeight()*2.0f, PxVec3(capsule.radius*SQ_PRUNER_INFLATION));
+			return AABBTreeOverlap<Gu::CapsuleAABBTest, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, test, cb);
+		}
+	case PxGeometryType::eSPHERE:
+		{
+			const Gu::Sphere& sphere = queryVolume.getGuSphere();
+			Gu::SphereAABBTest test(sphere.center, sphere.radius);
+			return AABBTreeOverlap<Gu::SphereAABBTest, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, test, cb);
+		}
+	case PxGeometryType::eCONVEXMESH:
+		{
+			const Gu::OBBAABBTest test(queryVolume.getPrunerWorldPos(), queryVolume.getPrunerWorldRot33(), queryVolume.getPrunerBoxGeomExtentsInflated());
+			return AABBTreeOverlap<Gu::OBBAABBTest, AABBTree, AABBTreeRuntimeNode>()(mPayloads.begin(), mBounds.begin(), *mTree, test, cb);
+		}
+	case PxGeometryType::ePLANE:
+	case PxGeometryType::eTRIANGLEMESH:
+	case PxGeometryType::eHEIGHTFIELD:
+	case PxGeometryType::eGEOMETRY_COUNT:
+	case PxGeometryType::eINVALID:
+		PX_ALWAYS_ASSERT_MESSAGE("unsupported overlap query volume geometry type");
+	}
+	return true;
+}
@@ -37,6 +37,7 @@
 #include "PxSphereGeometry.h"
 #include "PxCapsuleGeometry.h"
 #include "PsVecMath.h"
+#include "PsBitUtils.h"
 
 namespace physx
 {
@@ -100,6 +101,80 @@ protected:
 	RayAABBTest& operator=(const RayAABBTest&);
 };
 
+// RayAABBTest for a packet of up to 4 rays, one ray per SIMD lane. The test is the same, so a packet
+// culls exactly what the individual rays would. Origins and directions are multiplied by scale, use 2
+// with the center*2 / extents*2 node bounds as for RayAABBTest.
+struct RayPacketAABBTest
+{
+	PX_FORCE_INLINE RayPacketAABBTest(const PxVec3* origins, const PxVec3* unitDirs, PxReal* const* maxDists, PxU32 activeMask, PxReal scale)
+	{
+		const PxU32 firstRay = Ps::lowestSetBit(activeMask);
+		for(PxU32 i=0;i<4;i++)
+		{
+			// inactive lanes copy an active ray so that they don't produce NaNs, their results are masked out
+			const PxU32 ray = (activeMask & (1<<i)) ? i : firstRay;
+			const PxVec3 origin = origins[ray]*scale;
+			const PxVec3 dir = unitDirs[ray]*scale;
+			mOrigin[0][i] = origin.x;	mOrigin[1][i] = origin.y;	mOrigin[2][i] = origin.z;
+			mDir[0][i] = dir.x;			mDir[1][i] = dir.y;			mDir[2][i] = dir.z;
+			setLimits(i, *maxDists[ray]);
+		}
+		mOx = V4LoadA(mOrigin[0]);	mOy = V4LoadA(mOrigin[1]);	mOz = V4LoadA(mOrigin[2]);
+		mDx = V4LoadA(mDir[0]);		mDy = V4LoadA(mDir[1]);		mDz = V4LoadA(mDir[2]);
+		mAbsDx = V4Abs(mDx);		mAbsDy = V4Abs(mDy);		mAbsDz = V4Abs(mDz);
+	}
+
+	PX_FORCE_INLINE void setDistance(PxU32 ray, PxReal distance)
+	{
+		setLimits(ray, distance);
+	}
+
+	// returns the mask of the rays overlapping the box
+	PX_FORCE_INLINE PxU32 check(const Vec3V center, const Vec3V extents) const
+	{
+		const Vec4V cx = V4Splat(V3GetX(center)), cy = V4Splat(V3GetY(center)), cz = V4Splat(V3GetZ(center));
+		const Vec4V ex = V4Splat(V3GetX(extents)), ey = V4Splat(V3GetY(extents)), ez = V4Splat(V3GetZ(extents));
+
+		// coordinate axes
+		BoolV mask = BAnd(V4IsGrtrOrEq(V4Add(cx, ex), V4LoadA(mRayMin[0])), V4IsGrtrOrEq(V4LoadA(mRayMax[0]), V4Sub(cx, ex)));
+		mask = BAnd(mask, BAnd(V4IsGrtrOrEq(V4Add(cy, ey), V4LoadA(mRayMin[1])), V4IsGrtrOrEq(V4LoadA(mRayMax[1]), V4Sub(cy, ey))));
+		mask = BAnd(mask, BAnd(V4IsGrtrOrEq(V4Add(cz, ez), V4LoadA(mRayMin[2])), V4IsGrtrOrEq(V4LoadA(mRayMax[2]), V4Sub(cz, ez))));
+
+		// cross axes
+		const Vec4V offX = V4Sub(mOx, cx), offY = V4Sub(mOy, cy), offZ = V4Sub(mOz, cz);
+		const Vec4V fx = V4NegMulSub(mDy, offX, V4Mul(mDx, offY));
+		const Vec4V fy = V4NegMulSub(mDz, offY, V4Mul(mDy, offZ));
+		const Vec4V fz = V4NegMulSub(mDx, offZ, V4Mul(mDz, offX));
+		const Vec4V gx = V4MulAdd(ex, mAbsDy, V4Mul(ey, mAbsDx));
+		const Vec4V gy = V4MulAdd(ey, mAbsDz, V4Mul(ez, mAbsDy));
+		const Vec4V gz = V4MulAdd(ez, mAbsDx, V4Mul(ex, mAbsDz));
+		mask = BAnd(mask, BAnd(V4IsGrtrOrEq(gx, V4Abs(fx)), BAnd(V4IsGrtrOrEq(gy, V4Abs(fy)), V4IsGrtrOrEq(gz, V4Abs(fz)))));
+
+		return BGetBitMask(mask);
+	}
+
+	Vec4V mOx, mOy, mOz, mDx, mDy, mDz, mAbsDx, mAbsDy, mAbsDz;
+
+private:
+	// same segment bounds as RayAABBTest, per axis and per ray
+	PX_FORCE_INLINE void setLimits(PxU32 ray, PxReal maxDist)
+	{
+		for(PxU32 axis=0;axis<3;axis++)
+		{
+			const PxReal o = mOrigin[axis][ray];
+			const PxReal d = mDir[axis][ray];
+			const PxReal ext = maxDist >= PX_MAX_F32 ? (d == 0 ? o : PxSign(d)*PX_MAX_F32) : o + d*maxDist;
+			mRayMin[axis][ray] = PxMin(o, ext);
+			mRayMax[axis][ray] = PxMax(o, ext);
+		}
+	}
+
+	PX_ALIGN(16, PxReal mOrigin[3][4]);
+	PX_ALIGN(16, PxReal mDir[3][4]);
+	PX_ALIGN(16, PxReal mRayMin[3][4]);
+	PX_ALIGN(16, PxReal mRayMax[3][4]);
+};
+
 // probably not worth having a SIMD version of this unless the traversal passes Vec3Vs
 struct AABBAABBTest
 {
@@ -41,6 +41,7 @@ PruningPool::PruningPool() :
 	mMaxNbObjects		(0),
 	mWorldBoxes			(NULL),
 	mObjects			(NULL),
+	mFilterMasks		(NULL),
 	mHandleToIndex		(NULL),
 	mIndexToHandle		(NULL),
 	mFirstRecycledHandle(INVALID_PRUNERHANDLE)
@@ -51,6 +52,7 @@ PruningPool::~PruningPool()
 {
 	PX_FREE_AND_RESET(mWorldBoxes);
 	PX_FREE_AND_RESET(mObjects);
+	PX_FREE_AND_RESET(mFilterMasks);
 	PX_FREE_AND_RESET(mHandleToIndex);
 	PX_FREE_AND_RESET(mIndexToHandle);
 }
@@ -60,13 +62,15 @@ bool PruningPool::resize(PxU32 newCapacity)
 	// PT: we always allocate one extra box, to make sure we can safely use V4 loads on the array
 	PxBounds3*		newBoxes			= reinterpret_cast<PxBounds3*>(PX_ALLOC(sizeof(PxBounds3)*(newCapacity+1), "PxBounds3"));
 	PrunerPayload*	newData				= reinterpret_cast<PrunerPayload*>(PX_ALLOC(sizeof(PrunerPayload)*newCapacity, "PrunerPayload*"));
+	PxU32*			newFilterMasks		= reinterpret_cast<PxU32*>(PX_ALLOC(sizeof(PxU32)*newCapacity, "Pruner filter masks"));
 	PrunerHandle*	newIndexToHandle	= reinterpret_cast<PrunerHandle*>(PX_ALLOC(sizeof(PrunerHandle)*newCapacity, "Pruner Index Mapping"));
 	PoolIndex*		newHandleToIndex	= reinterpret_cast<PoolIndex*>(PX_ALLOC(sizeof(PoolIndex)*newCapacity, "Pruner Index Mapping"));
-	if( (NULL==newBoxes) || (NULL==newData) || (NULL==newIndexToHandle) || (NULL==newHandleToIndex)
+	if( (NULL==newBoxes) || (NULL==newData) || (NULL==newFilterMasks) || (NULL==newIndexToHandle) || (NULL==newHandleToIndex)
 		)
 	{
 		PX_FREE_AND_RESET(newBoxes);
 		PX_FREE_AND_RESET(newData);
+		PX_FREE_AND_RESET(newFilterMasks);
 		PX_FREE_AND_RESET(newIndexToHandle);
 		PX_FREE_AND_RESET(newHandleToIndex);
 		return false;
@@ -74,16 +78,19 @@ bool PruningPool::resize(PxU32 newCapacity)
 
 	if(mWorldBoxes)		PxMemCopy(newBoxes, mWorldBoxes, mNbObjects*sizeof(PxBounds3));
 	if(mObjects)		PxMemCopy(newData, mObjects, mNbObjects*sizeof(PrunerPayload));
+	if(mFilterMasks)	PxMemCopy(newFilterMasks, mFilterMasks, mNbObjects*sizeof(PxU32));
 	if(mIndexToHandle)	PxMemCopy(newIndexToHandle, mIndexToHandle, mNbObjects*sizeof(PrunerHandle));
 	if(mHandleToIndex)	PxMemCopy(newHandleToIndex, mHandleToIndex, mMaxNbObjects*sizeof(PoolIndex));
 	mMaxNbObjects = newCapacity;
 
 	PX_FREE_AND_RESET(mWorldBoxes);
 	PX_FREE_AND_RESET(mObjects);
+	PX_FREE_AND_RESET(mFilterMasks);
 	PX_FREE_AND_RESET(mHandleToIndex);
 	PX_FREE_AND_RESET(mIndexToHandle);
 	mWorldBoxes		= newBoxes;
 	mObjects		= newData;
+	mFilterMasks	= newFilterMasks;
 	mHandleToIndex	= newHandleToIndex;
 	mIndexToHandle	= newIndexToHandle;
 
@@ -133,6 +140,7 @@ PxU32 PruningPool::addObjects(PrunerHandle* results, const PxBounds3* bounds, co
 		// PT: these 3 arrays are "parallel"
 		mWorldBoxes		[index] = bounds[i]; // store the payload and AABB in parallel arrays
 		mObjects		[index] = payload[i];
+		mFilterMasks	[index] = 0xffffffff;	// passes every filter until setFilterMask() is called
 		mIndexToHandle	[index] = handle;
 
 		mHandleToIndex[handle] = index;
@@ -160,6 +168,7 @@ PoolIndex PruningPool::removeObject(PrunerHandle h)
 		const PrunerHandle handleOfLastObject	= mIndexToHandle[indexOfLastObject];
 		mWorldBoxes		[indexOfRemovedObject]	= mWorldBoxes	[indexOfLastObject];
 		mObjects		[indexOfRemovedObject]	= mObjects		[indexOfLastObject];
+		mFilterMasks	[indexOfRemovedObject]	= mFilterMasks	[indexOfLastObject];
 		mIndexToHandle	[indexOfRemovedObject]	= handleOfLastObject;
 
 		mHandleToIndex[handleOfLastObject]		= indexOfRemovedObject;
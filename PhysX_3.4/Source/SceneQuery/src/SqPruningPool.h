@@ -75,6 +75,8 @@ namespace Sq
 		PX_FORCE_INLINE	PxU32					getNbActiveObjects()	const	{ return mNbObjects;		}
 		PX_FORCE_INLINE	const PxBounds3*		getCurrentWorldBoxes()	const	{ return mWorldBoxes;		}
 		PX_FORCE_INLINE	PxBounds3*				getCurrentWorldBoxes()			{ return mWorldBoxes;		}
+		PX_FORCE_INLINE	const PxU32*			getFilterMasks()		const	{ return mFilterMasks;		}
+		PX_FORCE_INLINE	void					setFilterMask(PrunerHandle h, PxU32 mask)	{ mFilterMasks[getIndex(h)] = mask;	}
 
 		PX_FORCE_INLINE	const PxBounds3&		getWorldAABB(PrunerHandle h) const
 												{
@@ -101,6 +103,7 @@ namespace Sq
 						//!< these arrays are parallel
 						PxBounds3*				mWorldBoxes;		//!< List of world boxes, stores mNbObjects, capacity=mMaxNbObjects
 						PrunerPayload*			mObjects;			//!< List of objects, stores mNbObjects, capacity=mMaxNbObjects
+						PxU32*					mFilterMasks;		//!< Filter mask of each object, see Pruner::setFilterMask()
 //	private:			
 						PoolIndex*				mHandleToIndex;		//!< Maps from PrunerHandle to internal index (payload index in mObjects)
 						PrunerHandle*			mIndexToHandle;		//!< Inverse map from objectIndex to PrunerHandle
@@ -145,7 +145,7 @@ static void getShapeBounds(PxRigidActor* actor, bool dynamic, PxBounds3* bounds,
 }
 
 //////////////////////////////////////////////////////////////////////////
-bool PruningStructure::build(PxRigidActor*const* actors, PxU32 nbActors)
+bool PruningStructure::build(PxRigidActor*const* actors, PxU32 nbActors, PxCpuDispatcher* dispatcher)
 {
 	PX_ASSERT(actors);
 	PX_ASSERT(nbActors > 0);
@@ -256,6 +256,9 @@ bool PruningStructure::build(PxRigidActor*const* actors, PxU32 nbActors)
 			sTB.mNbPrimitives = numShapes[i];
 			sTB.mAABBArray = bounds[i];
 			sTB.mLimit = NB_OBJECTS_PER_NODE;
+			// the tree is built once and merged as is into the scene trees, so it is worth the better split
+			sTB.mBuildStrategy = BUILD_STRATEGY_SAH;
+			sTB.mDispatcher = dispatcher;
 			bool status = aabbTrees[i].build(sTB);
 
 			PX_UNUSED(status);
@@ -29,7 +29,9 @@
 
 #include "SqSceneQueryManager.h"
 #include "SqAABBPruner.h"
+#include "SqIncrementalAABBPruner.h"
 #include "SqBucketPruner.h"
+#include "SqHashGridPruner.h"
 #include "SqBounds.h"
 #include "NpBatchQuery.h"
 #include "PxFiltering.h"
@@ -43,6 +45,8 @@
 #include "SqPruner.h"
 #include "GuBounds.h"
 #include "NpShape.h"
+#include "PsThread.h"
+#include "PsInlineArray.h"
 
 using namespace physx;
 using namespace Sq;
@@ -69,7 +73,7 @@ PrunerExt::~PrunerExt()
 	PX_DELETE_AND_RESET(mPruner);
 }
 
-void PrunerExt::init(PxPruningStructureType::Enum type, PxU64 contextID)
+void PrunerExt::init(PxPruningStructureType::Enum type, PxU64 contextID, PxCpuDispatcher* dispatcher)
 {
 	mPrunerType = type;
 	mTimestamp	= 0;
@@ -77,8 +81,10 @@ void PrunerExt::init(PxPruningStructureType::Enum type, PxU64 contextID)
 	switch(type)
 	{
 		case PxPruningStructureType::eNONE:					{ pruner = PX_NEW(BucketPruner);					break;	}
-		case PxPruningStructureType::eDYNAMIC_AABB_TREE:	{ pruner = PX_NEW(AABBPruner)(true, contextID);		break;	}
-		case PxPruningStructureType::eSTATIC_AABB_TREE:		{ pruner = PX_NEW(AABBPruner)(false, contextID);	break;	}
+		case PxPruningStructureType::eDYNAMIC_AABB_TREE:	{ pruner = PX_NEW(AABBPruner)(true, contextID, dispatcher);		break;	}
+		case PxPruningStructureType::eSTATIC_AABB_TREE:		{ pruner = PX_NEW(AABBPruner)(false, contextID, dispatcher);	break;	}
+		case PxPruningStructureType::eINCREMENTAL_AABB_TREE:{ pruner = PX_NEW(IncrementalAABBPruner)(contextID);	break;	}
+		case PxPruningStructureType::eHASH_GRID:			{ pruner = PX_NEW(HashGridPruner)(contextID);			break;	}
 		case PxPruningStructureType::eLAST:					break;
 	}
 	mPruner = pruner;
@@ -175,13 +181,35 @@ void PrunerExt::growDirtyList(PrunerHandle handle)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+	// values of mPublishedSnapshots besides the set indices
+	enum
+	{
+		eSNAPSHOTS_NONE		= -2,	// readers use the pruners
+		eSNAPSHOTS_PAUSED	= -1	// readers wait
+	};
+
+	struct ScbPoseCallback : public PrunerPoseCallback
+	{
+		virtual void getPose(PxTransform& pose, const PrunerPayload& payload) const
+		{
+			NpActor::getGlobalPose(pose, *reinterpret_cast<const Scb::Shape*>(payload.data[0]), *reinterpret_cast<const Scb::Actor*>(payload.data[1]));
+		}
+	};
+}
+
 SceneQueryManager::SceneQueryManager(	Scb::Scene& scene, PxPruningStructureType::Enum staticStructure, 
 										PxPruningStructureType::Enum dynamicStructure, PxU32 dynamicTreeRebuildRateHint,
-										const PxSceneLimits& limits) :
-	mScene		(scene)
+										const PxSceneLimits& limits, PxCpuDispatcher* dispatcher) :
+	mScene				(scene),
+	mDispatcher			(dispatcher),
+	mPublishedSnapshots	(eSNAPSHOTS_NONE),
+	mSnapshotVersion	(0),
+	mUseSnapshots		(scene.getFlags() & PxSceneFlag::eENABLE_QUERY_SNAPSHOTS)
 {
-	mPrunerExt[PruningIndex::eSTATIC].init(staticStructure, scene.getContextId());
-	mPrunerExt[PruningIndex::eDYNAMIC].init(dynamicStructure, scene.getContextId());
+	mPrunerExt[PruningIndex::eSTATIC].init(staticStructure, scene.getContextId(), dispatcher);
+	mPrunerExt[PruningIndex::eDYNAMIC].init(dynamicStructure, scene.getContextId(), dispatcher);
 
 	setDynamicTreeRebuildRateHint(dynamicTreeRebuildRateHint);
 
@@ -195,6 +223,11 @@ SceneQueryManager::SceneQueryManager(	Scb::Scene& scene, PxPruningStructureType:
 
 SceneQueryManager::~SceneQueryManager()
 {
+	for(PxU32 i=0; i<2; i++)
+	{
+		for(PxU32 j=0; j<PruningIndex::eCOUNT; j++)
+			PX_DELETE_AND_RESET(mSnapshotSets[i].mSnapshots[j]);
+	}
 }
 
 void SceneQueryManager::flushMemory()
@@ -212,6 +245,15 @@ void SceneQueryManager::markForUpdate(PrunerData data)
 	mPrunerExt[index].addToDirtyList(handle);
 }
 
+void SceneQueryManager::setFilterMask(PrunerData data, PxU32 mask)
+{
+	mPrunerNeedsUpdating = true;
+	const PxU32 index = getPrunerIndex(data);
+	const PrunerHandle handle = getPrunerHandle(data);
+
+	mPrunerExt[index].pruner()->setFilterMask(handle, mask);
+}
+
 void SceneQueryManager::preallocate(PxU32 staticShapes, PxU32 dynamicShapes)
 {
 	mPrunerExt[PruningIndex::eSTATIC].preallocate(staticShapes);
@@ -238,6 +280,7 @@ PrunerData SceneQueryManager::addPrunerShape(const NpShape& shape, const PxRigid
 	PrunerHandle handle;
 	PX_ASSERT(mPrunerExt[index].pruner());
 	mPrunerExt[index].pruner()->addObjects(&handle, &b, &pp, 1, hasPrunerStructure);
+	mPrunerExt[index].pruner()->setFilterMask(handle, shape.getQueryFilterDataFast().word0);
 	mPrunerExt[index].invalidateTimestamp();
 
 	mPrunerExt[index].growDirtyList(handle);
@@ -245,6 +288,95 @@ PrunerData SceneQueryManager::addPrunerShape(const NpShape& shape, const PxRigid
 	return createPrunerData(index, handle);
 }
 
+void SceneQueryManager::addPrunerShapes(PxU32 nbShapes, const NpShape*const* shapes, const PxRigidActor& actor, bool dynamic, PrunerData* shapeData)
+{
+	if(!nbShapes)
+		return;
+
+	mPrunerNeedsUpdating = true;
+
+	const Scb::Actor& scbActor = gOffsetTable.convertPxActor2Scb(actor);
+
+	Ps::InlineArray<PrunerPayload, 32> payloads;
+	Ps::InlineArray<PxBounds3, 32> bounds;
+	Ps::InlineArray<PrunerHandle, 32> handles;
+	payloads.resize(nbShapes);
+	bounds.resize(nbShapes);
+	// the pools stop at the first failed allocation, the following handles are left untouched
+	handles.resize(nbShapes, INVALID_PRUNERHANDLE);
+
+	for(PxU32 i=0;i<nbShapes;i++)
+	{
+		const Scb::Shape& scbShape = shapes[i]->getScbShape();
+		payloads[i].data[0] = size_t(&scbShape);
+		payloads[i].data[1] = size_t(&scbActor);
+		(gComputeBoundsTable[dynamic])(bounds[i], scbShape, scbActor);
+	}
+
+	const PxU32 index = PxU32(dynamic);
+	PX_ASSERT(mPrunerExt[index].pruner());
+	// one insertion for all the shapes, e.g. the tree of the AABB pruner is only touched once
+	mPrunerExt[index].pruner()->addObjects(handles.begin(), bounds.begin(), payloads.begin(), nbShapes, false);
+	mPrunerExt[index].invalidateTimestamp();
+
+	for(PxU32 i=0;i<nbShapes;i++)
+	{
+		if(handles[i] != INVALID_PRUNERHANDLE)
+		{
+			mPrunerExt[index].pruner()->setFilterMask(handles[i], shapes[i]->getQueryFilterDataFast().word0);
+			mPrunerExt[index].growDirtyList(handles[i]);
+			shapeData[i] = createPrunerData(index, handles[i]);
+		}
+		else
+			shapeData[i] = SQ_INVALID_PRUNER_DATA;
+	}
+}
+
+void SceneQueryManager::removePrunerShapes(PxU32 nbShapes, const PrunerData* shapeData)
+{
+	if(!nbShapes)
+		return;
+
+	mPrunerNeedsUpdating = true;
+
+	Ps::InlineArray<PrunerHandle, 32> handles[PruningIndex::eCOUNT];
+	for(PxU32 i=0;i<nbShapes;i++)
+	{
+		const PxU32 index = getPrunerIndex(shapeData[i]);
+		const PrunerHandle handle = getPrunerHandle(shapeData[i]);
+		mPrunerExt[index].removeFromDirtyList(handle);
+		handles[index].pushBack(handle);
+	}
+
+	for(PxU32 index=0; index<PruningIndex::eCOUNT; index++)
+	{
+		if(handles[index].empty())
+			continue;
+
+		PX_ASSERT(mPrunerExt[index].pruner());
+		mPrunerExt[index].invalidateTimestamp();
+		mPrunerExt[index].pruner()->removeObjects(handles[index].begin(), handles[index].size());
+	}
+
+	// the objects will be released, the snapshots must stop returning them before the readers can see they are gone.
+	// The readers are only paused once for the whole batch.
+	const PxI32 published = pauseSnapshots();
+	if(published >= 0)
+	{
+		for(PxU32 i=0; i<2; i++)
+		{
+			for(PxU32 index=0; index<PruningIndex::eCOUNT; index++)
+			{
+				if(!mSnapshotSets[i].mSnapshots[index])
+					continue;
+				for(PxU32 j=0; j<handles[index].size(); j++)
+					mSnapshotSets[i].mSnapshots[index]->hideObject(handles[index][j]);
+			}
+		}
+	}
+	resumeSnapshots(published);
+}
+
 const PrunerPayload& SceneQueryManager::getPayload(PrunerData data) const
 {
 	const PxU32 index = getPrunerIndex(data);
@@ -264,6 +396,18 @@ void SceneQueryManager::removePrunerShape(PrunerData data)
 
 	mPrunerExt[index].invalidateTimestamp();
 	mPrunerExt[index].pruner()->removeObjects(&handle, 1);
+
+	// the object will be released, the snapshots must stop returning it before the readers can see it is gone
+	const PxI32 published = pauseSnapshots();
+	if(published >= 0)
+	{
+		for(PxU32 i=0; i<2; i++)
+		{
+			if(mSnapshotSets[i].mSnapshots[index])
+				mSnapshotSets[i].mSnapshots[index]->hideObject(handle);
+		}
+	}
+	resumeSnapshots(published);
 }
 
 void SceneQueryManager::setDynamicTreeRebuildRateHint(PxU32 rebuildRateHint)
@@ -418,10 +562,10 @@ void SceneQueryManager::forceDynamicTreeRebuild(bool rebuildStaticStructure, boo
 	Ps::Mutex::ScopedLock lock(mSceneQueryLock);
 	for(PxU32 i=0; i<PruningIndex::eCOUNT; i++)
 	{
-		if(rebuild[i] && mPrunerExt[i].pruner() && mPrunerExt[i].type() == PxPruningStructureType::eDYNAMIC_AABB_TREE)
+		if(rebuild[i] && mPrunerExt[i].pruner() && (mPrunerExt[i].type() == PxPruningStructureType::eDYNAMIC_AABB_TREE || mPrunerExt[i].type() == PxPruningStructureType::eINCREMENTAL_AABB_TREE))
 		{
-			static_cast<AABBPruner*>(mPrunerExt[i].pruner())->purge();
-			static_cast<AABBPruner*>(mPrunerExt[i].pruner())->commit();
+			static_cast<IncrementalPruner*>(mPrunerExt[i].pruner())->purge();
+			static_cast<IncrementalPruner*>(mPrunerExt[i].pruner())->commit();
 		}
 	}
 }
@@ -454,6 +598,113 @@ void SceneQueryManager::shiftOrigin(const PxVec3& shift)
 {
 	for(PxU32 i=0; i<PruningIndex::eCOUNT; i++)
 		mPrunerExt[i].pruner()->shiftOrigin(shift);
+
+	const PxI32 published = pauseSnapshots();
+	if(published >= 0)
+	{
+		for(PxU32 i=0; i<2; i++)
+		{
+			for(PxU32 j=0; j<PruningIndex::eCOUNT; j++)
+			{
+				if(mSnapshotSets[i].mSnapshots[j])
+					mSnapshotSets[i].mSnapshots[j]->shiftOrigin(shift);
+			}
+		}
+	}
+	resumeSnapshots(published);
+}
+
+const PrunerSnapshotSet* SceneQueryManager::acquireSnapshots() const
+{
+	if(!mUseSnapshots)
+		return NULL;
+
+	while(1)
+	{
+		const PxI32 published = mPublishedSnapshots;
+		if(published == eSNAPSHOTS_NONE)
+			return NULL;
+
+		if(published == eSNAPSHOTS_PAUSED)
+		{
+			Ps::Thread::yield();
+			continue;
+		}
+
+		// the writer can switch sets between the read and the increment, in which case it may already be updating this one
+		PrunerSnapshotSet& set = mSnapshotSets[published];
+		Ps::atomicIncrement(&set.mNbReaders);
+		if(mPublishedSnapshots == published)
+			return &set;
+		Ps::atomicDecrement(&set.mNbReaders);
+	}
+}
+
+void SceneQueryManager::publishSnapshots()
+{
+	if(!mUseSnapshots)
+		return;
+
+	PX_PROFILE_ZONE("SceneQuery.publishSnapshots", mScene.getContextId());
+
+	flushUpdates();
+
+	const PxI32 published = mPublishedSnapshots;
+	PX_ASSERT(published != eSNAPSHOTS_PAUSED);
+	if(published >= 0)
+	{
+		bool upToDate = true;
+		for(PxU32 i=0; i<PruningIndex::eCOUNT; i++)
+			upToDate = upToDate && mSnapshotSets[published].mSnapshots[i]->isUpToDate(mPrunerExt[i].timestamp());
+		if(upToDate)
+			return;
+	}
+
+	// update the set readers don't use, once the readers that got it before the previous publish are done
+	const PxI32 target = published == 0 ? 1 : 0;
+	PrunerSnapshotSet& set = mSnapshotSets[target];
+	while(set.mNbReaders)
+		Ps::Thread::yield();
+
+	const ScbPoseCallback poses;
+	for(PxU32 i=0; i<PruningIndex::eCOUNT; i++)
+	{
+		if(!set.mSnapshots[i])
+			set.mSnapshots[i] = PX_NEW(PrunerSnapshot)(mScene.getContextId());
+		set.mSnapshots[i]->update(*mPrunerExt[i].pruner(), mPrunerExt[i].timestamp(), poses, mDispatcher);
+	}
+
+	Ps::memoryBarrier();
+	mSnapshotVersion++;
+	mPublishedSnapshots = target;
+	Ps::memoryBarrier();
+}
+
+PxI32 SceneQueryManager::pauseSnapshots()
+{
+	const PxI32 published = mPublishedSnapshots;
+	if(published < 0)
+		return published;
+
+	mPublishedSnapshots = eSNAPSHOTS_PAUSED;
+	Ps::memoryBarrier();
+	for(PxU32 i=0; i<2; i++)
+	{
+		while(mSnapshotSets[i].mNbReaders)
+			Ps::Thread::yield();
+	}
+	return published;
+}
+
+void SceneQueryManager::resumeSnapshots(PxI32 published)
+{
+	if(published < 0)
+		return;
+
+	Ps::memoryBarrier();
+	mSnapshotVersion++;
+	mPublishedSnapshots = published;
+	Ps::memoryBarrier();
 }
 
 void DynamicBoundsSync::sync(const PrunerHandle* handles, const PxU32* indices, const PxBounds3* bounds, PxU32 count, const Cm::BitMap& dirtyShapeSimMap)
@@ -234,6 +234,12 @@ namespace Sc
 		bool					getSelfCollisionIndices(PxU32* indices) const;
 		PxU32					getNbSelfCollisionIndices() const;
 
+		void					setSelfCollisionInterval(PxU32 interval);
+		PxU32					getSelfCollisionInterval() const;
+
+		void					setLod(const PxClothLod& lod);
+		PxClothLod				getLod() const;
+
 		void					setRestPositions(const PxVec4* restPositions);
 		bool					getRestPositions(PxVec4* restPositions) const;
 		PxU32					getNbRestPositions() const;
@@ -125,6 +125,7 @@ namespace Sc
 
 		PxParticleReadDataFlags	getParticleReadDataFlags()						const;
 		void					setParticleReadDataFlags(PxParticleReadDataFlags);
+		void					setParticleWriteBuffers(const PxParticleWriteBuffers* buffers);
 
 		PxU32 					getMaxParticles()								const;
 
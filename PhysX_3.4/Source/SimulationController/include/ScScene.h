@@ -39,6 +39,7 @@
 #include "PxSimulationEventCallback.h"
 #include "PsPool.h"
 #include "PsHashSet.h"
+#include "PsSync.h"
 #include "CmRenderOutput.h"
 #include "CmTask.h"
 #include "CmFlushPool.h"
@@ -150,6 +151,7 @@ namespace Sc
 	class ShapeInteraction;
 	class ElementInteractionMarker;
 	class ArticulationSim;
+	class ArticulationJointSim;
 
 #if PX_USE_PARTICLE_SYSTEM_API
 	class ParticleSystemSim;
@@ -161,6 +163,7 @@ namespace Sc
 #endif
 
 	class SimStats;
+	class CostProfiler;
 
 	struct SimStateData;
 
@@ -410,8 +413,16 @@ namespace Sc
 // PX_ENABLE_SIM_STATS
 					void						getStats(PxSimulationStatistics& stats) const;
 	PX_FORCE_INLINE	SimStats&					getStatsInternal() { return *mStats; }
+					// Times the stages run by fetchResults(), see PxSimulationStatistics::stageWallTime
+					void						beginStatsStage(PxSimulationStatistics::StageType stage);
+					void						endStatsStage(PxSimulationStatistics::StageType stage);
 // PX_ENABLE_SIM_STATS
 
+					// See PxScene::setCostProfiling, 0 disables the profiling
+					void						setCostProfiling(PxU32 maxEntries);
+					PxU32						getCostProfiling() const;
+					bool						getCostProfile(PxCostProfile& profile) const;
+
 	PX_DEPRECATED	void						buildActiveTransforms();
 	PX_DEPRECATED	PxActiveTransform*			getActiveTransforms(PxU32& nbTransformsOut, PxClientID client);
 					void						buildActiveActors();
@@ -421,6 +432,11 @@ namespace Sc
 						const ActorPairReport& aPair, 
 						ContactStreamManager& cs, PxU32 removedShapeTestMask);
 
+					// Fills mQueuedContactPairHeaders with one header per contact report actor pair, nbPairs is 0 for the invalid streams.
+					// With PxSceneFlag::eENABLE_PARALLEL_CONTACT_REPORTS, the headers are finalized by parallel tasks.
+					void						buildContactPairHeaders(bool asPartOfFlush);
+					void						finalizeContactPairHeaders(PxU32 startIndex, PxU32 nbActorPairs, PxU32 removedShapeTestMask);
+
 					PxClientID					createClient();
 					void						setClientBehaviorFlags(PxClientID client, PxClientBehaviorFlags clientBehaviorFlags); 
 					PxClientBehaviorFlags		getClientBehaviorFlags(PxClientID client) const;
@@ -570,6 +586,8 @@ namespace Sc
 						PxU32						getBroadPhaseRegions(PxBroadPhaseRegionInfo* userBuffer, PxU32 bufferSize, PxU32 startIndex)	const;
 						PxU32						addBroadPhaseRegion(const PxBroadPhaseRegion& region, bool populateRegion);
 						bool						removeBroadPhaseRegion(PxU32 handle);
+						bool						setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc);
+						void						getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs)	const;
 						void**						getOutOfBoundsAggregates();
 						PxU32						getNbOutOfBoundsAggregates();
 						void						clearOutOfBoundsAggregates();
@@ -588,6 +606,7 @@ namespace Sc
 		PX_FORCE_INLINE	const void*					getFilterShaderDataFast()				const	{ return mFilterShaderData;				}
 		PX_FORCE_INLINE	PxU32						getFilterShaderDataSizeFast()			const	{ return mFilterShaderDataSize;			}
 		PX_FORCE_INLINE	PxSimulationFilterShader	getFilterShaderFast()					const	{ return mFilterShader;					}
+		PX_FORCE_INLINE	PxSimulationFilterBatchShader	getFilterBatchShaderFast()			const	{ return mFilterBatchShader;			}
 		PX_FORCE_INLINE	PxSimulationFilterCallback*	getFilterCallbackFast()					const	{ return mFilterCallback;				}
 		PX_FORCE_INLINE	PxPairFilteringMode::Enum	getKineKineFilteringMode()				const	{ return mKineKineFilteringMode;		}
 		PX_FORCE_INLINE	PxPairFilteringMode::Enum	getStaticKineFilteringMode()			const	{ return mStaticKineFilteringMode;		}
@@ -647,7 +666,7 @@ namespace Sc
 
 		PX_FORCE_INLINE Cm::BitMap&					getVelocityModifyMap() { return mVelocityModifyMap; }
 
-					void							stepSetupCollide();//This is very important to guarantee thread safty in the collide
+					void							stepSetupCollide(PxBaseTask* continuation);//This is very important to guarantee thread safty in the collide
 		PX_FORCE_INLINE void						addToPosePreviewList(BodySim& b)				{ PX_ASSERT(!mPosePreviewBodies.contains(&b)); mPosePreviewBodies.insert(&b); }
 		PX_FORCE_INLINE void						removeFromPosePreviewList(BodySim& b)			{ PX_ASSERT(mPosePreviewBodies.contains(&b)); mPosePreviewBodies.erase(&b); }
 #if PX_DEBUG
@@ -784,6 +803,9 @@ namespace Sc
 
 					Ps::Array<PxContactPairHeader>
 												mQueuedContactPairHeaders;
+					Ps::Array<PxContactPairHeader>
+												mClientContactPairHeaders;	// the headers sent to one client, if there are several
+					Ps::Sync					mContactPairHeadersDone;
 		//time:
 		//constants set with setTiming():
 					PxReal						mDt;						//delta time for current step.
@@ -830,6 +852,8 @@ namespace Sc
 
 					Ps::Array<Sc::ConstraintCore*>	mBrokenConstraints;
 					Ps::CoalescedHashSet<Sc::ConstraintSim*> mActiveBreakableConstraints;
+					Ps::Array<Sc::ConstraintSim*>	mBrokenConstraintCandidates;	// one entry per active breakable constraint, NULL unless the solver broke it
+					bool							mConstraintBreakageTested;		// set once the candidates of the current step are known
 
 					// pools for joint buffers
 					// Fixed joint is 92 bytes, D6 is 364 bytes right now. So these three pools cover all the internal cases
@@ -850,6 +874,7 @@ namespace Sc
 					PxU32						mFilterShaderDataSize;
 					PxU32						mFilterShaderDataCapacity;
 					PxSimulationFilterShader	mFilterShader;
+					PxSimulationFilterBatchShader	mFilterBatchShader;
 					PxSimulationFilterCallback*	mFilterCallback;
 
 					PxPairFilteringMode::Enum	mKineKineFilteringMode;
@@ -862,6 +887,7 @@ namespace Sc
 					bool						mEnableStabilization;
 					Ps::Array<Client*>			mClients;	//an array of transform arrays, one for each client.
 					SimStats*					mStats;
+					CostProfiler*				mCostProfiler;	// NULL unless the cost profiling is enabled
 					PxU32						mInternalFlags;	//!< Combination of ::SceneFlag
 					PxSceneFlags				mPublicFlags;	//copy of PxSceneDesc::flags, of type PxSceneFlag
 
@@ -877,6 +903,9 @@ namespace Sc
 					Cm::PreallocatingPool<BodySim>*		mBodySimPool;
 					Ps::Pool<ConstraintSim>*			mConstraintSimPool;
 					LLArticulationPool*					mLLArticulationPool;
+					// like the LL pool, created by the first articulation. Ragdolls that are added and removed often reuse these slots
+					Ps::Pool<ArticulationSim>*			mArticulationSimPool;
+					Ps::Pool<ArticulationJointSim>*		mArticulationJointSimPool;
 														
 					Ps::Pool<ConstraintInteraction>*
 												mConstraintInteractionPool;
@@ -942,6 +971,7 @@ namespace Sc
 					void						postThirdPassIslandGen(PxBaseTask*);
 					void						postSolver(PxBaseTask* continuation);
 					void						constraintProjection(PxBaseTask* continuation);
+					void						scheduleConstraintBreakageTests(PxBaseTask* continuation);
 					void						afterIntegration(PxBaseTask* continuation);  // performs sleep check, for instance
 					void						postCCDPass(PxBaseTask* continuation);
 					void						ccdBroadPhaseAABB(PxBaseTask* continuation);
@@ -235,13 +235,13 @@ void Sc::BodySim::updateCached(Cm::BitMapPinned* shapeChangedMap)
 	}
 }
 
-void Sc::BodySim::updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray)
+void Sc::BodySim::updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray, Gu::BoundsBatch& boundsBatch)
 {
 	PX_ASSERT(!(mLLBody.mInternalFlags & PxsRigidBody::eFROZEN));	// PT: should not be called otherwise
 
 	Sc::ShapeSim* sim;
 	for(Sc::ShapeIterator iterator(*this); (sim = iterator.getNext())!=NULL;)
-		sim->updateCached(transformCache, boundsArray);
+		sim->updateCached(transformCache, boundsArray, boundsBatch);
 }
 
 void Sc::BodySim::updateContactDistance(PxReal* contactDistance, const PxReal dt, Bp::BoundsArray& boundsArray)
@@ -349,8 +349,10 @@ void Sc::BodySim::postBody2WorldChange()
 	mLLBody.saveLastCCDTransform();
 
 #if PX_USE_PARTICLE_SYSTEM_API
-	if (getScene().getParticleContext()->getBodyTransformVaultFast().isInVault(*mLLBody.mCore))
-		getScene().getParticleContext()->getBodyTransformVaultFast().teleportBody(*mLLBody.mCore);
+	// no context until the scene gets its first particle system
+	Pt::Context* particleContext = getScene().getParticleContext();
+	if (particleContext && particleContext->getBodyTransformVaultFast().isInVault(*mLLBody.mCore))
+		particleContext->getBodyTransformVaultFast().teleportBody(*mLLBody.mCore);
 #endif
 
 	notifyShapesOfTransformChange();
@@ -48,6 +48,10 @@ namespace physx
 namespace Bp
 {
 	class BoundsArray;
+}
+namespace Gu
+{
+	class BoundsBatch;
 }
 	class PxsTransformCache;
 	class PxsSimulationController;
@@ -96,7 +100,7 @@ namespace Sc
 						void					notifyAddSpatialVelocity();
 						void					notifyClearSpatialVelocity();
 						void					updateCached(Cm::BitMapPinned* shapeChangedMap);
-						void					updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray);
+						void					updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray, Gu::BoundsBatch& boundsBatch);
 						void					updateContactDistance(PxReal* contactDistance, const PxReal dt, Bp::BoundsArray& boundsArray);
 
 		// hooks for actions in body core when it's attached to a sim object. Generally
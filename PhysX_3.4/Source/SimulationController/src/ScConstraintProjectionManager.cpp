@@ -33,6 +33,8 @@
 #include "ScBodySim.h"
 #include "ScConstraintSim.h"
 #include "ScConstraintInteraction.h"
+#include "CmFlushPool.h"
+#include "CmTask.h"
 
 using namespace physx;
 
@@ -392,10 +394,70 @@ PX_FORCE_INLINE void Sc::ConstraintProjectionManager::processConstraintForGroupB
 }
 
 
-void Sc::ConstraintProjectionManager::processPendingUpdates(PxcScratchAllocator& scratchAllocator)
+static void buildProjectionTrees(Sc::ConstraintGroupNode* const* roots, PxU32 nbRoots)
 {
+	for(PxU32 i=0; i < nbRoots; i++)
+	{
+		// the flag was only used to avoid duplicate entries in the build list
+		roots[i]->clearFlag(Sc::ConstraintGroupNode::ePENDING_TREE_UPDATE);
+		roots[i]->buildProjectionTrees();
+	}
+}
+
+
+class ProjectionTreeBuildTask : public Cm::Task
+{
+public:
+	ProjectionTreeBuildTask(PxU64 contextID, Sc::ConstraintGroupNode* const* roots, PxU32 nbRoots) :
+		Cm::Task	(contextID),
+		mRoots		(roots),
+		mNbRoots	(nbRoots)
+	{
+	}
+
+	virtual void runInternal()
+	{
+		// a constraint group only touches its own nodes while building, the groups can be processed independently
+		buildProjectionTrees(mRoots, mNbRoots);
+	}
+
+	virtual const char* getName() const
+	{
+		return "ScScene.projectionTreeBuild";
+	}
+
+public:
+	static const PxU32 sNodesPerTask = 256;  // just a guideline, batches end on group boundaries
+
+private:
+	PX_NOCOPY(ProjectionTreeBuildTask)
+
+	Sc::ConstraintGroupNode* const* mRoots;
+	const PxU32 mNbRoots;
+};
+
+
+PX_FORCE_INLINE void Sc::ConstraintProjectionManager::addToTreeBuilds(ConstraintGroupNode& root)
+{
+	PX_ASSERT(&root == &root.getRoot());
+	PX_ASSERT(!root.hasProjectionTreeRoot());
+
+	if (!root.readFlag(ConstraintGroupNode::ePENDING_TREE_UPDATE))
+	{
+		root.raiseFlag(ConstraintGroupNode::ePENDING_TREE_UPDATE);
+		mTreeBuildRoots.pushBack(&root);
+	}
+}
+
+
+void Sc::ConstraintProjectionManager::processPendingUpdates(PxcScratchAllocator& scratchAllocator, Cm::FlushPool& taskPool, PxBaseTask* continuation, PxU64 contextID)
+{
+	// the build tasks of the previous step are done by now
+	mTreeBuildRoots.clear();
+
 	//
-	// if there are dirty projection trees, then rebuild them
+	// if there are dirty projection trees, then purge them. They get rebuilt together with the trees of the new groups
+	// below, the groups might still get merged when the new constraints are processed.
 	//
 	const PxU32 nbProjectionTreesToUpdate = mPendingTreeUpdates.size();
 	if (nbProjectionTreesToUpdate)
@@ -414,7 +476,7 @@ void Sc::ConstraintProjectionManager::processPendingUpdates(PxcScratchAllocator&
 			//       at some point (hence no projection root) and later some of those get switched to dynamic.
 			if (n->hasProjectionTreeRoot())
 				n->purgeProjectionTrees();
-			n->buildProjectionTrees();
+			mTreeBuildRoots.pushBack(n);
 		}
 
 		mPendingTreeUpdates.clear();
@@ -452,6 +514,17 @@ void Sc::ConstraintProjectionManager::processPendingUpdates(PxcScratchAllocator&
 
 			nextConstraint = iter.getNext();
 		}
+	}
+
+	// The purged groups might have been merged into others, only the current roots get their trees built
+	const PxU32 nbPurgedTrees = mTreeBuildRoots.size();
+	mTreeBuildRoots.forceSize_Unsafe(0);
+	for(PxU32 i=0; i < nbPurgedTrees; i++)
+		addToTreeBuilds(mTreeBuildRoots.begin()[i]->getRoot());  // writes at most up to the entry that was just read
+
+	if (nbProjectionConstraintsToUpdate)
+	{
+		ConstraintSim* const* projectionConstraintsToUpdate = mPendingGroupUpdates.getEntries();
 
 		// Now find all the newly made groups and build projection trees.
 		// Don't need to iterate over the additionally constraints since the roots are supposed to be
@@ -465,11 +538,39 @@ void Sc::ConstraintProjectionManager::processPendingUpdates(PxcScratchAllocator&
 
 			ConstraintGroupNode& root = b->getConstraintGroup()->getRoot();
 			if (!root.hasProjectionTreeRoot())  // Build projection tree only once
-				root.buildProjectionTrees();
+				addToTreeBuilds(root);
 		}
 
 		mPendingGroupUpdates.clear();
 	}
+
+	//
+	// build the projection trees, the last batch is done by this thread
+	//
+	const PxU32 nbRoots = mTreeBuildRoots.size();
+	ConstraintGroupNode* const* roots = mTreeBuildRoots.begin();
+	PxU32 startIndex = 0;
+	if (continuation)
+	{
+		PxU32 nodeCount = 0;
+		for(PxU32 i=0; i < nbRoots; i++)
+		{
+			for(const ConstraintGroupNode* n = roots[i]; n; n = n->next)
+				nodeCount++;
+
+			if ((nodeCount >= ProjectionTreeBuildTask::sNodesPerTask) && (i + 1 < nbRoots))
+			{
+				ProjectionTreeBuildTask* task = PX_PLACEMENT_NEW(taskPool.allocate(sizeof(ProjectionTreeBuildTask)), 
+																	ProjectionTreeBuildTask(contextID, roots + startIndex, i - startIndex + 1));
+				task->setContinuation(continuation);
+				task->removeReference();
+
+				nodeCount = 0;
+				startIndex = i + 1;
+			}
+		}
+	}
+	buildProjectionTrees(roots + startIndex, nbRoots - startIndex);
 }
 
 
@@ -33,11 +33,18 @@
 
 #include "PsPool.h"
 #include "PsHashSet.h"
+#include "PsArray.h"
 #include "ScConstraintGroupNode.h"
 
 namespace physx
 {
 	class PxcScratchAllocator;
+	class PxBaseTask;
+
+namespace Cm
+{
+	class FlushPool;
+}
 
 namespace Sc
 {
@@ -57,7 +64,10 @@ namespace Sc
 		void addToPendingTreeUpdates(ConstraintGroupNode& n);
 		void removeFromPendingTreeUpdates(ConstraintGroupNode& n);
 
-		void processPendingUpdates(PxcScratchAllocator&);
+		// Groups and dirty trees are processed first, the projection trees are then built in parallel per constraint group
+		// if a continuation is given. The trees have to be complete once the continuation runs. Groups that did not change
+		// keep their trees from the previous frames.
+		void processPendingUpdates(PxcScratchAllocator&, Cm::FlushPool& taskPool, PxBaseTask* continuation, PxU64 contextID);
 		void invalidateGroup(ConstraintGroupNode& node, ConstraintSim* constraintDeleted);
 
 	private:
@@ -67,6 +77,7 @@ namespace Sc
 		void groupUnion(ConstraintGroupNode& root0, ConstraintGroupNode& root1);
 		void markConnectedConstraintsForUpdate(BodySim& b, ConstraintSim* c);
 		PX_FORCE_INLINE void processConstraintForGroupBuilding(ConstraintSim* c, ScratchAllocatorList<ConstraintSim*>&);
+		PX_FORCE_INLINE void addToTreeBuilds(ConstraintGroupNode& root);
 
 
 	private:
@@ -75,6 +86,8 @@ namespace Sc
 		Ps::CoalescedHashSet<ConstraintGroupNode*>	mPendingTreeUpdates;	//list of constraint groups that need their projection trees rebuilt. Note: non of the
 																			//constraints in those groups are allowed to be in mPendingGroupUpdates at the same time
 																			//because a group update will automatically trigger tree rebuilds.
+		Ps::Array<ConstraintGroupNode*>				mTreeBuildRoots;		//constraint group roots whose projection trees get built in the current step. Kept
+																			//until the next step since the build tasks work on it.
 	};
 
 } // namespace Sc
@@ -0,0 +1,201 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "foundation/PxMemory.h"
+#include "ScCostProfiler.h"
+#include "ScBodySim.h"
+#include "ScShapeInteraction.h"
+#include "PxvNphaseImplementationContext.h"
+#include "PxsContactManager.h"
+#include "DyContext.h"
+#include "PsTime.h"
+
+using namespace physx;
+
+// Keeps the costliest entries, sorted by decreasing time. Most entries are cheaper than the last one kept
+// and are rejected right away.
+template<class T>
+static void insertCostliest(Ps::Array<T>& entries, const T& entry, PxU32 maxEntries)
+{
+	PxU32 j;
+	if(entries.size() < maxEntries)
+	{
+		j = entries.size();
+		entries.pushBack(entry);
+	}
+	else
+	{
+		if(entry.time <= entries.back().time)
+			return;
+		j = entries.size() - 1;
+	}
+
+	while(j && entries[j-1].time < entry.time)
+	{
+		entries[j] = entries[j-1];
+		j--;
+	}
+	entries[j] = entry;
+}
+
+Sc::CostProfiler::CostProfiler(PxU32 maxEntries) :
+	mMaxEntries		(0),
+	mPairs			(PX_DEBUG_EXP("CostProfilerPairs")),
+	mActors			(PX_DEBUG_EXP("CostProfilerActors")),
+	mIslands		(PX_DEBUG_EXP("CostProfilerIslands")),
+	mAllActors		(PX_DEBUG_EXP("CostProfilerAllActors"))
+{
+	setMaxEntries(maxEntries);
+	clear();
+}
+
+void Sc::CostProfiler::setMaxEntries(PxU32 maxEntries)
+{
+	mMaxEntries = maxEntries;
+	mPairs.reserve(maxEntries);
+	mActors.reserve(maxEntries);
+	mIslands.reserve(maxEntries);
+	clear();
+}
+
+void Sc::CostProfiler::clear()
+{
+	mPairs.forceSize_Unsafe(0);
+	mActors.forceSize_Unsafe(0);
+	mIslands.forceSize_Unsafe(0);
+	mAllActors.forceSize_Unsafe(0);
+	mActorIndices.clear();
+
+	mNarrowPhaseTime = 0.0f;
+	mSolverTime = 0.0f;
+	PxMemZero(mGeometryPairTime, sizeof(mGeometryPairTime));
+	PxMemZero(mNbGeometryPairs, sizeof(mNbGeometryPairs));
+}
+
+void Sc::CostProfiler::addActorCost(PxActor* actor, PxReal time)
+{
+	const Ps::HashMap<PxActor*, PxU32>::Entry* entry = mActorIndices.find(actor);
+	if(entry)
+	{
+		PxActorCost& cost = mAllActors[entry->second];
+		cost.time += time;
+		cost.nbPairs++;
+		return;
+	}
+
+	mActorIndices.insert(actor, mAllActors.size());
+	PxActorCost cost;
+	cost.actor = actor;
+	cost.time = time;
+	cost.nbPairs = 1;
+	mAllActors.pushBack(cost);
+}
+
+void Sc::CostProfiler::collect(const PxvNphaseImplementationContext& npContext, const Dy::Context& dynamicsContext)
+{
+	clear();
+
+	// pairs, in tens of nanoseconds
+	PxsContactManager* const* managers;
+	const PxU32* costs;
+	const PxU32 nbManagers = npContext.getPairCosts(managers, costs);
+	for(PxU32 i=0; i<nbManagers; i++)
+	{
+		const PxsContactManager* cm = managers[i];
+		if(!cm)
+			continue;
+
+		const PxReal time = PxReal(costs[i] & PXS_PAIR_COST_MASK) * 0.01f;
+		mNarrowPhaseTime += time;
+
+		const PxcNpWorkUnit& unit = cm->getWorkUnit();
+		const PxU32 type0 = PxMin(unit.geomType0, unit.geomType1);
+		const PxU32 type1 = PxMax(unit.geomType0, unit.geomType1);
+		mGeometryPairTime[type0][type1] += time;
+		mNbGeometryPairs[type0][type1]++;
+
+		const ShapeInteraction* si = cm->getShapeInteraction();
+		if(!si)
+			continue;
+
+		PxPairCost pair;
+		pair.shape0 = si->getShape0().getPxShape();
+		pair.shape1 = si->getShape1().getPxShape();
+		pair.actor0 = si->getShape0().getRbSim().getPxActor();
+		pair.actor1 = si->getShape1().getRbSim().getPxActor();
+		pair.time = time;
+		insertCostliest(mPairs, pair, mMaxEntries);
+
+		addActorCost(pair.actor0, time);
+		addActorCost(pair.actor1, time);
+	}
+
+	for(PxU32 i=0; i<mAllActors.size(); i++)
+		insertCostliest(mActors, mAllActors[i], mMaxEntries);
+
+	// islands, in counter ticks
+	const Ps::Array<Dy::IslandCost>& islandCosts = dynamicsContext.getIslandCosts();
+	const Ps::CounterFrequencyToTensOfNanos& frequency = Ps::Time::getBootCounterFrequency();
+	for(PxU32 i=0; i<islandCosts.size(); i++)
+	{
+		const Dy::IslandCost& islandCost = islandCosts[i];
+
+		PxIslandCost island;
+		island.actor = NULL;
+		if(islandCost.body)
+		{
+			const BodySim* bodySim = reinterpret_cast<const BodySim*>(reinterpret_cast<const PxU8*>(islandCost.body) - BodySim::getRigidBodyOffset());
+			island.actor = bodySim->getPxActor();
+		}
+		island.nbIslands			= islandCost.nbIslands;
+		island.nbBodies				= islandCost.nbBodies;
+		island.nbArticulations		= islandCost.nbArticulations;
+		island.nbContactManagers	= islandCost.nbContactManagers;
+		island.nbConstraints		= islandCost.nbConstraints;
+		island.time					= PxReal(frequency.toTensOfNanos(islandCost.time)) * 0.01f;
+
+		mSolverTime += island.time;
+		insertCostliest(mIslands, island, mMaxEntries);
+	}
+}
+
+void Sc::CostProfiler::getProfile(PxCostProfile& profile) const
+{
+	profile.pairs			= mPairs.begin();
+	profile.nbPairs			= mPairs.size();
+	profile.actors			= mActors.begin();
+	profile.nbActors		= mActors.size();
+	profile.islands			= mIslands.begin();
+	profile.nbIslands		= mIslands.size();
+	profile.narrowPhaseTime	= mNarrowPhaseTime;
+	profile.solverTime		= mSolverTime;
+	PxMemCopy(profile.geometryPairTime, mGeometryPairTime, sizeof(mGeometryPairTime));
+	PxMemCopy(profile.nbGeometryPairs, mNbGeometryPairs, sizeof(mNbGeometryPairs));
+}
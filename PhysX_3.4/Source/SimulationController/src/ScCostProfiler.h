@@ -0,0 +1,95 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_SCP_COST_PROFILER
+#define PX_PHYSICS_SCP_COST_PROFILER
+
+#include "PsUserAllocated.h"
+#include "PsArray.h"
+#include "PsHashMap.h"
+#include "CmPhysXCommon.h"
+#include "PxCostProfile.h"
+
+namespace physx
+{
+
+class PxvNphaseImplementationContext;
+
+namespace Dy
+{
+	class Context;
+}
+
+namespace Sc
+{
+
+	/*
+	Description: gathers the costliest pairs, actors and islands of a step, see PxScene::setCostProfiling.
+	The pairs are timed by the narrow phase tasks and the islands by the solver task chains, this only sorts them out.
+	*/
+	class CostProfiler : public Ps::UserAllocated
+	{
+	public:
+		CostProfiler(PxU32 maxEntries);
+
+		PX_FORCE_INLINE	PxU32	getMaxEntries()						const	{ return mMaxEntries;	}
+						void	setMaxEntries(PxU32 maxEntries);
+
+		// Reads the costs of the step that just ended. Called at the end of the step, before the pairs
+		// and the bodies can be released.
+						void	collect(const PxvNphaseImplementationContext& npContext, const Dy::Context& dynamicsContext);
+
+						void	getProfile(PxCostProfile& profile)	const;
+
+	private:
+						void	clear();
+						void	addActorCost(PxActor* actor, PxReal time);
+
+		PxU32							mMaxEntries;
+
+		Ps::Array<PxPairCost>			mPairs;
+		Ps::Array<PxActorCost>			mActors;
+		Ps::Array<PxIslandCost>			mIslands;
+
+		// every actor touched by a pair, before keeping the costliest ones
+		Ps::Array<PxActorCost>			mAllActors;
+		Ps::HashMap<PxActor*, PxU32>	mActorIndices;
+
+		PxReal							mNarrowPhaseTime;
+		PxReal							mSolverTime;
+		PxReal							mGeometryPairTime[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+		PxU32							mNbGeometryPairs[PxGeometryType::eGEOMETRY_COUNT][PxGeometryType::eGEOMETRY_COUNT];
+	};
+
+} // namespace Sc
+
+}
+
+#endif
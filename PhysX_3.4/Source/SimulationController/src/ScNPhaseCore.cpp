@@ -138,13 +138,13 @@ Sc::NPhaseCore::NPhaseCore(Scene& scene, const PxSceneDesc& sceneDesc) :
 	mNextFramePersistentContactEventPairIndex(0),
 	mForceThresholdContactEventPairList	(PX_DEBUG_EXP("forceThresholdContactEventPairs")),
 	mContactReportBuffer			(sceneDesc.contactReportStreamBufferSize, (sceneDesc.flags & PxSceneFlag::eDISABLE_CONTACT_REPORT_BUFFER_RESIZE)),
-	mActorPairPool					(PX_DEBUG_EXP("actorPairPool")),
+	mActorPairPool					(Ps::AllocatorTraits<ActorPair>::Type(PX_DEBUG_EXP("actorPairPool")), 256),
 	mActorPairReportPool			(PX_DEBUG_EXP("actorPairReportPool")),
 	mActorElementPairPool			(PX_DEBUG_EXP("actorElementPool")),
 	mShapeInteractionPool			(Ps::AllocatorTraits<ShapeInteraction>::Type(PX_DEBUG_EXP("shapeInteractionPool")), 256),
 	mTriggerInteractionPool			(PX_DEBUG_EXP("triggerInteractionPool")),
 	mActorPairContactReportDataPool	(PX_DEBUG_EXP("actorPairContactReportPool")),
-	mInteractionMarkerPool			(PX_DEBUG_EXP("interactionMarkerPool"))
+	mInteractionMarkerPool			(Ps::AllocatorTraits<ElementInteractionMarker>::Type(PX_DEBUG_EXP("interactionMarkerPool")), 256)
 #if PX_USE_PARTICLE_SYSTEM_API
 	,mParticleBodyPool				(PX_DEBUG_EXP("particleBodyPool"))
 #endif
@@ -176,6 +176,19 @@ Sc::ElementSimInteraction* Sc::NPhaseCore::findInteraction(ElementSim* _element0
 	return pair ? pair->second : NULL;
 }
 
+void Sc::NPhaseCore::compactPools()
+{
+	PX_PROFILE_ZONE("Sim.compactInteractionPools", mOwnerScene.getContextId());
+
+	// Pairs are created in broadphase order, filling the pools from the lowest address keeps them packed in that order
+	mShapeInteractionPool.sortFreeList();
+	mInteractionMarkerPool.sortFreeList();
+	mTriggerInteractionPool.sortFreeList();
+	mActorPairPool.sortFreeList();
+	mActorPairReportPool.sortFreeList();
+	mActorElementPairPool.sortFreeList();
+}
+
 PxFilterInfo Sc::NPhaseCore::onOverlapFilter(ElementSim* volume0, ElementSim* volume1)
 {
 	PX_ASSERT(!findInteraction(volume0, volume1));
@@ -1273,11 +1286,8 @@ PxFilterInfo Sc::NPhaseCore::filterRbCollisionPairSecondStage(const ShapeSim& s0
 	return filterInfo;
 }
 
-PxFilterInfo Sc::NPhaseCore::filterRbCollisionPair(const ShapeSim& s0, const ShapeSim& s1, PxU32 filterPairIndex, PxU32& isTriggerPair, bool runCallbacks)
+bool Sc::NPhaseCore::filterRbCollisionPairFirstStage(const ShapeSim& s0, const ShapeSim& s1, const Sc::BodySim* b0, const Sc::BodySim* b1, PxU32 filterPairIndex, PxU32& isTriggerPair, PxFilterInfo& filterInfo)
 {
-	const Sc::BodySim* b0 = s0.getBodySim();
-	const Sc::BodySim* b1 = s1.getBodySim();
-
 	//  if not triggers...
 	PX_COMPILE_TIME_ASSERT(PxU32(PxShapeFlag::eTRIGGER_SHAPE) < (1 << ((sizeof(PxShapeFlags::InternalType) * 8) - 1)));
 	const PxU32 triggerMask = PxShapeFlag::eTRIGGER_SHAPE | (PxShapeFlag::eTRIGGER_SHAPE << 1);
@@ -1309,14 +1319,20 @@ PxFilterInfo Sc::NPhaseCore::filterRbCollisionPair(const ShapeSim& s0, const Sha
 			if(!(sceneFlags & PxSceneFlag::eENABLE_KINEMATIC_STATIC_PAIRS))
 			{
 				if(!b0 || !b1)
-					return filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eSUPPRESS);
+				{
+					filterInfo = filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eSUPPRESS);
+					return false;
+				}
 			}
 
 			// ...and ignore kinematic vs. kinematic pairs
 			if(!(sceneFlags & PxSceneFlag::eENABLE_KINEMATIC_PAIRS))
 			{
 				if(isS0Kinematic && isS1Kinematic)
-					return filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eSUPPRESS);
+				{
+					filterInfo = filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eSUPPRESS);
+					return false;
+				}
 			}
 		}
 	}
@@ -1327,17 +1343,18 @@ PxFilterInfo Sc::NPhaseCore::filterRbCollisionPair(const ShapeSim& s0, const Sha
 		{
 			if ((triggerPair & triggerMask) != triggerMask)  // only one shape is a trigger
 			{
-				return filterRbCollisionPairSecondStage(s0, s1, b0, b1, filterPairIndex, runCallbacks);
+				return true;
 			}
 			else
 			{
 				// trigger-trigger pairs are not supported
-				return filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eKILL);
+				filterInfo = filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eKILL);
+				return false;
 			}
 		}
 		else
 		{
-			return filterRbCollisionPairSecondStage(s0, s1, b0, b1, filterPairIndex, runCallbacks);
+			return true;
 		}
 	}
 
@@ -1359,7 +1376,7 @@ PxFilterInfo Sc::NPhaseCore::filterRbCollisionPair(const ShapeSim& s0, const Sha
 	{
 		if ((rbActor0.getActorType() != PxActorType::eARTICULATION_LINK) || (rbActor1.getActorType() != PxActorType::eARTICULATION_LINK))
 		{
-			return filterRbCollisionPairSecondStage(s0, s1, b0, b1, filterPairIndex, runCallbacks);
+			return true;
 		}
 		else
 		{
@@ -1373,17 +1390,134 @@ PxFilterInfo Sc::NPhaseCore::filterRbCollisionPair(const ShapeSim& s0, const Sha
 				if(interaction->getType() == InteractionType::eARTICULATION)
 				{
 					if((&interaction->getActor0() == &rbActor1) || (&interaction->getActor1() == &rbActor1))
-						return filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eKILL);
+					{
+						filterInfo = filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eKILL);
+						return false;
+					}
 				}
 			}
 		}
 
-		return filterRbCollisionPairSecondStage(s0, s1, b0, b1, filterPairIndex, runCallbacks);
+		return true;
 	}
 	else
 	{
-		return filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eSUPPRESS);
+		filterInfo = filterOutRbCollisionPair(filterPairIndex, PxFilterFlag::eSUPPRESS);
+		return false;
+	}
+}
+
+PxFilterInfo Sc::NPhaseCore::filterRbCollisionPair(const ShapeSim& s0, const ShapeSim& s1, PxU32 filterPairIndex, PxU32& isTriggerPair, bool runCallbacks)
+{
+	const Sc::BodySim* b0 = s0.getBodySim();
+	const Sc::BodySim* b1 = s1.getBodySim();
+
+	PxFilterInfo filterInfo;
+	if(!filterRbCollisionPairFirstStage(s0, s1, b0, b1, filterPairIndex, isTriggerPair, filterInfo))
+		return filterInfo;
+
+	return filterRbCollisionPairSecondStage(s0, s1, b0, b1, filterPairIndex, runCallbacks);
+}
+
+namespace
+{
+	// Pairs which passed the hardwired filter criteria, waiting for the batched filter shader
+	struct FilterShaderBatch
+	{
+		static const PxU32 MaxPairs = 64;
+
+		PxU32						pairIndices[MaxPairs];
+		const ShapeSim*				shapes0[MaxPairs];
+		const ShapeSim*				shapes1[MaxPairs];
+		PxFilterObjectAttributes	attributes0[MaxPairs];
+		PxFilterObjectAttributes	attributes1[MaxPairs];
+		PxFilterData				filterData0[MaxPairs];
+		PxFilterData				filterData1[MaxPairs];
+		PxPairFlags					pairFlags[MaxPairs];
+		PxFilterFlags				filterFlags[MaxPairs];
+		PxU32						size;
+	};
+}
+
+// Same as filterRbCollisionPairSecondStage() without callbacks, for a batch of pairs
+static void runFilterShaderBatch(const Sc::Scene& scene, PxSimulationFilterBatchShader shader, FilterShaderBatch& batch, PxFilterInfo* PX_RESTRICT filterInfo)
+{
+	for(PxU32 i = 0; i < batch.size; i++)
+		batch.pairFlags[i] = PxPairFlags();
+
+	shader(batch.size, batch.attributes0, batch.filterData0, batch.attributes1, batch.filterData1, batch.pairFlags, batch.filterFlags,
+		scene.getFilterShaderDataFast(), scene.getFilterShaderDataSizeFast());
+
+	for(PxU32 i = 0; i < batch.size; i++)
+	{
+		PxFilterInfo& finfo = filterInfo[batch.pairIndices[i]];
+		finfo.filterFlags = batch.filterFlags[i];
+		finfo.pairFlags = batch.pairFlags[i];
+
+		if(finfo.filterFlags & PxFilterFlag::eCALLBACK)
+		{
+			// The callback runs later, when the interaction gets created
+			if(scene.getFilterCallbackFast())
+				continue;
+
+			finfo.filterFlags.clear(PxFilterFlag::eNOTIFY);
+			Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "Filtering: eCALLBACK set but no filter callback defined.");
+		}
+
+		finfo.filterFlags = checkFilterFlags(finfo.filterFlags);
+
+		const ShapeSim& s0 = *batch.shapes0[i];
+		const ShapeSim& s1 = *batch.shapes1[i];
+		finfo.pairFlags = checkRbPairFlags(s0, s1, s0.getBodySim(), s1.getBodySim(), finfo.pairFlags, finfo.filterFlags);
 	}
+
+	batch.size = 0;
+}
+
+void Sc::NPhaseCore::onOverlapFilter(const Bp::AABBOverlap* PX_RESTRICT pairs, PxU32 pairCount, PxFilterInfo* PX_RESTRICT filterInfo)
+{
+	const PxSimulationFilterBatchShader batchShader = mOwnerScene.getFilterBatchShaderFast();
+	if(!batchShader)
+	{
+		for(PxU32 i = 0; i < pairCount; i++)
+			filterInfo[i] = onOverlapFilter(reinterpret_cast<ElementSim*>(pairs[i].mUserData0), reinterpret_cast<ElementSim*>(pairs[i].mUserData1));
+		return;
+	}
+
+	FilterShaderBatch batch;
+	batch.size = 0;
+
+	for(PxU32 i = 0; i < pairCount; i++)
+	{
+		ElementSim* volume0 = reinterpret_cast<ElementSim*>(pairs[i].mUserData0);
+		ElementSim* volume1 = reinterpret_cast<ElementSim*>(pairs[i].mUserData1);
+		PX_ASSERT(!findInteraction(volume0, volume1));
+		PX_ASSERT(PxMax(volume0->getElementType(), volume1->getElementType()) == ElementType::eSHAPE);
+
+		// Same order as onOverlapFilter(volume0, volume1)
+		const ShapeSim* s0 = static_cast<ShapeSim*>(volume1);
+		const ShapeSim* s1 = static_cast<ShapeSim*>(volume0);
+		PX_ASSERT(&s0->getActor() != &s1->getActor());
+
+		filterInfo[i] = PxFilterInfo();
+
+		PxU32 isTriggerPair = 0;
+		if(!filterRbCollisionPairFirstStage(*s0, *s1, s0->getBodySim(), s1->getBodySim(), INVALID_FILTER_PAIR_INDEX, isTriggerPair, filterInfo[i]))
+			continue;
+
+		const PxU32 index = batch.size++;
+		batch.pairIndices[index] = i;
+		batch.shapes0[index] = s0;
+		batch.shapes1[index] = s1;
+		s0->getFilterInfo(batch.attributes0[index], batch.filterData0[index]);
+		s1->getFilterInfo(batch.attributes1[index], batch.filterData1[index]);
+
+		if(batch.size == FilterShaderBatch::MaxPairs)
+			runFilterShaderBatch(mOwnerScene, batchShader, batch, filterInfo);
+	}
+
+	if(batch.size)
+		runFilterShaderBatch(mOwnerScene, batchShader, batch, filterInfo);
 }
 
 Sc::ActorPair* Sc::NPhaseCore::findActorPair(ShapeSim* s0, ShapeSim* s1, Ps::IntBool isReportPair)
@@ -1574,23 +1708,30 @@ static bool findTriggerContacts(TriggerInteraction* tri, bool toBeDeleted, bool
 		PX_ASSERT(primitive0->getFlags() & PxShapeFlag::eTRIGGER_SHAPE
 			   || primitive1->getFlags() & PxShapeFlag::eTRIGGER_SHAPE);
 
-		// Reorder them if needed
-		if(primitive0->getGeometryType() > primitive1->getGeometryType())
-			Ps::swap(primitive0, primitive1);
+		// The interaction only exists while the broadphase bounds overlap
+		if (!tri->needsOverlapTest())
+			overlap = true;
+		else
+		{
 
-		const Gu::GeomOverlapFunc overlapFunc =
-			Gu::getOverlapFuncTable()[primitive0->getGeometryType()][primitive1->getGeometryType()];
+			// Reorder them if needed
+			if(primitive0->getGeometryType() > primitive1->getGeometryType())
+				Ps::swap(primitive0, primitive1);
 
-		PX_ALIGN(16, PxTransform globalPose0);
-		primitive0->getAbsPoseAligned(&globalPose0);
+			const Gu::GeomOverlapFunc overlapFunc =
+				Gu::getOverlapFuncTable()[primitive0->getGeometryType()][primitive1->getGeometryType()];
 
-		PX_ALIGN(16, PxTransform globalPose1);
-		primitive1->getAbsPoseAligned(&globalPose1);
+			PX_ALIGN(16, PxTransform globalPose0);
+			primitive0->getAbsPoseAligned(&globalPose0);
 
-		PX_ASSERT(overlapFunc);
-		overlap = overlapFunc(	primitive0->getCore().getGeometry(), globalPose0,
-								primitive1->getCore().getGeometry(), globalPose1,
-								&tri->getTriggerCache());
+			PX_ALIGN(16, PxTransform globalPose1);
+			primitive1->getAbsPoseAligned(&globalPose1);
+
+			PX_ASSERT(overlapFunc);
+			overlap = overlapFunc(	primitive0->getCore().getGeometry(), globalPose0,
+									primitive1->getCore().getGeometry(), globalPose1,
+									&tri->getTriggerCache());
+		}
 	}
 
 	const bool hadOverlap = tri->lastFrameHadContacts();
@@ -1671,7 +1812,7 @@ public:
 			if (findTriggerContacts(tri, false, false, triggerPair[triggerReportItemCount], triggerPairExtra[triggerReportItemCount], triggerPairStats))
 				triggerReportItemCount++;
 
-			if (!(tri->readFlag(TriggerInteraction::PROCESS_THIS_FRAME)))
+			if (!(tri->readFlag(TriggerInteraction::PROCESS_THIS_FRAME)) && tri->needsOverlapTest())
 			{
 				// active trigger pairs for which overlap tests were not forced should remain in the active list
 				// to catch transitions between overlap and no overlap
@@ -1773,7 +1914,9 @@ void Sc::NPhaseCore::processTriggerInteractions(PxBaseTask* continuation)
 		{
 			const bool hasMultipleThreads = scene.getTaskManager().getCpuDispatcher()->getWorkerCount() > 1;
 			const bool moreThanOneBatch = pairCount > TriggerContactTask::sTriggerPairsPerTask;
-			const bool scheduleTasks = hasMultipleThreads && moreThanOneBatch;
+			// the tasks append their trigger reports and deactivated pairs in completion order, so they run in sequence with enhanced determinism
+			const bool deterministic = scene.getPublicFlags() & PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+			const bool scheduleTasks = hasMultipleThreads && moreThanOneBatch && !deterministic;
 			// when running on a single thread, the task system seems to cause the main overhead (locking and atomic operations
 			// seemed less of an issue). Hence, the tasks get run directly in that case. Same if there is only one batch.
 
@@ -171,6 +171,7 @@ namespace Sc
 		void onOverlapCreated(const Bp::AABBOverlap* PX_RESTRICT pairs, PxU32 pairCount, const PxU32 ccdPass);
 		Sc::Interaction* onOverlapCreated(ElementSim* volume0, ElementSim* volume1, const PxU32 ccdPass);
 		PxFilterInfo onOverlapFilter(ElementSim* volume0, ElementSim* volume1);
+		void onOverlapFilter(const Bp::AABBOverlap* PX_RESTRICT pairs, PxU32 pairCount, PxFilterInfo* PX_RESTRICT filterInfo);
 
 
 		ElementSimInteraction* onOverlapRemovedStage1(ElementSim* volume0, ElementSim* volume1);
@@ -253,6 +254,9 @@ namespace Sc
 		ElementSimInteraction* createRbElementInteraction(const PxFilterInfo& fInfo, ShapeSim& s0, ShapeSim& s1, PxsContactManager* contactManager, Sc::ShapeInteraction* shapeInteraction, 
 			Sc::ElementInteractionMarker* interactionMarker, PxU32 isTriggerPair);
 
+		// Orders the free lists of the interaction pools so that new pairs fill the holes left by the lost ones first
+		void compactPools();
+
 	private:
 		ElementSimInteraction* createRbElementInteraction(ShapeSim& s0, ShapeSim& s1, PxsContactManager* contactManager, Sc::ShapeInteraction* shapeInteraction, 
 			Sc::ElementInteractionMarker* interactionMarker);
@@ -286,6 +290,9 @@ namespace Sc
 		// helper method to run the filter logic after some hardwired filter criteria have been passed successfully
 		PxFilterInfo filterRbCollisionPairSecondStage(const ShapeSim& s0, const ShapeSim& s1, const Sc::BodySim* b0, const Sc::BodySim* b1, PxU32 filterPairIndex, bool runCallbacks);
 
+		// hardwired filter criteria, returns false if they already decided the fate of the pair (written to filterInfo)
+		bool filterRbCollisionPairFirstStage(const ShapeSim& s0, const ShapeSim& s1, const Sc::BodySim* b0, const Sc::BodySim* b1, PxU32 filterPairIndex, PxU32& isTriggerPair, PxFilterInfo& filterInfo);
+
 		PxFilterInfo filterRbCollisionPair(const ShapeSim& s0, const ShapeSim& s1, PxU32 filterPairIndex, PxU32& isTriggerPair, bool runCallbacks);
 		//-------------------------------------
 
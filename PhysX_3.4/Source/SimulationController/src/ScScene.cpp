@@ -47,6 +47,7 @@
 #include "PsTime.h"
 #include "ScConstraintInteraction.h"
 #include "ScSimStats.h"
+#include "ScCostProfiler.h"
 #include "ScTriggerPairs.h"
 #include "ScObjectIDTracker.h"
 #include "DyArticulation.h"
@@ -59,6 +60,7 @@
 #include "PxsContext.h"
 #include "ScSqBoundsManager.h"
 #include "ScElementSim.h"
+#include "CmParallelFor.h"
 
 #if defined(__APPLE__) && defined(__POWERPC__)
 #include <ppc_intrinsics.h>
@@ -129,6 +131,7 @@ public:
 };
 
 static const char* sFilterShaderDataMemAllocId = "SceneDesc filterShaderData";
+static const PxU32 sInteractionPoolCompactionInterval = 64;	// in simulation steps, power of two
 
 }}
 
@@ -178,6 +181,8 @@ public:
 		PxU32 nbFrozen = 0, nbUnfrozen = 0;
 		PxU32 nbActivated = 0, nbDeactivated = 0;
 
+		Gu::BoundsBatch boundsBatch;
+
 		for(PxU32 i = 0; i < mNumBodies; i++)
 		{
 			PxsRigidBody* rigid = islandSim.getRigidBody(mIndices[i]);
@@ -199,7 +204,7 @@ public:
 
 				// PT: TODO: remove duplicate "isFrozen" test inside updateCached
 //				bodySim->updateCached(NULL);
-				bodySim->updateCached(mCache, boundsArray);
+				bodySim->updateCached(mCache, boundsArray, boundsBatch);
 			}
 
 			if(llBody.isFreezeThisFrame() && isFrozen)
@@ -225,6 +230,8 @@ public:
 			}
 			llBody.clearAllFrameFlags();
 		}
+		boundsBatch.flush();
+
 		if(nbBpUpdates)
 		{
 			mCache.setChangedState();
@@ -578,6 +585,8 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 #endif
 	mBrokenConstraints				(PX_DEBUG_EXP("sceneBrokenConstraints")),
 	mActiveBreakableConstraints		(PX_DEBUG_EXP("sceneActiveBreakableConstraints")),
+	mBrokenConstraintCandidates		(PX_DEBUG_EXP("sceneBrokenConstraintCandidates")),
+	mConstraintBreakageTested		(false),
 	mMemBlock128Pool				(PX_DEBUG_EXP("PxsContext ConstraintBlock128Pool")),
 	mMemBlock256Pool				(PX_DEBUG_EXP("PxsContext ConstraintBlock256Pool")),
 	mMemBlock384Pool				(PX_DEBUG_EXP("PxsContext ConstraintBlock384Pool")),
@@ -658,7 +667,8 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 	PxMemZero(mClothFactories, sizeof(mClothFactories));
 #endif
 
-	mStats						= PX_NEW(SimStats);
+	mStats						= PX_NEW(SimStats)(contextID);
+	mCostProfiler				= NULL;
 	mConstraintIDTracker = PX_NEW(ObjectIDTracker);
 	mShapeIDTracker				= PX_NEW(ObjectIDTracker);
 	mRigidIDTracker				= PX_NEW(ObjectIDTracker);
@@ -672,7 +682,9 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 	mShapeSimPool				= PX_NEW(PreallocatingPool<ShapeSim>)(64, "ShapeSim");
 	mConstraintSimPool			= PX_NEW(Ps::Pool<ConstraintSim>)(PX_DEBUG_EXP("ScScene::ConstraintSim"));
 	mConstraintInteractionPool	= PX_NEW(Ps::Pool<ConstraintInteraction>)(PX_DEBUG_EXP("ScScene::ConstraintInteraction"));
-	mLLArticulationPool			= PX_NEW(LLArticulationPool);
+	mLLArticulationPool			= NULL;	// created by the first articulation, scenes without any never touch the pool
+	mArticulationSimPool		= NULL;
+	mArticulationJointSimPool	= NULL;
 
 	mSimStateDataPool			= PX_NEW(Ps::Pool<SimStateData>)(PX_DEBUG_EXP("ScScene::SimStateData"));
 
@@ -763,6 +775,7 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 			desc.limits.maxNbBroadPhaseOverlaps, 
 			desc.limits.maxNbStaticShapes, 
 			desc.limits.maxNbDynamicShapes,
+			desc.flags & PxSceneFlag::eENABLE_STATIC_BROADPHASE_TREE,
 			contextID);
 	}
 	else
@@ -852,6 +865,9 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 #endif
 	}
 
+	// The interactions, and with them the island edges and solver constraints, are created and destroyed in the order of the overlaps
+	mAABBManager->setSortedOverlaps(useEnhancedDeterminism);
+
 	//Construct the bitmap of updated actors required as input to the broadphase update
 	if(desc.limits.maxNbBodies)
 	{
@@ -870,6 +886,7 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 	mDynamicsContext->setFrictionOffsetThreshold(desc.frictionOffsetThreshold);
 	mDynamicsContext->setCCDSeparationThreshold(desc.ccdMaxSeparation);
 	mDynamicsContext->setSolverOffsetSlop(desc.solverOffsetSlop);
+	mDynamicsContext->setSolverConvergenceThreshold(desc.solverConvergenceThreshold);
 
 	const PxTolerancesScale& scale = Physics::getInstance().getTolerancesScale();
 	mDynamicsContext->setCorrelationDistance(0.025f * scale.length);
@@ -883,6 +900,7 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 	// hence we negate here.
 
 	mDynamicsContext->setBounceThreshold(-desc.bounceThresholdVelocity);
+	mDynamicsContext->setBalancedPartitions(desc.flags & PxSceneFlag::eENABLE_BALANCED_PARTITIONS);
 
 	StaticCore* anchorCore = PX_NEW(StaticCore)(PxTransform(PxIdentity));
 
@@ -932,17 +950,14 @@ Sc::Scene::Scene(const PxSceneDesc& desc, PxU64 contextID) :
 		mFilterShaderDataCapacity = 0;
 	}
 	mFilterShader = desc.filterShader;
+	mFilterBatchShader = desc.filterBatchShader;
 	mFilterCallback = desc.filterCallback;
 
 #if PX_USE_CLOTH_API
 	createClothSolver();
 #endif  // PX_USE_CLOTH_API
 
-#if PX_USE_PARTICLE_SYSTEM_API
-	mParticleContext = Pt::createParticleContext(mTaskManager
-		, mLLContext->getTaskPool()
-	);
-#endif // PX_USE_PARTICLE_SYSTEM_API
+	// the particle context is created by the first particle system, see addParticleSystem()
 }
 
 void Sc::Scene::release()
@@ -1017,6 +1032,8 @@ void Sc::Scene::release()
 	PX_DELETE(mShapeSimPool);
 	PX_DELETE(mBodySimPool);
 	PX_DELETE(mLLArticulationPool);
+	PX_DELETE(mArticulationSimPool);
+	PX_DELETE(mArticulationJointSimPool);
 
 #if PX_USE_CLOTH_API
 	for(PxU32 i=0; i<mNumClothSolvers; ++i)
@@ -1037,6 +1054,7 @@ void Sc::Scene::release()
 	PX_DELETE(mShapeIDTracker);
 	PX_DELETE(mConstraintIDTracker);
 	PX_DELETE(mStats);
+	PX_DELETE(mCostProfiler);
 
 	mAABBManager->destroy();
 
@@ -1361,6 +1379,39 @@ bool Sc::Scene::removeBroadPhaseRegion(PxU32 handle)
 	return bp->removeRegion(handle);
 }
 
+bool Sc::Scene::setBroadPhaseAdaptiveRegions(const PxBroadPhaseAdaptiveRegionsDesc* desc)
+{
+	Bp::BroadPhase* bp = mAABBManager->getBroadPhase();
+	return bp->setAdaptiveRegions(desc);
+}
+
+static PX_FORCE_INLINE PxShape* getBroadPhasePairShape(void* userData)
+{
+	const Sc::ElementSim* element = reinterpret_cast<const Sc::ElementSim*>(userData);
+	if(element->getElementType()!=Sc::ElementType::eSHAPE)
+		return NULL;
+	return static_cast<const Sc::ShapeSim*>(element)->getPxShape();
+}
+
+static bool decodeBroadPhasePair(const void* pairs, PxU32 index, PxShape*& shape0, PxShape*& shape1)
+{
+	const Bp::AABBOverlap& pair = reinterpret_cast<const Bp::AABBOverlap*>(pairs)[index];
+	shape0 = getBroadPhasePairShape(pair.mUserData0);
+	shape1 = getBroadPhasePairShape(pair.mUserData1);
+	return shape0 && shape1;
+}
+
+// the overlap arrays are only reset at the start of the next post-broadphase, and their user data have been
+// replaced with the element pointers by then, so they can be exposed as they are. Overlaps go to the bucket of
+// the highest volume type of the pair, so trigger pairs are in the trigger element type bucket.
+void Sc::Scene::getBroadPhaseTriggerPairs(PxBroadPhasePairView& createdPairs, PxBroadPhasePairView& lostPairs) const
+{
+	createdPairs.mPairs = mAABBManager->getCreatedOverlaps(Sc::ElementType::eTRIGGER, createdPairs.mNbPairs);
+	createdPairs.mDecode = decodeBroadPhasePair;
+	lostPairs.mPairs = mAABBManager->getDestroyedOverlaps(Sc::ElementType::eTRIGGER, lostPairs.mNbPairs);
+	lostPairs.mDecode = decodeBroadPhasePair;
+}
+
 void** Sc::Scene::getOutOfBoundsAggregates()
 {
 	PxU32 dummy;
@@ -1477,11 +1528,12 @@ void Sc::Scene::simulate(PxReal timeStep, PxBaseTask* continuation)
 		mOneOverDt = 0.0f < mDt ? 1.0f/mDt : 0.0f;
 
 		prepareCollide();
-		stepSetupCollide(); 
 
 		mAdvanceStep.setContinuation(continuation);
 		mCollideStep.setContinuation(&mAdvanceStep);
 
+		stepSetupCollide(&mCollideStep); 
+
 		mAdvanceStep.removeReference();
 		mCollideStep.removeReference();
 	}
@@ -1516,11 +1568,13 @@ void Sc::Scene::collide(PxReal timeStep, PxBaseTask* continuation)
 	mDt = timeStep;
 
 	prepareCollide();
-	stepSetupCollide();
+
+	mCollideStep.setContinuation(continuation);
+
+	stepSetupCollide(&mCollideStep);
 
 	mLLContext->beginUpdate();
 
-	mCollideStep.setContinuation(continuation);
 	mCollideStep.removeReference();
 }
 
@@ -1558,6 +1612,10 @@ void Sc::Scene::endSimulation()
 
 	endStep();	// - Update time stamps
 
+	// Lost pairs leave holes all over the interaction pools, reorder the free lists from time to time
+	if(!(mTimeStamp & (sInteractionPoolCompactionInterval - 1)))
+		mNPhaseCore->compactPools();
+
 	PxcDisplayContactCacheStats();
 }
 
@@ -1732,11 +1790,14 @@ void Sc::Scene::removeConstraint(ConstraintCore& constraint)
 
 void Sc::Scene::addArticulation(ArticulationCore& articulation, BodyCore& root)
 {
-	ArticulationSim* sim = PX_NEW(ArticulationSim)(articulation, *this, root);
+	if(!mArticulationSimPool)
+		mArticulationSimPool = PX_NEW(Ps::Pool<ArticulationSim>)(PX_DEBUG_EXP("ScScene::ArticulationSim"));
+
+	ArticulationSim* sim = mArticulationSimPool->construct(articulation, *this, root);
 
 	if (sim && (sim->getLowLevelArticulation() == NULL))
 	{
-		PX_DELETE(sim);
+		mArticulationSimPool->destroy(sim);
 		return;
 	}
 	mArticulations.insert(&articulation);
@@ -1746,20 +1807,23 @@ void Sc::Scene::removeArticulation(ArticulationCore& articulation)
 {
 	ArticulationSim* a = articulation.getSim();
 	if (a)
-		PX_DELETE(a);
+		mArticulationSimPool->destroy(a);
 	mArticulations.erase(&articulation);
 }
 
 void Sc::Scene::addArticulationJoint(ArticulationJointCore& joint, BodyCore& parent, BodyCore& child)
 {
-	ArticulationJointSim* sim = PX_NEW(ArticulationJointSim)(joint, *parent.getSim(), *child.getSim());
+	if(!mArticulationJointSimPool)
+		mArticulationJointSimPool = PX_NEW(Ps::Pool<ArticulationJointSim>)(PX_DEBUG_EXP("ScScene::ArticulationJointSim"));
+
+	ArticulationJointSim* sim = mArticulationJointSimPool->construct(joint, *parent.getSim(), *child.getSim());
 	PX_UNUSED(sim);
 }
 
 void Sc::Scene::removeArticulationJoint(ArticulationJointCore& joint)
 {
 	if (joint.getSim())
-		PX_DELETE(joint.getSim());
+		mArticulationJointSimPool->destroy(joint.getSim());
 }
 
 void Sc::Scene::addBrokenConstraint(Sc::ConstraintCore* c)
@@ -2122,6 +2186,7 @@ void Sc::Scene::clothPreprocessing(PxBaseTask* /*continuation*/)
 void Sc::Scene::broadPhase(PxBaseTask* continuation)
 {
 	PX_PROFILE_START_CROSSTHREAD("Basic.broadPhase", getContextId());
+	mStats->beginStage(PxSimulationStatistics::eSTAGE_BROAD_PHASE);
 
 #if PX_USE_CLOTH_API
 		ClothCore* const* clothList = mCloths.getEntries();
@@ -2192,6 +2257,7 @@ void Sc::Scene::postBroadPhaseStage3(PxBaseTask* /*continuation*/)
 {
 	finishBroadPhaseStage2(0);
 
+	mStats->endStage(PxSimulationStatistics::eSTAGE_BROAD_PHASE);
 	PX_PROFILE_STOP_CROSSTHREAD("Basic.postBroadPhase", getContextId());
 	PX_PROFILE_STOP_CROSSTHREAD("Basic.broadPhase", getContextId());
 }
@@ -2216,10 +2282,12 @@ public:
 
 	virtual void runInternal() 
 	{
+		Gu::BoundsBatch boundsBatch;
 		for (PxU32 a = 0; a < mNbShapes; ++a)
 		{
-			mShapes[a]->updateCached(mCache, mBoundsArray);
+			mShapes[a]->updateCached(mCache, mBoundsArray, boundsBatch);
 		}
+		boundsBatch.flush();
 	}
 
 	virtual const char* getName() const { return "DirtyShapeUpdatesTask";  }
@@ -2406,6 +2474,7 @@ void Sc::Scene::preRigidBodyNarrowPhase(PxBaseTask* continuation)
 void Sc::Scene::rigidBodyNarrowPhase(PxBaseTask* continuation)
 {
 	PX_PROFILE_START_CROSSTHREAD("Basic.narrowPhase", getContextId());
+	mStats->beginStage(PxSimulationStatistics::eSTAGE_NARROW_PHASE);
 
 	mCCDPass = 0;
 
@@ -2476,6 +2545,7 @@ void Sc::Scene::postNarrowPhase(PxBaseTask* /*continuation*/)
 
 	releaseConstraints(false);
 
+	mStats->endStage(PxSimulationStatistics::eSTAGE_NARROW_PHASE);
 	PX_PROFILE_STOP_CROSSTHREAD("Basic.narrowPhase", getContextId());
 	PX_PROFILE_STOP_CROSSTHREAD("Basic.collision", getContextId());
 }
@@ -2712,6 +2782,7 @@ void Sc::Scene::processLostSolverPatches(PxBaseTask* /*continuation*/)
 void Sc::Scene::islandGen(PxBaseTask* continuation)
 {
 	PX_PROFILE_START_CROSSTHREAD("Basic.rigidBodySolver", getContextId());
+	mStats->beginStage(PxSimulationStatistics::eSTAGE_ISLAND_GEN);
 
 	//mLLContext->runModifiableContactManagers(); //KS - moved here so that we can get up-to-date touch found/lost events in IG
 
@@ -2858,6 +2929,8 @@ void Sc::Scene::solver(PxBaseTask* continuation)
 {
 	PX_PROFILE_STOP_CROSSTHREAD("Basic.narrowPhase", getContextId());
 	PX_PROFILE_START_CROSSTHREAD("Basic.rigidBodySolver", getContextId());
+	mStats->endStage(PxSimulationStatistics::eSTAGE_ISLAND_GEN);
+	mStats->beginStage(PxSimulationStatistics::eSTAGE_SOLVER);
 	//Update forces per body in parallel. This can overlap with the other work in this phase.
 	beforeSolver(continuation);
 
@@ -2887,6 +2960,47 @@ void Sc::Scene::postThirdPassIslandGen(PxBaseTask* /*continuation*/)
 	mNPhaseCore->processPersistentContactEvents(outputs);
 }
 
+static void findLostInteractions(Sc::NPhaseCore* nPhaseCore, Bp::AABBOverlap* PX_RESTRICT p, PxU32 nbPairs)
+{
+	while (nbPairs--)
+	{
+		Sc::ElementSim* volume0 = reinterpret_cast<Sc::ElementSim*>(p->mUserData0);
+		Sc::ElementSim* volume1 = reinterpret_cast<Sc::ElementSim*>(p->mUserData1);
+		Sc::ElementSimInteraction* interaction = nPhaseCore->onOverlapRemovedStage1(volume0, volume1);
+		p->mPairUserData = interaction;
+		p++;
+	}
+}
+
+// The lookups only read the element map of the narrowphase core, which doesn't change before processLostContacts2()
+class FindLostInteractionsTask : public Cm::Task
+{
+public:
+	static const PxU32 MaxPairs = 512;
+
+	Sc::NPhaseCore* mNPhaseCore;
+	Bp::AABBOverlap* PX_RESTRICT mPairs;
+	PxU32 mNbToProcess;
+
+	FindLostInteractionsTask(PxU64 contextID, Sc::NPhaseCore* nPhaseCore, Bp::AABBOverlap* PX_RESTRICT pairs, PxU32 nbToProcess) :
+		Cm::Task		(contextID),
+		mNPhaseCore		(nPhaseCore),
+		mPairs			(pairs),
+		mNbToProcess	(nbToProcess)
+	{
+	}
+
+	virtual void runInternal()
+	{
+		findLostInteractions(mNPhaseCore, mPairs, mNbToProcess);
+	}
+
+	virtual const char* getName() const { return "FindLostInteractionsTask"; }
+
+private:
+	PX_NOCOPY(FindLostInteractionsTask)
+};
+
 void Sc::Scene::processLostContacts(PxBaseTask* continuation)
 {
 	mProcessNarrowPhaseLostTouchTasks.setContinuation(continuation);
@@ -2902,14 +3016,21 @@ void Sc::Scene::processLostContacts(PxBaseTask* continuation)
 		Bp::SimpleAABBManager* aabbMgr = mAABBManager;
 		PxU32 destroyedOverlapCount;
 		Bp::AABBOverlap* PX_RESTRICT p = aabbMgr->getDestroyedOverlaps(Bp::VolumeBuckets::eSHAPE, destroyedOverlapCount);
-		while (destroyedOverlapCount--)
+
+		// Hand all but the last batch to other threads, the stages reading mPairUserData are continuations of this task
+		Cm::FlushPool& flushPool = mLLContext->getTaskPool();
+		const PxU32 nbPairsPerTask = FindLostInteractionsTask::MaxPairs;
+		while (destroyedOverlapCount > nbPairsPerTask)
 		{
-			ElementSim* volume0 = reinterpret_cast<ElementSim*>(p->mUserData0);
-			ElementSim* volume1 = reinterpret_cast<ElementSim*>(p->mUserData1);
-			Sc::ElementSimInteraction* interaction = mNPhaseCore->onOverlapRemovedStage1(volume0, volume1);
-			p->mPairUserData = interaction;
-			p++;
+			FindLostInteractionsTask* task = PX_PLACEMENT_NEW(flushPool.allocate(sizeof(FindLostInteractionsTask)), FindLostInteractionsTask)(getContextId(), mNPhaseCore, p, nbPairsPerTask);
+			task->setContinuation(continuation);
+			task->removeReference();
+
+			p += nbPairsPerTask;
+			destroyedOverlapCount -= nbPairsPerTask;
 		}
+
+		findLostInteractions(mNPhaseCore, p, destroyedOverlapCount);
 	}
 }
 
@@ -2974,7 +3095,7 @@ void Sc::Scene::destroyManagers(PxBaseTask*)
 
 		mPostThirdPassIslandGenTask.setContinuation(mProcessLostContactsTask3.getContinuation());
 
-		mSimpleIslandManager->thirdPassIslandGen(&mPostThirdPassIslandGenTask);
+		mSimpleIslandManager->thirdPassIslandGen(&mPostThirdPassIslandGenTask, mLLContext->getTaskPool());
 
 		Bp::SimpleAABBManager* aabbMgr = mAABBManager;
 		PxU32 destroyedOverlapCount;
@@ -3127,6 +3248,9 @@ void Sc::Scene::updateDynamics(PxBaseTask* continuation)
 
 void Sc::Scene::updateCCDMultiPass(PxBaseTask* parentContinuation)
 {
+	mStats->endStage(PxSimulationStatistics::eSTAGE_INTEGRATION);
+	mStats->beginStage(PxSimulationStatistics::eSTAGE_CCD);
+
 	getCcdBodies().forceSize_Unsafe(mSimulationControllerCallback->getNbCcdBodies());
 	
 	// second run of the broadphase for making sure objects we have integrated did not tunnel.
@@ -3390,10 +3514,12 @@ public:
 
 	virtual void runInternal()
 	{
+		Gu::BoundsBatch boundsBatch;
 		for (PxU32 i = 0; i < mNbKinematics; ++i)
 		{
-			mKinematics[i]->getSim()->updateCached(mTransformCache, mBoundsArray);
+			mKinematics[i]->getSim()->updateCached(mTransformCache, mBoundsArray, boundsBatch);
 		}
+		boundsBatch.flush();
 	}
 
 	virtual const char* getName() const
@@ -3530,8 +3656,81 @@ private:
 	PxsContext* mLLContext;
 };
 
+static void testConstraintBreakage(Sc::ConstraintSim* const* constraints, PxU32 nbConstraints, const Dy::ConstraintWriteback* writebacks, Sc::ConstraintSim** brokenConstraints)
+{
+	for(PxU32 i=0; i < nbConstraints; i++)
+	{
+		Sc::ConstraintSim* c = constraints[i];
+		brokenConstraints[i] = writebacks[c->getLowLevelConstraint().index].broken ? c : NULL;
+	}
+}
+
+class ConstraintBreakageTask : public Cm::Task
+{
+public:
+	ConstraintBreakageTask(PxU64 contextID, Sc::ConstraintSim* const* constraints, PxU32 nbConstraints, const Dy::ConstraintWriteback* writebacks, Sc::ConstraintSim** brokenConstraints) :
+		Cm::Task			(contextID),
+		mConstraints		(constraints),
+		mNbConstraints		(nbConstraints),
+		mWritebacks			(writebacks),
+		mBrokenConstraints	(brokenConstraints)
+	{
+	}
+
+	virtual void runInternal()
+	{
+		testConstraintBreakage(mConstraints, mNbConstraints, mWritebacks, mBrokenConstraints);
+	}
+
+	virtual const char* getName() const
+	{
+		return "ScScene.constraintBreakageTests";
+	}
+
+public:
+	static const PxU32 sConstraintsPerTask = 1024;
+
+private:
+	PX_NOCOPY(ConstraintBreakageTask)
+
+	Sc::ConstraintSim* const* mConstraints;
+	const PxU32 mNbConstraints;
+	const Dy::ConstraintWriteback* mWritebacks;
+	Sc::ConstraintSim** mBrokenConstraints;
+};
+
+// the solver results are final once the projection runs, so the breakable constraints get tested in parallel with it. Each
+// constraint has its own slot in the candidate list, which keeps the breakage order of checkConstraintBreakage() deterministic.
+void Sc::Scene::scheduleConstraintBreakageTests(PxBaseTask* continuation)
+{
+	const PxU32 count = mActiveBreakableConstraints.size();
+	mBrokenConstraintCandidates.resizeUninitialized(count);
+	mConstraintBreakageTested = true;
+	if (!count)
+		return;
+
+	ConstraintSim* const* constraints = mActiveBreakableConstraints.getEntries();
+	const Dy::ConstraintWriteback* writebacks = mDynamicsContext->getConstraintWriteBackPool().begin();
+	ConstraintSim** candidates = mBrokenConstraintCandidates.begin();
+
+	// the first batch is done by this thread
+	Cm::FlushPool& flushPool = mLLContext->getTaskPool();
+	const PxU32 nbPerTask = ConstraintBreakageTask::sConstraintsPerTask;
+	for (PxU32 i = nbPerTask; i < count; i += nbPerTask)
+	{
+		ConstraintBreakageTask* task = PX_PLACEMENT_NEW(flushPool.allocate(sizeof(ConstraintBreakageTask)), 
+															ConstraintBreakageTask(getContextId(), constraints + i, PxMin(nbPerTask, count - i), writebacks, candidates + i));
+		task->setContinuation(continuation);
+		task->removeReference();
+	}
+
+	testConstraintBreakage(constraints, PxMin(nbPerTask, count), writebacks, candidates);
+}
+
 void Sc::Scene::constraintProjection(PxBaseTask* continuation)
 {
+	scheduleConstraintBreakageTests(continuation);
+
 	PxU32 constraintGroupRootCount = 0;
 	//BodyCore*const* activeBodies = getActiveBodiesArray();
 	//PxU32 activeBodyCount = getNumActiveBodies();
@@ -3608,6 +3807,9 @@ void Sc::Scene::constraintProjection(PxBaseTask* continuation)
 
 void Sc::Scene::postSolver(PxBaseTask* continuation)
 {
+	mStats->endStage(PxSimulationStatistics::eSTAGE_SOLVER);
+	mStats->beginStage(PxSimulationStatistics::eSTAGE_INTEGRATION);
+
 	PxcNpMemBlockPool& blockPool = mLLContext->getNpMemBlockPool();
 
 	//Merge...
@@ -3712,6 +3914,10 @@ void Sc::Scene::finalizationPhase(PxBaseTask* /*continuation*/)
 {
 	PX_PROFILE_ZONE("Sim.sceneFinalization", getContextId());
 
+	// Whichever ran last, the CCD passes are optional
+	mStats->endStage(PxSimulationStatistics::eSTAGE_INTEGRATION);
+	mStats->endStage(PxSimulationStatistics::eSTAGE_CCD);
+
 	if (mCCDContext)
 	{
 		//KS - force simulation controller to update any bodies updated by the CCD. When running GPU simulation, this would be required
@@ -3740,6 +3946,10 @@ void Sc::Scene::finalizationPhase(PxBaseTask* /*continuation*/)
 
 	checkConstraintBreakage(); // Performs breakage tests on breakable constraints
 
+	// The pairs and the bodies are still the ones that were timed, they can only be released once the step is fetched
+	if(mCostProfiler)
+		mCostProfiler->collect(*mLLContext->getNphaseImplementationContext(), *mDynamicsContext);
+
 	PX_PROFILE_STOP_CROSSTHREAD("Basic.rigidBodySolver", getContextId());
 
 	//KS - process deleted elementIDs now - before GPU particles releases elements, causing issues
@@ -3832,21 +4042,22 @@ void Sc::Scene::stepSetupSolve()
 	kinematicsSetup();
 }
 
-void Sc::Scene::stepSetupCollide()
+void Sc::Scene::stepSetupCollide(PxBaseTask* continuation)
 {
 	PX_PROFILE_ZONE("Sim.stepSetupCollide", getContextId());
 
-	//KS - todo - get this working!!!!!!!!!!!!!!!!!
-	{
-		PX_PROFILE_ZONE("Sim.projectionTreeUpdates", getContextId());
-		mProjectionManager->processPendingUpdates(mLLContext->getScratchAllocator());
-	}
-
 	kinematicsSetup();
 	PxsContactManagerOutputIterator outputs = mLLContext->getNphaseImplementationContext()->getContactManagerOutputs();
 	// Update all dirty interactions
 	mNPhaseCore->updateDirtyInteractions(outputs, mPublicFlags & PxSceneFlag::eADAPTIVE_FORCE);
 	mInternalFlags &= ~(SceneInternalFlag::eSCENE_SIP_STATES_DIRTY_DOMINANCE | SceneInternalFlag::eSCENE_SIP_STATES_DIRTY_VISUALIZATION);
+
+	// done last, the tree builds read the actor interactions and must not overlap with anything changing them. The
+	// continuation is the collide step which is where the interactions start to change again.
+	{
+		PX_PROFILE_ZONE("Sim.projectionTreeUpdates", getContextId());
+		mProjectionManager->processPendingUpdates(mLLContext->getScratchAllocator(), *getFlushPool(), continuation, getContextId());
+	}
 }
 
 void Sc::Scene::processLostTouchPairs()
@@ -4009,6 +4220,115 @@ void Sc::Scene::beforeSolver(PxBaseTask* continuation)
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// rolls back the bodies deactivated by the island gen this frame, see Sc::Scene::afterIntegration. The chunks are claimed from
+// a shared range so that a scene settling all at once doesn't do it serially. Poses, bounds and velocities of the bodies are written
+// in parallel, only the changed handles, the frozen bodies and the simulation controller are updated under the context lock.
+class ScDeactivateBodiesTask : public Cm::Task
+{
+public:
+	static const PxU32 MinBodiesPerTask = 128;
+	static const PxU32 MaxBodiesPerTask = 256;	// also the size of the local buffers
+
+	ScDeactivateBodiesTask(Sc::Scene& scene, const IG::NodeIndex* indices, Cm::ParallelForRange& range) :
+		Cm::Task	(scene.getContextId()),
+		mScene		(scene),
+		mIndices	(indices),
+		mRange		(range)
+	{
+	}
+
+	virtual void runInternal()
+	{
+		PxU32 start, nb;
+		while(mRange.claim(start, nb))
+			processBodies(mIndices + start, nb);
+	}
+
+	virtual const char* getName() const
+	{
+		return "ScScene.deactivateBodiesTask";
+	}
+
+private:
+	void processBodies(const IG::NodeIndex* indices, PxU32 nbBodies)
+	{
+		PX_ASSERT(nbBodies <= MaxBodiesPerTask);
+
+		const PxU32 rigidBodyOffset = Sc::BodySim::getRigidBodyOffset();
+		const IG::IslandSim& islandSim = mScene.getSimpleIslandManager()->getAccurateIslandSim();
+		PxsContext* context = mScene.getLowLevelContext();
+		PxsTransformCache& cache = context->getTransformCache();
+		Bp::BoundsArray& boundsArray = mScene.getBoundsArray();
+
+		PxsRigidBody* rigids[MaxBodiesPerTask];
+		PxU32 nodeIds[MaxBodiesPerTask];
+		Sc::BodySim* bpUpdates[MaxBodiesPerTask];
+		Sc::BodySim* frozen[MaxBodiesPerTask];
+		PxU32 nbBpUpdates = 0, nbFrozen = 0;
+
+		Gu::BoundsBatch boundsBatch;
+
+		for(PxU32 i = 0; i < nbBodies; i++)
+		{
+			PxsRigidBody* rigid = islandSim.getRigidBody(indices[i]);
+			Sc::BodySim* bodySim = reinterpret_cast<Sc::BodySim*>(reinterpret_cast<PxU8*>(rigid) - rigidBodyOffset);
+			rigids[i] = rigid;
+			nodeIds[i] = bodySim->getNodeIndex().index();
+
+			rigid->setPose(rigid->getLastCCDTransform());
+
+			if(!bodySim->isFrozen())
+			{
+				bodySim->updateCached(cache, boundsArray, boundsBatch);
+				bpUpdates[nbBpUpdates++] = bodySim;
+			}
+
+			if(rigid->isFreezeThisFrame())
+				frozen[nbFrozen++] = bodySim;
+
+			PxsBodyCore& bodyCore = bodySim->getBodyCore().getCore();
+			bodyCore.wakeCounter = 0.f;
+			bodyCore.linearVelocity = PxVec3(0);
+			bodyCore.angularVelocity = PxVec3(0);
+
+			rigid->clearAllFrameFlags();
+		}
+		boundsBatch.flush();
+
+		if(nbBpUpdates)
+		{
+			cache.setChangedState();
+			boundsArray.setChangedState();
+		}
+
+		context->getLock().lock();
+		Cm::BitMapPinned& changedAABBMgrActorHandles = mScene.getAABBManager()->getChangedAABBMgActorHandleMap();
+
+		for(PxU32 i = 0; i < nbBpUpdates; i++)
+		{
+			Sc::ShapeSim* sim;
+			for(Sc::ShapeIterator iterator(*bpUpdates[i]); (sim = iterator.getNext()) != NULL;)
+			{
+				if(sim->isInBroadPhase())
+					changedAABBMgrActorHandles.growAndSet(sim->getElementID());
+			}
+		}
+
+		mScene.getSimulationController()->addDynamics(rigids, nodeIds, nbBodies);
+
+		for(PxU32 i = 0; i < nbFrozen; i++)
+			frozen[i]->freezeTransforms(&changedAABBMgrActorHandles);
+
+		context->getLock().unlock();
+	}
+
+	Sc::Scene&					mScene;
+	const IG::NodeIndex*		mIndices;
+	Cm::ParallelForRange&		mRange;
+
+	PX_NOCOPY(ScDeactivateBodiesTask)
+};
+
 class UpdatProjectedPoseTask : public Cm::Task
 {
 	Sc::BodySim** mProjectedBodies;
@@ -4061,6 +4381,25 @@ void Sc::Scene::afterIntegration(PxBaseTask* continuation)
 
 		PxU32 previousNumBodiesToDeactivate = mNumDeactivatingNodes[IG::Node::eRIGID_BODY_TYPE];
 
+		// the rollback is split over tasks when many bodies go to sleep at once. They run after the lock stage, so we keep it serial
+		// when there are projected bodies, whose own tasks must see the rolled back poses.
+		const PxU32 nbBodiesToRollBack = numBodiesToDeactivate - previousNumBodiesToDeactivate;
+		const PxU32 nbDeactivateTasks = mProjectedBodies.size() ? 1 : Cm::getParallelForTaskCount(nbBodiesToRollBack, continuation->getTaskManager(), ScDeactivateBodiesTask::MinBodiesPerTask);
+		if(nbDeactivateTasks > 1)
+		{
+			PX_PROFILE_ZONE("AfterIntegration::dispatchDeactivateTasks", getContextId());
+			Cm::FlushPool& flushPool = mLLContext->getTaskPool();
+			Cm::ParallelForRange* range = PX_PLACEMENT_NEW(flushPool.allocate(sizeof(Cm::ParallelForRange)), Cm::ParallelForRange)();
+			range->init(nbBodiesToRollBack, nbDeactivateTasks, ScDeactivateBodiesTask::MinBodiesPerTask, ScDeactivateBodiesTask::MaxBodiesPerTask);
+
+			for(PxU32 a = 0; a < nbDeactivateTasks; a++)
+			{
+				ScDeactivateBodiesTask* task = PX_PLACEMENT_NEW(flushPool.allocate(sizeof(ScDeactivateBodiesTask)), ScDeactivateBodiesTask)(*this, deactivatingIndices + previousNumBodiesToDeactivate, *range);
+				task->setContinuation(continuation);
+				task->removeReference();
+			}
+		}
+		else
 		{
 			Cm::BitMapPinned& changedAABBMgrActorHandles = mAABBManager->getChangedAABBMgActorHandleMap();
 			PX_PROFILE_ZONE("AfterIntegration::deactivateStage", getContextId());
@@ -4415,17 +4754,63 @@ void Sc::Scene::finalizeContactStreamAndCreateHeader(PxContactPairHeader& header
 	header.extraDataStreamSize = extraDataSize;
 }
 
-const Ps::Array<PxContactPairHeader>& Sc::Scene::getQueuedContactPairHeaders()
+namespace
 {
-	// if buffered shape removals occured, then the criteria for testing the contact stream for events with removed shape pointers needs to be more strict.
-	PX_ASSERT(mRemovedShapeCountAtSimStart <= mShapeIDTracker->getDeletedIDCount());
-	bool reducedTestForRemovedShapes = mRemovedShapeCountAtSimStart == mShapeIDTracker->getDeletedIDCount();
-	const PxU32 removedShapeTestMask = PxU32((reducedTestForRemovedShapes ? ContactStreamManagerFlag::eTEST_FOR_REMOVED_SHAPES : (ContactStreamManagerFlag::eTEST_FOR_REMOVED_SHAPES | ContactStreamManagerFlag::eHAS_PAIRS_THAT_LOST_TOUCH)));
+	class ContactPairHeaderTask : public Cm::Task
+	{
+	public:
+		static const PxU32 MaxActorPairs = 256;
+
+		ContactPairHeaderTask(PxU64 contextID, Sc::Scene& scene, PxU32 startIndex, PxU32 nbActorPairs, PxU32 removedShapeTestMask) :
+			Cm::Task				(contextID),
+			mScene					(scene),
+			mStartIndex				(startIndex),
+			mNbActorPairs			(nbActorPairs),
+			mRemovedShapeTestMask	(removedShapeTestMask)
+		{
+		}
+
+		virtual void runInternal()
+		{
+			mScene.finalizeContactPairHeaders(mStartIndex, mNbActorPairs, mRemovedShapeTestMask);
+		}
+
+		virtual const char* getName() const { return "ScScene.contactPairHeaders"; }
+
+	private:
+		PX_NOCOPY(ContactPairHeaderTask)
+
+		Sc::Scene&	mScene;
+		const PxU32	mStartIndex;
+		const PxU32	mNbActorPairs;
+		const PxU32	mRemovedShapeTestMask;
+	};
+
+	// Continuation of the header tasks, releases the thread waiting in buildContactPairHeaders()
+	class ContactPairHeadersDoneTask : public Cm::Task
+	{
+	public:
+		ContactPairHeadersDoneTask(PxU64 contextID, Ps::Sync& sync) : Cm::Task(contextID), mSync(sync)	{}
 
-	ActorPairReport*const* actorPairs = mNPhaseCore->getContactReportActorPairs();
-	PxU32 nbActorPairs = mNPhaseCore->getNbContactReportActorPairs();
-	mQueuedContactPairHeaders.reserve(nbActorPairs);
-	mQueuedContactPairHeaders.clear();
+		virtual void runInternal()					{ mSync.set();							}
+		virtual const char* getName() const			{ return "ScScene.contactPairHeadersDone";	}
+
+	private:
+		PX_NOCOPY(ContactPairHeadersDoneTask)
+
+		Ps::Sync&	mSync;
+	};
+
+	bool isContactPairHeadersDone(void* sync)
+	{
+		return reinterpret_cast<Ps::Sync*>(sync)->wait(0);
+	}
+}
+
+void Sc::Scene::finalizeContactPairHeaders(PxU32 startIndex, PxU32 nbActorPairs, PxU32 removedShapeTestMask)
+{
+	ActorPairReport*const* actorPairs = mNPhaseCore->getContactReportActorPairs() + startIndex;
+	PxContactPairHeader* headers = mQueuedContactPairHeaders.begin() + startIndex;
 
 	for (PxU32 i = 0; i < nbActorPairs; i++)
 	{
@@ -4435,17 +4820,77 @@ const Ps::Array<PxContactPairHeader>& Sc::Scene::getQueuedContactPairHeaders()
 		ActorPairReport* aPair = actorPairs[i];
 		ContactStreamManager& cs = aPair->getContactStreamManager();
 		if (cs.getFlags() & ContactStreamManagerFlag::eINVALID_STREAM)
+		{
+			headers[i].pairs = NULL;
+			headers[i].nbPairs = 0;
 			continue;
+		}
 
 		if (i + 1 < nbActorPairs)
 			Ps::prefetch(&(actorPairs[i + 1]->getContactStreamManager()));
 
-		PxContactPairHeader &pairHeader = mQueuedContactPairHeaders.insert();
-		finalizeContactStreamAndCreateHeader(pairHeader, *aPair, cs, removedShapeTestMask);
+		finalizeContactStreamAndCreateHeader(headers[i], *aPair, cs, removedShapeTestMask);
 
+		// estimates for next frame
 		cs.maxPairCount = cs.currentPairCount;
 		cs.setMaxExtraDataSize(cs.extraDataSize);
 	}
+}
+
+void Sc::Scene::buildContactPairHeaders(bool asPartOfFlush)
+{
+	// if buffered shape removals occured, then the criteria for testing the contact stream for events with removed shape pointers needs to be more strict.
+	PX_ASSERT(asPartOfFlush || (mRemovedShapeCountAtSimStart <= mShapeIDTracker->getDeletedIDCount()));
+	bool reducedTestForRemovedShapes = asPartOfFlush || (mRemovedShapeCountAtSimStart == mShapeIDTracker->getDeletedIDCount());
+	const PxU32 removedShapeTestMask = PxU32(reducedTestForRemovedShapes ? ContactStreamManagerFlag::eTEST_FOR_REMOVED_SHAPES : (ContactStreamManagerFlag::eTEST_FOR_REMOVED_SHAPES | ContactStreamManagerFlag::eHAS_PAIRS_THAT_LOST_TOUCH));
+
+	const PxU32 nbActorPairs = mNPhaseCore->getNbContactReportActorPairs();
+	mQueuedContactPairHeaders.resizeUninitialized(nbActorPairs);
+
+	// flush() runs outside of the simulation, the task manager might not be set up
+	const PxU32 nbPerTask = ContactPairHeaderTask::MaxActorPairs;
+	PxCpuDispatcher* dispatcher = mTaskManager ? mTaskManager->getCpuDispatcher() : NULL;
+	if (!asPartOfFlush && (mPublicFlags & PxSceneFlag::eENABLE_PARALLEL_CONTACT_REPORTS) && (nbActorPairs > nbPerTask) && dispatcher && dispatcher->getWorkerCount())
+	{
+		PX_PROFILE_ZONE("Sim.buildContactPairHeaders", getContextId());
+
+		Cm::FlushPool& pool = *getFlushPool();
+		ContactPairHeadersDoneTask* doneTask = PX_PLACEMENT_NEW(pool.allocate(sizeof(ContactPairHeadersDoneTask)), ContactPairHeadersDoneTask)(getContextId(), mContactPairHeadersDone);
+		doneTask->setContinuation(*mTaskManager, NULL);
+
+		// the first batch is done by this thread
+		for (PxU32 i = nbPerTask; i < nbActorPairs; i += nbPerTask)
+		{
+			ContactPairHeaderTask* task = PX_PLACEMENT_NEW(pool.allocate(sizeof(ContactPairHeaderTask)), ContactPairHeaderTask)(getContextId(), *this, i, PxMin(nbPerTask, nbActorPairs - i), removedShapeTestMask);
+			task->setContinuation(doneTask);
+			task->removeReference();
+		}
+		doneTask->removeReference();
+
+		finalizeContactPairHeaders(0, nbPerTask, removedShapeTestMask);
+
+		if (!dispatcher->waitUntil(isContactPairHeadersDone, &mContactPairHeadersDone))
+			mContactPairHeadersDone.wait();
+		mContactPairHeadersDone.reset();
+	}
+	else
+		finalizeContactPairHeaders(0, nbActorPairs, removedShapeTestMask);
+}
+
+const Ps::Array<PxContactPairHeader>& Sc::Scene::getQueuedContactPairHeaders()
+{
+	buildContactPairHeaders(false);
+
+	// leave out the invalid streams
+	PxContactPairHeader* headers = mQueuedContactPairHeaders.begin();
+	const PxU32 nbActorPairs = mQueuedContactPairHeaders.size();
+	PxU32 nbHeaders = 0;
+	for (PxU32 i = 0; i < nbActorPairs; i++)
+	{
+		if (headers[i].nbPairs)
+			headers[nbHeaders++] = headers[i];
+	}
+	mQueuedContactPairHeaders.forceSize_Unsafe(nbHeaders);
 
 	return mQueuedContactPairHeaders;
 }
@@ -4457,57 +4902,63 @@ void Sc::Scene::fireQueuedContactCallbacks(bool asPartOfFlush)
 {
 	//if(contactNotifyCallback) //TODO: not sure if this is a key optimization, but to do something like this, we'd have to check if there are ANY contact reports set for any client.
 	{
-		// if buffered shape removals occured, then the criteria for testing the contact stream for events with removed shape pointers needs to be more strict.
-		PX_ASSERT(asPartOfFlush || (mRemovedShapeCountAtSimStart <= mShapeIDTracker->getDeletedIDCount()));
-		bool reducedTestForRemovedShapes = asPartOfFlush || (mRemovedShapeCountAtSimStart == mShapeIDTracker->getDeletedIDCount());
-		const PxU32 removedShapeTestMask = PxU32(reducedTestForRemovedShapes ? ContactStreamManagerFlag::eTEST_FOR_REMOVED_SHAPES : (ContactStreamManagerFlag::eTEST_FOR_REMOVED_SHAPES | ContactStreamManagerFlag::eHAS_PAIRS_THAT_LOST_TOUCH));
+		buildContactPairHeaders(asPartOfFlush);
 
 		ActorPairReport*const* actorPairs = mNPhaseCore->getContactReportActorPairs();
-		PxU32 nbActorPairs = mNPhaseCore->getNbContactReportActorPairs();
-		for(PxU32 i=0; i < nbActorPairs; i++)
-		{
-			if (i < (nbActorPairs - 1))
-				Ps::prefetchLine(actorPairs[i+1]);
+		PxContactPairHeader* headers = mQueuedContactPairHeaders.begin();
+		const PxU32 nbActorPairs = mQueuedContactPairHeaders.size();
 
-			ActorPairReport* aPair = actorPairs[i];
-			ContactStreamManager& cs = aPair->getContactStreamManager();
-			if (cs.getFlags() & ContactStreamManagerFlag::eINVALID_STREAM)
-				continue;
-			
-			if (i + 1 < nbActorPairs)
-				Ps::prefetch(&(actorPairs[i+1]->getContactStreamManager()));
-
-			PxContactPairHeader pairHeader;
-			finalizeContactStreamAndCreateHeader(pairHeader, *aPair, cs, removedShapeTestMask);
+		if (mClients.size() == 1)
+		{
+			// easy common case: the same client owns all the shapes, the headers go out in a single call
+			PxU32 nbHeaders = 0;
+			for (PxU32 i = 0; i < nbActorPairs; i++)
+			{
+				if (headers[i].nbPairs)
+					headers[nbHeaders++] = headers[i];
+			}
 
-			//multiclient support:
-			PxClientID clientActor0 = aPair->getActorAClientID();
-			PxClientID clientActor1 = aPair->getActorBClientID();
+			if (nbHeaders && mClients[0]->simulationEventCallback)
+				mClients[0]->simulationEventCallback->onContacts(headers, nbHeaders);
+		}
+		else
+		{
+			//multiclient support: gather the headers of each client
+			for (PxU32 client = 0; client < mClients.size(); client++)
+			{
+				PxSimulationEventCallback* callback = mClients[client]->simulationEventCallback;
+				if (!callback)
+					continue;
 
-			PxU8 actor0ClientBehaviorFlags = aPair->getActorAClientBehavior();
-			PxU8 actor1ClientBehaviorFlags = aPair->getActorBClientBehavior();
+				const bool acceptsForeignObjects = mClients[client]->behaviorFlags.isSet(PxClientBehaviorFlag::eREPORT_FOREIGN_OBJECTS_TO_CONTACT_NOTIFY);
 
-			if (mClients[clientActor0]->simulationEventCallback &&
-				(
-				(clientActor0 == clientActor1)	//easy common case: the same client owns both shapes
-				|| (	//else actor1 has a different owner -- see if we can still send this pair to the client of actor0:
-					(mClients[clientActor0]->behaviorFlags & PxClientBehaviorFlag::eREPORT_FOREIGN_OBJECTS_TO_CONTACT_NOTIFY)//this client accepts foreign objects
-					&& (actor1ClientBehaviorFlags & PxActorClientBehaviorFlag::eREPORT_TO_FOREIGN_CLIENTS_CONTACT_NOTIFY)//this actor can be sent to foreign client
-					)
-				))
-				mClients[clientActor0]->simulationEventCallback->onContact(pairHeader, pairHeader.pairs, pairHeader.nbPairs);
+				mClientContactPairHeaders.clear();
+				for (PxU32 i = 0; i < nbActorPairs; i++)
+				{
+					if (!headers[i].nbPairs)
+						continue;
+
+					const ActorPairReport* aPair = actorPairs[i];
+					PxClientID clientActor0 = aPair->getActorAClientID();
+					PxClientID clientActor1 = aPair->getActorBClientID();
+
+					bool report;
+					if (clientActor0 == clientActor1)
+						report = (client == clientActor0);
+					else if (client == clientActor0)	// see if actor1 can be sent to the client of actor0
+						report = acceptsForeignObjects && (aPair->getActorBClientBehavior() & PxActorClientBehaviorFlag::eREPORT_TO_FOREIGN_CLIENTS_CONTACT_NOTIFY);
+					else if (client == clientActor1)
+						report = acceptsForeignObjects && (aPair->getActorAClientBehavior() & PxActorClientBehaviorFlag::eREPORT_TO_FOREIGN_CLIENTS_CONTACT_NOTIFY);
+					else
+						report = false;
 
-			if (
-				(clientActor0 != clientActor1)	//don't call the same client twice
-				&& mClients[clientActor1]->simulationEventCallback
-				&& (mClients[clientActor1]->behaviorFlags & PxClientBehaviorFlag::eREPORT_FOREIGN_OBJECTS_TO_CONTACT_NOTIFY)//this client accepts foreign objects
-				&& (actor0ClientBehaviorFlags & PxActorClientBehaviorFlag::eREPORT_TO_FOREIGN_CLIENTS_CONTACT_NOTIFY)//this actor can be sent to foreign client
-				)
-				mClients[clientActor1]->simulationEventCallback->onContact(pairHeader, pairHeader.pairs, pairHeader.nbPairs);
+					if (report)
+						mClientContactPairHeaders.pushBack(headers[i]);
+				}
 
-			// estimates for next frame
-			cs.maxPairCount = cs.currentPairCount;
-			cs.setMaxExtraDataSize(cs.extraDataSize);
+				if (mClientContactPairHeaders.size())
+					callback->onContacts(mClientContactPairHeaders.begin(), mClientContactPairHeaders.size());
+			}
 		}
 	}
 }
@@ -4993,6 +5444,9 @@ void Sc::Scene::postCallbacksPreSync()
 	}
 
 	releaseConstraints(true); //release constraint blocks at the end of the frame, so user can retrieve the blocks
+
+	// the blocks left unused since a peak are given back gradually
+	mLLContext->getNpMemBlockPool().trimUnusedBlocks();
 }
 
 void Sc::Scene::setNbContactDataBlocks(PxU32 numBlocks)
@@ -5024,6 +5478,25 @@ void Sc::Scene::checkConstraintBreakage()
 {
 	PX_PROFILE_ZONE("Sim.checkConstraintBreakage", getContextId());
 
+	if (mConstraintBreakageTested)
+	{
+		// Only the constraints the solver broke are left to process. Constraints that got deactivated after the tests are not in the
+		// active list anymore and are skipped, like they would have been by a test at this point.
+		mConstraintBreakageTested = false;
+
+		PxU32 count = mBrokenConstraintCandidates.size();
+		ConstraintSim* const* candidates = mBrokenConstraintCandidates.begin();
+		while(count)
+		{
+			count--;
+			ConstraintSim* c = candidates[count];  // same order as the test of the whole list below
+			if (c && c->readFlag(ConstraintSim::eCHECK_MAX_FORCE_EXCEEDED))
+				c->checkMaxForceExceeded();
+		}
+		mBrokenConstraintCandidates.forceSize_Unsafe(0);
+		return;
+	}
+
 	PxU32 count = mActiveBreakableConstraints.size();
 	ConstraintSim* const* constraints = mActiveBreakableConstraints.getEntries(); 
 	while(count)
@@ -5045,6 +5518,52 @@ void Sc::Scene::getStats(PxSimulationStatistics& s) const
 		s.nbShapes[i] = mNbGeometries[i];
 }
 
+void Sc::Scene::beginStatsStage(PxSimulationStatistics::StageType stage)
+{
+	mStats->beginStage(stage);
+}
+
+void Sc::Scene::endStatsStage(PxSimulationStatistics::StageType stage)
+{
+	mStats->endStage(stage);
+}
+
+void Sc::Scene::setCostProfiling(PxU32 maxEntries)
+{
+	if(!maxEntries)
+	{
+		PX_DELETE_AND_RESET(mCostProfiler);
+	}
+	else if(mCostProfiler)
+	{
+		mCostProfiler->setMaxEntries(maxEntries);
+	}
+	else
+	{
+		mCostProfiler = PX_NEW(CostProfiler)(maxEntries);
+	}
+
+	mLLContext->setCostProfiling(maxEntries != 0);
+	mDynamicsContext->setCostProfiling(maxEntries != 0);
+}
+
+PxU32 Sc::Scene::getCostProfiling() const
+{
+	return mCostProfiler ? mCostProfiler->getMaxEntries() : 0;
+}
+
+bool Sc::Scene::getCostProfile(PxCostProfile& profile) const
+{
+	if(!mCostProfiler)
+	{
+		PxMemZero(&profile, sizeof(profile));
+		return false;
+	}
+
+	mCostProfiler->getProfile(profile);
+	return true;
+}
+
 void Sc::Scene::addShapes(void *const* shapes, PxU32 nbShapes, size_t ptrOffset, RigidSim& bodySim, PxBounds3* outBounds)
 {
 	for(PxU32 i=0;i<nbShapes;i++)
@@ -5843,6 +6362,8 @@ void Sc::Scene::initDominanceMatrix()
 
 Articulation* Sc::Scene::createLLArticulation(Sc::ArticulationSim* sim)
 {
+	if(!mLLArticulationPool)
+		mLLArticulationPool = PX_NEW(LLArticulationPool);
 	return mLLArticulationPool->construct(sim);
 }
 
@@ -5855,6 +6376,18 @@ void Sc::Scene::destroyLLArticulation(Articulation& articulation)
 
 void Sc::Scene::addParticleSystem(ParticleSystemCore& ps)
 {
+	// created on first use, so that scenes without particles never need the context. This also gives
+	// a context to the scenes created before PxRegisterParticles().
+	if(!mParticleContext)
+	{
+		mParticleContext = Pt::createParticleContext(mTaskManager, mLLContext->getTaskPool());
+		if(!mParticleContext)
+		{
+			getFoundation().error(PxErrorCode::eINVALID_OPERATION, __FILE__, __LINE__, "PxScene::addParticleSystem(): particles are not registered, see PxRegisterParticles().");
+			return;
+		}
+	}
+
 	// sim objects do all the necessary work of adding themselves to broad phase,
 	// activation, registering with the interaction system, etc
 
@@ -5981,8 +6514,11 @@ void Sc::Scene::createClothSolver()
 	if(*mClothSolvers) 
 		return; // already called before
 
-	if(Sc::Physics::getInstance().hasLowLevelClothFactory())
-		mClothFactories[0] = &Sc::Physics::getInstance().getLowLevelClothFactory();
+	// nothing to create before PxRegisterCloth(), which calls this again for the existing scenes. The GPU
+	// factory is not loaded either then.
+	if(!Sc::Physics::getInstance().hasLowLevelClothFactory())
+		return;
+	mClothFactories[0] = &Sc::Physics::getInstance().getLowLevelClothFactory();
 
 	if (mTaskManager && mTaskManager->getGpuDispatcher())
 	{
@@ -6330,18 +6866,11 @@ public:
 
 	virtual void runInternal()
 	{
+		mNPhaseCore->onOverlapFilter(mPairs, mNbToProcess, mFinfo);
+
 		for(PxU32 a = 0; a < mNbToProcess; ++a)
 		{
-			const Bp::AABBOverlap& pair = mPairs[a];
-			Sc::ElementSim* e0 = reinterpret_cast<Sc::ElementSim*>(pair.mUserData0);
-			Sc::ElementSim* e1 = reinterpret_cast<Sc::ElementSim*>(pair.mUserData1);
-
-			PX_ASSERT(e0 != NULL);
-			PX_ASSERT(e1 != NULL);
-
-			const PxFilterInfo finfo = mNPhaseCore->onOverlapFilter(e0, e1);
-
-			mFinfo[a] = finfo;
+			const PxFilterInfo& finfo = mFinfo[a];
 
 			if(!(finfo.filterFlags & PxFilterFlag::eKILL))
 			{
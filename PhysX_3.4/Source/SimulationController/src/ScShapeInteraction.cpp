@@ -47,6 +47,7 @@ Sc::ShapeInteraction::ShapeInteraction(ShapeSim& s1, ShapeSim& s2, PxPairFlags p
 	mActorPair				(NULL),
 	mReportPairIndex		(INVALID_REPORT_PAIR_ID),
 	mManager				(NULL),
+	mSleepingContactState	(NULL),
 	mEdgeIndex				(IG_INVALID_EDGE),
 	mReportStreamIndex		(0)
 {
@@ -127,6 +128,7 @@ Sc::ShapeInteraction::~ShapeInteraction()
 	{
 		destroyManager();
 	}
+	releaseSleepingContactState();
 
 	if (mEdgeIndex != IG_INVALID_EDGE)
 	{
@@ -171,6 +173,9 @@ void Sc::ShapeInteraction::visualize(Cm::RenderOutput& out, PxsContactManagerOut
 		size_t ptrActor1 = reinterpret_cast<size_t>(&getShape1().getRbSim());
 		const PxReal flipNormal = (ptrActor0 < ptrActor1) ? 1.0f : -1.0f;
 
+		const PxBounds3& cullbox = scene.getVisualizationCullingBox();
+		const bool useCullBox = !cullbox.isEmpty();
+
 		PxU32 offset;
 		PxU32 nextOffset = 0;
 		do
@@ -201,6 +206,9 @@ void Sc::ShapeInteraction::visualize(Cm::RenderOutput& out, PxsContactManagerOut
 				{
 					iter.nextContact();
 
+					if (useCullBox && !cullbox.contains(iter.getContactPoint()))
+						continue;
+
 					PxReal length = 0;
 					PxU32 color = 0;
 
@@ -282,7 +290,7 @@ void Sc::ShapeInteraction::setContactReportPostSolverVelocity(ContactStreamManag
 	cs.setContactReportPostSolverVelocity(stream, apr.getActorA(), apr.getActorB());
 }
 
-void Sc::ShapeInteraction::resetManagerCachedState()	const
+void Sc::ShapeInteraction::resetManagerCachedState()
 {
 	if (mManager)
 	{
@@ -293,6 +301,11 @@ void Sc::ShapeInteraction::resetManagerCachedState()	const
 		mManager->resetFrictionCachedState();	
 		nphaseImplementationContext->refreshContactManager(mManager);
 	}
+	else
+	{
+		// the manifold kept while asleep was built for the old shape
+		releaseSleepingContactState();
+	}
 }
 
 /*
@@ -972,7 +985,7 @@ bool Sc::ShapeInteraction::onDeactivate(PxU32 /*infoFlag*/)
 				raiseFlag(HAS_NO_TOUCH);
 			}
 
-			destroyManager();	
+			destroyManager(getScene().getPublicFlags() & PxSceneFlag::eENABLE_WARM_SLEEPING);
 			if (mEdgeIndex != IG_INVALID_EDGE)
 				getScene().getSimpleIslandManager()->clearEdgeRigidCM(mEdgeIndex);
 		}
@@ -1159,8 +1172,16 @@ void Sc::ShapeInteraction::createManager(void* contactManager)
 		scene.getSimpleIslandManager()->setEdgeRigidCM(mEdgeIndex, mManager);
 		PxvNphaseImplementationContext* nphaseImplementationContext = scene.getLowLevelContext()->getNphaseImplementationContext();
 		PX_ASSERT(nphaseImplementationContext);
-		nphaseImplementationContext->registerContactManager(mManager, touching, 0);
+		if (mSleepingContactState)
+		{
+			nphaseImplementationContext->registerWokenContactManager(mManager, touching, 0, mSleepingContactState);
+			mSleepingContactState = NULL;
+		}
+		else
+			nphaseImplementationContext->registerContactManager(mManager, touching, 0);
 	}
+	else
+		releaseSleepingContactState();
 }
 
 
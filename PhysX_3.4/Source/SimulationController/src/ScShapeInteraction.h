@@ -105,7 +105,7 @@ namespace Sc
 		PX_FORCE_INLINE	void					sendCCDRetouch(const PxU32 ccdPass, PxsContactManagerOutputIterator& outputs);
 						void					setContactReportPostSolverVelocity(ContactStreamManager& cs);
 		PX_FORCE_INLINE	void					sendLostTouchReport(bool shapeVolumeRemoved, const PxU32 ccdPass, PxsContactManagerOutputIterator& ouptuts);
-						void					resetManagerCachedState()	const;
+						void					resetManagerCachedState();
 	
 		PX_FORCE_INLINE	ActorPair*				getActorPair()				const	{ return mActorPair;								}
 		PX_FORCE_INLINE	void					setActorPair(ActorPair& aPair)		{ mActorPair = &aPair;								}
@@ -144,6 +144,7 @@ namespace Sc
 						PxU32					mReportPairIndex;			// Owned by NPhaseCore for its report pair list
 
 						PxsContactManager*		mManager;
+						void*					mSleepingContactState;		// Narrow phase state kept while the pair is asleep, see PxSceneFlag::eENABLE_WARM_SLEEPING
 
 						PxU32					mEdgeIndex;
 
@@ -154,7 +155,8 @@ namespace Sc
 						void					createManager(void* contactManager);
 		PX_INLINE		void					resetManager();
 		PX_INLINE		bool					updateManager(void* contactManager);
-		PX_INLINE		void					destroyManager();
+		PX_INLINE		void					destroyManager(bool keepState = false);
+		PX_INLINE		void					releaseSleepingContactState();
 		PX_FORCE_INLINE	bool					activeManagerAllowed() const;
 		PX_FORCE_INLINE	PxU32					getManagerContactState()		const	{ return mFlags & LL_MANAGER_RECREATE_EVENT; }
 
@@ -296,7 +298,7 @@ PX_INLINE bool Sc::ShapeInteraction::updateManager(void* contactManager)
 		return false;
 }
 
-PX_INLINE void Sc::ShapeInteraction::destroyManager()
+PX_INLINE void Sc::ShapeInteraction::destroyManager(bool keepState)
 {
 	PX_ASSERT(mManager);
 
@@ -304,7 +306,13 @@ PX_INLINE void Sc::ShapeInteraction::destroyManager()
 	
 	PxvNphaseImplementationContext* nphaseImplementationContext = scene.getLowLevelContext()->getNphaseImplementationContext();
 	PX_ASSERT(nphaseImplementationContext);
-	nphaseImplementationContext->unregisterContactManager(mManager);
+	if (keepState)
+	{
+		PX_ASSERT(!mSleepingContactState);
+		mSleepingContactState = nphaseImplementationContext->unregisterSleepingContactManager(mManager);
+	}
+	else
+		nphaseImplementationContext->unregisterContactManager(mManager);
 
 	/*if (mEdgeIndex != IG_INVALID_EDGE)
 		scene.getSimpleIslandManager()->clearEdgeRigidCM(mEdgeIndex);*/
@@ -313,6 +321,16 @@ PX_INLINE void Sc::ShapeInteraction::destroyManager()
 }
 
 
+PX_INLINE void Sc::ShapeInteraction::releaseSleepingContactState()
+{
+	if (mSleepingContactState)
+	{
+		getScene().getLowLevelContext()->getNphaseImplementationContext()->releaseSleepingContactState(mSleepingContactState);
+		mSleepingContactState = NULL;
+	}
+}
+
+
 PX_FORCE_INLINE bool Sc::ShapeInteraction::activeManagerAllowed() const
 {
 	PX_ASSERT(getShape0().getActor().isDynamicRigid() || getShape1().getActor().isDynamicRigid());
@@ -288,6 +288,11 @@ void Sc::ShapeSim::onFlagChange(PxShapeFlags oldFlags)
 			if (wasTrigger != isTrigger)
 				setElementInteractionsDirty(InteractionDirtyFlag::eFILTER_STATE, InteractionFlag::eFILTERABLE);
 		}
+
+		// the trigger pairs of the other mode are not tracked anymore, they are recreated from scratch
+		const PxShapeFlags boundsOnlyFlags = PxShapeFlag::eTRIGGER_BOUNDS_ONLY|PxShapeFlag::eTRIGGER_TEST_ON_ENTER;
+		if (wasTrigger && isTrigger && ((oldFlags ^ newFlags) & boundsOnlyFlags))
+			reinsertBroadPhase();
 	}
 
 	PxShapeFlags hadSq = oldFlags&PxShapeFlag::eSCENE_QUERY_SHAPE, hasSq = newFlags&PxShapeFlag::eSCENE_QUERY_SHAPE;
@@ -384,7 +389,8 @@ void Sc::ShapeSim::updateCached(PxU32 transformCacheFlags, Cm::BitMapPinned* sha
 		shapeChangedMap->growAndSet(index);
 }
 
-void Sc::ShapeSim::updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray)
+// the bounds of the simple shapes are only written when the batch is flushed
+void Sc::ShapeSim::updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray, Gu::BoundsBatch& boundsBatch)
 {
 	const PxU32 index = getElementID();
 
@@ -396,7 +402,9 @@ void Sc::ShapeSim::updateCached(PxsTransformCache& transformCache, Bp::BoundsArr
 	ct.flags = 0;
 
 	PxBounds3& b = boundsArray.begin()[index];
-	Gu::computeBounds(b, mCore.getGeometryUnion().getGeometry(), ct.transform, 0.0f, NULL, 1.0f, !physx::gUnifiedHeightfieldCollision);
+	const PxGeometry& geometry = mCore.getGeometryUnion().getGeometry();
+	if(!boundsBatch.add(b, geometry, ct.transform))
+		Gu::computeBounds(b, geometry, ct.transform, 0.0f, NULL, 1.0f, !physx::gUnifiedHeightfieldCollision);
 }
 
 void Sc::ShapeSim::updateContactDistance(PxReal* contactDistance, const PxReal inflation, const PxVec3 angVel, const PxReal dt, Bp::BoundsArray& boundsArray)
@@ -470,7 +478,7 @@ void Sc::ShapeSim::markBoundsForUpdate(bool forceBoundsUpdate, bool isDynamic)
 	// PT: onShapeChange currently only used for GPU physics. Inlined 'getSceneGpu' call avoids
 	// extra function calls and additional work from getPxsRigidCore(), etc
 	Pt::Context* context = scene.getParticleContext();
-	if(context->getSceneGpuFast())
+	if(context && context->getSceneGpuFast())
 		context->getSceneGpuFast()->onShapeChange(size_t(&mCore.getCore()), size_t(&getPxsRigidCore()), isDynamic);
 #endif
 #endif
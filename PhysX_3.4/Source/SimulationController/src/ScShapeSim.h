@@ -45,6 +45,7 @@ namespace Gu
 {
 	class TriangleMesh;
 	class HeightField;
+	class BoundsBatch;
 }
 
 /** Simulation object corresponding to a shape core object. This object is created when
@@ -125,7 +126,7 @@ namespace Sc
 		PX_FORCE_INLINE void							setSqBoundsId(PxU32 id)						{ mSqBoundsId = id; }
 
 						void							updateCached(PxU32 transformCacheFlags, Cm::BitMapPinned* shapeChangedMap);
-						void							updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray);
+						void							updateCached(PxsTransformCache& transformCache, Bp::BoundsArray& boundsArray, Gu::BoundsBatch& boundsBatch);
 						void							updateContactDistance(PxReal* contactDistance, const PxReal inflation, const PxVec3 angVel, const PxReal dt, Bp::BoundsArray& boundsArray);
 						Ps::IntBool						updateSweptBounds();
 						void							updateBPGroup();
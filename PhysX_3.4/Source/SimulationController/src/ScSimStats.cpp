@@ -31,19 +31,33 @@
 #include "foundation/PxMemory.h"
 #include "ScSimStats.h"
 #include "PxvSimStats.h"
+#include "CmTaskTimer.h"
+#include "PsTime.h"
 
 using namespace physx;
 
 static const PxU32 sBroadphaseAddRemoveSize = sizeof(PxU32) * PxSimulationStatistics::eVOLUME_COUNT;
 
-Sc::SimStats::SimStats()
+Sc::SimStats::SimStats(PxU64 contextId)
 {
 	PxMemZero(&numBroadPhaseAdds, sBroadphaseAddRemoveSize);
 	PxMemZero(&numBroadPhaseRemoves, sBroadphaseAddRemoveSize);
 
+	// Without a timer (too many scenes) only the wall times are measured
+	taskTimer = Cm::TaskTimer::acquire(contextId);
+	PxMemZero(stageStart, sizeof(stageStart));
+	PxMemZero(stageWallTime, sizeof(stageWallTime));
+	PxMemZero(stageCallerTime, sizeof(stageCallerTime));
+
 	clear();
 }
 
+Sc::SimStats::~SimStats()
+{
+	if(taskTimer)
+		taskTimer->release();
+}
+
 
 void Sc::SimStats::clear()
 {
@@ -62,6 +76,54 @@ void Sc::SimStats::simStart()
 	PxMemMove(numBroadPhaseAdds, numBroadPhaseAddsPending, sBroadphaseAddRemoveSize);
 	PxMemMove(numBroadPhaseRemoves, numBroadPhaseRemovesPending, sBroadphaseAddRemoveSize);
 	clear();
+
+	PxMemZero(stageStart, sizeof(stageStart));
+	PxMemZero(stageWallTime, sizeof(stageWallTime));
+	PxMemZero(stageCallerTime, sizeof(stageCallerTime));
+	if(taskTimer)
+	{
+		taskTimer->setStage(Cm::TaskTimer::NO_STAGE);
+		taskTimer->reset();
+	}
+#endif
+}
+
+// The scene query update and the callbacks run on the thread calling fetchResults(), not in tasks
+static PX_FORCE_INLINE bool isCallerStage(PxSimulationStatistics::StageType stage)
+{
+	return stage >= PxSimulationStatistics::eSTAGE_SCENE_QUERY_UPDATE;
+}
+
+void Sc::SimStats::beginStage(PxSimulationStatistics::StageType stage)
+{
+#if PX_ENABLE_SIM_STATS
+	stageStart[stage] = Ps::Time::getCurrentCounterValue();
+	if(taskTimer && !isCallerStage(stage))
+	{
+		stagePrevious[stage] = taskTimer->getStage();
+		taskTimer->setStage(PxI32(stage));
+	}
+#else
+	PX_UNUSED(stage);
+#endif
+}
+
+void Sc::SimStats::endStage(PxSimulationStatistics::StageType stage)
+{
+#if PX_ENABLE_SIM_STATS
+	if(!stageStart[stage])
+		return;
+
+	const PxU64 elapsed = Ps::Time::getBootCounterFrequency().toTensOfNanos(Ps::Time::getCurrentCounterValue() - stageStart[stage]);
+	stageStart[stage] = 0;
+	stageWallTime[stage] += elapsed;
+
+	if(isCallerStage(stage))
+		stageCallerTime[stage] += elapsed;
+	else if(taskTimer && taskTimer->getStage() == PxI32(stage))
+		taskTimer->setStage(stagePrevious[stage]);
+#else
+	PX_UNUSED(stage);
 #endif
 }
 
@@ -92,6 +154,9 @@ void Sc::SimStats::readOut(PxSimulationStatistics& s, const PxvSimStats& simStat
 		s.nbDiscreteContactPairs[i][i] = simStats.mNbDiscreteContactPairs[i][i];
 		s.nbModifiedContactPairs[i][i] = simStats.mNbModifiedContactPairs[i][i];
 		s.nbCCDPairs[i][i] = simStats.mNbCCDPairs[i][i];
+		s.nbPCMManifoldHits[i][i] = simStats.mNbPCMManifoldHits[i][i];
+		s.nbPCMManifoldRefreshes[i][i] = simStats.mNbPCMManifoldRefreshes[i][i];
+		s.nbPCMManifoldRegenerations[i][i] = simStats.mNbPCMManifoldRegenerations[i][i];
 
 		for(PxU32 j=i+1; j < PxGeometryType::eGEOMETRY_COUNT; j++)
 		{
@@ -106,6 +171,18 @@ void Sc::SimStats::readOut(PxSimulationStatistics& s, const PxvSimStats& simStat
 			c = simStats.mNbCCDPairs[i][j];
 			s.nbCCDPairs[i][j] = c;
 			s.nbCCDPairs[j][i] = c;
+
+			c = simStats.mNbPCMManifoldHits[i][j];
+			s.nbPCMManifoldHits[i][j] = c;
+			s.nbPCMManifoldHits[j][i] = c;
+
+			c = simStats.mNbPCMManifoldRefreshes[i][j];
+			s.nbPCMManifoldRefreshes[i][j] = c;
+			s.nbPCMManifoldRefreshes[j][i] = c;
+
+			c = simStats.mNbPCMManifoldRegenerations[i][j];
+			s.nbPCMManifoldRegenerations[i][j] = c;
+			s.nbPCMManifoldRegenerations[j][i] = c;
 		}
 #if PX_DEBUG
 		for(PxU32 j=0; j < i; j++)
@@ -136,6 +213,13 @@ void Sc::SimStats::readOut(PxSimulationStatistics& s, const PxvSimStats& simStat
 	s.nbLostTouches = simStats.mNbLostTouches;
 	s.nbPartitions = simStats.mNbPartitions;
 
+	for(PxU32 i=0; i < PxSimulationStatistics::eSTAGE_COUNT; i++)
+	{
+		const PxU64 cpuTime = stageCallerTime[i] + (taskTimer ? taskTimer->getTime(i) : 0);
+		s.stageWallTime[i] = PxU32(stageWallTime[i] / 100);
+		s.stageCpuTime[i] = PxU32(cpuTime / 100);
+	}
+
 #else
 	PX_UNUSED(s);
 	PX_UNUSED(simStats);
@@ -42,6 +42,11 @@ namespace physx
 
 struct PxvSimStats;
 
+namespace Cm
+{
+	class TaskTimer;
+}
+
 namespace Sc
 {
 
@@ -51,7 +56,8 @@ namespace Sc
 	class SimStats : public Ps::UserAllocated
 	{
 	public:
-		SimStats();
+		SimStats(PxU64 contextId);
+		~SimStats();
 
 		void clear();		//set counters to zero
 		void simStart();
@@ -67,6 +73,11 @@ namespace Sc
 			numBroadPhaseRemovesPending[v]++;
 		}
 
+		// A stage can run several times per step, ending a stage that isn't running does nothing.
+		// The tasks started while a stage runs are timed for it, until it ends or another stage starts
+		void beginStage(PxSimulationStatistics::StageType stage);
+		void endStage(PxSimulationStatistics::StageType stage);
+
 	private:
 		// Broadphase adds/removes for the current simulation step
 		PxU32 numBroadPhaseAdds[PxSimulationStatistics::eVOLUME_COUNT];
@@ -76,6 +87,13 @@ namespace Sc
 		PxU32 numBroadPhaseAddsPending[PxSimulationStatistics::eVOLUME_COUNT];
 		PxU32 numBroadPhaseRemovesPending[PxSimulationStatistics::eVOLUME_COUNT];
 
+		// Stage timings for the current simulation step
+		Cm::TaskTimer* taskTimer;
+		PxU64 stageStart[PxSimulationStatistics::eSTAGE_COUNT];		// counter value, 0 while the stage isn't running
+		PxI32 stagePrevious[PxSimulationStatistics::eSTAGE_COUNT];	// stage of the task timer when the stage started
+		PxU64 stageWallTime[PxSimulationStatistics::eSTAGE_COUNT];	// tens of nanoseconds
+		PxU64 stageCallerTime[PxSimulationStatistics::eSTAGE_COUNT];	// CPU time spent on the calling thread, in tens of nanoseconds
+
 	public:
 		typedef PxI32 TriggerPairCountsNonVolatile[PxGeometryType::eCONVEXMESH+1][PxGeometryType::eGEOMETRY_COUNT];
 		typedef volatile TriggerPairCountsNonVolatile TriggerPairCounts;
@@ -96,6 +96,9 @@ bool Sc::TriggerInteraction::isOneActorActive() const
 // - If the scenario above does not apply, then a trigger pair can only be deactivated, if both actors are sleeping.
 // - If an overlapping actor is activated/deactivated, the trigger interaction gets notified
 //
+// Pairs of bounds only triggers don't need to stay active once no overlap test is needed anymore, whatever
+// the sleep state: their overlap can only end with the broadphase pair, which deletes the interaction.
+//
 bool Sc::TriggerInteraction::onActivate(void*)
 {
 	// IMPORTANT: this method can get called concurrently from multiple threads -> make sure shared resources
@@ -103,7 +106,7 @@ bool Sc::TriggerInteraction::onActivate(void*)
 
 	if (!(readFlag(PROCESS_THIS_FRAME)))
 	{
-		if (isOneActorActive())
+		if (needsOverlapTest() && isOneActorActive())
 		{
 			raiseInteractionFlag(InteractionFlag::eIS_ACTIVE);
 			return true;
@@ -123,7 +126,7 @@ bool Sc::TriggerInteraction::onDeactivate(PxU32)
 {
 	if (!readFlag(PROCESS_THIS_FRAME))
 	{
-		if (!isOneActorActive())
+		if (!needsOverlapTest() || !isOneActorActive())
 		{
 			clearInteractionFlag(InteractionFlag::eIS_ACTIVE);
 			return true;
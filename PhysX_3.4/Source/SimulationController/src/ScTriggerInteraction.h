@@ -73,6 +73,10 @@ namespace Sc
 
 		PX_FORCE_INLINE void				forceProcessingThisFrame(Sc::Scene& scene);
 
+		// True if the exact overlap test has to run for this pair (always, unless the trigger shape has
+		// PxShapeFlag::eTRIGGER_BOUNDS_ONLY or eTRIGGER_TEST_ON_ENTER)
+		PX_FORCE_INLINE	bool				needsOverlapTest()							const;
+
 		//////////////////////// interaction ////////////////////////
 		virtual			bool				onActivate(void*);
 		virtual			bool				onDeactivate(PxU32 infoFlag);
@@ -109,6 +113,15 @@ PX_FORCE_INLINE void Sc::TriggerInteraction::setTriggerFlags(PxPairFlags trigger
 }
 
 
+PX_FORCE_INLINE bool Sc::TriggerInteraction::needsOverlapTest() const
+{
+	const PxU32 flags = getTriggerShape().getFlags();
+	if (flags & PxShapeFlag::eTRIGGER_TEST_ON_ENTER)
+		return !mLastFrameHadContacts;  // once inside, only the broadphase can end the overlap
+	return !(flags & PxShapeFlag::eTRIGGER_BOUNDS_ONLY);
+}
+
+
 PX_FORCE_INLINE void Sc::TriggerInteraction::forceProcessingThisFrame(Sc::Scene& scene)
 {
 	raiseFlag(PROCESS_THIS_FRAME);
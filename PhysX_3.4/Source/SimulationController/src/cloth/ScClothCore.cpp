@@ -841,6 +841,40 @@ PxU32 Sc::ClothCore::getNbSelfCollisionIndices() const
 	return mLowLevelCloth->getNumSelfCollisionIndices();
 }
 
+void Sc::ClothCore::setSelfCollisionInterval(PxU32 interval)
+{
+	mLowLevelCloth->setSelfCollisionInterval(interval);
+}
+PxU32 Sc::ClothCore::getSelfCollisionInterval() const
+{
+	return mLowLevelCloth->getSelfCollisionInterval();
+}
+
+void Sc::ClothCore::setLod(const PxClothLod& lod)
+{
+	cloth::LodConfig config;
+	config.mSolverFrequencyScale = lod.solverFrequencyScale;
+	config.mPhaseTypes = lod.phaseTypes;
+	config.mSelfCollision = lod.selfCollision;
+	config.mUpdateInterval = lod.updateInterval;
+
+	// the low level cloth masks phase configs by phase index, and config i is phase i
+	PxU32 nbPhases = PxMin(mFabric->getNbPhases(), 32u);
+	for(PxU32 i=0; i < nbPhases; i++)
+	{
+		if(!(lod.phaseTypes & (1u << mFabric->getPhaseType(i))))
+			config.mPhaseMask &= ~(1u << i);
+	}
+
+	mLowLevelCloth->setLodConfig(config);
+}
+
+PxClothLod Sc::ClothCore::getLod() const
+{
+	const cloth::LodConfig& config = mLowLevelCloth->getLodConfig();
+	return PxClothLod(config.mSolverFrequencyScale, config.mPhaseTypes, config.mSelfCollision, config.mUpdateInterval);
+}
+
 void Sc::ClothCore::setRestPositions(const PxVec4* restPositions)
 {
 	PxU32 size = restPositions ? mLowLevelCloth->getNumParticles() : 0;
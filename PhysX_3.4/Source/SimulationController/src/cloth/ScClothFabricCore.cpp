@@ -170,7 +170,7 @@ bool Sc::ClothFabricCore::load(PxInputStream& stream)
     // check if incompatible version is used. Version number changed 
 	// from PX_PHYSICS_VERSION to ordinal number in 3.3.2.
 	// see ExtClothFabricCooker.cpp (PxFabricCookerImpl::save)
-    if (version != 0x030300 && version != 0x030301 && version != 1)
+    if (version != 0x030300 && version != 0x030301 && version != 1 && version != 2)
     {
         Ps::getFoundation().error(PxErrorCode::eINTERNAL_ERROR, __FILE__, __LINE__, 
 			"Loading cloth fabric failed: mismatching version of cloth fabric stream.");
@@ -211,6 +211,16 @@ bool Sc::ClothFabricCore::load(PxInputStream& stream)
 	stream.read(tetherLengths.begin(), desc.nbTethers * sizeof(PxReal));
 	desc.tetherLengths = tetherLengths.begin();
 
+	// version 2 streams also have the triangles
+	Ps::Array<PxU32> triangles;
+	if (version == 2)
+	{
+		stream.read(&desc.nbTriangles, sizeof(PxU32));
+		triangles.resize(desc.nbTriangles * 3);
+		stream.read(triangles.begin(), desc.nbTriangles * 3 * sizeof(PxU32));
+		desc.triangles = triangles.begin();
+	}
+
 	return load(desc);
 }
 
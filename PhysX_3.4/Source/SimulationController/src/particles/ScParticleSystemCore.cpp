@@ -429,6 +429,15 @@ void Sc::ParticleSystemCore::setParticleReadDataFlags(PxParticleReadDataFlags fl
 
 //----------------------------------------------------------------------------//
 
+void Sc::ParticleSystemCore::setParticleWriteBuffers(const PxParticleWriteBuffers* buffers)
+{
+	PX_ASSERT(getSim());
+	if (getSim())
+		getSim()->setWriteBuffers(buffers);
+}
+
+//----------------------------------------------------------------------------//
+
 PxU32 Sc::ParticleSystemCore::getMaxParticles() const
 { 	
 	return getParticleState().getMaxParticlesV();
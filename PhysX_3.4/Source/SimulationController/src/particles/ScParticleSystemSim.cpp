@@ -453,6 +453,60 @@ void Sc::ParticleSystemSim::endStep()
 
 	// 2-way interaction
 	updateRigidBodies();
+
+	writeParticleBuffers();
+}
+
+//----------------------------------------------------------------------------//
+
+void Sc::ParticleSystemSim::setWriteBuffers(const PxParticleWriteBuffers* buffers)
+{
+	mWriteBuffers = buffers ? *buffers : PxParticleWriteBuffers();
+}
+
+//----------------------------------------------------------------------------//
+
+void Sc::ParticleSystemSim::writeParticleBuffers()
+{
+	PxVec3* positions = mWriteBuffers.positionBuffer.ptr();
+	PxVec3* velocities = mWriteBuffers.velocityBuffer.ptr();
+	if (!positions && !velocities)
+		return;
+
+	PX_PROFILE_ZONE("ParticleSim.writeParticleBuffers",0);
+
+	Pt::ParticleSystemStateDataDesc particles;
+	getParticleState().getParticlesV(particles, false, false);
+
+	const PxU32 capacity = mWriteBuffers.capacity;
+	const PxU32 positionStride = mWriteBuffers.positionBuffer.stride();
+	const PxU32 velocityStride = mWriteBuffers.velocityBuffer.stride();
+	PxU32 nbWritten = 0;
+
+	if (particles.numParticles > 0)
+	{
+		PX_ASSERT(particles.bitMap);
+		Cm::BitMap::Iterator it(*particles.bitMap);
+		for (PxU32 p = it.getNext(); p != Cm::BitMap::Iterator::DONE; p = it.getNext())
+		{
+			// the bitmap is walked in index order, so the first particle that doesn't fit ends the copy
+			const PxU32 slot = mWriteBuffers.compact ? nbWritten : p;
+			if (slot >= capacity)
+				break;
+
+			if (positions)
+				*reinterpret_cast<PxVec3*>(reinterpret_cast<PxU8*>(positions) + slot * positionStride) = particles.positions[p];
+			if (velocities)
+				*reinterpret_cast<PxVec3*>(reinterpret_cast<PxU8*>(velocities) + slot * velocityStride) = particles.velocities[p];
+			nbWritten++;
+		}
+
+		if (!mWriteBuffers.compact)
+			nbWritten = PxMin(particles.validParticleRange, capacity);
+	}
+
+	if (mWriteBuffers.nbWrittenParticles)
+		*mWriteBuffers.nbWrittenParticles = nbWritten;
 }
 
 //----------------------------------------------------------------------------//
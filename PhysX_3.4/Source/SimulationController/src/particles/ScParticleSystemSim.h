@@ -42,6 +42,7 @@
 
 #include "ScParticlePacketShape.h"
 #include "PtParticleSystemSim.h"
+#include "particles/PxParticleReadData.h"
 
 namespace physx
 {
@@ -92,6 +93,8 @@ namespace Sc
 		void					onRbShapeChange(const ParticlePacketShape& particleShape, const ShapeSim& shape);
 
 		void					processShapesUpdate();
+
+		void					setWriteBuffers(const PxParticleWriteBuffers* buffers);
 #if PX_SUPPORT_GPU_PHYSX
 		Ps::IntBool				isGpu() const { return mLLSim->isGpuV(); }
 #endif
@@ -128,6 +131,7 @@ namespace Sc
 		void				createShapeUpdateInput(Pt::ParticleShapesUpdateInput& input);	
 		void				createCollisionUpdateInput(Pt::ParticleCollisionUpdateInput& input);	
 		void				updateRigidBodies();
+		void				writeParticleBuffers();
 		void				prepareCollisionInput(PxBaseTask* continuation);
 
 		// ParticleSystem packet handling
@@ -161,6 +165,9 @@ namespace Sc
 		// Count interactions for sizing the contact manager stream
 		PxU32 mInteractionCount;
 
+		// Application buffers written at the end of each step
+		PxParticleWriteBuffers mWriteBuffers;
+
 		typedef Cm::DelegateTask<Sc::ParticleSystemSim, &Sc::ParticleSystemSim::prepareCollisionInput> CollisionInputPrepTask;
 		CollisionInputPrepTask mCollisionInputPrepTask;
 	};
@@ -0,0 +1,121 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#ifndef PX_FOUNDATION_PX_ALLOCATION_PROFILER_H
+#define PX_FOUNDATION_PX_ALLOCATION_PROFILER_H
+
+/** \addtogroup foundation
+  @{
+*/
+
+#include "foundation/Px.h"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxOutputStream;
+
+/**
+\brief Allocations made through the foundation allocator from one call site.
+
+A call site is the name, filename and line passed to PxAllocatorCallback::allocate. The names are only
+type names when PxFoundation::setReportAllocationNames is enabled, otherwise the sites are told apart by file and line.
+
+The totals count since profiling was enabled or PxResetAllocationProfile was called, the live values count the
+allocations profiled and not freed yet.
+
+@see PxGetAllocationSiteStats
+*/
+struct PxAllocationSiteStats
+{
+	const char*	name;				//!< Name passed to the allocator
+	const char*	filename;			//!< Source file of the allocation, NULL for the site counting the allocations that didn't fit the site table
+	PxU32		line;				//!< Source line of the allocation
+	PxU64		nbAllocations;		//!< Number of allocations made
+	PxU64		bytes;				//!< Bytes allocated
+	PxU64		liveAllocations;	//!< Number of allocations still alive
+	PxU64		liveBytes;			//!< Bytes still allocated
+	PxU64		peakBytes;			//!< Highest liveBytes
+};
+
+/**
+\brief Enables the in-process allocation profiler of the foundation allocator.
+
+The profiler aggregates every allocation by call site, so the allocation churn of the hot paths can be found without PVD.
+Each allocation and deallocation costs a hash lookup under one of 64 striped locks, cheap enough to leave on in staging builds.
+
+Disabling forgets the live allocations (they are reported as freed), the totals are kept until the next reset.
+
+\note The first call registers the profiler as an allocation listener, and must be made while no other thread allocates,
+typically right after PxCreateFoundation.
+
+\param[in] enabled True to profile the allocations made from now on.
+\return False if the foundation was not created.
+
+@see PxGetAllocationSiteStats PxDumpAllocationProfile
+*/
+PX_FOUNDATION_API bool PX_CALL_CONV PxSetAllocationProfilingEnabled(bool enabled);
+
+/**
+\brief Returns true if the allocation profiler is enabled.
+*/
+PX_FOUNDATION_API bool PX_CALL_CONV PxIsAllocationProfilingEnabled();
+
+/**
+\brief Copies the statistics of the call sites seen so far, returns the number of entries written.
+
+Can be called from any thread while allocations take place, the counters of a site are not read atomically.
+
+\param[out] stats Buffer receiving the statistics, may be NULL to only get the number of sites.
+\param[in] maxStats Size of the buffer.
+\return The number of entries written, or the number of sites if stats is NULL.
+*/
+PX_FOUNDATION_API PxU32 PX_CALL_CONV PxGetAllocationSiteStats(PxAllocationSiteStats* stats, PxU32 maxStats);
+
+/**
+\brief Clears the totals of every site, and sets the peaks to the live values.
+*/
+PX_FOUNDATION_API void PX_CALL_CONV PxResetAllocationProfile();
+
+/**
+\brief Writes the sites that allocated the most bytes as a text table, one site per line.
+
+\param[in] stream Stream receiving the table.
+\param[in] maxSites Number of sites written, the busiest first.
+*/
+PX_FOUNDATION_API void PX_CALL_CONV PxDumpAllocationProfile(PxOutputStream& stream, PxU32 maxSites = 64);
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif // PX_FOUNDATION_PX_ALLOCATION_PROFILER_H
@@ -0,0 +1,112 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#ifndef PX_FOUNDATION_PX_HUGE_PAGE_ALLOCATOR_H
+#define PX_FOUNDATION_PX_HUGE_PAGE_ALLOCATOR_H
+
+/** \addtogroup foundation
+  @{
+*/
+
+#include "foundation/PxAllocatorCallback.h"
+
+/**
+\brief Type name passed to PxAllocatorCallback::allocate for the large buffers that live as long as their owner.
+
+The SDK uses it for the broadphase bounds and contact distances, the BV4 trees of triangle meshes, the scene query trees,
+the heightfield samples and the solver body arrays, whether PxFoundation::setReportAllocationNames is enabled or not.
+An allocator callback can compare the type name against it (with strcmp, the pointers differ between modules) to serve
+those buffers from huge pages, see PxHugePageAllocator.
+*/
+#define PX_LARGE_PERSISTENT_ALLOCATION_NAME "PxLargePersistentAllocation"
+
+#if !PX_DOXYGEN
+namespace physx
+{
+#endif
+
+/**
+\brief Allocator callback serving the large, long lived buffers of the SDK from 2 MB pages.
+
+Requests of at least minSize bytes with the PX_LARGE_PERSISTENT_ALLOCATION_NAME type name get their own mapping of
+huge pages, which cuts the TLB misses of the tree traversals and the broadphase. Everything else, and the requests for
+which the system has no huge pages, goes to the wrapped allocator. Pass the allocator to PxCreateFoundation:
+
+\code
+PxHugePageAllocator hugePageAllocator(myAllocator);
+PxFoundation* foundation = PxCreateFoundation(PX_FOUNDATION_VERSION, hugePageAllocator, myErrorCallback);
+\endcode
+
+Each mapping is rounded up to the huge page size, so minSize should stay well above a few hundred KB.
+
+On Linux the pages come from the reserved huge page pool (MAP_HUGETLB), or else from transparent huge pages on a 2 MB
+aligned mapping (madvise(MADV_HUGEPAGE)). On Windows they are large pages (MEM_LARGE_PAGES), which require the
+SeLockMemoryPrivilege for the process. Other platforms always use the wrapped allocator.
+
+Every allocation has a 16 bytes header telling the two kinds apart, the wrapped allocator sees the requests 16 bytes bigger.
+The allocator is thread safe if the wrapped one is.
+*/
+class PX_FOUNDATION_API PxHugePageAllocator : public PxAllocatorCallback
+{
+  public:
+	/**
+	\param[in] fallback Allocator used for everything not served from huge pages, must outlive this one.
+	\param[in] minSize Smallest hinted request served from huge pages, in bytes.
+	*/
+	PxHugePageAllocator(PxAllocatorCallback& fallback, size_t minSize = 1024 * 1024);
+	virtual ~PxHugePageAllocator();
+
+	virtual void* allocate(size_t size, const char* typeName, const char* filename, int line);
+	virtual void deallocate(void* ptr);
+
+	/**
+	\brief Returns the number of live allocations on huge pages.
+	*/
+	PxU32 getNbHugePageAllocations() const;
+
+	/**
+	\brief Returns the bytes mapped on huge pages, including the rounding to the page size.
+	*/
+	PxU64 getHugePageBytes() const;
+
+  private:
+	PxHugePageAllocator& operator=(const PxHugePageAllocator&);
+
+	PxAllocatorCallback& mFallback;
+	const size_t mMinSize;
+	volatile int32_t mNbHugePageAllocations;
+	volatile int64_t mHugePageBytes;
+};
+
+#if !PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif // PX_FOUNDATION_PX_HUGE_PAGE_ALLOCATOR_H
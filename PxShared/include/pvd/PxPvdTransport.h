@@ -121,6 +121,41 @@ PxDefaultPvdSocketTransportCreate(const char* host, int port, unsigned int timeo
 */
 PX_PVDSDK_API PxPvdTransport* PX_CALL_CONV PxDefaultPvdFileTransportCreate(const char* name);
 
+/**
+	\brief Settings of the asynchronous file transport.
+
+	With rotation the capture is split in segments named <name>.0, <name>.1 and so on, and only the first segment and the
+	last maxSegments - 1 ones are kept. The first segment holds the class definitions, so a rolling capture is viewed by
+	joining it with the kept segments in order (objects created in the deleted segments are missing from it).
+	Compressed segments are LZ4 frames, "lz4 -dc name.0 name.7 name.8 > capture.pxd2" does both at once.
+
+	\see PxDefaultPvdAsyncFileTransportCreate
+*/
+struct PxPvdAsyncFileTransportDesc
+{
+	const char* name;        //!< Path of the capture file, or the prefix of the segments with rotation
+	uint32_t bufferSize;     //!< Size of each of the two buffers, a full buffer is handed to the writer thread
+	bool compress;           //!< Writes LZ4 compressed frames instead of the raw stream
+	uint64_t maxSegmentSize; //!< Uncompressed bytes after which a new segment is started, 0 disables the rotation
+	uint32_t maxSegments;    //!< Number of segments kept with rotation (at least 2), 0 keeps every segment
+
+	PxPvdAsyncFileTransportDesc()
+	: name(NULL), bufferSize(4 << 20), compress(true), maxSegmentSize(0), maxSegments(0)
+	{
+	}
+};
+
+/**
+	\brief Create a file transport writing from a background thread.
+
+	The stream is written to one buffer while the other one is compressed and written to the disk, so the threads sending
+	PVD data only wait for the disk when it can't keep up with them.
+
+	\param desc settings of the transport.
+	\return The transport, or NULL if the name is missing.
+*/
+PX_PVDSDK_API PxPvdTransport* PX_CALL_CONV PxDefaultPvdAsyncFileTransportCreate(const PxPvdAsyncFileTransportDesc& desc);
+
 #if !PX_DOXYGEN
 } // namespace physx
 #endif
@@ -36,6 +36,11 @@ namespace physx
 
 class PxBaseTask;
 
+/**
+ \brief Condition polled by PxCpuDispatcher::waitUntil, returns true once the wait is over.
+*/
+typedef bool (*PxWaitConditionFunction)(void* userData);
+
 /** 
  \brief A CpuDispatcher is responsible for scheduling the execution of tasks passed to it by the SDK.
 
@@ -71,6 +76,19 @@ public:
 	*/
 	virtual uint32_t getWorkerCount() const = 0;
 
+	/**
+	\brief Called by the SDK before a thread blocks, i.e. PxScene::fetchResults(true) and PxScene::fetchCollision(true).
+
+	A dispatcher backed by a fiber or job system can implement it to suspend the calling job until
+	isDone(userData) returns true, running other jobs meanwhile, instead of blocking a worker of the job system.
+	isDone can be called from any thread, and as many times as needed.
+
+	\param[in] isDone Condition checking if the SDK can continue.
+	\param[in] userData Passed to isDone.
+	\return False if the dispatcher didn't wait (the default), in which case the SDK blocks the thread.
+	*/
+	virtual bool waitUntil(PxWaitConditionFunction isDone, void* userData) { PX_UNUSED(isDone); PX_UNUSED(userData); return false; }
+
 	virtual ~PxCpuDispatcher() {}
 };
 
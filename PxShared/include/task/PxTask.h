@@ -37,6 +37,24 @@
 namespace physx
 {
 
+/**
+ * \brief Scheduling priority of a task
+ *
+ * Dispatchers that support priorities run every pending eHIGH task before the eNORMAL ones,
+ * and the eLOW tasks only when there is nothing else to do. A running task is never interrupted.
+ * Tasks of the SDK are eNORMAL, so background work (streaming, cooking...) submitted to a
+ * shared dispatcher should be eLOW to stay off the critical path of the simulation.
+ */
+struct PxTaskPriority
+{
+	enum Enum
+	{
+		eHIGH,
+		eNORMAL,
+		eLOW
+	};
+};
+
 /**
  * \brief Base class of all task types
  *
@@ -45,7 +63,7 @@ namespace physx
 class PxBaseTask
 {
 public:
-	PxBaseTask() : mContextID(0), mTm(NULL) {}
+	PxBaseTask() : mContextID(0), mTm(NULL), mPriority(PxTaskPriority::eNORMAL) {}
 	virtual ~PxBaseTask() {}
 
     /**
@@ -94,9 +112,18 @@ public:
 	PX_FORCE_INLINE	void	setContextId(PxU64 id)			{ mContextID = id;		}
 	PX_FORCE_INLINE	PxU64	getContextId()			const	{ return mContextID;	}
 
+	/**
+	 * \brief Sets the priority used by the dispatcher, must be set before the task is submitted
+	 *
+	 * \see PxTaskPriority
+	 */
+	PX_FORCE_INLINE	void					setPriority(PxTaskPriority::Enum priority)	{ mPriority = priority;	}
+	PX_FORCE_INLINE	PxTaskPriority::Enum	getPriority()						const	{ return mPriority;		}
+
 protected:
 	PxU64				mContextID;		//!< Context ID for profiler interface
 	PxTaskManager*		mTm;			//!< Owning PxTaskManager instance
+	PxTaskPriority::Enum	mPriority;	//!< Scheduling priority, see PxTaskPriority
 
 	friend class PxTaskMgr;
 };
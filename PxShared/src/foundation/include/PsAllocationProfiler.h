@@ -0,0 +1,126 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#ifndef PSFOUNDATION_PSALLOCATIONPROFILER_H
+#define PSFOUNDATION_PSALLOCATIONPROFILER_H
+
+#include "foundation/PxAllocationProfiler.h"
+#include "PsBroadcast.h"
+#include "PsHashMap.h"
+#include "PsMutex.h"
+
+namespace physx
+{
+namespace shdfnd
+{
+
+// Aggregates the allocations by call site, see PxSetAllocationProfilingEnabled.
+// Everything it allocates goes through the RawAllocator, so it never sees its own allocations.
+class AllocationProfiler : public AllocationListener
+{
+	PX_NOCOPY(AllocationProfiler)
+
+  public:
+	AllocationProfiler();
+	virtual ~AllocationProfiler();
+
+	virtual void onAllocation(size_t size, const char* typeName, const char* filename, int line, void* allocatedMemory);
+	virtual void onDeallocation(void* allocatedMemory);
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const
+	{
+		return mEnabled;
+	}
+
+	PxU32 getSiteStats(PxAllocationSiteStats* stats, PxU32 maxStats) const;
+	void reset();
+
+  private:
+	enum
+	{
+		eMAX_NB_SITES = 4096, // power of two, the last one counts the allocations of the sites that didn't fit
+		eNB_SHARDS = 64
+	};
+
+	enum SiteState
+	{
+		eSITE_EMPTY,
+		eSITE_WRITING,
+		eSITE_READY
+	};
+
+	struct Site
+	{
+		volatile int32_t state;
+		PxU32 line;
+		const char* name;
+		const char* filename;
+		volatile int64_t nbAllocations;
+		volatile int64_t bytes;
+		volatile int64_t liveAllocations;
+		volatile int64_t liveBytes;
+		volatile int64_t peakBytes;
+	};
+
+	struct Allocation
+	{
+		PxU32 site;
+		size_t size;
+	};
+
+	typedef HashMap<const void*, Allocation, Hash<const void*>, RawAllocator> AllocationMap;
+
+	// the live allocations, striped by address to keep the threads from serializing on one lock
+	struct Shard
+	{
+		MutexT<RawAllocator> mutex;
+		AllocationMap allocations;
+	};
+
+	PxU32 findSite(const char* name, const char* filename, PxU32 line);
+	void addLive(Site& site, int64_t size);
+	void removeLive(Site& site, int64_t size);
+	static void fillStats(PxAllocationSiteStats& stats, const Site& site);
+
+	PX_FORCE_INLINE Shard& getShard(const void* ptr)
+	{
+		const size_t address = reinterpret_cast<size_t>(ptr);
+		return mShards[((address >> 4) ^ (address >> 12)) & (eNB_SHARDS - 1)];
+	}
+
+	Site* mSites;
+	Shard* mShards;
+	volatile bool mEnabled;
+};
+
+} // namespace shdfnd
+} // namespace physx
+
+#endif // PSFOUNDATION_PSALLOCATIONPROFILER_H
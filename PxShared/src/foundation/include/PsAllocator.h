@@ -32,6 +32,7 @@
 
 #include "foundation/PxAllocatorCallback.h"
 #include "foundation/PxFoundation.h"
+#include "foundation/PxHugePageAllocator.h"
 #include "Ps.h"
 #include "foundation/PxAssert.h"
 
@@ -52,6 +53,8 @@
 #define PX_ALLOC(n, name) physx::shdfnd::NonTrackingAllocator().allocate(n, __FILE__, __LINE__)
 #endif
 #define PX_ALLOC_TEMP(n, name) PX_ALLOC(n, name)
+// Large buffers living as long as their owner, the allocator callback can put them on huge pages (see PxHugePageAllocator)
+#define PX_ALLOC_LARGE(n, name) physx::shdfnd::LargePersistentAllocator(name).allocate(n, __FILE__, __LINE__)
 #define PX_FREE(x) physx::shdfnd::NonTrackingAllocator().deallocate(x)
 #define PX_FREE_AND_RESET(x)                                                                                           \
 	{                                                                                                                  \
@@ -181,6 +184,28 @@ class NonTrackingAllocator
 	}
 };
 
+/**
+Allocator for the large buffers that live as long as their owner, e.g. trees and bounds arrays. Always passes
+PX_LARGE_PERSISTENT_ALLOCATION_NAME as the type name, so that the allocator callback can route them to huge pages.
+The memory can be freed with any other allocator.
+*/
+class LargePersistentAllocator
+{
+  public:
+	PX_FORCE_INLINE LargePersistentAllocator(const char* = 0)
+	{
+	}
+	PX_FORCE_INLINE void* allocate(size_t size, const char* file, int line)
+	{
+		return !size ? 0 : getAllocator().allocate(size, PX_LARGE_PERSISTENT_ALLOCATION_NAME, file, line);
+	}
+	PX_FORCE_INLINE void deallocate(void* ptr)
+	{
+		if(ptr)
+			getAllocator().deallocate(ptr);
+	}
+};
+
 /*
 \brief	Virtual allocator callback used to provide run-time defined allocators to foundation types like Array or Bitmap.
         This is used by VirtualAllocator
@@ -0,0 +1,248 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#ifndef PSFOUNDATION_PSCONCURRENTHASHMAP_H
+#define PSFOUNDATION_PSCONCURRENTHASHMAP_H
+
+#include "PsAllocator.h"
+#include "PsAtomic.h"
+#include "PsBitUtils.h"
+#include "PsHash.h"
+#include "PsIntrinsics.h"
+#include "PsThread.h"
+#include "foundation/PxMath.h"
+
+// Fixed capacity hash map that many threads can insert into and look up at the same time, without locks.
+// * linear probing over a power of two table, sized for a load factor of at most 0.5
+// * insert only: entries can't be erased, clear() resets the whole table and must not run concurrently
+// * insert() returns NULL when the table is full, the caller decides how to fall back (e.g. a serial pass)
+// * keys and values are copied into the slot before it is published, so a value pointer returned by
+//   insert() or find() stays valid until clear()
+//
+// A slot is claimed with a CAS on its state word, written, then published. Threads probing a slot that is being
+// written wait for it (a few stores), since it might hold their key.
+//
+// ConcurrentHashMap<K, V>:
+//		V*			insert(const K& k, const V& v, bool& inserted)	lock-free, O(1) expected
+//		V*			find(const K& k)								lock-free, O(1) expected
+//		uint32_t	size()
+//		void		clear()											O(capacity), not thread safe
+//
+// Iterating is only valid while no thread inserts:
+//
+// for(uint32_t i = 0; i < map.getCapacity(); i++)
+//		if(map.isOccupied(i))
+//			myFunction(map.getKey(i), map.getValue(i));
+
+namespace physx
+{
+namespace shdfnd
+{
+template <class Key, class Value, class HashFn = Hash<Key>, class Allocator = NonTrackingAllocator>
+class ConcurrentHashMap : private Allocator
+{
+	enum SlotState
+	{
+		eEMPTY = 0,
+		eWRITING = 1,
+		eREADY = 2
+	};
+
+	struct Slot
+	{
+		volatile int32_t mState;
+		Key mKey;
+		Value mValue;
+	};
+
+  public:
+	ConcurrentHashMap(uint32_t maxEntries = 0, const Allocator& alloc = Allocator())
+	: Allocator(alloc), mSlots(NULL), mMask(0), mSize(0)
+	{
+		if(maxEntries)
+			reserve(maxEntries);
+	}
+
+	~ConcurrentHashMap()
+	{
+		release();
+	}
+
+	// Resizes the table to hold maxEntries, dropping the current entries. Not thread safe.
+	void reserve(uint32_t maxEntries)
+	{
+		release();
+
+		const uint32_t capacity = nextPowerOfTwo(PxMax(maxEntries * 2, 2u) - 1);
+		mSlots = reinterpret_cast<Slot*>(Allocator::allocate(sizeof(Slot) * capacity, __FILE__, __LINE__));
+		mMask = capacity - 1;
+		for(uint32_t i = 0; i < capacity; i++)
+			mSlots[i].mState = eEMPTY;
+		mSize = 0;
+	}
+
+	// Returns the value stored for k, inserting v if k wasn't there. NULL if the table is full.
+	Value* insert(const Key& k, const Value& v, bool& inserted)
+	{
+		inserted = false;
+		if(!mSlots)
+			return NULL;
+
+		uint32_t index = hash(k);
+		for(uint32_t probe = 0; probe <= mMask; probe++, index++)
+		{
+			Slot& slot = mSlots[index & mMask];
+			int32_t state = slot.mState;
+			if(state == eEMPTY)
+			{
+				state = atomicCompareExchange(&slot.mState, eWRITING, eEMPTY);
+				if(state == eEMPTY)
+				{
+					PX_PLACEMENT_NEW(&slot.mKey, Key)(k);
+					PX_PLACEMENT_NEW(&slot.mValue, Value)(v);
+					// make the key and value visible before the state
+					memoryBarrier();
+					slot.mState = eREADY;
+					atomicIncrement(&mSize);
+					inserted = true;
+					return &slot.mValue;
+				}
+			}
+
+			waitForSlot(slot, state);
+			if(mHash.equal(slot.mKey, k))
+				return &slot.mValue;
+		}
+		return NULL;
+	}
+
+	Value* find(const Key& k) const
+	{
+		if(!mSlots)
+			return NULL;
+
+		uint32_t index = hash(k);
+		for(uint32_t probe = 0; probe <= mMask; probe++, index++)
+		{
+			Slot& slot = mSlots[index & mMask];
+			const int32_t state = slot.mState;
+			if(state == eEMPTY)
+				return NULL;
+
+			waitForSlot(slot, state);
+			if(mHash.equal(slot.mKey, k))
+				return &slot.mValue;
+		}
+		return NULL;
+	}
+
+	// Removes every entry. Not thread safe.
+	void clear()
+	{
+		if(!mSize)
+			return;
+
+		for(uint32_t i = 0; i <= mMask; i++)
+		{
+			if(mSlots[i].mState == eREADY)
+			{
+				mSlots[i].mKey.~Key();
+				mSlots[i].mValue.~Value();
+			}
+			mSlots[i].mState = eEMPTY;
+		}
+		mSize = 0;
+	}
+
+	PX_FORCE_INLINE uint32_t size() const
+	{
+		return uint32_t(mSize);
+	}
+
+	PX_FORCE_INLINE uint32_t getCapacity() const
+	{
+		return mSlots ? mMask + 1 : 0;
+	}
+
+	PX_FORCE_INLINE bool isOccupied(uint32_t index) const
+	{
+		return mSlots[index].mState == eREADY;
+	}
+
+	PX_FORCE_INLINE const Key& getKey(uint32_t index) const
+	{
+		return mSlots[index].mKey;
+	}
+
+	PX_FORCE_INLINE Value& getValue(uint32_t index) const
+	{
+		return mSlots[index].mValue;
+	}
+
+  private:
+	ConcurrentHashMap(const ConcurrentHashMap&);
+	ConcurrentHashMap& operator=(const ConcurrentHashMap&);
+
+	PX_FORCE_INLINE uint32_t hash(const Key& k) const
+	{
+		return mHash(k);
+	}
+
+	static void waitForSlot(const Slot& slot, int32_t state)
+	{
+		while(state == eWRITING)
+		{
+			ThreadImpl::yield();
+			state = slot.mState;
+		}
+		// the key written before the state was published
+		memoryBarrier();
+	}
+
+	void release()
+	{
+		if(mSlots)
+		{
+			clear();
+			Allocator::deallocate(mSlots);
+			mSlots = NULL;
+		}
+		mMask = 0;
+	}
+
+	Slot* mSlots;
+	uint32_t mMask;
+	volatile int32_t mSize;
+	HashFn mHash;
+};
+
+} // namespace shdfnd
+} // namespace physx
+
+#endif // #ifndef PSFOUNDATION_PSCONCURRENTHASHMAP_H
@@ -39,7 +39,21 @@ namespace shdfnd
 class Cpu
 {
   public:
+	enum Feature
+	{
+		eSSE2 = (1 << 0),
+		eSSE41 = (1 << 1),
+		eAVX = (1 << 2),
+		eFMA = (1 << 3),
+		eAVX2 = (1 << 4),
+		eAVX512F = (1 << 5)
+	};
+
 	static uint8_t getCpuId();
+
+	//! Mask of the Feature flags supported by the CPU, and by the OS for the extended register state (AVX, AVX-512).
+	//! Queried once and cached, so it can be called from the hot paths to pick a kernel.
+	static uint32_t getFeatures();
 };
 }
 }
@@ -0,0 +1,129 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#ifndef PSFOUNDATION_PSDISTRIBUTEDREADWRITELOCK_H
+#define PSFOUNDATION_PSDISTRIBUTEDREADWRITELOCK_H
+
+#include "PsAtomic.h"
+#include "PsHash.h"
+#include "PsMutex.h"
+#include "PsThread.h"
+
+// Read-biased alternative to ReadWriteLock, for locks taken by many threads that mostly read.
+// * readers don't touch the mutex: each thread increments a counter of its own cache line, picked by hashing its id,
+//   then checks the writer flag. Readers on different threads only share the (read-mostly) line of the flag.
+// * a writer takes the mutex, raises the flag and waits until every reader counter drops to zero. A reader finding
+//   the flag raised backs off and waits on the mutex, so writers are not starved by a stream of readers.
+// * lockReader(false) only counts the reader, for a thread that already holds the write lock (same as ReadWriteLock)
+//
+// Taking the write lock is more expensive than with ReadWriteLock since it goes through all the counters.
+
+namespace physx
+{
+namespace shdfnd
+{
+class DistributedReadWriteLock
+{
+	PX_NOCOPY(DistributedReadWriteLock)
+  public:
+	static const uint32_t NB_SLOTS = 32;
+
+	DistributedReadWriteLock() : mWriter(0)
+	{
+		for(uint32_t i = 0; i < NB_SLOTS; i++)
+			mSlots[i].mReaders = 0;
+	}
+
+	void lockReader(bool takeLock = true)
+	{
+		volatile int32_t* readers = &getSlot().mReaders;
+		if(!takeLock)
+		{
+			atomicIncrement(readers);
+			return;
+		}
+
+		while(true)
+		{
+			// the increment is a full barrier, a writer raising the flag after it sees the reader
+			atomicIncrement(readers);
+			if(!mWriter)
+				return;
+
+			atomicDecrement(readers);
+			mMutex.lock();
+			mMutex.unlock();
+		}
+	}
+
+	void unlockReader()
+	{
+		atomicDecrement(&getSlot().mReaders);
+	}
+
+	void lockWriter()
+	{
+		mMutex.lock();
+		atomicExchange(&mWriter, 1);
+
+		for(uint32_t i = 0; i < NB_SLOTS; i++)
+		{
+			while(mSlots[i].mReaders)
+				ThreadImpl::yield();
+		}
+	}
+
+	void unlockWriter()
+	{
+		atomicExchange(&mWriter, 0);
+		mMutex.unlock();
+	}
+
+  private:
+	// the counters are 64 bytes apart, so that no two of them share a cache line whatever the alignment of the lock
+	struct Slot
+	{
+		volatile int32_t mReaders;
+		int32_t mPad[15];
+	};
+
+	PX_FORCE_INLINE Slot& getSlot()
+	{
+		return mSlots[hash(uint64_t(ThreadImpl::getId())) & (NB_SLOTS - 1)];
+	}
+
+	Slot mSlots[NB_SLOTS];
+	volatile int32_t mWriter;
+	Mutex mMutex;
+};
+
+} // namespace shdfnd
+} // namespace physx
+
+#endif // #ifndef PSFOUNDATION_PSDISTRIBUTEDREADWRITELOCK_H
@@ -48,6 +48,8 @@ namespace physx
 namespace shdfnd
 {
 
+class AllocationProfiler;
+
 #if PX_VC
 #pragma warning(push)
 #pragma warning(disable : 4251) // class needs to have dll-interface to be used by clients of class
@@ -68,6 +70,10 @@ class PX_FOUNDATION_API Foundation : public PxFoundation, public UserAllocated
 	// note, you MUST eventually call release if createInstance returned true!
 	static Foundation* createInstance(PxU32 version, PxErrorCallback& errc, PxAllocatorCallback& alloc);
 	static Foundation& getInstance();
+	static Foundation* getInstanceIfCreated()
+	{
+		return mInstance;
+	}
 	void release();
 	static void incRefCount(); // this call requires a foundation object to exist already
 	static void decRefCount(); // this call requires a foundation object to exist already
@@ -140,6 +146,36 @@ class PX_FOUNDATION_API Foundation : public PxFoundation, public UserAllocated
 	{
 		return mTempAllocMutex;
 	}
+	PX_INLINE TempAllocatorArena*& getTempAllocArenas()
+	{
+		return mTempAllocArenas;
+	}
+	PX_INLINE uint32_t getTempAllocTls() const
+	{
+		return mTempAllocTls;
+	}
+
+	// Context (a scene id) the calling thread allocates for, read by the allocation listeners. 0 when unknown or disabled
+	PxU64 getAllocationContext() const;
+	// Returns the previous context of the calling thread
+	PxU64 setAllocationContext(PxU64 context);
+	// Threads only track their context while enabled, which is off by default to save the TLS accesses
+	void setAllocationContextEnabled(bool enabled)
+	{
+		mAllocationContextEnabled = enabled;
+	}
+	PX_INLINE bool isAllocationContextEnabled() const
+	{
+		return mAllocationContextEnabled;
+	}
+
+	// The allocation profiler, NULL until PxSetAllocationProfilingEnabled first enables it
+	AllocationProfiler* getAllocationProfiler() const
+	{
+		return mAllocationProfiler;
+	}
+	// Creates the profiler and registers it as an allocation listener
+	AllocationProfiler* createAllocationProfiler();
 	// End allocations
 
   private:
@@ -165,6 +201,13 @@ class PX_FOUNDATION_API Foundation : public PxFoundation, public UserAllocated
 
 	AllocFreeTable mTempAllocFreeTable;
 	Mutex mTempAllocMutex;
+	TempAllocatorArena* mTempAllocArenas; // every thread arena, for stats and release
+	uint32_t mTempAllocTls;               // arena of the calling thread
+
+	uint32_t mAllocationContextTls;
+	volatile bool mAllocationContextEnabled;
+
+	AllocationProfiler* mAllocationProfiler;
 
 	Mutex mListenerMutex;
 
@@ -181,6 +224,27 @@ PX_INLINE Foundation& getFoundation()
 	return Foundation::getInstance();
 }
 
+// Sets the allocation context of the calling thread for the lifetime of the scope
+class AllocationContextScope
+{
+	PX_NOCOPY(AllocationContextScope)
+  public:
+	PX_INLINE AllocationContextScope(PxU64 context) : mEnabled(getFoundation().isAllocationContextEnabled())
+	{
+		if(mEnabled)
+			mPrevious = getFoundation().setAllocationContext(context);
+	}
+	PX_INLINE ~AllocationContextScope()
+	{
+		if(mEnabled)
+			getFoundation().setAllocationContext(mPrevious);
+	}
+
+  private:
+	bool mEnabled;
+	PxU64 mPrevious;
+};
+
 } // namespace shdfnd
 } // namespace physx
 
@@ -0,0 +1,330 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#ifndef PSFOUNDATION_PSPARALLELSORT_H
+#define PSFOUNDATION_PSPARALLELSORT_H
+
+/** \addtogroup foundation
+@{
+*/
+
+#include "PsSort.h"
+#include "PsAtomic.h"
+#include "PsSync.h"
+#include "task/PxTask.h"
+
+namespace physx
+{
+namespace shdfnd
+{
+namespace internal
+{
+// One step of parallelSort(): independent jobs shared by the calling thread and the workers of the dispatcher.
+// The jobs are claimed from a counter, so the caller never waits for a task that hasn't started. If no worker is
+// free the caller runs all of them, which avoids deadlocks when sorting from within a task. The tasks hold a
+// reference on the phase, the ones starting after the last job just release it.
+template <class Allocator>
+class ParallelSortPhase
+{
+  public:
+	typedef void (*JobFunction)(void* data, uint32_t job);
+
+	static void run(PxCpuDispatcher& dispatcher, JobFunction function, void* data, uint32_t nbJobs,
+	                const Allocator& allocator)
+	{
+		const uint32_t nbTasks = PxMin(nbJobs - 1, dispatcher.getWorkerCount());
+		if(!nbTasks)
+		{
+			for(uint32_t i = 0; i < nbJobs; i++)
+				function(data, i);
+			return;
+		}
+
+		Allocator phaseAllocator(allocator);
+		void* memory =
+		    phaseAllocator.allocate(sizeof(ParallelSortPhase) + sizeof(Task) * nbTasks, __FILE__, __LINE__);
+		ParallelSortPhase* phase =
+		    PX_PLACEMENT_NEW(memory, ParallelSortPhase)(allocator, function, data, nbJobs, nbTasks);
+
+		Task* tasks = phase->getTasks();
+		for(uint32_t i = 0; i < nbTasks; i++)
+		{
+			Task* task = PX_PLACEMENT_NEW(tasks + i, Task)(*phase);
+			dispatcher.submitTask(*task);
+		}
+
+		phase->work();
+
+		if(!dispatcher.waitUntil(isDone, phase))
+			phase->mDone.wait();
+		phase->releaseReference();
+	}
+
+  private:
+	class Task : public PxLightCpuTask
+	{
+	  public:
+		Task(ParallelSortPhase& phase) : mPhase(phase)
+		{
+		}
+
+		virtual void run()
+		{
+			mPhase.work();
+		}
+
+		virtual void release()
+		{
+			mPhase.releaseReference();
+		}
+
+		virtual const char* getName() const
+		{
+			return "PsParallelSort";
+		}
+
+	  private:
+		Task& operator=(const Task&);
+
+		ParallelSortPhase& mPhase;
+	};
+
+	ParallelSortPhase(const Allocator& allocator, JobFunction function, void* data, uint32_t nbJobs, uint32_t nbTasks)
+	: mAllocator(allocator)
+	, mFunction(function)
+	, mData(data)
+	, mNbJobs(nbJobs)
+	, mNbTasks(nbTasks)
+	, mNextJob(0)
+	, mNbJobsDone(0)
+	, mRefCount(int32_t(nbTasks + 1))
+	{
+	}
+
+	Task* getTasks()
+	{
+		return reinterpret_cast<Task*>(this + 1);
+	}
+
+	void work()
+	{
+		for(;;)
+		{
+			const uint32_t job = uint32_t(atomicIncrement(&mNextJob) - 1);
+			if(job >= mNbJobs)
+				break;
+
+			mFunction(mData, job);
+
+			if(uint32_t(atomicIncrement(&mNbJobsDone)) == mNbJobs)
+				mDone.set();
+		}
+	}
+
+	void releaseReference()
+	{
+		if(atomicDecrement(&mRefCount))
+			return;
+
+		Allocator allocator(mAllocator);
+		Task* tasks = getTasks();
+		for(uint32_t i = 0; i < mNbTasks; i++)
+			tasks[i].~Task();
+		this->~ParallelSortPhase();
+		allocator.deallocate(this);
+	}
+
+	static bool isDone(void* phase)
+	{
+		return reinterpret_cast<ParallelSortPhase*>(phase)->mDone.wait(0);
+	}
+
+	Allocator mAllocator;
+	const JobFunction mFunction;
+	void* const mData;
+	const uint32_t mNbJobs;
+	const uint32_t mNbTasks;
+	volatile int32_t mNextJob;
+	volatile int32_t mNbJobsDone;
+	volatile int32_t mRefCount;
+	Sync mDone;
+};
+
+static const uint32_t PARALLEL_SORT_MAX_CHUNKS = 64;
+
+template <class T, class Predicate>
+struct ParallelSortData
+{
+	enum Step
+	{
+		eSORT_CHUNKS,
+		eMERGE,
+		eCOPY_BACK
+	};
+
+	T* elements;
+	T* buffer;
+	const Predicate* compare;
+	bool stable;
+	uint32_t bounds[PARALLEL_SORT_MAX_CHUNKS + 1];
+
+	Step step;
+	const T* src;
+	T* dst;
+	uint32_t width; // chunks per merged range
+
+	static void runJob(void* userData, uint32_t job)
+	{
+		ParallelSortData& data = *reinterpret_cast<ParallelSortData*>(userData);
+		const uint32_t* bounds = data.bounds;
+
+		if(data.step == eSORT_CHUNKS)
+		{
+			const uint32_t start = bounds[job];
+			if(data.stable)
+				mergeSort(data.elements + start, data.buffer + start, bounds[job + 1] - start, *data.compare);
+			else
+				sort(data.elements + start, bounds[job + 1] - start, *data.compare);
+		}
+		else if(data.step == eMERGE)
+		{
+			// each merge of 2 ranges is split into as many jobs as it has chunks, at equal output ranks
+			const uint32_t nbPieces = data.width * 2;
+			const uint32_t first = (job / nbPieces) * nbPieces;
+			const uint32_t piece = job % nbPieces;
+
+			const T* a = data.src + bounds[first];
+			const T* b = data.src + bounds[first + data.width];
+			const uint32_t nbA = bounds[first + data.width] - bounds[first];
+			const uint32_t nbB = bounds[first + nbPieces] - bounds[first + data.width];
+			const uint64_t total = uint64_t(nbA + nbB);
+			const uint32_t rank0 = uint32_t(total * piece / nbPieces);
+			const uint32_t rank1 = uint32_t(total * (piece + 1) / nbPieces);
+
+			const uint32_t a0 = mergeSplit(a, nbA, b, nbB, rank0, *data.compare);
+			const uint32_t a1 = mergeSplit(a, nbA, b, nbB, rank1, *data.compare);
+			merge(a + a0, a1 - a0, b + rank0 - a0, (rank1 - a1) - (rank0 - a0), data.dst + bounds[first] + rank0,
+			      *data.compare);
+		}
+		else
+		{
+			PX_ASSERT(data.step == eCOPY_BACK);
+			for(uint32_t i = bounds[job]; i < bounds[job + 1]; i++)
+				data.elements[i] = data.buffer[i];
+		}
+	}
+};
+} // namespace internal
+
+static const uint32_t PARALLEL_SORT_MIN_PER_CHUNK = 4096;
+
+/**
+\brief Sorts an array on the workers of a dispatcher, assuming that the predicate implements the < operator.
+
+The array is cut into a power of two of chunks, sorted separately, then merged pairwise. Every merge is split at equal
+output ranks so that all threads take part until the end. The calling thread takes part as well and doesn't return before
+the array is sorted, it is fine to call this from a task.
+
+Small arrays, or a NULL dispatcher or one without workers, fall back to sort() or stableSort() on the calling thread.
+With stable set the result matches stableSort() whatever the number of workers. Otherwise the relative order of elements
+comparing equal depends on the number of chunks, i.e. on the number of workers.
+
+The merges use a temporary buffer of count elements from the allocator, the elements are copied with operator= into
+that raw buffer. The predicate is called from several threads at once.
+*/
+template <class T, class Predicate, class Allocator>
+void parallelSort(T* elements, uint32_t count, const Predicate& compare, PxCpuDispatcher* dispatcher, bool stable,
+                  const Allocator& inAllocator, uint32_t minPerChunk = PARALLEL_SORT_MIN_PER_CHUNK)
+{
+	const uint32_t nbThreads = dispatcher ? dispatcher->getWorkerCount() + 1 : 1;
+
+	uint32_t nbChunks = 1;
+	while(nbChunks < nbThreads && nbChunks < internal::PARALLEL_SORT_MAX_CHUNKS && count / (nbChunks * 2) >= minPerChunk)
+		nbChunks *= 2;
+
+	if(nbChunks < 2)
+	{
+		if(stable)
+			stableSort(elements, count, compare, inAllocator);
+		else
+			sort(elements, count, compare, inAllocator);
+		return;
+	}
+
+	typedef internal::ParallelSortData<T, Predicate> Data;
+	typedef internal::ParallelSortPhase<Allocator> Phase;
+
+	Allocator allocator(inAllocator);
+	Data data;
+	data.elements = elements;
+	data.buffer = reinterpret_cast<T*>(allocator.allocate(sizeof(T) * count, __FILE__, __LINE__));
+	data.compare = &compare;
+	data.stable = stable;
+	for(uint32_t i = 0; i <= nbChunks; i++)
+		data.bounds[i] = uint32_t(uint64_t(count) * i / nbChunks);
+
+	data.step = Data::eSORT_CHUNKS;
+	Phase::run(*dispatcher, Data::runJob, &data, nbChunks, allocator);
+
+	data.step = Data::eMERGE;
+	data.src = elements;
+	data.dst = data.buffer;
+	for(data.width = 1; data.width < nbChunks; data.width *= 2)
+	{
+		Phase::run(*dispatcher, Data::runJob, &data, nbChunks, allocator);
+
+		T* src = data.dst;
+		data.dst = const_cast<T*>(data.src);
+		data.src = src;
+	}
+
+	if(data.src != elements)
+	{
+		data.step = Data::eCOPY_BACK;
+		Phase::run(*dispatcher, Data::runJob, &data, nbChunks, allocator);
+	}
+
+	allocator.deallocate(data.buffer);
+
+#if PX_SORT_PARANOIA
+	for(uint32_t i = 1; i < count; i++)
+		PX_ASSERT(!compare(elements[i], elements[i - 1]));
+#endif
+}
+
+template <class T, class Predicate>
+void parallelSort(T* elements, uint32_t count, const Predicate& compare, PxCpuDispatcher* dispatcher, bool stable)
+{
+	parallelSort(elements, count, compare, dispatcher, stable, typename shdfnd::AllocatorTraits<T>::Type());
+}
+
+} // namespace shdfnd
+} // namespace physx
+
+#endif // #ifndef PSFOUNDATION_PSPARALLELSORT_H
@@ -151,6 +151,55 @@ definition for serialized classes is complete in checked builds.
 		}
 	}
 
+	/*
+	Rebuild the free list in address order and release the slabs without live elements. The next allocations
+	then fill the holes of the first slabs, keeping the live elements packed instead of following the order
+	of the last deallocations. Live elements don't move.
+	*/
+	void sortFreeList()
+	{
+		if(!mFreeElement)
+			return;
+
+		Array<void*, Alloc> freeNodes(*this);
+		while(mFreeElement)
+		{
+			freeNodes.pushBack(mFreeElement);
+			mFreeElement = mFreeElement->mNext;
+		}
+
+		Alloc& alloc(*this);
+		sort(freeNodes.begin(), freeNodes.size(), Less<void*>(), alloc);
+		sort(mSlabs.begin(), mSlabs.size(), Less<void*>(), alloc);
+
+		uint32_t nbKeptNodes = 0;
+		uint32_t nbKeptSlabs = 0;
+		uint32_t freeIt = 0;
+		for(uint32_t s = 0; s < mSlabs.size(); s++)
+		{
+			const size_t slabEnd = size_t(mSlabs[s]) + mElementsPerSlab * sizeof(T);
+
+			const uint32_t firstFree = freeIt;
+			while(freeIt < freeNodes.size() && size_t(freeNodes[freeIt]) < slabEnd)
+				freeIt++;
+
+			if(freeIt - firstFree == mElementsPerSlab)
+			{
+				Alloc::deallocate(mSlabs[s]);
+				continue;
+			}
+
+			for(uint32_t i = firstFree; i < freeIt; i++)
+				freeNodes[nbKeptNodes++] = freeNodes[i];
+			mSlabs[nbKeptSlabs++] = mSlabs[s];
+		}
+		mSlabs.resize(nbKeptSlabs);
+
+		// Push from the back so that the lowest address ends up at the head
+		while(nbKeptNodes--)
+			push(reinterpret_cast<FreeList*>(freeNodes[nbKeptNodes]));
+	}
+
   protected:
 	struct FreeList
 	{
@@ -60,7 +60,7 @@ template <class T, class Predicate, class Allocator>
 void sort(T* elements, uint32_t count, const Predicate& compare, const Allocator& inAllocator,
           const uint32_t initialStackSize = 32)
 {
-	static const uint32_t SMALL_SORT_CUTOFF = 5; // must be >= 3 since we need 3 for median
+	static const uint32_t SMALL_SORT_CUTOFF = internal::SORT_NETWORK_MAX_SIZE; // must be >= 3 since we need 3 for median
 
 	PX_ALLOCA(stackMem, int32_t, initialStackSize);
 	internal::Stack<Allocator> stack(stackMem, initialStackSize, inAllocator);
@@ -120,6 +120,41 @@ void sort(T* elements, uint32_t count)
 	sort(elements, count, shdfnd::Less<T>(), typename shdfnd::AllocatorTraits<T>::Type());
 }
 
+/**
+\brief Stable version of sort(): elements comparing equal keep their relative order.
+
+Merge sort with a temporary buffer of count elements from the allocator. The elements are copied with operator=
+into the raw buffer, so this is meant for plain data. See also parallelSort() in PsParallelSort.h.
+*/
+template <class T, class Predicate, class Allocator>
+void stableSort(T* elements, uint32_t count, const Predicate& compare, const Allocator& inAllocator)
+{
+	if(count < 2)
+		return;
+
+	Allocator allocator(inAllocator);
+	T* buffer = reinterpret_cast<T*>(allocator.allocate(sizeof(T) * count, __FILE__, __LINE__));
+	internal::mergeSort(elements, buffer, count, compare);
+	allocator.deallocate(buffer);
+
+#if PX_SORT_PARANOIA
+	for(uint32_t i = 1; i < count; i++)
+		PX_ASSERT(!compare(elements[i], elements[i - 1]));
+#endif
+}
+
+template <class T, class Predicate>
+void stableSort(T* elements, uint32_t count, const Predicate& compare)
+{
+	stableSort(elements, count, compare, typename shdfnd::AllocatorTraits<T>::Type());
+}
+
+template <class T>
+void stableSort(T* elements, uint32_t count)
+{
+	stableSort(elements, count, shdfnd::Less<T>(), typename shdfnd::AllocatorTraits<T>::Type());
+}
+
 } // namespace shdfnd
 } // namespace physx
 
@@ -36,6 +36,7 @@
 
 #include "foundation/PxAssert.h"
 #include "foundation/PxIntrinsics.h"
+#include "foundation/PxMath.h"
 #include "PsBasicTemplates.h"
 #include "PsUserAllocated.h"
 
@@ -112,9 +113,49 @@ PX_INLINE int32_t partition(T* elements, int32_t first, int32_t last, Predicate&
 	return i;
 }
 
+template <class T, class Predicate>
+PX_FORCE_INLINE void compareExchange(T& a, T& b, Predicate& compare)
+{
+	// no branch on the comparison, the selects compile to min/max or conditional moves for simple keys
+	const bool swapped = compare(b, a);
+	const T lo = swapped ? b : a;
+	const T hi = swapped ? a : b;
+	a = lo;
+	b = hi;
+}
+
+// Optimal sorting networks for 2 to 8 elements, as pairs of indices to compare-exchange. Not stable.
+static const uint8_t gSortNetworks[] = {
+	0, 1,
+	1, 2, 0, 2, 0, 1,
+	0, 1, 2, 3, 0, 2, 1, 3, 1, 2,
+	0, 1, 3, 4, 2, 4, 2, 3, 0, 3, 0, 2, 1, 4, 1, 3, 1, 2,
+	1, 2, 4, 5, 0, 2, 3, 5, 0, 1, 3, 4, 2, 5, 0, 3, 1, 4, 2, 4, 1, 3, 2, 3,
+	1, 2, 3, 4, 5, 6, 0, 2, 3, 5, 4, 6, 0, 1, 4, 5, 2, 6, 0, 4, 1, 5, 0, 3, 2, 5, 1, 3, 2, 4, 2, 3,
+	0, 1, 2, 3, 4, 5, 6, 7, 0, 2, 1, 3, 4, 6, 5, 7, 1, 2, 5, 6, 0, 4, 3, 7, 1, 5, 2, 6, 1, 4, 3, 6, 2, 4, 3, 5, 3, 4
+};
+static const uint8_t gSortNetworkOffsets[] = { 0, 0, 0, 1, 4, 9, 18, 30, 46, 65 };
+static const uint32_t SORT_NETWORK_MAX_SIZE = 8;
+
+template <class T, class Predicate>
+PX_INLINE void sortNetwork(T* elements, uint32_t count, Predicate& compare)
+{
+	PX_ASSERT(count <= SORT_NETWORK_MAX_SIZE);
+	const uint8_t* pairs = gSortNetworks + gSortNetworkOffsets[count] * 2;
+	const uint32_t nbPairs = uint32_t(gSortNetworkOffsets[count + 1] - gSortNetworkOffsets[count]);
+	for(uint32_t i = 0; i < nbPairs; i++)
+		compareExchange(elements[pairs[i * 2]], elements[pairs[i * 2 + 1]], compare);
+}
+
 template <class T, class Predicate>
 PX_INLINE void smallSort(T* elements, int32_t first, int32_t last, Predicate& compare)
 {
+	if(uint32_t(last - first) < SORT_NETWORK_MAX_SIZE)
+	{
+		sortNetwork(elements + first, uint32_t(last - first + 1), compare);
+		return;
+	}
+
 	// selection sort - could reduce to fsel on 360 with floats.
 
 	for(int32_t i = first; i < last; i++)
@@ -129,6 +170,86 @@ PX_INLINE void smallSort(T* elements, int32_t first, int32_t last, Predicate& co
 	}
 }
 
+template <class T, class Predicate>
+PX_INLINE void insertionSort(T* elements, uint32_t count, Predicate& compare)
+{
+	// stable, elements move past strictly greater ones only
+	for(uint32_t i = 1; i < count; i++)
+	{
+		const T value = elements[i];
+		uint32_t j = i;
+		while(j && compare(value, elements[j - 1]))
+		{
+			elements[j] = elements[j - 1];
+			j--;
+		}
+		elements[j] = value;
+	}
+}
+
+// Stable merge of two sorted ranges, ties are taken from the first one
+template <class T, class Predicate>
+PX_INLINE void merge(const T* a, uint32_t nbA, const T* b, uint32_t nbB, T* dst, Predicate& compare)
+{
+	uint32_t i = 0, j = 0;
+	while(i < nbA && j < nbB)
+		*dst++ = compare(b[j], a[i]) ? b[j++] : a[i++];
+	while(i < nbA)
+		*dst++ = a[i++];
+	while(j < nbB)
+		*dst++ = b[j++];
+}
+
+// Number of elements of the first range among the first 'rank' outputs of merge(), i.e. where to split both ranges
+// so that the outputs on each side of 'rank' can be merged independently
+template <class T, class Predicate>
+PX_INLINE uint32_t mergeSplit(const T* a, uint32_t nbA, const T* b, uint32_t nbB, uint32_t rank, Predicate& compare)
+{
+	PX_ASSERT(rank <= nbA + nbB);
+	uint32_t lo = rank > nbB ? rank - nbB : 0;
+	uint32_t hi = rank < nbA ? rank : nbA;
+	while(lo < hi)
+	{
+		const uint32_t mid = (lo + hi) / 2;
+		// a[mid] comes before b[rank-mid-1] in the merge, so it is part of the first outputs
+		if(!compare(b[rank - mid - 1], a[mid]))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static const uint32_t MERGE_SORT_RUN_SIZE = 16;
+
+// Stable bottom-up merge sort. The buffer must hold count elements, it is used as raw memory (elements are copied
+// with operator=) and the result ends up in elements.
+template <class T, class Predicate>
+void mergeSort(T* elements, T* buffer, uint32_t count, Predicate& compare)
+{
+	for(uint32_t i = 0; i < count; i += MERGE_SORT_RUN_SIZE)
+		insertionSort(elements + i, PxMin(MERGE_SORT_RUN_SIZE, count - i), compare);
+
+	T* src = elements;
+	T* dst = buffer;
+	for(uint32_t width = MERGE_SORT_RUN_SIZE; width < count; width *= 2)
+	{
+		for(uint32_t i = 0; i < count; i += width * 2)
+		{
+			const uint32_t nbA = PxMin(width, count - i);
+			const uint32_t nbB = PxMin(width, count - i - nbA);
+			merge(src + i, nbA, src + i + nbA, nbB, dst + i, compare);
+		}
+		swap(src, dst);
+	}
+
+	if(src != elements)
+	{
+		for(uint32_t i = 0; i < count; i++)
+			elements[i] = src[i];
+	}
+}
+
 template <class Allocator>
 class Stack
 {
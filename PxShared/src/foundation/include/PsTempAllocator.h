@@ -36,6 +36,8 @@ namespace physx
 {
 namespace shdfnd
 {
+struct TempAllocatorArena;
+
 union TempAllocatorChunk
 {
 	TempAllocatorChunk() : mNext(0)
@@ -43,9 +45,45 @@ union TempAllocatorChunk
 	}
 	TempAllocatorChunk* mNext; // while chunk is free
 	uint32_t mIndex;           // while chunk is allocated
-	uint8_t mPad[16];          // 16 byte aligned allocations
+	struct
+	{
+		uint32_t mIndex;               // sArenaIndex
+		uint32_t mSize;                // size of the block, header included
+		TempAllocatorArena* mArena;    // arena the block was carved from
+	} mArenaBlock;                     // while chunk is allocated from a thread arena
+	uint8_t mPad[16];                  // 16 byte aligned allocations
+};
+
+// Bump allocator owned by one thread. Blocks can be freed from any thread, the arena rewinds once all of them
+// are freed (or when the last block is freed by the owner) and grows to the high water mark when it overflowed.
+// Arenas are only released with the foundation, so threads that come and go each frame each keep one around.
+struct TempAllocatorArena
+{
+	uint8_t* mMemory;
+	size_t mCapacity;
+	size_t mOffset;
+	size_t mRequested;         // biggest offset needed, including the allocations that didn't fit
+	size_t mFrameHighWater;    // biggest offset used since the last TempAllocator::endFrame
+	size_t mLastHighWater;     // mFrameHighWater at the last TempAllocator::endFrame
+	size_t mPeakHighWater;     // biggest offset used since creation
+	volatile int32_t mLiveCount;
+	volatile int32_t mOverflows;
+	uint32_t mLastOverflows;   // mOverflows at the last TempAllocator::endFrame
+	TempAllocatorArena* mNext; // next arena of the foundation
 };
 
+// Statistics of the thread arenas, see TempAllocator::getArenaStatistics
+struct TempAllocatorStatistics
+{
+	uint32_t nbArenas;
+	size_t capacity;       // sum of the arena sizes
+	size_t highWaterMark;  // most bytes used by an arena during the last frame
+	size_t peakHighWater;  // most bytes used by an arena since it was created
+	uint32_t nbOverflows;  // allocations that didn't fit their arena during the last frame
+};
+
+// Temp allocations are served from a bump arena of the calling thread, so they don't take a lock.
+// Blocks that don't fit, or bigger than 64kB, use the shared free list of the foundation.
 class TempAllocator
 {
   public:
@@ -54,6 +92,11 @@ class TempAllocator
 	}
 	PX_FOUNDATION_API void* allocate(size_t size, const char* file, int line);
 	PX_FOUNDATION_API void deallocate(void* ptr);
+
+	// Ends a frame (called at the end of PxScene::fetchResults): latches the high water marks of the frame.
+	PX_FOUNDATION_API static void endFrame();
+
+	PX_FOUNDATION_API static void getArenaStatistics(TempAllocatorStatistics& stats);
 };
 
 } // namespace shdfnd
@@ -71,6 +71,21 @@
 #include <xmmintrin.h>
 #endif
 
+// Use fused multiply-add for the MulAdd/ScaleAdd family when the compiler targets FMA3 (-mfma, -march=haswell, /arch:AVX2).
+// Results differ from the separate multiply and add in the last bit, so a binary built with it isn't bit exact with one built without.
+// Define PX_VECMATH_FMA to 0 to keep the SSE2 results on such targets.
+#if !defined(PX_VECMATH_FMA)
+#if COMPILE_VECTOR_INTRINSICS && PX_INTEL_FAMILY && (defined(__FMA__) || (PX_VC && defined(__AVX2__)))
+#define PX_VECMATH_FMA 1
+#else
+#define PX_VECMATH_FMA 0
+#endif
+#endif
+
+#if PX_VECMATH_FMA
+#include <immintrin.h>
+#endif
+
 namespace physx
 {
 namespace shdfnd
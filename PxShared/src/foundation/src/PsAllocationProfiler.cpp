@@ -0,0 +1,313 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#include "foundation/PxIO.h"
+#include "foundation/PxMath.h"
+#include "foundation/PxMemory.h"
+#include "PsAllocationProfiler.h"
+#include "PsAtomic.h"
+#include "PsFoundation.h"
+#include "PsSort.h"
+#include "PsString.h"
+#include "PsArray.h"
+
+namespace physx
+{
+namespace shdfnd
+{
+
+AllocationProfiler::AllocationProfiler() : mEnabled(false)
+{
+	RawAllocator alloc;
+	mSites = reinterpret_cast<Site*>(alloc.allocate(sizeof(Site) * eMAX_NB_SITES, __FILE__, __LINE__));
+	PxMemZero(mSites, sizeof(Site) * eMAX_NB_SITES);
+
+	// the overflow site is never looked up, it only takes what didn't fit
+	Site& overflow = mSites[eMAX_NB_SITES - 1];
+	overflow.name = "<other sites>";
+	overflow.state = eSITE_READY;
+
+	mShards = reinterpret_cast<Shard*>(alloc.allocate(sizeof(Shard) * eNB_SHARDS, __FILE__, __LINE__));
+	for(PxU32 i = 0; i < eNB_SHARDS; i++)
+		PX_PLACEMENT_NEW(mShards + i, Shard)();
+}
+
+AllocationProfiler::~AllocationProfiler()
+{
+	RawAllocator alloc;
+	for(PxU32 i = 0; i < eNB_SHARDS; i++)
+		mShards[i].~Shard();
+	alloc.deallocate(mShards);
+	alloc.deallocate(mSites);
+}
+
+PxU32 AllocationProfiler::findSite(const char* name, const char* filename, PxU32 line)
+{
+	// the names and file names are string literals, so the pointers identify them
+	size_t key = reinterpret_cast<size_t>(filename) ^ (reinterpret_cast<size_t>(name) << 7) ^ (size_t(line) * 2654435761u);
+	key ^= key >> 15;
+
+	const PxU32 mask = eMAX_NB_SITES - 1;
+	PxU32 index = PxU32(key) & mask;
+	for(PxU32 probe = 0; probe < eMAX_NB_SITES - 1; probe++, index = (index + 1) & mask)
+	{
+		if(index == eMAX_NB_SITES - 1)
+			continue;
+
+		Site& site = mSites[index];
+		int32_t state = site.state;
+		if(state == eSITE_EMPTY)
+		{
+			state = atomicCompareExchange(&site.state, eSITE_WRITING, eSITE_EMPTY);
+			if(state == eSITE_EMPTY)
+			{
+				site.name = name;
+				site.filename = filename;
+				site.line = line;
+				atomicExchange(&site.state, eSITE_READY);
+				return index;
+			}
+		}
+
+		// another thread is claiming the slot, wait for its key
+		while(state == eSITE_WRITING)
+			state = site.state;
+
+		if(site.filename == filename && site.line == line && site.name == name)
+			return index;
+	}
+	return eMAX_NB_SITES - 1;
+}
+
+void AllocationProfiler::addLive(Site& site, int64_t size)
+{
+	atomicAdd64(&site.nbAllocations, 1);
+	atomicAdd64(&site.bytes, size);
+	atomicAdd64(&site.liveAllocations, 1);
+	atomicMax64(&site.peakBytes, atomicAdd64(&site.liveBytes, size));
+}
+
+void AllocationProfiler::removeLive(Site& site, int64_t size)
+{
+	atomicAdd64(&site.liveAllocations, -1);
+	atomicAdd64(&site.liveBytes, -size);
+}
+
+void AllocationProfiler::onAllocation(size_t size, const char* typeName, const char* filename, int line, void* allocatedMemory)
+{
+	if(!mEnabled || !allocatedMemory)
+		return;
+
+	Allocation allocation;
+	allocation.site = findSite(typeName ? typeName : "", filename ? filename : "", PxU32(line));
+	allocation.size = size;
+	addLive(mSites[allocation.site], int64_t(size));
+
+	Shard& shard = getShard(allocatedMemory);
+	MutexT<RawAllocator>::ScopedLock lock(shard.mutex);
+	const AllocationMap::Entry* previous = shard.allocations.find(allocatedMemory);
+	if(previous)
+	{
+		// freed while the profiler was being disabled and enabled again, the old block is gone
+		removeLive(mSites[previous->second.site], int64_t(previous->second.size));
+		shard.allocations[allocatedMemory] = allocation;
+	}
+	else
+		shard.allocations.insert(allocatedMemory, allocation);
+}
+
+void AllocationProfiler::onDeallocation(void* allocatedMemory)
+{
+	if(!mEnabled || !allocatedMemory)
+		return;
+
+	Shard& shard = getShard(allocatedMemory);
+	MutexT<RawAllocator>::ScopedLock lock(shard.mutex);
+	AllocationMap::Entry entry;
+	// blocks allocated before the profiler was enabled are not found
+	if(shard.allocations.erase(allocatedMemory, entry))
+		removeLive(mSites[entry.second.site], int64_t(entry.second.size));
+}
+
+void AllocationProfiler::setEnabled(bool enabled)
+{
+	if(enabled == mEnabled)
+		return;
+	mEnabled = enabled;
+
+	if(!enabled)
+	{
+		// the frees of the blocks alive now won't be seen, so don't keep them as live
+		for(PxU32 i = 0; i < eNB_SHARDS; i++)
+		{
+			MutexT<RawAllocator>::ScopedLock lock(mShards[i].mutex);
+			mShards[i].allocations.clear();
+		}
+		for(PxU32 i = 0; i < eMAX_NB_SITES; i++)
+		{
+			mSites[i].liveAllocations = 0;
+			mSites[i].liveBytes = 0;
+		}
+	}
+}
+
+void AllocationProfiler::reset()
+{
+	for(PxU32 i = 0; i < eMAX_NB_SITES; i++)
+	{
+		Site& site = mSites[i];
+		site.nbAllocations = 0;
+		site.bytes = 0;
+		site.peakBytes = site.liveBytes;
+	}
+}
+
+void AllocationProfiler::fillStats(PxAllocationSiteStats& stats, const Site& site)
+{
+	stats.name = site.name;
+	stats.filename = site.filename;
+	stats.line = site.line;
+	// the live counters can briefly go below zero while a reset races with the frees
+	stats.nbAllocations = PxU64(PxMax<int64_t>(site.nbAllocations, 0));
+	stats.bytes = PxU64(PxMax<int64_t>(site.bytes, 0));
+	stats.liveAllocations = PxU64(PxMax<int64_t>(site.liveAllocations, 0));
+	stats.liveBytes = PxU64(PxMax<int64_t>(site.liveBytes, 0));
+	stats.peakBytes = PxU64(PxMax<int64_t>(site.peakBytes, 0));
+}
+
+PxU32 AllocationProfiler::getSiteStats(PxAllocationSiteStats* stats, PxU32 maxStats) const
+{
+	PxU32 count = 0;
+	for(PxU32 i = 0; i < eMAX_NB_SITES; i++)
+	{
+		const Site& site = mSites[i];
+		if(site.state != eSITE_READY || (i == eMAX_NB_SITES - 1 && !site.nbAllocations && !site.liveAllocations))
+			continue;
+
+		if(stats)
+		{
+			if(count == maxStats)
+				break;
+			fillStats(stats[count], site);
+			if(i == eMAX_NB_SITES - 1)
+				stats[count].filename = NULL;
+		}
+		count++;
+	}
+	return count;
+}
+
+namespace
+{
+AllocationProfiler* getProfiler()
+{
+	Foundation* foundation = Foundation::getInstanceIfCreated();
+	return foundation ? foundation->getAllocationProfiler() : NULL;
+}
+
+struct MoreBytes
+{
+	bool operator()(const PxAllocationSiteStats& a, const PxAllocationSiteStats& b) const
+	{
+		return a.bytes > b.bytes;
+	}
+};
+}
+
+} // namespace shdfnd
+
+bool PxSetAllocationProfilingEnabled(bool enabled)
+{
+	shdfnd::Foundation* foundation = shdfnd::Foundation::getInstanceIfCreated();
+	if(!foundation)
+		return false;
+
+	shdfnd::AllocationProfiler* profiler = foundation->getAllocationProfiler();
+	if(!profiler)
+	{
+		if(!enabled)
+			return true;
+		profiler = foundation->createAllocationProfiler();
+	}
+	profiler->setEnabled(enabled);
+	return true;
+}
+
+bool PxIsAllocationProfilingEnabled()
+{
+	shdfnd::AllocationProfiler* profiler = shdfnd::getProfiler();
+	return profiler && profiler->isEnabled();
+}
+
+PxU32 PxGetAllocationSiteStats(PxAllocationSiteStats* stats, PxU32 maxStats)
+{
+	shdfnd::AllocationProfiler* profiler = shdfnd::getProfiler();
+	return profiler ? profiler->getSiteStats(stats, maxStats) : 0;
+}
+
+void PxResetAllocationProfile()
+{
+	shdfnd::AllocationProfiler* profiler = shdfnd::getProfiler();
+	if(profiler)
+		profiler->reset();
+}
+
+void PxDumpAllocationProfile(PxOutputStream& stream, PxU32 maxSites)
+{
+	char line[512];
+	const PxU32 length = PxU32(shdfnd::snprintf(line, sizeof(line), "%14s %10s %14s %10s %14s  site\n", "bytes", "allocs", "live bytes", "live", "peak bytes"));
+	stream.write(line, PxMin<PxU32>(length, sizeof(line) - 1));
+
+	shdfnd::AllocationProfiler* profiler = shdfnd::getProfiler();
+	if(!profiler)
+		return;
+
+	// sites can be added while the copy is made, it just misses them
+	shdfnd::Array<PxAllocationSiteStats, shdfnd::RawAllocator> sites;
+	sites.resize(profiler->getSiteStats(NULL, 0));
+	sites.resize(profiler->getSiteStats(sites.begin(), sites.size()));
+	if(sites.empty())
+		return;
+	shdfnd::sort(sites.begin(), sites.size(), shdfnd::MoreBytes(), shdfnd::RawAllocator());
+
+	const PxU32 nbSites = PxMin(maxSites, sites.size());
+	for(PxU32 i = 0; i < nbSites; i++)
+	{
+		const PxAllocationSiteStats& site = sites[i];
+		const int written = shdfnd::snprintf(line, sizeof(line), "%14llu %10llu %14llu %10llu %14llu  %s:%u %s\n",
+		                                     static_cast<unsigned long long>(site.bytes), static_cast<unsigned long long>(site.nbAllocations),
+		                                     static_cast<unsigned long long>(site.liveBytes), static_cast<unsigned long long>(site.liveAllocations),
+		                                     static_cast<unsigned long long>(site.peakBytes), site.filename ? site.filename : "",
+		                                     site.line, site.name);
+		if(written > 0)
+			stream.write(line, PxMin<PxU32>(PxU32(written), sizeof(line) - 1));
+	}
+}
+
+} // namespace physx
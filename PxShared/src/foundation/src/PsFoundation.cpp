@@ -33,6 +33,8 @@
 #include "PsFoundation.h"
 #include "PsString.h"
 #include "PsAllocator.h"
+#include "PsThread.h"
+#include "PsAllocationProfiler.h"
 
 namespace physx
 {
@@ -56,11 +58,24 @@ Foundation::Foundation(PxErrorCallback& errc, PxAllocatorCallback& alloc)
 , mErrorMutex(PX_DEBUG_EXP("Foundation::mErrorMutex"))
 , mNamedAllocMutex(PX_DEBUG_EXP("Foundation::mNamedAllocMutex"))
 , mTempAllocMutex(PX_DEBUG_EXP("Foundation::mTempAllocMutex"))
+, mTempAllocArenas(NULL)
+, mTempAllocTls(TlsAlloc())
+, mAllocationContextTls(TlsAlloc())
+, mAllocationContextEnabled(false)
+, mAllocationProfiler(NULL)
 {
 }
 
 Foundation::~Foundation()
 {
+	if(mAllocationProfiler)
+	{
+		mBroadcastingAllocator.deregisterListener(*mAllocationProfiler);
+		mAllocationProfiler->~AllocationProfiler();
+		RawAllocator().deallocate(mAllocationProfiler);
+		mAllocationProfiler = NULL;
+	}
+
 	// deallocate temp buffer allocations
 	Allocator alloc;
 	for(PxU32 i = 0; i < mTempAllocFreeTable.size(); ++i)
@@ -73,6 +88,43 @@ Foundation::~Foundation()
 		}
 	}
 	mTempAllocFreeTable.reset();
+
+	// blocks still allocated from the arenas are leaked like the temp blocks that are never freed
+	for(TempAllocatorArena* arena = mTempAllocArenas; arena;)
+	{
+		TempAllocatorArena* next = arena->mNext;
+		alloc.deallocate(arena->mMemory);
+		alloc.deallocate(arena);
+		arena = next;
+	}
+	mTempAllocArenas = NULL;
+	TlsFree(mTempAllocTls);
+	TlsFree(mAllocationContextTls);
+}
+
+AllocationProfiler* Foundation::createAllocationProfiler()
+{
+	Mutex::ScopedLock lock(mListenerMutex);
+	if(!mAllocationProfiler)
+	{
+		// raw allocation, the profiler must not see its own memory
+		void* memory = RawAllocator().allocate(sizeof(AllocationProfiler), __FILE__, __LINE__);
+		mAllocationProfiler = PX_PLACEMENT_NEW(memory, AllocationProfiler)();
+		mBroadcastingAllocator.registerListener(*mAllocationProfiler);
+	}
+	return mAllocationProfiler;
+}
+
+PxU64 Foundation::getAllocationContext() const
+{
+	return mAllocationContextEnabled ? PxU64(TlsGetValue(mAllocationContextTls)) : 0;
+}
+
+PxU64 Foundation::setAllocationContext(PxU64 context)
+{
+	const PxU64 previous = PxU64(TlsGetValue(mAllocationContextTls));
+	TlsSetValue(mAllocationContextTls, size_t(context));
+	return previous;
 }
 
 Foundation& Foundation::getInstance()
@@ -0,0 +1,125 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#include "foundation/PxHugePageAllocator.h"
+#include "foundation/PxAssert.h"
+#include "PsHugePages.h"
+#include "PsAtomic.h"
+#include "PsString.h"
+
+namespace physx
+{
+
+namespace
+{
+// Placed in front of every allocation. The base is NULL for the allocations of the fallback allocator.
+struct HugePageHeader
+{
+	void*	base;
+	size_t	mappedSize;
+};
+
+const size_t HUGE_PAGE_HEADER_SIZE = 16;
+PX_COMPILE_TIME_ASSERT(sizeof(HugePageHeader) <= HUGE_PAGE_HEADER_SIZE);
+
+PX_FORCE_INLINE HugePageHeader* getHeader(void* ptr)
+{
+	return reinterpret_cast<HugePageHeader*>(reinterpret_cast<PxU8*>(ptr) - HUGE_PAGE_HEADER_SIZE);
+}
+}
+
+PxHugePageAllocator::PxHugePageAllocator(PxAllocatorCallback& fallback, size_t minSize)
+: mFallback(fallback), mMinSize(minSize), mNbHugePageAllocations(0), mHugePageBytes(0)
+{
+}
+
+PxHugePageAllocator::~PxHugePageAllocator()
+{
+	PX_ASSERT(!mNbHugePageAllocations);
+}
+
+void* PxHugePageAllocator::allocate(size_t size, const char* typeName, const char* filename, int line)
+{
+	if(size >= mMinSize && typeName && !shdfnd::strcmp(typeName, PX_LARGE_PERSISTENT_ALLOCATION_NAME))
+	{
+		size_t mappedSize;
+		void* base = shdfnd::mapHugePages(size + HUGE_PAGE_HEADER_SIZE, mappedSize);
+		if(base)
+		{
+			shdfnd::atomicIncrement(&mNbHugePageAllocations);
+			shdfnd::atomicAdd64(&mHugePageBytes, int64_t(mappedSize));
+
+			void* ptr = reinterpret_cast<PxU8*>(base) + HUGE_PAGE_HEADER_SIZE;
+			HugePageHeader* header = getHeader(ptr);
+			header->base = base;
+			header->mappedSize = mappedSize;
+			return ptr;
+		}
+	}
+
+	void* memory = mFallback.allocate(size + HUGE_PAGE_HEADER_SIZE, typeName, filename, line);
+	if(!memory)
+		return NULL;
+
+	void* ptr = reinterpret_cast<PxU8*>(memory) + HUGE_PAGE_HEADER_SIZE;
+	HugePageHeader* header = getHeader(ptr);
+	header->base = NULL;
+	header->mappedSize = 0;
+	return ptr;
+}
+
+void PxHugePageAllocator::deallocate(void* ptr)
+{
+	if(!ptr)
+		return;
+
+	HugePageHeader* header = getHeader(ptr);
+	if(!header->base)
+	{
+		mFallback.deallocate(header);
+		return;
+	}
+
+	const size_t mappedSize = header->mappedSize;
+	shdfnd::atomicDecrement(&mNbHugePageAllocations);
+	shdfnd::atomicAdd64(&mHugePageBytes, -int64_t(mappedSize));
+	shdfnd::unmapHugePages(header->base, mappedSize);
+}
+
+PxU32 PxHugePageAllocator::getNbHugePageAllocations() const
+{
+	return PxU32(mNbHugePageAllocations);
+}
+
+PxU64 PxHugePageAllocator::getHugePageBytes() const
+{
+	return PxU64(mHugePageBytes);
+}
+
+} // namespace physx
@@ -28,6 +28,7 @@
 // Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
 
 #include "foundation/PxMath.h"
+#include "foundation/PxMemory.h"
 
 #include "PsFoundation.h"
 #include "PsTempAllocator.h"
@@ -36,6 +37,7 @@
 #include "PsAtomic.h"
 #include "PsIntrinsics.h"
 #include "PsBitUtils.h"
+#include "PsThread.h"
 
 #if PX_VC
 #pragma warning(disable : 4706) // assignment within conditional expression
@@ -61,6 +63,85 @@ PX_INLINE Foundation::Mutex& getMutex()
 
 const PxU32 sMinIndex = 8;  // 256B min
 const PxU32 sMaxIndex = 17; // 128kB max
+
+const PxU32 sArenaIndex = 0xffffffff;
+const size_t sMaxArenaBlock = 64 * 1024;      // bigger blocks use the free list
+const size_t sMinArenaSize = 64 * 1024;
+const size_t sMaxArenaSize = 4 * 1024 * 1024; // a thread asking for more overflows to the free list
+
+TempAllocatorArena* getThreadArena()
+{
+	Foundation& foundation = getFoundation();
+	TempAllocatorArena* arena = reinterpret_cast<TempAllocatorArena*>(TlsGet(foundation.getTempAllocTls()));
+	if(arena)
+		return arena;
+
+	arena = reinterpret_cast<TempAllocatorArena*>(
+	    NonTrackingAllocator().allocate(sizeof(TempAllocatorArena), __FILE__, __LINE__));
+	PxMemZero(arena, sizeof(TempAllocatorArena));
+	arena->mRequested = sMinArenaSize;
+
+	{
+		Foundation::Mutex::ScopedLock lock(getMutex());
+		arena->mNext = foundation.getTempAllocArenas();
+		foundation.getTempAllocArenas() = arena;
+	}
+	TlsSet(foundation.getTempAllocTls(), arena);
+	return arena;
+}
+
+void* allocateFromArena(TempAllocatorArena& arena, size_t size, const char* filename, int line)
+{
+	const size_t blockSize = (size + sizeof(Chunk) + 15) & ~size_t(15);
+
+	if(arena.mLiveCount == 0)
+	{
+		// every block was freed, possibly by other threads
+		memoryBarrier();
+		arena.mOffset = 0;
+
+		if(arena.mRequested > arena.mCapacity && arena.mCapacity < sMaxArenaSize)
+		{
+			NonTrackingAllocator().deallocate(arena.mMemory);
+			const size_t capacity = PxMin(size_t(nextPowerOfTwo(uint32_t(arena.mRequested - 1))), sMaxArenaSize);
+			arena.mMemory = reinterpret_cast<uint8_t*>(NonTrackingAllocator().allocate(capacity, filename, line));
+			arena.mCapacity = arena.mMemory ? capacity : 0;
+		}
+	}
+
+	const size_t end = arena.mOffset + blockSize;
+	arena.mRequested = PxMax(arena.mRequested, end);
+	if(end > arena.mCapacity)
+	{
+		atomicIncrement(&arena.mOverflows);
+		return NULL;
+	}
+
+	Chunk* chunk = reinterpret_cast<Chunk*>(arena.mMemory + arena.mOffset);
+	arena.mOffset = end;
+	arena.mFrameHighWater = PxMax(arena.mFrameHighWater, end);
+	arena.mPeakHighWater = PxMax(arena.mPeakHighWater, end);
+	atomicIncrement(&arena.mLiveCount);
+
+	chunk->mArenaBlock.mIndex = sArenaIndex;
+	chunk->mArenaBlock.mSize = uint32_t(blockSize);
+	chunk->mArenaBlock.mArena = &arena;
+	return chunk + 1;
+}
+
+void deallocateFromArena(Chunk* chunk)
+{
+	TempAllocatorArena& arena = *chunk->mArenaBlock.mArena;
+
+	// the owner can rewind the top block right away, which keeps nested temp allocations from piling up
+	if(TlsGet(getFoundation().getTempAllocTls()) == &arena &&
+	   reinterpret_cast<uint8_t*>(chunk) + chunk->mArenaBlock.mSize == arena.mMemory + arena.mOffset)
+		arena.mOffset -= chunk->mArenaBlock.mSize;
+
+	// published last, the owner can reuse the memory as soon as it reads zero
+	memoryBarrier();
+	atomicDecrement(&arena.mLiveCount);
+}
 }
 
 void* TempAllocator::allocate(size_t size, const char* filename, int line)
@@ -68,6 +149,13 @@ void* TempAllocator::allocate(size_t size, const char* filename, int line)
 	if(!size)
 		return 0;
 
+	if(size <= sMaxArenaBlock)
+	{
+		void* ret = allocateFromArena(*getThreadArena(), size, filename, line);
+		if(ret)
+			return ret;
+	}
+
 	uint32_t index = PxMax(highestSetBit(uint32_t(size) + sizeof(Chunk) - 1), sMinIndex);
 
 	Chunk* chunk = 0;
@@ -112,6 +200,9 @@ void TempAllocator::deallocate(void* ptr)
 	Chunk* chunk = reinterpret_cast<Chunk*>(ptr) - 1;
 	uint32_t index = chunk->mIndex;
 
+	if(index == sArenaIndex)
+		return deallocateFromArena(chunk);
+
 	if(index >= sMaxIndex)
 		return NonTrackingAllocator().deallocate(chunk);
 
@@ -125,5 +216,33 @@ void TempAllocator::deallocate(void* ptr)
 	getFreeTable()[index] = chunk;
 }
 
+void TempAllocator::endFrame()
+{
+	Foundation::Mutex::ScopedLock lock(getMutex());
+
+	// the owners may be running, so the marks of the new frame can miss an allocation made meanwhile
+	for(TempAllocatorArena* arena = getFoundation().getTempAllocArenas(); arena; arena = arena->mNext)
+	{
+		arena->mLastHighWater = arena->mFrameHighWater;
+		arena->mFrameHighWater = 0;
+		arena->mLastOverflows = uint32_t(atomicExchange(&arena->mOverflows, 0));
+	}
+}
+
+void TempAllocator::getArenaStatistics(TempAllocatorStatistics& stats)
+{
+	PxMemZero(&stats, sizeof(stats));
+
+	Foundation::Mutex::ScopedLock lock(getMutex());
+	for(const TempAllocatorArena* arena = getFoundation().getTempAllocArenas(); arena; arena = arena->mNext)
+	{
+		stats.nbArenas++;
+		stats.capacity += arena->mCapacity;
+		stats.highWaterMark = PxMax(stats.highWaterMark, arena->mLastHighWater);
+		stats.peakHighWater = PxMax(stats.peakHighWater, arena->mPeakHighWater);
+		stats.nbOverflows += arena->mLastOverflows;
+	}
+}
+
 } // namespace shdfnd
 } // namespace physx
@@ -98,5 +98,23 @@ int32_t atomicExchange(volatile int32_t* val, int32_t val2)
 	return oldVal;
 }
 
+int64_t atomicAdd64(volatile int64_t* val, int64_t delta)
+{
+	return __sync_add_and_fetch(val, delta);
+}
+
+int64_t atomicMax64(volatile int64_t* val, int64_t val2)
+{
+	int64_t oldVal;
+	do
+	{
+		oldVal = *val;
+		if(val2 <= oldVal)
+			return oldVal;
+	} while(__sync_val_compare_and_swap(val, oldVal, val2) != oldVal);
+
+	return val2;
+}
+
 } // namespace shdfnd
 } // namespace physx
@@ -43,6 +43,10 @@
 #define cpuid(op, reg) reg[0] = reg[1] = reg[2] = reg[3] = 0;
 #endif
 
+#if PX_INTEL_FAMILY && !PX_EMSCRIPTEN
+#include <cpuid.h>
+#endif
+
 namespace physx
 {
 namespace shdfnd
@@ -54,5 +58,60 @@ uint8_t Cpu::getCpuId()
 	cpuid(1, cpuInfo);
 	return static_cast<uint8_t>(cpuInfo[1] >> 24); // APIC Physical ID
 }
+
+namespace
+{
+#if PX_INTEL_FAMILY && !PX_EMSCRIPTEN
+uint32_t queryFeatures()
+{
+	uint32_t eax, ebx, ecx, edx;
+	if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return 0;
+
+	uint32_t features = 0;
+	if(edx & (1 << 26))
+		features |= Cpu::eSSE2;
+	if(ecx & (1 << 19))
+		features |= Cpu::eSSE41;
+
+	// AVX needs the OS to save the YMM registers on context switches (OSXSAVE, then XCR0 bits 1 and 2)
+	if((ecx & (1 << 27)) == 0 || (ecx & (1 << 28)) == 0)
+		return features;
+
+	uint32_t xcr0, xcr0High;
+	__asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" /* xgetbv */ : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+	if((xcr0 & 0x6) != 0x6)
+		return features;
+
+	features |= Cpu::eAVX;
+	if(ecx & (1 << 12))
+		features |= Cpu::eFMA;
+
+	if(__get_cpuid_max(0, NULL) < 7)
+		return features;
+
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	if(ebx & (1 << 5))
+		features |= Cpu::eAVX2;
+
+	// AVX-512 also needs the opmask and ZMM state (XCR0 bits 5 to 7)
+	if((ebx & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)
+		features |= Cpu::eAVX512F;
+
+	return features;
+}
+#else
+uint32_t queryFeatures()
+{
+	return 0;
+}
+#endif
+}
+
+uint32_t Cpu::getFeatures()
+{
+	static const uint32_t features = queryFeatures();
+	return features;
+}
 }
 }
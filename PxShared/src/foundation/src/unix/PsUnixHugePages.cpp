@@ -0,0 +1,99 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#include "PsHugePages.h"
+
+#if PX_LINUX || PX_ANDROID || PX_APPLE_FAMILY
+#include <sys/mman.h>
+#endif
+
+namespace physx
+{
+namespace shdfnd
+{
+
+#if PX_LINUX || PX_ANDROID || PX_APPLE_FAMILY
+
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+void* mapHugePages(size_t size, size_t& mappedSize)
+{
+	mappedSize = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+#ifdef MAP_HUGETLB
+	// reserved huge pages, only there if the system was set up for them
+	void* hugeTlb = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(hugeTlb != MAP_FAILED)
+		return hugeTlb;
+#endif
+
+#ifdef MADV_HUGEPAGE
+	// transparent huge pages, the range has to be aligned to the page size. Map one page more and trim both ends.
+	PxU8* memory = reinterpret_cast<PxU8*>(
+	    mmap(NULL, mappedSize + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	if(memory == MAP_FAILED)
+		return NULL;
+
+	PxU8* aligned = reinterpret_cast<PxU8*>((size_t(memory) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+	if(aligned != memory)
+		munmap(memory, size_t(aligned - memory));
+	PxU8* end = aligned + mappedSize;
+	PxU8* mappingEnd = memory + mappedSize + HUGE_PAGE_SIZE;
+	if(end != mappingEnd)
+		munmap(end, size_t(mappingEnd - end));
+
+	madvise(aligned, mappedSize, MADV_HUGEPAGE);
+	return aligned;
+#else
+	return NULL;
+#endif
+}
+
+void unmapHugePages(void* base, size_t mappedSize)
+{
+	munmap(base, mappedSize);
+}
+
+#else
+
+void* mapHugePages(size_t, size_t& mappedSize)
+{
+	mappedSize = 0;
+	return NULL;
+}
+
+void unmapHugePages(void*, size_t)
+{
+	PX_ALWAYS_ASSERT();
+}
+
+#endif
+
+} // namespace shdfnd
+} // namespace physx
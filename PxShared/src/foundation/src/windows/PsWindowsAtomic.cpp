@@ -92,5 +92,23 @@ int32_t atomicMax(volatile int32_t* val, int32_t val2)
 	return newValue;
 }
 
+int64_t atomicAdd64(volatile int64_t* val, int64_t delta)
+{
+	return InterlockedExchangeAdd64((volatile LONG64*)val, delta) + delta;
+}
+
+int64_t atomicMax64(volatile int64_t* val, int64_t val2)
+{
+	LONG64 oldValue;
+	do
+	{
+		oldValue = *val;
+		if(val2 <= oldValue)
+			return oldValue;
+	} while(InterlockedCompareExchange64((volatile LONG64*)val, val2, oldValue) != oldValue);
+
+	return val2;
+}
+
 } // namespace shdfnd
 } // namespace physx
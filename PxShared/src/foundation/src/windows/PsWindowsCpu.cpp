@@ -60,5 +60,68 @@ uint8_t Cpu::getCpuId()
 	return static_cast<uint8_t>(CPUInfo[1] >> 24); // APIC Physical ID
 }
 #endif
+
+namespace
+{
+#if PX_ARM
+uint32_t queryFeatures()
+{
+	return 0;
+}
+#else
+uint32_t queryFeatures()
+{
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	const int maxLeaf = cpuInfo[0];
+
+	__cpuid(cpuInfo, 1);
+	const int ecx = cpuInfo[2];
+
+	uint32_t features = 0;
+	if(cpuInfo[3] & (1 << 26))
+		features |= Cpu::eSSE2;
+	if(ecx & (1 << 19))
+		features |= Cpu::eSSE41;
+
+#if _MSC_FULL_VER < 160040219 || !defined(_XCR_XFEATURE_ENABLED_MASK)
+	// xgetbv needs at least VC10 SP1, without it AVX can't be checked safely
+	PX_UNUSED(maxLeaf);
+	return features;
+#else
+	// AVX needs the OS to save the YMM registers on context switches (OSXSAVE, then XCR0 bits 1 and 2)
+	if((ecx & (1 << 27)) == 0 || (ecx & (1 << 28)) == 0)
+		return features;
+
+	const unsigned __int64 xcr0 = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+	if((xcr0 & 0x6) != 0x6)
+		return features;
+
+	features |= Cpu::eAVX;
+	if(ecx & (1 << 12))
+		features |= Cpu::eFMA;
+
+	if(maxLeaf < 7)
+		return features;
+
+	__cpuidex(cpuInfo, 7, 0);
+	if(cpuInfo[1] & (1 << 5))
+		features |= Cpu::eAVX2;
+
+	// AVX-512 also needs the opmask and ZMM state (XCR0 bits 5 to 7)
+	if((cpuInfo[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)
+		features |= Cpu::eAVX512F;
+
+	return features;
+#endif
+}
+#endif
+}
+
+uint32_t Cpu::getFeatures()
+{
+	static const uint32_t features = queryFeatures();
+	return features;
+}
 }
 }
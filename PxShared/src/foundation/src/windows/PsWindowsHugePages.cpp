@@ -0,0 +1,92 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#include "windows/PsWindowsInclude.h"
+#include "PsHugePages.h"
+
+namespace physx
+{
+namespace shdfnd
+{
+
+#if PX_WINDOWS
+
+#ifndef MEM_LARGE_PAGES
+#define MEM_LARGE_PAGES 0x20000000
+#endif
+
+namespace
+{
+typedef SIZE_T(WINAPI* GetLargePageMinimumFunction)();
+
+size_t getLargePageSize()
+{
+	// not declared for the XP baseline of PsWindowsInclude.h
+	static GetLargePageMinimumFunction function = reinterpret_cast<GetLargePageMinimumFunction>(
+	    GetProcAddress(GetModuleHandleA("kernel32.dll"), "GetLargePageMinimum"));
+	return function ? size_t(function()) : 0;
+}
+}
+
+void* mapHugePages(size_t size, size_t& mappedSize)
+{
+	// large pages need the SeLockMemoryPrivilege, without it the allocation fails and the caller falls back
+	const size_t pageSize = getLargePageSize();
+	if(!pageSize)
+	{
+		mappedSize = 0;
+		return NULL;
+	}
+
+	mappedSize = (size + pageSize - 1) & ~(pageSize - 1);
+	return VirtualAlloc(NULL, mappedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+}
+
+void unmapHugePages(void* base, size_t)
+{
+	VirtualFree(base, 0, MEM_RELEASE);
+}
+
+#else
+
+void* mapHugePages(size_t, size_t& mappedSize)
+{
+	mappedSize = 0;
+	return NULL;
+}
+
+void unmapHugePages(void*, size_t)
+{
+	PX_ALWAYS_ASSERT();
+}
+
+#endif
+
+} // namespace shdfnd
+} // namespace physx
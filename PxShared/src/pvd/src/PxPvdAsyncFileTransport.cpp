@@ -0,0 +1,462 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#include "pvd/PxPvdTransport.h"
+#include "foundation/PxAssert.h"
+#include "foundation/PxMath.h"
+#include "foundation/PxMemory.h"
+
+#include "PxPvdAsyncFileTransport.h"
+#include "PsString.h"
+#include <string.h>
+
+namespace physx
+{
+namespace pvdsdk
+{
+
+namespace
+{
+// LZ4 frame format, see https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+// Independent blocks of at most 4MB, without checksums, so any LZ4 decoder reads the segments.
+const uint32_t LZ4_MAX_BLOCK_SIZE = 4 << 20;
+const uint32_t LZ4_HASH_LOG = 14;
+const uint32_t LZ4_MIN_MATCH = 4;
+const uint32_t LZ4_LAST_LITERALS = 5; // the last bytes of a block are always literals
+const uint32_t LZ4_MATCH_LIMIT = 12;  // and the last match starts before them
+const uint32_t LZ4_MAX_OFFSET = 65535;
+
+PX_FORCE_INLINE uint32_t read32(const uint8_t* p)
+{
+	uint32_t value;
+	PxMemCopy(&value, p, sizeof(value));
+	return value;
+}
+
+PX_FORCE_INLINE void writeLE32(uint8_t* p, uint32_t value)
+{
+	p[0] = uint8_t(value);
+	p[1] = uint8_t(value >> 8);
+	p[2] = uint8_t(value >> 16);
+	p[3] = uint8_t(value >> 24);
+}
+
+PX_FORCE_INLINE uint32_t rotl32(uint32_t value, uint32_t bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+// xxHash32 of fewer than 16 bytes, for the frame header checksum
+uint32_t xxh32Small(const uint8_t* data, uint32_t size)
+{
+	const uint32_t prime1 = 2654435761u, prime2 = 2246822519u, prime3 = 3266489917u, prime4 = 668265263u,
+	               prime5 = 374761393u;
+	PX_ASSERT(size < 16);
+
+	uint32_t h = prime5 + size;
+	for(; size >= 4; data += 4, size -= 4)
+		h = rotl32(h + read32(data) * prime3, 17) * prime4;
+	for(; size; data++, size--)
+		h = rotl32(h + *data * prime5, 11) * prime1;
+
+	h ^= h >> 15;
+	h *= prime2;
+	h ^= h >> 13;
+	h *= prime3;
+	h ^= h >> 16;
+	return h;
+}
+
+PX_FORCE_INLINE uint8_t* writeLength(uint8_t* op, uint32_t length)
+{
+	for(; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = uint8_t(length);
+	return op;
+}
+
+// Greedy single probe LZ4 block compression. Returns the compressed size, or 0 if it isn't smaller than the input
+uint32_t lz4CompressBlock(const uint8_t* src, uint32_t size, uint8_t* dst, uint32_t* hashTable)
+{
+	uint8_t* op = dst;
+	uint8_t* const dstEnd = dst + size - 1;
+	uint32_t anchor = 0;
+
+	if(size > LZ4_MATCH_LIMIT)
+	{
+		PxMemZero(hashTable, sizeof(uint32_t) << LZ4_HASH_LOG);
+		const uint32_t matchStartLimit = size - LZ4_MATCH_LIMIT;
+		const uint32_t matchEndLimit = size - LZ4_LAST_LITERALS;
+
+		uint32_t ip = 0;
+		while(ip < matchStartLimit)
+		{
+			const uint32_t sequence = read32(src + ip);
+			const uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_LOG);
+			const uint32_t ref = hashTable[hash];
+			hashTable[hash] = ip;
+
+			// Entries of 0 also stand for empty ones, the comparison sorts them out
+			if(ref >= ip || ip - ref > LZ4_MAX_OFFSET || read32(src + ref) != sequence)
+			{
+				ip++;
+				continue;
+			}
+
+			uint32_t matchLength = LZ4_MIN_MATCH;
+			while(ip + matchLength < matchEndLimit && src[ref + matchLength] == src[ip + matchLength])
+				matchLength++;
+
+			const uint32_t literalLength = ip - anchor;
+			// token, literal length bytes, literals, offset and match length bytes
+			if(op + 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1 > dstEnd)
+				return 0;
+
+			uint8_t* token = op++;
+			*token = 0;
+			if(literalLength >= 15)
+			{
+				*token = 15 << 4;
+				op = writeLength(op, literalLength - 15);
+			}
+			else
+				*token = uint8_t(literalLength << 4);
+			PxMemCopy(op, src + anchor, literalLength);
+			op += literalLength;
+
+			const uint32_t offset = ip - ref;
+			*op++ = uint8_t(offset);
+			*op++ = uint8_t(offset >> 8);
+
+			const uint32_t extraLength = matchLength - LZ4_MIN_MATCH;
+			if(extraLength >= 15)
+			{
+				*token |= 15;
+				op = writeLength(op, extraLength - 15);
+			}
+			else
+				*token |= uint8_t(extraLength);
+
+			ip += matchLength;
+			anchor = ip;
+		}
+	}
+
+	// The last sequence only has literals
+	const uint32_t literalLength = size - anchor;
+	if(op + 1 + literalLength / 255 + 1 + literalLength > dstEnd)
+		return 0;
+
+	if(literalLength >= 15)
+	{
+		*op++ = 15 << 4;
+		op = writeLength(op, literalLength - 15);
+	}
+	else
+		*op++ = uint8_t(literalLength << 4);
+	PxMemCopy(op, src + anchor, literalLength);
+	op += literalLength;
+
+	return uint32_t(op - dst);
+}
+}
+
+PvdAsyncFileTransport::PvdAsyncFileTransport(const PxPvdAsyncFileTransportDesc& desc)
+: mBufferSize(PxMax(desc.bufferSize, 4096u))
+, mCompress(desc.compress)
+, mMaxSegmentSize(desc.maxSegmentSize)
+, mMaxSegments(desc.maxSegments)
+, mFront(0)
+, mFrontSize(0)
+, mSegmentSize(0)
+, mWrittenData(0)
+, mConnected(false)
+, mPendingBuffer(0)
+, mPendingSize(0)
+, mPendingClose(false)
+, mFailed(false)
+, mFile(NULL)
+, mSegmentIndex(0)
+, mCompressed(NULL)
+, mHashTable(NULL)
+, mLocked(false)
+{
+	const uint32_t nameLength = uint32_t(strlen(desc.name)) + 1;
+	mName = reinterpret_cast<char*>(PX_ALLOC(nameLength, "PvdAsyncFileTransport"));
+	PxMemCopy(mName, desc.name, nameLength);
+
+	mBuffers[0] = reinterpret_cast<uint8_t*>(PX_ALLOC(mBufferSize, "PvdAsyncFileTransport"));
+	mBuffers[1] = reinterpret_cast<uint8_t*>(PX_ALLOC(mBufferSize, "PvdAsyncFileTransport"));
+	if(mCompress)
+	{
+		mCompressed = reinterpret_cast<uint8_t*>(PX_ALLOC(PxMin(mBufferSize, LZ4_MAX_BLOCK_SIZE), "PvdAsyncFileTransport"));
+		mHashTable = reinterpret_cast<uint32_t*>(PX_ALLOC(sizeof(uint32_t) << LZ4_HASH_LOG, "PvdAsyncFileTransport"));
+	}
+
+	mWriterIdle.set();
+	start();
+}
+
+PvdAsyncFileTransport::~PvdAsyncFileTransport()
+{
+}
+
+bool PvdAsyncFileTransport::connect()
+{
+	if(mConnected)
+		return true;
+
+	// The writer is idle, its state can be used from here
+	waitForWriter();
+	mFailed = false;
+	mConnected = openSegment();
+	return mConnected;
+}
+
+void PvdAsyncFileTransport::disconnect()
+{
+	if(!mConnected)
+		return;
+
+	submit(true);
+	waitForWriter();
+	mConnected = false;
+}
+
+bool PvdAsyncFileTransport::isConnected()
+{
+	return mConnected;
+}
+
+bool PvdAsyncFileTransport::write(const uint8_t* inBytes, uint32_t inLength)
+{
+	PX_ASSERT(mLocked);
+	if(!mConnected || mFailed)
+		return false;
+
+	mWrittenData += inLength;
+	mSegmentSize += inLength;
+	while(inLength)
+	{
+		const uint32_t size = PxMin(inLength, mBufferSize - mFrontSize);
+		PxMemCopy(mBuffers[mFront] + mFrontSize, inBytes, size);
+		mFrontSize += size;
+		inBytes += size;
+		inLength -= size;
+
+		if(mFrontSize == mBufferSize)
+			submit(false);
+	}
+	return !mFailed;
+}
+
+PxPvdTransport& PvdAsyncFileTransport::lock()
+{
+	mMutex.lock();
+	PX_ASSERT(!mLocked);
+	mLocked = true;
+	return *this;
+}
+
+void PvdAsyncFileTransport::unlock()
+{
+	PX_ASSERT(mLocked);
+
+	// Between two events, the new segment starts cleanly
+	if(mConnected && mMaxSegmentSize && mSegmentSize >= mMaxSegmentSize)
+	{
+		submit(true);
+		mSegmentSize = 0;
+	}
+
+	mLocked = false;
+	mMutex.unlock();
+}
+
+void PvdAsyncFileTransport::flush()
+{
+	if(!mConnected)
+		return;
+
+	submit(false);
+	waitForWriter();
+}
+
+uint64_t PvdAsyncFileTransport::getWrittenDataSize()
+{
+	return mWrittenData;
+}
+
+void PvdAsyncFileTransport::release()
+{
+	disconnect();
+
+	signalQuit();
+	mWorkReady.set();
+	waitForQuit();
+
+	PX_FREE(mName);
+	PX_FREE(mBuffers[0]);
+	PX_FREE(mBuffers[1]);
+	if(mCompressed)
+		PX_FREE(mCompressed);
+	if(mHashTable)
+		PX_FREE(mHashTable);
+	PX_DELETE(this);
+}
+
+void PvdAsyncFileTransport::waitForWriter()
+{
+	mWriterIdle.wait();
+}
+
+void PvdAsyncFileTransport::submit(bool closeSegment)
+{
+	waitForWriter();
+	mWriterIdle.reset();
+
+	mPendingBuffer = mFront;
+	mPendingSize = mFrontSize;
+	mPendingClose = closeSegment;
+	mFront ^= 1;
+	mFrontSize = 0;
+
+	mWorkReady.set();
+}
+
+void PvdAsyncFileTransport::execute()
+{
+	while(true)
+	{
+		mWorkReady.wait();
+		mWorkReady.reset();
+		if(quitIsSignalled())
+			break;
+
+		if(!mFailed)
+		{
+			if(!mFile && mPendingSize)
+				mFailed = !openSegment();
+			if(mFile && !writeBlock(mBuffers[mPendingBuffer], mPendingSize))
+				mFailed = true;
+		}
+		if(mPendingClose)
+			closeSegment();
+
+		mWriterIdle.set();
+	}
+	quit();
+}
+
+bool PvdAsyncFileTransport::openSegment()
+{
+	PX_ASSERT(!mFile);
+
+	if(mMaxSegmentSize)
+	{
+		char name[1024];
+		shdfnd::snprintf(name, sizeof(name), "%s.%u", mName, mSegmentIndex);
+		mFile = fopen(name, "wb");
+
+		// The first segment holds the class definitions, it is always kept
+		if(mFile && mMaxSegments >= 2 && mSegmentIndex >= mMaxSegments)
+		{
+			shdfnd::snprintf(name, sizeof(name), "%s.%u", mName, mSegmentIndex - mMaxSegments + 1);
+			remove(name);
+		}
+	}
+	else
+		mFile = fopen(mName, "wb");
+
+	if(!mFile)
+		return false;
+
+	if(mCompress)
+	{
+		// Magic, version 1 with independent blocks, 4MB blocks, header checksum
+		uint8_t header[7];
+		writeLE32(header, 0x184D2204);
+		header[4] = 0x60;
+		header[5] = 0x70;
+		header[6] = uint8_t(xxh32Small(header + 4, 2) >> 8);
+		return fwrite(header, sizeof(header), 1, mFile) == 1;
+	}
+	return true;
+}
+
+void PvdAsyncFileTransport::closeSegment()
+{
+	if(!mFile)
+		return;
+
+	if(mCompress)
+	{
+		const uint8_t endMark[4] = { 0, 0, 0, 0 };
+		if(fwrite(endMark, sizeof(endMark), 1, mFile) != 1)
+			mFailed = true;
+	}
+	fclose(mFile);
+	mFile = NULL;
+	mSegmentIndex++;
+}
+
+bool PvdAsyncFileTransport::writeBlock(const uint8_t* data, uint32_t size)
+{
+	if(!mCompress)
+		return !size || fwrite(data, size, 1, mFile) == 1;
+
+	while(size)
+	{
+		const uint32_t blockSize = PxMin(size, LZ4_MAX_BLOCK_SIZE);
+		const uint32_t compressedSize = lz4CompressBlock(data, blockSize, mCompressed, mHashTable);
+
+		// The high bit flags the blocks stored as is
+		uint8_t blockHeader[4];
+		writeLE32(blockHeader, compressedSize ? compressedSize : (blockSize | 0x80000000));
+		if(fwrite(blockHeader, sizeof(blockHeader), 1, mFile) != 1)
+			return false;
+		if(fwrite(compressedSize ? mCompressed : data, compressedSize ? compressedSize : blockSize, 1, mFile) != 1)
+			return false;
+
+		data += blockSize;
+		size -= blockSize;
+	}
+	return true;
+}
+
+} // namespace pvdsdk
+
+PxPvdTransport* PxDefaultPvdAsyncFileTransportCreate(const PxPvdAsyncFileTransportDesc& desc)
+{
+	if(!desc.name)
+		return NULL;
+	return PX_NEW(pvdsdk::PvdAsyncFileTransport)(desc);
+}
+
+} // namespace physx
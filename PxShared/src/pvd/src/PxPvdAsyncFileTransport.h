@@ -0,0 +1,117 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2018 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+#ifndef PXPVDSDK_PXPVDASYNCFILETRANSPORT_H
+#define PXPVDSDK_PXPVDASYNCFILETRANSPORT_H
+
+#include "pvd/PxPvdTransport.h"
+
+#include "PsThread.h"
+#include "PsSync.h"
+#include "PsMutex.h"
+#include <stdio.h>
+
+namespace physx
+{
+namespace pvdsdk
+{
+
+// Double buffered file transport. The threads sending PVD data fill the front buffer, a full buffer is handed to the
+// writer thread, which compresses it and writes it while the other buffer is being filled.
+// Segments are only rotated at unlock(), where the stream is between two events.
+class PvdAsyncFileTransport : public physx::PxPvdTransport, public physx::shdfnd::Thread
+{
+	PX_NOCOPY(PvdAsyncFileTransport)
+  public:
+	PvdAsyncFileTransport(const PxPvdAsyncFileTransportDesc& desc);
+	virtual ~PvdAsyncFileTransport();
+
+	virtual bool connect();
+	virtual void disconnect();
+	virtual bool isConnected();
+
+	virtual bool write(const uint8_t* inBytes, uint32_t inLength);
+
+	virtual PxPvdTransport& lock();
+	virtual void unlock();
+
+	virtual void flush();
+
+	virtual uint64_t getWrittenDataSize();
+
+	virtual void release();
+
+	// Writer thread
+	virtual void execute();
+
+  private:
+	// Hands the front buffer to the writer thread, waiting for it to be done with the previous one
+	void submit(bool closeSegment);
+	void waitForWriter();
+
+	// Writer thread
+	bool openSegment();
+	void closeSegment();
+	bool writeBlock(const uint8_t* data, uint32_t size);
+
+	char* mName;
+	uint32_t mBufferSize;
+	bool mCompress;
+	uint64_t mMaxSegmentSize;
+	uint32_t mMaxSegments;
+
+	uint8_t* mBuffers[2];
+	uint32_t mFront;
+	uint32_t mFrontSize;
+	uint64_t mSegmentSize; // uncompressed bytes of the current segment
+	uint64_t mWrittenData;
+	bool mConnected;
+
+	// Work handed to the writer thread
+	uint32_t mPendingBuffer;
+	uint32_t mPendingSize;
+	bool mPendingClose;
+	volatile bool mFailed;
+	physx::shdfnd::Sync mWorkReady;
+	physx::shdfnd::Sync mWriterIdle;
+
+	// Owned by the writer thread
+	FILE* mFile;
+	uint32_t mSegmentIndex;
+	uint8_t* mCompressed;
+	uint32_t* mHashTable;
+
+	physx::shdfnd::Mutex mMutex;
+	bool mLocked; // for debug, remove it when finished
+};
+
+} // pvdsdk
+} // physx
+
+#endif // PXPVDSDK_PXPVDASYNCFILETRANSPORT_H